@@ -0,0 +1,125 @@
+#! /usr/bin/env python3
+# Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+"""
+Sensor throughput benchmark.
+Spawns robot_num robots cycling through robot_models, eg ones with URR2DLidarComponent, URR3DLidarComponent &
+URRROS2CameraComponent variants, then for duration [s] measures per robot sensor topic the achieved publish rate & the
+end-to-end latency, ie the sim time at reception minus the msg stamp, plus the RTF from /clock. Per sensor CPU costs,
+render thread time & frame breakdown are taken from the sim's /diagnostics & /frame_telemetry, thus the game mode should have
+bPublishSensorDiagnostics on & a URRROS2FrameTelemetryPublisher.
+Results are written as JSON to output_path, for runs of different plugin versions to be compared.
+
+ros2 run rr_sim_tests benchmark_sensors --ros-args -p robot_models:="['lidar_robot', 'camera_robot']" -p robot_num:=10 \
+    -p sensor_topics:="['scan:LaserScan', 'image_raw:Image']" -p output_path:=/tmp/sensors.json
+"""
+
+import sys
+import time
+
+# rclpy
+import rclpy
+from rclpy.executors import SingleThreadedExecutor
+from rclpy.node import Node
+
+# other ros
+from sensor_msgs.msg import Image, LaserScan, PointCloud2
+
+# rr_sim_tests
+from rr_sim_tests.utils.benchmark import (
+    SimStatsMonitor,
+    TopicMonitor,
+    spawn_robots_in_grid,
+    spin_for,
+    write_results,
+)
+
+SENSOR_MSG_TYPES = {
+    'LaserScan': LaserScan,
+    'PointCloud2': PointCloud2,
+    'Image': Image,
+}
+
+
+class ParamsNode(Node):
+    def __init__(self):
+        super().__init__('benchmark_sensors_params')
+        self.declare_parameters(
+            namespace='',
+            parameters=[
+                ('robot_models', ['kinematic_burger']),
+                ('robot_name_prefix', 'bench'),
+                ('robot_num', 1),
+                ('robot_spacing', 2.0),
+                # <topic relative to the robot namespace>:<LaserScan|PointCloud2|Image>
+                ('sensor_topics', ['scan:LaserScan']),
+                ('warmup', 5.0),
+                ('duration', 30.0),
+                ('service_namespace', ''),
+                ('output_path', ''),
+            ]
+        )
+
+
+def BenchmarkSensors(args=None):
+    rclpy.init(args=args)
+    param_node = ParamsNode()
+    robot_models = param_node.get_parameter('robot_models').value
+    robot_name_prefix = param_node.get_parameter('robot_name_prefix').value
+    robot_num = param_node.get_parameter('robot_num').value
+    robot_spacing = param_node.get_parameter('robot_spacing').value
+    sensor_topics = [topic.split(':') for topic in param_node.get_parameter('sensor_topics').value]
+    warmup = param_node.get_parameter('warmup').value
+    duration = param_node.get_parameter('duration').value
+    service_namespace = param_node.get_parameter('service_namespace').value
+    output_path = param_node.get_parameter('output_path').value
+
+    spawned_robots = spawn_robots_in_grid(robot_models, robot_name_prefix, robot_num, robot_spacing, service_namespace)
+
+    stats_monitor = SimStatsMonitor()
+    topics_node = rclpy.create_node('benchmark_sensors')
+    executor = SingleThreadedExecutor()
+    executor.add_node(stats_monitor)
+    executor.add_node(topics_node)
+    topic_monitors = [
+        TopicMonitor(topics_node, f'/{robot_name}/{topic_name}', SENSOR_MSG_TYPES[msg_type], stats_monitor)
+        for robot_name in spawned_robots for topic_name, msg_type in sensor_topics
+    ]
+
+    # Let sensors start publishing & the sim settle after the spawns
+    spin_for(executor, warmup)
+    stats_monitor.start_window()
+    for topic_monitor in topic_monitors:
+        topic_monitor.start()
+    start_time = time.monotonic()
+    spin_for(executor, duration)
+    measured_duration = time.monotonic() - start_time
+    for topic_monitor in topic_monitors:
+        topic_monitor.stop()
+
+    topics_results = {topic_monitor.topic_name: topic_monitor.get_results(measured_duration)
+                      for topic_monitor in topic_monitors}
+    rates = [result['rate_hz'] for result in topics_results.values()]
+    write_results({
+        'benchmark': 'sensors',
+        'robot_models': robot_models,
+        'requested_robots': robot_num,
+        'spawned_robots': len(spawned_robots),
+        'duration_s': measured_duration,
+        'rtf': stats_monitor.get_window_rtf(),
+        'rate_min_hz': min(rates, default=0.0),
+        'rate_mean_hz': sum(rates) / len(rates) if rates else 0.0,
+        'topics': topics_results,
+        'sensor_diagnostics': stats_monitor.sensor_diagnostics,
+        'frame_telemetry': stats_monitor.frame_telemetry,
+    }, output_path)
+
+    executor.shutdown()
+    topics_node.destroy_node()
+    stats_monitor.destroy_node()
+    param_node.destroy_node()
+    rclpy.shutdown()
+
+
+if __name__ == '__main__':
+    BenchmarkSensors(sys.argv[:])
@@ -0,0 +1,199 @@
+#! /usr/bin/env python3
+# Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+"""
+Spawn & startup latency benchmark.
+Spawns robot_num robots cycling through robot_models with the SpawnEntities service, or SpawnEntity per robot if
+use_spawn_entities is false, then measures per robot the time-to-ready, ie till the first msg on its ready_topic, eg
+odom. The breakdown per phase (resources loading, URDF/SDF parsing, mesh import, collision cooking, actor spawn & ROS
+interface init) is the difference of the sim's /startup_profile around the spawns, thus the game mode should have
+bPublishStartupProfile on. Results are written as JSON to output_path.
+
+ros2 run rr_sim_tests benchmark_spawn --ros-args -p robot_models:="['kinematic_burger']" -p robot_num:=50 \
+    -p output_path:=/tmp/spawn.json
+"""
+
+import sys
+import time
+
+# rclpy
+import rclpy
+from rclpy.executors import SingleThreadedExecutor
+from rclpy.node import Node
+from rclpy.qos import qos_profile_sensor_data
+
+# other ros
+from diagnostic_msgs.msg import DiagnosticArray
+from nav_msgs.msg import Odometry
+from sensor_msgs.msg import Image, LaserScan, PointCloud2
+
+# UE_msgs
+from ue_msgs.msg import EntityState
+from ue_msgs.srv import SpawnEntities, SpawnEntity
+
+# rr_sim_tests
+from rr_sim_tests.utils.benchmark import diagnostic_values, grid_pose, percentile, write_results
+from rr_sim_tests.utils.wait_for_service import wait_for_service
+
+TOPIC_NAME_STARTUP_PROFILE = '/startup_profile'
+SERVICE_NAME_SPAWN_ENTITY = 'SpawnEntity'
+SERVICE_NAME_SPAWN_ENTITIES = 'SpawnEntities'
+READY_MSG_TYPES = {
+    'Odometry': Odometry,
+    'LaserScan': LaserScan,
+    'PointCloud2': PointCloud2,
+    'Image': Image,
+}
+
+
+class ParamsNode(Node):
+    def __init__(self):
+        super().__init__('benchmark_spawn_params')
+        self.declare_parameters(
+            namespace='',
+            parameters=[
+                ('robot_models', ['kinematic_burger']),
+                ('robot_name_prefix', 'spawn_bench'),
+                ('robot_num', 10),
+                ('robot_spacing', 2.0),
+                ('use_spawn_entities', True),
+                # {name} is replaced by the robot name
+                ('ready_topic', '/{name}/odom'),
+                ('ready_topic_type', 'Odometry'),
+                ('timeout', 120.0),
+                ('service_namespace', ''),
+                ('output_path', ''),
+            ]
+        )
+
+
+class SpawnBenchmarkNode(Node):
+    def __init__(self):
+        super().__init__('benchmark_spawn')
+        self.startup_profile = None
+        self.startup_profile_time = None
+        self.ready_times = {}
+        self.create_subscription(DiagnosticArray, TOPIC_NAME_STARTUP_PROFILE, self._startup_profile_callback, 10)
+
+    def _startup_profile_callback(self, in_msg):
+        self.startup_profile = {status.name.split('/')[-1]: diagnostic_values(status) for status in in_msg.status}
+        self.startup_profile_time = time.monotonic()
+
+    def watch_ready_topic(self, in_robot_name, in_topic_name, in_msg_type):
+        def callback(_):
+            self.ready_times.setdefault(in_robot_name, time.monotonic())
+        self.create_subscription(in_msg_type, in_topic_name, callback, qos_profile_sensor_data)
+
+
+def spin_until(in_executor, in_condition, in_timeout):
+    end_time = time.monotonic() + in_timeout
+    while rclpy.ok() and not in_condition() and time.monotonic() < end_time:
+        in_executor.spin_once(timeout_sec=0.01)
+    return in_condition()
+
+
+def make_entity_state(in_robot_name, in_index, in_spacing):
+    state = EntityState()
+    state.name = in_robot_name
+    state.reference_frame = ''
+    state.pose = grid_pose(in_index, in_spacing)
+    return state
+
+
+def profile_delta(in_before, in_after):
+    """
+    Per phase count & time spent between two /startup_profile msgs
+    """
+    delta = {}
+    for phase, after in (in_after or {}).items():
+        before = (in_before or {}).get(phase, {})
+        count = after.get('count', 0.0) - before.get('count', 0.0)
+        total_ms = after.get('total_ms', 0.0) - before.get('total_ms', 0.0)
+        delta[phase] = {
+            'count': count,
+            'total_ms': total_ms,
+            'mean_ms': total_ms / count if count > 0 else 0.0,
+            # Max since the sim start, not only over the spawns
+            'max_ms': after.get('max_ms', 0.0),
+        }
+    return delta
+
+
+def BenchmarkSpawn(args=None):
+    rclpy.init(args=args)
+    param_node = ParamsNode()
+    robot_models = param_node.get_parameter('robot_models').value
+    robot_name_prefix = param_node.get_parameter('robot_name_prefix').value
+    robot_num = param_node.get_parameter('robot_num').value
+    robot_spacing = param_node.get_parameter('robot_spacing').value
+    use_spawn_entities = param_node.get_parameter('use_spawn_entities').value
+    ready_topic = param_node.get_parameter('ready_topic').value
+    ready_msg_type = READY_MSG_TYPES[param_node.get_parameter('ready_topic_type').value]
+    timeout = param_node.get_parameter('timeout').value
+    service_namespace = param_node.get_parameter('service_namespace').value
+    output_path = param_node.get_parameter('output_path').value
+
+    node = SpawnBenchmarkNode()
+    executor = SingleThreadedExecutor()
+    executor.add_node(node)
+    robot_names = [f'{robot_name_prefix}{i}' for i in range(robot_num)]
+    for robot_name in robot_names:
+        node.watch_ready_topic(robot_name, ready_topic.format(name=robot_name), ready_msg_type)
+
+    # Baseline profile, including the sim startup itself
+    if not spin_until(executor, lambda: node.startup_profile is not None, 5.0):
+        print(f'No {TOPIC_NAME_STARTUP_PROFILE} received, the breakdown will be empty')
+    profile_before = node.startup_profile
+
+    service_name = service_namespace + '/' + (SERVICE_NAME_SPAWN_ENTITIES if use_spawn_entities else SERVICE_NAME_SPAWN_ENTITY)
+    cli = wait_for_service(node, SpawnEntities if use_spawn_entities else SpawnEntity, service_name)
+    futures = []
+    start_time = time.monotonic()
+    if use_spawn_entities:
+        req = SpawnEntities.Request()
+        req.type = [robot_models[i % len(robot_models)] for i in range(robot_num)]
+        req.state = [make_entity_state(robot_name, i, robot_spacing) for i, robot_name in enumerate(robot_names)]
+        req.tags = []
+        futures.append(cli.call_async(req))
+    else:
+        for i, robot_name in enumerate(robot_names):
+            req = SpawnEntity.Request()
+            req.xml = robot_models[i % len(robot_models)]
+            req.robot_namespace = robot_name
+            req.state = make_entity_state(robot_name, i, robot_spacing)
+            req.tags = []
+            futures.append(cli.call_async(req))
+
+    spin_until(executor, lambda: all(future.done() for future in futures), timeout)
+    service_duration = time.monotonic() - start_time
+    spin_until(executor, lambda: len(node.ready_times) == robot_num, max(timeout - service_duration, 0.0))
+
+    # Wait for a profile published after the robots got ready
+    profile_request_time = time.monotonic()
+    spin_until(executor, lambda: (node.startup_profile_time or 0.0) > profile_request_time + 1.0, 5.0)
+
+    ready_durations = [ready_time - start_time for ready_time in node.ready_times.values()]
+    write_results({
+        'benchmark': 'spawn',
+        'robot_models': robot_models,
+        'requested_robots': robot_num,
+        'ready_robots': len(ready_durations),
+        'service': SERVICE_NAME_SPAWN_ENTITIES if use_spawn_entities else SERVICE_NAME_SPAWN_ENTITY,
+        'service_success': all(future.done() and future.result().success for future in futures),
+        'service_duration_s': service_duration,
+        'time_to_first_ready_s': min(ready_durations, default=0.0),
+        'time_to_ready_p50_s': percentile(ready_durations, 0.5),
+        'time_to_ready_p95_s': percentile(ready_durations, 0.95),
+        'time_to_all_ready_s': max(ready_durations, default=0.0) if len(ready_durations) == robot_num else None,
+        'sim_startup_profile': profile_before,
+        'phases': profile_delta(profile_before, node.startup_profile),
+    }, output_path)
+
+    executor.shutdown()
+    node.destroy_node()
+    param_node.destroy_node()
+    rclpy.shutdown()
+
+
+if __name__ == '__main__':
+    BenchmarkSpawn(sys.argv[:])
@@ -0,0 +1,120 @@
+#! /usr/bin/env python3
+# Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+import unittest
+
+import launch
+import launch_testing.actions
+import launch_testing.markers
+
+import rclpy
+from rclpy.executors import SingleThreadedExecutor
+from geometry_msgs.msg import Twist
+from rosgraph_msgs.msg import Clock
+
+from rr_sim_tests.utils.benchmark import (
+    SimStatsMonitor,
+    TopicMonitor,
+    check_budgets,
+    load_budgets,
+    spawn_robots_in_grid,
+    spin_for,
+)
+from rr_sim_tests.utils.utils import CmdVelPublisher, remove_robot
+
+import pytest
+
+"""
+Test if /clock keeps its budgeted RTF, rate & jitter under a scripted load: load_robot_num robots of load_robot_model are
+spawned then driven in circles during the measurement, then removed.
+Budgets are taken from the 'clock' section of budgets_path.
+"""
+LAUNCH_ARG_LOAD_ROBOT_MODEL = 'load_robot_model'
+LAUNCH_ARG_LOAD_ROBOT_NUM = 'load_robot_num'
+LAUNCH_ARG_WARMUP = 'warmup'
+LAUNCH_ARG_DURATION = 'duration'
+LAUNCH_ARG_BUDGETS_PATH = 'budgets_path'
+
+TOPIC_NAME_CLOCK = '/clock'
+LOAD_ROBOT_NAME_PREFIX = 'rtf_load'
+LOAD_ROBOT_SPACING = 2.0
+CMD_VEL_PERIOD = 0.1
+
+@pytest.mark.launch_test
+@launch_testing.markers.keep_alive
+def generate_test_description():
+    load_robot_model = launch.substitutions.LaunchConfiguration(LAUNCH_ARG_LOAD_ROBOT_MODEL, default='kinematic_burger')
+    load_robot_num = launch.substitutions.LaunchConfiguration(LAUNCH_ARG_LOAD_ROBOT_NUM, default='10')
+    warmup = launch.substitutions.LaunchConfiguration(LAUNCH_ARG_WARMUP, default='3.0')
+    duration = launch.substitutions.LaunchConfiguration(LAUNCH_ARG_DURATION, default='20.0')
+    budgets_path = launch.substitutions.LaunchConfiguration(LAUNCH_ARG_BUDGETS_PATH, default='')
+
+    return launch.LaunchDescription([
+        launch.actions.DeclareLaunchArgument(
+            LAUNCH_ARG_LOAD_ROBOT_MODEL,
+            default_value=load_robot_model,
+            description='Model of the load robots'),
+        launch.actions.DeclareLaunchArgument(
+            LAUNCH_ARG_LOAD_ROBOT_NUM,
+            default_value=load_robot_num,
+            description='Num of load robots, 0 to measure the idle sim'),
+        launch.actions.DeclareLaunchArgument(
+            LAUNCH_ARG_WARMUP,
+            default_value=warmup,
+            description='[s] Wait after the spawns before measuring'),
+        launch.actions.DeclareLaunchArgument(
+            LAUNCH_ARG_DURATION,
+            default_value=duration,
+            description='[s] Measurement duration'),
+        launch.actions.DeclareLaunchArgument(
+            LAUNCH_ARG_BUDGETS_PATH,
+            default_value=budgets_path,
+            description='Budgets JSON file, the package config/perf_budgets.json if empty'),
+        launch_testing.actions.ReadyToTest()
+    ])
+
+class TestClockRTF(unittest.TestCase):
+    def test_clock_rtf_within_budgets(self, proc_output, test_args):
+        argstr = lambda arg: str(test_args[arg]).strip() if arg in test_args else ''
+        budgets = load_budgets(argstr(LAUNCH_ARG_BUDGETS_PATH)).get('clock', {})
+        load_robot_num = int(argstr(LAUNCH_ARG_LOAD_ROBOT_NUM) or 10)
+
+        rclpy.init()
+        load_robots = spawn_robots_in_grid([argstr(LAUNCH_ARG_LOAD_ROBOT_MODEL) or 'kinematic_burger'],
+                                           LOAD_ROBOT_NAME_PREFIX, load_robot_num, LOAD_ROBOT_SPACING)
+        assert len(load_robots) == load_robot_num, f'Only {len(load_robots)}/{load_robot_num} load robots spawned!'
+
+        twist = Twist()
+        twist.linear.x = 0.5
+        twist.angular.z = 0.5
+        cmd_vel_publishers = [CmdVelPublisher(in_robot_namespace=robot_name, publishing_freq=0, publishing_num=0,
+                                              in_robot_twist=twist) for robot_name in load_robots]
+        stats_monitor = SimStatsMonitor()
+        node = rclpy.create_node('test_clock_rtf')
+        executor = SingleThreadedExecutor()
+        executor.add_node(stats_monitor)
+        executor.add_node(node)
+        clock_monitor = TopicMonitor(node, TOPIC_NAME_CLOCK, Clock)
+        node.create_timer(CMD_VEL_PERIOD, lambda: [cmd_vel_publisher.pub() for cmd_vel_publisher in cmd_vel_publishers])
+
+        spin_for(executor, float(argstr(LAUNCH_ARG_WARMUP) or 3.0))
+        stats_monitor.start_window()
+        clock_monitor.start()
+        duration = float(argstr(LAUNCH_ARG_DURATION) or 20.0)
+        spin_for(executor, duration)
+        clock_monitor.stop()
+
+        results = clock_monitor.get_results(duration)
+        results['rtf'] = stats_monitor.get_window_rtf()
+        print(f'{TOPIC_NAME_CLOCK} with {len(load_robots)} load robots: {results}')
+        violations = check_budgets(TOPIC_NAME_CLOCK, results, budgets)
+
+        executor.shutdown()
+        node.destroy_node()
+        stats_monitor.destroy_node()
+        for cmd_vel_publisher in cmd_vel_publishers:
+            cmd_vel_publisher.destroy_node()
+        for robot_name in load_robots:
+            remove_robot(robot_name)
+        rclpy.shutdown()
+        assert not violations, 'Clock over budgets:\n' + '\n'.join(violations)
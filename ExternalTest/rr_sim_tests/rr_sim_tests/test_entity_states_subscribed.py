@@ -0,0 +1,98 @@
+#! /usr/bin/env python3
+# Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+import time
+import unittest
+
+import launch
+import launch_testing.actions
+import launch_testing.markers
+
+import rclpy
+from rclpy.node import Node
+from gazebo_msgs.msg import ModelStates
+from std_msgs.msg import String
+
+import pytest
+
+"""
+Test if the states of [robot_name] are pushed on /entity_states/<id> once subscribed on /entity_state_subscriptions,
+then stop being pushed once unsubscribed
+"""
+LAUNCH_ARG_ROBOT_NAME = 'robot_name'
+LAUNCH_ARG_FREQUENCY = 'frequency'
+
+TOPIC_NAME_SUBSCRIPTIONS = '/entity_state_subscriptions'
+SUBSCRIPTION_ID = 'rr_sim_tests'
+
+class EntityStatesSubscriber(Node):
+    def __init__(self, in_entity_name: str, in_frequency: int):
+        super().__init__('entity_states_subscriber')
+        self._entity_name = in_entity_name
+        self._frequency = in_frequency
+        self._received_num = 0
+        self._subscriptions_publisher = self.create_publisher(String, TOPIC_NAME_SUBSCRIPTIONS, 10)
+        self.create_subscription(ModelStates, f'/entity_states/{SUBSCRIPTION_ID}', self.on_entity_states_published, 10)
+
+    @property
+    def received_num(self):
+        return self._received_num
+
+    def subscribe(self, in_frequency: int):
+        msg = String()
+        msg.data = f'{SUBSCRIPTION_ID} {in_frequency} {self._entity_name}'
+        self._subscriptions_publisher.publish(msg)
+
+    def on_entity_states_published(self, msg):
+        if self._entity_name in msg.name:
+            self._received_num += 1
+
+    def spin_for(self, in_duration: float):
+        start_time = time.time()
+        while (time.time() - start_time) < in_duration:
+            rclpy.spin_once(self, timeout_sec=0.1)
+
+    def wait_for_received_num(self, in_num: int, in_timeout=5.0):
+        start_time = time.time()
+        while (self._received_num < in_num) and ((time.time() - start_time) < in_timeout):
+            # Resent until received, the subscription topic not being latched
+            self.subscribe(self._frequency)
+            self.spin_for(0.5)
+        return self._received_num >= in_num
+
+@pytest.mark.launch_test
+@launch_testing.markers.keep_alive
+def generate_test_description():
+    robot_name = launch.substitutions.LaunchConfiguration(LAUNCH_ARG_ROBOT_NAME, default='')
+    frequency = launch.substitutions.LaunchConfiguration(LAUNCH_ARG_FREQUENCY, default='10')
+    return launch.LaunchDescription([
+        launch.actions.DeclareLaunchArgument(
+            LAUNCH_ARG_ROBOT_NAME,
+            default_value=robot_name,
+            description='Name of the entity whose states are subscribed'),
+        launch.actions.DeclareLaunchArgument(
+            LAUNCH_ARG_FREQUENCY,
+            default_value=frequency,
+            description='[Hz] Subscribed publication frequency'),
+        launch_testing.actions.ReadyToTest()
+    ])
+
+class TestEntityStatesSubscribed(unittest.TestCase):
+    def test_entity_states_subscribed(self, proc_output, test_args):
+        argstr = lambda arg: str(test_args[arg]).strip() if arg in test_args else ''
+        robot_name = argstr(LAUNCH_ARG_ROBOT_NAME)
+        assert len(robot_name) > 0, f'{LAUNCH_ARG_ROBOT_NAME} is required'
+
+        rclpy.init()
+        subscriber = EntityStatesSubscriber(robot_name, int(argstr(LAUNCH_ARG_FREQUENCY) or 10))
+        assert subscriber.wait_for_received_num(3, in_timeout=10.0), f'No states of {robot_name} pushed!'
+
+        # Unsubscribed: at most the msgs already in flight are received
+        subscriber.subscribe(0)
+        subscriber.spin_for(1.0)
+        received_num = subscriber.received_num
+        subscriber.spin_for(1.0)
+        assert subscriber.received_num == received_num, 'States still pushed after unsubscribing!'
+
+        subscriber.destroy_node()
+        rclpy.shutdown()
@@ -2,6 +2,7 @@
 # Copyright 2020-2021 Rapyuta Robotics Co., Ltd.
 
 import os
+import sys
 import time
 import random
 import numpy as np
@@ -12,6 +13,7 @@ from rclpy.parameter import Parameter
 from geometry_msgs.msg import Pose, Twist
 from tf_transformations import quaternion_from_euler
 
+from rr_sim_tests.utils.benchmark import check_budgets, load_budgets, percentile
 from rr_sim_tests.utils.utils import CmdVelPublisher
 from rr_sim_tests.utils.utils import spawn_robot
 from rr_sim_tests.utils.wait_for_spawned_entity import wait_for_spawned_entity
@@ -30,20 +32,27 @@ class ParamsNode(Node):
             ('robot_name_prefix', 'amr'),
             ('start_index', 1),
             ('robot_num', 1),
-            ('service_namespace', '')
+            ('service_namespace', ''),
+            # Spawn latencies are checked against the 'spawn' section of budgets_path, exiting on violations if
+            # fail_on_budgets, else only reported
+            ('budgets_path', ''),
+            ('fail_on_budgets', False)
         ]
     )
 
 def SpawnRobotInArea(robot_name, x_lim, y_lim, service_namespace, robot_models):
+    """
+    @return whether the robot got spawned & its spawn latency [s], retries included
+    """
     # sanity check
     if robot_name is None:
         print('You need to provide robot name with `--ros-args -p robot_name:=<name>`')
-        return False
+        return False, 0.0
 
     is_robot_spawned, _ = wait_for_spawned_entity(robot_name, 10.0, service_namespace)
     if is_robot_spawned:
         print(robot_name + ' already exists.')
-        return False
+        return False, 0.0
 
     # spawn robot
     robot_namespace = robot_name
@@ -52,6 +61,7 @@ def SpawnRobotInArea(robot_name, x_lim, y_lim, service_namespace, robot_models):
     robot_pose = Pose()
 
     is_robot_spawned = False
+    start_time = time.monotonic()
     while not is_robot_spawned:
         q = quaternion_from_euler(0.0, 0.0, random.uniform(-np.pi, np.pi))
         robot_pose.position.x = float(random.uniform(x_lim[0], x_lim[1]))
@@ -73,7 +83,7 @@ def SpawnRobotInArea(robot_name, x_lim, y_lim, service_namespace, robot_models):
                     break
                 count += 1
     
-    return is_robot_spawned
+    return is_robot_spawned, time.monotonic() - start_time
 
 def RandomSpawnAndSendCmdVel(args=None):
     rclpy.init(args=args)
@@ -97,14 +107,31 @@ def RandomSpawnAndSendCmdVel(args=None):
     start_index = param_node.get_parameter('start_index').value
     robot_num = param_node.get_parameter('robot_num').value
     service_namespace = param_node.get_parameter('service_namespace').value
+    budgets_path = param_node.get_parameter('budgets_path').value
+    fail_on_budgets = param_node.get_parameter('fail_on_budgets').value
 
     spawned_robots = {}
+    spawn_latencies = []
     for i in range(start_index, start_index + robot_num):
         robot_name = robot_name_prefix + str(i)
-        res = SpawnRobotInArea(robot_name, x_lim, y_lim, service_namespace, robot_models)
+        res, spawn_latency = SpawnRobotInArea(robot_name, x_lim, y_lim, service_namespace, robot_models)
         if res:
+            spawn_latencies.append(spawn_latency)
             spawned_robots[robot_name] = CmdVelPublisher(in_robot_namespace=robot_name, publishing_freq=0, publishing_num=0, in_robot_twist=None)
 
+    spawn_results = {
+        'latency_s': max(spawn_latencies, default=0.0),
+        'latency_p95_s': percentile(spawn_latencies, 0.95),
+        'latency_mean_s': sum(spawn_latencies) / len(spawn_latencies) if spawn_latencies else 0.0,
+    }
+    print(f'Spawned {len(spawn_latencies)}/{robot_num} robots: {spawn_results}')
+    violations = check_budgets('random spawn', spawn_results, load_budgets(budgets_path).get('spawn', {}))
+    if violations:
+        print('Spawn over budgets:\n' + '\n'.join(violations))
+        if fail_on_budgets:
+            rclpy.shutdown()
+            sys.exit(1)
+
     # publish cmd_vel
     while True:
         # create random twist
@@ -11,9 +11,7 @@ import launch_testing.markers
 import rclpy
 from rclpy.node import Node
 
-from ue_msgs.srv import DeleteEntity
-
-from rr_sim_tests.utils.wait_for_service import wait_for_service
+from rr_sim_tests.utils.utils import remove_robot
 from rr_sim_tests.utils.wait_for_spawned_entity import wait_for_spawned_entity
 
 import pytest
@@ -22,7 +20,6 @@ import pytest
 Test robot removal
 """
 LAUNCH_ARG_ROBOT_NAME = 'robot_name'
-SERVICE_NAME_DELETE_ENTITY = 'DeleteEntity'
 
 @pytest.mark.launch_test
 @launch_testing.markers.keep_alive
@@ -38,29 +35,6 @@ def generate_test_description():
         launch_testing.actions.ReadyToTest()
     ])
 
-def remove_robot(in_robot_name, in_timeout=5.0):
-    assert(len(in_robot_name) > 0)
-    node = rclpy.create_node(f'spawn_{in_robot_name}')
-    cli = wait_for_service(node, DeleteEntity, SERVICE_NAME_DELETE_ENTITY)
-    if not cli.service_is_ready():
-        return False
-
-    # Prepare DeleteEntity request
-    req = DeleteEntity.Request()
-    req.name = in_robot_name
-
-    # Async invoke DeleteEntity service
-    future = cli.call_async(req)
-    try:
-        start = time.time()
-        while (time.time() - start < in_timeout):
-            rclpy.spin_once(node)
-            if future.done():
-                break
-    finally:
-        node.destroy_node()
-    return True
-
 class TestRobotRemove(unittest.TestCase):
     def test_remove_robot(self, proc_output, test_args):
         rclpy.init()
@@ -1,6 +1,7 @@
 #! /usr/bin/env python3
 # Copyright 2020-2021 Rapyuta Robotics Co., Ltd.
 
+import time
 import unittest
 
 import launch
@@ -12,13 +13,15 @@ import rclpy
 from geometry_msgs.msg import Pose
 from tf_transformations import quaternion_from_euler
 
+from rr_sim_tests.utils.benchmark import check_budgets, load_budgets
 from rr_sim_tests.utils.wait_for_spawned_entity import wait_for_spawned_entity
 from rr_sim_tests.utils.utils import spawn_robot
 
 import pytest
 
 """
-Test robot spawning
+Test robot spawning, within the 'spawn' section's max_latency_s of budgets_path.
+The latency spans the SpawnEntity call till GetEntityState finds the robot, polled every 0.5s.
 """
 LAUNCH_ARG_ROBOT_MODEL = 'robot_model'
 LAUNCH_ARG_ROBOT_NAMESPACE = 'robot_namespace'
@@ -28,6 +31,7 @@ LAUNCH_ARG_ROBOT_POS = 'robot_pos'
 LAUNCH_ARG_ROBOT_ROT = 'robot_rot'
 LAUNCH_ARG_ROBOT_TAGS = 'robot_tags'
 LAUNCH_ARG_ROBOT_JSON = 'robot_json'
+LAUNCH_ARG_BUDGETS_PATH = 'budgets_path'
 
 SERVICE_NAME_SPAWN_ENTITY = 'SpawnEntity'
 
@@ -42,6 +46,7 @@ def generate_test_description():
     robot_rot = launch.substitutions.LaunchConfiguration(LAUNCH_ARG_ROBOT_ROT, default='0.0, 0.0, 0.0')
     robot_tags = launch.substitutions.LaunchConfiguration(LAUNCH_ARG_ROBOT_TAGS, default='')
     robot_json = launch.substitutions.LaunchConfiguration(LAUNCH_ARG_ROBOT_JSON, default='')
+    budgets_path = launch.substitutions.LaunchConfiguration(LAUNCH_ARG_BUDGETS_PATH, default='')
 
     return launch.LaunchDescription([
         launch.actions.DeclareLaunchArgument(
@@ -76,6 +81,10 @@ def generate_test_description():
             LAUNCH_ARG_ROBOT_JSON,
             default_value=robot_tags,
             description="Robot json configs"),
+        launch.actions.DeclareLaunchArgument(
+            LAUNCH_ARG_BUDGETS_PATH,
+            default_value=budgets_path,
+            description='Budgets JSON file, the package config/perf_budgets.json if empty'),
         launch_testing.actions.ReadyToTest()
     ])
 class TestRobotSpawn(unittest.TestCase):
@@ -104,6 +113,7 @@ class TestRobotSpawn(unittest.TestCase):
 
         robot_tags = argstr(LAUNCH_ARG_ROBOT_TAGS).split(',')
         robot_json = argstr(LAUNCH_ARG_ROBOT_JSON)
+        start_time = time.monotonic()
         assert spawn_robot(argstr(LAUNCH_ARG_ROBOT_MODEL),
                            robot_name,
                            argstr(LAUNCH_ARG_ROBOT_NAMESPACE),
@@ -113,4 +123,10 @@ class TestRobotSpawn(unittest.TestCase):
                            in_robot_json=robot_json)
         is_robot_spawned, _ = wait_for_spawned_entity(robot_name, 8.0)
         assert is_robot_spawned, f'{robot_name} failed being spawned!'
+
+        latency = time.monotonic() - start_time
+        print(f'{robot_name} spawned in {latency:.3f}s')
+        violations = check_budgets(robot_name, {'latency_s': latency},
+                                   load_budgets(argstr(LAUNCH_ARG_BUDGETS_PATH)).get('spawn', {}))
+        assert not violations, 'Spawn over budgets:\n' + '\n'.join(violations)
         rclpy.shutdown()
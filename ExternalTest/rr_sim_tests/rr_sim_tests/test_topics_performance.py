@@ -0,0 +1,110 @@
+#! /usr/bin/env python3
+# Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+import unittest
+
+import launch
+import launch_testing.actions
+import launch_testing.markers
+
+import rclpy
+from rclpy.executors import SingleThreadedExecutor
+from nav_msgs.msg import Odometry
+from sensor_msgs.msg import Image, LaserScan, PointCloud2
+
+from rr_sim_tests.utils.benchmark import SimStatsMonitor, TopicMonitor, check_budgets, load_budgets, spin_for
+from rr_sim_tests.utils.wait_for_topics import WaitForTopics
+
+import pytest
+
+"""
+Test if topics are published at their budgeted rate, jitter & latency.
+Budgets are taken per topic name from the 'topics' section of budgets_path, its 'default' entry applying to all topics.
+"""
+LAUNCH_ARG_TOPICS = 'topics'
+LAUNCH_ARG_ROBOT_NAMESPACE = 'robot_namespace'
+LAUNCH_ARG_WARMUP = 'warmup'
+LAUNCH_ARG_DURATION = 'duration'
+LAUNCH_ARG_BUDGETS_PATH = 'budgets_path'
+
+TOPIC_MSG_TYPES = {
+    'LaserScan': LaserScan,
+    'PointCloud2': PointCloud2,
+    'Image': Image,
+    'Odometry': Odometry,
+}
+
+@pytest.mark.launch_test
+@launch_testing.markers.keep_alive
+def generate_test_description():
+    topics = launch.substitutions.LaunchConfiguration(LAUNCH_ARG_TOPICS, default='scan:LaserScan,odom:Odometry')
+    robot_namespace = launch.substitutions.LaunchConfiguration(LAUNCH_ARG_ROBOT_NAMESPACE, default='')
+    warmup = launch.substitutions.LaunchConfiguration(LAUNCH_ARG_WARMUP, default='2.0')
+    duration = launch.substitutions.LaunchConfiguration(LAUNCH_ARG_DURATION, default='10.0')
+    budgets_path = launch.substitutions.LaunchConfiguration(LAUNCH_ARG_BUDGETS_PATH, default='')
+
+    return launch.LaunchDescription([
+        launch.actions.DeclareLaunchArgument(
+            LAUNCH_ARG_TOPICS,
+            default_value=topics,
+            description="<topic>:<LaserScan|PointCloud2|Image|Odometry> separated by ','. Eg:'scan:LaserScan'"),
+        launch.actions.DeclareLaunchArgument(
+            LAUNCH_ARG_ROBOT_NAMESPACE,
+            default_value=robot_namespace,
+            description='Robot namespace of the topics'),
+        launch.actions.DeclareLaunchArgument(
+            LAUNCH_ARG_WARMUP,
+            default_value=warmup,
+            description='[s] Wait before measuring'),
+        launch.actions.DeclareLaunchArgument(
+            LAUNCH_ARG_DURATION,
+            default_value=duration,
+            description='[s] Measurement duration'),
+        launch.actions.DeclareLaunchArgument(
+            LAUNCH_ARG_BUDGETS_PATH,
+            default_value=budgets_path,
+            description='Budgets JSON file, the package config/perf_budgets.json if empty'),
+        launch_testing.actions.ReadyToTest()
+    ])
+
+class TestTopicsPerformance(unittest.TestCase):
+    def test_topics_within_budgets(self, proc_output, test_args):
+        argstr = lambda arg: str(test_args[arg]).strip() if arg in test_args else ''
+        robot_namespace = argstr(LAUNCH_ARG_ROBOT_NAMESPACE)
+        topics = [topic.strip().split(':') for topic in (argstr(LAUNCH_ARG_TOPICS) or 'scan:LaserScan').split(',')]
+        topic_names = [f'/{robot_namespace}/{name}' if robot_namespace else name for name, _ in topics]
+        budgets = load_budgets(argstr(LAUNCH_ARG_BUDGETS_PATH)).get('topics', {})
+
+        # Published at all first, to fail distinctly from budget violations
+        with WaitForTopics([(name, TOPIC_MSG_TYPES[msg_type]) for name, (_, msg_type) in zip(topic_names, topics)],
+                           in_timeout=5.0):
+            pass
+
+        rclpy.init()
+        stats_monitor = SimStatsMonitor()
+        node = rclpy.create_node('test_topics_performance')
+        executor = SingleThreadedExecutor()
+        executor.add_node(stats_monitor)
+        executor.add_node(node)
+        topic_monitors = [TopicMonitor(node, name, TOPIC_MSG_TYPES[msg_type], stats_monitor)
+                          for name, (_, msg_type) in zip(topic_names, topics)]
+
+        spin_for(executor, float(argstr(LAUNCH_ARG_WARMUP) or 2.0))
+        for topic_monitor in topic_monitors:
+            topic_monitor.start()
+        duration = float(argstr(LAUNCH_ARG_DURATION) or 10.0)
+        spin_for(executor, duration)
+
+        violations = []
+        for topic_monitor, (topic, _) in zip(topic_monitors, topics):
+            topic_monitor.stop()
+            results = topic_monitor.get_results(duration)
+            print(f'{topic_monitor.topic_name}: {results}')
+            violations += check_budgets(topic_monitor.topic_name, results,
+                                        {**budgets.get('default', {}), **budgets.get(topic, {})})
+
+        executor.shutdown()
+        node.destroy_node()
+        stats_monitor.destroy_node()
+        rclpy.shutdown()
+        assert not violations, 'Topics over budgets:\n' + '\n'.join(violations)
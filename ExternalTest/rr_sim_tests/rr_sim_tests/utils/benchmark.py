@@ -0,0 +1,224 @@
+#! /usr/bin/env python3
+# Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+import json
+import math
+import os
+import platform
+import time
+
+# rclpy
+import rclpy
+from rclpy.node import Node
+from rclpy.qos import qos_profile_sensor_data
+
+# other ros
+from ament_index_python.packages import get_package_share_directory
+from diagnostic_msgs.msg import DiagnosticArray
+from geometry_msgs.msg import Pose
+from rosgraph_msgs.msg import Clock
+
+# rr_sim_tests
+from rr_sim_tests.utils.utils import spawn_robot
+from rr_sim_tests.utils.wait_for_spawned_entity import wait_for_spawned_entity
+
+TOPIC_NAME_CLOCK = '/clock'
+TOPIC_NAME_DIAGNOSTICS = '/diagnostics'
+TOPIC_NAME_FRAME_TELEMETRY = '/frame_telemetry'
+
+# Shipped with the package, see load_budgets()
+DEFAULT_BUDGETS_FILE = 'perf_budgets.json'
+
+
+def stamp_to_sec(in_stamp):
+    return in_stamp.sec + in_stamp.nanosec * 1e-9
+
+
+def percentile(in_values, in_ratio):
+    if not in_values:
+        return 0.0
+    values = sorted(in_values)
+    return values[min(max(int(math.ceil(in_ratio * len(values))) - 1, 0), len(values) - 1)]
+
+
+def grid_pose(in_index, in_spacing, in_z=0.03):
+    """
+    Pose of the in_index-th robot of a square grid centered around the origin, in_spacing [m] apart
+    """
+    side = 1
+    while side * side <= in_index:
+        side += 1
+    pose = Pose()
+    pose.position.x = (in_index % side - 0.5 * (side - 1)) * in_spacing
+    pose.position.y = (in_index // side - 0.5 * (side - 1)) * in_spacing
+    pose.position.z = in_z
+    pose.orientation.w = 1.0
+    return pose
+
+
+def spawn_robots_in_grid(in_robot_models, in_robot_name_prefix, in_robot_num, in_spacing, in_service_namespace='',
+                         in_timeout=10.0):
+    """
+    Spawn in_robot_num robots cycling through in_robot_models with the SpawnEntity service
+    @return names of the spawned robots
+    """
+    spawned_robots = []
+    for i in range(in_robot_num):
+        robot_name = f'{in_robot_name_prefix}{i}'
+        robot_model = in_robot_models[i % len(in_robot_models)]
+        if spawn_robot(robot_model, robot_name, robot_name, '', grid_pose(i, in_spacing), in_service_namespace,
+                       in_robot_tags=[], in_timeout=in_timeout):
+            is_robot_spawned, _ = wait_for_spawned_entity(robot_name, in_timeout, in_service_namespace)
+            if is_robot_spawned:
+                spawned_robots.append(robot_name)
+                continue
+        print(f'Failed to spawn {robot_name} of model {robot_model}')
+    return spawned_robots
+
+
+def spin_for(in_executor, in_duration):
+    end_time = time.monotonic() + in_duration
+    while rclpy.ok() and time.monotonic() < end_time:
+        in_executor.spin_once(timeout_sec=0.01)
+
+
+def diagnostic_values(in_status):
+    values = {}
+    for key_value in in_status.values:
+        try:
+            values[key_value.key] = float(key_value.value)
+        except ValueError:
+            values[key_value.key] = key_value.value
+    return values
+
+
+class TopicMonitor:
+    """
+    Records the reception of msgs on one topic, for its achieved rate, inter-msg jitter & end-to-end latency, ie the sim
+    time at reception minus the msg stamp, given msgs with a header & a SimStatsMonitor
+    """
+
+    def __init__(self, in_node, in_topic_name, in_msg_type, in_stats_monitor=None, in_qos=qos_profile_sensor_data):
+        self.topic_name = in_topic_name
+        self._stats_monitor = in_stats_monitor
+        self._recording = False
+        self.reception_times = []
+        self.latencies = []
+        in_node.create_subscription(in_msg_type, in_topic_name, self._callback, in_qos)
+
+    def start(self):
+        self.reception_times.clear()
+        self.latencies.clear()
+        self._recording = True
+
+    def stop(self):
+        self._recording = False
+
+    def _callback(self, in_msg):
+        if not self._recording:
+            return
+        self.reception_times.append(time.monotonic())
+        header = getattr(in_msg, 'header', None)
+        if header is not None and self._stats_monitor is not None and self._stats_monitor.latest_sim_time is not None:
+            self.latencies.append(self._stats_monitor.latest_sim_time - stamp_to_sec(header.stamp))
+
+    def get_results(self, in_duration):
+        intervals = [t1 - t0 for t0, t1 in zip(self.reception_times, self.reception_times[1:])]
+        mean_interval = sum(intervals) / len(intervals) if intervals else 0.0
+        # Deviation of each interval from the mean one
+        deviations = [abs(interval - mean_interval) for interval in intervals]
+        return {
+            'received_msgs': len(self.reception_times),
+            'rate_hz': len(self.reception_times) / in_duration if in_duration > 0 else 0.0,
+            'interval_mean_ms': 1000.0 * mean_interval,
+            'interval_p95_ms': 1000.0 * percentile(intervals, 0.95),
+            'interval_max_ms': 1000.0 * max(intervals, default=0.0),
+            'jitter_stddev_ms': 1000.0 * math.sqrt(sum(d * d for d in deviations) / len(deviations)) if deviations else 0.0,
+            'jitter_p95_ms': 1000.0 * percentile(deviations, 0.95),
+            'latency_mean_ms': 1000.0 * sum(self.latencies) / len(self.latencies) if self.latencies else 0.0,
+            'latency_p95_ms': 1000.0 * percentile(self.latencies, 0.95),
+            'latency_max_ms': 1000.0 * max(self.latencies, default=0.0),
+        }
+
+
+class SimStatsMonitor(Node):
+    """
+    Tracks /clock for the RTF, plus the latest sensor diagnostics & frame telemetry published by the sim
+    (ARRROS2GameMode::bPublishSensorDiagnostics & URRROS2FrameTelemetryPublisher)
+    """
+
+    def __init__(self, in_node_name='sim_stats_monitor'):
+        super().__init__(node_name=in_node_name)
+        self.create_subscription(Clock, TOPIC_NAME_CLOCK, self._clock_callback, qos_profile_sensor_data)
+        self.create_subscription(DiagnosticArray, TOPIC_NAME_DIAGNOSTICS, self._diagnostics_callback, 10)
+        self.create_subscription(DiagnosticArray, TOPIC_NAME_FRAME_TELEMETRY, self._frame_telemetry_callback, 10)
+        self.latest_sim_time = None
+        self.sensor_diagnostics = {}
+        self.frame_telemetry = {}
+        self._window_start = None
+
+    def _clock_callback(self, in_msg):
+        self.latest_sim_time = stamp_to_sec(in_msg.clock)
+
+    def _diagnostics_callback(self, in_msg):
+        for status in in_msg.status:
+            self.sensor_diagnostics[status.name] = diagnostic_values(status)
+
+    def _frame_telemetry_callback(self, in_msg):
+        for status in in_msg.status:
+            self.frame_telemetry[status.name] = diagnostic_values(status)
+
+    def start_window(self):
+        self._window_start = (time.monotonic(), self.latest_sim_time)
+
+    def get_window_rtf(self):
+        if self._window_start is None or self._window_start[1] is None or self.latest_sim_time is None:
+            return 0.0
+        wall_duration = time.monotonic() - self._window_start[0]
+        return (self.latest_sim_time - self._window_start[1]) / wall_duration if wall_duration > 0 else 0.0
+
+
+def load_budgets(in_budgets_path=''):
+    """
+    Load performance budgets from a JSON file, the package's DEFAULT_BUDGETS_FILE if in_budgets_path is empty.
+    Budgets are grouped per section, eg 'clock', 'spawn' or 'topics' then per topic name, each a dict of
+    'min_<metric>' & 'max_<metric>' bounds checked by check_budgets()
+    """
+    if not in_budgets_path:
+        in_budgets_path = os.path.join(get_package_share_directory('rr_sim_tests'), 'config', DEFAULT_BUDGETS_FILE)
+    with open(in_budgets_path, 'r') as budgets_file:
+        return json.load(budgets_file)
+
+
+def check_budgets(in_name, in_metrics, in_budgets):
+    """
+    Check metrics against 'min_<metric>' & 'max_<metric>' budgets, ignoring budgets of metrics not measured
+    @return violation descriptions, empty if all budgets are met
+    """
+    violations = []
+    for budget_name, bound in (in_budgets or {}).items():
+        is_min = budget_name.startswith('min_')
+        if not is_min and not budget_name.startswith('max_'):
+            continue
+        metric = in_metrics.get(budget_name[4:])
+        if metric is None:
+            continue
+        if (is_min and metric < bound) or (not is_min and metric > bound):
+            violations.append(f'{in_name}: {budget_name[4:]}={metric:.3f} {"<" if is_min else ">"} budget {bound}')
+    return violations
+
+
+def write_results(in_results, in_output_path):
+    """
+    Write in_results as JSON, with the host & time of the run, to in_output_path or stdout if empty
+    """
+    in_results['host'] = platform.node()
+    in_results['unix_time'] = time.time()
+    output = json.dumps(in_results, indent=2, sort_keys=True)
+    if in_output_path:
+        os.makedirs(os.path.dirname(os.path.abspath(in_output_path)), exist_ok=True)
+        with open(in_output_path, 'w') as output_file:
+            output_file.write(output)
+        print(f'Benchmark results written to {in_output_path}')
+    else:
+        print(output)
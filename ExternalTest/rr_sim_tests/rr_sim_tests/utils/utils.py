@@ -19,9 +19,10 @@ from rr_sim_tests.utils.wait_for_spawned_entity import wait_for_spawned_entity
 
 # UE_msgs
 from ue_msgs.msg import EntityState
-from ue_msgs.srv import SpawnEntity
+from ue_msgs.srv import DeleteEntity, SpawnEntity
 
 SERVICE_NAME_SPAWN_ENTITY = "SpawnEntity"
+SERVICE_NAME_DELETE_ENTITY = "DeleteEntity"
 
 
 def spawn_robot(
@@ -69,6 +70,32 @@ def spawn_robot(
     return True
 
 
+def remove_robot(in_robot_name, in_service_namespace="", in_timeout=5.0):
+    assert len(in_robot_name) > 0
+    node = rclpy.create_node(f"remove_{in_robot_name}")
+    cli = wait_for_service(
+        node, DeleteEntity, in_service_namespace + "/" + SERVICE_NAME_DELETE_ENTITY
+    )
+    if not cli.service_is_ready():
+        return False
+
+    # Prepare DeleteEntity request
+    req = DeleteEntity.Request()
+    req.name = in_robot_name
+
+    # Async invoke DeleteEntity service
+    future = cli.call_async(req)
+    try:
+        start = time.time()
+        while (time.time() - start) < in_timeout:
+            rclpy.spin_once(node)
+            if future.done():
+                break
+    finally:
+        node.destroy_node()
+    return True
+
+
 TOPIC_NAME_CMD_VEL = "cmd_vel"
 PUBLISHING_NUM = 1
 PUBLISHING_FREQ = 10
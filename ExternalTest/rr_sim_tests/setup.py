@@ -10,6 +10,7 @@ setup(
         ('share/ament_index/resource_index/packages',
             ['resource/' + package_name]),
         ('share/' + package_name, ['package.xml']),
+        ('share/' + package_name + '/config', ['config/perf_budgets.json']),
     ],
     install_requires=['setuptools'],
     zip_safe=True,
@@ -21,6 +22,8 @@ setup(
     entry_points={
         'console_scripts': [
             'test_random_spawn = rr_sim_tests.test_random_spawn:RandomSpawnAndSendCmdVel',
+            'benchmark_sensors = rr_sim_tests.benchmark_sensors:BenchmarkSensors',
+            'benchmark_spawn = rr_sim_tests.benchmark_spawn:BenchmarkSpawn',
         ],
     },
 )
@@ -3,6 +3,7 @@
 #include "Core/RRActorCommon.h"
 
 // UE
+#include "HAL/IConsoleManager.h"
 
 // RapyutaSimulationPlugins
 #include "Core/RRCamera.h"
@@ -216,6 +217,90 @@ URRActorCommon::URRActorCommon()
 {
 }
 
+static TAutoConsoleVariable<bool> CVarSegMaskInstanceIds(
+    TEXT("rr.SegMask.InstanceIds"),
+    false,
+    TEXT("Store entities' seg mask ids as 24-bit instance ids in custom primitive data, instead of 8-bit custom depth stencil "
+         "values, to be output by their materials. Must be set before any entity is spawned."),
+    ECVF_Default);
+
+bool URRActorCommon::IsSegMaskInstanceIdEnabled()
+{
+    return CVarSegMaskInstanceIds.GetValueOnGameThread();
+}
+
+int32 URRActorCommon::GenerateUniqueDepthStencilValue()
+{
+    if (!SegMaskIdAllocator.IsInitialized())
+    {
+        SegMaskIdAllocator.Initialize(
+            IsSegMaskInstanceIdEnabled() ? FRRSegMaskIdAllocator::MAX_INSTANCE_ID : MAX_CUSTOM_DEPTH_STENCIL_VALUES_NUM,
+            &StaticCustomDepthStencilList);
+    }
+    const int32 id = SegMaskIdAllocator.Allocate();
+    if (id > SegMaskIdAllocator.GetMaxId())
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore,
+                         Error,
+                         TEXT("SceneInstance[%d] [%d] More than %d seg mask ids having been assigned! "
+                              "Segmentation Mask will be duplicated!"),
+                         SceneInstanceId,
+                         id,
+                         SegMaskIdAllocator.GetMaxId());
+    }
+    return id;
+}
+
+// ===================================================================================================================================
+// [FRRSegMaskIdAllocator] --
+//
+void FRRSegMaskIdAllocator::Initialize(const int32 InMaxId, const TArray<int32>* InReservedIds)
+{
+    MaxId = InMaxId;
+    ReservedIds = InReservedIds;
+    Reset();
+}
+
+int32 FRRSegMaskIdAllocator::Allocate()
+{
+    int32 id = 0;
+    if (FreeIds.Num() > 0)
+    {
+        id = FreeIds.Pop(false);
+    }
+    else
+    {
+        // Fetch the next non-reserved id, each id being passed by the counter once only
+        do
+        {
+            ++LatestId;
+        } while (ReservedIds && ReservedIds->Contains(LatestId));
+        id = LatestId;
+        AllocatedFlags.SetNum(id + 1, false);
+    }
+    AllocatedFlags[id] = true;
+    ++AllocatedNum;
+    return id;
+}
+
+void FRRSegMaskIdAllocator::Release(const int32 InId)
+{
+    if ((InId > 0) && (InId < AllocatedFlags.Num()) && AllocatedFlags[InId])
+    {
+        AllocatedFlags[InId] = false;
+        --AllocatedNum;
+        FreeIds.Push(InId);
+    }
+}
+
+void FRRSegMaskIdAllocator::Reset()
+{
+    LatestId = 0;
+    AllocatedNum = 0;
+    FreeIds.Reset();
+    AllocatedFlags.Reset();
+}
+
 void URRActorCommon::PrintSimConfig() const
 {
     UE_LOG(LogRapyutaCore, Verbose, TEXT("ACTOR COMMON CONFIG -----------------------------"));
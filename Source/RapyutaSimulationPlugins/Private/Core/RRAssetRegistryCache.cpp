@@ -0,0 +1,135 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRAssetRegistryCache.h"
+
+// UE
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+// RapyutaSimulationPlugins
+#include "RapyutaSimulationPlugins.h"
+
+static TAutoConsoleVariable<bool> CVarAssetRegistryCacheEnabled(
+    TEXT("rr.AssetRegistryCache.Enabled"),
+    true,
+    TEXT("Whether asset lists collated from the asset registry are cached on disk by FRRAssetRegistryCache."),
+    ECVF_Default);
+
+bool FRRAssetRegistryCache::IsEnabled()
+{
+    return CVarAssetRegistryCacheEnabled.GetValueOnAnyThread();
+}
+
+FString FRRAssetRegistryCache::GetCacheFilePath(const FString& InClassName, const FString& InAssetsPath)
+{
+    return FPaths::Combine(FPaths::ProjectSavedDir(),
+                           TEXT("RRAssetRegistryCache"),
+                           FString::Printf(TEXT("%s_v%u.rracr"), *FMD5::HashAnsiString(*(InClassName + InAssetsPath)), VERSION));
+}
+
+FString FRRAssetRegistryCache::GetPackagesSignature(const FString& InAssetsPath)
+{
+    FString directory;
+    if (!FPackageName::TryConvertLongPackageNameToFilename(InAssetsPath / TEXT(""), directory))
+    {
+        return FString();
+    }
+
+    // Sorted, as directory iteration order is not guaranteed
+    TArray<FString> packageStats;
+    IFileManager::Get().IterateDirectoryStatRecursively(
+        *directory,
+        [&directory, &packageStats](const TCHAR* InFilePath, const FFileStatData& InStatData)
+        {
+            if (!InStatData.bIsDirectory && FPackageName::IsPackageExtension(*FPaths::GetExtension(InFilePath, true)))
+            {
+                FString relativePath = InFilePath;
+                FPaths::MakePathRelativeTo(relativePath, *directory);
+                packageStats.Emplace(FString::Printf(
+                    TEXT("%s|%lld|%lld"), *relativePath, InStatData.FileSize, InStatData.ModificationTime.GetTicks()));
+            }
+            return true;
+        });
+    packageStats.Sort();
+
+    FMD5 md5;
+    for (const auto& packageStat : packageStats)
+    {
+        const FTCHARToUTF8 utf8(*packageStat);
+        md5.Update(reinterpret_cast<const uint8*>(utf8.Get()), utf8.Length() + 1);
+    }
+    FMD5Hash hash;
+    hash.Set(md5);
+    return LexToString(hash);
+}
+
+bool FRRAssetRegistryCache::Load(const FString& InClassName,
+                                 const FString& InAssetsPath,
+                                 const FString& InSignature,
+                                 TArray<FRRCachedAssetInfo>& OutAssetInfoList)
+{
+    const FString cacheFilePath = GetCacheFilePath(InClassName, InAssetsPath);
+    TArray<uint8> data;
+    if (!FFileHelper::LoadFileToArray(data, *cacheFilePath, FILEREAD_Silent))
+    {
+        return false;
+    }
+
+    FMemoryReader reader(data);
+    uint32 magic = 0;
+    uint32 version = 0;
+    FString signature;
+    reader << magic;
+    reader << version;
+    if ((MAGIC != magic) || (VERSION != version))
+    {
+        return false;
+    }
+    reader << signature;
+    if (reader.IsError() || (signature != InSignature))
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Display, TEXT("Asset registry cache [%s] is outdated, rescanning"), *InAssetsPath);
+        return false;
+    }
+
+    reader << OutAssetInfoList;
+    if (reader.IsError())
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("Asset registry cache [%s] is corrupted, ignored"), *cacheFilePath);
+        OutAssetInfoList.Reset();
+        return false;
+    }
+    return true;
+}
+
+bool FRRAssetRegistryCache::Save(const FString& InClassName,
+                                 const FString& InAssetsPath,
+                                 const FString& InSignature,
+                                 const TArray<FRRCachedAssetInfo>& InAssetInfoList)
+{
+    TArray<uint8> data;
+    FMemoryWriter writer(data);
+    uint32 magic = MAGIC;
+    uint32 version = VERSION;
+    FString signature = InSignature;
+    writer << magic;
+    writer << version;
+    writer << signature;
+    writer << const_cast<TArray<FRRCachedAssetInfo>&>(InAssetInfoList);
+
+    const FString cacheFilePath = GetCacheFilePath(InClassName, InAssetsPath);
+    const FString tempFilePath = FString::Printf(TEXT("%s.%u.tmp"), *cacheFilePath, FPlatformProcess::GetCurrentProcessId());
+    if (!FFileHelper::SaveArrayToFile(data, *tempFilePath) || !IFileManager::Get().Move(*cacheFilePath, *tempFilePath, true))
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("Failed saving asset registry cache [%s]"), *cacheFilePath);
+        IFileManager::Get().Delete(*tempFilePath);
+        return false;
+    }
+    return true;
+}
@@ -2,7 +2,9 @@
 #include "Core/RRAssetUtils.h"
 
 // UE
+#include "Async/Async.h"
 #include "CoreMinimal.h"
+#include "UObject/StrongObjectPtr.h"
 
 #if WITH_EDITOR
 #include "BlueprintCompilationManager.h"
@@ -18,6 +20,37 @@
 #include "Core/RRGameSingleton.h"
 #include "Core/RRThreadUtils.h"
 
+namespace
+{
+struct FRRPackageSaveRequest
+{
+    //! Kept from GC until saved
+    TStrongObjectPtr<UPackage> Package;
+    TStrongObjectPtr<UObject> Object;
+    bool bAlwaysOverwrite = false;
+};
+
+//! Game thread only
+TArray<FRRPackageSaveRequest> GPackageSaveQueue;
+int32 GPackageSaveBatchDepth = 0;
+
+FSavePackageArgs MakePackageSaveArgs(bool bInAsyncSave)
+{
+    FSavePackageArgs saveArgs;
+    saveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+    saveArgs.SaveFlags = (bInAsyncSave ? SAVE_Async : SAVE_None) | SAVE_NoError | SAVE_KeepDirty | SAVE_FromAutosave |
+                         SAVE_KeepEditorOnlyCookedPackages;
+    saveArgs.Error = GWarn;
+    saveArgs.bWarnOfLongFilename = false;
+    return saveArgs;
+}
+
+FString GetPackageFileName(const UPackage* InPackage)
+{
+    return FPackageName::LongPackageNameToFilename(InPackage->GetName(), FPackageName::GetAssetPackageExtension());
+}
+}    // namespace
+
 UClass* URRAssetUtils::CreateBlueprintClass(UClass* InParentClass,
                                             const FString& InBlueprintClassName,
                                             const TFunction<void(UObject* InCDO)>& InCDOFunc,
@@ -159,10 +192,11 @@ UBlueprint* URRAssetUtils::CreateBlueprintFromActor(AActor* InActor,
     {
         URRAssetUtils::SavePackageToAsset(blueprint->GetPackage(), blueprint);
     }
+    return blueprint;
 #else
     UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("UBlueprint runtime creation requires WITH_EDITOR"));
-#endif
     return nullptr;
+#endif
 }
 
 UPackage* URRAssetUtils::CreatePackageForSavingToAsset(const TCHAR* InPackageName, const EPackageFlags InPackageFlags)
@@ -275,6 +309,13 @@ UObject* URRAssetUtils::SaveObjectToAsset(UObject* InObject,
 
 bool URRAssetUtils::SavePackageToAsset(UPackage* InPackage, UObject* InObject, bool bInAsyncSave, bool bInAlwaysOverwrite)
 {
+    // Saved later along with the batch's other packages
+    if (IsBatchingPackageSaves())
+    {
+        EnqueuePackageToSave(InPackage, InObject, bInAlwaysOverwrite);
+        return true;
+    }
+
     // Mark both dirty
     if (InObject)
     {
@@ -283,16 +324,10 @@ bool URRAssetUtils::SavePackageToAsset(UPackage* InPackage, UObject* InObject, b
     InPackage->MarkPackageDirty();
 
     // Save package args
-    FSavePackageArgs saveArgs;
-    saveArgs.TopLevelFlags = RF_Public | RF_Standalone;
-    saveArgs.SaveFlags = (bInAsyncSave ? SAVE_Async : SAVE_None) | SAVE_NoError | SAVE_KeepDirty | SAVE_FromAutosave |
-                         SAVE_KeepEditorOnlyCookedPackages;
-    saveArgs.Error = GWarn;
-    saveArgs.bWarnOfLongFilename = false;
+    const FSavePackageArgs saveArgs = MakePackageSaveArgs(bInAsyncSave);
 
     // Final output asset (package) full file name
-    const FString packageFileName =
-        FPackageName::LongPackageNameToFilename(InPackage->GetName(), FPackageName::GetAssetPackageExtension());
+    const FString packageFileName = GetPackageFileName(InPackage);
 #if RAPYUTA_SIM_VERBOSE
     UE_LOG(LogRapyutaCore,
            Warning,
@@ -352,3 +387,137 @@ bool URRAssetUtils::SavePackageToAsset(UPackage* InPackage, UObject* InObject, b
         }
     }
 }
+
+void URRAssetUtils::BeginPackageSaveBatch()
+{
+    check(IsInGameThread());
+    ++GPackageSaveBatchDepth;
+}
+
+void URRAssetUtils::EndPackageSaveBatch(const FRROnPackagesSaved& InOnSaved)
+{
+    check(IsInGameThread());
+    if (GPackageSaveBatchDepth <= 0)
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("No package save batch to end"));
+        return;
+    }
+    if (--GPackageSaveBatchDepth > 0)
+    {
+        InOnSaved.ExecuteIfBound(0, TArray<FString>());
+        return;
+    }
+    FlushPackageSaveQueue(InOnSaved);
+}
+
+bool URRAssetUtils::IsBatchingPackageSaves()
+{
+    return IsInGameThread() && (GPackageSaveBatchDepth > 0);
+}
+
+void URRAssetUtils::EnqueuePackageToSave(UPackage* InPackage, UObject* InObject, bool bInAlwaysOverwrite)
+{
+    check(IsInGameThread());
+    if (nullptr == InPackage)
+    {
+        return;
+    }
+    for (FRRPackageSaveRequest& request : GPackageSaveQueue)
+    {
+        if (request.Package.Get() == InPackage)
+        {
+            request.Object.Reset(InObject ? InObject : request.Object.Get());
+            request.bAlwaysOverwrite |= bInAlwaysOverwrite;
+            return;
+        }
+    }
+
+    FRRPackageSaveRequest& request = GPackageSaveQueue.AddDefaulted_GetRef();
+    request.Package.Reset(InPackage);
+    request.Object.Reset(InObject);
+    request.bAlwaysOverwrite = bInAlwaysOverwrite;
+}
+
+int32 URRAssetUtils::GetQueuedPackagesToSaveNum()
+{
+    return GPackageSaveQueue.Num();
+}
+
+int32 URRAssetUtils::FlushPackageSaveQueue(const FRROnPackagesSaved& InOnSaved)
+{
+    check(IsInGameThread());
+    TArray<FRRPackageSaveRequest> requests = MoveTemp(GPackageSaveQueue);
+    GPackageSaveQueue.Reset();
+
+    TArray<FString> failedPackageNames;
+    TArray<FPackageSaveInfo> saveInfos;
+    saveInfos.Reserve(requests.Num());
+    for (const FRRPackageSaveRequest& request : requests)
+    {
+        UPackage* package = request.Package.Get();
+        UObject* object = request.Object.Get();
+        const FString packageFileName = GetPackageFileName(package);
+        if ((false == request.bAlwaysOverwrite) && FPaths::FileExists(packageFileName))
+        {
+            UE_LOG_WITH_INFO(
+                LogRapyutaCore, Error, TEXT("[%s] FAILED SAVING OBJECT TO UASSET, ALREADY EXISTS"), *packageFileName);
+            failedPackageNames.Add(package->GetName());
+            continue;
+        }
+
+        // Make sure [package] is [object]'s package
+        if (object)
+        {
+            if (object->GetPackage() != package)
+            {
+                object->Rename(nullptr, package);
+            }
+            object->MarkPackageDirty();
+        }
+        package->MarkPackageDirty();
+
+        FPackageSaveInfo& saveInfo = saveInfos.AddDefaulted_GetRef();
+        saveInfo.Package = package;
+        saveInfo.Asset = object;
+        saveInfo.Filename = packageFileName;
+    }
+
+    // Packages serialized in parallel, their files being written asynchronously
+    int32 savedNum = 0;
+    if (saveInfos.Num() > 0)
+    {
+        TArray<FSavePackageResultStruct> results;
+        UPackage::SaveConcurrent(saveInfos, MakePackageSaveArgs(true), results);
+        for (auto i = 0; i < saveInfos.Num(); ++i)
+        {
+            if (results.IsValidIndex(i) && (ESavePackageResult::Success == results[i].Result))
+            {
+                ++savedNum;
+            }
+            else
+            {
+                UE_LOG_WITH_INFO(LogRapyutaCore,
+                                 Error,
+                                 TEXT("[%s] FAILED SAVING PACKAGE TO UASSET - Error[%d]"),
+                                 *saveInfos[i].Package->GetName(),
+                                 results.IsValidIndex(i) ? static_cast<uint8>(results[i].Result) : 0);
+                failedPackageNames.Add(saveInfos[i].Package->GetName());
+            }
+        }
+    }
+
+    UE_LOG_WITH_INFO(LogRapyutaCore,
+                     Log,
+                     TEXT("Saving %d/%d queued packages, %d failed"),
+                     savedNum,
+                     requests.Num(),
+                     failedPackageNames.Num());
+    URRThreadUtils::DoAsyncTaskInThread<void>(
+        []() { UPackage::WaitForAsyncFileWrites(); },
+        [InOnSaved, savedNum, failedPackageNames]()
+        {
+            AsyncTask(ENamedThreads::GameThread,
+                      [InOnSaved, savedNum, failedPackageNames]() { InOnSaved.ExecuteIfBound(savedNum, failedPackageNames); });
+        });
+    return saveInfos.Num();
+}
@@ -9,7 +9,12 @@
 #include "Core/RRPlayerController.h"
 #include "Core/RRUObjectUtils.h"
 
-TMap<UClass*, TUniquePtr<std::once_flag>> ARRBaseActor::OnceFlagList;
+namespace
+{
+//! Serializes the first #ARRBaseActor::Initialize() of each class, later ones only reading its CDO's flag
+FCriticalSection GGlobalConfigMutex;
+}    // namespace
+
 std::once_flag ARRBaseActor::OnceFlag;
 int8 ARRBaseActor::SSceneInstanceId = URRActorCommon::DEFAULT_SCENE_INSTANCE_ID;
 ARRBaseActor::ARRBaseActor()
@@ -60,17 +65,17 @@ void ARRBaseActor::PreInitializeComponents()
 
 bool ARRBaseActor::Initialize()
 {
-    UClass* thisClass = GetClass();
-    if (false == OnceFlagList.Contains(thisClass))
+    ARRBaseActor* classDefault = GetClass()->GetDefaultObject<ARRBaseActor>();
+    if (!classDefault->bGloballyConfigured.load(std::memory_order_acquire))
     {
-        ARRBaseActor::OnceFlagList.Add(thisClass, MakeUnique<std::once_flag>());
+        FScopeLock lock(&GGlobalConfigMutex);
+        if (!classDefault->bGloballyConfigured.load(std::memory_order_relaxed))
+        {
+            PrintSimConfig();
+            DoGlobalConfig();
+            classDefault->bGloballyConfigured.store(true, std::memory_order_release);
+        }
     }
-    std::call_once(*OnceFlagList[thisClass],
-                   [this]()
-                   {
-                       PrintSimConfig();
-                       DoGlobalConfig();
-                   });
 
     // Entity Model Name
     if (ActorInfo.IsValid())
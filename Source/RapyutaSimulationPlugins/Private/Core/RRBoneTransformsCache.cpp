@@ -0,0 +1,54 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRBoneTransformsCache.h"
+
+// UE
+#include "Components/SkeletalMeshComponent.h"
+
+TMap<TWeakObjectPtr<USkeletalMeshComponent>, FRRBoneTransforms> FRRBoneTransformsCache::SBoneTransforms;
+uint64 FRRBoneTransformsCache::SLastCleanupFrame = 0;
+
+const FRRBoneTransforms& FRRBoneTransformsCache::Get(USkeletalMeshComponent* InSkeletalMesh)
+{
+    check(IsInGameThread());
+    // Entries of destroyed components are dropped once per frame at most
+    if (SLastCleanupFrame != GFrameCounter)
+    {
+        SLastCleanupFrame = GFrameCounter;
+        for (auto it = SBoneTransforms.CreateIterator(); it; ++it)
+        {
+            if (!it->Key.IsValid())
+            {
+                it.RemoveCurrent();
+            }
+        }
+    }
+
+    FRRBoneTransforms& boneTransforms = SBoneTransforms.FindOrAdd(InSkeletalMesh);
+    const int32 bonesNum = InSkeletalMesh->GetNumBones();
+    if (boneTransforms.BoneNames.Num() != bonesNum)
+    {
+        boneTransforms.BoneNames.SetNum(bonesNum);
+        boneTransforms.ParentIndices.SetNum(bonesNum);
+        for (int32 i = 0; i < bonesNum; ++i)
+        {
+            boneTransforms.BoneNames[i] = InSkeletalMesh->GetBoneName(i);
+            const FName parentName = InSkeletalMesh->GetParentBone(boneTransforms.BoneNames[i]);
+            boneTransforms.ParentIndices[i] = parentName.IsNone() ? INDEX_NONE : InSkeletalMesh->GetBoneIndex(parentName);
+        }
+        boneTransforms.Frame = 0;
+    }
+
+    if (boneTransforms.Frame != GFrameCounter)
+    {
+        boneTransforms.BoneSpaceTransforms = InSkeletalMesh->GetBoneSpaceTransforms();
+        boneTransforms.Frame = GFrameCounter;
+    }
+    return boneTransforms;
+}
+
+uint64 FRRBoneTransformsCache::GetReadFrame(const USkeletalMeshComponent* InSkeletalMesh)
+{
+    const FRRBoneTransforms* boneTransforms = SBoneTransforms.Find(InSkeletalMesh);
+    return boneTransforms ? boneTransforms->Frame : 0;
+}
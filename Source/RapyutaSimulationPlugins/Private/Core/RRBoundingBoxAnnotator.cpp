@@ -0,0 +1,152 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRBoundingBoxAnnotator.h"
+
+// UE
+#include "Async/ParallelFor.h"
+#include "GameFramework/Actor.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRCoreUtils.h"
+#include "Core/RRGameState.h"
+#include "Core/RRTrace.h"
+#include "Core/RRUObjectUtils.h"
+
+TMap<FObjectKey, uint32> FRRBoundingBoxAnnotator::LocalBoundsGenerations;
+
+void FRRBoundingBoxAnnotator::InvalidateLocalBounds(const AActor* InActor)
+{
+    if (InActor)
+    {
+        ++LocalBoundsGenerations.FindOrAdd(FObjectKey(InActor));
+    }
+}
+
+void FRRBoundingBoxAnnotator::Annotate(const TArray<AActor*>& InActors,
+                                       const AActor* InBaseActor,
+                                       const FRRAnnotationView& InView,
+                                       TArray<FRRBoundingBoxAnnotation>& OutAnnotations,
+                                       bool bInIncludeNonColliding)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRAnnotateBoundingBoxes", RRSensorChannel);
+    OutAnnotations.Reset();
+    if (InActors.Num() == 0)
+    {
+        return;
+    }
+
+    // Vertex order, resolved once per batch
+    FVector vertexNormals[8];
+    ARRGameState* gameState = URRCoreUtils::GetGameState<ARRGameState>(InActors[0]);
+    if (nullptr == gameState)
+    {
+        return;
+    }
+    for (int32 i = 0; i < 8; ++i)
+    {
+        vertexNormals[i] = gameState->GetEntityBBVertexNormal(i);
+    }
+
+    // 1- Gather transforms & cached local bounds, on game thread
+    const FTransform baseInverse = InBaseActor ? InBaseActor->GetTransform().Inverse() : FTransform::Identity;
+    TArray<FTransform> transforms;
+    TArray<const FCachedLocalBounds*> bounds;
+    transforms.Reserve(InActors.Num());
+    bounds.Reserve(InActors.Num());
+    OutAnnotations.Reserve(InActors.Num());
+    for (AActor* actor : InActors)
+    {
+        if (!IsValid(actor) || actor->IsHidden())
+        {
+            continue;
+        }
+        const FObjectKey actorKey(actor);
+        const uint32* generation = LocalBoundsGenerations.Find(actorKey);
+        const uint32 currentGeneration = generation ? *generation : 0;
+        FCachedLocalBounds* cachedBounds = LocalBoundsCache.Find(actorKey);
+        if ((nullptr == cachedBounds) || (cachedBounds->Generation != currentGeneration) ||
+            (cachedBounds->bIncludeNonColliding != bInIncludeNonColliding))
+        {
+            // Walks all components, thus only upon first annotation or mesh change
+            cachedBounds = &LocalBoundsCache.FindOrAdd(actorKey);
+            actor->CalculateComponentsBoundingBoxInLocalSpace(bInIncludeNonColliding)
+                .GetCenterAndExtents(cachedBounds->Center, cachedBounds->Extent);
+            cachedBounds->Generation = currentGeneration;
+            cachedBounds->bIncludeNonColliding = bInIncludeNonColliding;
+        }
+        // Same as GetRelativeTransform(), as in GetActorCenterAndBoundingBoxVertices()
+        transforms.Add(InBaseActor ? actor->GetActorTransform() * baseInverse : actor->GetActorTransform());
+        bounds.Add(cachedBounds);
+        OutAnnotations.AddDefaulted_GetRef().Actor = actor;
+    }
+
+    // 2- Boxes & projections, in parallel. World vertices are needed for projection even if annotated in base frame
+    const FTransform viewInverse = InView.Transform.Inverse();
+    const FTransform baseTransform = InBaseActor ? InBaseActor->GetTransform() : FTransform::Identity;
+    const double halfWidth = 0.5 * InView.ImageSize.X;
+    const double halfHeight = 0.5 * InView.ImageSize.Y;
+    const double focal = halfWidth / FMath::Tan(FMath::DegreesToRadians(0.5 * InView.FOVAngle));
+    const FBox2D imageBounds(FVector2D::ZeroVector, FVector2D(InView.ImageSize));
+    const int32 batchesNum = FMath::DivideAndRoundUp(OutAnnotations.Num(), BATCH_SIZE);
+    ParallelFor(batchesNum,
+                [&](int32 InBatchIndex)
+                {
+                    const int32 start = InBatchIndex * BATCH_SIZE;
+                    const int32 end = FMath::Min(start + BATCH_SIZE, OutAnnotations.Num());
+                    for (int32 i = start; i < end; ++i)
+                    {
+                        FRRBoundingBoxAnnotation& annotation = OutAnnotations[i];
+                        const FTransform& transform = transforms[i];
+                        const FCachedLocalBounds& localBounds = *bounds[i];
+                        const FVector center = transform.TransformPosition(localBounds.Center);
+                        const FQuat rotation = transform.GetRotation();
+                        annotation.CenterAndVertices3D[0] = center;
+                        for (int32 v = 0; v < 8; ++v)
+                        {
+                            const FVector extent = URRUObjectUtils::GetDirectedExtent(vertexNormals[v], localBounds.Extent);
+                            annotation.CenterAndVertices3D[v + 1] = center + rotation.RotateVector(extent);
+                        }
+
+                        // Projection of the vertices in front of the camera
+                        FBox2D imageBox(ForceInit);
+                        for (int32 v = 1; v < 9; ++v)
+                        {
+                            const FVector world =
+                                InBaseActor ? baseTransform.TransformPosition(annotation.CenterAndVertices3D[v])
+                                            : annotation.CenterAndVertices3D[v];
+                            const FVector camera = viewInverse.TransformPosition(world);
+                            if (camera.X > InView.NearClipPlane)
+                            {
+                                imageBox += FVector2D(halfWidth + focal * camera.Y / camera.X,
+                                                      halfHeight - focal * camera.Z / camera.X);
+                            }
+                        }
+                        annotation.bVisible = imageBox.bIsValid && imageBox.Intersect(imageBounds);
+                        annotation.ImageBox = annotation.bVisible ? imageBox.Overlap(imageBounds) : FBox2D(ForceInit);
+                    }
+                });
+}
+
+FString FRRBoundingBoxAnnotator::ToText(const TArray<FRRBoundingBoxAnnotation>& InAnnotations)
+{
+    FString text;
+    for (const auto& annotation : InAnnotations)
+    {
+        const AActor* actor = annotation.Actor.Get();
+        if (!annotation.bVisible || (nullptr == actor))
+        {
+            continue;
+        }
+        text += actor->GetName();
+        for (const FVector& point : annotation.CenterAndVertices3D)
+        {
+            text += FString::Printf(TEXT(" %.3f %.3f %.3f"), point.X, point.Y, point.Z);
+        }
+        text += FString::Printf(TEXT(" %.1f %.1f %.1f %.1f\n"),
+                                annotation.ImageBox.Min.X,
+                                annotation.ImageBox.Min.Y,
+                                annotation.ImageBox.Max.X,
+                                annotation.ImageBox.Max.Y);
+    }
+    return text;
+}
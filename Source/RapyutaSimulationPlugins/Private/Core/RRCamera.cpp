@@ -3,6 +3,7 @@
 #include "Core/RRCamera.h"
 
 // UE
+#include "Async/ParallelFor.h"
 #include "Components/SceneCaptureComponent2D.h"
 #include "Engine/TextureRenderTarget2D.h"
 
@@ -69,6 +70,49 @@ void ARRCamera::RandomizePose(const FVector& InBaseLocation, bool bIsRandomLocat
     }
 }
 
+void ARRCamera::RandomizeCameras(const TArray<ARRCamera*>& InCameras,
+                                 const FVector& InBaseLocation,
+                                 bool bIsRandomLocationOnly,
+                                 const int32 InSeed)
+{
+    check(IsInGameThread());
+    TArray<float> fovs;
+    TArray<FVector> locations;
+    fovs.SetNumUninitialized(InCameras.Num());
+    locations.SetNumUninitialized(InCameras.Num());
+    ParallelFor(InCameras.Num(),
+                [&InCameras, &InBaseLocation, &fovs, &locations, InSeed](const int32 InIdx)
+                {
+                    if (nullptr == InCameras[InIdx])
+                    {
+                        return;
+                    }
+                    const FRRCameraProperties& cameraProps = InCameras[InIdx]->CameraProperties;
+                    const FRandomStream stream = URRMathUtils::GetRandomSubstream(InSeed, InIdx);
+                    fovs[InIdx] = stream.FRandRange(cameraProps.HFoVRangeInDegree.X, cameraProps.HFoVRangeInDegree.Y);
+                    locations[InIdx] = URRMathUtils::GetRandomSphericalPosition(
+                        stream, InBaseLocation, cameraProps.DistanceRangeInCm, cameraProps.HeightRangeInCm);
+                });
+
+    for (int32 i = 0; i < InCameras.Num(); ++i)
+    {
+        ARRCamera* camera = InCameras[i];
+        if (nullptr == camera)
+        {
+            continue;
+        }
+        camera->CameraComponent->FieldOfView = fovs[i];
+        if (bIsRandomLocationOnly)
+        {
+            camera->SetActorLocation(locations[i]);
+        }
+        else
+        {
+            camera->SetActorTransform(FTransform((-locations[i]).ToOrientationRotator(), locations[i]));
+        }
+    }
+}
+
 float ARRCamera::GetDistanceToFloor() const
 {
     return ActorCommon->SceneFloor
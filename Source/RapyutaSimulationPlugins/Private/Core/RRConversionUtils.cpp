@@ -1,3 +1,103 @@
 // Copyright 2020-2021 Rapyuta Robotics Co., Ltd.
 
 #include "Core/RRConversionUtils.h"
+
+// UE
+#include "Engine/World.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRGeneralUtils.h"
+#include "Core/RRNetworkGameState.h"
+#include "Tools/RRLimitRTFFixedSizeCustomTimeStep.h"
+
+int64 URRConversionUtils::GetSimTimeNanosec(const UObject* InContextObject)
+{
+    const UWorld* world = InContextObject ? InContextObject->GetWorld() : nullptr;
+    if (nullptr == world)
+    {
+        return 0;
+    }
+    if (const auto* networkGameState = world->GetGameState<ARRNetworkGameState>())
+    {
+        return networkGameState->GetServerWorldTimeNanosec();
+    }
+    return GetWorldTimeNanosec(world);
+}
+
+int64 URRConversionUtils::GetWorldTimeNanosec(const UWorld* InWorld)
+{
+    if (const auto* fixedTimeStep = URRLimitRTFFixedSizeCustomTimeStep::Get())
+    {
+        return fixedTimeStep->GetWorldTimeNanosec(InWorld);
+    }
+    return FMath::RoundToInt64(InWorld->GetTimeSeconds() * 1e+09);
+}
+
+void URRConversionUtils::VectorsUEToROS(TArrayView<const FVector> InVectors, TArrayView<FVector> OutVectors)
+{
+    check(InVectors.Num() == OutVectors.Num());
+    const int32 num = InVectors.Num();
+    const FVector* in = InVectors.GetData();
+    FVector* out = OutVectors.GetData();
+    for (int32 i = 0; i < num; ++i)
+    {
+        out[i].Set(in[i].X * 0.01, in[i].Y * -0.01, in[i].Z * 0.01);
+    }
+}
+
+void URRConversionUtils::TransformsUEToROS(TArrayView<const FTransform> InTransforms, TArrayView<FTransform> OutTransforms)
+{
+    check(InTransforms.Num() == OutTransforms.Num());
+    const int32 num = InTransforms.Num();
+    const FTransform* in = InTransforms.GetData();
+    FTransform* out = OutTransforms.GetData();
+    for (int32 i = 0; i < num; ++i)
+    {
+        const FVector translation = in[i].GetTranslation();
+        const FQuat rotation = in[i].GetRotation();
+        out[i].SetComponents(FQuat(-rotation.X, rotation.Y, -rotation.Z, rotation.W),
+                             FVector(translation.X * 0.01, translation.Y * -0.01, translation.Z * 0.01),
+                             in[i].GetScale3D());
+    }
+}
+
+void URRConversionUtils::RelativeTransformsUEToROS(const FTransform& InRefTransf,
+                                                   TArrayView<const FTransform> InWorldTransforms,
+                                                   TArrayView<FTransform> OutTransforms)
+{
+    RelativeTransformsUEToROS(FRRRefFrame(InRefTransf), InWorldTransforms, OutTransforms);
+}
+
+void URRConversionUtils::RelativeTransformsUEToROS(const FRRRefFrame& InRefFrame,
+                                                   TArrayView<const FTransform> InWorldTransforms,
+                                                   TArrayView<FTransform> OutTransforms)
+{
+    check(InWorldTransforms.Num() == OutTransforms.Num());
+    const int32 num = InWorldTransforms.Num();
+    const FTransform* in = InWorldTransforms.GetData();
+    FTransform* out = OutTransforms.GetData();
+
+    // Negative scales go through the matrix path of FTransform::GetRelativeTransform()
+    if (InRefFrame.bNegativeScale)
+    {
+        for (int32 i = 0; i < num; ++i)
+        {
+            out[i] = TransformUEToROS(InRefFrame.GetRelativeTransform(in[i]));
+        }
+        return;
+    }
+
+    // Same as FRRRefFrame::GetRelativeTransform(), fused with the conversion
+    const FQuat& refInvRotation = InRefFrame.InvRotation;
+    const FVector& refInvScale = InRefFrame.InvScale;
+    const FVector refTranslation = InRefFrame.Transform.GetTranslation();
+    for (int32 i = 0; i < num; ++i)
+    {
+        FQuat rotation = refInvRotation * in[i].GetRotation();
+        rotation.Normalize();
+        const FVector translation = refInvRotation.RotateVector(in[i].GetTranslation() - refTranslation) * refInvScale;
+        out[i].SetComponents(FQuat(-rotation.X, rotation.Y, -rotation.Z, rotation.W),
+                             FVector(translation.X * 0.01, translation.Y * -0.01, translation.Z * 0.01),
+                             in[i].GetScale3D() * refInvScale);
+    }
+}
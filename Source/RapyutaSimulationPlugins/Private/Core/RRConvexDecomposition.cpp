@@ -0,0 +1,349 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRConvexDecomposition.h"
+
+// UE
+#include "Async/ParallelFor.h"
+#include "CompGeom/ConvexHull3.h"
+
+namespace
+{
+//! Solid-filled voxelization of a mesh, padded by a voxel on each side
+struct FVoxelGrid
+{
+    FIntVector Dims = FIntVector::ZeroValue;
+    FVector3d Origin = FVector3d::ZeroVector;
+    double VoxelSize = 0.;
+    TBitArray<> Solid;
+
+    int32 GetIndex(const int32 InX, const int32 InY, const int32 InZ) const
+    {
+        return InX + Dims.X * (InY + Dims.Y * InZ);
+    }
+
+    bool IsSolid(const int32 InX, const int32 InY, const int32 InZ) const
+    {
+        return (InX >= 0) && (InY >= 0) && (InZ >= 0) && (InX < Dims.X) && (InY < Dims.Y) && (InZ < Dims.Z) &&
+               Solid[GetIndex(InX, InY, InZ)];
+    }
+};
+
+//! Solid voxels inside an inclusive voxel box, with their hull in voxel units
+struct FPart
+{
+    FIntVector Min = FIntVector::ZeroValue;
+    FIntVector Max = FIntVector::ZeroValue;
+    int32 VoxelsNum = 0;
+    double HullVolume = 0.;
+    TArray<FVector3d> HullVertices;
+
+    double GetConcaveVolume() const
+    {
+        return FMath::Max(0., HullVolume - VoxelsNum);
+    }
+
+    double GetConcavity() const
+    {
+        return (HullVolume > 0.) ? (GetConcaveVolume() / HullVolume) : 0.;
+    }
+};
+
+bool Voxelize(const TArray<FVector3f>& InVertices, const TArray<uint32>& InIndices, const int32 InResolution, FVoxelGrid& OutGrid)
+{
+    FBox3d bounds(ForceInit);
+    for (const auto& vertex : InVertices)
+    {
+        bounds += FVector3d(vertex);
+    }
+    const double maxExtent = bounds.GetSize().GetMax();
+    if (!bounds.IsValid || (maxExtent <= UE_DOUBLE_SMALL_NUMBER) || (InResolution <= 0))
+    {
+        return false;
+    }
+
+    OutGrid.VoxelSize = maxExtent / InResolution;
+    OutGrid.Origin = bounds.Min - FVector3d(OutGrid.VoxelSize);
+    const FVector3d size = bounds.GetSize() / OutGrid.VoxelSize;
+    OutGrid.Dims = FIntVector(FMath::CeilToInt32(size.X) + 3, FMath::CeilToInt32(size.Y) + 3, FMath::CeilToInt32(size.Z) + 3);
+    const int32 voxelsNum = OutGrid.Dims.X * OutGrid.Dims.Y * OutGrid.Dims.Z;
+
+    // 1- Surface voxels, by sampling triangles at half a voxel
+    TBitArray<> surface(false, voxelsNum);
+    auto fMark = [&OutGrid, &surface](const FVector3d& InPos)
+    {
+        const FVector3d voxel = (InPos - OutGrid.Origin) / OutGrid.VoxelSize;
+        const int32 x = FMath::Clamp(FMath::FloorToInt32(voxel.X), 0, OutGrid.Dims.X - 1);
+        const int32 y = FMath::Clamp(FMath::FloorToInt32(voxel.Y), 0, OutGrid.Dims.Y - 1);
+        const int32 z = FMath::Clamp(FMath::FloorToInt32(voxel.Z), 0, OutGrid.Dims.Z - 1);
+        surface[OutGrid.GetIndex(x, y, z)] = true;
+    };
+    for (int32 t = 0; t + 2 < InIndices.Num(); t += 3)
+    {
+        if (!InVertices.IsValidIndex(InIndices[t]) || !InVertices.IsValidIndex(InIndices[t + 1]) ||
+            !InVertices.IsValidIndex(InIndices[t + 2]))
+        {
+            continue;
+        }
+        const FVector3d a(InVertices[InIndices[t]]);
+        const FVector3d ab = FVector3d(InVertices[InIndices[t + 1]]) - a;
+        const FVector3d ac = FVector3d(InVertices[InIndices[t + 2]]) - a;
+        const double maxEdge = FMath::Max3(ab.Length(), ac.Length(), (ac - ab).Length());
+        const int32 samplesNum = FMath::Max(1, FMath::CeilToInt32(2. * maxEdge / OutGrid.VoxelSize));
+        for (int32 i = 0; i <= samplesNum; ++i)
+        {
+            for (int32 j = 0; j <= samplesNum - i; ++j)
+            {
+                fMark(a + ab * (static_cast<double>(i) / samplesNum) + ac * (static_cast<double>(j) / samplesNum));
+            }
+        }
+    }
+
+    // 2- Flood fill the outside from the padded corner, the rest being solid.
+    // Non-closed meshes leak, leaving only their surface voxels solid.
+    TBitArray<> outside(false, voxelsNum);
+    TArray<FIntVector> stack;
+    stack.Add(FIntVector::ZeroValue);
+    outside[0] = true;
+    static const FIntVector NEIGHBOURS[6] = {FIntVector(1, 0, 0),
+                                             FIntVector(-1, 0, 0),
+                                             FIntVector(0, 1, 0),
+                                             FIntVector(0, -1, 0),
+                                             FIntVector(0, 0, 1),
+                                             FIntVector(0, 0, -1)};
+    while (stack.Num() > 0)
+    {
+        const FIntVector voxel = stack.Pop(false);
+        for (const auto& offset : NEIGHBOURS)
+        {
+            const FIntVector n = voxel + offset;
+            if ((n.X < 0) || (n.Y < 0) || (n.Z < 0) || (n.X >= OutGrid.Dims.X) || (n.Y >= OutGrid.Dims.Y) ||
+                (n.Z >= OutGrid.Dims.Z))
+            {
+                continue;
+            }
+            const int32 index = OutGrid.GetIndex(n.X, n.Y, n.Z);
+            if (!outside[index] && !surface[index])
+            {
+                outside[index] = true;
+                stack.Add(n);
+            }
+        }
+    }
+
+    OutGrid.Solid.Init(false, voxelsNum);
+    for (int32 i = 0; i < voxelsNum; ++i)
+    {
+        OutGrid.Solid[i] = !outside[i];
+    }
+    return true;
+}
+
+//! Shrink InOutPart's box to its solid voxels & compute their hull, wrapping the corners of its boundary voxels
+void ComputePartHull(const FVoxelGrid& InGrid, FPart& InOutPart)
+{
+    FIntVector solidMin(MAX_int32);
+    FIntVector solidMax(MIN_int32);
+    TSet<FIntVector> corners;
+    InOutPart.VoxelsNum = 0;
+    auto fIsInPart = [&InGrid, &InOutPart](const int32 InX, const int32 InY, const int32 InZ)
+    {
+        return (InX >= InOutPart.Min.X) && (InY >= InOutPart.Min.Y) && (InZ >= InOutPart.Min.Z) && (InX <= InOutPart.Max.X) &&
+               (InY <= InOutPart.Max.Y) && (InZ <= InOutPart.Max.Z) && InGrid.IsSolid(InX, InY, InZ);
+    };
+    for (int32 z = InOutPart.Min.Z; z <= InOutPart.Max.Z; ++z)
+    {
+        for (int32 y = InOutPart.Min.Y; y <= InOutPart.Max.Y; ++y)
+        {
+            for (int32 x = InOutPart.Min.X; x <= InOutPart.Max.X; ++x)
+            {
+                if (!InGrid.IsSolid(x, y, z))
+                {
+                    continue;
+                }
+                ++InOutPart.VoxelsNum;
+                solidMin = FIntVector(FMath::Min(solidMin.X, x), FMath::Min(solidMin.Y, y), FMath::Min(solidMin.Z, z));
+                solidMax = FIntVector(FMath::Max(solidMax.X, x), FMath::Max(solidMax.Y, y), FMath::Max(solidMax.Z, z));
+                if (fIsInPart(x - 1, y, z) && fIsInPart(x + 1, y, z) && fIsInPart(x, y - 1, z) && fIsInPart(x, y + 1, z) &&
+                    fIsInPart(x, y, z - 1) && fIsInPart(x, y, z + 1))
+                {
+                    continue;
+                }
+                for (int32 c = 0; c < 8; ++c)
+                {
+                    corners.Add(FIntVector(x + (c & 1), y + ((c >> 1) & 1), z + ((c >> 2) & 1)));
+                }
+            }
+        }
+    }
+
+    InOutPart.HullVolume = 0.;
+    InOutPart.HullVertices.Reset();
+    if (InOutPart.VoxelsNum == 0)
+    {
+        return;
+    }
+    InOutPart.Min = solidMin;
+    InOutPart.Max = solidMax;
+
+    TArray<FVector3d> points;
+    points.Reserve(corners.Num());
+    for (const auto& corner : corners)
+    {
+        points.Emplace(corner.X, corner.Y, corner.Z);
+    }
+    UE::Geometry::FConvexHull3d hull;
+    if (!hull.Solve(points) || (hull.GetDimension() < 3))
+    {
+        // Voxel corners always span a volume, kept as is otherwise
+        InOutPart.HullVolume = InOutPart.VoxelsNum;
+        InOutPart.HullVertices = MoveTemp(points);
+        return;
+    }
+
+    TSet<int32> hullVertexIds;
+    const FVector3d center = FVector3d(solidMin + solidMax + FIntVector(1)) * 0.5;
+    for (const auto& tri : hull.GetTriangles())
+    {
+        const FVector3d a = points[tri.A] - center;
+        const FVector3d b = points[tri.B] - center;
+        const FVector3d c = points[tri.C] - center;
+        InOutPart.HullVolume += FVector3d::DotProduct(a, FVector3d::CrossProduct(b, c)) / 6.;
+        hullVertexIds.Add(tri.A);
+        hullVertexIds.Add(tri.B);
+        hullVertexIds.Add(tri.C);
+    }
+    InOutPart.HullVolume = FMath::Abs(InOutPart.HullVolume);
+    InOutPart.HullVertices.Reserve(hullVertexIds.Num());
+    for (const int32 id : hullVertexIds)
+    {
+        InOutPart.HullVertices.Add(points[id]);
+    }
+}
+
+//! Split InPart into the two parts of least total concave volume, among planes at its quarters along each axis
+bool SplitPart(const FVoxelGrid& InGrid, const FPart& InPart, FPart& OutLeft, FPart& OutRight)
+{
+    struct FCandidate
+    {
+        FPart Left;
+        FPart Right;
+        double Cost = TNumericLimits<double>::Max();
+    };
+    TArray<FCandidate> candidates;
+    for (int32 axis = 0; axis < 3; ++axis)
+    {
+        const int32 extent = InPart.Max[axis] - InPart.Min[axis] + 1;
+        TArray<int32, TInlineAllocator<3>> positions;
+        for (int32 k = 1; k <= 3; ++k)
+        {
+            const int32 position = InPart.Min[axis] + (extent * k) / 4;
+            if ((position > InPart.Min[axis]) && (position <= InPart.Max[axis]))
+            {
+                positions.AddUnique(position);
+            }
+        }
+        for (const int32 position : positions)
+        {
+            FCandidate& candidate = candidates.AddDefaulted_GetRef();
+            candidate.Left.Min = candidate.Right.Min = InPart.Min;
+            candidate.Left.Max = candidate.Right.Max = InPart.Max;
+            candidate.Left.Max[axis] = position - 1;
+            candidate.Right.Min[axis] = position;
+        }
+    }
+
+    ParallelFor(candidates.Num(),
+                [&InGrid, &candidates](int32 InCandidateIndex)
+                {
+                    FCandidate& candidate = candidates[InCandidateIndex];
+                    ComputePartHull(InGrid, candidate.Left);
+                    ComputePartHull(InGrid, candidate.Right);
+                    if ((candidate.Left.VoxelsNum > 0) && (candidate.Right.VoxelsNum > 0))
+                    {
+                        candidate.Cost = candidate.Left.GetConcaveVolume() + candidate.Right.GetConcaveVolume();
+                    }
+                });
+
+    const FCandidate* best = nullptr;
+    for (const auto& candidate : candidates)
+    {
+        if ((candidate.Cost < TNumericLimits<double>::Max()) && ((nullptr == best) || (candidate.Cost < best->Cost)))
+        {
+            best = &candidate;
+        }
+    }
+    if (nullptr == best)
+    {
+        return false;
+    }
+    OutLeft = best->Left;
+    OutRight = best->Right;
+    return true;
+}
+}    // namespace
+
+bool FRRConvexDecomposition::Decompose(const TArray<FVector3f>& InVertices,
+                                       const TArray<uint32>& InIndices,
+                                       const FRRConvexDecompositionSettings& InSettings,
+                                       TArray<TArray<FVector3f>>& OutHulls)
+{
+    OutHulls.Reset();
+    FVoxelGrid grid;
+    if (!Voxelize(InVertices, InIndices, InSettings.Resolution, grid))
+    {
+        return false;
+    }
+
+    TArray<FPart> parts;
+    FPart& root = parts.AddDefaulted_GetRef();
+    root.Max = grid.Dims - FIntVector(1);
+    ComputePartHull(grid, root);
+    if (root.VoxelsNum == 0)
+    {
+        return false;
+    }
+
+    // Split the most concave part first, parts failing to be split being kept as they are
+    TBitArray<> unsplittable(false, 1);
+    while (parts.Num() < InSettings.MaxHullsNum)
+    {
+        int32 worstIndex = INDEX_NONE;
+        for (int32 i = 0; i < parts.Num(); ++i)
+        {
+            if (!unsplittable[i] && (parts[i].GetConcavity() > InSettings.MaxConcavity) &&
+                ((INDEX_NONE == worstIndex) || (parts[i].GetConcaveVolume() > parts[worstIndex].GetConcaveVolume())))
+            {
+                worstIndex = i;
+            }
+        }
+        if (INDEX_NONE == worstIndex)
+        {
+            break;
+        }
+
+        FPart left, right;
+        if (SplitPart(grid, parts[worstIndex], left, right))
+        {
+            parts[worstIndex] = MoveTemp(left);
+            parts.Add(MoveTemp(right));
+            unsplittable.Add(false);
+        }
+        else
+        {
+            unsplittable[worstIndex] = true;
+        }
+    }
+
+    // Voxel units -> mesh space
+    OutHulls.Reserve(parts.Num());
+    for (const auto& part : parts)
+    {
+        TArray<FVector3f>& hull = OutHulls.AddDefaulted_GetRef();
+        hull.Reserve(part.HullVertices.Num());
+        for (const auto& vertex : part.HullVertices)
+        {
+            hull.Add(FVector3f(grid.Origin + vertex * grid.VoxelSize));
+        }
+    }
+    return OutHulls.Num() > 0;
+}
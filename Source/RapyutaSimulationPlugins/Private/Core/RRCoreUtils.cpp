@@ -2,11 +2,16 @@
 #include "Core/RRCoreUtils.h"
 
 // UE
+#include "Async/ParallelFor.h"
 #include "CoreMinimal.h"
+#include "Engine/Engine.h"
 #include "Engine/GameViewportClient.h"
+#include "Engine/Texture2D.h"
+#include "HAL/IConsoleManager.h"
 #include "HAL/PlatformProcess.h"
 #include "IESConverter.h"
 #include "ImageUtils.h"
+#include "Misc/FileHelper.h"
 
 // RapyutaSimulationPlugins
 #include "Core/RRActorCommon.h"
@@ -14,6 +19,7 @@
 #include "Core/RRGameMode.h"
 #include "Core/RRGameSingleton.h"
 #include "Core/RRGameState.h"
+#include "Core/RRLightProfileCache.h"
 #include "Core/RRPlayerController.h"
 #include "Core/RRSceneDirector.h"
 #include "Core/RRStaticMeshComponent.h"
@@ -23,13 +29,6 @@
 
 IImageWrapperModule* URRCoreUtils::SImageWrapperModule = nullptr;
 TMap<ERRFileType, TSharedPtr<IImageWrapper>> URRCoreUtils::SImageWrappers;
-FRRLightProfileData URRCoreUtils::SLightProfileData;
-TFunction<void(uint8*, const FUpdateTextureRegion2D*)> URRCoreUtils::CleanupLightProfileData =
-    [](uint8*, const FUpdateTextureRegion2D*)
-{
-    FMemory::Free(SLightProfileData.ImageData);
-    SLightProfileData.ImageData = nullptr;
-};
 
 FString URRCoreUtils::GetFileTypeFilter(const ERRFileType InFileType)
 {
@@ -71,7 +70,7 @@ bool URRCoreUtils::HasPlayerControllerListInitialized(const UObject* InContextOb
     {
         return true;
     }
-    for (int8 i = 0; i < gameState->SCENE_INSTANCES_NUM; ++i)
+    for (int8 i = 0; i < gameState->SceneInstanceList.Num(); ++i)
     {
         const auto* playerController = URRCoreUtils::GetPlayerController<ARRPlayerController>(i, InContextObject);
         check(playerController);
@@ -144,6 +143,52 @@ bool URRCoreUtils::IsSimProfiling()
     return URRGameSingleton::Get()->BSIM_PROFILING;
 }
 
+static TAutoConsoleVariable<bool> CVarHeadlessSensorMode(
+    TEXT("rr.HeadlessSensorMode"),
+    false,
+    TEXT("Headless sensor-only mode, also enabled by -RRHeadless: no main view rendering, lidar rays, on-screen messages or "
+         "robot UI widgets, taken upon the game start for the main view."),
+    ECVF_Default);
+
+bool URRCoreUtils::IsHeadlessSensorMode()
+{
+    static const bool bHeadlessCommandLine = FParse::Param(FCommandLine::Get(), TEXT("RRHeadless"));
+    return bHeadlessCommandLine || CVarHeadlessSensorMode.GetValueOnAnyThread();
+}
+
+TArray<FString> URRCoreUtils::ApplyHeadlessSensorMode(const UObject* InContextObject)
+{
+    TArray<FString> disabledFeatures;
+    if (!IsHeadlessSensorMode())
+    {
+        return disabledFeatures;
+    }
+
+    // Main view, if any, a dedicated server having none
+    UGameInstance* gameInstance = GetGameInstance<UGameInstance>(InContextObject);
+    UGameViewportClient* gameViewportClient = gameInstance ? gameInstance->GetGameViewportClient() : nullptr;
+    if (gameViewportClient)
+    {
+        gameViewportClient->bDisableWorldRendering = true;
+        disabledFeatures.Add(TEXT("MainViewRendering"));
+    }
+    if (GEngine && GEngine->bEnableOnScreenDebugMessages)
+    {
+        GEngine->bEnableOnScreenDebugMessages = false;
+        disabledFeatures.Add(TEXT("OnScreenMessages"));
+    }
+
+    // Checking IsHeadlessSensorMode() by themselves
+    disabledFeatures.Add(TEXT("LidarRays"));
+    disabledFeatures.Add(TEXT("RobotUIWidgets"));
+
+    UE_LOG_WITH_INFO(LogRapyutaCore,
+                     Display,
+                     TEXT("Headless sensor-only mode, disabled: %s"),
+                     *FString::Join(disabledFeatures, TEXT(", ")));
+    return disabledFeatures;
+}
+
 bool URRCoreUtils::ShutDownSim(const UObject* InContextObject, uint64 InSimCompletionTimeoutInSecs)
 {
     // END ALL SCENE INSTANCES' OPERATIONS --
@@ -289,30 +334,224 @@ bool URRCoreUtils::CheckWithTimeOut(const TFunctionRef<bool()>& InCondition,
 // -------------------------------------------------------------------------------------------------------------------------
 // IMAGE UTILS --
 //
+namespace
+{
+//! BC1-encode a BGRA8 image, of which the size is a multiple of 4, with each block's bounding box colors as endpoints
+void CompressBC1(const TArray64<uint8>& InBGRA, const int32 InWidth, const int32 InHeight, TArray64<uint8>& OutBlocks)
+{
+    auto fTo565 = [](const int32* InBGR)
+    { return static_cast<uint16>(((InBGR[2] >> 3) << 11) | ((InBGR[1] >> 2) << 5) | (InBGR[0] >> 3)); };
+    auto fFrom565 = [](const uint16 InColor, int32* OutBGR)
+    {
+        const int32 r = (InColor >> 11) & 31;
+        const int32 g = (InColor >> 5) & 63;
+        const int32 b = InColor & 31;
+        OutBGR[0] = (b << 3) | (b >> 2);
+        OutBGR[1] = (g << 2) | (g >> 4);
+        OutBGR[2] = (r << 3) | (r >> 2);
+    };
+
+    const int32 blocksX = InWidth / 4;
+    const int32 blocksY = InHeight / 4;
+    OutBlocks.SetNumUninitialized(static_cast<int64>(blocksX) * blocksY * 8);
+    ParallelFor(blocksY,
+                [&](const int32 InBlockY)
+                {
+                    for (int32 blockX = 0; blockX < blocksX; ++blockX)
+                    {
+                        int32 pixels[16][3];
+                        int32 minBGR[3] = {255, 255, 255};
+                        int32 maxBGR[3] = {0, 0, 0};
+                        for (int32 i = 0; i < 16; ++i)
+                        {
+                            const int64 pixelIdx = (static_cast<int64>(InBlockY) * 4 + i / 4) * InWidth + blockX * 4 + i % 4;
+                            for (int32 c = 0; c < 3; ++c)
+                            {
+                                pixels[i][c] = InBGRA[4 * pixelIdx + c];
+                                minBGR[c] = FMath::Min(minBGR[c], pixels[i][c]);
+                                maxBGR[c] = FMath::Max(maxBGR[c], pixels[i][c]);
+                            }
+                        }
+
+                        // color0 > color1 selects the 4-color opaque mode
+                        uint16 color0 = fTo565(maxBGR);
+                        uint16 color1 = fTo565(minBGR);
+                        uint32 indices = 0;
+                        if (color0 != color1)
+                        {
+                            if (color0 < color1)
+                            {
+                                Swap(color0, color1);
+                            }
+                            int32 palette[4][3];
+                            fFrom565(color0, palette[0]);
+                            fFrom565(color1, palette[1]);
+                            for (int32 c = 0; c < 3; ++c)
+                            {
+                                palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+                                palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+                            }
+                            for (int32 i = 0; i < 16; ++i)
+                            {
+                                uint32 bestIdx = 0;
+                                int32 bestDistSq = MAX_int32;
+                                for (uint32 p = 0; p < 4; ++p)
+                                {
+                                    const int32 distSq = FMath::Square(pixels[i][0] - palette[p][0]) +
+                                                         FMath::Square(pixels[i][1] - palette[p][1]) +
+                                                         FMath::Square(pixels[i][2] - palette[p][2]);
+                                    if (distSq < bestDistSq)
+                                    {
+                                        bestDistSq = distSq;
+                                        bestIdx = p;
+                                    }
+                                }
+                                indices |= bestIdx << (2 * i);
+                            }
+                        }
+
+                        uint8* block = &OutBlocks[8 * (static_cast<int64>(InBlockY) * blocksX + blockX)];
+                        FMemory::Memcpy(block, &color0, sizeof(uint16));
+                        FMemory::Memcpy(block + 2, &color1, sizeof(uint16));
+                        FMemory::Memcpy(block + 4, &indices, sizeof(uint32));
+                    }
+                });
+}
+
+}    // namespace
+
+bool URRCoreUtils::DecodeImageFile(const FString& InImagePath, const bool bInCompressed, FRRDecodedImage& OutImage)
+{
+    TArray64<uint8> fileData;
+    if ((nullptr == SImageWrapperModule) || !FFileHelper::LoadFileToArray(fileData, *InImagePath))
+    {
+        return false;
+    }
+
+    // HDR images are left to [FImageUtils::ImportFileAsTexture2D()], for their float pixel formats
+    const EImageFormat imageFormat = SImageWrapperModule->DetectImageFormat(fileData.GetData(), fileData.Num());
+    if ((EImageFormat::Invalid == imageFormat) || (EImageFormat::EXR == imageFormat) || (EImageFormat::HDR == imageFormat))
+    {
+        return false;
+    }
+
+    TSharedPtr<IImageWrapper> imageWrapper = SImageWrapperModule->CreateImageWrapper(imageFormat);
+    TArray64<uint8> bgra;
+    if (!imageWrapper.IsValid() || !imageWrapper->SetCompressed(fileData.GetData(), fileData.Num()) ||
+        !imageWrapper->GetRaw(ERGBFormat::BGRA, 8, bgra))
+    {
+        return false;
+    }
+
+    OutImage.Width = imageWrapper->GetWidth();
+    OutImage.Height = imageWrapper->GetHeight();
+    if (bInCompressed && (OutImage.Width % 4 == 0) && (OutImage.Height % 4 == 0))
+    {
+        CompressBC1(bgra, OutImage.Width, OutImage.Height, OutImage.Data);
+        OutImage.PixelFormat = PF_DXT1;
+    }
+    else
+    {
+        OutImage.Data = MoveTemp(bgra);
+        OutImage.PixelFormat = PF_B8G8R8A8;
+    }
+    return true;
+}
+
+UTexture2D* URRCoreUtils::CreateImageTexture(const FRRDecodedImage& InImage, const FString& InTextureName)
+{
+    UTexture2D* texture = UTexture2D::CreateTransient(InImage.Width, InImage.Height, InImage.PixelFormat);
+    if (nullptr == texture)
+    {
+        return nullptr;
+    }
+
+    FTexture2DMipMap& mip = texture->GetPlatformData()->Mips[0];
+    void* mipData = mip.BulkData.Lock(LOCK_READ_WRITE);
+    FMemory::Memcpy(mipData, InImage.Data.GetData(), FMath::Min<int64>(InImage.Data.Num(), mip.BulkData.GetBulkDataSize()));
+    mip.BulkData.Unlock();
+    texture->Rename(*InTextureName);
+
+    // The mip is uploaded by the render thread, without blocking this one
+    texture->UpdateResource();
+    return texture;
+}
+
+bool URRCoreUtils::UpdateImageTexture(UTexture2D* InTexture, FRRDecodedImage&& InImage)
+{
+    if (!IsValid(InTexture) || !InImage.IsValid() || (InTexture->GetSizeX() != InImage.Width) ||
+        (InTexture->GetSizeY() != InImage.Height) || (InTexture->GetPixelFormat() != InImage.PixelFormat))
+    {
+        return false;
+    }
+
+    // Both are released by the render thread, once uploaded
+    auto* region = new FUpdateTextureRegion2D(0, 0, 0, 0, InImage.Width, InImage.Height);
+    auto* data = new TArray64<uint8>(MoveTemp(InImage.Data));
+    const bool bBC1 = (PF_DXT1 == InImage.PixelFormat);
+    const uint32 bytesPerPixel = bBC1 ? 8 : 4;
+    const uint32 pitch = bBC1 ? (InImage.Width / 4) * bytesPerPixel : InImage.Width * bytesPerPixel;
+    InTexture->UpdateTextureRegions(0,
+                                    1,
+                                    region,
+                                    pitch,
+                                    bytesPerPixel,
+                                    data->GetData(),
+                                    [data](uint8*, const FUpdateTextureRegion2D* InRegions)
+                                    {
+                                        delete data;
+                                        delete InRegions;
+                                    });
+    return true;
+}
+
 bool URRCoreUtils::LoadImagesFromFolder(const FString& InImageFolderPath,
                                         const TArray<ERRFileType>& InImageFileTypes,
                                         TArray<UTexture*>& OutImageTextureList,
-                                        bool bIsLogged)
+                                        bool bIsLogged,
+                                        bool bInCompressed)
 {
     TArray<FString> imageFilePaths;
     bool bResult = LoadFullFilePaths(InImageFolderPath, imageFilePaths, InImageFileTypes);
 
     if (bResult)
     {
-        for (const auto& imagePath : imageFilePaths)
+        // Images are decoded on worker threads by batch, bounding the decoded data held at once.
+        // Their textures are then created in this thread, the game thread.
+        static constexpr int32 DECODE_BATCH_SIZE = 256;
+        LoadImageWrapperModule();
+        TArray<FRRDecodedImage> decodedImages;
+        for (int32 batchBegin = 0; batchBegin < imageFilePaths.Num(); batchBegin += DECODE_BATCH_SIZE)
         {
-            // FPaths::GetCleanFilename() could be used but rather not due to being more expensive.
-            // Also, imageFolderPath could be single or compound relative path, which must be unique to be texture name.
-            FString&& textureName = imagePath.RightChop(InImageFolderPath.Len());
-            if (UTexture2D* texture = LoadImageToTexture(imagePath, textureName))
-            {
-                OutImageTextureList.Add(texture);
-            }
-            else
+            const int32 batchNum = FMath::Min(DECODE_BATCH_SIZE, imageFilePaths.Num() - batchBegin);
+            decodedImages.Reset();
+            decodedImages.SetNum(batchNum);
+            ParallelFor(batchNum,
+                        [&](const int32 InIdx)
+                        {
+                            DecodeImageFile(imageFilePaths[batchBegin + InIdx], bInCompressed, decodedImages[InIdx]);
+                        });
+
+            for (int32 i = 0; i < batchNum; ++i)
             {
-                // Continue the loading regardless of some being failed.
-                bResult = false;
-                UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Failed to load image to texture: [%s]"), *imagePath);
+                const FString& imagePath = imageFilePaths[batchBegin + i];
+                // FPaths::GetCleanFilename() could be used but rather not due to being more expensive.
+                // Also, imageFolderPath could be single or compound relative path, which must be unique to be texture name.
+                FString&& textureName = imagePath.RightChop(InImageFolderPath.Len());
+                // Ones not decoded by workers, eg HDR ones, are imported serially
+                UTexture2D* texture = decodedImages[i].IsValid() ? CreateImageTexture(decodedImages[i], textureName)
+                                                                 : LoadImageToTexture(imagePath, textureName);
+                decodedImages[i].Data.Empty();
+                if (texture)
+                {
+                    OutImageTextureList.Add(texture);
+                }
+                else
+                {
+                    // Continue the loading regardless of some being failed.
+                    bResult = false;
+                    UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Failed to load image to texture: [%s]"), *imagePath);
+                }
             }
         }
     }
@@ -326,37 +565,47 @@ bool URRCoreUtils::LoadImagesFromFolder(const FString& InImageFolderPath,
 }
 
 // Ref: DatasmithRuntime::GetTextureDataForIes() & CreateIESTexture()
-UTextureLightProfile* URRCoreUtils::LoadIESProfile(const FString& InFullFilePath, const FString& InLightProfileName)
+bool URRCoreUtils::ParseIESProfile(const FString& InFullFilePath, FRRLightProfileData& OutData)
 {
-    TArray<uint8> buffer;
-    if (!(FFileHelper::LoadFileToArray(buffer, *InFullFilePath) && buffer.Num() > 0))
+    const bool bCacheEnabled = FRRLightProfileCache::IsEnabled();
+    const FString signature = bCacheEnabled ? FRRLightProfileCache::GetFileSignature(InFullFilePath) : FString();
+    if (signature.IsEmpty() || !FRRLightProfileCache::Load(InFullFilePath, signature, OutData))
     {
-        UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Failed loading file to array [%s]"), *InFullFilePath);
-        return nullptr;
-    }
+        TArray<uint8> buffer;
+        if (!(FFileHelper::LoadFileToArray(buffer, *InFullFilePath) && buffer.Num() > 0))
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Failed loading file to array [%s]"), *InFullFilePath);
+            return false;
+        }
 
-    // checks for .IES extension to avoid wasting loading large assets just to reject them during header parsing
-    FIESConverter iesConverter(buffer.GetData(), buffer.Num());
-    if (false == iesConverter.IsValid())
-    {
-        UE_LOG_WITH_INFO(
-            LogRapyutaCore, Error, TEXT("IESConverter failed creating buffer from image loaded from [%s]"), *InFullFilePath);
-        return nullptr;
+        // checks for .IES extension to avoid wasting loading large assets just to reject them during header parsing
+        FIESConverter iesConverter(buffer.GetData(), buffer.Num());
+        if (false == iesConverter.IsValid())
+        {
+            UE_LOG_WITH_INFO(
+                LogRapyutaCore, Error, TEXT("IESConverter failed creating buffer from image loaded from [%s]"), *InFullFilePath);
+            return false;
+        }
+
+        OutData.Width = iesConverter.GetWidth();
+        OutData.Height = iesConverter.GetHeight();
+        OutData.Brightness = iesConverter.GetBrightness();
+        OutData.TextureMultiplier = iesConverter.GetMultiplier();
+        OutData.ImageData = iesConverter.GetRawData();
+        if (!signature.IsEmpty())
+        {
+            FRRLightProfileCache::Save(InFullFilePath, signature, OutData);
+        }
     }
 
-    // Fille loaded data into [SLightProfileData]
-    SLightProfileData.Width = iesConverter.GetWidth();
-    SLightProfileData.Height = iesConverter.GetHeight();
-    SLightProfileData.Brightness = iesConverter.GetBrightness();
-    SLightProfileData.BytesPerPixel = 8;    // RGBA16F
-    SLightProfileData.Pitch = SLightProfileData.Width * SLightProfileData.BytesPerPixel;
-    SLightProfileData.TextureMultiplier = iesConverter.GetMultiplier();
-    const TArray<uint8>& rawData = iesConverter.GetRawData();
-    SLightProfileData.ImageData = (uint8*)FMemory::Malloc(rawData.Num() * sizeof(uint8), 0x20);
-    FMemory::Memcpy(SLightProfileData.ImageData, rawData.GetData(), rawData.Num() * sizeof(uint8));
-    ensure(SLightProfileData.ImageData);
-
-    // [SLightProfileData] -> [lightProfile]
+    OutData.PixelFormat = PF_FloatRGBA;
+    OutData.BytesPerPixel = 8;    // RGBA16F
+    OutData.Pitch = OutData.Width * OutData.BytesPerPixel;
+    return true;
+}
+
+UTextureLightProfile* URRCoreUtils::CreateIESProfile(FRRLightProfileData&& InData, const FString& InLightProfileName)
+{
     UTextureLightProfile* lightProfile = NewObject<UTextureLightProfile>(GetTransientPackage(), *InLightProfileName, RF_Transient);
     if (!lightProfile)
     {
@@ -368,13 +617,12 @@ UTextureLightProfile* URRCoreUtils::LoadIESProfile(const FString& InFullFilePath
     importInfo.Insert(FAssetImportInfo::FSourceFile(InLightProfileName));
     lightProfile->AssetImportData->SourceData = MoveTemp(importInfo);
 
-    lightProfile->Source.Init(SLightProfileData.Width,
-                              SLightProfileData.Height,
+    lightProfile->Source.Init(InData.Width,
+                              InData.Height,
                               /*NumSlices=*/1,
                               1,
                               TSF_RGBA16F,
-                              SLightProfileData.ImageData);
-    CleanupLightProfileData(nullptr, nullptr);
+                              InData.ImageData.GetData());
 #endif
 
     lightProfile->LODGroup = TEXTUREGROUP_IESLightProfile;
@@ -384,25 +632,38 @@ UTextureLightProfile* URRCoreUtils::LoadIESProfile(const FString& InFullFilePath
 #if WITH_EDITORONLY_DATA
     lightProfile->MipGenSettings = TMGS_NoMipmaps;
 #endif
-    lightProfile->Brightness = SLightProfileData.Brightness;
-    lightProfile->TextureMultiplier = SLightProfileData.TextureMultiplier;
+    lightProfile->Brightness = InData.Brightness;
+    lightProfile->TextureMultiplier = InData.TextureMultiplier;
 
     // Update the texture with these new settings
     lightProfile->UpdateResource();
 
 #if !WITH_EDITOR
-    SLightProfileData.Region = FUpdateTextureRegion2D(0, 0, 0, 0, SLightProfileData.Width, SLightProfileData.Height);
+    // Both are released by the render thread, once uploaded
+    auto* region = new FUpdateTextureRegion2D(0, 0, 0, 0, InData.Width, InData.Height);
+    auto* imageData = new TArray<uint8>(MoveTemp(InData.ImageData));
     lightProfile->UpdateTextureRegions(0,
                                        1,
-                                       &SLightProfileData.Region,
-                                       SLightProfileData.Pitch,
-                                       SLightProfileData.BytesPerPixel,
-                                       SLightProfileData.ImageData,
-                                       CleanupLightProfileData);
+                                       region,
+                                       InData.Pitch,
+                                       InData.BytesPerPixel,
+                                       imageData->GetData(),
+                                       [imageData](uint8*, const FUpdateTextureRegion2D* InRegions)
+                                       {
+                                           delete imageData;
+                                           delete InRegions;
+                                       });
 #endif
     return lightProfile;
 }
 
+UTextureLightProfile* URRCoreUtils::LoadIESProfile(const FString& InFullFilePath, const FString& InLightProfileName)
+{
+    FRRLightProfileData lightProfileData;
+    return ParseIESProfile(InFullFilePath, lightProfileData) ? CreateIESProfile(MoveTemp(lightProfileData), InLightProfileName)
+                                                             : nullptr;
+}
+
 bool URRCoreUtils::LoadIESProfilesFromFolder(const FString& InFolderPath,
                                              TArray<UTextureLightProfile*>& OutLightProfileList,
                                              bool bIsLogged)
@@ -411,12 +672,20 @@ bool URRCoreUtils::LoadIESProfilesFromFolder(const FString& InFolderPath,
     bool bResult = LoadFullFilePaths(InFolderPath, filePaths, {ERRFileType::LIGHT_PROFILE_IES});
     if (bResult)
     {
-        for (const auto& iesProfilePath : filePaths)
+        // Parsed on worker threads, each into its own buffer, the textures being created in this thread
+        TArray<FRRLightProfileData> profilesData;
+        profilesData.SetNum(filePaths.Num());
+        ParallelFor(filePaths.Num(), [&](const int32 InIdx) { ParseIESProfile(filePaths[InIdx], profilesData[InIdx]); });
+
+        for (auto i = 0; i < filePaths.Num(); ++i)
         {
+            const FString& iesProfilePath = filePaths[i];
             // FPaths::GetCleanFilename() could be used but rather not due to being more expensive.
             // Also, InFolderPath could be single or compound relative path, which must be unique to be light profile name.
             FString&& iesProfileName = iesProfilePath.RightChop(InFolderPath.Len());
-            if (UTextureLightProfile* iesProfile = LoadIESProfile(iesProfilePath, iesProfileName))
+            UTextureLightProfile* iesProfile =
+                profilesData[i].IsValid() ? CreateIESProfile(MoveTemp(profilesData[i]), iesProfileName) : nullptr;
+            if (iesProfile)
             {
                 OutLightProfileList.Add(iesProfile);
             }
@@ -3,6 +3,7 @@
 #include "Core/RRCrowdFollowingComponent.h"
 
 //RapyutaSimulationPlugins
+#include "Core/RRCrowdLODManager.h"
 #include "Core/RRMathUtils.h"
 #include "Drives/RRFloatingMovementComponent.h"
 
@@ -26,6 +27,60 @@ void URRCrowdFollowingComponent::SetMovementComponent(UNavMovementComponent* InM
     }
 }
 
+void URRCrowdFollowingComponent::BeginPlay()
+{
+    Super::BeginPlay();
+    if (bLODEnabled)
+    {
+        FRRCrowdLODManager::Get(GetWorld()).AddAgent(this);
+    }
+}
+
+void URRCrowdFollowingComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (bLODEnabled)
+    {
+        FRRCrowdLODManager::Get(GetWorld()).RemoveAgent(this);
+    }
+    Super::EndPlay(EndPlayReason);
+}
+
+void URRCrowdFollowingComponent::SetFarLOD(const bool bInFarLOD)
+{
+    if (bInFarLOD == bFarLOD)
+    {
+        return;
+    }
+    bFarLOD = bInFarLOD;
+
+    const float tickInterval = bFarLOD ? LODFarTickInterval : 0.f;
+    SetComponentTickInterval(tickInterval);
+    if (MovementComp)
+    {
+        MovementComp->SetComponentTickInterval(tickInterval);
+    }
+    if (FloatMovementComp)
+    {
+        FloatMovementComp->SetSweepEnabled(!bFarLOD);
+    }
+
+    if (bFarLOD)
+    {
+        NearAvoidanceQuality = AvoidanceQuality;
+        bNearSeparation = bEnableSeparation;
+        bNearOptimizeTopology = bEnableOptimizeTopology;
+        SetCrowdAvoidanceQuality(ECrowdAvoidanceQuality::Low);
+        SetCrowdSeparation(false);
+        SetCrowdOptimizeTopology(false);
+    }
+    else
+    {
+        SetCrowdAvoidanceQuality(NearAvoidanceQuality);
+        SetCrowdSeparation(bNearSeparation);
+        SetCrowdOptimizeTopology(bNearOptimizeTopology);
+    }
+}
+
 void URRCrowdFollowingComponent::FollowPathSegment(float InDeltaTime)
 {
     if (IsCrowdSimulationEnabled() || (MovementComp && MovementComp->UseAccelerationForPathFollowing()))
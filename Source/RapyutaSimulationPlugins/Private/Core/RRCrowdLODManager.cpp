@@ -0,0 +1,182 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRCrowdLODManager.h"
+
+// UE
+#include "Async/ParallelFor.h"
+#include "Components/SceneComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRCrowdFollowingComponent.h"
+#include "Robots/RRBaseRobot.h"
+
+static TAutoConsoleVariable<float> CVarCrowdLODUpdateInterval(
+    TEXT("rr.CrowdLOD.UpdateInterval"),
+    0.25f,
+    TEXT("[s] Interval between crowd agents LOD updates by FRRCrowdLODManager, taken upon the manager creation."),
+    ECVF_Default);
+
+void FRRCrowdLODTickFunction::ExecuteTick(float DeltaTime,
+                                          ELevelTick TickType,
+                                          ENamedThreads::Type CurrentThread,
+                                          const FGraphEventRef& MyCompletionGraphEvent)
+{
+    if (Manager && (TickType != LEVELTICK_ViewportsOnly))
+    {
+        Manager->Update();
+    }
+}
+
+TMap<UWorld*, TUniquePtr<FRRCrowdLODManager>> FRRCrowdLODManager::SManagers;
+std::once_flag FRRCrowdLODManager::OnceFlag;
+
+FRRCrowdLODManager::~FRRCrowdLODManager()
+{
+    if (TickFunction.IsTickFunctionRegistered())
+    {
+        TickFunction.UnRegisterTickFunction();
+    }
+}
+
+FRRCrowdLODManager& FRRCrowdLODManager::Get(UWorld* InWorld)
+{
+    check(IsInGameThread());
+    std::call_once(OnceFlag,
+                   []() { FWorldDelegates::OnPostWorldCleanup.AddStatic(&FRRCrowdLODManager::OnPostWorldCleanup); });
+
+    TUniquePtr<FRRCrowdLODManager>& manager = SManagers.FindOrAdd(InWorld);
+    if (!manager.IsValid())
+    {
+        manager = MakeUnique<FRRCrowdLODManager>();
+        manager->World = InWorld;
+        manager->TickFunction.Manager = manager.Get();
+        manager->TickFunction.bCanEverTick = true;
+        manager->TickFunction.TickGroup = TG_PrePhysics;
+        manager->TickFunction.TickInterval = FMath::Max(CVarCrowdLODUpdateInterval.GetValueOnGameThread(), 0.f);
+        manager->TickFunction.RegisterTickFunction(InWorld->PersistentLevel);
+    }
+    return *manager;
+}
+
+void FRRCrowdLODManager::OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/)
+{
+    SManagers.Remove(InWorld);
+}
+
+void FRRCrowdLODManager::AddAgent(URRCrowdFollowingComponent* InAgent)
+{
+    if (InAgent)
+    {
+        Agents.AddUnique(InAgent);
+    }
+}
+
+void FRRCrowdLODManager::RemoveAgent(URRCrowdFollowingComponent* InAgent)
+{
+    if (InAgent)
+    {
+        Agents.RemoveSwap(InAgent);
+        InAgent->SetFarLOD(false);
+    }
+}
+
+void FRRCrowdLODManager::AddViewer(USceneComponent* InViewer)
+{
+    if (InViewer)
+    {
+        Viewers.AddUnique(InViewer);
+    }
+}
+
+void FRRCrowdLODManager::RemoveViewer(USceneComponent* InViewer)
+{
+    Viewers.RemoveSwap(InViewer);
+}
+
+void FRRCrowdLODManager::GatherViewerLocations(UWorld* InWorld)
+{
+    ViewerLocations.Reset();
+    for (TActorIterator<ARRBaseRobot> it(InWorld); it; ++it)
+    {
+        ViewerLocations.Add(it->GetActorLocation());
+    }
+    for (auto it = InWorld->GetPlayerControllerIterator(); it; ++it)
+    {
+        if (const APlayerController* playerController = it->Get())
+        {
+            FVector viewLocation;
+            FRotator viewRotation;
+            playerController->GetPlayerViewPoint(viewLocation, viewRotation);
+            ViewerLocations.Add(viewLocation);
+        }
+    }
+    for (int32 i = 0; i < Viewers.Num();)
+    {
+        if (const USceneComponent* viewer = Viewers[i].Get())
+        {
+            ViewerLocations.Add(viewer->GetComponentLocation());
+            ++i;
+        }
+        else
+        {
+            Viewers.RemoveAtSwap(i, 1, false);
+        }
+    }
+}
+
+void FRRCrowdLODManager::Update()
+{
+    UWorld* world = World.Get();
+    if ((nullptr == world) || (Agents.Num() == 0))
+    {
+        LastFarAgentsNum = 0;
+        return;
+    }
+
+    // 1- Gather locations on game thread
+    GatherViewerLocations(world);
+    AgentLocations.Reset();
+    for (int32 i = 0; i < Agents.Num();)
+    {
+        const URRCrowdFollowingComponent* agent = Agents[i].Get();
+        if (!IsValid(agent))
+        {
+            Agents.RemoveAtSwap(i, 1, false);
+            continue;
+        }
+        AgentLocations.Add(agent->GetCrowdAgentLocation());
+        ++i;
+    }
+
+    // 2- Nearest viewer distances, without any viewer all agents being far
+    const int32 agentsNum = AgentLocations.Num();
+    AgentDistancesSquared.SetNumUninitialized(agentsNum);
+    ParallelFor(agentsNum,
+                [this](const int32 i)
+                {
+                    double distanceSquared = TNumericLimits<double>::Max();
+                    for (const FVector& viewerLocation : ViewerLocations)
+                    {
+                        distanceSquared = FMath::Min(distanceSquared, FVector::DistSquared(AgentLocations[i], viewerLocation));
+                    }
+                    AgentDistancesSquared[i] = distanceSquared;
+                });
+
+    // 3- Switch LODs, with hysteresis not to flicker at the LOD distance
+    LastFarAgentsNum = 0;
+    for (int32 i = 0; i < agentsNum; ++i)
+    {
+        URRCrowdFollowingComponent* agent = Agents[i].Get();
+        const double lodDistanceSquared = FMath::Square(agent->LODDistance);
+        if (agent->IsFarLOD() ? (AgentDistancesSquared[i] < 0.81 * lodDistanceSquared)
+                              : (AgentDistancesSquared[i] > lodDistanceSquared))
+        {
+            agent->SetFarLOD(!agent->IsFarLOD());
+        }
+        LastFarAgentsNum += agent->IsFarLOD() ? 1 : 0;
+    }
+}
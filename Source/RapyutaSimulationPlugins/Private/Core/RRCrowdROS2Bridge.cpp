@@ -0,0 +1,137 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRCrowdROS2Bridge.h"
+
+// UE
+#include "AIController.h"
+#include "Async/Async.h"
+#include "Misc/ScopeLock.h"
+
+// rclUE
+#include "Msgs/ROS2ModelStates.h"
+#include "ROS2NodeComponent.h"
+#include "ROS2Subscriber.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRConversionUtils.h"
+#include "Core/RRTrace.h"
+#include "RapyutaSimulationPlugins.h"
+#include "Tools/RRFrameTelemetry.h"
+#include "Tools/RRROS2EntityStatesPublisher.h"
+
+void URRCrowdROS2Bridge::InitROS2(UROS2NodeComponent* InROS2Node)
+{
+    if (bROS2Inited || (nullptr == InROS2Node))
+    {
+        return;
+    }
+
+    if (nullptr == StatesPublisher)
+    {
+        StatesPublisher = NewObject<URRROS2EntityStatesPublisher>(this, TEXT("StatesPublisher"));
+    }
+    StatesPublisher->TopicName = StatesTopicName;
+    StatesPublisher->PublicationFrequencyHz = StatesPublicationFrequencyHz;
+    InROS2Node->AddPublisher(StatesPublisher);
+
+    ROS2_CREATE_SUBSCRIBER(
+        InROS2Node, this, GoalsTopicName, UROS2ModelStatesMsg::StaticClass(), &URRCrowdROS2Bridge::GoalsCallback);
+    bROS2Inited = true;
+    UE_LOG_WITH_INFO(LogRapyutaCore, Display, TEXT("Crowd ROS 2 bridge of %d agents"), Agents.Num());
+}
+
+void URRCrowdROS2Bridge::AddAgent(AAIController* InController, const FString& InName)
+{
+    APawn* pawn = IsValid(InController) ? InController->GetPawn() : nullptr;
+    if (nullptr == pawn)
+    {
+        return;
+    }
+    const FString name = InName.IsEmpty() ? pawn->GetName() : InName;
+    Agents.Add(name, InController);
+
+    if (nullptr == StatesPublisher)
+    {
+        StatesPublisher = NewObject<URRROS2EntityStatesPublisher>(this, TEXT("StatesPublisher"));
+    }
+    StatesPublisher->AddEntity(pawn, name);
+}
+
+void URRCrowdROS2Bridge::RemoveAgent(AAIController* InController)
+{
+    if (const FString* name = Agents.FindKey(InController))
+    {
+        Agents.Remove(FString(*name));
+    }
+    if (StatesPublisher && IsValid(InController))
+    {
+        StatesPublisher->RemoveEntity(InController->GetPawn());
+    }
+}
+
+void URRCrowdROS2Bridge::GoalsCallback(const UROS2GenericMsg* InMsg)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRCrowdGoalsCallback", RRROS2Channel);
+    FRRFrameTimeScope frameTimeScope(ERRFrameTimeCategory::ROS_SUBSCRIBE);
+    const UROS2ModelStatesMsg* goalsMsg = Cast<UROS2ModelStatesMsg>(InMsg);
+    if (!IsValid(goalsMsg))
+    {
+        return;
+    }
+    FROSModelStates goals;
+    goalsMsg->GetMsg(goals);
+    if (goals.Name.Num() != goals.Pose.Num())
+    {
+        UE_LOG_WITH_INFO_NAMED(LogRapyutaCore, Warning, TEXT("pose array must be same size of name array"));
+        return;
+    }
+
+    {
+        FScopeLock lock(&GoalsMutex);
+        for (int32 i = 0; i < goals.Name.Num(); ++i)
+        {
+            PendingGoals.Add(goals.Name[i], URRConversionUtils::VectorROSToUE(goals.Pose[i].Position));
+        }
+    }
+
+    // (Note) In this callback, which could be invoked from a ROS working thread,
+    // thus any direct referencing to its member in this GameThread lambda needs to be verified.
+    // A single task is queued at a time, dispatching all goals received till its execution.
+    if (!bGoalsTaskQueued.exchange(true))
+    {
+        AsyncTask(ENamedThreads::GameThread,
+                  [weakThis = TWeakObjectPtr<URRCrowdROS2Bridge>(this)]
+                  {
+                      if (URRCrowdROS2Bridge* bridge = weakThis.Get())
+                      {
+                          bridge->ApplyPendingGoals();
+                      }
+                  });
+    }
+}
+
+void URRCrowdROS2Bridge::ApplyPendingGoals()
+{
+    DispatchedGoals.Reset();
+    {
+        FScopeLock lock(&GoalsMutex);
+        bGoalsTaskQueued = false;
+        for (const auto& goal : PendingGoals)
+        {
+            DispatchedGoals.Emplace(goal.Key, goal.Value);
+        }
+        PendingGoals.Reset();
+    }
+
+    for (const auto& goal : DispatchedGoals)
+    {
+        const TWeakObjectPtr<AAIController>* agent = Agents.Find(goal.Key);
+        AAIController* controller = agent ? agent->Get() : nullptr;
+        if (nullptr == controller)
+        {
+            UE_LOG_WITH_INFO_NAMED(LogRapyutaCore, Warning, TEXT("do not have crowd agent named %s"), *goal.Key);
+            continue;
+        }
+        controller->MoveToLocation(goal.Value, GoalAcceptanceRadius);
+    }
+}
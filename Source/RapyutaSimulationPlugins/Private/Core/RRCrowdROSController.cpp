@@ -1,7 +1,12 @@
 // Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
 #include "Core/RRCrowdROSController.h"
 
+// UE
+#include "Engine/World.h"
+
 // RapyutaSimulationPlugins
+#include "Core/RRCrowdROS2Bridge.h"
+#include "Core/RRROS2GameMode.h"
 #include "Robots/RRBaseRobot.h"
 #include "Robots/RRRobotROS2Interface.h"
 
@@ -9,6 +14,15 @@ void ARRCrowdROSController::OnPossess(APawn* InPawn)
 {
     Super::OnPossess(InPawn);
 
+    if (bBatchedROS2)
+    {
+        if (auto* gameMode = GetWorld()->GetAuthGameMode<ARRROS2GameMode>())
+        {
+            gameMode->GetCrowdROS2Bridge()->AddAgent(this);
+        }
+        return;
+    }
+
     // NOTE: Init InPawn's ROS 2 interface here (not right after its creation in ARRBaseRobot) for:
     // + Controller, upon posses/unpossess, acts as the pivot to start/stop robot's ROS2Interface
     // + InPawn's ROS2Interface, due to requirements for also instantiatable in ARRBaseRobot's child BPs, may not have been
@@ -28,6 +42,16 @@ void ARRCrowdROSController::OnPossess(APawn* InPawn)
 
 void ARRCrowdROSController::OnUnPossess()
 {
+    if (bBatchedROS2)
+    {
+        if (auto* gameMode = GetWorld()->GetAuthGameMode<ARRROS2GameMode>())
+        {
+            gameMode->GetCrowdROS2Bridge()->RemoveAgent(this);
+        }
+        Super::OnUnPossess();
+        return;
+    }
+
     auto* robot = GetPawn<ARRBaseRobot>();
     if (robot)
     {
@@ -0,0 +1,132 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRDatasetWriter.h"
+
+// UE
+#include "Async/Async.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRCoreUtils.h"
+#include "RapyutaSimulationPlugins.h"
+
+FRRDatasetWriter::~FRRDatasetWriter()
+{
+    Flush();
+}
+
+bool FRRDatasetWriter::Init(const FString& InOutputFolderPath,
+                            const int32 InMaxPendingSamplesNum,
+                            const uint64 InMinFreeDiskSpaceInBytes)
+{
+    Flush();
+    OutputFolderPath = InOutputFolderPath;
+    MaxPendingSamplesNum = FMath::Max(InMaxPendingSamplesNum, 1);
+    MinFreeDiskSpaceInBytes = InMinFreeDiskSpaceInBytes;
+    SamplesSinceDiskSpaceCheck = 0;
+    bEnoughDiskSpace = true;
+    FailedSamplesNum.Reset();
+
+    // Image wrappers are created by worker threads from the module, which must be loaded in the game thread
+    URRCoreUtils::LoadImageWrapperModule();
+    return URRCoreUtils::CreateDirectoryIfNotExisting(OutputFolderPath);
+}
+
+bool FRRDatasetWriter::Enqueue(FRRDatasetSample&& InSample)
+{
+    check(IsInGameThread());
+    if (!HasCapacity())
+    {
+        return false;
+    }
+
+    if ((SamplesSinceDiskSpaceCheck == 0) || !bEnoughDiskSpace)
+    {
+        bEnoughDiskSpace = URRCoreUtils::HasEnoughDiskSpace(
+            OutputFolderPath, MinFreeDiskSpaceInBytes + DISK_SPACE_CHECK_INTERVAL * InSample.GetDataSize());
+    }
+    SamplesSinceDiskSpaceCheck = (SamplesSinceDiskSpaceCheck + 1) % DISK_SPACE_CHECK_INTERVAL;
+    if (!bEnoughDiskSpace)
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Dataset sample [%s] dropped, short of disk space"), *InSample.FilePath);
+        FailedSamplesNum.Increment();
+        return false;
+    }
+
+    WriteTasks.RemoveAllSwap([](const TFuture<void>& InTask) { return InTask.IsReady(); });
+    PendingSamplesNum.Increment();
+    WriteTasks.Emplace(Async(EAsyncExecution::ThreadPool,
+                             [this, outputFolderPath = OutputFolderPath, sample = MoveTemp(InSample)]()
+                             {
+                                 if (!WriteSample(outputFolderPath, sample))
+                                 {
+                                     FailedSamplesNum.Increment();
+                                 }
+                                 PendingSamplesNum.Decrement();
+                             }));
+    return true;
+}
+
+void FRRDatasetWriter::Flush()
+{
+    for (auto& task : WriteTasks)
+    {
+        task.Wait();
+    }
+    WriteTasks.Reset();
+}
+
+bool FRRDatasetWriter::WriteSample(const FString& InOutputFolderPath, const FRRDatasetSample& InSample)
+{
+    const FString filePathNoExt = FPaths::Combine(InOutputFolderPath, InSample.FilePath);
+    bool bWritten = false;
+    switch (InSample.Type)
+    {
+        case ERRDatasetSampleType::COLOR:
+        case ERRDatasetSampleType::DEPTH:
+        {
+            const bool bColor = (ERRDatasetSampleType::COLOR == InSample.Type);
+            const int64 pixelsNum = static_cast<int64>(InSample.Width) * InSample.Height;
+            if ((pixelsNum <= 0) || (pixelsNum != (bColor ? InSample.ColorData.Num() : InSample.DepthData.Num())))
+            {
+                break;
+            }
+
+            // Image wrappers are stateful, thus one per task
+            TSharedPtr<IImageWrapper> imageWrapper =
+                URRCoreUtils::SImageWrapperModule->CreateImageWrapper(bColor ? EImageFormat::PNG : EImageFormat::EXR);
+            const bool bRawSet = bColor ? imageWrapper->SetRaw(InSample.ColorData.GetData(),
+                                                               InSample.ColorData.Num() * sizeof(FColor),
+                                                               InSample.Width,
+                                                               InSample.Height,
+                                                               ERGBFormat::BGRA,
+                                                               8)
+                                        : imageWrapper->SetRaw(InSample.DepthData.GetData(),
+                                                               InSample.DepthData.Num() * sizeof(float),
+                                                               InSample.Width,
+                                                               InSample.Height,
+                                                               ERGBFormat::GrayF,
+                                                               32);
+            if (bRawSet)
+            {
+                const TArray64<uint8>& compressedData = imageWrapper->GetCompressed();
+                bWritten = FFileHelper::SaveArrayToFile(
+                    compressedData,
+                    *(filePathNoExt + URRCoreUtils::GetSimFileExt(bColor ? ERRFileType::IMAGE_PNG : ERRFileType::IMAGE_EXR)));
+            }
+            break;
+        }
+        case ERRDatasetSampleType::TEXT:
+            bWritten = FFileHelper::SaveStringToFile(InSample.Text, *(filePathNoExt + TEXT(".txt")));
+            break;
+    }
+
+    if (!bWritten)
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("Failed writing dataset sample [%s]"), *filePathNoExt);
+    }
+    return bWritten;
+}
@@ -0,0 +1,1337 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRGLTFLoader.h"
+
+// UE
+#include "Async/ParallelFor.h"
+#include "Dom/JsonObject.h"
+#include "Misc/Base64.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRMeshData.h"
+#include "Core/RRTrace.h"
+#include "RapyutaSimulationPlugins.h"
+
+namespace
+{
+// Meshopt vertex codec
+constexpr int32 VERTEX_BLOCK_SIZE_BYTES = 8192;
+constexpr int32 VERTEX_BLOCK_MAX_SIZE = 256;
+constexpr int32 BYTE_GROUP_SIZE = 16;
+constexpr int32 BYTE_GROUP_DECODE_LIMIT = 24;
+constexpr int32 TAIL_MAX_SIZE = 32;
+
+FORCEINLINE uint8 Unzigzag8(const uint8 InValue)
+{
+    return static_cast<uint8>(-(InValue & 1)) ^ (InValue >> 1);
+}
+
+//! Decode a group of 16 bytes of 0, 2, 4 or 8 bits each, values all ones being followed by their full byte
+const uint8* DecodeBytesGroup(const uint8* InData, uint8* OutBuffer, const int32 InBitsLog2)
+{
+    if (InBitsLog2 == 0)
+    {
+        FMemory::Memzero(OutBuffer, BYTE_GROUP_SIZE);
+        return InData;
+    }
+    if (InBitsLog2 == 3)
+    {
+        FMemory::Memcpy(OutBuffer, InData, BYTE_GROUP_SIZE);
+        return InData + BYTE_GROUP_SIZE;
+    }
+
+    const int32 bits = 1 << InBitsLog2;
+    const uint32 exception = (1u << bits) - 1;
+    const int32 valuesPerByte = 8 / bits;
+    const uint8* dataVar = InData + BYTE_GROUP_SIZE / valuesPerByte;
+    for (int32 i = 0; i < BYTE_GROUP_SIZE; ++i)
+    {
+        // Most significant bits first
+        const uint32 value = (InData[i / valuesPerByte] >> (8 - bits * (1 + i % valuesPerByte))) & exception;
+        OutBuffer[i] = (value == exception) ? *dataVar++ : static_cast<uint8>(value);
+    }
+    return dataVar;
+}
+
+const uint8* DecodeBytes(const uint8* InData, const uint8* InDataEnd, uint8* OutBuffer, const int32 InBufferSize)
+{
+    const int32 headerSize = (InBufferSize / BYTE_GROUP_SIZE + 3) / 4;
+    if (InDataEnd - InData < headerSize)
+    {
+        return nullptr;
+    }
+    const uint8* header = InData;
+    const uint8* data = InData + headerSize;
+    for (int32 i = 0; i < InBufferSize; i += BYTE_GROUP_SIZE)
+    {
+        if (InDataEnd - data < BYTE_GROUP_DECODE_LIMIT)
+        {
+            return nullptr;
+        }
+        const int32 headerOffset = i / BYTE_GROUP_SIZE;
+        const int32 bitsLog2 = (header[headerOffset / 4] >> ((headerOffset % 4) * 2)) & 3;
+        data = DecodeBytesGroup(data, OutBuffer + i, bitsLog2);
+    }
+    return data;
+}
+
+//! Decode a block of vertices, each byte being delta-coded from the same byte of the previous vertex
+const uint8* DecodeVertexBlock(const uint8* InData,
+                               const uint8* InDataEnd,
+                               uint8* OutVertices,
+                               const int32 InCount,
+                               const int32 InSize,
+                               uint8* InOutLastVertex)
+{
+    uint8 buffer[VERTEX_BLOCK_MAX_SIZE];
+    uint8 transposed[VERTEX_BLOCK_SIZE_BYTES];
+    const int32 alignedCount = (InCount + BYTE_GROUP_SIZE - 1) & ~(BYTE_GROUP_SIZE - 1);
+    const uint8* data = InData;
+    for (int32 k = 0; k < InSize; ++k)
+    {
+        data = DecodeBytes(data, InDataEnd, buffer, alignedCount);
+        if (nullptr == data)
+        {
+            return nullptr;
+        }
+        uint8 previous = InOutLastVertex[k];
+        for (int32 i = 0; i < InCount; ++i)
+        {
+            previous += Unzigzag8(buffer[i]);
+            transposed[i * InSize + k] = previous;
+        }
+    }
+    FMemory::Memcpy(OutVertices, transposed, InCount * InSize);
+    FMemory::Memcpy(InOutLastVertex, &transposed[InSize * (InCount - 1)], InSize);
+    return data;
+}
+
+// Meshopt index codecs
+uint32 DecodeVByte(const uint8*& InOutData)
+{
+    const uint8 lead = *InOutData++;
+    if (lead < 128)
+    {
+        return lead;
+    }
+    uint32 result = lead & 127;
+    int32 shift = 7;
+    for (int32 i = 0; i < 4; ++i)
+    {
+        const uint8 group = *InOutData++;
+        result |= static_cast<uint32>(group & 127) << shift;
+        shift += 7;
+        if (group < 128)
+        {
+            break;
+        }
+    }
+    return result;
+}
+
+FORCEINLINE uint32 DecodeIndex(const uint8*& InOutData, const uint32 InLast)
+{
+    const uint32 v = DecodeVByte(InOutData);
+    const uint32 delta = (v >> 1) ^ (0u - (v & 1));
+    return InLast + delta;
+}
+
+FORCEINLINE void WriteIndex(uint8* OutData, const int32 InIndex, const int32 InIndexSize, const uint32 InValue)
+{
+    if (InIndexSize == 2)
+    {
+        reinterpret_cast<uint16*>(OutData)[InIndex] = static_cast<uint16>(InValue);
+    }
+    else
+    {
+        reinterpret_cast<uint32*>(OutData)[InIndex] = InValue;
+    }
+}
+
+struct FIndexFifos
+{
+    uint32 Edges[16][2];
+    uint32 Vertices[16];
+    uint32 EdgesOffset = 0;
+    uint32 VerticesOffset = 0;
+
+    FIndexFifos()
+    {
+        FMemory::Memset(Edges, 0xFF, sizeof(Edges));
+        FMemory::Memset(Vertices, 0xFF, sizeof(Vertices));
+    }
+
+    void PushEdge(const uint32 InA, const uint32 InB)
+    {
+        Edges[EdgesOffset][0] = InA;
+        Edges[EdgesOffset][1] = InB;
+        EdgesOffset = (EdgesOffset + 1) & 15;
+    }
+
+    void PushVertex(const uint32 InV, const bool bInCond = true)
+    {
+        Vertices[VerticesOffset] = InV;
+        VerticesOffset = (VerticesOffset + (bInCond ? 1 : 0)) & 15;
+    }
+};
+
+// Meshopt filters
+template<typename T>
+void DecodeFilterOct(T* InOutData, const int32 InCount)
+{
+    const float maxValue = static_cast<float>((1 << (sizeof(T) * 8 - 1)) - 1);
+    for (int32 i = 0; i < InCount; ++i)
+    {
+        // z stores the value encoding 1
+        float x = static_cast<float>(InOutData[i * 4 + 0]);
+        float y = static_cast<float>(InOutData[i * 4 + 1]);
+        const float z = static_cast<float>(InOutData[i * 4 + 2]) - FMath::Abs(x) - FMath::Abs(y);
+        const float t = (z >= 0.f) ? 0.f : z;
+        x += (x >= 0.f) ? t : -t;
+        y += (y >= 0.f) ? t : -t;
+        const float s = maxValue / FMath::Sqrt(x * x + y * y + z * z);
+        InOutData[i * 4 + 0] = static_cast<T>(FMath::RoundHalfFromZero(x * s));
+        InOutData[i * 4 + 1] = static_cast<T>(FMath::RoundHalfFromZero(y * s));
+        InOutData[i * 4 + 2] = static_cast<T>(FMath::RoundHalfFromZero(z * s));
+    }
+}
+
+void DecodeFilterQuat(int16* InOutData, const int32 InCount)
+{
+    const float scale = 1.f / FMath::Sqrt(2.f);
+    for (int32 i = 0; i < InCount; ++i)
+    {
+        int16* q = InOutData + i * 4;
+        // The scale is stored in the high bits of the 4th component, the index of the max component in its 2 low bits
+        const float ss = scale / static_cast<float>(q[3] | 3);
+        const float x = q[0] * ss;
+        const float y = q[1] * ss;
+        const float z = q[2] * ss;
+        const float w = FMath::Sqrt(FMath::Max(0.f, 1.f - x * x - y * y - z * z));
+        const int32 maxComponent = q[3] & 3;
+        const int16 xf = static_cast<int16>(FMath::RoundHalfFromZero(x * 32767.f));
+        const int16 yf = static_cast<int16>(FMath::RoundHalfFromZero(y * 32767.f));
+        const int16 zf = static_cast<int16>(FMath::RoundHalfFromZero(z * 32767.f));
+        const int16 wf = static_cast<int16>(FMath::RoundHalfFromZero(w * 32767.f));
+        q[(maxComponent + 1) & 3] = xf;
+        q[(maxComponent + 2) & 3] = yf;
+        q[(maxComponent + 3) & 3] = zf;
+        q[(maxComponent + 0) & 3] = wf;
+    }
+}
+
+void DecodeFilterExp(uint32* InOutData, const int32 InCount)
+{
+    for (int32 i = 0; i < InCount; ++i)
+    {
+        // 24-bit signed mantissa & 8-bit signed exponent, ie ldexp(m, e)
+        const uint32 v = InOutData[i];
+        const int32 m = static_cast<int32>(v << 8) >> 8;
+        const int32 e = static_cast<int32>(v) >> 24;
+        const float value = static_cast<float>(m) * FMath::Pow(2.f, static_cast<float>(e));
+        FMemory::Memcpy(&InOutData[i], &value, sizeof(float));
+    }
+}
+}    // namespace
+
+bool FRRMeshoptDecoder::DecodeVertexBuffer(uint8* OutData,
+                                           const int32 InCount,
+                                           const int32 InSize,
+                                           const uint8* InBuffer,
+                                           const int32 InBufferSize)
+{
+    if ((InSize <= 0) || (InSize > VERTEX_BLOCK_MAX_SIZE) || (InSize % 4 != 0) || (InBufferSize < 1 + InSize))
+    {
+        return false;
+    }
+    const uint8* data = InBuffer;
+    const uint8* dataEnd = InBuffer + InBufferSize;
+    if (((data[0] & 0xF0) != 0xA0) || ((data[0] & 0x0F) != 0))
+    {
+        return false;
+    }
+    ++data;
+
+    // The first vertex deltas are coded from the tail
+    uint8 lastVertex[VERTEX_BLOCK_MAX_SIZE];
+    FMemory::Memcpy(lastVertex, dataEnd - InSize, InSize);
+    // The tail padding keeps byte groups decodable up to the end
+    const int32 tailSize = FMath::Max(InSize, TAIL_MAX_SIZE);
+    const int32 blockSize = FMath::Min((VERTEX_BLOCK_SIZE_BYTES / InSize) & ~(BYTE_GROUP_SIZE - 1), VERTEX_BLOCK_MAX_SIZE);
+    for (int32 offset = 0; offset < InCount; offset += blockSize)
+    {
+        const int32 count = FMath::Min(blockSize, InCount - offset);
+        data = DecodeVertexBlock(data, dataEnd, OutData + offset * InSize, count, InSize, lastVertex);
+        if (nullptr == data)
+        {
+            return false;
+        }
+    }
+    return (dataEnd - data) == tailSize;
+}
+
+bool FRRMeshoptDecoder::DecodeIndexBuffer(uint8* OutData,
+                                          const int32 InCount,
+                                          const int32 InIndexSize,
+                                          const uint8* InBuffer,
+                                          const int32 InBufferSize)
+{
+    if ((InCount % 3 != 0) || ((InIndexSize != 2) && (InIndexSize != 4)) || (InBufferSize < 1 + InCount / 3 + 16))
+    {
+        return false;
+    }
+    const int32 version = InBuffer[0] & 0x0F;
+    if (((InBuffer[0] & 0xF0) != 0xE0) || (version > 1))
+    {
+        return false;
+    }
+
+    FIndexFifos fifos;
+    uint32 next = 0;
+    uint32 last = 0;
+    const int32 fecMax = (version >= 1) ? 13 : 15;
+    const uint8* code = InBuffer + 1;
+    const uint8* data = code + InCount / 3;
+    const uint8* dataSafeEnd = InBuffer + InBufferSize - 16;
+    const uint8* codeAuxTable = dataSafeEnd;
+    for (int32 i = 0; i < InCount; i += 3)
+    {
+        if (data > dataSafeEnd)
+        {
+            return false;
+        }
+        const uint8 codeTri = *code++;
+        uint32 a = 0;
+        uint32 b = 0;
+        uint32 c = 0;
+        if (codeTri < 0xF0)
+        {
+            // Edge from the fifo & a vertex from the fifo, the next one or a free one
+            const int32 fe = codeTri >> 4;
+            a = fifos.Edges[(fifos.EdgesOffset - 1 - fe) & 15][0];
+            b = fifos.Edges[(fifos.EdgesOffset - 1 - fe) & 15][1];
+            const int32 fec = codeTri & 15;
+            if (fec < fecMax)
+            {
+                const bool bNext = (fec == 0);
+                c = bNext ? next : fifos.Vertices[(fifos.VerticesOffset - 1 - fec) & 15];
+                next += bNext ? 1 : 0;
+                fifos.PushVertex(c, bNext);
+            }
+            else
+            {
+                // 13, 14 -> -1, +1 from the last free index
+                last = c = (fec != 15) ? (last + (fec - (fec ^ 3))) : DecodeIndex(data, last);
+                fifos.PushVertex(c);
+            }
+            WriteIndex(OutData, i, InIndexSize, a);
+            WriteIndex(OutData, i + 1, InIndexSize, b);
+            WriteIndex(OutData, i + 2, InIndexSize, c);
+            fifos.PushEdge(c, b);
+            fifos.PushEdge(a, c);
+            continue;
+        }
+
+        // New triangle, its first vertex being the next one
+        int32 feb = 0;
+        int32 fec = 0;
+        if (codeTri < 0xFE)
+        {
+            const uint8 codeAux = codeAuxTable[codeTri & 15];
+            feb = codeAux >> 4;
+            fec = codeAux & 15;
+            a = next++;
+            b = (feb == 0) ? next : fifos.Vertices[(fifos.VerticesOffset - feb) & 15];
+            next += (feb == 0) ? 1 : 0;
+            c = (fec == 0) ? next : fifos.Vertices[(fifos.VerticesOffset - fec) & 15];
+            next += (fec == 0) ? 1 : 0;
+            fifos.PushVertex(a);
+            fifos.PushVertex(b, feb == 0);
+            fifos.PushVertex(c, fec == 0);
+        }
+        else
+        {
+            const uint8 codeAux = *data++;
+            const int32 fea = (codeTri == 0xFE) ? 0 : 15;
+            feb = codeAux >> 4;
+            fec = codeAux & 15;
+            if (codeAux == 0)
+            {
+                next = 0;
+            }
+            // next is incremented for all vertices before the free indices are decoded, as encoded
+            a = (fea == 0) ? next++ : 0;
+            b = (feb == 0) ? next++ : fifos.Vertices[(fifos.VerticesOffset - feb) & 15];
+            c = (fec == 0) ? next++ : fifos.Vertices[(fifos.VerticesOffset - fec) & 15];
+            if (fea == 15)
+            {
+                last = a = DecodeIndex(data, last);
+            }
+            if (feb == 15)
+            {
+                last = b = DecodeIndex(data, last);
+            }
+            if (fec == 15)
+            {
+                last = c = DecodeIndex(data, last);
+            }
+            fifos.PushVertex(a);
+            fifos.PushVertex(b, (feb == 0) || (feb == 15));
+            fifos.PushVertex(c, (fec == 0) || (fec == 15));
+        }
+        WriteIndex(OutData, i, InIndexSize, a);
+        WriteIndex(OutData, i + 1, InIndexSize, b);
+        WriteIndex(OutData, i + 2, InIndexSize, c);
+        fifos.PushEdge(b, a);
+        fifos.PushEdge(c, b);
+        fifos.PushEdge(a, c);
+    }
+    return data == dataSafeEnd;
+}
+
+bool FRRMeshoptDecoder::DecodeIndexSequence(uint8* OutData,
+                                            const int32 InCount,
+                                            const int32 InIndexSize,
+                                            const uint8* InBuffer,
+                                            const int32 InBufferSize)
+{
+    if (((InIndexSize != 2) && (InIndexSize != 4)) || (InBufferSize < 1 + InCount + 4))
+    {
+        return false;
+    }
+    if (((InBuffer[0] & 0xF0) != 0xD0) || ((InBuffer[0] & 0x0F) > 1))
+    {
+        return false;
+    }
+
+    const uint8* data = InBuffer + 1;
+    const uint8* dataSafeEnd = InBuffer + InBufferSize - 4;
+    // Deltas from one of 2 baselines, selected by the low bit
+    uint32 last[2] = {0, 0};
+    for (int32 i = 0; i < InCount; ++i)
+    {
+        if (data >= dataSafeEnd)
+        {
+            return false;
+        }
+        uint32 v = DecodeVByte(data);
+        const uint32 baseline = v & 1;
+        v >>= 1;
+        const uint32 delta = (v >> 1) ^ (0u - (v & 1));
+        last[baseline] += delta;
+        WriteIndex(OutData, i, InIndexSize, last[baseline]);
+    }
+    return data == dataSafeEnd;
+}
+
+bool FRRMeshoptDecoder::DecodeFilter(const FString& InFilter, uint8* InOutData, const int32 InCount, const int32 InStride)
+{
+    if (InFilter.IsEmpty() || InFilter.Equals(TEXT("NONE")))
+    {
+        return true;
+    }
+    if (InFilter.Equals(TEXT("OCTAHEDRAL")))
+    {
+        if (InStride == 4)
+        {
+            DecodeFilterOct(reinterpret_cast<int8*>(InOutData), InCount);
+            return true;
+        }
+        if (InStride == 8)
+        {
+            DecodeFilterOct(reinterpret_cast<int16*>(InOutData), InCount);
+            return true;
+        }
+        return false;
+    }
+    if (InFilter.Equals(TEXT("QUATERNION")))
+    {
+        if (InStride == 8)
+        {
+            DecodeFilterQuat(reinterpret_cast<int16*>(InOutData), InCount);
+            return true;
+        }
+        return false;
+    }
+    if (InFilter.Equals(TEXT("EXPONENTIAL")))
+    {
+        if (InStride % 4 == 0)
+        {
+            DecodeFilterExp(reinterpret_cast<uint32*>(InOutData), InCount * InStride / 4);
+            return true;
+        }
+        return false;
+    }
+    return false;
+}
+
+namespace
+{
+constexpr uint32 GLB_MAGIC = 0x46546C67;    // "glTF"
+constexpr uint32 GLB_CHUNK_JSON = 0x4E4F534A;
+constexpr uint32 GLB_CHUNK_BIN = 0x004E4942;
+
+constexpr int32 GLTF_BYTE = 5120;
+constexpr int32 GLTF_UNSIGNED_BYTE = 5121;
+constexpr int32 GLTF_SHORT = 5122;
+constexpr int32 GLTF_UNSIGNED_SHORT = 5123;
+constexpr int32 GLTF_UNSIGNED_INT = 5125;
+constexpr int32 GLTF_FLOAT = 5126;
+
+constexpr int32 GLTF_MODE_TRIANGLES = 4;
+constexpr int32 GLTF_MODE_TRIANGLE_STRIP = 5;
+constexpr int32 GLTF_MODE_TRIANGLE_FAN = 6;
+
+int32 GetComponentSize(const int32 InComponentType)
+{
+    switch (InComponentType)
+    {
+        case GLTF_BYTE:
+        case GLTF_UNSIGNED_BYTE:
+            return 1;
+        case GLTF_SHORT:
+        case GLTF_UNSIGNED_SHORT:
+            return 2;
+        case GLTF_UNSIGNED_INT:
+        case GLTF_FLOAT:
+            return 4;
+        default:
+            return 0;
+    }
+}
+
+int32 GetComponentsNum(const FString& InType)
+{
+    static const TMap<FString, int32> sComponentsNums = {
+        {TEXT("SCALAR"), 1}, {TEXT("VEC2"), 2}, {TEXT("VEC3"), 3}, {TEXT("VEC4"), 4}, {TEXT("MAT4"), 16}};
+    const int32* componentsNum = sComponentsNums.Find(InType);
+    return componentsNum ? *componentsNum : 0;
+}
+
+//! Read a component as float, normalized integers being mapped to [0, 1] or [-1, 1]
+float ReadComponent(const uint8* InData, const int32 InComponentType, const bool bInNormalized)
+{
+    switch (InComponentType)
+    {
+        case GLTF_BYTE:
+        {
+            const int8 v = *reinterpret_cast<const int8*>(InData);
+            return bInNormalized ? FMath::Max(v / 127.f, -1.f) : v;
+        }
+        case GLTF_UNSIGNED_BYTE:
+            return bInNormalized ? (*InData / 255.f) : *InData;
+        case GLTF_SHORT:
+        {
+            int16 v;
+            FMemory::Memcpy(&v, InData, sizeof(v));
+            return bInNormalized ? FMath::Max(v / 32767.f, -1.f) : v;
+        }
+        case GLTF_UNSIGNED_SHORT:
+        {
+            uint16 v;
+            FMemory::Memcpy(&v, InData, sizeof(v));
+            return bInNormalized ? (v / 65535.f) : v;
+        }
+        case GLTF_UNSIGNED_INT:
+        {
+            uint32 v;
+            FMemory::Memcpy(&v, InData, sizeof(v));
+            return static_cast<float>(v);
+        }
+        case GLTF_FLOAT:
+        {
+            float v;
+            FMemory::Memcpy(&v, InData, sizeof(v));
+            return v;
+        }
+        default:
+            return 0.f;
+    }
+}
+
+//! Decode the %XX escapes of a relative URI
+FString DecodeURI(const FString& InURI)
+{
+    FString decoded;
+    decoded.Reserve(InURI.Len());
+    for (int32 i = 0; i < InURI.Len(); ++i)
+    {
+        if ((InURI[i] == TCHAR('%')) && (i + 2 < InURI.Len()) && FChar::IsHexDigit(InURI[i + 1]) &&
+            FChar::IsHexDigit(InURI[i + 2]))
+        {
+            decoded.AppendChar(static_cast<TCHAR>(FParse::HexDigit(InURI[i + 1]) * 16 + FParse::HexDigit(InURI[i + 2])));
+            i += 2;
+        }
+        else
+        {
+            decoded.AppendChar(InURI[i]);
+        }
+    }
+    return decoded;
+}
+
+/**
+ * @brief Parsed glTF document, its buffers loaded & its meshopt-compressed buffer views decoded upfront
+ */
+class FRRGLTFFile
+{
+public:
+    bool Parse(const FString& InFilePath)
+    {
+        FilePath = InFilePath;
+        TArray<uint8> fileData;
+        if (!FFileHelper::LoadFileToArray(fileData, *InFilePath))
+        {
+            return Error(TEXT("could not be read"));
+        }
+
+        FString json;
+        TArray<uint8> glbBin;
+        const uint32* words = reinterpret_cast<const uint32*>(fileData.GetData());
+        if ((fileData.Num() >= 20) && (words[0] == GLB_MAGIC))
+        {
+            // Header, JSON chunk then optional BIN chunk
+            if ((words[1] != 2) || (static_cast<int64>(words[2]) > fileData.Num()))
+            {
+                return Error(TEXT("is not a valid GLB 2.0 file"));
+            }
+            int64 offset = 12;
+            while (offset + 8 <= words[2])
+            {
+                uint32 chunkLength = 0;
+                uint32 chunkType = 0;
+                FMemory::Memcpy(&chunkLength, &fileData[offset], sizeof(uint32));
+                FMemory::Memcpy(&chunkType, &fileData[offset + 4], sizeof(uint32));
+                offset += 8;
+                if (offset + chunkLength > words[2])
+                {
+                    return Error(TEXT("has a truncated GLB chunk"));
+                }
+                if (chunkType == GLB_CHUNK_JSON)
+                {
+                    FUTF8ToTCHAR converter(reinterpret_cast<const ANSICHAR*>(&fileData[offset]), chunkLength);
+                    json = FString(converter.Length(), converter.Get());
+                }
+                else if ((chunkType == GLB_CHUNK_BIN) && (glbBin.Num() == 0))
+                {
+                    glbBin.Append(&fileData[offset], chunkLength);
+                }
+                // Chunks are 4-byte aligned
+                offset += (chunkLength + 3) & ~3u;
+            }
+        }
+        else
+        {
+            FFileHelper::BufferToString(json, fileData.GetData(), fileData.Num());
+        }
+
+        const TSharedRef<TJsonReader<>> reader = TJsonReaderFactory<>::Create(json);
+        if (!FJsonSerializer::Deserialize(reader, Root) || !Root.IsValid())
+        {
+            return Error(TEXT("has invalid JSON"));
+        }
+
+        // Other extensions only alter what is not loaded, eg textures or material models
+        static const TSet<FString> sSupportedRequiredExtensions = {TEXT("EXT_meshopt_compression"),
+                                                                    TEXT("KHR_meshopt_compression"),
+                                                                    TEXT("KHR_mesh_quantization"),
+                                                                    TEXT("KHR_texture_transform"),
+                                                                    TEXT("KHR_materials_unlit"),
+                                                                    TEXT("KHR_materials_emissive_strength")};
+        const TArray<TSharedPtr<FJsonValue>>* requiredExtensions = nullptr;
+        if (Root->TryGetArrayField(TEXT("extensionsRequired"), requiredExtensions))
+        {
+            for (const auto& extension : *requiredExtensions)
+            {
+                if (!sSupportedRequiredExtensions.Contains(extension->AsString()))
+                {
+                    return Error(*FString::Printf(TEXT("requires unsupported extension %s"), *extension->AsString()));
+                }
+            }
+        }
+
+        // Buffers
+        Root->TryGetArrayField(TEXT("bufferViews"), BufferViews);
+        Root->TryGetArrayField(TEXT("accessors"), Accessors);
+        const TArray<TSharedPtr<FJsonValue>>* buffers = nullptr;
+        if (Root->TryGetArrayField(TEXT("buffers"), buffers))
+        {
+            Buffers.SetNum(buffers->Num());
+            for (int32 i = 0; i < buffers->Num(); ++i)
+            {
+                const TSharedPtr<FJsonObject> buffer = (*buffers)[i]->AsObject();
+                FString uri;
+                if (!buffer.IsValid())
+                {
+                    return Error(TEXT("has an invalid buffer"));
+                }
+                if (!buffer->TryGetStringField(TEXT("uri"), uri))
+                {
+                    // GLB-stored buffer, or meshopt fallback buffer without data
+                    if (i == 0)
+                    {
+                        Buffers[i] = MoveTemp(glbBin);
+                    }
+                    continue;
+                }
+                if (uri.StartsWith(TEXT("data:")))
+                {
+                    int32 commaIndex = INDEX_NONE;
+                    if (!uri.FindChar(TCHAR(','), commaIndex) || !uri.Left(commaIndex).EndsWith(TEXT(";base64")) ||
+                        !FBase64::Decode(uri.Mid(commaIndex + 1), Buffers[i]))
+                    {
+                        return Error(TEXT("has an invalid data URI buffer"));
+                    }
+                }
+                else if (!FFileHelper::LoadFileToArray(Buffers[i], *FPaths::Combine(FPaths::GetPath(FilePath), DecodeURI(uri))))
+                {
+                    return Error(*FString::Printf(TEXT("references missing buffer %s"), *uri));
+                }
+            }
+        }
+
+        // Meshopt-compressed views decoded upfront, accessors being then read concurrently
+        DecodedViews.SetNum(BufferViews ? BufferViews->Num() : 0);
+        bDecodedViews.Init(false, DecodedViews.Num());
+        for (int32 i = 0; i < DecodedViews.Num(); ++i)
+        {
+            const TSharedPtr<FJsonObject> view = (*BufferViews)[i]->AsObject();
+            const TSharedPtr<FJsonObject>* meshopt = GetMeshoptExtension(view);
+            if (meshopt && !DecodeView(i, **meshopt))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Get the data of a buffer view, decoded if meshopt-compressed
+     * @return false if invalid
+     */
+    bool GetBufferView(const int32 InViewIndex, const uint8*& OutData, int64& OutSize, int32& OutStride) const
+    {
+        if ((nullptr == BufferViews) || !BufferViews->IsValidIndex(InViewIndex))
+        {
+            return false;
+        }
+        const TSharedPtr<FJsonObject> view = (*BufferViews)[InViewIndex]->AsObject();
+        OutStride = view->HasField(TEXT("byteStride")) ? static_cast<int32>(view->GetNumberField(TEXT("byteStride"))) : 0;
+        if (bDecodedViews[InViewIndex])
+        {
+            OutData = DecodedViews[InViewIndex].GetData();
+            OutSize = DecodedViews[InViewIndex].Num();
+            return true;
+        }
+        return GetBufferRange(*view, OutData, OutSize);
+    }
+
+    /**
+     * @brief Read an accessor as floats
+     * @param InAccessorIndex
+     * @param InComponentsNum Expected num of components per element
+     * @param OutValues InComponentsNum floats per element
+     * @return false if invalid or sparse
+     */
+    bool ReadAccessor(const int32 InAccessorIndex, const int32 InComponentsNum, TArray<float>& OutValues) const
+    {
+        FAccessorView accessor;
+        if (!GetAccessorView(InAccessorIndex, InComponentsNum, false, accessor))
+        {
+            return false;
+        }
+        OutValues.SetNumZeroed(accessor.Count * InComponentsNum);
+        const uint8* element = accessor.Data;
+        for (int32 i = 0; element && (i < accessor.Count); ++i, element += accessor.Stride)
+        {
+            for (int32 c = 0; c < InComponentsNum; ++c)
+            {
+                OutValues[i * InComponentsNum + c] =
+                    ReadComponent(element + c * accessor.ComponentSize, accessor.ComponentType, accessor.bNormalized);
+            }
+        }
+        return true;
+    }
+
+    //! Read an index accessor, of unsigned integers
+    bool ReadIndices(const int32 InAccessorIndex, TArray<int32>& OutIndices) const
+    {
+        FAccessorView accessor;
+        if (!GetAccessorView(InAccessorIndex, 1, true, accessor))
+        {
+            return false;
+        }
+        OutIndices.SetNumZeroed(accessor.Count);
+        const uint8* element = accessor.Data;
+        for (int32 i = 0; element && (i < accessor.Count); ++i, element += accessor.Stride)
+        {
+            // Little endian
+            uint32 index = 0;
+            FMemory::Memcpy(&index, element, accessor.ComponentSize);
+            OutIndices[i] = static_cast<int32>(index);
+        }
+        return true;
+    }
+
+    //! Num of components per element of an accessor, 0 if invalid
+    int32 GetAccessorComponentsNum(const int32 InAccessorIndex) const
+    {
+        if ((nullptr == Accessors) || !Accessors->IsValidIndex(InAccessorIndex))
+        {
+            return 0;
+        }
+        return GetComponentsNum((*Accessors)[InAccessorIndex]->AsObject()->GetStringField(TEXT("type")));
+    }
+
+    bool Error(const TCHAR* InMessage) const
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("glTF file %s %s"), *FilePath, InMessage);
+        return false;
+    }
+
+    TSharedPtr<FJsonObject> Root;
+
+private:
+    static const TSharedPtr<FJsonObject>* GetMeshoptExtension(const TSharedPtr<FJsonObject>& InView)
+    {
+        const TSharedPtr<FJsonObject>* extensions = nullptr;
+        const TSharedPtr<FJsonObject>* meshopt = nullptr;
+        if (InView->TryGetObjectField(TEXT("extensions"), extensions) &&
+            ((*extensions)->TryGetObjectField(TEXT("EXT_meshopt_compression"), meshopt) ||
+             (*extensions)->TryGetObjectField(TEXT("KHR_meshopt_compression"), meshopt)))
+        {
+            return meshopt;
+        }
+        return nullptr;
+    }
+
+    bool GetBufferRange(const FJsonObject& InView, const uint8*& OutData, int64& OutSize) const
+    {
+        const int32 bufferIndex = static_cast<int32>(InView.GetNumberField(TEXT("buffer")));
+        const int64 byteOffset =
+            InView.HasField(TEXT("byteOffset")) ? static_cast<int64>(InView.GetNumberField(TEXT("byteOffset"))) : 0;
+        const int64 byteLength = static_cast<int64>(InView.GetNumberField(TEXT("byteLength")));
+        if (!Buffers.IsValidIndex(bufferIndex) || (byteOffset < 0) || (byteOffset + byteLength > Buffers[bufferIndex].Num()))
+        {
+            return false;
+        }
+        OutData = Buffers[bufferIndex].GetData() + byteOffset;
+        OutSize = byteLength;
+        return true;
+    }
+
+    bool DecodeView(const int32 InViewIndex, const FJsonObject& InMeshopt)
+    {
+        bDecodedViews[InViewIndex] = true;
+        const uint8* source = nullptr;
+        int64 sourceSize = 0;
+        if (!GetBufferRange(InMeshopt, source, sourceSize))
+        {
+            return Error(TEXT("has an invalid meshopt buffer view"));
+        }
+        const int32 count = static_cast<int32>(InMeshopt.GetNumberField(TEXT("count")));
+        const int32 stride = static_cast<int32>(InMeshopt.GetNumberField(TEXT("byteStride")));
+        const FString mode = InMeshopt.GetStringField(TEXT("mode"));
+        FString filter;
+        InMeshopt.TryGetStringField(TEXT("filter"), filter);
+
+        TArray<uint8>& decoded = DecodedViews[InViewIndex];
+        decoded.SetNumUninitialized(count * stride);
+        bool bDecoded = false;
+        if (mode.Equals(TEXT("ATTRIBUTES")))
+        {
+            bDecoded = FRRMeshoptDecoder::DecodeVertexBuffer(decoded.GetData(), count, stride, source, sourceSize) &&
+                       FRRMeshoptDecoder::DecodeFilter(filter, decoded.GetData(), count, stride);
+        }
+        else if (mode.Equals(TEXT("TRIANGLES")))
+        {
+            bDecoded = FRRMeshoptDecoder::DecodeIndexBuffer(decoded.GetData(), count, stride, source, sourceSize);
+        }
+        else if (mode.Equals(TEXT("INDICES")))
+        {
+            bDecoded = FRRMeshoptDecoder::DecodeIndexSequence(decoded.GetData(), count, stride, source, sourceSize);
+        }
+        if (!bDecoded)
+        {
+            decoded.Reset();
+            return Error(*FString::Printf(TEXT("has a meshopt buffer view %d failing to decode (%s)"), InViewIndex, *mode));
+        }
+        return true;
+    }
+
+    //! Elements of an accessor, Data being null if it has no buffer view, thus all zeros
+    struct FAccessorView
+    {
+        const uint8* Data = nullptr;
+        int32 Count = 0;
+        int32 Stride = 0;
+        int32 ComponentType = 0;
+        int32 ComponentSize = 0;
+        bool bNormalized = false;
+    };
+
+    bool GetAccessorView(const int32 InAccessorIndex,
+                         const int32 InComponentsNum,
+                         const bool bInIndices,
+                         FAccessorView& OutAccessor) const
+    {
+        if ((nullptr == Accessors) || !Accessors->IsValidIndex(InAccessorIndex))
+        {
+            return false;
+        }
+        const TSharedPtr<FJsonObject> accessor = (*Accessors)[InAccessorIndex]->AsObject();
+        const int32 count = static_cast<int32>(accessor->GetNumberField(TEXT("count")));
+        const int32 componentType = static_cast<int32>(accessor->GetNumberField(TEXT("componentType")));
+        const int32 componentsNum = GetComponentsNum(accessor->GetStringField(TEXT("type")));
+        const int32 componentSize = GetComponentSize(componentType);
+        if ((count < 0) || (componentsNum != InComponentsNum) || (componentSize == 0) || accessor->HasField(TEXT("sparse")) ||
+            (bInIndices && ((componentType == GLTF_FLOAT) || (componentType == GLTF_BYTE) || (componentType == GLTF_SHORT))))
+        {
+            return Error(*FString::Printf(TEXT("has unsupported accessor %d"), InAccessorIndex));
+        }
+        OutAccessor.Count = count;
+        OutAccessor.ComponentType = componentType;
+        OutAccessor.ComponentSize = componentSize;
+        accessor->TryGetBoolField(TEXT("normalized"), OutAccessor.bNormalized);
+        if (!accessor->HasField(TEXT("bufferView")))
+        {
+            return true;
+        }
+
+        const uint8* data = nullptr;
+        int64 size = 0;
+        int32 stride = 0;
+        if (!GetBufferView(static_cast<int32>(accessor->GetNumberField(TEXT("bufferView"))), data, size, stride))
+        {
+            return false;
+        }
+        const int64 byteOffset =
+            accessor->HasField(TEXT("byteOffset")) ? static_cast<int64>(accessor->GetNumberField(TEXT("byteOffset"))) : 0;
+        const int32 elementSize = componentsNum * componentSize;
+        stride = (stride > 0) ? stride : elementSize;
+        if ((count > 0) && (byteOffset + static_cast<int64>(stride) * (count - 1) + elementSize > size))
+        {
+            return Error(*FString::Printf(TEXT("has accessor %d out of its buffer view"), InAccessorIndex));
+        }
+        OutAccessor.Data = data + byteOffset;
+        OutAccessor.Stride = stride;
+        return true;
+    }
+
+    FString FilePath;
+    const TArray<TSharedPtr<FJsonValue>>* BufferViews = nullptr;
+    const TArray<TSharedPtr<FJsonValue>>* Accessors = nullptr;
+    TArray<TArray<uint8>> Buffers;
+    TArray<TArray<uint8>> DecodedViews;
+    TBitArray<> bDecodedViews;
+};
+
+//! A primitive to be converted into its slot of #FRRMeshData::Nodes, with its node's world matrix
+struct FRRGLTFPrimitiveJob
+{
+    int32 NodeIndex = 0;
+    int32 MeshIndex = 0;
+    TSharedPtr<FJsonObject> Primitive;
+    FMatrix WorldMatrix = FMatrix::Identity;
+};
+
+FMatrix GetNodeLocalMatrix(const FJsonObject& InNode)
+{
+    auto readNumbers = [&InNode](const TCHAR* InField, double* OutValues, const int32 InNum)
+    {
+        const TArray<TSharedPtr<FJsonValue>>* values = nullptr;
+        if (InNode.TryGetArrayField(InField, values) && (values->Num() == InNum))
+        {
+            for (int32 i = 0; i < InNum; ++i)
+            {
+                OutValues[i] = (*values)[i]->AsNumber();
+            }
+            return true;
+        }
+        return false;
+    };
+
+    // Column-major, thus the row-vector UE matrix read in order
+    double m[16];
+    if (readNumbers(TEXT("matrix"), m, 16))
+    {
+        FMatrix matrix;
+        for (int32 i = 0; i < 16; ++i)
+        {
+            matrix.M[i / 4][i % 4] = m[i];
+        }
+        return matrix;
+    }
+    double t[3] = {0., 0., 0.};
+    double r[4] = {0., 0., 0., 1.};
+    double s[3] = {1., 1., 1.};
+    readNumbers(TEXT("translation"), t, 3);
+    readNumbers(TEXT("rotation"), r, 4);
+    readNumbers(TEXT("scale"), s, 3);
+    return FScaleMatrix(FVector(s[0], s[1], s[2])) *
+           FQuatRotationTranslationMatrix(FQuat(r[0], r[1], r[2], r[3]), FVector(t[0], t[1], t[2]));
+}
+
+/**
+ * @brief Convert a triangle primitive, pre-transformed by its node, into UE space as Assimp's import does
+ * @return false if not a triangle primitive or invalid
+ */
+bool ProcessPrimitive(const FRRGLTFFile& InFile,
+                      const FJsonObject& InPrimitive,
+                      const FMatrix& InWorldMatrix,
+                      const float InScale,
+                      FRRMeshNodeData& OutMeshNodeData)
+{
+    const TSharedPtr<FJsonObject>* attributes = nullptr;
+    int32 positionAccessor = INDEX_NONE;
+    if (!InPrimitive.TryGetObjectField(TEXT("attributes"), attributes) ||
+        !(*attributes)->TryGetNumberField(TEXT("POSITION"), positionAccessor))
+    {
+        return false;
+    }
+    auto getAttribute = [attributes](const TCHAR* InName)
+    {
+        int32 accessor = INDEX_NONE;
+        (*attributes)->TryGetNumberField(InName, accessor);
+        return accessor;
+    };
+
+    // [Vertices] --, m -> cm & right -> left handed, as URRConversionUtils::ConvertHandedness()
+    TArray<float> values;
+    if (!InFile.ReadAccessor(positionAccessor, 3, values))
+    {
+        return false;
+    }
+    const int32 verticesNum = values.Num() / 3;
+    OutMeshNodeData.Vertices.SetNum(verticesNum);
+    FRRMeshVertex* outVertices = OutMeshNodeData.Vertices.GetData();
+    const double scale = 100. * InScale;
+    for (int32 i = 0; i < verticesNum; ++i)
+    {
+        const FVector p = InWorldMatrix.TransformPosition(FVector(values[3 * i], values[3 * i + 1], values[3 * i + 2])) * scale;
+        outVertices[i].Position = FVector3f(p.X, -p.Y, p.Z);
+    }
+
+    // [Triangles' indices] --
+    int32 mode = GLTF_MODE_TRIANGLES;
+    InPrimitive.TryGetNumberField(TEXT("mode"), mode);
+    if ((mode != GLTF_MODE_TRIANGLES) && (mode != GLTF_MODE_TRIANGLE_STRIP) && (mode != GLTF_MODE_TRIANGLE_FAN))
+    {
+        return false;
+    }
+    TArray<int32> indices;
+    int32 indicesAccessor = INDEX_NONE;
+    if (InPrimitive.TryGetNumberField(TEXT("indices"), indicesAccessor))
+    {
+        if (!InFile.ReadIndices(indicesAccessor, indices))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        indices.SetNumUninitialized(verticesNum);
+        for (int32 i = 0; i < verticesNum; ++i)
+        {
+            indices[i] = i;
+        }
+    }
+    if (mode == GLTF_MODE_TRIANGLES)
+    {
+        indices.SetNum(indices.Num() - indices.Num() % 3);
+        OutMeshNodeData.TriangleIndices = MoveTemp(indices);
+    }
+    else
+    {
+        // Strips alternate their winding, fans share their first vertex
+        OutMeshNodeData.TriangleIndices.Reserve(3 * FMath::Max(0, indices.Num() - 2));
+        for (int32 i = 2; i < indices.Num(); ++i)
+        {
+            const bool bOdd = (mode == GLTF_MODE_TRIANGLE_STRIP) && (i % 2 == 1);
+            const int32 a = (mode == GLTF_MODE_TRIANGLE_FAN) ? indices[0] : indices[i - 2];
+            OutMeshNodeData.TriangleIndices.Append({bOdd ? indices[i - 1] : a, bOdd ? a : indices[i - 1], indices[i]});
+        }
+    }
+    for (const int32 index : OutMeshNodeData.TriangleIndices)
+    {
+        if ((index < 0) || (index >= verticesNum))
+        {
+            return InFile.Error(TEXT("has out of range vertex indices"));
+        }
+    }
+
+    // [Normals] --, generated smooth as by Assimp's aiProcess_GenSmoothNormals only if missing
+    const FMatrix normalMatrix = InWorldMatrix.Inverse().GetTransposed();
+    const int32 normalAccessor = getAttribute(TEXT("NORMAL"));
+    if ((normalAccessor != INDEX_NONE) && InFile.ReadAccessor(normalAccessor, 3, values) && (values.Num() == 3 * verticesNum))
+    {
+        for (int32 i = 0; i < verticesNum; ++i)
+        {
+            const FVector n =
+                normalMatrix.TransformVector(FVector(values[3 * i], values[3 * i + 1], values[3 * i + 2])).GetSafeNormal();
+            outVertices[i].Normal = FPackedNormal(FVector3f(n.X, -n.Y, n.Z));
+        }
+    }
+    else
+    {
+        TArray<FVector3f> normals;
+        normals.SetNumZeroed(verticesNum);
+        const TArray<int32>& triangles = OutMeshNodeData.TriangleIndices;
+        for (int32 t = 0; t + 2 < triangles.Num(); t += 3)
+        {
+            // Area-weighted, in the mirrored space thus with the opposite winding
+            const FVector3f& p0 = outVertices[triangles[t]].Position;
+            const FVector3f& p1 = outVertices[triangles[t + 1]].Position;
+            const FVector3f& p2 = outVertices[triangles[t + 2]].Position;
+            const FVector3f faceNormal = (p0 - p1) ^ (p2 - p0);
+            normals[triangles[t]] += faceNormal;
+            normals[triangles[t + 1]] += faceNormal;
+            normals[triangles[t + 2]] += faceNormal;
+        }
+        for (int32 i = 0; i < verticesNum; ++i)
+        {
+            outVertices[i].Normal = FPackedNormal(normals[i].GetSafeNormal());
+        }
+    }
+
+    // [UVs] --, glTF & UE both having their origin at the top left
+    const int32 uvAccessor = getAttribute(TEXT("TEXCOORD_0"));
+    if ((uvAccessor != INDEX_NONE) && InFile.ReadAccessor(uvAccessor, 2, values) && (values.Num() == 2 * verticesNum))
+    {
+        for (int32 i = 0; i < verticesNum; ++i)
+        {
+            outVertices[i].UV = FVector2f(values[2 * i], values[2 * i + 1]);
+        }
+    }
+
+    // [Tangents] --, their bitangent sign flipped by the mirroring
+    const int32 tangentAccessor = getAttribute(TEXT("TANGENT"));
+    if ((tangentAccessor != INDEX_NONE) && InFile.ReadAccessor(tangentAccessor, 4, values) && (values.Num() == 4 * verticesNum))
+    {
+        for (int32 i = 0; i < verticesNum; ++i)
+        {
+            const FVector t =
+                InWorldMatrix.TransformVector(FVector(values[4 * i], values[4 * i + 1], values[4 * i + 2])).GetSafeNormal();
+            outVertices[i].Tangent = FPackedNormal(FVector4f(t.X, -t.Y, t.Z, (values[4 * i + 3] < 0.f) ? 1.f : -1.f));
+        }
+    }
+
+    // [VertexColors] --, only allocated if available
+    const int32 colorAccessor = getAttribute(TEXT("COLOR_0"));
+    const int32 colorComponentsNum = InFile.GetAccessorComponentsNum(colorAccessor);
+    if ((colorComponentsNum == 3) || (colorComponentsNum == 4))
+    {
+        const bool bRGBA = (colorComponentsNum == 4);
+        if (InFile.ReadAccessor(colorAccessor, colorComponentsNum, values) && (values.Num() == colorComponentsNum * verticesNum))
+        {
+            const int32 componentsNum = colorComponentsNum;
+            OutMeshNodeData.VertexColors.SetNumUninitialized(verticesNum);
+            for (int32 i = 0; i < verticesNum; ++i)
+            {
+                const float* c = &values[componentsNum * i];
+                OutMeshNodeData.VertexColors[i] = FLinearColor(c[0], c[1], c[2], bRGBA ? c[3] : 1.f).ToFColor(false);
+            }
+        }
+    }
+    return true;
+}
+
+FRRMeshMaterialData ProcessMaterial(const FJsonObject& InMaterial)
+{
+    auto readColor = [](const FJsonObject& InObject, const TCHAR* InField, FLinearColor& OutColor)
+    {
+        const TArray<TSharedPtr<FJsonValue>>* values = nullptr;
+        if (InObject.TryGetArrayField(InField, values) && (values->Num() >= 3))
+        {
+            OutColor = FLinearColor((*values)[0]->AsNumber(),
+                                    (*values)[1]->AsNumber(),
+                                    (*values)[2]->AsNumber(),
+                                    (values->Num() > 3) ? (*values)[3]->AsNumber() : 1.f);
+            return true;
+        }
+        return false;
+    };
+
+    FRRMeshMaterialData materialData;
+    FLinearColor color = FLinearColor::White;
+    const TSharedPtr<FJsonObject>* pbr = nullptr;
+    if (InMaterial.TryGetObjectField(TEXT("pbrMetallicRoughness"), pbr))
+    {
+        readColor(**pbr, TEXT("baseColorFactor"), color);
+    }
+    materialData.VectorParams.Add(TEXT("BaseColor"), color);
+    if (readColor(InMaterial, TEXT("emissiveFactor"), color))
+    {
+        materialData.VectorParams.Add(TEXT("Emissive"), color);
+    }
+    return materialData;
+}
+}    // namespace
+
+bool FRRGLTFLoader::IsGLTFFile(const FString& InFilePath)
+{
+    return InFilePath.EndsWith(TEXT(".gltf"), ESearchCase::IgnoreCase) ||
+           InFilePath.EndsWith(TEXT(".glb"), ESearchCase::IgnoreCase);
+}
+
+bool FRRGLTFLoader::Load(const FString& InFilePath, const float InMeshScale, FRRMeshData& OutMeshData)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRLoadGLTF", RRAssetChannel);
+    FRRGLTFFile file;
+    if (!file.Parse(InFilePath))
+    {
+        return false;
+    }
+    const TArray<TSharedPtr<FJsonValue>>* nodes = nullptr;
+    const TArray<TSharedPtr<FJsonValue>>* meshes = nullptr;
+    if (!file.Root->TryGetArrayField(TEXT("nodes"), nodes) || !file.Root->TryGetArrayField(TEXT("meshes"), meshes))
+    {
+        return file.Error(TEXT("has no mesh node"));
+    }
+
+    // Root nodes of the default scene, or of the first one
+    TArray<int32> rootNodes;
+    const TArray<TSharedPtr<FJsonValue>>* scenes = nullptr;
+    if (file.Root->TryGetArrayField(TEXT("scenes"), scenes) && (scenes->Num() > 0))
+    {
+        int32 sceneIndex = 0;
+        file.Root->TryGetNumberField(TEXT("scene"), sceneIndex);
+        const TArray<TSharedPtr<FJsonValue>>* sceneNodes = nullptr;
+        if (scenes->IsValidIndex(sceneIndex) && (*scenes)[sceneIndex]->AsObject()->TryGetArrayField(TEXT("nodes"), sceneNodes))
+        {
+            for (const auto& node : *sceneNodes)
+            {
+                rootNodes.Add(static_cast<int32>(node->AsNumber()));
+            }
+        }
+    }
+    else
+    {
+        // Without scene, nodes which are not children
+        TBitArray<> bChildren(false, nodes->Num());
+        for (const auto& node : *nodes)
+        {
+            const TArray<TSharedPtr<FJsonValue>>* children = nullptr;
+            if (node->AsObject()->TryGetArrayField(TEXT("children"), children))
+            {
+                for (const auto& child : *children)
+                {
+                    const int32 childIndex = static_cast<int32>(child->AsNumber());
+                    if (bChildren.IsValidIndex(childIndex))
+                    {
+                        bChildren[childIndex] = true;
+                    }
+                }
+            }
+        }
+        for (int32 i = 0; i < nodes->Num(); ++i)
+        {
+            if (!bChildren[i])
+            {
+                rootNodes.Add(i);
+            }
+        }
+    }
+
+    // 1- Flatten the node hierarchy, as pre-transformed by Assimp's aiProcess_PreTransformVertices keeping the hierarchy
+    TArray<FRRGLTFPrimitiveJob> jobs;
+    int32 defaultMaterialUsersNum = 0;
+    int32 currentIndex = 0;
+    TBitArray<> bVisited(false, nodes->Num());
+    TFunction<void(int32, const FMatrix&, int32)> flattenNode =
+        [&](const int32 InNodeIndex, const FMatrix& InParentMatrix, const int32 InParentIndex)
+    {
+        // Guarding against cycles
+        if (!nodes->IsValidIndex(InNodeIndex) || bVisited[InNodeIndex])
+        {
+            return;
+        }
+        bVisited[InNodeIndex] = true;
+        const TSharedPtr<FJsonObject> node = (*nodes)[InNodeIndex]->AsObject();
+        const FMatrix worldMatrix = GetNodeLocalMatrix(*node) * InParentMatrix;
+        int32 meshIndex = INDEX_NONE;
+        const TArray<TSharedPtr<FJsonValue>>* primitives = nullptr;
+        if (node->TryGetNumberField(TEXT("mesh"), meshIndex) && meshes->IsValidIndex(meshIndex) &&
+            (*meshes)[meshIndex]->AsObject()->TryGetArrayField(TEXT("primitives"), primitives) && (primitives->Num() > 0))
+        {
+            const int32 nodeIndex = OutMeshData.Nodes.AddDefaulted();
+            FRRMeshNode& meshNode = OutMeshData.Nodes[nodeIndex];
+            meshNode.NodeParentIndex = InParentIndex;
+            meshNode.Meshes.SetNum(primitives->Num());
+            for (int32 i = 0; i < primitives->Num(); ++i)
+            {
+                FRRGLTFPrimitiveJob& job = jobs.AddDefaulted_GetRef();
+                job.NodeIndex = nodeIndex;
+                job.MeshIndex = i;
+                job.Primitive = (*primitives)[i]->AsObject();
+                job.WorldMatrix = worldMatrix;
+                defaultMaterialUsersNum += job.Primitive->HasField(TEXT("material")) ? 0 : 1;
+            }
+        }
+
+        const int32 currentParentIndex = currentIndex;
+        const TArray<TSharedPtr<FJsonValue>>* children = nullptr;
+        if (node->TryGetArrayField(TEXT("children"), children))
+        {
+            for (const auto& child : *children)
+            {
+                ++currentIndex;
+                flattenNode(static_cast<int32>(child->AsNumber()), worldMatrix, currentParentIndex);
+            }
+        }
+    };
+    for (const int32 rootNode : rootNodes)
+    {
+        flattenNode(rootNode, FMatrix::Identity, -1);
+    }
+
+    // 2- Convert the primitives in parallel, each into its own slot
+    ParallelFor(jobs.Num(),
+                [&file, &jobs, &OutMeshData, InMeshScale](int32 InJobIndex)
+                {
+                    const FRRGLTFPrimitiveJob& job = jobs[InJobIndex];
+                    FRRMeshNodeData& meshNodeData = OutMeshData.Nodes[job.NodeIndex].Meshes[job.MeshIndex];
+                    if (!ProcessPrimitive(file, *job.Primitive, job.WorldMatrix, InMeshScale, meshNodeData))
+                    {
+                        // eg points or lines, skipped as by Assimp's aiProcess_SortByPType
+                        meshNodeData = FRRMeshNodeData();
+                    }
+                });
+
+    // 3- Materials, as imported by Assimp: baseColorFactor as diffuse, the default material appended last if needed
+    const TArray<TSharedPtr<FJsonValue>>* materials = nullptr;
+    const int32 materialsNum = file.Root->TryGetArrayField(TEXT("materials"), materials) ? materials->Num() : 0;
+    for (int32 i = 0; i < materialsNum; ++i)
+    {
+        OutMeshData.Materials.Add(ProcessMaterial(*(*materials)[i]->AsObject()));
+    }
+    if (defaultMaterialUsersNum > 0)
+    {
+        FRRMeshMaterialData& defaultMaterial = OutMeshData.Materials.AddDefaulted_GetRef();
+        defaultMaterial.VectorParams.Add(TEXT("BaseColor"), FLinearColor::White);
+    }
+    for (int32 i = 0; i < jobs.Num(); ++i)
+    {
+        int32 materialIndex = materialsNum;
+        jobs[i].Primitive->TryGetNumberField(TEXT("material"), materialIndex);
+        OutMeshData.Nodes[jobs[i].NodeIndex].Meshes[jobs[i].MeshIndex].MaterialIndex =
+            FMath::Clamp(materialIndex, 0, OutMeshData.Materials.Num() - 1);
+    }
+
+    // Skipped primitives & nodes left empty
+    for (auto& meshNode : OutMeshData.Nodes)
+    {
+        meshNode.Meshes.RemoveAll([](const FRRMeshNodeData& InMesh) { return InMesh.TriangleIndices.Num() == 0; });
+    }
+    OutMeshData.Nodes.RemoveAll([](const FRRMeshNode& InNode) { return InNode.Meshes.Num() == 0; });
+    if (OutMeshData.Nodes.Num() == 0)
+    {
+        OutMeshData.Reset();
+        return file.Error(TEXT("has no triangle mesh"));
+    }
+    return true;
+}
@@ -14,6 +14,9 @@
 #include "Core/RRGameState.h"
 #include "Core/RRPlayerController.h"
 #include "Tools/RRROS2ClockPublisher.h"
+#include "Tools/RRStartupProfiler.h"
+
+const FName ARRGameMode::SIM_START_DEPENDENCY_PRIORITY_RESOURCES(TEXT("PriorityResources"));
 
 ARRGameMode::ARRGameMode()
 {
@@ -154,13 +157,23 @@ void ARRGameMode::StartSim()
     URRCoreUtils::LoadImageWrapperModule();
 
     // 2- LOAD SIM STATIC GLOBAL RESOURCES --
+    // The rest, not in the map's resource manifests, keep streaming in the background
+    SimStartBarrier.Reset();
+    SimStartBarrier.AddDependency(SIM_START_DEPENDENCY_PRIORITY_RESOURCES);
     auto* gameSingleton = URRGameSingleton::Get();
     if (gameSingleton)
     {
 #if RAPYUTA_SIM_VERBOSE
         gameSingleton->PrintSimConfig();
 #endif
-        gameSingleton->InitializeResources();
+        FRRStartupProfiler::Get().BeginPhase(ERRStartupPhase::RESOURCES_LOADING);
+        gameSingleton->OnPriorityResourcesLoaded.AddWeakLambda(
+            this, [this]() { SimStartBarrier.Signal(SIM_START_DEPENDENCY_PRIORITY_RESOURCES); });
+        gameSingleton->InitializeResources(UWorld::RemovePIEPrefix(GetWorld()->GetMapName()));
+    }
+    else
+    {
+        SimStartBarrier.Signal(SIM_START_DEPENDENCY_PRIORITY_RESOURCES);
     }
 
     // 3- START SIM ONCE RESOURCES ARE LOADED --
@@ -168,53 +181,56 @@ void ARRGameMode::StartSim()
     // The reason for this scheduled delegate is some essential operation, which facilitates sim startup activities like
     // asynchronous resource loading, could only run after this [ARRGameState::BeginPlay()] ends!
     URRCoreUtils::ScreenMsg(FColor::Yellow, TEXT("LOADING SIM RESOURCES.."), 10.f);
+    GetWorld()->GetTimerManager().SetTimerForNextTick(
+        [this]() { SimStartBarrier.Arm([this]() { TryStartingSim(); }); });
     GetWorld()->GetTimerManager().SetTimer(
-        OwnTimerHandle, [this]() { TryStartingSim(); }, 1.f, true);
+        OwnTimerHandle,
+        [this]()
+        {
+            if (false == SimStartBarrier.HasFired())
+            {
+                UE_LOG_WITH_INFO(LogRapyutaCore,
+                                 Error,
+                                 TEXT("SIM START TIMEOUT -> SHUTTING DOWN THE SIM... %s"),
+                                 *SimStartBarrier.ToString());
+                // Log the resources yet to be loaded
+                if (auto* singleton = URRGameSingleton::Get())
+                {
+                    singleton->HavePriorityResourcesBeenLoaded(true);
+                }
+            }
+        },
+        ARRGameMode::SIM_START_TIMEOUT_SECS,
+        false);
 }
 
 bool ARRGameMode::TryStartingSim()
 {
-    static FDateTime sBeginTime(FDateTime::UtcNow());
-
-    // !NOTE: This method was scheduled to be run by BeginPlay()
-    // 1 - WAIT FOR RESOURCE LOADING, in prep for Sim initialization
+    // !NOTE: This method is run by [SimStartBarrier], once resources are loaded in prep for Sim initialization
+    // 1 - STOP THE SIM START TIMEOUT
     UWorld* world = GetWorld();
-
-    auto* gameSingleton = URRGameSingleton::Get();
-    if (gameSingleton)
+    URRCoreUtils::StopRegisteredTimer(world, OwnTimerHandle);
+    if (auto* gameSingleton = URRGameSingleton::Get())
     {
-        bool bResult = URRCoreUtils::CheckWithTimeOut(
-            [gameSingleton]() { return gameSingleton->HaveAllResourcesBeenLoaded(); },
-            [this, world]()
-            {
-                // Clear the timer to avoid repeated call to the method
-                URRCoreUtils::StopRegisteredTimer(world, OwnTimerHandle);
-                UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("DYNAMIC RESOURCES LOADING TIMEOUT -> SHUTTING DOWN THE SIM..."))
-            },
-            sBeginTime,
-            ARRGameMode::SIM_START_TIMEOUT_SECS);
-
-        // Either resources have yet to be fully loaded or time out!
-        if (!bResult)
-        {
-            return false;
-        }
+        gameSingleton->OnPriorityResourcesLoaded.RemoveAll(this);
     }
+    FRRStartupProfiler::Get().EndPhase(ERRStartupPhase::RESOURCES_LOADING);
 
-    // Clear the timer to avoid repeated call to the method
-    URRCoreUtils::StopRegisteredTimer(world, OwnTimerHandle);
-
-    URRCoreUtils::ScreenMsg(FColor::Yellow, TEXT("ALL DYNAMIC RESOURCES LOADED!"), 10.f);
+    URRCoreUtils::ScreenMsg(FColor::Yellow, TEXT("PRIORITY DYNAMIC RESOURCES LOADED!"), 10.f);
 #if RAPYUTA_SIM_VERBOSE
-    UE_LOG(LogRapyutaCore, Warning, TEXT("ALL DYNAMIC RESOURCES LOADED! -> BRING UP THE SIM NOW... ========================"));
+    UE_LOG(LogRapyutaCore, Warning, TEXT("PRIORITY DYNAMIC RESOURCES LOADED! -> BRING UP THE SIM NOW... ===================="));
 #endif
 
     // 1 - [GameState]::StartSim()
+    double phaseStartTime = FPlatformTime::Seconds();
     auto gameState = GetGameState<ARRGameState>();
     if (gameState)
     {
         gameState->StartSim();
-        UE_LOG(LogRapyutaCore, Log, TEXT("SIM STARTED, GLOBAL ACTORS ARE ACCESSIBLE NOW! ========================"));
+        UE_LOG(LogRapyutaCore,
+               Log,
+               TEXT("SIM STARTED, GLOBAL ACTORS ARE ACCESSIBLE NOW! (scene instances: %.1fms) ========================"),
+               (FPlatformTime::Seconds() - phaseStartTime) * 1000.);
     }
     else
     {
@@ -223,7 +239,13 @@ bool ARRGameMode::TryStartingSim()
     }
 
     // 2- START PARENT'S PLAY, WHICH TRIGGER OTHERS PLAY FROM GAME STATE, PLAYER CONTROLLER, ETC.
+    phaseStartTime = FPlatformTime::Seconds();
     ARRROS2GameMode::StartPlay();
+    UE_LOG_WITH_INFO(LogRapyutaCore,
+                     Display,
+                     TEXT("SIM READY %.1fms after StartSim (ROS 2 & play start: %.1fms)"),
+                     SimStartBarrier.GetElapsedSeconds() * 1000.,
+                     (FPlatformTime::Seconds() - phaseStartTime) * 1000.);
     return true;
 }
 
@@ -3,7 +3,11 @@
 #include "Core/RRGameSingleton.h"
 
 // RapyutaSim
+#include "Core/RRMeshCache.h"
+#include "Core/RRTrace.h"
 #include "Core/RRTypeUtils.h"
+#include "Core/RRUObjectUtils.h"
+#include "Tools/RRMemoryStats.h"
 
 TMap<ERRResourceDataType, TArray<const TCHAR*>> URRGameSingleton::SASSET_OWNING_MODULE_NAMES = {
     // Only required for statically loaded UASSET
@@ -62,8 +66,45 @@ URRGameSingleton* URRGameSingleton::Get()
     return singleton;
 }
 
-bool URRGameSingleton::InitializeResources()
+FString URRGameSingleton::GetMeshUniqueName(const TCHAR* InPrefix, const FString& InMeshFilePath)
 {
+    const FString contentHash = FRRMeshCache::GetContentHash(InMeshFilePath);
+    return URRUObjectUtils::ComposeDynamicResourceName(
+        InPrefix, contentHash.IsEmpty() ? FPaths::GetBaseFilename(InMeshFilePath) : contentHash);
+}
+
+int64 URRGameSingleton::GetResourceStoreSize(int32& OutObjectsNum) const
+{
+    OutObjectsNum = 0;
+    int64 bytes = ResourceStore.GetAllocatedSize();
+    for (const UObject* resource : ResourceStore)
+    {
+        if (IsValid(resource))
+        {
+            ++OutObjectsNum;
+            bytes += resource->GetResourceSizeBytes(EResourceSizeMode::EstimatedTotal);
+        }
+    }
+    return bytes;
+}
+
+bool URRGameSingleton::InitializeResources(const FString& InMapName)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRInitializeResources", RRAssetChannel);
+    LLM_SCOPE_BYTAG(RRResources);
+    // Collect the map's manifest resources, to be loaded first
+    PriorityResourceNames.Reset();
+    // Not notified while requesting, since the types yet to be requested would count as loaded
+    bPriorityResourcesLoadedNotified = true;
+    for (const auto& manifest : RESOURCE_MANIFESTS)
+    {
+        if (manifest.MapName.IsEmpty() || manifest.MapName.Equals(InMapName))
+        {
+            PriorityResourceNames.Append(manifest.ResourceNames);
+        }
+    }
+    UE_LOG_WITH_INFO(LogRapyutaCore, Display, TEXT("[%s] PRIORITY RESOURCES NUM: %d"), *InMapName, PriorityResourceNames.Num());
+
     // Prepare an empty [ResourceMap]
     for (uint8 i = (static_cast<uint8>(ERRResourceDataType::NONE) + 1); i < static_cast<uint8>(ERRResourceDataType::TOTAL); ++i)
     {
@@ -101,6 +142,9 @@ bool URRGameSingleton::InitializeResources()
 #if RAPYUTA_SIM_VERBOSE
     UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("RESOURCES REGISTERED TO BE LOADED!"));
 #endif
+    // Eg nothing to load or all loaded synchronously
+    bPriorityResourcesLoadedNotified = false;
+    NotifyIfPriorityResourcesLoaded();
     return true;
 }
 
@@ -111,7 +155,32 @@ void URRGameSingleton::FinalizeResources()
         ResourceMap[static_cast<ERRResourceDataType>(i)].Finalize();
     }
 
+    {
+        FWriteScopeLock lock(ResourceSnapshotsLock);
+        for (auto& snapshot : ResourceSnapshots)
+        {
+            snapshot.Reset();
+        }
+    }
     ResourceStore.Empty();
+    PriorityResourceNames.Empty();
+    DynamicResourceWaiters.Empty();
+    OnPriorityResourcesLoaded.Clear();
+}
+
+void URRGameSingleton::PublishResourceSnapshot(const ERRResourceDataType InDataType,
+                                               const FString& InResourceUniqueName,
+                                               UObject* InResourceObject)
+{
+    check(IsInGameThread());
+    const FRRResourceSnapshotPtr currentSnapshot = GetResourceSnapshot(InDataType);
+    TSharedRef<FRRResourceSnapshot, ESPMode::ThreadSafe> newSnapshot =
+        currentSnapshot.IsValid() ? MakeShared<FRRResourceSnapshot, ESPMode::ThreadSafe>(*currentSnapshot)
+                                  : MakeShared<FRRResourceSnapshot, ESPMode::ThreadSafe>();
+    newSnapshot->Add(FName(*InResourceUniqueName), InResourceObject);
+
+    FWriteScopeLock lock(ResourceSnapshotsLock);
+    ResourceSnapshots[static_cast<uint8>(InDataType)] = newSnapshot;
 }
 
 bool URRGameSingleton::HaveAllResourcesBeenLoaded(bool bIsLogged) const
@@ -131,3 +200,83 @@ bool URRGameSingleton::HaveAllResourcesBeenLoaded(bool bIsLogged) const
 
     return bResult;
 }
+
+void URRGameSingleton::NotifyIfPriorityResourcesLoaded()
+{
+    check(IsInGameThread());
+    if (!bPriorityResourcesLoadedNotified && (ResourceMap.Num() > 0) && HavePriorityResourcesBeenLoaded())
+    {
+        bPriorityResourcesLoadedNotified = true;
+        OnPriorityResourcesLoaded.Broadcast();
+    }
+}
+
+bool URRGameSingleton::HavePriorityResourcesBeenLoaded(bool bIsLogged) const
+{
+    bool bResult = true;
+    for (const auto& resourceInfo : ResourceMap)
+    {
+        const bool bLoaded = resourceInfo.Value.bHasBeenAllLoaded || (resourceInfo.Value.ToBeAsyncLoadedPriorityResourceNum <= 0);
+        bResult &= bLoaded;
+        if (!bLoaded && bIsLogged)
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore,
+                             Warning,
+                             TEXT("[%s] Priority resources have not yet been fully loaded: %d left!"),
+                             *URRTypeUtils::GetERRResourceDataTypeAsString(resourceInfo.Key),
+                             resourceInfo.Value.ToBeAsyncLoadedPriorityResourceNum);
+        }
+    }
+
+    return bResult;
+}
+
+void URRGameSingleton::WaitForSimResource(const ERRResourceDataType InDataType,
+                                          const FString& InResourceUniqueName,
+                                          FRRResourceReadyCallback&& InCallback)
+{
+    check(IsInGameThread());
+    const FRRResource* resource = GetSimResourceInfo(InDataType).Data.Find(InResourceUniqueName);
+    if (resource && (false == IsValid(resource->AssetData)) && resource->AssetPath.IsValid())
+    {
+        // Bump its loading, still processed by the delegate of its first request
+        UAssetManager* assetManager = UAssetManager::GetIfValid();
+        if (assetManager)
+        {
+            assetManager->GetStreamableManager().RequestAsyncLoad(
+                resource->AssetPath, FStreamableDelegate(), FStreamableManager::AsyncLoadHighPriority);
+        }
+    }
+    WaitForDynamicResource(InDataType, InResourceUniqueName, MoveTemp(InCallback));
+}
+
+void URRGameSingleton::WaitForDynamicResource(const ERRResourceDataType InDataType,
+                                              const FString& InResourceUniqueName,
+                                              FRRResourceReadyCallback&& InCallback)
+{
+    check(IsInGameThread());
+    UObject* resourceObject = GetSimResourceInfo(InDataType).Data.FindRef(InResourceUniqueName).AssetData;
+    if (IsValid(resourceObject))
+    {
+        InCallback(resourceObject);
+    }
+    else
+    {
+        DynamicResourceWaiters.FindOrAdd(MakeTuple(InDataType, InResourceUniqueName)).Add(MoveTemp(InCallback));
+    }
+}
+
+void URRGameSingleton::SignalDynamicResourceWaiters(const ERRResourceDataType InDataType,
+                                                    const FString& InResourceUniqueName,
+                                                    UObject* InResourceObject)
+{
+    check(IsInGameThread());
+    TArray<FRRResourceReadyCallback> waiters;
+    if (DynamicResourceWaiters.RemoveAndCopyValue(MakeTuple(InDataType, InResourceUniqueName), waiters))
+    {
+        for (auto& waiter : waiters)
+        {
+            waiter(InResourceObject);
+        }
+    }
+}
@@ -3,6 +3,7 @@
 
 // UE
 #include "Camera/CameraActor.h"
+#include "Engine/LevelStreamingDynamic.h"
 #include "Engine/World.h"
 #include "GenericPlatform/GenericPlatformMath.h"
 #include "Kismet/GameplayStatics.h"
@@ -11,6 +12,7 @@
 
 // RapyutaSimulationPlugins
 #include "Core/RRActorCommon.h"
+#include "Core/RRBaseActor.h"
 #include "Core/RRCoreUtils.h"
 #include "Core/RRMathUtils.h"
 #include "Core/RRMeshActor.h"
@@ -30,6 +32,7 @@ void ARRGameState::PrintSimConfig() const
     UE_LOG_WITH_INFO(LogRapyutaCore, Log, TEXT("GAME STATE CONFIG -----------------------------"));
     UE_LOG_WITH_INFO(LogRapyutaCore, Display, TEXT("SCENE_INSTANCES_NUM: %d"), SCENE_INSTANCES_NUM);
     UE_LOG_WITH_INFO(LogRapyutaCore, Display, TEXT("SCENE_INSTANCES_DISTANCE_INTERVAL: %f(cm)"), SCENE_INSTANCES_DISTANCE_INTERVAL);
+    UE_LOG_WITH_INFO(LogRapyutaCore, Display, TEXT("SCENE_INSTANCE_ENVIRONMENT_LEVEL: %s"), *SCENE_INSTANCE_ENVIRONMENT_LEVEL);
     UE_LOG_WITH_INFO(LogRapyutaCore,
                      Display,
                      TEXT("SIM_OUTPUTS_BASE_FOLDER_NAME: %s -> %s"),
@@ -80,9 +83,18 @@ void ARRGameState::StartSim()
         // 2 - Create <SceneType>Common & <Plugin>Common objects
         CreateServiceObjects(i);
 
+        // 2.1 - Stream the scene instance's own environment, if configured
+        if (HasOwnSceneInstanceEnvironments())
+        {
+            CreateSceneInstanceEnvironment(i);
+        }
+
         // 3 - Trigger OnStartSim() for creating plugins' own common artifacts
         StartSubSim(i);
 
+        // 3.1 - Prewarm actor pools, so the scene director could acquire pooled actors from its start
+        PrewarmActorPools(i);
+
         // 4 - Do preliminary configuration/spawning for the Sim operation
         InitializeSim(i);
 
@@ -90,6 +102,71 @@ void ARRGameState::StartSim()
     }
 }
 
+TArray<int8> ARRGameState::ForkSceneInstances(int8 InSourceSceneInstanceId, const TArray<int32>& InRandomSeeds)
+{
+    TArray<int8> forkIds;
+#if RAPYUTA_USE_SCENE_DIRECTOR
+    const ARRSceneDirector* sourceDirector =
+        HasSceneInstance(InSourceSceneInstanceId) ? SceneInstanceList[InSourceSceneInstanceId]->SceneDirector : nullptr;
+    if (!(sourceDirector && sourceDirector->HasSceneInitialized()))
+    {
+        UE_LOG_WITH_INFO(
+            LogRapyutaCore, Error, TEXT("SceneInstance[%d] is not initialized to be forked"), InSourceSceneInstanceId);
+        return forkIds;
+    }
+
+    // Each scene instance has a player controller of its own in standalone, their max num being the split screen players'
+    int32 maxSceneInstancesNum = MAX_int8;
+    if (IsNetMode(NM_Standalone))
+    {
+        maxSceneInstancesNum = FMath::Min(maxSceneInstancesNum, URRCoreUtils::GetMaxSplitscreenPlayers(this));
+    }
+    for (const int32 randomSeed : InRandomSeeds)
+    {
+        if (SceneInstanceList.Num() >= maxSceneInstancesNum)
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore,
+                             Warning,
+                             TEXT("Max num of scene instances %d reached, %d/%d forks created"),
+                             maxSceneInstancesNum,
+                             forkIds.Num(),
+                             InRandomSeeds.Num());
+            break;
+        }
+
+        // Same sequence as [StartSim()]'s, seeded & namespaced before anything of the fork is spawned
+        const int8 forkId = static_cast<int8>(SceneInstanceList.Num());
+        URRMathUtils::SetSceneRandomSeed(forkId, randomSeed);
+        CreateSceneInstance(forkId);
+        CreateServiceObjects(forkId);
+        SceneInstanceList[forkId]->ActorCommon->SceneROSNamespace =
+            FString::Printf(TEXT("%s%d"), *SCENE_INSTANCE_FORK_ROS_NAMESPACE_PREFIX, forkId);
+        if (HasOwnSceneInstanceEnvironments())
+        {
+            CreateSceneInstanceEnvironment(forkId);
+        }
+        StartSubSim(forkId);
+        PrewarmActorPools(forkId);
+        InitializeSim(forkId);
+
+        // Set up before its [TryInitializeOperation()], run from the next timer tick
+        SceneInstanceList[forkId]->SceneDirector->ForkFrom(sourceDirector);
+        forkIds.Add(forkId);
+
+        UE_LOG_WITH_INFO(LogRapyutaCore,
+                         Display,
+                         TEXT("SIM SCENE INSTANCE [%d] FORKED FROM [%d] - Random seed: %d, ROS namespace: %s"),
+                         forkId,
+                         InSourceSceneInstanceId,
+                         URRMathUtils::GetSceneRandomSeed(forkId),
+                         *SceneInstanceList[forkId]->ActorCommon->SceneROSNamespace);
+    }
+#else
+    UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Scene instances are forked by their scene directors, not in use"));
+#endif
+    return forkIds;
+}
+
 void ARRGameState::SetupEnvironment()
 {
     FetchEnvStaticActors();
@@ -163,6 +240,28 @@ void ARRGameState::CreateServiceObjects(int8 InSceneInstanceId)
     sceneInstance->ActorCommon->SceneInstanceLocation.Z = 0.f;
 }
 
+void ARRGameState::CreateSceneInstanceEnvironment(int8 InSceneInstanceId)
+{
+    FRRStreamingLevelInfo levelInfo;
+    levelInfo.AssetPath = SCENE_INSTANCE_ENVIRONMENT_LEVEL;
+    levelInfo.TargetTransform.SetTranslation(URRCoreUtils::GetSceneInstanceLocation(InSceneInstanceId));
+
+    ULevelStreamingDynamic* environment = URRCoreUtils::CreateStreamingLevel(this, levelInfo);
+    if (nullptr == environment)
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore,
+                         Error,
+                         TEXT("[SceneInstance %d] Failed streaming environment level [%s]"),
+                         InSceneInstanceId,
+                         *SCENE_INSTANCE_ENVIRONMENT_LEVEL);
+    }
+    if (SceneInstanceEnvironments.Num() <= InSceneInstanceId)
+    {
+        SceneInstanceEnvironments.SetNumZeroed(InSceneInstanceId + 1);
+    }
+    SceneInstanceEnvironments[InSceneInstanceId] = environment;
+}
+
 bool ARRGameState::HasSceneInstanceListBeenCreated(bool bIsLogged) const
 {
     if (!SceneInstanceList.Num())
@@ -246,6 +345,12 @@ bool ARRGameState::HaveAllSceneInstancesCompleted() const
 
 void ARRGameState::MoveEnvironmentToSceneInstance(int8 InSceneInstanceId)
 {
+    // Scene instances with their own environments never need to wait for the shared one
+    if (HasOwnSceneInstanceEnvironments())
+    {
+        return;
+    }
+
     if (InSceneInstanceId != LastSceneInstanceId)
     {
         if (IsValid(MainEnvironment))
@@ -342,3 +447,115 @@ void ARRGameState::AddEntity(ARRMeshActor* InEntity)
 {
     AllDynamicMeshEntities.AddUnique(InEntity);
 }
+
+ARRBaseActor* ARRGameState::AcquirePooledActor(int8 InSceneInstanceId,
+                                               UClass* InActorClass,
+                                               const FString& InEntityModelName,
+                                               const FTransform& InActorTransform,
+                                               const FString& InActorName)
+{
+    ARRBaseActor* actor = nullptr;
+    if (FRRActorPool* pool = ActorPools.Find(GetActorPoolKey(InActorClass, InEntityModelName)))
+    {
+        const int32 actorIdx = pool->Actors.IndexOfByPredicate(
+            [InSceneInstanceId](const ARRBaseActor* InActor)
+            { return IsValid(InActor) && (InSceneInstanceId == InActor->SceneInstanceId); });
+        if (INDEX_NONE != actorIdx)
+        {
+            actor = pool->Actors[actorIdx];
+            pool->Actors.RemoveAtSwap(actorIdx);
+        }
+        // Drop ones having been destroyed elsewhere meanwhile
+        pool->Actors.RemoveAllSwap([](const ARRBaseActor* InActor) { return !IsValid(InActor); });
+    }
+
+    if (nullptr == actor)
+    {
+        return URRUObjectUtils::SpawnSimActor(
+            GetWorld(), InSceneInstanceId, InActorClass, InEntityModelName, InActorName, InActorTransform);
+    }
+
+    actor->SetActorTransform(InActorTransform, false, nullptr, ETeleportType::ResetPhysics);
+    actor->SetActorHiddenInGame(false);
+    actor->SetActorEnableCollision(true);
+    actor->SetActorTickEnabled(actor->PrimaryActorTick.bStartWithTickEnabled);
+    if (auto* meshActor = Cast<ARRMeshActor>(actor))
+    {
+        meshActor->SetActivated(true);
+    }
+    return actor;
+}
+
+void ARRGameState::ReleasePooledActor(ARRBaseActor* InActor)
+{
+    if (false == IsValid(InActor))
+    {
+        return;
+    }
+
+    // Deactivating a mesh actor also teleports it out of sight & disables its custom depth rendering
+    if (auto* meshActor = Cast<ARRMeshActor>(InActor))
+    {
+        meshActor->SetActivated(false);
+    }
+    else
+    {
+        InActor->SetActorLocation(FVector(0.f, 0.f, -5000.f), false, nullptr, ETeleportType::ResetPhysics);
+    }
+
+    TInlineComponentArray<UPrimitiveComponent*> primComponents(InActor);
+    for (auto& primComp : primComponents)
+    {
+        if (primComp->IsSimulatingPhysics())
+        {
+            primComp->SetPhysicsLinearVelocity(FVector::ZeroVector);
+            primComp->SetPhysicsAngularVelocityInDegrees(FVector::ZeroVector);
+        }
+    }
+    InActor->SetActorHiddenInGame(true);
+    InActor->SetActorEnableCollision(false);
+    InActor->SetActorTickEnabled(false);
+
+    ActorPools.FindOrAdd(GetActorPoolKey(InActor->GetClass(), InActor->EntityModelName)).Actors.AddUnique(InActor);
+}
+
+void ARRGameState::PrewarmActorPool(int8 InSceneInstanceId, UClass* InActorClass, const FString& InEntityModelName, int32 InNum)
+{
+    if ((nullptr == InActorClass) || (false == InActorClass->IsChildOf(ARRBaseActor::StaticClass())))
+    {
+        UE_LOG_WITH_INFO(
+            LogRapyutaCore, Error, TEXT("[%s] is not an ARRBaseActor class, thus not poolable"), *GetNameSafe(InActorClass));
+        return;
+    }
+
+    const FRRActorPool& pool = ActorPools.FindOrAdd(GetActorPoolKey(InActorClass, InEntityModelName));
+    int32 pooledNum = 0;
+    for (const auto& actor : pool.Actors)
+    {
+        pooledNum += (IsValid(actor) && (InSceneInstanceId == actor->SceneInstanceId)) ? 1 : 0;
+    }
+
+    for (int32 i = pooledNum; i < InNum; ++i)
+    {
+        ARRBaseActor* newActor = URRUObjectUtils::SpawnSimActor(
+            GetWorld(),
+            InSceneInstanceId,
+            InActorClass,
+            InEntityModelName,
+            FString::Printf(TEXT("%d_%s_Pooled_%d"), InSceneInstanceId, *InEntityModelName, i));
+        if (nullptr == newActor)
+        {
+            break;
+        }
+        ReleasePooledActor(newActor);
+    }
+}
+
+void ARRGameState::PrewarmActorPools(int8 InSceneInstanceId)
+{
+    for (const auto& prewarmInfo : ACTOR_POOL_PREWARM_LIST)
+    {
+        PrewarmActorPool(
+            InSceneInstanceId, prewarmInfo.ActorClass.LoadSynchronous(), prewarmInfo.EntityModelName, prewarmInfo.Num);
+    }
+}
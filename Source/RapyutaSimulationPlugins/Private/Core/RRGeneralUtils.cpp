@@ -1 +1,218 @@
 // Copyright 2020-2021 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRGeneralUtils.h"
+
+// UE
+#include "HAL/FileManager.h"
+#include "JsonObjectConverter.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+#include "UObject/StructOnScope.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRCoreUtils.h"
+
+static TAutoConsoleVariable<bool> CVarJsonCacheEnabled(TEXT("rr.JsonCache.Enabled"),
+                                                       true,
+                                                       TEXT("Parse JSON documents, eg robots' JSON configs, once per process"),
+                                                       ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarJsonCacheMaxEntries(TEXT("rr.JsonCache.MaxEntries"),
+                                                           256,
+                                                           TEXT("Cached JSON documents beyond which the cache is cleared"),
+                                                           ECVF_Default);
+
+namespace
+{
+struct FRRCachedJson
+{
+    //! File timestamp, FDateTime::MinValue() for JSON text
+    FDateTime TimeStamp = FDateTime::MinValue();
+    TSharedPtr<FJsonObject> JsonObject;
+    //! Per struct type, converted upon first request
+    TMap<const UScriptStruct*, TSharedPtr<FStructOnScope>> Structs;
+};
+
+//! Keyed by JSON text or file path
+TMap<FString, FRRCachedJson> GJsonCache;
+FCriticalSection GJsonCacheMutex;
+
+bool IsJsonFilePath(const FString& InJson)
+{
+    return InJson.EndsWith(TEXT(".json"), ESearchCase::IgnoreCase) && !InJson.TrimStart().StartsWith(TEXT("{"));
+}
+
+TSharedPtr<FJsonObject> ParseJson(const FString& InJson, FDateTime& OutTimeStamp)
+{
+    FString content;
+    if (IsJsonFilePath(InJson))
+    {
+        OutTimeStamp = IFileManager::Get().GetTimeStamp(*InJson);
+        if (!FFileHelper::LoadFileToString(content, *InJson))
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Failed to read JSON file %s"), *InJson);
+            return nullptr;
+        }
+    }
+    else
+    {
+        OutTimeStamp = FDateTime::MinValue();
+        content = InJson;
+    }
+
+    TSharedPtr<FJsonObject> jsonObj;
+    if (!FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(content), jsonObj) || !jsonObj.IsValid())
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Failed to deserialize JSON: %s"), *InJson.Left(256));
+        return nullptr;
+    }
+    return jsonObj;
+}
+
+// With GJsonCacheMutex held
+FRRCachedJson* FindOrAddCachedJson(const FString& InJson)
+{
+    FRRCachedJson* cached = GJsonCache.Find(InJson);
+    if (cached && IsJsonFilePath(InJson) && (IFileManager::Get().GetTimeStamp(*InJson) != cached->TimeStamp))
+    {
+        GJsonCache.Remove(InJson);
+        cached = nullptr;
+    }
+    if (nullptr == cached)
+    {
+        FDateTime timeStamp;
+        TSharedPtr<FJsonObject> jsonObj = ParseJson(InJson, timeStamp);
+        if (!jsonObj.IsValid())
+        {
+            return nullptr;
+        }
+        if (GJsonCache.Num() >= FMath::Max(CVarJsonCacheMaxEntries.GetValueOnAnyThread(), 1))
+        {
+            GJsonCache.Reset();
+        }
+        cached = &GJsonCache.Add(InJson);
+        cached->TimeStamp = timeStamp;
+        cached->JsonObject = MoveTemp(jsonObj);
+    }
+    return cached;
+}
+struct FRRCachedRefFrame
+{
+    //! Actor transform the frame was computed from, to detect moves within the frame
+    FTransform ActorTransform;
+    FRRRefFrame Frame;
+};
+
+//! Cleared upon each new frame, thus never holding destroyed actors for longer
+TMap<const AActor*, FRRCachedRefFrame> GRefFramesCache;
+uint64 GRefFramesCacheFrame = 0;
+}    // namespace
+
+FRRRefFrame::FRRRefFrame(const FTransform& InRefTransf) : Transform(InRefTransf)
+{
+    Transform.NormalizeRotation();
+    InvRotation = Transform.GetRotation().Inverse();
+    InvScale = FTransform::GetSafeScaleReciprocal(Transform.GetScale3D());
+    bNegativeScale = (Transform.GetScale3D().GetMin() < 0.);
+}
+
+FTransform FRRRefFrame::GetRelativeTransform(const FTransform& InWorldTransf) const
+{
+    // Negative scales go through the matrix path of FTransform::GetRelativeTransform()
+    if (bNegativeScale)
+    {
+        FTransform relativeTransf = InWorldTransf.GetRelativeTransform(Transform);
+        relativeTransf.NormalizeRotation();
+        return relativeTransf;
+    }
+
+    // Same as FTransform::GetRelativeTransform(), with the per-reference terms precomputed
+    FQuat rotation = InvRotation * InWorldTransf.GetRotation();
+    rotation.Normalize();
+    return FTransform(rotation,
+                      InvRotation.RotateVector(InWorldTransf.GetTranslation() - Transform.GetTranslation()) * InvScale,
+                      InWorldTransf.GetScale3D() * InvScale);
+}
+
+FRRRefFrame URRGeneralUtils::GetCachedRefFrame(const AActor* RefActor)
+{
+    check(RefActor);
+    const FTransform& actorTransf = RefActor->GetTransform();
+    if (!IsInGameThread())
+    {
+        return FRRRefFrame(actorTransf);
+    }
+
+    if (GRefFramesCacheFrame != GFrameCounter)
+    {
+        GRefFramesCache.Reset();
+        GRefFramesCacheFrame = GFrameCounter;
+    }
+
+    FRRCachedRefFrame* cached = GRefFramesCache.Find(RefActor);
+    if (nullptr == cached)
+    {
+        cached = &GRefFramesCache.Add(RefActor, {actorTransf, FRRRefFrame(actorTransf)});
+    }
+    else if (!cached->ActorTransform.Equals(actorTransf, 0.))
+    {
+        cached->ActorTransform = actorTransf;
+        cached->Frame = FRRRefFrame(actorTransf);
+    }
+    return cached->Frame;
+}
+
+TSharedPtr<FJsonObject> URRGeneralUtils::GetCachedJsonObject(const FString& InJson)
+{
+    if (InJson.IsEmpty())
+    {
+        return nullptr;
+    }
+    if (!CVarJsonCacheEnabled.GetValueOnAnyThread())
+    {
+        FDateTime timeStamp;
+        return ParseJson(InJson, timeStamp);
+    }
+
+    FScopeLock lock(&GJsonCacheMutex);
+    FRRCachedJson* cached = FindOrAddCachedJson(InJson);
+    return cached ? cached->JsonObject : nullptr;
+}
+
+bool URRGeneralUtils::GetCachedJsonStruct(const FString& InJson, const UScriptStruct* InStruct, void* OutStructData)
+{
+    check(InStruct && OutStructData);
+    if (InJson.IsEmpty())
+    {
+        return false;
+    }
+    if (!CVarJsonCacheEnabled.GetValueOnAnyThread())
+    {
+        FDateTime timeStamp;
+        TSharedPtr<FJsonObject> jsonObj = ParseJson(InJson, timeStamp);
+        return jsonObj.IsValid() && FJsonObjectConverter::JsonObjectToUStruct(jsonObj.ToSharedRef(), InStruct, OutStructData);
+    }
+
+    FScopeLock lock(&GJsonCacheMutex);
+    FRRCachedJson* cached = FindOrAddCachedJson(InJson);
+    if (nullptr == cached)
+    {
+        return false;
+    }
+
+    TSharedPtr<FStructOnScope>& structData = cached->Structs.FindOrAdd(InStruct);
+    if (!structData.IsValid())
+    {
+        TSharedPtr<FStructOnScope> converted = MakeShared<FStructOnScope>(InStruct);
+        if (!FJsonObjectConverter::JsonObjectToUStruct(
+                cached->JsonObject.ToSharedRef(), InStruct, converted->GetStructMemory()))
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Failed to convert JSON to %s"), *InStruct->GetName());
+            cached->Structs.Remove(InStruct);
+            return false;
+        }
+        structData = MoveTemp(converted);
+    }
+    InStruct->CopyScriptStruct(OutStructData, structData->GetStructMemory());
+    return true;
+}
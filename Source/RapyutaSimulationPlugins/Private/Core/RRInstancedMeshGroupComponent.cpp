@@ -0,0 +1,166 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRInstancedMeshGroupComponent.h"
+
+// UE
+#include "Materials/MaterialInstanceDynamic.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRMeshActor.h"
+#include "Core/RRObjectCommon.h"
+#include "Core/RRUObjectUtils.h"
+
+URRInstancedMeshGroupComponent::URRInstancedMeshGroupComponent()
+{
+    PrimaryComponentTick.bCanEverTick = false;
+    NumCustomDataFloats = CUSTOM_DATA_NUM;
+}
+
+UStaticMeshComponent* URRInstancedMeshGroupComponent::GetEntityMeshComponent(const ARRMeshActor* InEntity)
+{
+    return IsValid(InEntity) ? Cast<UStaticMeshComponent>(InEntity->BaseMeshComp) : nullptr;
+}
+
+bool URRInstancedMeshGroupComponent::SetGroup(const FRRHomoMeshEntityGroup& InGroup)
+{
+    ResetGroup();
+    UStaticMeshComponent* firstMeshComp = (InGroup.Num() > 0) ? GetEntityMeshComponent(InGroup[0]) : nullptr;
+    UStaticMesh* staticMesh = firstMeshComp ? firstMeshComp->GetStaticMesh() : nullptr;
+    if (nullptr == staticMesh)
+    {
+        UE_LOG_WITH_INFO_NAMED(LogRapyutaCore, Error, TEXT("Group [%s] has no static mesh entity"), *InGroup.GetGroupName());
+        return false;
+    }
+
+    // Materials are shared by all instances, their MIDs' vector params being replaced by per-instance custom data
+    SetStaticMesh(staticMesh);
+    for (auto i = 0; i < firstMeshComp->GetNumMaterials(); ++i)
+    {
+        UMaterialInterface* material = firstMeshComp->GetMaterial(i);
+        if (auto* mid = Cast<UMaterialInstanceDynamic>(material))
+        {
+            material = mid->Parent;
+        }
+        SetMaterial(i, material);
+    }
+    SetNumCustomDataFloats(CUSTOM_DATA_NUM);
+
+    TArray<FTransform> transforms;
+    for (ARRMeshActor* entity : InGroup.Entities)
+    {
+        UStaticMeshComponent* meshComp = GetEntityMeshComponent(entity);
+        if ((nullptr == meshComp) || (meshComp->GetStaticMesh() != staticMesh) || (entity->MeshCompList.Num() != 1))
+        {
+            UE_LOG_WITH_INFO_NAMED(LogRapyutaCore,
+                                   Warning,
+                                   TEXT("[%s] is not of the group's mesh [%s], thus not instanced"),
+                                   *GetNameSafe(entity),
+                                   *staticMesh->GetName());
+            continue;
+        }
+        transforms.Add(meshComp->GetComponentTransform());
+        Entities.Add(entity);
+    }
+    AddInstances(transforms, false, true);
+
+    TArray<float> customData;
+    customData.SetNumZeroed(CUSTOM_DATA_NUM);
+    for (auto i = 0; i < Entities.Num(); ++i)
+    {
+        ARRMeshActor* entity = Entities[i];
+        UStaticMeshComponent* meshComp = GetEntityMeshComponent(entity);
+        FLinearColor colorAlbedo = FLinearColor::White;
+        if (auto* mid = Cast<UMaterialInstanceDynamic>(meshComp->GetMaterial(0)))
+        {
+            mid->GetVectorParameterValue(FRRMaterialProperty::PROP_NAME_COLOR_ALBEDO, colorAlbedo);
+        }
+        customData[CUSTOM_DATA_INDEX_SEGMASK_ID] = URRUObjectUtils::GetSegMaskId(meshComp);
+        customData[CUSTOM_DATA_INDEX_COLOR_ALBEDO] = colorAlbedo.R;
+        customData[CUSTOM_DATA_INDEX_COLOR_ALBEDO + 1] = colorAlbedo.G;
+        customData[CUSTOM_DATA_INDEX_COLOR_ALBEDO + 2] = colorAlbedo.B;
+        SetCustomData(i, customData);
+
+        meshComp->SetVisibility(false);
+        entity->InstancedGroupComp = this;
+        entity->InstanceIndex = i;
+    }
+    UpdateGroupCustomDepthStencil();
+    MarkRenderStateDirty();
+    return Entities.Num() > 0;
+}
+
+void URRInstancedMeshGroupComponent::ResetGroup()
+{
+    for (ARRMeshActor* entity : Entities)
+    {
+        if (UStaticMeshComponent* meshComp = GetEntityMeshComponent(entity))
+        {
+            meshComp->SetVisibility(true);
+        }
+        if (IsValid(entity) && (entity->InstancedGroupComp == this))
+        {
+            entity->InstancedGroupComp = nullptr;
+            entity->InstanceIndex = INDEX_NONE;
+        }
+    }
+    Entities.Reset();
+    ClearInstances();
+}
+
+void URRInstancedMeshGroupComponent::UpdateInstanceTransforms()
+{
+    TArray<FTransform> transforms;
+    transforms.Reserve(Entities.Num());
+    for (ARRMeshActor* entity : Entities)
+    {
+        // Invalid entities are collapsed to zero scale, keeping the other instance indices unchanged
+        UStaticMeshComponent* meshComp = GetEntityMeshComponent(entity);
+        transforms.Add(meshComp ? meshComp->GetComponentTransform()
+                                : FTransform(FQuat::Identity, FVector::ZeroVector, FVector::ZeroVector));
+    }
+    if (transforms.Num() > 0)
+    {
+        BatchUpdateInstancesTransforms(0, transforms, true, true, false);
+    }
+}
+
+void URRInstancedMeshGroupComponent::SetInstanceSegMaskId(const int32 InInstanceIndex, const int32 InSegMaskId)
+{
+    SetCustomDataValue(InInstanceIndex, CUSTOM_DATA_INDEX_SEGMASK_ID, InSegMaskId, true);
+    UpdateGroupCustomDepthStencil();
+}
+
+void URRInstancedMeshGroupComponent::SetInstanceColorAlbedo(const int32 InInstanceIndex,
+                                                            const FLinearColor& InColor,
+                                                            bool bMarkRenderStateDirty)
+{
+    SetCustomDataValue(InInstanceIndex, CUSTOM_DATA_INDEX_COLOR_ALBEDO, InColor.R);
+    SetCustomDataValue(InInstanceIndex, CUSTOM_DATA_INDEX_COLOR_ALBEDO + 1, InColor.G);
+    SetCustomDataValue(InInstanceIndex, CUSTOM_DATA_INDEX_COLOR_ALBEDO + 2, InColor.B, bMarkRenderStateDirty);
+}
+
+void URRInstancedMeshGroupComponent::UpdateGroupCustomDepthStencil()
+{
+    int32 stencilValue = INDEX_NONE;
+    for (const ARRMeshActor* entity : Entities)
+    {
+        const UStaticMeshComponent* meshComp = GetEntityMeshComponent(entity);
+        const int32 entityStencilValue = meshComp ? meshComp->CustomDepthStencilValue : INDEX_NONE;
+        if ((INDEX_NONE != stencilValue) && (entityStencilValue != stencilValue))
+        {
+            stencilValue = INDEX_NONE;
+            break;
+        }
+        stencilValue = entityStencilValue;
+    }
+
+    const bool bUniformStencil = (stencilValue > URRActorCommon::DEFAULT_CUSTOM_DEPTH_STENCIL_VALUE_VOID);
+    SetRenderCustomDepth(bUniformStencil);
+    SetCustomDepthStencilValue(bUniformStencil ? stencilValue : URRActorCommon::DEFAULT_CUSTOM_DEPTH_STENCIL_VALUE_VOID);
+}
+
+void URRInstancedMeshGroupComponent::OnComponentDestroyed(bool bDestroyingHierarchy)
+{
+    ResetGroup();
+    Super::OnComponentDestroyed(bDestroyingHierarchy);
+}
@@ -0,0 +1,99 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRLightProfileCache.h"
+
+// UE
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRTextureData.h"
+#include "RapyutaSimulationPlugins.h"
+
+static TAutoConsoleVariable<bool> CVarLightProfileCacheEnabled(
+    TEXT("rr.LightProfileCache.Enabled"),
+    true,
+    TEXT("Whether light profiles parsed from IES files are cached on disk by FRRLightProfileCache."),
+    ECVF_Default);
+
+bool FRRLightProfileCache::IsEnabled()
+{
+    return CVarLightProfileCacheEnabled.GetValueOnAnyThread();
+}
+
+FString FRRLightProfileCache::GetCacheFilePath(const FString& InFilePath)
+{
+    return FPaths::Combine(FPaths::ProjectSavedDir(),
+                           TEXT("RRLightProfileCache"),
+                           FString::Printf(TEXT("%s_v%u.rries"), *FMD5::HashAnsiString(*InFilePath), VERSION));
+}
+
+FString FRRLightProfileCache::GetFileSignature(const FString& InFilePath)
+{
+    const FFileStatData statData = IFileManager::Get().GetStatData(*InFilePath);
+    return statData.bIsValid ? FString::Printf(TEXT("%lld|%lld"), statData.FileSize, statData.ModificationTime.GetTicks())
+                             : FString();
+}
+
+bool FRRLightProfileCache::Load(const FString& InFilePath, const FString& InSignature, FRRLightProfileData& OutData)
+{
+    TArray<uint8> data;
+    if (!FFileHelper::LoadFileToArray(data, *GetCacheFilePath(InFilePath), FILEREAD_Silent))
+    {
+        return false;
+    }
+
+    FMemoryReader reader(data);
+    uint32 magic = 0;
+    uint32 version = 0;
+    FString signature;
+    reader << magic;
+    reader << version;
+    if ((MAGIC != magic) || (VERSION != version))
+    {
+        return false;
+    }
+    reader << signature;
+    if (reader.IsError() || (signature != InSignature))
+    {
+        return false;
+    }
+
+    reader << OutData;
+    if (reader.IsError() || !OutData.IsValid())
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("Light profile cache of [%s] is corrupted, ignored"), *InFilePath);
+        OutData = FRRLightProfileData();
+        return false;
+    }
+    return true;
+}
+
+bool FRRLightProfileCache::Save(const FString& InFilePath, const FString& InSignature, const FRRLightProfileData& InData)
+{
+    TArray<uint8> data;
+    FMemoryWriter writer(data);
+    uint32 magic = MAGIC;
+    uint32 version = VERSION;
+    FString signature = InSignature;
+    writer << magic;
+    writer << version;
+    writer << signature;
+    writer << const_cast<FRRLightProfileData&>(InData);
+
+    const FString cacheFilePath = GetCacheFilePath(InFilePath);
+    const FString tempFilePath = FString::Printf(TEXT("%s.%u.tmp"), *cacheFilePath, FPlatformProcess::GetCurrentProcessId());
+    if (!FFileHelper::SaveArrayToFile(data, *tempFilePath) || !IFileManager::Get().Move(*cacheFilePath, *tempFilePath, true))
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("Failed saving light profile cache [%s]"), *cacheFilePath);
+        IFileManager::Get().Delete(*tempFilePath);
+        return false;
+    }
+    return true;
+}
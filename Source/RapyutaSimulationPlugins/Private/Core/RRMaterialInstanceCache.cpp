@@ -0,0 +1,102 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRMaterialInstanceCache.h"
+
+// UE
+#include "Components/MeshComponent.h"
+#include "Engine/World.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRObjectCommon.h"
+
+const FMaterialParameterInfo FRRMaterialParameterInfos::ALBEDO(FName(FRRMaterialProperty::PROP_NAME_ALBEDO));
+const FMaterialParameterInfo FRRMaterialParameterInfos::ORM(FName(FRRMaterialProperty::PROP_NAME_ORM));
+const FMaterialParameterInfo FRRMaterialParameterInfos::NORMAL(FName(FRRMaterialProperty::PROP_NAME_NORMAL));
+const FMaterialParameterInfo FRRMaterialParameterInfos::MASK(FName(FRRMaterialProperty::PROP_NAME_MASK));
+const FMaterialParameterInfo FRRMaterialParameterInfos::COLOR_ALBEDO(FName(FRRMaterialProperty::PROP_NAME_COLOR_ALBEDO));
+const FMaterialParameterInfo FRRMaterialParameterInfos::EMISSIVE_STRENGTH(
+    FName(FRRMaterialProperty::PROP_NAME_EMISSIVE_STRENGTH));
+
+TMap<UWorld*, TUniquePtr<FRRMaterialInstanceCache>> FRRMaterialInstanceCache::SCaches;
+std::once_flag FRRMaterialInstanceCache::OnceFlag;
+
+FRRMaterialInstanceCache& FRRMaterialInstanceCache::Get(UWorld* InWorld)
+{
+    check(IsInGameThread());
+    std::call_once(OnceFlag,
+                   []() { FWorldDelegates::OnPostWorldCleanup.AddStatic(&FRRMaterialInstanceCache::OnPostWorldCleanup); });
+
+    TUniquePtr<FRRMaterialInstanceCache>& cache = SCaches.FindOrAdd(InWorld);
+    if (!cache.IsValid())
+    {
+        cache = MakeUnique<FRRMaterialInstanceCache>();
+    }
+    return *cache;
+}
+
+void FRRMaterialInstanceCache::OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/)
+{
+    // The MIDs are garbage collected once unreferenced by the cache
+    SCaches.Remove(InWorld);
+}
+
+UMaterialInstanceDynamic* FRRMaterialInstanceCache::GetOrCreate(UMeshComponent* InMeshComp,
+                                                                const int32 InMaterialIndex,
+                                                                UMaterialInterface* InParentMaterial,
+                                                                const FName& InName)
+{
+    check(IsInGameThread());
+    if ((nullptr == InMeshComp) || (nullptr == InParentMaterial))
+    {
+        return nullptr;
+    }
+
+    auto* currentMID = Cast<UMaterialInstanceDynamic>(InMeshComp->GetMaterial(InMaterialIndex));
+    if (currentMID && ((currentMID == InParentMaterial) || (currentMID->Parent == InParentMaterial)))
+    {
+        return currentMID;
+    }
+
+    UMaterialInstanceDynamic*& mid = MaterialInstances.FindOrAdd(
+        FRRMaterialInstanceKey(InMeshComp, InMaterialIndex, InParentMaterial), nullptr);
+    if (nullptr == mid)
+    {
+        mid = UMaterialInstanceDynamic::Create(
+            InParentMaterial,
+            InMeshComp,
+            InName.IsNone() ? NAME_None
+                            : MakeUniqueObjectName(InMeshComp, UMaterialInstanceDynamic::StaticClass(), InName));
+    }
+    InMeshComp->SetMaterial(InMaterialIndex, mid);
+
+    // [mid] ref is invalidated by pruning
+    UMaterialInstanceDynamic* result = mid;
+    PruneIfNeeded();
+    return result;
+}
+
+void FRRMaterialInstanceCache::PruneIfNeeded()
+{
+    if (MaterialInstances.Num() < PruneThresholdNum)
+    {
+        return;
+    }
+
+    // MIDs of garbage components are nulled by the GC, their keys then no longer resolving
+    for (auto it = MaterialInstances.CreateIterator(); it; ++it)
+    {
+        if ((nullptr == it.Value()) || (nullptr == it.Key().Get<0>().ResolveObjectPtr()))
+        {
+            it.RemoveCurrent();
+        }
+    }
+    PruneThresholdNum = FMath::Max(256, 2 * MaterialInstances.Num());
+}
+
+void FRRMaterialInstanceCache::AddReferencedObjects(FReferenceCollector& Collector)
+{
+    for (auto& materialInstance : MaterialInstances)
+    {
+        Collector.AddReferencedObject(materialInstance.Value);
+    }
+}
@@ -1,25 +1,141 @@
 // Copyright 2020-2021 Rapyuta Robotics Co., Ltd.
 #include "Core/RRMathUtils.h"
 
+// UE
+#include "Misc/CommandLine.h"
+#include "Misc/Parse.h"
+
 FRandomStream URRMathUtils::RandomStream = FRandomStream();
+TMap<int32, int32> URRMathUtils::SceneRandomSeeds;
+
+namespace
+{
+//! Innermost #FRRRandomStreamScope of each thread
+thread_local const FRandomStream* GScopedRandomStream = nullptr;
+}    // namespace
 
 void URRMathUtils::InitializeRandomStream()
 {
-    RandomStream.GenerateNewSeed();
+    int32 seed = 0;
+    if (FParse::Value(FCommandLine::Get(), TEXT("RRRandomSeed="), seed))
+    {
+        RandomStream.Initialize(seed);
+    }
+    else
+    {
+        RandomStream.GenerateNewSeed();
+    }
     UE_LOG_WITH_INFO(
         LogRapyutaCore, Display, TEXT("RRSim Random generator was initialized with seed: %d"), RandomStream.GetCurrentSeed());
 }
 
-FVector URRMathUtils::GetRandomSphericalPosition(const FVector& InCenter,
+void URRMathUtils::SetRandomSeed(const int32 InSeed)
+{
+    check(IsInGameThread());
+    RandomStream.Initialize(InSeed);
+}
+
+int32 URRMathUtils::GetSceneRandomSeed(const int32 InSceneId)
+{
+    const int32* seed = SceneRandomSeeds.Find(InSceneId);
+    return seed ? *seed : static_cast<int32>(HashCombine(GetTypeHash(GetMasterRandomSeed()), GetTypeHash(InSceneId)));
+}
+
+void URRMathUtils::SetSceneRandomSeed(const int32 InSceneId, const int32 InSeed)
+{
+    check(IsInGameThread());
+    if (InSeed != 0)
+    {
+        SceneRandomSeeds.Add(InSceneId, InSeed);
+    }
+    else
+    {
+        SceneRandomSeeds.Remove(InSceneId);
+    }
+}
+
+const FRandomStream& URRMathUtils::GetCurrentRandomStream()
+{
+    if (GScopedRandomStream)
+    {
+        return *GScopedRandomStream;
+    }
+    if (IsInGameThread())
+    {
+        return RandomStream;
+    }
+    // Seeded upon the thread's first draw, from the master seed at that time
+    thread_local const FRandomStream sThreadStream =
+        GetRandomSubstream(GetMasterRandomSeed(), static_cast<int32>(FPlatformTLS::GetCurrentThreadId()));
+    return sThreadStream;
+}
+
+void URRMathUtils::FillRandomFloatsInRange(const FRandomStream& InStream, TArrayView<float> OutValues, float InMin, float InMax)
+{
+    for (float& value : OutValues)
+    {
+        value = InStream.FRandRange(InMin, InMax);
+    }
+}
+
+void URRMathUtils::FillRandomIntegersInRange(const FRandomStream& InStream,
+                                             TArrayView<int32> OutValues,
+                                             int32 InMin,
+                                             int32 InMax)
+{
+    for (int32& value : OutValues)
+    {
+        value = InStream.RandRange(InMin, InMax);
+    }
+}
+
+void URRMathUtils::FillRandomLocations(const FRandomStream& InStream,
+                                       TArrayView<FVector> OutLocations,
+                                       const FVector& InLocationA,
+                                       const FVector& InLocationB)
+{
+    for (FVector& location : OutLocations)
+    {
+        location.Set(InStream.FRandRange(InLocationA.X, InLocationB.X),
+                     InStream.FRandRange(InLocationA.Y, InLocationB.Y),
+                     InStream.FRandRange(InLocationA.Z, InLocationB.Z));
+    }
+}
+
+void URRMathUtils::FillRandomOrientations(const FRandomStream& InStream, TArrayView<FQuat> OutOrientations)
+{
+    for (FQuat& orientation : OutOrientations)
+    {
+        orientation = GetRandomOrientation(InStream);
+    }
+}
+
+FRRRandomStreamScope::FRRRandomStreamScope(const FRandomStream& InStream) : PrevStream(GScopedRandomStream)
+{
+    GScopedRandomStream = &InStream;
+}
+
+FRRRandomStreamScope::~FRRRandomStreamScope()
+{
+    GScopedRandomStream = PrevStream;
+}
+
+const FRandomStream* FRRRandomStreamScope::GetCurrent()
+{
+    return GScopedRandomStream;
+}
+
+FVector URRMathUtils::GetRandomSphericalPosition(const FRandomStream& InStream,
+                                                 const FVector& InCenter,
                                                  const FVector2f& InDistanceRange,
                                                  const FVector2f& InHeightRange)
 {
     // Spherical coordinate (r, θ, φ)
-    const float randRadialDistance = URRMathUtils::GetRandomFloatInRange(InDistanceRange);
-    const float randHeight = URRMathUtils::GetRandomFloatInRange(InHeightRange);
+    const float randRadialDistance = InStream.FRandRange(InDistanceRange.X, InDistanceRange.Y);
+    const float randHeight = InStream.FRandRange(InHeightRange.X, InHeightRange.Y);
 
     // Azimuthal angle θ (Azimuth)
-    const float randAzimuthalAngle = GetRandomFloatInRange(-PI, PI);
+    const float randAzimuthalAngle = InStream.FRandRange(-PI, PI);
 
     return InCenter + FVector(randRadialDistance * FMath::Cos(randAzimuthalAngle),
                               randRadialDistance * FMath::Sin(randAzimuthalAngle),
@@ -2,9 +2,11 @@
 #include "Core/RRMeshActor.h"
 
 // RapyutaSimulationPlugins
+#include "Core/RRBoundingBoxAnnotator.h"
 #include "Core/RRCoreUtils.h"
 #include "Core/RRGameMode.h"
 #include "Core/RRGameState.h"
+#include "Core/RRInstancedMeshGroupComponent.h"
 #include "Core/RRMathUtils.h"
 #include "Core/RRSceneDirector.h"
 #include "Core/RRStaticMeshComponent.h"
@@ -96,27 +98,38 @@ UMeshComponent* ARRMeshActor::GetMeshComponent(int32 Index) const
 
 void ARRMeshActor::SetCustomDepthEnabled(bool bIsCustomDepthEnabled)
 {
+    // Since deactivated actors do not appear in scene, their seg mask ids are released to be reused by activated ones,
+    // while already labelled ones keep theirs
+    const bool bSegMasked = bIsCustomDepthEnabled && IsDataSynthEntity() && ActorCommon;
     for (auto& meshComp : MeshCompList)
     {
         // [RenderCustomDepth]
         meshComp->SetRenderCustomDepth(bIsCustomDepthEnabled);
 
         // [CustomDepthStencilValue]
-        // Since deactivated actors do not appear in scene so their custom depth stencil values should be reused
-        if (bIsCustomDepthEnabled && IsDataSynthEntity())
+        const int32 segMaskId = URRUObjectUtils::GetSegMaskId(meshComp);
+        if (bSegMasked)
         {
-#if RAPYUTA_USE_SCENE_DIRECTOR
-            auto* sceneDirector = RRGameState->GetSceneInstance<URRSceneInstance>(SceneInstanceId)->SceneDirector;
-            meshComp->SetCustomDepthStencilValue((sceneDirector->SceneEntityMaskValueList.Num() > 0)
-                                                     ? sceneDirector->SceneEntityMaskValueList.Pop()
-                                                     : ActorCommon->GenerateUniqueDepthStencilValue());
-#endif
+            if (!bSegMaskIdsAllocated || (segMaskId <= URRActorCommon::DEFAULT_CUSTOM_DEPTH_STENCIL_VALUE_VOID))
+            {
+                URRUObjectUtils::SetSegMaskId(meshComp, ActorCommon->GenerateUniqueDepthStencilValue());
+            }
         }
         else
         {
-            meshComp->SetCustomDepthStencilValue(URRActorCommon::DEFAULT_CUSTOM_DEPTH_STENCIL_VALUE_VOID);
+            if (bSegMaskIdsAllocated && ActorCommon)
+            {
+                ActorCommon->ReleaseDepthStencilValue(segMaskId);
+            }
+            URRUObjectUtils::SetSegMaskId(meshComp, URRActorCommon::DEFAULT_CUSTOM_DEPTH_STENCIL_VALUE_VOID);
         }
     }
+    bSegMaskIdsAllocated = bSegMasked;
+
+    if (InstancedGroupComp.IsValid() && BaseMeshComp)
+    {
+        InstancedGroupComp->SetInstanceSegMaskId(InstanceIndex, URRUObjectUtils::GetSegMaskId(BaseMeshComp));
+    }
 }
 
 void ARRMeshActor::SetCustomDepthStencilValue(int32 InCustomDepthStencilValue)
@@ -124,19 +137,26 @@ void ARRMeshActor::SetCustomDepthStencilValue(int32 InCustomDepthStencilValue)
     bool bCustomDepthEnabled = (InCustomDepthStencilValue >= 0);
     for (auto& meshComp : MeshCompList)
     {
+        // Explicit values are not owned by the allocator
+        if (bSegMaskIdsAllocated && ActorCommon)
+        {
+            ActorCommon->ReleaseDepthStencilValue(URRUObjectUtils::GetSegMaskId(meshComp));
+        }
+
         // [RenderCustomDepth]
         meshComp->SetRenderCustomDepth(bCustomDepthEnabled);
 
         // [CustomDepthStencilValue]
-        if (bCustomDepthEnabled && IsDataSynthEntity())
-        {
-            auto* sceneDirector = RRGameState->GetSceneInstance<URRSceneInstance>(SceneInstanceId)->SceneDirector;
-            meshComp->SetCustomDepthStencilValue(InCustomDepthStencilValue);
-        }
-        else
-        {
-            meshComp->SetCustomDepthStencilValue(URRActorCommon::DEFAULT_CUSTOM_DEPTH_STENCIL_VALUE_VOID);
-        }
+        URRUObjectUtils::SetSegMaskId(meshComp,
+                                      (bCustomDepthEnabled && IsDataSynthEntity())
+                                          ? InCustomDepthStencilValue
+                                          : URRActorCommon::DEFAULT_CUSTOM_DEPTH_STENCIL_VALUE_VOID);
+    }
+    bSegMaskIdsAllocated = false;
+
+    if (InstancedGroupComp.IsValid() && BaseMeshComp)
+    {
+        InstancedGroupComp->SetInstanceSegMaskId(InstanceIndex, URRUObjectUtils::GetSegMaskId(BaseMeshComp));
     }
 }
 
@@ -145,7 +165,7 @@ bool ARRMeshActor::IsCustomDepthEnabled() const
     for (const auto& meshComp : MeshCompList)
     {
         if ((false == meshComp->bRenderCustomDepth) ||
-            (meshComp->CustomDepthStencilValue <= URRActorCommon::DEFAULT_CUSTOM_DEPTH_STENCIL_VALUE_VOID))
+            (URRUObjectUtils::GetSegMaskId(meshComp) <= URRActorCommon::DEFAULT_CUSTOM_DEPTH_STENCIL_VALUE_VOID))
         {
             return false;
         }
@@ -158,7 +178,7 @@ TArray<int32> ARRMeshActor::GetCustomDepthStencilValueList() const
     TArray<int32> customDepthStencilValueList;
     for (const auto& meshComp : MeshCompList)
     {
-        customDepthStencilValueList.AddUnique(BaseMeshComp->CustomDepthStencilValue);
+        customDepthStencilValueList.AddUnique(URRUObjectUtils::GetSegMaskId(meshComp));
     }
 
     return customDepthStencilValueList;
@@ -166,6 +186,8 @@ TArray<int32> ARRMeshActor::GetCustomDepthStencilValueList() const
 
 void ARRMeshActor::OnBodyComponentMeshCreationDone(bool bInCreationResult, UObject* InMeshBodyComponent)
 {
+    FRRBoundingBoxAnnotator::InvalidateLocalBounds(this);
+
     // Accumulatively result marking
     bLastMeshCreationResult = (0 == CreatedMeshesNum) ? bInCreationResult : (bLastMeshCreationResult && bInCreationResult);
     if (ToBeCreatedMeshesNum == (++CreatedMeshesNum))
@@ -0,0 +1,309 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRMeshCache.h"
+
+// Native
+#include <type_traits>
+
+// UE
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRConvexDecomposition.h"
+#include "Core/RRMeshData.h"
+#include "RapyutaSimulationPlugins.h"
+
+static TAutoConsoleVariable<bool> CVarMeshCacheEnabled(
+    TEXT("rr.MeshCache.Enabled"),
+    true,
+    TEXT("Whether meshes imported from files are cached on disk by FRRMeshCache, to be loaded from it on later runs."),
+    ECVF_Default);
+
+namespace
+{
+//! Arrays of trivially copyable elements are written as raw memory, the cache being local to the machine & #VERSION
+template<typename T>
+void SerializeRawArray(FArchive& Ar, TArray<T>& InOutArray)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable elements are serialized as raw memory");
+    int32 num = InOutArray.Num();
+    Ar << num;
+    if (Ar.IsLoading())
+    {
+        if ((num < 0) || (static_cast<int64>(num) * sizeof(T) > static_cast<uint64>(Ar.TotalSize() - Ar.Tell())))
+        {
+            Ar.SetError();
+            return;
+        }
+        InOutArray.SetNumUninitialized(num);
+    }
+    Ar.Serialize(InOutArray.GetData(), static_cast<int64>(num) * sizeof(T));
+}
+}    // namespace
+
+bool FRRMeshCache::IsEnabled()
+{
+    return CVarMeshCacheEnabled.GetValueOnAnyThread();
+}
+
+FString FRRMeshCache::GetContentHash(const FString& InMeshFilePath)
+{
+    struct FContentHashEntry
+    {
+        int64 Size = 0;
+        FDateTime TimeStamp;
+        FString Hash;
+    };
+    static TMap<FString, FContentHashEntry> sContentHashes;
+    static FCriticalSection sContentHashesMutex;
+
+    const FFileStatData statData = IFileManager::Get().GetStatData(*InMeshFilePath);
+    if (!statData.bIsValid || statData.bIsDirectory)
+    {
+        return FString();
+    }
+    {
+        FScopeLock lock(&sContentHashesMutex);
+        const FContentHashEntry* entry = sContentHashes.Find(InMeshFilePath);
+        if (entry && (entry->Size == statData.FileSize) && (entry->TimeStamp == statData.ModificationTime))
+        {
+            return entry->Hash;
+        }
+    }
+
+    // Hashed outside of the lock, concurrent first hashes of the same file being harmless
+    const FMD5Hash fileHash = FMD5Hash::HashFile(*InMeshFilePath);
+    if (!fileHash.IsValid())
+    {
+        return FString();
+    }
+    FContentHashEntry entry;
+    entry.Size = statData.FileSize;
+    entry.TimeStamp = statData.ModificationTime;
+    entry.Hash = LexToString(fileHash);
+    FScopeLock lock(&sContentHashesMutex);
+    return sContentHashes.Add(InMeshFilePath, MoveTemp(entry)).Hash;
+}
+
+FString FRRMeshCache::GetCacheFilePath(const FString& InMeshFilePath,
+                                       const float InMeshScale,
+                                       const FRRMeshLODSettings& InLODSettings)
+{
+    const FString fileHash = GetContentHash(InMeshFilePath);
+    if (fileHash.IsEmpty())
+    {
+        return FString();
+    }
+    // Screen sizes only apply upon building static meshes, thus are not part of the key
+    const FString lodKey = InLODSettings.IsEnabled()
+                             ? FString::Printf(TEXT("_lod%d_%g"), InLODSettings.GetLODsNum(), InLODSettings.TrianglesRatio)
+                             : FString();
+    return FPaths::Combine(FPaths::ProjectSavedDir(),
+                           TEXT("RRMeshCache"),
+                           FString::Printf(TEXT("%s_%g%s_v%u.rrmesh"), *fileHash, InMeshScale, *lodKey, VERSION));
+}
+
+void FRRMeshCache::Serialize(FArchive& Ar, FRRMeshData& InOutMeshData)
+{
+    int32 nodesNum = InOutMeshData.Nodes.Num();
+    Ar << nodesNum;
+    if (Ar.IsLoading())
+    {
+        if ((nodesNum < 0) || (nodesNum > Ar.TotalSize()))
+        {
+            Ar.SetError();
+            return;
+        }
+        InOutMeshData.Nodes.SetNum(nodesNum);
+    }
+    for (auto& node : InOutMeshData.Nodes)
+    {
+        Ar << node.RelativeTransform;
+        Ar << node.NodeParentIndex;
+        int32 meshesNum = node.Meshes.Num();
+        Ar << meshesNum;
+        if (Ar.IsLoading())
+        {
+            if ((meshesNum < 0) || (meshesNum > Ar.TotalSize()))
+            {
+                Ar.SetError();
+                return;
+            }
+            node.Meshes.SetNum(meshesNum);
+        }
+        for (auto& mesh : node.Meshes)
+        {
+            SerializeRawArray(Ar, mesh.Vertices);
+            SerializeRawArray(Ar, mesh.VertexColors);
+            SerializeRawArray(Ar, mesh.TriangleIndices);
+            int32 lodsNum = mesh.LODs.Num();
+            Ar << lodsNum;
+            if (Ar.IsLoading())
+            {
+                if ((lodsNum < 0) || (lodsNum > Ar.TotalSize()))
+                {
+                    Ar.SetError();
+                    return;
+                }
+                mesh.LODs.SetNum(lodsNum);
+            }
+            for (auto& lod : mesh.LODs)
+            {
+                SerializeRawArray(Ar, lod.TriangleIndices);
+            }
+            SerializeRawArray(Ar, mesh.BoneInfluences);
+            Ar << mesh.MaterialIndex;
+            if (Ar.IsError())
+            {
+                return;
+            }
+        }
+    }
+
+    int32 materialsNum = InOutMeshData.Materials.Num();
+    Ar << materialsNum;
+    if (Ar.IsLoading())
+    {
+        if ((materialsNum < 0) || (materialsNum > Ar.TotalSize()))
+        {
+            Ar.SetError();
+            return;
+        }
+        InOutMeshData.Materials.SetNum(materialsNum);
+    }
+    for (auto& material : InOutMeshData.Materials)
+    {
+        Ar << material.VectorParams;
+    }
+}
+
+void FRRMeshCache::SerializeHulls(FArchive& Ar, TArray<TArray<FVector3f>>& InOutHulls)
+{
+    int32 hullsNum = InOutHulls.Num();
+    Ar << hullsNum;
+    if (Ar.IsLoading())
+    {
+        if ((hullsNum < 0) || (hullsNum > Ar.TotalSize()))
+        {
+            Ar.SetError();
+            return;
+        }
+        InOutHulls.SetNum(hullsNum);
+    }
+    for (auto& hull : InOutHulls)
+    {
+        SerializeRawArray(Ar, hull);
+        if (Ar.IsError())
+        {
+            return;
+        }
+    }
+}
+
+bool FRRMeshCache::LoadFile(const FString& InCacheFilePath, TFunctionRef<void(FArchive&)> InSerializeFunc)
+{
+    TUniquePtr<IMappedFileHandle> mappedFile(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*InCacheFilePath));
+    if (!mappedFile.IsValid())
+    {
+        return false;
+    }
+    TUniquePtr<IMappedFileRegion> mappedRegion(mappedFile->MapRegion());
+    if (!mappedRegion.IsValid())
+    {
+        return false;
+    }
+
+    FMemoryReaderView reader(TArrayView<const uint8>(mappedRegion->GetMappedPtr(), mappedRegion->GetMappedSize()));
+    uint32 magic = 0;
+    uint32 version = 0;
+    reader << magic;
+    reader << version;
+    if ((MAGIC != magic) || (VERSION != version))
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("Mesh cache [%s] is of another version, ignored"), *InCacheFilePath);
+        return false;
+    }
+
+    InSerializeFunc(reader);
+    if (reader.IsError())
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("Mesh cache [%s] is corrupted, ignored"), *InCacheFilePath);
+        return false;
+    }
+    return true;
+}
+
+bool FRRMeshCache::SaveFile(const FString& InCacheFilePath, TFunctionRef<void(FArchive&)> InSerializeFunc)
+{
+    TArray<uint8> data;
+    FMemoryWriter writer(data);
+    uint32 magic = MAGIC;
+    uint32 version = VERSION;
+    writer << magic;
+    writer << version;
+    InSerializeFunc(writer);
+
+    const FString tempFilePath = FString::Printf(TEXT("%s.%u.tmp"), *InCacheFilePath, FPlatformTLS::GetCurrentThreadId());
+    if (!FFileHelper::SaveArrayToFile(data, *tempFilePath) || !IFileManager::Get().Move(*InCacheFilePath, *tempFilePath, true))
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("Failed saving mesh cache [%s]"), *InCacheFilePath);
+        IFileManager::Get().Delete(*tempFilePath);
+        return false;
+    }
+    return true;
+}
+
+bool FRRMeshCache::Load(const FString& InCacheFilePath, FRRMeshData& OutMeshData)
+{
+    if (!LoadFile(InCacheFilePath, [&OutMeshData](FArchive& Ar) { Serialize(Ar, OutMeshData); }))
+    {
+        OutMeshData.Reset();
+        return false;
+    }
+    OutMeshData.bIsValid = (OutMeshData.Nodes.Num() > 0);
+    return OutMeshData.bIsValid;
+}
+
+bool FRRMeshCache::Save(const FString& InCacheFilePath, const FRRMeshData& InMeshData)
+{
+    return SaveFile(InCacheFilePath, [&InMeshData](FArchive& Ar) { Serialize(Ar, const_cast<FRRMeshData&>(InMeshData)); });
+}
+
+FString FRRMeshCache::GetHullsCacheFilePath(const TArray<FVector3f>& InVertices,
+                                            const TArray<uint32>& InIndices,
+                                            const FRRConvexDecompositionSettings& InSettings)
+{
+    FMD5 md5;
+    md5.Update(reinterpret_cast<const uint8*>(InVertices.GetData()), InVertices.Num() * sizeof(FVector3f));
+    md5.Update(reinterpret_cast<const uint8*>(InIndices.GetData()), InIndices.Num() * sizeof(uint32));
+    FMD5Hash geometryHash;
+    geometryHash.Set(md5);
+    return FPaths::Combine(
+        FPaths::ProjectSavedDir(),
+        TEXT("RRMeshCache"),
+        FString::Printf(TEXT("%s_%s_v%u.rrhull"), *LexToString(geometryHash), *InSettings.ToString(), VERSION));
+}
+
+bool FRRMeshCache::LoadHulls(const FString& InCacheFilePath, TArray<TArray<FVector3f>>& OutHulls)
+{
+    if (!LoadFile(InCacheFilePath, [&OutHulls](FArchive& Ar) { SerializeHulls(Ar, OutHulls); }))
+    {
+        OutHulls.Reset();
+        return false;
+    }
+    return OutHulls.Num() > 0;
+}
+
+bool FRRMeshCache::SaveHulls(const FString& InCacheFilePath, const TArray<TArray<FVector3f>>& InHulls)
+{
+    return SaveFile(InCacheFilePath,
+                    [&InHulls](FArchive& Ar) { SerializeHulls(Ar, const_cast<TArray<TArray<FVector3f>>&>(InHulls)); });
+}
@@ -1,7 +1,143 @@
 // Copyright 2020-2021 Rapyuta Robotics Co., Ltd.
 #include "Core/RRMeshData.h"
 
-TMap<FString, TSharedPtr<FRRMeshData>> FRRMeshData::MeshDataStore;
+// UE
+#include "HAL/IConsoleManager.h"
+
+// RapyutaSimulationPlugins
+#include "Tools/RRMemoryStats.h"
+
+static TAutoConsoleVariable<int32> CVarMeshDataStoreBudgetMB(
+    TEXT("rr.MeshDataStore.BudgetMB"),
+    1024,
+    TEXT("Memory budget [MB] of the CPU-side mesh data kept for reuse by FRRMeshData::MeshDataStore, 0 for unbounded."),
+    ECVF_Default);
+
+static void LogMeshDataStoreStats()
+{
+    UE_LOG(LogRapyutaCore, Display, TEXT("MeshDataStore: %s"), *FRRMeshData::GetMeshDataStoreStats().ToString());
+}
+
+static FAutoConsoleCommand GMeshDataStoreStatsCommand(TEXT("rr.MeshDataStore.Stats"),
+                                                      TEXT("Log the stats of FRRMeshData::MeshDataStore."),
+                                                      FConsoleCommandDelegate::CreateStatic(&LogMeshDataStoreStats));
+
+TMap<FString, FRRMeshData::FStoreEntry> FRRMeshData::MeshDataStore;
+FRRMeshDataStoreStats FRRMeshData::MeshDataStoreStats;
+uint64 FRRMeshData::MeshDataStoreAccessCounter = 0;
+
+void FRRMeshData::AddMeshData(const FString& InMeshUniqueName,
+                              const TSharedPtr<FRRMeshData>& InMeshData,
+                              bool bInResourceBuilt)
+{
+    check(IsInGameThread());
+    if (!InMeshData.IsValid())
+    {
+        return;
+    }
+    LLM_SCOPE_BYTAG(RRMeshData);
+
+    // The Assimp scene has been fully converted into [InMeshData], thus is not to be kept resident
+    InMeshData->MeshImporter.Reset();
+
+    FStoreEntry& entry = MeshDataStore.FindOrAdd(InMeshUniqueName);
+    MeshDataStoreStats.ResidentBytes -= entry.Bytes;
+    entry.MeshData = InMeshData;
+    entry.Bytes = InMeshData->GetAllocatedSize();
+    entry.LastAccess = ++MeshDataStoreAccessCounter;
+    entry.bResourceBuilt = bInResourceBuilt;
+    MeshDataStoreStats.ResidentBytes += entry.Bytes;
+    MeshDataStoreStats.EntriesNum = MeshDataStore.Num();
+
+    TrimMeshDataStore();
+}
+
+TSharedPtr<FRRMeshData> FRRMeshData::GetMeshData(const FString& InMeshUniqueName)
+{
+    check(IsInGameThread());
+    FStoreEntry* entry = MeshDataStore.Find(InMeshUniqueName);
+    if (nullptr == entry)
+    {
+        ++MeshDataStoreStats.MissesNum;
+        return nullptr;
+    }
+    ++MeshDataStoreStats.HitsNum;
+    entry->LastAccess = ++MeshDataStoreAccessCounter;
+    return entry->MeshData;
+}
+
+void FRRMeshData::TrimMeshDataStore()
+{
+    const int64 budgetBytes = static_cast<int64>(CVarMeshDataStoreBudgetMB.GetValueOnGameThread()) * 1024 * 1024;
+    if ((budgetBytes <= 0) || (MeshDataStoreStats.ResidentBytes <= budgetBytes))
+    {
+        return;
+    }
+
+    // Only entries referenced by no mesh component being created could be evicted, built ones first then by LRU
+    TArray<TPair<FString, const FStoreEntry*>> candidates;
+    for (const auto& entry : MeshDataStore)
+    {
+        if (entry.Value.MeshData.GetSharedReferenceCount() == 1)
+        {
+            candidates.Emplace(entry.Key, &entry.Value);
+        }
+    }
+    candidates.Sort(
+        [](const TPair<FString, const FStoreEntry*>& InA, const TPair<FString, const FStoreEntry*>& InB)
+        {
+            if (InA.Value->bResourceBuilt != InB.Value->bResourceBuilt)
+            {
+                return InA.Value->bResourceBuilt;
+            }
+            return InA.Value->LastAccess < InB.Value->LastAccess;
+        });
+
+    TArray<FString> evictedNames;
+    for (const auto& candidate : candidates)
+    {
+        if (MeshDataStoreStats.ResidentBytes <= budgetBytes)
+        {
+            break;
+        }
+        MeshDataStoreStats.ResidentBytes -= candidate.Value->Bytes;
+        evictedNames.Add(candidate.Key);
+    }
+    for (const auto& name : evictedNames)
+    {
+        MeshDataStore.Remove(name);
+    }
+    MeshDataStoreStats.EvictionsNum += evictedNames.Num();
+    MeshDataStoreStats.EntriesNum = MeshDataStore.Num();
+#if RAPYUTA_SIM_DEBUG
+    UE_LOG_WITH_INFO(
+        LogRapyutaCore, Display, TEXT("Evicted %d mesh data: %s"), evictedNames.Num(), *MeshDataStoreStats.ToString());
+#endif
+}
+
+int64 FRRMeshData::GetAllocatedSize() const
+{
+    int64 bytes = sizeof(FRRMeshData) + Nodes.GetAllocatedSize() + Materials.GetAllocatedSize();
+    for (const auto& node : Nodes)
+    {
+        for (const auto& mesh : node.Meshes)
+        {
+            bytes += mesh.Vertices.GetAllocatedSize() + mesh.VertexColors.GetAllocatedSize() +
+                     mesh.TriangleIndices.GetAllocatedSize() + mesh.LODs.GetAllocatedSize() +
+                     mesh.BoneInfluences.GetAllocatedSize();
+            for (const auto& lod : mesh.LODs)
+            {
+                bytes += lod.TriangleIndices.GetAllocatedSize();
+            }
+        }
+        bytes += node.Meshes.GetAllocatedSize();
+    }
+    for (const auto& material : Materials)
+    {
+        bytes += material.VectorParams.GetAllocatedSize();
+    }
+    return bytes;
+}
 
 void FRRBoneProperty::PrintSelf() const
 {
@@ -24,22 +160,89 @@ void FRRMeshData::PrintSelf() const
     }
 }
 
+void FRRMeshNodeData::GetPositions(TArray<FVector>& OutPositions) const
+{
+    OutPositions.SetNumUninitialized(Vertices.Num());
+    for (auto i = 0; i < Vertices.Num(); ++i)
+    {
+        OutPositions[i] = FVector(Vertices[i].Position);
+    }
+}
+
+void FRRMeshNodeData::ToProcMeshSection(TArray<FVector>& OutVertices,
+                                        TArray<FVector>& OutNormals,
+                                        TArray<FVector2D>& OutUVs,
+                                        TArray<FColor>& OutVertexColors,
+                                        TArray<FProcMeshTangent>& OutTangents) const
+{
+    const int32 verticesNum = Vertices.Num();
+    OutVertices.SetNumUninitialized(verticesNum);
+    OutNormals.SetNumUninitialized(verticesNum);
+    OutUVs.SetNumUninitialized(verticesNum);
+    OutTangents.SetNumUninitialized(verticesNum);
+    for (auto i = 0; i < verticesNum; ++i)
+    {
+        const FRRMeshVertex& vertex = Vertices[i];
+        OutVertices[i] = FVector(vertex.Position);
+        OutNormals[i] = FVector(vertex.Normal.ToFVector3f());
+        OutUVs[i] = FVector2D(vertex.UV);
+        const FVector4f tangent = vertex.Tangent.ToFVector4f();
+        OutTangents[i] = FProcMeshTangent(FVector(tangent.X, tangent.Y, tangent.Z), tangent.W < 0.f);
+    }
+
+    // UProceduralMeshComponent also takes empty vertex colors
+    OutVertexColors = VertexColors;
+}
+
+void FRRMeshNodeData::FromProcMeshSection(const TArray<FVector>& InVertices,
+                                          const TArray<FVector>& InNormals,
+                                          const TArray<FVector2D>& InUVs,
+                                          const TArray<FColor>& InVertexColors,
+                                          const TArray<FProcMeshTangent>& InTangents)
+{
+    const int32 verticesNum = InVertices.Num();
+    Vertices.SetNum(verticesNum);
+    for (auto i = 0; i < verticesNum; ++i)
+    {
+        FRRMeshVertex& vertex = Vertices[i];
+        vertex.Position = FVector3f(InVertices[i]);
+        vertex.UV = InUVs.IsValidIndex(i) ? FVector2f(InUVs[i]) : FVector2f::ZeroVector;
+        vertex.Normal = FPackedNormal(InNormals.IsValidIndex(i) ? FVector3f(InNormals[i]) : FVector3f::ZeroVector);
+        if (InTangents.IsValidIndex(i))
+        {
+            const float tangentW = InTangents[i].bFlipTangentY ? -1.f : 1.f;
+            vertex.Tangent = FPackedNormal(FVector4f(FVector3f(InTangents[i].TangentX), tangentW));
+        }
+        else
+        {
+            vertex.Tangent = FPackedNormal(FVector4f(1.f, 0.f, 0.f, 1.f));
+        }
+    }
+    VertexColors = (InVertexColors.Num() == verticesNum) ? InVertexColors : TArray<FColor>();
+}
+
+void FRRMeshNodeData::TransformBy(const FTransform& InTransform)
+{
+    for (auto& vertex : Vertices)
+    {
+        vertex.Position = FVector3f(InTransform.TransformPosition(FVector(vertex.Position)));
+        vertex.Normal = FPackedNormal(FVector3f(InTransform.TransformVectorNoScale(FVector(vertex.Normal.ToFVector3f()))));
+        const FVector4f tangent = vertex.Tangent.ToFVector4f();
+        const FVector tangentX = InTransform.TransformVectorNoScale(FVector(tangent.X, tangent.Y, tangent.Z));
+        vertex.Tangent = FPackedNormal(FVector4f(FVector3f(tangentX), tangent.W));
+    }
+}
+
 void FRRMeshNodeData::PrintSelf() const
 {
     UE_LOG_WITH_INFO(LogRapyutaCore,
                      Display,
                      TEXT("- Vertices num: %d\n"
                           "- Triangles num: %d\n"
-                          "- Normals num: %d\n"
-                          "- UVs num: %d UV2fs %d\n"
-                          "- ProcTangents num: %d\n"
+                          "- VertexColors num: %d\n"
                           "- BoneInfluences num: %d\n"),
                      Vertices.Num(),
                      TriangleIndices.Num(),
-                     Normals.Num(),
-                     UVs.Num(),
-                     UV2fs.Num(),
-                     ProcTangents.Num(),
+                     VertexColors.Num(),
                      BoneInfluences.Num());
-    verify(UVs.Num() == UV2fs.Num());
 }
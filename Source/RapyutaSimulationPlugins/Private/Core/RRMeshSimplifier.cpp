@@ -0,0 +1,362 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRMeshSimplifier.h"
+
+// UE
+#include "Async/ParallelFor.h"
+
+namespace
+{
+//! Weight of the planes preserving open boundary edges, relative to the face planes
+constexpr double BOUNDARY_WEIGHT = 100.;
+
+//! Min cosine between a triangle normal before & after a collapse
+constexpr double MIN_NORMAL_COSINE = 0.2;
+
+//! Symmetric 4x4 quadric, as its 10 upper triangle coefficients
+struct FQuadric
+{
+    double A[10] = {0.};
+
+    static FQuadric FromPlane(const FVector3d& InNormal, const double InD, const double InWeight)
+    {
+        const double a = InNormal.X, b = InNormal.Y, c = InNormal.Z;
+        FQuadric quadric;
+        quadric.A[0] = InWeight * a * a;
+        quadric.A[1] = InWeight * a * b;
+        quadric.A[2] = InWeight * a * c;
+        quadric.A[3] = InWeight * a * InD;
+        quadric.A[4] = InWeight * b * b;
+        quadric.A[5] = InWeight * b * c;
+        quadric.A[6] = InWeight * b * InD;
+        quadric.A[7] = InWeight * c * c;
+        quadric.A[8] = InWeight * c * InD;
+        quadric.A[9] = InWeight * InD * InD;
+        return quadric;
+    }
+
+    FQuadric& operator+=(const FQuadric& InOther)
+    {
+        for (int32 i = 0; i < 10; ++i)
+        {
+            A[i] += InOther.A[i];
+        }
+        return *this;
+    }
+
+    double Evaluate(const FVector3d& InPos) const
+    {
+        const double x = InPos.X, y = InPos.Y, z = InPos.Z;
+        return A[0] * x * x + 2. * A[1] * x * y + 2. * A[2] * x * z + 2. * A[3] * x + A[4] * y * y + 2. * A[5] * y * z +
+               2. * A[6] * y + A[7] * z * z + 2. * A[8] * z + A[9];
+    }
+};
+
+//! Collapse of vertex [From] onto [To], valid as long as both versions are unchanged
+struct FCollapse
+{
+    double Cost = 0.;
+    int32 From = INDEX_NONE;
+    int32 To = INDEX_NONE;
+    uint32 FromVersion = 0;
+    uint32 ToVersion = 0;
+};
+
+struct FCollapseLess
+{
+    bool operator()(const FCollapse& InA, const FCollapse& InB) const
+    {
+        return InA.Cost < InB.Cost;
+    }
+};
+
+uint64 EdgeKey(const int32 InA, const int32 InB)
+{
+    return (static_cast<uint64>(FMath::Min(InA, InB)) << 32) | static_cast<uint32>(FMath::Max(InA, InB));
+}
+}    // namespace
+
+void FRRMeshSimplifier::Simplify(const TArray<FRRMeshVertex>& InVertices,
+                                 const TArray<int32>& InTriangleIndices,
+                                 const int32 InTargetTrianglesNum,
+                                 TArray<int32>& OutTriangleIndices)
+{
+    const int32 trianglesNum = InTriangleIndices.Num() / 3;
+    OutTriangleIndices = InTriangleIndices;
+    if ((trianglesNum <= InTargetTrianglesNum) || (trianglesNum == 0))
+    {
+        return;
+    }
+    for (const int32 index : InTriangleIndices)
+    {
+        if (!InVertices.IsValidIndex(index))
+        {
+            return;
+        }
+    }
+
+    // 1- Weld vertices sharing a position
+    TArray<int32> weldedIds;
+    weldedIds.SetNumUninitialized(InVertices.Num());
+    TArray<int32> weldedSources;
+    TMap<FVector3f, int32> positionIds;
+    positionIds.Reserve(InVertices.Num());
+    for (int32 i = 0; i < InVertices.Num(); ++i)
+    {
+        if (const int32* weldedId = positionIds.Find(InVertices[i].Position))
+        {
+            weldedIds[i] = *weldedId;
+        }
+        else
+        {
+            weldedIds[i] = weldedSources.Add(i);
+            positionIds.Add(InVertices[i].Position, weldedIds[i]);
+        }
+    }
+    const int32 weldedNum = weldedSources.Num();
+    TArray<FVector3d> positions;
+    positions.SetNumUninitialized(weldedNum);
+    for (int32 w = 0; w < weldedNum; ++w)
+    {
+        positions[w] = FVector3d(InVertices[weldedSources[w]].Position);
+    }
+
+    // 2- Triangles in welded ids, their face quadrics & edges' use counts
+    TArray<int32> triangles;
+    triangles.SetNumUninitialized(InTriangleIndices.Num());
+    TBitArray<> removedTriangles(false, trianglesNum);
+    TArray<TArray<int32>> vertexTriangles;
+    vertexTriangles.SetNum(weldedNum);
+    TArray<FQuadric> quadrics;
+    quadrics.SetNum(weldedNum);
+    TMap<uint64, int32> edgeUses;
+    edgeUses.Reserve(InTriangleIndices.Num());
+    int32 remainingNum = trianglesNum;
+    for (int32 t = 0; t < trianglesNum; ++t)
+    {
+        int32* tri = &triangles[3 * t];
+        for (int32 k = 0; k < 3; ++k)
+        {
+            tri[k] = weldedIds[InTriangleIndices[3 * t + k]];
+        }
+        if ((tri[0] == tri[1]) || (tri[1] == tri[2]) || (tri[2] == tri[0]))
+        {
+            removedTriangles[t] = true;
+            --remainingNum;
+            continue;
+        }
+
+        const FVector3d& p0 = positions[tri[0]];
+        FVector3d normal = FVector3d::CrossProduct(positions[tri[1]] - p0, positions[tri[2]] - p0);
+        const double doubleArea = normal.Length();
+        if (doubleArea > UE_DOUBLE_SMALL_NUMBER)
+        {
+            normal /= doubleArea;
+            const FQuadric faceQuadric = FQuadric::FromPlane(normal, -FVector3d::DotProduct(normal, p0), 0.5 * doubleArea);
+            for (int32 k = 0; k < 3; ++k)
+            {
+                quadrics[tri[k]] += faceQuadric;
+            }
+        }
+        for (int32 k = 0; k < 3; ++k)
+        {
+            vertexTriangles[tri[k]].Add(t);
+            ++edgeUses.FindOrAdd(EdgeKey(tri[k], tri[(k + 1) % 3]));
+        }
+    }
+
+    // 3- Boundary edges, used by a single triangle, get a plane orthogonal to their triangle
+    for (int32 t = 0; t < trianglesNum; ++t)
+    {
+        if (removedTriangles[t])
+        {
+            continue;
+        }
+        const int32* tri = &triangles[3 * t];
+        const FVector3d faceNormal =
+            FVector3d::CrossProduct(positions[tri[1]] - positions[tri[0]], positions[tri[2]] - positions[tri[0]]).GetSafeNormal();
+        for (int32 k = 0; k < 3; ++k)
+        {
+            const int32 a = tri[k];
+            const int32 b = tri[(k + 1) % 3];
+            if (edgeUses.FindRef(EdgeKey(a, b)) != 1)
+            {
+                continue;
+            }
+            const FVector3d edge = positions[b] - positions[a];
+            const FVector3d planeNormal = FVector3d::CrossProduct(edge, faceNormal).GetSafeNormal();
+            const FQuadric boundaryQuadric = FQuadric::FromPlane(
+                planeNormal, -FVector3d::DotProduct(planeNormal, positions[a]), BOUNDARY_WEIGHT * edge.SizeSquared());
+            quadrics[a] += boundaryQuadric;
+            quadrics[b] += boundaryQuadric;
+        }
+    }
+
+    // 4- Collapse the cheapest edges first
+    TArray<uint32> versions;
+    versions.SetNumZeroed(weldedNum);
+    TBitArray<> removedVertices(false, weldedNum);
+    TArray<FCollapse> collapses;
+    collapses.Reserve(edgeUses.Num());
+    auto pushCollapse = [&](const int32 InA, const int32 InB)
+    {
+        FQuadric quadric = quadrics[InA];
+        quadric += quadrics[InB];
+        const double costAToB = quadric.Evaluate(positions[InB]);
+        const double costBToA = quadric.Evaluate(positions[InA]);
+        const bool bAToB = (costAToB <= costBToA);
+        FCollapse collapse;
+        collapse.Cost = bAToB ? costAToB : costBToA;
+        collapse.From = bAToB ? InA : InB;
+        collapse.To = bAToB ? InB : InA;
+        collapse.FromVersion = versions[collapse.From];
+        collapse.ToVersion = versions[collapse.To];
+        collapses.HeapPush(collapse, FCollapseLess());
+    };
+    for (const auto& edge : edgeUses)
+    {
+        pushCollapse(static_cast<int32>(edge.Key >> 32), static_cast<int32>(edge.Key & 0xFFFFFFFF));
+    }
+
+    TArray<int32> neighbours;
+    while ((remainingNum > InTargetTrianglesNum) && (collapses.Num() > 0))
+    {
+        FCollapse collapse;
+        collapses.HeapPop(collapse, FCollapseLess(), false);
+        const int32 from = collapse.From;
+        const int32 to = collapse.To;
+        if (removedVertices[from] || removedVertices[to] || (versions[from] != collapse.FromVersion) ||
+            (versions[to] != collapse.ToVersion))
+        {
+            continue;
+        }
+
+        // Reject the collapse if any triangle kept around [from] would flip
+        bool bFlipping = false;
+        for (const int32 t : vertexTriangles[from])
+        {
+            const int32* tri = &triangles[3 * t];
+            if (removedTriangles[t] || (tri[0] == to) || (tri[1] == to) || (tri[2] == to))
+            {
+                continue;
+            }
+            FVector3d corners[3] = {positions[tri[0]], positions[tri[1]], positions[tri[2]]};
+            const FVector3d oldNormal =
+                FVector3d::CrossProduct(corners[1] - corners[0], corners[2] - corners[0]).GetSafeNormal();
+            for (int32 k = 0; k < 3; ++k)
+            {
+                if (tri[k] == from)
+                {
+                    corners[k] = positions[to];
+                }
+            }
+            const FVector3d newNormal =
+                FVector3d::CrossProduct(corners[1] - corners[0], corners[2] - corners[0]).GetSafeNormal();
+            if (FVector3d::DotProduct(oldNormal, newNormal) < MIN_NORMAL_COSINE)
+            {
+                bFlipping = true;
+                break;
+            }
+        }
+        if (bFlipping)
+        {
+            continue;
+        }
+
+        // Apply it: triangles sharing the edge degenerate, the others move onto [to]
+        for (const int32 t : vertexTriangles[from])
+        {
+            if (removedTriangles[t])
+            {
+                continue;
+            }
+            int32* tri = &triangles[3 * t];
+            if ((tri[0] == to) || (tri[1] == to) || (tri[2] == to))
+            {
+                removedTriangles[t] = true;
+                --remainingNum;
+                continue;
+            }
+            for (int32 k = 0; k < 3; ++k)
+            {
+                if (tri[k] == from)
+                {
+                    tri[k] = to;
+                }
+            }
+            vertexTriangles[to].Add(t);
+        }
+        vertexTriangles[from].Empty();
+        vertexTriangles[to].RemoveAllSwap([&removedTriangles](const int32 InTriangle) { return removedTriangles[InTriangle]; });
+        quadrics[to] += quadrics[from];
+        removedVertices[from] = true;
+        ++versions[to];
+
+        // New collapses of the edges around [to]
+        neighbours.Reset();
+        for (const int32 t : vertexTriangles[to])
+        {
+            for (int32 k = 0; k < 3; ++k)
+            {
+                if (triangles[3 * t + k] != to)
+                {
+                    neighbours.AddUnique(triangles[3 * t + k]);
+                }
+            }
+        }
+        for (const int32 neighbour : neighbours)
+        {
+            pushCollapse(to, neighbour);
+        }
+    }
+
+    // 5- Back to source vertices, keeping a corner's own vertex if it has not moved, to keep its attributes
+    OutTriangleIndices.Reset(3 * remainingNum);
+    for (int32 t = 0; t < trianglesNum; ++t)
+    {
+        if (removedTriangles[t])
+        {
+            continue;
+        }
+        for (int32 k = 0; k < 3; ++k)
+        {
+            const int32 sourceIndex = InTriangleIndices[3 * t + k];
+            const int32 weldedId = triangles[3 * t + k];
+            OutTriangleIndices.Add((weldedIds[sourceIndex] == weldedId) ? sourceIndex : weldedSources[weldedId]);
+        }
+    }
+}
+
+void FRRMeshSimplifier::GenerateLODs(const FRRMeshLODSettings& InLODSettings, FRRMeshData& InOutMeshData)
+{
+    if (!InLODSettings.IsEnabled())
+    {
+        return;
+    }
+
+    TArray<FRRMeshNodeData*> meshes;
+    for (auto& node : InOutMeshData.Nodes)
+    {
+        for (auto& mesh : node.Meshes)
+        {
+            meshes.Add(&mesh);
+        }
+    }
+
+    const int32 lodsNum = InLODSettings.GetLODsNum();
+    ParallelFor(meshes.Num(),
+                [&meshes, &InLODSettings, lodsNum](int32 InMeshIndex)
+                {
+                    FRRMeshNodeData& mesh = *meshes[InMeshIndex];
+                    mesh.LODs.SetNum(lodsNum - 1);
+                    // Each LOD is simplified from the previous one
+                    for (int32 lodIndex = 1; lodIndex < lodsNum; ++lodIndex)
+                    {
+                        const TArray<int32>& sourceIndices = mesh.GetTriangleIndices(lodIndex - 1);
+                        const int32 targetTrianglesNum =
+                            FMath::Max(1, FMath::FloorToInt32(InLODSettings.TrianglesRatio * sourceIndices.Num() / 3));
+                        FRRMeshSimplifier::Simplify(
+                            mesh.Vertices, sourceIndices, targetTrianglesNum, mesh.LODs[lodIndex - 1].TriangleIndices);
+                    }
+                });
+}
@@ -5,6 +5,7 @@
 #include <string>
 
 // UE
+#include "Async/ParallelFor.h"
 #include "DrawDebugHelpers.h"
 #include "HAL/FileManagerGeneric.h"
 #include "Materials/MaterialInterface.h"
@@ -18,9 +19,15 @@
 
 // RapyutaSimulationPlugins
 #include "Core/RRConversionUtils.h"
+#include "Core/RRGLTFLoader.h"
 #include "Core/RRGameSingleton.h"
+#include "Core/RRMeshCache.h"
+#include "Core/RRMeshSimplifier.h"
 #include "Core/RRThreadUtils.h"
+#include "Core/RRTrace.h"
 #include "RapyutaSimulationPlugins.h"
+#include "Tools/RRMemoryStats.h"
+#include "Tools/RRStartupProfiler.h"
 
 void URRMeshUtils::ProcessMeshNode(aiNode* InNode,
                                    const aiScene* InScene,
@@ -28,15 +35,26 @@ void URRMeshUtils::ProcessMeshNode(aiNode* InNode,
                                    int* InCurrentIndex,
                                    FRRMeshData& OutMeshData)
 {
-    FRRMeshNode meshNode;
-    meshNode.NodeParentIndex = InParentNodeIndex;
+    // 1- Flatten the node tree, allocating the mesh slots of each mesh node
+    TArray<FRRMeshJob> meshJobs;
+    FlattenMeshNode(InNode, InScene, InParentNodeIndex, InCurrentIndex, OutMeshData, meshJobs);
 
-    aiMatrix4x4 nodeTransf = InNode->mTransformation;
-    meshNode.RelativeTransform = FTransform(FMatrix(FPlane(nodeTransf.a1, nodeTransf.b1, nodeTransf.c1, nodeTransf.d1),
-                                                    FPlane(nodeTransf.a2, nodeTransf.b2, nodeTransf.c2, nodeTransf.d2),
-                                                    FPlane(nodeTransf.a3, nodeTransf.b3, nodeTransf.c3, nodeTransf.d3),
-                                                    FPlane(nodeTransf.a4, nodeTransf.b4, nodeTransf.c4, nodeTransf.d4)));
+    // 2- Convert the meshes in parallel, each into its own slot
+    ParallelFor(meshJobs.Num(),
+                [&OutMeshData, &meshJobs](int32 InJobIndex)
+                {
+                    const FRRMeshJob& job = meshJobs[InJobIndex];
+                    OutMeshData.Nodes[job.NodeIndex].Meshes[job.MeshIndex] = ProcessMesh(job.Mesh);
+                });
+}
 
+void URRMeshUtils::FlattenMeshNode(aiNode* InNode,
+                                   const aiScene* InScene,
+                                   int InParentNodeIndex,
+                                   int* InCurrentIndex,
+                                   FRRMeshData& OutMeshData,
+                                   TArray<FRRMeshJob>& OutMeshJobs)
+{
 #if RAPYUTA_MESH_UTILS_DEBUG
     UE_LOG_WITH_INFO(LogRapyutaCore,
                      Display,
@@ -47,23 +65,39 @@ void URRMeshUtils::ProcessMeshNode(aiNode* InNode,
 #endif
     if ((InNode->mNumMeshes > 0) && InNode->mMeshes)
     {
+        int32 meshesNum = 0;
         for (auto i = 0; i < InNode->mNumMeshes; ++i)
         {
-            auto meshIndex = InNode->mMeshes[i];
-#if RAPYUTA_MESH_UTILS_DEBUG
-            UE_LOG_WITH_INFO(LogRapyutaCore, Log, TEXT("Loading Mesh at index: %d"), meshIndex);
-#endif
-            aiMesh* mesh = InScene->mMeshes[meshIndex];
-            if (mesh)
-            {
-                meshNode.Meshes.Emplace(ProcessMesh(mesh));
-            }
+            meshesNum += (nullptr != InScene->mMeshes[InNode->mMeshes[i]]) ? 1 : 0;
         }
 
         // Only add [meshNode] having mesh data to [OutMeshData]'s Nodes
-        if (meshNode.Meshes.Num() > 0)
+        if (meshesNum > 0)
         {
-            OutMeshData.Nodes.Emplace(MoveTemp(meshNode));
+            const int32 nodeIndex = OutMeshData.Nodes.AddDefaulted();
+            FRRMeshNode& meshNode = OutMeshData.Nodes[nodeIndex];
+            meshNode.NodeParentIndex = InParentNodeIndex;
+
+            aiMatrix4x4 nodeTransf = InNode->mTransformation;
+            meshNode.RelativeTransform =
+                FTransform(FMatrix(FPlane(nodeTransf.a1, nodeTransf.b1, nodeTransf.c1, nodeTransf.d1),
+                                   FPlane(nodeTransf.a2, nodeTransf.b2, nodeTransf.c2, nodeTransf.d2),
+                                   FPlane(nodeTransf.a3, nodeTransf.b3, nodeTransf.c3, nodeTransf.d3),
+                                   FPlane(nodeTransf.a4, nodeTransf.b4, nodeTransf.c4, nodeTransf.d4)));
+            meshNode.Meshes.SetNum(meshesNum);
+
+            int32 meshIndex = 0;
+            for (auto i = 0; i < InNode->mNumMeshes; ++i)
+            {
+#if RAPYUTA_MESH_UTILS_DEBUG
+                UE_LOG_WITH_INFO(LogRapyutaCore, Log, TEXT("Loading Mesh at index: %d"), InNode->mMeshes[i]);
+#endif
+                aiMesh* mesh = InScene->mMeshes[InNode->mMeshes[i]];
+                if (mesh)
+                {
+                    OutMeshJobs.Add({nodeIndex, meshIndex++, mesh});
+                }
+            }
         }
     }
 
@@ -73,7 +107,7 @@ void URRMeshUtils::ProcessMeshNode(aiNode* InNode,
     for (auto i = 0; i < InNode->mNumChildren; ++i)
     {
         (*InCurrentIndex)++;
-        ProcessMeshNode(InNode->mChildren[i], InScene, currentParentIndex, InCurrentIndex, OutMeshData);
+        FlattenMeshNode(InNode->mChildren[i], InScene, currentParentIndex, InCurrentIndex, OutMeshData, OutMeshJobs);
     }
 }
 
@@ -92,37 +126,69 @@ FRRMeshNodeData URRMeshUtils::ProcessMesh(aiMesh* InMesh)
                      InMesh->mNumFaces,
                      bHasFaces);
 #endif
-    // Fetch mesh data, also Converting handedness from Assimp(right) ->UE (left)
-    for (auto i = 0; i < InMesh->mNumVertices; ++i)
-    {
-        // [Vertices] --
-        outMeshNodeData.Vertices.Emplace(
-            URRConversionUtils::ConvertHandedness(FVector(InMesh->mVertices[i].x, InMesh->mVertices[i].y, InMesh->mVertices[i].z)));
-
-        // [VertexColors] --
-        const aiColor4D* colors = InMesh->mColors[0];
-        outMeshNodeData.VertexColors.Emplace(colors ? FColor(colors[i].r, colors[i].g, colors[i].b, colors[i].a) : FColor::Black);
-
-        // [Normals] --
-        outMeshNodeData.Normals.Emplace(bHasNormals ? URRConversionUtils::ConvertHandedness(FVector(
-                                                          InMesh->mNormals[i].x, InMesh->mNormals[i].y, InMesh->mNormals[i].z))
-                                                    : FVector::ZeroVector);
-
-        // [UVs] --
-        // UVs have already been flipped with [aiProcess_FlipUVs] flag
-        const aiVector3D* textureCoords = InMesh->mTextureCoords[0];
-        outMeshNodeData.UVs.Emplace(
-            textureCoords ? FVector2D(static_cast<double>(textureCoords[i].x), static_cast<double>(textureCoords[i].y))
-                          : FVector2D::ZeroVector);
-        outMeshNodeData.UV2fs.Emplace(FVector2f(outMeshNodeData.UVs.Last()));
-
-        // [Tangents] --
-        outMeshNodeData.ProcTangents.Emplace(
-            bHasTangents ? FProcMeshTangent(InMesh->mTangents[i].x, -InMesh->mTangents[i].y, InMesh->mTangents[i].z)
-                         : FProcMeshTangent());
+    // The interleaved vertices are allocated once, then filled by a separate tight loop per source stream
+    const int32 verticesNum = static_cast<int32>(InMesh->mNumVertices);
+    outMeshNodeData.Vertices.SetNum(verticesNum);
+    FRRMeshVertex* outVertices = outMeshNodeData.Vertices.GetData();
+
+    // Fetch mesh data, also Converting handedness from Assimp(right) ->UE (left), as URRConversionUtils::ConvertHandedness()
+    // [Vertices] --
+    const aiVector3D* vertices = InMesh->mVertices;
+    for (int32 i = 0; i < verticesNum; ++i)
+    {
+        outVertices[i].Position = FVector3f(vertices[i].x, -vertices[i].y, vertices[i].z);
+    }
+
+    // [VertexColors] --, only allocated if available
+    const aiColor4D* colors = InMesh->mColors[0];
+    if (colors)
+    {
+        outMeshNodeData.VertexColors.SetNumUninitialized(verticesNum);
+        FColor* outColors = outMeshNodeData.VertexColors.GetData();
+        for (int32 i = 0; i < verticesNum; ++i)
+        {
+            outColors[i] = FColor(colors[i].r, colors[i].g, colors[i].b, colors[i].a);
+        }
+    }
+
+    // [Normals] --
+    if (bHasNormals)
+    {
+        const aiVector3D* normals = InMesh->mNormals;
+        for (int32 i = 0; i < verticesNum; ++i)
+        {
+            outVertices[i].Normal = FPackedNormal(FVector3f(normals[i].x, -normals[i].y, normals[i].z));
+        }
+    }
+
+    // [UVs] --
+    // UVs have already been flipped with [aiProcess_FlipUVs] flag
+    const aiVector3D* textureCoords = InMesh->mTextureCoords[0];
+    if (textureCoords)
+    {
+        for (int32 i = 0; i < verticesNum; ++i)
+        {
+            outVertices[i].UV = FVector2f(textureCoords[i].x, textureCoords[i].y);
+        }
+    }
+
+    // [Tangents] --
+    if (bHasTangents)
+    {
+        const aiVector3D* tangents = InMesh->mTangents;
+        for (int32 i = 0; i < verticesNum; ++i)
+        {
+            outVertices[i].Tangent = FPackedNormal(FVector4f(tangents[i].x, -tangents[i].y, tangents[i].z, 1.f));
+        }
     }
 
     // [BoneInfluences] --
+    int32 boneWeightsNum = 0;
+    for (auto bi = 0; bi < InMesh->mNumBones; ++bi)
+    {
+        boneWeightsNum += InMesh->mBones[bi] ? InMesh->mBones[bi]->mNumWeights : 0;
+    }
+    outMeshNodeData.BoneInfluences.Reserve(boneWeightsNum);
     for (auto bi = 0; bi < InMesh->mNumBones; ++bi)
     {
         const auto& bone = InMesh->mBones[bi];
@@ -150,6 +216,8 @@ FRRMeshNodeData URRMeshUtils::ProcessMesh(aiMesh* InMesh)
 #if RAPYUTA_MESH_UTILS_DEBUG
         UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("mNumFaces: %u at %u"), InMesh->mNumFaces, InMesh->mFaces);
 #endif
+        // Faces are triangulated by [aiProcess_Triangulate]
+        outMeshNodeData.TriangleIndices.Reserve(3 * InMesh->mNumFaces);
         for (auto f = 0; f < InMesh->mNumFaces; ++f)
         {
             const aiFace& face = InMesh->mFaces[f];
@@ -178,7 +246,7 @@ bool URRMeshUtils::ProcessTexture(aiMaterial* InMaterial,
                                   const aiTextureType InTextureType,
                                   const TCHAR* InTextureTypeName,
                                   const FString& InTextureBasePath,
-                                  UMaterialInstanceDynamic* OutUEMaterial)
+                                  FRRMeshMaterialData& OutMaterialData)
 {
     static uint64 sTextureNameCount = 0;
 #if RAPYUTA_SIM_DEBUG
@@ -197,8 +265,7 @@ bool URRMeshUtils::ProcessTexture(aiMaterial* InMaterial,
             fullTexturePath, FString::Printf(TEXT("%d%s"), ++sTextureNameCount, InTextureTypeName));
         if (ueTexture != nullptr)
         {
-            URRThreadUtils::DoTaskInGameThread([OutUEMaterial, InTextureTypeName, ueTexture]()
-                                               { OutUEMaterial->SetTextureParameterValue(InTextureTypeName, ueTexture); });
+            OutMaterialData.TextureParams.Add(InTextureTypeName, ueTexture);
             return true;
         }
         else
@@ -227,61 +294,118 @@ void URRMeshUtils::ProcessMaterial(aiMaterial* InMaterial, const FString& InMesh
     static constexpr const TCHAR* MATERIAL_PARAM_NAME_METALLIC = TEXT("Metallic");
     static constexpr const TCHAR* MATERIAL_PARAM_NAME_ROUGHNESS = TEXT("Roughness");
 
-    URRGameSingleton* gameSingleton = URRGameSingleton::Get();
-    UMaterialInstanceDynamic* ueMaterial =
-        UMaterialInstanceDynamic::Create(gameSingleton->GetMaterial(URRGameSingleton::MATERIAL_NAME_PROP_MASTER), gameSingleton);
-
-#if RAPYUTA_SIM_DEBUG
-    const FString fullMeshPath = FPaths::GetPath(InMeshFilePath);
-    ProcessTexture(InMaterial, aiTextureType_BASE_COLOR, MATERIAL_PARAM_NAME_BASE_COLOR, fullMeshPath, ueMaterial);
-    ProcessTexture(InMaterial, aiTextureType_NORMALS, MATERIAL_PARAM_NAME_NORMAL, fullMeshPath, ueMaterial);
-    ProcessTexture(InMaterial, aiTextureType_AMBIENT, MATERIAL_PARAM_NAME_AMBIENT, fullMeshPath, ueMaterial);
-    ProcessTexture(InMaterial, aiTextureType_SPECULAR, MATERIAL_PARAM_NAME_SPECULAR, fullMeshPath, ueMaterial);
-    ProcessTexture(InMaterial, aiTextureType_EMISSION_COLOR, MATERIAL_PARAM_NAME_EMISSIVE, fullMeshPath, ueMaterial);
-    ProcessTexture(InMaterial, aiTextureType_METALNESS, MATERIAL_PARAM_NAME_METALLIC, fullMeshPath, ueMaterial);
-    ProcessTexture(InMaterial, aiTextureType_DIFFUSE_ROUGHNESS, MATERIAL_PARAM_NAME_ROUGHNESS, fullMeshPath, ueMaterial);
-#endif
-
     auto fToLinearColor = [](const aiColor4D& InColor)
     {
         // https://stackoverflow.com/questions/12524623/what-are-the-practical-differences-when-working-with-colors-in-a-linear-vs-a-no
         // [aiColor4D] is already in [0, 1]
         return FLinearColor(InColor.r, InColor.g, InColor.b, InColor.a);
     };
+    FRRMeshMaterialData materialData;
     aiColor4D color;
     if (AI_SUCCESS == InMaterial->Get(AI_MATKEY_COLOR_DIFFUSE, color))
     {
-        URRThreadUtils::DoTaskInGameThread([ueMaterial, linearColor = fToLinearColor(color)]()
-                                           { ueMaterial->SetVectorParameterValue(MATERIAL_PARAM_NAME_BASE_COLOR, linearColor); });
+        materialData.VectorParams.Add(MATERIAL_PARAM_NAME_BASE_COLOR, fToLinearColor(color));
     }
     if (AI_SUCCESS == InMaterial->Get(AI_MATKEY_COLOR_SPECULAR, color))
     {
-        URRThreadUtils::DoTaskInGameThread([ueMaterial, linearColor = fToLinearColor(color)]()
-                                           { ueMaterial->SetVectorParameterValue(MATERIAL_PARAM_NAME_SPECULAR, linearColor); });
+        materialData.VectorParams.Add(MATERIAL_PARAM_NAME_SPECULAR, fToLinearColor(color));
     }
     if (AI_SUCCESS == InMaterial->Get(AI_MATKEY_COLOR_EMISSIVE, color))
     {
-        URRThreadUtils::DoTaskInGameThread([ueMaterial, linearColor = fToLinearColor(color)]()
-                                           { ueMaterial->SetVectorParameterValue(MATERIAL_PARAM_NAME_EMISSIVE, linearColor); });
+        materialData.VectorParams.Add(MATERIAL_PARAM_NAME_EMISSIVE, fToLinearColor(color));
     }
     if (AI_SUCCESS == InMaterial->Get(AI_MATKEY_COLOR_REFLECTIVE, color))
     {
-        URRThreadUtils::DoTaskInGameThread(
-            [ueMaterial, linearColor = fToLinearColor(color)]()
-            { ueMaterial->SetVectorParameterValue(MATERIAL_PARAM_NAME_ROUGHNESS, FLinearColor::White - linearColor); });
+        materialData.VectorParams.Add(MATERIAL_PARAM_NAME_ROUGHNESS, FLinearColor::White - fToLinearColor(color));
     }
     if (AI_SUCCESS == InMaterial->Get(AI_MATKEY_COLOR_AMBIENT, color))
     {
-        URRThreadUtils::DoTaskInGameThread([ueMaterial, linearColor = fToLinearColor(color)]()
-                                           { ueMaterial->SetVectorParameterValue(MATERIAL_PARAM_NAME_AMBIENT, linearColor); });
+        materialData.VectorParams.Add(MATERIAL_PARAM_NAME_AMBIENT, fToLinearColor(color));
     }
 
-    // Add into [MaterialInstances]
-    OutMeshData.MaterialInstances.Add(ueMaterial);
+#if RAPYUTA_SIM_DEBUG
+    const FString fullMeshPath = FPaths::GetPath(InMeshFilePath);
+    ProcessTexture(InMaterial, aiTextureType_BASE_COLOR, MATERIAL_PARAM_NAME_BASE_COLOR, fullMeshPath, materialData);
+    ProcessTexture(InMaterial, aiTextureType_NORMALS, MATERIAL_PARAM_NAME_NORMAL, fullMeshPath, materialData);
+    ProcessTexture(InMaterial, aiTextureType_AMBIENT, MATERIAL_PARAM_NAME_AMBIENT, fullMeshPath, materialData);
+    ProcessTexture(InMaterial, aiTextureType_SPECULAR, MATERIAL_PARAM_NAME_SPECULAR, fullMeshPath, materialData);
+    ProcessTexture(InMaterial, aiTextureType_EMISSION_COLOR, MATERIAL_PARAM_NAME_EMISSIVE, fullMeshPath, materialData);
+    ProcessTexture(InMaterial, aiTextureType_METALNESS, MATERIAL_PARAM_NAME_METALLIC, fullMeshPath, materialData);
+    ProcessTexture(InMaterial, aiTextureType_DIFFUSE_ROUGHNESS, MATERIAL_PARAM_NAME_ROUGHNESS, fullMeshPath, materialData);
+#endif
+
+    // Add into [Materials] & [MaterialInstances], whose params are applied later along with all other materials'
+    OutMeshData.Materials.Add(MoveTemp(materialData));
+    OutMeshData.MaterialInstances.Add(CreateMaterialInstance());
 }
 
-FRRMeshData URRMeshUtils::LoadMeshFromFile(const FString& InMeshFilePath, Assimp::Importer& InMeshImporter, float InMeshScale)
+UMaterialInstanceDynamic* URRMeshUtils::CreateMaterialInstance()
 {
+    // Resolved from the resource snapshot, being run on mesh loader threads
+    URRGameSingleton* gameSingleton = URRGameSingleton::Get();
+    static const FName sMaterialNamePropMaster(URRGameSingleton::MATERIAL_NAME_PROP_MASTER);
+    UMaterialInstanceDynamic* ueMaterial = UMaterialInstanceDynamic::Create(
+        gameSingleton->FindSimResourceAnyThread<UMaterialInterface>(ERRResourceDataType::UE_MATERIAL, sMaterialNamePropMaster),
+        gameSingleton);
+    return ueMaterial;
+}
+
+void URRMeshUtils::ApplyMaterialParams(const FRRMeshData& InMeshData)
+{
+    if (InMeshData.MaterialInstances.Num() == 0)
+    {
+        return;
+    }
+
+    auto applyParams = [materialInstances = InMeshData.MaterialInstances, materials = InMeshData.Materials]()
+    {
+        for (auto i = 0; i < materialInstances.Num(); ++i)
+        {
+            for (const auto& param : materials[i].VectorParams)
+            {
+                materialInstances[i]->SetVectorParameterValue(param.Key, param.Value);
+            }
+            for (const auto& param : materials[i].TextureParams)
+            {
+                materialInstances[i]->SetTextureParameterValue(param.Key, param.Value);
+            }
+        }
+    };
+
+    if (IsInGameThread())
+    {
+        applyParams();
+    }
+    else
+    {
+        // Material setup of meshes loaded in parallel, budgeted on game thread
+        URRThreadUtils::EnqueueGameThreadJob(MoveTemp(applyParams), ERRGameThreadJobPriority::LOW);
+    }
+}
+
+FRRMeshData URRMeshUtils::LoadMeshFromFile(const FString& InMeshFilePath,
+                                            Assimp::Importer& InMeshImporter,
+                                            float InMeshScale,
+                                            const FRRMeshLODSettings& InLODSettings)
+{
+    return LoadMeshFromFileImpl(InMeshFilePath, &InMeshImporter, InMeshScale, InLODSettings);
+}
+
+FRRMeshData URRMeshUtils::LoadMeshFromFile(const FString& InMeshFilePath,
+                                            float InMeshScale,
+                                            const FRRMeshLODSettings& InLODSettings)
+{
+    return LoadMeshFromFileImpl(InMeshFilePath, nullptr, InMeshScale, InLODSettings);
+}
+
+FRRMeshData URRMeshUtils::LoadMeshFromFileImpl(const FString& InMeshFilePath,
+                                                Assimp::Importer* InMeshImporter,
+                                                float InMeshScale,
+                                                const FRRMeshLODSettings& InLODSettings)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRLoadMeshFromFile", RRAssetChannel);
+    FRRStartupPhaseScope startupPhaseScope(ERRStartupPhase::MESH_IMPORT);
+    LLM_SCOPE_BYTAG(RRMeshData);
     FRRMeshData outMeshData;
     if (false == FPaths::FileExists(InMeshFilePath))
     {
@@ -290,6 +414,47 @@ FRRMeshData URRMeshUtils::LoadMeshFromFile(const FString& InMeshFilePath, Assimp
         return outMeshData;
     }
 
+    // Mesh cache, holding the post-processed data of the same file content, scale & LODs
+    const FString cacheFilePath =
+        FRRMeshCache::IsEnabled() ? FRRMeshCache::GetCacheFilePath(InMeshFilePath, InMeshScale, InLODSettings) : FString();
+    if (!cacheFilePath.IsEmpty() && FRRMeshCache::Load(cacheFilePath, outMeshData))
+    {
+        for (auto i = 0; i < outMeshData.Materials.Num(); ++i)
+        {
+            outMeshData.MaterialInstances.Add(CreateMaterialInstance());
+        }
+        ApplyMaterialParams(outMeshData);
+        return outMeshData;
+    }
+
+    // [glTF] --, loaded natively unless using what only Assimp supports, eg Draco or sparse accessors
+    if (FRRGLTFLoader::IsGLTFFile(InMeshFilePath))
+    {
+        if (FRRGLTFLoader::Load(InMeshFilePath, InMeshScale, outMeshData))
+        {
+            FRRMeshSimplifier::GenerateLODs(InLODSettings, outMeshData);
+            for (auto i = 0; i < outMeshData.Materials.Num(); ++i)
+            {
+                outMeshData.MaterialInstances.Add(CreateMaterialInstance());
+            }
+            ApplyMaterialParams(outMeshData);
+            outMeshData.bIsValid = true;
+            if (!cacheFilePath.IsEmpty())
+            {
+                FRRMeshCache::Save(cacheFilePath, outMeshData);
+            }
+            return outMeshData;
+        }
+        outMeshData.Reset();
+    }
+
+    // Constructed only if needed, registering all Assimp importers
+    if (nullptr == InMeshImporter)
+    {
+        outMeshData.MeshImporter = MakeShared<Assimp::Importer>();
+    }
+    Assimp::Importer& meshImporter = InMeshImporter ? *InMeshImporter : *outMeshData.MeshImporter;
+
     // [scene] must be a const ptr as required by Assimp
     const aiScene* scene = nullptr;
     try
@@ -303,23 +468,23 @@ FRRMeshData URRMeshUtils::LoadMeshFromFile(const FString& InMeshFilePath, Assimp
 
         // Assimp(m) -> UE(cm), scaled by x100, which necessitates [aiProcess_GlobalScale]
         flags |= aiProcess_GlobalScale;
-        InMeshImporter.SetPropertyFloat(AI_CONFIG_GLOBAL_SCALE_FACTOR_KEY, 100.f * InMeshScale);
+        meshImporter.SetPropertyFloat(AI_CONFIG_GLOBAL_SCALE_FACTOR_KEY, 100.f * InMeshScale);
         if (InMeshFilePath.EndsWith(TEXT(".dae")))
         {
-            InMeshImporter.SetPropertyBool(AI_CONFIG_IMPORT_COLLADA_IGNORE_UP_DIRECTION, true);
+            meshImporter.SetPropertyBool(AI_CONFIG_IMPORT_COLLADA_IGNORE_UP_DIRECTION, true);
         }
 
 #if 0    // This is only required if the meshes are exported by Blender                                                           \
          // Rotate the mesh around X by -90                                                                                       \
-         // InMeshImporter.SetPropertyBool(AI_CONFIG_PP_PTV_ADD_ROOT_TRANSFORMATION, true);                                       \
+         // meshImporter.SetPropertyBool(AI_CONFIG_PP_PTV_ADD_ROOT_TRANSFORMATION, true);                                       \
          // const aiMatrix4x4 initialMeshTransform(aiVector3D(0.f, 0.f, 0.f), aiQuaternion(0.f, 0.f, -90.f), aiVector3D(0.f, 0.f, \
          // 0.f));                                                                                                                \
-         // InMeshImporter.SetPropertyMatrix(AI_CONFIG_PP_PTV_ROOT_TRANSFORMATION, initialMeshTransform);
+         // meshImporter.SetPropertyMatrix(AI_CONFIG_PP_PTV_ROOT_TRANSFORMATION, initialMeshTransform);
 #endif
 
         // Transform all meshes to World space, which necessitates [aiProcess_PreTransformVertices]
         flags |= aiProcess_PreTransformVertices;
-        InMeshImporter.SetPropertyBool(AI_CONFIG_PP_PTV_KEEP_HIERARCHY, true);
+        meshImporter.SetPropertyBool(AI_CONFIG_PP_PTV_KEEP_HIERARCHY, true);
 
         // https://github.com/assimp/assimp/issues/2093
         // http://wlosok.cz/procedural-mesh-in-ue4-1-triangle
@@ -333,7 +498,7 @@ FRRMeshData URRMeshUtils::LoadMeshFromFile(const FString& InMeshFilePath, Assimp
         // + [aiProcess_FlipWindingOrder] makes CW while UE has CCW vertice winding order already, which makes a face' normal
         // face outward. aiProcessPreset_TargetRealtime_Fast | aiProcessPreset_TargetRealtime_Quality
         scene =
-            InMeshImporter.ReadFile(URRCoreUtils::FToStdString(InMeshFilePath).c_str(),
+            meshImporter.ReadFile(URRCoreUtils::FToStdString(InMeshFilePath).c_str(),
                                     flags | (aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace | aiProcess_Triangulate |
                                              aiProcess_JoinIdenticalVertices | aiProcess_SortByPType | aiProcess_FindInvalidData));
     }
@@ -345,20 +510,20 @@ FRRMeshData URRMeshUtils::LoadMeshFromFile(const FString& InMeshFilePath, Assimp
 
     if (nullptr == scene)
     {
-        UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Error: %s - %s"), *FString(InMeshImporter.GetErrorString()), *InMeshFilePath);
+        UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Error: %s - %s"), *FString(meshImporter.GetErrorString()), *InMeshFilePath);
         return outMeshData;
     }
     else if (false == scene->HasMeshes())
     {
         UE_LOG_WITH_INFO(
-            LogRapyutaCore, Error, TEXT("Scene has no mesh: %s - %s"), *FString(InMeshImporter.GetErrorString()), *InMeshFilePath);
+            LogRapyutaCore, Error, TEXT("Scene has no mesh: %s - %s"), *FString(meshImporter.GetErrorString()), *InMeshFilePath);
         return outMeshData;
     }
     else if (nullptr == scene->mRootNode)
     {
         // (Note) [scene->mRootNode->mNumMeshes] could be zero but its children should also have meshes
         UE_LOG_WITH_INFO(
-            LogRapyutaCore, Error, TEXT("NULL ROOT NODE: %s - %s"), *FString(InMeshImporter.GetErrorString()), *InMeshFilePath);
+            LogRapyutaCore, Error, TEXT("NULL ROOT NODE: %s - %s"), *FString(meshImporter.GetErrorString()), *InMeshFilePath);
         return outMeshData;
     }
 
@@ -375,6 +540,9 @@ FRRMeshData URRMeshUtils::LoadMeshFromFile(const FString& InMeshFilePath, Assimp
     int* nodeIndexPtr = &nodeIndex;
     ProcessMeshNode(scene->mRootNode, scene, -1, nodeIndexPtr, outMeshData);
 
+    // [LODs] --, whose simplification is the reason for their caching
+    FRRMeshSimplifier::GenerateLODs(InLODSettings, outMeshData);
+
 #if RAPYUTA_MESH_UTILS_DEBUG
     UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("MATERIALS NUM: %d"), scene->mNumMaterials);
 #endif
@@ -386,11 +554,16 @@ FRRMeshData URRMeshUtils::LoadMeshFromFile(const FString& InMeshFilePath, Assimp
         {
             ProcessMaterial(scene->mMaterials[i], InMeshFilePath, outMeshData);
         }
+        ApplyMaterialParams(outMeshData);
     }
 
 #if RAPYUTA_MESH_UTILS_DEBUG
     UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("NODES NUM: %d"), outMeshData.Nodes.Num());
 #endif
     outMeshData.bIsValid = (outMeshData.Nodes.Num() > 0);
+    if (outMeshData.bIsValid && !cacheFilePath.IsEmpty())
+    {
+        FRRMeshCache::Save(cacheFilePath, outMeshData);
+    }
     return outMeshData;
 }
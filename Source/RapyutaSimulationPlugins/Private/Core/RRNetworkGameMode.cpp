@@ -2,21 +2,46 @@
 
 #include "Core/RRNetworkGameMode.h"
 
+// UE
+#include "Kismet/GameplayStatics.h"
+
 // RapyutaSimulationPlugins
 #include "Core/RRNetworkGameState.h"
 #include "Core/RRNetworkPlayerController.h"
+#include "Core/RRSpectatorPlayerController.h"
 #include "Tools/RRROS2SimulationStateClient.h"
 
 ARRNetworkGameMode::ARRNetworkGameMode()
 {
     GameStateClass = ARRNetworkGameState::StaticClass();
     PlayerControllerClass = ARRNetworkPlayerController::StaticClass();
+    SpectatorPlayerControllerClass = ARRSpectatorPlayerController::StaticClass();
+}
+
+APlayerController* ARRNetworkGameMode::SpawnPlayerController(ENetRole InRemoteRole, const FString& Options)
+{
+    if (SpectatorPlayerControllerClass && UGameplayStatics::HasOption(Options, ARRSpectatorPlayerController::SPECTATOR_OPTION))
+    {
+        return SpawnPlayerControllerCommon(
+            InRemoteRole, FVector::ZeroVector, FRotator::ZeroRotator, SpectatorPlayerControllerClass.Get());
+    }
+    return Super::SpawnPlayerController(InRemoteRole, Options);
 }
 
 void ARRNetworkGameMode::PostLogin(APlayerController* InPlayerController)
 {
     Super::PostLogin(InPlayerController);
 
+    if (auto* spectatorController = Cast<ARRSpectatorPlayerController>(InPlayerController))
+    {
+        // No ROS 2 sim state client nor clock sync, only entity snapshots
+        check(MainSimState);
+        spectatorController->ServerSimState = MainSimState;
+        spectatorController->StartSpectatingOnly();
+        UE_LOG_WITH_INFO(LogRapyutaCore, Log, TEXT("Logged-in spectator %s"), *spectatorController->GetName());
+        return;
+    }
+
     auto* networkPlayerController = CastChecked<ARRNetworkPlayerController>(InPlayerController);
 #if WITH_EDITOR
     FString pcName = (NetworkClientControllerList.Num() == 0)
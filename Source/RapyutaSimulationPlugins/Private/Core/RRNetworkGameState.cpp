@@ -4,6 +4,7 @@
 #include "Core/RRNetworkGameState.h"
 
 // RapyutaSimulationPlugins
+#include "Core/RRConversionUtils.h"
 #include "Core/RRNetworkPlayerController.h"
 
 ARRNetworkGameState::ARRNetworkGameState()
@@ -26,3 +27,16 @@ float ARRNetworkGameState::GetServerWorldTimeSeconds() const
         return GetWorld()->GetTimeSeconds();
     }
 }
+
+int64 ARRNetworkGameState::GetServerWorldTimeNanosec() const
+{
+    APlayerController* pc = GetGameInstance()->GetFirstLocalPlayerController(GetWorld());
+    if (pc && IsNetMode(NM_Client))
+    {
+        return CastChecked<ARRNetworkPlayerController>(pc)->GetLocalTimeNanosec();
+    }
+    else
+    {
+        return URRConversionUtils::GetWorldTimeNanosec(GetWorld());
+    }
+}
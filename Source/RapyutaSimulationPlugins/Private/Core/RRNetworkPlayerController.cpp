@@ -2,6 +2,8 @@
 #include "Core/RRNetworkPlayerController.h"
 
 // UE
+#include "GameFramework/GameStateBase.h"
+#include "HAL/IConsoleManager.h"
 #include "Kismet/GameplayStatics.h"
 #include "Math/Rotator.h"
 #include "Misc/CommandLine.h"
@@ -14,6 +16,7 @@
 
 // RapyutaSimulationPlugins
 #include "Core/RRActorCommon.h"
+#include "Core/RRConversionUtils.h"
 #include "Core/RRCoreUtils.h"
 #include "Core/RRUObjectUtils.h"
 #include "Robots/RRBaseRobot.h"
@@ -21,6 +24,45 @@
 #include "Tools/RRROS2SimulationStateClient.h"
 #include "Tools/SimulationState.h"
 
+static TAutoConsoleVariable<bool> CVarBatchRobotMovement(
+    TEXT("rr.NetworkPlayerController.BatchRobotMovement"),
+    true,
+    TEXT("Whether client robots' velocity commands are sent all together per frame in one unreliable RPC."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarRobotMovementSendsNum(
+    TEXT("rr.NetworkPlayerController.RobotMovementSendsNum"),
+    3,
+    TEXT("Number of consecutive batches a robot movement command is sent in, to tolerate lost unreliable batches."),
+    ECVF_Default);
+
+bool FRRRobotMovementCommand::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    bOutSuccess = true;
+    UObject* serverRobot = ServerRobot;
+    bOutSuccess &= Map->SerializeObject(Ar, ARRBaseRobot::StaticClass(), serverRobot);
+    ServerRobot = Cast<ARRBaseRobot>(serverRobot);
+
+    Ar << SequenceNum;
+    Ar << Flags;
+
+    bool bLocalSuccess = true;
+    if (Flags & FLAG_LINEAR)
+    {
+        Ar << LinearTimeStamp;
+        bOutSuccess &= ClientLocation.NetSerialize(Ar, Map, bLocalSuccess);
+        ClientLinearRotation.SerializeCompressedShort(Ar);
+        bOutSuccess &= LinearVel.NetSerialize(Ar, Map, bLocalSuccess);
+    }
+    if (Flags & FLAG_ANGULAR)
+    {
+        Ar << AngularTimeStamp;
+        ClientAngularRotation.SerializeCompressedShort(Ar);
+        bOutSuccess &= AngularVel.NetSerialize(Ar, Map, bLocalSuccess);
+    }
+    return true;
+}
+
 ARRNetworkPlayerController::ARRNetworkPlayerController()
 {
     bShowMouseCursor = true;
@@ -33,6 +75,7 @@ void ARRNetworkPlayerController::Tick(float DeltaSeconds)
 {
     Super::Tick(DeltaSeconds);
     UpdateLocalClock(DeltaSeconds);
+    FlushRobotMovementCommands();
 }
 
 void ARRNetworkPlayerController::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -129,7 +172,8 @@ void ARRNetworkPlayerController::BeginPlay()
     if (IsLocalController())
     {
         FTimerManager& timerManager = GetWorld()->GetTimerManager();
-        timerManager.SetTimer(ClockRequestTimerHandle, this, &ARRNetworkPlayerController::RequestServerTimeUpdate, 5.f, true);
+        timerManager.SetTimer(
+            ClockRequestTimerHandle, this, &ARRNetworkPlayerController::RequestServerTimeUpdate, ClockSyncIntervalSec, true);
 
         // Temporaryr hack to sync CameraManager to PlayerStarts sinc camera pose become (0,0,0) for multiplayer.
         if (IsNetMode(NM_Client))
@@ -151,26 +195,61 @@ void ARRNetworkPlayerController::ServerSetPlayerName_Implementation(const FStrin
 }
 
 // Client Requesting Server to send time, Client Clock at time of request is sent as well
-void ARRNetworkPlayerController::ServerRequestLocalClockUpdate_Implementation(float InClientRequestTime)
+void ARRNetworkPlayerController::ServerRequestLocalClockUpdate_Implementation(int64 InClientRequestTimeNanosec)
 {
-    float serverCurrentTime = UGameplayStatics::GetRealTimeSeconds(GetWorld());
-    ClientSendLocalClockUpdate(serverCurrentTime, InClientRequestTime);
+    // Server sim time, as returned by ARRNetworkGameState::GetServerWorldTimeNanosec() in the server
+    const int64 serverCurrentTimeNanosec = URRConversionUtils::GetWorldTimeNanosec(GetWorld());
+    ClientSendLocalClockUpdate(InClientRequestTimeNanosec, serverCurrentTimeNanosec);
 }
 
-void ARRNetworkPlayerController::ClientSendLocalClockUpdate_Implementation(float InServerCurrentTime, float InClientRequestTime)
+void ARRNetworkPlayerController::ClientSendLocalClockUpdate_Implementation(int64 InClientRequestTimeNanosec,
+                                                                           int64 InServerCurrentTimeNanosec)
 {
-    float clientRequestRoundTrip = LocalTime - InClientRequestTime;
-    float latencyAdjustedTime = InServerCurrentTime + (clientRequestRoundTrip * 0.5f);
-    LocalTime = latencyAdjustedTime;
+    FRRClockSyncSample sample;
+    sample.RoundTripNanosec = LocalTimeNanosec - InClientRequestTimeNanosec;
+    sample.OffsetNanosec = InServerCurrentTimeNanosec + sample.RoundTripNanosec / 2 - LocalTimeNanosec;
+    if (ClockSyncSamples.Num() >= FMath::Max(ClockSyncSamplesNum, 1))
+    {
+        ClockSyncSamples.RemoveAt(0, 1, false);
+    }
+    ClockSyncSamples.Add(sample);
 
-    GetWorld()->TimeSeconds = LocalTime;
+    // The sample of minimal round trip has the least asymmetric network delays, thus the most accurate offset
+    const FRRClockSyncSample* bestSample = &ClockSyncSamples[0];
+    for (const auto& clockSyncSample : ClockSyncSamples)
+    {
+        bestSample = (clockSyncSample.RoundTripNanosec < bestSample->RoundTripNanosec) ? &clockSyncSample : bestSample;
+    }
+
+    const int64 offsetNanosec = bestSample->OffsetNanosec;
+    if (!bClockSynced || (FMath::Abs(offsetNanosec) > static_cast<int64>(ClockStepThresholdSec * 1e+09)))
+    {
+        ShiftLocalClock(offsetNanosec);
+        PendingClockCorrectionNanosec = 0;
+        bClockSynced = true;
+    }
+    else
+    {
+        PendingClockCorrectionNanosec = offsetNanosec;
+    }
+}
+
+void ARRNetworkPlayerController::ShiftLocalClock(const int64 InShiftNanosec)
+{
+    LocalTimeNanosec += InShiftNanosec;
+    for (auto& sample : ClockSyncSamples)
+    {
+        sample.OffsetNanosec -= InShiftNanosec;
+    }
+    LocalTime = static_cast<float>(LocalTimeNanosec * 1e-09);
+    GetWorld()->TimeSeconds = LocalTimeNanosec * 1e-09;
 }
 
 void ARRNetworkPlayerController::RequestServerTimeUpdate()
 {
     if (IsLocalController())
     {
-        ServerRequestLocalClockUpdate(LocalTime);
+        ServerRequestLocalClockUpdate(LocalTimeNanosec);
     }
 }
 
@@ -178,7 +257,20 @@ void ARRNetworkPlayerController::UpdateLocalClock(float InDeltaSeconds)
 {
     if (IsLocalController())
     {
-        LocalTime += InDeltaSeconds;
+        LocalTimeNanosec += FMath::RoundToInt64(InDeltaSeconds * 1e+09);
+
+        // Slewing, thus never stepping backwards
+        const int64 maxSlewNanosec = FMath::RoundToInt64(FMath::Max(MaxClockSlewRate, 0.f) * InDeltaSeconds * 1e+09);
+        const int64 slewNanosec = FMath::Clamp(PendingClockCorrectionNanosec, -maxSlewNanosec, maxSlewNanosec);
+        PendingClockCorrectionNanosec -= slewNanosec;
+        if (bClockSynced && IsNetMode(NM_Client))
+        {
+            ShiftLocalClock(slewNanosec);
+        }
+        else
+        {
+            LocalTime = static_cast<float>(LocalTimeNanosec * 1e-09);
+        }
     }
 }
 
@@ -187,7 +279,7 @@ void ARRNetworkPlayerController::ReceivedPlayer()
     Super::ReceivedPlayer();
     if (IsLocalController())
     {
-        ServerRequestLocalClockUpdate(LocalTime);
+        ServerRequestLocalClockUpdate(LocalTimeNanosec);
     }
 }
 
@@ -195,6 +287,128 @@ void ARRNetworkPlayerController::ServerSetLinearVel_Implementation(ARRBaseRobot*
                                                                    float InClientTimeStamp,
                                                                    const FTransform& InClientRobotTransform,
                                                                    const FVector& InLinearVel)
+{
+    ApplyRobotLinearMovement(InServerRobot, InClientTimeStamp, InClientRobotTransform, InLinearVel);
+}
+
+void ARRNetworkPlayerController::ServerSetAngularVel_Implementation(ARRBaseRobot* InServerRobot,
+                                                                    float InClientTimeStamp,
+                                                                    const FRotator& InClientRobotRotation,
+                                                                    const FVector& InAngularVel)
+{
+    ApplyRobotAngularMovement(InServerRobot, InClientTimeStamp, InClientRobotRotation, InAngularVel);
+}
+
+bool ARRNetworkPlayerController::IsRobotMovementBatched()
+{
+    return CVarBatchRobotMovement.GetValueOnGameThread();
+}
+
+FRRRobotMovementCommand& ARRNetworkPlayerController::QueueRobotMovementCommand(ARRBaseRobot* InServerRobot)
+{
+    FRRRobotMovementCommand* command = RobotMovementCommands.FindByPredicate(
+        [InServerRobot](const FRRRobotMovementCommand& InCommand) { return InCommand.ServerRobot == InServerRobot; });
+    if (nullptr == command)
+    {
+        command = &RobotMovementCommands.AddDefaulted_GetRef();
+        command->ServerRobot = InServerRobot;
+    }
+    ++command->SequenceNum;
+    command->SendsLeftNum = FMath::Max(CVarRobotMovementSendsNum.GetValueOnGameThread(), 1);
+    return *command;
+}
+
+void ARRNetworkPlayerController::QueueRobotLinearMovement(ARRBaseRobot* InServerRobot,
+                                                          float InClientTimeStamp,
+                                                          const FTransform& InClientRobotTransform,
+                                                          const FVector& InLinearVel)
+{
+    FRRRobotMovementCommand& command = QueueRobotMovementCommand(InServerRobot);
+    command.Flags |= FRRRobotMovementCommand::FLAG_LINEAR;
+    command.LinearTimeStamp = InClientTimeStamp;
+    command.ClientLocation = InClientRobotTransform.GetTranslation();
+    command.ClientLinearRotation = InClientRobotTransform.Rotator();
+    command.LinearVel = InLinearVel;
+}
+
+void ARRNetworkPlayerController::QueueRobotAngularMovement(ARRBaseRobot* InServerRobot,
+                                                           float InClientTimeStamp,
+                                                           const FRotator& InClientRobotRotation,
+                                                           const FVector& InAngularVel)
+{
+    FRRRobotMovementCommand& command = QueueRobotMovementCommand(InServerRobot);
+    command.Flags |= FRRRobotMovementCommand::FLAG_ANGULAR;
+    command.AngularTimeStamp = InClientTimeStamp;
+    command.ClientAngularRotation = InClientRobotRotation;
+    command.AngularVel = InAngularVel;
+}
+
+void ARRNetworkPlayerController::FlushRobotMovementCommands()
+{
+    if (RobotMovementCommands.Num() == 0)
+    {
+        return;
+    }
+
+    TArray<FRRRobotMovementCommand> batch;
+    for (int32 i = RobotMovementCommands.Num() - 1; i >= 0; --i)
+    {
+        FRRRobotMovementCommand& command = RobotMovementCommands[i];
+        if (!IsValid(command.ServerRobot))
+        {
+            RobotMovementCommands.RemoveAtSwap(i, 1, false);
+            continue;
+        }
+        // Fully sent commands are kept, for their robots' sequence nums to keep on incrementing
+        if (command.SendsLeftNum > 0)
+        {
+            batch.Add(command);
+            --command.SendsLeftNum;
+        }
+    }
+
+    if (batch.Num() > 0)
+    {
+        ServerSetRobotsMovement(batch);
+    }
+}
+
+void ARRNetworkPlayerController::ServerSetRobotsMovement_Implementation(const TArray<FRRRobotMovementCommand>& InCommands)
+{
+    for (const auto& command : InCommands)
+    {
+        if (nullptr == command.ServerRobot)
+        {
+            continue;
+        }
+
+        // Sequence nums wrap around, a command being newer if ahead by less than half the range
+        uint16* appliedSequenceNum = AppliedRobotMovementSequenceNums.Find(command.ServerRobot);
+        if (appliedSequenceNum && (static_cast<int16>(command.SequenceNum - *appliedSequenceNum) <= 0))
+        {
+            continue;
+        }
+        AppliedRobotMovementSequenceNums.Add(command.ServerRobot, command.SequenceNum);
+
+        if (command.Flags & FRRRobotMovementCommand::FLAG_LINEAR)
+        {
+            ApplyRobotLinearMovement(command.ServerRobot,
+                                     command.LinearTimeStamp,
+                                     FTransform(command.ClientLinearRotation, command.ClientLocation),
+                                     command.LinearVel);
+        }
+        if (command.Flags & FRRRobotMovementCommand::FLAG_ANGULAR)
+        {
+            ApplyRobotAngularMovement(
+                command.ServerRobot, command.AngularTimeStamp, command.ClientAngularRotation, command.AngularVel);
+        }
+    }
+}
+
+void ARRNetworkPlayerController::ApplyRobotLinearMovement(ARRBaseRobot* InServerRobot,
+                                                          float InClientTimeStamp,
+                                                          const FTransform& InClientRobotTransform,
+                                                          const FVector& InLinearVel)
 {
     // todo: donot work with physics model. GetActoLocaion return constant values.
 #if RAPYUTA_SIM_DEBUG
@@ -204,18 +418,32 @@ void ARRNetworkPlayerController::ServerSetLinearVel_Implementation(ARRBaseRobot*
     auto* robot = Cast<ARRBaseRobot>(InServerRobot);
     if (robot)
     {
-        float serverCurrentTime = UGameplayStatics::GetRealTimeSeconds(GetWorld());
-        robot->SetActorLocation(InClientRobotTransform.GetTranslation() +
-                                InClientRobotTransform.GetRotation() * InLinearVel * (serverCurrentTime - InClientTimeStamp));
+        const FVector worldLinearVel = InClientRobotTransform.GetRotation() * InLinearVel;
+        if (robot->MovementReconciler)
+        {
+            FRRRobotMove move;
+            move.TimeStamp = InClientTimeStamp;
+            move.bHasLocation = true;
+            move.Location = InClientRobotTransform.GetTranslation();
+            move.LinearVel = worldLinearVel;
+            robot->MovementReconciler->AddClientMove(move);
+        }
+        else
+        {
+            // Client time stamps are in sim time
+            const float serverCurrentTime = GetWorld()->GetGameState()->GetServerWorldTimeSeconds();
+            robot->SetActorLocation(InClientRobotTransform.GetTranslation() +
+                                    worldLinearVel * (serverCurrentTime - InClientTimeStamp));
+        }
         //NOTE: Don't use ARRBaseRobot::SetLinearVel() here, which is only for client
         robot->TargetLinearVel = InLinearVel;
     }
 }
 
-void ARRNetworkPlayerController::ServerSetAngularVel_Implementation(ARRBaseRobot* InServerRobot,
-                                                                    float InClientTimeStamp,
-                                                                    const FRotator& InClientRobotRotation,
-                                                                    const FVector& InAngularVel)
+void ARRNetworkPlayerController::ApplyRobotAngularMovement(ARRBaseRobot* InServerRobot,
+                                                           float InClientTimeStamp,
+                                                           const FRotator& InClientRobotRotation,
+                                                           const FVector& InAngularVel)
 {
 #if RAPYUTA_SIM_DEBUG
     UE_LOG_WITH_INFO_NAMED(
@@ -224,9 +452,21 @@ void ARRNetworkPlayerController::ServerSetAngularVel_Implementation(ARRBaseRobot
     auto* robot = Cast<ARRBaseRobot>(InServerRobot);
     if (robot)
     {
-        float serverCurrentTime = UGameplayStatics::GetRealTimeSeconds(GetWorld());
-        robot->SetActorRotation(InClientRobotRotation +
-                                FRotator::MakeFromEuler(InAngularVel) * (serverCurrentTime - InClientTimeStamp));
+        if (robot->MovementReconciler)
+        {
+            FRRRobotMove move;
+            move.TimeStamp = InClientTimeStamp;
+            move.bHasRotation = true;
+            move.Rotation = InClientRobotRotation;
+            move.AngularVel = InAngularVel;
+            robot->MovementReconciler->AddClientMove(move);
+        }
+        else
+        {
+            const float serverCurrentTime = GetWorld()->GetGameState()->GetServerWorldTimeSeconds();
+            robot->SetActorRotation(InClientRobotRotation +
+                                    FRotator::MakeFromEuler(InAngularVel) * (serverCurrentTime - InClientTimeStamp));
+        }
         //NOTE: Don't use ARRBaseRobot::SetAngularVel() here, which is only for client
         robot->TargetAngularVel = InAngularVel;
     }
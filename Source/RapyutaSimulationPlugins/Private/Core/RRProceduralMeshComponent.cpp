@@ -8,17 +8,35 @@
 // UE
 #include "Async/Async.h"
 #include "DrawDebugHelpers.h"
+#include "HAL/IConsoleManager.h"
 #include "KismetProceduralMeshLibrary.h"
+#include "PhysicsEngine/BodySetup.h"
 #include "RenderUtils.h"
 
 // RapyutaSimulationPlugins
 #include "Core/RRActorCommon.h"
+#include "Core/RRBoundingBoxAnnotator.h"
 #include "Core/RRGameMode.h"
 #include "Core/RRGameSingleton.h"
 #include "Core/RRMeshActor.h"
 #include "Core/RRMeshData.h"
 #include "Core/RRMeshUtils.h"
+#include "Core/RRThreadUtils.h"
+#include "Core/RRTrace.h"
 #include "Core/RRUObjectUtils.h"
+#include "Tools/RRStartupProfiler.h"
+
+static TAutoConsoleVariable<bool> CVarProcMeshResizeByScale(
+    TEXT("rr.ProcMesh.ResizeByScale"),
+    false,
+    TEXT("Whether all procedural mesh components are resized by scale of shared unit-size shapes, as by bResizeByScale."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<bool> CVarProcMeshAnalyticCollision(
+    TEXT("rr.ProcMesh.AnalyticCollision"),
+    true,
+    TEXT("Whether primitive-shape procedural mesh components collide through analytic shapes, not cooked meshes."),
+    ECVF_Default);
 
 URRProceduralMeshComponent::URRProceduralMeshComponent(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
 {
@@ -39,7 +57,7 @@ void URRProceduralMeshComponent::Initialize(bool bIsStaticBody, bool bInIsPhysic
 
 bool URRProceduralMeshComponent::InitializeMesh(const FString& InMeshFileName)
 {
-    MeshUniqueName = URRUObjectUtils::ComposeDynamicResourceName(TEXT("PM"), *FPaths::GetBaseFilename(InMeshFileName));
+    MeshUniqueName = URRGameSingleton::GetMeshUniqueName(TEXT("PM"), InMeshFileName);
     ShapeType = URRGameSingleton::GetShapeTypeFromMeshName(InMeshFileName);
 
     switch (ShapeType)
@@ -56,6 +74,7 @@ bool URRProceduralMeshComponent::InitializeMesh(const FString& InMeshFileName)
             }
             else
             {
+                TRACE_COUNTER_INCREMENT(RRPendingAsyncMeshLoads);
                 Async(
 #if WITH_EDITOR
                     EAsyncExecution::LargeThreadPool,
@@ -64,23 +83,27 @@ bool URRProceduralMeshComponent::InitializeMesh(const FString& InMeshFileName)
 #endif
                     [this, InMeshFileName]()
                     {
-                        FRRMeshData runtimeMeshData;
-                        TSharedPtr<Assimp::Importer> meshImporter = MakeShared<Assimp::Importer>();
-                        runtimeMeshData = URRMeshUtils::LoadMeshFromFile(InMeshFileName, *meshImporter);
-                        runtimeMeshData.MeshImporter = meshImporter;
+                        FRRMeshData runtimeMeshData = URRMeshUtils::LoadMeshFromFile(InMeshFileName);
+                        TRACE_COUNTER_DECREMENT(RRPendingAsyncMeshLoads);
                         runtimeMeshData.MeshUniqueName = MeshUniqueName;
                         if (runtimeMeshData.IsValid())
                         {
-                            AsyncTask(ENamedThreads::GameThread,
-                                      [this, loadedMeshData = MoveTemp(runtimeMeshData)]() mutable
-                                      {
-                                          verify(loadedMeshData.IsValid());
-                                          // Create mesh body, signalling [OnMeshCreationDone()]
-                                          verify(CreateMeshBody(loadedMeshData));
-                                          // Save [loadedMeshData] to [FRRMeshData::MeshDataStore]
-                                          FRRMeshData::AddMeshData(MeshUniqueName,
-                                                                   MakeShared<FRRMeshData>(MoveTemp(loadedMeshData)));
-                                      });
+                            // Budgeted on game thread, thus amortized with other meshes' loaded at once
+                            URRThreadUtils::EnqueueGameThreadJob(
+                                [weakThis = TWeakObjectPtr<URRProceduralMeshComponent>(this),
+                                 loadedMeshData = MoveTemp(runtimeMeshData)]() mutable
+                                {
+                                    if (!weakThis.IsValid())
+                                    {
+                                        return;
+                                    }
+                                    verify(loadedMeshData.IsValid());
+                                    // Create mesh body, signalling [OnMeshCreationDone()]
+                                    verify(weakThis->CreateMeshBody(loadedMeshData));
+                                    // Save [loadedMeshData] to [FRRMeshData::MeshDataStore]
+                                    FRRMeshData::AddMeshData(weakThis->MeshUniqueName,
+                                                             MakeShared<FRRMeshData>(MoveTemp(loadedMeshData)));
+                                });
                         }
                     });
             }
@@ -104,6 +127,7 @@ bool URRProceduralMeshComponent::InitializeMesh(const FString& InMeshFileName)
 
 bool URRProceduralMeshComponent::CreateMeshBody(const FRRMeshData& InBodyMeshData)
 {
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRProcMeshCreateBody", RRAssetChannel);
     // (NOTE) This function is hooked up from an async task running in GameThread
     if (false == InBodyMeshData.IsValid())
     {
@@ -111,11 +135,21 @@ bool URRProceduralMeshComponent::CreateMeshBody(const FRRMeshData& InBodyMeshDat
         return false;
     }
 
+    URRGameSingleton* gameSingleton = URRGameSingleton::Get();
+    const FString bodySetupModelName = GetBodySetupModelName();
+    // A body setup of the same mesh, cooked or being cooked, is to be attached instead of cooking the same collision again
+    const bool bReuseBodySetup = gameSingleton->HasSimResource(ERRResourceDataType::UE_BODY_SETUP, bodySetupModelName);
+
     // VISUAL MESH DATA --
-    for (const auto& node : InBodyMeshData.Nodes)
     {
-        // (NOTE) This also invoke UpdateCollision() but without collision info yet
-        CreateMeshSection(node.Meshes);
+        // (NOTE) This also invoke UpdateCollision() but without collision info yet.
+        // If reusing a body setup, sections are created without collision & sync cooking, which has then nothing to cook,
+        // thus no async cooking gets kicked off only to be thrown away, its finish later replacing the reused body setup.
+        TGuardValue<bool> asyncCookingGuard(bUseAsyncCooking, bUseAsyncCooking && (false == bReuseBodySetup));
+        for (const auto& node : InBodyMeshData.Nodes)
+        {
+            CreateMeshSection(node.Meshes, false == bReuseBodySetup);
+        }
     }
 
     ARRMeshActor* ownerActor = CastChecked<ARRMeshActor>(GetOwner());
@@ -133,32 +167,28 @@ bool URRProceduralMeshComponent::CreateMeshBody(const FRRMeshData& InBodyMeshDat
     // MarkRenderDynamicDataDirty();
 
     // COLLISION MESH DATA --
-    URRGameSingleton* gameSingleton = URRGameSingleton::Get();
-    const FString bodySetupModelName = GetBodySetupModelName();
-
-    if (gameSingleton->HasSimResource(ERRResourceDataType::UE_BODY_SETUP, bodySetupModelName))
+    if (bReuseBodySetup)
     {
         // Wait for BodySetup[bodySetupModelName] has been fully cooked
-        URRCoreUtils::RegisterRepeatedExecution(
-            GetWorld(),
-            BodySetupTimerHandle,
-            [this, gameSingleton, bodySetupModelName]()
+        gameSingleton->WaitForDynamicResource(
+            ERRResourceDataType::UE_BODY_SETUP,
+            bodySetupModelName,
+            [weakThis = TWeakObjectPtr<URRProceduralMeshComponent>(this)](UObject* InBodySetup)
             {
-                UBodySetup* existentBodySetup = gameSingleton->GetBodySetup(bodySetupModelName);
+                if (!weakThis.IsValid())
+                {
+                    return;
+                }
+                UBodySetup* existentBodySetup = Cast<UBodySetup>(InBodySetup);
                 if (existentBodySetup)
                 {
                     verify(existentBodySetup->bCreatedPhysicsMeshes);
-                    // Stop the repeat timer first, note that this will invalidate all the captured variants except this
-                    URRCoreUtils::StopRegisteredExecution(GetWorld(), BodySetupTimerHandle);
-
                     // REUSE [existentBodySetup]
-                    ProcMeshBodySetup = existentBodySetup;
-                    RecreatePhysicsState();
-
-                    OnMeshCreationDone.ExecuteIfBound(true, this);
+                    weakThis->ProcMeshBodySetup = existentBodySetup;
+                    weakThis->RecreatePhysicsState();
                 }
-            },
-            0.01f);
+                weakThis->OnMeshCreationDone.ExecuteIfBound(nullptr != existentBodySetup, weakThis.Get());
+            });
         return true;
     }
     else
@@ -175,7 +205,7 @@ bool URRProceduralMeshComponent::CreateMeshBody(const FRRMeshData& InBodyMeshDat
         {
             for (const auto& mesh : node.Meshes)
             {
-                convexMeshes.Emplace(mesh.Vertices);
+                mesh.GetPositions(convexMeshes.AddDefaulted_GetRef());
             }
 #if RAPYUTA_SIM_DEBUG
             UE_LOG_WITH_INFO(LogRapyutaCore, Display, TEXT("Proc mesh-Convex Collision added: %d"), node.Meshes.Num());
@@ -185,7 +215,11 @@ bool URRProceduralMeshComponent::CreateMeshBody(const FRRMeshData& InBodyMeshDat
         // The current body setup will be updated to one created on-the-fly then,
         // thus its dynamically allocated collision data needs to be flushed first before registering new one
         GetBodySetup()->ClearPhysicsMeshes();
-        SetCollisionConvexMeshes(convexMeshes);
+        {
+            // Only cooking in sync, not async, is timed fully
+            FRRStartupPhaseScope startupPhaseScope(ERRStartupPhase::COLLISION_COOKING);
+            SetCollisionConvexMeshes(convexMeshes);
+        }
 
         // REGISTER [ProcMeshBodySetup] depending on ASYNC/SYNC Collision cooking
         if (bUseAsyncCooking)
@@ -230,12 +264,22 @@ void URRProceduralMeshComponent::FinalizeMeshBodyCreation(UBodySetup* InBodySetu
         URRGameSingleton::Get()->AddDynamicResource<UBodySetup>(
             ERRResourceDataType::UE_BODY_SETUP, InBodySetup, InBodySetupModelName);
     }
+    else
+    {
+        // Let the waiters for the same body setup fail also
+        URRGameSingleton::Get()->SignalDynamicResourceWaiters(ERRResourceDataType::UE_BODY_SETUP, InBodySetupModelName, nullptr);
+    }
     OnMeshCreationDone.ExecuteIfBound(bSuccessful, this);
 }
 
-void URRProceduralMeshComponent::CreateMeshSection(const TArray<FRRMeshNodeData>& InMeshSectionData)
+void URRProceduralMeshComponent::CreateMeshSection(const TArray<FRRMeshNodeData>& InMeshSectionData, bool bInCreateCollision)
 {
     uint32 meshSectionIndex = 0;
+    TArray<FVector> vertices;
+    TArray<FVector> normals;
+    TArray<FVector2D> uvs;
+    TArray<FColor> vertexColors;
+    TArray<FProcMeshTangent> tangents;
     for (auto& mesh : InMeshSectionData)
     {
         if (mesh.TriangleIndices.Num() == 0)
@@ -247,29 +291,25 @@ void URRProceduralMeshComponent::CreateMeshSection(const TArray<FRRMeshNodeData>
         UE_LOG_WITH_INFO_NAMED(
             LogRapyutaCore,
             Warning,
-            TEXT("CREATE PROCEDURAL MESH SECTION[%u]: Vertices(%u) - VertexColors(%u) - TriangleIndices(%u) - Normals(%u) - "
-                 "UVs(%u) - "
-                 "ProcTangents(%u) - "
+            TEXT("CREATE PROCEDURAL MESH SECTION[%u]: Vertices(%u) - VertexColors(%u) - TriangleIndices(%u) - "
                  "Material(%u)"),
             meshSectionIndex,
             mesh.Vertices.Num(),
             mesh.VertexColors.Num(),
             mesh.TriangleIndices.Num(),
-            mesh.Normals.Num(),
-            mesh.UVs.Num(),
-            mesh.ProcTangents.Num(),
             mesh.MaterialIndex);
 #endif
 
-        // Create Mesh Section
+        // Create Mesh Section, from the expanded compact mesh data
+        mesh.ToProcMeshSection(vertices, normals, uvs, vertexColors, tangents);
         Super::CreateMeshSection(meshSectionIndex,
-                                 mesh.Vertices,
+                                 vertices,
                                  mesh.TriangleIndices,
-                                 mesh.Normals,
-                                 mesh.UVs,
-                                 mesh.VertexColors,
-                                 mesh.ProcTangents,
-                                 bUseComplexAsSimpleCollision);
+                                 normals,
+                                 uvs,
+                                 vertexColors,
+                                 tangents,
+                                 bInCreateCollision && bUseComplexAsSimpleCollision);
         SetMeshSectionVisible(meshSectionIndex, true);
         meshSectionIndex++;
     }
@@ -311,16 +351,21 @@ bool URRProceduralMeshComponent::GetMeshData(FRRMeshData& OutMeshData, bool bFro
         {
             OutMeshData.bIsValid = true;
             FRRMeshNode meshNode;
+            TArray<FVector> vertices;
+            TArray<FVector> normals;
+            TArray<FVector2D> uvs;
+            TArray<FProcMeshTangent> tangents;
             for (auto i = 0; i < sectionsNum; ++i)
             {
                 FRRMeshNodeData section;
                 UKismetProceduralMeshLibrary::GetSectionFromProceduralMesh(
-                    this, i, section.Vertices, section.TriangleIndices, section.Normals, section.UVs, section.ProcTangents);
+                    this, i, vertices, section.TriangleIndices, normals, uvs, tangents);
 
-                for (auto& vertex : section.Vertices)
+                for (auto& vertex : vertices)
                 {
                     vertex = GetComponentTransform().TransformPosition(vertex);
                 }
+                section.FromProcMeshSection(vertices, normals, uvs, TArray<FColor>(), tangents);
                 meshNode.Meshes.Add(MoveTemp(section));
             }
             OutMeshData.Nodes.Emplace(MoveTemp(meshNode));
@@ -331,26 +376,115 @@ bool URRProceduralMeshComponent::GetMeshData(FRRMeshData& OutMeshData, bool bFro
 
 void URRProceduralMeshComponent::SetMeshSize(const FVector& InSize)
 {
+    if (bResizeByScale || CVarProcMeshResizeByScale.GetValueOnGameThread())
+    {
+        SetMeshSizeByScale(InSize);
+    }
+    else
+    {
+        CreatePrimitiveShapeMesh(InSize);
+    }
+    FRRBoundingBoxAnnotator::InvalidateLocalBounds(GetOwner());
+}
+
+FVector URRProceduralMeshComponent::GetUnitShapeSize() const
+{
+    switch (ShapeType)
+    {
+        case ERRShapeType::BOX:
+        case ERRShapeType::PLANE:
+            return FVector(UNIT_SHAPE_SIZE);
+
+        case ERRShapeType::CYLINDER:
+        case ERRShapeType::CAPSULE:
+        case ERRShapeType::SPHERE:
+        {
+            const UStaticMesh* staticMesh = URRGameSingleton::Get()->GetStaticMesh(MeshUniqueName);
+            return staticMesh ? staticMesh->GetBoundingBox().GetSize() : FVector::ZeroVector;
+        }
+
+        case ERRShapeType::MESH:
+            return (GetNumSections() > 0) ? CalcBounds(FTransform::Identity).GetBox().GetSize() : FVector::ZeroVector;
+
+        default:
+            return FVector::ZeroVector;
+    }
+}
+
+void URRProceduralMeshComponent::SetMeshSizeByScale(const FVector& InSize)
+{
+    const FVector unitSize = GetUnitShapeSize();
+    if ((unitSize.X <= 0.f) || (unitSize.Y <= 0.f) || (unitSize.Z <= 0.f))
+    {
+        UE_LOG_WITH_INFO_NAMED(LogRapyutaCore, Warning, TEXT("[%s] has no mesh to be resized yet"), *MeshUniqueName);
+        return;
+    }
+
+    if ((ERRShapeType::MESH != ShapeType) && (0 == GetNumSections()))
+    {
+        // Unit-size shape, cooked in sync being tiny
+        const bool bAsyncCooking = bUseAsyncCooking;
+        bUseAsyncCooking = false;
+        CreatePrimitiveShapeMesh(unitSize);
+        bUseAsyncCooking = bAsyncCooking;
+
+        // Body setup shared by all components of the same shape
+        URRGameSingleton* gameSingleton = URRGameSingleton::Get();
+        const FString bodySetupModelName = GetBodySetupModelName();
+        UBodySetup* sharedBodySetup = gameSingleton->GetBodySetup(bodySetupModelName);
+        if (sharedBodySetup && sharedBodySetup->bCreatedPhysicsMeshes)
+        {
+            ProcMeshBodySetup = sharedBodySetup;
+            RecreatePhysicsState();
+        }
+        else if (GetBodySetup()->bCreatedPhysicsMeshes && !GetBodySetup()->bFailedToCreatePhysicsMeshes)
+        {
+            GetBodySetup()->bSharedCookedData = true;
+            gameSingleton->AddDynamicResource<UBodySetup>(ERRResourceDataType::UE_BODY_SETUP, GetBodySetup(), bodySetupModelName);
+        }
+    }
+
+    // Collision geometry being scaled at query time
+    SetWorldScale3D(InSize / unitSize);
+}
+
+void URRProceduralMeshComponent::CreatePrimitiveShapeMesh(const FVector& InSize)
+{
+    // Sections then only provide visuals
+    const bool bAnalyticCollision = CVarProcMeshAnalyticCollision.GetValueOnGameThread();
+    if (bAnalyticCollision)
+    {
+        bUseComplexAsSimpleCollision = false;
+    }
+
     switch (ShapeType)
     {
         case ERRShapeType::BOX:
         case ERRShapeType::PLANE:
         {
             FRRMeshNodeData newNodeData;
-            UKismetProceduralMeshLibrary::GenerateBoxMesh(InSize / 2,
-                                                          newNodeData.Vertices,
-                                                          newNodeData.TriangleIndices,
-                                                          newNodeData.Normals,
-                                                          newNodeData.UVs,
-                                                          newNodeData.ProcTangents);
+            TArray<FVector> vertices;
+            TArray<FVector> normals;
+            TArray<FVector2D> uvs;
+            TArray<FProcMeshTangent> tangents;
+            UKismetProceduralMeshLibrary::GenerateBoxMesh(
+                InSize / 2, vertices, newNodeData.TriangleIndices, normals, uvs, tangents);
+            newNodeData.FromProcMeshSection(vertices, normals, uvs, TArray<FColor>(), tangents);
 
             // Create new mesh section
             ClearAllMeshSections();
             CreateMeshSection({newNodeData});
             SetMeshSectionVisible(0, true);
 
-            // Also new collision convex mesh
-            Super::SetCollisionConvexMeshes({newNodeData.Vertices});
+            if (bAnalyticCollision)
+            {
+                CreatePrimitiveShapeCollision(InSize, FVector::ZeroVector);
+            }
+            else
+            {
+                // Also new collision convex mesh
+                Super::SetCollisionConvexMeshes({vertices});
+            }
         }
         break;
 
@@ -364,14 +498,84 @@ void URRProceduralMeshComponent::SetMeshSize(const FVector& InSize)
                 nullptr, FString::Printf(TEXT("%sSM%d"), *GetName(), ++sCount));
             UStaticMesh* staticMesh = URRGameSingleton::Get()->GetStaticMesh(MeshUniqueName);
             tempStaticMeshComp->SetStaticMesh(staticMesh);
-            tempStaticMeshComp->SetWorldScale3D(InSize / staticMesh->GetBoundingBox().GetSize());
+            const FVector scale = InSize / staticMesh->GetBoundingBox().GetSize();
+            tempStaticMeshComp->SetWorldScale3D(scale);
 
             // Get geom data from static mesh
-            UKismetProceduralMeshLibrary::CopyProceduralMeshFromStaticMeshComponent(tempStaticMeshComp, 0, this, true);
+            UKismetProceduralMeshLibrary::CopyProceduralMeshFromStaticMeshComponent(
+                tempStaticMeshComp, 0, this, !bAnalyticCollision);
+            if (bAnalyticCollision)
+            {
+                CreatePrimitiveShapeCollision(InSize, staticMesh->GetBoundingBox().GetCenter() * scale);
+            }
             break;
     }
 }
 
+void URRProceduralMeshComponent::CreatePrimitiveShapeCollision(const FVector& InSize, const FVector& InCenter)
+{
+    UBodySetup* bodySetup = GetBodySetup();
+    bodySetup->AggGeom.EmptyElements();
+    TArray<TArray<FVector>> convexMeshes;
+    switch (ShapeType)
+    {
+        case ERRShapeType::BOX:
+        case ERRShapeType::PLANE:
+        {
+            FKBoxElem box(InSize.X, InSize.Y, InSize.Z);
+            box.Center = InCenter;
+            bodySetup->AggGeom.BoxElems.Add(box);
+        }
+        break;
+
+        case ERRShapeType::SPHERE:
+        {
+            FKSphereElem sphere(0.5f * InSize.GetMin());
+            sphere.Center = InCenter;
+            bodySetup->AggGeom.SphereElems.Add(sphere);
+        }
+        break;
+
+        case ERRShapeType::CAPSULE:
+        {
+            const float radius = 0.5f * FMath::Min(InSize.X, InSize.Y);
+            FKSphylElem capsule(radius, FMath::Max(InSize.Z - 2.f * radius, 0.f));
+            capsule.Center = InCenter;
+            bodySetup->AggGeom.SphylElems.Add(capsule);
+        }
+        break;
+
+        case ERRShapeType::CYLINDER:
+        {
+            TArray<FVector>& vertices = convexMeshes.AddDefaulted_GetRef();
+            vertices.Reserve(2 * CYLINDER_COLLISION_SIDES_NUM);
+            for (int32 i = 0; i < CYLINDER_COLLISION_SIDES_NUM; ++i)
+            {
+                float sinAngle = 0.f, cosAngle = 0.f;
+                FMath::SinCos(&sinAngle, &cosAngle, 2.f * PI * i / CYLINDER_COLLISION_SIDES_NUM);
+                const FVector rim(0.5f * InSize.X * cosAngle, 0.5f * InSize.Y * sinAngle, 0.5f * InSize.Z);
+                vertices.Add(InCenter + rim);
+                vertices.Add(InCenter + FVector(rim.X, rim.Y, -rim.Z));
+            }
+        }
+        break;
+
+        default:
+            break;
+    }
+
+    // Analytic shapes have nothing to cook & the cylinder hull is tiny, thus created in sync, also since async cooking
+    // would create a new body setup without the shapes above
+    {
+        TGuardValue<bool> asyncCookingGuard(bUseAsyncCooking, false);
+        Super::SetCollisionConvexMeshes(convexMeshes);
+    }
+
+    // No triangle mesh to trace against, complex traces such as lidars' ones also hitting the shapes
+    GetBodySetup()->CollisionTraceFlag = CTF_UseSimpleAsComplex;
+    RecreatePhysicsState();
+}
+
 void URRProceduralMeshComponent::SetCollisionModeAvailable(bool bIsOn, bool bIsHitEventEnabled)
 {
     if (bIsOn)
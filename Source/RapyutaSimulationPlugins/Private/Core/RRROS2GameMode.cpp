@@ -10,9 +10,20 @@
 #include "ROS2NodeComponent.h"
 
 // RapyutaSimulationPlugins
+#include "Core/RRCoreUtils.h"
+#include "Core/RRCrowdROS2Bridge.h"
 #include "Core/RRNetworkGameMode.h"
+#include "Core/RRROS2InterfacePool.h"
+#include "Core/RRROS2NodePool.h"
 #include "Tools/RRGhostPlayerPawn.h"
+#include "Tools/RRInputReplay.h"
+#include "Tools/RRLockstepCustomTimeStep.h"
+#include "Tools/RRMcapRecorder.h"
 #include "Tools/RRROS2ClockPublisher.h"
+#include "Tools/RRROS2MemoryStatsPublisher.h"
+#include "Tools/RRROS2SensorDiagnosticsPublisher.h"
+#include "Tools/RRROS2StartupProfilePublisher.h"
+#include "Tools/RRROS2TFAggregatePublisher.h"
 
 ARRROS2GameMode::ARRROS2GameMode()
 {
@@ -90,20 +101,145 @@ void ARRROS2GameMode::InitROS2()
     ClockPublisher =
         CastChecked<URRROS2ClockPublisher>(MainROS2Node->CreatePublisherWithClass(URRROS2ClockPublisher::StaticClass()));
 
+    // Lockstep stepping service & controller acks, only if the engine custom time step is the lockstep one
+    if (auto* lockstepTimeStep = Cast<URRLockstepCustomTimeStep>(GEngine->GetCustomTimeStep()))
+    {
+        lockstepTimeStep->InitROS2(MainROS2Node);
+    }
+
+    // Create sensor diagnostics publisher
+    if (bPublishSensorDiagnostics)
+    {
+        SensorDiagnosticsPublisher = CastChecked<URRROS2SensorDiagnosticsPublisher>(
+            MainROS2Node->CreatePublisherWithClass(URRROS2SensorDiagnosticsPublisher::StaticClass()));
+    }
+
+    // Create startup profile publisher
+    if (bPublishStartupProfile)
+    {
+        StartupProfilePublisher = CastChecked<URRROS2StartupProfilePublisher>(
+            MainROS2Node->CreatePublisherWithClass(URRROS2StartupProfilePublisher::StaticClass()));
+    }
+
+    // Create memory stats publisher
+    if (bPublishMemoryStats)
+    {
+        MemoryStatsPublisher = CastChecked<URRROS2MemoryStatsPublisher>(
+            MainROS2Node->CreatePublisherWithClass(URRROS2MemoryStatsPublisher::StaticClass()));
+    }
+
+    // Create TF aggregate publishers, which TF publishers submit to upon their timer, regardless of being inited before
+    if (bAggregateTF)
+    {
+        TFAggregatePublisher = NewObject<URRROS2TFAggregatePublisher>(this, TEXT("TFAggregatePublisher"));
+        MainROS2Node->AddPublisher(TFAggregatePublisher);
+        StaticTFAggregatePublisher = NewObject<URRROS2TFAggregatePublisher>(this, TEXT("StaticTFAggregatePublisher"));
+        StaticTFAggregatePublisher->IsStatic = true;
+        MainROS2Node->AddPublisher(StaticTFAggregatePublisher);
+    }
+
+    // Crowd agents possessed before ROS 2 initialization
+    if (CrowdROS2Bridge)
+    {
+        CrowdROS2Bridge->InitROS2(MainROS2Node);
+    }
+
     // Signal [OnROS2Initialized]
     OnROS2Initialized.Broadcast();
 }
 
+URRCrowdROS2Bridge* ARRROS2GameMode::GetCrowdROS2Bridge()
+{
+    if (nullptr == CrowdROS2Bridge)
+    {
+        CrowdROS2Bridge = NewObject<URRCrowdROS2Bridge>(this, TEXT("CrowdROS2Bridge"));
+        if (IsValid(MainROS2Node))
+        {
+            CrowdROS2Bridge->InitROS2(MainROS2Node);
+        }
+    }
+    return CrowdROS2Bridge;
+}
+
+URRROS2NodePool* ARRROS2GameMode::GetRobotROS2NodePool()
+{
+    if ((nullptr == RobotROS2NodePool) && (RobotROS2NodePoolSize > 0))
+    {
+        RobotROS2NodePool = NewObject<URRROS2NodePool>(this, TEXT("RobotROS2NodePool"));
+        RobotROS2NodePool->NodesNum = RobotROS2NodePoolSize;
+    }
+    return RobotROS2NodePool;
+}
+
+URRROS2InterfacePool* ARRROS2GameMode::GetRobotROS2InterfacePool()
+{
+    if ((nullptr == RobotROS2InterfacePool) && (RobotROS2InterfacePoolSize > 0))
+    {
+        RobotROS2InterfacePool = NewObject<URRROS2InterfacePool>(this, TEXT("RobotROS2InterfacePool"));
+        RobotROS2InterfacePool->InterfacesNum = RobotROS2InterfacePoolSize;
+    }
+    return RobotROS2InterfacePool;
+}
+
 void ARRROS2GameMode::StartPlay()
 {
     Super::StartPlay();
+    URRCoreUtils::ApplyHeadlessSensorMode(this);
 
     // Init Sim main components
     InitSim();
+    InitInputReplay();
+    InitMcapRecord();
 
     UE_LOG_WITH_INFO(LogRapyutaCore, Display, TEXT("START PLAY!"));
 }
 
+void ARRROS2GameMode::EndPlay(const EEndPlayReason::Type InEndPlayReason)
+{
+    if (InputReplay)
+    {
+        InputReplay->Stop();
+    }
+    if (FRRMcapRecorder::IsRecording())
+    {
+        FRRMcapRecorder::Get().StopRecording();
+    }
+    Super::EndPlay(InEndPlayReason);
+}
+
+void ARRROS2GameMode::InitInputReplay()
+{
+    FString filePath;
+    if (FParse::Value(FCommandLine::Get(), TEXT("RRInputRecord="), filePath))
+    {
+        InputReplayMode = ERRInputReplayMode::RECORD;
+        InputReplayFilePath = filePath;
+    }
+    else if (FParse::Value(FCommandLine::Get(), TEXT("RRInputReplay="), filePath))
+    {
+        InputReplayMode = ERRInputReplayMode::REPLAY;
+        InputReplayFilePath = filePath;
+    }
+
+    if ((ERRInputReplayMode::NONE != InputReplayMode) && !InputReplayFilePath.IsEmpty())
+    {
+        InputReplay = NewObject<URRInputReplay>(this);
+        if (!InputReplay->Start(MainSimState, InputReplayMode, InputReplayFilePath))
+        {
+            InputReplay = nullptr;
+        }
+    }
+}
+
+void ARRROS2GameMode::InitMcapRecord()
+{
+    FParse::Value(FCommandLine::Get(), TEXT("RRRecord="), McapRecordFilePath);
+    if (!McapRecordFilePath.IsEmpty() && !FRRMcapRecorder::Get().StartRecording(McapRecordFilePath))
+    {
+        McapRecordFilePath.Empty();
+    }
+}
+
 void ARRROS2GameMode::SetFixedTimeStep(const float InStepSize)
 {
     auto ct = Cast<URRLimitRTFFixedSizeCustomTimeStep>(GEngine->GetCustomTimeStep());
@@ -0,0 +1,91 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRROS2InterfacePool.h"
+
+// rclUE
+#include "ROS2NodeComponent.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRCoreUtils.h"
+#include "Core/RRROS2NodePool.h"
+#include "Robots/RRBaseRobot.h"
+#include "Robots/RRRobotROS2Interface.h"
+#include "Sensors/RRROS2BaseSensorComponent.h"
+
+namespace
+{
+constexpr ERenameFlags GRenameFlags = REN_DontCreateRedirectors | REN_DoNotDirty | REN_NonTransactional;
+}    // namespace
+
+bool URRROS2InterfacePool::Park(ARRBaseRobot* InRobot)
+{
+    URRRobotROS2Interface* ros2Interface = InRobot ? InRobot->ROS2Interface : nullptr;
+    if ((nullptr == ros2Interface) || !IsValid(ros2Interface->RobotROS2Node) ||
+        URRROS2NodePool::IsPooled(ros2Interface->RobotROS2Node) || (ParkedInterfaces.Num() >= InterfacesNum))
+    {
+        return false;
+    }
+
+    const FString& key = ros2Interface->PoolKey;
+    if (key.IsEmpty() || ParkedInterfaces.Contains(key))
+    {
+        return false;
+    }
+
+    // Sensor publishers are owned by the robot's sensors, thus taken over before they are destroyed along with it
+    ros2Interface->ParkSensorPublishers(InRobot);
+    ros2Interface->DeInitialize();
+    ros2Interface->OdomComponent = nullptr;
+    ros2Interface->ROSSpawnParameters = nullptr;
+    ros2Interface->Rename(nullptr, this, GRenameFlags);
+    InRobot->ROS2Interface = nullptr;
+    ParkedInterfaces.Add(key, ros2Interface);
+
+    UE_LOG_WITH_INFO(LogRapyutaCore,
+                     Verbose,
+                     TEXT("ROS 2 interface of %s parked with %d sensor publishers"),
+                     *InRobot->GetName(),
+                     ros2Interface->ParkedSensorPublishers.Num());
+    return true;
+}
+
+URRRobotROS2Interface* URRROS2InterfacePool::Acquire(const FString& InKey, ARRBaseRobot* InRobot)
+{
+    URRRobotROS2Interface* ros2Interface = nullptr;
+    if ((nullptr == InRobot) || !ParkedInterfaces.RemoveAndCopyValue(InKey, ros2Interface) || !IsValid(ros2Interface))
+    {
+        return nullptr;
+    }
+
+    ros2Interface->Rename(nullptr, InRobot, GRenameFlags);
+    ros2Interface->bRecycled = true;
+
+    UE_LOG_WITH_INFO(LogRapyutaCore, Verbose, TEXT("ROS 2 interface recycled for %s"), *InRobot->GetName());
+    return ros2Interface;
+}
+
+bool URRROS2InterfacePool::IsParked(const URRRobotROS2Interface* InInterface)
+{
+    return InInterface && InInterface->GetOuter() && InInterface->GetOuter()->IsA<URRROS2InterfacePool>();
+}
+
+FString URRROS2InterfacePool::MakeKey(const ARRBaseRobot* InRobot)
+{
+    TArray<FString> topicNames;
+    TInlineComponentArray<URRROS2BaseSensorComponent*> sensorComponents(InRobot);
+    for (const URRROS2BaseSensorComponent* sensorComp : sensorComponents)
+    {
+        topicNames.Add(sensorComp->TopicName);
+    }
+    topicNames.Sort();
+
+    FString ns = InRobot->ROSSpawnParameters ? InRobot->ROSSpawnParameters->GetNamespace() : InRobot->RobotUniqueName;
+    if (InRobot->ActorCommon)
+    {
+        ns = InRobot->ActorCommon->GetSceneROSNamespace(ns);
+    }
+    return FString::Printf(TEXT("%s|%s|%s"),
+                           *ns,
+                           InRobot->ROS2InterfaceClass ? *InRobot->ROS2InterfaceClass->GetPathName() : TEXT(""),
+                           *FString::Join(topicNames, TEXT(",")));
+}
@@ -0,0 +1,78 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRROS2NodePool.h"
+
+// rclUE
+#include "ROS2NodeComponent.h"
+
+// RapyutaSimulationPlugins
+#include "RapyutaSimulationPlugins.h"
+#include "Robots/RRBaseRobot.h"
+#include "Robots/RRRobotROS2Interface.h"
+
+UROS2NodeComponent* URRROS2NodePool::Acquire()
+{
+    int32 index = INDEX_NONE;
+    if (Nodes.Num() < FMath::Max(NodesNum, 1))
+    {
+        UROS2NodeComponent* node = NewObject<UROS2NodeComponent>(this);
+        node->Name = FString::Printf(TEXT("%s_%d"), *NodeNamePrefix, Nodes.Num());
+        node->Namespace.Reset();
+        node->Init();
+        index = Nodes.Add(node);
+        UsersNums.Add(0);
+        UE_LOG_WITH_INFO(LogRapyutaCore, Display, TEXT("Pooled ROS 2 node %s created"), *node->Name);
+    }
+    else
+    {
+        index = 0;
+        for (int32 i = 1; i < UsersNums.Num(); ++i)
+        {
+            if (UsersNums[i] < UsersNums[index])
+            {
+                index = i;
+            }
+        }
+    }
+    ++UsersNums[index];
+    return Nodes[index];
+}
+
+void URRROS2NodePool::Release(UROS2NodeComponent* InNode)
+{
+    const int32 index = Nodes.Find(InNode);
+    if (INDEX_NONE != index)
+    {
+        UsersNums[index] = FMath::Max(UsersNums[index] - 1, 0);
+    }
+}
+
+bool URRROS2NodePool::IsPooled(const UROS2NodeComponent* InNode)
+{
+    return InNode && InNode->GetOuter() && InNode->GetOuter()->IsA<URRROS2NodePool>();
+}
+
+FString URRROS2NodePool::GetNamespace(const UROS2NodeComponent* InNode, const UObject* InUser)
+{
+    if (!IsPooled(InNode))
+    {
+        return InNode ? InNode->Namespace : FString();
+    }
+
+    const ARRBaseRobot* robot = Cast<ARRBaseRobot>(InUser);
+    if ((nullptr == robot) && InUser)
+    {
+        robot = InUser->GetTypedOuter<ARRBaseRobot>();
+    }
+    return (robot && robot->ROS2Interface) ? robot->ROS2Interface->RobotNamespace : FString();
+}
+
+FString URRROS2NodePool::GetTopicName(const UROS2NodeComponent* InNode, const UObject* InUser, const FString& InTopicName)
+{
+    if (!IsPooled(InNode) || InTopicName.StartsWith(TEXT("/")))
+    {
+        return InTopicName;
+    }
+    const FString ns = GetNamespace(InNode, InUser);
+    return ns.IsEmpty() ? InTopicName : FString::Printf(TEXT("/%s/%s"), *ns.TrimChar(TEXT('/')), *InTopicName);
+}
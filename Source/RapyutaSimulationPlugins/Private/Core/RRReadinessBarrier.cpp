@@ -0,0 +1,114 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRReadinessBarrier.h"
+
+// RapyutaSimulationPlugins
+#include "RapyutaSimulationPlugins.h"
+
+void FRRReadinessBarrier::Reset()
+{
+    Dependencies.Reset();
+    PendingNum = 0;
+    StartTime = 0.;
+    OnReady.Reset();
+    bArmed = false;
+    bFired = false;
+}
+
+void FRRReadinessBarrier::AddDependency(const FName& InDependency)
+{
+    check(IsInGameThread());
+    if (StartTime <= 0.)
+    {
+        StartTime = FPlatformTime::Seconds();
+    }
+    if (false == Dependencies.Contains(InDependency))
+    {
+        Dependencies.Add(InDependency, -1.);
+        ++PendingNum;
+    }
+}
+
+void FRRReadinessBarrier::Signal(const FName& InDependency)
+{
+    check(IsInGameThread());
+    double* resolveTime = Dependencies.Find(InDependency);
+    if (nullptr == resolveTime)
+    {
+        UE_LOG_WITH_INFO(
+            LogRapyutaCore, Warning, TEXT("[%s] Unknown dependency [%s] signalled"), *Name, *InDependency.ToString());
+        return;
+    }
+    if (*resolveTime >= 0.)
+    {
+        return;
+    }
+    *resolveTime = GetElapsedSeconds();
+    --PendingNum;
+    UE_LOG_WITH_INFO(LogRapyutaCore,
+                     Display,
+                     TEXT("[%s] [%s] ready after %.1fms, %d pending"),
+                     *Name,
+                     *InDependency.ToString(),
+                     *resolveTime * 1000.,
+                     PendingNum);
+    TryFire();
+}
+
+void FRRReadinessBarrier::Arm(TUniqueFunction<void()>&& InOnReady)
+{
+    check(IsInGameThread());
+    if (StartTime <= 0.)
+    {
+        StartTime = FPlatformTime::Seconds();
+    }
+    OnReady = MoveTemp(InOnReady);
+    bArmed = true;
+    bFired = false;
+    TryFire();
+}
+
+TArray<FName> FRRReadinessBarrier::GetPendingDependencies() const
+{
+    TArray<FName> pendingDependencies;
+    for (const auto& dependency : Dependencies)
+    {
+        if (dependency.Value < 0.)
+        {
+            pendingDependencies.Add(dependency.Key);
+        }
+    }
+    return pendingDependencies;
+}
+
+double FRRReadinessBarrier::GetElapsedSeconds() const
+{
+    return (StartTime > 0.) ? (FPlatformTime::Seconds() - StartTime) : 0.;
+}
+
+FString FRRReadinessBarrier::ToString() const
+{
+    FString result = FString::Printf(TEXT("[%s] %.1fms:"), *Name, GetElapsedSeconds() * 1000.);
+    for (const auto& dependency : Dependencies)
+    {
+        const FString dependencyName = dependency.Key.ToString();
+        result += (dependency.Value < 0.) ? FString::Printf(TEXT(" %s=pending"), *dependencyName)
+                                          : FString::Printf(TEXT(" %s=%.1fms"), *dependencyName, dependency.Value * 1000.);
+    }
+    return result;
+}
+
+void FRRReadinessBarrier::TryFire()
+{
+    if (IsReady() && !bFired)
+    {
+        bFired = true;
+        UE_LOG_WITH_INFO(LogRapyutaCore, Display, TEXT("%s -> READY"), *ToString());
+        // Moved out as the action may reset or re-arm this barrier
+        TUniqueFunction<void()> onReady = MoveTemp(OnReady);
+        if (onReady)
+        {
+            onReady();
+        }
+    }
+}
@@ -0,0 +1,113 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRReplicationGraph.h"
+
+// UE
+#include "Engine/NetConnection.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRSpectatorPlayerController.h"
+#include "Robots/RRBaseRobot.h"
+#include "Robots/RRRobotROS2Interface.h"
+#include "Tools/ROS2Spawnable.h"
+
+void URRReplicationGraphNode_ConnectionRobots::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+    if (nullptr == Graph)
+    {
+        return;
+    }
+
+    const uint32 updateInterval = static_cast<uint32>(FMath::Max(Graph->RobotsUpdateIntervalFrames, 1));
+    if ((0 == LastUpdateFrame) || (Params.ReplicationFrameNum - LastUpdateFrame >= updateInterval))
+    {
+        LastUpdateFrame = FMath::Max(Params.ReplicationFrameNum, 1u);
+
+        const UNetConnection* connection = Params.ConnectionManager.NetConnection;
+        const APlayerController* playerController = connection ? connection->PlayerController : nullptr;
+        const APlayerState* playerState = playerController ? playerController->PlayerState : nullptr;
+        const int32 playerId = playerState ? playerState->GetPlayerId() : INDEX_NONE;
+        const bool bSpectator = (nullptr != Cast<ARRSpectatorPlayerController>(playerController));
+
+        const float nearDistance = Graph->RobotsNearDistance;
+        const float farDistance = FMath::Max(Graph->RobotsFarDistance, nearDistance + 1.f);
+        const int32 farPeriod = FMath::Clamp(Graph->RobotsFarReplicationPeriodFrame, 1, 255);
+
+        OwnedRobots.Reset();
+        for (const auto& robotPtr : Graph->GetRobots())
+        {
+            ARRBaseRobot* robot = robotPtr.Get();
+            if (nullptr == robot)
+            {
+                continue;
+            }
+
+            const UROS2Spawnable* spawnParams = robot->ROS2Interface ? robot->ROS2Interface->ROSSpawnParameters : nullptr;
+            const bool bOwned = spawnParams && (INDEX_NONE != playerId) && (spawnParams->GetNetworkPlayerId() == playerId);
+            int32 period = 1;
+            if (bSpectator)
+            {
+                // Culled beyond the viewer's very location, a distance of 0 meaning never culled
+                Params.ConnectionManager.ActorInfoMap.FindOrAdd(robot).SetCullDistanceSquared(1.f);
+                continue;
+            }
+            if (bOwned)
+            {
+                OwnedRobots.Add(robot);
+            }
+            else if (Params.Viewers.Num() > 0)
+            {
+                const FVector robotLocation = robot->GetActorLocation();
+                double minDistSquared = TNumericLimits<double>::Max();
+                for (const FNetViewer& viewer : Params.Viewers)
+                {
+                    minDistSquared = FMath::Min(minDistSquared, FVector::DistSquared(viewer.ViewLocation, robotLocation));
+                }
+                const double alpha =
+                    FMath::Clamp((FMath::Sqrt(minDistSquared) - nearDistance) / (farDistance - nearDistance), 0., 1.);
+                period = FMath::RoundToInt(FMath::Lerp(1., static_cast<double>(farPeriod), alpha));
+            }
+            Params.ConnectionManager.ActorInfoMap.FindOrAdd(robot).ReplicationPeriodFrame = period;
+        }
+    }
+
+    if (OwnedRobots.Num() > 0)
+    {
+        Params.OutGatheredReplicationLists.AddReplicationActorList(OwnedRobots);
+    }
+}
+
+void URRReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* InConnectionManager)
+{
+    Super::InitConnectionGraphNodes(InConnectionManager);
+
+    URRReplicationGraphNode_ConnectionRobots* robotsNode = CreateNewNode<URRReplicationGraphNode_ConnectionRobots>();
+    robotsNode->Graph = this;
+    AddConnectionGraphNode(robotsNode, InConnectionManager);
+}
+
+void URRReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& InActorInfo,
+                                                      FGlobalActorReplicationInfo& InGlobalInfo)
+{
+    // Robots are bAlwaysRelevant as all ARRBaseActor, which would route them to AlwaysRelevantNode
+    if (ARRBaseRobot* robot = Cast<ARRBaseRobot>(InActorInfo.GetActor()))
+    {
+        Robots.Add(robot);
+        GridNode->AddActor_Dynamic(InActorInfo, InGlobalInfo);
+        return;
+    }
+    Super::RouteAddNetworkActorToNodes(InActorInfo, InGlobalInfo);
+}
+
+void URRReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& InActorInfo)
+{
+    if (ARRBaseRobot* robot = Cast<ARRBaseRobot>(InActorInfo.GetActor()))
+    {
+        Robots.RemoveSwap(robot);
+        GridNode->RemoveActor_Dynamic(InActorInfo);
+        return;
+    }
+    Super::RouteRemoveNetworkActorToNodes(InActorInfo);
+}
@@ -0,0 +1,168 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRRobotModelCache.h"
+
+// UE
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/SecureHash.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+
+// RapyutaSimulationPlugins
+#include "RapyutaSimulationPlugins.h"
+
+static TAutoConsoleVariable<bool> CVarRobotModelCacheEnabled(
+    TEXT("rr.RobotModelCache.Enabled"),
+    true,
+    TEXT("Whether robot models parsed from URDF/SDF files are cached in memory & on disk by FRRRobotModelCache."),
+    ECVF_Default);
+
+FRWLock FRRRobotModelCache::SLock;
+TMap<FString, TSharedRef<FRRRobotModelInfo, ESPMode::ThreadSafe>> FRRRobotModelCache::SModelInfos;
+
+bool FRRRobotModelCache::IsEnabled()
+{
+    return CVarRobotModelCacheEnabled.GetValueOnAnyThread();
+}
+
+FString FRRRobotModelCache::GetContentHash(const FString& InDescriptionFilePath, const FString& InDescription)
+{
+    FMD5 md5;
+    const FTCHARToUTF8 folderUtf8(*FPaths::GetPath(InDescriptionFilePath));
+    md5.Update(reinterpret_cast<const uint8*>(folderUtf8.Get()), folderUtf8.Length() + 1);
+    const FTCHARToUTF8 descriptionUtf8(*InDescription);
+    md5.Update(reinterpret_cast<const uint8*>(descriptionUtf8.Get()), descriptionUtf8.Length());
+    FMD5Hash hash;
+    hash.Set(md5);
+    return LexToString(hash);
+}
+
+FString FRRRobotModelCache::GetCacheFilePath(const FString& InContentHash)
+{
+    return FPaths::Combine(
+        FPaths::ProjectSavedDir(), TEXT("RRRobotModelCache"), FString::Printf(TEXT("%s_v%u.rrdm"), *InContentHash, VERSION));
+}
+
+bool FRRRobotModelCache::Find(const FString& InContentHash, FRRRobotModelInfo& OutModelInfo)
+{
+    {
+        FReadScopeLock lock(SLock);
+        if (const TSharedRef<FRRRobotModelInfo, ESPMode::ThreadSafe>* modelInfo = SModelInfos.Find(InContentHash))
+        {
+            OutModelInfo.Data = (*modelInfo)->Data;
+            return true;
+        }
+    }
+
+    // Read outside the lock, concurrent loads of the same entry resulting in the same data
+    auto modelInfo = MakeShared<FRRRobotModelInfo, ESPMode::ThreadSafe>();
+    if (!LoadFromDisk(InContentHash, modelInfo->Data))
+    {
+        return false;
+    }
+    OutModelInfo.Data = modelInfo->Data;
+
+    FWriteScopeLock lock(SLock);
+    SModelInfos.Add(InContentHash, MoveTemp(modelInfo));
+    return true;
+}
+
+void FRRRobotModelCache::Add(const FString& InContentHash, const FRRRobotModelInfo& InModelInfo)
+{
+    {
+        FWriteScopeLock lock(SLock);
+        if (SModelInfos.Contains(InContentHash))
+        {
+            return;
+        }
+        SModelInfos.Add(InContentHash, MakeShared<FRRRobotModelInfo, ESPMode::ThreadSafe>(InModelInfo.Data));
+    }
+    SaveToDisk(InContentHash, InModelInfo.Data);
+}
+
+void FRRRobotModelCache::Reset()
+{
+    FWriteScopeLock lock(SLock);
+    SModelInfos.Reset();
+}
+
+bool FRRRobotModelCache::SerializeModelData(FArchive& Ar, FRRRobotModelData& InOutModelData)
+{
+    FRRRobotModelData::StaticStruct()->SerializeItem(Ar, &InOutModelData, nullptr);
+
+    // [ChildModelsData] is not a UPROPERTY(), as struct recursion is not supported
+    int32 childModelsNum = InOutModelData.ChildModelsData.Num();
+    Ar << childModelsNum;
+    if (Ar.IsLoading())
+    {
+        if ((childModelsNum < 0) || Ar.IsError())
+        {
+            Ar.SetError();
+            return false;
+        }
+        InOutModelData.ChildModelsData.SetNum(childModelsNum);
+    }
+    for (auto& childModelData : InOutModelData.ChildModelsData)
+    {
+        if (!SerializeModelData(Ar, childModelData))
+        {
+            return false;
+        }
+    }
+    return !Ar.IsError();
+}
+
+bool FRRRobotModelCache::LoadFromDisk(const FString& InContentHash, FRRRobotModelData& OutModelData)
+{
+    TArray<uint8> data;
+    if (!FFileHelper::LoadFileToArray(data, *GetCacheFilePath(InContentHash), FILEREAD_Silent))
+    {
+        return false;
+    }
+
+    FMemoryReader reader(data);
+    uint32 magic = 0;
+    uint32 version = 0;
+    reader << magic;
+    reader << version;
+    if ((MAGIC != magic) || (VERSION != version))
+    {
+        return false;
+    }
+
+    FObjectAndNameAsStringProxyArchive proxyReader(reader, false);
+    if (!SerializeModelData(proxyReader, OutModelData))
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("Robot model cache [%s] is corrupted, ignored"), *InContentHash);
+        OutModelData = FRRRobotModelData();
+        return false;
+    }
+    return true;
+}
+
+bool FRRRobotModelCache::SaveToDisk(const FString& InContentHash, const FRRRobotModelData& InModelData)
+{
+    TArray<uint8> data;
+    FMemoryWriter writer(data);
+    uint32 magic = MAGIC;
+    uint32 version = VERSION;
+    writer << magic;
+    writer << version;
+    FObjectAndNameAsStringProxyArchive proxyWriter(writer, false);
+    SerializeModelData(proxyWriter, const_cast<FRRRobotModelData&>(InModelData));
+
+    const FString cacheFilePath = GetCacheFilePath(InContentHash);
+    const FString tempFilePath = FString::Printf(TEXT("%s.%u.tmp"), *cacheFilePath, FPlatformProcess::GetCurrentProcessId());
+    if (!FFileHelper::SaveArrayToFile(data, *tempFilePath) || !IFileManager::Get().Move(*cacheFilePath, *tempFilePath, true))
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("Failed saving robot model cache [%s]"), *cacheFilePath);
+        IFileManager::Get().Delete(*tempFilePath);
+        return false;
+    }
+    return true;
+}
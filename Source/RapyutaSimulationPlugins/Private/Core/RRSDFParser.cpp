@@ -14,6 +14,8 @@
 #include "Core/RRConversionUtils.h"
 #include "Core/RRCoreUtils.h"
 #include "Core/RRMeshData.h"
+#include "Core/RRRobotModelCache.h"
+#include "Tools/RRStartupProfiler.h"
 
 static inline FVector GetLocationFromIgnitionPose(const ignition::math::Pose3d& InIgnPose)
 {
@@ -29,6 +31,21 @@ static inline FQuat GetRotationFromIgnitionPose(const ignition::math::Pose3d& In
 
 FRRRobotModelInfo FRRSDFParser::LoadModelInfoFromFile(const FString& InSDFPath)
 {
+    FRRStartupPhaseScope startupPhaseScope(ERRStartupPhase::ROBOT_DESCRIPTION_PARSING);
+    // Identical models, eg of a robot fleet, are only parsed once
+    FString contentHash;
+    FString sdfContent;
+    if (FRRRobotModelCache::IsEnabled() && FFileHelper::LoadFileToString(sdfContent, *InSDFPath))
+    {
+        contentHash = FRRRobotModelCache::GetContentHash(InSDFPath, sdfContent);
+        FRRRobotModelInfo cachedModelInfo;
+        if (FRRRobotModelCache::Find(contentHash, cachedModelInfo))
+        {
+            cachedModelInfo.Data.DescriptionFilePath = InSDFPath;
+            return cachedModelInfo;
+        }
+    }
+
     // Specify path to the model file uri in <include>
     // InModelName: <model://ModelPath>
     sdf::setFindCallback(
@@ -65,6 +82,10 @@ FRRRobotModelInfo FRRSDFParser::LoadModelInfoFromFile(const FString& InSDFPath)
     if (LoadModelInfoFromSDF(outSDFContent, robotModelInfo))
     {
         robotModelData.UpdateLinksLocationFromJoints();
+        if (!contentHash.IsEmpty())
+        {
+            FRRRobotModelCache::Add(contentHash, robotModelInfo);
+        }
 #if RAPYUTA_SDF_PARSER_DEBUG
         UE_LOG_WITH_INFO(
             LogRapyutaCore, Warning, TEXT("PARSING SDF SUCCEEDED[%s]!"), *FString::Join(robotModelData.ModelNameList, TEXT(",")));
@@ -639,6 +660,25 @@ bool FRRSDFParser::ParseSensorsProperty(const sdf::ElementPtr& InLinkElement, TA
                 lidarInfo.NoiseStdDev = noiseElement->Get<double>(SDF_ELEMENT_SENSOR_LIDAR_NOISE_STDDEV);
             }
         }
+        // [CAMERA] --
+        else if (ERRSensorType::CAMERA == sensorProp.SensorType)
+        {
+            auto& cameraInfo = sensorProp.CameraInfo;
+            sdf::ElementPtr cameraElement = sensorElement->FindElement(SDF_ELEMENT_SENSOR_CAMERA);
+            if (cameraElement)
+            {
+                // (NOTE) SDF does not support adding a custom element or attribute type, thus must make use of <camera>'s name
+                const FString cameraName = URRCoreUtils::StdToFString(cameraElement->Get<std::string>(SDF_ELEMENT_ATTR_NAME));
+                cameraInfo.CaptureProfileName = cameraName.Equals(TEXT("__default__")) ? FString() : cameraName;
+
+                sdf::ElementPtr imageElement = cameraElement->FindElement(SDF_ELEMENT_SENSOR_CAMERA_IMAGE);
+                if (imageElement)
+                {
+                    cameraInfo.Width = imageElement->Get<int>(SDF_ELEMENT_SENSOR_CAMERA_IMAGE_WIDTH);
+                    cameraInfo.Height = imageElement->Get<int>(SDF_ELEMENT_SENSOR_CAMERA_IMAGE_HEIGHT);
+                }
+            }
+        }
 
         // Add new sensor prop to the list
         OutSensorPropList.Emplace(MoveTemp(sensorProp));
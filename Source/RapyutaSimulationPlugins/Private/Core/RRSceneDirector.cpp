@@ -2,6 +2,9 @@
 
 #include "Core/RRSceneDirector.h"
 
+// UE
+#include "HAL/IConsoleManager.h"
+
 // RapyutaSimulationPlugins
 #include "Core/RRActorCommon.h"
 #include "Core/RRCoreUtils.h"
@@ -10,9 +13,22 @@
 #include "Core/RRGameState.h"
 #include "Core/RRMathUtils.h"
 #include "Core/RRPlayerController.h"
+#include "Core/RRStaticMeshComponent.h"
 #include "Core/RRThreadUtils.h"
 #include "Core/RRUObjectUtils.h"
 
+static TAutoConsoleVariable<int32> CVarDatasetWriterMaxPendingSamples(
+    TEXT("rr.DatasetWriter.MaxPendingSamples"),
+    64,
+    TEXT("Max number of captured dataset samples being encoded & written at once per scene instance."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarDatasetWriterMinFreeDiskSpaceMB(
+    TEXT("rr.DatasetWriter.MinFreeDiskSpaceMB"),
+    1024,
+    TEXT("Free disk space (MB) kept on the dataset output disk, samples being dropped below it."),
+    ECVF_Default);
+
 ARRSceneDirector::ARRSceneDirector()
 {
     bSceneInitialized = false;
@@ -20,6 +36,15 @@ ARRSceneDirector::ARRSceneDirector()
     bIsOperating = false;
 }
 
+void ARRSceneDirector::ForkFrom(const ARRSceneDirector* InSourceDirector)
+{
+    ForkSourceSceneInstanceId = InSourceDirector->SceneInstanceId;
+    SceneName = InSourceDirector->SceneName;
+    OperationBatchLoopLeft = InSourceDirector->OperationBatchLoopLeft;
+    StaticMeshMergeSettings = InSourceDirector->StaticMeshMergeSettings;
+    UE_LOG_WITH_SCENE_ID(LogRapyutaCore, Display, TEXT("[%s] forked from [%s]"), *GetName(), *InSourceDirector->GetName());
+}
+
 bool ARRSceneDirector::Initialize()
 {
     if (false == Super::Initialize())
@@ -79,6 +104,16 @@ bool ARRSceneDirector::InitializeOperation()
     // PostProcessVolume
     MainPostProcessVolume = Cast<APostProcessVolume>(URRUObjectUtils::FindPostProcessVolume(GetWorld()));
 
+    // Dataset writer
+    if (false == DatasetWriter.Init(
+                     FPaths::Combine(RRGameState->GetSimOutputsBaseFolderPath(), FString::Printf(TEXT("%d"), SceneInstanceId)),
+                     CVarDatasetWriterMaxPendingSamples.GetValueOnGameThread(),
+                     static_cast<uint64>(FMath::Max(CVarDatasetWriterMinFreeDiskSpaceMB.GetValueOnGameThread(), 0)) << 20))
+    {
+        UE_LOG_WITH_SCENE_ID(
+            LogRapyutaCore, Error, TEXT("Failed creating dataset output folder [%s]"), *DatasetWriter.GetOutputFolderPath());
+    }
+
     // Plan to run the main operation after Initializing is finished, in the next tick --
     URRCoreUtils::PlanToExecuteOnNextTick(GetWorld(), [this]() { RunOperation(); });
 
@@ -103,8 +138,63 @@ bool ARRSceneDirector::HasOperationCompleted(bool bIsLogged)
         {
             UE_LOG_WITH_SCENE_ID(LogRapyutaCore, Display, TEXT("is still operating!"));
         }
+        else if (DatasetWriter.GetPendingSamplesNum() > 0)
+        {
+            UE_LOG_WITH_SCENE_ID(
+                LogRapyutaCore, Display, TEXT("is still writing %d dataset samples!"), DatasetWriter.GetPendingSamplesNum());
+        }
+    }
+    return !(bIsDataCollecting || bIsOperating || (DatasetWriter.GetPendingSamplesNum() > 0));
+}
+
+bool ARRSceneDirector::EnqueueDatasetSample(FRRDatasetSample&& InSample)
+{
+    return DatasetWriter.Enqueue(MoveTemp(InSample));
+}
+
+bool ARRSceneDirector::EnqueueSegMaskLabels(const FString& InFilePath, const TArray<AActor*>& InActors)
+{
+    FRRDatasetSample sample;
+    sample.Type = ERRDatasetSampleType::TEXT;
+    sample.FilePath = InFilePath;
+    for (AActor* actor : InActors)
+    {
+        if (IsValid(actor))
+        {
+            sample.Text +=
+                FString::Printf(TEXT("%s %s\n"), *actor->GetName(), *URRUObjectUtils::GetSegMaskDepthStencilsAsText(actor));
+        }
+    }
+    return DatasetWriter.Enqueue(MoveTemp(sample));
+}
+
+bool ARRSceneDirector::EnqueueBoundingBoxAnnotations(const FString& InFilePath,
+                                                     const TArray<AActor*>& InActors,
+                                                     const FRRAnnotationView& InView,
+                                                     const AActor* InBaseActor)
+{
+    TArray<FRRBoundingBoxAnnotation> annotations;
+    BoundingBoxAnnotator.Annotate(InActors, InBaseActor, InView, annotations);
+
+    FRRDatasetSample sample;
+    sample.Type = ERRDatasetSampleType::TEXT;
+    sample.FilePath = InFilePath;
+    sample.Text = FRRBoundingBoxAnnotator::ToText(annotations);
+    return DatasetWriter.Enqueue(MoveTemp(sample));
+}
+
+void ARRSceneDirector::ContinueOnDatasetWriterCapacity(TFunction<void()> InContinuation)
+{
+    if (DatasetWriter.HasCapacity())
+    {
+        InContinuation();
+    }
+    else
+    {
+        URRCoreUtils::PlanToExecuteOnNextTick(GetWorld(),
+                                              [this, continuation = MoveTemp(InContinuation)]() mutable
+                                              { ContinueOnDatasetWriterCapacity(MoveTemp(continuation)); });
     }
-    return !(bIsDataCollecting || bIsOperating);
 }
 
 void ARRSceneDirector::OnDataCollectionPhaseDone(bool bIsFinalDataCollectingPhase)
@@ -112,6 +202,11 @@ void ARRSceneDirector::OnDataCollectionPhaseDone(bool bIsFinalDataCollectingPhas
     if (bIsFinalDataCollectingPhase)
     {
         bIsDataCollecting = false;
+        UE_LOG_WITH_SCENE_ID(LogRapyutaCore,
+                             Log,
+                             TEXT("%d dataset samples still being written, %d failed"),
+                             DatasetWriter.GetPendingSamplesNum(),
+                             DatasetWriter.GetFailedSamplesNum());
 
         // PROFILING --
         if (URRCoreUtils::IsSimProfiling())
@@ -127,8 +222,39 @@ void ARRSceneDirector::OnDataCollectionPhaseDone(bool bIsFinalDataCollectingPhas
 
 void ARRSceneDirector::ResetScene()
 {
-    ActorCommon->LatestCustomDepthStencilValue = 0;
+    ActorCommon->SegMaskIdAllocator.Reset();
     SceneEntityMaskValueList.Reset();
+    if (SceneSnapshot.Num() > 0)
+    {
+        const int32 restoredNum = SceneSnapshot.Restore();
+        UE_LOG_WITH_SCENE_ID(LogRapyutaCore, Verbose, TEXT("Restored %d/%d actors"), restoredNum, SceneSnapshot.Num());
+    }
+}
+
+void ARRSceneDirector::CaptureSceneSnapshot(const TArray<AActor*>& InActors)
+{
+    SceneSnapshot.Capture(InActors);
+    UE_LOG_WITH_SCENE_ID(LogRapyutaCore, Log, TEXT("Captured snapshot of %d actors"), SceneSnapshot.Num());
+}
+
+int32 ARRSceneDirector::MergeStaticMeshes(const TArray<AActor*>& InActors)
+{
+    if (MergedMeshActor)
+    {
+        UE_LOG_WITH_SCENE_ID(
+            LogRapyutaCore, Warning, TEXT("Static meshes already merged into [%s]"), *MergedMeshActor->GetName());
+        return 0;
+    }
+
+    MergedMeshActor = FRRStaticMeshMerger::MergeActorsStaticMeshes(GetWorld(), InActors, StaticMeshMergeSettings);
+    TInlineComponentArray<URRStaticMeshComponent*> mergedMeshComps;
+    if (MergedMeshActor)
+    {
+        MergedMeshActor->GetComponents(mergedMeshComps);
+    }
+    UE_LOG_WITH_SCENE_ID(
+        LogRapyutaCore, Log, TEXT("Merged %d actors' static meshes into %d"), InActors.Num(), mergedMeshComps.Num());
+    return mergedMeshComps.Num();
 }
 
 void ARRSceneDirector::EndSceneInstance()
@@ -0,0 +1,145 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRSceneSnapshot.h"
+
+// UE
+#include "Components/MeshComponent.h"
+#include "GameFramework/Actor.h"
+
+void FRRSceneSnapshot::Capture(const TArray<AActor*>& InActors)
+{
+    check(IsInGameThread());
+    Reset();
+    Actors.Reserve(InActors.Num());
+    Transforms.Reserve(InActors.Num());
+    HiddenFlags.Reserve(InActors.Num());
+
+    TArray<UMeshComponent*> meshComps;
+    for (AActor* actor : InActors)
+    {
+        if (false == IsValid(actor))
+        {
+            continue;
+        }
+        Actors.Add(actor);
+        Transforms.Add(actor->GetActorTransform());
+        HiddenFlags.Add(actor->IsHidden());
+
+        actor->GetComponents(meshComps);
+        for (UMeshComponent* meshComp : meshComps)
+        {
+            for (int32 i = 0; i < meshComp->GetNumMaterials(); ++i)
+            {
+                UMaterialInterface* material = meshComp->GetMaterial(i);
+                FMaterialState& state = MaterialStates.AddDefaulted_GetRef();
+                state.MeshComp = meshComp;
+                state.MaterialIndex = i;
+                if (const auto* mid = Cast<UMaterialInstanceDynamic>(material))
+                {
+                    state.ScalarParameterValues = mid->ScalarParameterValues;
+                    state.VectorParameterValues = mid->VectorParameterValues;
+                    state.TextureParameterValues = mid->TextureParameterValues;
+                }
+                Materials.Add(material);
+            }
+        }
+    }
+}
+
+int32 FRRSceneSnapshot::Restore() const
+{
+    check(IsInGameThread());
+    int32 restoredNum = 0;
+    for (int32 i = 0; i < Actors.Num(); ++i)
+    {
+        AActor* actor = Actors[i].Get();
+        if (nullptr == actor)
+        {
+            continue;
+        }
+        // Also zeroing velocities of physics-simulated bodies
+        actor->SetActorTransform(Transforms[i], false, nullptr, ETeleportType::ResetPhysics);
+        if (actor->IsHidden() != HiddenFlags[i])
+        {
+            actor->SetActorHiddenInGame(HiddenFlags[i]);
+        }
+        ++restoredNum;
+    }
+
+    for (int32 i = 0; i < MaterialStates.Num(); ++i)
+    {
+        const FMaterialState& state = MaterialStates[i];
+        UMeshComponent* meshComp = state.MeshComp.Get();
+        if (nullptr == meshComp)
+        {
+            continue;
+        }
+        if (meshComp->GetMaterial(state.MaterialIndex) != Materials[i])
+        {
+            meshComp->SetMaterial(state.MaterialIndex, Materials[i]);
+        }
+        if (auto* mid = Cast<UMaterialInstanceDynamic>(Materials[i]))
+        {
+            RestoreMaterialParameters(mid, state);
+        }
+    }
+    return restoredNum;
+}
+
+void FRRSceneSnapshot::RestoreMaterialParameters(UMaterialInstanceDynamic* InMID, const FMaterialState& InState)
+{
+    // Parameters added since the snapshot could only be dropped by clearing all
+    if ((InMID->ScalarParameterValues.Num() != InState.ScalarParameterValues.Num()) ||
+        (InMID->VectorParameterValues.Num() != InState.VectorParameterValues.Num()) ||
+        (InMID->TextureParameterValues.Num() != InState.TextureParameterValues.Num()))
+    {
+        InMID->ClearParameterValues();
+    }
+
+    // Only changed parameters are set, each of which being sent to the render thread
+    for (const auto& param : InState.ScalarParameterValues)
+    {
+        float value = 0.f;
+        if (!InMID->GetScalarParameterValue(param.ParameterInfo, value, true) || (value != param.ParameterValue))
+        {
+            InMID->SetScalarParameterValueByInfo(param.ParameterInfo, param.ParameterValue);
+        }
+    }
+    for (const auto& param : InState.VectorParameterValues)
+    {
+        FLinearColor value;
+        if (!InMID->GetVectorParameterValue(param.ParameterInfo, value, true) || (value != param.ParameterValue))
+        {
+            InMID->SetVectorParameterValueByInfo(param.ParameterInfo, param.ParameterValue);
+        }
+    }
+    for (const auto& param : InState.TextureParameterValues)
+    {
+        UTexture* value = nullptr;
+        if (!InMID->GetTextureParameterValue(param.ParameterInfo, value, true) || (value != param.ParameterValue))
+        {
+            InMID->SetTextureParameterValueByInfo(param.ParameterInfo, param.ParameterValue);
+        }
+    }
+}
+
+void FRRSceneSnapshot::Reset()
+{
+    Actors.Reset();
+    Transforms.Reset();
+    HiddenFlags.Reset();
+    MaterialStates.Reset();
+    Materials.Reset();
+}
+
+void FRRSceneSnapshot::AddReferencedObjects(FReferenceCollector& Collector)
+{
+    Collector.AddReferencedObjects(Materials);
+    for (auto& state : MaterialStates)
+    {
+        for (auto& param : state.TextureParameterValues)
+        {
+            Collector.AddReferencedObject(param.ParameterValue);
+        }
+    }
+}
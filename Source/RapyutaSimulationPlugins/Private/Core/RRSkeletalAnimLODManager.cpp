@@ -0,0 +1,297 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRSkeletalAnimLODManager.h"
+
+// UE
+#include "Async/ParallelFor.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRBoneTransformsCache.h"
+#include "Robots/RRBaseRobot.h"
+#include "Sensors/RRBaseLidarComponent.h"
+#include "Sensors/RRROS2CameraActor.h"
+#include "Sensors/RRROS2CameraComponent.h"
+
+static TAutoConsoleVariable<bool> CVarSkeletalAnimLODEnabled(
+    TEXT("rr.SkeletalAnimLOD.Enabled"),
+    true,
+    TEXT("Whether FRRSkeletalAnimLODManager throttles the animation of robot skeletal meshes unseen by any sensor or view."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSkeletalAnimLODUpdateInterval(
+    TEXT("rr.SkeletalAnimLOD.UpdateInterval"),
+    0.1f,
+    TEXT("[s] Interval between skeletal meshes animation LOD updates, taken upon the manager creation."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSkeletalAnimLODReducedTickInterval(
+    TEXT("rr.SkeletalAnimLOD.ReducedTickInterval"),
+    0.1f,
+    TEXT("[s] Tick interval of the skeletal meshes unseen by any sensor or view."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSkeletalAnimLODPausedTickInterval(
+    TEXT("rr.SkeletalAnimLOD.PausedTickInterval"),
+    1.f,
+    TEXT("[s] Tick interval of the unseen skeletal meshes farther than rr.SkeletalAnimLOD.PausedDistance from any viewer."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSkeletalAnimLODPausedDistance(
+    TEXT("rr.SkeletalAnimLOD.PausedDistance"),
+    5000.f,
+    TEXT("[cm] Distance to the nearest viewer beyond which unseen skeletal meshes are paused, <= 0 never to pause."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSkeletalAnimLODViewRange(
+    TEXT("rr.SkeletalAnimLOD.ViewRange"),
+    0.f,
+    TEXT("[cm] Range of cameras & player views without a max view distance, <= 0 for unbounded."),
+    ECVF_Default);
+
+void FRRSkeletalAnimLODTickFunction::ExecuteTick(float DeltaTime,
+                                                 ELevelTick TickType,
+                                                 ENamedThreads::Type CurrentThread,
+                                                 const FGraphEventRef& MyCompletionGraphEvent)
+{
+    if (Manager && (TickType != LEVELTICK_ViewportsOnly))
+    {
+        Manager->Update();
+    }
+}
+
+TMap<UWorld*, TUniquePtr<FRRSkeletalAnimLODManager>> FRRSkeletalAnimLODManager::SManagers;
+std::once_flag FRRSkeletalAnimLODManager::OnceFlag;
+
+FRRSkeletalAnimLODManager::~FRRSkeletalAnimLODManager()
+{
+    if (TickFunction.IsTickFunctionRegistered())
+    {
+        TickFunction.UnRegisterTickFunction();
+    }
+}
+
+FRRSkeletalAnimLODManager& FRRSkeletalAnimLODManager::Get(UWorld* InWorld)
+{
+    check(IsInGameThread());
+    std::call_once(OnceFlag,
+                   []() { FWorldDelegates::OnPostWorldCleanup.AddStatic(&FRRSkeletalAnimLODManager::OnPostWorldCleanup); });
+
+    TUniquePtr<FRRSkeletalAnimLODManager>& manager = SManagers.FindOrAdd(InWorld);
+    if (!manager.IsValid())
+    {
+        manager = MakeUnique<FRRSkeletalAnimLODManager>();
+        manager->World = InWorld;
+        manager->TickFunction.Manager = manager.Get();
+        manager->TickFunction.bCanEverTick = true;
+        // After the sensors & bone publishers have run in the frame
+        manager->TickFunction.TickGroup = TG_PostUpdateWork;
+        manager->TickFunction.TickInterval = FMath::Max(CVarSkeletalAnimLODUpdateInterval.GetValueOnGameThread(), 0.f);
+        manager->TickFunction.RegisterTickFunction(InWorld->PersistentLevel);
+    }
+    return *manager;
+}
+
+void FRRSkeletalAnimLODManager::OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/)
+{
+    SManagers.Remove(InWorld);
+}
+
+void FRRSkeletalAnimLODManager::AddSkeletalMesh(USkeletalMeshComponent* InSkeletalMesh)
+{
+    if (InSkeletalMesh && !SkeletalMeshes.ContainsByPredicate([InSkeletalMesh](const FSkeletalMesh& InMesh)
+                                                              { return InMesh.Component == InSkeletalMesh; }))
+    {
+        FSkeletalMesh& mesh = SkeletalMeshes.AddDefaulted_GetRef();
+        mesh.Component = InSkeletalMesh;
+        mesh.OriginalTickInterval = InSkeletalMesh->GetComponentTickInterval();
+    }
+}
+
+void FRRSkeletalAnimLODManager::RemoveSkeletalMesh(USkeletalMeshComponent* InSkeletalMesh)
+{
+    const int32 meshIdx = SkeletalMeshes.IndexOfByPredicate([InSkeletalMesh](const FSkeletalMesh& InMesh)
+                                                            { return InMesh.Component == InSkeletalMesh; });
+    if (meshIdx != INDEX_NONE)
+    {
+        SetLOD(SkeletalMeshes[meshIdx], ERRSkeletalAnimLOD::FULL);
+        SkeletalMeshes.RemoveAtSwap(meshIdx, 1, false);
+    }
+}
+
+void FRRSkeletalAnimLODManager::SetLOD(FSkeletalMesh& InSkeletalMesh, const ERRSkeletalAnimLOD InLOD)
+{
+    USkeletalMeshComponent* component = InSkeletalMesh.Component.Get();
+    if ((nullptr == component) || (InSkeletalMesh.LOD == InLOD))
+    {
+        return;
+    }
+    InSkeletalMesh.LOD = InLOD;
+    switch (InLOD)
+    {
+        case ERRSkeletalAnimLOD::FULL:
+            component->SetComponentTickInterval(InSkeletalMesh.OriginalTickInterval);
+            break;
+        case ERRSkeletalAnimLOD::REDUCED:
+            component->SetComponentTickInterval(FMath::Max(CVarSkeletalAnimLODReducedTickInterval.GetValueOnGameThread(),
+                                                           InSkeletalMesh.OriginalTickInterval));
+            break;
+        case ERRSkeletalAnimLOD::PAUSED:
+            component->SetComponentTickInterval(FMath::Max(CVarSkeletalAnimLODPausedTickInterval.GetValueOnGameThread(),
+                                                           InSkeletalMesh.OriginalTickInterval));
+            break;
+    }
+}
+
+void FRRSkeletalAnimLODManager::GatherViewers(UWorld* InWorld)
+{
+    Viewers.Reset();
+    const float viewRange = CVarSkeletalAnimLODViewRange.GetValueOnGameThread();
+    const float defaultRange = (viewRange > 0.f) ? viewRange : TNumericLimits<float>::Max();
+
+    // Half angle of the cone circumscribing a view frustum
+    auto getDiagonalHalfAngle = [](const float InHorizontalFOV, const float InAspectRatio)
+    {
+        const float tanHalfFOV = FMath::Tan(FMath::DegreesToRadians(0.5f * FMath::Clamp(InHorizontalFOV, 1.f, 179.f)));
+        return FMath::Atan(tanHalfFOV * FMath::Sqrt(1.f + FMath::Square(1.f / FMath::Max(InAspectRatio, KINDA_SMALL_NUMBER))));
+    };
+
+    auto addSensors = [this, defaultRange, &getDiagonalHalfAngle](const AActor* InActor)
+    {
+        TInlineComponentArray<URRROS2BaseSensorComponent*> sensors(InActor);
+        for (const URRROS2BaseSensorComponent* sensor : sensors)
+        {
+            if (const URRROS2CameraComponent* camera = Cast<URRROS2CameraComponent>(sensor))
+            {
+                const USceneCaptureComponent2D* capture = camera->SceneCaptureComponent;
+                if (capture)
+                {
+                    FViewer& viewer = Viewers.AddDefaulted_GetRef();
+                    viewer.Origin = capture->GetComponentLocation();
+                    viewer.Forward = capture->GetForwardVector();
+                    viewer.HalfAngle =
+                        getDiagonalHalfAngle(capture->FOVAngle, float(camera->Width) / FMath::Max(camera->Height, 1));
+                    viewer.Range = capture->MaxViewDistanceOverride > 0.f ? capture->MaxViewDistanceOverride : defaultRange;
+                }
+            }
+            else if (const URRBaseLidarComponent* lidar = Cast<URRBaseLidarComponent>(sensor))
+            {
+                FViewer& viewer = Viewers.AddDefaulted_GetRef();
+                viewer.Origin = lidar->GetComponentLocation();
+                viewer.Range = lidar->MaxRange;
+            }
+        }
+    };
+
+    for (TActorIterator<ARRBaseRobot> it(InWorld); it; ++it)
+    {
+        addSensors(*it);
+    }
+    for (TActorIterator<ARRROS2CameraActor> it(InWorld); it; ++it)
+    {
+        addSensors(*it);
+    }
+    for (auto it = InWorld->GetPlayerControllerIterator(); it; ++it)
+    {
+        const APlayerController* playerController = it->Get();
+        if (playerController && playerController->IsLocalController())
+        {
+            FVector viewLocation;
+            FRotator viewRotation;
+            playerController->GetPlayerViewPoint(viewLocation, viewRotation);
+            FViewer& viewer = Viewers.AddDefaulted_GetRef();
+            viewer.Origin = viewLocation;
+            viewer.Forward = viewRotation.Vector();
+            // Viewport aspect ratio unknown on a dedicated server, thus assumed 16:9
+            viewer.HalfAngle = getDiagonalHalfAngle(
+                playerController->PlayerCameraManager ? playerController->PlayerCameraManager->GetFOVAngle() : 90.f, 16.f / 9.f);
+            viewer.Range = defaultRange;
+        }
+    }
+}
+
+void FRRSkeletalAnimLODManager::Update()
+{
+    UWorld* world = World.Get();
+    const uint64 lastUpdateFrame = LastUpdateFrame;
+    LastUpdateFrame = GFrameCounter;
+    FMemory::Memzero(LastLODNums);
+    if ((nullptr == world) || (SkeletalMeshes.Num() == 0))
+    {
+        return;
+    }
+
+    // 1- Gather viewers & bounds on game thread
+    for (int32 i = 0; i < SkeletalMeshes.Num();)
+    {
+        if (!SkeletalMeshes[i].Component.IsValid())
+        {
+            SkeletalMeshes.RemoveAtSwap(i, 1, false);
+            continue;
+        }
+        ++i;
+    }
+    const int32 meshesNum = SkeletalMeshes.Num();
+    if (!CVarSkeletalAnimLODEnabled.GetValueOnGameThread())
+    {
+        for (FSkeletalMesh& mesh : SkeletalMeshes)
+        {
+            SetLOD(mesh, ERRSkeletalAnimLOD::FULL);
+        }
+        LastLODNums[static_cast<uint8>(ERRSkeletalAnimLOD::FULL)] = meshesNum;
+        return;
+    }
+
+    GatherViewers(world);
+    Bounds.SetNumUninitialized(meshesNum);
+    for (int32 i = 0; i < meshesNum; ++i)
+    {
+        Bounds[i] = SkeletalMeshes[i].Component->Bounds.GetSphere();
+    }
+
+    // 2- Visibility to any viewer & nearest viewer distance
+    const float pausedDistance = CVarSkeletalAnimLODPausedDistance.GetValueOnGameThread();
+    LODs.SetNumUninitialized(meshesNum);
+    ParallelFor(meshesNum,
+                [this, pausedDistance](const int32 i)
+                {
+                    const FSphere& bounds = Bounds[i];
+                    double nearestDistance = TNumericLimits<double>::Max();
+                    for (const FViewer& viewer : Viewers)
+                    {
+                        const FVector toBounds = bounds.Center - viewer.Origin;
+                        const double distance = toBounds.Size();
+                        nearestDistance = FMath::Min(nearestDistance, distance - bounds.W);
+                        if (distance - bounds.W > viewer.Range)
+                        {
+                            continue;
+                        }
+                        // Cone vs sphere, the sphere being seen under an angle of asin(W / distance)
+                        if ((viewer.HalfAngle >= PI) || (distance <= bounds.W) ||
+                            (FMath::Acos(FMath::Clamp(FVector::DotProduct(viewer.Forward, toBounds) / distance, -1.0, 1.0)) -
+                                 FMath::Asin(bounds.W / distance) <=
+                             viewer.HalfAngle))
+                        {
+                            LODs[i] = ERRSkeletalAnimLOD::FULL;
+                            return;
+                        }
+                    }
+                    LODs[i] = ((pausedDistance > 0.f) && (nearestDistance > pausedDistance)) ? ERRSkeletalAnimLOD::PAUSED
+                                                                                             : ERRSkeletalAnimLOD::REDUCED;
+                });
+
+    // 3- Apply, keeping the meshes whose bones have been read since the last update exact
+    for (int32 i = 0; i < meshesNum; ++i)
+    {
+        FSkeletalMesh& mesh = SkeletalMeshes[i];
+        const ERRSkeletalAnimLOD lod =
+            (FRRBoneTransformsCache::GetReadFrame(mesh.Component.Get()) > lastUpdateFrame) ? ERRSkeletalAnimLOD::FULL : LODs[i];
+        SetLOD(mesh, lod);
+        ++LastLODNums[static_cast<uint8>(lod)];
+    }
+}
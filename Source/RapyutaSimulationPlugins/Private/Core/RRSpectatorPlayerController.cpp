@@ -0,0 +1,147 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRSpectatorPlayerController.h"
+
+// UE
+#include "GameFramework/PlayerState.h"
+#include "Net/UnrealNetwork.h"
+
+// RapyutaSimulationPlugins
+#include "Tools/SimulationState.h"
+
+bool FRREntitySnapshotEntry::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    uint32 entityId = static_cast<uint32>(EntityId);
+    Ar.SerializeIntPacked(entityId);
+    EntityId = entityId;
+
+    bool bLocalSuccess = true;
+    bOutSuccess = Location.NetSerialize(Ar, Map, bLocalSuccess);
+    Rotation.SerializeCompressedShort(Ar);
+    return true;
+}
+
+ARRSpectatorPlayerController::ARRSpectatorPlayerController()
+{
+    bReplicates = true;
+    PrimaryActorTick.bCanEverTick = true;
+}
+
+void ARRSpectatorPlayerController::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+    DOREPLIFETIME(ARRSpectatorPlayerController, ServerSimState);
+}
+
+void ARRSpectatorPlayerController::InitPlayerState()
+{
+    Super::InitPlayerState();
+    if (PlayerState && HasAuthority())
+    {
+        PlayerState->SetIsOnlyASpectator(true);
+    }
+}
+
+void ARRSpectatorPlayerController::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
+    if (HasAuthority() && !IsLocalController())
+    {
+        SnapshotElapsedSec += DeltaSeconds;
+        if (SnapshotElapsedSec >= SnapshotIntervalSec)
+        {
+            SnapshotElapsedSec = 0.f;
+            SendEntitySnapshot();
+        }
+    }
+}
+
+void ARRSpectatorPlayerController::SendEntitySnapshot()
+{
+    if (nullptr == ServerSimState)
+    {
+        return;
+    }
+
+    // Server-side view of a remote spectator, as synced by its ServerSetSpectatorLocation()
+    FVector viewLocation;
+    FRotator viewRotation;
+    GetPlayerViewPoint(viewLocation, viewRotation);
+
+    InterestEntities.Reset();
+    if (InterestRadius > 0.f)
+    {
+        ServerSimState->FindEntitiesInRadius(viewLocation, InterestRadius, InterestEntities);
+    }
+    else
+    {
+        for (const auto& entity : ServerSimState->Entities)
+        {
+            if (IsValid(entity.Value))
+            {
+                InterestEntities.Add(entity.Value);
+            }
+        }
+    }
+    if (InterestEntities.Num() > MaxSnapshotEntitiesNum)
+    {
+        InterestEntities.Sort(
+            [&viewLocation](const AActor& InA, const AActor& InB)
+            {
+                return FVector::DistSquared(InA.GetActorLocation(), viewLocation) <
+                       FVector::DistSquared(InB.GetActorLocation(), viewLocation);
+            });
+        InterestEntities.SetNum(FMath::Max(MaxSnapshotEntitiesNum, 0), false);
+    }
+
+    // Ids looked up in one pass over the registry instead of one per entity
+    TMap<const AActor*, uint32> entityIds;
+    entityIds.Reserve(ServerSimState->EntityRegistry.Items.Num());
+    for (const FRREntityRegistryItem& item : ServerSimState->EntityRegistry.Items)
+    {
+        entityIds.Add(item.Actor, item.EntityId);
+    }
+
+    TArray<FRREntitySnapshotEntry> entries;
+    entries.Reserve(InterestEntities.Num());
+    for (const AActor* entity : InterestEntities)
+    {
+        if (const uint32* entityId = entityIds.Find(entity))
+        {
+            FRREntitySnapshotEntry& entry = entries.AddDefaulted_GetRef();
+            entry.EntityId = *entityId;
+            entry.Location = entity->GetActorLocation();
+            entry.Rotation = entity->GetActorRotation();
+        }
+    }
+    ClientReceiveEntitySnapshot(entries);
+}
+
+void ARRSpectatorPlayerController::ClientReceiveEntitySnapshot_Implementation(const TArray<FRREntitySnapshotEntry>& InEntries)
+{
+    LatestSnapshot = InEntries;
+    OnEntitySnapshotReceived.Broadcast(LatestSnapshot);
+}
+
+FString ARRSpectatorPlayerController::FindEntityName(const int64 InEntityId)
+{
+    const uint32 entityId = static_cast<uint32>(InEntityId);
+    if (const FString* name = EntityNames.Find(entityId))
+    {
+        return *name;
+    }
+
+    if (ServerSimState)
+    {
+        EntityNames.Reset();
+        for (const FRREntityRegistryItem& item : ServerSimState->EntityRegistry.Items)
+        {
+            EntityNames.Add(item.EntityId, item.Name);
+        }
+        if (const FString* name = EntityNames.Find(entityId))
+        {
+            return *name;
+        }
+    }
+    return FString();
+}
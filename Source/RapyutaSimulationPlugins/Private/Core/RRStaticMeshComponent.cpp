@@ -5,6 +5,7 @@
 #if WITH_EDITOR
 #include "ConvexDecompTool.h"
 #endif
+#include "Async/ParallelFor.h"
 #include "Engine/StaticMesh.h"
 #include "Materials/MaterialInstanceDynamic.h"
 #include "MeshDescription.h"
@@ -12,11 +13,16 @@
 
 // RapyutaSimulationPlugins
 #include "Core/RRActorCommon.h"
+#include "Core/RRBoundingBoxAnnotator.h"
+#include "Core/RRConvexDecomposition.h"
 #include "Core/RRGameSingleton.h"
 #include "Core/RRMeshActor.h"
+#include "Core/RRMeshCache.h"
 #include "Core/RRMeshUtils.h"
 #include "Core/RRThreadUtils.h"
+#include "Core/RRTrace.h"
 #include "Core/RRTypeUtils.h"
+#include "Tools/RRStartupProfiler.h"
 
 URRStaticMeshComponent::URRStaticMeshComponent()
 {
@@ -84,15 +90,22 @@ void URRStaticMeshComponent::SetMesh(UStaticMesh* InStaticMesh)
     AsyncTask(ENamedThreads::GameThread, [this]() { OnMeshCreationDone.ExecuteIfBound(true, this); });
 }
 
+void URRStaticMeshComponent::SetMeshSize(const FVector& InSize)
+{
+    SetWorldScale3D(InSize / GetStaticMesh()->GetBoundingBox().GetSize());
+    FRRBoundingBoxAnnotator::InvalidateLocalBounds(GetOwner());
+}
+
 bool URRStaticMeshComponent::InitializeMesh(const FString& InMeshFileName)
 {
     URRGameSingleton* gameSingleton = URRGameSingleton::Get();
     UStaticMesh* staticMesh = gameSingleton->GetStaticMesh(InMeshFileName, false);
     const bool bStaticMeshAlreadyExists = (nullptr != staticMesh);
+    // Keyed by content, thus shared by all paths to the same mesh
     MeshUniqueName = bStaticMeshAlreadyExists ? InMeshFileName
-                                              : URRUObjectUtils::ComposeDynamicResourceName(
+                                              : URRGameSingleton::GetMeshUniqueName(
                                                     URRGameSingleton::GetAssetNamePrefix(ERRResourceDataType::UE_STATIC_MESH),
-                                                    *FPaths::GetBaseFilename(InMeshFileName));
+                                                    InMeshFileName);
     ShapeType = URRGameSingleton::GetShapeTypeFromMeshName(InMeshFileName);
 
 #if RAPYUTA_SIM_DEBUG
@@ -109,20 +122,16 @@ bool URRStaticMeshComponent::InitializeMesh(const FString& InMeshFileName)
             else if (gameSingleton->HasSimResource(ERRResourceDataType::UE_STATIC_MESH, MeshUniqueName))
             {
                 // Wait for StaticMesh[MeshUniqueName] has been fully loaded
-                URRCoreUtils::RegisterRepeatedExecution(
-                    GetWorld(),
-                    StaticMeshTimerHandle,
-                    [this, gameSingleton]()
+                gameSingleton->WaitForDynamicResource(
+                    ERRResourceDataType::UE_STATIC_MESH,
+                    MeshUniqueName,
+                    [weakThis = TWeakObjectPtr<URRStaticMeshComponent>(this)](UObject* InStaticMesh)
                     {
-                        UStaticMesh* existentStaticMesh = gameSingleton->GetStaticMesh(MeshUniqueName, false);
-                        if (existentStaticMesh)
+                        if (weakThis.IsValid() && InStaticMesh)
                         {
-                            // Stop the repeat timer first, note that this will invalidate all the captured variants except this
-                            URRCoreUtils::StopRegisteredExecution(GetWorld(), StaticMeshTimerHandle);
-                            SetMesh(existentStaticMesh);
+                            weakThis->SetMesh(CastChecked<UStaticMesh>(InStaticMesh));
                         }
-                    },
-                    0.01f);
+                    });
             }
             else
             {
@@ -138,31 +147,43 @@ bool URRStaticMeshComponent::InitializeMesh(const FString& InMeshFileName)
                 else
                 {
                     // Start async mesh loading
+                    TRACE_COUNTER_INCREMENT(RRPendingAsyncMeshLoads);
                     Async(
 #if WITH_EDITOR
                         EAsyncExecution::LargeThreadPool,
 #else
                         EAsyncExecution::ThreadPool,
 #endif
-                        [this, InMeshFileName]()
+                        [this, InMeshFileName, lodSettings = LODSettings]()
                         {
-                            FRRMeshData runtimeMeshData;
-                            TSharedPtr<Assimp::Importer> meshImporter = MakeShared<Assimp::Importer>();
-                            runtimeMeshData = URRMeshUtils::LoadMeshFromFile(InMeshFileName, *meshImporter);
-                            runtimeMeshData.MeshImporter = meshImporter;
+                            FRRMeshData runtimeMeshData = URRMeshUtils::LoadMeshFromFile(InMeshFileName, 1.f, lodSettings);
+                            TRACE_COUNTER_DECREMENT(RRPendingAsyncMeshLoads);
                             runtimeMeshData.MeshUniqueName = MeshUniqueName;
                             if (runtimeMeshData.IsValid())
                             {
-                                AsyncTask(ENamedThreads::GameThread,
-                                          [this, loadedMeshData = MoveTemp(runtimeMeshData)]() mutable
-                                          {
-                                              verify(loadedMeshData.IsValid());
-                                              // Create mesh body, signalling [OnMeshCreationDone()]
-                                              verify(CreateMeshBody(loadedMeshData));
-                                              // Save [loadedMeshData] to [FRRMeshData::MeshDataStore]
-                                              FRRMeshData::AddMeshData(MeshUniqueName,
-                                                                       MakeShared<FRRMeshData>(MoveTemp(loadedMeshData)));
-                                          });
+                                // Mesh descriptions built here, only the static mesh build being left to the game thread
+                                TArray<FMeshDescription> meshDescs;
+                                BuildMeshDescriptions(runtimeMeshData, GetVisualLODsNum(runtimeMeshData, lodSettings), meshDescs);
+
+                                // Budgeted on game thread, thus amortized with other meshes' loaded at once
+                                URRThreadUtils::EnqueueGameThreadJob(
+                                    [weakThis = TWeakObjectPtr<URRStaticMeshComponent>(this),
+                                     loadedMeshData = MoveTemp(runtimeMeshData),
+                                     meshDescs = MoveTemp(meshDescs)]() mutable
+                                    {
+                                        if (!weakThis.IsValid())
+                                        {
+                                            return;
+                                        }
+                                        verify(loadedMeshData.IsValid());
+                                        // Create mesh body, signalling [OnMeshCreationDone()]
+                                        verify(weakThis->CreateMeshBody(loadedMeshData, &meshDescs));
+                                        // Save [loadedMeshData] to [FRRMeshData::MeshDataStore]
+                                        // Its static mesh having been built, it is a preferred eviction candidate
+                                        FRRMeshData::AddMeshData(weakThis->MeshUniqueName,
+                                                                 MakeShared<FRRMeshData>(MoveTemp(loadedMeshData)),
+                                                                 true);
+                                    });
                             }
                         });
                 }
@@ -182,7 +203,40 @@ bool URRStaticMeshComponent::InitializeMesh(const FString& InMeshFileName)
     return true;
 }
 
-UStaticMesh* URRStaticMeshComponent::CreateMesh(const FRRMeshData& InMeshData, bool bInAsVisualMesh)
+int32 URRStaticMeshComponent::GetVisualLODsNum(const FRRMeshData& InMeshData, const FRRMeshLODSettings& InLODSettings)
+{
+    return InLODSettings.IsEnabled() ? FMath::Min(InMeshData.GetLODsNum(), InLODSettings.GetLODsNum()) : 1;
+}
+
+void URRStaticMeshComponent::BuildMeshDescriptions(const FRRMeshData& InMeshData,
+                                                   int32 InLODsNum,
+                                                   TArray<FMeshDescription>& OutMeshDescs)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRStaticMeshBuildDescriptions", RRAssetChannel);
+    // Mesh descriptions, one per LOD, will hold all the geometry, uv, normals going into the static mesh
+    OutMeshDescs.SetNum(InLODsNum);
+    ParallelFor(InLODsNum,
+                [&InMeshData, &OutMeshDescs](int32 InLODIndex)
+                {
+                    FMeshDescription& meshDesc = OutMeshDescs[InLODIndex];
+                    FStaticMeshAttributes attributes(meshDesc);
+                    attributes.Register();
+
+                    FMeshDescriptionBuilder meshDescBuilder;
+                    meshDescBuilder.SetMeshDescription(&meshDesc);
+                    meshDescBuilder.EnablePolyGroups();
+                    meshDescBuilder.SetNumUVLayers(1);
+
+                    for (const auto& node : InMeshData.Nodes)
+                    {
+                        CreateMeshSection(node.Meshes, meshDescBuilder, InLODIndex);
+                    }
+                });
+}
+
+UStaticMesh* URRStaticMeshComponent::CreateMesh(const FRRMeshData& InMeshData,
+                                                bool bInAsVisualMesh,
+                                                const TArray<FMeshDescription>* InMeshDescs)
 {
     // (NOTE) This function could be invoked from an async task running in GameThread
     if (false == InMeshData.IsValid())
@@ -192,19 +246,18 @@ UStaticMesh* URRStaticMeshComponent::CreateMesh(const FRRMeshData& InMeshData, b
     }
 
     // Static mesh
-    // Mesh description will hold all the geometry, uv, normals going into the static mesh
-    FMeshDescription meshDesc;
-    FStaticMeshAttributes attributes(meshDesc);
-    attributes.Register();
-
-    FMeshDescriptionBuilder meshDescBuilder;
-    meshDescBuilder.SetMeshDescription(&meshDesc);
-    meshDescBuilder.EnablePolyGroups();
-    meshDescBuilder.SetNumUVLayers(1);
-
-    for (const auto& node : InMeshData.Nodes)
+    // Collision meshes only need LOD0
+    const int32 meshLODsNum = bInAsVisualMesh ? GetVisualLODsNum(InMeshData, LODSettings) : 1;
+    TArray<FMeshDescription> meshDescs;
+    if ((nullptr == InMeshDescs) || (InMeshDescs->Num() < meshLODsNum))
     {
-        CreateMeshSection(node.Meshes, meshDescBuilder);
+        BuildMeshDescriptions(InMeshData, meshLODsNum, meshDescs);
+        InMeshDescs = &meshDescs;
+    }
+    TArray<const FMeshDescription*> meshDescPtrs;
+    for (auto lodIndex = 0; lodIndex < meshLODsNum; ++lodIndex)
+    {
+        meshDescPtrs.Add(&(*InMeshDescs)[lodIndex]);
     }
 
     // Build static mesh
@@ -237,11 +290,13 @@ UStaticMesh* URRStaticMeshComponent::CreateMesh(const FRRMeshData& InMeshData, b
         ITargetPlatform* currentPlatform = GetTargetPlatformManagerRef().GetRunningTargetPlatform();
         check(currentPlatform);
         const FStaticMeshLODGroup& lodGroup = currentPlatform->GetStaticMeshLODSettings().GetLODGroup(NAME_None);
-        int32 lodsNum = lodGroup.GetDefaultNumLODs();
+        // LODs generated upon import are already reduced
+        int32 lodsNum = (meshLODsNum > 1) ? meshLODsNum : lodGroup.GetDefaultNumLODs();
         if (lodsNum == 0)
         {
             lodsNum = 1;
         }
+        staticMesh->bAutoComputeLODScreenSize = (meshLODsNum == 1);
         while (staticMesh->GetNumSourceModels() < lodsNum)
         {
             staticMesh->AddSourceModel();
@@ -249,7 +304,15 @@ UStaticMesh* URRStaticMeshComponent::CreateMesh(const FRRMeshData& InMeshData, b
         for (auto lodIndex = 0; lodIndex < lodsNum; ++lodIndex)
         {
             auto& sourceModel = staticMesh->GetSourceModel(lodIndex);
-            sourceModel.ReductionSettings = lodGroup.GetDefaultSettings(lodIndex);
+            if (meshLODsNum > 1)
+            {
+                sourceModel.ReductionSettings = FMeshReductionSettings();
+                sourceModel.ScreenSize.Default = (lodIndex > 0) ? LODSettings.ScreenSizes[lodIndex - 1] : 1.f;
+            }
+            else
+            {
+                sourceModel.ReductionSettings = lodGroup.GetDefaultSettings(lodIndex);
+            }
             sourceModel.BuildSettings.bGenerateLightmapUVs = true;
             sourceModel.BuildSettings.SrcLightmapIndex = 0;
             sourceModel.BuildSettings.DstLightmapIndex = 0;
@@ -277,13 +340,24 @@ UStaticMesh* URRStaticMeshComponent::CreateMesh(const FRRMeshData& InMeshData, b
     }
 
     // Build mesh
-    staticMesh->BuildFromMeshDescriptions({&meshDesc}, meshDescParams);
+    staticMesh->BuildFromMeshDescriptions(meshDescPtrs, meshDescParams);
+
+    // Override the default LOD screen sizes, read by the render proxies created later
+    FStaticMeshRenderData* renderData = staticMesh->GetRenderData();
+    if (renderData && (meshLODsNum > 1))
+    {
+        for (auto lodIndex = 1; lodIndex < meshLODsNum; ++lodIndex)
+        {
+            renderData->ScreenSize[lodIndex].Default = LODSettings.ScreenSizes[lodIndex - 1];
+        }
+    }
     return staticMesh;
 }
 
-UStaticMesh* URRStaticMeshComponent::CreateMeshBody(const FRRMeshData& InMeshData)
+UStaticMesh* URRStaticMeshComponent::CreateMeshBody(const FRRMeshData& InMeshData, const TArray<FMeshDescription>* InMeshDescs)
 {
-    UStaticMesh* visualMesh = CreateMesh(InMeshData, true);
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRStaticMeshCreateBody", RRAssetChannel);
+    UStaticMesh* visualMesh = CreateMesh(InMeshData, true, InMeshDescs);
     if (nullptr == visualMesh)
     {
         return nullptr;
@@ -296,13 +370,15 @@ UStaticMesh* URRStaticMeshComponent::CreateMeshBody(const FRRMeshData& InMeshDat
         if (bUseComplexCollision)
         {
 #if WITH_EDITOR
-            visualMesh->ComplexCollisionMesh = CreateMesh(InMeshData, false);
+            // Sharing the visual LOD0 mesh description
+            visualMesh->ComplexCollisionMesh = CreateMesh(InMeshData, false, InMeshDescs);
 #endif
             bodySetup->CollisionTraceFlag = ECollisionTraceFlag::CTF_UseComplexAsSimple;
         }
         else
         {
             // Ref: UProceduralMeshComponent::UpdateCollision()
+            FRRStartupPhaseScope startupPhaseScope(ERRStartupPhase::COLLISION_COOKING);
             GenerateCustomSimpleCollision(InMeshData, bodySetup);
             bodySetup->BodySetupGuid = FGuid::NewGuid();
             bodySetup->CollisionTraceFlag = ECollisionTraceFlag::CTF_UseSimpleAsComplex;
@@ -356,7 +432,8 @@ UStaticMesh* URRStaticMeshComponent::CreateMeshBody(const FRRMeshData& InMeshDat
 }
 
 void URRStaticMeshComponent::CreateMeshSection(const TArray<FRRMeshNodeData>& InMeshSectionData,
-                                               FMeshDescriptionBuilder& OutMeshDescBuilder)
+                                               FMeshDescriptionBuilder& OutMeshDescBuilder,
+                                               int32 InLODIndex)
 {
 #if RAPYUTA_SIM_VERBOSE
     uint32 meshSectionIndex = 0;
@@ -369,40 +446,38 @@ void URRStaticMeshComponent::CreateMeshSection(const TArray<FRRMeshNodeData>& In
         }
 
 #if RAPYUTA_SIM_VERBOSE
-        UE_LOG_WITH_INFO_NAMED(
+        UE_LOG_WITH_INFO(
             LogRapyutaCore,
             Warning,
-            TEXT("CREATE STATIC MESH SECTION[%u]: Vertices(%u) - VertexColors(%u) - TriangleIndices(%u) - Normals(%u) - "
-                 "UVs(%u) - "
-                 "ProcTangents(%u) - "
+            TEXT("CREATE STATIC MESH SECTION[%u]: Vertices(%u) - VertexColors(%u) - TriangleIndices(%u) - "
                  "Material(%u)"),
             meshSectionIndex,
             mesh.Vertices.Num(),
             mesh.VertexColors.Num(),
             mesh.TriangleIndices.Num(),
-            mesh.Normals.Num(),
-            mesh.UVs.Num(),
-            mesh.ProcTangents.Num(),
             mesh.MaterialIndex);
 #endif
 
         // Create vertex instances (3 per face)
         TArray<FVertexID> vertexIDs;
+        vertexIDs.Reserve(mesh.Vertices.Num());
         for (auto i = 0; i < mesh.Vertices.Num(); ++i)
         {
-            vertexIDs.Emplace(OutMeshDescBuilder.AppendVertex(mesh.Vertices[i]));
+            vertexIDs.Emplace(OutMeshDescBuilder.AppendVertex(mesh.GetPosition(i)));
         }
 
         // Vertex instances
+        const TArray<int32>& triangleIndices = mesh.GetTriangleIndices(InLODIndex);
         TArray<FVertexInstanceID> vertexInsts;
-        for (auto i = 0; i < mesh.TriangleIndices.Num(); ++i)
+        vertexInsts.Reserve(triangleIndices.Num());
+        for (auto i = 0; i < triangleIndices.Num(); ++i)
         {
             // Face(towards -X) vertex instance
-            const auto vIdx = mesh.TriangleIndices[i];
+            const auto vIdx = triangleIndices[i];
             const FVertexInstanceID instanceID = OutMeshDescBuilder.AppendInstance(vertexIDs[vIdx]);
-            OutMeshDescBuilder.SetInstanceNormal(instanceID, mesh.Normals[vIdx]);
-            OutMeshDescBuilder.SetInstanceUV(instanceID, mesh.UVs[vIdx], 0);
-            OutMeshDescBuilder.SetInstanceColor(instanceID, FVector4f(FLinearColor(mesh.VertexColors[vIdx])));
+            OutMeshDescBuilder.SetInstanceNormal(instanceID, mesh.GetNormal(vIdx));
+            OutMeshDescBuilder.SetInstanceUV(instanceID, mesh.GetUV(vIdx), 0);
+            OutMeshDescBuilder.SetInstanceColor(instanceID, FVector4f(FLinearColor(mesh.GetVertexColor(vIdx))));
             vertexInsts.Emplace(instanceID);
         }
 
@@ -428,18 +503,50 @@ void URRStaticMeshComponent::GenerateCustomSimpleCollision(const FRRMeshData& In
     {
         for (auto& mesh : meshNode.Meshes)
         {
+            // Each mesh's indices are offset by the vertices of the previous ones
+            const uint32 vertexOffset = verts.Num();
             for (const auto& vertex : mesh.Vertices)
             {
-                verts.Add(FVector3f(vertex));
+                verts.Add(vertex.Position);
             }
             for (const auto& triangleIdx : mesh.TriangleIndices)
             {
-                indices.Add(triangleIdx);
+                indices.Add(vertexOffset + triangleIdx);
             }
         }
     }
 #if WITH_EDITOR
     DecomposeMeshToHulls(OutBodySetup, verts, indices, 64, 100000);
+#else
+    // Runtime decomposition, cached alongside the mesh cache
+    const FRRConvexDecompositionSettings settings;
+    const FString cacheFilePath =
+        FRRMeshCache::IsEnabled() ? FRRMeshCache::GetHullsCacheFilePath(verts, indices, settings) : FString();
+    TArray<TArray<FVector3f>> hulls;
+    if (cacheFilePath.IsEmpty() || !FRRMeshCache::LoadHulls(cacheFilePath, hulls))
+    {
+        if (!FRRConvexDecomposition::Decompose(verts, indices, settings, hulls))
+        {
+            UE_LOG_WITH_INFO_NAMED(LogRapyutaCore, Warning, TEXT("[%s] Convex decomposition failed"), *MeshUniqueName);
+            return;
+        }
+        if (!cacheFilePath.IsEmpty())
+        {
+            FRRMeshCache::SaveHulls(cacheFilePath, hulls);
+        }
+    }
+
+    OutBodySetup->AggGeom.ConvexElems.Reset(hulls.Num());
+    for (const auto& hull : hulls)
+    {
+        FKConvexElem& convexElem = OutBodySetup->AggGeom.ConvexElems.AddDefaulted_GetRef();
+        convexElem.VertexData.Reserve(hull.Num());
+        for (const auto& vertex : hull)
+        {
+            convexElem.VertexData.Add(FVector(vertex));
+        }
+        convexElem.UpdateElemBox();
+    }
 #endif
 }
 
@@ -0,0 +1,268 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRStaticMeshMerger.h"
+
+// UE
+#include "Engine/StaticMesh.h"
+#include "EngineUtils.h"
+#include "PhysicsEngine/BodySetup.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRMeshActor.h"
+#include "Core/RRStaticMeshComponent.h"
+#include "Core/RRTrace.h"
+#include "Core/RRUObjectUtils.h"
+
+namespace
+{
+struct FRRMeshMergeCluster
+{
+    //! Source mesh comps & their mesh data, in merge order
+    TArray<URRStaticMeshComponent*> MeshComps;
+    TArray<TSharedPtr<FRRMeshData>> MeshDataList;
+    int32 VerticesNum = 0;
+    bool bHasVertexColors = false;
+    //! Center of the first mesh comp's grid cell, frame of the merged mesh
+    FVector Origin = FVector::ZeroVector;
+};
+
+bool IsMergeable(const URRStaticMeshComponent* InMeshComp)
+{
+    return IsValid(InMeshComp) && InMeshComp->IsRegistered() && InMeshComp->IsVisible() &&
+           (InMeshComp->Mobility != EComponentMobility::Movable) && !InMeshComp->IsSimulatingPhysics() &&
+           (ERRShapeType::MESH == InMeshComp->ShapeType) && InMeshComp->GetStaticMesh();
+}
+
+//! Mesh comps only merge with those of the same materials, collision profile & custom depth stencil, in the same grid cell
+FString MakeClusterKey(const URRStaticMeshComponent* InMeshComp, const FIntPoint& InCell)
+{
+    FString key = FString::Printf(TEXT("%d_%d|%s|%d_%d"),
+                                  InCell.X,
+                                  InCell.Y,
+                                  *InMeshComp->GetCollisionProfileName().ToString(),
+                                  InMeshComp->bRenderCustomDepth,
+                                  InMeshComp->CustomDepthStencilValue);
+    for (auto i = 0; i < InMeshComp->GetNumMaterials(); ++i)
+    {
+        key += FString::Printf(TEXT("|%s"), *GetPathNameSafe(InMeshComp->GetMaterial(i)));
+    }
+    return key;
+}
+}    // namespace
+
+void FRRStaticMeshMerger::AppendMeshData(const FRRMeshData& InMeshData,
+                                         const FTransform& InTransform,
+                                         bool bInWithVertexColors,
+                                         FRRMeshNodeData& InOutMergedMesh)
+{
+    // Mirroring transforms flip the triangles' winding
+    const bool bIsMirrored = (InTransform.GetDeterminant() < 0.f);
+    for (const auto& meshNode : InMeshData.Nodes)
+    {
+        for (const auto& mesh : meshNode.Meshes)
+        {
+            FRRMeshNodeData transformedMesh;
+            transformedMesh.Vertices = mesh.Vertices;
+            transformedMesh.TransformBy(InTransform);
+
+            const int32 indexOffset = InOutMergedMesh.Vertices.Num();
+            InOutMergedMesh.Vertices.Append(MoveTemp(transformedMesh.Vertices));
+            if (bInWithVertexColors)
+            {
+                if (mesh.HasVertexColors())
+                {
+                    InOutMergedMesh.VertexColors.Append(mesh.VertexColors);
+                }
+                InOutMergedMesh.VertexColors.SetNumZeroed(InOutMergedMesh.Vertices.Num());
+            }
+
+            const int32 firstIndex = InOutMergedMesh.TriangleIndices.Num();
+            InOutMergedMesh.TriangleIndices.Reserve(firstIndex + mesh.TriangleIndices.Num());
+            for (const int32 index : mesh.TriangleIndices)
+            {
+                InOutMergedMesh.TriangleIndices.Add(indexOffset + index);
+            }
+            if (bIsMirrored)
+            {
+                for (auto i = firstIndex; i + 2 < InOutMergedMesh.TriangleIndices.Num(); i += 3)
+                {
+                    Swap(InOutMergedMesh.TriangleIndices[i + 1], InOutMergedMesh.TriangleIndices[i + 2]);
+                }
+            }
+        }
+    }
+}
+
+TArray<URRStaticMeshComponent*> FRRStaticMeshMerger::Merge(AActor* InOwner,
+                                                           const TArray<URRStaticMeshComponent*>& InMeshComps,
+                                                           const FRRStaticMeshMergeSettings& InSettings)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRStaticMeshMerge", RRAssetChannel);
+    TArray<URRStaticMeshComponent*> mergedMeshComps;
+    if (!IsValid(InOwner) || (InSettings.ClusterSize <= 0.f))
+    {
+        return mergedMeshComps;
+    }
+
+    // Cluster mesh comps, an over-sized cluster being continued by another of the same key
+    TMap<FString, int32> openClusterIndices;
+    TArray<FRRMeshMergeCluster> clusters;
+    for (URRStaticMeshComponent* meshComp : InMeshComps)
+    {
+        if (!IsMergeable(meshComp))
+        {
+            continue;
+        }
+        TSharedPtr<FRRMeshData> meshData = FRRMeshData::GetMeshData(meshComp->MeshUniqueName);
+        if (!(meshData.IsValid() && meshData->IsValid()))
+        {
+            continue;
+        }
+
+        const FVector location = meshComp->GetComponentLocation();
+        const FIntPoint cell(FMath::FloorToInt(location.X / InSettings.ClusterSize),
+                             FMath::FloorToInt(location.Y / InSettings.ClusterSize));
+        const FString key = MakeClusterKey(meshComp, cell);
+        const int32 verticesNum = meshData->GetVerticesNum();
+        int32* clusterIndex = openClusterIndices.Find(key);
+        if ((nullptr == clusterIndex) || (clusters[*clusterIndex].VerticesNum + verticesNum > InSettings.MaxMergedVerticesNum))
+        {
+            FRRMeshMergeCluster& newCluster = clusters.AddDefaulted_GetRef();
+            newCluster.Origin = FVector((cell.X + 0.5f) * InSettings.ClusterSize, (cell.Y + 0.5f) * InSettings.ClusterSize, 0.f);
+            clusterIndex = &openClusterIndices.Add(key, clusters.Num() - 1);
+        }
+
+        FRRMeshMergeCluster& cluster = clusters[*clusterIndex];
+        cluster.MeshComps.Add(meshComp);
+        cluster.MeshDataList.Add(meshData);
+        cluster.VerticesNum += verticesNum;
+        cluster.bHasVertexColors |= meshData->HasVertexColors();
+    }
+
+    USceneComponent* ownerRoot = InOwner->GetRootComponent();
+    for (auto clusterIndex = 0; clusterIndex < clusters.Num(); ++clusterIndex)
+    {
+        const FRRMeshMergeCluster& cluster = clusters[clusterIndex];
+        if (cluster.MeshComps.Num() < FMath::Max(InSettings.MinClusterMeshCompsNum, 1))
+        {
+            continue;
+        }
+
+        // Merged mesh data, as a single node & mesh section in the cluster frame
+        const FTransform clusterTransform(cluster.Origin);
+        FRRMeshData mergedMeshData;
+        mergedMeshData.MeshUniqueName = FString::Printf(TEXT("%s_Merged_%d"), *InOwner->GetName(), clusterIndex);
+        FRRMeshNodeData& mergedMeshSection = mergedMeshData.Nodes.AddDefaulted_GetRef().Meshes.AddDefaulted_GetRef();
+        mergedMeshSection.Vertices.Reserve(cluster.VerticesNum);
+        for (auto i = 0; i < cluster.MeshComps.Num(); ++i)
+        {
+            AppendMeshData(*cluster.MeshDataList[i],
+                           cluster.MeshComps[i]->GetComponentTransform().GetRelativeTransform(clusterTransform),
+                           cluster.bHasVertexColors,
+                           mergedMeshSection);
+        }
+        mergedMeshData.bIsValid = (mergedMeshSection.TriangleIndices.Num() > 0);
+
+        // Merged mesh comp, with a single complex-as-simple collision body
+        URRStaticMeshComponent* sourceMeshComp = cluster.MeshComps[0];
+        const FTransform relativeTransform =
+            ownerRoot ? clusterTransform.GetRelativeTransform(ownerRoot->GetComponentTransform()) : clusterTransform;
+        URRStaticMeshComponent* mergedMeshComp = URRUObjectUtils::CreateMeshComponent<URRStaticMeshComponent>(
+            InOwner, mergedMeshData.MeshUniqueName, mergedMeshData.MeshUniqueName, relativeTransform, true, false, true);
+        mergedMeshComp->ShapeType = ERRShapeType::MESH;
+        mergedMeshComp->bUseDefaultSimpleCollision = false;
+        mergedMeshComp->bUseComplexCollision = true;
+        UStaticMesh* mergedStaticMesh = mergedMeshComp->CreateMesh(mergedMeshData, true);
+        if (nullptr == mergedStaticMesh)
+        {
+            mergedMeshComp->DestroyComponent();
+            continue;
+        }
+#if WITH_EDITOR
+        mergedStaticMesh->ComplexCollisionMesh = mergedMeshComp->CreateMesh(mergedMeshData, false);
+#endif
+        mergedStaticMesh->GetBodySetup()->CollisionTraceFlag = ECollisionTraceFlag::CTF_UseComplexAsSimple;
+
+        mergedMeshComp->SetCollisionProfileName(sourceMeshComp->GetCollisionProfileName());
+        mergedMeshComp->SetRenderCustomDepth(sourceMeshComp->bRenderCustomDepth);
+        mergedMeshComp->SetCustomDepthStencilValue(sourceMeshComp->CustomDepthStencilValue);
+        for (auto i = 0; i < sourceMeshComp->GetNumMaterials(); ++i)
+        {
+            mergedMeshComp->SetMaterial(i, sourceMeshComp->GetMaterial(i));
+        }
+        mergedMeshComp->SetMesh(mergedStaticMesh);
+
+        // Source mesh comps are kept for their actors, no longer rendered nor colliding
+        for (URRStaticMeshComponent* meshComp : cluster.MeshComps)
+        {
+            meshComp->SetVisibility(false);
+            meshComp->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+        }
+        mergedMeshComps.Add(mergedMeshComp);
+
+        UE_LOG_WITH_INFO(LogRapyutaCore,
+                         Verbose,
+                         TEXT("[%s] merged from %d mesh comps, %d vertices"),
+                         *mergedMeshData.MeshUniqueName,
+                         cluster.MeshComps.Num(),
+                         mergedStaticMesh->GetNumVertices(0));
+    }
+    return mergedMeshComps;
+}
+
+AActor* FRRStaticMeshMerger::MergeWorldStaticMeshes(UWorld* InWorld, const FRRStaticMeshMergeSettings& InSettings)
+{
+    TArray<AActor*> meshActors;
+    if (InWorld)
+    {
+        for (TActorIterator<ARRMeshActor> actorIt(InWorld); actorIt; ++actorIt)
+        {
+            meshActors.Add(*actorIt);
+        }
+    }
+    return MergeActorsStaticMeshes(InWorld, meshActors, InSettings);
+}
+
+AActor* FRRStaticMeshMerger::MergeActorsStaticMeshes(UWorld* InWorld,
+                                                     const TArray<AActor*>& InActors,
+                                                     const FRRStaticMeshMergeSettings& InSettings)
+{
+    if (nullptr == InWorld)
+    {
+        return nullptr;
+    }
+
+    TArray<URRStaticMeshComponent*> meshComps;
+    for (const AActor* actor : InActors)
+    {
+        if (IsValid(actor))
+        {
+            TInlineComponentArray<URRStaticMeshComponent*> actorMeshComps(actor);
+            meshComps.Append(actorMeshComps);
+        }
+    }
+    if (meshComps.Num() < InSettings.MinClusterMeshCompsNum)
+    {
+        return nullptr;
+    }
+
+    FActorSpawnParameters spawnParams;
+    spawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+    AActor* mergedActor = InWorld->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, spawnParams);
+    USceneComponent* root = URRUObjectUtils::SetupDefaultRootComponent(mergedActor);
+    root->SetMobility(EComponentMobility::Static);
+    URRUObjectUtils::RegisterActorComponent(root);
+
+    const TArray<URRStaticMeshComponent*> mergedMeshComps = Merge(mergedActor, meshComps, InSettings);
+    UE_LOG_WITH_INFO(LogRapyutaCore,
+                     Log,
+                     TEXT("%d static mesh comps gathered, merged into %d meshes"),
+                     meshComps.Num(),
+                     mergedMeshComps.Num());
+    if (mergedMeshComps.Num() == 0)
+    {
+        mergedActor->Destroy();
+        return nullptr;
+    }
+    return mergedActor;
+}
@@ -0,0 +1,198 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRStreamingTexturePool.h"
+
+// UE
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "Engine/Texture2D.h"
+#include "UObject/Package.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRCoreUtils.h"
+#include "Core/RRMathUtils.h"
+#include "RapyutaSimulationPlugins.h"
+
+FRRStreamingTexturePool::~FRRStreamingTexturePool()
+{
+    Reset();
+}
+
+bool FRRStreamingTexturePool::Init(const FString& InImageFolderPath,
+                                   const TArray<ERRFileType>& InImageFileTypes,
+                                   const int32 InResidentTexturesNum,
+                                   const int32 InPrefetchBatchNum,
+                                   const bool bInCompressed)
+{
+    check(IsInGameThread());
+    Reset();
+    ImageFolderPath = InImageFolderPath;
+    bCompressed = bInCompressed;
+    if (!URRCoreUtils::LoadFullFilePaths(InImageFolderPath, ImageFilePaths, InImageFileTypes) || (ImageFilePaths.Num() == 0))
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("No image found under [%s]"), *InImageFolderPath);
+        return false;
+    }
+    URRCoreUtils::LoadImageWrapperModule();
+
+    const int32 residentTexturesNum = FMath::Clamp(InResidentTexturesNum, 1, ImageFilePaths.Num());
+    PrefetchBatchNum = FMath::Clamp(InPrefetchBatchNum, 1, residentTexturesNum);
+
+    // The first working set is made of the library's first images
+    TArray<FRRDecodedImage> decodedImages;
+    decodedImages.SetNum(residentTexturesNum);
+    ParallelFor(residentTexturesNum,
+                [this, &decodedImages](const int32 InIdx)
+                { URRCoreUtils::DecodeImageFile(ImageFilePaths[InIdx], bCompressed, decodedImages[InIdx]); });
+    for (int32 i = 0; i < residentTexturesNum; ++i)
+    {
+        if (UTexture2D* texture = CreateTexture(i, decodedImages[i]))
+        {
+            ResidentTextures.Add(texture);
+            ResidentFileIndices.Add(i);
+        }
+        else
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("Failed to load image to texture: [%s]"), *ImageFilePaths[i]);
+        }
+    }
+
+    // Nothing to stream if the whole library is resident
+    if (ResidentTextures.Num() < ImageFilePaths.Num())
+    {
+        PrefetchNextBatch();
+    }
+    return ResidentTextures.Num() > 0;
+}
+
+void FRRStreamingTexturePool::Reset()
+{
+    if (PrefetchFuture.IsValid())
+    {
+        PrefetchFuture.Wait();
+        PrefetchFuture.Reset();
+    }
+    PrefetchBatch.Reset();
+    ImageFilePaths.Reset();
+    ResidentTextures.Reset();
+    ResidentFileIndices.Reset();
+    NextReplacedIndex = 0;
+    DrawsNum = 0;
+}
+
+UTexture* FRRStreamingTexturePool::GetRandomTexture()
+{
+    check(IsInGameThread());
+    if (ResidentTextures.Num() == 0)
+    {
+        return nullptr;
+    }
+
+    AddDraws(1);
+    return URRMathUtils::GetRandomElement(ResidentTextures);
+}
+
+void FRRStreamingTexturePool::GetResidentTextures(TArray<UTexture*>& OutTextures, const int32 InDrawsNum)
+{
+    check(IsInGameThread());
+    if (ResidentTextures.Num() > 0)
+    {
+        AddDraws(InDrawsNum);
+    }
+    OutTextures.Reset(ResidentTextures.Num());
+    OutTextures.Append(ResidentTextures);
+}
+
+void FRRStreamingTexturePool::AddDraws(const int32 InDrawsNum)
+{
+    // Never blocking on the prefetch, the current working set keeps being drawn from till it is ready
+    DrawsNum += InDrawsNum;
+    if ((DrawsNum >= ResidentTextures.Num()) && PrefetchFuture.IsValid() && PrefetchFuture.IsReady())
+    {
+        SwapInPrefetchedBatch();
+        DrawsNum = 0;
+        PrefetchNextBatch();
+    }
+}
+
+void FRRStreamingTexturePool::PrefetchNextBatch()
+{
+    // Indices are picked in the game thread, to keep the sim random stream deterministic
+    TSet<int32> batchFileIndices;
+    const int32 maxAttemptsNum = 4 * PrefetchBatchNum;
+    for (int32 attempt = 0; (batchFileIndices.Num() < PrefetchBatchNum) && (attempt < maxAttemptsNum); ++attempt)
+    {
+        const int32 fileIdx = URRMathUtils::GetRandomIntegerInRange(0, ImageFilePaths.Num() - 1);
+        if (!ResidentFileIndices.Contains(fileIdx))
+        {
+            batchFileIndices.Add(fileIdx);
+        }
+    }
+
+    TArray<FString> batchFilePaths;
+    PrefetchBatch = MakeShared<FRRDecodedBatch, ESPMode::ThreadSafe>();
+    for (const int32 fileIdx : batchFileIndices)
+    {
+        batchFilePaths.Add(ImageFilePaths[fileIdx]);
+        PrefetchBatch->Emplace(fileIdx, FRRDecodedImage());
+    }
+
+    PrefetchFuture = Async(EAsyncExecution::ThreadPool,
+                           [batch = PrefetchBatch, batchFilePaths = MoveTemp(batchFilePaths), bCompressed = bCompressed]()
+                           {
+                               ParallelFor(batch->Num(),
+                                           [&batch, &batchFilePaths, bCompressed](const int32 InIdx)
+                                           {
+                                               URRCoreUtils::DecodeImageFile(
+                                                   batchFilePaths[InIdx], bCompressed, (*batch)[InIdx].Value);
+                                           });
+                           });
+}
+
+void FRRStreamingTexturePool::SwapInPrefetchedBatch()
+{
+    PrefetchFuture.Reset();
+    for (auto& decodedImage : *PrefetchBatch)
+    {
+        if (!decodedImage.Value.IsValid())
+        {
+            UE_LOG_WITH_INFO(
+                LogRapyutaCore, Warning, TEXT("Failed to prefetch image: [%s]"), *ImageFilePaths[decodedImage.Key]);
+            continue;
+        }
+
+        const int32 replacedIdx = NextReplacedIndex;
+        UTexture2D*& residentTexture = ResidentTextures[replacedIdx];
+        // Recycle the replaced texture's GPU resource if possible, else it is garbage collected once unreferenced
+        if (!URRCoreUtils::UpdateImageTexture(residentTexture, MoveTemp(decodedImage.Value)))
+        {
+            UTexture2D* texture = CreateTexture(decodedImage.Key, decodedImage.Value);
+            if (nullptr == texture)
+            {
+                continue;
+            }
+            residentTexture = texture;
+        }
+        ResidentFileIndices[replacedIdx] = decodedImage.Key;
+        NextReplacedIndex = (NextReplacedIndex + 1) % ResidentTextures.Num();
+    }
+    PrefetchBatch.Reset();
+}
+
+UTexture2D* FRRStreamingTexturePool::CreateTexture(const int32 InFileIndex, const FRRDecodedImage& InImage) const
+{
+    if (!InImage.IsValid())
+    {
+        return nullptr;
+    }
+
+    // Replaced textures may still be alive under the same name
+    const FString textureName = ImageFilePaths[InFileIndex].RightChop(ImageFolderPath.Len());
+    return URRCoreUtils::CreateImageTexture(
+        InImage, MakeUniqueObjectName(GetTransientPackage(), UTexture2D::StaticClass(), FName(*textureName)).ToString());
+}
+
+void FRRStreamingTexturePool::AddReferencedObjects(FReferenceCollector& Collector)
+{
+    Collector.AddReferencedObjects(ResidentTextures);
+}
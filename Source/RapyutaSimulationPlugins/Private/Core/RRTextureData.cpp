@@ -2,14 +2,105 @@
 
 #include "Core/RRTextureData.h"
 
+// UE
+#include "Async/ParallelFor.h"
+#include "Engine/TextureLightProfile.h"
+
 // RapyutaSimulationPlugins
 #include "Core/RRCoreUtils.h"
 #include "Core/RRGameSingleton.h"
 #include "Core/RRMathUtils.h"
+#include "Core/RRStreamingTexturePool.h"
+#include "RapyutaSimulationPlugins.h"
 
 UTexture* FRRTextureData::GetRandomTexture() const
 {
-    return (ImageTextureList.Num() > 0) ? URRMathUtils::GetRandomElement(ImageTextureList)
+    return StreamingPool.IsValid()          ? StreamingPool->GetRandomTexture()
+         : (ImageTextureList.Num() > 0)     ? URRMathUtils::GetRandomElement(ImageTextureList)
          : (TextureNames.Num() > 0)     ? URRGameSingleton::Get()->GetTexture(URRMathUtils::GetRandomElement(TextureNames))
                                         : nullptr;
 }
+
+void FRRTextureData::GetTextures(TArray<UTexture*>& OutTextures, const int32 InDrawsNum) const
+{
+    OutTextures.Reset();
+    if (StreamingPool.IsValid())
+    {
+        StreamingPool->GetResidentTextures(OutTextures, InDrawsNum);
+    }
+    else if (ImageTextureList.Num() > 0)
+    {
+        OutTextures = ImageTextureList;
+    }
+    else
+    {
+        URRGameSingleton* gameSingleton = URRGameSingleton::Get();
+        for (const auto& textureName : TextureNames)
+        {
+            if (UTexture* texture = gameSingleton->GetTexture(textureName))
+            {
+                OutTextures.Add(texture);
+            }
+        }
+    }
+}
+
+bool FRRLightProfileLibrary::LoadFromFolder(const FString& InFolderPath, bool bIsLogged)
+{
+    TArray<FString> filePaths;
+    bool bResult = URRCoreUtils::LoadFullFilePaths(InFolderPath, filePaths, {ERRFileType::LIGHT_PROFILE_IES});
+    if (bResult)
+    {
+        TArray<FRRLightProfileData> profilesData;
+        profilesData.SetNum(filePaths.Num());
+        ParallelFor(filePaths.Num(),
+                    [&](const int32 InIdx) { URRCoreUtils::ParseIESProfile(filePaths[InIdx], profilesData[InIdx]); });
+
+        for (auto i = 0; i < filePaths.Num(); ++i)
+        {
+            if (profilesData[i].IsValid())
+            {
+                // Relative to InFolderPath, as in URRCoreUtils::LoadIESProfilesFromFolder()
+                FString profileName = filePaths[i].RightChop(InFolderPath.Len());
+                ProfileNames.AddUnique(profileName);
+                ProfilesData.Emplace(MoveTemp(profileName), MoveTemp(profilesData[i]));
+            }
+            else
+            {
+                bResult = false;
+                UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Failed to parse ies profile [%s]"), *filePaths[i]);
+            }
+        }
+    }
+
+    if (!bResult && bIsLogged)
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Failed to load all ies profiles from [%s]!"), *InFolderPath);
+    }
+    return bResult;
+}
+
+UTextureLightProfile* FRRLightProfileLibrary::GetLightProfile(const FString& InProfileName)
+{
+    if (UTextureLightProfile** lightProfile = LightProfiles.Find(InProfileName))
+    {
+        return *lightProfile;
+    }
+
+    FRRLightProfileData profileData;
+    if (!ProfilesData.RemoveAndCopyValue(InProfileName, profileData))
+    {
+        return nullptr;
+    }
+    UTextureLightProfile* lightProfile = URRCoreUtils::CreateIESProfile(MoveTemp(profileData), InProfileName);
+    if (lightProfile)
+    {
+        LightProfiles.Add(InProfileName, lightProfile);
+    }
+    return lightProfile;
+}
+
+UTextureLightProfile* FRRLightProfileLibrary::GetRandomLightProfile()
+{
+    return (ProfileNames.Num() > 0) ? GetLightProfile(URRMathUtils::GetRandomElement(ProfileNames)) : nullptr;
+}
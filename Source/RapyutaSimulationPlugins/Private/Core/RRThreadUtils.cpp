@@ -1,2 +1,159 @@
 // Copyright 2020-2021 Rapyuta Robotics Co., Ltd.
 #include "Core/RRThreadUtils.h"
+
+// Native
+#include <mutex>
+
+// UE
+#include "Containers/Queue.h"
+#include "HAL/IConsoleManager.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRTrace.h"
+
+static TAutoConsoleVariable<float> CVarGameThreadJobsBudgetMs(
+    TEXT("rr.GameThreadJobs.BudgetMs"),
+    2.f,
+    TEXT("Game thread time per frame [ms] given to NORMAL & LOW jobs queued by URRThreadUtils::EnqueueGameThreadJob."),
+    ECVF_Default);
+
+namespace
+{
+TQueue<TUniqueFunction<void()>, EQueueMode::Mpsc> GGameThreadJobs[static_cast<uint8>(ERRGameThreadJobPriority::TOTAL)];
+std::atomic<int32> GGameThreadJobsNum(0);
+std::once_flag GGameThreadJobsTickerOnceFlag;
+
+bool RunGameThreadJob(const ERRGameThreadJobPriority InPriority)
+{
+    TUniqueFunction<void()> job;
+    if (!GGameThreadJobs[static_cast<uint8>(InPriority)].Dequeue(job))
+    {
+        return false;
+    }
+    --GGameThreadJobsNum;
+    job();
+    return true;
+}
+
+bool RunGameThreadJobs(float)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_STR("RRRunGameThreadJobs");
+    while (RunGameThreadJob(ERRGameThreadJobPriority::HIGH))
+    {
+    }
+
+    const double endTime = FPlatformTime::Seconds() + 0.001 * FMath::Max(CVarGameThreadJobsBudgetMs.GetValueOnGameThread(), 0.f);
+    bool bJobRun = false;
+    do
+    {
+        bJobRun = RunGameThreadJob(ERRGameThreadJobPriority::NORMAL) || RunGameThreadJob(ERRGameThreadJobPriority::LOW);
+    } while (bJobRun && (FPlatformTime::Seconds() < endTime));
+    TRACE_COUNTER_SET(RRPendingGameThreadJobs, GGameThreadJobsNum.load());
+    return true;
+}
+}    // namespace
+
+void URRThreadUtils::EnqueueGameThreadJob(TUniqueFunction<void()> InJob, const ERRGameThreadJobPriority InPriority)
+{
+    std::call_once(GGameThreadJobsTickerOnceFlag,
+                   []() { FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateStatic(&RunGameThreadJobs)); });
+    check(InPriority < ERRGameThreadJobPriority::TOTAL);
+    ++GGameThreadJobsNum;
+    GGameThreadJobs[static_cast<uint8>(InPriority)].Enqueue(MoveTemp(InJob));
+}
+
+int32 URRThreadUtils::GetGameThreadJobsNum()
+{
+    return GGameThreadJobsNum;
+}
+
+void FRRTaskHandle::Wait() const
+{
+    if (Event.IsValid())
+    {
+        FTaskGraphInterface::Get().WaitUntilTaskCompletes(Event);
+    }
+}
+
+FRRTaskHandle URRThreadUtils::LaunchTask(TUniqueFunction<void()> InTask,
+                                         const TArray<FRRTaskHandle>& InPrerequisites,
+                                         const ENamedThreads::Type InThread,
+                                         TSharedPtr<std::atomic<bool>, ESPMode::ThreadSafe> InCancelledFlag)
+{
+    FRRTaskHandle handle;
+    handle.CancelledFlag =
+        InCancelledFlag.IsValid() ? MoveTemp(InCancelledFlag) : MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false);
+
+    FGraphEventArray prerequisites;
+    TArray<TSharedPtr<std::atomic<bool>, ESPMode::ThreadSafe>, TInlineAllocator<4>> prerequisiteCancelledFlags;
+    for (const FRRTaskHandle& prerequisite : InPrerequisites)
+    {
+        if (prerequisite.Event.IsValid())
+        {
+            prerequisites.Add(prerequisite.Event);
+        }
+        if (prerequisite.CancelledFlag.IsValid() && (prerequisite.CancelledFlag != handle.CancelledFlag))
+        {
+            prerequisiteCancelledFlags.Add(prerequisite.CancelledFlag);
+        }
+    }
+
+    handle.Event = FFunctionGraphTask::CreateAndDispatchWhenReady(
+        [task = MoveTemp(InTask), cancelledFlag = handle.CancelledFlag, prerequisiteCancelledFlags]()
+        {
+            bool bCancelled = *cancelledFlag;
+            for (const auto& prerequisiteCancelledFlag : prerequisiteCancelledFlags)
+            {
+                bCancelled |= *prerequisiteCancelledFlag;
+            }
+            if (!bCancelled)
+            {
+                task();
+            }
+        },
+        TStatId(),
+        &prerequisites,
+        InThread);
+    return handle;
+}
+
+FRRTaskHandle URRThreadUtils::Then(const FRRTaskHandle& InTask,
+                                   TUniqueFunction<void()> InContinuation,
+                                   const ENamedThreads::Type InThread)
+{
+    return LaunchTask(MoveTemp(InContinuation), {InTask}, InThread, InTask.CancelledFlag);
+}
+
+FRRTaskHandle URRThreadUtils::ThenAfter(const FRRTaskHandle& InTask,
+                                        const float InDelaySeconds,
+                                        TUniqueFunction<void()> InContinuation,
+                                        const ENamedThreads::Type InThread)
+{
+    TSharedPtr<std::atomic<bool>, ESPMode::ThreadSafe> cancelledFlag =
+        InTask.CancelledFlag.IsValid() ? InTask.CancelledFlag : MakeShared<std::atomic<bool>, ESPMode::ThreadSafe>(false);
+    FGraphEventArray prerequisites;
+    if (InTask.Event.IsValid())
+    {
+        prerequisites.Add(InTask.Event);
+    }
+
+    // Completed by the core ticker once the delay since the task completion has elapsed, or at once if cancelled, thus
+    // registered regardless of the cancellation for the continuation to complete anyway
+    FGraphEventRef delayEvent = FGraphEvent::CreateGraphEvent();
+    FFunctionGraphTask::CreateAndDispatchWhenReady(
+        [delayEvent, InDelaySeconds, cancelledFlag]()
+        {
+            FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda(
+                                                     [delayEvent](float)
+                                                     {
+                                                         delayEvent->DispatchSubsequents();
+                                                         return false;
+                                                     }),
+                                                 *cancelledFlag ? 0.f : InDelaySeconds);
+        },
+        TStatId(),
+        &prerequisites,
+        ENamedThreads::AnyBackgroundHiPriTask);
+
+    return LaunchTask(MoveTemp(InContinuation), {FRRTaskHandle{delayEvent, nullptr}}, InThread, cancelledFlag);
+}
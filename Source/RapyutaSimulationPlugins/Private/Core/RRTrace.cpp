@@ -0,0 +1,49 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Core/RRTrace.h"
+
+// UE
+#include "HAL/IConsoleManager.h"
+
+// RapyutaSimulationPlugins
+#include "RapyutaSimulationPlugins.h"
+
+UE_TRACE_CHANNEL_DEFINE(RRROS2Channel);
+UE_TRACE_CHANNEL_DEFINE(RRSimStateChannel);
+UE_TRACE_CHANNEL_DEFINE(RRAssetChannel);
+UE_TRACE_CHANNEL_DEFINE(RRDriveChannel);
+
+TRACE_DECLARE_INT_COUNTER(RRLidarActiveRays, TEXT("RR/LidarActiveRays"));
+TRACE_DECLARE_INT_COUNTER(RRCameraQueuedRenderRequests, TEXT("RR/CameraQueuedRenderRequests"));
+TRACE_DECLARE_INT_COUNTER(RRPendingAsyncMeshLoads, TEXT("RR/PendingAsyncMeshLoads"));
+TRACE_DECLARE_INT_COUNTER(RREntitiesNum, TEXT("RR/EntitiesNum"));
+TRACE_DECLARE_INT_COUNTER(RRPendingGameThreadJobs, TEXT("RR/PendingGameThreadJobs"));
+TRACE_DECLARE_INT_COUNTER(RRPendingPublisherThreadMsgs, TEXT("RR/PendingPublisherThreadMsgs"));
+
+static void TraceCommand(const TArray<FString>& InArgs)
+{
+    static const TCHAR* CHANNEL_NAMES[] = {
+        TEXT("RRSensor"), TEXT("RRROS2"), TEXT("RRSimState"), TEXT("RRAsset"), TEXT("RRDrive")};
+    if (InArgs.Num() < 2)
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Display, TEXT("Usage: rr.Trace <RRSensor|RRROS2|RRSimState|RRAsset|RRDrive|all> <0|1>"));
+        return;
+    }
+
+    const bool bEnabled = FCString::ToBool(*InArgs[1]);
+    const bool bAll = InArgs[0].Equals(TEXT("all"), ESearchCase::IgnoreCase);
+    for (const TCHAR* channelName : CHANNEL_NAMES)
+    {
+        if (bAll || InArgs[0].Equals(channelName, ESearchCase::IgnoreCase))
+        {
+            UE::Trace::ToggleChannel(channelName, bEnabled);
+            UE_LOG_WITH_INFO(
+                LogRapyutaCore, Display, TEXT("Trace channel %s %s"), channelName, bEnabled ? TEXT("on") : TEXT("off"));
+        }
+    }
+}
+
+static FAutoConsoleCommandWithArgs GTraceCommand(TEXT("rr.Trace"),
+                                                 TEXT("Toggle the plugin's trace channels, eg 'rr.Trace RRSensor 1' or "
+                                                      "'rr.Trace all 0'. The trace itself is started with Trace.Start."),
+                                                 FConsoleCommandWithArgsDelegate::CreateStatic(&TraceCommand));
@@ -1,14 +1,19 @@
 #include "Core/RRUObjectUtils.h"
 
 // UE
+#include "AI/NavigationSystemBase.h"
+#include "Async/ParallelFor.h"
 #include "Components/ActorComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "Engine/StaticMeshActor.h"
 #include "GameFramework/Actor.h"
+#include "Kismet/GameplayStatics.h"
 
 // RapyutaSimulationPlugins
 #include "Core/RRBaseActor.h"
 #include "Core/RRGameSingleton.h"
+#include "Core/RRInstancedMeshGroupComponent.h"
+#include "Core/RRMaterialInstanceCache.h"
 #include "Core/RRMathUtils.h"
 #include "Core/RRMeshActor.h"
 
@@ -213,6 +218,23 @@ void URRUObjectUtils::AttachComponentToComponent(USceneComponent* InChildComp,
     }
 }
 
+void URRUObjectUtils::FinishSpawningActors(UWorld* InWorld, TArray<AActor*>& InOutActors, const TArray<FTransform>& InTransforms)
+{
+    // Navigation updates of the actors' registered components are gathered until unlocked
+    FNavigationLockContext navigationLock(InWorld);
+    for (int32 i = 0; i < InOutActors.Num(); ++i)
+    {
+        if (InOutActors[i])
+        {
+            InOutActors[i] = UGameplayStatics::FinishSpawningActor(InOutActors[i], InTransforms[i]);
+        }
+        if (false == IsValid(InOutActors[i]))
+        {
+            InOutActors[i] = nullptr;
+        }
+    }
+}
+
 ARRBaseActor* URRUObjectUtils::SpawnSimActor(UWorld* InWorld,
                                              int8 InSceneInstanceId,
                                              UClass* InActorClass,
@@ -357,8 +379,53 @@ void URRUObjectUtils::SetHomoAngularConstraintMotion(FConstraintInstance* InCI,
     InCI->SetAngularTwistMotion(InHomoAngularMotion);
 }
 
+void URRUObjectUtils::SetSegMaskId(UPrimitiveComponent* InComp, const int32 InSegMaskId)
+{
+    if (URRActorCommon::IsSegMaskInstanceIdEnabled())
+    {
+        const bool bLabelled = (InSegMaskId > URRActorCommon::DEFAULT_CUSTOM_DEPTH_STENCIL_VALUE_VOID);
+        InComp->SetCustomDepthStencilValue(bLabelled ? SEGMASK_INSTANCE_ID_STENCIL_VALUE
+                                                     : URRActorCommon::DEFAULT_CUSTOM_DEPTH_STENCIL_VALUE_VOID);
+        InComp->SetCustomPrimitiveDataFloat(SEGMASK_ID_CUSTOM_PRIMITIVE_DATA_INDEX, static_cast<float>(InSegMaskId));
+    }
+    else
+    {
+        InComp->SetCustomDepthStencilValue(InSegMaskId);
+    }
+}
+
+int32 URRUObjectUtils::GetSegMaskId(const UPrimitiveComponent* InComp)
+{
+    if (URRActorCommon::IsSegMaskInstanceIdEnabled())
+    {
+        const TArray<float>& customData = InComp->GetCustomPrimitiveData().Data;
+        return customData.IsValidIndex(SEGMASK_ID_CUSTOM_PRIMITIVE_DATA_INDEX)
+                   ? FMath::RoundToInt(customData[SEGMASK_ID_CUSTOM_PRIMITIVE_DATA_INDEX])
+                   : URRActorCommon::DEFAULT_CUSTOM_DEPTH_STENCIL_VALUE_VOID;
+    }
+    return InComp->CustomDepthStencilValue;
+}
+
 FString URRUObjectUtils::GetSegMaskDepthStencilsAsText(AActor* InActor)
 {
+    // Instance ids are output as is by materials, thus written unmapped
+    if (URRActorCommon::IsSegMaskInstanceIdEnabled())
+    {
+        TArray<int32> instanceIdList;
+        if (ARRMeshActor* meshActor = Cast<ARRMeshActor>(InActor))
+        {
+            for (const auto& meshComp : meshActor->MeshCompList)
+            {
+                instanceIdList.AddUnique(GetSegMaskId(meshComp));
+            }
+        }
+        else if (AStaticMeshActor* staticMeshActor = Cast<AStaticMeshActor>(InActor))
+        {
+            instanceIdList.Add(GetSegMaskId(staticMeshActor->GetStaticMeshComponent()));
+        }
+        return FString::JoinBy(instanceIdList, TEXT("/"), [](const int32& InId) { return FString::FromInt(InId); });
+    }
+
     TArray<uint8> depthStencilValueList;
 
     if (ARRMeshActor* meshActor = Cast<ARRMeshActor>(InActor))
@@ -385,9 +452,13 @@ UMaterialInstanceDynamic* URRUObjectUtils::CreateMeshCompMaterialInstance(UMeshC
                                                                           const FString& InMaterialInterfaceName)
 {
     verify(IsValid(InMeshComp));
+    // Reusing the slot's MID of the same material if any, instead of creating a new one upon every call
     const FString& dynamicMaterialName = FString::Printf(TEXT("%s%s"), *InMeshComp->GetName(), *InMaterialInterfaceName);
-    return InMeshComp->CreateDynamicMaterialInstance(
-        InMaterialIndex, URRGameSingleton::Get()->GetMaterial(InMaterialInterfaceName), FName(*dynamicMaterialName));
+    return FRRMaterialInstanceCache::Get(InMeshComp->GetWorld())
+        .GetOrCreate(InMeshComp,
+                     InMaterialIndex,
+                     URRGameSingleton::Get()->GetMaterial(InMaterialInterfaceName),
+                     FName(*dynamicMaterialName));
 }
 
 int32 URRUObjectUtils::GetActorMaterialsNum(AActor* InActor)
@@ -467,40 +538,40 @@ void URRUObjectUtils::ApplyMaterialProps(UMaterialInstanceDynamic* InMaterial,
     {
         if (InMaterialInfo.AlbedoTextureNameList.Num() > 0)
         {
-            InMaterial->SetTextureParameterValue(
-                FRRMaterialProperty::PROP_NAME_ALBEDO,
+            InMaterial->SetTextureParameterValueByInfo(
+                FRRMaterialParameterInfos::ALBEDO,
                 gameSingleton->GetTexture(URRMathUtils::GetRandomElement(InMaterialInfo.AlbedoTextureNameList)));
         }
         // Albedo color
-        InMaterial->SetVectorParameterValue(FRRMaterialProperty::PROP_NAME_COLOR_ALBEDO,
-                                            (InMaterialInfo.AlbedoColorList.Num() > 0)
-                                                ? URRMathUtils::GetRandomElement(InMaterialInfo.AlbedoColorList)
-                                                : FLinearColor::Transparent);
+        InMaterial->SetVectorParameterValueByInfo(FRRMaterialParameterInfos::COLOR_ALBEDO,
+                                                  (InMaterialInfo.AlbedoColorList.Num() > 0)
+                                                      ? URRMathUtils::GetRandomElement(InMaterialInfo.AlbedoColorList)
+                                                      : FLinearColor::Transparent);
 
         // Mask Texture: default White
-        InMaterial->SetTextureParameterValue(FRRMaterialProperty::PROP_NAME_MASK,
-                                             InMaterialInfo.MaskTextureName.IsEmpty()
-                                                 ? whiteMaskTexture
-                                                 : gameSingleton->GetTexture(InMaterialInfo.MaskTextureName));
+        InMaterial->SetTextureParameterValueByInfo(FRRMaterialParameterInfos::MASK,
+                                                   InMaterialInfo.MaskTextureName.IsEmpty()
+                                                       ? whiteMaskTexture
+                                                       : gameSingleton->GetTexture(InMaterialInfo.MaskTextureName));
     }
     else
     {
         // Mask Texture: default Black
-        InMaterial->SetTextureParameterValue(FRRMaterialProperty::PROP_NAME_MASK, blackMaskTexture);
+        InMaterial->SetTextureParameterValueByInfo(FRRMaterialParameterInfos::MASK, blackMaskTexture);
     }
 
     // ORM Texture
     if (false == InMaterialInfo.ORMTextureName.IsEmpty())
     {
-        InMaterial->SetTextureParameterValue(FRRMaterialProperty::PROP_NAME_ORM,
-                                             gameSingleton->GetTexture(InMaterialInfo.ORMTextureName));
+        InMaterial->SetTextureParameterValueByInfo(FRRMaterialParameterInfos::ORM,
+                                                   gameSingleton->GetTexture(InMaterialInfo.ORMTextureName));
     }
 
     // Normal Texture
     if (false == InMaterialInfo.NormalTextureName.IsEmpty())
     {
-        InMaterial->SetTextureParameterValue(FRRMaterialProperty::PROP_NAME_NORMAL,
-                                             gameSingleton->GetTexture(InMaterialInfo.NormalTextureName));
+        InMaterial->SetTextureParameterValueByInfo(FRRMaterialParameterInfos::NORMAL,
+                                                   gameSingleton->GetTexture(InMaterialInfo.NormalTextureName));
     }
 }
 
@@ -537,9 +608,9 @@ bool URRUObjectUtils::SetMeshActorColor(AActor* InMeshActor, const FLinearColor&
         UMaterialInstanceDynamic* material = Cast<UMaterialInstanceDynamic>(meshComp->GetMaterial(i));
         if (material)
         {
-            material->SetTextureParameterValue(FRRMaterialProperty::PROP_NAME_MASK, maskTexture);
-            material->SetVectorParameterValue(FRRMaterialProperty::PROP_NAME_COLOR_ALBEDO, InColor);
-            material->SetScalarParameterValue(FRRMaterialProperty::PROP_NAME_EMISSIVE_STRENGTH, emissiveStrength);
+            material->SetTextureParameterValueByInfo(FRRMaterialParameterInfos::MASK, maskTexture);
+            material->SetVectorParameterValueByInfo(FRRMaterialParameterInfos::COLOR_ALBEDO, InColor);
+            material->SetScalarParameterValueByInfo(FRRMaterialParameterInfos::EMISSIVE_STRENGTH, emissiveStrength);
         }
     }
     return true;
@@ -550,6 +621,12 @@ void URRUObjectUtils::RandomizeActorAppearance(AActor* InActor, const FRRTexture
     UMeshComponent* baseMeshComp = nullptr;
     if (auto* meshActor = Cast<ARRMeshActor>(InActor))
     {
+        // Instanced entities share their materials, thus only their per-instance albedo color is randomized
+        if (meshActor->InstancedGroupComp.IsValid())
+        {
+            meshActor->InstancedGroupComp->SetInstanceColorAlbedo(meshActor->InstanceIndex, URRMathUtils::GetRandomColor());
+            return;
+        }
         baseMeshComp = meshActor->BaseMeshComp;
     }
     else if (auto* staticMeshActor = Cast<AStaticMeshActor>(InActor))
@@ -558,6 +635,7 @@ void URRUObjectUtils::RandomizeActorAppearance(AActor* InActor, const FRRTexture
     }
     check(baseMeshComp);
 
+    FRRMaterialInstanceCache& materialInstanceCache = FRRMaterialInstanceCache::Get(InActor->GetWorld());
     for (auto i = 0; i < baseMeshComp->GetMaterials().Num(); ++i)
     {
         UMaterialInstanceDynamic* baseMaterial = Cast<UMaterialInstanceDynamic>(baseMeshComp->GetMaterial(i));
@@ -569,9 +647,130 @@ void URRUObjectUtils::RandomizeActorAppearance(AActor* InActor, const FRRTexture
         }
         else
         {
-            baseMaterial = baseMeshComp->CreateAndSetMaterialInstanceDynamicFromMaterial(i, baseMeshComp->GetMaterial(i));
+            baseMaterial = materialInstanceCache.GetOrCreate(baseMeshComp, i, baseMeshComp->GetMaterial(i));
+            if (nullptr == baseMaterial)
+            {
+                continue;
+            }
+        }
+        baseMaterial->SetTextureParameterValueByInfo(FRRMaterialParameterInfos::ALBEDO, InTextureData.GetRandomTexture());
+        baseMaterial->SetVectorParameterValueByInfo(FRRMaterialParameterInfos::COLOR_ALBEDO, URRMathUtils::GetRandomColor());
+    }
+}
+
+void URRUObjectUtils::RandomizeActorsAppearance(const TArray<AActor*>& InActors,
+                                                const FRRTextureData& InTextureData,
+                                                const int32 InSeed)
+{
+    check(IsInGameThread());
+
+    // One sample per instanced entity, or per material of other actors', all in flat arrays
+    struct FRRAppearanceTarget
+    {
+        ARRMeshActor* InstancedActor = nullptr;
+        UMeshComponent* MeshComp = nullptr;
+        int32 FirstSampleIdx = 0;
+        int32 SamplesNum = 0;
+    };
+    TArray<FRRAppearanceTarget> targets;
+    targets.SetNum(InActors.Num());
+    int32 samplesNum = 0;
+    int32 textureDrawsNum = 0;
+    for (int32 i = 0; i < InActors.Num(); ++i)
+    {
+        FRRAppearanceTarget& target = targets[i];
+        target.FirstSampleIdx = samplesNum;
+        if (auto* meshActor = Cast<ARRMeshActor>(InActors[i]))
+        {
+            // Instanced entities share their materials, thus only their per-instance albedo color is randomized
+            if (meshActor->InstancedGroupComp.IsValid())
+            {
+                target.InstancedActor = meshActor;
+                target.SamplesNum = 1;
+            }
+            else
+            {
+                target.MeshComp = meshActor->BaseMeshComp;
+            }
         }
-        baseMaterial->SetTextureParameterValue(FRRMaterialProperty::PROP_NAME_ALBEDO, InTextureData.GetRandomTexture());
-        baseMaterial->SetVectorParameterValue(FRRMaterialProperty::PROP_NAME_COLOR_ALBEDO, URRMathUtils::GetRandomColor());
+        else if (auto* staticMeshActor = Cast<AStaticMeshActor>(InActors[i]))
+        {
+            target.MeshComp = staticMeshActor->GetStaticMeshComponent();
+        }
+
+        if (target.MeshComp)
+        {
+            target.SamplesNum = target.MeshComp->GetNumMaterials();
+            textureDrawsNum += target.SamplesNum;
+        }
+        samplesNum += target.SamplesNum;
+    }
+
+    TArray<UTexture*> textures;
+    InTextureData.GetTextures(textures, textureDrawsNum);
+
+    TArray<int32> textureIndices;
+    TArray<FLinearColor> colors;
+    textureIndices.SetNumUninitialized(samplesNum);
+    colors.SetNumUninitialized(samplesNum);
+    ParallelFor(targets.Num(),
+                [&targets, &textures, &textureIndices, &colors, InSeed](const int32 InIdx)
+                {
+                    const FRRAppearanceTarget& target = targets[InIdx];
+                    const FRandomStream stream = URRMathUtils::GetRandomSubstream(InSeed, InIdx);
+                    for (int32 i = target.FirstSampleIdx; i < target.FirstSampleIdx + target.SamplesNum; ++i)
+                    {
+                        textureIndices[i] =
+                            (target.MeshComp && (textures.Num() > 0)) ? stream.RandRange(0, textures.Num() - 1) : INDEX_NONE;
+                        colors[i] = URRMathUtils::GetRandomColor(stream);
+                    }
+                });
+
+    const FMaterialParameterInfo& albedoTextureInfo = FRRMaterialParameterInfos::ALBEDO;
+    const FMaterialParameterInfo& albedoColorInfo = FRRMaterialParameterInfos::COLOR_ALBEDO;
+    TSet<URRInstancedMeshGroupComponent*> instancedGroupComps;
+    for (const auto& target : targets)
+    {
+        if (target.InstancedActor)
+        {
+            URRInstancedMeshGroupComponent* groupComp = target.InstancedActor->InstancedGroupComp.Get();
+            groupComp->SetInstanceColorAlbedo(target.InstancedActor->InstanceIndex, colors[target.FirstSampleIdx], false);
+            instancedGroupComps.Add(groupComp);
+            continue;
+        }
+
+        for (int32 i = 0; i < target.SamplesNum; ++i)
+        {
+            UMaterialInterface* material = target.MeshComp->GetMaterial(i);
+            UMaterialInstanceDynamic* mid = Cast<UMaterialInstanceDynamic>(material);
+            if (nullptr == mid)
+            {
+                mid = FRRMaterialInstanceCache::Get(target.MeshComp->GetWorld()).GetOrCreate(target.MeshComp, i, material);
+                if (nullptr == mid)
+                {
+                    continue;
+                }
+            }
+
+            // Each parameter set is sent to the render thread, thus skipped if unchanged
+            const int32 sampleIdx = target.FirstSampleIdx + i;
+            UTexture* currentTexture = nullptr;
+            if ((INDEX_NONE != textureIndices[sampleIdx]) &&
+                (!mid->GetTextureParameterValue(albedoTextureInfo, currentTexture, true) ||
+                 (currentTexture != textures[textureIndices[sampleIdx]])))
+            {
+                mid->SetTextureParameterValueByInfo(albedoTextureInfo, textures[textureIndices[sampleIdx]]);
+            }
+            FLinearColor currentColor;
+            if (!mid->GetVectorParameterValue(albedoColorInfo, currentColor, true) || (currentColor != colors[sampleIdx]))
+            {
+                mid->SetVectorParameterValueByInfo(albedoColorInfo, colors[sampleIdx]);
+            }
+        }
+    }
+
+    for (auto* groupComp : instancedGroupComps)
+    {
+        groupComp->MarkRenderStateDirty();
     }
 }
@@ -5,6 +5,8 @@
 // RapyutaSimulationPlugins
 #include "Core/RRConversionUtils.h"
 #include "Core/RRCoreUtils.h"
+#include "Core/RRRobotModelCache.h"
+#include "Tools/RRStartupProfiler.h"
 
 static TArray<const TCHAR*> UE_ELEMENT_LIST = {TEXT("ue_sensor_ray_scan_horizontal"),
                                                TEXT("ue_sensor_ray_scan_vertical"),
@@ -19,6 +21,80 @@ static TArray<const TCHAR*> UE_ELEMENT_LIST = {TEXT("ue_sensor_ray_scan_horizont
                                                TEXT("ue_material_orm"),
                                                TEXT("ue_material_normal")};
 
+namespace
+{
+/**
+ * @brief Parse up to InMaxNum whitespace-separated floats from InText, without allocating temporary strings
+ * @param InText
+ * @param OutValues Left untouched beyond the returned number
+ * @param InMaxNum
+ * @return int32 Number of parsed values
+ */
+int32 ParseFloats(const TCHAR* InText, float* OutValues, const int32 InMaxNum)
+{
+    int32 num = 0;
+    const TCHAR* cursor = InText;
+    while (cursor && (num < InMaxNum))
+    {
+        while (FChar::IsWhitespace(*cursor))
+        {
+            ++cursor;
+        }
+        TCHAR* end = nullptr;
+        const double value = FCString::Strtod(cursor, &end);
+        if ((TEXT('\0') == *cursor) || (end == cursor))
+        {
+            break;
+        }
+        OutValues[num++] = static_cast<float>(value);
+        cursor = end;
+    }
+    return num;
+}
+}    // namespace
+
+FRRURDFParser::ERRURDFElement FRRURDFParser::GetElementToken(const TCHAR* InElementName)
+{
+    struct FElementToken
+    {
+        const TCHAR* Name;
+        ERRURDFElement Token;
+    };
+    static constexpr FElementToken ELEMENT_TOKENS[] = {
+        {TEXT("robot"), ERRURDFElement::ROBOT},
+        {TEXT("joint"), ERRURDFElement::JOINT},
+        {TEXT("link"), ERRURDFElement::LINK},
+        {TEXT("transmission"), ERRURDFElement::TRANSMISSION},
+        {TEXT("ue"), ERRURDFElement::UE},
+        {TEXT("material"), ERRURDFElement::MATERIAL},
+        {TEXT("visual"), ERRURDFElement::VISUAL},
+        {TEXT("inertial"), ERRURDFElement::INERTIAL},
+        {TEXT("collision"), ERRURDFElement::COLLISION},
+        {TEXT("sensor"), ERRURDFElement::SENSOR},
+        {TEXT("component"), ERRURDFElement::COMPONENT},
+        {TEXT("base_link"), ERRURDFElement::BASE_LINK},
+        {TEXT("articulated_link"), ERRURDFElement::ARTICULATED_LINK},
+        {TEXT("wheel"), ERRURDFElement::WHEEL},
+        {TEXT("end_effector"), ERRURDFElement::END_EFFECTOR},
+        {TEXT("albedo"), ERRURDFElement::ALBEDO},
+        {TEXT("orm"), ERRURDFElement::ORM},
+        {TEXT("normal"), ERRURDFElement::NORMAL},
+        {TEXT("ray"), ERRURDFElement::RAY},
+        {TEXT("lidar"), ERRURDFElement::LIDAR},
+        {TEXT("horizontal"), ERRURDFElement::HORIZONTAL},
+        {TEXT("vertical"), ERRURDFElement::VERTICAL},
+        {TEXT("range"), ERRURDFElement::RANGE},
+        {TEXT("noise"), ERRURDFElement::NOISE}};
+    for (const auto& elementToken : ELEMENT_TOKENS)
+    {
+        if (0 == FCString::Strcmp(InElementName, elementToken.Name))
+        {
+            return elementToken.Token;
+        }
+    }
+    return ERRURDFElement::OTHER;
+}
+
 bool FRRURDFParser::ProcessAttribute(const TCHAR* InAttributeName, const TCHAR* InAttributeValueText)
 {
     // (NOTE) Except critical error case, always return true to keep reading until end of file!
@@ -27,39 +103,30 @@ bool FRRURDFParser::ProcessAttribute(const TCHAR* InAttributeName, const TCHAR*
 
     if (!attName.IsEmpty() && !attValueString.IsEmpty())
     {
-        TArray<int32> indexGroup;
-        int32 max;
-
-        FString elementStackTop = ElemStack.Top();
-        FString elements = FString::Join(ElemStack, TEXT("_"));
+        const FString& elementStackTop = ElemStack.Top();
+        const ERRURDFElement topToken = ElemTokenStack.Top();
 
-        if (!attValueString.IsEmpty())
+        for (uint32 ueElementMask = UEElementMasks.Top(); ueElementMask != 0; ueElementMask &= ueElementMask - 1)
         {
-            for (const auto& ueElement : UE_ELEMENT_LIST)
-            {
-                if (elements.Contains(ueElement))
-                {
-                    AttMap.Add(ComposeAttributeKey(ueElement, attName), attValueString);
-                }
-            }
+            AttMap.Add(ComposeAttributeKey(UE_ELEMENT_LIST[FMath::CountTrailingZeros(ueElementMask)], attName), attValueString);
         }
 
-        if (elementStackTop.Equals(TEXT("robot")) && attName.Equals(TEXT("name")))
+        if ((ERRURDFElement::ROBOT == topToken) && attName.Equals(TEXT("name")))
         {
             ModelName = attValueString;
         }
-        else if (elementStackTop.Equals(TEXT("joint")))
+        else if (ERRURDFElement::JOINT == topToken)
         {
             // Look which element is the current one.
-            const int32 indexTransmission = ElemStack.FindLast(TEXT("transmission"));
-            const int32 indexJoint = ElemStack.FindLast(TEXT("joint"));
-            const int32 indexLink = ElemStack.FindLast(TEXT("link"));
-            const int32 indexUE = ElemStack.FindLast(TEXT("ue"));
-            const int32 indexMaterial = ElemStack.FindLast(TEXT("material"));
+            const int32 indexTransmission = FindLastElement(ERRURDFElement::TRANSMISSION);
+            const int32 indexJoint = FindLastElement(ERRURDFElement::JOINT);
+            const int32 indexLink = FindLastElement(ERRURDFElement::LINK);
+            const int32 indexUE = FindLastElement(ERRURDFElement::UE);
+            const int32 indexMaterial = FindLastElement(ERRURDFElement::MATERIAL);
 
             // Check current context
-            indexGroup = {indexTransmission, indexJoint, indexLink, indexUE, indexMaterial};
-            max = FMath::Max<int32>(indexGroup);
+            const int32 max =
+                FMath::Max(FMath::Max3(indexTransmission, indexJoint, indexLink), FMath::Max(indexUE, indexMaterial));
 
             // Handle special case 1 of joint tags within a transmission tag
             if ((ELEMENT_INDEX_NONE != indexTransmission) && (max == indexTransmission))
@@ -84,18 +151,17 @@ bool FRRURDFParser::ProcessAttribute(const TCHAR* InAttributeName, const TCHAR*
 
         // Handles the sub categories for Links
         // (elementStackTop: origin, geometry(mesh, box, cylinder, sphere), material, mass, inertia)
-        else if (!elementStackTop.Equals(TEXT("robot")) && !elementStackTop.Equals(TEXT("ue")) &&
-                 !elementStackTop.Equals(TEXT("transmission")) && !elementStackTop.Equals(TEXT("link")) &&
-                 (ElemStack.FindLast(TEXT("link")) > ElemStack.FindLast(TEXT("joint"))))
+        else if ((ERRURDFElement::ROBOT != topToken) && (ERRURDFElement::UE != topToken) &&
+                 (ERRURDFElement::TRANSMISSION != topToken) && (ERRURDFElement::LINK != topToken) &&
+                 (FindLastElement(ERRURDFElement::LINK) > FindLastElement(ERRURDFElement::JOINT)))
         {
             // Look which element is the current one.
-            int32 indexVisual = ElemStack.FindLast(TEXT("visual"));
-            int32 indexInertial = ElemStack.FindLast(TEXT("inertial"));
-            int32 indexCollision = ElemStack.FindLast(TEXT("collision"));
+            const int32 indexVisual = FindLastElement(ERRURDFElement::VISUAL);
+            const int32 indexInertial = FindLastElement(ERRURDFElement::INERTIAL);
+            const int32 indexCollision = FindLastElement(ERRURDFElement::COLLISION);
 
             // Check current context
-            indexGroup = {indexVisual, indexInertial, indexCollision};
-            max = FMath::Max<int32>(indexGroup);
+            const int32 max = FMath::Max3(indexVisual, indexInertial, indexCollision);
 #if RAPYUTA_URDF_PARSER_DEBUG
             UE_LOG_WITH_INFO(LogRapyutaCore, VeryVerbose, TEXT(" INDEX  %d %d %d"), indexVisual, indexInertial, indexCollision);
             UE_LOG_WITH_INFO(LogRapyutaCore, VeryVerbose, TEXT("%s - %s"), *attName, *attValueString);
@@ -119,31 +185,31 @@ bool FRRURDFParser::ProcessAttribute(const TCHAR* InAttributeName, const TCHAR*
                     LogRapyutaCore, Error, TEXT("Unexpected attribute in robot description %s - %s"), *attName, *attValueString);
             }
         }
-        else if (elementStackTop.Equals(TEXT("sensor")) || elementStackTop.Equals(TEXT("component")) ||
-                 elementStackTop.Equals(TEXT("base_link")) || elementStackTop.Equals(TEXT("articulated_link")) ||
-                 elementStackTop.Equals(TEXT("wheel")) || elementStackTop.Equals(TEXT("end_effector")) ||
-                 elementStackTop.Equals(TEXT("material")))
+        else if ((ERRURDFElement::SENSOR == topToken) || (ERRURDFElement::COMPONENT == topToken) ||
+                 (ERRURDFElement::BASE_LINK == topToken) || (ERRURDFElement::ARTICULATED_LINK == topToken) ||
+                 (ERRURDFElement::WHEEL == topToken) || (ERRURDFElement::END_EFFECTOR == topToken) ||
+                 (ERRURDFElement::MATERIAL == topToken))
         {
             AttMap.Add(ComposeAttributeKey(elementStackTop, attName, TEXT("ue")), attValueString);
         }
-        else if (elementStackTop.Equals(TEXT("albedo")) || elementStackTop.Equals(TEXT("orm")) ||
-                 elementStackTop.Equals(TEXT("normal")))
+        else if ((ERRURDFElement::ALBEDO == topToken) || (ERRURDFElement::ORM == topToken) ||
+                 (ERRURDFElement::NORMAL == topToken))
         {
             AttMap.Add(ComposeAttributeKey(elementStackTop, attName, TEXT("ue_material")), attValueString);
         }
-        else if (elementStackTop.Equals(TEXT("ray")) || elementStackTop.Equals(TEXT("lidar")))
+        else if ((ERRURDFElement::RAY == topToken) || (ERRURDFElement::LIDAR == topToken))
         {
             AttMap.Add(ComposeAttributeKey(elementStackTop, attName, TEXT("ue_sensor")), attValueString);
         }
-        else if (elementStackTop.Equals(TEXT("horizontal")) || elementStackTop.Equals(TEXT("vertical")))
+        else if ((ERRURDFElement::HORIZONTAL == topToken) || (ERRURDFElement::VERTICAL == topToken))
         {
             AttMap.Add(ComposeAttributeKey(elementStackTop, attName, TEXT("ue_sensor_scan")), attValueString);
         }
-        else if (elementStackTop.Equals(TEXT("range")))
+        else if (ERRURDFElement::RANGE == topToken)
         {
             AttMap.Add(ComposeAttributeKey(elementStackTop, attName, TEXT("ue_sensor_lidar")), attValueString);
         }
-        else if (elementStackTop.Equals(TEXT("noise")))
+        else if (ERRURDFElement::NOISE == topToken)
         {
             AttMap.Add(ComposeAttributeKey(elementStackTop, attName, TEXT("ue_sensor_lidar")), attValueString);
         }
@@ -170,15 +236,28 @@ bool FRRURDFParser::ProcessElement(const TCHAR* InElementName, const TCHAR* InEl
     if (!elementName.IsEmpty())
     {
         ElemStack.Push(elementName);
-        FString elements = FString::Join(ElemStack, TEXT("_"));
+        ElemTokenStack.Push(GetElementToken(InElementName));
+        ElemPathLengths.Push(ElemPath.Len());
+        if (!ElemPath.IsEmpty())
+        {
+            ElemPath.AppendChar(TEXT('_'));
+        }
+        ElemPath.Append(elementName);
 
-        for (const auto& ueElement : UE_ELEMENT_LIST)
+        // The UE elements contained in the path only change upon push/pop, thus are matched once here for all attributes
+        uint32 ueElementMask = 0;
+        for (auto i = 0; i < UE_ELEMENT_LIST.Num(); ++i)
         {
-            if (elements.Contains(ueElement) && !elementData.IsEmpty())
+            if (ElemPath.Contains(UE_ELEMENT_LIST[i]))
             {
-                AttMap.Add(ComposeAttributeKey(ueElement, elementName), elementData);
+                ueElementMask |= (1u << i);
+                if (!elementData.IsEmpty())
+                {
+                    AttMap.Add(ComposeAttributeKey(UE_ELEMENT_LIST[i], elementName), elementData);
+                }
             }
         }
+        UEElementMasks.Push(ueElementMask);
         return true;
     }
     else
@@ -191,7 +270,8 @@ bool FRRURDFParser::ProcessElement(const TCHAR* InElementName, const TCHAR* InEl
 bool FRRURDFParser::ProcessClose(const TCHAR* InElementName)
 {
     // (NOTE) Except critical error case, always return true to keep reading until end of file!
-    const FString elementStackTop = ElemStack.Top();
+    const FString& elementStackTop = ElemStack.Top();
+    const ERRURDFElement topToken = ElemTokenStack.Top();
 #if RAPYUTA_URDF_PARSER_DEBUG
     // For debugging only
     if (false == FString(InElementName).Equals(elementStackTop))
@@ -207,18 +287,18 @@ bool FRRURDFParser::ProcessClose(const TCHAR* InElementName)
 
     bool bElementSupported = false;
     bool bResult = true;
-    if (elementStackTop.Equals(TEXT("joint")))
+    if (ERRURDFElement::JOINT == topToken)
     {
         bElementSupported = true;
         bResult = ParseJointProperty();
     }
-    else if (elementStackTop.Equals(TEXT("link")))
+    else if (ERRURDFElement::LINK == topToken)
     {
         bElementSupported = true;
         bResult = ParseLinkProperty();
     }
     // NOTE: <ue> tags must stay at the end of .urdf file, after all <link> ones & each cannot have duplicated child tags
-    else if (elementStackTop.Equals(TEXT("ue")))
+    else if (ERRURDFElement::UE == topToken)
     {
         bElementSupported = true;
         // Parse link's material + sensor
@@ -235,7 +315,10 @@ bool FRRURDFParser::ProcessClose(const TCHAR* InElementName)
     }
 
     // Pop elem out of the stack for the next read (ProcessClose)
-    ElemStack.Pop();
+    ElemStack.Pop(false);
+    ElemTokenStack.Pop(false);
+    ElemPath.LeftInline(ElemPathLengths.Pop(false), false);
+    UEElementMasks.Pop(false);
     return bResult;
 }
 
@@ -317,6 +400,24 @@ void FRRURDFParser::ParseModelUESpecifics()
     }
     WholeBodyMaterialInfo.ORMTextureName = AttMap.FindRef(TEXT("ue_material_orm_name"));
     WholeBodyMaterialInfo.NormalTextureName = AttMap.FindRef(TEXT("ue_material_normal_name"));
+
+    // 7- Mesh LODs, eg: ue_mesh_lod_screen_sizes="0.3 0.1" ue_mesh_lod_triangles_ratio="0.4"
+    const FString lodScreenSizesText = AttMap.FindRef(TEXT("ue_mesh_lod_screen_sizes"));
+    if (!lodScreenSizesText.IsEmpty())
+    {
+        TArray<FString> screenSizesText;
+        lodScreenSizesText.ParseIntoArray(screenSizesText, URRActorCommon::SPACE_STR, true);
+        MeshLODSettings.ScreenSizes.Reset(screenSizesText.Num());
+        for (const auto& screenSizeText : screenSizesText)
+        {
+            MeshLODSettings.ScreenSizes.Add(FCString::Atof(*screenSizeText));
+        }
+    }
+    const FString lodTrianglesRatioText = AttMap.FindRef(TEXT("ue_mesh_lod_triangles_ratio"));
+    if (!lodTrianglesRatioText.IsEmpty())
+    {
+        MeshLODSettings.TrianglesRatio = FMath::Clamp(FCString::Atof(*lodTrianglesRatioText), 0.01f, 1.f);
+    }
 }
 
 bool FRRURDFParser::ParseJointProperty()
@@ -535,13 +636,9 @@ bool FRRURDFParser::ParseLinkProperty()
         // Visual Color element
         if (AttMap.Contains(TEXT("visual_color_rgba")))
         {
-            TArray<FString> visualColorArray;
-
-            AttMap.FindRef(TEXT("visual_color_rgba")).ParseIntoArray(visualColorArray, URRActorCommon::SPACE_STR, true);
-            visualMaterialColor = FColor(FCString::Atof(*visualColorArray[0]),
-                                         FCString::Atof(*visualColorArray[1]),
-                                         FCString::Atof(*visualColorArray[2]),
-                                         FCString::Atof(*visualColorArray[3]));
+            float rgba[4] = {0.f, 0.f, 0.f, 0.f};
+            ParseFloats(*AttMap.FindRef(TEXT("visual_color_rgba")), rgba, 4);
+            visualMaterialColor = FColor(rgba[0], rgba[1], rgba[2], rgba[3]);
         }
 
         // Visual Material element
@@ -629,6 +726,19 @@ bool FRRURDFParser::ParseSensorProperty(FRRSensorProperty& OutSensorProp)
             outLidarInfo.NoiseMean = FCString::Atod(*AttMap.FindRef(TEXT("ue_sensor_ray_noise_mean")));
             outLidarInfo.NoiseStdDev = FCString::Atod(*AttMap.FindRef(TEXT("ue_sensor_ray_noise_stddev")));
         }
+        break;
+
+        case ERRSensorType::CAMERA:
+        {
+            auto& outCameraInfo = OutSensorProp.CameraInfo;
+            outCameraInfo.CaptureProfileName = AttMap.FindRef(TEXT("ue_sensor_camera_capture_profile"));
+            outCameraInfo.Width = FCString::Atoi(*AttMap.FindRef(TEXT("ue_sensor_camera_image_width")));
+            outCameraInfo.Height = FCString::Atoi(*AttMap.FindRef(TEXT("ue_sensor_camera_image_height")));
+        }
+        break;
+
+        default:
+            break;
     }    // End switch (sensorType)
 
     return true;
@@ -636,51 +746,53 @@ bool FRRURDFParser::ParseSensorProperty(FRRSensorProperty& OutSensorProp)
 
 FVector FRRURDFParser::ParseVector(const FString& InElementName, bool bIsForLocation)
 {
-    TArray<FString> vectorText;
+    const FString* elementText = AttMap.Find(InElementName);
+    float values[3] = {0.f, 0.f, 0.f};
+    const int32 valuesNum = elementText ? ParseFloats(**elementText, values, 3) : 0;
 
     // Output Vector's meaning is different for spheres.
     if (InElementName.Contains(TEXT("sphere_radius")))
     {
-        AttMap.FindRef(InElementName).ParseIntoArray(vectorText, URRActorCommon::SPACE_STR, true);
-        float diameter = 2.f * FCString::Atof(*vectorText[0]);
+        float diameter = 2.f * values[0];
 
         return URRConversionUtils::SizeROSToUE(FVector(diameter));
     }
 
-    const FString elementText = AttMap.FindRef(InElementName);
-    elementText.ParseIntoArray(vectorText, URRActorCommon::SPACE_STR, true);
-    if (vectorText.Num() < 3)
+    if (valuesNum < 3)
     {
-        UE_LOG_WITH_INFO(
-            LogRapyutaCore, Error, TEXT("[%s]: %s does not represent a 3d vector value!"), *InElementName, *elementText);
+        UE_LOG_WITH_INFO(LogRapyutaCore,
+                         Error,
+                         TEXT("[%s]: %s does not represent a 3d vector value!"),
+                         *InElementName,
+                         elementText ? **elementText : TEXT(""));
     }
-    const FVector urdfVector(FCString::Atof(*vectorText[0]), FCString::Atof(*vectorText[1]), FCString::Atof(*vectorText[2]));
+    const FVector urdfVector(values[0], values[1], values[2]);
     return bIsForLocation ? URRConversionUtils::VectorROSToUE(urdfVector) : urdfVector;
 }
 
 FTransform FRRURDFParser::ParsePose(const FString& InElementName)
 {
-    TArray<FString> poseText;
-
-    const FString elementText = AttMap.FindRef(InElementName);
-    elementText.ParseIntoArray(poseText, URRActorCommon::SPACE_STR, true);
-    if (poseText.Num() < 6)
+    const FString* elementText = AttMap.Find(InElementName);
+    float values[6] = {0.f, 0.f, 0.f, 0.f, 0.f, 0.f};
+    if ((elementText ? ParseFloats(**elementText, values, 6) : 0) < 6)
     {
-        UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("[%s]: %s does not represent a 6d pose value!"), *InElementName, *elementText);
+        UE_LOG_WITH_INFO(LogRapyutaCore,
+                         Error,
+                         TEXT("[%s]: %s does not represent a 6d pose value!"),
+                         *InElementName,
+                         elementText ? **elementText : TEXT(""));
     }
-    const FVector translation(FCString::Atof(*poseText[0]), FCString::Atof(*poseText[1]), FCString::Atof(*poseText[2]));
+    const FVector translation(values[0], values[1], values[2]);
 
     // URDF: rpy
     // FRotator(pitch, yaw, roll)
-    const FRotator rotation(FCString::Atof(*poseText[4]), FCString::Atof(*poseText[5]), FCString::Atof(*poseText[3]));
+    const FRotator rotation(values[4], values[5], values[3]);
 
     return FTransform(rotation, translation);
 }
 
 FQuat FRRURDFParser::ParseRotation(const FString& InElementName)
 {
-    TArray<FString> rotationText;
-
     //**********************************************************************
     // In URDF the order of axes might be different to the order in UE4
     //
@@ -688,45 +800,51 @@ FQuat FRRURDFParser::ParseRotation(const FString& InElementName)
     // size z, y, x
     // rotation (rpy) roll, pitch, yaw (UE4 pitch, yaw, roll)
     //**********************************************************************
-    const FString elementText = AttMap.FindRef(InElementName);
-    elementText.ParseIntoArray(rotationText, URRActorCommon::SPACE_STR, true);
-    if (rotationText.Num() < 3)
+    const FString* elementText = AttMap.Find(InElementName);
+    float values[3] = {0.f, 0.f, 0.f};
+    if ((elementText ? ParseFloats(**elementText, values, 3) : 0) < 3)
     {
-        UE_LOG_WITH_INFO(
-            LogRapyutaCore, Error, TEXT("[%s]: %s does not represent a 3d rotation value!"), *InElementName, *elementText);
+        UE_LOG_WITH_INFO(LogRapyutaCore,
+                         Error,
+                         TEXT("[%s]: %s does not represent a 3d rotation value!"),
+                         *InElementName,
+                         elementText ? **elementText : TEXT(""));
     }
 
-    float urdf_R = FMath::RadiansToDegrees(FCString::Atof(*rotationText[0]));
-    float urdf_P = FMath::RadiansToDegrees(FCString::Atof(*rotationText[1]));
-    float urdf_Y = FMath::RadiansToDegrees(FCString::Atof(*rotationText[2]));
+    float urdf_R = FMath::RadiansToDegrees(values[0]);
+    float urdf_P = FMath::RadiansToDegrees(values[1]);
+    float urdf_Y = FMath::RadiansToDegrees(values[2]);
 
     return URRConversionUtils::QuatROSToUE(FQuat(FRotator(urdf_P, urdf_Y, urdf_R)));
 }
 
 FVector FRRURDFParser::ParseCylinderSize(const FString& InRadiusElementName, const FString& InLengthElementName)
 {
-    TArray<FString> radiusText, lengthText;
-
     // [Radius]
-    const FString radiusElementText = AttMap.FindRef(InRadiusElementName);
-    radiusElementText.ParseIntoArray(radiusText, URRActorCommon::SPACE_STR, true);
-    if (radiusText.Num() < 1)
+    const FString* radiusElementText = AttMap.Find(InRadiusElementName);
+    float radius = 0.f;
+    if ((radiusElementText ? ParseFloats(**radiusElementText, &radius, 1) : 0) < 1)
     {
-        UE_LOG_WITH_INFO(
-            LogRapyutaCore, Error, TEXT("[%s]: %s does not represent a radius value!"), *InRadiusElementName, *radiusElementText);
+        UE_LOG_WITH_INFO(LogRapyutaCore,
+                         Error,
+                         TEXT("[%s]: %s does not represent a radius value!"),
+                         *InRadiusElementName,
+                         radiusElementText ? **radiusElementText : TEXT(""));
     }
 
     // [Length]
-    const FString lengthElementText = AttMap.FindRef(InLengthElementName);
-    lengthElementText.ParseIntoArray(lengthText, URRActorCommon::SPACE_STR, true);
-    if (lengthText.Num() < 1)
+    const FString* lengthElementText = AttMap.Find(InLengthElementName);
+    float length = 0.f;
+    if ((lengthElementText ? ParseFloats(**lengthElementText, &length, 1) : 0) < 1)
     {
-        UE_LOG_WITH_INFO(
-            LogRapyutaCore, Error, TEXT("[%s]: %s does not represent a length value!"), *InLengthElementName, *lengthElementText);
+        UE_LOG_WITH_INFO(LogRapyutaCore,
+                         Error,
+                         TEXT("[%s]: %s does not represent a length value!"),
+                         *InLengthElementName,
+                         lengthElementText ? **lengthElementText : TEXT(""));
     }
 
-    float diameter = 2.f * FCString::Atof(*radiusText[0]);
-    float length = FCString::Atof(*lengthText[0]);
+    float diameter = 2.f * radius;
 
     return URRConversionUtils::SizeROSToUE(FVector(diameter, diameter, length));
 }
@@ -801,6 +919,7 @@ bool FRRURDFParser::ParseGeometryInfo(const FString& InLinkName,
 
 FRRRobotModelInfo FRRURDFParser::LoadModelInfoFromFile(const FString& InURDFPath)
 {
+    FRRStartupPhaseScope startupPhaseScope(ERRStartupPhase::ROBOT_DESCRIPTION_PARSING);
     FString outXMLContent;
     if (!FFileHelper::LoadFileToString(outXMLContent, *InURDFPath, FFileHelper::EHashOptions::None))
     {
@@ -809,6 +928,16 @@ FRRRobotModelInfo FRRURDFParser::LoadModelInfoFromFile(const FString& InURDFPath
     }
     outXMLContent = URRCoreUtils::GetSanitizedXMLString(outXMLContent);
 
+    // Identical models, eg of a robot fleet, are only parsed once
+    const FString contentHash =
+        FRRRobotModelCache::IsEnabled() ? FRRRobotModelCache::GetContentHash(InURDFPath, outXMLContent) : FString();
+    FRRRobotModelInfo cachedModelInfo;
+    if (!contentHash.IsEmpty() && FRRRobotModelCache::Find(contentHash, cachedModelInfo))
+    {
+        cachedModelInfo.Data.DescriptionFilePath = InURDFPath;
+        return cachedModelInfo;
+    }
+
 #if RAPYUTA_URDF_PARSER_DEBUG
     UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("PARSE URDF CONTENT FROM FILE %s"), *InURDFPath);
 #endif
@@ -819,6 +948,10 @@ FRRRobotModelInfo FRRURDFParser::LoadModelInfoFromFile(const FString& InURDFPath
     if (LoadModelInfoFromXML(outXMLContent, robotModelInfo))
     {
         robotModelData.UpdateLinksLocationFromJoints();
+        if (!contentHash.IsEmpty())
+        {
+            FRRRobotModelCache::Add(contentHash, robotModelInfo);
+        }
     }
     return robotModelInfo;
 }
@@ -882,6 +1015,9 @@ bool FRRURDFParser::LoadModelInfoFromXML(const FString& InUrdfXml, FRRRobotModel
 
         // 4- WholeBodyMaterialInfo
         outRobotModelData.WholeBodyMaterialInfo = MoveTemp(WholeBodyMaterialInfo);
+
+        // 5- MeshLODSettings
+        outRobotModelData.MeshLODSettings = MoveTemp(MeshLODSettings);
     }
     else
     {
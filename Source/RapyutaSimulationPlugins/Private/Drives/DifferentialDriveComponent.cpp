@@ -7,6 +7,7 @@
 
 // RapyutaSimulationPlugins
 #include "Core/RRConversionUtils.h"
+#include "Drives/RRPhysicsSubstepManager.h"
 
 DEFINE_LOG_CATEGORY(LogDifferentialDriveComponent);
 
@@ -29,6 +30,11 @@ void UDifferentialDriveComponent::SetWheels(UPhysicsConstraintComponent* InWheel
 
     fSetWheel(WheelLeft, InWheelLeft);
     fSetWheel(WheelRight, InWheelRight);
+
+    // Drive params have just been set, proxies are resolved anew
+    WheelLeftDrive = FRRWheelDriveCache();
+    WheelRightDrive = FRRWheelDriveCache();
+    DriveMaxForce = MaxForce;
 }
 
 void UDifferentialDriveComponent::SetPerimeter()
@@ -40,7 +46,9 @@ void UDifferentialDriveComponent::SetPerimeter()
             LogDifferentialDriveComponent, Warning, TEXT("Wheel radius is too small. Wheel radius is reset to 1.0"));
     }
     WheelPerimeter = WheelRadius * 2.f * M_PI;
+    InvWheelPerimeter = 1.f / WheelPerimeter;
 }
+
 void UDifferentialDriveComponent::TickComponent(float InDeltaTime,
                                                 enum ELevelTick TickType,
                                                 FActorComponentTickFunction* ThisTickFunction)
@@ -48,7 +56,25 @@ void UDifferentialDriveComponent::TickComponent(float InDeltaTime,
     Super::TickComponent(InDeltaTime, TickType, ThisTickFunction);
     if (!ShouldSkipUpdate(InDeltaTime))
     {
-        UpdateOdom(InDeltaTime);
+        if (bAggregatedTick)
+        {
+            // Integrated after all differential drives have moved, possibly in parallel
+            PendingOdomDeltaTime += InDeltaTime;
+        }
+        else
+        {
+            UpdateOdom(InDeltaTime);
+        }
+    }
+}
+
+void UDifferentialDriveComponent::UpdatePendingOdom(UActorComponent* InComponent)
+{
+    UDifferentialDriveComponent* driveComp = static_cast<UDifferentialDriveComponent*>(InComponent);
+    if (driveComp->PendingOdomDeltaTime > 0.f)
+    {
+        driveComp->UpdateOdom(driveComp->PendingOdomDeltaTime);
+        driveComp->PendingOdomDeltaTime = 0.f;
     }
 }
 
@@ -59,9 +85,15 @@ void UDifferentialDriveComponent::UpdateMovement(float DeltaTime)
         const float angularVelRad = FMath::DegreesToRadians(AngularVelocity.Z);
         float velL = Velocity.X + angularVelRad * WheelSeparationHalf;
         float velR = Velocity.X - angularVelRad * WheelSeparationHalf;
+        const FVector leftTarget(-velL * InvWheelPerimeter, 0, 0);
+        const FVector rightTarget(-velR * InvWheelPerimeter, 0, 0);
+        if (bPhysicsThreadDrive && SubmitPhysicsThreadDrive(leftTarget, rightTarget))
+        {
+            return;
+        }
 
-        WheelLeft->SetAngularVelocityTarget(FVector(-velL / WheelPerimeter, 0, 0));
-        WheelRight->SetAngularVelocityTarget(FVector(-velR / WheelPerimeter, 0, 0));
+        WheelLeft->SetAngularVelocityTarget(leftTarget);
+        WheelRight->SetAngularVelocityTarget(rightTarget);
         WheelLeft->SetAngularDriveParams(MaxForce, MaxForce, MaxForce);
         WheelRight->SetAngularDriveParams(MaxForce, MaxForce, MaxForce);
     }
@@ -71,6 +103,74 @@ void UDifferentialDriveComponent::UpdateMovement(float DeltaTime)
     }
 }
 
+bool UDifferentialDriveComponent::SubmitPhysicsThreadDrive(const FVector& InLeftTarget, const FVector& InRightTarget)
+{
+    FRRPhysicsSubstepManager* substepManager = FRRPhysicsSubstepManager::Get(GetWorld());
+    if (nullptr == substepManager)
+    {
+        return false;
+    }
+
+    // Re-resolved only once the wheel's Chaos joint has been recreated, eg upon its bodies' re-creation
+    auto fResolveProxy = [](UPhysicsConstraintComponent* InWheel, FRRWheelDriveCache& InOutDrive)
+    {
+        const void* constraint = InWheel->ConstraintInstance.ConstraintHandle.Constraint;
+        if ((nullptr == InOutDrive.Proxy) || (constraint != InOutDrive.Constraint))
+        {
+            InOutDrive = FRRWheelDriveCache();
+            InOutDrive.Constraint = constraint;
+            InOutDrive.Proxy = FRRPhysicsSubstepManager::GetJointProxy(InWheel);
+        }
+        return (nullptr != InOutDrive.Proxy);
+    };
+    if (!fResolveProxy(WheelLeft, WheelLeftDrive) || !fResolveProxy(WheelRight, WheelRightDrive))
+    {
+        return false;
+    }
+
+    // Drive params change the game thread joint settings, which then overwrite the physics thread targets, thus resubmitted
+    const bool bMaxForceChanged = (DriveMaxForce != MaxForce);
+    if (bMaxForceChanged)
+    {
+        WheelLeft->SetAngularDriveParams(MaxForce, MaxForce, MaxForce);
+        WheelRight->SetAngularDriveParams(MaxForce, MaxForce, MaxForce);
+        DriveMaxForce = MaxForce;
+    }
+
+    auto fSubmit = [substepManager, bMaxForceChanged](
+                       UPhysicsConstraintComponent* InWheel, FRRWheelDriveCache& InOutDrive, const FVector& InTarget)
+    {
+        if (bMaxForceChanged || !InOutDrive.bSubmitted || !InTarget.Equals(InOutDrive.LastTarget, 1e-6f))
+        {
+            // [rev/s] -> [rad/s], as by FConstraintInstance::SetAngularVelocityTarget()
+            substepManager->SubmitDriveTarget(InWheel->GetUniqueID(), InOutDrive.Proxy, InTarget * UE_TWO_PI);
+            InOutDrive.LastTarget = InTarget;
+            InOutDrive.bSubmitted = true;
+        }
+    };
+    fSubmit(WheelLeft, WheelLeftDrive, InLeftTarget);
+    fSubmit(WheelRight, WheelRightDrive, InRightTarget);
+    return true;
+}
+
+void UDifferentialDriveComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (bPhysicsThreadDrive)
+    {
+        if (FRRPhysicsSubstepManager* substepManager = FRRPhysicsSubstepManager::Get(GetWorld()))
+        {
+            for (const UPhysicsConstraintComponent* wheel : {WheelLeft, WheelRight})
+            {
+                if (wheel)
+                {
+                    substepManager->RemoveDriveTargets(wheel->GetUniqueID());
+                }
+            }
+        }
+    }
+    Super::EndPlay(EndPlayReason);
+}
+
 void UDifferentialDriveComponent::UpdateOdom(float DeltaTime)
 {
     if (OdomComponent == nullptr)
@@ -89,7 +189,7 @@ void UDifferentialDriveComponent::UpdateOdom(float DeltaTime)
     FROSOdom odomData = OdomComponent->OdomData;
 
     // time
-    odomData.Header.Stamp = URRConversionUtils::FloatToROSStamp(UGameplayStatics::GetTimeSeconds(GetWorld()));
+    odomData.Header.Stamp = URRConversionUtils::GetCurrentROS2Time(this);
 
     // vl and vr as computed here is ok for kinematics
     // for physics, vl and vr should be computed based on the change in wheel orientation (i.e. the velocity term to be used is
@@ -0,0 +1,172 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Drives/RRDriveTickManager.h"
+
+// UE
+#include "Algo/Sort.h"
+#include "Async/ParallelFor.h"
+#include "Components/ActorComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "HAL/IConsoleManager.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRTrace.h"
+
+static TAutoConsoleVariable<bool> CVarDriveTickParallel(
+    TEXT("rr.DriveTick.Parallel"),
+    true,
+    TEXT("Run the parallel updates of FRRDriveTickManager groups in a ParallelFor across robots, else serially."),
+    ECVF_Default);
+
+void FRRDriveTickFunction::ExecuteTick(float DeltaTime,
+                                       ELevelTick TickType,
+                                       ENamedThreads::Type CurrentThread,
+                                       const FGraphEventRef& MyCompletionGraphEvent)
+{
+    if (Group && (TickType != LEVELTICK_ViewportsOnly))
+    {
+        Group->Tick(DeltaTime, TickType);
+    }
+}
+
+FRRDriveTickGroup::~FRRDriveTickGroup()
+{
+    if (TickFunction.IsTickFunctionRegistered())
+    {
+        TickFunction.UnRegisterTickFunction();
+    }
+}
+
+void FRRDriveTickGroup::Tick(const float InDeltaTime, const ELevelTick InTickType)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRDriveTickGroup", RRDriveChannel);
+    TickedComponents.Reset();
+    for (int32 i = 0; i < Components.Num();)
+    {
+        UActorComponent* component = Components[i].Get();
+        if (!IsValid(component) || !component->IsRegistered())
+        {
+            Components.RemoveAtSwap(i, 1, false);
+            continue;
+        }
+        ++i;
+
+        AActor* owner = component->GetOwner();
+        if ((nullptr == owner) || !component->IsActive() || !component->HasBegunPlay())
+        {
+            continue;
+        }
+        component->TickComponent(InDeltaTime * owner->CustomTimeDilation, InTickType, &component->PrimaryComponentTick);
+        if (ParallelUpdate)
+        {
+            const AActor* rootActor = owner;
+            while (const AActor* parentActor = rootActor->GetAttachParentActor())
+            {
+                rootActor = parentActor;
+            }
+            TickedComponents.Emplace(rootActor, component);
+        }
+    }
+
+    if ((nullptr == ParallelUpdate) || (TickedComponents.Num() == 0))
+    {
+        return;
+    }
+    if (!CVarDriveTickParallel.GetValueOnGameThread())
+    {
+        for (const auto& tickedComponent : TickedComponents)
+        {
+            ParallelUpdate(tickedComponent.Value);
+        }
+        return;
+    }
+
+    // Islands of components of robots attached together, contiguous once sorted by their root actor
+    Algo::SortBy(TickedComponents, [](const TPair<const AActor*, UActorComponent*>& InPair) { return UPTRINT(InPair.Key); });
+    IslandOffsets.Reset();
+    for (int32 i = 0; i < TickedComponents.Num(); ++i)
+    {
+        if ((i == 0) || (TickedComponents[i].Key != TickedComponents[i - 1].Key))
+        {
+            IslandOffsets.Add(i);
+        }
+    }
+    IslandOffsets.Add(TickedComponents.Num());
+    ParallelFor(IslandOffsets.Num() - 1,
+                [this](const int32 InIslandIdx)
+                {
+                    for (int32 i = IslandOffsets[InIslandIdx]; i < IslandOffsets[InIslandIdx + 1]; ++i)
+                    {
+                        ParallelUpdate(TickedComponents[i].Value);
+                    }
+                });
+}
+
+TMap<UWorld*, TUniquePtr<FRRDriveTickManager>> FRRDriveTickManager::SManagers;
+std::once_flag FRRDriveTickManager::OnceFlag;
+
+FRRDriveTickManager& FRRDriveTickManager::Get(UWorld* InWorld)
+{
+    check(IsInGameThread());
+    std::call_once(OnceFlag,
+                   []() { FWorldDelegates::OnPostWorldCleanup.AddStatic(&FRRDriveTickManager::OnPostWorldCleanup); });
+
+    TUniquePtr<FRRDriveTickManager>& manager = SManagers.FindOrAdd(InWorld);
+    if (!manager.IsValid())
+    {
+        manager = MakeUnique<FRRDriveTickManager>();
+        manager->World = InWorld;
+    }
+    return *manager;
+}
+
+void FRRDriveTickManager::OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/)
+{
+    SManagers.Remove(InWorld);
+}
+
+void FRRDriveTickManager::AddComponent(UActorComponent* InComponent, FRRDriveParallelUpdate InParallelUpdate)
+{
+    check(IsInGameThread());
+    UWorld* world = World.Get();
+    if ((nullptr == InComponent) || (nullptr == world))
+    {
+        return;
+    }
+
+    TUniquePtr<FRRDriveTickGroup>& group = Groups.FindOrAdd(InComponent->GetClass());
+    if (!group.IsValid())
+    {
+        group = MakeUnique<FRRDriveTickGroup>();
+        group->ParallelUpdate = InParallelUpdate;
+        group->TickFunction.Group = group.Get();
+        group->TickFunction.bCanEverTick = true;
+        group->TickFunction.TickGroup = InComponent->PrimaryComponentTick.TickGroup;
+        group->TickFunction.EndTickGroup = InComponent->PrimaryComponentTick.EndTickGroup;
+        group->TickFunction.RegisterTickFunction(world->PersistentLevel);
+    }
+    group->Components.AddUnique(InComponent);
+    InComponent->SetComponentTickEnabled(false);
+}
+
+void FRRDriveTickManager::RemoveComponent(UActorComponent* InComponent)
+{
+    if (InComponent)
+    {
+        if (TUniquePtr<FRRDriveTickGroup>* group = Groups.Find(InComponent->GetClass()))
+        {
+            (*group)->Components.RemoveSwap(InComponent);
+        }
+    }
+}
+
+int32 FRRDriveTickManager::GetComponentsNum() const
+{
+    int32 componentsNum = 0;
+    for (const auto& group : Groups)
+    {
+        componentsNum += group.Value->Components.Num();
+    }
+    return componentsNum;
+}
@@ -4,6 +4,7 @@
 
 // RapyutaSimulationPlugins
 #include "Core/RRMathUtils.h"
+#include "Drives/RRKinematicFleet.h"
 
 URRFloatingMovementComponent::URRFloatingMovementComponent(const FObjectInitializer& ObjectInitializer)
     : Super(ObjectInitializer), bSweepEnabled(true), b2DMovement(false), bUseDecelerationForPaths(true)
@@ -69,9 +70,25 @@ void URRFloatingMovementComponent::TickComponent(float InDeltaTime,
     bPositionCorrected = false;
 
     // Move [UpdatedComponent], updating [bPositionCorrected] here-in
-    FVector deltaLoc = Velocity * InDeltaTime;
-    FRotator deltaRot = FRotator::MakeFromEuler(AngularVelocity) * InDeltaTime;
-    if ((!deltaLoc.IsNearlyZero(1e-6f)) || (!deltaRot.IsNearlyZero(1e-3f)))
+    const FVector deltaLoc = Velocity * InDeltaTime;
+    const FRotator deltaRot = FRotator::MakeFromEuler(AngularVelocity) * InDeltaTime;
+    const FQuat newRotation = FQuat(deltaRot).GetNormalized() * UpdatedComponent->GetComponentQuat().GetNormalized();
+    if (bFleetMovement)
+    {
+        // Moved along with all other fleet robots later in the frame, also if idle, to be collided with
+        FRRKinematicFleet::Get(GetWorld()).SubmitMove(this, deltaLoc, newRotation, FleetRadius, InDeltaTime);
+        return;
+    }
+    ApplyMovement(deltaLoc, newRotation, true, InDeltaTime);
+}
+
+void URRFloatingMovementComponent::ApplyMovement(const FVector& InDelta,
+                                                 const FQuat& InNewRotation,
+                                                 const bool bInSweep,
+                                                 const float InDeltaTime)
+{
+    const bool bSweep = bSweepEnabled && bInSweep;
+    if ((!InDelta.IsNearlyZero(1e-6f)) || (!InNewRotation.Equals(UpdatedComponent->GetComponentQuat(), 1e-5f)))
     {
         // Save prevLocation
         const FVector prevLocation = UpdatedComponent->GetComponentLocation();
@@ -80,18 +97,15 @@ void URRFloatingMovementComponent::TickComponent(float InDeltaTime,
             // NOTE: [UpdatedComponent] should have been attached to the target base, of which overlapping is ignored
             TGuardValue<EMoveComponentFlags> ScopedFlagRestore(MoveComponentFlags, MoveComponentFlags | MOVECOMP_IgnoreBases);
             FHitResult hit(1.f);
-            SafeMoveUpdatedComponent(deltaLoc,
-                                     FQuat(deltaRot).GetNormalized() * UpdatedComponent->GetComponentQuat().GetNormalized(),
-                                     bSweepEnabled,
-                                     hit);
+            SafeMoveUpdatedComponent(InDelta, InNewRotation, bSweep, hit);
 
 #if RAPYUTA_FLOAT_MOVEMENT_DEBUG
-            if (deltaRot.Yaw > 0.f)
+            if (AngularVelocity.Z > 0.f)
             {
                 UE_LOG_WITH_INFO(LogRapyutaCore,
                                  Warning,
                                  TEXT("deltaRot.Yaw: %f, AngularVelocity.Z: %f[deg], MaxAngularSpeed: %f[deg], inDeltaTime: %f"),
-                                 deltaRot.Yaw,
+                                 AngularVelocity.Z * InDeltaTime,
                                  AngularVelocity.Z,
                                  MaxAngularSpeed,
                                  InDeltaTime);
@@ -119,9 +133,9 @@ void URRFloatingMovementComponent::TickComponent(float InDeltaTime,
 
             if (hit.IsValidBlockingHit())
             {
-                HandleImpact(hit, InDeltaTime, deltaLoc);
+                HandleImpact(hit, InDeltaTime, InDelta);
                 // Slide the remaining distance along the hit surface
-                SlideAlongSurface(deltaLoc, 1.f - hit.Time, hit.Normal, hit, bSweepEnabled);
+                SlideAlongSurface(InDelta, 1.f - hit.Time, hit.Normal, hit, bSweep);
             }
         }
 
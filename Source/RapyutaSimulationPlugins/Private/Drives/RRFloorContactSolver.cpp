@@ -0,0 +1,262 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Drives/RRFloorContactSolver.h"
+
+// UE
+#include "Algo/BinarySearch.h"
+#include "Async/ParallelFor.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+
+// RapyutaSimulationPlugins
+#include "Drives/RobotVehicleMovementComponent.h"
+#include "RapyutaSimulationPlugins.h"
+
+//! [cm] Surfaces of a cell closer than this in Z are the same one
+static constexpr float FLOOR_SAMPLE_Z_TOLERANCE = 1.f;
+
+bool FRRFloorHeightMap::FindFloor(const FVector& InStart, const FVector& InEnd, FHitResult& OutHit) const
+{
+    OutHit = FHitResult(1.f);
+    if (const auto* samples = Cells.Find(GetCell(InStart)))
+    {
+        for (const FSample& sample : *samples)
+        {
+            if (sample.Normal.Z <= UE_KINDA_SMALL_NUMBER)
+            {
+                continue;
+            }
+            // Z of the sample's plane at the ray location
+            const FVector offset = InStart - sample.Point;
+            const double floorZ = sample.Point.Z - (sample.Normal.X * offset.X + sample.Normal.Y * offset.Y) / sample.Normal.Z;
+            if ((floorZ <= InStart.Z) && (floorZ >= InEnd.Z))
+            {
+                OutHit.bBlockingHit = true;
+                OutHit.TraceStart = InStart;
+                OutHit.TraceEnd = InEnd;
+                OutHit.ImpactPoint = FVector(InStart.X, InStart.Y, floorZ);
+                OutHit.Location = OutHit.ImpactPoint;
+                OutHit.ImpactNormal = sample.Normal;
+                OutHit.Normal = sample.Normal;
+                OutHit.Distance = InStart.Z - floorZ;
+                OutHit.Time = OutHit.Distance / FMath::Max(InStart.Z - InEnd.Z, UE_KINDA_SMALL_NUMBER);
+                return true;
+            }
+        }
+    }
+    return IsAuthoritative(InStart);
+}
+
+void FRRFloorHeightMap::AddSample(const FHitResult& InHit)
+{
+    auto& samples = Cells.FindOrAdd(GetCell(InHit.ImpactPoint));
+    for (const FSample& sample : samples)
+    {
+        if (FMath::Abs(sample.Point.Z - InHit.ImpactPoint.Z) < FLOOR_SAMPLE_Z_TOLERANCE)
+        {
+            return;
+        }
+    }
+    samples.Add({InHit.ImpactPoint, InHit.ImpactNormal});
+}
+
+bool FRRFloorHeightMap::IsAuthoritative(const FVector& InLocation) const
+{
+    const FVector2D location(InLocation);
+    for (const FBox2D& bounds : AuthoritativeBounds)
+    {
+        if (bounds.IsInside(location))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FRRFloorHeightMap::Build(UWorld* InWorld, const FBox& InBounds)
+{
+    const FIntPoint minCell = GetCell(InBounds.Min);
+    const FIntPoint maxCell = GetCell(InBounds.Max);
+    const FIntPoint cellsNum = maxCell - minCell + FIntPoint(1, 1);
+    TArray<TArray<FHitResult>> cellHits;
+    cellHits.SetNum(cellsNum.X * cellsNum.Y);
+
+    // Static geometry only, all surfaces through the Z range, eg of multiple floors
+    const FCollisionObjectQueryParams objectParams(ECC_WorldStatic);
+    const FCollisionQueryParams traceParams(FName(TEXT("Static_Floor_Map")), false);
+    ParallelFor(cellHits.Num(),
+                [&](const int32 InCellIdx)
+                {
+                    const FIntPoint cell = minCell + FIntPoint(InCellIdx % cellsNum.X, InCellIdx / cellsNum.X);
+                    const FVector2D center = (FVector2D(cell) + FVector2D(0.5, 0.5)) * CellSize;
+                    InWorld->LineTraceMultiByObjectType(cellHits[InCellIdx],
+                                                        FVector(center, InBounds.Max.Z),
+                                                        FVector(center, InBounds.Min.Z),
+                                                        objectParams,
+                                                        traceParams);
+                });
+
+    int32 samplesNum = 0;
+    for (const TArray<FHitResult>& hits : cellHits)
+    {
+        for (const FHitResult& hit : hits)
+        {
+            AddSample(hit);
+            ++samplesNum;
+        }
+    }
+    AuthoritativeBounds.Add(FBox2D(FVector2D(minCell) * CellSize, FVector2D(maxCell + FIntPoint(1, 1)) * CellSize));
+    UE_LOG_WITH_INFO(LogRapyutaCore,
+                     Log,
+                     TEXT("Built static floor map of %dx%d cells of %.1fcm, %d surfaces"),
+                     cellsNum.X,
+                     cellsNum.Y,
+                     CellSize,
+                     samplesNum);
+}
+
+TMap<UWorld*, TUniquePtr<FRRFloorContactSolver>> FRRFloorContactSolver::SSolvers;
+std::once_flag FRRFloorContactSolver::OnceFlag;
+
+FRRFloorContactSolver& FRRFloorContactSolver::Get(UWorld* InWorld)
+{
+    check(IsInGameThread());
+    std::call_once(OnceFlag,
+                   []()
+                   {
+                       FWorldDelegates::OnWorldPostActorTick.AddStatic(&FRRFloorContactSolver::OnWorldPostActorTick);
+                       FWorldDelegates::OnPostWorldCleanup.AddStatic(&FRRFloorContactSolver::OnPostWorldCleanup);
+                   });
+
+    TUniquePtr<FRRFloorContactSolver>& solver = SSolvers.FindOrAdd(InWorld);
+    if (!solver.IsValid())
+    {
+        solver = MakeUnique<FRRFloorContactSolver>();
+        solver->World = InWorld;
+    }
+    return *solver;
+}
+
+void FRRFloorContactSolver::OnWorldPostActorTick(UWorld* InWorld, ELevelTick /*InTickType*/, float /*InDeltaSeconds*/)
+{
+    if (TUniquePtr<FRRFloorContactSolver>* solver = SSolvers.Find(InWorld))
+    {
+        (*solver)->Flush();
+    }
+}
+
+void FRRFloorContactSolver::OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/)
+{
+    SSolvers.Remove(InWorld);
+}
+
+void FRRFloorContactSolver::AddRobot(URobotVehicleMovementComponent* InMovementComp, const float InDeltaTime)
+{
+    for (auto& pendingRobot : PendingRobots)
+    {
+        if (pendingRobot.Key == InMovementComp)
+        {
+            pendingRobot.Value = InDeltaTime;
+            return;
+        }
+    }
+    PendingRobots.Emplace(InMovementComp, InDeltaTime);
+}
+
+void FRRFloorContactSolver::BuildStaticFloorMap(const FBox& InBounds, const float InCellSize)
+{
+    check(IsInGameThread());
+    // Robots sharing the same bounds only build it once
+    if (!World.IsValid() || !InBounds.IsValid ||
+        (FloorHeights.IsAuthoritative(InBounds.Min) && FloorHeights.IsAuthoritative(InBounds.Max)))
+    {
+        return;
+    }
+    if (FloorHeights.Cells.Num() == 0)
+    {
+        FloorHeights.CellSize = FMath::Max(InCellSize, 1.f);
+    }
+    FloorHeights.Build(World.Get(), InBounds);
+}
+
+void FRRFloorContactSolver::Flush()
+{
+    if (PendingRobots.Num() == 0)
+    {
+        return;
+    }
+
+    // 1- Gather pending robots' rays, looking up the cached ones
+    TArray<URobotVehicleMovementComponent*> robots;
+    TArray<float> deltaTimes;
+    robots.Reserve(PendingRobots.Num());
+    deltaTimes.Reserve(PendingRobots.Num());
+    RayStarts.Reset();
+    RayEnds.Reset();
+    RayOffsets.Reset(PendingRobots.Num() + 1);
+    RayOffsets.Add(0);
+    for (const auto& pendingRobot : PendingRobots)
+    {
+        URobotVehicleMovementComponent* robot = pendingRobot.Key.Get();
+        if (IsValid(robot) && IsValid(robot->GetOwner()))
+        {
+            robot->GetFloorContactRays(RayStarts, RayEnds);
+            robots.Add(robot);
+            deltaTimes.Add(pendingRobot.Value);
+            RayOffsets.Add(RayStarts.Num());
+        }
+    }
+    PendingRobots.Reset();
+
+    RayHits.SetNum(RayStarts.Num(), false);
+    TracedRayIndices.Reset(RayStarts.Num());
+    for (int32 robotIdx = 0; robotIdx < robots.Num(); ++robotIdx)
+    {
+        // Moving platforms are not static floors
+        URobotVehicleMovementComponent* robot = robots[robotIdx];
+        const bool bCached = robot->bCacheStaticFloorHeights && !robot->IsOnMovingPlatform();
+        for (int32 rayIdx = RayOffsets[robotIdx]; rayIdx < RayOffsets[robotIdx + 1]; ++rayIdx)
+        {
+            if (!bCached || !FloorHeights.FindFloor(RayStarts[rayIdx], RayEnds[rayIdx], RayHits[rayIdx]))
+            {
+                TracedRayIndices.Add(rayIdx);
+            }
+        }
+    }
+    LastCachedRaysNum = RayStarts.Num() - TracedRayIndices.Num();
+
+    // 2- Trace all remaining rays of all robots at once
+    UWorld* world = World.Get();
+    ParallelFor(TracedRayIndices.Num(),
+                [this, world, &robots](const int32 InIdx)
+                {
+                    const int32 rayIdx = TracedRayIndices[InIdx];
+                    // Index of the last offset <= rayIdx
+                    const int32 robotIdx = Algo::UpperBound(RayOffsets, rayIdx) - 1;
+                    world->LineTraceSingleByChannel(RayHits[rayIdx],
+                                                    RayStarts[rayIdx],
+                                                    RayEnds[rayIdx],
+                                                    ECollisionChannel::ECC_Visibility,
+                                                    robots[robotIdx]->BatchFloorTraceParams,
+                                                    FCollisionResponseParams::DefaultResponseParam);
+                });
+
+    // 3- Cache new static floor hits, then let each robot adapt to its own, on game thread
+    for (const int32 rayIdx : TracedRayIndices)
+    {
+        const FHitResult& hit = RayHits[rayIdx];
+        const UPrimitiveComponent* hitComp = hit.GetComponent();
+        const int32 robotIdx = Algo::UpperBound(RayOffsets, rayIdx) - 1;
+        if (hit.bBlockingHit && robots[robotIdx]->bCacheStaticFloorHeights && hitComp &&
+            (hitComp->Mobility == EComponentMobility::Static) && !robots[robotIdx]->IsOnMovingPlatform())
+        {
+            FloorHeights.AddSample(hit);
+        }
+    }
+    for (int32 robotIdx = 0; robotIdx < robots.Num(); ++robotIdx)
+    {
+        robots[robotIdx]->AdaptToFloor(
+            TArrayView<FHitResult>(&RayHits[RayOffsets[robotIdx]], RayOffsets[robotIdx + 1] - RayOffsets[robotIdx]),
+            deltaTimes[robotIdx]);
+    }
+}
@@ -2,6 +2,10 @@
 
 #include "Drives/RRJointComponent.h"
 
+// RapyutaSimulationPlugins
+#include "Drives/RRDriveTickManager.h"
+#include "Robots/RRBaseRobot.h"
+
 // Sets default values for this component's properties
 URRJointComponent::URRJointComponent()
 {
@@ -12,6 +16,19 @@ void URRJointComponent::BeginPlay()
 {
     Initialize();
     Super::BeginPlay();
+    if (bAggregatedTick)
+    {
+        FRRDriveTickManager::Get(GetWorld()).AddComponent(this);
+    }
+}
+
+void URRJointComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (bAggregatedTick)
+    {
+        FRRDriveTickManager::Get(GetWorld()).RemoveComponent(this);
+    }
+    Super::EndPlay(EndPlayReason);
 }
 
 bool URRJointComponent::IsValid()
@@ -22,6 +39,15 @@ bool URRJointComponent::IsValid()
 void URRJointComponent::Initialize()
 {}
 
+void URRJointComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+    if (!bUpdatedByOwner)
+    {
+        UpdateJoint(DeltaTime, GetWorld()->GetTimeSeconds());
+    }
+}
+
 // velocity
 void URRJointComponent::SetVelocityTarget(const FVector& InLinearVelocity, const FVector& InAngularVelocity)
 {
@@ -76,6 +102,10 @@ void URRJointComponent::SetVelocityTargetWithArray(const TArray<float>& InVeloci
     FVector OutAngularVelocity;
     VelocityFromArray(InVelocity, OutLinearVelocity, OutAngularVelocity);
     SetVelocityTarget(OutLinearVelocity, OutAngularVelocity);
+    if (ARRBaseRobot* robot = Cast<ARRBaseRobot>(GetOwner()))
+    {
+        robot->WakePhysics();
+    }
 }
 
 
@@ -149,6 +179,10 @@ void URRJointComponent::SetPoseTargetWithArray(const TArray<float>& InPose)
     FRotator OutOrientation;
     PoseFromArray(InPose, OutPosition, OutOrientation);
     SetPoseTarget(OutPosition, OutOrientation);
+    if (ARRBaseRobot* robot = Cast<ARRBaseRobot>(GetOwner()))
+    {
+        robot->WakePhysics();
+    }
 }
 
 void URRJointComponent::SetPoseWithArray(const TArray<float>& InPose)
@@ -0,0 +1,198 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Drives/RRJointStateBlock.h"
+
+// UE
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+
+// RapyutaSimulationPlugins
+#include "Drives/RRJointComponent.h"
+#include "Drives/RRKinematicJointComponent.h"
+
+FRRLinkBodyStates::FState FRRLinkBodyStates::FState::Read(const UPrimitiveComponent& InLink)
+{
+    FState state;
+    const FBodyInstance* body = InLink.GetBodyInstance();
+    if (body && body->IsValidBodyInstance())
+    {
+        state.CenterOfMass = body->GetCOMPosition();
+        state.LinearVelocity = body->GetUnrealWorldVelocity();
+        state.AngularVelocity = body->GetUnrealWorldAngularVelocityInRadians();
+    }
+    else
+    {
+        state.CenterOfMass = InLink.GetComponentLocation();
+    }
+    return state;
+}
+
+const FRRLinkBodyStates::FState& FRRLinkBodyStates::FindOrRead(const UPrimitiveComponent& InLink)
+{
+    if (const FState* state = States.Find(&InLink))
+    {
+        return *state;
+    }
+    return States.Add(&InLink, FState::Read(InLink));
+}
+
+void FRRJointStateBlock::Reset(const TMap<FString, URRJointComponent*>& InJoints)
+{
+    // Hand the joints removed since the previous reset back to their own ticks, or their FRRDriveTickManager group's
+    for (URRJointComponent* joint : SourceJoints)
+    {
+        if (::IsValid(joint) && !InJoints.FindKey(joint))
+        {
+            joint->bUpdatedByOwner = false;
+            joint->LinkBodyStates = nullptr;
+            joint->SetComponentTickEnabled(!joint->bAggregatedTick);
+        }
+    }
+
+    Names.Reset(InJoints.Num());
+    Joints.Reset(InJoints.Num());
+    Offsets.Reset(InJoints.Num());
+    DOFsNum.Reset(InJoints.Num());
+    DOFMasks.Reset(InJoints.Num());
+    SourceJoints.Reset(InJoints.Num());
+
+    int32 dofsNum = 0;
+    for (const auto& joint : InJoints)
+    {
+        SourceJoints.Add(joint.Value);
+        if (nullptr == joint.Value)
+        {
+            continue;
+        }
+
+        URRJointComponent* jointComp = joint.Value;
+        const uint8 linearDOF = FMath::Min<uint8>(jointComp->LinearDOF, 3);
+        const uint8 rotationalDOF = FMath::Min<uint8>(jointComp->RotationalDOF, 3);
+        Names.Add(joint.Key);
+        Joints.Add(jointComp);
+        Offsets.Add(dofsNum);
+        DOFsNum.Add(linearDOF + rotationalDOF);
+        DOFMasks.Add(static_cast<uint8>(((1 << linearDOF) - 1) | (((1 << rotationalDOF) - 1) << 3)));
+        dofsNum += linearDOF + rotationalDOF;
+
+        jointComp->bUpdatedByOwner = true;
+        jointComp->LinkBodyStates = &LinkBodyStates;
+        jointComp->SetComponentTickEnabled(false);
+    }
+
+    Positions.SetNumZeroed(dofsNum);
+    Velocities.SetNumZeroed(dofsNum);
+    PositionTargets.SetNumZeroed(dofsNum);
+    VelocityTargets.SetNumZeroed(dofsNum);
+    for (int32 i = 0; i < Joints.Num(); ++i)
+    {
+        Gather(i, *Joints[i]);
+    }
+}
+
+bool FRRJointStateBlock::Matches(const TMap<FString, URRJointComponent*>& InJoints) const
+{
+    if (SourceJoints.Num() != InJoints.Num())
+    {
+        return false;
+    }
+    int32 i = 0;
+    for (const auto& joint : InJoints)
+    {
+        if (SourceJoints[i++] != joint.Value)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void FRRJointStateBlock::Update(const float InDeltaTime)
+{
+    UWorld* world = nullptr;
+    for (const auto& joint : Joints)
+    {
+        if (joint.IsValid())
+        {
+            world = joint->GetWorld();
+            break;
+        }
+    }
+    if (nullptr == world)
+    {
+        return;
+    }
+
+    const float time = world->GetTimeSeconds();
+    LinkBodyStates.Reset();
+
+    // Kinematic joints' poses are applied all at once after the loop, instead of each moving & sweeping its subtree
+    TArray<URRKinematicJointComponent*, TInlineAllocator<16>> kinematicJoints;
+    for (int32 i = 0; i < Joints.Num(); ++i)
+    {
+        if (URRJointComponent* joint = Joints[i].Get())
+        {
+            if (URRKinematicJointComponent* kinematicJoint = Cast<URRKinematicJointComponent>(joint))
+            {
+                kinematicJoint->bDeferPoseUpdate = true;
+                kinematicJoints.Add(kinematicJoint);
+            }
+            joint->UpdateJoint(InDeltaTime, time);
+            Gather(i, *joint);
+        }
+    }
+
+    if (kinematicJoints.Num() > 0)
+    {
+        URRKinematicJointComponent::UpdatePoses(kinematicJoints);
+        for (URRKinematicJointComponent* kinematicJoint : kinematicJoints)
+        {
+            kinematicJoint->bDeferPoseUpdate = false;
+        }
+    }
+}
+
+void FRRJointStateBlock::Gather(const int32 InJointIndex, const URRJointComponent& InJoint)
+{
+    const int32 offset = Offsets[InJointIndex];
+    const uint8 linearDOF = FMath::Min<uint8>(InJoint.LinearDOF, 3);
+    const uint8 rotationalDOF = DOFsNum[InJointIndex] - linearDOF;
+    for (uint8 i = 0; i < linearDOF; ++i)
+    {
+        Positions[offset + i] = InJoint.Position[i];
+        Velocities[offset + i] = InJoint.LinearVelocity[i];
+        PositionTargets[offset + i] = InJoint.PositionTarget[i];
+        VelocityTargets[offset + i] = InJoint.LinearVelocityTarget[i];
+    }
+    if (rotationalDOF > 0)
+    {
+        // Euler order as in URRJointComponent::PoseFromArray()
+        const FVector orientation = InJoint.Orientation.Euler();
+        const FVector orientationTarget = InJoint.OrientationTarget.Euler();
+        const int32 rotOffset = offset + linearDOF;
+        for (uint8 i = 0; i < rotationalDOF; ++i)
+        {
+            Positions[rotOffset + i] = orientation[i];
+            Velocities[rotOffset + i] = InJoint.AngularVelocity[i];
+            PositionTargets[rotOffset + i] = orientationTarget[i];
+            VelocityTargets[rotOffset + i] = InJoint.AngularVelocityTarget[i];
+        }
+    }
+}
+
+void FRRJointsTickFunction::ExecuteTick(float DeltaTime,
+                                        ELevelTick TickType,
+                                        ENamedThreads::Type CurrentThread,
+                                        const FGraphEventRef& MyCompletionGraphEvent)
+{
+    if ((nullptr == Block) || (nullptr == Joints) || (TickType == LEVELTICK_ViewportsOnly))
+    {
+        return;
+    }
+
+    if (!Block->Matches(*Joints))
+    {
+        Block->Reset(*Joints);
+    }
+    Block->Update(DeltaTime);
+}
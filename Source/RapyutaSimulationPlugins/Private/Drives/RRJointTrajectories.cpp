@@ -0,0 +1,102 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Drives/RRJointTrajectories.h"
+
+void FRRJointTrajectories::SetNum(const int32 InAxesNum)
+{
+    StartTimes.SetNumZeroed(InAxesNum);
+    StartPositions.SetNumZeroed(InAxesNum);
+    StartVelocities.SetNumZeroed(InAxesNum);
+    InitializedFlags.SetNumZeroed(InAxesNum);
+    for (int32 k = 0; k < SEGMENTS_NUM; ++k)
+    {
+        SegmentStarts[k].SetNumZeroed(InAxesNum);
+        SegmentDurations[k].SetNumZeroed(InAxesNum);
+        SegmentAccs[k].SetNumZeroed(InAxesNum);
+    }
+}
+
+void FRRJointTrajectories::Plan(const int32 InAxis,
+                                const double InStartPosition,
+                                const double InEndPosition,
+                                const double InAccMax,
+                                const double InVelMax,
+                                const double InStartTime,
+                                const double InStartVelocity,
+                                const bool bInAngle)
+{
+    const double accMax = FMath::Max(InAccMax, UE_DOUBLE_SMALL_NUMBER);
+    const double velMax = FMath::Max(InVelMax, UE_DOUBLE_SMALL_NUMBER);
+    double distance = bInAngle ? FMath::UnwindRadians(InEndPosition - InStartPosition) : (InEndPosition - InStartPosition);
+    double velocity = InStartVelocity;
+
+    StartTimes[InAxis] = InStartTime;
+    StartPositions[InAxis] = InStartPosition;
+    StartVelocities[InAxis] = InStartVelocity;
+    InitializedFlags[InAxis] = true;
+
+    int32 segment = 0;
+    double segmentStart = InStartTime;
+    auto addSegment = [this, InAxis, &segment, &segmentStart](const double InDuration, const double InAcc)
+    {
+        SegmentStarts[segment][InAxis] = segmentStart;
+        SegmentDurations[segment][InAxis] = InDuration;
+        SegmentAccs[segment][InAxis] = InAcc;
+        segmentStart += InDuration;
+        ++segment;
+    };
+
+    // 1- Stop first if moving away from the target, or too fast to stop before it
+    double direction = (distance != 0.) ? FMath::Sign(distance) : -FMath::Sign(velocity);
+    const double stopDistance = velocity * FMath::Abs(velocity) / (2. * accMax);
+    if ((velocity * direction < 0.) || (stopDistance * direction > FMath::Abs(distance)))
+    {
+        addSegment(FMath::Abs(velocity) / accMax, -FMath::Sign(velocity) * accMax);
+        distance -= stopDistance;
+        velocity = 0.;
+        direction = FMath::Sign(distance);
+    }
+
+    // 2- Accelerate or decelerate to the peak velocity, cruise, then decelerate to rest at the target
+    const double remainingDistance = FMath::Abs(distance);
+    const double speed = velocity * direction;
+    const double peakSpeed = FMath::Min(FMath::Sqrt(accMax * remainingDistance + 0.5 * speed * speed), velMax);
+    const double speedChangeDuration = FMath::Abs(peakSpeed - speed) / accMax;
+    const double speedChangeDistance = 0.5 * (peakSpeed + speed) * speedChangeDuration;
+    const double stopDuration = peakSpeed / accMax;
+    const double cruiseDistance = FMath::Max(remainingDistance - speedChangeDistance - 0.5 * peakSpeed * stopDuration, 0.);
+    addSegment(speedChangeDuration, FMath::Sign(peakSpeed - speed) * direction * accMax);
+    addSegment((peakSpeed > UE_DOUBLE_SMALL_NUMBER) ? (cruiseDistance / peakSpeed) : 0., 0.);
+    addSegment(stopDuration, -direction * accMax);
+    while (segment < SEGMENTS_NUM)
+    {
+        addSegment(0., 0.);
+    }
+}
+
+void FRRJointTrajectories::Evaluate(const double InTime, TArrayView<double> OutPositions, TArrayView<double> OutVelocities) const
+{
+    const int32 axesNum = Num();
+    check((OutPositions.Num() >= axesNum) && (OutVelocities.Num() >= axesNum));
+    double* RESTRICT positions = OutPositions.GetData();
+    double* RESTRICT velocities = OutVelocities.GetData();
+    for (int32 i = 0; i < axesNum; ++i)
+    {
+        positions[i] = StartPositions[i];
+        velocities[i] = StartVelocities[i];
+    }
+
+    // Each segment contributes its elapsed part, 0 if not yet started, its whole duration if ended
+    for (int32 k = 0; k < SEGMENTS_NUM; ++k)
+    {
+        const double* RESTRICT starts = SegmentStarts[k].GetData();
+        const double* RESTRICT durations = SegmentDurations[k].GetData();
+        const double* RESTRICT accs = SegmentAccs[k].GetData();
+        for (int32 i = 0; i < axesNum; ++i)
+        {
+            const double dt = FMath::Clamp(InTime - starts[i], 0., durations[i]);
+            positions[i] += (velocities[i] + 0.5 * accs[i] * dt) * dt;
+            velocities[i] += accs[i] * dt;
+        }
+    }
+}
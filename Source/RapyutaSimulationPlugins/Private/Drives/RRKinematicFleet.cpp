@@ -0,0 +1,234 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Drives/RRKinematicFleet.h"
+
+// UE
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+#include "GameFramework/MovementComponent.h"
+
+// RapyutaSimulationPlugins
+#include "Drives/RRFloatingMovementComponent.h"
+#include "Drives/RobotVehicleMovementComponent.h"
+
+void FRRKinematicFleetTickFunction::ExecuteTick(float DeltaTime,
+                                                ELevelTick TickType,
+                                                ENamedThreads::Type CurrentThread,
+                                                const FGraphEventRef& MyCompletionGraphEvent)
+{
+    if (Fleet && (TickType != LEVELTICK_ViewportsOnly))
+    {
+        Fleet->Flush();
+    }
+}
+
+void FRRKinematicFleet::FRRFleetMoves::Reset()
+{
+    MovementComps.Reset();
+    Locations.Reset();
+    Deltas.Reset();
+    Rotations.Reset();
+    Radii.Reset();
+    HalfHeights.Reset();
+    DeltaTimes.Reset();
+}
+
+TMap<UWorld*, TUniquePtr<FRRKinematicFleet>> FRRKinematicFleet::SFleets;
+std::once_flag FRRKinematicFleet::OnceFlag;
+
+FRRKinematicFleet::~FRRKinematicFleet()
+{
+    if (TickFunction.IsTickFunctionRegistered())
+    {
+        TickFunction.UnRegisterTickFunction();
+    }
+}
+
+FRRKinematicFleet& FRRKinematicFleet::Get(UWorld* InWorld)
+{
+    check(IsInGameThread());
+    std::call_once(OnceFlag,
+                   []() { FWorldDelegates::OnPostWorldCleanup.AddStatic(&FRRKinematicFleet::OnPostWorldCleanup); });
+
+    TUniquePtr<FRRKinematicFleet>& fleet = SFleets.FindOrAdd(InWorld);
+    if (!fleet.IsValid())
+    {
+        fleet = MakeUnique<FRRKinematicFleet>();
+        fleet->World = InWorld;
+        fleet->TickFunction.Fleet = fleet.Get();
+        fleet->TickFunction.bCanEverTick = true;
+        fleet->TickFunction.TickGroup = TG_PostPhysics;
+        fleet->TickFunction.RegisterTickFunction(InWorld->PersistentLevel);
+    }
+    return *fleet;
+}
+
+void FRRKinematicFleet::OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/)
+{
+    SFleets.Remove(InWorld);
+}
+
+void FRRKinematicFleet::SubmitMove(UMovementComponent* InMovementComp,
+                                   const FVector& InDelta,
+                                   const FQuat& InNewRotation,
+                                   const float InRadius,
+                                   const float InDeltaTime)
+{
+    const USceneComponent* updatedComp = InMovementComp->UpdatedComponent;
+    if (nullptr == updatedComp)
+    {
+        return;
+    }
+    const FBoxSphereBounds& bounds = updatedComp->Bounds;
+    Moves.MovementComps.Add(InMovementComp);
+    // Bounds center, the reference point of all fleet checks
+    Moves.Locations.Add(bounds.Origin);
+    Moves.Deltas.Add(InDelta);
+    Moves.Rotations.Add(InNewRotation);
+    Moves.Radii.Add((InRadius > 0.f) ? InRadius : FMath::Max(bounds.BoxExtent.X, bounds.BoxExtent.Y));
+    Moves.HalfHeights.Add(bounds.BoxExtent.Z);
+    Moves.DeltaTimes.Add(InDeltaTime);
+}
+
+void FRRKinematicFleet::Flush()
+{
+    const int32 robotsNum = Moves.Num();
+    LastRobotsNum = robotsNum;
+    LastSweptRobotsNum = 0;
+    UWorld* world = World.Get();
+    if ((robotsNum == 0) || (nullptr == world))
+    {
+        Moves.Reset();
+        return;
+    }
+
+    // 1- Broad phase grid of the robots' desired locations
+    float maxRadius = 1.f;
+    for (const float radius : Moves.Radii)
+    {
+        maxRadius = FMath::Max(maxRadius, radius);
+    }
+    const double cellSize = 2. * maxRadius;
+    auto getCell = [cellSize](const FVector& InLocation)
+    { return FIntPoint(FMath::FloorToInt32(InLocation.X / cellSize), FMath::FloorToInt32(InLocation.Y / cellSize)); };
+    Grid.Reset();
+    for (int32 i = 0; i < robotsNum; ++i)
+    {
+        Grid.FindOrAdd(getCell(Moves.Locations[i] + Moves.Deltas[i])).Add(i);
+    }
+
+    // 2- Robot-robot pushbacks, from the desired locations only, thus order independent
+    Corrections.SetNumUninitialized(robotsNum);
+    ParallelFor(robotsNum,
+                [this, &getCell](const int32 i)
+                {
+                    FVector correction = FVector::ZeroVector;
+                    const FVector location = Moves.Locations[i] + Moves.Deltas[i];
+                    const FIntPoint cell = getCell(location);
+                    for (int32 x = cell.X - 1; x <= cell.X + 1; ++x)
+                    {
+                        for (int32 y = cell.Y - 1; y <= cell.Y + 1; ++y)
+                        {
+                            const auto* cellRobots = Grid.Find(FIntPoint(x, y));
+                            if (nullptr == cellRobots)
+                            {
+                                continue;
+                            }
+                            for (const int32 j : *cellRobots)
+                            {
+                                const FVector offset = location - (Moves.Locations[j] + Moves.Deltas[j]);
+                                const double minDistance = Moves.Radii[i] + Moves.Radii[j];
+                                if ((j == i) || (FMath::Abs(offset.Z) >= (Moves.HalfHeights[i] + Moves.HalfHeights[j])))
+                                {
+                                    continue;
+                                }
+                                const double distance = offset.Size2D();
+                                if (distance >= minDistance)
+                                {
+                                    continue;
+                                }
+                                // Coincident robots are split along X, by their index order
+                                const FVector normal =
+                                    (distance > UE_KINDA_SMALL_NUMBER) ? (FVector(offset.X, offset.Y, 0.) / distance)
+                                                                       : FVector((i < j) ? -1. : 1., 0., 0.);
+                                correction += 0.5 * (minDistance - distance) * normal;
+                            }
+                        }
+                    }
+                    Corrections[i] = correction;
+                });
+
+    // 3- Static geometry checks, only redone once robots have moved by half the clearance since the last one
+    NearStaticFlags.SetNumUninitialized(robotsNum);
+    TArray<int32> checkedRobots;
+    for (int32 i = 0; i < robotsNum; ++i)
+    {
+        Moves.Deltas[i] += Corrections[i];
+        const FVector location = Moves.Locations[i] + Moves.Deltas[i];
+        const FRRStaticCheck* staticCheck = StaticChecks.Find(Moves.MovementComps[i].Get());
+        if (staticCheck && (FVector::DistSquared(staticCheck->Location, location) < FMath::Square(0.5f * StaticClearance)))
+        {
+            NearStaticFlags[i] = staticCheck->bNearStatic;
+        }
+        else
+        {
+            checkedRobots.Add(i);
+        }
+    }
+    ParallelFor(checkedRobots.Num(),
+                [this, world, &checkedRobots](const int32 InIdx)
+                {
+                    const int32 i = checkedRobots[InIdx];
+                    const UMovementComponent* movementComp = Moves.MovementComps[i].Get();
+                    const float halfHeight = FMath::Max(Moves.HalfHeights[i] - 0.5f * FloorClearance, 1.f);
+                    const FVector center = Moves.Locations[i] + Moves.Deltas[i] + FVector(0., 0., 0.5f * FloorClearance);
+                    const float halfSize = Moves.Radii[i] + StaticClearance;
+                    const FCollisionQueryParams queryParams(
+                        FName(TEXT("Fleet_Static_Check")), false, movementComp ? movementComp->GetOwner() : nullptr);
+                    NearStaticFlags[i] = world->OverlapAnyTestByObjectType(center,
+                                                                            FQuat::Identity,
+                                                                            FCollisionObjectQueryParams(ECC_WorldStatic),
+                                                                            FCollisionShape::MakeBox(
+                                                                                FVector(halfSize, halfSize, halfHeight)),
+                                                                            queryParams);
+                });
+    for (const int32 i : checkedRobots)
+    {
+        if (UMovementComponent* movementComp = Moves.MovementComps[i].Get())
+        {
+            StaticChecks.Add(movementComp, {Moves.Locations[i] + Moves.Deltas[i], NearStaticFlags[i]});
+        }
+    }
+    // Forget robots gone for good
+    if (StaticChecks.Num() > 2 * robotsNum)
+    {
+        for (auto it = StaticChecks.CreateIterator(); it; ++it)
+        {
+            if (nullptr == it.Key().ResolveObjectPtr())
+            {
+                it.RemoveCurrent();
+            }
+        }
+    }
+
+    // 4- Moves, on game thread
+    for (int32 i = 0; i < robotsNum; ++i)
+    {
+        UMovementComponent* movementComp = Moves.MovementComps[i].Get();
+        if (!IsValid(movementComp) || (nullptr == movementComp->UpdatedComponent))
+        {
+            continue;
+        }
+        const bool bSweep = NearStaticFlags[i];
+        LastSweptRobotsNum += bSweep ? 1 : 0;
+        if (URobotVehicleMovementComponent* vehicleMovementComp = Cast<URobotVehicleMovementComponent>(movementComp))
+        {
+            vehicleMovementComp->ApplyMovement(Moves.Deltas[i], Moves.Rotations[i], bSweep, Moves.DeltaTimes[i]);
+        }
+        else if (URRFloatingMovementComponent* floatingMovementComp = Cast<URRFloatingMovementComponent>(movementComp))
+        {
+            floatingMovementComp->ApplyMovement(Moves.Deltas[i], Moves.Rotations[i], bSweep, Moves.DeltaTimes[i]);
+        }
+    }
+    Moves.Reset();
+}
@@ -2,6 +2,9 @@
 
 #include "Drives/RRKinematicJointComponent.h"
 
+// UE
+#include "Components/SceneComponent.h"
+
 // Sets default values for this component's properties
 URRKinematicJointComponent::URRKinematicJointComponent()
 {
@@ -25,14 +28,12 @@ void URRKinematicJointComponent::Initialize()
 
 }
 
-// Called every frame
-void URRKinematicJointComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void URRKinematicJointComponent::UpdateJoint(const float InDeltaTime, const float InTime)
 {
-    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
     if (!LinearVelocity.IsZero() || !AngularVelocity.IsZero())
     {
-        FVector dPos = LinearVelocity * DeltaTime;
-        FVector dRot = AngularVelocity * DeltaTime;
+        FVector dPos = LinearVelocity * InDeltaTime;
+        FVector dRot = AngularVelocity * InDeltaTime;
 
         // Check reach goal in this step.
         if (ControlType == ERRJointControlType::POSITION)
@@ -112,12 +113,79 @@ void URRKinematicJointComponent::UpdatePose()
     {
         return;
     }
+    if (bDeferPoseUpdate)
+    {
+        bPoseDirty = true;
+        return;
+    }
     FHitResult SweepHitResult;
     K2_SetWorldTransform(FTransform(Orientation, Position) *  // joint changes
                          ParentLinkToJoint *                 // joint to child l 
                          ParentLink->GetComponentTransform(),             // world orogin to parent
-                         true,                                // bSweep
+                         bSweep,                              // bSweep
                          SweepHitResult,
                          false    // bTeleport
     );
 }
+
+void URRKinematicJointComponent::UpdatePoses(const TArrayView<URRKinematicJointComponent* const> InJoints)
+{
+    TArray<URRKinematicJointComponent*, TInlineAllocator<16>> dirtyJoints;
+    for (URRKinematicJointComponent* joint : InJoints)
+    {
+        if (joint && joint->bPoseDirty)
+        {
+            joint->bPoseDirty = false;
+            dirtyJoints.Add(joint);
+        }
+    }
+    if (dirtyJoints.Num() == 0)
+    {
+        return;
+    }
+
+    // 1- Relative transforms to ParentLink, the joint's attach parent, thus independent of other joints' world transforms
+    TArray<FTransform, TInlineAllocator<16>> sweepStarts;
+    for (URRKinematicJointComponent* joint : dirtyJoints)
+    {
+        sweepStarts.Add(joint->bSweep ? joint->GetComponentTransform() : FTransform::Identity);
+        const FTransform relative = FTransform(joint->Orientation, joint->Position) * joint->ParentLinkToJoint;
+        joint->SetRelativeLocation_Direct(relative.GetLocation());
+        joint->SetRelativeRotation_Direct(relative.Rotator());
+        joint->SetRelativeScale3D_Direct(relative.GetScale3D());
+    }
+
+    // 2- Propagate once per moved subtree, from its top joint, ie having no moved joint as ancestor
+    for (URRKinematicJointComponent* joint : dirtyJoints)
+    {
+        bool bTopJoint = true;
+        for (const USceneComponent* parent = joint->GetAttachParent(); parent; parent = parent->GetAttachParent())
+        {
+            const URRKinematicJointComponent* parentJoint = Cast<URRKinematicJointComponent>(parent);
+            if (parentJoint && dirtyJoints.Contains(parentJoint))
+            {
+                bTopJoint = false;
+                break;
+            }
+        }
+        if (bTopJoint)
+        {
+            joint->UpdateComponentToWorld();
+            joint->UpdateOverlaps();
+        }
+    }
+
+    // 3- Sweep flagged joints from their previous pose, their subtree being updated once at the end of the scope
+    for (int32 i = 0; i < dirtyJoints.Num(); ++i)
+    {
+        URRKinematicJointComponent* joint = dirtyJoints[i];
+        if (joint->bSweep)
+        {
+            const FTransform target = joint->GetComponentTransform();
+            FScopedMovementUpdate scopedMovement(joint, EScopedUpdate::DeferredUpdates);
+            FHitResult sweepHitResult;
+            joint->SetWorldTransform(sweepStarts[i], false, nullptr, ETeleportType::TeleportPhysics);
+            joint->SetWorldTransform(target, true, &sweepHitResult, ETeleportType::None);
+        }
+    }
+}
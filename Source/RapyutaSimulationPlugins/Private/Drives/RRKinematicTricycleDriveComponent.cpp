@@ -3,40 +3,23 @@
 #include "Drives/RRKinematicTricycleDriveComponent.h"
 
 DEFINE_LOG_CATEGORY(LogRRKinematicTricycleDriveComponent);
-void URRKinematicTricycleDriveComponent::TickComponent(float InDeltaTime,
-                                                       enum ELevelTick TickType,
-                                                       FActorComponentTickFunction* ThisTickFunction)
+FTransform URRKinematicTricycleDriveComponent::ComputeDriveLocalMove(float InDeltaTime)
 {
-    if (!ShouldSkipUpdate(InDeltaTime))
+    if ((SteeringJoint != nullptr) && (DriveJoint != nullptr))
     {
-        Super::TickComponent(InDeltaTime, TickType, ThisTickFunction);
+        float steerAngle = FMath::DegreesToRadians(SteeringJoint->Orientation.Roll);
+        float wheelAngle = FMath::DegreesToRadians(DriveJoint->Orientation.Roll);
 
-        if (AIMovementComp)
-        {
-            // Let the tick handled by [AIMovementComp] update [UpdatedComponent]'s velocity
-            return;
-        }
+        float driveDiff = (wheelAngle - PrevWheeAngleRad) * WheelRadius;
+        const FVector linearDiff = FVector(driveDiff * FMath::Cos(steerAngle), 0, 0);
+        const FQuat rotationDiff = FQuat(FVector(0, 0, 1), driveDiff * FMath::Sin(steerAngle) / WheelBase);
 
-        if ((SteeringJoint != nullptr) && (DriveJoint != nullptr))
-        {
-            float steerAngle = FMath::DegreesToRadians(SteeringJoint->Orientation.Roll);
-            float wheelAngle = FMath::DegreesToRadians(DriveJoint->Orientation.Roll);
-
-            float driveDiff = (wheelAngle - PrevWheeAngleRad) * WheelRadius;
-            const FVector linearDiff = FVector(driveDiff * FMath::Cos(steerAngle), 0, 0);
-            const FQuat rotationDiff = FQuat(FVector(0, 0, 1), driveDiff * FMath::Sin(steerAngle) / WheelBase);
-
-            FHitResult hit;
-            UpdatedComponent->AddLocalTransform(FTransform(rotationDiff, linearDiff), true, &hit);
-
-            PrevWheeAngleRad = wheelAngle;
-        }
-        else
-        {
-            UE_LOG_WITH_INFO_NAMED(
-                LogRRKinematicTricycleDriveComponent, Warning, TEXT("Steering and/or drive joints are not speciied"));
-        }
+        PrevWheeAngleRad = wheelAngle;
+        return FTransform(rotationDiff, linearDiff);
     }
+
+    UE_LOG_WITH_INFO_NAMED(LogRRKinematicTricycleDriveComponent, Warning, TEXT("Steering and/or drive joints are not speciied"));
+    return FTransform::Identity;
 }
 
 void URRKinematicTricycleDriveComponent::SetDriveJoints(URRJointComponent* InSteeringJoint, URRJointComponent* InDriveJoint)
@@ -2,12 +2,18 @@
 
 #include "Drives/RRPhysicsJointComponent.h"
 
+// RapyutaSimulationPlugins
+#include "Drives/RRJointStateBlock.h"
+#include "Drives/RRPhysicsSubstepManager.h"
+#include "Robots/RRRobotStructs.h"
+
 // Sets default values for this component's properties
 URRPhysicsJointComponent::URRPhysicsJointComponent()
 {
     // todo initializing physicsconstaints here does not work somehow.
     Constraint = CreateDefaultSubobject<UPhysicsConstraintComponent>(TEXT("%sPhysicsConstraint"), *GetName());
     Constraint->AttachToComponent(this, FAttachmentTransformRules::KeepRelativeTransform);
+    Trajectories.SetNum(6);
 }
 
 bool URRPhysicsJointComponent::IsValid()
@@ -40,8 +46,30 @@ void URRPhysicsJointComponent::Initialize()
     }
 }
 
+void URRPhysicsJointComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (bSubstepControlled)
+    {
+        if (FRRPhysicsSubstepManager* substepManager = FRRPhysicsSubstepManager::Get(GetWorld()))
+        {
+            substepManager->RemoveJoint(GetUniqueID());
+        }
+        bSubstepControlled = false;
+    }
+    Super::EndPlay(EndPlayReason);
+}
+
 void URRPhysicsJointComponent::SetJoint()
 {
+    // Profile is copied into the physics constraint upon its creation by SetConstrainedComponents()
+    if (bArticulated)
+    {
+        FConstraintProfileProperties& profile = Constraint->ConstraintInstance.ProfileInstance;
+        profile.bParentDominates = true;
+        profile.bEnableProjection = true;
+        profile.ProjectionLinearAlpha = 1.f;
+        profile.ProjectionAngularAlpha = 1.f;
+    }
     Constraint->SetConstrainedComponents(ParentLink, NAME_None, ChildLink, NAME_None);
 
     // set linear drive
@@ -88,6 +116,25 @@ void URRPhysicsJointComponent::SetJoint()
     Constraint->SetAngularDriveParams(AngularSpring, AngularDamper, AngularForceLimit);
 }
 
+void URRPhysicsJointComponent::SetDynamicProperties(const FRRRobotJointDynamicProperties& InDynamicProperties)
+{
+    // [m] -> [cm]: stiffness & damping are unchanged, forces scale by 100, torques by 100*100
+    if (LinearDOF > 0)
+    {
+        LinearSpring = InDynamicProperties.SpringStiff;
+        LinearDamper = InDynamicProperties.Damping;
+        LinearForceLimit = 100.f * InDynamicProperties.MaxForceLimit;
+        LinearVelMax = FVector(100.f * InDynamicProperties.MaxVelocity);
+    }
+    else if (RotationalDOF > 0)
+    {
+        AngularSpring = 10000.f * InDynamicProperties.SpringStiff;
+        AngularDamper = 10000.f * InDynamicProperties.Damping;
+        AngularForceLimit = 10000.f * InDynamicProperties.MaxForceLimit;
+        AngularVelMax = FVector(FMath::RadiansToDegrees(InDynamicProperties.MaxVelocity));
+    }
+}
+
 void URRPhysicsJointComponent::SetVelocity(const FVector& InLinearVelocity, const FVector& InAngularVelocity)
 {
      UE_LOG(LogRapyutaCore, Error, TEXT("Can't set velocity directly to physics joint"));
@@ -103,6 +150,7 @@ void URRPhysicsJointComponent::SetVelocityTarget(const FVector& InLinearVelocity
 
     // set velocity target
     Super::SetVelocityTarget(InLinearVelocity, InAngularVelocity);
+    bSubstepControlDirty = true;
     if (!bSmoothing)
     {
         Constraint->SetLinearVelocityTarget(InLinearVelocity);
@@ -145,6 +193,7 @@ void URRPhysicsJointComponent::SetPoseTarget(const FVector& InPosition, const FR
     Constraint->SetLinearPositionDrive(true, true, true);
     Constraint->SetAngularOrientationDrive(true, true);
     Super::SetPoseTarget(InPosition, InOrientation);
+    bSubstepControlDirty = true;
 
     FVector OrientationEuler = Orientation.Euler();
     FVector OrientationTargetEuler = OrientationTarget.Euler();
@@ -182,23 +231,24 @@ void URRPhysicsJointComponent::SetPoseTarget(const FVector& InPosition, const FR
         {    
             if (!FMath::IsNearlyEqual(Position[i], PositionTarget[i], PositionTolerance))
             {
-                PositionTPI[i].calcTrajectory(
+                Trajectories.Plan(i,
                     Position[i], PositionTarget[i], //pose
                     LinearVelocitySmoothingAcc, LinearVelMax[i], //max
-                    t0, 
-                    LinearVelocity[i], 0.0 //velocity
+                    t0,
+                    LinearVelocity[i] //velocity
                 );
             }
 
             if (!FMath::IsNearlyEqual(OrientationEuler[i], OrientationTargetEuler[i], OrientationTolerance))
             {
-                OrientationTPI[i].calcTrajectory(
-                    FMath::DegreesToRadians(OrientationEuler[i]), 
+                Trajectories.Plan(i + 3,
+                    FMath::DegreesToRadians(OrientationEuler[i]),
                     FMath::DegreesToRadians(OrientationTargetEuler[i]), //pose
-                    FMath::DegreesToRadians(AngularVelocitySmoothingAcc), 
+                    FMath::DegreesToRadians(AngularVelocitySmoothingAcc),
                     FMath::DegreesToRadians(AngularVelMax[i]), //max
-                    t0, 
-                    FMath::DegreesToRadians(AngularVelocity[i]), 0.0 //velocity
+                    t0,
+                    FMath::DegreesToRadians(AngularVelocity[i]), //velocity
+                    true
                 );
             }
         }
@@ -233,6 +283,24 @@ void URRPhysicsJointComponent::UpdateState(const float DeltaTime)
     Position = relativeTrans.GetLocation() - JointToChildLink.GetLocation();
     Orientation = (relativeTrans.GetRotation()*JointToChildLink.GetRotation().Inverse()).Rotator();
 
+    if (bPhysicsVelocity)
+    {
+        // Bodies are read once for all joints of the robot, if updated by its joint block
+        const FRRLinkBodyStates::FState parentState =
+            LinkBodyStates ? LinkBodyStates->FindOrRead(*ParentLink) : FRRLinkBodyStates::FState::Read(*ParentLink);
+        const FRRLinkBodyStates::FState childState =
+            LinkBodyStates ? LinkBodyStates->FindOrRead(*ChildLink) : FRRLinkBodyStates::FState::Read(*ChildLink);
+
+        // Derivative of the child location in the joint frame, which rotates with the parent link
+        const FTransform& jointTransform = Constraint->GetComponentTransform();
+        const FVector childLocation = ChildLink->GetComponentLocation();
+        LinearVelocity = jointTransform.InverseTransformVectorNoScale(childState.GetVelocityAtPoint(childLocation) -
+                                                                       parentState.GetVelocityAtPoint(childLocation));
+        AngularVelocity = FMath::RadiansToDegrees(
+            jointTransform.InverseTransformVectorNoScale(childState.AngularVelocity - parentState.AngularVelocity));
+        return;
+    }
+
     FVector prevOrientationEuler = prevOrientation.Euler();
     FVector OrientationEuler = Orientation.Euler();
     for (uint8 i = 0; i < 3; i++)
@@ -273,8 +341,45 @@ void URRPhysicsJointComponent::UpdateState(const float DeltaTime)
 #endif
 }
 
+bool URRPhysicsJointComponent::UpdateSubstepControl()
+{
+    if (!bSubstepControlDirty)
+    {
+        return bSubstepControlled;
+    }
+
+    FRRPhysicsSubstepManager* substepManager = FRRPhysicsSubstepManager::Get(GetWorld());
+    if (nullptr == substepManager)
+    {
+        return false;
+    }
+
+    FRRJointSubstepControl control;
+    control.ControlType = ControlType;
+    control.LinearVelocityTarget = LinearVelocityTarget;
+    control.AngularVelocityTarget = AngularVelocityTarget;
+    control.MidLinearVelocityTarget = MidLinearVelocityTarget;
+    control.MidAngularVelocityTarget = MidAngularVelocityTarget;
+    control.LinearVelocitySmoothingAcc = LinearVelocitySmoothingAcc;
+    control.AngularVelocitySmoothingAcc = AngularVelocitySmoothingAcc;
+    control.LinearVelocityTolerance = LinearVelocityTolerance;
+    control.AngularVelocityTolerance = AngularVelocityTolerance;
+    control.MidPositionTarget = MidPositionTarget;
+    control.MidOrientationTarget = MidOrientationTarget;
+    control.Trajectories = Trajectories;
+    control.Time = GetWorld()->GetTimeSeconds();
+    bSubstepControlled = substepManager->SubmitJointControl(GetUniqueID(), Constraint, MoveTemp(control));
+    bSubstepControlDirty = !bSubstepControlled;
+    return bSubstepControlled;
+}
+
 void URRPhysicsJointComponent::UpdateControl(const float DeltaTime)
 {
+    if (bSmoothing && bSubstepControl && UpdateSubstepControl())
+    {
+        return;
+    }
+
     uint8 i = 0;
     if( ControlType == ERRJointControlType::POSITION )
     {       
@@ -283,23 +388,23 @@ void URRPhysicsJointComponent::UpdateControl(const float DeltaTime)
         if (bSmoothing)
         {
             // input
-            float t = GetWorld()->GetTimeSeconds();
+            float t = UpdateTime;
             
-            // output
-            bool initialized = true;
+            // output, all axes at once
+            double positions[6];
+            double velocities[6];
+            Trajectories.Evaluate(t, MakeArrayView(positions), MakeArrayView(velocities));
             for (i = 0; i < 3; i++)
             {
-                if (PositionTPI[i].isInitialized())
+                if (Trajectories.IsInitialized(i))
                 {
-                    std::vector<double> resPos = PositionTPI[i].getPoint(t);
-                    MidPositionTarget[i] = resPos[0];
-                    MidLinearVelocityTarget[i] = resPos[1];
+                    MidPositionTarget[i] = positions[i];
+                    MidLinearVelocityTarget[i] = velocities[i];
                 }
-                if (OrientationTPI[i].isInitialized())
+                if (Trajectories.IsInitialized(i + 3))
                 {
-                    std::vector<double> resOri = OrientationTPI[i].getPoint(t);
-                    MidOrientationTargetEuler[i] = FMath::RadiansToDegrees(resOri[0]);
-                    MidAngularVelocityTarget[i] = FMath::RadiansToDegrees(resOri[1]);   
+                    MidOrientationTargetEuler[i] = FMath::RadiansToDegrees(positions[i + 3]);
+                    MidAngularVelocityTarget[i] = FMath::RadiansToDegrees(velocities[i + 3]);
                 }
             }
             MidOrientationTarget = FRotator::MakeFromEuler(MidOrientationTargetEuler);
@@ -312,7 +417,7 @@ void URRPhysicsJointComponent::UpdateControl(const float DeltaTime)
         }
         else
         {
-            // todo support linear update in two_points_interpolation_constant_acc.hpp
+            // todo support linear update in FRRJointTrajectories
             // Set velocity=0 if it reached or overshoot
             // Use URRMathUtils::URRMathUtils::StepUpdate to check current value is within tolerance.
             FVector OrientationEuler = Orientation.Euler();
@@ -370,10 +475,9 @@ void URRPhysicsJointComponent::UpdateControl(const float DeltaTime)
 #endif
 }
 
-void URRPhysicsJointComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+void URRPhysicsJointComponent::UpdateJoint(const float InDeltaTime, const float InTime)
 {
-    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-
-    UpdateState(DeltaTime);
-    UpdateControl(DeltaTime);
+    UpdateTime = InTime;
+    UpdateState(InDeltaTime);
+    UpdateControl(InDeltaTime);
 }
\ No newline at end of file
@@ -0,0 +1,281 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Drives/RRPhysicsSubstepManager.h"
+
+// UE
+#include "Chaos/PBDJointConstraints.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+#include "PhysicsEngine/PhysicsConstraintComponent.h"
+#include "PhysicsProxy/JointConstraintProxy.h"
+#include "PhysicsProxy/SingleParticlePhysicsProxy.h"
+#include "PBDRigidsSolver.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRMathUtils.h"
+
+void FRRJointSubstepControl::Step_Internal(const float InDeltaTime)
+{
+    Chaos::FPBDJointConstraintHandle* handle = Proxy ? Proxy->GetHandle() : nullptr;
+    if (nullptr == handle)
+    {
+        return;
+    }
+
+    Time += InDeltaTime;
+    Chaos::FPBDJointSettings settings = handle->GetSettings();
+    if (ERRJointControlType::POSITION == ControlType)
+    {
+        FVector midOrientationTargetEuler = MidOrientationTarget.Euler();
+        double positions[6];
+        double velocities[6];
+        Trajectories.Evaluate(Time, MakeArrayView(positions), MakeArrayView(velocities));
+        for (uint8 i = 0; i < 3; ++i)
+        {
+            if (Trajectories.IsInitialized(i))
+            {
+                MidPositionTarget[i] = positions[i];
+                MidLinearVelocityTarget[i] = velocities[i];
+            }
+            if (Trajectories.IsInitialized(i + 3))
+            {
+                midOrientationTargetEuler[i] = FMath::RadiansToDegrees(positions[i + 3]);
+                MidAngularVelocityTarget[i] = FMath::RadiansToDegrees(velocities[i + 3]);
+            }
+        }
+        MidOrientationTarget = FRotator::MakeFromEuler(midOrientationTargetEuler);
+
+        settings.LinearDrivePositionTarget = MidPositionTarget;
+        // Same inverse conversion as URRPhysicsJointComponent::UpdateControl()
+        settings.AngularDrivePositionTarget =
+            FRotator(-MidOrientationTarget.Pitch, -MidOrientationTarget.Yaw, -MidOrientationTarget.Roll).Quaternion();
+    }
+    else if (ERRJointControlType::VELOCITY == ControlType)
+    {
+        for (uint8 i = 0; i < 3; ++i)
+        {
+            URRMathUtils::StepUpdate(MidLinearVelocityTarget[i],
+                                     LinearVelocityTarget[i],
+                                     LinearVelocitySmoothingAcc * InDeltaTime,
+                                     LinearVelocityTolerance);
+            URRMathUtils::StepUpdate(MidAngularVelocityTarget[i],
+                                     AngularVelocityTarget[i],
+                                     AngularVelocitySmoothingAcc * InDeltaTime,
+                                     AngularVelocityTolerance);
+        }
+    }
+    else
+    {
+        return;
+    }
+
+    // [deg/s] -> [rev/s] -> [rad/s], as by FConstraintInstance::SetAngularVelocityTarget()
+    settings.LinearDriveVelocityTarget = MidLinearVelocityTarget;
+    settings.AngularDriveVelocityTarget = MidAngularVelocityTarget / 360.0 * UE_TWO_PI;
+    handle->SetSettings(settings);
+}
+
+void FRRConstraintDriveTarget::Apply_Internal() const
+{
+    if (Chaos::FPBDJointConstraintHandle* handle = Proxy ? Proxy->GetHandle() : nullptr)
+    {
+        Chaos::FPBDJointSettings settings = handle->GetSettings();
+        settings.AngularDriveVelocityTarget = AngularVelocityTarget;
+        handle->SetSettings(settings);
+    }
+}
+
+void FRRImuSubstepSampler::Sample_Internal(const float InDeltaTime)
+{
+    Chaos::FRigidBodyHandle_Internal* body = Proxy ? Proxy->GetPhysicsThreadAPI() : nullptr;
+    if (nullptr == body)
+    {
+        return;
+    }
+
+    // State at the end of the previous substep, whose delta time the velocity change is over
+    const FQuat bodyRotation = body->R();
+    const FQuat sensorRotation = bodyRotation * MountTransform.GetRotation();
+    const FVector angularVelocity = body->W();
+    const FVector velocity =
+        body->V() + FVector::CrossProduct(angularVelocity, bodyRotation.RotateVector(MountTransform.GetLocation()));
+    if (bHasPrevVelocity && (PrevDeltaTime > UE_SMALL_NUMBER))
+    {
+        FRRImuSample sample;
+        sample.Time = Time;
+        sample.LinearAcceleration = sensorRotation.UnrotateVector((velocity - PrevVelocity) / PrevDeltaTime - Gravity);
+        sample.AngularVelocity = sensorRotation.UnrotateVector(angularVelocity);
+        sample.Orientation = sensorRotation;
+        Ring->Push(sample);
+    }
+    PrevVelocity = velocity;
+    PrevDeltaTime = InDeltaTime;
+    bHasPrevVelocity = true;
+    Time += InDeltaTime;
+}
+
+void FRRPhysicsSubstepCallback::OnPreSimulate_Internal()
+{
+    // The same input may be given to all substeps of a game frame, thus only applied once
+    const FRRPhysicsSubstepInput* input = GetConsumerInput_Internal();
+    if (input && (input->FrameId != LastFrameId))
+    {
+        LastFrameId = input->FrameId;
+        for (const uint32 jointId : input->RemovedJointIds)
+        {
+            JointControls.Remove(jointId);
+        }
+        for (const auto& jointControl : input->JointControls)
+        {
+            JointControls.Add(jointControl.Key, jointControl.Value);
+        }
+        for (const auto& driveTarget : input->DriveTargets)
+        {
+            driveTarget.Value.Apply_Internal();
+        }
+        for (const uint32 imuId : input->RemovedImuIds)
+        {
+            ImuSamplers.Remove(imuId);
+        }
+        for (const auto& imuSampler : input->ImuSamplers)
+        {
+            ImuSamplers.Add(imuSampler.Key, imuSampler.Value);
+        }
+    }
+
+    const float deltaTime = GetDeltaTime_Internal();
+    for (auto& jointControl : JointControls)
+    {
+        jointControl.Value.Step_Internal(deltaTime);
+    }
+    for (auto& imuSampler : ImuSamplers)
+    {
+        imuSampler.Value.Sample_Internal(deltaTime);
+    }
+}
+
+TMap<UWorld*, TUniquePtr<FRRPhysicsSubstepManager>> FRRPhysicsSubstepManager::SManagers;
+std::once_flag FRRPhysicsSubstepManager::OnceFlag;
+
+FRRPhysicsSubstepManager::~FRRPhysicsSubstepManager()
+{
+    UWorld* world = World.Get();
+    FPhysScene* physScene = world ? world->GetPhysicsScene() : nullptr;
+    if (Callback && physScene && physScene->GetSolver())
+    {
+        physScene->GetSolver()->UnregisterAndFreeSimCallbackObject_External(Callback);
+    }
+    Callback = nullptr;
+}
+
+FRRPhysicsSubstepManager* FRRPhysicsSubstepManager::Get(UWorld* InWorld)
+{
+    check(IsInGameThread());
+    std::call_once(OnceFlag,
+                   []() { FWorldDelegates::OnPostWorldCleanup.AddStatic(&FRRPhysicsSubstepManager::OnPostWorldCleanup); });
+
+    FPhysScene* physScene = InWorld ? InWorld->GetPhysicsScene() : nullptr;
+    if ((nullptr == physScene) || (nullptr == physScene->GetSolver()))
+    {
+        return nullptr;
+    }
+
+    TUniquePtr<FRRPhysicsSubstepManager>& manager = SManagers.FindOrAdd(InWorld);
+    if (!manager.IsValid())
+    {
+        manager = MakeUnique<FRRPhysicsSubstepManager>();
+        manager->World = InWorld;
+        manager->Callback = physScene->GetSolver()->CreateAndRegisterSimCallbackObject_External<FRRPhysicsSubstepCallback>();
+    }
+    return manager.Get();
+}
+
+void FRRPhysicsSubstepManager::OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/)
+{
+    SManagers.Remove(InWorld);
+}
+
+FRRPhysicsSubstepInput* FRRPhysicsSubstepManager::GetInput()
+{
+    FRRPhysicsSubstepInput* input = Callback->GetProducerInputData_External();
+    // Frame ids start from 1, the physics thread's initial last one being 0
+    input->FrameId = GFrameCounter + 1;
+    return input;
+}
+
+bool FRRPhysicsSubstepManager::SubmitJointControl(const uint32 InJointId,
+                                                  UPhysicsConstraintComponent* InConstraint,
+                                                  FRRJointSubstepControl&& InControl)
+{
+    check(IsInGameThread());
+    InControl.Proxy = GetJointProxy(InConstraint);
+    if (nullptr == InControl.Proxy)
+    {
+        return false;
+    }
+
+    GetInput()->JointControls.Emplace(InJointId, MoveTemp(InControl));
+    return true;
+}
+
+void FRRPhysicsSubstepManager::RemoveJoint(const uint32 InJointId)
+{
+    check(IsInGameThread());
+    GetInput()->RemovedJointIds.Add(InJointId);
+}
+
+FJointConstraintPhysicsProxy* FRRPhysicsSubstepManager::GetJointProxy(UPhysicsConstraintComponent* InConstraint)
+{
+    const FPhysicsConstraintHandle& constraintHandle = InConstraint->ConstraintInstance.ConstraintHandle;
+    if (!constraintHandle.IsValid() || !constraintHandle.Constraint->IsType(Chaos::EConstraintType::JointConstraintType))
+    {
+        return nullptr;
+    }
+    return static_cast<Chaos::FJointConstraint*>(constraintHandle.Constraint)->GetProxy<FJointConstraintPhysicsProxy>();
+}
+
+void FRRPhysicsSubstepManager::SubmitDriveTarget(const uint32 InConstraintId,
+                                                 FJointConstraintPhysicsProxy* InProxy,
+                                                 const FVector& InAngularVelocityTarget)
+{
+    check(IsInGameThread());
+    FRRConstraintDriveTarget driveTarget;
+    driveTarget.Proxy = InProxy;
+    driveTarget.AngularVelocityTarget = InAngularVelocityTarget;
+    GetInput()->DriveTargets.Emplace(InConstraintId, driveTarget);
+}
+
+void FRRPhysicsSubstepManager::RemoveDriveTargets(const uint32 InConstraintId)
+{
+    check(IsInGameThread());
+    GetInput()->DriveTargets.RemoveAll([InConstraintId](const TPair<uint32, FRRConstraintDriveTarget>& InDriveTarget)
+                                       { return InDriveTarget.Key == InConstraintId; });
+}
+
+bool FRRPhysicsSubstepManager::SubmitImuSampler(const uint32 InImuId,
+                                                UPrimitiveComponent* InBody,
+                                                FRRImuSubstepSampler&& InSampler)
+{
+    check(IsInGameThread());
+    FBodyInstance* bodyInstance = InBody ? InBody->GetBodyInstance() : nullptr;
+    InSampler.Proxy = bodyInstance ? bodyInstance->ActorHandle : nullptr;
+    if ((nullptr == InSampler.Proxy) || !InSampler.Ring.IsValid())
+    {
+        return false;
+    }
+
+    // Removals are applied first on physics thread, thus not to drop a sampler resubmitted in the same frame
+    GetInput()->RemovedImuIds.Remove(InImuId);
+    GetInput()->ImuSamplers.Emplace(InImuId, MoveTemp(InSampler));
+    return true;
+}
+
+void FRRPhysicsSubstepManager::RemoveImu(const uint32 InImuId)
+{
+    check(IsInGameThread());
+    FRRPhysicsSubstepInput* input = GetInput();
+    input->ImuSamplers.RemoveAll([InImuId](const TPair<uint32, FRRImuSubstepSampler>& InImuSampler)
+                                 { return InImuSampler.Key == InImuId; });
+    input->RemovedImuIds.Add(InImuId);
+}
@@ -11,7 +11,10 @@
 
 // RapyutaSimulationPlugins
 #include "Core/RRConversionUtils.h"
+#include "Drives/RRDriveTickManager.h"
 #include "Drives/RRFloatingMovementComponent.h"
+#include "Drives/RRFloorContactSolver.h"
+#include "Drives/RRKinematicFleet.h"
 #include "Robots/RRBaseRobot.h"
 
 // rclUE
@@ -23,6 +26,24 @@ void URobotVehicleMovementComponent::Initialize()
     InitData();
 }
 
+void URobotVehicleMovementComponent::BeginPlay()
+{
+    Super::BeginPlay();
+    if (bAggregatedTick)
+    {
+        FRRDriveTickManager::Get(GetWorld()).AddComponent(this, GetDriveParallelUpdate());
+    }
+}
+
+void URobotVehicleMovementComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (bAggregatedTick)
+    {
+        FRRDriveTickManager::Get(GetWorld()).RemoveComponent(this);
+    }
+    Super::EndPlay(EndPlayReason);
+}
+
 void URobotVehicleMovementComponent::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
@@ -104,8 +125,12 @@ void URobotVehicleMovementComponent::UpdateMovement(float InDeltaTime)
     DesiredRotation = oldRotation * deltaRotation;
     DesiredMovement = (oldRotation * position);
 
-    // if Robot is on a moving platform, add the platform motion
-    if (MovingPlatform != nullptr && bAdaptToSurfaceBelow)
+    const FTransform driveMove = ComputeDriveLocalMove(InDeltaTime);
+    DesiredMovement += DesiredRotation * driveMove.GetLocation();
+    DesiredRotation *= driveMove.GetRotation();
+
+    // if Robot is on a moving platform, add the platform motion, unless carried by it as attached
+    if (MovingPlatform != nullptr && bAdaptToSurfaceBelow && !bAttachedToPlatform)
     {
         FVector currentPlatformLocation = MovingPlatform->GetActorLocation();
         FVector platformTranslation = currentPlatformLocation - LastPlatformLocation;
@@ -121,17 +146,38 @@ void URobotVehicleMovementComponent::UpdateMovement(float InDeltaTime)
     // modification (if some modifications!) if collision detected, need to check actions possible : stop motion (if static object
     // or object mass >> vehicle mass), reduce motion (if movable object and object mass ~ vehicle mass), ignore ?
 
+    if (bFleetMovement)
+    {
+        // Moved along with all other fleet robots, later in the frame
+        FRRKinematicFleet::Get(GetWorld()).SubmitMove(this, DesiredMovement, DesiredRotation, FleetRadius, InDeltaTime);
+        return;
+    }
+    ApplyMovement(DesiredMovement, DesiredRotation, true, InDeltaTime);
+}
+
+void URobotVehicleMovementComponent::ApplyMovement(const FVector& InDelta,
+                                                   const FQuat& InNewRotation,
+                                                   const bool bInSweep,
+                                                   const float InDeltaTime)
+{
     FHitResult hit;
-    SafeMoveUpdatedComponent(DesiredMovement, DesiredRotation, true, hit);
+    SafeMoveUpdatedComponent(InDelta, InNewRotation, bInSweep, hit);
 
     // If we bumped into something, try to slide along it
     if (hit.IsValidBlockingHit())
     {
-        SlideAlongSurface(DesiredMovement, 1.0f - hit.Time, hit.Normal, hit);
+        SlideAlongSurface(InDelta, 1.0f - hit.Time, hit.Normal, hit);
     }
 
     if (bAdaptToSurfaceBelow)
     {
+        if (bBatchFloorContacts)
+        {
+            // Traced with all other robots' contacts, later in the frame
+            FRRFloorContactSolver::Get(GetWorld()).AddRobot(this, InDeltaTime);
+            return;
+        }
+
         // check for floor configuration beneath the robot : slopes, etc
         AActor* owner = GetOwner();
         FCollisionQueryParams traceParams = FCollisionQueryParams(FName(TEXT("Contact_Trace")), true, owner);
@@ -140,101 +186,127 @@ void URobotVehicleMovementComponent::UpdateMovement(float InDeltaTime)
         traceParams.bReturnFaceIndex = true;
         traceParams.AddIgnoredActor(owner);
 
-        // If few contact points defined, cast a single ray beneath the robot to get the floor orientation
-        if (ContactPoints.Num() < 3)
+        TArray<FVector> rayStarts;
+        TArray<FVector> rayEnds;
+        GetFloorContactRays(rayStarts, rayEnds);
+        TArray<FHitResult, TInlineAllocator<8>> hits;
+        hits.SetNum(rayStarts.Num());
+        for (int32 i = 0; i < rayStarts.Num(); ++i)
         {
-            // robot will be oriented as the normal vector in floor plane
-            FVector startPos = owner->GetActorLocation() + FVector(0., 0., RayOffsetUp);
-            FVector endPos = owner->GetActorLocation() - FVector(0., 0., RayOffsetDown);
-            bool bIsFloorHit = GetWorld()->LineTraceSingleByChannel(hit,
-                                                                    startPos,
-                                                                    endPos,
-                                                                    ECollisionChannel::ECC_Visibility,
-                                                                    traceParams,
-                                                                    FCollisionResponseParams::DefaultResponseParam);
-            if (bIsFloorHit)
-            {
-                FVector forwardProjection = FVector::VectorPlaneProject(owner->GetActorForwardVector(), hit.ImpactNormal);
-                owner->SetActorRotation(UKismetMathLibrary::MakeRotFromXZ(forwardProjection, hit.ImpactNormal));
-                if (MovingPlatform == nullptr)
-                {
-                    FVector heightVariation = {0., 0., MinDistanceToFloor - hit.Distance};
-                    owner->AddActorWorldOffset(heightVariation, true, &hit, ETeleportType::None);
-                }
-            }
-            else
+            GetWorld()->LineTraceSingleByChannel(hits[i],
+                                                 rayStarts[i],
+                                                 rayEnds[i],
+                                                 ECollisionChannel::ECC_Visibility,
+                                                 traceParams,
+                                                 FCollisionResponseParams::DefaultResponseParam);
+        }
+        AdaptToFloor(hits, InDeltaTime);
+    }
+}
+
+void URobotVehicleMovementComponent::GetFloorContactRays(TArray<FVector>& OutStarts, TArray<FVector>& OutEnds) const
+{
+    // If few contact points defined, cast a single ray beneath the robot to get the floor orientation
+    if (ContactPoints.Num() < 3)
+    {
+        const FVector location = GetOwner()->GetActorLocation();
+        OutStarts.Add(location + FVector(0., 0., RayOffsetUp));
+        OutEnds.Add(location - FVector(0., 0., RayOffsetDown));
+    }
+    else
+    {
+        for (const USceneComponent* contact : ContactPoints)
+        {
+            const FVector location = contact->GetComponentLocation();
+            OutStarts.Add(location + FVector(0.f, 0.f, RayOffsetUp));
+            OutEnds.Add(location - FVector(0.f, 0.f, RayOffsetDown));
+        }
+    }
+}
+
+void URobotVehicleMovementComponent::AdaptToFloor(TArrayView<FHitResult> InHits, const float InDeltaTime)
+{
+    AActor* owner = GetOwner();
+    FHitResult hit;
+    if (ContactPoints.Num() < 3)
+    {
+        // robot will be oriented as the normal vector in floor plane
+        const FHitResult& floorHit = InHits[0];
+        if (floorHit.bBlockingHit)
+        {
+            FVector forwardProjection = FVector::VectorPlaneProject(owner->GetActorForwardVector(), floorHit.ImpactNormal);
+            owner->SetActorRotation(UKismetMathLibrary::MakeRotFromXZ(forwardProjection, floorHit.ImpactNormal));
+            if (MovingPlatform == nullptr)
             {
-                // very basic robot falling
-                owner->AddActorWorldOffset(FVector(0., 0., -FallingSpeed * InDeltaTime), true, &hit, ETeleportType::None);
+                FVector heightVariation = {0., 0., MinDistanceToFloor - floorHit.Distance};
+                owner->AddActorWorldOffset(heightVariation, true, &hit, ETeleportType::None);
             }
         }
         else
         {
-            // compute all impact points and keep the 3 closest
-            // get the normal vector of the plane formed by these 3 points
-            FVector contacts[3];
-            float contactsDistance[3];
-            uint8 nbContact = 0;
+            // very basic robot falling
+            owner->AddActorWorldOffset(FVector(0., 0., -FallingSpeed * InDeltaTime), true, &hit, ETeleportType::None);
+        }
+    }
+    else
+    {
+        // compute all impact points and keep the 3 closest
+        // get the normal vector of the plane formed by these 3 points
+        FVector contacts[3];
+        float contactsDistance[3];
+        uint8 nbContact = 0;
 
-            for (USceneComponent* contact : ContactPoints)
+        for (int32 i = 0; i < ContactPoints.Num(); ++i)
+        {
+            FHitResult& contactHit = InHits[i];
+            if (!contactHit.bBlockingHit)
             {
-                // get the contact points
-                FVector startPos = contact->GetComponentLocation() + FVector(0.f, 0.f, RayOffsetUp);
-                FVector endPos = contact->GetComponentLocation() - FVector(0.f, 0.f, RayOffsetDown);
-                bool bIsFloorHit = GetWorld()->LineTraceSingleByChannel(hit,
-                                                                        startPos,
-                                                                        endPos,
-                                                                        ECollisionChannel::ECC_Visibility,
-                                                                        traceParams,
-                                                                        FCollisionResponseParams::DefaultResponseParam);
-                if (!bIsFloorHit)
-                {
-                    // if no impact below, just consider this contact point is falling
-                    hit.ImpactPoint = contact->GetComponentLocation() - FVector(0.f, 0.f, FallingSpeed * InDeltaTime);
-                    hit.Distance = RayOffsetUp + FallingSpeed * InDeltaTime;
-                }
+                // if no impact below, just consider this contact point is falling
+                contactHit.ImpactPoint =
+                    ContactPoints[i]->GetComponentLocation() - FVector(0.f, 0.f, FallingSpeed * InDeltaTime);
+                contactHit.Distance = RayOffsetUp + FallingSpeed * InDeltaTime;
+            }
 
-                // keep only the 3 contacts with shortest distances
-                if (nbContact < 3)
-                {
-                    contacts[nbContact] = hit.ImpactPoint;
-                    contactsDistance[nbContact] = hit.Distance;
-                    nbContact++;
-                }
-                else
+            // keep only the 3 contacts with shortest distances
+            if (nbContact < 3)
+            {
+                contacts[nbContact] = contactHit.ImpactPoint;
+                contactsDistance[nbContact] = contactHit.Distance;
+                nbContact++;
+            }
+            else
+            {
+                uint8 maxContactDistanceIndex = 0;
+                if (contactsDistance[1] > contactsDistance[0])
+                    maxContactDistanceIndex = 1;
+                if (contactsDistance[2] > contactsDistance[maxContactDistanceIndex])
+                    maxContactDistanceIndex = 2;
+                if (contactHit.Distance < contactsDistance[maxContactDistanceIndex])
                 {
-                    uint8 maxContactDistanceIndex = 0;
-                    if (contactsDistance[1] > contactsDistance[0])
-                        maxContactDistanceIndex = 1;
-                    if (contactsDistance[2] > contactsDistance[maxContactDistanceIndex])
-                        maxContactDistanceIndex = 2;
-                    if (hit.Distance < contactsDistance[maxContactDistanceIndex])
-                    {
-                        contactsDistance[maxContactDistanceIndex] = hit.Distance;
-                        contacts[maxContactDistanceIndex] = hit.ImpactPoint;
-                    }
+                    contactsDistance[maxContactDistanceIndex] = contactHit.Distance;
+                    contacts[maxContactDistanceIndex] = contactHit.ImpactPoint;
                 }
             }
+        }
 
-            // get the normal vector of the plane going through these 3 points
-            FVector planeNormal = FVector::CrossProduct(contacts[1] - contacts[0], contacts[2] - contacts[0]);
-            planeNormal.Normalize(0.01f);
-            if (planeNormal.Z < 0.f)
-                planeNormal = -planeNormal;
+        // get the normal vector of the plane going through these 3 points
+        FVector planeNormal = FVector::CrossProduct(contacts[1] - contacts[0], contacts[2] - contacts[0]);
+        planeNormal.Normalize(0.01f);
+        if (planeNormal.Z < 0.f)
+            planeNormal = -planeNormal;
 
-            FVector ForwardProjection = FVector::VectorPlaneProject(owner->GetActorForwardVector(), planeNormal);
-            owner->SetActorRotation(UKismetMathLibrary::MakeRotFromXZ(ForwardProjection, planeNormal));
+        FVector ForwardProjection = FVector::VectorPlaneProject(owner->GetActorForwardVector(), planeNormal);
+        owner->SetActorRotation(UKismetMathLibrary::MakeRotFromXZ(ForwardProjection, planeNormal));
 
-            if (MovingPlatform == nullptr)
-            {
-                // Moves the robot up or down, depending on impact position
-                float minDistance = *Algo::MinElement(contactsDistance);
-                minDistance -= RayOffsetUp;
-                minDistance = FMath::Min(minDistance, FallingSpeed * InDeltaTime);
+        if (MovingPlatform == nullptr)
+        {
+            // Moves the robot up or down, depending on impact position
+            float minDistance = *Algo::MinElement(contactsDistance);
+            minDistance -= RayOffsetUp;
+            minDistance = FMath::Min(minDistance, FallingSpeed * InDeltaTime);
 
-                FVector heightVariation = {0., 0., -minDistance};
-                owner->AddActorWorldOffset(heightVariation, false, &hit, ETeleportType::None);
-            }
+            FVector heightVariation = {0., 0., -minDistance};
+            owner->AddActorWorldOffset(heightVariation, false, &hit, ETeleportType::None);
         }
     }
 }
@@ -276,13 +348,38 @@ void URobotVehicleMovementComponent::InitData()
 #if RAPYUTA_SIM_VERBOSE
     UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("Min Distance To Floor = %f"), MinDistanceToFloor);
 #endif
+
+    // Batched contacts only need the floor distance, against simple collision
+    BatchFloorTraceParams = FCollisionQueryParams(FName(TEXT("Batch_Contact_Trace")), false, owner);
+    if (bBatchFloorContacts && bCacheStaticFloorHeights && StaticFloorMapBounds.IsValid)
+    {
+        FRRFloorContactSolver::Get(GetWorld()).BuildStaticFloorMap(StaticFloorMapBounds, StaticFloorCellSize);
+    }
 }
 
 void URobotVehicleMovementComponent::SetMovingPlatform(AActor* InPlatform)
 {
+    if (MovingPlatform && (MovingPlatform != InPlatform))
+    {
+        RemoveMovingPlatform();
+    }
     MovingPlatform = InPlatform;
     LastPlatformLocation = InPlatform->GetActorLocation();
     LastPlatformRotation = InPlatform->GetActorQuat();
+
+    // Not overriding any other attachment of the robot, eg by ASimulationState's attach service
+    AActor* owner = GetOwner();
+    if (bAttachToMovingPlatform && !bAttachedToPlatform && (nullptr == owner->GetAttachParentActor()))
+    {
+        bAttachedToPlatform = owner->AttachToActor(InPlatform, FAttachmentTransformRules::KeepWorldTransform);
+        if (!bAttachedToPlatform)
+        {
+            UE_LOG_WITH_INFO_NAMED(LogRapyutaCore,
+                                   Warning,
+                                   TEXT("Failed attaching to moving platform %s, following its translation instead"),
+                                   *InPlatform->GetName());
+        }
+    }
 }
 
 bool URobotVehicleMovementComponent::IsOnMovingPlatform()
@@ -292,5 +389,14 @@ bool URobotVehicleMovementComponent::IsOnMovingPlatform()
 
 void URobotVehicleMovementComponent::RemoveMovingPlatform()
 {
+    if (bAttachedToPlatform)
+    {
+        AActor* owner = GetOwner();
+        if (owner->GetAttachParentActor() == MovingPlatform)
+        {
+            owner->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+        }
+        bAttachedToPlatform = false;
+    }
     MovingPlatform = nullptr;
 }
@@ -3,6 +3,8 @@
 #include "Robots/RRBaseRobot.h"
 
 // UE
+#include "Components/SkeletalMeshComponent.h"
+#include "Components/WorldPartitionStreamingSourceComponent.h"
 #include "Engine/ActorChannel.h"
 #include "Net/UnrealNetwork.h"
 
@@ -10,17 +12,24 @@
 #include "ROS2NodeComponent.h"
 
 // RapyutaSimulationPlugins
+#include "Core/RRCoreUtils.h"
 #include "Core/RRGameSingleton.h"
 #include "Core/RRNetworkGameMode.h"
 #include "Core/RRNetworkGameState.h"
 #include "Core/RRNetworkPlayerController.h"
+#include "Core/RRROS2GameMode.h"
+#include "Core/RRROS2InterfacePool.h"
+#include "Core/RRSkeletalAnimLODManager.h"
 #include "Core/RRUObjectUtils.h"
 #include "Drives/RRJointComponent.h"
 #include "Drives/RobotVehicleMovementComponent.h"
 #include "Robots/RRBaseRobotROSController.h"
 #include "Robots/RRRobotROS2Interface.h"
+#include "Sensors/RRBaseLidarComponent.h"
 #include "Sensors/RRROS2BaseSensorComponent.h"
+#include "Sensors/RRROS2CameraComponent.h"
 #include "Tools/SimulationState.h"
+#include "UI/RRRobotLabelsWidget.h"
 #include "UI/RRUserWidget.h"
 
 // Others
@@ -223,8 +232,19 @@ void ARRBaseRobot::SetRootOffset(const FTransform& InRootOffset)
 void ARRBaseRobot::CreateROS2Interface()
 {
     UE_LOG_WITH_INFO_NAMED(LogRapyutaCore, Display, TEXT("IsNetMode: %d"), IsNetMode(NM_Client));
-    ROS2Interface = CastChecked<URRRobotROS2Interface>(
-        URRUObjectUtils::CreateSelfSubobject(this, ROS2InterfaceClass, FString::Printf(TEXT("%sROS2Interface"), *GetName())));
+
+    // Interface parked by a robot deleted in the same namespace, with its ROS 2 node & endpoints
+    auto* gameMode = GetWorld()->GetAuthGameMode<ARRROS2GameMode>();
+    URRROS2InterfacePool* interfacePool =
+        (gameMode && IsNetMode(NM_Standalone)) ? gameMode->GetRobotROS2InterfacePool() : nullptr;
+    const FString poolKey = interfacePool ? URRROS2InterfacePool::MakeKey(this) : FString();
+    ROS2Interface = interfacePool ? interfacePool->Acquire(poolKey, this) : nullptr;
+    if (nullptr == ROS2Interface)
+    {
+        ROS2Interface = CastChecked<URRRobotROS2Interface>(URRUObjectUtils::CreateSelfSubobject(
+            this, ROS2InterfaceClass, FString::Printf(TEXT("%sROS2Interface"), *GetName())));
+    }
+    ROS2Interface->PoolKey = poolKey;
     ROS2Interface->ROSSpawnParameters = ROSSpawnParameters;
     ROS2Interface->SetupROSParamsAll();
 
@@ -370,12 +390,64 @@ bool ARRBaseRobot::InitSensors(UROS2NodeComponent* InROS2Node)
     {
         sensorComp->InitalizeWithROS2(InROS2Node);
     }
+    UpdateStreamingSourceShapes();
 
     return true;
 }
 
+void ARRBaseRobot::UpdateStreamingSourceShapes()
+{
+    const UWorld* world = GetWorld();
+    if (!bWorldPartitionStreamingSource || (nullptr == world) || (nullptr == world->GetWorldPartition()))
+    {
+        return;
+    }
+    if (nullptr == StreamingSourceComp)
+    {
+        StreamingSourceComp = NewObject<UWorldPartitionStreamingSourceComponent>(this, TEXT("StreamingSourceComp"));
+        StreamingSourceComp->RegisterComponent();
+    }
+
+    // Shapes are relative to the robot
+    TArray<FStreamingSourceShape>& shapes = StreamingSourceComp->Shapes;
+    shapes.Reset();
+    FStreamingSourceShape& bodyShape = shapes.AddDefaulted_GetRef();
+    bodyShape.bUseGridLoadingRange = (StreamingSourceRadius <= 0.f);
+    bodyShape.Radius = StreamingSourceRadius;
+
+    const FTransform& robotTransform = GetActorTransform();
+    TInlineComponentArray<URRROS2BaseSensorComponent*> sensorComponents(this);
+    for (const URRROS2BaseSensorComponent* sensorComp : sensorComponents)
+    {
+        if (const URRBaseLidarComponent* lidar = Cast<URRBaseLidarComponent>(sensorComp))
+        {
+            FStreamingSourceShape& shape = shapes.AddDefaulted_GetRef();
+            shape.bUseGridLoadingRange = false;
+            shape.Radius = lidar->MaxRange;
+            shape.Location = robotTransform.InverseTransformPosition(lidar->GetComponentLocation());
+        }
+        else if (const URRROS2CameraComponent* camera = Cast<URRROS2CameraComponent>(sensorComp))
+        {
+            const USceneCaptureComponent2D* capture = camera->SceneCaptureComponent;
+            if (capture)
+            {
+                FStreamingSourceShape& shape = shapes.AddDefaulted_GetRef();
+                shape.bUseGridLoadingRange = false;
+                shape.Radius = (capture->MaxViewDistanceOverride > 0.f) ? capture->MaxViewDistanceOverride : StreamingCameraRange;
+                shape.bIsSector = true;
+                shape.SectorAngle = FMath::Clamp(capture->FOVAngle, 1.f, 360.f);
+                shape.Location = robotTransform.InverseTransformPosition(capture->GetComponentLocation());
+                shape.Rotation = robotTransform.InverseTransformRotation(capture->GetComponentQuat()).Rotator();
+            }
+        }
+    }
+    StreamingSourceComp->EnableStreamingSource();
+}
+
 void ARRBaseRobot::SetJointState(const TMap<FString, TArray<float>>& InJointState, const ERRJointControlType InJointControlType)
 {
+    WakePhysics();
+
     // SetAngularVelocityTarget
     for (auto& joint : InJointState)
     {
@@ -440,7 +512,14 @@ void ARRBaseRobot::SyncServerLinearMovement(float InClientTimeStamp,
     auto* npc = Cast<ARRNetworkPlayerController>(UGameplayStatics::GetPlayerController(GetWorld(), 0));
     if (npc != nullptr)
     {
-        npc->ServerSetLinearVel(ServerRobot, InClientTimeStamp, InClientRobotTransform, InLinearVel);
+        if (ARRNetworkPlayerController::IsRobotMovementBatched())
+        {
+            npc->QueueRobotLinearMovement(ServerRobot, InClientTimeStamp, InClientRobotTransform, InLinearVel);
+        }
+        else
+        {
+            npc->ServerSetLinearVel(ServerRobot, InClientTimeStamp, InClientRobotTransform, InLinearVel);
+        }
     }
 }
 
@@ -461,13 +540,21 @@ void ARRBaseRobot::SyncServerAngularMovement(float InClientTimeStamp,
     auto* npc = Cast<ARRNetworkPlayerController>(UGameplayStatics::GetPlayerController(GetWorld(), 0));
     if (npc != nullptr)
     {
-        npc->ServerSetAngularVel(ServerRobot, InClientTimeStamp, InClientRobotRotation, InAngularVel);
+        if (ARRNetworkPlayerController::IsRobotMovementBatched())
+        {
+            npc->QueueRobotAngularMovement(ServerRobot, InClientTimeStamp, InClientRobotRotation, InAngularVel);
+        }
+        else
+        {
+            npc->ServerSetAngularVel(ServerRobot, InClientTimeStamp, InClientRobotRotation, InAngularVel);
+        }
     }
 }
 
 void ARRBaseRobot::SetLocalLinearVel(const FVector& InLinearVel)
 {
     TargetLinearVel = InLinearVel;
+    WakePhysics();
 #if RAPYUTA_SIM_DEBUG
     UE_LOG_WITH_INFO(LogRapyutaCore,
                      Warning,
@@ -480,6 +567,7 @@ void ARRBaseRobot::SetLocalLinearVel(const FVector& InLinearVel)
 void ARRBaseRobot::SetLocalAngularVel(const FVector& InAngularVel)
 {
     TargetAngularVel = InAngularVel;
+    WakePhysics();
 #if RAPYUTA_SIM_DEBUG
     UE_LOG_WITH_INFO(LogRapyutaCore,
                      Warning,
@@ -491,6 +579,15 @@ void ARRBaseRobot::SetLocalAngularVel(const FVector& InAngularVel)
 
 void ARRBaseRobot::InitUIWidget()
 {
+    if (bPooledUIWidget)
+    {
+        if (URRRobotLabelsWidget* labelsWidget = URRRobotLabelsWidget::Get(GetWorld()))
+        {
+            labelsWidget->AddLabel(this, GetName(), UIWidgetOffset.GetLocation());
+        }
+        return;
+    }
+
     UIWidgetComp = URRUObjectUtils::CreateAndAttachChildComponent<UWidgetComponent>(
         this, *FString::Printf(TEXT("%sUIWidget"), *GetName()), UIWidgetOffset);
 
@@ -537,7 +634,14 @@ bool ARRBaseRobot::CheckUIUserWidget() const
 
 void ARRBaseRobot::SetTooltipText(const FString& InTooltip)
 {
-    if (CheckUIUserWidget())
+    if (bPooledUIWidget)
+    {
+        if (URRRobotLabelsWidget* labelsWidget = URRRobotLabelsWidget::Get(GetWorld()))
+        {
+            labelsWidget->SetLabelText(this, InTooltip);
+        }
+    }
+    else if (CheckUIUserWidget())
     {
         UIUserWidget->SetLabelText(InTooltip);
     }
@@ -545,7 +649,11 @@ void ARRBaseRobot::SetTooltipText(const FString& InTooltip)
 
 void ARRBaseRobot::SetTooltipVisible(bool bInTooltipVisible)
 {
-    if (CheckUIUserWidget() && UIUserWidget->TextBlock)
+    if (bPooledUIWidget)
+    {
+        SetUIWidgetVisible(bInTooltipVisible);
+    }
+    else if (CheckUIUserWidget() && UIUserWidget->TextBlock)
     {
         UIUserWidget->TextBlock->SetVisibility(bInTooltipVisible ? ESlateVisibility::Visible : ESlateVisibility::Collapsed);
     }
@@ -553,7 +661,14 @@ void ARRBaseRobot::SetTooltipVisible(bool bInTooltipVisible)
 
 void ARRBaseRobot::SetUIWidgetVisible(bool bInWidgetVisible)
 {
-    if (CheckUIUserWidget())
+    if (bPooledUIWidget)
+    {
+        if (URRRobotLabelsWidget* labelsWidget = URRRobotLabelsWidget::Get(GetWorld()))
+        {
+            labelsWidget->SetLabelVisible(this, bInWidgetVisible);
+        }
+    }
+    else if (CheckUIUserWidget())
     {
         UIUserWidget->SetVisibility(bInWidgetVisible ? ESlateVisibility::Visible : ESlateVisibility::Collapsed);
     }
@@ -562,10 +677,69 @@ void ARRBaseRobot::SetUIWidgetVisible(bool bInWidgetVisible)
 void ARRBaseRobot::BeginPlay()
 {
     Super::BeginPlay();
-    if (bUIWidgetEnabled)
+    if (bUpdateJointsInRobot)
+    {
+        JointsTickFunction.Block = &JointStates;
+        JointsTickFunction.Joints = &Joints;
+        JointsTickFunction.bCanEverTick = true;
+        JointsTickFunction.TickGroup = TG_PrePhysics;
+        JointsTickFunction.RegisterTickFunction(GetLevel());
+    }
+    if (bUIWidgetEnabled && !URRCoreUtils::IsHeadlessSensorMode())
     {
         InitUIWidget();
     }
+    if (bMovementReconciliationEnabled && !IsNetMode(NM_Standalone) && (nullptr == MovementReconciler))
+    {
+        MovementReconciler = NewObject<URRRobotMovementReconciler>(this, TEXT("MovementReconciler"));
+        MovementReconciler->RegisterComponent();
+    }
+    if (bSkeletalAnimLODEnabled)
+    {
+        FRRSkeletalAnimLODManager& animLODManager = FRRSkeletalAnimLODManager::Get(GetWorld());
+        for (USkeletalMeshComponent* skeletalMeshComp : TInlineComponentArray<USkeletalMeshComponent*>(this))
+        {
+            animLODManager.AddSkeletalMesh(skeletalMeshComp);
+        }
+    }
+    UpdateStreamingSourceShapes();
+}
+
+void ARRBaseRobot::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (JointsTickFunction.IsTickFunctionRegistered())
+    {
+        JointsTickFunction.UnRegisterTickFunction();
+    }
+    if (bSkeletalAnimLODEnabled)
+    {
+        FRRSkeletalAnimLODManager& animLODManager = FRRSkeletalAnimLODManager::Get(GetWorld());
+        for (USkeletalMeshComponent* skeletalMeshComp : TInlineComponentArray<USkeletalMeshComponent*>(this))
+        {
+            animLODManager.RemoveSkeletalMesh(skeletalMeshComp);
+        }
+    }
+    if (bUIWidgetEnabled && bPooledUIWidget && (EndPlayReason == EEndPlayReason::Destroyed))
+    {
+        if (URRRobotLabelsWidget* labelsWidget = URRRobotLabelsWidget::Get(GetWorld()))
+        {
+            labelsWidget->RemoveLabel(this);
+        }
+    }
+    Super::EndPlay(EndPlayReason);
+}
+
+void ARRBaseRobot::Destroyed()
+{
+    if (ROS2Interface && IsNetMode(NM_Standalone))
+    {
+        auto* gameMode = GetWorld()->GetAuthGameMode<ARRROS2GameMode>();
+        if (URRROS2InterfacePool* interfacePool = gameMode ? gameMode->GetRobotROS2InterfacePool() : nullptr)
+        {
+            interfacePool->Park(this);
+        }
+    }
+    Super::Destroyed();
 }
 
 void ARRBaseRobot::Tick(float DeltaSeconds)
@@ -574,7 +748,36 @@ void ARRBaseRobot::Tick(float DeltaSeconds)
 
     // why this is required?
     // https://dev.epicgames.com/community/snippets/VP9/keep-chaos-physics-awake
+    // Only done while commanded then settling, so that parked robots cost nothing and their bodies sleep
+    const bool bCommanded = bAlwaysWakePhysics || !TargetLinearVel.IsNearlyZero() || !TargetAngularVel.IsNearlyZero() ||
+                            (GetWorld()->GetTimeSeconds() < PhysicsWakeEndTime);
+    if (!bCommanded && !bPhysicsSettling)
+    {
+        return;
+    }
+
     TInlineComponentArray<UStaticMeshComponent*> staticMeshComponents(this);
+    if (!bCommanded)
+    {
+        const float sleepLinearVelSquared = FMath::Square(PhysicsSleepLinearVelocity);
+        const float sleepAngularVelSquared = FMath::Square(PhysicsSleepAngularVelocity);
+        bPhysicsSettling = staticMeshComponents.ContainsByPredicate(
+            [sleepLinearVelSquared, sleepAngularVelSquared](const UStaticMeshComponent* InStaticMeshComp)
+            {
+                return InStaticMeshComp->IsSimulatingPhysics() &&
+                       ((InStaticMeshComp->GetPhysicsLinearVelocity().SizeSquared() > sleepLinearVelSquared) ||
+                        (InStaticMeshComp->GetPhysicsAngularVelocityInDegrees().SizeSquared() > sleepAngularVelSquared));
+            });
+        if (!bPhysicsSettling)
+        {
+            return;
+        }
+    }
+    else
+    {
+        bPhysicsSettling = true;
+    }
+
     for (auto& staticMeshComp : staticMeshComponents)
     {
         if (staticMeshComp->IsSimulatingPhysics())
@@ -584,6 +787,24 @@ void ARRBaseRobot::Tick(float DeltaSeconds)
     }
 }
 
+void ARRBaseRobot::WakePhysics()
+{
+    PhysicsWakeEndTime = GetWorld()->GetTimeSeconds() + PhysicsWakeDuration;
+}
+
+void ARRBaseRobot::PostNetReceiveLocationAndRotation()
+{
+    // Physics-replicated robots keep UE's own physics state smoothing
+    const FRepMovement& replicatedMovement = GetReplicatedMovement();
+    if (MovementReconciler && (ROLE_SimulatedProxy == GetLocalRole()) && !replicatedMovement.bRepPhysics)
+    {
+        MovementReconciler->AddRemotePose(FRepMovement::RebaseOntoLocalOrigin(replicatedMovement.Location, this),
+                                          replicatedMovement.Rotation);
+        return;
+    }
+    Super::PostNetReceiveLocationAndRotation();
+}
+
 void ARRBaseRobot::InitPropertiesFromJSON()
 {
     // Example Implementation of Json parser
@@ -594,14 +815,20 @@ void ARRBaseRobot::InitPropertiesFromJSON()
     //     return;
     // }
 
-    // TSharedRef<TJsonReader<TCHAR>> jsonReader = TJsonReaderFactory<TCHAR>::Create(ROSSpawnParameters->ActorJsonConfigs);
-    // TSharedPtr<FJsonObject> jsonObj = MakeShareable(new FJsonObject());
-    // if (!FJsonSerializer::Deserialize(jsonReader, jsonObj) && jsonObj.IsValid())
+    // // Parsed once for all robots spawned with the same configs, or the same configs file
+    // TSharedPtr<FJsonObject> jsonObj = URRGeneralUtils::GetCachedJsonObject(ROSSpawnParameters->ActorJsonConfigs);
+    // if (!jsonObj.IsValid())
     // {
-    //     UE_LOG_WITH_INFO_NAMED(LogRapyutaCore, Error, TEXT("Failed to deserialize json to object"));
     //     return;
     // }
 
+    // // Or converted once into a USTRUCT, copied into each robot
+    // FMyRobotConfigs configs;
+    // if (URRGeneralUtils::GetCachedJsonStruct(ROSSpawnParameters->ActorJsonConfigs, configs))
+    // {
+    //     MyConfigs = configs;
+    // }
+
     // // Parse single value
     // bool bParam = false;
     // if (URRGeneralUtils::GetJsonField(jsonObj, TEXT("bool_value"), bParam))
@@ -0,0 +1,171 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Robots/RRRobotMovementReconciler.h"
+
+// UE
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "GameFramework/GameStateBase.h"
+
+URRRobotMovementReconciler::URRRobotMovementReconciler()
+{
+    PrimaryComponentTick.bCanEverTick = true;
+    // After the owner's movement component has integrated its velocities
+    PrimaryComponentTick.TickGroup = TG_PostPhysics;
+}
+
+float URRRobotMovementReconciler::GetSimTime() const
+{
+    const UWorld* world = GetWorld();
+    const AGameStateBase* gameState = world ? world->GetGameState() : nullptr;
+    return gameState ? gameState->GetServerWorldTimeSeconds() : (world ? world->GetTimeSeconds() : 0.f);
+}
+
+void URRRobotMovementReconciler::TickComponent(float InDeltaTime,
+                                               enum ELevelTick InTickType,
+                                               FActorComponentTickFunction* InThisTickFunction)
+{
+    Super::TickComponent(InDeltaTime, InTickType, InThisTickFunction);
+    if (GetOwnerRole() == ROLE_Authority)
+    {
+        ReconcileClientMoves();
+        ApplyCorrections(InDeltaTime);
+    }
+    else if (GetOwnerRole() == ROLE_SimulatedProxy)
+    {
+        InterpolateRemotePoses();
+    }
+}
+
+void URRRobotMovementReconciler::AddClientMove(const FRRRobotMove& InMove)
+{
+    // Moves may arrive out of order, an older part being superseded by the latest one already received
+    if ((InMove.bHasLocation && (InMove.TimeStamp < LatestLocationTimeStamp)) ||
+        (InMove.bHasRotation && (InMove.TimeStamp < LatestRotationTimeStamp)))
+    {
+        return;
+    }
+    LatestLocationTimeStamp = InMove.bHasLocation ? InMove.TimeStamp : LatestLocationTimeStamp;
+    LatestRotationTimeStamp = InMove.bHasRotation ? InMove.TimeStamp : LatestRotationTimeStamp;
+    if (ClientMoves.Num() >= MAX_BUFFERED_POSES_NUM)
+    {
+        ClientMoves.RemoveAt(0, 1, false);
+    }
+    ClientMoves.Add(InMove);
+}
+
+void URRRobotMovementReconciler::ReconcileClientMoves()
+{
+    if (ClientMoves.Num() == 0)
+    {
+        return;
+    }
+
+    // Only the latest location & rotation parts matter, older ones being superseded
+    const FRRRobotMove* locationMove = nullptr;
+    const FRRRobotMove* rotationMove = nullptr;
+    for (const auto& move : ClientMoves)
+    {
+        locationMove = move.bHasLocation ? &move : locationMove;
+        rotationMove = move.bHasRotation ? &move : rotationMove;
+    }
+
+    AActor* owner = GetOwner();
+    const float simTime = GetSimTime();
+    if (locationMove)
+    {
+        const float extrapolationTime = FMath::Clamp(simTime - locationMove->TimeStamp, 0.f, MaxExtrapolationTime);
+        const FVector locationError =
+            locationMove->Location + locationMove->LinearVel * extrapolationTime - owner->GetActorLocation();
+        if (locationError.Size() > MaxCorrectionDistance)
+        {
+            owner->SetActorLocation(owner->GetActorLocation() + locationError, false, nullptr, ETeleportType::TeleportPhysics);
+            PendingLocationCorrection = FVector::ZeroVector;
+        }
+        else
+        {
+            PendingLocationCorrection = locationError;
+        }
+    }
+
+    if (rotationMove)
+    {
+        const float extrapolationTime = FMath::Clamp(simTime - rotationMove->TimeStamp, 0.f, MaxExtrapolationTime);
+        const FQuat targetRotation =
+            (rotationMove->Rotation + FRotator::MakeFromEuler(rotationMove->AngularVel) * extrapolationTime).Quaternion();
+        const FQuat rotationError = targetRotation * owner->GetActorQuat().Inverse();
+        if (FMath::RadiansToDegrees(rotationError.GetAngle()) > MaxCorrectionAngle)
+        {
+            owner->SetActorRotation(targetRotation, ETeleportType::TeleportPhysics);
+            PendingRotationCorrection = FQuat::Identity;
+        }
+        else
+        {
+            PendingRotationCorrection = rotationError;
+        }
+    }
+    ClientMoves.Reset();
+}
+
+void URRRobotMovementReconciler::ApplyCorrections(const float InDeltaTime)
+{
+    const float alpha = (CorrectionDuration > 0.f) ? FMath::Min(InDeltaTime / CorrectionDuration, 1.f) : 1.f;
+    AActor* owner = GetOwner();
+    if (!PendingLocationCorrection.IsNearlyZero(KINDA_SMALL_NUMBER))
+    {
+        const FVector locationStep = PendingLocationCorrection * alpha;
+        owner->SetActorLocation(owner->GetActorLocation() + locationStep);
+        PendingLocationCorrection -= locationStep;
+    }
+    if (!PendingRotationCorrection.IsIdentity(KINDA_SMALL_NUMBER))
+    {
+        const FQuat rotationStep = FQuat::Slerp(FQuat::Identity, PendingRotationCorrection, alpha);
+        owner->SetActorRotation(rotationStep * owner->GetActorQuat());
+        PendingRotationCorrection = PendingRotationCorrection * rotationStep.Inverse();
+    }
+}
+
+void URRRobotMovementReconciler::AddRemotePose(const FVector& InLocation, const FRotator& InRotation)
+{
+    if (RemotePoses.Num() >= MAX_BUFFERED_POSES_NUM)
+    {
+        RemotePoses.RemoveAt(0, 1, false);
+    }
+    RemotePoses.Add({GetSimTime(), InLocation, InRotation.Quaternion()});
+}
+
+void URRRobotMovementReconciler::InterpolateRemotePoses()
+{
+    if (RemotePoses.Num() == 0)
+    {
+        return;
+    }
+
+    // Render time surrounded by 2 poses: interpolating between them, else staying at the latest one till the next arrives
+    const float renderTime = GetSimTime() - RemoteInterpolationDelay;
+    FVector location = RemotePoses.Last().Location;
+    FQuat rotation = RemotePoses.Last().Rotation;
+    int32 prevIdx = RemotePoses.Num() - 1;
+    for (int32 i = 0; i < RemotePoses.Num() - 1; ++i)
+    {
+        const FRRRobotRemotePose& prevPose = RemotePoses[i];
+        const FRRRobotRemotePose& nextPose = RemotePoses[i + 1];
+        if (renderTime < nextPose.TimeStamp)
+        {
+            prevIdx = i;
+            const float duration = nextPose.TimeStamp - prevPose.TimeStamp;
+            const float alpha =
+                (duration > 0.f) ? FMath::Clamp((renderTime - prevPose.TimeStamp) / duration, 0.f, 1.f) : 1.f;
+            location = FMath::Lerp(prevPose.Location, nextPose.Location, alpha);
+            rotation = FQuat::Slerp(prevPose.Rotation, nextPose.Rotation, alpha);
+            break;
+        }
+    }
+    GetOwner()->SetActorLocationAndRotation(location, rotation);
+
+    // Poses before the previous one are no longer needed
+    if (prevIdx > 0)
+    {
+        RemotePoses.RemoveAt(0, prevIdx, false);
+    }
+}
@@ -18,10 +18,23 @@
 // RapyutaSimulationPlugins
 #include "Core/RRConversionUtils.h"
 #include "Core/RRGeneralUtils.h"
+#include "Core/RRROS2GameMode.h"
+#include "Core/RRROS2InterfacePool.h"
+#include "Core/RRROS2NodePool.h"
+#include "Core/RRTrace.h"
 #include "Robots/RRBaseRobot.h"
+#include "Sensors/RRROS2BaseSensorComponent.h"
+#include "Tools/RRFrameTelemetry.h"
+#include "Tools/RRInputReplay.h"
+#include "Tools/RRStartupProfiler.h"
+
+TArray<TWeakObjectPtr<URRRobotROS2Interface>> URRRobotROS2Interface::SInterfacesWithPendingCmds;
+FCriticalSection URRRobotROS2Interface::SPendingCmdsMutex;
+std::once_flag URRRobotROS2Interface::SPendingCmdsOnceFlag;
 
 void URRRobotROS2Interface::Initialize(ARRBaseRobot* InRobot)
 {
+    FRRStartupPhaseScope startupPhaseScope(ERRStartupPhase::ROS2_INTERFACE_INIT);
 #if RAPYUTA_SIM_VERBOSE
     UE_LOG_WITH_INFO_NAMED(LogRapyutaCore, Verbose, TEXT("InitializeROS2Interface"));
 #endif
@@ -34,8 +47,19 @@ void URRRobotROS2Interface::Initialize(ARRBaseRobot* InRobot)
     Robot = InRobot;
     Robot->ROS2Interface = this;
 
+    // Commands of all robots are applied once per tick
+    std::call_once(SPendingCmdsOnceFlag,
+                   []() { FWorldDelegates::OnWorldPreActorTick.AddStatic(&URRRobotROS2Interface::ApplyAllPendingCmds); });
+
+    // Recycled from a robot deleted in the same namespace: its node & endpoints are kept, only to be rebound to InRobot
+    const bool bRebindEndpoints = bRecycled && IsValid(RobotROS2Node);
+    bRecycled = false;
+
     // Instantiate a ROS 2 node for InRobot
-    InitRobotROS2Node(InRobot);
+    if (!bRebindEndpoints)
+    {
+        InitRobotROS2Node(InRobot);
+    }
 
     // OdomPublisher (with TF)
     if (bPublishOdom && Robot->bMobileRobot)
@@ -50,10 +74,32 @@ void URRRobotROS2Interface::Initialize(ARRBaseRobot* InRobot)
         }
     }
 
+    if (bSensorsOnDemand)
+    {
+        TInlineComponentArray<URRROS2BaseSensorComponent*> sensorComponents(InRobot);
+        for (auto* sensorComp : sensorComponents)
+        {
+            sensorComp->bOnDemand = true;
+        }
+    }
+
+    if (bRebindEndpoints)
+    {
+        RebindSensorPublishers(InRobot);
+    }
+
     // Initialize Robot's sensors (lidar, etc.)
     // NOTE: This inits both static sensors added by BP robot & possiblly also dynamic ones added in the overriding child InitSensors()
     verify(InRobot->InitSensors(RobotROS2Node));
 
+    if (bRebindEndpoints)
+    {
+        // Subscription, service & action callbacks are bound to this interface, thus already to InRobot
+        RestartPublishers();
+        BPInitialize();
+        return;
+    }
+
     // Refresh TF, Odom publishers
     InitPublishers();
 
@@ -86,7 +132,17 @@ void URRRobotROS2Interface::DeInitialize()
     Robot->ROS2Interface = nullptr;
     Robot = nullptr;
 
+    // Resolved against the robot's joints, thus stale once this is recycled for another robot
+    JointCmdLayout.Reset();
+
     StopPublishers();
+
+    // Pooled node, shared with other robots, to be reacquired upon reinitialization
+    if (URRROS2NodePool::IsPooled(RobotROS2Node))
+    {
+        CastChecked<URRROS2NodePool>(RobotROS2Node->GetOuter())->Release(RobotROS2Node);
+        RobotROS2Node = nullptr;
+    }
 }
 
 void URRRobotROS2Interface::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -106,6 +162,24 @@ void URRRobotROS2Interface::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>
 
 void URRRobotROS2Interface::InitRobotROS2Node(ARRBaseRobot* InRobot)
 {
+    RobotNamespace = ROSSpawnParameters ? ROSSpawnParameters->GetNamespace() : InRobot->RobotUniqueName;
+    if (InRobot->ActorCommon)
+    {
+        RobotNamespace = InRobot->ActorCommon->GetSceneROSNamespace(RobotNamespace);
+    }
+
+    // Shared node of the game mode's pool if any, without namespace
+    auto* gameMode = InRobot->GetWorld()->GetAuthGameMode<ARRROS2GameMode>();
+    URRROS2NodePool* nodePool = gameMode ? gameMode->GetRobotROS2NodePool() : nullptr;
+    if (nodePool && ((nullptr == RobotROS2Node) || URRROS2NodePool::IsPooled(RobotROS2Node)))
+    {
+        if (nullptr == RobotROS2Node)
+        {
+            RobotROS2Node = nodePool->Acquire();
+        }
+        return;
+    }
+
     const FString nodeName = URRGeneralUtils::GetNewROS2NodeName(InRobot->GetName());
     if (RobotROS2Node == nullptr)
     {
@@ -116,17 +190,15 @@ void URRRobotROS2Interface::InitRobotROS2Node(ARRBaseRobot* InRobot)
     RobotROS2Node->Name = nodeName;
 
     // Set robot's [ROS2Node] namespace from spawn parameters if existing
-    if (ROSSpawnParameters)
-    {
-        RobotROS2Node->Namespace = ROSSpawnParameters->GetNamespace();
-    }
-    else
-    {
-        RobotROS2Node->Namespace = InRobot->RobotUniqueName;
-    }
+    RobotROS2Node->Namespace = RobotNamespace;
     RobotROS2Node->Init();
 }
 
+FString URRRobotROS2Interface::GetTopicName(const FString& InTopicName) const
+{
+    return URRROS2NodePool::GetTopicName(RobotROS2Node, this, InTopicName);
+}
+
 bool URRRobotROS2Interface::InitPublishers()
 {
     if (false == IsValid(RobotROS2Node))
@@ -139,6 +211,7 @@ bool URRRobotROS2Interface::InitPublishers()
     {
         if (pub.Value != nullptr)
         {
+            pub.Value->TopicName = GetTopicName(pub.Value->TopicName);
             RobotROS2Node->AddPublisher(pub.Value);
         }
         else
@@ -163,6 +236,66 @@ void URRRobotROS2Interface::StopPublishers()
     }
 }
 
+void URRRobotROS2Interface::RestartPublishers()
+{
+    for (auto& pub : Publishers)
+    {
+        if (pub.Value != nullptr)
+        {
+            pub.Value->StartPublishTimer();
+        }
+    }
+}
+
+void URRRobotROS2Interface::ParkSensorPublishers(ARRBaseRobot* InRobot)
+{
+    TInlineComponentArray<URRROS2BaseSensorComponent*> sensorComponents(InRobot);
+    for (auto* sensorComp : sensorComponents)
+    {
+        URRROS2BaseSensorPublisher* sensorPublisher = sensorComp->SensorPublisher;
+        if (IsValid(sensorPublisher) && sensorPublisher->IsInitializedWith(RobotROS2Node))
+        {
+            sensorPublisher->StopAsyncPublishing();
+            sensorPublisher->StopTimerPublishing();
+            sensorPublisher->StopPublishTimer();
+            sensorPublisher->DataSourceComponent = nullptr;
+            sensorPublisher->Rename(nullptr, this, REN_DontCreateRedirectors | REN_DoNotDirty | REN_NonTransactional);
+            sensorComp->SensorPublisher = nullptr;
+            ParkedSensorPublishers.Add(sensorPublisher);
+        }
+    }
+}
+
+void URRRobotROS2Interface::RebindSensorPublishers(ARRBaseRobot* InRobot)
+{
+    TInlineComponentArray<URRROS2BaseSensorComponent*> sensorComponents(InRobot);
+    for (auto* sensorComp : sensorComponents)
+    {
+        if ((nullptr != sensorComp->SensorPublisher) || (nullptr == sensorComp->SensorPublisherClass))
+        {
+            continue;
+        }
+        const FString topicName = URRROS2NodePool::GetTopicName(RobotROS2Node, sensorComp, sensorComp->TopicName);
+        const int32 index = ParkedSensorPublishers.IndexOfByPredicate(
+            [sensorComp, &topicName](const URRROS2BaseSensorPublisher* InPublisher)
+            {
+                return InPublisher && (InPublisher->GetClass() == sensorComp->SensorPublisherClass) &&
+                       (InPublisher->TopicName == topicName);
+            });
+        if (INDEX_NONE != index)
+        {
+            URRROS2BaseSensorPublisher* sensorPublisher = ParkedSensorPublishers[index];
+            ParkedSensorPublishers.RemoveAtSwap(index, 1, false);
+            sensorPublisher->Rename(nullptr, sensorComp, REN_DontCreateRedirectors | REN_DoNotDirty | REN_NonTransactional);
+            sensorPublisher->DataSourceComponent = sensorComp;
+            sensorComp->SensorPublisher = sensorPublisher;
+        }
+    }
+
+    // Not taken over by any sensor, thus destroyed along with their rcl publisher
+    ParkedSensorPublishers.Reset();
+}
+
 bool URRRobotROS2Interface::InitSubscriptions()
 {
     if (false == IsValid(RobotROS2Node))
@@ -185,6 +318,7 @@ bool URRRobotROS2Interface::InitSubscriptions()
     {
         if (sub.Value != nullptr)
         {
+            sub.Value->TopicName = GetTopicName(sub.Value->TopicName);
             RobotROS2Node->AddSubscription(sub.Value);
         }
         else
@@ -290,6 +424,13 @@ bool URRRobotROS2Interface::InitActionServers()
 
 void URRRobotROS2Interface::MovementCallback(const UROS2GenericMsg* Msg)
 {
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRMovementCallback", RRROS2Channel);
+    FRRFrameTimeScope frameTimeScope(ERRFrameTimeCategory::ROS_SUBSCRIBE);
+    // Recorded commands are applied instead
+    if (URRInputReplay::IsAnyReplaying())
+    {
+        return;
+    }
     const UROS2TwistMsg* twistMsg = Cast<UROS2TwistMsg>(Msg);
     if (IsValid(twistMsg))
     {
@@ -297,42 +438,45 @@ void URRRobotROS2Interface::MovementCallback(const UROS2GenericMsg* Msg)
         // probably should not stay in msg though
         FROSTwist twist;
         twistMsg->GetMsg(twist);
-        const FVector linear = URRConversionUtils::VectorROSToUE(twist.Linear);
-        const FVector angular = URRConversionUtils::RotationROSToUEVector(twist.Angular, true);
-
-        // (Note) In this callback, which could be invoked from a ROS working thread,
-        // thus any direct referencing to its member in this GameThread lambda needs to be verified.
-        AsyncTask(ENamedThreads::GameThread,
-                  [this, linear, angular]
-                  {
-                      if (IsValid(Robot))
-                      {
-                          Robot->SetLinearVel(linear);
-                          Robot->SetAngularVel(angular);
-                      }
-                  });
+        {
+            FScopeLock lock(&MovementCmdMutex);
+            PendingLinearVel = URRConversionUtils::VectorROSToUE(twist.Linear);
+            PendingAngularVel = URRConversionUtils::RotationROSToUEVector(twist.Angular, true);
+            bMovementCmdPending = true;
+        }
+        QueuePendingCmds();
     }
 }
 
 void URRRobotROS2Interface::JointStateCallback(const UROS2GenericMsg* Msg)
 {
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRJointStateCallback", RRROS2Channel);
+    FRRFrameTimeScope frameTimeScope(ERRFrameTimeCategory::ROS_SUBSCRIBE);
+    // Recorded commands are applied instead
+    if (URRInputReplay::IsAnyReplaying())
+    {
+        return;
+    }
     const UROS2JointStateMsg* jointStateMsg = Cast<UROS2JointStateMsg>(Msg);
     if (IsValid(jointStateMsg))
     {
         // TODO refactoring will be needed to put units and system of reference conversions in a consistent location
         // probably should not stay in msg though
-        FROSJointState jointState;
+        FROSJointState& jointState = JointStateMsgData;
         jointStateMsg->GetMsg(jointState);
 
         // Check Joint type. should be different function?
         ERRJointControlType jointControlType;
+        const decltype(jointState.Position)* values = nullptr;
         if (jointState.Name.Num() == jointState.Position.Num())
         {
             jointControlType = ERRJointControlType::POSITION;
+            values = &jointState.Position;
         }
         else if (jointState.Name.Num() == jointState.Velocity.Num())
         {
             jointControlType = ERRJointControlType::VELOCITY;
+            values = &jointState.Velocity;
         }
         else if (jointState.Name.Num() == jointState.Effort.Num())
         {
@@ -347,73 +491,231 @@ void URRRobotROS2Interface::JointStateCallback(const UROS2GenericMsg* Msg)
             return;
         }
 
-        // Calculate input, ROS to UE conversion.
-        TMap<FString, TArray<float>> joints;
-        for (auto i = 0; i < jointState.Name.Num(); ++i)
+        TSharedPtr<const FRRJointCmdLayout, ESPMode::ThreadSafe> layout = GetJointCmdLayout(jointState.Name);
+        if (!layout.IsValid())
         {
-            if (!Robot->Joints.Contains(jointState.Name[i]))
-            {
-                if (bWarnAboutMissingLink)
-                {
-                    UE_LOG_WITH_INFO_NAMED(
-                        LogRapyutaCore, Warning, TEXT("vehicle do not have joint named %s."), *jointState.Name[i]);
-                }
-                continue;
-            }
+            return;
+        }
 
-            TArray<float> input;
-            if (ERRJointControlType::POSITION == jointControlType)
-            {
-                input.Add(jointState.Position[i]);
-            }
-            else if (ERRJointControlType::VELOCITY == jointControlType)
-            {
-                input.Add(jointState.Velocity[i]);
-            }
-            else
+        // Calculate input, ROS to UE conversion, into the pending buffer, which keeps its allocation across msgs
+        {
+            FScopeLock lock(&JointCmdMutex);
+            PendingJointCmd.Layout = layout;
+            PendingJointCmd.ControlType = jointControlType;
+            PendingJointCmd.Values.SetNumUninitialized(values->Num(), false);
+            for (auto i = 0; i < values->Num(); ++i)
             {
-                UE_LOG_WITH_INFO(
-                    LogRapyutaCore, Warning, TEXT("position, velocity or effort array must be same size of name array"));
-                continue;
+                PendingJointCmd.Values[i] = (*values)[i] * layout->Scales[i];
             }
+        }
 
-            // ROS To UE conversion
-            if (Robot->Joints[jointState.Name[i]]->LinearDOF == 1)
-            {
-                input[0] *= 100;    // todo add conversion to conversion util
-            }
-            else if (Robot->Joints[jointState.Name[i]]->RotationalDOF == 1)
+        QueuePendingCmds();
+    }
+}
+
+void URRRobotROS2Interface::QueuePendingCmds()
+{
+    // (Note) Invoked from a ROS working thread, thus this is only referenced weakly until applied on game thread
+    if (!bCmdsQueued.exchange(true))
+    {
+        FScopeLock lock(&SPendingCmdsMutex);
+        SInterfacesWithPendingCmds.Add(this);
+    }
+}
+
+void URRRobotROS2Interface::ApplyAllPendingCmds(UWorld* InWorld, ELevelTick /*InTickType*/, float /*InDeltaSeconds*/)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRApplyAllPendingCmds", RRROS2Channel);
+    static TArray<URRRobotROS2Interface*> sInterfaces;
+    sInterfaces.Reset();
+    {
+        FScopeLock lock(&SPendingCmdsMutex);
+        for (int32 i = SInterfacesWithPendingCmds.Num() - 1; i >= 0; --i)
+        {
+            URRRobotROS2Interface* ros2Interface = SInterfacesWithPendingCmds[i].Get();
+            if ((nullptr == ros2Interface) || (ros2Interface->GetWorld() == InWorld))
             {
-                input[0] *= 180 / M_PI;    // todo add conversion to conversion util
+                if (ros2Interface)
+                {
+                    sInterfaces.Add(ros2Interface);
+                }
+                SInterfacesWithPendingCmds.RemoveAtSwap(i, 1, false);
             }
-            else
+        }
+    }
+
+    for (URRRobotROS2Interface* ros2Interface : sInterfaces)
+    {
+        ros2Interface->ApplyPendingCmds();
+    }
+}
+
+void URRRobotROS2Interface::ApplyPendingCmds()
+{
+    check(IsInGameThread());
+    // Commands received from now on are queued again
+    bCmdsQueued = false;
+    if (!IsValid(Robot))
+    {
+        // Commands to a deleted robot, received until it is respawned, are dropped
+        if (URRROS2InterfacePool::IsParked(this))
+        {
+            FScopeLock movementLock(&MovementCmdMutex);
+            FScopeLock jointLock(&JointCmdMutex);
+            bMovementCmdPending = false;
+            PendingJointCmd.Layout.Reset();
+            return;
+        }
+        UE_LOG_WITH_INFO_NAMED(
+            LogRapyutaCore, Warning, TEXT("Robot is nullptr. RobotROS2Interface::Robot must not be nullptr."));
+        return;
+    }
+
+    bool bMovementCmd = false;
+    FVector linearVel;
+    FVector angularVel;
+    {
+        FScopeLock lock(&MovementCmdMutex);
+        Swap(bMovementCmd, bMovementCmdPending);
+        linearVel = PendingLinearVel;
+        angularVel = PendingAngularVel;
+    }
+    if (bMovementCmd)
+    {
+        Robot->SetLinearVel(linearVel);
+        Robot->SetAngularVel(angularVel);
+        if (URRInputReplay* inputReplay = URRInputReplay::Get(GetWorld()))
+        {
+            inputReplay->RecordMovementCmd(Robot->GetName(), linearVel, angularVel);
+        }
+    }
+
+    ApplyPendingJointCmd();
+}
+
+TSharedPtr<const FRRJointCmdLayout, ESPMode::ThreadSafe> URRRobotROS2Interface::GetJointCmdLayout(const TArray<FString>& InNames)
+{
+    if (!IsValid(Robot))
+    {
+        return nullptr;
+    }
+
+    if (JointCmdLayout.IsValid() && (JointCmdLayout->RobotJointsNum == Robot->Joints.Num()) &&
+        (JointCmdLayout->Names == InNames))
+    {
+        return JointCmdLayout;
+    }
+
+    // Resolve the joints once per names layout, thus warnings are also logged once per layout
+    TSharedPtr<FRRJointCmdLayout, ESPMode::ThreadSafe> layout = MakeShared<FRRJointCmdLayout, ESPMode::ThreadSafe>();
+    layout->Names = InNames;
+    layout->RobotJointsNum = Robot->Joints.Num();
+    layout->Joints.Reserve(InNames.Num());
+    layout->Scales.Reserve(InNames.Num());
+    for (const auto& name : InNames)
+    {
+        URRJointComponent* joint = Robot->Joints.FindRef(name);
+        float scale = 0.f;
+        if (nullptr == joint)
+        {
+            if (bWarnAboutMissingLink)
             {
-                UE_LOG_WITH_INFO(LogRapyutaCore,
-                                 Warning,
-                                 TEXT("[%s] Supports only single DOF joint. %s has %d "
-                                      "linear DOF and %d rotational DOF"),
-                                 *jointState.Name[i],
-                                 Robot->Joints[jointState.Name[i]]->LinearDOF,
-                                 Robot->Joints[jointState.Name[i]]->RotationalDOF);
+                UE_LOG_WITH_INFO_NAMED(LogRapyutaCore, Warning, TEXT("vehicle do not have joint named %s."), *name);
             }
+        }
+        // ROS To UE conversion
+        else if (joint->LinearDOF == 1)
+        {
+            scale = 100.f;    // todo add conversion to conversion util
+        }
+        else if (joint->RotationalDOF == 1)
+        {
+            scale = 180.f / M_PI;    // todo add conversion to conversion util
+        }
+        else
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore,
+                             Warning,
+                             TEXT("[%s] Supports only single DOF joint. %s has %d "
+                                  "linear DOF and %d rotational DOF"),
+                             *GetName(),
+                             *name,
+                             joint->LinearDOF,
+                             joint->RotationalDOF);
+            joint = nullptr;
+        }
+        layout->Joints.Add(joint);
+        layout->Scales.Add(scale);
+    }
+
+    JointCmdLayout = layout;
+    return JointCmdLayout;
+}
+
+void URRRobotROS2Interface::ApplyPendingJointCmd()
+{
+    check(IsInGameThread());
+    {
+        FScopeLock lock(&JointCmdMutex);
+        // Swap the buffers, keeping both allocations
+        Swap(PendingJointCmd, AppliedJointCmd);
+    }
+
+    if (!AppliedJointCmd.Layout.IsValid())
+    {
+        return;
+    }
 
-            joints.Emplace(jointState.Name[i], input);
+    const FRRJointCmdLayout& layout = *AppliedJointCmd.Layout;
+    JointCmdInput.SetNumUninitialized(1, false);
+    for (auto i = 0; i < AppliedJointCmd.Values.Num(); ++i)
+    {
+        URRJointComponent* joint = layout.Joints[i].Get();
+        if (nullptr == joint)
+        {
+            continue;
         }
 
-        // (Note) In this callback, which could be invoked from a ROS working thread,
-        // thus any direct referencing to its member in this GameThread lambda needs to be verified.
-        AsyncTask(ENamedThreads::GameThread,
-                  [this, joints, jointControlType]
-                  {
-                      if (!IsValid(Robot))
-                      {
-                          UE_LOG_WITH_INFO_NAMED(
-                              LogRapyutaCore, Warning, TEXT("Robot is nullptr. RobotROS2Interface::Robot must not be nullptr."));
-                          return;
-                      }
-                      Robot->SetJointState(joints, jointControlType);
-                  });
+        JointCmdInput[0] = AppliedJointCmd.Values[i];
+        switch (AppliedJointCmd.ControlType)
+        {
+            case ERRJointControlType::POSITION:
+                joint->SetPoseTargetWithArray(JointCmdInput);
+                break;
+            case ERRJointControlType::VELOCITY:
+                joint->SetVelocityTargetWithArray(JointCmdInput);
+                break;
+            case ERRJointControlType::EFFORT:
+                UE_LOG_WITH_INFO_NAMED(LogRapyutaCore, Warning, TEXT("Effort control is not supported."));
+                break;
+        }
+    }
+
+    if (URRInputReplay* inputReplay = URRInputReplay::Get(GetWorld()))
+    {
+        inputReplay->RecordJointCmd(Robot->GetName(), layout.Names, AppliedJointCmd.ControlType, AppliedJointCmd.Values);
+    }
+
+    // Consumed, thus not re-applied upon the next swap
+    AppliedJointCmd.Layout.Reset();
+}
+
+void URRRobotROS2Interface::ApplyJointCmd(const TArray<FString>& InNames,
+                                          const ERRJointControlType InControlType,
+                                          const TArray<float>& InValues)
+{
+    TSharedPtr<const FRRJointCmdLayout, ESPMode::ThreadSafe> layout = GetJointCmdLayout(InNames);
+    if (!layout.IsValid() || (layout->Joints.Num() != InValues.Num()))
+    {
+        return;
+    }
+    {
+        FScopeLock lock(&JointCmdMutex);
+        PendingJointCmd.Layout = layout;
+        PendingJointCmd.ControlType = InControlType;
+        PendingJointCmd.Values = InValues;
     }
+    ApplyPendingJointCmd();
 }
 
 URRRobotROS2InterfaceComponent::URRRobotROS2InterfaceComponent()
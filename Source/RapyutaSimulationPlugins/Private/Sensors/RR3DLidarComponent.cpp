@@ -2,363 +2,773 @@
 
 #include "Sensors/RR3DLidarComponent.h"
 
+// UE
+#include "Engine/TextureRenderTarget2D.h"
+#include "Materials/MaterialInterface.h"
+#include "ProfilingDebugging/RealtimeGPUProfiler.h"
+
+// rclUE
 #include "rclcUtilities.h"
 
+// RapyutaSimulationPlugins
+#include "Core/RRCoreUtils.h"
+#include "Core/RRTrace.h"
+
+DECLARE_GPU_STAT_NAMED(RRLidarDepthReadback, TEXT("RR Lidar Depth Readback"));
+
 URR3DLidarComponent::URR3DLidarComponent()
 {
     SensorPublisherClass = URRROS2PointCloud2Publisher::StaticClass();
 }
-void URR3DLidarComponent::TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+
+void URR3DLidarComponent::Run()
 {
-    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
-#if TRACE_ASYNC
-    verify(TraceHandles.Num() == RecordedHits.Num());
-    UWorld* world = GetWorld();
-    for (auto i = 0; i < TraceHandles.Num(); ++i)
+    // t: per-column time offset [s] from the scan stamp, only in sweep mode
+    // return_index: 0 for the first return of a beam, only in multi-echo mode
+    TArray<const TCHAR*, TInlineAllocator<POINT_FIELDS_NUM + 2>> fields = {
+        TEXT("x"), TEXT("y"), TEXT("z"), TEXT("distance"), TEXT("intensity")};
+    static_assert(POINT_FIELDS_NUM == 5, "fields must match POINT_FIELDS_NUM");
+    TimeFieldIndex = bSweepScan ? fields.Add(TEXT("t")) : INDEX_NONE;
+    ReturnIndexFieldIndex = (GetEchoesNum() > 1) ? fields.Add(TEXT("return_index")) : INDEX_NONE;
+
+    const int32 fieldsNum = fields.Num();
+    PointCloudMsg.Fields.Reset(fieldsNum);
+    for (int32 Index = 0; Index != fieldsNum; ++Index)
     {
-        FTraceHandle& traceHandle = TraceHandles[i];
-        FHitResult& recordedHit = RecordedHits[i];
-        if (traceHandle._Data.FrameNumber != 0)
-        {
-            FTraceDatum Output;
-            if (world->QueryTraceData(traceHandle, Output))
-            {
-                if (Output.OutHits.Num() > 0)
-                {
-                    traceHandle._Data.FrameNumber = 0;
-                    // We should only be tracing the first hit anyhow
-                    recordedHit = Output.OutHits[0];
-                }
-                else
-                {
-                    traceHandle._Data.FrameNumber = 0;
-                    recordedHit = FHitResult();
-                    recordedHit.TraceStart = Output.Start;
-                    recordedHit.TraceEnd = Output.End;
-                }
-            }
-        }
+        FROSPointField f;
+        f.Name = fields[Index];
+        f.Offset = Index * sizeof(float);
+        f.Datatype = 7;
+        f.Count = 1;
+        PointCloudMsg.Fields.Add(f);
     }
-#endif
+
+    PointCloudMsg.bIsBigendian = false;
+    PointCloudMsg.PointStep = sizeof(float) * fieldsNum;
+    PointCloudMsg.bIsDense = true;
+
+    Super::Run();
+}
+FRotator URR3DLidarComponent::GetLocalRayRotation(const int32 InIndex) const
+{
+    const int IdxX = InIndex % NSamplesPerScan;
+    const int IdxY = InIndex / NSamplesPerScan;
+    const float HAngle = StartAngle + DHAngle * IdxX;
+    const float VAngle = StartVerticalAngle + DVAngle * IdxY;
+    return FRotator(VAngle, HAngle, 0);
 }
 
-void URR3DLidarComponent::Run()
+int32 URR3DLidarComponent::FindRayIndex(const FRotator& InLocalRotation) const
 {
-    const uint64 nTotalScan = GetTotalScan();
+    if (NChannelsPerScan <= 0)
+    {
+        return INDEX_NONE;
+    }
+    const float dv = FOVVertical / static_cast<float>(NChannelsPerScan);
+    const int32 channel = FMath::RoundToInt32((InLocalRotation.Pitch - StartVerticalAngle) / dv);
+    if ((channel < 0) || (channel >= NChannelsPerScan) ||
+        !FMath::IsNearlyEqual(StartVerticalAngle + dv * channel, InLocalRotation.Pitch, RAY_ANGLE_TOLERANCE))
+    {
+        return INDEX_NONE;
+    }
+    const int32 column = FindColumn(InLocalRotation.Yaw);
+    return (INDEX_NONE == column) ? INDEX_NONE : (channel * NSamplesPerScan + column);
+}
 
-    RecordedHits.Init(FHitResult(ForceInit), nTotalScan);
+uint32 URR3DLidarComponent::GetScanPatternHash() const
+{
+    uint32 hash = Super::GetScanPatternHash();
+    hash = HashCombine(hash, GetTypeHash(NChannelsPerScan));
+    hash = HashCombine(hash, GetTypeHash(StartVerticalAngle));
+    hash = HashCombine(hash, GetTypeHash(FOVVertical));
+    return hash;
+}
 
-#if TRACE_ASYNC
-    TraceHandles.Init(FTraceHandle(), nTotalScan);
-#endif
-    Super::Run();
+void URR3DLidarComponent::BuildRayDirectionTable()
+{
+    DVAngle = FOVVertical / static_cast<float>(NChannelsPerScan);
+    Super::BuildRayDirectionTable();
 }
 
 void URR3DLidarComponent::SensorUpdate()
 {
-    DHAngle = FOVHorizontal / static_cast<float>(NSamplesPerScan);
-    DVAngle = FOVVertical / static_cast<float>(NChannelsPerScan);
+    if ((Backend != ERR3DLidarBackend::DEPTH_CAPTURE) || IsScanDerived())
+    {
+        Super::SensorUpdate();
+        return;
+    }
+
+    // The previous capture is still being read back
+    if (DepthReadback.bInFlight)
+    {
+        return;
+    }
 
-    // complex collisions: true
-    FCollisionQueryParams TraceParams = FCollisionQueryParams(TEXT("3DLaser_Trace"), true, GetOwner());
-    TraceParams.bReturnPhysicalMaterial = true;
+    PrepareScan();
+    if ((DepthCaptures.Num() == 0) || (DepthCaptureLayoutHash != RayDirectionTableHash))
+    {
+        InitDepthCaptures();
+    }
+    CaptureDepth();
+}
 
-    // TraceParams.bIgnoreTouches = true;
-    TraceParams.bTraceComplex = true;
-    TraceParams.bReturnFaceIndex = true;
+void URR3DLidarComponent::TickComponent(float DeltaTime,
+                                        enum ELevelTick TickType,
+                                        FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+    if (DepthReadback.bInFlight && DepthReadback.RenderFence.IsFenceComplete())
+    {
+        ResolveDepthCapture();
+    }
+}
 
-    FVector lidarPos = GetComponentLocation();
-    FRotator lidarRot = GetComponentRotation();
+void URR3DLidarComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    // The render command writes into #DepthReadback
+    if (DepthReadback.bInFlight)
+    {
+        DepthReadback.RenderFence.Wait();
+        DepthReadback.bInFlight = false;
+    }
+    Super::EndPlay(EndPlayReason);
+}
 
-#if TRACE_ASYNC
-    // This is cheesy, but basically if the first trace is in flight we assume they're all waiting and don't do another trace.
-    // This is not good if done on other threads and only works because both timers and actor ticks happen on the game thread.
-    if ((TraceHandles.Num() > 0) && (TraceHandles[0]._Data.FrameNumber == 0))
+void URR3DLidarComponent::InitDepthCaptures()
+{
+    DepthCaptureLayout.Build(StartAngle,
+                             FOVHorizontal,
+                             StartVerticalAngle,
+                             FOVVertical,
+                             DepthCaptureWidth,
+                             RayTable->LocalRayDirX.GetData(),
+                             RayTable->LocalRayDirY.GetData(),
+                             RayTable->LocalRayDirZ.GetData(),
+                             GetRaysNum());
+    DepthCaptureLayoutHash = RayDirectionTableHash;
+
+    auto createCaptures = [this](TArray<USceneCaptureComponent2D*>& OutCaptures,
+                                 const ESceneCaptureSource InCaptureSource,
+                                 const ETextureRenderTargetFormat InFormat,
+                                 UMaterialInterface* InMaterial)
     {
-        UWorld* world = GetWorld();
-        for (auto i = 0; i < TraceHandles.Num(); ++i)
+        for (auto* capture : OutCaptures)
         {
-            const int IdxX = i % NSamplesPerScan;
-            const int IdxY = i / NSamplesPerScan;
-            const float HAngle = StartAngle + DHAngle * IdxX;
-            const float VAngle = StartVerticalAngle + DVAngle * IdxY;
-
-            FRotator laserRot(VAngle, HAngle, 0);
-            FRotator rot = UKismetMathLibrary::ComposeRotators(laserRot, lidarRot);
-
-            FVector startPos = lidarPos + MinRange * UKismetMathLibrary::GetForwardVector(rot);
-            FVector endPos = lidarPos + MaxRange * UKismetMathLibrary::GetForwardVector(rot);
-            // To be considered: += WithNoise * FVector(GaussianRNGPosition(Gen),GaussianRNGPosition(Gen),GaussianRNGPosition(Gen));
-
-            TraceHandles[i] = world->AsyncLineTraceByChannel(EAsyncTraceType::Single,
-                                                             startPos,
-                                                             endPos,
-                                                             ECC_Visibility,
-                                                             TraceParams,
-                                                             FCollisionResponseParams::DefaultResponseParam,
-                                                             nullptr);
+            capture->DestroyComponent();
         }
-    }
-#else
-    ParallelFor(
-        RecordedHits.Num(),
-        [this, &TraceParams, &lidarPos, &lidarRot](int32 Index)
+        OutCaptures.Reset(DepthCaptureLayout.FacesNum);
+        for (int32 i = 0; i < DepthCaptureLayout.FacesNum; ++i)
         {
-            const int IdxX = Index % NSamplesPerScan;
-            const int IdxY = Index / NSamplesPerScan;
-            const float HAngle = StartAngle + DHAngle * IdxX;
-            const float VAngle = StartVerticalAngle + DVAngle * IdxY;
+            UTextureRenderTarget2D* renderTarget = NewObject<UTextureRenderTarget2D>(this);
+            renderTarget->RenderTargetFormat = InFormat;
+            renderTarget->ClearColor = FLinearColor(MaxRange, 0.f, 0.f, 0.f);
+            renderTarget->InitAutoFormat(DepthCaptureLayout.Width, DepthCaptureLayout.Height);
+
+            USceneCaptureComponent2D* capture = NewObject<USceneCaptureComponent2D>(this);
+            capture->SetupAttachment(this);
+            capture->SetRelativeRotation(FRotator(0.f, DepthCaptureLayout.FaceYaws[i], 0.f));
+            capture->FOVAngle = DepthCaptureLayout.FaceFOV;
+            capture->CaptureSource = InCaptureSource;
+            capture->bCaptureEveryFrame = false;
+            capture->bCaptureOnMovement = false;
+            capture->TextureTarget = renderTarget;
+            if (InMaterial)
+            {
+                capture->PostProcessSettings.AddBlendable(InMaterial, 1.f);
+            }
+            capture->RegisterComponent();
+            OutCaptures.Add(capture);
+        }
+    };
 
-            FRotator laserRot(VAngle, HAngle, 0);
-            FRotator rot = UKismetMathLibrary::ComposeRotators(laserRot, lidarRot);
+    createCaptures(DepthCaptures, ESceneCaptureSource::SCS_SceneDepth, ETextureRenderTargetFormat::RTF_R32f, nullptr);
+    if (DepthCaptureSurfaceClassMaterial)
+    {
+        createCaptures(SurfaceClassCaptures,
+                       ESceneCaptureSource::SCS_FinalColorHDR,
+                       ETextureRenderTargetFormat::RTF_RGBA16f,
+                       DepthCaptureSurfaceClassMaterial);
+    }
 
-            FVector startPos = lidarPos + MinRange * UKismetMathLibrary::GetForwardVector(rot);
-            FVector endPos = lidarPos + MaxRange * UKismetMathLibrary::GetForwardVector(rot);
-            // + WithNoise *  FVector(GaussianRNGPosition(Gen),GaussianRNGPosition(Gen),GaussianRNGPosition(Gen));
+    DepthReadback.Depth.SetNum(DepthCaptureLayout.FacesNum);
+    DepthReadback.SurfaceClass.SetNum(SurfaceClassCaptures.Num());
+}
 
-            GetWorld()->LineTraceSingleByChannel(
-                RecordedHits[Index], startPos, endPos, ECC_Visibility, TraceParams, FCollisionResponseParams::DefaultResponseParam);
-        },
-        false);
-#endif
+void URR3DLidarComponent::CaptureDepth()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRLidarCaptureDepth", RRSensorChannel);
+    struct FFaceReadback
+    {
+        FTextureRenderTargetResource* Resource;
+        TArray<FLinearColor>* OutData;
+    };
+    TArray<FFaceReadback> faceReadbacks;
 
-    if (BWithNoise)
+    auto captureFaces = [&faceReadbacks](const TArray<USceneCaptureComponent2D*>& InCaptures, TArray<TArray<FLinearColor>>& OutData)
     {
-        // this approach to noise is different from the above:
-        // noise on the linetrace input means that the further the hit, the larger the error, while here the error is independent
-        // from distance
-        ParallelFor(
-            RecordedHits.Num(),
-            [this, &TraceParams, &lidarPos, &lidarRot](int32 Index)
+        for (int32 i = 0; i < InCaptures.Num(); ++i)
+        {
+            InCaptures[i]->CaptureScene();
+            faceReadbacks.Add({InCaptures[i]->TextureTarget->GameThread_GetRenderTargetResource(), &OutData[i]});
+        }
+    };
+    captureFaces(DepthCaptures, DepthReadback.Depth);
+    captureFaces(SurfaceClassCaptures, DepthReadback.SurfaceClass);
+
+    // Raw values, ie [cm] depth & surface class index
+    ENQUEUE_RENDER_COMMAND(LidarDepthReadback)
+    (
+        [faceReadbacks = MoveTemp(faceReadbacks)](FRHICommandListImmediate& RHICmdList)
+        {
+            SCOPED_DRAW_EVENT(RHICmdList, RRLidarDepthReadback);
+            SCOPED_GPU_STAT(RHICmdList, RRLidarDepthReadback);
+            for (const auto& faceReadback : faceReadbacks)
             {
-                RecordedHits[Index].ImpactPoint +=
-                    FVector(GaussianRNGPosition(Gen), GaussianRNGPosition(Gen), GaussianRNGPosition(Gen));
-                RecordedHits[Index].TraceEnd +=
-                    FVector(GaussianRNGPosition(Gen), GaussianRNGPosition(Gen), GaussianRNGPosition(Gen));
-            },
-            false);
-    }
-
-    TimeOfLastScan = UGameplayStatics::GetTimeSeconds(GetWorld());
-    Dt = 1.f / static_cast<float>(PublicationFrequencyHz);
+                const FIntPoint size = faceReadback.Resource->GetSizeXY();
+                RHICmdList.ReadSurfaceData(faceReadback.Resource->GetRenderTargetTexture(),
+                                           FIntRect(0, 0, size.X, size.Y),
+                                           *faceReadback.OutData,
+                                           FReadSurfaceDataFlags(RCM_MinMax, CubeFace_MAX));
+            }
+        });
+    DepthReadback.RenderFence.BeginFence();
+    DepthReadback.bInFlight = true;
+}
 
-    // need to store on a structure associating hits with time?
-    // GetROS2Data needs to get all data since the last Get? or the last within the last time interval?
+void URR3DLidarComponent::ResolveDepthCapture()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRLidarResolveDepth", RRSensorChannel);
+    DepthReadback.bInFlight = false;
+    DepthCaptureLayout.Resample(DepthReadback.Depth,
+                                DepthReadback.SurfaceClass,
+                                MinRange,
+                                MaxRange,
+                                ScanLidarPos,
+                                ScanRayDirX.GetData(),
+                                ScanRayDirY.GetData(),
+                                ScanRayDirZ.GetData(),
+                                PendingScanHits);
+    if (RayTable->ExcludedRaysNum > 0)
+    {
+        for (int32 i = 0; i < PendingScanHits.Num(); ++i)
+        {
+            if (IsRayExcluded(i))
+            {
+                FVector startPos, endPos;
+                GetTraceRay(i, startPos, endPos);
+                PendingScanHits[i].SetMiss(endPos);
+            }
+        }
+    }
+    Swap(ScanHits, PendingScanHits);
+    OnScanTraced();
+}
 
-    ULineBatchComponent* const LineBatcher = GetWorld()->PersistentLineBatcher;
-    if (LineBatcher != nullptr && bShowLidarRays)
+void URR3DLidarComponent::TraceScan(TArray<FRRLidarHit>& OutHits,
+                                    TArray<FHitResult>* OutRecordedHits,
+                                    TArray<FRRLidarHit>& OutEchoHits)
+{
+    const int32 stride = AdaptiveStride;
+    if (!bAdaptiveResolution || (ActiveEchoesNum > 1) || (stride < 2) || (NSamplesPerScan <= stride) ||
+        (NChannelsPerScan <= stride))
     {
-        for (auto& h : RecordedHits)
+        Super::TraceScan(OutHits, OutRecordedHits, OutEchoHits);
+        return;
+    }
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRLidarAdaptiveTraceScan", RRSensorChannel);
+
+    // Coarse grid of every stride-th column & channel plus the last ones, so that every block has 4 traced corners
+    const int32 coarseColumnsNum = FMath::DivideAndRoundUp(NSamplesPerScan - 1, stride) + 1;
+    const int32 coarseChannelsNum = FMath::DivideAndRoundUp(NChannelsPerScan - 1, stride) + 1;
+    auto getColumn = [this, stride](const int32 InCoarse) { return FMath::Min(InCoarse * stride, NSamplesPerScan - 1); };
+    auto getChannel = [this, stride](const int32 InCoarse) { return FMath::Min(InCoarse * stride, NChannelsPerScan - 1); };
+    const FTraceRayKernel traceRayKernel = GetTraceRayKernel(nullptr != OutRecordedHits, false);
+    auto traceRay = [this, traceRayKernel, &OutHits, OutRecordedHits](const int32 InIndex)
+    { (this->*traceRayKernel)(InIndex, OutHits[InIndex], OutRecordedHits ? &(*OutRecordedHits)[InIndex] : nullptr, nullptr); };
+
+    std::atomic<int32> tracedRaysNum = 0;
+    ParallelFor(coarseColumnsNum * coarseChannelsNum,
+                [&](int32 Index)
+                {
+                    const int32 rayIdx =
+                        getChannel(Index / coarseColumnsNum) * NSamplesPerScan + getColumn(Index % coarseColumnsNum);
+                    traceRay(rayIdx);
+                    if (!IsRayExcluded(rayIdx))
+                    {
+                        ++tracedRaysNum;
+                    }
+                });
+
+    // Each block owns its rays in [c0, c1) x [h0, h1), the last ones also their c1 or h1 line
+    const int32 blockColumnsNum = coarseColumnsNum - 1;
+    const int32 blockChannelsNum = coarseChannelsNum - 1;
+    ParallelFor(
+        blockColumnsNum * blockChannelsNum,
+        [&](int32 Index)
         {
-            if (h.GetActor() != nullptr)
+            const int32 blockColumn = Index % blockColumnsNum;
+            const int32 blockChannel = Index / blockColumnsNum;
+            const int32 c0 = getColumn(blockColumn);
+            const int32 c1 = getColumn(blockColumn + 1);
+            const int32 h0 = getChannel(blockChannel);
+            const int32 h1 = getChannel(blockChannel + 1);
+            const FRRLidarHit* corners[4] = {&OutHits[h0 * NSamplesPerScan + c0],
+                                             &OutHits[h0 * NSamplesPerScan + c1],
+                                             &OutHits[h1 * NSamplesPerScan + c0],
+                                             &OutHits[h1 * NSamplesPerScan + c1]};
+            int32 cornerHitsNum = 0;
+            float minDistance = TNumericLimits<float>::Max();
+            float maxDistance = 0.f;
+            for (const FRRLidarHit* corner : corners)
             {
-                float Distance = (MinRange * (h.Distance > 0) + h.Distance) * .01f;
-                if (h.PhysMaterial != nullptr)
+                if (corner->bHit)
                 {
-                    // retroreflective material
-                    if (h.PhysMaterial->SurfaceType == EPhysicalSurface::SurfaceType1)
+                    ++cornerHitsNum;
+                    minDistance = FMath::Min(minDistance, corner->Distance);
+                    maxDistance = FMath::Max(maxDistance, corner->Distance);
+                }
+            }
+            const bool bRefine = ((cornerHitsNum > 0) && (cornerHitsNum < 4)) ||
+                                 ((cornerHitsNum == 4) && (((maxDistance - minDistance) > AdaptiveEdgeThreshold) ||
+                                                           ((MinRange + minDistance) < AdaptiveNearRange)));
+
+            const int32 columnEnd = (blockColumn == blockColumnsNum - 1) ? c1 : (c1 - 1);
+            const int32 channelEnd = (blockChannel == blockChannelsNum - 1) ? h1 : (h1 - 1);
+            int32 blockTracedRaysNum = 0;
+            for (int32 channel = h0; channel <= channelEnd; ++channel)
+            {
+                const bool bCoarseChannel = (channel == h0) || (channel == h1);
+                for (int32 column = c0; column <= columnEnd; ++column)
+                {
+                    if (bCoarseChannel && ((column == c0) || (column == c1)))
                     {
-                        // UE_LOG_WITH_INFO(LogTemp, Warning, TEXT("retroreflective surface type hit"));
-                        // LineBatcher->DrawLine(h.TraceStart, h.ImpactPoint, ColorReflected, 10, .5, dt);
-                        LineBatcher->DrawPoint(h.ImpactPoint,
-                                               InterpColorFromIntensity(GetIntensityFromDist(IntensityReflective, Distance)),
-                                               5,
-                                               10,
-                                               Dt);
+                        continue;
                     }
-                    // non reflective material
-                    else if (h.PhysMaterial->SurfaceType == EPhysicalSurface::SurfaceType_Default)
+                    const int32 rayIdx = channel * NSamplesPerScan + column;
+                    if (bRefine || IsRayExcluded(rayIdx))
                     {
-                        // UE_LOG_WITH_INFO(LogTemp, Warning, TEXT("default surface type hit"));
-                        // LineBatcher->DrawLine(h.TraceStart, h.ImpactPoint, ColorHit, 10, .5, dt);
-                        LineBatcher->DrawPoint(h.ImpactPoint,
-                                               InterpColorFromIntensity(GetIntensityFromDist(IntensityNonReflective, Distance)),
-                                               5,
-                                               10,
-                                               Dt);
+                        traceRay(rayIdx);
+                        blockTracedRaysNum += IsRayExcluded(rayIdx) ? 0 : 1;
+                        continue;
                     }
-                    // reflective material
-                    else if (h.PhysMaterial->SurfaceType == EPhysicalSurface::SurfaceType2)
+
+                    FVector startPos, endPos;
+                    GetTraceRay(rayIdx, startPos, endPos);
+                    FRRLidarHit& hit = OutHits[rayIdx];
+                    if (cornerHitsNum == 0)
                     {
-                        FVector HitSurfaceNormal = h.Normal;
-                        FVector RayDirection = h.TraceEnd - h.TraceStart;
-                        RayDirection.Normalize();
-
-                        float NormalAlignment = FVector::DotProduct(HitSurfaceNormal, -RayDirection);
-                        NormalAlignment *= NormalAlignment;
-                        NormalAlignment *= NormalAlignment;
-                        NormalAlignment *= NormalAlignment;
-                        NormalAlignment *= NormalAlignment;
-                        NormalAlignment *= NormalAlignment;    // pow 32
-                        // LineBatcher->DrawLine(h.TraceStart, h.ImpactPoint, FLinearColor::LerpUsingHSV(ColorHit, ColorReflected,
-                        // NormalAlignment), 10, .5, dt); NormalAlignment =
-                        // (NormalAlignment*(IntensityReflective-IntensityNonReflective) + IntensityNonReflective)/IntensityMax;
-                        // LineBatcher->DrawPoint(h.ImpactPoint, InterpolateColor(NormalAlignment), 5, 10, dt);
-                        LineBatcher->DrawPoint(
-                            h.ImpactPoint,
-                            InterpColorFromIntensity(GetIntensityFromDist(
-                                NormalAlignment * (IntensityReflective - IntensityNonReflective) + IntensityNonReflective,
-                                Distance)),
-                            5,
-                            10,
-                            Dt);
+                        hit.SetMiss(endPos);
+                    }
+                    else
+                    {
+                        // Bilinear range, other fields from the nearest corner
+                        const float u = static_cast<float>(column - c0) / static_cast<float>(c1 - c0);
+                        const float v = static_cast<float>(channel - h0) / static_cast<float>(h1 - h0);
+                        const float distance = FMath::BiLerp(
+                            corners[0]->Distance, corners[1]->Distance, corners[2]->Distance, corners[3]->Distance, u, v);
+                        hit = *corners[((v < 0.5f) ? 0 : 2) + ((u < 0.5f) ? 0 : 1)];
+                        hit.Distance = distance;
+                        hit.Point = FVector3f(startPos + distance * (endPos - startPos).GetSafeNormal());
+                    }
+                    if (OutRecordedHits)
+                    {
+                        (*OutRecordedHits)[rayIdx] = FHitResult(ForceInit);
                     }
                 }
-                else
-                {
-                    // UE_LOG_WITH_INFO(LogTemp, Warning, TEXT("no physics material"));
-                    // LineBatcher->DrawLine(h.TraceStart, h.ImpactPoint, ColorHit, 10, .5, dt);
-                    LineBatcher->DrawPoint(
-                        h.ImpactPoint, InterpColorFromIntensity(GetIntensityFromDist(IntensityNonReflective, Distance)), 5, 10, Dt);
-                }
-            }
-            else if (ShowLidarRayMisses)
-            {
-                // LineBatcher->DrawLine(h.TraceStart, h.TraceEnd, ColorMiss, 10, .25, dt);
-                LineBatcher->DrawPoint(h.TraceEnd, ColorMiss, 2.5, 10, Dt);
             }
-        }
-    }
+            tracedRaysNum += blockTracedRaysNum;
+        });
+    LastScanTracedRaysNum = tracedRaysNum.load();
 }
 
-bool URR3DLidarComponent::Visible(AActor* TargetActor)
+void URR3DLidarComponent::OnScanTraced()
 {
-    TArray<FHitResult> RecordedVizHits;
-    RecordedVizHits.Init(FHitResult(ForceInit), GetTotalScan());
+    if ((ActiveEchoesNum > 1) && (BeamDivergence > 0.f))
+    {
+        TraceBeamDivergence();
+    }
 
-    DHAngle = FOVHorizontal / static_cast<float>(NSamplesPerScan);
-    DVAngle = FOVVertical / static_cast<float>(NChannelsPerScan);
+    UpdateDerivedLidars();
 
-    // complex collisions: true
-    FCollisionQueryParams TraceParams = FCollisionQueryParams(TEXT("3DLaser_Trace"), true, GetOwner());
-    TraceParams.bReturnPhysicalMaterial = true;
-    // TraceParams.bIgnoreTouches = true;
-    TraceParams.bTraceComplex = true;
-    TraceParams.bReturnFaceIndex = true;
+    if (BWithNoise)
+    {
+        AddPositionNoise();
+    }
 
-    FVector lidarPos = GetComponentLocation();
-    FRotator lidarRot = GetComponentRotation();
+    TimeOfLastScan = ScanStartTime;
+    TimeOfLastScanNanosec = ScanStartTimeNanosec;
+    Dt = 1.f / static_cast<float>(PublicationFrequencyHz);
 
-    ParallelFor(
-        RecordedVizHits.Num(),
-        [this, &TraceParams, &lidarPos, &lidarRot, &RecordedVizHits](int32 Index)
-        {
-            const int IdxX = Index % NSamplesPerScan;
-            const int IdxY = Index / NSamplesPerScan;
-            const float HAngle = StartAngle + DHAngle * IdxX;
-            const float VAngle = StartVerticalAngle + DVAngle * IdxY;
-
-            FRotator laserRot(VAngle, HAngle, 0);
-            FRotator rot = UKismetMathLibrary::ComposeRotators(laserRot, lidarRot);
-
-            FVector startPos = lidarPos + MinRange * UKismetMathLibrary::GetForwardVector(rot);
-            FVector endPos = lidarPos + MaxRange * UKismetMathLibrary::GetForwardVector(rot);
-
-            GetWorld()->LineTraceSingleByChannel(RecordedVizHits[Index],
-                                                 startPos,
-                                                 endPos,
-                                                 ECC_Visibility,
-                                                 TraceParams,
-                                                 FCollisionResponseParams::DefaultResponseParam);
-        },
-        false);
-
-    for (auto& h : RecordedVizHits)
+    // need to store on a structure associating hits with time?
+    // GetROS2Data needs to get all data since the last Get? or the last within the last time interval?
+
+    UpdateVisualization(bShowLidarRays && !URRCoreUtils::IsHeadlessSensorMode());
+}
+
+bool URR3DLidarComponent::IsAtRangeDiscontinuity(const int32 InIndex) const
+{
+    auto getRange = [this](const int32 InRayIndex)
     {
-        if (h.GetActor() == TargetActor)
+        const FRRLidarHit& hit = ScanHits[InRayIndex];
+        return hit.bHit ? hit.Distance : MaxRange;
+    };
+
+    const int32 column = InIndex % NSamplesPerScan;
+    const int32 channel = InIndex / NSamplesPerScan;
+    const float range = getRange(InIndex);
+    return ((column > 0) && (FMath::Abs(getRange(InIndex - 1) - range) > EchoSeparation)) ||
+           ((column < NSamplesPerScan - 1) && (FMath::Abs(getRange(InIndex + 1) - range) > EchoSeparation)) ||
+           ((channel > 0) && (FMath::Abs(getRange(InIndex - NSamplesPerScan) - range) > EchoSeparation)) ||
+           ((channel < NChannelsPerScan - 1) && (FMath::Abs(getRange(InIndex + NSamplesPerScan) - range) > EchoSeparation));
+}
+
+void URR3DLidarComponent::TraceBeamDivergence()
+{
+    static constexpr float STENCIL[BEAM_STENCIL_SIZE][2] = {{1.f, 0.f}, {-1.f, 0.f}, {0.f, 1.f}, {0.f, -1.f}};
+
+    const int32 echoSlotsNum = ActiveEchoesNum - 1;
+    const float tanHalfDivergence = FMath::Tan(FMath::DegreesToRadians(.5f * BeamDivergence));
+    // Beams directions & lidar pose of the traced scan, or of its last swept columns
+    const FVector lidarUp = ScanLidarRot.Quaternion().GetUpVector();
+    ParallelFor(
+        ScanHits.Num(),
+        [this, echoSlotsNum, tanHalfDivergence, &lidarUp](int32 InIndex)
         {
-            return true;
-        }
-    }
-    return false;
+            if (!IsAtRangeDiscontinuity(InIndex))
+            {
+                return;
+            }
+
+            FRRLidarHit* const echoHits = GetEchoHits(ScanEchoHits, InIndex);
+            int32 freeSlot = 0;
+            while ((freeSlot < echoSlotsNum) && echoHits[freeSlot].bHit)
+            {
+                ++freeSlot;
+            }
+
+            const FVector rayDir(ScanRayDirX[InIndex], ScanRayDirY[InIndex], ScanRayDirZ[InIndex]);
+            FVector right = FVector::CrossProduct(lidarUp, rayDir);
+            right = right.IsNearlyZero() ? FVector::RightVector : right.GetUnsafeNormal();
+            const FVector up = FVector::CrossProduct(rayDir, right);
+            for (int32 s = 0; (s < BEAM_STENCIL_SIZE) && (freeSlot < echoSlotsNum); ++s)
+            {
+                const FVector subRayDir =
+                    (rayDir + tanHalfDivergence * (STENCIL[s][0] * right + STENCIL[s][1] * up)).GetSafeNormal();
+                FHitResult hit;
+                GetWorld()->LineTraceSingleByChannel(hit,
+                                                     ScanLidarPos + MinRange * subRayDir,
+                                                     ScanLidarPos + MaxRange * subRayDir,
+                                                     ECC_Visibility,
+                                                     TraceParams,
+                                                     FCollisionResponseParams::DefaultResponseParam);
+                if (!hit.bBlockingHit)
+                {
+                    continue;
+                }
+
+                // Only keep returns distinct from the beam's ones
+                const FRRLidarHit& beamHit = ScanHits[InIndex];
+                bool bDistinct = !beamHit.bHit || (FMath::Abs(beamHit.Distance - hit.Distance) > EchoSeparation);
+                for (int32 e = 0; bDistinct && (e < freeSlot); ++e)
+                {
+                    bDistinct = (FMath::Abs(echoHits[e].Distance - hit.Distance) > EchoSeparation);
+                }
+                if (bDistinct)
+                {
+                    echoHits[freeSlot].SetFromHitResult(hit);
+                    echoHits[freeSlot].TimeOffset = beamHit.TimeOffset;
+                    ++freeSlot;
+                }
+            }
+        });
 }
 
 FROSPointCloud2 URR3DLidarComponent::GetROS2Data()
 {
-    FROSPointCloud2 retValue;
+    UpdatePointCloudMsg();
+    return PointCloudMsg;
+}
 
+void URR3DLidarComponent::UpdatePointCloudMsg()
+{
     // time
-    retValue.Header.Stamp = URRConversionUtils::FloatToROSStamp(TimeOfLastScan);
+    PointCloudMsg.Header.Stamp = URRConversionUtils::NanosecToROSStamp(TimeOfLastScanNanosec);
+
+    PointCloudMsg.Header.FrameId = FrameId;
+
+    // Each echo is a block of NChannelsPerScan rows
+    const int32 echoesNum = ActiveEchoesNum;
+    PointCloudMsg.Height = NChannelsPerScan * echoesNum;
+    PointCloudMsg.Width = NSamplesPerScan;
+    PointCloudMsg.RowStep = PointCloudMsg.PointStep * NSamplesPerScan;
+
+    const int32 raysNum = ScanHits.Num();
+    check(raysNum == NChannelsPerScan * NSamplesPerScan);
+    const int32 pointsNum = raysNum * echoesNum;
+    // Every byte is overwritten below, thus no need of zero-filling
+    const int32 dataSize = pointsNum * PointCloudMsg.PointStep;
+    if (PointCloudMsg.Data.Num() != dataSize)
+    {
+        PointCloudMsg.Data.SetNumUninitialized(dataSize);
+    }
+
+    if (BWithNoise)
+    {
+        UpdateIntensityNoise();
+    }
 
-    retValue.Header.FrameId = FrameId;
+    // Layout built in Run()
+    const int32 fieldsNum = PointCloudMsg.Fields.Num();
+    const int32 timeField = TimeFieldIndex;
+    const int32 returnIndexField = ReturnIndexFieldIndex;
+    float* const data = reinterpret_cast<float*>(PointCloudMsg.Data.GetData());
+    ParallelFor(
+        NChannelsPerScan * echoesNum,
+        [this, data, raysNum, echoesNum, fieldsNum, timeField, returnIndexField, bWithNoise = static_cast<bool>(BWithNoise)](
+            int32 InRow)
+        {
+            const int32 echo = InRow / NChannelsPerScan;
+            const int32 rowStart = (InRow % NChannelsPerScan) * NSamplesPerScan;
+            float* point = data + (echo * raysNum + rowStart) * fieldsNum;
+
+            // Rays [raysNum - rowEnd, raysNum - rowStart) in scan order, written reversed below
+            const int32 firstRay = raysNum - rowStart - NSamplesPerScan;
+            TArray<float, TInlineAllocator<2048>> intensities;
+            intensities.SetNumUninitialized(NSamplesPerScan);
+            IntensityTable.Evaluate((echo == 0) ? &ScanHits[firstRay] : &ScanEchoHits[firstRay * (echoesNum - 1) + echo - 1],
+                                    (echo == 0) ? 1 : (echoesNum - 1),
+                                    bWithNoise ? &IntensityNoise[firstRay] : nullptr,
+                                    NSamplesPerScan,
+                                    intensities.GetData());
+            for (auto i = rowStart; i < rowStart + NSamplesPerScan; ++i, point += fieldsNum)
+            {
+                // note that points are reversed compared to the scan order
+                const int32 rayIndex = raysNum - 1 - i;
+                const FRRLidarHit& hit = (echo == 0) ? ScanHits[rayIndex] : ScanEchoHits[rayIndex * (echoesNum - 1) + echo - 1];
+
+                // [m], misses are packed at origin
+                const float posScale = hit.bHit ? .01f : 0.f;
+                point[0] = hit.Point.X * posScale;
+                point[1] = hit.Point.Y * posScale;
+                point[2] = hit.Point.Z * posScale;
+                point[3] = (MinRange * (hit.Distance > 0) + hit.Distance) * .01f;
+                point[4] = intensities[rayIndex - firstRay];
+                if (timeField != INDEX_NONE)
+                {
+                    point[timeField] = hit.TimeOffset;
+                }
+                if (returnIndexField != INDEX_NONE)
+                {
+                    point[returnIndexField] = echo;
+                }
+            }
+        });
+}
 
-    retValue.Height = NChannelsPerScan;
-    retValue.Width = NSamplesPerScan;
+void URR3DLidarComponent::SetROS2Msg(UROS2GenericMsg* InMessage)
+{
+    UpdatePointCloudMsg();
+    if (IsPointCloudProcessed())
+    {
+        // Persistent dense msg kept as is for the next scans
+        CopyPointCloudMsg(PointCloudMsg, ProcessedPointCloudMsg);
+        ProcessPointCloud(GetPointCloudProcessParams(), ProcessedPointCloudMsg);
+        FRRROS2MsgWriter::WritePointCloud2(ProcessedPointCloudMsg, InMessage);
+        return;
+    }
+    FRRROS2MsgWriter::WritePointCloud2(PointCloudMsg, InMessage);
+}
 
-    static TArray<const TCHAR*> FIELDS = {TEXT("x"), TEXT("y"), TEXT("z"), TEXT("distance"), TEXT("intensity")};
+bool URR3DLidarComponent::GetROS2MsgBuilder(FRRROS2MsgBuilder& OutBuilder)
+{
+    if (!IsPointCloudProcessed())
+    {
+        return false;
+    }
 
-    for (int32 Index = 0; Index != FIELDS.Num(); ++Index)
+    // Dense packing stays in parallel on game thread, the processing of its copy being done on the publisher thread
+    UpdatePointCloudMsg();
+    if (!MsgPool.IsValid())
     {
-        FROSPointField f;
-        f.Name = FIELDS[Index];
-        f.Offset = Index * 4;
-        f.Datatype = 7;
-        f.Count = 1;
-        retValue.Fields.Add(f);
+        // One per builder the handoff ring holds plus the one being written
+        MsgPool = MakeShared<TRRROS2MsgPool<FROSPointCloud2>>(SensorPublisher ? SensorPublisher->HandOffCapacity + 1 : 2);
     }
+    TUniquePtr<FROSPointCloud2> pooledMsg = MsgPool->Acquire();
+    CopyPointCloudMsg(PointCloudMsg, *pooledMsg);
+    OutBuilder = [msg = MoveTemp(pooledMsg), pool = MsgPool, params = GetPointCloudProcessParams()](
+                     UROS2GenericMsg* InMessage) mutable
+    {
+        ProcessPointCloud(params, *msg);
+        FRRROS2MsgWriter::WritePointCloud2(*msg, InMessage);
+        pool->Release(MoveTemp(msg));
+    };
+    return true;
+}
 
-    retValue.bIsBigendian = false;
+void URR3DLidarComponent::CopyPointCloudMsg(const FROSPointCloud2& InSrc, FROSPointCloud2& OutDst)
+{
+    OutDst.Header = InSrc.Header;
+    OutDst.Height = InSrc.Height;
+    OutDst.Width = InSrc.Width;
+    OutDst.Fields = InSrc.Fields;
+    OutDst.bIsBigendian = InSrc.bIsBigendian;
+    OutDst.PointStep = InSrc.PointStep;
+    OutDst.RowStep = InSrc.RowStep;
+    // Reset keeps the allocation, only grown if the source is larger
+    OutDst.Data.Reset();
+    OutDst.Data.Append(InSrc.Data);
+    OutDst.bIsDense = InSrc.bIsDense;
+}
 
-    retValue.PointStep = sizeof(float) * 5;
-    retValue.RowStep = sizeof(float) * 5 * NSamplesPerScan;
+URR3DLidarComponent::FPointCloudProcessParams URR3DLidarComponent::GetPointCloudProcessParams() const
+{
+    FPointCloudProcessParams params;
+    params.bRemoveNoReturns = bRemoveNoReturns;
+    params.VoxelSize = VoxelSize * .01f;
+    params.bCompactPointFields = bCompactPointFields;
+    params.TimeFieldIndex = TimeFieldIndex;
+    params.ReturnIndexFieldIndex = ReturnIndexFieldIndex;
+    return params;
+}
 
-    retValue.Data.Init(0, RecordedHits.Num() * sizeof(float) * 5);
-    for (auto i = 0; i < RecordedHits.Num(); i++)
+void URR3DLidarComponent::ProcessPointCloud(const FPointCloudProcessParams& InParams, FROSPointCloud2& InOutMsg)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRProcessPointCloud", RRSensorChannel);
+    const int32 fieldsNum = InOutMsg.Fields.Num();
+    const int32 pointsNum = (fieldsNum > 0) ? static_cast<int32>(InOutMsg.Data.Num() / (fieldsNum * sizeof(float))) : 0;
+    float* const points = reinterpret_cast<float*>(InOutMsg.Data.GetData());
+    int32 keptNum = pointsNum;
+
+    // 1- Compact the returns towards the buffer start, in place, either as is or as voxel centroids
+    if (InParams.VoxelSize > 0.f)
     {
-        float Distance = (MinRange * (RecordedHits.Last(i).Distance > 0) + RecordedHits.Last(i).Distance) * .01f;
-        const float IntensityScale = 1.f + BWithNoise * GaussianRNGIntensity(Gen);
-        float Intensity = 0;
-        if (RecordedHits.Last(i).PhysMaterial != nullptr)
+        // Sums of each occupied voxel's points, in first occupancy order, then written over the first ones
+        const float invVoxelSize = 1.f / InParams.VoxelSize;
+        TMap<FIntVector, int32> voxels;
+        voxels.Reserve(pointsNum / 4);
+        TArray<float> sums;
+        TArray<int32> counts;
+        for (int32 i = 0; i < pointsNum; ++i)
         {
-            // retroreflective material
-            if (RecordedHits.Last(i).PhysMaterial->SurfaceType == EPhysicalSurface::SurfaceType1)
+            const float* point = points + i * fieldsNum;
+            // Distance, 0 without return
+            if (point[3] <= 0.f)
             {
-                Intensity = IntensityScale * IntensityReflective;
+                continue;
             }
-            // non-reflective material
-            else if (RecordedHits.Last(i).PhysMaterial->SurfaceType == EPhysicalSurface::SurfaceType_Default)
+            const FIntVector key(FMath::FloorToInt32(point[0] * invVoxelSize),
+                                 FMath::FloorToInt32(point[1] * invVoxelSize),
+                                 FMath::FloorToInt32(point[2] * invVoxelSize));
+            int32& voxel = voxels.FindOrAdd(key, INDEX_NONE);
+            if (INDEX_NONE == voxel)
             {
-                Intensity = IntensityScale * IntensityNonReflective;
+                voxel = counts.Add(0);
+                // t & return_index of the voxel's first point are kept as is
+                sums.Append(point, fieldsNum);
+                FMemory::Memzero(sums.GetData() + voxel * fieldsNum, POINT_FIELDS_NUM * sizeof(float));
             }
-            // reflective material
-            else if (RecordedHits.Last(i).PhysMaterial->SurfaceType == EPhysicalSurface::SurfaceType2)
+            float* sum = sums.GetData() + voxel * fieldsNum;
+            for (int32 f = 0; f < POINT_FIELDS_NUM; ++f)
             {
-                FVector HitSurfaceNormal = RecordedHits.Last(i).Normal;
-                FVector RayDirection = RecordedHits.Last(i).TraceEnd - RecordedHits.Last(i).TraceStart;
-                RayDirection.Normalize();
-
-                // the dot product for this should always be between 0 and 1
-                const float UnnormalizedIntensity =
-                    FMath::Clamp(IntensityNonReflective + (IntensityReflective - IntensityNonReflective) *
-                                                              FVector::DotProduct(HitSurfaceNormal, -RayDirection),
-                                 IntensityNonReflective,
-                                 IntensityReflective);
-                if ((UnnormalizedIntensity <= IntensityNonReflective) || (UnnormalizedIntensity <= IntensityReflective))
-                {
-                    UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("Normalized intensity is outof range. Something is wrong."));
-                }
-                Intensity = IntensityScale * UnnormalizedIntensity;
+                sum[f] += point[f];
             }
+            ++counts[voxel];
         }
-        else
+
+        keptNum = counts.Num();
+        for (int32 v = 0; v < keptNum; ++v)
         {
-            Intensity = 0;    // std::numeric_limits<float>::quiet_NaN();
+            const float* sum = sums.GetData() + v * fieldsNum;
+            float* point = points + v * fieldsNum;
+            const float invCount = 1.f / counts[v];
+            for (int32 f = 0; f < fieldsNum; ++f)
+            {
+                point[f] = (f < POINT_FIELDS_NUM) ? (sum[f] * invCount) : sum[f];
+            }
+        }
+    }
+    else if (InParams.bRemoveNoReturns)
+    {
+        keptNum = 0;
+        for (int32 i = 0; i < pointsNum; ++i)
+        {
+            const float* point = points + i * fieldsNum;
+            if (point[3] > 0.f)
+            {
+                FMemory::Memmove(points + keptNum * fieldsNum, point, fieldsNum * sizeof(float));
+                ++keptNum;
+            }
         }
-
-        FVector Pos = RecordedHits.Last(i).ImpactPoint * .01f;
-        memcpy(&retValue.Data[i * 4 * 5], &Pos.X, 4);
-        memcpy(&retValue.Data[i * 4 * 5 + 4], &Pos.Y, 4);
-        memcpy(&retValue.Data[i * 4 * 5 + 8], &Pos.Z, 4);
-        memcpy(&retValue.Data[i * 4 * 5 + 12], &Distance, 4);
-        memcpy(&retValue.Data[i * 4 * 5 + 16], &Intensity, 4);
     }
 
-    retValue.bIsDense = true;
+    // 2- Repack the kept points into the compact layout, never writing ahead of the points still to be read
+    int32 pointStep = fieldsNum * sizeof(float);
+    if (InParams.bCompactPointFields)
+    {
+        TArray<FROSPointField> fields;
+        auto addField = [&fields](const TCHAR* InName, const int32 InOffset, const uint8 InDatatype)
+        {
+            FROSPointField& field = fields.AddDefaulted_GetRef();
+            field.Name = InName;
+            field.Offset = InOffset;
+            field.Datatype = InDatatype;
+            field.Count = 1;
+        };
+        // sensor_msgs/PointField FLOAT32 & UINT16
+        static constexpr uint8 FLOAT32 = 7;
+        static constexpr uint8 UINT16 = 4;
+        addField(TEXT("x"), 0, FLOAT32);
+        addField(TEXT("y"), 4, FLOAT32);
+        addField(TEXT("z"), 8, FLOAT32);
+        int32 offset = 12;
+        const int32 timeOffset = (INDEX_NONE != InParams.TimeFieldIndex) ? offset : INDEX_NONE;
+        if (INDEX_NONE != timeOffset)
+        {
+            addField(TEXT("t"), offset, FLOAT32);
+            offset += 4;
+        }
+        const int32 intensityOffset = offset;
+        addField(TEXT("intensity"), offset, UINT16);
+        offset += 2;
+        const int32 returnIndexOffset = (INDEX_NONE != InParams.ReturnIndexFieldIndex) ? offset : INDEX_NONE;
+        if (INDEX_NONE != returnIndexOffset)
+        {
+            addField(TEXT("return_index"), offset, UINT16);
+            offset += 2;
+        }
+        pointStep = offset;
 
-    return retValue;
-}
+        uint8* const data = InOutMsg.Data.GetData();
+        for (int32 i = 0; i < keptNum; ++i)
+        {
+            // Read fully before writing, the compact point overlapping its source one
+            const float* point = points + i * fieldsNum;
+            const FVector3f xyz(point[0], point[1], point[2]);
+            const float t = (INDEX_NONE != timeOffset) ? point[InParams.TimeFieldIndex] : 0.f;
+            const uint16 intensity = static_cast<uint16>(FMath::Clamp(FMath::RoundToInt32(point[4]), 0, MAX_uint16));
+            const uint16 returnIndex =
+                (INDEX_NONE != returnIndexOffset) ? static_cast<uint16>(point[InParams.ReturnIndexFieldIndex]) : 0;
+            uint8* out = data + i * pointStep;
+            FMemory::Memcpy(out, &xyz, 3 * sizeof(float));
+            if (INDEX_NONE != timeOffset)
+            {
+                FMemory::Memcpy(out + timeOffset, &t, sizeof(float));
+            }
+            FMemory::Memcpy(out + intensityOffset, &intensity, sizeof(uint16));
+            if (INDEX_NONE != returnIndexOffset)
+            {
+                FMemory::Memcpy(out + returnIndexOffset, &returnIndex, sizeof(uint16));
+            }
+        }
+        InOutMsg.Fields = MoveTemp(fields);
+    }
 
-void URR3DLidarComponent::SetROS2Msg(UROS2GenericMsg* InMessage)
-{
-    CastChecked<UROS2PointCloud2Msg>(InMessage)->SetMsg(GetROS2Data());
+    InOutMsg.Data.SetNum(keptNum * pointStep, false);
+    InOutMsg.PointStep = pointStep;
+    if (keptNum != pointsNum)
+    {
+        InOutMsg.Height = 1;
+        InOutMsg.Width = keptNum;
+    }
+    InOutMsg.RowStep = pointStep * InOutMsg.Width;
 }
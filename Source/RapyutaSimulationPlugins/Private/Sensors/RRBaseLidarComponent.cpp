@@ -2,21 +2,857 @@
 
 #include "Sensors/RRBaseLidarComponent.h"
 
+// Native
+#include <utility>
+
+// UE
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "Kismet/GameplayStatics.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
 // RapyutaSimulationPlugins
+#include "Core/RRConversionUtils.h"
+#include "Core/RRMathUtils.h"
+#include "Core/RRNoiseUtils.h"
+#include "Core/RRTrace.h"
+#include "Sensors/RRLidarBatchScheduler.h"
+#include "Sensors/RRLidarVisualizationComponent.h"
+#include "Sensors/RRSensorRayCaster.h"
+#include "Tools/RRMemoryStats.h"
 #include "Tools/RRROS2LidarPublisher.h"
 
+static TAutoConsoleVariable<bool> CVarLidarShareRayTables(
+    TEXT("rr.Lidar.ShareRayTables"),
+    true,
+    TEXT("Whether lidars of the same class & scan pattern share their ray direction table, else each builds its own."),
+    ECVF_Default);
+
+namespace
+{
+//! Ray tables by lidar class, scan pattern hash & rays num, kept as long as a lidar holds them
+FCriticalSection GLidarRayTablesMutex;
+TMap<uint32, TWeakPtr<const FRRLidarRayTable>> GLidarRayTables;
+}    // namespace
+
+void FRRLidarHit::SetFromHitResult(const FHitResult& InHit)
+{
+    const AActor* hitActor = InHit.GetActor();
+    if (nullptr == hitActor)
+    {
+        SetMiss(InHit.TraceEnd);
+        return;
+    }
+
+    bHit = true;
+    Point = FVector3f(InHit.ImpactPoint);
+    Distance = InHit.Distance;
+    ActorId = hitActor->GetUniqueID();
+    SurfaceType = InHit.PhysMaterial.IsValid() ? static_cast<uint8>(InHit.PhysMaterial->SurfaceType.GetValue()) : SURFACE_TYPE_NONE;
+    NormalAlignment = FVector::DotProduct(InHit.Normal, -(InHit.TraceEnd - InHit.TraceStart).GetSafeNormal());
+}
+
 URRBaseLidarComponent::URRBaseLidarComponent()
 {
     BWithNoise = true;
     TopicName = TEXT("scan");
     FrameId = TEXT("base_scan");
+    OverloadTier = ERRSensorOverloadTier::NAVIGATION;
 }
 
 void URRBaseLidarComponent::BeginPlay()
 {
     Super::BeginPlay();
-    GaussianRNGPosition = std::normal_distribution<>{PositionalNoiseMean, PositionalNoiseVariance};
     GaussianRNGIntensity = std::normal_distribution<>{IntensityNoiseMean, IntensityNoiseVariance};
+
+    ActiveNoiseSeed = FRRNoiseUtils::GetSensorSeed(NoiseSeed, GetPathName());
+    UE_LOG_WITH_INFO(LogRapyutaCore, Log, TEXT("[%s] Lidar noise seed: %u"), *GetName(), ActiveNoiseSeed);
+}
+
+void URRBaseLidarComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+#if TRACE_ASYNC
+    WaitForScanTrace();
+#endif
+    Super::EndPlay(EndPlayReason);
+}
+
+void URRBaseLidarComponent::Run()
+{
+    // complex collisions: true
+    TraceParams = FCollisionQueryParams(TEXT("Laser_Trace"), true, GetOwner());
+    TraceParams.bReturnPhysicalMaterial = true;
+
+    // TraceParams.bIgnoreTouches = true;
+    TraceParams.bTraceComplex = true;
+    TraceParams.bReturnFaceIndex = true;
+
+#if TRACE_ASYNC
+    WaitForScanTrace();
+#endif
+    BuildRayDirectionTable();
+    InitScanBuffers();
+    ResolveLidarGroup();
+
+    Super::Run();
+}
+
+void URRBaseLidarComponent::TickComponent(float DeltaTime,
+                                          enum ELevelTick TickType,
+                                          FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+    if (bSweepScan && (SweepColumnsDone >= 0))
+    {
+        UpdateSweep(false);
+    }
+#if TRACE_ASYNC
+    if (ScanTraceFuture.IsValid() && ScanTraceFuture.IsReady())
+    {
+        ScanTraceFuture.Reset();
+        Swap(ScanHits, PendingScanHits);
+        Swap(ScanEchoHits, PendingScanEchoHits);
+        if (bRecordHitResults)
+        {
+            Swap(RecordedHits, PendingRecordedHits);
+        }
+        OnScanTraced();
+    }
+#endif
+}
+
+void URRBaseLidarComponent::Stop()
+{
+    Super::Stop();
+    if (URRBaseLidarComponent* sourceLidar = SourceLidar.Get())
+    {
+        sourceLidar->DerivedLidars.Remove(this);
+        SourceLidar.Reset();
+    }
+    // Derived lidars trace their own scans from now on
+    for (const TWeakObjectPtr<URRBaseLidarComponent>& derivedLidar : DerivedLidars)
+    {
+        if (derivedLidar.IsValid() && (derivedLidar->SourceLidar.Get() == this))
+        {
+            derivedLidar->SourceLidar.Reset();
+        }
+    }
+    DerivedLidars.Reset();
+    if (bBatchTrace)
+    {
+        FRRLidarBatchScheduler::Get(GetWorld()).RemoveScan(this);
+    }
+    SweepColumnsDone = -1;
+#if TRACE_ASYNC
+    // The traced scan is dropped
+    WaitForScanTrace();
+#endif
+}
+
+#if TRACE_ASYNC
+void URRBaseLidarComponent::WaitForScanTrace()
+{
+    if (ScanTraceFuture.IsValid())
+    {
+        ScanTraceFuture.Wait();
+        ScanTraceFuture.Reset();
+    }
+}
+#endif
+
+void URRBaseLidarComponent::SensorUpdate()
+{
+    // Derived in the source lidar's OnScanTraced()
+    if (IsScanDerived())
+    {
+        return;
+    }
+
+#if TRACE_ASYNC
+    // The scan in flight still owns the ray directions & back buffers
+    if (ScanTraceFuture.IsValid())
+    {
+        ++SkippedScansNum;
+        UE_LOG_WITH_INFO(LogROS2Sensor,
+                         Verbose,
+                         TEXT("[%s] Previous scan still in flight, skipped %u scans so far"),
+                         *GetName(),
+                         SkippedScansNum);
+        return;
+    }
+#endif
+
+    if (bSweepScan)
+    {
+        // Complete the sweep in progress, which is due by now, then start a new one
+        if (SweepColumnsDone >= 0)
+        {
+            UpdateSweep(true);
+        }
+        PrepareScan();
+        SweepColumnsDone = 0;
+        UpdateSweep(false);
+        return;
+    }
+
+    PrepareScan();
+
+    if (bBatchTrace)
+    {
+        // Traced together with all other lidars due in this frame, then post-processed in OnScanTraced()
+        FRRLidarBatchScheduler::Get(GetWorld()).AddScan(this);
+        return;
+    }
+
+#if TRACE_ASYNC
+    ScanTraceFuture =
+        Async(EAsyncExecution::TaskGraph,
+              [this]()
+              { TraceScan(PendingScanHits, bRecordHitResults ? &PendingRecordedHits : nullptr, PendingScanEchoHits); });
+#else
+    TraceScan(ScanHits, bRecordHitResults ? &RecordedHits : nullptr, ScanEchoHits);
+    OnScanTraced();
+#endif
+}
+
+void URRBaseLidarComponent::TraceScan(TArray<FRRLidarHit>& OutHits,
+                                      TArray<FHitResult>* OutRecordedHits,
+                                      TArray<FRRLidarHit>& OutEchoHits)
+{
+    if (ScanRayScene.IsValid() && (nullptr == OutRecordedHits))
+    {
+        ScanRayScene->RaycastPacket(ScanLidarPos,
+                                    ScanRayDirX.GetData(),
+                                    ScanRayDirY.GetData(),
+                                    ScanRayDirZ.GetData(),
+                                    OutHits.Num(),
+                                    MinRange,
+                                    MaxRange,
+                                    ScanIgnoredActorId,
+                                    (RayTable->ExcludedRaysNum > 0) ? &RayTable->ExcludedRays : nullptr,
+                                    OutHits.GetData());
+        LastScanTracedRaysNum = OutHits.Num() - RayTable->ExcludedRaysNum;
+        return;
+    }
+
+    const FTraceRayKernel traceRay = GetTraceRayKernel(nullptr != OutRecordedHits, ActiveEchoesNum > 1);
+    ParallelFor(OutHits.Num(),
+                [this, traceRay, &OutHits, OutRecordedHits, &OutEchoHits](int32 Index)
+                {
+                    (this->*traceRay)(Index,
+                                      OutHits[Index],
+                                      OutRecordedHits ? &(*OutRecordedHits)[Index] : nullptr,
+                                      GetEchoHits(OutEchoHits, Index));
+                });
+    LastScanTracedRaysNum = OutHits.Num() - RayTable->ExcludedRaysNum;
+}
+
+int32 URRBaseLidarComponent::FindColumn(const float InYaw) const
+{
+    if (NSamplesPerScan <= 0)
+    {
+        return INDEX_NONE;
+    }
+    const float dh = FOVHorizontal / static_cast<float>(NSamplesPerScan);
+    float offset = FMath::Fmod(InYaw - StartAngle, 360.f);
+    if (offset < 0.f)
+    {
+        offset += 360.f;
+    }
+    int32 column = FMath::RoundToInt32(offset / dh);
+    if (!FMath::IsNearlyEqual(column * dh, offset, RAY_ANGLE_TOLERANCE))
+    {
+        return INDEX_NONE;
+    }
+    // Yaws just below StartAngle of full circle scans
+    if ((column == NSamplesPerScan) && FMath::IsNearlyEqual(FOVHorizontal, 360.f, RAY_ANGLE_TOLERANCE))
+    {
+        column = 0;
+    }
+    return ((column >= 0) && (column < NSamplesPerScan)) ? column : INDEX_NONE;
+}
+
+void URRBaseLidarComponent::ResolveLidarGroup()
+{
+    if (URRBaseLidarComponent* sourceLidar = SourceLidar.Get())
+    {
+        sourceLidar->DerivedLidars.Remove(this);
+    }
+    SourceLidar.Reset();
+    if (LidarGroup.IsNone() || (nullptr == GetOwner()))
+    {
+        return;
+    }
+
+    TInlineComponentArray<URRBaseLidarComponent*> lidars(GetOwner());
+    for (URRBaseLidarComponent* lidar : lidars)
+    {
+        if ((lidar == this) || (lidar->LidarGroup != LidarGroup) || lidar->IsScanDerived() || lidar->bOnDemand ||
+            (lidar->GetRaysNum() < GetRaysNum()) || !BuildSourceRayIndices(*lidar))
+        {
+            continue;
+        }
+        SourceLidar = lidar;
+        lidar->DerivedLidars.AddUnique(this);
+        if (lidar->PublicationFrequencyHz != PublicationFrequencyHz)
+        {
+            UE_LOG_WITH_INFO(LogROS2Sensor,
+                             Warning,
+                             TEXT("[%s] derived from [%s] at its %dHz instead of %dHz"),
+                             *GetName(),
+                             *lidar->GetName(),
+                             lidar->PublicationFrequencyHz,
+                             PublicationFrequencyHz);
+        }
+        UE_LOG_WITH_INFO(LogROS2Sensor, Log, TEXT("[%s] scans derived from [%s]"), *GetName(), *lidar->GetName());
+        return;
+    }
+    // Eg the group's source lidar itself
+    UE_LOG_WITH_INFO(LogROS2Sensor,
+                     Log,
+                     TEXT("[%s] no lidar of group [%s] covers its rays, tracing its own scans"),
+                     *GetName(),
+                     *LidarGroup.ToString());
+}
+
+bool URRBaseLidarComponent::BuildSourceRayIndices(const URRBaseLidarComponent& InSource)
+{
+    SourceRayIndices.Reset();
+    if ((GetEchoesNum() > 1) || (bRecordHitResults && !InSource.bRecordHitResults) || (MinRange < InSource.MinRange) ||
+        (MaxRange > InSource.MaxRange) ||
+        !GetComponentLocation().Equals(InSource.GetComponentLocation(), GROUP_POSITION_TOLERANCE) ||
+        (FMath::RadiansToDegrees(GetComponentQuat().AngularDistance(InSource.GetComponentQuat())) > RAY_ANGLE_TOLERANCE))
+    {
+        return false;
+    }
+
+    const int32 raysNum = GetRaysNum();
+    SourceRayIndices.SetNumUninitialized(raysNum);
+    for (int32 i = 0; i < raysNum; ++i)
+    {
+        SourceRayIndices[i] = InSource.FindRayIndex(GetLocalRayRotation(i));
+        if (INDEX_NONE == SourceRayIndices[i])
+        {
+            SourceRayIndices.Reset();
+            return false;
+        }
+    }
+    SourceRayIndicesHash = RayDirectionTableHash;
+    SourceScanPatternHash = InSource.GetScanPatternHash();
+    return true;
+}
+
+bool URRBaseLidarComponent::DeriveScan(const URRBaseLidarComponent& InSource)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRLidarDeriveScan", RRSensorChannel);
+    if (GetScanPatternHash() != RayDirectionTableHash)
+    {
+        BuildRayDirectionTable();
+        InitScanBuffers();
+    }
+    if (((SourceRayIndicesHash != RayDirectionTableHash) || (SourceScanPatternHash != InSource.GetScanPatternHash())) &&
+        !BuildSourceRayIndices(InSource))
+    {
+        UE_LOG_WITH_INFO(LogROS2Sensor,
+                         Warning,
+                         TEXT("[%s] no longer derivable from [%s], tracing its own scans"),
+                         *GetName(),
+                         *InSource.GetName());
+        SourceLidar.Reset();
+        return false;
+    }
+
+    UpdateIntensityTable();
+
+    ++ScanIndex;
+    ScanStartTime = InSource.ScanStartTime;
+    ScanStartTimeNanosec = InSource.ScanStartTimeNanosec;
+    UpdateScanPose();
+
+    ParallelFor(ScanHits.Num(),
+                [this, &InSource](int32 Index)
+                {
+                    const int32 sourceIdx = SourceRayIndices[Index];
+                    const FRRLidarHit& sourceHit = InSource.ScanHits[sourceIdx];
+                    const FVector sourceRayDir(
+                        InSource.ScanRayDirX[sourceIdx], InSource.ScanRayDirY[sourceIdx], InSource.ScanRayDirZ[sourceIdx]);
+                    // Re-measured from this lidar's trace start
+                    const float distance = sourceHit.Distance + InSource.MinRange - MinRange;
+                    FRRLidarHit& hit = ScanHits[Index];
+                    if (!sourceHit.bHit || IsRayExcluded(Index) || (distance < 0.f) || (MinRange + distance > MaxRange))
+                    {
+                        hit.SetMiss(InSource.ScanLidarPos + MaxRange * sourceRayDir);
+                        hit.TimeOffset = sourceHit.TimeOffset;
+                    }
+                    else
+                    {
+                        hit = sourceHit;
+                        hit.Distance = distance;
+                    }
+                    if (bRecordHitResults)
+                    {
+                        RecordedHits[Index] = hit.bHit ? InSource.RecordedHits[sourceIdx] : FHitResult(ForceInit);
+                    }
+                });
+    LastScanTracedRaysNum = 0;
+    OnScanTraced();
+    return true;
+}
+
+void URRBaseLidarComponent::UpdateDerivedLidars()
+{
+    for (int32 i = DerivedLidars.Num() - 1; i >= 0; --i)
+    {
+        URRBaseLidarComponent* derivedLidar = DerivedLidars[i].Get();
+        if ((nullptr == derivedLidar) || (derivedLidar->SourceLidar.Get() != this) || !derivedLidar->DeriveScan(*this))
+        {
+            DerivedLidars.RemoveAtSwap(i);
+        }
+    }
+}
+
+uint32 URRBaseLidarComponent::GetScanPatternHash() const
+{
+    uint32 hash = GetTypeHash(NSamplesPerScan);
+    hash = HashCombine(hash, GetTypeHash(StartAngle));
+    hash = HashCombine(hash, GetTypeHash(FOVHorizontal));
+    for (const FRRLidarRegion& region : ExcludedRegions)
+    {
+        hash = HashCombine(hash, GetTypeHash(region.MinAzimuth));
+        hash = HashCombine(hash, GetTypeHash(region.MaxAzimuth));
+        hash = HashCombine(hash, GetTypeHash(region.MinElevation));
+        hash = HashCombine(hash, GetTypeHash(region.MaxElevation));
+    }
+    return hash;
+}
+
+void URRBaseLidarComponent::BuildRayDirectionTable()
+{
+    DHAngle = FOVHorizontal / static_cast<float>(NSamplesPerScan);
+    RayDirectionTableHash = GetScanPatternHash();
+
+    const int32 raysNum = GetRaysNum();
+    const int32 paddedRaysNum = Align(raysNum, 4);
+    const bool bShared = CVarLidarShareRayTables.GetValueOnGameThread();
+    const uint32 tableKey = HashCombine(HashCombine(GetTypeHash(GetClass()), RayDirectionTableHash), GetTypeHash(raysNum));
+    RayTable.Reset();
+    if (bShared)
+    {
+        FScopeLock lock(&GLidarRayTablesMutex);
+        if (const TWeakPtr<const FRRLidarRayTable>* sharedTable = GLidarRayTables.Find(tableKey))
+        {
+            RayTable = sharedTable->Pin();
+        }
+    }
+
+    if (!RayTable.IsValid())
+    {
+        TSharedRef<FRRLidarRayTable> table = MakeShared<FRRLidarRayTable>();
+        table->LocalRayDirX.SetNumZeroed(paddedRaysNum);
+        table->LocalRayDirY.SetNumZeroed(paddedRaysNum);
+        table->LocalRayDirZ.SetNumZeroed(paddedRaysNum);
+        table->ExcludedRays.Init(false, raysNum);
+        for (int32 i = 0; i < raysNum; ++i)
+        {
+            const FRotator localRot = GetLocalRayRotation(i);
+            const FVector3f localDir(localRot.Vector());
+            table->LocalRayDirX[i] = localDir.X;
+            table->LocalRayDirY[i] = localDir.Y;
+            table->LocalRayDirZ[i] = localDir.Z;
+            if (ExcludedRegions.ContainsByPredicate([&localRot](const FRRLidarRegion& InRegion)
+                                                    { return InRegion.Contains(localRot); }))
+            {
+                table->ExcludedRays[i] = true;
+                ++table->ExcludedRaysNum;
+            }
+        }
+        RayTable = table;
+
+        if (bShared)
+        {
+            FScopeLock lock(&GLidarRayTablesMutex);
+            for (auto it = GLidarRayTables.CreateIterator(); it; ++it)
+            {
+                if (!it.Value().IsValid())
+                {
+                    it.RemoveCurrent();
+                }
+            }
+            GLidarRayTables.Add(tableKey, RayTable);
+        }
+    }
+
+    // Per instance, rotated by each scan
+    ScanRayDirX.SetNumZeroed(paddedRaysNum);
+    ScanRayDirY.SetNumZeroed(paddedRaysNum);
+    ScanRayDirZ.SetNumZeroed(paddedRaysNum);
+}
+
+void URRBaseLidarComponent::UpdateSweep(const bool bInComplete)
+{
+    const int32 columnsNum = NSamplesPerScan;
+    const int32 channelsNum = PendingScanHits.Num() / columnsNum;
+    const float timeOffset = UGameplayStatics::GetTimeSeconds(GetWorld()) - ScanStartTime;
+    const int32 columnsDue =
+        bInComplete ? columnsNum
+                    : FMath::Clamp(FMath::FloorToInt32(timeOffset * PublicationFrequencyHz * columnsNum) + 1, 0, columnsNum);
+    if (columnsDue > SweepColumnsDone)
+    {
+        UpdateScanPose();
+        const int32 columnsDone = SweepColumnsDone;
+        ParallelFor((columnsDue - columnsDone) * channelsNum,
+                    [this, columnsNum, channelsNum, columnsDone, timeOffset](int32 Index)
+                    {
+                        const int32 column = columnsNum - 1 - (columnsDone + Index / channelsNum);
+                        const int32 rayIndex = column + (Index % channelsNum) * columnsNum;
+                        FRRLidarHit* const echoHits = GetEchoHits(PendingScanEchoHits, rayIndex);
+                        (this->*ScanTraceRayKernel)(rayIndex,
+                                                    PendingScanHits[rayIndex],
+                                                    bRecordHitResults ? &PendingRecordedHits[rayIndex] : nullptr,
+                                                    echoHits);
+                        PendingScanHits[rayIndex].TimeOffset = timeOffset;
+                        for (int32 e = 0; echoHits && (e < ActiveEchoesNum - 1); ++e)
+                        {
+                            echoHits[e].TimeOffset = timeOffset;
+                        }
+                    });
+        SweepColumnsDone = columnsDue;
+    }
+
+    if (SweepColumnsDone == columnsNum)
+    {
+        SweepColumnsDone = -1;
+        Swap(ScanHits, PendingScanHits);
+        Swap(ScanEchoHits, PendingScanEchoHits);
+        if (bRecordHitResults)
+        {
+            Swap(RecordedHits, PendingRecordedHits);
+        }
+        OnScanTraced();
+    }
+}
+
+void URRBaseLidarComponent::PrepareScan()
+{
+    if (GetScanPatternHash() != RayDirectionTableHash)
+    {
+        BuildRayDirectionTable();
+        InitScanBuffers();
+    }
+    else if (GetEchoesNum() != ActiveEchoesNum)
+    {
+        InitScanBuffers();
+    }
+
+    ++ScanIndex;
+    ScanStartTime = UGameplayStatics::GetTimeSeconds(GetWorld());
+    ScanStartTimeNanosec = URRConversionUtils::GetSimTimeNanosec(this);
+    UpdateScanPose();
+
+    if (bUseSensorRayCaster && (ActiveEchoesNum == 1) && !bRecordHitResults)
+    {
+        ScanRayScene = FRRSensorRayCaster::Get(GetWorld()).GetScene();
+        ScanIgnoredActorId = GetOwner() ? GetOwner()->GetUniqueID() : 0;
+    }
+    else
+    {
+        ScanRayScene.Reset();
+    }
+    ScanTraceRayKernel = GetTraceRayKernel(bRecordHitResults, ActiveEchoesNum > 1);
+}
+
+void URRBaseLidarComponent::UpdateScanPose()
+{
+    ScanLidarPos = GetComponentLocation();
+    ScanLidarRot = GetComponentRotation();
+
+    // world dir = lidarRot * laserRot * forward, same as ComposeRotators(laserRot, lidarRot).Vector()
+    URRMathUtils::RotateVectorsSoA(FQuat4f(ScanLidarRot.Quaternion()),
+                                   RayTable->LocalRayDirX.GetData(),
+                                   RayTable->LocalRayDirY.GetData(),
+                                   RayTable->LocalRayDirZ.GetData(),
+                                   ScanRayDirX.GetData(),
+                                   ScanRayDirY.GetData(),
+                                   ScanRayDirZ.GetData(),
+                                   RayTable->LocalRayDirX.Num());
+}
+
+void URRBaseLidarComponent::FillScanNoise(const ENoiseStream InStream,
+                                          const float InMean,
+                                          const float InStdDev,
+                                          const int32 InNum,
+                                          TArray<float>& OutNoise) const
+{
+    static constexpr int32 CHUNK_SIZE = 128 * FRRNoiseUtils::GAUSSIAN_BATCH_SIZE;
+    OutNoise.SetNumUninitialized(InNum);
+    const uint64 key = FRRNoiseUtils::MakeKey(ActiveNoiseSeed, ScanIndex, static_cast<uint32>(InStream));
+    float* const noise = OutNoise.GetData();
+    ParallelFor(FMath::DivideAndRoundUp(InNum, CHUNK_SIZE),
+                [key, InMean, InStdDev, InNum, noise](int32 InChunkIndex)
+                {
+                    const int32 start = InChunkIndex * CHUNK_SIZE;
+                    FRRNoiseUtils::FillGaussian(
+                        key, start, InMean, InStdDev, noise + start, FMath::Min(CHUNK_SIZE, InNum - start));
+                });
+}
+
+void URRBaseLidarComponent::AddPositionNoise()
+{
+    FillScanNoise(ENoiseStream::POSITION, PositionalNoiseMean, PositionalNoiseVariance, 3 * ScanHits.Num(), PositionNoise);
+    for (auto i = 0; i < ScanHits.Num(); ++i)
+    {
+        ScanHits[i].Point += FVector3f(PositionNoise[3 * i], PositionNoise[3 * i + 1], PositionNoise[3 * i + 2]);
+    }
+
+    if (ScanEchoHits.Num() > 0)
+    {
+        FillScanNoise(
+            ENoiseStream::ECHO_POSITION, PositionalNoiseMean, PositionalNoiseVariance, 3 * ScanEchoHits.Num(), PositionNoise);
+        for (auto i = 0; i < ScanEchoHits.Num(); ++i)
+        {
+            ScanEchoHits[i].Point += FVector3f(PositionNoise[3 * i], PositionNoise[3 * i + 1], PositionNoise[3 * i + 2]);
+        }
+    }
+}
+
+int64 URRBaseLidarComponent::GetScanBuffersAllocatedSize() const
+{
+    return ScanHits.GetAllocatedSize() + PendingScanHits.GetAllocatedSize() + ScanEchoHits.GetAllocatedSize() +
+           PendingScanEchoHits.GetAllocatedSize() + RecordedHits.GetAllocatedSize() + PendingRecordedHits.GetAllocatedSize();
+}
+
+void URRBaseLidarComponent::InitScanBuffers()
+{
+    LLM_SCOPE_BYTAG(RRLidar);
+    const int32 raysNum = GetRaysNum();
+    ScanHits.Init(FRRLidarHit(), raysNum);
+    if (bRecordHitResults)
+    {
+        RecordedHits.Init(FHitResult(ForceInit), raysNum);
+    }
+    else
+    {
+        RecordedHits.Empty();
+    }
+
+    PendingScanHits.Init(FRRLidarHit(), raysNum);
+    PendingRecordedHits.Init(FHitResult(ForceInit), bRecordHitResults ? raysNum : 0);
+
+    ActiveEchoesNum = FMath::Max(1, GetEchoesNum());
+    ScanEchoHits.Init(FRRLidarHit(), raysNum * (ActiveEchoesNum - 1));
+    PendingScanEchoHits.Init(FRRLidarHit(), raysNum * (ActiveEchoesNum - 1));
+    SweepColumnsDone = -1;
+}
+
+template<ERRLidarTraceConfig TConfig>
+void URRBaseLidarComponent::TraceRayKernel(const int32 InIndex,
+                                           FRRLidarHit& OutHit,
+                                           FHitResult* OutRecordedHit,
+                                           FRRLidarHit* OutEchoHits) const
+{
+    constexpr bool bExclusions = EnumHasAnyFlags(TConfig, ERRLidarTraceConfig::EXCLUSIONS);
+    constexpr bool bRayScene = EnumHasAnyFlags(TConfig, ERRLidarTraceConfig::RAY_SCENE);
+    constexpr bool bEchoes = EnumHasAnyFlags(TConfig, ERRLidarTraceConfig::ECHOES);
+    constexpr bool bRecorded = EnumHasAnyFlags(TConfig, ERRLidarTraceConfig::RECORDED);
+
+    FVector startPos, endPos;
+    GetTraceRay(InIndex, startPos, endPos);
+
+    if constexpr (bExclusions)
+    {
+        if (RayTable->ExcludedRays[InIndex])
+        {
+            OutHit.SetMiss(endPos);
+            if constexpr (bEchoes)
+            {
+                for (int32 e = 0; e < ActiveEchoesNum - 1; ++e)
+                {
+                    OutEchoHits[e].SetMiss(endPos);
+                }
+            }
+            if constexpr (bRecorded)
+            {
+                *OutRecordedHit = FHitResult(ForceInit);
+            }
+            return;
+        }
+    }
+
+    if constexpr (bRayScene)
+    {
+        const FVector3f rayDir(ScanRayDirX[InIndex], ScanRayDirY[InIndex], ScanRayDirZ[InIndex]);
+        ScanRayScene->Raycast(startPos, rayDir, MaxRange - MinRange, ScanIgnoredActorId, OutHit);
+    }
+    else if constexpr (bEchoes)
+    {
+        // Overlapping hits in distance order, followed by the blocking one if any
+        TArray<FHitResult, TInlineAllocator<8>> hits;
+        GetWorld()->LineTraceMultiByChannel(
+            hits, startPos, endPos, ECC_Visibility, TraceParams, FCollisionResponseParams::DefaultResponseParam);
+        if (hits.Num() > 0)
+        {
+            OutHit.SetFromHitResult(hits[0]);
+        }
+        else
+        {
+            OutHit.SetMiss(endPos);
+        }
+        for (int32 e = 0; e < ActiveEchoesNum - 1; ++e)
+        {
+            if (e + 1 < hits.Num())
+            {
+                OutEchoHits[e].SetFromHitResult(hits[e + 1]);
+            }
+            else
+            {
+                OutEchoHits[e].SetMiss(endPos);
+            }
+        }
+        if constexpr (bRecorded)
+        {
+            *OutRecordedHit = (hits.Num() > 0) ? MoveTemp(hits[0]) : FHitResult(ForceInit);
+        }
+    }
+    else
+    {
+        FHitResult hit;
+        GetWorld()->LineTraceSingleByChannel(
+            hit, startPos, endPos, ECC_Visibility, TraceParams, FCollisionResponseParams::DefaultResponseParam);
+        OutHit.SetFromHitResult(hit);
+        if constexpr (bRecorded)
+        {
+            *OutRecordedHit = MoveTemp(hit);
+        }
+    }
+}
+
+namespace
+{
+//! Kernels indexed by their #ERRLidarTraceConfig
+template<uint8... TConfigs>
+TArray<URRBaseLidarComponent::FTraceRayKernel> MakeTraceRayKernels(std::integer_sequence<uint8, TConfigs...>)
+{
+    return {&URRBaseLidarComponent::TraceRayKernel<static_cast<ERRLidarTraceConfig>(TConfigs)>...};
+}
+}    // namespace
+
+URRBaseLidarComponent::FTraceRayKernel URRBaseLidarComponent::GetTraceRayKernel(const bool bInRecorded,
+                                                                                const bool bInEchoes) const
+{
+    static const TArray<FTraceRayKernel> sKernels =
+        MakeTraceRayKernels(std::make_integer_sequence<uint8, static_cast<uint8>(ERRLidarTraceConfig::NUM)>());
+
+    ERRLidarTraceConfig config = ERRLidarTraceConfig::NONE;
+    if (RayTable.IsValid() && (RayTable->ExcludedRaysNum > 0))
+    {
+        config |= ERRLidarTraceConfig::EXCLUSIONS;
+    }
+    if (bInRecorded)
+    {
+        config |= ERRLidarTraceConfig::RECORDED;
+    }
+    if (bInEchoes)
+    {
+        config |= ERRLidarTraceConfig::ECHOES;
+    }
+    else if (!bInRecorded && ScanRayScene.IsValid())
+    {
+        config |= ERRLidarTraceConfig::RAY_SCENE;
+    }
+    return sKernels[static_cast<uint8>(config)];
+}
+
+bool URRBaseLidarComponent::Visible(AActor* TargetActor)
+{
+    return TargetActor && GetVisibleActorIds().Contains(TargetActor->GetUniqueID());
+}
+
+void URRBaseLidarComponent::GetVisibleActors(const TArray<AActor*>& InTargetActors, TArray<bool>& OutVisible)
+{
+    const TSet<uint32>& visibleActorIds = GetVisibleActorIds();
+    OutVisible.SetNumUninitialized(InTargetActors.Num());
+    for (int32 i = 0; i < InTargetActors.Num(); ++i)
+    {
+        OutVisible[i] = InTargetActors[i] && visibleActorIds.Contains(InTargetActors[i]->GetUniqueID());
+    }
+}
+
+const TSet<uint32>& URRBaseLidarComponent::GetVisibleActorIds()
+{
+    if (bVisibilityFromLatestScan)
+    {
+        if (VisibleActorIdsScanTime != TimeOfLastScan)
+        {
+            VisibleActorIdsScanTime = TimeOfLastScan;
+            VisibleActorIdsFrame = MAX_uint64;
+            VisibleActorIds.Reset();
+            for (const auto& h : ScanHits)
+            {
+                if (h.bHit && (h.ActorId != 0))
+                {
+                    VisibleActorIds.Add(h.ActorId);
+                }
+            }
+        }
+        return VisibleActorIds;
+    }
+
+    const FTransform lidarPose = GetComponentTransform();
+    if ((VisibleActorIdsFrame == GFrameCounter) && VisibleActorIdsPose.Equals(lidarPose))
+    {
+        return VisibleActorIds;
+    }
+    VisibleActorIdsFrame = GFrameCounter;
+    VisibleActorIdsPose = lidarPose;
+    VisibleActorIdsScanTime = -1.f;
+
+    if (GetScanPatternHash() != RayDirectionTableHash)
+    {
+        BuildRayDirectionTable();
+    }
+
+    // complex collisions: true
+    FCollisionQueryParams vizTraceParams = FCollisionQueryParams(TEXT("Laser_Trace"), true, GetOwner());
+    vizTraceParams.bTraceComplex = true;
+
+    // Rotate the local directions on the fly, not to overwrite the ones of a scan pending in FRRLidarBatchScheduler
+    const FVector lidarPos = lidarPose.GetLocation();
+    const FQuat lidarQuat = lidarPose.GetRotation();
+    TArray<FRRLidarHit> vizHits;
+    vizHits.SetNum(GetRaysNum());
+    ParallelFor(
+        vizHits.Num(),
+        [this, &vizTraceParams, &lidarPos, &lidarQuat, &vizHits](int32 Index)
+        {
+            const FRRLidarRayTable& rayTable = *RayTable;
+            const FVector rayDir = lidarQuat.RotateVector(
+                FVector(rayTable.LocalRayDirX[Index], rayTable.LocalRayDirY[Index], rayTable.LocalRayDirZ[Index]));
+            if (IsRayExcluded(Index))
+            {
+                vizHits[Index].SetMiss(lidarPos + MaxRange * rayDir);
+                return;
+            }
+            FHitResult hit;
+            GetWorld()->LineTraceSingleByChannel(hit,
+                                                 lidarPos + MinRange * rayDir,
+                                                 lidarPos + MaxRange * rayDir,
+                                                 ECC_Visibility,
+                                                 vizTraceParams,
+                                                 FCollisionResponseParams::DefaultResponseParam);
+            vizHits[Index].SetFromHitResult(hit);
+        },
+        false);
+
+    VisibleActorIds.Reset();
+    for (const auto& h : vizHits)
+    {
+        if (h.bHit)
+        {
+            VisibleActorIds.Add(h.ActorId);
+        }
+    }
+    return VisibleActorIds;
 }
 
 void URRBaseLidarComponent::GetData(TArray<FHitResult>& OutHits, float& OutTime) const
@@ -44,3 +880,68 @@ float URRBaseLidarComponent::GetIntensityFromDist(float InBaseIntensity, float I
     return InBaseIntensity * 1.3f * FMath::Exp(-.1f * (FMath::Pow(3.5f * InDistance, .6f))) /
            (1 + FMath::Exp(-((3.5f * InDistance))));
 }
+
+void URRBaseLidarComponent::UpdateIntensityTable()
+{
+    IntensityTable.Build(IntensityNonReflective, IntensityReflective, GetNoSurfaceIntensity(), SurfaceIntensities);
+    // Read by the traces of the upcoming scan only, none being in flight by now
+    TraceParams.bReturnPhysicalMaterial = IntensityTable.bSurfaceDependent;
+}
+
+bool URRBaseLidarComponent::GetVisualizationIntensity(const FRRLidarHit& InHit, float& OutIntensity) const
+{
+    const float distance = (MinRange * (InHit.Distance > 0) + InHit.Distance) * .01f;
+    float baseIntensity = 0.f;
+    if (!IntensityTable.GetVisualized(InHit.SurfaceType, InHit.NormalAlignment, baseIntensity))
+    {
+        return false;
+    }
+    OutIntensity = GetIntensityFromDist(baseIntensity, distance);
+    return true;
+}
+
+void URRBaseLidarComponent::UpdateVisualization(const bool bInShow)
+{
+    if (!bInShow)
+    {
+        if (VisualizationComponent)
+        {
+            VisualizationComponent->SetVisibility(false);
+        }
+        return;
+    }
+
+    if (nullptr == VisualizationComponent)
+    {
+        VisualizationComponent = NewObject<URRLidarVisualizationComponent>(this);
+        VisualizationComponent->SetupAttachment(this);
+        VisualizationComponent->RegisterComponent();
+    }
+    VisualizationComponent->SetVisibility(true);
+
+    const int32 decimation = FMath::Max(1, VisualizationDecimation);
+    TArray<FRRLidarVizPoint> points;
+    points.Reserve(ScanHits.Num() / decimation + 1);
+    for (auto i = 0; i < ScanHits.Num(); i += decimation)
+    {
+        const FRRLidarHit& h = ScanHits[i];
+        float intensity = 0.f;
+        if (h.bHit && GetVisualizationIntensity(h, intensity))
+        {
+            // this means that viz and data sent won't correspond, which should be ok
+            const float value = FMath::GetRangePct(IntensityMin, IntensityMax, intensity) + BWithNoise * GaussianRNGIntensity(Gen);
+            points.Add({h.Point, value});
+        }
+        else if (!h.bHit && ShowLidarRayMisses)
+        {
+            points.Add({h.Point, FRRLidarVizPoint::MISS});
+        }
+    }
+
+    FRRLidarVizStyle style;
+    style.ColorMin = ColorMin;
+    style.ColorMid = ColorMid;
+    style.ColorMax = ColorMax;
+    style.ColorMiss = ColorMiss;
+    VisualizationComponent->SetPoints(MoveTemp(points), style);
+}
@@ -2,6 +2,9 @@
 
 #include "Sensors/RRBaseOdomComponent.h"
 
+// RapyutaSimulationPlugins
+#include "Drives/RRDriveTickManager.h"
+
 URRBaseOdomComponent::URRBaseOdomComponent()
 {
     SensorPublisherClass = URRROS2OdomPublisher::StaticClass();
@@ -10,16 +13,56 @@ URRBaseOdomComponent::URRBaseOdomComponent()
     FrameId = TEXT("odom");    //default frame id
 }
 
+void URRBaseOdomComponent::BeginPlay()
+{
+    Super::BeginPlay();
+    if (bAggregatedTick)
+    {
+        FRRDriveTickManager::Get(GetWorld()).AddComponent(this, &URRBaseOdomComponent::UpdatePendingOdom);
+    }
+}
+
+void URRBaseOdomComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (bAggregatedTick)
+    {
+        FRRDriveTickManager::Get(GetWorld()).RemoveComponent(this);
+    }
+    Super::EndPlay(EndPlayReason);
+}
+
 void URRBaseOdomComponent::SensorUpdate()
 {
     if (!bManualUpdate)
     {
-        float currentTime = UGameplayStatics::GetTimeSeconds(GetWorld());
-        UpdateOdom(currentTime - LastUpdatedTime);
+        const float currentTime = GetWorld()->GetTimeSeconds();
+        if (bAggregatedTick)
+        {
+            // Initialized on game thread, then updated in parallel with all other odoms
+            if (!bIsOdomInitialized)
+            {
+                InitOdom();
+            }
+            PendingOdomDeltaTime += currentTime - LastUpdatedTime;
+        }
+        else
+        {
+            UpdateOdom(currentTime - LastUpdatedTime);
+        }
         LastUpdatedTime = currentTime;
     }
 }
 
+void URRBaseOdomComponent::UpdatePendingOdom(UActorComponent* InComponent)
+{
+    URRBaseOdomComponent* odomComp = static_cast<URRBaseOdomComponent*>(InComponent);
+    if (odomComp->PendingOdomDeltaTime > 0.f)
+    {
+        odomComp->UpdateOdom(odomComp->PendingOdomDeltaTime);
+        odomComp->PendingOdomDeltaTime = 0.f;
+    }
+}
+
 void URRBaseOdomComponent::PreInitializePublisher(UROS2NodeComponent* InROS2Node, const FString& InTopicName)
 {
     Super::PreInitializePublisher(InROS2Node, InTopicName);
@@ -40,8 +83,7 @@ void URRBaseOdomComponent::SetFrameIds(const FString& InFrameId, const FString&
 // todo separate ROS
 void URRBaseOdomComponent::InitOdom()
 {
-    GaussianRNGPosition = std::normal_distribution<>{NoiseMeanPos, NoiseVariancePos};
-    GaussianRNGRotation = std::normal_distribution<>{NoiseMeanRot, NoiseVarianceRot};
+    NoiseStream.Reset(FRRNoiseUtils::MakeKey(FRRNoiseUtils::GetSensorSeed(NoiseSeed, GetPathName()), 0));
 
     AActor* owner = GetOwner();
     OdomData.Header.FrameId = FrameId;
@@ -58,6 +100,7 @@ void URRBaseOdomComponent::InitOdom()
         InitialTransform.SetRotation(FQuat::Identity);
     }
 
+    InitialRotationInverse = InitialTransform.GetRotation().Inverse();
     OdomData.Pose.Pose.Position = InitialTransform.GetTranslation();
     OdomData.Pose.Pose.Orientation = InitialTransform.GetRotation();
 
@@ -80,7 +123,7 @@ void URRBaseOdomComponent::InitOdom()
     OdomData.Twist.Covariance[35] = 1e-03f;
 
     bIsOdomInitialized = true;
-    LastUpdatedTime = UGameplayStatics::GetTimeSeconds(GetWorld());
+    LastUpdatedTime = GetWorld()->GetTimeSeconds();
 }
 
 void URRBaseOdomComponent::UpdateOdom(float InDeltaTime)
@@ -96,7 +139,7 @@ void URRBaseOdomComponent::UpdateOdom(float InDeltaTime)
     }
 
     // time
-    OdomData.Header.Stamp = URRConversionUtils::FloatToROSStamp(UGameplayStatics::GetTimeSeconds(GetWorld()));
+    OdomData.Header.Stamp = URRConversionUtils::GetCurrentROS2Time(this);
 
     // previous estimated data (with noise)
     FVector previousEstimatedPos = PreviousNoisyTransform.GetTranslation();
@@ -105,13 +148,19 @@ void URRBaseOdomComponent::UpdateOdom(float InDeltaTime)
     AActor* owner = GetOwner();
 
     // position
-    FVector pos = InitialTransform.GetRotation().UnrotateVector(owner->GetActorLocation() - InitialTransform.GetTranslation());
+    FVector pos = InitialRotationInverse.RotateVector(owner->GetActorLocation() - InitialTransform.GetTranslation());
     FVector previousPos = PreviousTransform.GetTranslation();    // prev pos without noise
     PreviousTransform.SetTranslation(pos);
-    pos += previousEstimatedPos - previousPos + bWithNoise * FVector(GaussianRNGPosition(Gen), GaussianRNGPosition(Gen), 0);
+    if (bWithNoise)
+    {
+        const float noiseX = NoiseStream.NextGaussian(NoiseMeanPos, NoiseVariancePos);
+        const float noiseY = NoiseStream.NextGaussian(NoiseMeanPos, NoiseVariancePos);
+        pos += FVector(noiseX, noiseY, 0);
+    }
+    pos += previousEstimatedPos - previousPos;
 
-    FRotator noiseRot = FRotator(0, 0, bWithNoise * GaussianRNGRotation(Gen));
-    FQuat rot = owner->GetActorQuat() * InitialTransform.GetRotation().Inverse();
+    FRotator noiseRot = FRotator(0, 0, bWithNoise ? NoiseStream.NextGaussian(NoiseMeanRot, NoiseVarianceRot) : 0.f);
+    FQuat rot = owner->GetActorQuat() * InitialRotationInverse;
     FQuat previousRot = PreviousTransform.GetRotation();
     PreviousTransform.SetRotation(rot);
     rot = noiseRot.Quaternion() * previousEstimatedRot * previousRot.Inverse() * rot;
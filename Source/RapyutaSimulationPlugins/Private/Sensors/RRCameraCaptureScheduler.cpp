@@ -0,0 +1,151 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Sensors/RRCameraCaptureScheduler.h"
+
+// UE
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRMathUtils.h"
+#include "Core/RRTrace.h"
+#include "Sensors/RRROS2CameraComponent.h"
+
+static TAutoConsoleVariable<float> CVarCameraCaptureGPUBudgetMs(
+    TEXT("rr.CameraCapture.GPUBudgetMs"),
+    0.f,
+    TEXT("[ms] Per-frame GPU budget of the captures served by FRRCameraCaptureScheduler, 0 for unlimited."),
+    ECVF_Default);
+
+TMap<UWorld*, TUniquePtr<FRRCameraCaptureScheduler>> FRRCameraCaptureScheduler::SSchedulers;
+std::once_flag FRRCameraCaptureScheduler::OnceFlag;
+
+FRRCameraCaptureScheduler& FRRCameraCaptureScheduler::Get(UWorld* InWorld)
+{
+    check(IsInGameThread());
+    std::call_once(OnceFlag,
+                   []()
+                   {
+                       FWorldDelegates::OnWorldPostActorTick.AddStatic(&FRRCameraCaptureScheduler::OnWorldPostActorTick);
+                       FWorldDelegates::OnPostWorldCleanup.AddStatic(&FRRCameraCaptureScheduler::OnPostWorldCleanup);
+                   });
+
+    TUniquePtr<FRRCameraCaptureScheduler>& scheduler = SSchedulers.FindOrAdd(InWorld);
+    if (!scheduler.IsValid())
+    {
+        scheduler = MakeUnique<FRRCameraCaptureScheduler>();
+    }
+    return *scheduler;
+}
+
+void FRRCameraCaptureScheduler::OnWorldPostActorTick(UWorld* InWorld, ELevelTick /*InTickType*/, float /*InDeltaSeconds*/)
+{
+    if (TUniquePtr<FRRCameraCaptureScheduler>* scheduler = SSchedulers.Find(InWorld))
+    {
+        (*scheduler)->Flush();
+    }
+}
+
+void FRRCameraCaptureScheduler::OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/)
+{
+    SSchedulers.Remove(InWorld);
+}
+
+float FRRCameraCaptureScheduler::AddCamera(URRROS2CameraComponent* InCamera)
+{
+    Cameras.RemoveAll([](const TWeakObjectPtr<URRROS2CameraComponent>& InCameraPtr) { return !InCameraPtr.IsValid(); });
+    int32 index = Cameras.Find(InCamera);
+    if (INDEX_NONE == index)
+    {
+        index = Cameras.Add(InCamera);
+    }
+
+    return URRMathUtils::GetSpreadPhase(static_cast<uint32>(index));
+}
+
+void FRRCameraCaptureScheduler::RemoveCamera(URRROS2CameraComponent* InCamera)
+{
+    Cameras.Remove(InCamera);
+    PendingRequests.RemoveAll([InCamera](const FCaptureRequest& InRequest) { return InRequest.Camera == InCamera; });
+}
+
+void FRRCameraCaptureScheduler::RequestCapture(URRROS2CameraComponent* InCamera)
+{
+    if (!PendingRequests.ContainsByPredicate([InCamera](const FCaptureRequest& InRequest) { return InRequest.Camera == InCamera; }))
+    {
+        PendingRequests.Add({InCamera, GFrameCounter});
+    }
+}
+
+void FRRCameraCaptureScheduler::Flush()
+{
+    PendingRequests.RemoveAll([](const FCaptureRequest& InRequest) { return !InRequest.Camera.IsValid(); });
+    if (PendingRequests.Num() == 0)
+    {
+        return;
+    }
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRCameraCaptureBatch", RRSensorChannel);
+
+    // 1- Serve by priority, then the longest waiting first
+    PendingRequests.StableSort(
+        [](const FCaptureRequest& InA, const FCaptureRequest& InB)
+        {
+            const int32 priorityA = InA.Camera->CapturePriority;
+            const int32 priorityB = InB.Camera->CapturePriority;
+            return (priorityA != priorityB) ? (priorityA > priorityB) : (InA.RequestFrame < InB.RequestFrame);
+        });
+
+    // 2- Capture within the budget, at least one per frame not to starve any camera
+    const float budgetMs = CVarCameraCaptureGPUBudgetMs.GetValueOnGameThread();
+    float spentMs = 0.f;
+    int32 servedNum = 0;
+    TArray<URRROS2CameraComponent::FReadbackCopy> copies;
+    TArray<URRROS2CameraComponent::FReadbackPoll> polls;
+    copies.Reserve(PendingRequests.Num());
+    polls.Reserve(PendingRequests.Num());
+    for (const auto& request : PendingRequests)
+    {
+        URRROS2CameraComponent* camera = request.Camera.Get();
+        if ((budgetMs > 0.f) && (servedNum > 0) && (spentMs + camera->CaptureCostMs > budgetMs))
+        {
+            break;
+        }
+        spentMs += camera->CaptureCostMs;
+        ++servedNum;
+
+        if (camera->IsAtlasLeader())
+        {
+            camera->CaptureAtlas(copies, polls);
+            continue;
+        }
+        camera->CaptureScenes();
+        polls.Add(camera->MakeReadbackPoll());
+        URRROS2CameraComponent::FReadbackCopy copy;
+        if (camera->BeginReadback(copy))
+        {
+            copies.Add(copy);
+        }
+    }
+
+    // 3- Deferred requests keep their request frame, thus are served first amongst their priority next frame
+    for (int32 i = servedNum; i < PendingRequests.Num(); ++i)
+    {
+        ++PendingRequests[i].Camera->DeferredFramesNum;
+    }
+    PendingRequests.RemoveAt(0, servedNum, false);
+
+    // 4- Poll the previous readbacks & copy the new captures of all served cameras in a single render command
+    ENQUEUE_RENDER_COMMAND(ScheduledCameraReadbacks)
+    (
+        [polls = MoveTemp(polls), copies = MoveTemp(copies)](FRHICommandListImmediate& RHICmdList)
+        {
+            for (const auto& poll : polls)
+            {
+                URRROS2CameraComponent::PollReadbacks_RenderThread(poll);
+            }
+            for (const auto& copy : copies)
+            {
+                URRROS2CameraComponent::EnqueueReadbackCopy_RenderThread(RHICmdList, copy);
+            }
+        });
+}
@@ -0,0 +1,115 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Sensors/RRContactManager.h"
+
+// UE
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "EventManager.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+#include "PBDRigidsSolver.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRTrace.h"
+#include "Sensors/RRROS2ContactSensorComponent.h"
+
+TMap<UWorld*, TUniquePtr<FRRContactManager>> FRRContactManager::SManagers;
+std::once_flag FRRContactManager::OnceFlag;
+
+FRRContactManager::~FRRContactManager()
+{
+    UWorld* world = World.Get();
+    FPhysScene* physScene = world ? world->GetPhysicsScene() : nullptr;
+    if (physScene && physScene->GetSolver())
+    {
+        physScene->GetSolver()->GetEventManager()->UnregisterHandler(Chaos::EEventType::Collision, this);
+    }
+}
+
+FRRContactManager* FRRContactManager::Get(UWorld* InWorld)
+{
+    check(IsInGameThread());
+    std::call_once(OnceFlag, []() { FWorldDelegates::OnPostWorldCleanup.AddStatic(&FRRContactManager::OnPostWorldCleanup); });
+
+    FPhysScene* physScene = InWorld ? InWorld->GetPhysicsScene() : nullptr;
+    if ((nullptr == physScene) || (nullptr == physScene->GetSolver()))
+    {
+        return nullptr;
+    }
+
+    TUniquePtr<FRRContactManager>& manager = SManagers.FindOrAdd(InWorld);
+    if (!manager.IsValid())
+    {
+        manager = MakeUnique<FRRContactManager>();
+        manager->World = InWorld;
+        Chaos::FPBDRigidsSolver* solver = physScene->GetSolver();
+        solver->SetGenerateCollisionData(true);
+        solver->GetEventManager()->RegisterHandler<Chaos::FCollisionEventData>(
+            Chaos::EEventType::Collision, manager.Get(), &FRRContactManager::HandleCollisionEvents);
+    }
+    return manager.Get();
+}
+
+void FRRContactManager::OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/)
+{
+    SManagers.Remove(InWorld);
+}
+
+void FRRContactManager::AddBody(UPrimitiveComponent* InBody, URRROS2ContactSensorComponent* InSensor)
+{
+    check(IsInGameThread());
+    // Collision data is only generated for bodies notifying rigid body collisions
+    InBody->SetNotifyRigidBodyCollision(true);
+    BodySensors.Add(InBody, InSensor);
+}
+
+void FRRContactManager::RemoveSensor(const URRROS2ContactSensorComponent* InSensor)
+{
+    check(IsInGameThread());
+    for (auto it = BodySensors.CreateIterator(); it; ++it)
+    {
+        if (!it.Value().IsValid() || (it.Value().Get() == InSensor))
+        {
+            it.RemoveCurrent();
+        }
+    }
+}
+
+void FRRContactManager::HandleCollisionEvents(const Chaos::FCollisionEventData& InEvent)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRHandleContacts", RRSensorChannel);
+    UWorld* world = World.Get();
+    FPhysScene* physScene = world ? world->GetPhysicsScene() : nullptr;
+    if ((nullptr == physScene) || (BodySensors.Num() == 0))
+    {
+        return;
+    }
+
+    for (const Chaos::FCollidingData& collision : InEvent.CollisionData.AllCollisionsArray)
+    {
+        UPrimitiveComponent* body1 = physScene->GetOwningComponent<UPrimitiveComponent>(collision.Proxy1);
+        UPrimitiveComponent* body2 = physScene->GetOwningComponent<UPrimitiveComponent>(collision.Proxy2);
+        if ((nullptr == body1) || (nullptr == body2))
+        {
+            continue;
+        }
+
+        // Either body may be a sensor's, with the contact seen from its side
+        auto bucketContact = [&](UPrimitiveComponent* InBody, UPrimitiveComponent* InOtherBody, const float InSign)
+        {
+            const TWeakObjectPtr<URRROS2ContactSensorComponent>* sensor = BodySensors.Find(InBody);
+            if (sensor && sensor->IsValid())
+            {
+                FRRContact& contact = (*sensor)->PendingContacts.AddDefaulted_GetRef();
+                contact.Body = InBody;
+                contact.OtherBody = InOtherBody;
+                contact.Location = collision.Location;
+                contact.Normal = InSign * collision.Normal;
+                contact.Impulse = InSign * collision.AccumulatedImpulse;
+                contact.PenetrationDepth = collision.PenetrationDepth;
+            }
+        };
+        bucketContact(body1, body2, 1.f);
+        bucketContact(body2, body1, -1.f);
+    }
+}
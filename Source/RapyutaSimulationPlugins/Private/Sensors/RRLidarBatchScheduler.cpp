@@ -0,0 +1,98 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Sensors/RRLidarBatchScheduler.h"
+
+// UE
+#include "Algo/BinarySearch.h"
+#include "Async/ParallelFor.h"
+#include "Engine/World.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRTrace.h"
+#include "Sensors/RRBaseLidarComponent.h"
+
+TMap<UWorld*, TUniquePtr<FRRLidarBatchScheduler>> FRRLidarBatchScheduler::SSchedulers;
+std::once_flag FRRLidarBatchScheduler::OnceFlag;
+
+FRRLidarBatchScheduler& FRRLidarBatchScheduler::Get(UWorld* InWorld)
+{
+    check(IsInGameThread());
+    std::call_once(OnceFlag,
+                   []()
+                   {
+                       FWorldDelegates::OnWorldPostActorTick.AddStatic(&FRRLidarBatchScheduler::OnWorldPostActorTick);
+                       FWorldDelegates::OnPostWorldCleanup.AddStatic(&FRRLidarBatchScheduler::OnPostWorldCleanup);
+                   });
+
+    TUniquePtr<FRRLidarBatchScheduler>& scheduler = SSchedulers.FindOrAdd(InWorld);
+    if (!scheduler.IsValid())
+    {
+        scheduler = MakeUnique<FRRLidarBatchScheduler>();
+    }
+    return *scheduler;
+}
+
+void FRRLidarBatchScheduler::OnWorldPostActorTick(UWorld* InWorld, ELevelTick /*InTickType*/, float /*InDeltaSeconds*/)
+{
+    if (TUniquePtr<FRRLidarBatchScheduler>* scheduler = SSchedulers.Find(InWorld))
+    {
+        (*scheduler)->Flush();
+    }
+}
+
+void FRRLidarBatchScheduler::OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/)
+{
+    SSchedulers.Remove(InWorld);
+}
+
+void FRRLidarBatchScheduler::AddScan(URRBaseLidarComponent* InLidar)
+{
+    PendingLidars.AddUnique(InLidar);
+}
+
+void FRRLidarBatchScheduler::RemoveScan(URRBaseLidarComponent* InLidar)
+{
+    PendingLidars.Remove(InLidar);
+}
+
+void FRRLidarBatchScheduler::Flush()
+{
+    if (PendingLidars.Num() == 0)
+    {
+        TRACE_COUNTER_SET(RRLidarActiveRays, 0);
+        return;
+    }
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRLidarBatchTrace", RRSensorChannel);
+
+    // 1- Gather due lidars & their rays offsets in the batch
+    TArray<URRBaseLidarComponent*> lidars;
+    lidars.Reserve(PendingLidars.Num());
+    RayOffsets.Reset(PendingLidars.Num() + 1);
+    RayOffsets.Add(0);
+    for (const auto& pendingLidar : PendingLidars)
+    {
+        URRBaseLidarComponent* lidar = pendingLidar.Get();
+        if (IsValid(lidar) && (lidar->ScanHits.Num() > 0))
+        {
+            lidars.Add(lidar);
+            RayOffsets.Add(RayOffsets.Last() + lidar->ScanHits.Num());
+        }
+    }
+    PendingLidars.Reset();
+    TRACE_COUNTER_SET(RRLidarActiveRays, RayOffsets.Last());
+
+    // 2- Trace all rays of all lidars at once
+    ParallelFor(RayOffsets.Last(),
+                [this, &lidars](int32 InRayIndex)
+                {
+                    // Index of the last offset <= InRayIndex
+                    const int32 lidarIndex = Algo::UpperBound(RayOffsets, InRayIndex) - 1;
+                    lidars[lidarIndex]->TraceRay(InRayIndex - RayOffsets[lidarIndex]);
+                });
+
+    // 3- Post-process each scan (noise, timestamp, visualization) on game thread
+    for (auto* lidar : lidars)
+    {
+        lidar->OnScanTraced();
+    }
+}
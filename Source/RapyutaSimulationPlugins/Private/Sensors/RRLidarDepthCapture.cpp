@@ -0,0 +1,135 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Sensors/RRLidarDepthCapture.h"
+
+// UE
+#include "Async/ParallelFor.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+
+// RapyutaSimulationPlugins
+#include "Sensors/RRBaseLidarComponent.h"
+
+void FRRLidarDepthCaptureLayout::Build(const float InStartAngle,
+                                       const float InFOVHorizontal,
+                                       const float InStartVerticalAngle,
+                                       const float InFOVVertical,
+                                       const int32 InWidth,
+                                       const float* InDirX,
+                                       const float* InDirY,
+                                       const float* InDirZ,
+                                       const int32 InRaysNum)
+{
+    static constexpr float MAX_ELEVATION = 85.f;
+
+    FacesNum = FMath::Max(1, FMath::CeilToInt32(InFOVHorizontal / MAX_FACE_FOV - KINDA_SMALL_NUMBER));
+    FaceFOV = InFOVHorizontal / FacesNum;
+    FaceYaws.SetNumUninitialized(FacesNum);
+    for (int32 i = 0; i < FacesNum; ++i)
+    {
+        FaceYaws[i] = InStartAngle + FaceFOV * (i + .5f);
+    }
+
+    // The vertical FOV must be covered up to the face horizontal edges, where it is the narrowest
+    const float halfFaceFOVRad = FMath::DegreesToRadians(.5f * FaceFOV);
+    const float minElevation = FMath::Clamp(InStartVerticalAngle, -MAX_ELEVATION, MAX_ELEVATION);
+    const float maxElevation = FMath::Clamp(InStartVerticalAngle + InFOVVertical, -MAX_ELEVATION, MAX_ELEVATION);
+    TanHalfFOVH = FMath::Tan(halfFaceFOVRad);
+    TanHalfFOVV = FMath::Max(FMath::Abs(FMath::Tan(FMath::DegreesToRadians(minElevation))),
+                             FMath::Abs(FMath::Tan(FMath::DegreesToRadians(maxElevation)))) /
+                  FMath::Cos(halfFaceFOVRad);
+    TanHalfFOVV = FMath::Max(TanHalfFOVV, KINDA_SMALL_NUMBER);
+    Width = FMath::Max(InWidth, 1);
+    Height = FMath::Clamp(FMath::CeilToInt32(Width * TanHalfFOVV / TanHalfFOVH), 1, 8192);
+
+    RaySamples.SetNum(InRaysNum);
+    for (int32 i = 0; i < InRaysNum; ++i)
+    {
+        FRaySample& sample = RaySamples[i];
+        sample = FRaySample();
+
+        const float azimuth = FMath::RadiansToDegrees(FMath::Atan2(InDirY[i], InDirX[i]));
+        const int32 face =
+            FMath::Clamp(FMath::FloorToInt32(FRotator::ClampAxis(azimuth - InStartAngle) / FaceFOV), 0, FacesNum - 1);
+
+        // Into face space: x forward, y right, z up
+        float sinYaw, cosYaw;
+        FMath::SinCos(&sinYaw, &cosYaw, FMath::DegreesToRadians(FaceYaws[face]));
+        const float fx = InDirX[i] * cosYaw + InDirY[i] * sinYaw;
+        const float fy = -InDirX[i] * sinYaw + InDirY[i] * cosYaw;
+        const float fz = InDirZ[i];
+        if (fx <= KINDA_SMALL_NUMBER)
+        {
+            continue;
+        }
+        const float ndcX = fy / fx / TanHalfFOVH;
+        const float ndcY = fz / fx / TanHalfFOVV;
+        if ((FMath::Abs(ndcX) > 1.f + KINDA_SMALL_NUMBER) || (FMath::Abs(ndcY) > 1.f + KINDA_SMALL_NUMBER))
+        {
+            continue;
+        }
+
+        sample.Face = face;
+        sample.PixelX = FMath::Clamp(FMath::FloorToInt32((.5f + .5f * ndcX) * Width), 0, Width - 1);
+        sample.PixelY = FMath::Clamp(FMath::FloorToInt32((.5f - .5f * ndcY) * Height), 0, Height - 1);
+        sample.InvForward = 1.f / fx;
+    }
+}
+
+void FRRLidarDepthCaptureLayout::Resample(const TArray<TArray<FLinearColor>>& InDepth,
+                                          const TArray<TArray<FLinearColor>>& InSurfaceClass,
+                                          const float InMinRange,
+                                          const float InMaxRange,
+                                          const FVector& InLidarPos,
+                                          const float* InDirX,
+                                          const float* InDirY,
+                                          const float* InDirZ,
+                                          TArray<FRRLidarHit>& OutHits) const
+{
+    check(OutHits.Num() == RaySamples.Num());
+    const bool bWithSurfaceClass = (InSurfaceClass.Num() == FacesNum);
+    ParallelFor(
+        RaySamples.Num(),
+        [&](int32 InIndex)
+        {
+            const FRaySample& sample = RaySamples[InIndex];
+            const FVector rayDir(InDirX[InIndex], InDirY[InIndex], InDirZ[InIndex]);
+            FRRLidarHit& hit = OutHits[InIndex];
+            const TArray<FLinearColor>* depth = (sample.Face != INDEX_NONE) ? &InDepth[sample.Face] : nullptr;
+            if ((nullptr == depth) || (depth->Num() != Width * Height))
+            {
+                hit.SetMiss(InLidarPos + InMaxRange * rayDir);
+                return;
+            }
+
+            auto getDepth = [this, depth](const int32 InX, const int32 InY) { return (*depth)[InY * Width + InX].R; };
+            const float viewDepth = getDepth(sample.PixelX, sample.PixelY);
+            const float range = viewDepth * sample.InvForward;
+            if ((range < InMinRange) || (range >= InMaxRange))
+            {
+                hit.SetMiss(InLidarPos + InMaxRange * rayDir);
+                return;
+            }
+
+            hit = FRRLidarHit();
+            hit.bHit = true;
+            hit.Point = FVector3f(InLidarPos + range * rayDir);
+            // Line traces start at min range
+            hit.Distance = range - InMinRange;
+            hit.SurfaceType =
+                bWithSurfaceClass
+                    ? static_cast<uint8>(FMath::Clamp(
+                          FMath::RoundToInt32(InSurfaceClass[sample.Face][sample.PixelY * Width + sample.PixelX].R), 0, 63))
+                    : static_cast<uint8>(EPhysicalSurface::SurfaceType_Default);
+
+            // Surface normal from the depth gradient, toward the neighbours inside the face
+            const int32 dx = (sample.PixelX + 1 < Width) ? 1 : -1;
+            const int32 dy = (sample.PixelY + 1 < Height) ? 1 : -1;
+            const FVector3f p0 = GetFacePoint(sample.PixelX, sample.PixelY, viewDepth);
+            const FVector3f px =
+                GetFacePoint(sample.PixelX + dx, sample.PixelY, getDepth(sample.PixelX + dx, sample.PixelY));
+            const FVector3f py =
+                GetFacePoint(sample.PixelX, sample.PixelY + dy, getDepth(sample.PixelX, sample.PixelY + dy));
+            const FVector3f normal = FVector3f::CrossProduct(px - p0, py - p0).GetSafeNormal();
+            hit.NormalAlignment = FMath::Abs(FVector3f::DotProduct(normal, p0.GetSafeNormal()));
+        });
+}
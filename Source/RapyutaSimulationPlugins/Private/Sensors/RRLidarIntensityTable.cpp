@@ -0,0 +1,103 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Sensors/RRLidarIntensityTable.h"
+
+// RapyutaSimulationPlugins
+#include "Sensors/RRBaseLidarComponent.h"
+
+void FRRLidarIntensityTable::Build(const float InNonReflective,
+                                   const float InReflective,
+                                   const float InNoSurfaceIntensity,
+                                   const TMap<TEnumAsByte<EPhysicalSurface>, FRRLidarSurfaceIntensity>& InSurfaces)
+{
+    for (int32 i = 0; i < SIZE; ++i)
+    {
+        Diffuse[i] = 0.f;
+        Specular[i] = 0.f;
+        VisualizedDiffuse[i] = std::numeric_limits<float>::quiet_NaN();
+    }
+    auto setEntry = [this](const int32 InSurfaceType, const float InDiffuse, const float InSpecular, const bool bInVisualized)
+    {
+        Diffuse[InSurfaceType] = InDiffuse;
+        Specular[InSurfaceType] = InSpecular;
+        VisualizedDiffuse[InSurfaceType] = bInVisualized ? InDiffuse : std::numeric_limits<float>::quiet_NaN();
+    };
+
+    // non-reflective material
+    setEntry(EPhysicalSurface::SurfaceType_Default, InNonReflective, 0.f, true);
+    // retroreflective material
+    setEntry(EPhysicalSurface::SurfaceType1, InReflective, 0.f, true);
+    // reflective material, the normal alignment being in [0, 1]
+    setEntry(EPhysicalSurface::SurfaceType2, InNonReflective, InReflective - InNonReflective, true);
+    for (const auto& surface : InSurfaces)
+    {
+        setEntry(surface.Key.GetValue(), surface.Value.Diffuse, surface.Value.Specular, surface.Value.bVisualized);
+    }
+
+    // no physics material
+    Diffuse[FRRLidarHit::SURFACE_TYPE_NONE] = InNoSurfaceIntensity;
+    Specular[FRRLidarHit::SURFACE_TYPE_NONE] = 0.f;
+    VisualizedDiffuse[FRRLidarHit::SURFACE_TYPE_NONE] = InNonReflective;
+
+    // Bitwise, as NaNs are valid intensities
+    bSurfaceDependent = false;
+    constexpr uint8 none = FRRLidarHit::SURFACE_TYPE_NONE;
+    for (int32 i = 0; (i < SIZE) && !bSurfaceDependent; ++i)
+    {
+        bSurfaceDependent = (FMemory::Memcmp(&Diffuse[i], &Diffuse[none], sizeof(float)) != 0) ||
+                            (FMemory::Memcmp(&Specular[i], &Specular[none], sizeof(float)) != 0) ||
+                            (FMemory::Memcmp(&VisualizedDiffuse[i], &VisualizedDiffuse[none], sizeof(float)) != 0);
+    }
+}
+
+void FRRLidarIntensityTable::Evaluate(const FRRLidarHit* InHits,
+                                      const int32 InHitsStride,
+                                      const float* InNoise,
+                                      const int32 InNum,
+                                      float* OutIntensities) const
+{
+    float specular[CHUNK_SIZE];
+    float alignment[CHUNK_SIZE];
+    for (int32 start = 0; start < InNum; start += CHUNK_SIZE)
+    {
+        const int32 num = FMath::Min(CHUNK_SIZE, InNum - start);
+        float* const out = OutIntensities + start;
+        // Gather
+        for (int32 i = 0; i < num; ++i)
+        {
+            const FRRLidarHit& hit = InHits[(start + i) * InHitsStride];
+            out[i] = Diffuse[hit.SurfaceType];
+            specular[i] = Specular[hit.SurfaceType];
+            alignment[i] = hit.NormalAlignment;
+        }
+        for (int32 i = 0; i < num; ++i)
+        {
+            out[i] += specular[i] * FMath::Clamp(alignment[i], 0.f, 1.f);
+        }
+        if (InNoise)
+        {
+            const float* const noise = InNoise + start;
+            for (int32 i = 0; i < num; ++i)
+            {
+                out[i] *= 1.f + noise[i];
+            }
+        }
+    }
+}
+
+bool FRRLidarIntensityTable::GetVisualized(const uint8 InSurfaceType, const float InNormalAlignment, float& OutIntensity) const
+{
+    const float diffuse = VisualizedDiffuse[InSurfaceType];
+    if (FMath::IsNaN(diffuse))
+    {
+        return false;
+    }
+    float normalAlignment = InNormalAlignment;
+    normalAlignment *= normalAlignment;
+    normalAlignment *= normalAlignment;
+    normalAlignment *= normalAlignment;
+    normalAlignment *= normalAlignment;
+    normalAlignment *= normalAlignment;    // pow 32
+    OutIntensity = diffuse + normalAlignment * Specular[InSurfaceType];
+    return true;
+}
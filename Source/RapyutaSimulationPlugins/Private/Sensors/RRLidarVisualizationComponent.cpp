@@ -0,0 +1,131 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Sensors/RRLidarVisualizationComponent.h"
+
+// UE
+#include "PrimitiveSceneProxy.h"
+#include "SceneManagement.h"
+
+/**
+ * @brief Scene proxy of #URRLidarVisualizationComponent, owning the colored points of the latest scan
+ */
+class FRRLidarVisualizationSceneProxy final : public FPrimitiveSceneProxy
+{
+public:
+    FRRLidarVisualizationSceneProxy(const URRLidarVisualizationComponent* InComponent) : FPrimitiveSceneProxy(InComponent)
+    {
+        bWillEverBeLit = false;
+    }
+
+    SIZE_T GetTypeHash() const override
+    {
+        static size_t UniquePointer;
+        return reinterpret_cast<size_t>(&UniquePointer);
+    }
+
+    void SetPoints_RenderThread(TArray<FRRLidarVizPoint>&& InPoints, const FRRLidarVizStyle& InStyle)
+    {
+        check(IsInRenderingThread());
+        Positions.SetNumUninitialized(InPoints.Num());
+        Colors.SetNumUninitialized(InPoints.Num());
+        Sizes.SetNumUninitialized(InPoints.Num());
+        for (int32 i = 0; i < InPoints.Num(); ++i)
+        {
+            const FRRLidarVizPoint& point = InPoints[i];
+            const bool bMiss = (point.Value == FRRLidarVizPoint::MISS);
+            Positions[i] = FVector(point.Position);
+            Colors[i] = bMiss ? InStyle.ColorMiss : InStyle.GetColor(point.Value);
+            Sizes[i] = bMiss ? InStyle.MissPointSize : InStyle.HitPointSize;
+        }
+    }
+
+    virtual void GetDynamicMeshElements(const TArray<const FSceneView*>& Views,
+                                        const FSceneViewFamily& ViewFamily,
+                                        uint32 VisibilityMap,
+                                        FMeshElementCollector& Collector) const override
+    {
+        for (int32 viewIndex = 0; viewIndex < Views.Num(); ++viewIndex)
+        {
+            if (VisibilityMap & (1 << viewIndex))
+            {
+                FPrimitiveDrawInterface* PDI = Collector.GetPDI(viewIndex);
+                for (int32 i = 0; i < Positions.Num(); ++i)
+                {
+                    PDI->DrawPoint(Positions[i], Colors[i], Sizes[i], SDPG_World);
+                }
+            }
+        }
+    }
+
+    virtual FPrimitiveViewRelevance GetViewRelevance(const FSceneView* View) const override
+    {
+        FPrimitiveViewRelevance result;
+        result.bDrawRelevance = IsShown(View);
+        result.bDynamicRelevance = true;
+        result.bShadowRelevance = false;
+        result.bEditorPrimitiveRelevance = UseEditorCompositing(View);
+        return result;
+    }
+
+    virtual uint32 GetMemoryFootprint() const override
+    {
+        return sizeof(*this) + GetAllocatedSize();
+    }
+
+    uint32 GetAllocatedSize() const
+    {
+        return FPrimitiveSceneProxy::GetAllocatedSize() + Positions.GetAllocatedSize() + Colors.GetAllocatedSize() +
+               Sizes.GetAllocatedSize();
+    }
+
+private:
+    TArray<FVector> Positions;
+    TArray<FLinearColor> Colors;
+    TArray<float> Sizes;
+};
+
+URRLidarVisualizationComponent::URRLidarVisualizationComponent()
+{
+    PrimaryComponentTick.bCanEverTick = false;
+    SetUsingAbsoluteLocation(true);
+    SetUsingAbsoluteRotation(true);
+    SetUsingAbsoluteScale(true);
+    SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    SetGenerateOverlapEvents(false);
+    CastShadow = false;
+    bSelectable = false;
+}
+
+void URRLidarVisualizationComponent::SetPoints(TArray<FRRLidarVizPoint>&& InPoints, const FRRLidarVizStyle& InStyle)
+{
+    PointsBounds = FBox(ForceInit);
+    for (const auto& point : InPoints)
+    {
+        PointsBounds += FVector(point.Position);
+    }
+    UpdateBounds();
+    MarkRenderTransformDirty();
+
+    if (SceneProxy)
+    {
+        FRRLidarVisualizationSceneProxy* proxy = static_cast<FRRLidarVisualizationSceneProxy*>(SceneProxy);
+        ENQUEUE_RENDER_COMMAND(SetLidarVizPoints)
+        (
+            [proxy, points = MoveTemp(InPoints), InStyle](FRHICommandListImmediate& RHICmdList) mutable
+            {
+                proxy->SetPoints_RenderThread(MoveTemp(points), InStyle);
+            });
+    }
+}
+
+FPrimitiveSceneProxy* URRLidarVisualizationComponent::CreateSceneProxy()
+{
+    return new FRRLidarVisualizationSceneProxy(this);
+}
+
+FBoxSphereBounds URRLidarVisualizationComponent::CalcBounds(const FTransform& LocalToWorld) const
+{
+    // Points are already in world space
+    return PointsBounds.IsValid ? FBoxSphereBounds(PointsBounds)
+                                : FBoxSphereBounds(LocalToWorld.GetLocation(), FVector::ZeroVector, 0.f);
+}
@@ -67,33 +67,21 @@ void URRPoseSensorManager::UpdateReferenceActorWithTag()
         return;
     }
 
+    // Keep the current reference while within its floor boundaries
+    const float sensorPoseZ = GetComponentTransform().GetTranslation().Z;
+    if (IsValid(ReferenceActor) && (ReferenceSearchVersion == ServerSimState->GetTaggedEntitiesVersion()) &&
+        (ReferenceSearchTag == ReferenceTag) && (sensorPoseZ >= ReferenceMinZ) && (sensorPoseZ <= ReferenceMaxZ))
+    {
+        return;
+    }
+
     // search object with tag and
     // do not use GetAllActorsWithTag since it is slow.
     // set nearest actor in z axis as ReferenceActor
-    AActor* nearestActor = nullptr;
-    const TArray<AActor*> actors = ServerSimState->EntitiesWithTag.FindRef(FName(ReferenceTag)).Actors;
-    if (actors.Num() > 0)
-    {
-        float sensorPoseZ = GetComponentTransform().GetTranslation().Z;
-        int32 nearestActorIndex = 0;
-
-        float minDiffZ = FMath::Abs(sensorPoseZ - actors[0]->GetActorLocation().Z);
-        for (int32 index = 1; index < actors.Num(); ++index)
-        {
-            float diffZ = FMath::Abs(sensorPoseZ - actors[index]->GetActorLocation().Z);
-            if (minDiffZ > diffZ)
-            {
-                minDiffZ = diffZ;
-                nearestActorIndex = index;
-            }
-        }
-        nearestActor = actors[nearestActorIndex];
-    }
-    else
-    {
-        UE_LOG_WITH_INFO_NAMED(
-            LogRapyutaCore, Warning, TEXT("ServerSimState's EntitiesWithTag for [%s] tag is empty"), *ReferenceTag);
-    }
+    AActor* nearestActor =
+        ServerSimState->FindNearestTaggedEntityAlongZ(FName(ReferenceTag), sensorPoseZ, ReferenceMinZ, ReferenceMaxZ);
+    ReferenceSearchVersion = ServerSimState->GetTaggedEntitiesVersion();
+    ReferenceSearchTag = ReferenceTag;
 
     if (nearestActor != nullptr)
     {
@@ -2,11 +2,32 @@
 
 #include "Sensors/RRROS2BaseSensorComponent.h"
 
+// RapyutaSimulationPlugins
+#include "Core/RRROS2NodePool.h"
+#include "Sensors/RRSensorScheduler.h"
+#include "Tools/RRFrameTelemetry.h"
+
 DEFINE_LOG_CATEGORY(LogROS2Sensor);
 
 URRROS2BaseSensorComponent::URRROS2BaseSensorComponent()
 {
     PrimaryComponentTick.bCanEverTick = true;
+    Stats = MakeShared<FRRSensorStats>();
+}
+
+void URRROS2BaseSensorComponent::TimedSensorUpdate()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRSensorUpdate", RRSensorChannel);
+    const double startTime = FPlatformTime::Seconds();
+    SensorUpdate();
+    const double endTime = FPlatformTime::Seconds();
+    Stats->RecordUpdate(startTime, endTime);
+    FRRFrameTelemetry::Get().AddSensorTime(GetClass()->GetFName(), endTime - startTime);
+}
+
+int32 URRROS2BaseSensorComponent::GetDroppedFramesNum() const
+{
+    return SkippedUpdatesNum + (IsValid(SensorPublisher) ? SensorPublisher->GetDroppedMsgsNum() : 0);
 }
 
 void URRROS2BaseSensorComponent::InitalizeWithROS2(UROS2NodeComponent* InROS2Node,
@@ -18,10 +39,47 @@ void URRROS2BaseSensorComponent::InitalizeWithROS2(UROS2NodeComponent* InROS2Nod
     PreInitializePublisher(InROS2Node, InTopicName);
     InitializePublisher(InROS2Node, InQoS);
 
+    if (bOnDemand && IsValid(SensorPublisher))
+    {
+        // Started upon the first check finding subscribers
+        if (!bAsyncPublish)
+        {
+            SensorPublisher->StopPublishTimer();
+        }
+        bPausedOnDemand = true;
+        GetWorld()->GetTimerManager().SetTimer(
+            OnDemandTimerHandle, this, &URRROS2BaseSensorComponent::CheckSubscribers, OnDemandCheckInterval, true, 0.f);
+        return;
+    }
+
     // Start getting sensor data
     Run();
 }
 
+void URRROS2BaseSensorComponent::CheckSubscribers()
+{
+    if (!IsValid(SensorPublisher))
+    {
+        return;
+    }
+    const bool bSubscribed = SensorPublisher->GetSubscribersNum() > 0;
+    if (bSubscribed && bPausedOnDemand)
+    {
+        bPausedOnDemand = false;
+        Run();
+        if (!bAsyncPublish)
+        {
+            SensorPublisher->StartTimerPublishing(PublicationFrequencyHz);
+        }
+    }
+    else if (!bSubscribed && !bPausedOnDemand)
+    {
+        bPausedOnDemand = true;
+        Stop();
+        SensorPublisher->StopTimerPublishing();
+    }
+}
+
 void URRROS2BaseSensorComponent::CreatePublisher(const FString& InPublisherName)
 {
     // Init [SensorPublisher] info
@@ -43,12 +101,13 @@ void URRROS2BaseSensorComponent::PreInitializePublisher(UROS2NodeComponent* InRO
     {
         SensorPublisher->PublicationFrequencyHz = PublicationFrequencyHz;
 
-        // Update [SensorPublisher]'s topic name
-        SensorPublisher->TopicName = InTopicName.IsEmpty() ? TopicName : InTopicName;
+        // Update [SensorPublisher]'s topic name, in the robot's namespace if InROS2Node is shared
+        SensorPublisher->TopicName =
+            URRROS2NodePool::GetTopicName(InROS2Node, this, InTopicName.IsEmpty() ? TopicName : InTopicName);
 
         if (bAppendNodeNamespace)
         {
-            FrameId = URRGeneralUtils::ComposeROSFullFrameId(InROS2Node->Namespace, *FrameId);
+            FrameId = URRGeneralUtils::ComposeROSFullFrameId(URRROS2NodePool::GetNamespace(InROS2Node, this), *FrameId);
         }
     }
 }
@@ -57,6 +116,12 @@ void URRROS2BaseSensorComponent::InitializePublisher(UROS2NodeComponent* InROS2N
 {
     if (IsValid(SensorPublisher))
     {
+        // Recycled along with InROS2Node, only its publication timer stopped upon parking to be restarted
+        if (SensorPublisher->IsInitializedWith(InROS2Node))
+        {
+            SensorPublisher->StartPublishTimer();
+            return;
+        }
         SensorPublisher->InitializeWithROS2(InROS2Node);
         SensorPublisher->QoS = InQoS;
         SensorPublisher->Init();
@@ -65,11 +130,36 @@ void URRROS2BaseSensorComponent::InitializePublisher(UROS2NodeComponent* InROS2N
 
 void URRROS2BaseSensorComponent::Run()
 {
+    if (bAsyncPublish && IsValid(SensorPublisher))
+    {
+        SensorPublisher->StartAsyncPublishing(PublicationFrequencyHz);
+    }
+    else if (IsValid(SensorPublisher) && SensorPublisher->bLoanMessages)
+    {
+        SensorPublisher->StartTimerPublishing(PublicationFrequencyHz);
+    }
+    if (bFrameScheduled)
+    {
+        FRRSensorScheduler::Get(GetWorld()).AddSensor(this);
+        return;
+    }
     GetWorld()->GetTimerManager().SetTimer(
-        TimerHandle, this, &URRROS2BaseSensorComponent::SensorUpdate, 1.f / static_cast<float>(PublicationFrequencyHz), true);
+        TimerHandle, this, &URRROS2BaseSensorComponent::TimedSensorUpdate, 1.f / static_cast<float>(PublicationFrequencyHz), true);
 }
 
 void URRROS2BaseSensorComponent::Stop()
 {
     GetWorld()->GetTimerManager().ClearTimer(TimerHandle);
+    if (IsValid(SensorPublisher))
+    {
+        SensorPublisher->StopAsyncPublishing();
+        if (SensorPublisher->bLoanMessages)
+        {
+            SensorPublisher->StopTimerPublishing();
+        }
+    }
+    if (bFrameScheduled)
+    {
+        FRRSensorScheduler::Get(GetWorld()).RemoveSensor(this);
+    }
 }
@@ -2,6 +2,26 @@
 
 #include "Sensors/RRROS2CameraComponent.h"
 
+// UE
+#include "CanvasTypes.h"
+#include "EngineModule.h"
+#include "LegacyScreenPercentageDriver.h"
+#include "Materials/MaterialInterface.h"
+#include "ProfilingDebugging/RealtimeGPUProfiler.h"
+#include "RendererInterface.h"
+#include "SceneView.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRTrace.h"
+#include "Tools/RRMemoryStats.h"
+#include "Robots/RRRobotStructs.h"
+#include "Sensors/RRCameraCaptureScheduler.h"
+#include "Sensors/RRRenderTargetPool.h"
+#include "Tools/RRROS2CompressedImagePublisher.h"
+#include "Tools/RRROS2MsgWriter.h"
+
+DECLARE_GPU_STAT_NAMED(RRCameraReadbackCopy, TEXT("RR Camera Readback Copy"));
+
 URRROS2CameraComponent::URRROS2CameraComponent()
 {
     // component initialization
@@ -14,132 +34,990 @@ URRROS2CameraComponent::URRROS2CameraComponent()
     SensorPublisherClass = URRROS2ImagePublisher::StaticClass();
 }
 
+bool FRRCameraCaptureProfile::GetBuiltinProfile(const FString& InName, FRRCameraCaptureProfile& OutProfile)
+{
+    OutProfile = FRRCameraCaptureProfile();
+    if (InName.Equals(TEXT("perception-fast")))
+    {
+        OutProfile.DisabledShowFlags = {TEXT("MotionBlur"),
+                                        TEXT("Bloom"),
+                                        TEXT("LensFlares"),
+                                        TEXT("DepthOfField"),
+                                        TEXT("Translucency"),
+                                        TEXT("AmbientOcclusion"),
+                                        TEXT("DistanceFieldAO"),
+                                        TEXT("ScreenSpaceReflections"),
+                                        TEXT("ContactShadows"),
+                                        TEXT("VolumetricFog"),
+                                        TEXT("Particles")};
+        OutProfile.LODDistanceFactor = 2.f;
+        return true;
+    }
+    if (InName.Equals(TEXT("photoreal")))
+    {
+        return true;
+    }
+    return false;
+}
+
+void FRRCameraCaptureProfile::Apply(USceneCaptureComponent2D* InCapture, const bool bInPostProcess) const
+{
+    for (const auto& showFlagName : DisabledShowFlags)
+    {
+        const int32 showFlagIndex = FEngineShowFlags::FindIndexByName(*showFlagName);
+        if (INDEX_NONE == showFlagIndex)
+        {
+            UE_LOG_WITH_INFO(LogROS2Sensor, Warning, TEXT("[%s] Unknown show flag %s"), *InCapture->GetName(), *showFlagName);
+            continue;
+        }
+        InCapture->ShowFlags.SetSingleFlag(showFlagIndex, false);
+    }
+    if (bInPostProcess && bOverridePostProcess)
+    {
+        InCapture->PostProcessSettings = PostProcessSettings;
+        InCapture->PostProcessBlendWeight = 1.f;
+    }
+    InCapture->LODDistanceFactor = LODDistanceFactor;
+    InCapture->bCaptureEveryFrame = bCaptureEveryFrame;
+    InCapture->bCaptureOnMovement = bCaptureOnMovement;
+}
+
+bool URRROS2CameraComponent::FindCaptureProfile(const FString& InName, FRRCameraCaptureProfile& OutProfile) const
+{
+    if (const FRRCameraCaptureProfile* customProfile = CustomCaptureProfiles.Find(InName))
+    {
+        OutProfile = *customProfile;
+        return true;
+    }
+    return FRRCameraCaptureProfile::GetBuiltinProfile(InName, OutProfile);
+}
+
+void URRROS2CameraComponent::SetCameraInfo(const FRRSensorCameraInfo& InCameraInfo)
+{
+    CaptureProfileName = InCameraInfo.CaptureProfileName;
+    if ((InCameraInfo.Width > 0) && (InCameraInfo.Height > 0))
+    {
+        Width = InCameraInfo.Width;
+        Height = InCameraInfo.Height;
+    }
+}
+
+void URRROS2CameraComponent::CreatePublisher(const FString& InPublisherName)
+{
+    Super::CreatePublisher(InPublisherName);
+
+    if (AuxPublishers.Num() > 0)
+    {
+        return;
+    }
+    for (const auto output : {ERRCameraOutput::DEPTH, ERRCameraOutput::SEGMENTATION, ERRCameraOutput::NORMALS})
+    {
+        if (IsOutputEnabled(output))
+        {
+            URRROS2ImagePublisher* auxPublisher = NewObject<URRROS2ImagePublisher>(
+                this,
+                *FString::Printf(TEXT("%s%sPublisher"),
+                                 *GetName(),
+                                 *StaticEnum<ERRCameraOutput>()->GetDisplayNameTextByValue(static_cast<int64>(output)).ToString()));
+            auxPublisher->DataSourceComponent = this;
+            auxPublisher->CameraOutput = output;
+            AuxPublishers.Add(auxPublisher);
+        }
+    }
+    if (bPublishCompressed)
+    {
+        URRROS2ImagePublisher* compressedPublisher =
+            NewObject<URRROS2CompressedImagePublisher>(this, *FString::Printf(TEXT("%sCompressedPublisher"), *GetName()));
+        compressedPublisher->DataSourceComponent = this;
+        AuxPublishers.Add(compressedPublisher);
+    }
+}
+
 void URRROS2CameraComponent::PreInitializePublisher(UROS2NodeComponent* InROS2Node, const FString& InTopicName)
 {
+    LLM_SCOPE_BYTAG(RRCamera);
+    // Rejoined upon Run()
+    LeaveAtlas();
     SceneCaptureComponent->FOVAngle = CameraComponent->FieldOfView;
     SceneCaptureComponent->OrthoWidth = CameraComponent->OrthoWidth;
 
-    RenderTarget = NewObject<UTextureRenderTarget2D>(this, UTextureRenderTarget2D::StaticClass());
-    RenderTarget->InitCustomFormat(Width, Height, EPixelFormat::PF_B8G8R8A8, true);
+    // Render targets are leased from the world pool, to be reused by the cameras of respawned robots
+    ReturnRenderTargets();
+
+    FRRCameraCaptureProfile captureProfile;
+    const bool bCaptureProfile = !CaptureProfileName.IsEmpty() && FindCaptureProfile(CaptureProfileName, captureProfile);
+    if (bCaptureProfile)
+    {
+        captureProfile.Apply(SceneCaptureComponent, true);
+    }
+    else if (!CaptureProfileName.IsEmpty())
+    {
+        UE_LOG_WITH_INFO(LogROS2Sensor, Warning, TEXT("[%s] Unknown capture profile %s"), *GetName(), *CaptureProfileName);
+    }
+
+    FRRRenderTargetPool& renderTargetPool = FRRRenderTargetPool::Get(GetWorld());
+    RenderTarget = renderTargetPool.Lease(Width, Height, EPixelFormat::PF_B8G8R8A8);
     SceneCaptureComponent->TextureTarget = RenderTarget;
 
+    if (Encoding.Equals(TEXT("bgr8")))
+    {
+        ImageEncoding = EImageEncoding::BGR8;
+    }
+    else if (Encoding.Equals(TEXT("mono8")))
+    {
+        ImageEncoding = EImageEncoding::MONO8;
+    }
+    else
+    {
+        if (!Encoding.Equals(TEXT("rgb8")))
+        {
+            UE_LOG_WITH_INFO(LogROS2Sensor, Warning, TEXT("[%s] Unsupported encoding %s, using rgb8"), *GetName(), *Encoding);
+            Encoding = TEXT("rgb8");
+        }
+        ImageEncoding = EImageEncoding::RGB8;
+    }
+
     // Initialize image data
+    const int32 channelsNum = GetChannelsNum(ImageEncoding);
     Data.Header.FrameId = FrameId;
     Data.Width = Width;
     Data.Height = Height;
     Data.Encoding = Encoding;
-    Data.Step = Width * 3;    // todo should be variable based on encoding
-    Data.Data.AddUninitialized(Width * Height * 3);
+    Data.Step = Width * channelsNum;
+    Data.Data.SetNumZeroed(Width * Height * channelsNum);
+
+    // Single pass for all auxiliary outputs
+    const bool bAux = HasAuxOutputs();
+    if (bAux)
+    {
+        if (nullptr == AuxCaptureComponent)
+        {
+            AuxCaptureComponent = NewObject<USceneCaptureComponent2D>(this, TEXT("AuxCaptureComponent"));
+            AuxCaptureComponent->SetupAttachment(this);
+            AuxCaptureComponent->RegisterComponent();
+        }
+        AuxCaptureComponent->bCaptureEveryFrame = false;
+        AuxCaptureComponent->bCaptureOnMovement = false;
+        if (bCaptureProfile)
+        {
+            // Post process is replaced by AuxOutputsMaterial
+            captureProfile.Apply(AuxCaptureComponent, false);
+        }
+        AuxCaptureComponent->FOVAngle = CameraComponent->FieldOfView;
+        AuxCaptureComponent->OrthoWidth = CameraComponent->OrthoWidth;
+        if (AuxOutputsMaterial)
+        {
+            AuxCaptureComponent->CaptureSource = ESceneCaptureSource::SCS_FinalColorHDR;
+            AuxCaptureComponent->PostProcessSettings.WeightedBlendables.Array.Reset();
+            AuxCaptureComponent->PostProcessSettings.AddBlendable(AuxOutputsMaterial, 1.f);
+        }
+        else
+        {
+            AuxCaptureComponent->CaptureSource = ESceneCaptureSource::SCS_SceneDepth;
+        }
+
+        AuxRenderTarget = renderTargetPool.Lease(Width, Height, EPixelFormat::PF_A32B32G32R32F);
+        AuxCaptureComponent->TextureTarget = AuxRenderTarget;
+
+        if (!IsDepth16() && !DepthEncoding.Equals(TEXT("32FC1")))
+        {
+            UE_LOG_WITH_INFO(
+                LogROS2Sensor, Warning, TEXT("[%s] Unsupported depth encoding %s, using 32FC1"), *GetName(), *DepthEncoding);
+            DepthEncoding = TEXT("32FC1");
+        }
+        const TCHAR* auxEncodings[] = {*DepthEncoding, TEXT("mono8"), TEXT("32FC3")};
+        for (const auto output : {ERRCameraOutput::DEPTH, ERRCameraOutput::SEGMENTATION, ERRCameraOutput::NORMALS})
+        {
+            const int32 auxIndex = GetAuxOutputIndex(output);
+            const int32 bytesPerPixel = GetAuxBytesPerPixel(output);
+            FROSImg& auxData = AuxData[auxIndex];
+            auxData.Header.FrameId = FrameId;
+            auxData.Width = Width;
+            auxData.Height = Height;
+            auxData.Encoding = auxEncodings[auxIndex];
+            auxData.Step = Width * bytesPerPixel;
+            auxData.Data.SetNumZeroed(Width * Height * bytesPerPixel);
+        }
+    }
 
     QueueSize = QueueSize < 1 ? 1 : QueueSize;    // QueueSize should be more than 1
 
+    // Readback slots are recycled across captures
+    FlushRenderingCommands();
+    RenderRequests.Reset(QueueSize);
+    for (int32 i = 0; i < QueueSize; ++i)
+    {
+        TUniquePtr<FRenderRequest> renderRequest = MakeUnique<FRenderRequest>();
+        renderRequest->Readback = MakeUnique<FRHIGPUTextureReadback>(TEXT("RRROS2CameraReadback"));
+        if (bAux)
+        {
+            renderRequest->AuxReadback = MakeUnique<FRHIGPUTextureReadback>(TEXT("RRROS2CameraAuxReadback"));
+        }
+        RenderRequests.Add(MoveTemp(renderRequest));
+    }
+    RenderRequestHead = 0;
+    TRACE_COUNTER_SUBTRACT(RRCameraQueuedRenderRequests, QueueCount);
+    QueueCount = 0;
+
     Super::PreInitializePublisher(InROS2Node, InTopicName);
+
+    for (auto* auxPublisher : AuxPublishers)
+    {
+        auxPublisher->PublicationFrequencyHz = PublicationFrequencyHz;
+        switch (auxPublisher->CameraOutput)
+        {
+            case ERRCameraOutput::COLOR:
+                auxPublisher->TopicName = CompressedTopicName;
+                break;
+            case ERRCameraOutput::DEPTH:
+                auxPublisher->TopicName = DepthTopicName;
+                break;
+            case ERRCameraOutput::SEGMENTATION:
+                auxPublisher->TopicName = SegmentationTopicName;
+                break;
+            case ERRCameraOutput::NORMALS:
+                auxPublisher->TopicName = NormalsTopicName;
+                break;
+        }
+    }
+}
+
+void URRROS2CameraComponent::InitializePublisher(UROS2NodeComponent* InROS2Node, const UROS2QoS InQoS)
+{
+    Super::InitializePublisher(InROS2Node, InQoS);
+    for (auto* auxPublisher : AuxPublishers)
+    {
+        auxPublisher->InitializeWithROS2(InROS2Node);
+        auxPublisher->QoS = InQoS;
+        auxPublisher->Init();
+    }
+}
+
+int32 URRROS2CameraComponent::GetAuxBytesPerPixel(const ERRCameraOutput InOutput) const
+{
+    if (!IsOutputEnabled(InOutput))
+    {
+        return 0;
+    }
+    switch (InOutput)
+    {
+        case ERRCameraOutput::DEPTH:
+            return IsDepth16() ? sizeof(uint16) : sizeof(float);
+        case ERRCameraOutput::SEGMENTATION:
+            return sizeof(uint8);
+        case ERRCameraOutput::NORMALS:
+            return 3 * sizeof(float);
+        default:
+            return 0;
+    }
+}
+
+bool URRROS2CameraComponent::IsOutputEnabled(const ERRCameraOutput InOutput) const
+{
+    switch (InOutput)
+    {
+        case ERRCameraOutput::COLOR:
+            return true;
+        case ERRCameraOutput::DEPTH:
+            return bPublishDepth;
+        case ERRCameraOutput::SEGMENTATION:
+            return bPublishSegmentation && (nullptr != AuxOutputsMaterial);
+        case ERRCameraOutput::NORMALS:
+            return bPublishNormals && (nullptr != AuxOutputsMaterial);
+    }
+    return false;
+}
+
+void URRROS2CameraComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    // No capture once the render targets are returned
+    Stop();
+
+    // Render commands hold raw pointers to the readback slots & render target resources, flushed before reuse
+    ReturnRenderTargets();
+    Super::EndPlay(EndPlayReason);
+}
+
+void URRROS2CameraComponent::ReturnRenderTargets()
+{
+    if ((nullptr == RenderTarget) && (nullptr == AuxRenderTarget))
+    {
+        return;
+    }
+    FlushRenderingCommands();
+    FRRRenderTargetPool& renderTargetPool = FRRRenderTargetPool::Get(GetWorld());
+    renderTargetPool.Return(RenderTarget);
+    renderTargetPool.Return(AuxRenderTarget);
+    RenderTarget = nullptr;
+    AuxRenderTarget = nullptr;
+    SceneCaptureComponent->TextureTarget = nullptr;
+    if (AuxCaptureComponent)
+    {
+        AuxCaptureComponent->TextureTarget = nullptr;
+    }
+}
+
+void URRROS2CameraComponent::ResolveAtlasGroup()
+{
+    LeaveAtlas();
+    AActor* owner = GetOwner();
+    if (AtlasGroup.IsNone() || (nullptr == owner) || (nullptr == RenderTarget))
+    {
+        return;
+    }
+
+    TInlineComponentArray<URRROS2CameraComponent*> cameras(owner);
+    for (URRROS2CameraComponent* camera : cameras)
+    {
+        if ((camera != this) && (camera->AtlasGroup == AtlasGroup) && camera->IsAtlasLeader())
+        {
+            if (!camera->AddAtlasMember(this))
+            {
+                UE_LOG_WITH_INFO(LogROS2Sensor,
+                                 Warning,
+                                 TEXT("[%s] Not of the size of atlas %s (%dx%d) or with auxiliary outputs, captured alone"),
+                                 *GetName(),
+                                 *AtlasGroup.ToString(),
+                                 camera->Width,
+                                 camera->Height);
+            }
+            return;
+        }
+    }
+
+    if (HasAuxOutputs())
+    {
+        UE_LOG_WITH_INFO(
+            LogROS2Sensor, Warning, TEXT("[%s] Auxiliary outputs are not rendered into atlases, captured alone"), *GetName());
+        return;
+    }
+    AtlasMembers.Add(this);
+    AtlasLeader = this;
+    UpdateAtlasLayout();
+}
+
+bool URRROS2CameraComponent::AddAtlasMember(URRROS2CameraComponent* InMember)
+{
+    if ((InMember->Width != Width) || (InMember->Height != Height) || InMember->HasAuxOutputs())
+    {
+        return false;
+    }
+    AtlasMembers.Add(InMember);
+    InMember->AtlasLeader = this;
+    UpdateAtlasLayout();
+    return true;
+}
+
+void URRROS2CameraComponent::LeaveAtlas()
+{
+    URRROS2CameraComponent* leader = AtlasLeader.Get();
+    AtlasLeader.Reset();
+    if (nullptr == leader)
+    {
+        return;
+    }
+
+    // Render commands reference the atlas render target & the tiles readbacks
+    FlushRenderingCommands();
+    FRRRenderTargetPool& renderTargetPool = FRRRenderTargetPool::Get(GetWorld());
+    auto restoreRenderTarget = [&renderTargetPool](URRROS2CameraComponent* InCamera)
+    {
+        InCamera->AtlasRect = FIntRect();
+        if (nullptr == InCamera->RenderTarget)
+        {
+            InCamera->RenderTarget = renderTargetPool.Lease(InCamera->Width, InCamera->Height, EPixelFormat::PF_B8G8R8A8);
+        }
+        InCamera->SceneCaptureComponent->TextureTarget = InCamera->RenderTarget;
+    };
+    restoreRenderTarget(this);
+
+    if (leader != this)
+    {
+        leader->AtlasMembers.Remove(this);
+        leader->UpdateAtlasLayout();
+        return;
+    }
+
+    // Hand the other members over to the first of them
+    TArray<TWeakObjectPtr<URRROS2CameraComponent>> members = MoveTemp(AtlasMembers);
+    renderTargetPool.Return(AtlasRenderTarget);
+    AtlasRenderTarget = nullptr;
+    for (const auto& memberPtr : members)
+    {
+        URRROS2CameraComponent* member = memberPtr.Get();
+        if (member && (member != this))
+        {
+            member->AtlasLeader.Reset();
+            restoreRenderTarget(member);
+        }
+    }
+    for (const auto& memberPtr : members)
+    {
+        URRROS2CameraComponent* member = memberPtr.Get();
+        if (member && (member != this))
+        {
+            member->ResolveAtlasGroup();
+        }
+    }
+}
+
+void URRROS2CameraComponent::UpdateAtlasLayout()
+{
+    AtlasMembers.RemoveAll([](const TWeakObjectPtr<URRROS2CameraComponent>& InMember) { return !InMember.IsValid(); });
+    FlushRenderingCommands();
+    FRRRenderTargetPool& renderTargetPool = FRRRenderTargetPool::Get(GetWorld());
+    renderTargetPool.Return(AtlasRenderTarget);
+    AtlasRenderTarget = nullptr;
+    if (AtlasMembers.Num() == 0)
+    {
+        return;
+    }
+
+    // Near-square grid of equally sized tiles
+    const int32 membersNum = AtlasMembers.Num();
+    const int32 columnsNum = FMath::CeilToInt32(FMath::Sqrt(static_cast<float>(membersNum)));
+    const int32 rowsNum = FMath::DivideAndRoundUp(membersNum, columnsNum);
+    AtlasRenderTarget = renderTargetPool.Lease(columnsNum * Width, rowsNum * Height, EPixelFormat::PF_B8G8R8A8);
+    for (int32 i = 0; i < membersNum; ++i)
+    {
+        URRROS2CameraComponent* member = AtlasMembers[i].Get();
+        const FIntPoint tileMin((i % columnsNum) * Width, (i / columnsNum) * Height);
+        member->AtlasRect = FIntRect(tileMin, tileMin + FIntPoint(Width, Height));
+        member->SceneCaptureComponent->TextureTarget = AtlasRenderTarget;
+        // Own render target only used when captured alone
+        if (member->RenderTarget)
+        {
+            renderTargetPool.Return(member->RenderTarget);
+            member->RenderTarget = nullptr;
+        }
+    }
+}
+
+void URRROS2CameraComponent::RenderAtlas()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRCameraRenderAtlas", RRSensorChannel);
+    TArray<FSceneViewTile, TInlineAllocator<8>> tiles;
+    for (const auto& memberPtr : AtlasMembers)
+    {
+        if (const URRROS2CameraComponent* member = memberPtr.Get())
+        {
+            FSceneViewTile& tile = tiles.AddDefaulted_GetRef();
+            tile.Capture = member->SceneCaptureComponent;
+            tile.Location = member->SceneCaptureComponent->GetComponentLocation();
+            tile.Rect = member->AtlasRect;
+        }
+    }
+    RenderSceneViews(AtlasRenderTarget, tiles);
+}
+
+void URRROS2CameraComponent::RenderSceneViews(UTextureRenderTarget2D* InRenderTarget, TArrayView<const FSceneViewTile> InTiles)
+{
+    UWorld* world = GetWorld();
+    if ((nullptr == world) || (nullptr == world->Scene) || (nullptr == InRenderTarget) || (InTiles.Num() == 0))
+    {
+        return;
+    }
+
+    FTextureRenderTargetResource* renderTargetResource = InRenderTarget->GameThread_GetRenderTargetResource();
+    FSceneViewFamilyContext viewFamily(
+        FSceneViewFamily::ConstructionValues(renderTargetResource, world->Scene, SceneCaptureComponent->ShowFlags)
+            .SetRealtimeUpdate(true)
+            .SetTime(FGameTime::CreateDilated(
+                world->GetRealTimeSeconds(), world->GetDeltaRealSeconds(), world->GetTimeSeconds(), world->GetDeltaSeconds())));
+    viewFamily.SceneCaptureSource = SceneCaptureComponent->CaptureSource;
+
+    // One view per tile, sharing the scene render setup of the family
+    for (const FSceneViewTile& tile : InTiles)
+    {
+        const USceneCaptureComponent2D* capture = tile.Capture;
+        const FVector& viewLocation = tile.Location;
+
+        FSceneViewInitOptions viewInitOptions;
+        viewInitOptions.SetViewRectangle(tile.Rect);
+        viewInitOptions.ViewFamily = &viewFamily;
+        viewInitOptions.ViewOrigin = viewLocation;
+        // UE x forward, z up -> view space z forward, y up
+        viewInitOptions.ViewRotationMatrix =
+            FInverseRotationMatrix(capture->GetComponentRotation()) *
+            FMatrix(FPlane(0, 0, 1, 0), FPlane(1, 0, 0, 0), FPlane(0, 1, 0, 0), FPlane(0, 0, 0, 1));
+        const float halfFOV = FMath::DegreesToRadians(.5f * capture->FOVAngle);
+        const float aspectRatio = static_cast<float>(tile.Rect.Width()) / static_cast<float>(tile.Rect.Height());
+        viewInitOptions.ProjectionMatrix =
+            FReversedZPerspectiveMatrix(halfFOV, halfFOV, 1.f, aspectRatio, GNearClippingPlane, GNearClippingPlane);
+        viewInitOptions.FOV = capture->FOVAngle;
+        viewInitOptions.DesiredFOV = capture->FOVAngle;
+        viewInitOptions.BackgroundColor = FLinearColor::Black;
+        viewInitOptions.LODDistanceFactor = FMath::Clamp(capture->LODDistanceFactor, .01f, 100.f);
+
+        FSceneView* view = new FSceneView(viewInitOptions);
+        view->bIsSceneCapture = true;
+        // Without view state, thus without temporal history
+        view->AntiAliasingMethod = EAntiAliasingMethod::AAM_FXAA;
+        view->StartFinalPostprocessSettings(viewLocation);
+        view->OverridePostProcessSettings(capture->PostProcessSettings, capture->PostProcessBlendWeight);
+        view->EndFinalPostprocessSettings(viewInitOptions);
+        // Owned & deleted by the family context
+        viewFamily.Views.Add(view);
+    }
+    viewFamily.SetScreenPercentageInterface(new FLegacyScreenPercentageDriver(viewFamily, 1.f));
+
+    FCanvas canvas(renderTargetResource, nullptr, world, world->Scene->GetFeatureLevel());
+    GetRendererModule().BeginRenderingViewFamily(&canvas, &viewFamily);
+}
+
+void URRROS2CameraComponent::CaptureAtlas(TArray<FReadbackCopy>& OutCopies, TArray<FReadbackPoll>& OutPolls)
+{
+    check(IsAtlasLeader());
+    RenderAtlas();
+    for (const auto& memberPtr : AtlasMembers)
+    {
+        if (URRROS2CameraComponent* member = memberPtr.Get())
+        {
+            OutPolls.Add(member->MakeReadbackPoll());
+            FReadbackCopy copy;
+            if (member->BeginReadback(copy))
+            {
+                OutCopies.Add(copy);
+            }
+        }
+    }
+}
+
+void URRROS2CameraComponent::Run()
+{
+    ResolveAtlasGroup();
+
+    // Phases are spread by FRRSensorScheduler if frame scheduled
+    if (!bScheduledCapture || bFrameScheduled)
+    {
+        Super::Run();
+        return;
+    }
+
+    // Spread the timer phases of scheduled cameras, not to have the ones of the same rate all due in the same frame
+    const float period = 1.f / static_cast<float>(PublicationFrequencyHz);
+    const float phase = FRRCameraCaptureScheduler::Get(GetWorld()).AddCamera(this);
+    GetWorld()->GetTimerManager().SetTimer(
+        TimerHandle, this, &URRROS2CameraComponent::TimedSensorUpdate, period, true, (1.f + phase) * period);
+}
+
+void URRROS2CameraComponent::Stop()
+{
+    Super::Stop();
+    LeaveAtlas();
+    if (bScheduledCapture)
+    {
+        FRRCameraCaptureScheduler::Get(GetWorld()).RemoveCamera(this);
+    }
+}
+
+int64 URRROS2CameraComponent::GetRenderRequestsAllocatedSize() const
+{
+    int64 bytes = RenderRequests.GetAllocatedSize();
+    for (const auto& renderRequest : RenderRequests)
+    {
+        bytes += sizeof(FRenderRequest) + renderRequest->Image.GetAllocatedSize();
+        for (const auto& auxImage : renderRequest->AuxImages)
+        {
+            bytes += auxImage.GetAllocatedSize();
+        }
+    }
+    return bytes;
+}
+
+int64 URRROS2CameraComponent::GetMsgDataAllocatedSize() const
+{
+    int64 bytes = Data.Data.GetAllocatedSize();
+    for (const auto& auxData : AuxData)
+    {
+        bytes += auxData.Data.GetAllocatedSize();
+    }
+    return bytes;
 }
 
 void URRROS2CameraComponent::SensorUpdate()
 {
-    SceneCaptureComponent->CaptureScene();
+    if (IsAtlasMember())
+    {
+        // Captured by its atlas leader, in the same frame as the other members
+        return;
+    }
+    if (bScheduledCapture)
+    {
+        // Captured within the budget of FRRCameraCaptureScheduler, along with the other cameras due in this frame
+        FRRCameraCaptureScheduler::Get(GetWorld()).RequestCapture(this);
+        return;
+    }
+    if (IsAtlasLeader())
+    {
+        TArray<FReadbackCopy> copies;
+        TArray<FReadbackPoll> polls;
+        CaptureAtlas(copies, polls);
+        ENQUEUE_RENDER_COMMAND(AtlasCameraReadbacks)
+        (
+            [polls = MoveTemp(polls), copies = MoveTemp(copies)](FRHICommandListImmediate& RHICmdList)
+            {
+                for (const auto& poll : polls)
+                {
+                    PollReadbacks_RenderThread(poll);
+                }
+                for (const auto& copy : copies)
+                {
+                    EnqueueReadbackCopy_RenderThread(RHICmdList, copy);
+                }
+            });
+        return;
+    }
+    CaptureScenes();
     CaptureNonBlocking();
 }
 
+void URRROS2CameraComponent::CaptureScenes()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRCameraCaptureScenes", RRSensorChannel);
+    SceneCaptureComponent->CaptureScene();
+    if (AuxCaptureComponent && AuxRenderTarget)
+    {
+        AuxCaptureComponent->CaptureScene();
+    }
+}
+
 // reference https://github.com/TimmHess/UnrealImageCapture
 void URRROS2CameraComponent::CaptureNonBlocking()
 {
-    SceneCaptureComponent->TextureTarget->TargetGamma = GEngine->GetDisplayGamma();
-    // Get RenderContext
-    FTextureRenderTargetResource* renderTargetResource = SceneCaptureComponent->TextureTarget->GameThread_GetRenderTargetResource();
-
-    struct FReadSurfaceContext
+    if (RenderRequests.Num() == 0)
     {
-        FRenderTarget* SrcRenderTarget;
-        TArray<FColor>* OutData;
-        FIntRect Rect;
-        FReadSurfaceDataFlags Flags;
-    };
-
-    // Init new RenderRequest
-    FRenderRequest* renderRequest = new FRenderRequest();
+        return;
+    }
+    PollReadbacks();
 
-    // Setup GPU command
-    FReadSurfaceContext readSurfaceContext = {
-        renderTargetResource,
-        &(renderRequest->Image),
-        FIntRect(0, 0, renderTargetResource->GetSizeXY().X, renderTargetResource->GetSizeXY().Y),
-        FReadSurfaceDataFlags(RCM_UNorm, CubeFace_MAX)};
+    FReadbackCopy copy;
+    if (!BeginReadback(copy))
+    {
+        return;
+    }
 
     // Above 4.22 use this
     ENQUEUE_RENDER_COMMAND(SceneDrawCompletion)
-    (
-        [readSurfaceContext, this](FRHICommandListImmediate& RHICmdList)
+    ([copy](FRHICommandListImmediate& RHICmdList) { EnqueueReadbackCopy_RenderThread(RHICmdList, copy); });
+}
+
+bool URRROS2CameraComponent::BeginReadback(FReadbackCopy& OutCopy)
+{
+    if (RenderRequests.Num() == 0)
+    {
+        return false;
+    }
+    SceneCaptureComponent->TextureTarget->TargetGamma = GEngine->GetDisplayGamma();
+
+    if (QueueCount >= RenderRequests.Num())
+    {
+        switch (QueuePolicy)
         {
-            RHICmdList.ReadSurfaceData(readSurfaceContext.SrcRenderTarget->GetRenderTargetTexture(),
-                                       readSurfaceContext.Rect,
-                                       *readSurfaceContext.OutData,
-                                       readSurfaceContext.Flags);
-        });
+            case ERRCameraQueuePolicy::DROP_OLDEST:
+                // the oldest slot is reused
+                RenderRequestHead = (RenderRequestHead + 1) % RenderRequests.Num();
+                QueueCount--;
+                TRACE_COUNTER_DECREMENT(RRCameraQueuedRenderRequests);
+                ++DroppedFramesNum;
+                break;
+
+            case ERRCameraQueuePolicy::DROP_NEWEST:
+                ++DroppedFramesNum;
+                UE_LOG_WITH_INFO(LogROS2Sensor,
+                                 Verbose,
+                                 TEXT("[%s] All readback slots pending, dropped %d frames so far"),
+                                 *GetName(),
+                                 DroppedFramesNum);
+                return false;
+
+            case ERRCameraQueuePolicy::BLOCK:
+                // the oldest capture is kept in Data, to be published next
+                ++BlockedFramesNum;
+                while (!ConsumeRenderRequest())
+                {
+                    PollReadbacks();
+                    FlushRenderingCommands();
+                }
+                break;
+        }
+    }
+    FRenderRequest* renderRequest = RenderRequests[(RenderRequestHead + QueueCount) % RenderRequests.Num()].Get();
+    renderRequest->CaptureId = ++LastCaptureId;
+    QueueCount++;
+    TRACE_COUNTER_INCREMENT(RRCameraQueuedRenderRequests);
+
+    // Get RenderContext
+    OutCopy.RenderTargetResource = SceneCaptureComponent->TextureTarget->GameThread_GetRenderTargetResource();
+    OutCopy.AuxRenderTargetResource = AuxRenderTarget ? AuxRenderTarget->GameThread_GetRenderTargetResource() : nullptr;
+    OutCopy.RenderRequest = renderRequest;
+    OutCopy.CaptureId = renderRequest->CaptureId;
+    OutCopy.SourceRect = AtlasRect;
+    return true;
+}
 
-    // Notify new task in RenderQueue
-    RenderRequestQueue.Enqueue(renderRequest);
-    if (QueueCount > QueueSize)
+void URRROS2CameraComponent::EnqueueReadbackCopy_RenderThread(FRHICommandListImmediate& RHICmdList, const FReadbackCopy& InCopy)
+{
+    check(IsInRenderingThread());
+    SCOPED_DRAW_EVENT(RHICmdList, RRCameraReadbackCopy);
+    SCOPED_GPU_STAT(RHICmdList, RRCameraReadbackCopy);
+    FRenderRequest* renderRequest = InCopy.RenderRequest;
+    // A tile is copied to the staging texture origin, thus polled as a whole image
+    const FIntRect& rect = InCopy.SourceRect;
+    const FResolveRect sourceRect =
+        rect.IsEmpty() ? FResolveRect() : FResolveRect(rect.Min.X, rect.Min.Y, rect.Max.X, rect.Max.Y);
+    renderRequest->Readback->EnqueueCopy(RHICmdList, InCopy.RenderTargetResource->GetRenderTargetTexture(), sourceRect);
+    if (InCopy.AuxRenderTargetResource && renderRequest->AuxReadback)
     {
-        RenderRequestQueue.Pop();
+        renderRequest->AuxReadback->EnqueueCopy(RHICmdList, InCopy.AuxRenderTargetResource->GetRenderTargetTexture());
     }
-    else
+    renderRequest->CaptureIdRT = InCopy.CaptureId;
+    renderRequest->bPendingRT = true;
+}
+
+URRROS2CameraComponent::FReadbackPoll URRROS2CameraComponent::MakeReadbackPoll() const
+{
+    FReadbackPoll poll;
+    for (const auto& renderRequest : RenderRequests)
     {
-        QueueCount++;
+        poll.RenderRequests.Add(renderRequest.Get());
     }
+    poll.Width = Width;
+    poll.Height = Height;
+    poll.Encoding = ImageEncoding;
+    poll.bDepth16 = IsDepth16();
+    poll.AuxBytesPerPixel[0] = GetAuxBytesPerPixel(ERRCameraOutput::DEPTH);
+    poll.AuxBytesPerPixel[1] = GetAuxBytesPerPixel(ERRCameraOutput::SEGMENTATION);
+    poll.AuxBytesPerPixel[2] = GetAuxBytesPerPixel(ERRCameraOutput::NORMALS);
+    return poll;
+}
 
-    // Set RenderCommandFence
-    renderRequest->RenderFence.BeginFence();
+void URRROS2CameraComponent::PollReadbacks()
+{
+    ENQUEUE_RENDER_COMMAND(PollCameraReadbacks)
+    ([poll = MakeReadbackPoll()](FRHICommandListImmediate& RHICmdList) { PollReadbacks_RenderThread(poll); });
 }
 
-FROSImg URRROS2CameraComponent::GetROS2Data()
+void URRROS2CameraComponent::PollReadbacks_RenderThread(const FReadbackPoll& InPoll)
 {
-    if (!RenderRequestQueue.IsEmpty())
+    check(IsInRenderingThread());
+    LLM_SCOPE_BYTAG(RRCamera);
+    const int32 width = InPoll.Width;
+    const int32 height = InPoll.Height;
+    for (FRenderRequest* renderRequest : InPoll.RenderRequests)
     {
-        // Timestamp
-        Data.Header.Stamp = URRConversionUtils::FloatToROSStamp(UGameplayStatics::GetTimeSeconds(GetWorld()));
-
-        // Peek the next RenderRequest from queue
-        FRenderRequest* nextRenderRequest = nullptr;
-        RenderRequestQueue.Peek(nextRenderRequest);
-        if (nextRenderRequest)
-        {    // nullptr check
-            if (nextRenderRequest->RenderFence.IsFenceComplete())
-            {    // Check if rendering is done, indicated by RenderFence
-                for (int I = 0; I < nextRenderRequest->Image.Num(); I++)
+        FRHIGPUTextureReadback* const auxReadback = renderRequest->AuxReadback.Get();
+        if (!renderRequest->bPendingRT || !renderRequest->Readback->IsReady() || (auxReadback && !auxReadback->IsReady()))
+        {
+            continue;
+        }
+
+        if (auxReadback)
+        {
+            int32 auxRowPitchInPixels = 0;
+            const FLinearColor* auxSrc = static_cast<const FLinearColor*>(auxReadback->Lock(auxRowPitchInPixels));
+            if (auxSrc)
+            {
+                for (int32 i = 0; i < 3; ++i)
+                {
+                    renderRequest->AuxImages[i].SetNumUninitialized(width * height * InPoll.AuxBytesPerPixel[i], false);
+                }
+                for (int32 y = 0; y < height; ++y)
                 {
-                    Data.Data[I * 3 + 0] = nextRenderRequest->Image[I].R;
-                    Data.Data[I * 3 + 1] = nextRenderRequest->Image[I].G;
-                    Data.Data[I * 3 + 2] = nextRenderRequest->Image[I].B;
+                    ConvertAuxPixels(auxSrc + y * auxRowPitchInPixels, width, y, InPoll.bDepth16, renderRequest->AuxImages);
                 }
+            }
+            auxReadback->Unlock();
+        }
 
-                // Delete the first element from RenderQueue
-                RenderRequestQueue.Pop();
-                QueueCount--;
-                delete nextRenderRequest;
+        int32 rowPitchInPixels = 0;
+        const FColor* src = static_cast<const FColor*>(renderRequest->Readback->Lock(rowPitchInPixels));
+        if (src)
+        {
+            // B8G8R8A8 pixels have FColor layout, but staging rows may be padded
+            const int32 rowSize = width * GetChannelsNum(InPoll.Encoding);
+            renderRequest->Image.SetNumUninitialized(rowSize * height, false);
+            for (int32 y = 0; y < height; ++y)
+            {
+                ConvertPixels(src + y * rowPitchInPixels, &renderRequest->Image[y * rowSize], width, InPoll.Encoding);
             }
         }
+        renderRequest->Readback->Unlock();
+        renderRequest->bPendingRT = false;
+        renderRequest->ReadyCaptureId.store(renderRequest->CaptureIdRT, std::memory_order_release);
     }
+}
 
-    // SceneCaptureComponent->CaptureScene();
-    // FTextureRenderTarget2DResource* RenderTargetResource;
-    // RenderTargetResource = (FTextureRenderTarget2DResource*)RenderTarget->GameThread_GetRenderTargetResource();
-    // if (RenderTargetResource) {
-    //     TArray<FColor> buffer;
-    //     RenderTargetResource->ReadPixels(buffer);
-    //     for (int I = 0; I < buffer.Num(); I++)
-    //     {
-    //         Data.data[I * 3 + 0] = buffer[I].R;
-    //         Data.data[I * 3 + 1] = buffer[I].G;
-    //         Data.data[I * 3 + 2] = buffer[I].B;
-    //     }
-    // }
+bool URRROS2CameraComponent::ConsumeRenderRequest()
+{
+    if (QueueCount == 0)
+    {
+        return false;
+    }
+
+    FRenderRequest* nextRenderRequest = RenderRequests[RenderRequestHead].Get();
+    if (nextRenderRequest->ReadyCaptureId.load(std::memory_order_acquire) != nextRenderRequest->CaptureId)
+    {
+        return false;
+    }
+
+    // Already converted on render thread
+    Swap(Data.Data, nextRenderRequest->Image);
+    DataCaptureId = nextRenderRequest->CaptureId;
+    for (int32 i = 0; i < 3; ++i)
+    {
+        if (nextRenderRequest->AuxImages[i].Num() > 0)
+        {
+            AuxData[i].Header.Stamp = Data.Header.Stamp;
+            Swap(AuxData[i].Data, nextRenderRequest->AuxImages[i]);
+        }
+    }
 
+    // Recycle the slot
+    RenderRequestHead = (RenderRequestHead + 1) % RenderRequests.Num();
+    QueueCount--;
+    TRACE_COUNTER_DECREMENT(RRCameraQueuedRenderRequests);
+    return true;
+}
+
+void URRROS2CameraComponent::ConvertPixels(const FColor* InSrc,
+                                           uint8* OutDst,
+                                           const int32 InNum,
+                                           const EImageEncoding InEncoding)
+{
+    // Branch-free loops over contiguous pixels, vectorized by the compiler
+    switch (InEncoding)
+    {
+        case EImageEncoding::RGB8:
+            for (int32 i = 0; i < InNum; ++i)
+            {
+                OutDst[3 * i + 0] = InSrc[i].R;
+                OutDst[3 * i + 1] = InSrc[i].G;
+                OutDst[3 * i + 2] = InSrc[i].B;
+            }
+            break;
+
+        case EImageEncoding::BGR8:
+            for (int32 i = 0; i < InNum; ++i)
+            {
+                OutDst[3 * i + 0] = InSrc[i].B;
+                OutDst[3 * i + 1] = InSrc[i].G;
+                OutDst[3 * i + 2] = InSrc[i].R;
+            }
+            break;
+
+        case EImageEncoding::MONO8:
+            // ITU-R BT.601 luma, in 8-bit fixed point
+            for (int32 i = 0; i < InNum; ++i)
+            {
+                OutDst[i] = static_cast<uint8>((77 * InSrc[i].R + 150 * InSrc[i].G + 29 * InSrc[i].B) >> 8);
+            }
+            break;
+    }
+}
+
+void URRROS2CameraComponent::ConvertAuxPixels(const FLinearColor* InSrc,
+                                              const int32 InNum,
+                                              const int32 InRow,
+                                              const bool bInDepth16,
+                                              TArray<uint8> (&OutAuxImages)[3])
+{
+    TArray<uint8>& depthImage = OutAuxImages[GetAuxOutputIndex(ERRCameraOutput::DEPTH)];
+    if (depthImage.Num() > 0)
+    {
+        if (bInDepth16)
+        {
+            // [cm] -> [mm], 0 if out of range
+            uint16* dst = reinterpret_cast<uint16*>(depthImage.GetData()) + InRow * InNum;
+            for (int32 i = 0; i < InNum; ++i)
+            {
+                const float depthMm = InSrc[i].R * 10.f;
+                dst[i] = (depthMm < 65535.f) ? static_cast<uint16>(depthMm) : 0;
+            }
+        }
+        else
+        {
+            // [cm] -> [m]
+            float* dst = reinterpret_cast<float*>(depthImage.GetData()) + InRow * InNum;
+            for (int32 i = 0; i < InNum; ++i)
+            {
+                dst[i] = InSrc[i].R * .01f;
+            }
+        }
+    }
+
+    TArray<uint8>& segmentationImage = OutAuxImages[GetAuxOutputIndex(ERRCameraOutput::SEGMENTATION)];
+    if (segmentationImage.Num() > 0)
+    {
+        uint8* dst = segmentationImage.GetData() + InRow * InNum;
+        for (int32 i = 0; i < InNum; ++i)
+        {
+            dst[i] = static_cast<uint8>(FMath::Clamp(FMath::RoundToInt32(InSrc[i].G), 0, 255));
+        }
+    }
+
+    TArray<uint8>& normalsImage = OutAuxImages[GetAuxOutputIndex(ERRCameraOutput::NORMALS)];
+    if (normalsImage.Num() > 0)
+    {
+        float* dst = reinterpret_cast<float*>(normalsImage.GetData()) + 3 * InRow * InNum;
+        for (int32 i = 0; i < InNum; ++i)
+        {
+            // Octahedral decoding
+            FVector3f normal(InSrc[i].B, InSrc[i].A, 1.f - FMath::Abs(InSrc[i].B) - FMath::Abs(InSrc[i].A));
+            if (normal.Z < 0.f)
+            {
+                const float x = normal.X;
+                normal.X = (1.f - FMath::Abs(normal.Y)) * FMath::Sign(x);
+                normal.Y = (1.f - FMath::Abs(x)) * FMath::Sign(normal.Y);
+            }
+            normal.Normalize();
+
+            // left handed -> right handed
+            dst[3 * i + 0] = normal.X;
+            dst[3 * i + 1] = -normal.Y;
+            dst[3 * i + 2] = normal.Z;
+        }
+    }
+}
+
+bool URRROS2CameraComponent::UpdateImageMsg()
+{
+    bool bConsumed = false;
+    if (QueueCount > 0)
+    {
+        // Timestamp
+        Data.Header.Stamp = URRConversionUtils::GetCurrentROS2Time(this);
+
+        // Consume the oldest capture if its readback is done, never blocking on GPU
+        bConsumed = ConsumeRenderRequest();
+    }
+    if (QueueCount > 0)
+    {
+        PollReadbacks();
+    }
+    return bConsumed;
+}
+
+FROSImg URRROS2CameraComponent::GetROS2Data()
+{
+    UpdateImageMsg();
     return Data;
 }
 
 void URRROS2CameraComponent::SetROS2Msg(UROS2GenericMsg* InMessage)
 {
-    CastChecked<UROS2ImgMsg>(InMessage)->SetMsg(GetROS2Data());
+    UpdateImageMsg();
+    FRRROS2MsgWriter::WriteImg(Data, InMessage);
+}
+
+void URRROS2CameraComponent::SetOutputROS2Msg(const ERRCameraOutput InOutput, UROS2GenericMsg* InMessage)
+{
+    if (InOutput == ERRCameraOutput::COLOR)
+    {
+        SetROS2Msg(InMessage);
+        return;
+    }
+
+    // Consumed together with the color image, by SetROS2Msg()
+    FRRROS2MsgWriter::WriteImg(AuxData[GetAuxOutputIndex(InOutput)], InMessage);
 }
@@ -0,0 +1,122 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Sensors/RRROS2ContactSensorComponent.h"
+
+// UE
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRConversionUtils.h"
+#include "Core/RRCoreUtils.h"
+#include "Tools/RRROS2ContactsStatePublisher.h"
+
+URRROS2ContactSensorComponent::URRROS2ContactSensorComponent()
+{
+    SensorPublisherClass = URRROS2ContactsStatePublisher::StaticClass();
+    TopicName = TEXT("bumper");
+    FrameId = TEXT("base_link");
+    PublicationFrequencyHz = 20;
+    OverloadTier = ERRSensorOverloadTier::SAFETY;
+}
+
+void URRROS2ContactSensorComponent::Run()
+{
+    FRRContactManager* contactManager = FRRContactManager::Get(GetWorld());
+    if (nullptr == contactManager)
+    {
+        UE_LOG_WITH_INFO_NAMED(LogRapyutaCore, Error, TEXT("World has no physics solver to sense contacts of"));
+        return;
+    }
+
+    if ((Bodies.Num() == 0) && GetOwner())
+    {
+        GetOwner()->ForEachComponent<UPrimitiveComponent>(false,
+                                                          [this](UPrimitiveComponent* InBody)
+                                                          {
+                                                              if (InBody->IsCollisionEnabled())
+                                                              {
+                                                                  Bodies.Add(InBody);
+                                                              }
+                                                          });
+    }
+    for (UPrimitiveComponent* body : Bodies)
+    {
+        if (body)
+        {
+            contactManager->AddBody(body, this);
+        }
+    }
+    PendingContacts.Reset();
+    LastUpdateTime = GetWorld()->GetTimeSeconds();
+    Super::Run();
+}
+
+void URRROS2ContactSensorComponent::Stop()
+{
+    Super::Stop();
+    if (FRRContactManager* contactManager = FRRContactManager::Get(GetWorld()))
+    {
+        contactManager->RemoveSensor(this);
+    }
+    PendingContacts.Reset();
+}
+
+void URRROS2ContactSensorComponent::SensorUpdate()
+{
+    const double currentTime = GetWorld()->GetTimeSeconds();
+    const double deltaTime = FMath::Max(currentTime - LastUpdateTime, UE_SMALL_NUMBER);
+    LastUpdateTime = currentTime;
+
+    Data.Header.Stamp = URRConversionUtils::FloatToROSStamp(currentTime);
+    Data.Header.FrameId = FrameId;
+    Data.States.Reset();
+    bInContact = (PendingContacts.Num() > 0);
+
+    // One state per pair of colliding bodies
+    const FTransform sensorInverse = GetComponentTransform().Inverse();
+    TMap<TPair<const UPrimitiveComponent*, const UPrimitiveComponent*>, int32> stateIndices;
+    for (const FRRContact& contact : PendingContacts)
+    {
+        const UPrimitiveComponent* body = contact.Body.Get();
+        const UPrimitiveComponent* otherBody = contact.OtherBody.Get();
+        if ((nullptr == body) || (nullptr == otherBody))
+        {
+            continue;
+        }
+
+        int32& stateIndex = stateIndices.FindOrAdd(MakeTuple(body, otherBody), INDEX_NONE);
+        if (INDEX_NONE == stateIndex)
+        {
+            stateIndex = Data.States.AddDefaulted();
+            FROSContactState& newState = Data.States[stateIndex];
+            newState.Collision1Name = FString::Printf(TEXT("%s::%s"), *GetNameSafe(body->GetOwner()), *body->GetName());
+            newState.Collision2Name =
+                FString::Printf(TEXT("%s::%s"), *GetNameSafe(otherBody->GetOwner()), *otherBody->GetName());
+            newState.Info = FString::Printf(TEXT("%s collides with %s"), *newState.Collision1Name, *newState.Collision2Name);
+        }
+
+        // Mean force over the update period, torque about the body origin, in ROS units of this sensor's frame
+        FROSContactState& state = Data.States[stateIndex];
+        const FVector position = URRConversionUtils::VectorUEToROS(sensorInverse.TransformPosition(contact.Location));
+        const FVector force =
+            URRConversionUtils::VectorUEToROS(sensorInverse.TransformVectorNoScale(contact.Impulse)) / deltaTime;
+        const FVector bodyPosition =
+            URRConversionUtils::VectorUEToROS(sensorInverse.TransformPosition(body->GetComponentLocation()));
+        FROSWrench wrench;
+        wrench.Force = force;
+        wrench.Torque = FVector::CrossProduct(position - bodyPosition, force);
+        state.Wrenches.Add(wrench);
+        state.TotalWrench.Force += wrench.Force;
+        state.TotalWrench.Torque += wrench.Torque;
+        state.ContactPositions.Add(position);
+        state.ContactNormals.Add(URRConversionUtils::ConvertHandedness(sensorInverse.TransformVectorNoScale(contact.Normal)));
+        state.Depths.Add(URRConversionUtils::DistanceUEToROS(contact.PenetrationDepth));
+    }
+    PendingContacts.Reset();
+}
+
+void URRROS2ContactSensorComponent::SetROS2Msg(UROS2GenericMsg* InMessage)
+{
+    CastChecked<UROS2ContactsStateMsg>(InMessage)->SetMsg(Data);
+}
@@ -51,6 +51,36 @@ FROSEntityState URRROS2EntityStateSensorComponent::GetROS2Data()
     return Data;
 }
 
+void URRROS2EntityStateSensorComponent::Run()
+{
+    Super::Run();
+    if (bPublishOnlyOnChange && !bAsyncPublish && IsValid(SensorPublisher) && !SensorPublisher->bLoanMessages)
+    {
+        // Through HandOff(), which checks HasDataToPublish()
+        SensorPublisher->StartTimerPublishing(PublicationFrequencyHz);
+    }
+}
+
+void URRROS2EntityStateSensorComponent::Stop()
+{
+    Super::Stop();
+    if (bPublishOnlyOnChange && IsValid(SensorPublisher))
+    {
+        SensorPublisher->StopTimerPublishing();
+    }
+}
+
+bool URRROS2EntityStateSensorComponent::HasDataToPublish() const
+{
+    if (!bPublishOnlyOnChange || bChangedSincePublished || (PublishedTime < 0.))
+    {
+        return true;
+    }
+    const UWorld* world = GetWorld();
+    return (MaxUnchangedPublishInterval > 0.f) && world &&
+           ((world->GetTimeSeconds() - PublishedTime) >= MaxUnchangedPublishInterval);
+}
+
 void URRROS2EntityStateSensorComponent::SensorUpdate()
 {
     FTransform relativeTransf;
@@ -69,18 +99,51 @@ void URRROS2EntityStateSensorComponent::SensorUpdate()
 
     Data.Pose.Position = relativeTransf.GetTranslation() + RootOffset.GetTranslation();
     Data.Pose.Orientation = relativeTransf.GetRotation() * RootOffset.GetRotation();
-    Data.ReferenceFrame = ReferenceActorName;
+    // Not reassigned every update, reusing the string buffer
+    if (!Data.ReferenceFrame.Equals(ReferenceActorName, ESearchCase::CaseSensitive))
+    {
+        Data.ReferenceFrame = ReferenceActorName;
+        bChangedSincePublished = true;
+    }
+
+    const double currentTime = GetWorld()->GetTimeSeconds();
+    const double deltaTime = currentTime - PrevUpdateTime;
+    if (bEstimateTwist && bIsValid && (PrevUpdateTime >= 0.) && (deltaTime > UE_SMALL_NUMBER))
+    {
+        Data.Twist.Linear = (Data.Pose.Position - PrevPose.Position) / deltaTime;
 
-    // todo calc vel
-    Data.Twist.Linear = FVector::ZeroVector;
-    Data.Twist.Angular = FVector::ZeroVector;
+        // Shortest rotation from the previous orientation, as axis * angle
+        FQuat deltaQuat = Data.Pose.Orientation * PrevPose.Orientation.Inverse();
+        deltaQuat.EnforceShortestArcWith(FQuat::Identity);
+        FVector axis;
+        double angle = 0.;
+        deltaQuat.ToAxisAndAngle(axis, angle);
+        Data.Twist.Angular = axis * (angle / deltaTime);
+    }
+    else if (!bEstimateTwist || !bIsValid)
+    {
+        Data.Twist.Linear = FVector::ZeroVector;
+        Data.Twist.Angular = FVector::ZeroVector;
+    }
+    PrevPose = Data.Pose;
+    PrevUpdateTime = currentTime;
+
+    if (bPublishOnlyOnChange && !bChangedSincePublished)
+    {
+        bChangedSincePublished = (FVector::Dist(Data.Pose.Position, PublishedPose.Position) > PositionChangeThreshold) ||
+                                 (Data.Pose.Orientation.AngularDistance(PublishedPose.Orientation) > OrientationChangeThreshold);
+    }
 
     bIsValid = true;
 }
 
 void URRROS2EntityStateSensorComponent::SetROS2Msg(UROS2GenericMsg* InMessage)
 {
-    CastChecked<UROS2EntityStateMsg>(InMessage)->SetMsg(GetROS2Data());
+    // Data as is, without the copy of GetROS2Data()
+    CastChecked<UROS2EntityStateMsg>(InMessage)->SetMsg(Data);
+    PublishedPose = Data.Pose;
+    PublishedTime = GetWorld()->GetTimeSeconds();
+    bChangedSincePublished = false;
 }
 
 void URRROS2EntityStateSensorComponent::SetRootOffset(const FTransform& InRootOffset)
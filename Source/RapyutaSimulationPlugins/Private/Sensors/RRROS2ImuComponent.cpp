@@ -0,0 +1,144 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Sensors/RRROS2ImuComponent.h"
+
+// UE
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRConversionUtils.h"
+#include "Core/RRCoreUtils.h"
+#include "Drives/RRPhysicsSubstepManager.h"
+#include "Tools/RRROS2ImuPublisher.h"
+
+URRROS2ImuComponent::URRROS2ImuComponent()
+{
+    SensorPublisherClass = URRROS2ImuPublisher::StaticClass();
+    TopicName = TEXT("imu");
+    FrameId = TEXT("imu_link");
+    PublicationFrequencyHz = 100;
+    OverloadTier = ERRSensorOverloadTier::NAVIGATION;
+}
+
+void URRROS2ImuComponent::Run()
+{
+    NoiseStream.Reset(FRRNoiseUtils::MakeKey(FRRNoiseUtils::GetSensorSeed(NoiseSeed, GetPathName()), 0));
+    Ring = MakeShared<FRRImuSampleRing, ESPMode::ThreadSafe>(static_cast<uint32>(RingCapacity));
+    StartSampling();
+    Super::Run();
+}
+
+void URRROS2ImuComponent::Stop()
+{
+    Super::Stop();
+    StopSampling();
+}
+
+bool URRROS2ImuComponent::StartSampling()
+{
+    if (nullptr == Body)
+    {
+        for (USceneComponent* parent = GetAttachParent(); parent; parent = parent->GetAttachParent())
+        {
+            UPrimitiveComponent* primitiveParent = Cast<UPrimitiveComponent>(parent);
+            const FBodyInstance* bodyInstance = primitiveParent ? primitiveParent->GetBodyInstance() : nullptr;
+            if (bodyInstance && bodyInstance->IsValidBodyInstance())
+            {
+                Body = primitiveParent;
+                break;
+            }
+        }
+    }
+    FRRPhysicsSubstepManager* substepManager = FRRPhysicsSubstepManager::Get(GetWorld());
+    if ((nullptr == Body) || (nullptr == substepManager))
+    {
+        return false;
+    }
+
+    FRRImuSubstepSampler sampler;
+    sampler.Ring = Ring;
+    sampler.MountTransform = GetComponentTransform().GetRelativeTransform(Body->GetComponentTransform());
+    sampler.Gravity = FVector(0., 0., GetWorld()->GetGravityZ());
+    sampler.Time = GetWorld()->GetTimeSeconds();
+    bSampling = substepManager->SubmitImuSampler(GetUniqueID(), Body, MoveTemp(sampler));
+    return bSampling;
+}
+
+void URRROS2ImuComponent::StopSampling()
+{
+    if (bSampling)
+    {
+        if (FRRPhysicsSubstepManager* substepManager = FRRPhysicsSubstepManager::Get(GetWorld()))
+        {
+            substepManager->RemoveImu(GetUniqueID());
+        }
+        bSampling = false;
+    }
+}
+
+void URRROS2ImuComponent::SensorUpdate()
+{
+    // Body proxies may only be created after this sensor started, eg upon robot spawning
+    if (!bSampling && !StartSampling())
+    {
+        if (bIsValid)
+        {
+            UE_LOG_WITH_INFO_NAMED(LogRapyutaCore, Warning, TEXT("No physics body to mount the IMU on"));
+        }
+        bIsValid = false;
+        return;
+    }
+    bIsValid = true;
+
+    Samples.Reset();
+    if (Ring->PopAll(Samples) == 0)
+    {
+        return;
+    }
+
+    // [m/s^2] & [rad/s] -> UE units, per sample
+    if (bWithNoise)
+    {
+        const float linearStdDev = 100.f * LinearAccelerationNoiseStdDev;
+        for (FRRImuSample& sample : Samples)
+        {
+            for (uint8 i = 0; i < 3; ++i)
+            {
+                sample.LinearAcceleration[i] += NoiseStream.NextGaussian(0.f, linearStdDev);
+                sample.AngularVelocity[i] += NoiseStream.NextGaussian(0.f, AngularVelocityNoiseStdDev);
+            }
+        }
+    }
+    OnImuSamples.Broadcast(Samples);
+
+    // Decimated by averaging, low-passing as an IMU's digital filter
+    FVector linearAcceleration = FVector::ZeroVector;
+    FVector angularVelocity = FVector::ZeroVector;
+    for (const FRRImuSample& sample : Samples)
+    {
+        linearAcceleration += sample.LinearAcceleration;
+        angularVelocity += sample.AngularVelocity;
+    }
+    linearAcceleration /= Samples.Num();
+    angularVelocity /= Samples.Num();
+
+    const FRRImuSample& latestSample = Samples.Last();
+    Data.Header.Stamp = URRConversionUtils::FloatToROSStamp(latestSample.Time);
+    Data.Header.FrameId = FrameId;
+    Data.Orientation = URRConversionUtils::QuatUEToROS(latestSample.Orientation);
+    Data.LinearAcceleration = URRConversionUtils::VectorUEToROS(linearAcceleration);
+    // Axial vector, as physics angular velocities in URRROS2EntityStatesPublisher
+    Data.AngularVelocity = FVector(-angularVelocity.X, angularVelocity.Y, -angularVelocity.Z);
+
+    // Of the mean of the averaged samples
+    const double linearVariance = bWithNoise ? FMath::Square(LinearAccelerationNoiseStdDev) / Samples.Num() : 0.;
+    const double angularVariance = bWithNoise ? FMath::Square(AngularVelocityNoiseStdDev) / Samples.Num() : 0.;
+    Data.LinearAccelerationCovariance = {linearVariance, 0., 0., 0., linearVariance, 0., 0., 0., linearVariance};
+    Data.AngularVelocityCovariance = {angularVariance, 0., 0., 0., angularVariance, 0., 0., 0., angularVariance};
+}
+
+void URRROS2ImuComponent::SetROS2Msg(UROS2GenericMsg* InMessage)
+{
+    CastChecked<UROS2ImuMsg>(InMessage)->SetMsg(Data);
+}
@@ -0,0 +1,166 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Sensors/RRROS2StereoCameraComponent.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRROS2NodePool.h"
+#include "Core/RRTrace.h"
+#include "Sensors/RRRenderTargetPool.h"
+#include "Tools/RRROS2MsgWriter.h"
+
+URRROS2StereoCameraComponent::URRROS2StereoCameraComponent()
+{
+    TopicName = TEXT("left/image_raw");
+}
+
+void URRROS2StereoCameraComponent::CreatePublisher(const FString& InPublisherName)
+{
+    Super::CreatePublisher(InPublisherName);
+
+    if (StereoPublishers.Num() > 0)
+    {
+        return;
+    }
+    for (const auto output :
+         {ERRStereoCameraOutput::RIGHT_IMAGE, ERRStereoCameraOutput::LEFT_CAMERA_INFO, ERRStereoCameraOutput::RIGHT_CAMERA_INFO})
+    {
+        URRROS2StereoCameraPublisher* stereoPublisher = NewObject<URRROS2StereoCameraPublisher>(
+            this,
+            *FString::Printf(TEXT("%s%sPublisher"),
+                             *GetName(),
+                             *StaticEnum<ERRStereoCameraOutput>()->GetNameStringByValue(static_cast<int64>(output))));
+        stereoPublisher->DataSourceComponent = this;
+        stereoPublisher->SetStereoOutput(output);
+        StereoPublishers.Add(stereoPublisher);
+        // Initialized along the auxiliary ones
+        AuxPublishers.Add(stereoPublisher);
+    }
+}
+
+void URRROS2StereoCameraComponent::PreInitializePublisher(UROS2NodeComponent* InROS2Node, const FString& InTopicName)
+{
+    if (HasAuxOutputs() || !AtlasGroup.IsNone())
+    {
+        UE_LOG_WITH_INFO(LogROS2Sensor,
+                         Warning,
+                         TEXT("[%s] Auxiliary outputs & atlas groups are not supported by stereo cameras"),
+                         *GetName());
+        bPublishDepth = false;
+        bPublishSegmentation = false;
+        bPublishNormals = false;
+        AtlasGroup = NAME_None;
+    }
+
+    Super::PreInitializePublisher(InROS2Node, InTopicName);
+
+    // Both eyes side by side, left first
+    FRRRenderTargetPool& renderTargetPool = FRRRenderTargetPool::Get(GetWorld());
+    renderTargetPool.Return(RenderTarget);
+    RenderTarget = renderTargetPool.Lease(2 * Width, Height, EPixelFormat::PF_B8G8R8A8);
+    SceneCaptureComponent->TextureTarget = RenderTarget;
+
+    Data.Header.FrameId = FrameId;
+    RightData.Header.FrameId = RightFrameId.IsEmpty() ? FrameId : RightFrameId;
+    RightData.Width = Data.Width;
+    RightData.Height = Data.Height;
+    RightData.Encoding = Data.Encoding;
+    RightData.Step = Data.Step;
+    RightData.Data.SetNumZeroed(Data.Data.Num());
+    StereoImage.Reset();
+    InitCameraInfo(false, LeftCameraInfo);
+    InitCameraInfo(true, RightCameraInfo);
+
+    for (auto* stereoPublisher : StereoPublishers)
+    {
+        switch (stereoPublisher->GetStereoOutput())
+        {
+            case ERRStereoCameraOutput::RIGHT_IMAGE:
+                stereoPublisher->TopicName = URRROS2NodePool::GetTopicName(InROS2Node, this, RightTopicName);
+                break;
+            case ERRStereoCameraOutput::LEFT_CAMERA_INFO:
+                stereoPublisher->TopicName = URRROS2NodePool::GetTopicName(InROS2Node, this, LeftCameraInfoTopicName);
+                break;
+            case ERRStereoCameraOutput::RIGHT_CAMERA_INFO:
+                stereoPublisher->TopicName = URRROS2NodePool::GetTopicName(InROS2Node, this, RightCameraInfoTopicName);
+                break;
+        }
+    }
+}
+
+void URRROS2StereoCameraComponent::InitCameraInfo(const bool bInRight, FROSCameraInfo& OutCameraInfo) const
+{
+    // Square pixels, principal point at the image center
+    const double fx = .5 * Width / FMath::Tan(FMath::DegreesToRadians(.5 * SceneCaptureComponent->FOVAngle));
+    const double cx = .5 * Width;
+    const double cy = .5 * Height;
+    // [m], as in ROS stereo camera infos
+    const double tx = bInRight ? (-fx * Baseline * .01) : 0.;
+
+    OutCameraInfo.Header.FrameId = bInRight ? RightData.Header.FrameId : Data.Header.FrameId;
+    OutCameraInfo.Width = Width;
+    OutCameraInfo.Height = Height;
+    OutCameraInfo.DistortionModel = TEXT("plumb_bob");
+    OutCameraInfo.D = {0., 0., 0., 0., 0.};
+    OutCameraInfo.K = {fx, 0., cx, 0., fx, cy, 0., 0., 1.};
+    OutCameraInfo.R = {1., 0., 0., 0., 1., 0., 0., 0., 1.};
+    OutCameraInfo.P = {fx, 0., cx, tx, 0., fx, cy, 0., 0., 0., 1., 0.};
+}
+
+void URRROS2StereoCameraComponent::CaptureScenes()
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRStereoCameraCaptureScenes", RRSensorChannel);
+    const FVector leftLocation = SceneCaptureComponent->GetComponentLocation();
+    const FVector rightAxis = SceneCaptureComponent->GetRightVector();
+    const FSceneViewTile tiles[2] = {
+        {SceneCaptureComponent, leftLocation, FIntRect(0, 0, Width, Height)},
+        {SceneCaptureComponent, leftLocation + Baseline * rightAxis, FIntRect(Width, 0, 2 * Width, Height)}};
+    RenderSceneViews(RenderTarget, tiles);
+}
+
+URRROS2CameraComponent::FReadbackPoll URRROS2StereoCameraComponent::MakeReadbackPoll() const
+{
+    FReadbackPoll poll = Super::MakeReadbackPoll();
+    poll.Width = 2 * Width;
+    return poll;
+}
+
+bool URRROS2StereoCameraComponent::UpdateImageMsg()
+{
+    if (!Super::UpdateImageMsg())
+    {
+        return false;
+    }
+
+    // Split the consumed pair, Data.Data being recycled as the next readback image
+    Swap(StereoImage, Data.Data);
+    const int32 rowSize = Data.Step;
+    Data.Data.SetNumUninitialized(rowSize * Height, false);
+    RightData.Data.SetNumUninitialized(rowSize * Height, false);
+    for (int32 y = 0; y < Height; ++y)
+    {
+        const uint8* src = &StereoImage[2 * y * rowSize];
+        FMemory::Memcpy(&Data.Data[y * rowSize], src, rowSize);
+        FMemory::Memcpy(&RightData.Data[y * rowSize], src + rowSize, rowSize);
+    }
+    RightData.Header.Stamp = Data.Header.Stamp;
+    LeftCameraInfo.Header.Stamp = Data.Header.Stamp;
+    RightCameraInfo.Header.Stamp = Data.Header.Stamp;
+    return true;
+}
+
+void URRROS2StereoCameraComponent::SetStereoROS2Msg(const ERRStereoCameraOutput InOutput, UROS2GenericMsg* InMessage)
+{
+    // Consumed together with the left image, by SetROS2Msg()
+    switch (InOutput)
+    {
+        case ERRStereoCameraOutput::RIGHT_IMAGE:
+            FRRROS2MsgWriter::WriteImg(RightData, InMessage);
+            break;
+        case ERRStereoCameraOutput::LEFT_CAMERA_INFO:
+            CastChecked<UROS2CameraInfoMsg>(InMessage)->SetMsg(LeftCameraInfo);
+            break;
+        case ERRStereoCameraOutput::RIGHT_CAMERA_INFO:
+            CastChecked<UROS2CameraInfoMsg>(InMessage)->SetMsg(RightCameraInfo);
+            break;
+    }
+}
@@ -0,0 +1,76 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Sensors/RRRenderTargetPool.h"
+
+// UE
+#include "Engine/TextureRenderTarget2D.h"
+#include "Engine/World.h"
+#include "UObject/Package.h"
+
+TMap<UWorld*, TUniquePtr<FRRRenderTargetPool>> FRRRenderTargetPool::SPools;
+std::once_flag FRRRenderTargetPool::OnceFlag;
+
+FRRRenderTargetPool& FRRRenderTargetPool::Get(UWorld* InWorld)
+{
+    check(IsInGameThread());
+    std::call_once(OnceFlag, []() { FWorldDelegates::OnPostWorldCleanup.AddStatic(&FRRRenderTargetPool::OnPostWorldCleanup); });
+
+    TUniquePtr<FRRRenderTargetPool>& pool = SPools.FindOrAdd(InWorld);
+    if (!pool.IsValid())
+    {
+        pool = MakeUnique<FRRRenderTargetPool>();
+    }
+    return *pool;
+}
+
+void FRRRenderTargetPool::OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/)
+{
+    // The render targets are garbage collected once unreferenced by the pool
+    SPools.Remove(InWorld);
+}
+
+UTextureRenderTarget2D* FRRRenderTargetPool::Lease(const int32 InWidth, const int32 InHeight, const EPixelFormat InFormat)
+{
+    UTextureRenderTarget2D* renderTarget = nullptr;
+    TArray<UTextureRenderTarget2D*>* freeTargets = FreeTargets.Find(MakeKey(InWidth, InHeight, InFormat));
+    if (freeTargets && (freeTargets->Num() > 0))
+    {
+        renderTarget = freeTargets->Pop(false);
+    }
+    else
+    {
+        // Outered to the transient package to outlive the leasing component
+        renderTarget = NewObject<UTextureRenderTarget2D>(GetTransientPackage(), NAME_None, RF_Transient);
+        renderTarget->InitCustomFormat(InWidth, InHeight, InFormat, true);
+    }
+    LeasedTargets.Add(renderTarget);
+    return renderTarget;
+}
+
+void FRRRenderTargetPool::Return(UTextureRenderTarget2D* InRenderTarget)
+{
+    if (InRenderTarget && (LeasedTargets.RemoveSingleSwap(InRenderTarget, false) > 0))
+    {
+        FreeTargets.FindOrAdd(MakeKey(InRenderTarget->SizeX, InRenderTarget->SizeY, InRenderTarget->GetFormat()))
+            .Add(InRenderTarget);
+    }
+}
+
+int32 FRRRenderTargetPool::GetFreeTargetsNum() const
+{
+    int32 num = 0;
+    for (const auto& freeTargets : FreeTargets)
+    {
+        num += freeTargets.Value.Num();
+    }
+    return num;
+}
+
+void FRRRenderTargetPool::AddReferencedObjects(FReferenceCollector& Collector)
+{
+    for (auto& freeTargets : FreeTargets)
+    {
+        Collector.AddReferencedObjects(freeTargets.Value);
+    }
+    Collector.AddReferencedObjects(LeasedTargets);
+}
@@ -0,0 +1,852 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Sensors/RRSensorRayCaster.h"
+
+// Native
+#include <type_traits>
+
+// UE
+#include "Algo/Partition.h"
+#include "Async/ParallelFor.h"
+#include "Chaos/TriangleMeshImplicitObject.h"
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Materials/MaterialInterface.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRTrace.h"
+#include "RapyutaSimulationPlugins.h"
+#include "Sensors/RRBaseLidarComponent.h"
+#include "Tools/SimulationState.h"
+
+static TAutoConsoleVariable<bool> CVarSensorRayCasterDiskCache(
+    TEXT("rr.SensorRayCaster.DiskCache"),
+    true,
+    TEXT("Whether the sensor ray caster static BVH is cached to Saved/RRSensorRayCaster, then loaded from it on later runs."),
+    ECVF_Default);
+
+namespace
+{
+//! Bumped upon any change of the cache file layout or of the static geometry extraction
+constexpr uint32 CACHE_MAGIC = 0x48564252;    // "RBVH"
+constexpr uint32 CACHE_VERSION = 1;
+
+template<typename T>
+void SerializeRawArray(FArchive& Ar, TArray<T>& InOutArray)
+{
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable elements are serialized as raw memory");
+    int32 num = InOutArray.Num();
+    Ar << num;
+    if (Ar.IsLoading())
+    {
+        if ((num < 0) || (static_cast<int64>(num) * sizeof(T) > static_cast<uint64>(Ar.TotalSize() - Ar.Tell())))
+        {
+            Ar.SetError();
+            return;
+        }
+        InOutArray.SetNumUninitialized(num);
+    }
+    Ar.Serialize(InOutArray.GetData(), static_cast<int64>(num) * sizeof(T));
+}
+
+FORCEINLINE FVector3f SafeInverse(const FVector3f& InDir)
+{
+    auto inverse = [](const float InX) { return 1.f / ((FMath::Abs(InX) > 1e-12f) ? InX : ((InX >= 0.f) ? 1e-12f : -1e-12f)); };
+    return FVector3f(inverse(InDir.X), inverse(InDir.Y), inverse(InDir.Z));
+}
+
+//! Slab test of a ray against a node's bounds, within [InMinDistance, InMaxDistance]
+FORCEINLINE bool IntersectNode(const FRRBVH::FNode& InNode,
+                               const FVector3f& InOrigin,
+                               const FVector3f& InInvDir,
+                               const float InMinDistance,
+                               const float InMaxDistance,
+                               float& OutEntry)
+{
+    const FVector3f t0 = (InNode.Min - InOrigin) * InInvDir;
+    const FVector3f t1 = (InNode.Max - InOrigin) * InInvDir;
+    const float entry =
+        FMath::Max(FMath::Max3(FMath::Min(t0.X, t1.X), FMath::Min(t0.Y, t1.Y), FMath::Min(t0.Z, t1.Z)), InMinDistance);
+    const float exit =
+        FMath::Min(FMath::Min3(FMath::Max(t0.X, t1.X), FMath::Max(t0.Y, t1.Y), FMath::Max(t0.Z, t1.Z)), InMaxDistance);
+    OutEntry = entry;
+    return entry <= exit;
+}
+
+FORCEINLINE float GetHalfArea(const FBox3f& InBox)
+{
+    const FVector3f size = InBox.Max - InBox.Min;
+    return size.X * size.Y + size.Y * size.Z + size.Z * size.X;
+}
+
+FORCEINLINE bool IsBlockingSensorRays(const UPrimitiveComponent* InComponent)
+{
+    return InComponent->IsQueryCollisionEnabled() && (InComponent->GetCollisionResponseToChannel(ECC_Visibility) == ECR_Block);
+}
+}    // namespace
+
+void FRRBVH::Build(const TArray<FBox3f>& InPrimBounds, TArray<int32>& OutOrder)
+{
+    Nodes.Reset();
+    const int32 primsNum = InPrimBounds.Num();
+    OutOrder.SetNumUninitialized(primsNum);
+    if (primsNum == 0)
+    {
+        return;
+    }
+
+    TArray<FVector3f> centroids;
+    centroids.SetNumUninitialized(primsNum);
+    for (int32 i = 0; i < primsNum; ++i)
+    {
+        OutOrder[i] = i;
+        centroids[i] = InPrimBounds[i].GetCenter();
+    }
+
+    struct FBuildTask
+    {
+        int32 NodeIdx = 0;
+        int32 First = 0;
+        int32 Count = 0;
+    };
+    TArray<FBuildTask, TInlineAllocator<64>> tasks;
+    Nodes.Reserve(2 * FMath::DivideAndRoundUp(primsNum, 2));
+    Nodes.AddDefaulted();
+    tasks.Add({0, 0, primsNum});
+    while (tasks.Num() > 0)
+    {
+        const FBuildTask task = tasks.Pop(false);
+        FBox3f bounds(ForceInit);
+        FBox3f centroidBounds(ForceInit);
+        for (int32 i = task.First; i < task.First + task.Count; ++i)
+        {
+            bounds += InPrimBounds[OutOrder[i]];
+            centroidBounds += centroids[OutOrder[i]];
+        }
+        Nodes[task.NodeIdx].Min = bounds.Min;
+        Nodes[task.NodeIdx].Max = bounds.Max;
+
+        const FVector3f extent = centroidBounds.Max - centroidBounds.Min;
+        const int32 axis = (extent.X >= extent.Y) ? ((extent.X >= extent.Z) ? 0 : 2) : ((extent.Y >= extent.Z) ? 1 : 2);
+        int32 leftCount = 0;
+        if ((task.Count > 1) && (extent[axis] > 0.f))
+        {
+            // Binned SAH along the widest centroids axis
+            const float binScale = SAH_BINS_NUM / extent[axis];
+            auto getBin = [&centroids, &centroidBounds, axis, binScale](const int32 InPrim)
+            {
+                return FMath::Min(static_cast<int32>((centroids[InPrim][axis] - centroidBounds.Min[axis]) * binScale),
+                                  SAH_BINS_NUM - 1);
+            };
+            FBox3f binBounds[SAH_BINS_NUM];
+            int32 binCounts[SAH_BINS_NUM] = {};
+            for (FBox3f& binBox : binBounds)
+            {
+                binBox.Init();
+            }
+            for (int32 i = task.First; i < task.First + task.Count; ++i)
+            {
+                const int32 bin = getBin(OutOrder[i]);
+                binBounds[bin] += InPrimBounds[OutOrder[i]];
+                ++binCounts[bin];
+            }
+
+            float rightCosts[SAH_BINS_NUM] = {};
+            FBox3f rightBox(ForceInit);
+            int32 rightCount = 0;
+            for (int32 bin = SAH_BINS_NUM - 1; bin > 0; --bin)
+            {
+                rightBox += binBounds[bin];
+                rightCount += binCounts[bin];
+                rightCosts[bin] = (rightCount > 0) ? (rightCount * GetHalfArea(rightBox)) : 0.f;
+            }
+            FBox3f leftBox(ForceInit);
+            int32 leftBinsCount = 0;
+            float bestCost = TNumericLimits<float>::Max();
+            int32 bestSplit = INDEX_NONE;
+            for (int32 bin = 0; bin < SAH_BINS_NUM - 1; ++bin)
+            {
+                leftBox += binBounds[bin];
+                leftBinsCount += binCounts[bin];
+                if ((leftBinsCount == 0) || (leftBinsCount == task.Count))
+                {
+                    continue;
+                }
+                const float cost = leftBinsCount * GetHalfArea(leftBox) + rightCosts[bin + 1];
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestSplit = bin;
+                }
+            }
+            if ((INDEX_NONE != bestSplit) && ((task.Count > MAX_LEAF_SIZE) || (bestCost < task.Count * GetHalfArea(bounds))))
+            {
+                leftCount = Algo::Partition(OutOrder.GetData() + task.First,
+                                            task.Count,
+                                            [&getBin, bestSplit](const int32 InPrim) { return getBin(InPrim) <= bestSplit; });
+            }
+        }
+        if ((leftCount == 0) && (task.Count > MAX_LEAF_SIZE))
+        {
+            // Coincident centroids
+            leftCount = task.Count / 2;
+        }
+
+        if (leftCount == 0)
+        {
+            Nodes[task.NodeIdx].Index = task.First;
+            Nodes[task.NodeIdx].Count = task.Count;
+            continue;
+        }
+        const int32 leftIdx = Nodes.AddDefaulted(2);
+        Nodes[task.NodeIdx].Index = leftIdx;
+        Nodes[task.NodeIdx].Count = 0;
+        tasks.Add({leftIdx, task.First, leftCount});
+        tasks.Add({leftIdx + 1, task.First + leftCount, task.Count - leftCount});
+    }
+}
+
+template<typename TFunc>
+void FRRBVH::Traverse(const FVector3f& InOrigin,
+                      const FVector3f& InInvDir,
+                      const float InMinDistance,
+                      float& InOutMaxDistance,
+                      TFunc&& InVisitLeaf) const
+{
+    float rootEntry = 0.f;
+    if (IsEmpty() || !IntersectNode(Nodes[0], InOrigin, InInvDir, InMinDistance, InOutMaxDistance, rootEntry))
+    {
+        return;
+    }
+
+    struct FStackEntry
+    {
+        int32 NodeIdx = 0;
+        float Entry = 0.f;
+    };
+    TArray<FStackEntry, TInlineAllocator<64>> stack;
+    stack.Add({0, rootEntry});
+    while (stack.Num() > 0)
+    {
+        const FStackEntry top = stack.Pop(false);
+        // Farther than a hit found since being pushed
+        if (top.Entry > InOutMaxDistance)
+        {
+            continue;
+        }
+        const FNode& node = Nodes[top.NodeIdx];
+        if (node.Count > 0)
+        {
+            InVisitLeaf(node.Index, node.Count, InOutMaxDistance);
+            continue;
+        }
+
+        float leftEntry = 0.f;
+        float rightEntry = 0.f;
+        const bool bLeft = IntersectNode(Nodes[node.Index], InOrigin, InInvDir, InMinDistance, InOutMaxDistance, leftEntry);
+        const bool bRight = IntersectNode(Nodes[node.Index + 1], InOrigin, InInvDir, InMinDistance, InOutMaxDistance, rightEntry);
+        // Nearest child on top
+        if (bLeft && bRight)
+        {
+            const bool bLeftNearer = leftEntry <= rightEntry;
+            stack.Add(bLeftNearer ? FStackEntry{node.Index + 1, rightEntry} : FStackEntry{node.Index, leftEntry});
+            stack.Add(bLeftNearer ? FStackEntry{node.Index, leftEntry} : FStackEntry{node.Index + 1, rightEntry});
+        }
+        else if (bLeft)
+        {
+            stack.Add({node.Index, leftEntry});
+        }
+        else if (bRight)
+        {
+            stack.Add({node.Index + 1, rightEntry});
+        }
+    }
+}
+
+template<typename TFunc>
+void FRRBVH::TraversePacket(const FVector3f& InOrigin,
+                            const FVector3f* InInvDirs,
+                            const int32 InRaysNum,
+                            const float InMinDistance,
+                            const float* InMaxDistances,
+                            TFunc&& InVisitLeaf) const
+{
+    check(InRaysNum <= 64);
+    if (IsEmpty() || (InRaysNum <= 0))
+    {
+        return;
+    }
+
+    auto getEnteringRays = [InOrigin, InInvDirs, InMinDistance, InMaxDistances](const FNode& InNode, const uint64 InRays)
+    {
+        uint64 rays = 0;
+        float entry = 0.f;
+        for (uint64 remaining = InRays; remaining != 0; remaining &= remaining - 1)
+        {
+            const int32 ray = static_cast<int32>(FMath::CountTrailingZeros64(remaining));
+            if (IntersectNode(InNode, InOrigin, InInvDirs[ray], InMinDistance, InMaxDistances[ray], entry))
+            {
+                rays |= uint64(1) << ray;
+            }
+        }
+        return rays;
+    };
+
+    // Children are visited nearest first along the packet's middle ray
+    const FVector3f packetDir = InInvDirs[InRaysNum / 2].Reciprocal();
+    struct FStackEntry
+    {
+        int32 NodeIdx = 0;
+        uint64 Rays = 0;
+    };
+    TArray<FStackEntry, TInlineAllocator<64>> stack;
+    stack.Add({0, (InRaysNum == 64) ? ~uint64(0) : ((uint64(1) << InRaysNum) - 1)});
+    while (stack.Num() > 0)
+    {
+        const FStackEntry top = stack.Pop(false);
+        const FNode& node = Nodes[top.NodeIdx];
+        const uint64 rays = getEnteringRays(node, top.Rays);
+        if (rays == 0)
+        {
+            continue;
+        }
+        if (node.Count > 0)
+        {
+            InVisitLeaf(node.Index, node.Count, rays);
+            continue;
+        }
+
+        const FNode& left = Nodes[node.Index];
+        const FNode& right = Nodes[node.Index + 1];
+        const bool bLeftNearer = FVector3f::DotProduct(left.Min + left.Max - right.Min - right.Max, packetDir) <= 0.f;
+        stack.Add({bLeftNearer ? (node.Index + 1) : node.Index, rays});
+        stack.Add({bLeftNearer ? node.Index : (node.Index + 1), rays});
+    }
+}
+
+void FRRSensorRayScene::IntersectTriangles(const int32 InFirst,
+                                           const int32 InCount,
+                                           const FVector3f& InOrigin,
+                                           const FVector3f& InDir,
+                                           const float InMinDistance,
+                                           const uint32 InIgnoredActorId,
+                                           float& InOutDistance,
+                                           int32& OutTriangle) const
+{
+    for (int32 t = InFirst; t < InFirst + InCount; ++t)
+    {
+        // Two-sided Moller-Trumbore
+        const FTriangle& triangle = Static->Triangles[t];
+        const FVector3f p = FVector3f::CrossProduct(InDir, triangle.E2);
+        const float det = FVector3f::DotProduct(triangle.E1, p);
+        if (FMath::Abs(det) < 1e-8f)
+        {
+            continue;
+        }
+        const float invDet = 1.f / det;
+        const FVector3f s = InOrigin - triangle.V0;
+        const float u = FVector3f::DotProduct(s, p) * invDet;
+        if ((u < 0.f) || (u > 1.f))
+        {
+            continue;
+        }
+        const FVector3f q = FVector3f::CrossProduct(s, triangle.E1);
+        const float v = FVector3f::DotProduct(InDir, q) * invDet;
+        if ((v < 0.f) || (u + v > 1.f))
+        {
+            continue;
+        }
+        const float distance = FVector3f::DotProduct(triangle.E2, q) * invDet;
+        if ((distance >= InMinDistance) && (distance < InOutDistance) &&
+            (Static->SourceActorIds[triangle.SourceIndex] != InIgnoredActorId))
+        {
+            InOutDistance = distance;
+            OutTriangle = t;
+        }
+    }
+}
+
+void FRRSensorRayScene::SetStaticHit(const FVector& InOrigin,
+                                     const FVector3f& InDir,
+                                     const float InMinDistance,
+                                     const float InMaxDistance,
+                                     const float InDistance,
+                                     const int32 InTriangle,
+                                     FRRLidarHit& OutHit) const
+{
+    if (INDEX_NONE == InTriangle)
+    {
+        OutHit.SetMiss(InOrigin + FVector(InDir) * InMaxDistance);
+        return;
+    }
+
+    const FTriangle& triangle = Static->Triangles[InTriangle];
+    OutHit = FRRLidarHit();
+    OutHit.bHit = true;
+    OutHit.Point = FVector3f(InOrigin + FVector(InDir) * InDistance);
+    OutHit.Distance = InDistance - InMinDistance;
+    OutHit.ActorId = Static->SourceActorIds[triangle.SourceIndex];
+    OutHit.SurfaceType = triangle.SurfaceType;
+    OutHit.NormalAlignment =
+        FMath::Abs(FVector3f::DotProduct(FVector3f::CrossProduct(triangle.E1, triangle.E2).GetSafeNormal(), InDir));
+}
+
+void FRRSensorRayScene::RaycastDynamic(const FVector& InStart,
+                                       const FVector3f& InDir,
+                                       const float InLength,
+                                       const uint32 InIgnoredActorId,
+                                       FRRLidarHit& InOutHit) const
+{
+    if (DynamicBVH.IsEmpty())
+    {
+        return;
+    }
+
+    static const FCollisionQueryParams SDynamicTraceParams = []()
+    {
+        FCollisionQueryParams params(TEXT("RR_Sensor_Ray"), true);
+        params.bReturnPhysicalMaterial = true;
+        return params;
+    }();
+    float maxDistance = InOutHit.bHit ? InOutHit.Distance : InLength;
+    DynamicBVH.Traverse(FVector3f(InStart),
+                        SafeInverse(InDir),
+                        0.f,
+                        maxDistance,
+                        [this, &InStart, &InDir, InIgnoredActorId, &InOutHit](
+                            const int32 InFirst, const int32 InCount, float& InOutMaxDistance)
+                        {
+                            for (int32 i = InFirst; i < InFirst + InCount; ++i)
+                            {
+                                const FDynamicPrimitive& primitive = DynamicPrimitives[i];
+                                UPrimitiveComponent* component = primitive.Component.Get();
+                                if ((primitive.ActorId == InIgnoredActorId) || (nullptr == component))
+                                {
+                                    continue;
+                                }
+                                FHitResult hit;
+                                const FVector end = InStart + FVector(InDir) * InOutMaxDistance;
+                                if (component->LineTraceComponent(hit, InStart, end, SDynamicTraceParams) &&
+                                    (hit.Distance < InOutMaxDistance))
+                                {
+                                    hit.TraceStart = InStart;
+                                    hit.TraceEnd = end;
+                                    InOutHit.SetFromHitResult(hit);
+                                    InOutMaxDistance = hit.Distance;
+                                }
+                            }
+                        });
+}
+
+void FRRSensorRayScene::Raycast(const FVector& InStart,
+                                const FVector3f& InDir,
+                                const float InLength,
+                                const uint32 InIgnoredActorId,
+                                FRRLidarHit& OutHit) const
+{
+    const FVector3f origin(InStart);
+    float distance = InLength;
+    int32 triangle = INDEX_NONE;
+    if (Static.IsValid())
+    {
+        Static->BVH.Traverse(origin,
+                             SafeInverse(InDir),
+                             0.f,
+                             distance,
+                             [this, &origin, &InDir, InIgnoredActorId, &triangle](
+                                 const int32 InFirst, const int32 InCount, float& InOutMaxDistance)
+                             {
+                                 IntersectTriangles(
+                                     InFirst, InCount, origin, InDir, 0.f, InIgnoredActorId, InOutMaxDistance, triangle);
+                             });
+    }
+    SetStaticHit(InStart, InDir, 0.f, InLength, distance, triangle, OutHit);
+    RaycastDynamic(InStart, InDir, InLength, InIgnoredActorId, OutHit);
+}
+
+void FRRSensorRayScene::RaycastPacket(const FVector& InOrigin,
+                                      const float* InDirX,
+                                      const float* InDirY,
+                                      const float* InDirZ,
+                                      const int32 InRaysNum,
+                                      const float InMinDistance,
+                                      const float InMaxDistance,
+                                      const uint32 InIgnoredActorId,
+                                      const TBitArray<>* InSkippedRays,
+                                      FRRLidarHit* OutHits) const
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRSensorRaycastPacket", RRSensorChannel);
+    const FVector3f origin(InOrigin);
+    ParallelFor(
+        FMath::DivideAndRoundUp(InRaysNum, PACKET_SIZE),
+        [&](int32 InPacket)
+        {
+            const int32 first = InPacket * PACKET_SIZE;
+            const int32 raysNum = FMath::Min(PACKET_SIZE, InRaysNum - first);
+            FVector3f dirs[PACKET_SIZE];
+            FVector3f invDirs[PACKET_SIZE];
+            float distances[PACKET_SIZE];
+            int32 triangles[PACKET_SIZE];
+            for (int32 i = 0; i < raysNum; ++i)
+            {
+                dirs[i] = FVector3f(InDirX[first + i], InDirY[first + i], InDirZ[first + i]);
+                invDirs[i] = SafeInverse(dirs[i]);
+                // Skipped rays never enter any node
+                distances[i] = (InSkippedRays && (*InSkippedRays)[first + i]) ? -1.f : InMaxDistance;
+                triangles[i] = INDEX_NONE;
+            }
+
+            if (Static.IsValid())
+            {
+                Static->BVH.TraversePacket(
+                    origin,
+                    invDirs,
+                    raysNum,
+                    InMinDistance,
+                    distances,
+                    [&](const int32 InFirst, const int32 InCount, const uint64 InRays)
+                    {
+                        for (uint64 remaining = InRays; remaining != 0; remaining &= remaining - 1)
+                        {
+                            const int32 ray = static_cast<int32>(FMath::CountTrailingZeros64(remaining));
+                            IntersectTriangles(InFirst,
+                                               InCount,
+                                               origin,
+                                               dirs[ray],
+                                               InMinDistance,
+                                               InIgnoredActorId,
+                                               distances[ray],
+                                               triangles[ray]);
+                        }
+                    });
+            }
+
+            for (int32 i = 0; i < raysNum; ++i)
+            {
+                FRRLidarHit& hit = OutHits[first + i];
+                if (distances[i] < 0.f)
+                {
+                    hit.SetMiss(InOrigin + FVector(dirs[i]) * InMaxDistance);
+                    continue;
+                }
+                SetStaticHit(InOrigin, dirs[i], InMinDistance, InMaxDistance, distances[i], triangles[i], hit);
+                RaycastDynamic(
+                    InOrigin + FVector(dirs[i]) * InMinDistance, dirs[i], InMaxDistance - InMinDistance, InIgnoredActorId, hit);
+            }
+        });
+}
+
+TMap<UWorld*, TUniquePtr<FRRSensorRayCaster>> FRRSensorRayCaster::SCasters;
+std::once_flag FRRSensorRayCaster::OnceFlag;
+
+FRRSensorRayCaster& FRRSensorRayCaster::Get(UWorld* InWorld)
+{
+    check(IsInGameThread());
+    std::call_once(OnceFlag, []() { FWorldDelegates::OnPostWorldCleanup.AddStatic(&FRRSensorRayCaster::OnPostWorldCleanup); });
+
+    TUniquePtr<FRRSensorRayCaster>& caster = SCasters.FindOrAdd(InWorld);
+    if (!caster.IsValid())
+    {
+        caster = MakeUnique<FRRSensorRayCaster>();
+        caster->World = InWorld;
+        caster->BuildStaticGeometry(InWorld);
+    }
+    return *caster;
+}
+
+void FRRSensorRayCaster::OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/)
+{
+    SCasters.Remove(InWorld);
+}
+
+FString FRRSensorRayCaster::GetCacheFilePath(const UWorld* InWorld, const uint32 InHash)
+{
+    return FPaths::Combine(FPaths::ProjectSavedDir(),
+                           TEXT("RRSensorRayCaster"),
+                           FString::Printf(TEXT("%s_%08x.bvh"), *InWorld->GetMapName(), InHash));
+}
+
+void FRRSensorRayCaster::BuildStaticGeometry(UWorld* InWorld)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRSensorRayCasterBuild", RRSensorChannel);
+    const double startTime = FPlatformTime::Seconds();
+
+    // 1- Gather the static primitives blocking sensor rays, in the deterministic actors order, hashing what the triangles
+    // are extracted from
+    struct FSource
+    {
+        UStaticMeshComponent* Component = nullptr;
+        UBodySetup* BodySetup = nullptr;
+    };
+    TArray<FSource> sources;
+    uint32 hash = CACHE_VERSION;
+    auto hashTransform = [&hash](const FTransform& InTransform)
+    {
+        const FVector location = InTransform.GetLocation();
+        const FQuat rotation = InTransform.GetRotation();
+        const FVector scale = InTransform.GetScale3D();
+        hash = FCrc::MemCrc32(&location, sizeof(location), hash);
+        hash = FCrc::MemCrc32(&rotation, sizeof(rotation), hash);
+        hash = FCrc::MemCrc32(&scale, sizeof(scale), hash);
+    };
+    StaticFallbackPrimitives.Reset();
+    for (TActorIterator<AActor> it(InWorld); it; ++it)
+    {
+        it->ForEachComponent<UPrimitiveComponent>(
+            false,
+            [this, &sources, &hash, &hashTransform](UPrimitiveComponent* InComponent)
+            {
+                if ((InComponent->Mobility != EComponentMobility::Static) || !IsBlockingSensorRays(InComponent))
+                {
+                    return;
+                }
+                UStaticMeshComponent* meshComponent = Cast<UStaticMeshComponent>(InComponent);
+                UStaticMesh* mesh = meshComponent ? meshComponent->GetStaticMesh() : nullptr;
+                UBodySetup* bodySetup = mesh ? mesh->GetBodySetup() : nullptr;
+                if ((nullptr == bodySetup) || (bodySetup->ChaosTriMeshes.Num() == 0) ||
+                    (bodySetup->GetCollisionTraceFlag() == CTF_UseSimpleAsComplex))
+                {
+                    // Eg landscapes, brushes or simple collision only meshes
+                    StaticFallbackPrimitives.Add(InComponent);
+                    return;
+                }
+
+                sources.Add({meshComponent, bodySetup});
+                hash = HashCombine(hash, GetTypeHash(InComponent->GetPathName()));
+                hash = HashCombine(hash, GetTypeHash(mesh->GetPathName()));
+                hashTransform(InComponent->GetComponentTransform());
+                if (const UInstancedStaticMeshComponent* ism = Cast<UInstancedStaticMeshComponent>(meshComponent))
+                {
+                    hash = FCrc::MemCrc32(ism->PerInstanceSMData.GetData(),
+                                          ism->PerInstanceSMData.Num() * ism->PerInstanceSMData.GetTypeSize(),
+                                          hash);
+                }
+                for (int32 m = 0; m < meshComponent->GetNumMaterials(); ++m)
+                {
+                    const UMaterialInterface* material = meshComponent->GetMaterial(m);
+                    hash = HashCombine(hash, GetTypeHash(material ? material->GetPathName() : FString()));
+                }
+            });
+    }
+
+    TSharedRef<FRRSensorRayScene::FStaticGeometry> geometry = MakeShared<FRRSensorRayScene::FStaticGeometry>();
+    geometry->SourceActorIds.SetNumUninitialized(sources.Num());
+    for (int32 i = 0; i < sources.Num(); ++i)
+    {
+        geometry->SourceActorIds[i] = sources[i].Component->GetOwner()->GetUniqueID();
+    }
+
+    auto serializeGeometry = [&geometry](FArchive& Ar)
+    {
+        SerializeRawArray(Ar, geometry->Triangles);
+        SerializeRawArray(Ar, geometry->BVH.Nodes);
+    };
+
+    // 2- Load the cached BVH
+    const bool bDiskCache = CVarSensorRayCasterDiskCache.GetValueOnGameThread();
+    const FString cacheFilePath = GetCacheFilePath(InWorld, hash);
+    bool bLoaded = false;
+    TArray<uint8> data;
+    if (bDiskCache && FFileHelper::LoadFileToArray(data, *cacheFilePath, FILEREAD_Silent))
+    {
+        FMemoryReader reader(data);
+        uint32 magic = 0;
+        uint32 fileHash = 0;
+        reader << magic;
+        reader << fileHash;
+        if ((CACHE_MAGIC == magic) && (hash == fileHash))
+        {
+            serializeGeometry(reader);
+            bLoaded = !reader.IsError();
+        }
+        if (!bLoaded)
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("Sensor BVH cache [%s] is corrupted, ignored"), *cacheFilePath);
+        }
+    }
+
+    // 3- Or extract the collision triangles, in world space, then build & cache their BVH
+    if (!bLoaded)
+    {
+        TArray<FRRSensorRayScene::FTriangle> triangles;
+        for (int32 sourceIdx = 0; sourceIdx < sources.Num(); ++sourceIdx)
+        {
+            UStaticMeshComponent* meshComponent = sources[sourceIdx].Component;
+            TArray<uint8, TInlineAllocator<16>> surfaceTypes;
+            for (int32 m = 0; m < meshComponent->GetNumMaterials(); ++m)
+            {
+                const UMaterialInterface* material = meshComponent->GetMaterial(m);
+                const UPhysicalMaterial* physMaterial = material ? material->GetPhysicalMaterial() : nullptr;
+                surfaceTypes.Add(physMaterial ? static_cast<uint8>(physMaterial->SurfaceType.GetValue())
+                                              : static_cast<uint8>(EPhysicalSurface::SurfaceType_Default));
+            }
+
+            TArray<FTransform, TInlineAllocator<1>> transforms;
+            if (const UInstancedStaticMeshComponent* ism = Cast<UInstancedStaticMeshComponent>(meshComponent))
+            {
+                for (int32 i = 0; i < ism->GetInstanceCount(); ++i)
+                {
+                    ism->GetInstanceTransform(i, transforms.AddDefaulted_GetRef(), true);
+                }
+            }
+            else
+            {
+                transforms.Add(meshComponent->GetComponentTransform());
+            }
+
+            for (const auto& triMesh : sources[sourceIdx].BodySetup->ChaosTriMeshes)
+            {
+                if (!triMesh.IsValid())
+                {
+                    continue;
+                }
+                const auto& particles = triMesh->Particles();
+                const Chaos::FTrimeshIndexBuffer& elements = triMesh->Elements();
+                const int32 trianglesNum = elements.GetNumTriangles();
+                for (const FTransform& transform : transforms)
+                {
+                    for (int32 t = 0; t < trianglesNum; ++t)
+                    {
+                        int32 indices[3];
+                        for (int32 k = 0; k < 3; ++k)
+                        {
+                            indices[k] = elements.RequiresLargeIndices() ? elements.GetLargeIndexBuffer()[t][k]
+                                                                         : elements.GetSmallIndexBuffer()[t][k];
+                        }
+                        FVector3f vertices[3];
+                        for (int32 k = 0; k < 3; ++k)
+                        {
+                            vertices[k] = FVector3f(transform.TransformPosition(FVector(particles.X(indices[k]))));
+                        }
+                        FRRSensorRayScene::FTriangle& triangle = triangles.AddDefaulted_GetRef();
+                        triangle.V0 = vertices[0];
+                        triangle.E1 = vertices[1] - vertices[0];
+                        triangle.E2 = vertices[2] - vertices[0];
+                        triangle.SourceIndex = sourceIdx;
+                        const int32 materialIdx = triMesh->GetMaterialIndex(t);
+                        triangle.SurfaceType = surfaceTypes.IsValidIndex(materialIdx)
+                                                   ? surfaceTypes[materialIdx]
+                                                   : static_cast<uint8>(EPhysicalSurface::SurfaceType_Default);
+                    }
+                }
+            }
+        }
+
+        TArray<FBox3f> bounds;
+        bounds.SetNumUninitialized(triangles.Num());
+        for (int32 i = 0; i < triangles.Num(); ++i)
+        {
+            const FRRSensorRayScene::FTriangle& triangle = triangles[i];
+            bounds[i] = FBox3f(ForceInit);
+            bounds[i] += triangle.V0;
+            bounds[i] += triangle.V0 + triangle.E1;
+            bounds[i] += triangle.V0 + triangle.E2;
+        }
+        TArray<int32> order;
+        geometry->BVH.Build(bounds, order);
+        geometry->Triangles.SetNumUninitialized(triangles.Num());
+        for (int32 i = 0; i < order.Num(); ++i)
+        {
+            geometry->Triangles[i] = triangles[order[i]];
+        }
+
+        if (bDiskCache)
+        {
+            data.Reset();
+            FMemoryWriter writer(data);
+            uint32 magic = CACHE_MAGIC;
+            writer << magic;
+            writer << hash;
+            serializeGeometry(writer);
+            if (!FFileHelper::SaveArrayToFile(data, *cacheFilePath))
+            {
+                UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("Failed saving sensor BVH cache [%s]"), *cacheFilePath);
+            }
+        }
+    }
+
+    Static = geometry;
+    UE_LOG_WITH_INFO(LogRapyutaCore,
+                     Log,
+                     TEXT("[%s] sensor BVH of %d triangles & %d nodes %s in %.1fms, %d static primitives traced on their own"),
+                     *InWorld->GetMapName(),
+                     geometry->Triangles.Num(),
+                     geometry->BVH.Nodes.Num(),
+                     bLoaded ? TEXT("loaded") : TEXT("built"),
+                     1000. * (FPlatformTime::Seconds() - startTime),
+                     StaticFallbackPrimitives.Num());
+}
+
+TSharedRef<const FRRSensorRayScene> FRRSensorRayCaster::GetScene()
+{
+    check(IsInGameThread());
+    if (Scene.IsValid() && (SceneFrame == GFrameCounter))
+    {
+        return Scene.ToSharedRef();
+    }
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRSensorRayCasterGetScene", RRSensorChannel);
+
+    TSharedRef<FRRSensorRayScene> scene = MakeShared<FRRSensorRayScene>();
+    scene->Static = Static;
+    TArray<FBox3f> bounds;
+    TArray<FRRSensorRayScene::FDynamicPrimitive> primitives;
+    auto addPrimitive = [&bounds, &primitives](UPrimitiveComponent* InComponent)
+    {
+        if (IsValid(InComponent) && InComponent->IsRegistered() && IsBlockingSensorRays(InComponent))
+        {
+            bounds.Add(FBox3f(InComponent->Bounds.GetBox()));
+            const AActor* owner = InComponent->GetOwner();
+            primitives.Add({InComponent, owner ? owner->GetUniqueID() : 0});
+        }
+    };
+    for (const TWeakObjectPtr<UPrimitiveComponent>& component : StaticFallbackPrimitives)
+    {
+        addPrimitive(component.Get());
+    }
+
+    if (!SimState.IsValid() && World.IsValid())
+    {
+        TActorIterator<ASimulationState> it(World.Get());
+        SimState = it ? *it : nullptr;
+    }
+    if (ASimulationState* simState = SimState.Get())
+    {
+        for (const auto& entity : simState->Entities)
+        {
+            if (IsValid(entity.Value))
+            {
+                entity.Value->ForEachComponent<UPrimitiveComponent>(false,
+                                                                    [&addPrimitive](UPrimitiveComponent* InComponent)
+                                                                    {
+                                                                        if (InComponent->Mobility != EComponentMobility::Static)
+                                                                        {
+                                                                            addPrimitive(InComponent);
+                                                                        }
+                                                                    });
+            }
+        }
+    }
+
+    TArray<int32> order;
+    scene->DynamicBVH.Build(bounds, order);
+    scene->DynamicPrimitives.SetNum(order.Num());
+    for (int32 i = 0; i < order.Num(); ++i)
+    {
+        scene->DynamicPrimitives[i] = primitives[order[i]];
+    }
+
+    Scene = scene;
+    SceneFrame = GFrameCounter;
+    return scene;
+}
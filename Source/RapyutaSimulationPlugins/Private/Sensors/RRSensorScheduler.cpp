@@ -0,0 +1,258 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Sensors/RRSensorScheduler.h"
+
+// UE
+#include "Algo/AnyOf.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRCoreUtils.h"
+#include "Core/RRMathUtils.h"
+#include "Sensors/RRROS2BaseSensorComponent.h"
+#include "Tools/RRLimitRTFFixedSizeCustomTimeStep.h"
+
+static TAutoConsoleVariable<float> CVarSensorSchedulerCPUBudgetMs(
+    TEXT("rr.SensorScheduler.CPUBudgetMs"),
+    0.f,
+    TEXT("[ms] Per-frame game thread budget of the sensor updates fired by FRRSensorScheduler, 0 for unlimited."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<bool> CVarSensorSchedulerOverloadPolicy(
+    TEXT("rr.SensorScheduler.OverloadPolicy"),
+    false,
+    TEXT("Slow down the lower overload tiers of sensors while the sim falls behind its target RTF."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSensorSchedulerOverloadRTFRatio(
+    TEXT("rr.SensorScheduler.OverloadRTFRatio"),
+    0.9f,
+    TEXT("Ratio of the target RTF below which the sim is overloaded."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSensorSchedulerOverloadMinRateScale(
+    TEXT("rr.SensorScheduler.OverloadMinRateScale"),
+    0.125f,
+    TEXT("Lowest ratio of their frequency sensors are slowed down to under overload."),
+    ECVF_Default);
+
+TMap<UWorld*, TUniquePtr<FRRSensorScheduler>> FRRSensorScheduler::SSchedulers;
+std::once_flag FRRSensorScheduler::OnceFlag;
+
+FRRSensorScheduler& FRRSensorScheduler::Get(UWorld* InWorld)
+{
+    check(IsInGameThread());
+    std::call_once(OnceFlag,
+                   []()
+                   {
+                       FWorldDelegates::OnWorldPreActorTick.AddStatic(&FRRSensorScheduler::OnWorldPreActorTick);
+                       FWorldDelegates::OnPostWorldCleanup.AddStatic(&FRRSensorScheduler::OnPostWorldCleanup);
+                   });
+
+    TUniquePtr<FRRSensorScheduler>& scheduler = SSchedulers.FindOrAdd(InWorld);
+    if (!scheduler.IsValid())
+    {
+        scheduler = MakeUnique<FRRSensorScheduler>();
+    }
+    return *scheduler;
+}
+
+void FRRSensorScheduler::OnWorldPreActorTick(UWorld* InWorld, ELevelTick InTickType, float /*InDeltaSeconds*/)
+{
+    if (InTickType == LEVELTICK_TimeOnly)
+    {
+        return;
+    }
+    if (TUniquePtr<FRRSensorScheduler>* scheduler = SSchedulers.Find(InWorld))
+    {
+        (*scheduler)->Update(InWorld->GetTimeSeconds());
+    }
+}
+
+void FRRSensorScheduler::OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/)
+{
+    SSchedulers.Remove(InWorld);
+}
+
+void FRRSensorScheduler::AddSensor(URRROS2BaseSensorComponent* InSensor)
+{
+    RemoveSensor(InSensor);
+
+    FEntry entry;
+    entry.Sensor = InSensor;
+    entry.BasePeriod = 1. / FMath::Max(InSensor->PublicationFrequencyHz, 1);
+    InSensor->OverloadRateScale = GetTierRateScale(InSensor->OverloadTier);
+    entry.Period = entry.BasePeriod / InSensor->OverloadRateScale;
+    // First due after one period as with timers, phase-shifted against the other sensors
+    entry.DueTime = InSensor->GetWorld()->GetTimeSeconds() + (1. + URRMathUtils::GetSpreadPhase(PhaseIndex++)) * entry.Period;
+    Entries.Add(entry);
+}
+
+void FRRSensorScheduler::RemoveSensor(URRROS2BaseSensorComponent* InSensor)
+{
+    Entries.RemoveAll([InSensor](const FEntry& InEntry) { return InEntry.Sensor == InSensor; });
+}
+
+void FRRSensorScheduler::Update(const double InTimeSeconds)
+{
+    // Tolerance against the accumulated float error of fixed time steps
+    static constexpr double DUE_TOLERANCE = 1e-6;
+
+    // 1- Gather due sensors
+    Entries.RemoveAll([](const FEntry& InEntry) { return !InEntry.Sensor.IsValid(); });
+    UpdateOverloadPolicy(InTimeSeconds);
+    DueEntries.Reset();
+    for (int32 i = 0; i < Entries.Num(); ++i)
+    {
+        if (Entries[i].DueTime <= InTimeSeconds + DUE_TOLERANCE)
+        {
+            DueEntries.Add(i);
+        }
+    }
+    if (DueEntries.Num() == 0)
+    {
+        return;
+    }
+
+    // 2- By priority, then the latest first
+    DueEntries.StableSort(
+        [this](const int32 InA, const int32 InB)
+        {
+            const FEntry& entryA = Entries[InA];
+            const FEntry& entryB = Entries[InB];
+            const ERRSensorPriority priorityA = entryA.Sensor->SchedulePriority;
+            const ERRSensorPriority priorityB = entryB.Sensor->SchedulePriority;
+            return (priorityA != priorityB) ? (priorityA < priorityB) : (entryA.DueTime < entryB.DueTime);
+        });
+
+    // 3- Update within the budget. Sensors may be stopped & removed by their update, thus entries are fetched by sensor.
+    const double budgetSeconds = CVarSensorSchedulerCPUBudgetMs.GetValueOnGameThread() * 1e-3;
+    double spentSeconds = 0.;
+    TArray<TWeakObjectPtr<URRROS2BaseSensorComponent>, TInlineAllocator<64>> dueSensors;
+    for (const int32 entryIndex : DueEntries)
+    {
+        dueSensors.Add(Entries[entryIndex].Sensor);
+    }
+    for (const auto& dueSensor : dueSensors)
+    {
+        URRROS2BaseSensorComponent* sensor = dueSensor.Get();
+        FEntry* entry = Entries.FindByPredicate([sensor](const FEntry& InEntry) { return InEntry.Sensor == sensor; });
+        if ((nullptr == sensor) || (nullptr == entry))
+        {
+            continue;
+        }
+        if ((budgetSeconds > 0.) && (spentSeconds >= budgetSeconds) && (sensor->SchedulePriority != ERRSensorPriority::HIGH))
+        {
+            // Kept due, thus updated first amongst its priority next frame
+            ++sensor->DeferredUpdatesNum;
+            continue;
+        }
+
+        // Exact rate: advance by whole periods from the due time
+        const double dueTime = entry->DueTime;
+        const int64 elapsedPeriodsNum = FMath::FloorToInt64((InTimeSeconds + DUE_TOLERANCE - dueTime) / entry->Period) + 1;
+        entry->DueTime = dueTime + elapsedPeriodsNum * entry->Period;
+        sensor->SkippedUpdatesNum += static_cast<int32>(elapsedPeriodsNum - 1);
+
+        const double startTime = FPlatformTime::Seconds();
+        sensor->TimedSensorUpdate();
+        spentSeconds += FPlatformTime::Seconds() - startTime;
+    }
+}
+
+void FRRSensorScheduler::UpdateOverloadPolicy(const double InTimeSeconds)
+{
+    // [s] Real time over which the RTF is measured, also the min time between two rate changes
+    static constexpr double POLICY_INTERVAL = 1.;
+    // Ratio of the target RTF from which the rates are restored, above the overload ratio not to oscillate
+    static constexpr double RECOVERY_RTF_RATIO = 0.98;
+
+    const double realTime = FPlatformTime::Seconds();
+    if (false == CVarSensorSchedulerOverloadPolicy.GetValueOnGameThread())
+    {
+        PolicyRealTime = 0.;
+        MeasuredRTF = 0.;
+        if (Algo::AnyOf(TierRateScales, [](const float InScale) { return InScale < 1.f; }))
+        {
+            for (float& scale : TierRateScales)
+            {
+                scale = 1.f;
+            }
+            ApplyTierRateScales();
+        }
+        return;
+    }
+
+    // Restarted upon being enabled or paused, not to measure the pause as overload
+    if ((PolicyRealTime <= 0.) || (InTimeSeconds <= PolicyWorldTime))
+    {
+        PolicyRealTime = realTime;
+        PolicyWorldTime = InTimeSeconds;
+        return;
+    }
+    const double realElapsed = realTime - PolicyRealTime;
+    if (realElapsed < POLICY_INTERVAL)
+    {
+        return;
+    }
+    MeasuredRTF = (InTimeSeconds - PolicyWorldTime) / realElapsed;
+    PolicyRealTime = realTime;
+    PolicyWorldTime = InTimeSeconds;
+    const URRLimitRTFFixedSizeCustomTimeStep* timeStep = URRLimitRTFFixedSizeCustomTimeStep::Get();
+    TargetRTF = timeStep ? timeStep->GetTargetRTF() : 1.;
+
+    // One tier per interval, letting the RTF settle in between
+    const uint8 safetyTier = static_cast<uint8>(ERRSensorOverloadTier::SAFETY);
+    if (MeasuredRTF < TargetRTF * CVarSensorSchedulerOverloadRTFRatio.GetValueOnGameThread())
+    {
+        const float minScale = FMath::Clamp(CVarSensorSchedulerOverloadMinRateScale.GetValueOnGameThread(), 0.01f, 1.f);
+        for (int32 tier = OVERLOAD_TIERS_NUM - 1; tier > safetyTier; --tier)
+        {
+            if (TierRateScales[tier] > minScale)
+            {
+                TierRateScales[tier] = FMath::Max(0.5f * TierRateScales[tier], minScale);
+                UE_LOG_WITH_INFO(LogRapyutaCore,
+                                 Warning,
+                                 TEXT("RTF %.2f below target %.2f: %s sensors slowed down to %.0f%% of their rate"),
+                                 MeasuredRTF,
+                                 TargetRTF,
+                                 *StaticEnum<ERRSensorOverloadTier>()->GetNameStringByValue(tier),
+                                 100.f * TierRateScales[tier]);
+                ApplyTierRateScales();
+                break;
+            }
+        }
+    }
+    else if (MeasuredRTF >= TargetRTF * RECOVERY_RTF_RATIO)
+    {
+        for (int32 tier = safetyTier + 1; tier < OVERLOAD_TIERS_NUM; ++tier)
+        {
+            if (TierRateScales[tier] < 1.f)
+            {
+                TierRateScales[tier] = FMath::Min(2.f * TierRateScales[tier], 1.f);
+                UE_LOG_WITH_INFO(LogRapyutaCore,
+                                 Log,
+                                 TEXT("RTF %.2f back to target: %s sensors restored to %.0f%% of their rate"),
+                                 MeasuredRTF,
+                                 *StaticEnum<ERRSensorOverloadTier>()->GetNameStringByValue(tier),
+                                 100.f * TierRateScales[tier]);
+                ApplyTierRateScales();
+                break;
+            }
+        }
+    }
+}
+
+void FRRSensorScheduler::ApplyTierRateScales()
+{
+    for (FEntry& entry : Entries)
+    {
+        if (URRROS2BaseSensorComponent* sensor = entry.Sensor.Get())
+        {
+            // Next due time kept, the new period applying from the next update
+            sensor->OverloadRateScale = GetTierRateScale(sensor->OverloadTier);
+            entry.Period = entry.BasePeriod / sensor->OverloadRateScale;
+        }
+    }
+}
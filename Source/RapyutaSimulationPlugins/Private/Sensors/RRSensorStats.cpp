@@ -0,0 +1,157 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Sensors/RRSensorStats.h"
+
+// UE
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+#include "UObject/UObjectIterator.h"
+
+// RapyutaSimulationPlugins
+#include "Sensors/RRROS2BaseSensorComponent.h"
+
+UE_TRACE_CHANNEL_DEFINE(RRSensorChannel);
+
+static void LogSensorStats(const TArray<FString>& InArgs, UWorld* InWorld)
+{
+    const bool bReset = (InArgs.Num() > 0) && InArgs[0].Equals(TEXT("reset"), ESearchCase::IgnoreCase);
+    for (TObjectIterator<URRROS2BaseSensorComponent> it; it; ++it)
+    {
+        URRROS2BaseSensorComponent* sensor = *it;
+        if (sensor->GetWorld() != InWorld)
+        {
+            continue;
+        }
+        if (bReset)
+        {
+            sensor->Stats->Reset();
+            continue;
+        }
+        UE_LOG(LogROS2Sensor,
+               Display,
+               TEXT("[%s/%s] %d Hz - %s - dropped %d - deferred %d"),
+               *GetNameSafe(sensor->GetOwner()),
+               *sensor->GetName(),
+               sensor->PublicationFrequencyHz,
+               *sensor->Stats->GetSummary().ToString(),
+               sensor->GetDroppedFramesNum(),
+               sensor->DeferredUpdatesNum);
+    }
+}
+
+static FAutoConsoleCommandWithWorldAndArgs GSensorStatsCommand(
+    TEXT("rr.SensorStats"),
+    TEXT("Log the rolling stats of all ROS 2 sensors of the world, or reset them with 'rr.SensorStats reset'."),
+    FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&LogSensorStats));
+
+void FRRRollingSamples::Add(const double InValue)
+{
+    if (Samples.Num() < Capacity)
+    {
+        Samples.Add(InValue);
+    }
+    else
+    {
+        Samples[NextIndex] = InValue;
+    }
+    NextIndex = (NextIndex + 1) % Capacity;
+}
+
+double FRRRollingSamples::GetMean() const
+{
+    double sum = 0.;
+    for (const double sample : Samples)
+    {
+        sum += sample;
+    }
+    return (Samples.Num() > 0) ? (sum / Samples.Num()) : 0.;
+}
+
+double FRRRollingSamples::GetMax() const
+{
+    return (Samples.Num() > 0) ? FMath::Max(Samples) : 0.;
+}
+
+double FRRRollingSamples::GetPercentile(const float InPercent) const
+{
+    if (Samples.Num() == 0)
+    {
+        return 0.;
+    }
+    TArray<double> sorted = Samples;
+    sorted.Sort();
+    const int32 rank = FMath::CeilToInt32(FMath::Clamp(InPercent, 0.f, 100.f) * .01f * sorted.Num()) - 1;
+    return sorted[FMath::Clamp(rank, 0, sorted.Num() - 1)];
+}
+
+FString FRRSensorStats::FSummary::ToString() const
+{
+    return FString::Printf(TEXT("updates %lld: mean %.3f / p95 %.3f / max %.3f ms - msgs %lld: mean %.3f / p95 %.3f ms - "
+                                "latency: mean %.3f / p95 %.3f / max %.3f ms - rate %.2f Hz"),
+                           UpdatesNum,
+                           UpdateMeanMs,
+                           UpdateP95Ms,
+                           UpdateMaxMs,
+                           PublishedMsgsNum,
+                           MsgMeanMs,
+                           MsgP95Ms,
+                           LatencyMeanMs,
+                           LatencyP95Ms,
+                           LatencyMaxMs,
+                           PublishRateHz);
+}
+
+void FRRSensorStats::RecordUpdate(const double InStartSeconds, const double InEndSeconds)
+{
+    FScopeLock lock(&Mutex);
+    ++UpdatesNum;
+    UpdateTimesMs.Add(1000. * (InEndSeconds - InStartSeconds));
+    LastUpdateEndSeconds = InEndSeconds;
+}
+
+void FRRSensorStats::RecordPublish(const double InStartSeconds, const double InEndSeconds)
+{
+    FScopeLock lock(&Mutex);
+    ++PublishedMsgsNum;
+    MsgTimesMs.Add(1000. * (InEndSeconds - InStartSeconds));
+    if (LastUpdateEndSeconds > 0.)
+    {
+        PublishLatenciesMs.Add(1000. * (InEndSeconds - LastUpdateEndSeconds));
+    }
+    PublishTimes.Add(InEndSeconds);
+}
+
+void FRRSensorStats::Reset()
+{
+    FScopeLock lock(&Mutex);
+    UpdateTimesMs.Reset();
+    MsgTimesMs.Reset();
+    PublishLatenciesMs.Reset();
+    PublishTimes.Reset();
+    UpdatesNum = 0;
+    PublishedMsgsNum = 0;
+    LastUpdateEndSeconds = 0.;
+}
+
+FRRSensorStats::FSummary FRRSensorStats::GetSummary() const
+{
+    FScopeLock lock(&Mutex);
+    FSummary summary;
+    summary.UpdatesNum = UpdatesNum;
+    summary.PublishedMsgsNum = PublishedMsgsNum;
+    summary.UpdateMeanMs = UpdateTimesMs.GetMean();
+    summary.UpdateP95Ms = UpdateTimesMs.GetPercentile(95.f);
+    summary.UpdateMaxMs = UpdateTimesMs.GetMax();
+    summary.MsgMeanMs = MsgTimesMs.GetMean();
+    summary.MsgP95Ms = MsgTimesMs.GetPercentile(95.f);
+    summary.LatencyMeanMs = PublishLatenciesMs.GetMean();
+    summary.LatencyP95Ms = PublishLatenciesMs.GetPercentile(95.f);
+    summary.LatencyMaxMs = PublishLatenciesMs.GetMax();
+    if (PublishTimes.Num() > 1)
+    {
+        const double duration = PublishTimes.GetLatest() - PublishTimes.GetOldest();
+        summary.PublishRateHz = (duration > 0.) ? ((PublishTimes.Num() - 1) / duration) : 0.;
+    }
+    return summary;
+}
@@ -2,13 +2,38 @@
 
 #include "Tools/OccupancyMapGenerator.h"
 
+#include "Async/ParallelFor.h"
+#include "Components/SceneCaptureComponent2D.h"
 #include "DrawDebugHelpers.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "EngineUtils.h"
 #include "HAL/PlatformFileManager.h"
 #include "Misc/Paths.h"
+#include "ProfilingDebugging/RealtimeGPUProfiler.h"
+
+// rclUE
+#include "ROS2NodeComponent.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRROS2GameMode.h"
+#include "Tools/RRROS2OccupancyGridPublisher.h"
+#include "Tools/SimulationState.h"
+
+namespace
+{
+// Quadtree cell values, free & occupied as the grid's
+constexpr uint8 QUADTREE_OCCUPIED = 0;
+constexpr uint8 QUADTREE_MIXED = 128;
+constexpr uint8 QUADTREE_FREE = 255;
+}    // namespace
+
+DECLARE_GPU_STAT_NAMED(RROccupancyDepthReadback, TEXT("RR Occupancy Depth Readback"));
 
 // Sets default values
 AOccupancyMapGenerator::AOccupancyMapGenerator()
 {
+    PrimaryActorTick.bCanEverTick = true;
+    PrimaryActorTick.bStartWithTickEnabled = false;
 }
 
 // Called when the game starts or when spawned
@@ -16,81 +41,607 @@ void AOccupancyMapGenerator::BeginPlay()
 {
     Super::BeginPlay();
 
-    // this could be done via shader if GPU raycast is accessible
-    // result would be saved on texture
+    // bUseGPU rasterizes from depth captures instead of tracing each cell
     FVector Center;
     FVector Extent;
     Map->GetActorBounds(false, Center, Extent, true);
 
-    FVector Origin = Center - Extent;
+    Origin = Center - Extent;
+    MapSize = 2 * Extent;
 
     float GridRes_cm = GridRes * 100;
+    MapTopZ = Center.Z + Extent.Z;
+    RayStartZ = MapTopZ + GridRes_cm;
+    RayEndZ = MapTopZ + MaxVerticalHeight * 100;
+
+    NCellsX = 2 * Extent.X / GridRes_cm;
+    NCellsY = 2 * Extent.Y / GridRes_cm;
+    TileSize = FMath::Max(TileSize, 1);
+    NTilesX = FMath::DivideAndRoundUp(NCellsX, TileSize);
+    TilesNum = NTilesX * FMath::DivideAndRoundUp(NCellsY, TileSize);
+    NextTileIndex = 0;
+
+    const int32 cellsNum = NCellsX * NCellsY;
+    OccupancyGrid.SetNumUninitialized(cellsNum);
+    SliceGrids.SetNum(HeightSlices.Num());
+    for (auto& sliceGrid : SliceGrids)
+    {
+        sliceGrid.SetNumUninitialized(cellsNum);
+    }
+    HeightMap.SetNumUninitialized(bGenerateHeightMap ? cellsNum : 0);
+
+    QuadtreeLevels.SetNum(FMath::Max(QuadtreeLevelsNum, 0));
+    QuadtreeLevelSizes.SetNum(QuadtreeLevels.Num());
+    FIntPoint levelSize(NCellsX, NCellsY);
+    for (int32 k = 0; k < QuadtreeLevels.Num(); ++k)
+    {
+        levelSize = FIntPoint(FMath::DivideAndRoundUp(levelSize.X, 2), FMath::DivideAndRoundUp(levelSize.Y, 2));
+        QuadtreeLevelSizes[k] = levelSize;
+        QuadtreeLevels[k].SetNumUninitialized(levelSize.X * levelSize.Y);
+    }
+
+    if (bUseGPU && (HeightSlices.Num() > 0))
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("HeightSlices require traces, thus bUseGPU is ignored"));
+    }
+    bGPUGeneration = bUseGPU && (HeightSlices.Num() == 0);
+    if (bGPUGeneration)
+    {
+        GPUTileSize = FMath::Max(GPUTileSize, 1);
+        NGPUTilesX = FMath::DivideAndRoundUp(NCellsX, GPUTileSize);
+        GPUTilesNum = NGPUTilesX * FMath::DivideAndRoundUp(NCellsY, GPUTileSize);
+        NextGPUTileIndex = 0;
+
+        UTextureRenderTarget2D* renderTarget = NewObject<UTextureRenderTarget2D>(this);
+        renderTarget->RenderTargetFormat = ETextureRenderTargetFormat::RTF_R32f;
+        renderTarget->ClearColor = FLinearColor(UE_BIG_NUMBER, 0.f, 0.f, 0.f);
+        renderTarget->InitAutoFormat(GPUTileSize, GPUTileSize);
+
+        // Looking down, image rows from max X & columns from min Y
+        DepthCapture = NewObject<USceneCaptureComponent2D>(this, TEXT("DepthCapture"));
+        DepthCapture->ProjectionType = ECameraProjectionMode::Orthographic;
+        DepthCapture->OrthoWidth = GPUTileSize * GridRes_cm;
+        DepthCapture->CaptureSource = ESceneCaptureSource::SCS_SceneDepth;
+        DepthCapture->bCaptureEveryFrame = false;
+        DepthCapture->bCaptureOnMovement = false;
+        DepthCapture->TextureTarget = renderTarget;
+        DepthCapture->RegisterComponent();
+        DepthCapture->SetWorldRotation(FRotator(-90.f, 0.f, 0.f));
+    }
+
+    if (bGenerateOverFrames || bIncrementalUpdate || bPublishROS2 || bGPUGeneration)
+    {
+        SetActorTickEnabled(true);
+    }
+    if (!bGenerateOverFrames && !bGPUGeneration)
+    {
+        BatchTiles.Reset(TilesNum);
+        for (int32 i = 0; i < TilesNum; ++i)
+        {
+            BatchTiles.Add(i);
+        }
+        TraceTiles(BatchTiles);
+        NextTileIndex = TilesNum;
+        FinishGeneration();
+    }
+}
 
-    // cell-centered sampling
-    float XPos = Origin.X + GridRes_cm * .5;
-    float YPos = Origin.Y + GridRes_cm * .5;
+void AOccupancyMapGenerator::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    // The render command writes into #DepthData
+    if (bDepthInFlight)
+    {
+        DepthFence.Wait();
+        bDepthInFlight = false;
+    }
+    if (SimulationState && EntityBoundsChangedHandle.IsValid())
+    {
+        SimulationState->OnEntityBoundsChanged.Remove(EntityBoundsChangedHandle);
+    }
+    EntityBoundsChangedHandle.Reset();
+    Super::EndPlay(EndPlayReason);
+}
 
-    int NCellsX = 2 * Extent.X / GridRes_cm;
-    int NCellsY = 2 * Extent.Y / GridRes_cm;
+void AOccupancyMapGenerator::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
 
-    OccupancyGrid.Reserve(NCellsX * NCellsY);
+    // Batches of as many tiles as worker threads, first the initial generation then the dirty tiles
+    const int32 batchTilesNum = FMath::Max(FTaskGraphInterface::Get().GetNumWorkerThreads(), 1);
+    const double endTime = FPlatformTime::Seconds() + 0.001 * FrameBudgetMs;
+    if (bGPUGeneration)
+    {
+        // One tile captured per frame, resolved once read back
+        if (bDepthInFlight)
+        {
+            if (!DepthFence.IsFenceComplete())
+            {
+                return;
+            }
+            ResolveGPUTile();
+        }
+        if (NextGPUTileIndex < GPUTilesNum)
+        {
+            CaptureGPUTile();
+            return;
+        }
+        bGPUGeneration = false;
+        NextTileIndex = TilesNum;
+        SetActorTickEnabled(bIncrementalUpdate || (bPublishROS2 && (nullptr == GridPublisher)));
+        FinishGeneration();
+        return;
+    }
+    if (NextTileIndex < TilesNum)
+    {
+        do
+        {
+            BatchTiles.Reset();
+            for (; (NextTileIndex < TilesNum) && (BatchTiles.Num() < batchTilesNum); ++NextTileIndex)
+            {
+                BatchTiles.Add(NextTileIndex);
+            }
+            TraceTiles(BatchTiles);
+        } while ((NextTileIndex < TilesNum) && (FPlatformTime::Seconds() < endTime));
 
+        if (NextTileIndex >= TilesNum)
+        {
+            SetActorTickEnabled(bIncrementalUpdate || (bPublishROS2 && (nullptr == GridPublisher)));
+            FinishGeneration();
+        }
+        return;
+    }
+
+    // The main ROS 2 node is initialized by the game mode upon StartPlay, thus possibly after BeginPlay
+    if (bPublishROS2 && (nullptr == GridPublisher) && InitGridPublisher() && !bIncrementalUpdate)
+    {
+        SetActorTickEnabled(false);
+    }
+
+    if (!bIncrementalUpdate)
+    {
+        return;
+    }
+    // SimulationState is spawned by the game mode upon StartPlay, thus possibly after BeginPlay
+    if (!EntityBoundsChangedHandle.IsValid())
+    {
+        if (nullptr == SimulationState)
+        {
+            TActorIterator<ASimulationState> it(GetWorld());
+            SimulationState = it ? *it : nullptr;
+        }
+        if (SimulationState)
+        {
+            EntityBoundsChangedHandle =
+                SimulationState->OnEntityBoundsChanged.AddUObject(this, &AOccupancyMapGenerator::OnEntityBoundsChanged);
+        }
+    }
+
+    if (DirtyTiles.Num() == 0)
+    {
+        return;
+    }
+    do
+    {
+        BatchTiles.Reset();
+        for (auto it = DirtyTiles.CreateIterator(); it && (BatchTiles.Num() < batchTilesNum); ++it)
+        {
+            BatchTiles.Add(*it);
+            it.RemoveCurrent();
+        }
+        TraceTiles(BatchTiles);
+    } while ((DirtyTiles.Num() > 0) && (FPlatformTime::Seconds() < endTime));
+
+    if (DirtyTiles.Num() == 0)
+    {
+        FinishGeneration();
+    }
+}
+
+void AOccupancyMapGenerator::OnEntityBoundsChanged(const AActor* InEntity, const FBox& InPrevBounds)
+{
+    MarkDirty(InPrevBounds);
+    if (IsValid(InEntity))
+    {
+        MarkDirty(InEntity->GetComponentsBoundingBox());
+    }
+}
+
+void AOccupancyMapGenerator::MarkDirty(const FBox& InBounds)
+{
+    // Tiles not traced yet are to be traced anyway
+    if (!InBounds.IsValid || !IsGenerated())
+    {
+        return;
+    }
+    if ((InBounds.Max.X < Origin.X) || (InBounds.Max.Y < Origin.Y) || (InBounds.Min.X > Origin.X + MapSize.X) ||
+        (InBounds.Min.Y > Origin.Y + MapSize.Y))
+    {
+        return;
+    }
+    const float GridRes_cm = GridRes * 100;
+    auto getTile = [this, GridRes_cm](const double InPos, const double InOrigin, const int32 InCellsNum)
+    { return FMath::Clamp(FMath::FloorToInt32((InPos - InOrigin) / GridRes_cm), 0, InCellsNum - 1) / TileSize; };
+    const int32 minTileX = getTile(InBounds.Min.X, Origin.X, NCellsX);
+    const int32 maxTileX = getTile(InBounds.Max.X, Origin.X, NCellsX);
+    const int32 minTileY = getTile(InBounds.Min.Y, Origin.Y, NCellsY);
+    const int32 maxTileY = getTile(InBounds.Max.Y, Origin.Y, NCellsY);
+    for (int32 tileY = minTileY; tileY <= maxTileY; ++tileY)
+    {
+        for (int32 tileX = minTileX; tileX <= maxTileX; ++tileX)
+        {
+            DirtyTiles.Add(tileY * NTilesX + tileX);
+        }
+    }
+}
+
+void AOccupancyMapGenerator::TraceTiles(const TArray<int32>& InTileIndices)
+{
     FCollisionQueryParams TraceParams = FCollisionQueryParams(FName(TEXT("Laser_Trace")), false, this);
     TraceParams.bReturnPhysicalMaterial = false;
     TraceParams.bIgnoreTouches = true;
 
-    UWorld* world = GetWorld();
-    for (auto j = 0; j < NCellsY; j++)
+    const float GridRes_cm = GridRes * 100;
+    const UWorld* world = GetWorld();
+    ParallelFor(InTileIndices.Num(),
+                [this, &InTileIndices, &TraceParams, GridRes_cm, world](const int32 InIdx)
+                {
+                    auto isBlocked = [world, &TraceParams](const FVector& InStart, const FVector& InEnd, FHitResult& OutHit)
+                    {
+                        return world->LineTraceSingleByChannel(OutHit,
+                                                               InStart,
+                                                               InEnd,
+                                                               ECC_Visibility,
+                                                               TraceParams,
+                                                               FCollisionResponseParams::DefaultResponseParam);
+                    };
+
+                    // Scene queries only read the physics scene, thus tiles are traced concurrently
+                    const int32 tileIndex = InTileIndices[InIdx];
+                    const int32 tileX = (tileIndex % NTilesX) * TileSize;
+                    const int32 tileY = (tileIndex / NTilesX) * TileSize;
+                    for (int32 j = tileY; j < FMath::Min(tileY + TileSize, NCellsY); j++)
+                    {
+                        for (int32 i = tileX; i < FMath::Min(tileX + TileSize, NCellsX); i++)
+                        {
+                            // cell-centered sampling
+                            const int32 cellIndex = j * NCellsX + i;
+                            const double x = Origin.X + GridRes_cm * (.5 + i);
+                            const double y = Origin.Y + GridRes_cm * (.5 + j);
+
+                            FHitResult hit;
+                            isBlocked(FVector(x, y, RayStartZ), FVector(x, y, RayEndZ), hit);
+                            OccupancyGrid[cellIndex] = hit.bBlockingHit ? 0 : 255;
+
+                            for (int32 k = 0; k < HeightSlices.Num(); ++k)
+                            {
+                                const bool bBlocked = isBlocked(FVector(x, y, MapTopZ + HeightSlices[k].X * 100),
+                                                                FVector(x, y, MapTopZ + HeightSlices[k].Y * 100),
+                                                                hit);
+                                SliceGrids[k][cellIndex] = bBlocked ? 0 : 255;
+                            }
+
+                            // Downward, from the max height to the map top
+                            if (bGenerateHeightMap)
+                            {
+                                HeightMap[cellIndex] = isBlocked(FVector(x, y, RayEndZ), FVector(x, y, MapTopZ), hit)
+                                                           ? (hit.ImpactPoint.Z - MapTopZ)
+                                                           : 0.f;
+                            }
+                        }
+                    }
+                });
+
+    for (const int32 tileIndex : InTileIndices)
     {
-        for (auto i = 0; i < NCellsX; i++)
+        const FIntPoint minCell((tileIndex % NTilesX) * TileSize, (tileIndex / NTilesX) * TileSize);
+        const FIntPoint maxCell(FMath::Min(minCell.X + TileSize, NCellsX) - 1, FMath::Min(minCell.Y + TileSize, NCellsY) - 1);
+        UpdateQuadtree(minCell, maxCell);
+        TracedCells.Min = TracedCells.Min.ComponentMin(minCell);
+        TracedCells.Max = TracedCells.Max.ComponentMax(maxCell);
+    }
+}
+
+void AOccupancyMapGenerator::CaptureGPUTile()
+{
+    const float GridRes_cm = GridRes * 100;
+    const int32 tileX = (NextGPUTileIndex % NGPUTilesX) * GPUTileSize;
+    const int32 tileY = (NextGPUTileIndex / NGPUTilesX) * GPUTileSize;
+    DepthCapture->SetWorldLocation(FVector(Origin.X + GridRes_cm * (tileX + .5 * GPUTileSize),
+                                           Origin.Y + GridRes_cm * (tileY + .5 * GPUTileSize),
+                                           RayEndZ));
+    DepthCapture->CaptureScene();
+
+    // Raw values, ie [cm] depth from the capture plane
+    FTextureRenderTargetResource* resource = DepthCapture->TextureTarget->GameThread_GetRenderTargetResource();
+    ENQUEUE_RENDER_COMMAND(OccupancyDepthReadback)
+    (
+        [resource, outData = &DepthData](FRHICommandListImmediate& RHICmdList)
         {
-            FVector OccupancyRayStart(
-                Origin.X + GridRes_cm * (.5 + i), Origin.Y + GridRes_cm * (.5 + j), Center.Z + Extent.Z + GridRes_cm);
-            FVector OccupancyRayEnd(
-                Origin.X + GridRes_cm * (.5 + i), Origin.Y + GridRes_cm * (.5 + j), Center.Z + Extent.Z + MaxVerticalHeight * 100);
+            SCOPED_DRAW_EVENT(RHICmdList, RROccupancyDepthReadback);
+            SCOPED_GPU_STAT(RHICmdList, RROccupancyDepthReadback);
+            const FIntPoint size = resource->GetSizeXY();
+            RHICmdList.ReadSurfaceData(resource->GetRenderTargetTexture(),
+                                       FIntRect(0, 0, size.X, size.Y),
+                                       *outData,
+                                       FReadSurfaceDataFlags(RCM_MinMax, CubeFace_MAX));
+        });
+    DepthFence.BeginFence();
+    bDepthInFlight = true;
+}
+
+void AOccupancyMapGenerator::ResolveGPUTile()
+{
+    bDepthInFlight = false;
+    const int32 tileIndex = NextGPUTileIndex++;
+    if (DepthData.Num() < GPUTileSize * GPUTileSize)
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Failed to read back the depth of GPU tile %d"), tileIndex);
+        return;
+    }
+
+    // Occupied where the highest surface is above the ray start, as with upward traces
+    const FIntPoint minCell((tileIndex % NGPUTilesX) * GPUTileSize, (tileIndex / NGPUTilesX) * GPUTileSize);
+    const FIntPoint maxCell(FMath::Min(minCell.X + GPUTileSize, NCellsX) - 1, FMath::Min(minCell.Y + GPUTileSize, NCellsY) - 1);
+    const float occupiedDepth = RayEndZ - RayStartZ;
+    const float mapTopDepth = RayEndZ - MapTopZ;
+    ParallelFor(maxCell.Y - minCell.Y + 1,
+                [this, &minCell, &maxCell, occupiedDepth, mapTopDepth](const int32 InRow)
+                {
+                    const int32 j = minCell.Y + InRow;
+                    for (int32 i = minCell.X; i <= maxCell.X; ++i)
+                    {
+                        const int32 cellIndex = j * NCellsX + i;
+                        const float depth = DepthData[(GPUTileSize - 1 - (i - minCell.X)) * GPUTileSize + InRow].R;
+                        OccupancyGrid[cellIndex] = (depth <= occupiedDepth) ? 0 : 255;
+                        if (bGenerateHeightMap)
+                        {
+                            HeightMap[cellIndex] = (depth <= mapTopDepth) ? (mapTopDepth - depth) : 0.f;
+                        }
+                    }
+                });
 
-            FHitResult hit;
-            world->LineTraceSingleByChannel(hit,
-                                            OccupancyRayStart,
-                                            OccupancyRayEnd,
-                                            ECC_Visibility,
-                                            TraceParams,
-                                            FCollisionResponseParams::DefaultResponseParam);
+    UpdateQuadtree(minCell, maxCell);
+    TracedCells.Min = TracedCells.Min.ComponentMin(minCell);
+    TracedCells.Max = TracedCells.Max.ComponentMax(maxCell);
+}
+
+void AOccupancyMapGenerator::UpdateQuadtree(const FIntPoint& InMinCell, const FIntPoint& InMaxCell)
+{
+    FIntPoint minCell = InMinCell;
+    FIntPoint maxCell = InMaxCell;
+    for (int32 k = 0; k < QuadtreeLevels.Num(); ++k)
+    {
+        // Parents of the finer level's updated cells
+        minCell = FIntPoint(minCell.X / 2, minCell.Y / 2);
+        maxCell = FIntPoint(maxCell.X / 2, maxCell.Y / 2);
+        const FIntPoint& levelSize = QuadtreeLevelSizes[k];
+        // Children out of the finer level do not count
+        const FIntPoint childLevelSize = (k == 0) ? FIntPoint(NCellsX, NCellsY) : QuadtreeLevelSizes[k - 1];
+        for (int32 y = minCell.Y; y <= maxCell.Y; ++y)
+        {
+            for (int32 x = minCell.X; x <= maxCell.X; ++x)
+            {
+                bool bAllFree = true;
+                bool bAllOccupied = true;
+                for (int32 childY = 2 * y; childY <= 2 * y + 1; ++childY)
+                {
+                    for (int32 childX = 2 * x; childX <= 2 * x + 1; ++childX)
+                    {
+                        if ((childX >= childLevelSize.X) || (childY >= childLevelSize.Y))
+                        {
+                            continue;
+                        }
+                        const uint8 child = GetQuadtreeCell(k, childX, childY);
+                        bAllFree &= (QUADTREE_FREE == child);
+                        bAllOccupied &= (QUADTREE_OCCUPIED == child);
+                    }
+                }
+                QuadtreeLevels[k][y * levelSize.X + x] =
+                    bAllFree ? QUADTREE_FREE : (bAllOccupied ? QUADTREE_OCCUPIED : QUADTREE_MIXED);
+            }
+        }
+    }
+}
+
+uint8 AOccupancyMapGenerator::GetQuadtreeCell(const int32 InLevel, const int32 InX, const int32 InY) const
+{
+    return (InLevel == 0) ? OccupancyGrid[InY * NCellsX + InX]
+                          : QuadtreeLevels[InLevel - 1][InY * QuadtreeLevelSizes[InLevel - 1].X + InX];
+}
+
+bool AOccupancyMapGenerator::IsAreaFree(const FBox2D& InArea) const
+{
+    const float GridRes_cm = GridRes * 100;
+    const FIntPoint minCell(FMath::FloorToInt32((InArea.Min.X - Origin.X) / GridRes_cm),
+                            FMath::FloorToInt32((InArea.Min.Y - Origin.Y) / GridRes_cm));
+    const FIntPoint maxCell(FMath::FloorToInt32((InArea.Max.X - Origin.X) / GridRes_cm),
+                            FMath::FloorToInt32((InArea.Max.Y - Origin.Y) / GridRes_cm));
+    if (!IsGenerated() || (minCell.X < 0) || (minCell.Y < 0) || (maxCell.X >= NCellsX) || (maxCell.Y >= NCellsY))
+    {
+        return false;
+    }
+
+    // From the coarsest level, whose cells all have to be checked
+    const int32 topLevel = QuadtreeLevels.Num();
+    const FIntPoint topLevelSize = (topLevel == 0) ? FIntPoint(NCellsX, NCellsY) : QuadtreeLevelSizes[topLevel - 1];
+    for (int32 y = (minCell.Y >> topLevel); y <= FMath::Min(maxCell.Y >> topLevel, topLevelSize.Y - 1); ++y)
+    {
+        for (int32 x = (minCell.X >> topLevel); x <= FMath::Min(maxCell.X >> topLevel, topLevelSize.X - 1); ++x)
+        {
+            if (!IsQuadtreeAreaFree(topLevel, x, y, minCell, maxCell))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool AOccupancyMapGenerator::IsQuadtreeAreaFree(const int32 InLevel,
+                                                const int32 InX,
+                                                const int32 InY,
+                                                const FIntPoint& InMinCell,
+                                                const FIntPoint& InMaxCell) const
+{
+    const uint8 cell = GetQuadtreeCell(InLevel, InX, InY);
+    if (QUADTREE_MIXED != cell)
+    {
+        return (QUADTREE_FREE == cell);
+    }
 
-            OccupancyGrid.Add(hit.bBlockingHit ? 0 : 255);
+    // Children overlapping the area
+    const FIntPoint& childLevelSize = (InLevel == 1) ? FIntPoint(NCellsX, NCellsY) : QuadtreeLevelSizes[InLevel - 2];
+    const int32 childLevel = InLevel - 1;
+    for (int32 y = FMath::Max(2 * InY, InMinCell.Y >> childLevel); y <= FMath::Min(2 * InY + 1, InMaxCell.Y >> childLevel); ++y)
+    {
+        for (int32 x = FMath::Max(2 * InX, InMinCell.X >> childLevel); x <= FMath::Min(2 * InX + 1, InMaxCell.X >> childLevel);
+             ++x)
+        {
+            if ((x < childLevelSize.X) && (y < childLevelSize.Y) && !IsQuadtreeAreaFree(childLevel, x, y, InMinCell, InMaxCell))
+            {
+                return false;
+            }
         }
     }
+    return true;
+}
 
+void AOccupancyMapGenerator::FinishGeneration()
+{
     // write to file
-    bool res = WriteToFile(NCellsX, NCellsY, Origin.X / 100.f, -(Center.Y + Extent.Y) / 100.f);
+    bool res = WriteToFile(NCellsX, NCellsY, Origin.X / 100.f, -(Origin.Y + MapSize.Y) / 100.f);
+
+    for (int32 k = 0; k < SliceGrids.Num(); ++k)
+    {
+        res &= WriteGridToFile(FString::Printf(TEXT("%s_slice%d"), *Filename, k),
+                               NCellsX,
+                               NCellsY,
+                               GridRes,
+                               Origin.X / 100.f,
+                               -(Origin.Y + MapSize.Y) / 100.f,
+                               SliceGrids[k],
+                               255,
+                               FString::Printf(TEXT("height_range: [%f, %f]\n"), HeightSlices[k].X, HeightSlices[k].Y));
+    }
+
+    // 16-bit big-endian heights, 65535 being MaxVerticalHeight
+    if (bGenerateHeightMap)
+    {
+        TArray<uint8> heightData;
+        heightData.SetNumUninitialized(2 * HeightMap.Num());
+        for (int32 i = 0; i < HeightMap.Num(); ++i)
+        {
+            const uint16 height =
+                FMath::Clamp(FMath::RoundToInt32(65535.f * HeightMap[i] / (MaxVerticalHeight * 100)), 0, 65535);
+            heightData[2 * i] = uint8(height >> 8);
+            heightData[2 * i + 1] = uint8(height & 0xFF);
+        }
+        res &= WriteGridToFile(Filename + TEXT("_height"),
+                               NCellsX,
+                               NCellsY,
+                               GridRes,
+                               Origin.X / 100.f,
+                               -(Origin.Y + MapSize.Y) / 100.f,
+                               heightData,
+                               65535,
+                               FString::Printf(TEXT("max_height: %f\n"), MaxVerticalHeight));
+    }
+
+    // Mixed cells as occupied, for conservative planning on coarse levels
+    for (int32 k = 0; k < QuadtreeLevels.Num(); ++k)
+    {
+        TArray<uint8> levelData = QuadtreeLevels[k];
+        for (uint8& cell : levelData)
+        {
+            cell = (QUADTREE_FREE == cell) ? 255 : 0;
+        }
+        const float levelRes = GridRes * (1 << (k + 1));
+        res &= WriteGridToFile(FString::Printf(TEXT("%s_L%d"), *Filename, k + 1),
+                               QuadtreeLevelSizes[k].X,
+                               QuadtreeLevelSizes[k].Y,
+                               levelRes,
+                               Origin.X / 100.f,
+                               -(Origin.Y / 100.f + QuadtreeLevelSizes[k].Y * levelRes),
+                               levelData);
+    }
+
     if (!res)
     {
         UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Failed to save files."));
     }
+
+    // Full grid upon the initial generation, then only the retraced area
+    if (GridPublisher)
+    {
+        if (GridPublisher->IsGridSet())
+        {
+            GridPublisher->UpdateGridArea(OccupancyGrid, TracedCells.Min, TracedCells.Max);
+        }
+        else
+        {
+            GridPublisher->SetGrid(NCellsX, NCellsY, GridRes, Origin.X / 100.f, -(Origin.Y + MapSize.Y) / 100.f, OccupancyGrid);
+        }
+    }
+    TracedCells = FIntRect(FIntPoint(MAX_int32), FIntPoint(MIN_int32));
+}
+
+bool AOccupancyMapGenerator::InitGridPublisher()
+{
+    ARRROS2GameMode* gameMode = GetWorld()->GetAuthGameMode<ARRROS2GameMode>();
+    if ((nullptr == gameMode) || (nullptr == gameMode->MainROS2Node))
+    {
+        return false;
+    }
+    GridPublisher = NewObject<URRROS2OccupancyGridPublisher>(this, TEXT("GridPublisher"));
+    GridPublisher->TopicName = MapTopicName;
+    gameMode->MainROS2Node->AddPublisher(GridPublisher);
+    if (IsGenerated())
+    {
+        GridPublisher->SetGrid(NCellsX, NCellsY, GridRes, Origin.X / 100.f, -(Origin.Y + MapSize.Y) / 100.f, OccupancyGrid);
+    }
+    return true;
 }
 
 bool AOccupancyMapGenerator::WriteToFile(int width, int height, float originx, float originy)
+{
+    return WriteGridToFile(Filename, width, height, GridRes, originx, originy, OccupancyGrid);
+}
+
+bool AOccupancyMapGenerator::WriteGridToFile(const FString& InFilename,
+                                             const int32 InWidth,
+                                             const int32 InHeight,
+                                             const float InResolution,
+                                             const float InOriginX,
+                                             const float InOriginY,
+                                             TArrayView<const uint8> InData,
+                                             const int32 InMaxValue,
+                                             const FString& InYamlExtra)
 {
     FString Directory = FPaths::ProjectContentDir();
 
-    FString TargetFile = Directory + "/" + Filename + ".pgm";
-    FString TargetInfoFile = Directory + "/" + Filename + ".yaml";
+    FString TargetFile = Directory + "/" + InFilename + ".pgm";
+    FString TargetInfoFile = Directory + "/" + InFilename + ".yaml";
 
-    FString yamlContent = "image: " + Filename + ".pgm\n" + "resolution: " + FString::SanitizeFloat(GridRes) + "\n" + "origin: [" +
-                          FString::SanitizeFloat(originx) + ", " + FString::SanitizeFloat(originy) + ", 0.0]\n" + "negate: 0\n" +
-                          "occupied_thresh: 0.65\n" + "free_thresh: 0.196\n";
+    FString yamlContent = "image: " + InFilename + ".pgm\n" + "resolution: " + FString::SanitizeFloat(InResolution) + "\n" +
+                          "origin: [" + FString::SanitizeFloat(InOriginX) + ", " + FString::SanitizeFloat(InOriginY) +
+                          ", 0.0]\n" + "negate: 0\n" + "occupied_thresh: 0.65\n" + "free_thresh: 0.196\n" + InYamlExtra;
 
-    FString pgmHeader = "P5\n" + FString::FromInt(width) + " " + FString::FromInt(height) + "\n" + FString::FromInt(255) + "\n";
+    FString pgmHeader =
+        "P5\n" + FString::FromInt(InWidth) + " " + FString::FromInt(InHeight) + "\n" + FString::FromInt(InMaxValue) + "\n";
 
-    TArrayView<uint8> data = OccupancyGrid;
+    // Header & all rows in a single buffered write
+    const int32 dataSize = FMath::Min(InWidth * InHeight * ((InMaxValue > 255) ? 2 : 1), InData.Num());
+    TArray<uint8> pgmContent;
+    pgmContent.Reserve(pgmHeader.Len() + dataSize);
+    for (const TCHAR c : pgmHeader)
+    {
+        pgmContent.Add(uint8(c));
+    }
+    pgmContent.Append(InData.GetData(), dataSize);
 
     bool res = true;
     res &= FFileHelper::SaveStringToFile(yamlContent, *TargetInfoFile);
-    res &= FFileHelper::SaveStringToFile(pgmHeader, *TargetFile);
-    for (int i = 0; i < height; i++)
-    {
-        res &= FFileHelper::SaveArrayToFile(data.Slice(i * width, width), *TargetFile, &IFileManager::Get(), FILEWRITE_Append);
-    }
+    res &= FFileHelper::SaveArrayToFile(pgmContent, *TargetFile);
 
     return res;
 }
@@ -0,0 +1,263 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RREntitySpatialHash.h"
+
+void FRREntitySpatialHash::SetCellSize(const float InCellSize)
+{
+    const float cellSize = FMath::Max(InCellSize, 1.f);
+    if (cellSize == CellSize)
+    {
+        return;
+    }
+    CellSize = cellSize;
+    Cells.Reset();
+    for (auto it = Slots.CreateIterator(); it; ++it)
+    {
+        it->Cell = GetCell(it->Location);
+        AddToCell(it.GetIndex());
+    }
+}
+
+void FRREntitySpatialHash::Sync(const TMap<FString, AActor*>& InEntities)
+{
+    check(IsInGameThread());
+    ++SyncStamp;
+    int32 syncedNum = 0;
+    for (const auto& entity : InEntities)
+    {
+        if (IsValid(entity.Value))
+        {
+            Update(entity.Value);
+            FSlot& slot = Slots[SlotIndices[entity.Value]];
+            if (slot.SyncStamp != SyncStamp)
+            {
+                slot.SyncStamp = SyncStamp;
+                ++syncedNum;
+            }
+        }
+    }
+
+    // Drop the entities removed from InEntities or destroyed
+    if (SlotIndices.Num() > syncedNum)
+    {
+        TArray<const AActor*> removedEntities;
+        for (const auto& slotIndex : SlotIndices)
+        {
+            if (Slots[slotIndex.Value].SyncStamp != SyncStamp)
+            {
+                removedEntities.Add(slotIndex.Key);
+            }
+        }
+        for (const AActor* entity : removedEntities)
+        {
+            Remove(entity);
+        }
+    }
+}
+
+void FRREntitySpatialHash::Update(AActor* InEntity)
+{
+    const FVector location = InEntity->GetActorLocation();
+    const FIntVector cell = GetCell(location);
+    const int32* slotIdx = SlotIndices.Find(InEntity);
+    if (nullptr == slotIdx)
+    {
+        FSlot slot;
+        slot.Actor = InEntity;
+        slot.Location = location;
+        slot.Cell = cell;
+        const int32 newSlotIdx = Slots.Add(MoveTemp(slot));
+        SlotIndices.Add(InEntity, newSlotIdx);
+        AddToCell(newSlotIdx);
+        return;
+    }
+
+    // The address may be of an entity destroyed since, not yet swept by Sync()
+    FSlot& slot = Slots[*slotIdx];
+    slot.Actor = InEntity;
+    slot.Location = location;
+    if (slot.Cell != cell)
+    {
+        RemoveFromCell(*slotIdx);
+        slot.Cell = cell;
+        AddToCell(*slotIdx);
+    }
+}
+
+void FRREntitySpatialHash::Remove(const AActor* InEntity)
+{
+    int32 slotIdx = INDEX_NONE;
+    if (SlotIndices.RemoveAndCopyValue(InEntity, slotIdx))
+    {
+        RemoveFromCell(slotIdx);
+        Slots.RemoveAt(slotIdx);
+    }
+}
+
+void FRREntitySpatialHash::Reset()
+{
+    Slots.Reset();
+    SlotIndices.Reset();
+    Cells.Reset();
+}
+
+void FRREntitySpatialHash::AddToCell(const int32 InSlotIdx)
+{
+    Cells.FindOrAdd(Slots[InSlotIdx].Cell).Add(InSlotIdx);
+}
+
+void FRREntitySpatialHash::RemoveFromCell(const int32 InSlotIdx)
+{
+    const FIntVector& cell = Slots[InSlotIdx].Cell;
+    if (TArray<int32>* cellSlots = Cells.Find(cell))
+    {
+        cellSlots->RemoveSingleSwap(InSlotIdx, false);
+        if (cellSlots->Num() == 0)
+        {
+            Cells.Remove(cell);
+        }
+    }
+}
+
+template<typename TFunc>
+void FRREntitySpatialHash::ForEachInCell(const FIntVector& InCell, FFilter InFilter, TFunc&& InFunc) const
+{
+    if (const TArray<int32>* cellSlots = Cells.Find(InCell))
+    {
+        for (const int32 slotIdx : *cellSlots)
+        {
+            const FSlot& slot = Slots[slotIdx];
+            AActor* actor = slot.Actor.Get();
+            if (actor && InFilter(actor))
+            {
+                InFunc(actor, slot.Location);
+            }
+        }
+    }
+}
+
+template<typename TFunc>
+void FRREntitySpatialHash::ForEachInBoxCells(const FBox& InBox, FFilter InFilter, TFunc&& InFunc) const
+{
+    const FIntVector minCell = GetCell(InBox.Min);
+    const FIntVector maxCell = GetCell(InBox.Max);
+    const int64 boxCellsNum = int64(maxCell.X - minCell.X + 1) * (maxCell.Y - minCell.Y + 1) * (maxCell.Z - minCell.Z + 1);
+
+    // Boxes spanning more cells than there are occupied ones
+    if (boxCellsNum > Cells.Num())
+    {
+        for (const auto& cell : Cells)
+        {
+            if ((cell.Key.X >= minCell.X) && (cell.Key.X <= maxCell.X) && (cell.Key.Y >= minCell.Y) &&
+                (cell.Key.Y <= maxCell.Y) && (cell.Key.Z >= minCell.Z) && (cell.Key.Z <= maxCell.Z))
+            {
+                ForEachInCell(cell.Key, InFilter, InFunc);
+            }
+        }
+        return;
+    }
+
+    for (int32 x = minCell.X; x <= maxCell.X; ++x)
+    {
+        for (int32 y = minCell.Y; y <= maxCell.Y; ++y)
+        {
+            for (int32 z = minCell.Z; z <= maxCell.Z; ++z)
+            {
+                ForEachInCell(FIntVector(x, y, z), InFilter, InFunc);
+            }
+        }
+    }
+}
+
+void FRREntitySpatialHash::QueryBox(const FBox& InBox, TArray<AActor*>& OutEntities, FFilter InFilter) const
+{
+    if (!InBox.IsValid)
+    {
+        return;
+    }
+    ForEachInBoxCells(InBox,
+                      InFilter,
+                      [&InBox, &OutEntities](AActor* InActor, const FVector& InLocation)
+                      {
+                          if (InBox.IsInsideOrOn(InLocation))
+                          {
+                              OutEntities.Add(InActor);
+                          }
+                      });
+}
+
+void FRREntitySpatialHash::QueryRadius(const FVector& InCenter,
+                                       const float InRadius,
+                                       TArray<AActor*>& OutEntities,
+                                       FFilter InFilter) const
+{
+    if (InRadius < 0.f)
+    {
+        return;
+    }
+    const double radiusSquared = FMath::Square(static_cast<double>(InRadius));
+    ForEachInBoxCells(FBox(InCenter - FVector(InRadius), InCenter + FVector(InRadius)),
+                      InFilter,
+                      [&InCenter, radiusSquared, &OutEntities](AActor* InActor, const FVector& InLocation)
+                      {
+                          if (FVector::DistSquared(InLocation, InCenter) <= radiusSquared)
+                          {
+                              OutEntities.Add(InActor);
+                          }
+                      });
+}
+
+AActor* FRREntitySpatialHash::FindNearest(const FVector& InLocation, const float InMaxDistance, FFilter InFilter) const
+{
+    AActor* nearest = nullptr;
+    double nearestDistSquared = (InMaxDistance > 0.f) ? FMath::Square(InMaxDistance) : TNumericLimits<double>::Max();
+    auto keepNearest = [&InLocation, &nearest, &nearestDistSquared](AActor* InActor, const FVector& InActorLocation)
+    {
+        const double distSquared = FVector::DistSquared(InActorLocation, InLocation);
+        if (distSquared <= nearestDistSquared)
+        {
+            nearest = InActor;
+            nearestDistSquared = distSquared;
+        }
+    };
+
+    // Shells of cells at Chebyshev distance k, as long as cheaper than visiting all occupied cells
+    const FIntVector center = GetCell(InLocation);
+    const int32 maxShell = (InMaxDistance > 0.f) ? FMath::CeilToInt32(InMaxDistance / CellSize) : TNumericLimits<int32>::Max();
+    for (int32 k = 0; k <= maxShell; ++k)
+    {
+        const int64 side = 2 * int64(k) + 1;
+        const int64 shellCellsNum = (k == 0) ? 1 : (side * side * side - (side - 2) * (side - 2) * (side - 2));
+        if (shellCellsNum > Cells.Num())
+        {
+            for (const auto& cell : Cells)
+            {
+                const FIntVector delta = cell.Key - center;
+                if (FMath::Max3(FMath::Abs(delta.X), FMath::Abs(delta.Y), FMath::Abs(delta.Z)) >= k)
+                {
+                    ForEachInCell(cell.Key, InFilter, keepNearest);
+                }
+            }
+            break;
+        }
+
+        for (int32 x = -k; x <= k; ++x)
+        {
+            for (int32 y = -k; y <= k; ++y)
+            {
+                const bool bShellFace = (FMath::Abs(x) == k) || (FMath::Abs(y) == k);
+                for (int32 z = -k; z <= k; z += (bShellFace || (k == 0)) ? 1 : 2 * k)
+                {
+                    ForEachInCell(center + FIntVector(x, y, z), InFilter, keepNearest);
+                }
+            }
+        }
+
+        // Any entity in farther shells is at least k cells away
+        if (nearest && (nearestDistSquared <= FMath::Square(k * static_cast<double>(CellSize))))
+        {
+            break;
+        }
+    }
+    return nearest;
+}
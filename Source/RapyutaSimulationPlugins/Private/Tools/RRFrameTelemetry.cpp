@@ -0,0 +1,347 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRFrameTelemetry.h"
+
+// UE
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+#include "RenderCore.h"
+
+// RapyutaSimulationPlugins
+#include "RapyutaSimulationPlugins.h"
+
+static void FrameTelemetryCommand(const TArray<FString>& InArgs)
+{
+    FRRFrameTelemetry& telemetry = FRRFrameTelemetry::Get();
+    if (InArgs.Num() == 0)
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Display, TEXT("%s"), *telemetry.GetSummary().ToString());
+    }
+    else if (InArgs[0].Equals(TEXT("reset"), ESearchCase::IgnoreCase))
+    {
+        telemetry.Reset();
+    }
+    else if (InArgs[0].Equals(TEXT("csv"), ESearchCase::IgnoreCase) && (InArgs.Num() > 1))
+    {
+        if (InArgs[1].Equals(TEXT("stop"), ESearchCase::IgnoreCase))
+        {
+            telemetry.StopCsv();
+        }
+        else
+        {
+            telemetry.StartCsv(InArgs[1], (InArgs.Num() > 2) ? FCString::Atof(*InArgs[2]) : 1.f);
+        }
+    }
+}
+
+static FAutoConsoleCommandWithArgs GFrameTelemetryCommand(
+    TEXT("rr.FrameTelemetry"),
+    TEXT("Log the frame time breakdown per fixed step, reset it with 'rr.FrameTelemetry reset', or write it to CSV with "
+         "'rr.FrameTelemetry csv <path> [interval sec]' & stop with 'rr.FrameTelemetry csv stop'."),
+    FConsoleCommandWithArgsDelegate::CreateStatic(&FrameTelemetryCommand));
+
+static FRRFrameTimeStats MakeFrameTimeStats(const FString& InName, const FRRRollingSamples& InSamplesMs)
+{
+    FRRFrameTimeStats stats;
+    stats.Name = InName;
+    stats.StepsNum = InSamplesMs.Num();
+    stats.MeanMs = InSamplesMs.GetMean();
+    stats.P50Ms = InSamplesMs.GetPercentile(50.f);
+    stats.P95Ms = InSamplesMs.GetPercentile(95.f);
+    stats.P99Ms = InSamplesMs.GetPercentile(99.f);
+    stats.MaxMs = InSamplesMs.GetMax();
+    return stats;
+}
+
+FString FRRFrameTelemetry::FSummary::ToString() const
+{
+    FString result = FString::Printf(TEXT("Frame telemetry over %llu steps [ms] (mean / p50 / p95 / p99 / max):"), StepsNum);
+    auto append = [&result](const FRRFrameTimeStats& InStats)
+    {
+        result += FString::Printf(TEXT("\n  %-32s %8.3f / %8.3f / %8.3f / %8.3f / %8.3f"),
+                                  *InStats.Name,
+                                  InStats.MeanMs,
+                                  InStats.P50Ms,
+                                  InStats.P95Ms,
+                                  InStats.P99Ms,
+                                  InStats.MaxMs);
+    };
+    for (const FRRFrameTimeStats& stats : Categories)
+    {
+        append(stats);
+    }
+    for (const FRRFrameTimeStats& stats : SensorClasses)
+    {
+        append(stats);
+    }
+    return result;
+}
+
+FRRFrameTelemetry& FRRFrameTelemetry::Get()
+{
+    static FRRFrameTelemetry sFrameTelemetry;
+    return sFrameTelemetry;
+}
+
+const TCHAR* FRRFrameTelemetry::GetCategoryName(const ERRFrameTimeCategory InCategory)
+{
+    switch (InCategory)
+    {
+        case ERRFrameTimeCategory::FRAME:
+            return TEXT("frame");
+        case ERRFrameTimeCategory::GAME_TICK:
+            return TEXT("game_tick");
+        case ERRFrameTimeCategory::PHYSICS:
+            return TEXT("physics");
+        case ERRFrameTimeCategory::SENSORS:
+            return TEXT("sensors");
+        case ERRFrameTimeCategory::ROS_PUBLISH:
+            return TEXT("ros_publish");
+        case ERRFrameTimeCategory::ROS_SUBSCRIBE:
+            return TEXT("ros_subscribe");
+        case ERRFrameTimeCategory::RENDER:
+            return TEXT("render");
+        case ERRFrameTimeCategory::RENDER_THREAD:
+            return TEXT("render_thread");
+        case ERRFrameTimeCategory::RTF_WAIT:
+            return TEXT("rtf_wait");
+        default:
+            return TEXT("unknown");
+    }
+}
+
+FRRFrameTelemetry::FRRFrameTelemetry()
+{
+    for (std::atomic<int64>& stepTime : StepTimesNanosec)
+    {
+        stepTime = 0;
+    }
+    CategoryTimesMs.Init(FRRRollingSamples(STEPS_NUM), static_cast<int32>(ERRFrameTimeCategory::NUM));
+
+    FWorldDelegates::OnWorldTickStart.AddRaw(this, &FRRFrameTelemetry::OnWorldTickStart);
+    FWorldDelegates::OnWorldPostActorTick.AddRaw(this, &FRRFrameTelemetry::OnWorldPostActorTick);
+    FWorldDelegates::OnPostWorldCleanup.AddRaw(this, &FRRFrameTelemetry::OnPostWorldCleanup);
+
+    FString csvFilePath;
+    if (FParse::Value(FCommandLine::Get(), TEXT("RRFrameTelemetryCsv="), csvFilePath))
+    {
+        StartCsv(csvFilePath);
+    }
+}
+
+void FRRFrameTelemetry::AddTime(const ERRFrameTimeCategory InCategory, const double InSeconds)
+{
+    StepTimesNanosec[static_cast<uint8>(InCategory)] += static_cast<int64>(InSeconds * 1e+09);
+
+    // Spans of the game thread frame, from which the others are excluded
+    switch (InCategory)
+    {
+        case ERRFrameTimeCategory::FRAME:
+        case ERRFrameTimeCategory::GAME_TICK:
+        case ERRFrameTimeCategory::RENDER:
+        case ERRFrameTimeCategory::RENDER_THREAD:
+        case ERRFrameTimeCategory::RTF_WAIT:
+            break;
+        default:
+            if (IsInGameThread())
+            {
+                GameThreadNestedTime += InSeconds;
+            }
+            break;
+    }
+}
+
+void FRRFrameTelemetry::AddSensorTime(const FName& InSensorClassName, const double InSeconds)
+{
+    AddTime(ERRFrameTimeCategory::SENSORS, InSeconds);
+    FScopeLock lock(&SensorTimesMutex);
+    StepSensorTimes.FindOrAdd(InSensorClassName) += InSeconds;
+}
+
+void FRRFrameTelemetry::OnWorldTickStart(UWorld* InWorld, ELevelTick /*InTickType*/, float /*InDeltaSeconds*/)
+{
+    if ((nullptr == InWorld) || !InWorld->IsGameWorld())
+    {
+        return;
+    }
+    WorldTickStartTime = FPlatformTime::Seconds();
+    WorldTickStartNestedTime = GameThreadNestedTime;
+
+    FPhysScene_Chaos* physScene = InWorld->GetPhysicsScene();
+    FPhysScene_Chaos*& hookedPhysScene = HookedPhysScenes.FindOrAdd(InWorld);
+    if (physScene && (physScene != hookedPhysScene))
+    {
+        hookedPhysScene = physScene;
+        physScene->OnPhysScenePreTick.AddRaw(this, &FRRFrameTelemetry::OnPhysScenePreTick);
+        physScene->OnPhysScenePostTick.AddRaw(this, &FRRFrameTelemetry::OnPhysScenePostTick);
+    }
+}
+
+void FRRFrameTelemetry::OnWorldPostActorTick(UWorld* InWorld, ELevelTick /*InTickType*/, float /*InDeltaSeconds*/)
+{
+    if ((nullptr == InWorld) || !InWorld->IsGameWorld() || (WorldTickStartTime <= 0.))
+    {
+        return;
+    }
+    LastWorldTickEndTime = FPlatformTime::Seconds();
+    LastWorldTickEndNestedTime = GameThreadNestedTime;
+    AddTime(ERRFrameTimeCategory::GAME_TICK,
+            FMath::Max(LastWorldTickEndTime - WorldTickStartTime - (GameThreadNestedTime - WorldTickStartNestedTime), 0.));
+    WorldTickStartTime = 0.;
+}
+
+void FRRFrameTelemetry::OnPhysScenePreTick(FPhysScene_Chaos* /*InPhysScene*/, float /*InDeltaSeconds*/)
+{
+    PhysicsStartTime = FPlatformTime::Seconds();
+    PhysicsStartNestedTime = GameThreadNestedTime;
+}
+
+void FRRFrameTelemetry::OnPhysScenePostTick(FPhysScene_Chaos* /*InPhysScene*/)
+{
+    if (PhysicsStartTime <= 0.)
+    {
+        return;
+    }
+    // Sensors ticking during physics are only accounted as such
+    AddTime(ERRFrameTimeCategory::PHYSICS,
+            FMath::Max(FPlatformTime::Seconds() - PhysicsStartTime - (GameThreadNestedTime - PhysicsStartNestedTime), 0.));
+    PhysicsStartTime = 0.;
+}
+
+void FRRFrameTelemetry::OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/)
+{
+    // The scene is freed with the world, a new world at the same address getting a new one
+    HookedPhysScenes.Remove(InWorld);
+}
+
+void FRRFrameTelemetry::EndStep(const double InFrameTime, const double InWaitTime)
+{
+    check(IsInGameThread());
+    const double stepEndTime = FPlatformTime::Seconds();
+    if (LastWorldTickEndTime > 0.)
+    {
+        const double renderTime = (stepEndTime - InWaitTime) - LastWorldTickEndTime -
+                                  (GameThreadNestedTime - LastWorldTickEndNestedTime);
+        AddTime(ERRFrameTimeCategory::RENDER, FMath::Max(renderTime, 0.));
+        LastWorldTickEndTime = 0.;
+    }
+    AddTime(ERRFrameTimeCategory::RENDER_THREAD, FPlatformTime::ToSeconds(GRenderThreadTime));
+    AddTime(ERRFrameTimeCategory::RTF_WAIT, InWaitTime);
+    AddTime(ERRFrameTimeCategory::FRAME, InFrameTime);
+
+    for (int32 i = 0; i < CategoryTimesMs.Num(); ++i)
+    {
+        CategoryTimesMs[i].Add(1e-06 * static_cast<double>(StepTimesNanosec[i].exchange(0)));
+    }
+    {
+        // Sensor classes not updated in this step still get a sample, thus a per step cost
+        FScopeLock lock(&SensorTimesMutex);
+        for (const auto& sensorTime : StepSensorTimes)
+        {
+            if (!SensorClassTimesMs.Contains(sensorTime.Key))
+            {
+                SensorClassTimesMs.Add(sensorTime.Key, FRRRollingSamples(STEPS_NUM));
+            }
+        }
+        for (auto& sensorClassTimes : SensorClassTimesMs)
+        {
+            const double* sensorTime = StepSensorTimes.Find(sensorClassTimes.Key);
+            sensorClassTimes.Value.Add(sensorTime ? (1000. * (*sensorTime)) : 0.);
+        }
+        StepSensorTimes.Reset();
+    }
+    ++StepsNum;
+
+    if (!CsvFilePath.IsEmpty() && ((stepEndTime - LastCsvTime) >= CsvIntervalSec))
+    {
+        LastCsvTime = stepEndTime;
+        WriteCsv();
+    }
+}
+
+FRRFrameTelemetry::FSummary FRRFrameTelemetry::GetSummary() const
+{
+    check(IsInGameThread());
+    FSummary summary;
+    summary.StepsNum = StepsNum;
+    for (int32 i = 0; i < CategoryTimesMs.Num(); ++i)
+    {
+        summary.Categories.Add(
+            MakeFrameTimeStats(GetCategoryName(static_cast<ERRFrameTimeCategory>(i)), CategoryTimesMs[i]));
+    }
+    for (const auto& sensorClassTimes : SensorClassTimesMs)
+    {
+        summary.SensorClasses.Add(MakeFrameTimeStats(
+            FString::Printf(TEXT("sensor/%s"), *sensorClassTimes.Key.ToString()), sensorClassTimes.Value));
+    }
+    return summary;
+}
+
+void FRRFrameTelemetry::Reset()
+{
+    check(IsInGameThread());
+    for (FRRRollingSamples& categoryTimes : CategoryTimesMs)
+    {
+        categoryTimes.Reset();
+    }
+    SensorClassTimesMs.Reset();
+    StepsNum = 0;
+}
+
+bool FRRFrameTelemetry::StartCsv(const FString& InFilePath, const float InIntervalSec)
+{
+    check(IsInGameThread());
+    if (!FFileHelper::SaveStringToFile(FString(TEXT("real_time_sec,steps,name,steps_num,mean_ms,p50_ms,p95_ms,p99_ms,max_ms\n")),
+                                       *InFilePath))
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Failed to write frame telemetry to [%s]"), *InFilePath);
+        return false;
+    }
+    CsvFilePath = InFilePath;
+    CsvIntervalSec = FMath::Max(InIntervalSec, 0.f);
+    LastCsvTime = FPlatformTime::Seconds();
+    UE_LOG_WITH_INFO(LogRapyutaCore, Display, TEXT("Writing frame telemetry every %.2fs to [%s]"), CsvIntervalSec, *CsvFilePath);
+    return true;
+}
+
+void FRRFrameTelemetry::StopCsv()
+{
+    CsvFilePath.Reset();
+}
+
+void FRRFrameTelemetry::WriteCsv()
+{
+    const FSummary summary = GetSummary();
+    FString rows;
+    auto appendRow = [this, &summary, &rows](const FRRFrameTimeStats& InStats)
+    {
+        rows += FString::Printf(TEXT("%.3f,%llu,%s,%d,%.4f,%.4f,%.4f,%.4f,%.4f\n"),
+                                LastCsvTime,
+                                summary.StepsNum,
+                                *InStats.Name,
+                                InStats.StepsNum,
+                                InStats.MeanMs,
+                                InStats.P50Ms,
+                                InStats.P95Ms,
+                                InStats.P99Ms,
+                                InStats.MaxMs);
+    };
+    for (const FRRFrameTimeStats& stats : summary.Categories)
+    {
+        appendRow(stats);
+    }
+    for (const FRRFrameTimeStats& stats : summary.SensorClasses)
+    {
+        appendRow(stats);
+    }
+
+    if (!FFileHelper::SaveStringToFile(
+            rows, *CsvFilePath, FFileHelper::EEncodingOptions::AutoDetect, &IFileManager::Get(), FILEWRITE_Append))
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("Failed to append frame telemetry to [%s]"), *CsvFilePath);
+    }
+}
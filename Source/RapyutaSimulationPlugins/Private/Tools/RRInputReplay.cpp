@@ -0,0 +1,576 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRInputReplay.h"
+
+// UE
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+// rclUE
+#include "Srvs/ROS2Attach.h"
+#include "Srvs/ROS2DeleteEntity.h"
+#include "Srvs/ROS2SetEntityState.h"
+#include "Srvs/ROS2SpawnEntity.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRUObjectUtils.h"
+#include "RapyutaSimulationPlugins.h"
+#include "Robots/RRBaseRobot.h"
+#include "Robots/RRRobotROS2Interface.h"
+#include "Tools/RRLimitRTFFixedSizeCustomTimeStep.h"
+#include "Tools/SimulationState.h"
+
+TMap<const UWorld*, TWeakObjectPtr<URRInputReplay>> URRInputReplay::SReplays;
+std::atomic<int32> URRInputReplay::SReplayingNum(0);
+
+namespace
+{
+const uint8 FILE_MAGIC[4] = {'R', 'R', 'I', 'R'};
+
+// Saving only reads the struct
+template<typename T>
+void WriteStruct(FArchive& InAr, const T& InStruct)
+{
+    T::StaticStruct()->SerializeBin(InAr, const_cast<T*>(&InStruct));
+}
+
+template<typename T>
+void WriteStructs(FArchive& InAr, const TArray<T>& InStructs)
+{
+    int32 num = InStructs.Num();
+    InAr << num;
+    for (const T& item : InStructs)
+    {
+        WriteStruct(InAr, item);
+    }
+}
+
+template<typename T>
+T ReadStruct(FArchive& InAr)
+{
+    T item;
+    T::StaticStruct()->SerializeBin(InAr, &item);
+    return item;
+}
+
+template<typename T>
+TArray<T> ReadStructs(FArchive& InAr)
+{
+    int32 num = 0;
+    InAr << num;
+    TArray<T> items;
+    if (!InAr.IsError() && (num > 0))
+    {
+        items.Reserve(num);
+        for (int32 i = 0; i < num; ++i)
+        {
+            items.Emplace(ReadStruct<T>(InAr));
+        }
+    }
+    return items;
+}
+}    // namespace
+
+URRInputReplay* URRInputReplay::Get(const UWorld* InWorld)
+{
+    const TWeakObjectPtr<URRInputReplay>* replay = SReplays.Find(InWorld);
+    return replay ? replay->Get() : nullptr;
+}
+
+bool URRInputReplay::Start(ASimulationState* InSimState, const ERRInputReplayMode InMode, const FString& InFilePath)
+{
+    check(IsInGameThread());
+    Stop();
+    UWorld* world = IsValid(InSimState) ? InSimState->GetWorld() : nullptr;
+    if ((nullptr == world) || (ERRInputReplayMode::NONE == InMode))
+    {
+        return false;
+    }
+
+    const URRLimitRTFFixedSizeCustomTimeStep* fixedTimeStep = URRLimitRTFFixedSizeCustomTimeStep::Get();
+    int64 stepSizeNanosec = fixedTimeStep ? fixedTimeStep->GetStepSizeNanosec() : 0;
+    if (0 == stepSizeNanosec)
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore,
+                         Warning,
+                         TEXT("[%s] The engine time step is not URRLimitRTFFixedSizeCustomTimeStep, steps of %s are counted "
+                              "from the start, thus not deterministic."),
+                         *GetName(),
+                         *InFilePath);
+    }
+
+    if (ERRInputReplayMode::RECORD == InMode)
+    {
+        Writer.Reset(IFileManager::Get().CreateFileWriter(*InFilePath));
+        if (!Writer.IsValid())
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("[%s] Failed to open %s for recording"), *GetName(), *InFilePath);
+            return false;
+        }
+        uint32 version = FILE_VERSION;
+        Writer->Serialize(const_cast<uint8*>(FILE_MAGIC), sizeof(FILE_MAGIC));
+        *Writer << version << stepSizeNanosec;
+    }
+    else
+    {
+        if (!FFileHelper::LoadFileToArray(ReplayData, *InFilePath))
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("[%s] Failed to load %s for replaying"), *GetName(), *InFilePath);
+            return false;
+        }
+        FMemoryReader reader(ReplayData);
+        uint8 magic[4] = {};
+        uint32 version = 0;
+        int64 recordedStepSizeNanosec = 0;
+        reader.Serialize(magic, sizeof(magic));
+        reader << version << recordedStepSizeNanosec;
+        if (reader.IsError() || (0 != FMemory::Memcmp(magic, FILE_MAGIC, sizeof(FILE_MAGIC))) || (version != FILE_VERSION))
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore,
+                             Error,
+                             TEXT("[%s] %s is not an input recording of version %u"),
+                             *GetName(),
+                             *InFilePath,
+                             FILE_VERSION);
+            ReplayData.Empty();
+            return false;
+        }
+        if (recordedStepSizeNanosec != stepSizeNanosec)
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore,
+                             Warning,
+                             TEXT("[%s] %s was recorded with a step of %lld ns, replayed with %lld ns"),
+                             *GetName(),
+                             *InFilePath,
+                             recordedStepSizeNanosec,
+                             stepSizeNanosec);
+        }
+        ReplayOffset = reader.Tell();
+        ReplayedRecordsNum = 0;
+        ChecksumMismatchesNum = 0;
+        FirstMismatchStep = -1;
+        bReplayFinishLogged = false;
+        ++SReplayingNum;
+    }
+
+    SimState = InSimState;
+    Mode = InMode;
+    FilePath = InFilePath;
+    CountedSteps = 0;
+    LastChecksumStep = -1;
+    TWeakObjectPtr<URRInputReplay>& registered = SReplays.FindOrAdd(world);
+    if (registered.IsValid() && (registered.Get() != this))
+    {
+        registered->Stop();
+    }
+    registered = this;
+    PreActorTickHandle = FWorldDelegates::OnWorldPreActorTick.AddUObject(this, &URRInputReplay::OnWorldPreActorTick);
+    PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &URRInputReplay::OnWorldPostActorTick);
+
+    UE_LOG_WITH_INFO(LogRapyutaCore,
+                     Display,
+                     TEXT("[%s] %s inputs %s %s"),
+                     *GetName(),
+                     IsRecording() ? TEXT("Recording") : TEXT("Replaying"),
+                     IsRecording() ? TEXT("to") : TEXT("from"),
+                     *FilePath);
+    return true;
+}
+
+void URRInputReplay::Stop()
+{
+    if (ERRInputReplayMode::NONE == Mode)
+    {
+        return;
+    }
+
+    FWorldDelegates::OnWorldPreActorTick.Remove(PreActorTickHandle);
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+    if (IsRecording())
+    {
+        Writer->Close();
+        Writer.Reset();
+        UE_LOG_WITH_INFO(
+            LogRapyutaCore, Display, TEXT("[%s] Recorded inputs till step %lld to %s"), *GetName(), GetStep(), *FilePath);
+    }
+    else
+    {
+        --SReplayingNum;
+        UE_LOG_WITH_INFO(LogRapyutaCore,
+                         Display,
+                         TEXT("[%s] Replayed %lld records of %s, %s - %d checksum mismatches, first at step %lld"),
+                         *GetName(),
+                         ReplayedRecordsNum,
+                         *FilePath,
+                         IsReplayFinished() ? TEXT("finished") : TEXT("unfinished"),
+                         ChecksumMismatchesNum,
+                         FirstMismatchStep);
+        ReplayData.Empty();
+        ReplayOffset = 0;
+    }
+
+    for (auto it = SReplays.CreateIterator(); it; ++it)
+    {
+        if (!it.Value().IsValid() || (it.Value().Get() == this))
+        {
+            it.RemoveCurrent();
+        }
+    }
+    Mode = ERRInputReplayMode::NONE;
+}
+
+void URRInputReplay::BeginDestroy()
+{
+    Stop();
+    Super::BeginDestroy();
+}
+
+int64 URRInputReplay::GetStep() const
+{
+    const URRLimitRTFFixedSizeCustomTimeStep* fixedTimeStep = URRLimitRTFFixedSizeCustomTimeStep::Get();
+    const UWorld* world = IsValid(SimState) ? SimState->GetWorld() : nullptr;
+    if (world && fixedTimeStep && (fixedTimeStep->GetStepSizeNanosec() > 0))
+    {
+        return fixedTimeStep->GetWorldTimeNanosec(world) / fixedTimeStep->GetStepSizeNanosec();
+    }
+    return CountedSteps;
+}
+
+void URRInputReplay::WriteRecord(const ERRReplayInputType InType, const TFunctionRef<void(FArchive&)>& InWritePayload)
+{
+    check(IsInGameThread());
+    PayloadBuffer.Reset();
+    FMemoryWriter payloadWriter(PayloadBuffer);
+    InWritePayload(payloadWriter);
+
+    int64 step = GetStep();
+    uint8 type = static_cast<uint8>(InType);
+    int32 payloadSize = PayloadBuffer.Num();
+    *Writer << step << type << payloadSize;
+    Writer->Serialize(PayloadBuffer.GetData(), payloadSize);
+}
+
+void URRInputReplay::RecordMovementCmd(const FString& InRobotName, const FVector& InLinearVel, const FVector& InAngularVel)
+{
+    if (IsRecording())
+    {
+        WriteRecord(ERRReplayInputType::MOVEMENT_CMD,
+                    [&](FArchive& InAr)
+                    {
+                        FString robotName = InRobotName;
+                        FVector linearVel = InLinearVel;
+                        FVector angularVel = InAngularVel;
+                        InAr << robotName << linearVel << angularVel;
+                    });
+    }
+}
+
+void URRInputReplay::RecordJointCmd(const FString& InRobotName,
+                                    const TArray<FString>& InNames,
+                                    const ERRJointControlType InControlType,
+                                    const TArray<float>& InValues)
+{
+    if (IsRecording())
+    {
+        WriteRecord(ERRReplayInputType::JOINT_CMD,
+                    [&](FArchive& InAr)
+                    {
+                        FString robotName = InRobotName;
+                        TArray<FString> names = InNames;
+                        uint8 controlType = static_cast<uint8>(InControlType);
+                        TArray<float> values = InValues;
+                        InAr << robotName << names << controlType << values;
+                    });
+    }
+}
+
+void URRInputReplay::RecordSpawnEntity(const FROSSpawnEntityReq& InRequest, const int32 InNetworkPlayerId)
+{
+    if (IsRecording())
+    {
+        WriteRecord(ERRReplayInputType::SPAWN_ENTITY,
+                    [&](FArchive& InAr)
+                    {
+                        int32 networkPlayerId = InNetworkPlayerId;
+                        InAr << networkPlayerId;
+                        WriteStruct(InAr, InRequest);
+                    });
+    }
+}
+
+void URRInputReplay::RecordSpawnEntities(const TArray<FROSSpawnEntityReq>& InRequests, const int32 InNetworkPlayerId)
+{
+    if (IsRecording())
+    {
+        WriteRecord(ERRReplayInputType::SPAWN_ENTITIES,
+                    [&](FArchive& InAr)
+                    {
+                        int32 networkPlayerId = InNetworkPlayerId;
+                        InAr << networkPlayerId;
+                        WriteStructs(InAr, InRequests);
+                    });
+    }
+}
+
+void URRInputReplay::RecordSetEntityState(const FROSSetEntityStateReq& InRequest)
+{
+    if (IsRecording())
+    {
+        WriteRecord(ERRReplayInputType::SET_ENTITY_STATE, [&](FArchive& InAr) { WriteStruct(InAr, InRequest); });
+    }
+}
+
+void URRInputReplay::RecordSetEntityStates(const TArray<FROSSetEntityStateReq>& InRequests)
+{
+    if (IsRecording())
+    {
+        WriteRecord(ERRReplayInputType::SET_ENTITY_STATES, [&](FArchive& InAr) { WriteStructs(InAr, InRequests); });
+    }
+}
+
+void URRInputReplay::RecordAttach(const FROSAttachReq& InRequest)
+{
+    if (IsRecording())
+    {
+        WriteRecord(ERRReplayInputType::ATTACH, [&](FArchive& InAr) { WriteStruct(InAr, InRequest); });
+    }
+}
+
+void URRInputReplay::RecordDeleteEntity(const FROSDeleteEntityReq& InRequest)
+{
+    if (IsRecording())
+    {
+        WriteRecord(ERRReplayInputType::DELETE_ENTITY, [&](FArchive& InAr) { WriteStruct(InAr, InRequest); });
+    }
+}
+
+void URRInputReplay::OnWorldPreActorTick(UWorld* InWorld, ELevelTick /*InTickType*/, float /*InDeltaSeconds*/)
+{
+    if (!IsValid(SimState) || (InWorld != SimState->GetWorld()))
+    {
+        return;
+    }
+    ++CountedSteps;
+    if (IsReplaying())
+    {
+        Replay(GetStep(), false);
+    }
+}
+
+void URRInputReplay::OnWorldPostActorTick(UWorld* InWorld, ELevelTick /*InTickType*/, float /*InDeltaSeconds*/)
+{
+    if (!IsValid(SimState) || (InWorld != SimState->GetWorld()))
+    {
+        return;
+    }
+
+    const int64 step = GetStep();
+    if (IsReplaying())
+    {
+        Replay(step, true);
+    }
+    else if (bStateChecksums && (step != LastChecksumStep) && (0 == (step % FMath::Max(ChecksumIntervalSteps, 1))))
+    {
+        LastChecksumStep = step;
+        WriteRecord(ERRReplayInputType::STATE_CHECKSUM,
+                    [this](FArchive& InAr)
+                    {
+                        uint32 checksum = ComputeStateChecksum();
+                        InAr << checksum;
+                    });
+    }
+}
+
+void URRInputReplay::Replay(const int64 InStep, const bool bInPostTick)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_STR("RRInputReplay");
+    FMemoryReader reader(ReplayData);
+    while (ReplayOffset < ReplayData.Num())
+    {
+        reader.Seek(ReplayOffset);
+        int64 step = 0;
+        uint8 type = 0;
+        int32 payloadSize = 0;
+        reader << step << type << payloadSize;
+        if (reader.IsError() || (payloadSize < 0) || (reader.Tell() + payloadSize > ReplayData.Num()))
+        {
+            UE_LOG_WITH_INFO(
+                LogRapyutaCore, Error, TEXT("[%s] %s is truncated at offset %lld"), *GetName(), *FilePath, ReplayOffset);
+            ReplayOffset = ReplayData.Num();
+            break;
+        }
+
+        const ERRReplayInputType inputType = static_cast<ERRReplayInputType>(type);
+        if ((step > InStep) || (!bInPostTick && (step == InStep) && (ERRReplayInputType::STATE_CHECKSUM == inputType)))
+        {
+            break;
+        }
+
+        // Records being skipped by their size, a payload is read in isolation
+        const int64 payloadOffset = reader.Tell();
+        FMemoryReader payloadReader(ReplayData);
+        payloadReader.Seek(payloadOffset);
+        ApplyRecord(inputType, payloadReader, step);
+        ReplayOffset = payloadOffset + payloadSize;
+        ++ReplayedRecordsNum;
+    }
+
+    if (IsReplayFinished() && !bReplayFinishLogged)
+    {
+        bReplayFinishLogged = true;
+        UE_LOG_WITH_INFO(LogRapyutaCore,
+                         Display,
+                         TEXT("[%s] Replay of %s finished at step %lld: %lld records, %d checksum mismatches"),
+                         *GetName(),
+                         *FilePath,
+                         InStep,
+                         ReplayedRecordsNum,
+                         ChecksumMismatchesNum);
+    }
+}
+
+void URRInputReplay::ApplyRecord(const ERRReplayInputType InType, FArchive& InPayload, const int64 InStep)
+{
+    auto findRobot = [this](const FString& InRobotName) -> ARRBaseRobot*
+    {
+        ARRBaseRobot* robot = Cast<ARRBaseRobot>(SimState->FindEntity(InRobotName));
+        if (nullptr == robot)
+        {
+            robot = URRUObjectUtils::FindActorByName<ARRBaseRobot>(SimState->GetWorld(), InRobotName);
+        }
+        if (nullptr == robot)
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("[%s] Replayed robot %s not found"), *GetName(), *InRobotName);
+        }
+        return robot;
+    };
+
+    switch (InType)
+    {
+        case ERRReplayInputType::MOVEMENT_CMD:
+        {
+            FString robotName;
+            FVector linearVel;
+            FVector angularVel;
+            InPayload << robotName << linearVel << angularVel;
+            if (ARRBaseRobot* robot = findRobot(robotName))
+            {
+                robot->SetLinearVel(linearVel);
+                robot->SetAngularVel(angularVel);
+            }
+        }
+        break;
+
+        case ERRReplayInputType::JOINT_CMD:
+        {
+            FString robotName;
+            TArray<FString> names;
+            uint8 controlType = 0;
+            TArray<float> values;
+            InPayload << robotName << names << controlType << values;
+            ARRBaseRobot* robot = findRobot(robotName);
+            if (robot && robot->ROS2Interface)
+            {
+                robot->ROS2Interface->ApplyJointCmd(names, static_cast<ERRJointControlType>(controlType), values);
+            }
+        }
+        break;
+
+        case ERRReplayInputType::SPAWN_ENTITY:
+        {
+            int32 networkPlayerId = 0;
+            InPayload << networkPlayerId;
+            SimState->ServerQueueSpawnEntity(ReadStruct<FROSSpawnEntityReq>(InPayload), networkPlayerId);
+        }
+        break;
+
+        case ERRReplayInputType::SPAWN_ENTITIES:
+        {
+            int32 networkPlayerId = 0;
+            InPayload << networkPlayerId;
+            SimState->ServerSpawnEntities(ReadStructs<FROSSpawnEntityReq>(InPayload), networkPlayerId);
+        }
+        break;
+
+        case ERRReplayInputType::SET_ENTITY_STATE:
+            SimState->ServerSetEntityState(ReadStruct<FROSSetEntityStateReq>(InPayload));
+            break;
+
+        case ERRReplayInputType::SET_ENTITY_STATES:
+            SimState->ServerSetEntityStates(ReadStructs<FROSSetEntityStateReq>(InPayload));
+            break;
+
+        case ERRReplayInputType::ATTACH:
+            SimState->ServerAttach(ReadStruct<FROSAttachReq>(InPayload));
+            break;
+
+        case ERRReplayInputType::DELETE_ENTITY:
+            SimState->ServerDeleteEntity(ReadStruct<FROSDeleteEntityReq>(InPayload));
+            break;
+
+        case ERRReplayInputType::STATE_CHECKSUM:
+        {
+            // Only verified upon the step it was recorded in, a late one not reflecting the recorded state
+            uint32 recordedChecksum = 0;
+            InPayload << recordedChecksum;
+            if (bStateChecksums && (InStep == GetStep()))
+            {
+                const uint32 checksum = ComputeStateChecksum();
+                if (checksum != recordedChecksum)
+                {
+                    if (0 == ChecksumMismatchesNum++)
+                    {
+                        FirstMismatchStep = InStep;
+                        UE_LOG_WITH_INFO(LogRapyutaCore,
+                                         Warning,
+                                         TEXT("[%s] Replayed state diverges from %s at step %lld: checksum %08x, recorded %08x"),
+                                         *GetName(),
+                                         *FilePath,
+                                         InStep,
+                                         checksum,
+                                         recordedChecksum);
+                    }
+                }
+            }
+        }
+        break;
+
+        default:
+            UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("[%s] Unknown record type %u skipped"), *GetName(), static_cast<uint8>(InType));
+            break;
+    }
+}
+
+uint32 URRInputReplay::ComputeStateChecksum() const
+{
+    TArray<FString> names;
+    SimState->Entities.GetKeys(names);
+    names.Sort();
+
+    const double locationScale = 1. / FMath::Max(static_cast<double>(ChecksumLocationTolerance), UE_DOUBLE_SMALL_NUMBER);
+    uint32 checksum = 0;
+    for (const FString& name : names)
+    {
+        const AActor* entity = SimState->Entities.FindRef(name);
+        if (!IsValid(entity))
+        {
+            continue;
+        }
+        const FTransform transform = entity->GetActorTransform();
+        const FVector location = transform.GetLocation() * locationScale;
+        const FQuat rotation = transform.GetRotation().GetNormalized();
+        const int64 quantized[7] = {FMath::RoundToInt64(location.X),
+                                    FMath::RoundToInt64(location.Y),
+                                    FMath::RoundToInt64(location.Z),
+                                    FMath::RoundToInt64(rotation.X * 1e+05),
+                                    FMath::RoundToInt64(rotation.Y * 1e+05),
+                                    FMath::RoundToInt64(rotation.Z * 1e+05),
+                                    FMath::RoundToInt64(rotation.W * 1e+05)};
+        checksum = FCrc::StrCrc32(*name, checksum);
+        checksum = FCrc::MemCrc32(quantized, sizeof(quantized), checksum);
+    }
+    return checksum;
+}
@@ -2,8 +2,22 @@
 
 #include "Tools/RRLimitRTFFixedSizeCustomTimeStep.h"
 
+#if PLATFORM_LINUX
+#include <errno.h>
+#include <time.h>
+#endif
+
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/WorldSettings.h"
+#include "HAL/IConsoleManager.h"
 #include "Misc/App.h"
 #include "Misc/ConfigCacheIni.h"
+#include "PhysicsEngine/PhysicsSettings.h"
+
+// RapyutaSimulationPlugins
+#include "Tools/RRFrameTelemetry.h"
+#include "Tools/RRROS2PublisherThread.h"
 
 URRLimitRTFFixedSizeCustomTimeStep::URRLimitRTFFixedSizeCustomTimeStep(const FObjectInitializer& ObjectInitializer)
     : Super(ObjectInitializer)
@@ -13,10 +27,14 @@ URRLimitRTFFixedSizeCustomTimeStep::URRLimitRTFFixedSizeCustomTimeStep(const FOb
     {
         StepSize = 1.0 / frameRate;
     }
+    StepSizeNanosec = FMath::RoundToInt64(static_cast<double>(StepSize) * 1e+09);
     FApp::SetUseFixedTimeStep(true);
     FApp::SetFixedDeltaTime(StepSize);
 
     GConfig->GetFloat(TEXT("/Script/Engine.Engine"), TEXT("TargetRTF"), TargetRTF, GEngineIni);
+    GConfig->GetBool(TEXT("/Script/Engine.Engine"), TEXT("bAdaptiveRTF"), bAdaptiveRTF, GEngineIni);
+    GConfig->GetBool(TEXT("/Script/Engine.Engine"), TEXT("bAsyncPhysics"), bAsyncPhysics, GEngineIni);
+    EffectiveRTF = TargetRTF;
     UE_LOG_WITH_INFO(LogRapyutaCore, Display, TEXT("StepSize: %f, TargetRTFL %f"), StepSize, TargetRTF);
 
     LastPlatformTime = FPlatformTime::Seconds();
@@ -24,6 +42,9 @@ URRLimitRTFFixedSizeCustomTimeStep::URRLimitRTFFixedSizeCustomTimeStep(const FOb
 
 bool URRLimitRTFFixedSizeCustomTimeStep::Initialize(UEngine* InEngine)
 {
+    // Hook world ticks on game thread, before any cost is recorded from other threads
+    FRRFrameTelemetry::Get();
+    ApplyAsyncPhysicsSettings();
     return true;
 }
 
@@ -67,7 +88,32 @@ void URRLimitRTFFixedSizeCustomTimeStep::SetStepSize(const float InStepSize)
     }
 
     StepSize = stepSize;
+    StepSizeNanosec = FMath::RoundToInt64(static_cast<double>(StepSize) * 1e+09);
     FApp::SetFixedDeltaTime(StepSize);
+    ApplyAsyncPhysicsSettings();
+}
+
+void URRLimitRTFFixedSizeCustomTimeStep::ApplyAsyncPhysicsSettings()
+{
+    if (!bAsyncPhysics)
+    {
+        AsyncPhysicsLagStepsNum = 0;
+        return;
+    }
+
+    // One fixed physics step per game step, substepping being exclusive with async physics
+    UPhysicsSettings* physicsSettings = UPhysicsSettings::Get();
+    physicsSettings->bTickPhysicsAsync = true;
+    physicsSettings->AsyncFixedTimeStepSize = StepSize;
+    physicsSettings->bSubstepping = false;
+
+    // Game thread results are those of the previous step, not interpolated between older ones
+    if (IConsoleVariable* interpolationCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("p.AsyncInterpolationMultiplier")))
+    {
+        interpolationCVar->Set(1.f, ECVF_SetByCode);
+    }
+    AsyncPhysicsLagStepsNum = 1;
+    UE_LOG_WITH_INFO(LogRapyutaCore, Display, TEXT("Async physics with fixed step %f"), StepSize);
 }
 
 float URRLimitRTFFixedSizeCustomTimeStep::GetTargetRTF() const
@@ -91,6 +137,17 @@ void URRLimitRTFFixedSizeCustomTimeStep::SetTargetRTF(const float InTargetRTF)
     }
 
     TargetRTF = targetRTF;
+    EffectiveRTF = TargetRTF;
+}
+
+float URRLimitRTFFixedSizeCustomTimeStep::GetEffectiveRTF() const
+{
+    return (bAdaptiveRTF && (EffectiveRTF > 0.f)) ? EffectiveRTF : TargetRTF;
+}
+
+void URRLimitRTFFixedSizeCustomTimeStep::ReportConsumerLag()
+{
+    ++ConsumerLagReportsNum;
 }
 
 bool URRLimitRTFFixedSizeCustomTimeStep::WaitForSync()
@@ -109,31 +166,171 @@ bool URRLimitRTFFixedSizeCustomTimeStep::WaitForSync()
         deltaRealTime = currentPlatformTime - FApp::GetLastTime();    // DeltaRealTime should be zero now, which will force a sleep
     }
 
-    const double waitTime = FMath::Max(StepSize / TargetRTF - deltaRealTime, 0.0);
+    const float rtf = GetEffectiveRTF();
+    const double waitTime = FMath::Max(StepSize / rtf - deltaRealTime, 0.0);
 
     double actualWaitTime = 0.0;
+    if (waitTime > 0.0)
     {
         FSimpleScopeSecondsCounter ActualWaitTimeCounter(actualWaitTime);
+        WaitUntil(LastPlatformTime + StepSize / rtf);
+    }
 
-        if (waitTime > 5.f / 1000.f)
-        {
-            FPlatformProcess::SleepNoStats(waitTime - 0.002f);
-        }
+    AdvanceStep(actualWaitTime);
+    return true;
+}
 
-        // Give up timeslice for remainder of wait time.
-        const double WaitEndTime = LastPlatformTime + StepSize / TargetRTF;
-        while (FPlatformTime::Seconds() < WaitEndTime)
+void URRLimitRTFFixedSizeCustomTimeStep::WaitUntil(const double InWaitEndTime)
+{
+    // Wake up early by the measured oversleep, so that the sleep alone mostly meets the deadline
+    const double sleepEndTime = InWaitEndTime - OversleepEstimate;
+    const double sleepTime = sleepEndTime - FPlatformTime::Seconds();
+    if (sleepTime > 0.0)
+    {
+#if PLATFORM_LINUX
+        // Absolute deadline on the monotonic clock, thus not drifting upon EINTR restarts
+        struct timespec deadline;
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        const int64 deadlineNanosec =
+            deadline.tv_sec * 1000000000LL + deadline.tv_nsec + static_cast<int64>(sleepTime * 1e+09);
+        deadline.tv_sec = deadlineNanosec / 1000000000LL;
+        deadline.tv_nsec = deadlineNanosec % 1000000000LL;
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, nullptr) == EINTR)
         {
-            FPlatformProcess::SleepNoStats(0.f);
         }
+#else
+        FPlatformProcess::SleepNoStats(sleepTime);
+#endif
+        const double oversleep = FPlatformTime::Seconds() - sleepEndTime;
+        OversleepEstimate = FMath::Clamp(
+            OversleepEstimate + OVERSLEEP_SMOOTHING * (oversleep - OversleepEstimate), 0.0, MAX_OVERSLEEP_ESTIMATE);
     }
 
+    // Only yield for the remainder, as short as the oversleep estimate error
+    while (FPlatformTime::Seconds() < InWaitEndTime)
+    {
+        FPlatformProcess::SleepNoStats(0.f);
+    }
+    StatsWindow.MaxLateness = FMath::Max(StatsWindow.MaxLateness, FPlatformTime::Seconds() - InWaitEndTime);
+}
+
+void URRLimitRTFFixedSizeCustomTimeStep::UpdateStats(const double InRealStepTime, const double InWaitTime)
+{
+    ++StatsWindow.StepsNum;
+    StatsWindow.SimTime += StepSize;
+    StatsWindow.RealTime += InRealStepTime;
+    StatsWindow.WaitTime += InWaitTime;
+    if (StatsWindow.RealTime < StatsIntervalSec)
+    {
+        return;
+    }
+
+    // Only completed windows are reported
+    Stats.StepsNum = StatsWindow.StepsNum;
+    Stats.AchievedRTF = StatsWindow.SimTime / StatsWindow.RealTime;
+    Stats.MeanWaitTime = StatsWindow.WaitTime / StatsWindow.StepsNum;
+    Stats.WaitRatio = StatsWindow.WaitTime / StatsWindow.RealTime;
+    Stats.MaxLateness = StatsWindow.MaxLateness;
+    Stats.OversleepEstimate = OversleepEstimate;
+    StatsWindow = FRRTimeStepStatsWindow();
+    if (bLogStats)
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore,
+                         Display,
+                         TEXT("RTF %.3f (target %.3f), wait %.3fms/step (%.1f%%), max lateness %.3fms, oversleep %.3fms"),
+                         Stats.AchievedRTF,
+                         TargetRTF,
+                         Stats.MeanWaitTime * 1000.0,
+                         Stats.WaitRatio * 100.0,
+                         Stats.MaxLateness * 1000.0,
+                         Stats.OversleepEstimate * 1000.0);
+    }
+}
+
+void URRLimitRTFFixedSizeCustomTimeStep::AdvanceStep(const double InIdleTime)
+{
     // Use fixed delta time and update time.
     FApp::SetDeltaTime(StepSize);
-    FApp::SetIdleTime(actualWaitTime);
+    FApp::SetIdleTime(InIdleTime);
     FApp::SetCurrentTime(FApp::GetLastTime() + StepSize);
+    SimTimeNanosec += StepSizeNanosec;
 
-    LastPlatformTime = FPlatformTime::Seconds();
+    const double currentPlatformTime = FPlatformTime::Seconds();
+    FRRFrameTelemetry::Get().EndStep(currentPlatformTime - LastPlatformTime, InIdleTime);
+    UpdateStats(currentPlatformTime - LastPlatformTime, InIdleTime);
+    if (bAdaptiveRTF)
+    {
+        UpdateAdaptiveRTF(currentPlatformTime - LastPlatformTime, InIdleTime);
+    }
+    LastPlatformTime = currentPlatformTime;
+    OnSimStepped.Broadcast(SimTimeNanosec);
+}
 
-    return true;
+URRLimitRTFFixedSizeCustomTimeStep* URRLimitRTFFixedSizeCustomTimeStep::Get()
+{
+    return GEngine ? Cast<URRLimitRTFFixedSizeCustomTimeStep>(GEngine->GetCustomTimeStep()) : nullptr;
+}
+
+int64 URRLimitRTFFixedSizeCustomTimeStep::GetPhysicsTimeNanosec() const
+{
+    return FMath::Max<int64>(SimTimeNanosec - AsyncPhysicsLagStepsNum * StepSizeNanosec, 0);
+}
+
+int64 URRLimitRTFFixedSizeCustomTimeStep::GetWorldTimeNanosec(const UWorld* InWorld) const
+{
+    const double worldTime = InWorld->GetTimeSeconds();
+    const AWorldSettings* worldSettings = InWorld->GetWorldSettings();
+    if ((StepSize > 0.f) && ((nullptr == worldSettings) || (worldSettings->GetEffectiveTimeDilation() == 1.f)))
+    {
+        return FMath::RoundToInt64(worldTime / StepSize) * StepSizeNanosec;
+    }
+    return FMath::RoundToInt64(worldTime * 1e+09);
+}
+
+void URRLimitRTFFixedSizeCustomTimeStep::UpdateAdaptiveRTF(const double InRealStepTime, const double InWaitTime)
+{
+    ++GovernorWindow.StepsNum;
+    GovernorWindow.RealTime += InRealStepTime;
+    GovernorWindow.BusyTime += FMath::Max(InRealStepTime - InWaitTime, 0.0);
+    if (GovernorWindow.RealTime < AdaptiveRTFIntervalSec)
+    {
+        return;
+    }
+
+    // Consumer lag: sensor msgs dropped or piling up in the publisher thread, or lag reported by eg ROS subscribers' acks
+    const FRRROS2PublisherThread& publisherThread = FRRROS2PublisherThread::Get();
+    const int64 droppedMsgsNum = publisherThread.GetDroppedMsgsNum();
+    const int32 lagReportsNum = ConsumerLagReportsNum.exchange(0);
+    const bool bConsumersLagging = (droppedMsgsNum > LastDroppedMsgsNum) || (lagReportsNum > 0) ||
+                                   (publisherThread.GetPendingMsgsNum() > MaxPendingMsgsNum);
+    LastDroppedMsgsNum = droppedMsgsNum;
+
+    // Max RTF sustained by the frame cost alone, ie with no wait
+    const double sustainableRTF =
+        StepSize * GovernorWindow.StepsNum / FMath::Max(GovernorWindow.BusyTime, UE_DOUBLE_SMALL_NUMBER);
+    const float currentRTF = GetEffectiveRTF();
+    float newRTF = currentRTF;
+    if (bConsumersLagging)
+    {
+        // Multiplicative decrease, to relieve consumers quickly
+        newRTF = currentRTF * AdaptiveRTFDecreaseFactor;
+    }
+    else
+    {
+        // Additive-like increase, though never far beyond what frames could sustain, not to build up a backlog
+        newRTF = FMath::Min(currentRTF * (1.f + AdaptiveRTFIncreaseRatio), static_cast<float>(sustainableRTF * 1.1));
+    }
+    EffectiveRTF = FMath::Clamp(newRTF, FMath::Max(MinAdaptiveRTF, StepSize), FMath::Max(MaxAdaptiveRTF, MinAdaptiveRTF));
+    GovernorWindow = FRRGovernorWindow();
+
+    if (bLogStats && (EffectiveRTF != currentRTF))
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore,
+                         Display,
+                         TEXT("Adaptive RTF %.3f -> %.3f (sustainable %.3f, consumers lagging %d)"),
+                         currentRTF,
+                         EffectiveRTF,
+                         sustainableRTF,
+                         bConsumersLagging);
+    }
 }
@@ -0,0 +1,138 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRLockstepCustomTimeStep.h"
+
+// UE
+#include "Misc/App.h"
+#include "Misc/ScopeLock.h"
+
+// rclUE
+#include "Msgs/ROS2Str.h"
+#include "ROS2NodeComponent.h"
+#include "ROS2ServiceServer.h"
+#include "ROS2Subscriber.h"
+#include "Srvs/ROS2SetBool.h"
+
+// RapyutaSimulationPlugins
+#include "RapyutaSimulationPlugins.h"
+#include "Tools/RRFrameTelemetry.h"
+
+void URRLockstepCustomTimeStep::InitROS2(UROS2NodeComponent* InROS2Node)
+{
+    {
+        FScopeLock lock(&LockstepMutex);
+        StepsLeftNum = StepsPerAcksNum;
+        PendingAckNames.Reset();
+    }
+
+    ROS2_CREATE_SERVICE_SERVER(InROS2Node,
+                               this,
+                               StepSimulationSrvName,
+                               UROS2SetBoolSrv::StaticClass(),
+                               &URRLockstepCustomTimeStep::StepSimulationSrv);
+    if (AckControllerNames.Num() > 0)
+    {
+        ROS2_CREATE_SUBSCRIBER(
+            InROS2Node, this, AckTopicName, UROS2StrMsg::StaticClass(), &URRLockstepCustomTimeStep::AckCallback);
+    }
+    bROS2Inited = true;
+    UE_LOG_WITH_INFO(LogRapyutaCore,
+                     Display,
+                     TEXT("Lockstep: %d steps per request, %d steps per acks of %d controllers"),
+                     StepsPerRequestNum,
+                     StepsPerAcksNum,
+                     AckControllerNames.Num());
+}
+
+bool URRLockstepCustomTimeStep::WaitForSync()
+{
+    if (!bROS2Inited || !bLockstepEnabled)
+    {
+        return Super::WaitForSync();
+    }
+
+    if (ConsumeStep())
+    {
+        // No real-time wait, the step being only granted once all of its consumers are ready
+        AdvanceStep(0.0);
+    }
+    else
+    {
+        // Hold: zero-length frame, letting the game thread & ROS callbacks run without advancing sim time
+        double actualWaitTime = 0.0;
+        {
+            FSimpleScopeSecondsCounter ActualWaitTimeCounter(actualWaitTime);
+            FPlatformProcess::SleepNoStats(HoldSleepSec);
+        }
+        FApp::SetDeltaTime(0.0);
+        FApp::SetIdleTime(actualWaitTime);
+        FApp::SetCurrentTime(FApp::GetLastTime());
+        LastPlatformTime = FPlatformTime::Seconds();
+    }
+    return true;
+}
+
+bool URRLockstepCustomTimeStep::ConsumeStep()
+{
+    FScopeLock lock(&LockstepMutex);
+    if ((StepsLeftNum <= 0) || (PendingAckNames.Num() > 0))
+    {
+        return false;
+    }
+
+    // The last step of a batch awaits acks of all controllers before the next one
+    if (--StepsLeftNum == 0)
+    {
+        PendingAckNames.Append(AckControllerNames);
+    }
+    return true;
+}
+
+void URRLockstepCustomTimeStep::RequestSteps(const int32 InStepsNum)
+{
+    FScopeLock lock(&LockstepMutex);
+    StepsLeftNum += FMath::Max(InStepsNum, 0);
+}
+
+void URRLockstepCustomTimeStep::Acknowledge(const FString& InControllerName)
+{
+    FScopeLock lock(&LockstepMutex);
+    if ((PendingAckNames.Remove(InControllerName) > 0) && (PendingAckNames.Num() == 0) && (StepsLeftNum == 0))
+    {
+        StepsLeftNum = StepsPerAcksNum;
+    }
+}
+
+int32 URRLockstepCustomTimeStep::GetStepsLeftNum() const
+{
+    FScopeLock lock(&LockstepMutex);
+    return StepsLeftNum;
+}
+
+void URRLockstepCustomTimeStep::StepSimulationSrv(UROS2GenericSrv* InService)
+{
+    FRRFrameTimeScope frameTimeScope(ERRFrameTimeCategory::ROS_SUBSCRIBE);
+    UROS2SetBoolSrv* stepService = Cast<UROS2SetBoolSrv>(InService);
+
+    FROSSetBoolReq request;
+    stepService->GetRequest(request);
+    if (request.bData)
+    {
+        RequestSteps(StepsPerRequestNum);
+    }
+
+    FROSSetBoolRes response;
+    response.bSuccess = request.bData;
+    stepService->SetResponse(response);
+}
+
+void URRLockstepCustomTimeStep::AckCallback(const UROS2GenericMsg* InMsg)
+{
+    FRRFrameTimeScope frameTimeScope(ERRFrameTimeCategory::ROS_SUBSCRIBE);
+    if (const UROS2StrMsg* strMsg = Cast<UROS2StrMsg>(InMsg))
+    {
+        FROSStr msg;
+        strMsg->GetMsg(msg);
+        Acknowledge(msg.Data);
+    }
+}
@@ -0,0 +1,704 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRMcapRecorder.h"
+
+// UE
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/Compression.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+// rclUE
+#include "ROS2Publisher.h"
+#include "rclcUtilities.h"
+#include "rmw/rmw.h"
+#include "rosidl_typesupport_introspection_c/field_types.h"
+#include "rosidl_typesupport_introspection_c/identifier.h"
+#include "rosidl_typesupport_introspection_c/message_introspection.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRCoreUtils.h"
+
+static TAutoConsoleVariable<int32> CVarRecordChunkSizeKB(TEXT("rr.Record.ChunkSizeKB"),
+                                                         1024,
+                                                         TEXT("[KB] Uncompressed msgs of a topic per MCAP chunk, upon start"),
+                                                         ECVF_Default);
+
+static TAutoConsoleVariable<FString> CVarRecordCompression(TEXT("rr.Record.Compression"),
+                                                           TEXT("lz4"),
+                                                           TEXT("MCAP chunks compression, lz4 or none, upon start"),
+                                                           ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarRecordMaxPendingMB(TEXT("rr.Record.MaxPendingMB"),
+                                                          512,
+                                                          TEXT("[MB] Pending msgs beyond which msgs are dropped"),
+                                                          ECVF_Default);
+
+std::atomic<bool> FRRMcapRecorder::SRecording(false);
+
+namespace
+{
+const uint8 MCAP_MAGIC[8] = {0x89, 'M', 'C', 'A', 'P', '0', '\r', '\n'};
+
+constexpr uint8 OP_HEADER = 0x01;
+constexpr uint8 OP_FOOTER = 0x02;
+constexpr uint8 OP_SCHEMA = 0x03;
+constexpr uint8 OP_CHANNEL = 0x04;
+constexpr uint8 OP_MESSAGE = 0x05;
+constexpr uint8 OP_CHUNK = 0x06;
+constexpr uint8 OP_CHUNK_INDEX = 0x08;
+constexpr uint8 OP_STATISTICS = 0x0B;
+constexpr uint8 OP_DATA_END = 0x0F;
+
+// LZ4 frame of independent blocks of up to 4MB, without checksums
+const uint8 LZ4_FRAME_HEADER[7] = {0x04, 0x22, 0x4D, 0x18, 0x60, 0x70, 0x73};
+constexpr int32 LZ4_MAX_BLOCK_SIZE = 4 * 1024 * 1024;
+constexpr uint32 LZ4_UNCOMPRESSED_BLOCK_FLAG = 0x80000000u;
+
+using FROSMsgMembers = rosidl_typesupport_introspection_c__MessageMembers;
+using FROSMsgMember = rosidl_typesupport_introspection_c__MessageMember;
+
+// MCAP is little-endian, as are all UE target platforms
+template<typename T>
+void Put(TArray<uint8>& OutBuffer, const T InValue)
+{
+    OutBuffer.Append(reinterpret_cast<const uint8*>(&InValue), sizeof(T));
+}
+
+void PutString(TArray<uint8>& OutBuffer, const FString& InString)
+{
+    FTCHARToUTF8 utf8(*InString);
+    Put<uint32>(OutBuffer, utf8.Length());
+    OutBuffer.Append(reinterpret_cast<const uint8*>(utf8.Get()), utf8.Length());
+}
+
+bool CompressLZ4Frame(const TArray<uint8>& InData, TArray<uint8>& OutFrame)
+{
+    OutFrame.Reset();
+    OutFrame.Append(LZ4_FRAME_HEADER, UE_ARRAY_COUNT(LZ4_FRAME_HEADER));
+    TArray<uint8> block;
+    for (int32 offset = 0; offset < InData.Num(); offset += LZ4_MAX_BLOCK_SIZE)
+    {
+        const int32 size = FMath::Min(LZ4_MAX_BLOCK_SIZE, InData.Num() - offset);
+        int32 compressedSize = FCompression::CompressMemoryBound(NAME_LZ4, size);
+        block.SetNumUninitialized(compressedSize, false);
+        if (FCompression::CompressMemory(NAME_LZ4, block.GetData(), compressedSize, InData.GetData() + offset, size) &&
+            (compressedSize < size))
+        {
+            Put<uint32>(OutFrame, static_cast<uint32>(compressedSize));
+            OutFrame.Append(block.GetData(), compressedSize);
+        }
+        else
+        {
+            Put<uint32>(OutFrame, static_cast<uint32>(size) | LZ4_UNCOMPRESSED_BLOCK_FLAG);
+            OutFrame.Append(InData.GetData() + offset, size);
+        }
+    }
+    Put<uint32>(OutFrame, 0);
+    return OutFrame.Num() < InData.Num();
+}
+
+const FROSMsgMembers* GetMsgMembers(const rosidl_message_type_support_t* InTypeSupport)
+{
+    const rosidl_message_type_support_t* typeSupport =
+        InTypeSupport ? get_message_typesupport_handle(InTypeSupport, rosidl_typesupport_introspection_c__identifier) : nullptr;
+    if (nullptr == typeSupport)
+    {
+        rcutils_reset_error();
+        return nullptr;
+    }
+    return static_cast<const FROSMsgMembers*>(typeSupport->data);
+}
+
+// Eg sensor_msgs/msg/LaserScan, or sensor_msgs/LaserScan as referred to in msg definitions
+FString GetMsgTypeName(const FROSMsgMembers& InMembers, const bool bInWithMsgNamespace)
+{
+    FString msgNamespace = UTF8_TO_TCHAR(InMembers.message_namespace_);
+    msgNamespace.ReplaceInline(TEXT("__"), TEXT("/"));
+    if (!bInWithMsgNamespace)
+    {
+        msgNamespace.RemoveFromEnd(TEXT("/msg"));
+    }
+    return FString::Printf(TEXT("%s/%s"), *msgNamespace, UTF8_TO_TCHAR(InMembers.message_name_));
+}
+
+FString GetFieldTypeName(const FROSMsgMember& InMember, TArray<const FROSMsgMembers*>& OutDependencies)
+{
+    FString typeName;
+    switch (InMember.type_id_)
+    {
+        case rosidl_typesupport_introspection_c__ROS_TYPE_FLOAT:
+            typeName = TEXT("float32");
+            break;
+        case rosidl_typesupport_introspection_c__ROS_TYPE_DOUBLE:
+        case rosidl_typesupport_introspection_c__ROS_TYPE_LONG_DOUBLE:
+            typeName = TEXT("float64");
+            break;
+        case rosidl_typesupport_introspection_c__ROS_TYPE_CHAR:
+            typeName = TEXT("char");
+            break;
+        case rosidl_typesupport_introspection_c__ROS_TYPE_WCHAR:
+            typeName = TEXT("wchar");
+            break;
+        case rosidl_typesupport_introspection_c__ROS_TYPE_BOOLEAN:
+            typeName = TEXT("bool");
+            break;
+        case rosidl_typesupport_introspection_c__ROS_TYPE_OCTET:
+            typeName = TEXT("byte");
+            break;
+        case rosidl_typesupport_introspection_c__ROS_TYPE_UINT8:
+            typeName = TEXT("uint8");
+            break;
+        case rosidl_typesupport_introspection_c__ROS_TYPE_INT8:
+            typeName = TEXT("int8");
+            break;
+        case rosidl_typesupport_introspection_c__ROS_TYPE_UINT16:
+            typeName = TEXT("uint16");
+            break;
+        case rosidl_typesupport_introspection_c__ROS_TYPE_INT16:
+            typeName = TEXT("int16");
+            break;
+        case rosidl_typesupport_introspection_c__ROS_TYPE_UINT32:
+            typeName = TEXT("uint32");
+            break;
+        case rosidl_typesupport_introspection_c__ROS_TYPE_INT32:
+            typeName = TEXT("int32");
+            break;
+        case rosidl_typesupport_introspection_c__ROS_TYPE_UINT64:
+            typeName = TEXT("uint64");
+            break;
+        case rosidl_typesupport_introspection_c__ROS_TYPE_INT64:
+            typeName = TEXT("int64");
+            break;
+        case rosidl_typesupport_introspection_c__ROS_TYPE_STRING:
+        case rosidl_typesupport_introspection_c__ROS_TYPE_WSTRING:
+            typeName = (rosidl_typesupport_introspection_c__ROS_TYPE_STRING == InMember.type_id_) ? TEXT("string")
+                                                                                                   : TEXT("wstring");
+            if (InMember.string_upper_bound_ > 0)
+            {
+                typeName += FString::Printf(TEXT("<=%llu"), static_cast<uint64>(InMember.string_upper_bound_));
+            }
+            break;
+        case rosidl_typesupport_introspection_c__ROS_TYPE_MESSAGE:
+            if (const FROSMsgMembers* members = GetMsgMembers(InMember.members_))
+            {
+                typeName = GetMsgTypeName(*members, false);
+                OutDependencies.Add(members);
+            }
+            break;
+        default:
+            break;
+    }
+
+    if (InMember.is_array_)
+    {
+        if (InMember.array_size_ > 0)
+        {
+            typeName += InMember.is_upper_bound_ ? FString::Printf(TEXT("[<=%llu]"), static_cast<uint64>(InMember.array_size_))
+                                                 : FString::Printf(TEXT("[%llu]"), static_cast<uint64>(InMember.array_size_));
+        }
+        else
+        {
+            typeName += TEXT("[]");
+        }
+    }
+    return typeName;
+}
+
+// ros2msg definition, ie the msg fields followed by those of every msg type they depend on
+FString GetMsgDefinition(const FROSMsgMembers& InMembers)
+{
+    FString definition;
+    TArray<const FROSMsgMembers*> dependencies = {&InMembers};
+    TSet<FString> dependencyNames;
+    for (int32 i = 0; i < dependencies.Num(); ++i)
+    {
+        const FROSMsgMembers& members = *dependencies[i];
+        if (i > 0)
+        {
+            const FString typeName = GetMsgTypeName(members, false);
+            bool bAlreadyDefined = false;
+            dependencyNames.Add(typeName, &bAlreadyDefined);
+            if (bAlreadyDefined)
+            {
+                continue;
+            }
+            definition += FString::ChrN(80, TEXT('=')) + TEXT("\nMSG: ") + typeName + TEXT("\n");
+        }
+        for (uint32 m = 0; m < members.member_count_; ++m)
+        {
+            definition += FString::Printf(TEXT("%s %s\n"),
+                                          *GetFieldTypeName(members.members_[m], dependencies),
+                                          UTF8_TO_TCHAR(members.members_[m].name_));
+        }
+    }
+    return definition;
+}
+
+TArray<uint8> GetSchemaContent(const uint16 InId, const FString& InName, const FString& InDefinition)
+{
+    TArray<uint8> content;
+    Put<uint16>(content, InId);
+    PutString(content, InName);
+    PutString(content, TEXT("ros2msg"));
+    PutString(content, InDefinition);
+    return content;
+}
+
+TArray<uint8> GetChannelContent(const uint16 InId, const uint16 InSchemaId, const FString& InTopic)
+{
+    TArray<uint8> content;
+    Put<uint16>(content, InId);
+    Put<uint16>(content, InSchemaId);
+    PutString(content, InTopic);
+    PutString(content, TEXT("cdr"));
+    // No metadata
+    Put<uint32>(content, 0);
+    return content;
+}
+
+// Serialized msg buffer reused by each publishing thread, grown by rmw_serialize as needed
+struct FRRSerializedMsg
+{
+    FRRSerializedMsg()
+    {
+        rcutils_allocator_t allocator = rcutils_get_default_allocator();
+        bValid = (RMW_RET_OK == rmw_serialized_message_init(&Msg, 0, &allocator));
+    }
+    ~FRRSerializedMsg()
+    {
+        if (bValid)
+        {
+            rmw_serialized_message_fini(&Msg);
+        }
+    }
+
+    rmw_serialized_message_t Msg = rmw_get_zero_initialized_serialized_message();
+    bool bValid = false;
+};
+
+void RecordCommand(const TArray<FString>& InArgs)
+{
+    FRRMcapRecorder& recorder = FRRMcapRecorder::Get();
+    if (InArgs.Num() == 0)
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore,
+                         Display,
+                         TEXT("rr.Record <file path>|stop, %s, %lld msgs recorded, %lld dropped"),
+                         FRRMcapRecorder::IsRecording() ? TEXT("recording") : TEXT("not recording"),
+                         recorder.GetRecordedMsgsNum(),
+                         recorder.GetDroppedMsgsNum());
+    }
+    else if (InArgs[0].Equals(TEXT("stop"), ESearchCase::IgnoreCase))
+    {
+        recorder.StopRecording();
+    }
+    else
+    {
+        recorder.StartRecording(InArgs[0]);
+    }
+}
+
+static FAutoConsoleCommandWithArgs GRecordCommand(TEXT("rr.Record"),
+                                                  TEXT("rr.Record <file path>|stop: Record the published msgs into an MCAP file"),
+                                                  FConsoleCommandWithArgsDelegate::CreateStatic(&RecordCommand));
+}    // namespace
+
+FRRMcapRecorder& FRRMcapRecorder::Get()
+{
+    static FRRMcapRecorder sRecorder;
+    return sRecorder;
+}
+
+bool FRRMcapRecorder::StartRecording(const FString& InFilePath)
+{
+    check(IsInGameThread());
+    if (IsRecording())
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("Already recording into %s"), *FilePath);
+        return false;
+    }
+
+    FilePath = InFilePath.EndsWith(TEXT(".mcap")) ? InFilePath : InFilePath + TEXT(".mcap");
+    IPlatformFile& platformFile = FPlatformFileManager::Get().GetPlatformFile();
+    platformFile.CreateDirectoryTree(*FPaths::GetPath(FilePath));
+    FileHandle = platformFile.OpenWrite(*FilePath);
+    if (nullptr == FileHandle)
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Failed to open %s for recording"), *FilePath);
+        return false;
+    }
+
+    {
+        FScopeLock lock(&ChannelsMutex);
+        Schemas.Reset();
+        SchemaIds.Reset();
+        Channels.Reset();
+        ChannelIds.Reset();
+    }
+    FileOffset = 0;
+    Chunks.Reset();
+    ChunkIndexes.Reset();
+    WrittenSchemaIds.Reset();
+    WrittenChannelIds.Reset();
+    ChannelMessageCounts.Reset();
+    MessageStartTime = TNumericLimits<uint64>::Max();
+    MessageEndTime = 0;
+    PendingBytes = 0;
+    RecordedMsgsNum = 0;
+    DroppedMsgsNum = 0;
+    bLZ4 = CVarRecordCompression.GetValueOnGameThread().Equals(TEXT("lz4"), ESearchCase::IgnoreCase);
+    ChunkSize = static_cast<int64>(FMath::Max(CVarRecordChunkSizeKB.GetValueOnGameThread(), 1)) * 1024;
+
+    WriteBytes(MCAP_MAGIC, UE_ARRAY_COUNT(MCAP_MAGIC));
+    TArray<uint8> header;
+    PutString(header, TEXT("ros2"));
+    PutString(header, TEXT("RapyutaSimulationPlugins"));
+    WriteRecord(OP_HEADER, header);
+
+    bStopping = false;
+    WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+    Thread = FRunnableThread::Create(this, TEXT("RRMcapRecorderThread"), 0, TPri_BelowNormal);
+    SRecording = true;
+    UE_LOG_WITH_INFO(LogRapyutaCore, Display, TEXT("Recording into %s"), *FilePath);
+    return true;
+}
+
+void FRRMcapRecorder::StopRecording()
+{
+    check(IsInGameThread());
+    if (!IsRecording())
+    {
+        return;
+    }
+
+    // Waits for the msgs being handed off, none being handed off afterwards
+    {
+        FScopeLock lock(&ChannelsMutex);
+        SRecording = false;
+    }
+    Stop();
+    Thread->WaitForCompletion();
+    delete Thread;
+    Thread = nullptr;
+    FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+    WakeEvent = nullptr;
+    UE_LOG_WITH_INFO(LogRapyutaCore,
+                     Display,
+                     TEXT("Recorded %lld msgs on %d topics into %s, %lld dropped"),
+                     RecordedMsgsNum.load(),
+                     WrittenChannelIds.Num(),
+                     *FilePath,
+                     DroppedMsgsNum.load());
+}
+
+void FRRMcapRecorder::Stop()
+{
+    bStopping = true;
+    if (WakeEvent)
+    {
+        WakeEvent->Trigger();
+    }
+}
+
+void FRRMcapRecorder::RecordPublished(UROS2Publisher& InPublisher, const int64 InLogTimeNanosec)
+{
+    if (IsRecording() && InPublisher.TopicMessage)
+    {
+        Get().Record(InPublisher.RclPublisher,
+                     InPublisher.TopicMessage->GetTypeSupport(),
+                     InPublisher.TopicMessage->Get(),
+                     InLogTimeNanosec);
+    }
+}
+
+void FRRMcapRecorder::Record(const rcl_publisher_t& InPublisher,
+                             const rosidl_message_type_support_t* InTypeSupport,
+                             const void* InROSMsg,
+                             const int64 InLogTimeNanosec)
+{
+    if (!IsRecording() || (nullptr == InTypeSupport) || (nullptr == InROSMsg))
+    {
+        return;
+    }
+    const char* topic = rcl_publisher_get_topic_name(&InPublisher);
+    if (nullptr == topic)
+    {
+        rcutils_reset_error();
+        return;
+    }
+
+    thread_local FRRSerializedMsg tSerializedMsg;
+    if (!tSerializedMsg.bValid || (RMW_RET_OK != rmw_serialize(InROSMsg, InTypeSupport, &tSerializedMsg.Msg)))
+    {
+        rmw_reset_error();
+        ++DroppedMsgsNum;
+        return;
+    }
+    const int64 size = static_cast<int64>(tSerializedMsg.Msg.buffer_length);
+    if (PendingBytes.load() + size > static_cast<int64>(CVarRecordMaxPendingMB.GetValueOnAnyThread()) * 1024 * 1024)
+    {
+        ++DroppedMsgsNum;
+        return;
+    }
+
+    FRRMcapMessage message;
+    message.LogTime = static_cast<uint64>(FMath::Max<int64>(InLogTimeNanosec, 0));
+    message.Data.Append(tSerializedMsg.Msg.buffer, size);
+    {
+        FScopeLock lock(&ChannelsMutex);
+        if (!IsRecording())
+        {
+            return;
+        }
+        message.ChannelId = FindOrAddChannel(UTF8_TO_TCHAR(topic), InTypeSupport);
+        message.Sequence = Channels[message.ChannelId - 1].NextSequence++;
+        PendingBytes += size;
+        ++RecordedMsgsNum;
+        Queue.Enqueue(MoveTemp(message));
+        WakeEvent->Trigger();
+    }
+}
+
+uint16 FRRMcapRecorder::FindOrAddChannel(const FString& InTopic, const rosidl_message_type_support_t* InTypeSupport)
+{
+    if (const uint16* channelId = ChannelIds.Find(InTopic))
+    {
+        return *channelId;
+    }
+
+    // Schemas are only generated once per type
+    const FROSMsgMembers* members = GetMsgMembers(InTypeSupport);
+    const FString schemaName = members ? GetMsgTypeName(*members, true) : FString(TEXT("unknown"));
+    uint16& schemaId = SchemaIds.FindOrAdd(schemaName, 0);
+    if (0 == schemaId)
+    {
+        Schemas.Add({schemaName, members ? GetMsgDefinition(*members) : FString()});
+        schemaId = static_cast<uint16>(Schemas.Num());
+        if (nullptr == members)
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("%s: msg type without introspection, recorded schemaless"), *InTopic);
+        }
+    }
+
+    FChannel& channel = Channels.AddDefaulted_GetRef();
+    channel.Topic = InTopic;
+    channel.SchemaId = schemaId;
+    const uint16 channelId = static_cast<uint16>(Channels.Num());
+    ChannelIds.Add(InTopic, channelId);
+    return channelId;
+}
+
+uint32 FRRMcapRecorder::Run()
+{
+    // Also wakes up periodically, not to depend on every trigger
+    static constexpr uint32 WAIT_MS = 10;
+    FRRMcapMessage message;
+    const auto writePendingMessages = [this, &message]()
+    {
+        while (Queue.Dequeue(message))
+        {
+            PendingBytes -= message.Data.Num();
+            WriteMessage(message);
+        }
+    };
+
+    while (!bStopping)
+    {
+        WakeEvent->Wait(WAIT_MS);
+        writePendingMessages();
+    }
+
+    writePendingMessages();
+    for (auto& chunk : Chunks)
+    {
+        if (chunk.Value.Records.Num() > 0)
+        {
+            FlushChunk(chunk.Key, chunk.Value);
+        }
+    }
+    WriteSummary();
+    delete FileHandle;
+    FileHandle = nullptr;
+    return 0;
+}
+
+void FRRMcapRecorder::WriteMessage(FRRMcapMessage& InMessage)
+{
+    FChunk& chunk = Chunks.FindOrAdd(InMessage.ChannelId);
+    if (chunk.Records.Num() == 0)
+    {
+        chunk.Records.Reserve(ChunkSize + InMessage.Data.Num());
+        chunk.MessageStartTime = InMessage.LogTime;
+        chunk.MessageEndTime = InMessage.LogTime;
+    }
+    chunk.MessageStartTime = FMath::Min(chunk.MessageStartTime, InMessage.LogTime);
+    chunk.MessageEndTime = FMath::Max(chunk.MessageEndTime, InMessage.LogTime);
+    MessageStartTime = FMath::Min(MessageStartTime, InMessage.LogTime);
+    MessageEndTime = FMath::Max(MessageEndTime, InMessage.LogTime);
+    ++ChannelMessageCounts.FindOrAdd(InMessage.ChannelId, 0);
+
+    // Published at the sim time it was recorded at
+    Put<uint8>(chunk.Records, OP_MESSAGE);
+    Put<uint64>(chunk.Records, sizeof(uint16) + sizeof(uint32) + 2 * sizeof(uint64) + InMessage.Data.Num());
+    Put<uint16>(chunk.Records, InMessage.ChannelId);
+    Put<uint32>(chunk.Records, InMessage.Sequence);
+    Put<uint64>(chunk.Records, InMessage.LogTime);
+    Put<uint64>(chunk.Records, InMessage.LogTime);
+    chunk.Records.Append(InMessage.Data);
+
+    if (chunk.Records.Num() >= ChunkSize)
+    {
+        FlushChunk(InMessage.ChannelId, chunk);
+    }
+}
+
+void FRRMcapRecorder::FlushChunk(const uint16 InChannelId, FChunk& InChunk)
+{
+    WriteSchemaAndChannel(InChannelId);
+
+    TArray<uint8> compressedRecords;
+    const bool bCompressed = bLZ4 && CompressLZ4Frame(InChunk.Records, compressedRecords);
+    const TArray<uint8>& records = bCompressed ? compressedRecords : InChunk.Records;
+
+    // Without CRCs, written as 0
+    TArray<uint8> prefix;
+    Put<uint64>(prefix, InChunk.MessageStartTime);
+    Put<uint64>(prefix, InChunk.MessageEndTime);
+    Put<uint64>(prefix, InChunk.Records.Num());
+    Put<uint32>(prefix, 0);
+    PutString(prefix, bCompressed ? TEXT("lz4") : TEXT(""));
+    Put<uint64>(prefix, records.Num());
+
+    FChunkIndex& index = ChunkIndexes.AddDefaulted_GetRef();
+    index.MessageStartTime = InChunk.MessageStartTime;
+    index.MessageEndTime = InChunk.MessageEndTime;
+    index.ChunkStartOffset = FileOffset;
+    index.ChunkLength = sizeof(uint8) + sizeof(uint64) + prefix.Num() + records.Num();
+    index.CompressedSize = records.Num();
+    index.UncompressedSize = InChunk.Records.Num();
+    index.bLZ4 = bCompressed;
+
+    TArray<uint8> recordHeader;
+    Put<uint8>(recordHeader, OP_CHUNK);
+    Put<uint64>(recordHeader, prefix.Num() + records.Num());
+    WriteBytes(recordHeader.GetData(), recordHeader.Num());
+    WriteBytes(prefix.GetData(), prefix.Num());
+    WriteBytes(records.GetData(), records.Num());
+
+    // Keeping its allocation for the next chunk
+    InChunk.Records.Reset();
+}
+
+void FRRMcapRecorder::WriteSchemaAndChannel(const uint16 InChannelId)
+{
+    if (WrittenChannelIds.Contains(InChannelId))
+    {
+        return;
+    }
+
+    FChannel channel;
+    FSchema schema;
+    {
+        FScopeLock lock(&ChannelsMutex);
+        channel = Channels[InChannelId - 1];
+        schema = Schemas[channel.SchemaId - 1];
+    }
+    if (!WrittenSchemaIds.Contains(channel.SchemaId))
+    {
+        WriteRecord(OP_SCHEMA, GetSchemaContent(channel.SchemaId, schema.Name, schema.Definition));
+        WrittenSchemaIds.Add(channel.SchemaId);
+    }
+    WriteRecord(OP_CHANNEL, GetChannelContent(InChannelId, channel.SchemaId, channel.Topic));
+    WrittenChannelIds.Add(InChannelId);
+}
+
+void FRRMcapRecorder::WriteSummary()
+{
+    TArray<uint8> dataEnd;
+    Put<uint32>(dataEnd, 0);
+    WriteRecord(OP_DATA_END, dataEnd);
+
+    const uint64 summaryStart = FileOffset;
+    TArray<FSchema> schemas;
+    TArray<FChannel> channels;
+    {
+        FScopeLock lock(&ChannelsMutex);
+        schemas = Schemas;
+        channels = Channels;
+    }
+    for (const uint16 schemaId : WrittenSchemaIds)
+    {
+        WriteRecord(OP_SCHEMA, GetSchemaContent(schemaId, schemas[schemaId - 1].Name, schemas[schemaId - 1].Definition));
+    }
+    for (const uint16 channelId : WrittenChannelIds)
+    {
+        WriteRecord(OP_CHANNEL, GetChannelContent(channelId, channels[channelId - 1].SchemaId, channels[channelId - 1].Topic));
+    }
+
+    uint64 messagesNum = 0;
+    for (const auto& channelMessageCount : ChannelMessageCounts)
+    {
+        messagesNum += channelMessageCount.Value;
+    }
+    TArray<uint8> statistics;
+    Put<uint64>(statistics, messagesNum);
+    Put<uint16>(statistics, WrittenSchemaIds.Num());
+    Put<uint32>(statistics, WrittenChannelIds.Num());
+    // Attachments & metadata
+    Put<uint32>(statistics, 0);
+    Put<uint32>(statistics, 0);
+    Put<uint32>(statistics, ChunkIndexes.Num());
+    Put<uint64>(statistics, (messagesNum > 0) ? MessageStartTime : 0);
+    Put<uint64>(statistics, MessageEndTime);
+    Put<uint32>(statistics, ChannelMessageCounts.Num() * (sizeof(uint16) + sizeof(uint64)));
+    for (const auto& channelMessageCount : ChannelMessageCounts)
+    {
+        Put<uint16>(statistics, channelMessageCount.Key);
+        Put<uint64>(statistics, channelMessageCount.Value);
+    }
+    WriteRecord(OP_STATISTICS, statistics);
+
+    // Without message indexes, readers scanning the chunks instead
+    for (const FChunkIndex& index : ChunkIndexes)
+    {
+        TArray<uint8> chunkIndex;
+        Put<uint64>(chunkIndex, index.MessageStartTime);
+        Put<uint64>(chunkIndex, index.MessageEndTime);
+        Put<uint64>(chunkIndex, index.ChunkStartOffset);
+        Put<uint64>(chunkIndex, index.ChunkLength);
+        Put<uint32>(chunkIndex, 0);
+        Put<uint64>(chunkIndex, 0);
+        PutString(chunkIndex, index.bLZ4 ? TEXT("lz4") : TEXT(""));
+        Put<uint64>(chunkIndex, index.CompressedSize);
+        Put<uint64>(chunkIndex, index.UncompressedSize);
+        WriteRecord(OP_CHUNK_INDEX, chunkIndex);
+    }
+
+    TArray<uint8> footer;
+    Put<uint64>(footer, summaryStart);
+    Put<uint64>(footer, 0);
+    Put<uint32>(footer, 0);
+    WriteRecord(OP_FOOTER, footer);
+    WriteBytes(MCAP_MAGIC, UE_ARRAY_COUNT(MCAP_MAGIC));
+}
+
+void FRRMcapRecorder::WriteRecord(const uint8 InOpCode, const TArray<uint8>& InContent)
+{
+    TArray<uint8> recordHeader;
+    Put<uint8>(recordHeader, InOpCode);
+    Put<uint64>(recordHeader, InContent.Num());
+    WriteBytes(recordHeader.GetData(), recordHeader.Num());
+    WriteBytes(InContent.GetData(), InContent.Num());
+}
+
+void FRRMcapRecorder::WriteBytes(const uint8* InData, const int64 InSize)
+{
+    if ((InSize > 0) && !FileHandle->Write(InData, InSize))
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Failed to write %lld bytes into %s"), InSize, *FilePath);
+    }
+    FileOffset += InSize;
+}
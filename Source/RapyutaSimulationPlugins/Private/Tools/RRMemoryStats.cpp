@@ -0,0 +1,115 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRMemoryStats.h"
+
+// UE
+#include "HAL/IConsoleManager.h"
+#include "UObject/UObjectIterator.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRGameSingleton.h"
+#include "Core/RRMeshData.h"
+#include "RapyutaSimulationPlugins.h"
+#include "Sensors/RRBaseLidarComponent.h"
+#include "Sensors/RRROS2CameraComponent.h"
+#include "Tools/RRROS2PublisherThread.h"
+
+LLM_DEFINE_TAG(RRMeshData);
+LLM_DEFINE_TAG(RRResources);
+LLM_DEFINE_TAG(RRLidar);
+LLM_DEFINE_TAG(RRCamera);
+LLM_DEFINE_TAG(RRROS2Msgs);
+
+static void MemStatsCommand()
+{
+    UE_LOG_WITH_INFO(LogRapyutaCore, Display, TEXT("%s"), *FRRMemoryStats::ToString(FRRMemoryStats::Gather()));
+}
+
+static FAutoConsoleCommand GMemStatsCommand(TEXT("rr.MemStats"),
+                                            TEXT("Log the memory held per plugin subsystem, of all worlds."),
+                                            FConsoleCommandDelegate::CreateStatic(&MemStatsCommand));
+
+const TCHAR* FRRMemoryStats::GetSubsystemName(const ERRMemorySubsystem InSubsystem)
+{
+    switch (InSubsystem)
+    {
+        case ERRMemorySubsystem::MESH_DATA_STORE:
+            return TEXT("mesh_data_store");
+        case ERRMemorySubsystem::RESOURCE_STORE:
+            return TEXT("resource_store");
+        case ERRMemorySubsystem::LIDAR_SCAN_BUFFERS:
+            return TEXT("lidar_scan_buffers");
+        case ERRMemorySubsystem::CAMERA_RENDER_REQUESTS:
+            return TEXT("camera_render_requests");
+        case ERRMemorySubsystem::ROS2_MSGS:
+            return TEXT("ros2_msgs");
+        default:
+            return TEXT("unknown");
+    }
+}
+
+TArray<FRRMemorySubsystemStats> FRRMemoryStats::Gather(const UWorld* InWorld)
+{
+    check(IsInGameThread());
+    TArray<FRRMemorySubsystemStats> stats;
+    stats.SetNum(static_cast<uint8>(ERRMemorySubsystem::NUM));
+    for (uint8 i = 0; i < static_cast<uint8>(ERRMemorySubsystem::NUM); ++i)
+    {
+        stats[i].Name = GetSubsystemName(static_cast<ERRMemorySubsystem>(i));
+    }
+    auto getStats = [&stats](const ERRMemorySubsystem InSubsystem) -> FRRMemorySubsystemStats&
+    { return stats[static_cast<uint8>(InSubsystem)]; };
+
+    // Mesh data store, whose resident size is kept up to date upon every change
+    const FRRMeshDataStoreStats& meshDataStoreStats = FRRMeshData::GetMeshDataStoreStats();
+    getStats(ERRMemorySubsystem::MESH_DATA_STORE).Bytes = meshDataStoreStats.ResidentBytes;
+    getStats(ERRMemorySubsystem::MESH_DATA_STORE).ItemsNum = meshDataStoreStats.EntriesNum;
+
+    // Resource store
+    if (URRGameSingleton* gameSingleton = URRGameSingleton::Get())
+    {
+        FRRMemorySubsystemStats& resourceStats = getStats(ERRMemorySubsystem::RESOURCE_STORE);
+        resourceStats.Bytes = gameSingleton->GetResourceStoreSize(resourceStats.ItemsNum);
+    }
+
+    // Lidars
+    for (TObjectIterator<URRBaseLidarComponent> it; it; ++it)
+    {
+        if ((nullptr == InWorld) || (it->GetWorld() == InWorld))
+        {
+            FRRMemorySubsystemStats& lidarStats = getStats(ERRMemorySubsystem::LIDAR_SCAN_BUFFERS);
+            lidarStats.Bytes += it->GetScanBuffersAllocatedSize();
+            ++lidarStats.ItemsNum;
+        }
+    }
+
+    // Cameras
+    for (TObjectIterator<URRROS2CameraComponent> it; it; ++it)
+    {
+        if ((nullptr == InWorld) || (it->GetWorld() == InWorld))
+        {
+            FRRMemorySubsystemStats& cameraStats = getStats(ERRMemorySubsystem::CAMERA_RENDER_REQUESTS);
+            cameraStats.Bytes += it->GetRenderRequestsAllocatedSize();
+            ++cameraStats.ItemsNum;
+            getStats(ERRMemorySubsystem::ROS2_MSGS).Bytes += it->GetMsgDataAllocatedSize();
+        }
+    }
+
+    // Msgs pending in the publisher thread, whose builders own their data
+    getStats(ERRMemorySubsystem::ROS2_MSGS).ItemsNum = FRRROS2PublisherThread::Get().GetPendingMsgsNum();
+    return stats;
+}
+
+FString FRRMemoryStats::ToString(const TArray<FRRMemorySubsystemStats>& InStats)
+{
+    FString result = TEXT("Memory per subsystem [MB] (items):");
+    int64 totalBytes = 0;
+    for (const FRRMemorySubsystemStats& stats : InStats)
+    {
+        result += FString::Printf(
+            TEXT("\n  %-24s %10.3f (%d)"), *stats.Name, stats.Bytes / (1024. * 1024.), stats.ItemsNum);
+        totalBytes += stats.Bytes;
+    }
+    result += FString::Printf(TEXT("\n  %-24s %10.3f"), TEXT("total"), totalBytes / (1024. * 1024.));
+    return result;
+}
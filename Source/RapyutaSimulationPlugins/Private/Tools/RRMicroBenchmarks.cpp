@@ -0,0 +1,492 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRMicroBenchmarks.h"
+
+// UE
+#include "Dom/JsonObject.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRConversionUtils.h"
+#include "Core/RRGeneralUtils.h"
+#include "Core/RRMeshUtils.h"
+#include "Core/RRNoiseUtils.h"
+#include "Core/RRSDFParser.h"
+#include "Core/RRURDFParser.h"
+#include "RapyutaSimulationPlugins.h"
+#include "Sensors/RR2DLidarComponent.h"
+#include "Sensors/RR3DLidarComponent.h"
+#include "Sensors/RRROS2CameraComponent.h"
+#include "Tools/RRROS2MsgWriter.h"
+
+static TAutoConsoleVariable<int32> CVarBenchmarkRounds(TEXT("rr.Benchmark.Rounds"),
+                                                       7,
+                                                       TEXT("Timed rounds per micro-benchmark, its best one being reported."),
+                                                       ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarBenchmarkRoundMs(TEXT("rr.Benchmark.RoundMs"),
+                                                        20.f,
+                                                        TEXT("[ms] Min duration of a micro-benchmark round, iterations being "
+                                                             "calibrated to it."),
+                                                        ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarBenchmarkRegressionThreshold(
+    TEXT("rr.Benchmark.RegressionThreshold"),
+    0.2f,
+    TEXT("Relative slowdown of a micro-benchmark's best time vs its baseline reported as a regression, eg 0.2 for 20%."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<FString> CVarBenchmarkMeshFiles(
+    TEXT("rr.Benchmark.MeshFiles"),
+    FString(),
+    TEXT("';' separated reference mesh files benchmarked with URRMeshUtils::ProcessMesh, eg the Turtlebot3 STLs."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<FString> CVarBenchmarkModelFiles(TEXT("rr.Benchmark.ModelFiles"),
+                                                             FString(),
+                                                             TEXT("';' separated reference URDF/SDF files benchmarked with "
+                                                                  "their parser, the robot model cache being bypassed."),
+                                                             ECVF_Default);
+
+static void BenchmarkCommand(const TArray<FString>& InArgs)
+{
+    const bool bSave = (InArgs.Num() > 0) && InArgs[0].Equals(TEXT("save"), ESearchCase::IgnoreCase);
+    const int32 filterIndex = bSave ? 1 : 0;
+    TArray<FRRBenchmarkResult> results =
+        FRRMicroBenchmarks::Run(InArgs.IsValidIndex(filterIndex) ? InArgs[filterIndex] : FString());
+    if (bSave)
+    {
+        FRRMicroBenchmarks::SaveBaselines(results);
+    }
+
+    const int32 regressedNum = FRRMicroBenchmarks::CompareToBaselines(results);
+    UE_LOG_WITH_INFO(LogRapyutaCore, Display, TEXT("%s"), *FRRMicroBenchmarks::ToReport(results));
+    if (regressedNum > 0)
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore,
+                         Warning,
+                         TEXT("%d micro-benchmark(s) regressed beyond %.0f%% of their baseline"),
+                         regressedNum,
+                         100.f * CVarBenchmarkRegressionThreshold.GetValueOnGameThread());
+    }
+}
+
+static FAutoConsoleCommandWithArgs GBenchmarkCommand(
+    TEXT("rr.Benchmark"),
+    TEXT("Run the micro-benchmarks whose name contains an optional filter & report them vs their baselines, or store their "
+         "times as baselines with 'rr.Benchmark save [filter]'."),
+    FConsoleCommandWithArgsDelegate::CreateStatic(&BenchmarkCommand));
+
+/**
+ * @brief Time a function, after a warm-up call, over rounds of iterations calibrated to #CVarBenchmarkRoundMs
+ * @param InName
+ * @param InItemsNum
+ * @param InFunc Its results must be consumed by itself, eg written to an output buffer, not to be optimized out
+ * @param OutResults
+ */
+template<typename TFunc>
+static void Measure(const FString& InName, const int32 InItemsNum, TFunc&& InFunc, TArray<FRRBenchmarkResult>& OutResults)
+{
+    InFunc();
+
+    const double roundSec = 1e-3 * FMath::Max(CVarBenchmarkRoundMs.GetValueOnGameThread(), 1.f);
+    int32 iterations = 1;
+    for (;;)
+    {
+        const double startTime = FPlatformTime::Seconds();
+        for (int32 i = 0; i < iterations; ++i)
+        {
+            InFunc();
+        }
+        const double elapsedSec = FPlatformTime::Seconds() - startTime;
+        if ((elapsedSec >= roundSec) || (iterations >= (1 << 24)))
+        {
+            break;
+        }
+        iterations = (elapsedSec > 0.) ? FMath::Clamp(static_cast<int32>(iterations * 1.2 * roundSec / elapsedSec),
+                                                      iterations + 1,
+                                                      iterations * 16)
+                                       : iterations * 16;
+    }
+
+    FRRBenchmarkResult& result = OutResults.AddDefaulted_GetRef();
+    result.Name = InName;
+    result.ItemsNum = InItemsNum;
+    result.Iterations = iterations;
+    result.BestUs = TNumericLimits<double>::Max();
+    const int32 roundsNum = FMath::Max(CVarBenchmarkRounds.GetValueOnGameThread(), 1);
+    for (int32 round = 0; round < roundsNum; ++round)
+    {
+        const double startTime = FPlatformTime::Seconds();
+        for (int32 i = 0; i < iterations; ++i)
+        {
+            InFunc();
+        }
+        const double roundUs = 1e6 * (FPlatformTime::Seconds() - startTime) / iterations;
+        result.BestUs = FMath::Min(result.BestUs, roundUs);
+        result.MeanUs += roundUs / roundsNum;
+    }
+}
+
+TArray<FRRBenchmarkResult> FRRMicroBenchmarks::Run(const FString& InFilter)
+{
+    check(IsInGameThread());
+    TArray<FRRBenchmarkResult> results;
+    RunConversionBenchmarks(InFilter, results);
+    RunSensorBenchmarks(InFilter, results);
+    RunFileBenchmarks(InFilter, results);
+    return results;
+}
+
+void FRRMicroBenchmarks::RunConversionBenchmarks(const FString& InFilter, TArray<FRRBenchmarkResult>& OutResults)
+{
+    // Eg the entity & TF states of a large fleet
+    static constexpr int32 TRANSFORMS_NUM = 1024;
+    FRandomStream random(0);
+    TArray<FTransform> transforms;
+    transforms.SetNumUninitialized(TRANSFORMS_NUM);
+    for (FTransform& transform : transforms)
+    {
+        const FRotator rotation(random.FRandRange(-180., 180.), random.FRandRange(-180., 180.), random.FRandRange(-180., 180.));
+        transform = FTransform(rotation, random.GetUnitVector() * random.FRandRange(0., 1e5));
+    }
+    const FTransform refTransform(FRotator(10., 20., 30.), FVector(100., -200., 300.));
+    TArray<FTransform> outTransforms;
+    outTransforms.SetNumUninitialized(TRANSFORMS_NUM);
+
+    auto measure = [&InFilter, &OutResults](const TCHAR* InName, const int32 InItemsNum, auto&& InFunc)
+    {
+        if (InFilter.IsEmpty() || FCString::Stristr(InName, *InFilter))
+        {
+            Measure(InName, InItemsNum, InFunc, OutResults);
+        }
+    };
+
+    measure(TEXT("conversion.TransformUEToROS"),
+            TRANSFORMS_NUM,
+            [&]()
+            {
+                for (int32 i = 0; i < TRANSFORMS_NUM; ++i)
+                {
+                    outTransforms[i] = URRConversionUtils::TransformUEToROS(transforms[i]);
+                }
+            });
+    measure(TEXT("conversion.TransformsUEToROS"),
+            TRANSFORMS_NUM,
+            [&]() { URRConversionUtils::TransformsUEToROS(transforms, outTransforms); });
+    measure(TEXT("conversion.RelativeTransformsUEToROS"),
+            TRANSFORMS_NUM,
+            [&]() { URRConversionUtils::RelativeTransformsUEToROS(refTransform, transforms, outTransforms); });
+    measure(TEXT("general.GetRelativeTransform"),
+            TRANSFORMS_NUM,
+            [&]()
+            {
+                for (int32 i = 0; i < TRANSFORMS_NUM; ++i)
+                {
+                    outTransforms[i] = URRGeneralUtils::GetRelativeTransform(refTransform, transforms[i]);
+                }
+            });
+
+    // Eg a 3D lidar's intensity noise
+    static constexpr int32 NOISE_NUM = 32 * 1024;
+    TArray<float> noise;
+    noise.SetNumUninitialized(NOISE_NUM);
+    measure(TEXT("noise.FillGaussian"),
+            NOISE_NUM,
+            [&noise]() { FRRNoiseUtils::FillGaussian(FRRNoiseUtils::MakeKey(0, 0), 0, 0.f, 1.f, noise.GetData(), NOISE_NUM); });
+}
+
+void FRRMicroBenchmarks::RunSensorBenchmarks(const FString& InFilter, TArray<FRRBenchmarkResult>& OutResults)
+{
+    auto measure = [&InFilter, &OutResults](const TCHAR* InName, const int32 InItemsNum, auto&& InFunc)
+    {
+        if (InFilter.IsEmpty() || FCString::Stristr(InName, *InFilter))
+        {
+            Measure(InName, InItemsNum, InFunc, OutResults);
+        }
+    };
+
+    // Hits of a 32 channels x 1024 samples scan, a tenth of them missing, with 2-surface-type intensities
+    static constexpr int32 CHANNELS_NUM = 32;
+    static constexpr int32 SAMPLES_NUM = 1024;
+    FRandomStream random(0);
+    TArray<FRRLidarHit> hits;
+    hits.SetNum(SAMPLES_NUM);
+    for (FRRLidarHit& hit : hits)
+    {
+        hit.bHit = (random.FRand() > 0.1f);
+        hit.Distance = hit.bHit ? random.FRandRange(10.f, 3000.f) : 0.f;
+        hit.Point = hit.bHit ? FVector3f(random.GetUnitVector()) * hit.Distance : FVector3f::ZeroVector;
+        hit.NormalAlignment = random.FRand();
+        hit.SurfaceType = hit.bHit ? static_cast<uint8>(random.RandRange(0, 1)) : FRRLidarHit::SURFACE_TYPE_NONE;
+    }
+
+    URR2DLidarComponent::FLaserScanRaysParams laserScanParams;
+    laserScanParams.IntensityTable.Build(1000.f, 10000.f, std::numeric_limits<float>::quiet_NaN(), {});
+    FROSLaserScan laserScan;
+    measure(TEXT("lidar2d.WriteLaserScanRays"),
+            SAMPLES_NUM,
+            [&]() { URR2DLidarComponent::WriteLaserScanRays(hits, nullptr, laserScanParams, laserScan); });
+
+    // Dense cloud as packed by URR3DLidarComponent::UpdatePointCloudMsg(), misses at origin
+    FROSPointCloud2 sourceCloud;
+    const TCHAR* fields[] = {TEXT("x"), TEXT("y"), TEXT("z"), TEXT("distance"), TEXT("intensity")};
+    static_assert(UE_ARRAY_COUNT(fields) == URR3DLidarComponent::POINT_FIELDS_NUM, "fields must match POINT_FIELDS_NUM");
+    for (int32 i = 0; i < URR3DLidarComponent::POINT_FIELDS_NUM; ++i)
+    {
+        FROSPointField& field = sourceCloud.Fields.AddDefaulted_GetRef();
+        field.Name = fields[i];
+        field.Offset = i * sizeof(float);
+        field.Datatype = 7;
+        field.Count = 1;
+    }
+    sourceCloud.PointStep = sizeof(float) * URR3DLidarComponent::POINT_FIELDS_NUM;
+    sourceCloud.Height = CHANNELS_NUM;
+    sourceCloud.Width = SAMPLES_NUM;
+    sourceCloud.RowStep = sourceCloud.PointStep * SAMPLES_NUM;
+    sourceCloud.bIsDense = true;
+    sourceCloud.Data.SetNumUninitialized(CHANNELS_NUM * SAMPLES_NUM * sourceCloud.PointStep);
+    float* point = reinterpret_cast<float*>(sourceCloud.Data.GetData());
+    for (int32 i = 0; i < CHANNELS_NUM * SAMPLES_NUM; ++i, point += URR3DLidarComponent::POINT_FIELDS_NUM)
+    {
+        const FRRLidarHit& hit = hits[(i * 7) % SAMPLES_NUM];
+        point[0] = .01f * hit.Point.X;
+        point[1] = .01f * hit.Point.Y;
+        point[2] = .01f * (hit.Point.Z + (i / SAMPLES_NUM));
+        point[3] = .01f * hit.Distance;
+        point[4] = 1000.f;
+    }
+
+    // The cloud being processed in place, the copy from the source is included, as a mere memcpy into reused buffers
+    FROSPointCloud2 cloud;
+    auto measurePointCloud = [&](const TCHAR* InName, const URR3DLidarComponent::FPointCloudProcessParams& InParams)
+    {
+        measure(InName,
+                CHANNELS_NUM * SAMPLES_NUM,
+                [&]()
+                {
+                    cloud.Fields = sourceCloud.Fields;
+                    cloud.Data = sourceCloud.Data;
+                    URR3DLidarComponent::ProcessPointCloud(InParams, cloud);
+                });
+    };
+    URR3DLidarComponent::FPointCloudProcessParams pointCloudParams;
+    pointCloudParams.bRemoveNoReturns = true;
+    measurePointCloud(TEXT("lidar3d.ProcessPointCloud.RemoveNoReturns"), pointCloudParams);
+    pointCloudParams.VoxelSize = 0.1f;
+    measurePointCloud(TEXT("lidar3d.ProcessPointCloud.Voxel"), pointCloudParams);
+
+    // Dense cloud into a publisher msg, by rclUE reallocating its data each time vs written in place into its kept buffer
+    UROS2PointCloud2Msg* pointCloudMsg = NewObject<UROS2PointCloud2Msg>();
+    pointCloudMsg->Init();
+    measure(TEXT("lidar3d.SetMsg"), CHANNELS_NUM * SAMPLES_NUM, [&]() { pointCloudMsg->SetMsg(sourceCloud); });
+    measure(TEXT("lidar3d.WritePointCloud2"),
+            CHANNELS_NUM * SAMPLES_NUM,
+            [&]() { FRRROS2MsgWriter::WritePointCloud2(sourceCloud, pointCloudMsg); });
+
+    // A 1080p B8G8R8A8 readback, converted row by row as in URRROS2CameraComponent::PollReadbacks_RenderThread()
+    static constexpr int32 IMAGE_WIDTH = 1920;
+    static constexpr int32 IMAGE_HEIGHT = 1080;
+    TArray<FColor> pixels;
+    pixels.SetNumUninitialized(IMAGE_WIDTH * IMAGE_HEIGHT);
+    for (FColor& pixel : pixels)
+    {
+        pixel = FColor(random.GetUnsignedInt());
+    }
+    TArray<uint8> image;
+    auto measurePixels = [&](const TCHAR* InName, const URRROS2CameraComponent::EImageEncoding InEncoding)
+    {
+        const int32 rowSize = IMAGE_WIDTH * URRROS2CameraComponent::GetChannelsNum(InEncoding);
+        image.SetNumUninitialized(rowSize * IMAGE_HEIGHT);
+        measure(InName,
+                IMAGE_WIDTH * IMAGE_HEIGHT,
+                [&]()
+                {
+                    for (int32 row = 0; row < IMAGE_HEIGHT; ++row)
+                    {
+                        URRROS2CameraComponent::ConvertPixels(
+                            &pixels[row * IMAGE_WIDTH], &image[row * rowSize], IMAGE_WIDTH, InEncoding);
+                    }
+                });
+    };
+    measurePixels(TEXT("camera.ConvertPixels.RGB8"), URRROS2CameraComponent::EImageEncoding::RGB8);
+    measurePixels(TEXT("camera.ConvertPixels.MONO8"), URRROS2CameraComponent::EImageEncoding::MONO8);
+}
+
+void FRRMicroBenchmarks::RunFileBenchmarks(const FString& InFilter, TArray<FRRBenchmarkResult>& OutResults)
+{
+    auto getFiles = [](const TAutoConsoleVariable<FString>& InCVar)
+    {
+        TArray<FString> files;
+        InCVar.GetValueOnGameThread().ParseIntoArray(files, TEXT(";"));
+        return files;
+    };
+
+    // Named after the file, baselines being thus per reference file
+    for (const FString& meshFile : getFiles(CVarBenchmarkMeshFiles))
+    {
+        const FString name = FString::Printf(TEXT("mesh.ProcessMesh.%s"), *FPaths::GetCleanFilename(meshFile));
+        if (!InFilter.IsEmpty() && !name.Contains(InFilter))
+        {
+            continue;
+        }
+
+        // Imported once with the flags of URRMeshUtils::LoadMeshFromFile() ensuring triangulated faces & tangents
+        Assimp::Importer importer;
+        const aiScene* scene = importer.ReadFile(URRCoreUtils::FToStdString(meshFile).c_str(),
+                                                 aiProcess_GenSmoothNormals | aiProcess_CalcTangentSpace | aiProcess_Triangulate |
+                                                     aiProcess_JoinIdenticalVertices | aiProcess_SortByPType);
+        if ((nullptr == scene) || !scene->HasMeshes())
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Failed importing benchmark mesh %s"), *meshFile);
+            continue;
+        }
+        int32 verticesNum = 0;
+        for (uint32 i = 0; i < scene->mNumMeshes; ++i)
+        {
+            verticesNum += scene->mMeshes[i]->mNumVertices;
+        }
+        TArray<FRRMeshNodeData> nodes;
+        nodes.SetNum(scene->mNumMeshes);
+        Measure(name,
+                verticesNum,
+                [scene, &nodes]()
+                {
+                    for (uint32 i = 0; i < scene->mNumMeshes; ++i)
+                    {
+                        nodes[i] = URRMeshUtils::ProcessMesh(scene->mMeshes[i]);
+                    }
+                },
+                OutResults);
+    }
+
+    const TArray<FString> modelFiles = getFiles(CVarBenchmarkModelFiles);
+    if (modelFiles.Num() == 0)
+    {
+        return;
+    }
+
+    // Parsing itself is benchmarked, not the cache lookup
+    IConsoleVariable* modelCacheCVar = IConsoleManager::Get().FindConsoleVariable(TEXT("rr.RobotModelCache.Enabled"));
+    const bool bModelCacheEnabled = modelCacheCVar && modelCacheCVar->GetBool();
+    if (bModelCacheEnabled)
+    {
+        modelCacheCVar->Set(false, ECVF_SetByCode);
+    }
+    for (const FString& modelFile : modelFiles)
+    {
+        const bool bSDF = modelFile.EndsWith(TEXT(".sdf"), ESearchCase::IgnoreCase);
+        const FString name =
+            FString::Printf(TEXT("parser.%s.%s"), bSDF ? TEXT("SDF") : TEXT("URDF"), *FPaths::GetCleanFilename(modelFile));
+        if (!InFilter.IsEmpty() && !name.Contains(InFilter))
+        {
+            continue;
+        }
+
+        auto parse = [&modelFile, bSDF]()
+        {
+            // Parsers keep states, thus one per parsing
+            return bSDF ? FRRSDFParser().LoadModelInfoFromFile(modelFile) : FRRURDFParser().LoadModelInfoFromFile(modelFile);
+        };
+        FRRRobotModelInfo modelInfo = parse();
+        if (modelInfo.Data.ModelNameList.Num() == 0)
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Failed parsing benchmark model %s"), *modelFile);
+            continue;
+        }
+        Measure(name, 1, [&parse, &modelInfo]() { modelInfo = parse(); }, OutResults);
+    }
+    if (bModelCacheEnabled)
+    {
+        modelCacheCVar->Set(true, ECVF_SetByCode);
+    }
+}
+
+FString FRRMicroBenchmarks::GetBaselinesFilePath()
+{
+    FString filePath;
+    if (FParse::Value(FCommandLine::Get(), TEXT("RRBenchmarkBaselines="), filePath))
+    {
+        return filePath;
+    }
+    return FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("RRBenchmarks"), TEXT("Baselines.json"));
+}
+
+//! Baselines in [us] per benchmark name, empty if no file
+static TSharedPtr<FJsonObject> LoadBaselines(const FString& InFilePath)
+{
+    FString content;
+    TSharedPtr<FJsonObject> root;
+    if (FFileHelper::LoadFileToString(content, *InFilePath))
+    {
+        FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(content), root);
+    }
+    const TSharedPtr<FJsonObject>* baselines = nullptr;
+    return (root.IsValid() && root->TryGetObjectField(TEXT("baselines"), baselines)) ? *baselines : MakeShared<FJsonObject>();
+}
+
+bool FRRMicroBenchmarks::SaveBaselines(const TArray<FRRBenchmarkResult>& InResults)
+{
+    const FString filePath = GetBaselinesFilePath();
+    TSharedPtr<FJsonObject> baselines = LoadBaselines(filePath);
+    for (const FRRBenchmarkResult& result : InResults)
+    {
+        baselines->SetNumberField(result.Name, result.BestUs);
+    }
+
+    TSharedRef<FJsonObject> root = MakeShared<FJsonObject>();
+    root->SetStringField(TEXT("unit"), TEXT("us"));
+    root->SetObjectField(TEXT("baselines"), baselines);
+    FString content;
+    if (!FJsonSerializer::Serialize(root, TJsonWriterFactory<>::Create(&content)) ||
+        !FFileHelper::SaveStringToFile(content, *filePath))
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Failed writing micro-benchmark baselines to %s"), *filePath);
+        return false;
+    }
+    UE_LOG_WITH_INFO(LogRapyutaCore, Display, TEXT("Stored %d micro-benchmark baselines to %s"), InResults.Num(), *filePath);
+    return true;
+}
+
+int32 FRRMicroBenchmarks::CompareToBaselines(TArray<FRRBenchmarkResult>& InOutResults)
+{
+    const TSharedPtr<FJsonObject> baselines = LoadBaselines(GetBaselinesFilePath());
+    const double threshold = CVarBenchmarkRegressionThreshold.GetValueOnGameThread();
+    int32 regressedNum = 0;
+    for (FRRBenchmarkResult& result : InOutResults)
+    {
+        result.BaselineUs = 0.;
+        baselines->TryGetNumberField(result.Name, result.BaselineUs);
+        result.bRegressed = (result.BaselineUs > 0.) && (result.BestUs > (1. + threshold) * result.BaselineUs);
+        regressedNum += result.bRegressed;
+    }
+    return regressedNum;
+}
+
+FString FRRMicroBenchmarks::ToReport(const TArray<FRRBenchmarkResult>& InResults)
+{
+    FString report = TEXT("Micro-benchmarks [us] (items / iterations / best / mean / ns per item / baseline / change):");
+    for (const FRRBenchmarkResult& result : InResults)
+    {
+        report += FString::Printf(TEXT("\n  %-48s %8d / %8d / %10.2f / %10.2f / %8.2f"),
+                                  *result.Name,
+                                  result.ItemsNum,
+                                  result.Iterations,
+                                  result.BestUs,
+                                  result.MeanUs,
+                                  1e3 * result.BestUs / FMath::Max(result.ItemsNum, 1));
+        report += (result.BaselineUs > 0.) ? FString::Printf(TEXT(" / %10.2f / %+6.1f%%%s"),
+                                                             result.BaselineUs,
+                                                             100. * (result.BestUs / result.BaselineUs - 1.),
+                                                             result.bRegressed ? TEXT(" REGRESSED") : TEXT(""))
+                                           : FString(TEXT(" / no baseline"));
+    }
+    return report;
+}
@@ -26,11 +26,11 @@ void URRROS2ActorTFPublisher::TriggerPublishSrv(UROS2GenericSrv* Service)
     triggerPublishService->GetRequest(request);
     if (request.bData)
     {
-        StartPublishTimer();
+        StartTFPublishing();
     }
     else
     {
-        StopPublishTimer();
+        StopTFPublishing();
     }
 
     FROSSetBoolRes response;
@@ -62,7 +62,7 @@ void URRROS2ActorTFPublisher::SetTargetActorByActor(AActor* InActor)
     TargetActorName = TargetActor->GetName();
 }
 
-void URRROS2ActorTFPublisher::UpdateMessage(UROS2GenericMsg* InMessage)
+bool URRROS2ActorTFPublisher::GetUETFData(FROSTFStamped& OutTFData)
 {
     if (TargetActor == nullptr)
     {
@@ -72,7 +72,7 @@ void URRROS2ActorTFPublisher::UpdateMessage(UROS2GenericMsg* InMessage)
             UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("Target Actor %s is not valid."), *TargetActor->GetName());
         }
         bIsValid = false;
-        return;
+        return false;
     }
 
     if (!URRGeneralUtils::GetRelativeTransform(ReferenceActorName, ReferenceActor, TargetActor->GetTransform(), TF))
@@ -83,9 +83,9 @@ void URRROS2ActorTFPublisher::UpdateMessage(UROS2GenericMsg* InMessage)
             UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("Reference Actor %s is not valid."), *ReferenceActorName);
         }
         bIsValid = false;
-        return;
+        return false;
     }
 
     bIsValid = true;
-    Super::UpdateMessage(InMessage);
+    return Super::GetUETFData(OutTFData);
 }
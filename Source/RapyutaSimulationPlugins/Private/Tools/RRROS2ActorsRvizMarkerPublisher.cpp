@@ -2,6 +2,13 @@
 
 #include "Tools/RRROS2ActorsRvizMarkerPublisher.h"
 
+// UE
+#include "Engine/World.h"
+
+// visualization_msgs/Marker actions
+static constexpr int32 MARKER_ADD = 0;
+static constexpr int32 MARKER_DELETE = 2;
+
 URRROS2ActorsRvizMarkerPublisher::URRROS2ActorsRvizMarkerPublisher()
 {
     ActorClass = APawn::StaticClass();
@@ -12,25 +19,156 @@ URRROS2ActorsRvizMarkerPublisher::URRROS2ActorsRvizMarkerPublisher()
     SetDefaultDelegates();    //use UpdateMessage as update delegate
 }
 
-void URRROS2ActorsRvizMarkerPublisher::UpdateMessage(UROS2GenericMsg* InMessage)
+void URRROS2ActorsRvizMarkerPublisher::BeginDestroy()
+{
+    if (bActorsRegistryInited)
+    {
+        if (UWorld* world = GetWorld())
+        {
+            world->RemoveOnActorSpawnedHandler(ActorSpawnedHandle);
+            world->RemoveOnActorDestroyededHandler(ActorDestroyedHandle);
+        }
+        bActorsRegistryInited = false;
+    }
+    Super::BeginDestroy();
+}
+
+void URRROS2ActorsRvizMarkerPublisher::InitActorsRegistry()
+{
+    UWorld* world = GetWorld();
+    UGameplayStatics::GetAllActorsOfClass(world, ActorClass, Actors);
+    ActorSpawnedHandle = world->AddOnActorSpawnedHandler(
+        FOnActorSpawned::FDelegate::CreateUObject(this, &URRROS2ActorsRvizMarkerPublisher::OnActorSpawned));
+    ActorDestroyedHandle = world->AddOnActorDestroyedHandler(
+        FOnActorDestroyed::FDelegate::CreateUObject(this, &URRROS2ActorsRvizMarkerPublisher::OnActorDestroyed));
+    bActorsRegistryInited = true;
+}
+
+void URRROS2ActorsRvizMarkerPublisher::OnActorSpawned(AActor* InActor)
 {
-    if (bUpdateActorsList)
+    if (InActor && InActor->IsA(ActorClass))
     {
-        UGameplayStatics::GetAllActorsOfClass(GetWorld(), ActorClass, Actors);
+        Actors.AddUnique(InActor);
     }
+}
 
-    FROSMarkerArray msg;
-    BaseMarker.Header.Stamp = URRConversionUtils::FloatToROSStamp(UGameplayStatics::GetTimeSeconds(GetWorld()));
+void URRROS2ActorsRvizMarkerPublisher::OnActorDestroyed(AActor* InActor)
+{
+    Actors.Remove(InActor);
+}
+
+void URRROS2ActorsRvizMarkerPublisher::SyncMarkers()
+{
+    Actors.RemoveAll([](const AActor* InActor) { return !IsValid(InActor); });
+
+    bool bInSync = (Actors.Num() == MarkerActors.Num());
+    for (int32 i = 0; bInSync && (i < Actors.Num()); ++i)
+    {
+        bInSync = (MarkerActors[i].Get() == Actors[i]);
+    }
+    if (bInSync)
+    {
+        return;
+    }
+
+    // Existing markers by actor
+    TMap<AActor*, int32> markerIndices;
+    markerIndices.Reserve(MarkerActors.Num());
+    for (int32 i = 0; i < MarkerActors.Num(); ++i)
+    {
+        if (AActor* actor = MarkerActors[i].Get())
+        {
+            markerIndices.Add(actor, i);
+        }
+    }
+
+    TArray<FROSMarker> markers;
+    TArray<TWeakObjectPtr<AActor>> markerActors;
+    TArray<FTransform> markerTransforms;
+    markers.Reserve(Actors.Num());
+    markerActors.Reserve(Actors.Num());
+    markerTransforms.Reserve(Actors.Num());
     for (AActor* actor : Actors)
     {
-        FROSMarker marker = BaseMarker;
-        FTransform tf =
-            URRConversionUtils::TransformUEToROS(URRGeneralUtils::GetRelativeTransform(ReferenceActor, actor->GetTransform()));
-        marker.Ns = actor->GetName();
-        marker.Pose.Position = tf.GetTranslation();
-        marker.Pose.Orientation = tf.GetRotation();
-        msg.Markers.Add(marker);
+        int32 index = INDEX_NONE;
+        if (markerIndices.RemoveAndCopyValue(actor, index))
+        {
+            markers.Emplace(MoveTemp(Msg.Markers[index]));
+            markerTransforms.Add(MarkerTransforms[index]);
+        }
+        else
+        {
+            FROSMarker& marker = markers.Add_GetRef(BaseMarker);
+            marker.Ns = actor->GetName();
+            marker.Action = MARKER_ADD;
+            // Never equal to a valid transform, thus updated upon the next publish
+            markerTransforms.Add(FTransform(FVector(TNumericLimits<float>::Max())));
+        }
+        markerActors.Add(actor);
+    }
+
+    // Markers left are of removed or destroyed actors
+    for (int32 i = 0; i < MarkerActors.Num(); ++i)
+    {
+        if (!MarkerActors[i].IsValid() || markerIndices.Contains(MarkerActors[i].Get()))
+        {
+            FROSMarker& marker = DeletedMarkers.Add_GetRef(MoveTemp(Msg.Markers[i]));
+            marker.Action = MARKER_DELETE;
+        }
+    }
+
+    Msg.Markers = MoveTemp(markers);
+    MarkerActors = MoveTemp(markerActors);
+    MarkerTransforms = MoveTemp(markerTransforms);
+}
+
+void URRROS2ActorsRvizMarkerPublisher::UpdateMessage(UROS2GenericMsg* InMessage)
+{
+    if (bUpdateActorsList && !bActorsRegistryInited)
+    {
+        InitActorsRegistry();
+    }
+    SyncMarkers();
+
+    const FROSTime stamp = URRConversionUtils::GetCurrentROS2Time(this);
+    BaseMarker.Header.Stamp = stamp;
+    FROSMarkerArray changesMsg;
+    for (int32 i = 0; i < MarkerActors.Num(); ++i)
+    {
+        FROSMarker& marker = Msg.Markers[i];
+        marker.Header.Stamp = stamp;
+        const FTransform& actorTransf = MarkerActors[i]->GetTransform();
+        if (!MarkerTransforms[i].Equals(actorTransf))
+        {
+            MarkerTransforms[i] = actorTransf;
+            const FTransform tf =
+                URRConversionUtils::TransformUEToROS(URRGeneralUtils::GetRelativeTransform(ReferenceActor, actorTransf));
+            marker.Pose.Position = tf.GetTranslation();
+            marker.Pose.Orientation = tf.GetRotation();
+            if (bPublishChangesOnly)
+            {
+                changesMsg.Markers.Add(marker);
+            }
+        }
     }
 
-    CastChecked<UROS2MarkerArrayMsg>(InMessage)->SetMsg(msg);
+    for (auto& marker : DeletedMarkers)
+    {
+        marker.Header.Stamp = stamp;
+    }
+
+    if (bPublishChangesOnly)
+    {
+        changesMsg.Markers.Append(MoveTemp(DeletedMarkers));
+        CastChecked<UROS2MarkerArrayMsg>(InMessage)->SetMsg(changesMsg);
+    }
+    else
+    {
+        // Deleted markers are only appended for this publish
+        const int32 markersNum = Msg.Markers.Num();
+        Msg.Markers.Append(MoveTemp(DeletedMarkers));
+        CastChecked<UROS2MarkerArrayMsg>(InMessage)->SetMsg(Msg);
+        Msg.Markers.SetNum(markersNum, false);
+    }
+    DeletedMarkers.Reset();
 }
@@ -2,6 +2,20 @@
 
 #include "Tools/RRROS2BaseSensorPublisher.h"
 
+// UE
+#include "TimerManager.h"
+
+// rclUE
+#include "rclcUtilities.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRConversionUtils.h"
+#include "Sensors/RRROS2BaseSensorComponent.h"
+#include "Tools/RRFrameTelemetry.h"
+#include "Tools/RRMcapRecorder.h"
+#include "Tools/RRMemoryStats.h"
+#include "Tools/RRROS2PublisherThread.h"
+
 URRROS2BaseSensorPublisher::URRROS2BaseSensorPublisher()
 {
     // TopicName could be overridden later by users
@@ -14,6 +28,155 @@ void URRROS2BaseSensorPublisher::UpdateMessage(UROS2GenericMsg* InMessage)
 {
     if (nullptr != DataSourceComponent && DataSourceComponent->bIsValid)
     {
+        TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRSensorSetROS2Msg", RRSensorChannel);
+        FRRFrameTimeScope frameTimeScope(ERRFrameTimeCategory::ROS_PUBLISH);
+        LLM_SCOPE_BYTAG(RRROS2Msgs);
+        const double startTime = FPlatformTime::Seconds();
         DataSourceComponent->SetROS2Msg(InMessage);
+        DataSourceComponent->Stats->RecordPublish(startTime, FPlatformTime::Seconds());
+    }
+}
+
+void URRROS2BaseSensorPublisher::StartAsyncPublishing(const int32 InFrequencyHz)
+{
+    if (Channel.IsValid() || (InFrequencyHz <= 0))
+    {
+        return;
+    }
+    StopPublishTimer();
+    Channel = FRRROS2PublisherThread::Get().AddChannel(this, static_cast<uint32>(HandOffCapacity));
+    // Set before any handoff, thus before being read by the publisher thread
+    Channel->Stats = DataSourceComponent ? DataSourceComponent->Stats : nullptr;
+    GetWorld()->GetTimerManager().SetTimer(
+        HandOffTimerHandle, this, &URRROS2BaseSensorPublisher::HandOff, 1.f / static_cast<float>(InFrequencyHz), true);
+}
+
+void URRROS2BaseSensorPublisher::StopAsyncPublishing()
+{
+    if (!Channel.IsValid())
+    {
+        return;
+    }
+    if (UWorld* world = GetWorld())
+    {
+        world->GetTimerManager().ClearTimer(HandOffTimerHandle);
+    }
+    // Waits for the publisher thread to be done with this channel
+    FRRROS2PublisherThread::Get().RemoveChannel(Channel);
+    Channel.Reset();
+}
+
+void URRROS2BaseSensorPublisher::StartTimerPublishing(const int32 InFrequencyHz)
+{
+    if (Channel.IsValid() || (InFrequencyHz <= 0))
+    {
+        return;
+    }
+    StopPublishTimer();
+    GetWorld()->GetTimerManager().SetTimer(
+        HandOffTimerHandle, this, &URRROS2BaseSensorPublisher::HandOff, 1.f / static_cast<float>(InFrequencyHz), true);
+}
+
+void URRROS2BaseSensorPublisher::StopTimerPublishing()
+{
+    if (UWorld* world = GetWorld())
+    {
+        world->GetTimerManager().ClearTimer(HandOffTimerHandle);
+    }
+}
+
+int32 URRROS2BaseSensorPublisher::GetSubscribersNum() const
+{
+    size_t subscribersNum = 0;
+    if (!rcl_publisher_is_valid(&RclPublisher) ||
+        (RCL_RET_OK != rcl_publisher_get_subscription_count(&RclPublisher, &subscribersNum)))
+    {
+        return 0;
+    }
+    return static_cast<int32>(subscribersNum);
+}
+
+bool URRROS2BaseSensorPublisher::IsInitializedWith(const UROS2NodeComponent* InROS2Node) const
+{
+    return InROS2Node && (OwnerNode == InROS2Node) && rcl_publisher_is_valid(&RclPublisher);
+}
+
+void URRROS2BaseSensorPublisher::HandOff()
+{
+    if ((nullptr == DataSourceComponent) || !DataSourceComponent->bIsValid || !DataSourceComponent->HasDataToPublish())
+    {
+        return;
     }
+
+    // Published on game thread without channel, ie by #StartTimerPublishing
+    FRRROS2MsgBuilder builder;
+    if (Channel.IsValid() && DataSourceComponent->GetROS2MsgBuilder(builder))
+    {
+        if (FRRMcapRecorder::IsRecording())
+        {
+            // Recorded once built on the publisher thread, at the sim time of its handoff
+            builder = [this, innerBuilder = MoveTemp(builder), logTime = URRConversionUtils::GetSimTimeNanosec(this)](
+                          UROS2GenericMsg* InMsg) mutable
+            {
+                innerBuilder(InMsg);
+                FRRMcapRecorder::RecordPublished(*this, logTime);
+            };
+        }
+        FRRROS2PublisherThread::Get().Push(*Channel, MoveTemp(builder));
+    }
+    else if (!PublishLoaned())
+    {
+        UpdateMessage(TopicMessage);
+        Publish();
+        FRRMcapRecorder::RecordPublished(*this, URRConversionUtils::GetSimTimeNanosec(this));
+    }
+}
+
+bool URRROS2BaseSensorPublisher::PublishLoaned()
+{
+    if (!bLoanMessages || !rcl_publisher_can_loan_messages(&RclPublisher))
+    {
+        return false;
+    }
+
+    void* loanedMsg = nullptr;
+    if (RCL_RET_OK != rcl_borrow_loaned_message(&RclPublisher, TopicMessage->GetTypeSupport(), &loanedMsg))
+    {
+        return false;
+    }
+
+    FRRFrameTimeScope frameTimeScope(ERRFrameTimeCategory::ROS_PUBLISH);
+    const double startTime = FPlatformTime::Seconds();
+    if (!DataSourceComponent->WriteLoanedROS2Msg(loanedMsg))
+    {
+        rcl_return_loaned_message_from_publisher(&RclPublisher, loanedMsg);
+        return false;
+    }
+
+    if (FRRMcapRecorder::IsRecording())
+    {
+        FRRMcapRecorder::Get().Record(
+            RclPublisher, TopicMessage->GetTypeSupport(), loanedMsg, URRConversionUtils::GetSimTimeNanosec(this));
+    }
+
+    // Ownership of the loaned msg goes back to the RMW, whether published or not
+    if (RCL_RET_OK != rcl_publish_loaned_message(&RclPublisher, loanedMsg, nullptr))
+    {
+        UE_LOG_WITH_INFO(LogROS2Sensor, Warning, TEXT("[%s] Failed to publish loaned msg on %s"), *GetName(), *TopicName);
+        return false;
+    }
+    ++LoanedMsgsNum;
+    DataSourceComponent->Stats->RecordPublish(startTime, FPlatformTime::Seconds());
+    return true;
+}
+
+void URRROS2BaseSensorPublisher::BeginDestroy()
+{
+    StopAsyncPublishing();
+    Super::BeginDestroy();
+}
+
+int32 URRROS2BaseSensorPublisher::GetDroppedMsgsNum() const
+{
+    return Channel.IsValid() ? Channel->DroppedMsgsNum.load() : 0;
 }
@@ -0,0 +1,61 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRROS2BoneTFPublisher.h"
+
+// UE
+#include "Components/SkeletalMeshComponent.h"
+#include "Kismet/GameplayStatics.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRBoneTransformsCache.h"
+#include "Core/RRConversionUtils.h"
+#include "Core/RRGeneralUtils.h"
+
+URRROS2BoneTFPublisher::URRROS2BoneTFPublisher()
+{
+    PublicationFrequencyHz = 30;
+    MsgClass = UROS2TFMsgMsg::StaticClass();
+    SetDefaultDelegates();    //use UpdateMessage as update delegate
+}
+
+bool URRROS2BoneTFPublisher::InitializeWithROS2(UROS2NodeComponent* InROS2Node)
+{
+    // (NOTE) [/tf] has its [tf_prefix] only for frame ids, not topics
+    TopicName = TEXT("/tf");
+    QoS = UROS2QoS::DynamicBroadcaster;
+    return Super::InitializeWithROS2(InROS2Node);
+}
+
+void URRROS2BoneTFPublisher::UpdateMessage(UROS2GenericMsg* InMessage)
+{
+    if (!IsValid(SkeletalMeshComp))
+    {
+        return;
+    }
+
+    const FRRBoneTransforms& bones = FRRBoneTransformsCache::Get(SkeletalMeshComp);
+    const int32 bonesNum = bones.BoneSpaceTransforms.Num();
+    if (Msg.Transforms.Num() != bonesNum)
+    {
+        Msg.Transforms.SetNum(bonesNum);
+        for (int32 i = 0; i < bonesNum; ++i)
+        {
+            FROSTFStamped& tf = Msg.Transforms[i];
+            const int32 parentIndex = bones.ParentIndices[i];
+            tf.Header.FrameId = (parentIndex == INDEX_NONE)
+                                    ? RootFrameId
+                                    : URRGeneralUtils::ComposeROSFullFrameId(FramePrefix, *bones.BoneNames[parentIndex].ToString());
+            tf.ChildFrameId = URRGeneralUtils::ComposeROSFullFrameId(FramePrefix, *bones.BoneNames[i].ToString());
+        }
+    }
+
+    const FROSTime stamp = URRConversionUtils::GetCurrentROS2Time(this);
+    for (int32 i = 0; i < bonesNum; ++i)
+    {
+        FROSTFStamped& tf = Msg.Transforms[i];
+        tf.Header.Stamp = stamp;
+        tf.Transform = URRConversionUtils::TransformUEToROS(bones.BoneSpaceTransforms[i]);
+    }
+
+    CastChecked<UROS2TFMsgMsg>(InMessage)->SetMsg(Msg);
+}
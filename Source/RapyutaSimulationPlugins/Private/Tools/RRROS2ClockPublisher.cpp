@@ -3,9 +3,14 @@
 #include "Tools/RRROS2ClockPublisher.h"
 
 // rclUE
-#include "Msgs/ROS2Clock.h"
 #include "rclcUtilities.h"
 
+// RapyutaSimulationPlugins
+#include "Core/RRConversionUtils.h"
+#include "Core/RRNetworkGameState.h"
+#include "Tools/RRMcapRecorder.h"
+#include "Tools/RRLimitRTFFixedSizeCustomTimeStep.h"
+
 URRROS2ClockPublisher::URRROS2ClockPublisher()
 {
     MsgClass = UROS2ClockMsg::StaticClass();
@@ -22,25 +27,72 @@ URRROS2ClockPublisher::URRROS2ClockPublisher()
 bool URRROS2ClockPublisher::Init()
 {
     bool res = Super::Init();
-    TickDelegate = FTickerDelegate::CreateUObject(this, &URRROS2ClockPublisher::Tick);
-    TickDelegateHandle = FTSTicker::GetCoreTicker().AddTicker(TickDelegate);
+    URRLimitRTFFixedSizeCustomTimeStep* fixedTimeStep = URRLimitRTFFixedSizeCustomTimeStep::Get();
+    if (bSyncWithSimSteps && fixedTimeStep)
+    {
+        SimSteppedHandle = fixedTimeStep->OnSimStepped.AddUObject(this, &URRROS2ClockPublisher::OnSimStepped);
+    }
+    else
+    {
+        TickDelegate = FTickerDelegate::CreateUObject(this, &URRROS2ClockPublisher::Tick);
+        TickDelegateHandle = FTSTicker::GetCoreTicker().AddTicker(TickDelegate);
+    }
 
     return res;
 }
 
+void URRROS2ClockPublisher::BeginDestroy()
+{
+    if (TickDelegateHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(TickDelegateHandle);
+        TickDelegateHandle.Reset();
+    }
+    if (SimSteppedHandle.IsValid())
+    {
+        if (URRLimitRTFFixedSizeCustomTimeStep* fixedTimeStep = URRLimitRTFFixedSizeCustomTimeStep::Get())
+        {
+            fixedTimeStep->OnSimStepped.Remove(SimSteppedHandle);
+        }
+        SimSteppedHandle.Reset();
+    }
+    Super::BeginDestroy();
+}
+
 bool URRROS2ClockPublisher::Tick(float DeltaSeconds)
+{
+    PublishClock(false);
+    return true;
+}
+
+void URRROS2ClockPublisher::OnSimStepped(int64 InSimTimeNanosec)
+{
+    if (++SimStepsSincePublishNum >= FMath::Max(SimStepsPerPublishNum, 1))
+    {
+        SimStepsSincePublishNum = 0;
+        PublishClock(true);
+    }
+}
+
+void URRROS2ClockPublisher::PublishClock(const bool bInSkipUnchanged)
 {
     // Noted: Elapsed time: time in seconds since world was brought up for play
-    auto* gameState = GetWorld()->GetGameState();
+    UWorld* world = GetWorld();
+    auto* gameState = world ? world->GetGameState() : nullptr;
     if (gameState)
     {
-        // update msg
-        FROSClock msg;
-        msg.Clock = URRConversionUtils::FloatToROSStamp(gameState->GetServerWorldTimeSeconds());
+        // RR game states give the nanosec sim time, synced in clients by ARRNetworkPlayerController
+        const FROSTime clock = gameState->IsA<ARRNetworkGameState>()
+                                   ? URRConversionUtils::GetCurrentROS2Time(this)
+                                   : URRConversionUtils::FloatToROSStamp(gameState->GetServerWorldTimeSeconds());
+        if (bInSkipUnchanged && (clock.Sec == ClockMsg.Clock.Sec) && (clock.Nanosec == ClockMsg.Clock.Nanosec))
+        {
+            return;
+        }
 
-        // publish
-        Publish<UROS2ClockMsg, FROSClock>(msg);
+        // update msg & publish
+        ClockMsg.Clock = clock;
+        Publish<UROS2ClockMsg, FROSClock>(ClockMsg);
+        FRRMcapRecorder::RecordPublished(*this, URRConversionUtils::GetSimTimeNanosec(this));
     }
-
-    return true;
 }
@@ -0,0 +1,125 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRROS2CompressedImagePublisher.h"
+
+// UE
+#include "Async/Async.h"
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRCoreUtils.h"
+#include "Sensors/RRROS2CameraComponent.h"
+#include "Tools/RRFrameTelemetry.h"
+
+URRROS2CompressedImagePublisher::URRROS2CompressedImagePublisher()
+{
+    TopicName = TEXT("compressed_image");
+    MsgClass = UROS2CompressedImageMsg::StaticClass();
+}
+
+void URRROS2CompressedImagePublisher::BeginDestroy()
+{
+    if (EncodeFuture.IsValid())
+    {
+        EncodeFuture.Wait();
+        EncodeFuture.Reset();
+    }
+    Super::BeginDestroy();
+}
+
+void URRROS2CompressedImagePublisher::UpdateMessage(UROS2GenericMsg* InMessage)
+{
+    URRROS2CameraComponent* camera = Cast<URRROS2CameraComponent>(DataSourceComponent);
+    if ((nullptr == camera) || !camera->bIsValid)
+    {
+        return;
+    }
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRSensorSetCompressedImage", RRSensorChannel);
+    FRRFrameTimeScope frameTimeScope(ERRFrameTimeCategory::ROS_PUBLISH);
+    const double startTime = FPlatformTime::Seconds();
+    if (camera->SensorPublisher == this)
+    {
+        camera->UpdateImageMsg();
+    }
+
+    // 1- Collect the encoding done since the previous update
+    if (EncodeFuture.IsValid() && EncodeFuture.IsReady())
+    {
+        EncodeFuture.Reset();
+        Data.Header = RawImage.Header;
+        Data.Data.Reset(EncodedData.Num());
+        Data.Data.Append(EncodedData.GetData(), EncodedData.Num());
+    }
+
+    // 2- Start encoding the new capture, if any
+    const uint32 captureId = camera->GetImageMsgCaptureId();
+    if ((captureId != 0) && (captureId != EncodedCaptureId))
+    {
+        if (EncodeFuture.IsValid())
+        {
+            ++SkippedFramesNum;
+        }
+        else
+        {
+            const bool bPNG = CompressionFormat.Equals(TEXT("png"));
+            if (!ImageWrapper.IsValid())
+            {
+                if (!bPNG && !CompressionFormat.Equals(TEXT("jpeg")))
+                {
+                    UE_LOG_WITH_INFO(
+                        LogROS2Sensor, Warning, TEXT("[%s] Unsupported format %s, using jpeg"), *GetName(), *CompressionFormat);
+                    CompressionFormat = TEXT("jpeg");
+                }
+                URRCoreUtils::LoadImageWrapperModule();
+                ImageWrapper = URRCoreUtils::SImageWrapperModule->CreateImageWrapper(bPNG ? EImageFormat::PNG : EImageFormat::JPEG);
+            }
+
+            // The camera image keeps being updated by the raw publisher, thus is copied
+            RawImage.Header = camera->GetImageMsg().Header;
+            RawImage.Width = camera->GetImageMsg().Width;
+            RawImage.Height = camera->GetImageMsg().Height;
+            RawImage.Encoding = camera->GetImageMsg().Encoding;
+            RawImage.Data = camera->GetImageMsg().Data;
+            EncodedCaptureId = captureId;
+            Data.Format = FString::Printf(TEXT("%s; %s compressed %s"),
+                                          *RawImage.Encoding,
+                                          *CompressionFormat,
+                                          RawImage.Encoding.Equals(TEXT("mono8")) ? TEXT("mono8") : TEXT("bgr8"));
+            // PNG compression is lossless, its wrapper taking 0 as default
+            EncodeFuture = Async(EAsyncExecution::ThreadPool, [this, quality = bPNG ? 0 : JpegQuality]() { Encode(quality); });
+        }
+    }
+
+    CastChecked<UROS2CompressedImageMsg>(InMessage)->SetMsg(Data);
+    if (camera->SensorPublisher == this)
+    {
+        camera->Stats->RecordPublish(startTime, FPlatformTime::Seconds());
+    }
+}
+
+void URRROS2CompressedImagePublisher::Encode(const int32 InQuality)
+{
+    if (RawImage.Encoding.Equals(TEXT("mono8")))
+    {
+        ImageWrapper->SetRaw(RawImage.Data.GetData(), RawImage.Data.Num(), RawImage.Width, RawImage.Height, ERGBFormat::Gray, 8);
+    }
+    else
+    {
+        // rgb8 or bgr8 to BGRA8
+        const bool bRGB = RawImage.Encoding.Equals(TEXT("rgb8"));
+        const int32 pixelsNum = RawImage.Width * RawImage.Height;
+        BGRAImage.SetNumUninitialized(4 * pixelsNum, false);
+        const uint8* src = RawImage.Data.GetData();
+        uint8* dst = BGRAImage.GetData();
+        for (int32 i = 0; i < pixelsNum; ++i)
+        {
+            dst[4 * i + 0] = src[3 * i + (bRGB ? 2 : 0)];
+            dst[4 * i + 1] = src[3 * i + 1];
+            dst[4 * i + 2] = src[3 * i + (bRGB ? 0 : 2)];
+            dst[4 * i + 3] = 255;
+        }
+        ImageWrapper->SetRaw(BGRAImage.GetData(), BGRAImage.Num(), RawImage.Width, RawImage.Height, ERGBFormat::BGRA, 8);
+    }
+    EncodedData = ImageWrapper->GetCompressed(InQuality);
+}
@@ -0,0 +1,12 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRROS2ContactsStatePublisher.h"
+
+// rclUE
+#include "Msgs/ROS2ContactsState.h"
+
+URRROS2ContactsStatePublisher::URRROS2ContactsStatePublisher()
+{
+    TopicName = TEXT("bumper");
+    MsgClass = UROS2ContactsStateMsg::StaticClass();
+}
@@ -0,0 +1,137 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRROS2EntityStatesPublisher.h"
+
+// UE
+#include "Components/PrimitiveComponent.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRConversionUtils.h"
+#include "Core/RRGeneralUtils.h"
+
+URRROS2EntityStatesPublisher::URRROS2EntityStatesPublisher()
+{
+    MsgClass = UROS2ModelStatesMsg::StaticClass();
+    TopicName = TEXT("entity_states");
+    PublicationFrequencyHz = 30;
+    QoS = UROS2QoS::DynamicBroadcaster;
+    SetDefaultDelegates();    //use UpdateMessage as update delegate
+}
+
+void URRROS2EntityStatesPublisher::AddEntity(AActor* InEntity, const FString& InName)
+{
+    if (!IsValid(InEntity) || Entities.Contains(InEntity))
+    {
+        return;
+    }
+    Entities.Add(InEntity);
+    EntityNames.Add(InName.IsEmpty() ? InEntity->GetName() : InName);
+    TransformCache.Add(InEntity->GetActorTransform());
+    // Published upon the next update regardless of delta compression
+    PublishedTransforms.Add(FTransform(FVector(TNumericLimits<float>::Max())));
+}
+
+void URRROS2EntityStatesPublisher::RemoveEntity(AActor* InEntity)
+{
+    const int32 index = Entities.Find(InEntity);
+    if (INDEX_NONE != index)
+    {
+        RemoveEntityAt(index);
+    }
+}
+
+void URRROS2EntityStatesPublisher::RemoveAllEntities()
+{
+    Entities.Reset();
+    EntityNames.Reset();
+    TransformCache.Reset();
+    PublishedTransforms.Reset();
+}
+
+void URRROS2EntityStatesPublisher::RemoveEntityAt(const int32 InIndex)
+{
+    Entities.RemoveAtSwap(InIndex, 1, false);
+    EntityNames.RemoveAtSwap(InIndex, 1, false);
+    TransformCache.RemoveAtSwap(InIndex, 1, false);
+    PublishedTransforms.RemoveAtSwap(InIndex, 1, false);
+}
+
+void URRROS2EntityStatesPublisher::UpdateMessage(UROS2GenericMsg* InMessage)
+{
+    // 1- Drop destroyed entities, keeping the arrays contiguous
+    for (int32 i = Entities.Num() - 1; i >= 0; --i)
+    {
+        if (!Entities[i].IsValid())
+        {
+            RemoveEntityAt(i);
+        }
+    }
+
+    // 2- Fill the transform cache in a single pass
+    const int32 entitiesNum = Entities.Num();
+    for (int32 i = 0; i < entitiesNum; ++i)
+    {
+        TransformCache[i] = Entities[i]->GetActorTransform();
+    }
+
+    // 3- Select all entities or the moved ones only
+    const bool bKeyFrame = !bDeltaCompression || ((KeyFramePeriod > 0) && (PublishesNum % KeyFramePeriod == 0));
+    const float deltaAngleThresholdRad = FMath::DegreesToRadians(DeltaAngleThreshold);
+    PublishIndices.Reset(entitiesNum);
+    PublishTransforms.Reset(entitiesNum);
+    for (int32 i = 0; i < entitiesNum; ++i)
+    {
+        const FTransform& transf = TransformCache[i];
+        if (!bKeyFrame)
+        {
+            const FTransform& publishedTransf = PublishedTransforms[i];
+            if ((FVector::DistSquared(transf.GetLocation(), publishedTransf.GetLocation()) <
+                 FMath::Square(DeltaPositionThreshold)) &&
+                (transf.GetRotation().AngularDistance(publishedTransf.GetRotation()) < deltaAngleThresholdRad))
+            {
+                continue;
+            }
+        }
+        PublishedTransforms[i] = transf;
+        PublishIndices.Add(i);
+        PublishTransforms.Add(transf);
+    }
+
+    // 4- Poses in the ROS reference frame, in one batch
+    const FRRRefFrame refFrame = IsValid(ReferenceActor) ? URRGeneralUtils::GetCachedRefFrame(ReferenceActor) : FRRRefFrame();
+    const FQuat& refInvRotation = refFrame.InvRotation;
+    URRConversionUtils::RelativeTransformsUEToROS(refFrame, PublishTransforms, PublishTransforms);
+
+    // 5- Fill the msg
+    const int32 publishNum = PublishIndices.Num();
+    Msg.Name.Reset(publishNum);
+    Msg.Pose.Reset(publishNum);
+    Msg.Twist.Reset(publishNum);
+    for (int32 j = 0; j < publishNum; ++j)
+    {
+        const int32 i = PublishIndices[j];
+        const FTransform& relativeTransf = PublishTransforms[j];
+        FROSPose pose;
+        pose.Position = relativeTransf.GetTranslation();
+        pose.Orientation = relativeTransf.GetRotation();
+
+        // Twist in the reference frame
+        const AActor* entity = Entities[i].Get();
+        FROSTwist twist;
+        twist.Linear = URRConversionUtils::VectorUEToROS(refInvRotation.RotateVector(entity->GetVelocity()));
+        const UPrimitiveComponent* rootPrimitive = Cast<UPrimitiveComponent>(entity->GetRootComponent());
+        if (rootPrimitive && rootPrimitive->IsSimulatingPhysics())
+        {
+            // Axis-angle vector, thus mirrored as the quaternion axis in QuatUEToROS()
+            const FVector angularVel = refInvRotation.RotateVector(rootPrimitive->GetPhysicsAngularVelocityInRadians());
+            twist.Angular = FVector(-angularVel.X, angularVel.Y, -angularVel.Z);
+        }
+
+        Msg.Name.Add(EntityNames[i]);
+        Msg.Pose.Emplace(MoveTemp(pose));
+        Msg.Twist.Emplace(MoveTemp(twist));
+    }
+    ++PublishesNum;
+
+    CastChecked<UROS2ModelStatesMsg>(InMessage)->SetMsg(Msg);
+}
@@ -0,0 +1,76 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRROS2FrameTelemetryPublisher.h"
+
+// rclUE
+#include "Msgs/ROS2DiagnosticArray.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRConversionUtils.h"
+#include "Tools/RRFrameTelemetry.h"
+#include "Tools/RRLimitRTFFixedSizeCustomTimeStep.h"
+
+URRROS2FrameTelemetryPublisher::URRROS2FrameTelemetryPublisher()
+{
+    MsgClass = UROS2DiagnosticArrayMsg::StaticClass();
+    TopicName = TEXT("frame_telemetry");
+    PublicationFrequencyHz = 1;
+    SetDefaultDelegates();    //use UpdateMessage as update delegate
+}
+
+void URRROS2FrameTelemetryPublisher::UpdateMessage(UROS2GenericMsg* InMessage)
+{
+    // diagnostic_msgs/DiagnosticStatus levels
+    static constexpr uint8 LEVEL_OK = 0;
+    static constexpr uint8 LEVEL_WARN = 1;
+
+    FROSDiagnosticArray msg;
+    msg.Header.Stamp = URRConversionUtils::GetCurrentROS2Time(GetWorld());
+
+    const FRRFrameTelemetry::FSummary summary = FRRFrameTelemetry::Get().GetSummary();
+    const URRLimitRTFFixedSizeCustomTimeStep* timeStep = URRLimitRTFFixedSizeCustomTimeStep::Get();
+    // [ms] Real time a step may take at the effective RTF
+    const double stepBudgetMs = timeStep ? (1000. * timeStep->GetStepSize() / timeStep->GetEffectiveRTF()) : 0.;
+
+    auto addStatus = [&msg, stepBudgetMs, timeStep, this](const FRRFrameTimeStats& InStats, const bool bInFrame)
+    {
+        FROSDiagnosticStatus status;
+        status.Name = FString::Printf(TEXT("frame_telemetry/%s"), *InStats.Name);
+        const bool bOverBudget = bInFrame && (stepBudgetMs > 0.) && (InStats.P95Ms > (1. + OverBudgetRatio) * stepBudgetMs);
+        status.Level = bOverBudget ? LEVEL_WARN : LEVEL_OK;
+        status.Message = bOverBudget ? TEXT("Frame over the step real time budget") : TEXT("OK");
+
+        auto addValue = [&status](const TCHAR* InKey, const FString& InValue)
+        {
+            FROSKeyValue keyValue;
+            keyValue.Key = InKey;
+            keyValue.Value = InValue;
+            status.Values.Add(keyValue);
+        };
+        addValue(TEXT("steps"), FString::FromInt(InStats.StepsNum));
+        addValue(TEXT("mean_ms"), FString::SanitizeFloat(InStats.MeanMs));
+        addValue(TEXT("p50_ms"), FString::SanitizeFloat(InStats.P50Ms));
+        addValue(TEXT("p95_ms"), FString::SanitizeFloat(InStats.P95Ms));
+        addValue(TEXT("p99_ms"), FString::SanitizeFloat(InStats.P99Ms));
+        addValue(TEXT("max_ms"), FString::SanitizeFloat(InStats.MaxMs));
+        if (bInFrame && timeStep)
+        {
+            addValue(TEXT("step_budget_ms"), FString::SanitizeFloat(stepBudgetMs));
+            addValue(TEXT("target_rtf"), FString::SanitizeFloat(timeStep->GetTargetRTF()));
+            addValue(TEXT("effective_rtf"), FString::SanitizeFloat(timeStep->GetEffectiveRTF()));
+            addValue(TEXT("achieved_rtf"), FString::SanitizeFloat(timeStep->GetStats().AchievedRTF));
+        }
+        msg.Status.Add(MoveTemp(status));
+    };
+
+    for (int32 i = 0; i < summary.Categories.Num(); ++i)
+    {
+        addStatus(summary.Categories[i], static_cast<ERRFrameTimeCategory>(i) == ERRFrameTimeCategory::FRAME);
+    }
+    for (const FRRFrameTimeStats& stats : summary.SensorClasses)
+    {
+        addStatus(stats, false);
+    }
+
+    CastChecked<UROS2DiagnosticArrayMsg>(InMessage)->SetMsg(msg);
+}
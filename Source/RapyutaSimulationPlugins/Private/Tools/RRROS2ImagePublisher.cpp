@@ -12,4 +12,19 @@ URRROS2ImagePublisher::URRROS2ImagePublisher()
 {
    TopicName = TEXT("raw_image");
    MsgClass = UROS2ImgMsg::StaticClass();
-}
\ No newline at end of file
+}
+
+void URRROS2ImagePublisher::UpdateMessage(UROS2GenericMsg* InMessage)
+{
+    if (CameraOutput == ERRCameraOutput::COLOR)
+    {
+        Super::UpdateMessage(InMessage);
+        return;
+    }
+
+    URRROS2CameraComponent* camera = Cast<URRROS2CameraComponent>(DataSourceComponent);
+    if (camera && camera->bIsValid)
+    {
+        camera->SetOutputROS2Msg(CameraOutput, InMessage);
+    }
+}
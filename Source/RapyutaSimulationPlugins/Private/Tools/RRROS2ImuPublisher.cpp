@@ -0,0 +1,12 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRROS2ImuPublisher.h"
+
+// rclUE
+#include "Msgs/ROS2Imu.h"
+
+URRROS2ImuPublisher::URRROS2ImuPublisher()
+{
+    TopicName = TEXT("imu");
+    MsgClass = UROS2ImuMsg::StaticClass();
+}
@@ -0,0 +1,52 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRROS2MemoryStatsPublisher.h"
+
+// rclUE
+#include "Msgs/ROS2DiagnosticArray.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRConversionUtils.h"
+#include "Tools/RRMemoryStats.h"
+
+URRROS2MemoryStatsPublisher::URRROS2MemoryStatsPublisher()
+{
+    MsgClass = UROS2DiagnosticArrayMsg::StaticClass();
+    TopicName = TEXT("memory_stats");
+    PublicationFrequencyHz = 1;
+    SetDefaultDelegates();    //use UpdateMessage as update delegate
+}
+
+void URRROS2MemoryStatsPublisher::UpdateMessage(UROS2GenericMsg* InMessage)
+{
+    // diagnostic_msgs/DiagnosticStatus levels
+    static constexpr uint8 LEVEL_OK = 0;
+    static constexpr uint8 LEVEL_WARN = 1;
+
+    UWorld* world = GetWorld();
+    FROSDiagnosticArray msg;
+    msg.Header.Stamp = URRConversionUtils::GetCurrentROS2Time(world);
+    for (const FRRMemorySubsystemStats& stats : FRRMemoryStats::Gather(world))
+    {
+        const double megabytes = stats.Bytes / (1024. * 1024.);
+        const bool bOverWarn = (WarnMB > 0.f) && (megabytes > WarnMB);
+        FROSDiagnosticStatus status;
+        status.Name = FString::Printf(TEXT("memory_stats/%s"), *stats.Name);
+        status.Level = bOverWarn ? LEVEL_WARN : LEVEL_OK;
+        status.Message = bOverWarn ? TEXT("Memory above warning threshold") : TEXT("OK");
+
+        auto addValue = [&status](const TCHAR* InKey, const FString& InValue)
+        {
+            FROSKeyValue keyValue;
+            keyValue.Key = InKey;
+            keyValue.Value = InValue;
+            status.Values.Add(keyValue);
+        };
+        addValue(TEXT("bytes"), FString::Printf(TEXT("%lld"), stats.Bytes));
+        addValue(TEXT("mb"), FString::SanitizeFloat(megabytes));
+        addValue(TEXT("items"), FString::FromInt(stats.ItemsNum));
+        msg.Status.Add(MoveTemp(status));
+    }
+
+    CastChecked<UROS2DiagnosticArrayMsg>(InMessage)->SetMsg(msg);
+}
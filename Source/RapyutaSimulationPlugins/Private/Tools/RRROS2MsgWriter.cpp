@@ -0,0 +1,182 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRROS2MsgWriter.h"
+
+// rclUE
+#include "geometry_msgs/msg/transform_stamped.h"
+#include "nav_msgs/msg/odometry.h"
+#include "rosidl_runtime_c/primitives_sequence_functions.h"
+#include "rosidl_runtime_c/string_functions.h"
+#include "sensor_msgs/msg/image.h"
+#include "sensor_msgs/msg/point_cloud2.h"
+#include "sensor_msgs/msg/point_field.h"
+#include "tf2_msgs/msg/tf_message.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRConversionUtils.h"
+#include "Core/RRCoreUtils.h"
+
+namespace
+{
+template<typename TROSMsg>
+TROSMsg& GetROSMsg(UROS2GenericMsg* InMessage)
+{
+    // The rcl msg is owned by the msg object, only exposed as const since published as such
+    return *static_cast<TROSMsg*>(const_cast<void*>(InMessage->Get()));
+}
+
+void WriteHeader(const FROSHeader& InHeader, std_msgs__msg__Header& OutHeader)
+{
+    OutHeader.stamp.sec = InHeader.Stamp.Sec;
+    OutHeader.stamp.nanosec = InHeader.Stamp.Nanosec;
+    rosidl_runtime_c__String__assign(&OutHeader.frame_id, TCHAR_TO_UTF8(*InHeader.FrameId));
+}
+
+void WriteFrameId(const FString& InFrameId, FString& InOutWrittenFrameId, rosidl_runtime_c__String& OutFrameId)
+{
+    // Size also checked against the msg having been reinitialized since the latest write
+    if ((OutFrameId.size != static_cast<size_t>(InFrameId.Len())) ||
+        !InOutWrittenFrameId.Equals(InFrameId, ESearchCase::CaseSensitive))
+    {
+        rosidl_runtime_c__String__assign(&OutFrameId, TCHAR_TO_UTF8(*InFrameId));
+        InOutWrittenFrameId = InFrameId;
+    }
+}
+
+void WriteStamp(const FROSTime& InStamp, builtin_interfaces__msg__Time& OutStamp)
+{
+    OutStamp.sec = InStamp.Sec;
+    OutStamp.nanosec = InStamp.Nanosec;
+}
+
+void WriteVector(const FVector& InVector, geometry_msgs__msg__Vector3& OutVector)
+{
+    OutVector.x = InVector.X;
+    OutVector.y = InVector.Y;
+    OutVector.z = InVector.Z;
+}
+
+void WriteQuat(const FQuat& InQuat, geometry_msgs__msg__Quaternion& OutQuat)
+{
+    OutQuat.x = InQuat.X;
+    OutQuat.y = InQuat.Y;
+    OutQuat.z = InQuat.Z;
+    OutQuat.w = InQuat.W;
+}
+
+template<typename TCovariance>
+void WriteCovariance(const TCovariance& InCovariance, double (&OutCovariance)[36])
+{
+    const int32 num = FMath::Min(static_cast<int32>(InCovariance.Num()), 36);
+    for (int32 i = 0; i < num; ++i)
+    {
+        OutCovariance[i] = InCovariance[i];
+    }
+}
+
+void WriteData(const TArray<uint8>& InData, rosidl_runtime_c__uint8__Sequence& OutData)
+{
+    const size_t size = static_cast<size_t>(InData.Num());
+    if (OutData.capacity < size)
+    {
+        rosidl_runtime_c__uint8__Sequence__fini(&OutData);
+        if (!rosidl_runtime_c__uint8__Sequence__init(&OutData, size + size / FRRROS2MsgWriter::DATA_SLACK_DIVISOR))
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Failed to allocate %llu bytes of msg data"), static_cast<uint64>(size));
+            return;
+        }
+    }
+    if (size > 0)
+    {
+        FMemory::Memcpy(OutData.data, InData.GetData(), size);
+    }
+    OutData.size = size;
+}
+}    // namespace
+
+void FRRROS2MsgWriter::WriteImg(const FROSImg& InImg, UROS2GenericMsg* InMessage)
+{
+    sensor_msgs__msg__Image& msg = GetROSMsg<sensor_msgs__msg__Image>(CastChecked<UROS2ImgMsg>(InMessage));
+    WriteHeader(InImg.Header, msg.header);
+    msg.height = InImg.Height;
+    msg.width = InImg.Width;
+    rosidl_runtime_c__String__assign(&msg.encoding, TCHAR_TO_UTF8(*InImg.Encoding));
+    msg.is_bigendian = InImg.IsBigendian;
+    msg.step = InImg.Step;
+    WriteData(InImg.Data, msg.data);
+}
+
+void FRRROS2MsgWriter::WritePointCloud2(const FROSPointCloud2& InPointCloud, UROS2GenericMsg* InMessage)
+{
+    sensor_msgs__msg__PointCloud2& msg = GetROSMsg<sensor_msgs__msg__PointCloud2>(CastChecked<UROS2PointCloud2Msg>(InMessage));
+    WriteHeader(InPointCloud.Header, msg.header);
+    msg.height = InPointCloud.Height;
+    msg.width = InPointCloud.Width;
+
+    // Fields only reallocated upon their num changing, eg upon compacting
+    const size_t fieldsNum = static_cast<size_t>(InPointCloud.Fields.Num());
+    if (msg.fields.size != fieldsNum)
+    {
+        sensor_msgs__msg__PointField__Sequence__fini(&msg.fields);
+        sensor_msgs__msg__PointField__Sequence__init(&msg.fields, fieldsNum);
+    }
+    for (size_t i = 0; i < msg.fields.size; ++i)
+    {
+        const FROSPointField& field = InPointCloud.Fields[static_cast<int32>(i)];
+        sensor_msgs__msg__PointField& rosField = msg.fields.data[i];
+        rosidl_runtime_c__String__assign(&rosField.name, TCHAR_TO_UTF8(*field.Name));
+        rosField.offset = field.Offset;
+        rosField.datatype = field.Datatype;
+        rosField.count = field.Count;
+    }
+
+    msg.is_bigendian = InPointCloud.bIsBigendian;
+    msg.point_step = InPointCloud.PointStep;
+    msg.row_step = InPointCloud.RowStep;
+    WriteData(InPointCloud.Data, msg.data);
+    msg.is_dense = InPointCloud.bIsDense;
+}
+
+void FRRROS2MsgWriter::WriteOdom(const FROSOdom& InUEOdom,
+                                 const FString& InChildFrameId,
+                                 UROS2GenericMsg* InMessage,
+                                 FRRROS2MsgFrameIds& InOutFrameIds)
+{
+    nav_msgs__msg__Odometry& msg = GetROSMsg<nav_msgs__msg__Odometry>(CastChecked<UROS2OdomMsg>(InMessage));
+    WriteStamp(InUEOdom.Header.Stamp, msg.header.stamp);
+    WriteFrameId(InUEOdom.Header.FrameId, InOutFrameIds.FrameId, msg.header.frame_id);
+    WriteFrameId(InChildFrameId, InOutFrameIds.ChildFrameId, msg.child_frame_id);
+
+    const FVector position = URRConversionUtils::VectorUEToROS(InUEOdom.Pose.Pose.Position);
+    msg.pose.pose.position.x = position.X;
+    msg.pose.pose.position.y = position.Y;
+    msg.pose.pose.position.z = position.Z;
+    WriteQuat(URRConversionUtils::QuatUEToROS(InUEOdom.Pose.Pose.Orientation), msg.pose.pose.orientation);
+    WriteCovariance(InUEOdom.Pose.Covariance, msg.pose.covariance);
+
+    WriteVector(URRConversionUtils::VectorUEToROS(InUEOdom.Twist.Twist.Linear), msg.twist.twist.linear);
+    WriteVector(URRConversionUtils::RotationUEVectorToROS(InUEOdom.Twist.Twist.Angular), msg.twist.twist.angular);
+    WriteCovariance(InUEOdom.Twist.Covariance, msg.twist.covariance);
+}
+
+void FRRROS2MsgWriter::WriteTF(const FROSTFStamped& InTF, UROS2GenericMsg* InMessage, FRRROS2MsgFrameIds& InOutFrameIds)
+{
+    tf2_msgs__msg__TFMessage& msg = GetROSMsg<tf2_msgs__msg__TFMessage>(CastChecked<UROS2TFMsgMsg>(InMessage));
+    if (msg.transforms.size != 1)
+    {
+        geometry_msgs__msg__TransformStamped__Sequence__fini(&msg.transforms);
+        if (!geometry_msgs__msg__TransformStamped__Sequence__init(&msg.transforms, 1))
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Failed to allocate the transform of a TF msg"));
+            return;
+        }
+        InOutFrameIds = FRRROS2MsgFrameIds();
+    }
+
+    geometry_msgs__msg__TransformStamped& rosTF = msg.transforms.data[0];
+    WriteStamp(InTF.Header.Stamp, rosTF.header.stamp);
+    WriteFrameId(InTF.Header.FrameId, InOutFrameIds.FrameId, rosTF.header.frame_id);
+    WriteFrameId(InTF.ChildFrameId, InOutFrameIds.ChildFrameId, rosTF.child_frame_id);
+    WriteVector(InTF.Transform.GetTranslation(), rosTF.transform.translation);
+    WriteQuat(InTF.Transform.GetRotation(), rosTF.transform.rotation);
+}
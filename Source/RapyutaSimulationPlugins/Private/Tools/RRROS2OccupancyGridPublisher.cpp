@@ -0,0 +1,115 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRROS2OccupancyGridPublisher.h"
+
+// rclUE
+#include "ROS2NodeComponent.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRConversionUtils.h"
+#include "RapyutaSimulationPlugins.h"
+
+URRROS2OccupancyGridPublisher::URRROS2OccupancyGridPublisher()
+{
+    MsgClass = UROS2OccupancyGridMsg::StaticClass();
+    TopicName = TEXT("map");
+    // Published upon grid changes, thus without timer
+    PublicationFrequencyHz = -1;
+    // Latched for subscribers joining after the grid is published
+    QoS = UROS2QoS::StaticBroadcaster;
+}
+
+bool URRROS2OccupancyGridPublisher::InitializeWithROS2(UROS2NodeComponent* InROS2Node)
+{
+    const bool res = Super::InitializeWithROS2(InROS2Node);
+    if (res && (nullptr == UpdatesPublisher))
+    {
+        UpdatesPublisher = NewObject<UROS2Publisher>(this, TEXT("UpdatesPublisher"));
+        UpdatesPublisher->MsgClass = UROS2OccupancyGridUpdateMsg::StaticClass();
+        UpdatesPublisher->TopicName = UpdatesTopicName.IsEmpty() ? (TopicName + TEXT("_updates")) : UpdatesTopicName;
+        UpdatesPublisher->PublicationFrequencyHz = -1;
+        UpdatesPublisher->QoS = UROS2QoS::DynamicBroadcaster;
+        InROS2Node->AddPublisher(UpdatesPublisher);
+    }
+    return res;
+}
+
+void URRROS2OccupancyGridPublisher::SetGrid(const int32 InWidth,
+                                            const int32 InHeight,
+                                            const float InResolution,
+                                            const float InOriginX,
+                                            const float InOriginY,
+                                            TArrayView<const uint8> InGrid)
+{
+    if ((InWidth <= 0) || (InHeight <= 0) || (InGrid.Num() < InWidth * InHeight))
+    {
+        UE_LOG_WITH_INFO_NAMED(LogRapyutaCore, Warning, TEXT("Invalid grid of %dx%d cells"), InWidth, InHeight);
+        return;
+    }
+
+    const FROSTime stamp = URRConversionUtils::GetCurrentROS2Time(this);
+    Msg.Header.Stamp = stamp;
+    Msg.Header.FrameId = FrameId;
+    Msg.Info.MapLoadTime = stamp;
+    Msg.Info.Resolution = InResolution;
+    Msg.Info.Width = InWidth;
+    Msg.Info.Height = InHeight;
+    Msg.Info.Origin.Position = FVector(InOriginX, InOriginY, 0.);
+    Msg.Info.Origin.Orientation = FQuat::Identity;
+
+    // Grid rows from min UE Y, ie max ROS y, are flipped
+    Msg.Data.SetNumUninitialized(InWidth * InHeight);
+    for (int32 j = 0; j < InHeight; ++j)
+    {
+        const uint8* gridRow = &InGrid[j * InWidth];
+        int8* msgRow = &Msg.Data[(InHeight - 1 - j) * InWidth];
+        for (int32 i = 0; i < InWidth; ++i)
+        {
+            msgRow[i] = ToROSCell(gridRow[i]);
+        }
+    }
+    Publish<UROS2OccupancyGridMsg, FROSOccupancyGrid>(Msg);
+}
+
+void URRROS2OccupancyGridPublisher::UpdateGridArea(TArrayView<const uint8> InGrid,
+                                                   const FIntPoint& InMinCell,
+                                                   const FIntPoint& InMaxCell)
+{
+    const int32 width = Msg.Info.Width;
+    const int32 height = Msg.Info.Height;
+    if (!IsGridSet() || (InGrid.Num() < width * height))
+    {
+        return;
+    }
+    const FIntPoint minCell(FMath::Max(InMinCell.X, 0), FMath::Max(InMinCell.Y, 0));
+    const FIntPoint maxCell(FMath::Min(InMaxCell.X, width - 1), FMath::Min(InMaxCell.Y, height - 1));
+    if ((minCell.X > maxCell.X) || (minCell.Y > maxCell.Y))
+    {
+        return;
+    }
+
+    // Area rows in ROS order, from the max grid row
+    UpdateMsg.Header.Stamp = URRConversionUtils::GetCurrentROS2Time(this);
+    UpdateMsg.Header.FrameId = FrameId;
+    UpdateMsg.X = minCell.X;
+    UpdateMsg.Y = height - 1 - maxCell.Y;
+    UpdateMsg.Width = maxCell.X - minCell.X + 1;
+    UpdateMsg.Height = maxCell.Y - minCell.Y + 1;
+    UpdateMsg.Data.SetNumUninitialized(UpdateMsg.Width * UpdateMsg.Height);
+    for (int32 j = maxCell.Y, updateRow = 0; j >= minCell.Y; --j, ++updateRow)
+    {
+        const uint8* gridRow = &InGrid[j * width];
+        int8* msgRow = &Msg.Data[(height - 1 - j) * width];
+        int8* updateMsgRow = &UpdateMsg.Data[updateRow * UpdateMsg.Width];
+        for (int32 i = minCell.X; i <= maxCell.X; ++i)
+        {
+            msgRow[i] = ToROSCell(gridRow[i]);
+            updateMsgRow[i - minCell.X] = msgRow[i];
+        }
+    }
+
+    if (UpdatesPublisher)
+    {
+        UpdatesPublisher->Publish<UROS2OccupancyGridUpdateMsg, FROSOccupancyGridUpdate>(UpdateMsg);
+    }
+}
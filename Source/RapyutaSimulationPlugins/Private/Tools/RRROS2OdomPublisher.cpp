@@ -3,6 +3,7 @@
 #include "Tools/RRROS2OdomPublisher.h"
 
 // RapyutaSimulationPlugins
+#include "Core/RRROS2NodePool.h"
 #include "Drives/RobotVehicleMovementComponent.h"
 #include "Robots/RobotVehicle.h"
 
@@ -17,6 +18,8 @@ bool URRROS2OdomPublisher::InitializeWithROS2(UROS2NodeComponent* InROS2Node)
 {
     bool res = Super::InitializeWithROS2(InROS2Node);
 
+    // Namespace of the possibly new node, eg upon the interface's recycling
+    bChildFrameIdCached = false;
     if (res)
     {
         // Init TF
@@ -37,13 +40,43 @@ void URRROS2OdomPublisher::InitializeTFWithROS2(UROS2NodeComponent* InROS2Node)
 
 void URRROS2OdomPublisher::UpdateMessage(UROS2GenericMsg* InMessage)
 {
-    FROSOdom odomData;
-    bool bIsOdomDataValid = GetOdomData(odomData);
+    const URRBaseOdomComponent* odomSource = Cast<URRBaseOdomComponent>(DataSourceComponent);
+    if (odomSource)
+    {
+        const FROSOdom& odomData = odomSource->OdomData;
+        const FString& childFrameId = GetChildFrameId(odomData.ChildFrameId);
+        FRRROS2MsgWriter::WriteOdom(odomData, childFrameId, InMessage, WrittenFrameIds);
+
+        if (bPublishOdomTf && TFPublisher)
+        {
+            TFPublisher->TF = odomSource->GetOdomTF();
+            // Only copied upon changing, thus keeping the TF publisher's strings allocation
+            if (!TFPublisher->FrameId.Equals(odomData.Header.FrameId, ESearchCase::CaseSensitive))
+            {
+                TFPublisher->FrameId = odomData.Header.FrameId;
+            }
+            if (!TFPublisher->ChildFrameId.Equals(childFrameId, ESearchCase::CaseSensitive))
+            {
+                TFPublisher->ChildFrameId = childFrameId;
+            }
+        }
+    }
+}
 
-    if (bIsOdomDataValid)
+const FString& URRROS2OdomPublisher::GetChildFrameId(const FString& InOdomChildFrameId) const
+{
+    if (!bAppendNodeNamespace)
     {
-        CastChecked<UROS2OdomMsg>(InMessage)->SetMsg(odomData);
+        return InOdomChildFrameId;
     }
+    if (!bChildFrameIdCached || !CachedOdomChildFrameId.Equals(InOdomChildFrameId, ESearchCase::CaseSensitive))
+    {
+        CachedOdomChildFrameId = InOdomChildFrameId;
+        CachedChildFrameId =
+            URRGeneralUtils::ComposeROSFullFrameId(URRROS2NodePool::GetNamespace(OwnerNode, this), *InOdomChildFrameId);
+        bChildFrameIdCached = true;
+    }
+    return CachedChildFrameId;
 }
 
 bool URRROS2OdomPublisher::GetOdomData(FROSOdom& OutOdomData) const
@@ -52,10 +85,7 @@ bool URRROS2OdomPublisher::GetOdomData(FROSOdom& OutOdomData) const
     if (odomSource)
     {
         OutOdomData = URRConversionUtils::OdomUEToROS(odomSource->OdomData);
-        if (bAppendNodeNamespace)
-        {
-            OutOdomData.ChildFrameId = URRGeneralUtils::ComposeROSFullFrameId(OwnerNode->Namespace, *OutOdomData.ChildFrameId);
-        }
+        OutOdomData.ChildFrameId = GetChildFrameId(odomSource->OdomData.ChildFrameId);
 
         if (bPublishOdomTf && TFPublisher)
         {
@@ -0,0 +1,139 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRROS2PublisherThread.h"
+
+// UE
+#include "HAL/RunnableThread.h"
+#include "Misc/ScopeLock.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRTrace.h"
+#include "Tools/RRFrameTelemetry.h"
+#include "Tools/RRMemoryStats.h"
+
+FRRROS2PublisherThread& FRRROS2PublisherThread::Get()
+{
+    static FRRROS2PublisherThread sPublisherThread;
+    return sPublisherThread;
+}
+
+TSharedPtr<FRRROS2PublisherChannel> FRRROS2PublisherThread::AddChannel(URRROS2BaseSensorPublisher* InPublisher,
+                                                                       const uint32 InCapacity)
+{
+    check(IsInGameThread());
+    // One slot of TCircularQueue is always kept empty
+    TSharedPtr<FRRROS2PublisherChannel> channel =
+        MakeShared<FRRROS2PublisherChannel>(InPublisher, FMath::RoundUpToPowerOfTwo(FMath::Max(InCapacity, 1u) + 1));
+    {
+        FScopeLock lock(&ChannelsMutex);
+        Channels.Add(channel);
+    }
+    if (nullptr == Thread)
+    {
+        StartThread();
+    }
+    return channel;
+}
+
+void FRRROS2PublisherThread::RemoveChannel(const TSharedPtr<FRRROS2PublisherChannel>& InChannel)
+{
+    check(IsInGameThread());
+    bool bLast = false;
+    {
+        FScopeLock lock(&ChannelsMutex);
+        Channels.Remove(InChannel);
+        bLast = (Channels.Num() == 0);
+
+        // The thread being out of its pass, its pending builders could be dropped from here
+        FRRROS2MsgBuilder builder;
+        while (InChannel->Queue.Dequeue(builder))
+        {
+            --PendingMsgsNum;
+        }
+    }
+    if (bLast)
+    {
+        StopThread();
+    }
+}
+
+bool FRRROS2PublisherThread::Push(FRRROS2PublisherChannel& InChannel, FRRROS2MsgBuilder&& InBuilder)
+{
+    // Counted ahead, not to go negative if the thread publishes it right away
+    ++PendingMsgsNum;
+    if (!InChannel.Queue.Enqueue(MoveTemp(InBuilder)))
+    {
+        --PendingMsgsNum;
+        ++InChannel.DroppedMsgsNum;
+        ++DroppedMsgsNum;
+        return false;
+    }
+    WakeEvent->Trigger();
+    return true;
+}
+
+void FRRROS2PublisherThread::StartThread()
+{
+    bStopping = false;
+    WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+    Thread = FRunnableThread::Create(this, TEXT("RRROS2PublisherThread"), 0, TPri_Normal);
+}
+
+void FRRROS2PublisherThread::StopThread()
+{
+    if (Thread)
+    {
+        Stop();
+        Thread->WaitForCompletion();
+        delete Thread;
+        Thread = nullptr;
+        FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+        WakeEvent = nullptr;
+    }
+}
+
+void FRRROS2PublisherThread::Stop()
+{
+    bStopping = true;
+    if (WakeEvent)
+    {
+        WakeEvent->Trigger();
+    }
+}
+
+uint32 FRRROS2PublisherThread::Run()
+{
+    // Also wakes up periodically, not to depend on every trigger
+    static constexpr uint32 WAIT_MS = 10;
+    FRRROS2MsgBuilder builder;
+    while (!bStopping)
+    {
+        WakeEvent->Wait(WAIT_MS);
+        TRACE_COUNTER_SET(RRPendingPublisherThreadMsgs, PendingMsgsNum.load());
+
+        FScopeLock lock(&ChannelsMutex);
+        for (const auto& channel : Channels)
+        {
+            while (channel->Queue.Dequeue(builder))
+            {
+                UROS2GenericMsg* msg = channel->Publisher->TopicMessage;
+                if (msg)
+                {
+                    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRSensorAsyncPublish", RRSensorChannel);
+                    FRRFrameTimeScope frameTimeScope(ERRFrameTimeCategory::ROS_PUBLISH);
+                    LLM_SCOPE_BYTAG(RRROS2Msgs);
+                    const double startTime = FPlatformTime::Seconds();
+                    builder(msg);
+                    if (channel->Stats.IsValid())
+                    {
+                        channel->Stats->RecordPublish(startTime, FPlatformTime::Seconds());
+                    }
+                    channel->Publisher->Publish();
+                }
+                builder.Reset();
+                --PendingMsgsNum;
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,111 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRROS2SensorDiagnosticsPublisher.h"
+
+// UE
+#include "UObject/UObjectIterator.h"
+
+// rclUE
+#include "Msgs/ROS2DiagnosticArray.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRConversionUtils.h"
+#include "Sensors/RRROS2BaseSensorComponent.h"
+#include "Sensors/RRSensorScheduler.h"
+
+URRROS2SensorDiagnosticsPublisher::URRROS2SensorDiagnosticsPublisher()
+{
+    MsgClass = UROS2DiagnosticArrayMsg::StaticClass();
+    TopicName = TEXT("diagnostics");
+    PublicationFrequencyHz = 1;
+    SetDefaultDelegates();    //use UpdateMessage as update delegate
+}
+
+void URRROS2SensorDiagnosticsPublisher::UpdateMessage(UROS2GenericMsg* InMessage)
+{
+    // diagnostic_msgs/DiagnosticStatus levels
+    static constexpr uint8 LEVEL_OK = 0;
+    static constexpr uint8 LEVEL_WARN = 1;
+
+    UWorld* world = GetWorld();
+    FROSDiagnosticArray msg;
+    msg.Header.Stamp = URRConversionUtils::GetCurrentROS2Time(world);
+
+    auto addStatusValue = [](FROSDiagnosticStatus& InOutStatus, const TCHAR* InKey, const FString& InValue)
+    {
+        FROSKeyValue keyValue;
+        keyValue.Key = InKey;
+        keyValue.Value = InValue;
+        InOutStatus.Values.Add(keyValue);
+    };
+
+    // Overload policy of the frame-scheduled sensors
+    if (const FRRSensorScheduler* scheduler = FRRSensorScheduler::Find(world))
+    {
+        FROSDiagnosticStatus status;
+        status.Name = TEXT("sensor_scheduler");
+        bool bDegraded = false;
+        const UEnum* tierEnum = StaticEnum<ERRSensorOverloadTier>();
+        for (int32 tier = 0; tier < FRRSensorScheduler::OVERLOAD_TIERS_NUM; ++tier)
+        {
+            const float scale = scheduler->GetTierRateScale(static_cast<ERRSensorOverloadTier>(tier));
+            bDegraded |= (scale < 1.f);
+            addStatusValue(status,
+                           *FString::Printf(TEXT("%s_rate_scale"), *tierEnum->GetNameStringByValue(tier).ToLower()),
+                           FString::SanitizeFloat(scale));
+        }
+        status.Level = bDegraded ? LEVEL_WARN : LEVEL_OK;
+        status.Message = bDegraded ? TEXT("Sensor rates reduced under overload") : TEXT("OK");
+        addStatusValue(status, TEXT("measured_rtf"), FString::SanitizeFloat(scheduler->GetMeasuredRTF()));
+        addStatusValue(status, TEXT("target_rtf"), FString::SanitizeFloat(scheduler->GetTargetRTF()));
+        addStatusValue(status, TEXT("sensors"), FString::FromInt(scheduler->GetSensorsNum()));
+        msg.Status.Add(MoveTemp(status));
+    }
+    for (TObjectIterator<URRROS2BaseSensorComponent> it; it; ++it)
+    {
+        URRROS2BaseSensorComponent* sensor = *it;
+        if ((sensor->GetWorld() != world) || !IsValid(sensor->SensorPublisher))
+        {
+            continue;
+        }
+
+        const FRRSensorStats::FSummary summary = sensor->Stats->GetSummary();
+        FROSDiagnosticStatus status;
+        status.Name = FString::Printf(TEXT("%s/%s"), *GetNameSafe(sensor->GetOwner()), *sensor->GetName());
+        status.HardwareId = sensor->FrameId;
+        // Against the rate scheduled under overload, a slowed down sensor being reported as such
+        const bool bSlowedDown = (sensor->OverloadRateScale < 1.f);
+        const bool bSlow =
+            (summary.PublishedMsgsNum > 1) && (summary.PublishRateHz < MinRateRatio * sensor->GetEffectiveFrequencyHz());
+        status.Level = (bSlow || bSlowedDown) ? LEVEL_WARN : LEVEL_OK;
+        status.Message = bSlow ? TEXT("Publish rate below target")
+                               : (bSlowedDown ? TEXT("Rate reduced under overload") : TEXT("OK"));
+
+        auto addValue = [&status](const TCHAR* InKey, const FString& InValue)
+        {
+            FROSKeyValue keyValue;
+            keyValue.Key = InKey;
+            keyValue.Value = InValue;
+            status.Values.Add(keyValue);
+        };
+        addValue(TEXT("target_rate_hz"), FString::FromInt(sensor->PublicationFrequencyHz));
+        addValue(TEXT("effective_rate_hz"), FString::SanitizeFloat(sensor->GetEffectiveFrequencyHz()));
+        addValue(TEXT("overload_tier"),
+                 StaticEnum<ERRSensorOverloadTier>()->GetNameStringByValue(static_cast<int64>(sensor->OverloadTier)));
+        addValue(TEXT("achieved_rate_hz"), FString::SanitizeFloat(summary.PublishRateHz));
+        addValue(TEXT("update_mean_ms"), FString::SanitizeFloat(summary.UpdateMeanMs));
+        addValue(TEXT("update_p95_ms"), FString::SanitizeFloat(summary.UpdateP95Ms));
+        addValue(TEXT("update_max_ms"), FString::SanitizeFloat(summary.UpdateMaxMs));
+        addValue(TEXT("msg_mean_ms"), FString::SanitizeFloat(summary.MsgMeanMs));
+        addValue(TEXT("msg_p95_ms"), FString::SanitizeFloat(summary.MsgP95Ms));
+        addValue(TEXT("latency_mean_ms"), FString::SanitizeFloat(summary.LatencyMeanMs));
+        addValue(TEXT("latency_p95_ms"), FString::SanitizeFloat(summary.LatencyP95Ms));
+        addValue(TEXT("latency_max_ms"), FString::SanitizeFloat(summary.LatencyMaxMs));
+        addValue(TEXT("published_msgs"), FString::Printf(TEXT("%lld"), summary.PublishedMsgsNum));
+        addValue(TEXT("dropped_frames"), FString::FromInt(sensor->GetDroppedFramesNum()));
+        addValue(TEXT("deferred_updates"), FString::FromInt(sensor->DeferredUpdatesNum));
+        msg.Status.Add(MoveTemp(status));
+    }
+
+    CastChecked<UROS2DiagnosticArrayMsg>(InMessage)->SetMsg(msg);
+}
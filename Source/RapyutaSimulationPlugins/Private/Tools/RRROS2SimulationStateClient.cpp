@@ -3,6 +3,7 @@
 #include "Tools/RRROS2SimulationStateClient.h"
 
 // UE
+#include "Async/Async.h"
 #include "Engine/World.h"
 #include "EngineUtils.h"
 #include "Kismet/GameplayStatics.h"
@@ -10,9 +11,12 @@
 #include "TimerManager.h"
 
 // rclUE
+#include "Msgs/ROS2Str.h"
+#include "ROS2Subscriber.h"
 #include "Srvs/ROS2Attach.h"
 #include "Srvs/ROS2DeleteEntity.h"
 #include "Srvs/ROS2GetEntityState.h"
+#include "Srvs/ROS2SetBool.h"
 #include "Srvs/ROS2SetEntityState.h"
 #include "Srvs/ROS2SpawnEntities.h"
 #include "Srvs/ROS2SpawnEntity.h"
@@ -24,6 +28,8 @@
 #include "Core/RRROS2GameMode.h"
 #include "Core/RRUObjectUtils.h"
 #include "Tools/ROS2Spawnable.h"
+#include "Tools/RRInputReplay.h"
+#include "Tools/RRROS2EntityStatesPublisher.h"
 #include "Tools/SimulationState.h"
 
 void URRROS2SimulationStateClient::OnComponentCreated()
@@ -32,9 +38,20 @@ void URRROS2SimulationStateClient::OnComponentCreated()
     SetIsReplicated(true);
 }
 
+void URRROS2SimulationStateClient::OnComponentDestroyed(bool bDestroyingHierarchy)
+{
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+    Super::OnComponentDestroyed(bDestroyingHierarchy);
+}
+
 void URRROS2SimulationStateClient::Init(UROS2NodeComponent* InROS2Node)
 {
     ROS2Node = InROS2Node;
+    if (false == PostActorTickHandle.IsValid())
+    {
+        PostActorTickHandle =
+            FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &URRROS2SimulationStateClient::FlushSetEntityStateRequests);
+    }
 
     ROS2_CREATE_SERVICE_SERVER(ROS2Node,
                                this,
@@ -57,6 +74,21 @@ void URRROS2SimulationStateClient::Init(UROS2NodeComponent* InROS2Node)
                                &URRROS2SimulationStateClient::SpawnEntitiesSrv);
     ROS2_CREATE_SERVICE_SERVER(
         ROS2Node, this, TEXT("DeleteEntity"), UROS2DeleteEntitySrv::StaticClass(), &URRROS2SimulationStateClient::DeleteEntitySrv);
+    ROS2_CREATE_SERVICE_SERVER(ROS2Node,
+                               this,
+                               TEXT("CaptureWorldSnapshot"),
+                               UROS2SetBoolSrv::StaticClass(),
+                               &URRROS2SimulationStateClient::CaptureWorldSnapshotSrv);
+    ROS2_CREATE_SERVICE_SERVER(ROS2Node,
+                               this,
+                               TEXT("RestoreWorldSnapshot"),
+                               UROS2SetBoolSrv::StaticClass(),
+                               &URRROS2SimulationStateClient::RestoreWorldSnapshotSrv);
+    ROS2_CREATE_SUBSCRIBER(ROS2Node,
+                           this,
+                           EntityStateSubscriptionsTopicName,
+                           UROS2StrMsg::StaticClass(),
+                           &URRROS2SimulationStateClient::EntityStateSubscriptionCallback);
 }
 
 void URRROS2SimulationStateClient::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
@@ -110,7 +142,23 @@ template bool URRROS2SimulationStateClient::CheckEntity<TSubclassOf<AActor>>(TMa
 
 bool URRROS2SimulationStateClient::CheckEntity(const FString& InEntityName, const bool bAllowEmpty)
 {
-    return CheckEntity<AActor*>(ServerSimState->Entities, InEntityName, bAllowEmpty);
+    AActor* entity = nullptr;
+    return CheckEntity(InEntityName, bAllowEmpty, entity);
+}
+
+bool URRROS2SimulationStateClient::CheckEntity(const FString& InEntityName, const bool bAllowEmpty, AActor*& OutEntity)
+{
+    OutEntity = ServerSimState->FindEntity(InEntityName);
+    if (OutEntity || (bAllowEmpty && InEntityName.IsEmpty()))
+    {
+        return true;
+    }
+    UE_LOG_WITH_INFO_NAMED(
+        LogRapyutaCore,
+        Warning,
+        TEXT("Entity named [%s] is not under SimulationState control. Please register it to SimulationState!"),
+        *InEntityName);
+    return false;
 }
 
 bool URRROS2SimulationStateClient::CheckSpawnableEntity(const FString& InEntityName, const bool bAllowEmpty)
@@ -127,14 +175,15 @@ void URRROS2SimulationStateClient::GetEntityStateSrv(UROS2GenericSrv* InService)
 
     FROSGetEntityStateRes response;
     response.State.Name = request.Name;
-    response.bSuccess = CheckEntity(request.Name, false) && CheckEntity(request.ReferenceFrame, true);
+    AActor* entity = nullptr;
+    AActor* referenceEntity = nullptr;
+    response.bSuccess = CheckEntity(request.Name, false, entity) && CheckEntity(request.ReferenceFrame, true, referenceEntity);
 
     if (response.bSuccess)
     {
         FTransform relativeTransf;
-        FTransform worldTransf = ServerSimState->Entities[request.Name]->GetTransform();
-        URRGeneralUtils::GetRelativeTransform(
-            request.ReferenceFrame, ServerSimState->Entities.FindRef(request.ReferenceFrame), worldTransf, relativeTransf);
+        FTransform worldTransf = entity->GetTransform();
+        URRGeneralUtils::GetRelativeTransform(request.ReferenceFrame, referenceEntity, worldTransf, relativeTransf);
         relativeTransf = URRConversionUtils::TransformUEToROS(relativeTransf);
 
         response.State.Pose.Position = relativeTransf.GetTranslation();
@@ -147,6 +196,139 @@ void URRROS2SimulationStateClient::GetEntityStateSrv(UROS2GenericSrv* InService)
     GetEntityStateService->SetResponse(response);
 }
 
+bool URRROS2SimulationStateClient::SubscribeEntityStates(const FString& InSubscriptionId,
+                                                         const TArray<FString>& InEntityNames,
+                                                         const int32 InFrequencyHz,
+                                                         const FString& InReferenceFrame)
+{
+    UnsubscribeEntityStates(InSubscriptionId);
+    if (InFrequencyHz <= 0)
+    {
+        return false;
+    }
+
+    AActor* referenceEntity = nullptr;
+    if (InSubscriptionId.IsEmpty() || (nullptr == ROS2Node) || (nullptr == ServerSimState) ||
+        !CheckEntity(InReferenceFrame, true, referenceEntity))
+    {
+        return false;
+    }
+
+    // The publisher of an id is kept once unsubscribed, to be reused by its next subscriptions
+    FRREntityStatesSubscription& subscription = EntityStatesSubscriptions.FindOrAdd(InSubscriptionId);
+    if (nullptr == subscription.Publisher)
+    {
+        subscription.Publisher = NewObject<URRROS2EntityStatesPublisher>(this);
+        subscription.Publisher->TopicName = FString::Printf(TEXT("entity_states/%s"), *InSubscriptionId);
+        // Published by the subscription timer, only once its new entities are added
+        subscription.Publisher->PublicationFrequencyHz = 0;
+        ROS2Node->AddPublisher(subscription.Publisher);
+    }
+    subscription.Publisher->ReferenceActor = referenceEntity;
+    subscription.UnresolvedEntityNames = InEntityNames;
+    GetWorld()->GetTimerManager().SetTimer(
+        subscription.TimerHandle,
+        FTimerDelegate::CreateUObject(this, &URRROS2SimulationStateClient::PublishEntityStates, InSubscriptionId),
+        1.f / static_cast<float>(InFrequencyHz),
+        true);
+
+    UE_LOG_WITH_INFO_NAMED(LogRapyutaCore,
+                           Log,
+                           TEXT("Publishing %d entity states at %dHz on %s"),
+                           InEntityNames.Num(),
+                           InFrequencyHz,
+                           *subscription.Publisher->TopicName);
+    return true;
+}
+
+void URRROS2SimulationStateClient::UnsubscribeEntityStates(const FString& InSubscriptionId)
+{
+    if (FRREntityStatesSubscription* subscription = EntityStatesSubscriptions.Find(InSubscriptionId))
+    {
+        if (UWorld* world = GetWorld())
+        {
+            world->GetTimerManager().ClearTimer(subscription->TimerHandle);
+        }
+        if (subscription->Publisher)
+        {
+            subscription->Publisher->RemoveAllEntities();
+        }
+        subscription->UnresolvedEntityNames.Reset();
+    }
+}
+
+void URRROS2SimulationStateClient::PublishEntityStates(const FString InSubscriptionId)
+{
+    FRREntityStatesSubscription* subscription = EntityStatesSubscriptions.Find(InSubscriptionId);
+    if ((nullptr == subscription) || (nullptr == subscription->Publisher) || (nullptr == ServerSimState))
+    {
+        return;
+    }
+
+    // Entities are looked up once found, the publisher then keeping them in its own contiguous arrays
+    for (int32 i = subscription->UnresolvedEntityNames.Num() - 1; i >= 0; --i)
+    {
+        const FString& name = subscription->UnresolvedEntityNames[i];
+        if (AActor* entity = ServerSimState->FindEntity(name))
+        {
+            subscription->Publisher->AddEntity(entity, name);
+            subscription->UnresolvedEntityNames.RemoveAtSwap(i, 1, false);
+        }
+    }
+
+    subscription->Publisher->UpdateMessage(subscription->Publisher->TopicMessage);
+    subscription->Publisher->Publish();
+}
+
+void URRROS2SimulationStateClient::EntityStateSubscriptionCallback(const UROS2GenericMsg* InMsg)
+{
+    const UROS2StrMsg* strMsg = Cast<UROS2StrMsg>(InMsg);
+    if (nullptr == strMsg)
+    {
+        return;
+    }
+    FROSStr msg;
+    strMsg->GetMsg(msg);
+
+    TArray<FString> tokens;
+    msg.Data.ParseIntoArrayWS(tokens);
+    if ((tokens.Num() < 2) || !tokens[1].IsNumeric())
+    {
+        UE_LOG_WITH_INFO_NAMED(
+            LogRapyutaCore, Warning, TEXT("Invalid entity states subscription [%s], expected <id> <Hz> <names>"), *msg.Data);
+        return;
+    }
+
+    const int32 frequencyHz = FCString::Atoi(*tokens[1]);
+    FString referenceFrame;
+    TArray<FString> entityNames;
+    for (int32 i = 2; i < tokens.Num(); ++i)
+    {
+        if (tokens[i].StartsWith(TEXT("@")))
+        {
+            referenceFrame = tokens[i].RightChop(1);
+        }
+        else
+        {
+            entityNames.Add(MoveTemp(tokens[i]));
+        }
+    }
+
+    // (Note) The callback could be invoked from a ROS working thread, the publisher & its timer being created on game thread
+    AsyncTask(ENamedThreads::GameThread,
+              [weakThis = TWeakObjectPtr<URRROS2SimulationStateClient>(this),
+               id = MoveTemp(tokens[0]),
+               entityNames = MoveTemp(entityNames),
+               frequencyHz,
+               referenceFrame = MoveTemp(referenceFrame)]
+              {
+                  if (URRROS2SimulationStateClient* client = weakThis.Get())
+                  {
+                      client->SubscribeEntityStates(id, entityNames, frequencyHz, referenceFrame);
+                  }
+              });
+}
+
 void URRROS2SimulationStateClient::SetEntityStateSrv(UROS2GenericSrv* InService)
 {
     UROS2SetEntityStateSrv* setEntityStateService = Cast<UROS2SetEntityStateSrv>(InService);
@@ -159,8 +341,8 @@ void URRROS2SimulationStateClient::SetEntityStateSrv(UROS2GenericSrv* InService)
 
     if (response.bSuccess)
     {
-        // RPC to Server
-        ServerSetEntityState(request);
+        // RPC to Server, coalesced with the other requests of this frame
+        PendingSetEntityStateRequests.Emplace(MoveTemp(request));
     }
 
     setEntityStateService->SetResponse(response);
@@ -168,9 +350,52 @@ void URRROS2SimulationStateClient::SetEntityStateSrv(UROS2GenericSrv* InService)
 
 void URRROS2SimulationStateClient::ServerSetEntityState_Implementation(const FROSSetEntityStateReq& InRequest)
 {
+    // Live requests are ignored while the recorded ones are replayed
+    URRInputReplay* inputReplay = URRInputReplay::Get(GetWorld());
+    if (inputReplay && inputReplay->IsReplaying())
+    {
+        return;
+    }
+    if (inputReplay)
+    {
+        inputReplay->RecordSetEntityState(InRequest);
+    }
     ServerSimState->ServerSetEntityState(InRequest);
 }
 
+void URRROS2SimulationStateClient::ServerSetEntityStates_Implementation(const TArray<FROSSetEntityStateReq>& InRequests)
+{
+    // Live requests are ignored while the recorded ones are replayed
+    URRInputReplay* inputReplay = URRInputReplay::Get(GetWorld());
+    if (inputReplay && inputReplay->IsReplaying())
+    {
+        return;
+    }
+    if (inputReplay)
+    {
+        inputReplay->RecordSetEntityStates(InRequests);
+    }
+    ServerSimState->ServerSetEntityStates(InRequests);
+}
+
+void URRROS2SimulationStateClient::FlushSetEntityStateRequests(UWorld* InWorld, ELevelTick InTickType, float InDeltaSeconds)
+{
+    if ((InWorld != GetWorld()) || (PendingSetEntityStateRequests.Num() == 0))
+    {
+        return;
+    }
+
+    if (PendingSetEntityStateRequests.Num() == 1)
+    {
+        ServerSetEntityState(PendingSetEntityStateRequests[0]);
+    }
+    else
+    {
+        ServerSetEntityStates(PendingSetEntityStateRequests);
+    }
+    PendingSetEntityStateRequests.Reset();
+}
+
 void URRROS2SimulationStateClient::AttachSrv(UROS2GenericSrv* InService)
 {
     UROS2AttachSrv* attachService = Cast<UROS2AttachSrv>(InService);
@@ -201,46 +426,46 @@ void URRROS2SimulationStateClient::AttachSrv(UROS2GenericSrv* InService)
 
 void URRROS2SimulationStateClient::ServerAttach_Implementation(const FROSAttachReq& InRequest)
 {
+    // Live requests are ignored while the recorded ones are replayed
+    URRInputReplay* inputReplay = URRInputReplay::Get(GetWorld());
+    if (inputReplay && inputReplay->IsReplaying())
+    {
+        return;
+    }
+    if (inputReplay)
+    {
+        inputReplay->RecordAttach(InRequest);
+    }
     ServerSimState->ServerAttach(InRequest);
 }
 
 FROSSpawnEntityRes URRROS2SimulationStateClient::SpawnEntityImpl(FROSSpawnEntityReq& InRequest)
+{
+    FROSSpawnEntityRes response = CheckSpawnEntityRequest(InRequest);
+    if (response.bSuccess)
+    {
+        // RPC to Server's Spawn entity
+        ServerSpawnEntity(InRequest);
+
+        // RPC is not blocking and can't get actor even if it is spawned.
+        // todo: handle failed to spawn with collision and etc.
+    }
+    return response;
+}
+
+FROSSpawnEntityRes URRROS2SimulationStateClient::CheckSpawnEntityRequest(const FROSSpawnEntityReq& InRequest)
 {
     FROSSpawnEntityRes response;
     response.bSuccess = CheckSpawnableEntity(InRequest.Xml, false) && CheckEntity(InRequest.State.ReferenceFrame, true);
     if (response.bSuccess)
     {
-        const FString& entityModelName = InRequest.Xml;
         const FString& entityName = InRequest.State.Name;
         if (entityName.IsEmpty())
         {
             response.bSuccess = false;
             response.StatusMessage = FString::Printf(TEXT("[%s] Failed to spawn entity. Entity Name is empty"), *GetName());
         }
-        else if (nullptr == URRUObjectUtils::FindActorByName<AActor>(GetWorld(), entityName))
-        {
-            // RPC to Server's Spawn entity
-            ServerSpawnEntity(InRequest);
-
-            // RPC is not blocking and can't get actor even if it is spawned.
-            // todo: handle failed to spawn with collision and etc.
-
-            // AActor* newEntity = URRUObjectUtils::FindActorByName<AActor>(GetWorld(), entityName);
-            // if (nullptr == newEntity)
-            // {
-            //     response.bSuccess = false;
-            //     response.StatusMessage =
-            //         FString::Printf(TEXT("[%s] Failed to spawn entity named %s, probably out collision!"), *GetName(),
-            //         *entityName);
-            // }
-            // else
-            // {
-            response.bSuccess = true;
-            // response.StatusMessage = FString::Printf(TEXT("Spawning Entity of model [%s] as [%s]"), *entityModelName,
-            // *entityName);
-            // }
-        }
-        else
+        else if (URRUObjectUtils::FindActorByName<AActor>(GetWorld(), entityName))
         {
             response.bSuccess = false;
             response.StatusMessage = FString::Printf(
@@ -268,6 +493,9 @@ void URRROS2SimulationStateClient::SpawnEntitiesSrv(UROS2GenericSrv* InService)
 
     int32 numEntitySpawned = 0;
     FString statusMessage;
+    TArray<FROSSpawnEntityReq> entityRequests;
+    entityRequests.Reserve(entityListRequest.State.Num());
+    TSet<FString> entityNames;
     for (uint32 i = 0; i < entityListRequest.State.Num(); ++i)
     {
         UE_LOG_WITH_INFO(LogRapyutaCore,
@@ -281,12 +509,25 @@ void URRROS2SimulationStateClient::SpawnEntitiesSrv(UROS2GenericSrv* InService)
         entityRequest.State = entityListRequest.State[i];
         entityRequest.Tags = entityListRequest.Tags;
 
-        FROSSpawnEntityRes res = SpawnEntityImpl(entityRequest);
+        // Validated one by one, to report per-entity status, then all spawned by a single RPC
+        FROSSpawnEntityRes res = CheckSpawnEntityRequest(entityRequest);
+        bool bDuplicated = false;
+        entityNames.Add(entityRequest.State.Name, &bDuplicated);
+        if (res.bSuccess && bDuplicated)
+        {
+            res.bSuccess = false;
+            res.StatusMessage = FString::Printf(TEXT("[%s] Duplicated entity name in request"), *GetName());
+        }
         if (res.bSuccess)
         {
             numEntitySpawned++;
+            entityRequests.Emplace(MoveTemp(entityRequest));
         }
-        statusMessage.Append(FString::Printf(TEXT("%s:%s, "), *entityRequest.State.Name, *res.StatusMessage));
+        statusMessage.Append(FString::Printf(TEXT("%s:%s, "), *entityListRequest.State[i].Name, *res.StatusMessage));
+    }
+    if (entityRequests.Num() > 0)
+    {
+        ServerSpawnEntities(entityRequests);
     }
 
     FROSSpawnEntitiesRes entityListResponse;
@@ -297,7 +538,33 @@ void URRROS2SimulationStateClient::SpawnEntitiesSrv(UROS2GenericSrv* InService)
 
 void URRROS2SimulationStateClient::ServerSpawnEntity_Implementation(const FROSSpawnEntityReq& InRequest)
 {
-    ServerSimState->ServerSpawnEntity(InRequest, NetworkPlayerId);
+    // Spawned in later frames, by a bounded number per frame
+    // Live requests are ignored while the recorded ones are replayed
+    URRInputReplay* inputReplay = URRInputReplay::Get(GetWorld());
+    if (inputReplay && inputReplay->IsReplaying())
+    {
+        return;
+    }
+    if (inputReplay)
+    {
+        inputReplay->RecordSpawnEntity(InRequest, NetworkPlayerId);
+    }
+    ServerSimState->ServerQueueSpawnEntity(InRequest, NetworkPlayerId);
+}
+
+void URRROS2SimulationStateClient::ServerSpawnEntities_Implementation(const TArray<FROSSpawnEntityReq>& InRequests)
+{
+    // Live requests are ignored while the recorded ones are replayed
+    URRInputReplay* inputReplay = URRInputReplay::Get(GetWorld());
+    if (inputReplay && inputReplay->IsReplaying())
+    {
+        return;
+    }
+    if (inputReplay)
+    {
+        inputReplay->RecordSpawnEntities(InRequests, NetworkPlayerId);
+    }
+    ServerSimState->ServerSpawnEntities(InRequests, NetworkPlayerId);
 }
 
 // Currently this code doesnt seem to trigger the ROS 2 Service Response... keeping this in since if
@@ -312,8 +579,9 @@ void URRROS2SimulationStateClient::SpawnEntityCheck()
         SpawnEntityService->GetRequest(request);
 
         AActor* matchingEntity;
-        for (auto& entity : SimulationState->EntityList)
+        for (auto& entityItem : SimulationState->EntityRegistry.Items)
         {
+            AActor* entity = entityItem.Actor;
             if (entity)
             {
                 UROS2Spawnable* rosSpawnParameters = Entity->FindComponentByClass<UROS2Spawnable>();
@@ -362,7 +630,7 @@ void URRROS2SimulationStateClient::DeleteEntitySrv(UROS2GenericSrv* InService)
 
     FROSDeleteEntityRes response;
     response.bSuccess = false;
-    if (ServerSimState->Entities.Contains(request.Name))
+    if (ServerSimState->FindEntity(request.Name))
     {
         // RPC to server
         ServerDeleteEntity(request);
@@ -382,6 +650,16 @@ void URRROS2SimulationStateClient::DeleteEntitySrv(UROS2GenericSrv* InService)
 
 void URRROS2SimulationStateClient::ServerDeleteEntity_Implementation(const FROSDeleteEntityReq& InRequest)
 {
+    // Live requests are ignored while the recorded ones are replayed
+    URRInputReplay* inputReplay = URRInputReplay::Get(GetWorld());
+    if (inputReplay && inputReplay->IsReplaying())
+    {
+        return;
+    }
+    if (inputReplay)
+    {
+        inputReplay->RecordDeleteEntity(InRequest);
+    }
     ServerSimState->ServerDeleteEntity(InRequest);
 }
 
@@ -389,3 +667,48 @@ void URRROS2SimulationStateClient::ServerAddEntity_Implementation(AActor* InEnti
 {
     ServerSimState->ServerAddEntity(InEntity);
 }
+
+void URRROS2SimulationStateClient::CaptureWorldSnapshotSrv(UROS2GenericSrv* InService)
+{
+    UROS2SetBoolSrv* captureService = Cast<UROS2SetBoolSrv>(InService);
+
+    FROSSetBoolReq request;
+    captureService->GetRequest(request);
+
+    // RPC to Server
+    ServerCaptureWorldSnapshot(ASimulationState::DEFAULT_WORLD_SNAPSHOT_NAME, request.bData);
+
+    FROSSetBoolRes response;
+    response.bSuccess = true;
+    captureService->SetResponse(response);
+}
+
+void URRROS2SimulationStateClient::RestoreWorldSnapshotSrv(UROS2GenericSrv* InService)
+{
+    UROS2SetBoolSrv* restoreService = Cast<UROS2SetBoolSrv>(InService);
+
+    // RPC to Server
+    ServerRestoreWorldSnapshot(ASimulationState::DEFAULT_WORLD_SNAPSHOT_NAME);
+
+    FROSSetBoolRes response;
+    response.bSuccess = true;
+    restoreService->SetResponse(response);
+}
+
+void URRROS2SimulationStateClient::ServerCaptureWorldSnapshot_Implementation(const FString& InSnapshotName,
+                                                                             const bool bInCapture)
+{
+    if (bInCapture)
+    {
+        ServerSimState->ServerCaptureWorldSnapshot(InSnapshotName);
+    }
+    else
+    {
+        ServerSimState->ServerRemoveWorldSnapshot(InSnapshotName);
+    }
+}
+
+void URRROS2SimulationStateClient::ServerRestoreWorldSnapshot_Implementation(const FString& InSnapshotName)
+{
+    ServerSimState->ServerRestoreWorldSnapshot(InSnapshotName);
+}
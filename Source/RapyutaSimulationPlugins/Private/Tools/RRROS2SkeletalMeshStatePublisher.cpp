@@ -53,11 +53,7 @@ void URRROS2SkeletalMeshStatePublisher::UpdateMessage(UROS2GenericMsg* InMessage
 
     UROS2EntityStateMsg* stateMsg = CastChecked<UROS2EntityStateMsg>(InMessage);
 
-#if 0    // To be enabled when bone transform is used in the message content
-    const TArray<FTransform> boneTransforms = SkeletalMeshComp->GetBoneSpaceTransforms();
-    if (boneTransforms.IsValidIndex(Idx))
-    {
-#endif
+    // Bone transforms are published by URRROS2BoneTFPublisher
     const FTransform& robotTransform = Robot->GetTransform();
 
     FROSEntityState data;
@@ -81,14 +77,6 @@ void URRROS2SkeletalMeshStatePublisher::UpdateMessage(UROS2GenericMsg* InMessage
     data.Twist.Angular = FVector::ZeroVector;
     data.ReferenceFrame = ReferenceFrameId;
     stateMsg->SetMsg(data);
-
-#if 0
-    if ((++Idx) >= boneTransforms.Num())
-    {
-        Idx = 0;
-    }
-}
-#endif
     // DrawDebugDirectionalArrow(GetWorld(), data.position, data.position + data.orientation.GetForwardVector()*100, 100,
     // FColor(255, 0, 0, 255), false, 10, 1, 10);
 }
@@ -0,0 +1,45 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRROS2StartupProfilePublisher.h"
+
+// rclUE
+#include "Msgs/ROS2DiagnosticArray.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRConversionUtils.h"
+#include "Tools/RRStartupProfiler.h"
+
+URRROS2StartupProfilePublisher::URRROS2StartupProfilePublisher()
+{
+    MsgClass = UROS2DiagnosticArrayMsg::StaticClass();
+    TopicName = TEXT("startup_profile");
+    PublicationFrequencyHz = 1;
+    SetDefaultDelegates();    //use UpdateMessage as update delegate
+}
+
+void URRROS2StartupProfilePublisher::UpdateMessage(UROS2GenericMsg* InMessage)
+{
+    FROSDiagnosticArray msg;
+    msg.Header.Stamp = URRConversionUtils::GetCurrentROS2Time(GetWorld());
+    for (const FRRStartupPhaseStats& stats : FRRStartupProfiler::Get().GetStats())
+    {
+        FROSDiagnosticStatus status;
+        status.Name = FString::Printf(TEXT("startup_profile/%s"), *stats.Name);
+        status.Message = TEXT("OK");
+
+        auto addValue = [&status](const TCHAR* InKey, const FString& InValue)
+        {
+            FROSKeyValue keyValue;
+            keyValue.Key = InKey;
+            keyValue.Value = InValue;
+            status.Values.Add(keyValue);
+        };
+        addValue(TEXT("count"), FString::Printf(TEXT("%lld"), stats.Count));
+        addValue(TEXT("total_ms"), FString::SanitizeFloat(stats.TotalMs));
+        addValue(TEXT("mean_ms"), FString::SanitizeFloat((stats.Count > 0) ? (stats.TotalMs / stats.Count) : 0.));
+        addValue(TEXT("max_ms"), FString::SanitizeFloat(stats.MaxMs));
+        msg.Status.Add(MoveTemp(status));
+    }
+
+    CastChecked<UROS2DiagnosticArrayMsg>(InMessage)->SetMsg(msg);
+}
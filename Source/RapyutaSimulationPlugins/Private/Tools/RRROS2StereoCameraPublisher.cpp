@@ -0,0 +1,25 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRROS2StereoCameraPublisher.h"
+
+// rclUE
+#include "Msgs/ROS2CameraInfo.h"
+#include "Msgs/ROS2Img.h"
+
+// RapyutaSimulationPlugins
+#include "Sensors/RRROS2StereoCameraComponent.h"
+
+void URRROS2StereoCameraPublisher::SetStereoOutput(const ERRStereoCameraOutput InOutput)
+{
+    StereoOutput = InOutput;
+    MsgClass = (InOutput == ERRStereoCameraOutput::RIGHT_IMAGE) ? UROS2ImgMsg::StaticClass() : UROS2CameraInfoMsg::StaticClass();
+}
+
+void URRROS2StereoCameraPublisher::UpdateMessage(UROS2GenericMsg* InMessage)
+{
+    URRROS2StereoCameraComponent* camera = Cast<URRROS2StereoCameraComponent>(DataSourceComponent);
+    if (camera && camera->bIsValid)
+    {
+        camera->SetStereoROS2Msg(StereoOutput, InMessage);
+    }
+}
@@ -0,0 +1,152 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRROS2TFAggregatePublisher.h"
+
+// UE
+#include "Engine/World.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRConversionUtils.h"
+#include "Core/RRTrace.h"
+#include "Tools/RRMcapRecorder.h"
+
+TMap<UWorld*, TWeakObjectPtr<URRROS2TFAggregatePublisher>> URRROS2TFAggregatePublisher::SPublishers;
+TMap<UWorld*, TWeakObjectPtr<URRROS2TFAggregatePublisher>> URRROS2TFAggregatePublisher::SStaticPublishers;
+
+URRROS2TFAggregatePublisher::URRROS2TFAggregatePublisher()
+{
+    MsgClass = UROS2TFMsgMsg::StaticClass();
+    // Published upon world post actor tick, thus without timer
+    PublicationFrequencyHz = -1;
+}
+
+URRROS2TFAggregatePublisher* URRROS2TFAggregatePublisher::Get(UWorld* InWorld, const bool bInStatic)
+{
+    const TWeakObjectPtr<URRROS2TFAggregatePublisher>* publisher = (bInStatic ? SStaticPublishers : SPublishers).Find(InWorld);
+    return publisher ? publisher->Get() : nullptr;
+}
+
+bool URRROS2TFAggregatePublisher::InitializeWithROS2(UROS2NodeComponent* InROS2Node)
+{
+    // (NOTE) [/tf, /tf_static] has its [tf_prefix] only for frame ids, not topics
+    if (IsStatic)
+    {
+        TopicName = TEXT("/tf_static");
+        QoS = UROS2QoS::StaticBroadcaster;
+    }
+    else
+    {
+        TopicName = TEXT("/tf");
+        QoS = UROS2QoS::DynamicBroadcaster;
+    }
+    return Super::InitializeWithROS2(InROS2Node);
+}
+
+bool URRROS2TFAggregatePublisher::Init()
+{
+    const bool res = Super::Init();
+    if (res)
+    {
+        UWorld* world = GetWorld();
+        TWeakObjectPtr<URRROS2TFAggregatePublisher>& registered = (IsStatic ? SStaticPublishers : SPublishers).FindOrAdd(world);
+        if (registered.IsValid() && (registered.Get() != this))
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore,
+                             Warning,
+                             TEXT("[%s] replaces [%s] as the TF aggregate publisher of world %s"),
+                             *GetName(),
+                             *registered->GetName(),
+                             *world->GetName());
+        }
+        registered = this;
+        PostActorTickHandle =
+            FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &URRROS2TFAggregatePublisher::OnWorldPostActorTick);
+    }
+    return res;
+}
+
+void URRROS2TFAggregatePublisher::BeginDestroy()
+{
+    FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+    for (auto* publishers : {&SPublishers, &SStaticPublishers})
+    {
+        for (auto it = publishers->CreateIterator(); it; ++it)
+        {
+            if (!it->Value.IsValid() || (it->Value.Get() == this))
+            {
+                it.RemoveCurrent();
+            }
+        }
+    }
+    Super::BeginDestroy();
+}
+
+void URRROS2TFAggregatePublisher::AddTransform(FROSTFStamped&& InTF)
+{
+    if (!IsStatic)
+    {
+        Transforms.Emplace(MoveTemp(InTF));
+        return;
+    }
+
+    // Static transforms are only republished upon changes
+    FROSTFStamped* existingTF = StaticTransforms.Find(InTF.ChildFrameId);
+    if ((nullptr == existingTF) || (existingTF->Header.FrameId != InTF.Header.FrameId) ||
+        !existingTF->Transform.Equals(InTF.Transform))
+    {
+        StaticTransforms.Add(InTF.ChildFrameId, MoveTemp(InTF));
+        bStaticTransformsDirty = true;
+    }
+}
+
+void URRROS2TFAggregatePublisher::AddUETransform(FROSTFStamped&& InTF)
+{
+    if (IsStatic)
+    {
+        InTF.Transform = URRConversionUtils::TransformUEToROS(InTF.Transform);
+        AddTransform(MoveTemp(InTF));
+        return;
+    }
+    UETransformsBatch.Add(InTF.Transform);
+    UETransforms.Emplace(MoveTemp(InTF));
+}
+
+void URRROS2TFAggregatePublisher::OnWorldPostActorTick(UWorld* InWorld, ELevelTick /*InTickType*/, float /*InDeltaSeconds*/)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRTFAggregatePublish", RRROS2Channel);
+    if (InWorld != GetWorld())
+    {
+        return;
+    }
+
+    if (IsStatic)
+    {
+        if (!bStaticTransformsDirty)
+        {
+            return;
+        }
+        StaticTransforms.GenerateValueArray(Msg.Transforms);
+        bStaticTransformsDirty = false;
+    }
+    else
+    {
+        if ((Transforms.Num() == 0) && (UETransforms.Num() == 0))
+        {
+            return;
+        }
+        Msg.Transforms.Reset();
+        Swap(Msg.Transforms, Transforms);
+
+        URRConversionUtils::TransformsUEToROS(UETransformsBatch, UETransformsBatch);
+        Msg.Transforms.Reserve(Msg.Transforms.Num() + UETransforms.Num());
+        for (int32 i = 0; i < UETransforms.Num(); ++i)
+        {
+            UETransforms[i].Transform = UETransformsBatch[i];
+            Msg.Transforms.Emplace(MoveTemp(UETransforms[i]));
+        }
+        UETransforms.Reset();
+        UETransformsBatch.Reset();
+    }
+    Publish<UROS2TFMsgMsg, FROSTFMsg>(Msg);
+    FRRMcapRecorder::RecordPublished(*this, URRConversionUtils::GetSimTimeNanosec(this));
+}
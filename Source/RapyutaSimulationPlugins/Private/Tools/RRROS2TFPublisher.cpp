@@ -2,10 +2,17 @@
 
 #include "Tools/RRROS2TFPublisher.h"
 
+// UE
+#include "TimerManager.h"
+
 // rclUE
 #include "Msgs/ROS2TFMsg.h"
 #include "rclcUtilities.h"
 
+// RapyutaSimulationPlugins
+#include "Tools/RRMcapRecorder.h"
+#include "Tools/RRROS2TFAggregatePublisher.h"
+
 URRROS2TFPublisher::URRROS2TFPublisher()
 {
     PublicationFrequencyHz = 50;
@@ -35,20 +42,99 @@ void URRROS2TFPublisher::SetTransform(const FVector& Translation, const FQuat& R
     TF.SetRotation(Rotation);
 }
 
-void URRROS2TFPublisher::UpdateMessage(UROS2GenericMsg* InMessage)
+bool URRROS2TFPublisher::Init()
+{
+    const bool res = Super::Init();
+    if (res && bAggregate)
+    {
+        StopPublishTimer();
+        StartTFPublishing();
+    }
+    return res;
+}
+
+void URRROS2TFPublisher::StartTFPublishing()
+{
+    if (!bAggregate)
+    {
+        StartPublishTimer();
+    }
+    else if (PublicationFrequencyHz > 0)
+    {
+        GetWorld()->GetTimerManager().SetTimer(
+            AggregateTimerHandle, this, &URRROS2TFPublisher::SubmitTF, 1.f / static_cast<float>(PublicationFrequencyHz), true);
+    }
+}
+
+void URRROS2TFPublisher::StopTFPublishing()
 {
-    FROSTFMsg tf;
+    if (!bAggregate)
+    {
+        StopPublishTimer();
+    }
+    else
+    {
+        GetWorld()->GetTimerManager().ClearTimer(AggregateTimerHandle);
+    }
+}
+
+void URRROS2TFPublisher::SubmitTF()
+{
+    URRROS2TFAggregatePublisher* aggregatePublisher = URRROS2TFAggregatePublisher::Get(GetWorld(), IsStatic);
+    if (nullptr == aggregatePublisher)
+    {
+        // No aggregation in this world
+        UpdateMessage(TopicMessage);
+        Publish();
+        return;
+    }
 
     FROSTFStamped tfData;
+    if (IsStatic)
+    {
+        if (GetTFData(tfData))
+        {
+            aggregatePublisher->AddTransform(MoveTemp(tfData));
+        }
+    }
+    // Dynamic transforms are converted to ROS in one batch by the aggregate publisher
+    else if (GetUETFData(tfData))
+    {
+        aggregatePublisher->AddUETransform(MoveTemp(tfData));
+    }
+}
 
-    // time
-    tfData.Header.Stamp = URRConversionUtils::FloatToROSStamp(UGameplayStatics::GetTimeSeconds(GetWorld()));
-    tfData.Header.FrameId = FrameId;
-    tfData.ChildFrameId = ChildFrameId;
+bool URRROS2TFPublisher::GetTFData(FROSTFStamped& OutTFData)
+{
+    if (!GetUETFData(OutTFData))
+    {
+        return false;
+    }
+    OutTFData.Transform = URRConversionUtils::TransformUEToROS(OutTFData.Transform);
+    return true;
+}
 
-    tfData.Transform = URRConversionUtils::TransformUEToROS(TF);
+bool URRROS2TFPublisher::GetUETFData(FROSTFStamped& OutTFData)
+{
+    // time
+    OutTFData.Header.Stamp = URRConversionUtils::GetCurrentROS2Time(this);
+    OutTFData.Header.FrameId = FrameId;
+    OutTFData.ChildFrameId = ChildFrameId;
 
-    tf.Transforms.Emplace(MoveTemp(tfData));
+    OutTFData.Transform = TF;
+    return true;
+}
 
-    CastChecked<UROS2TFMsgMsg>(InMessage)->SetMsg(tf);
+void URRROS2TFPublisher::UpdateMessage(UROS2GenericMsg* InMessage)
+{
+    if (GetTFData(TFData))
+    {
+        FRRROS2MsgWriter::WriteTF(TFData, InMessage, WrittenFrameIds);
+        // Published right after, by the publish timer or #SubmitTF
+        if (FRRMcapRecorder::IsRecording())
+        {
+            FRRMcapRecorder::Get().Record(
+                RclPublisher, InMessage->GetTypeSupport(), InMessage->Get(), URRConversionUtils::GetSimTimeNanosec(this));
+        }
+    }
 }
@@ -0,0 +1,147 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRRobotBlueprintCommandlet.h"
+
+// UE
+#include "Components/StaticMeshComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRAssetUtils.h"
+#include "Core/RRCoreUtils.h"
+#include "Core/RRGameSingleton.h"
+#include "Core/RRSDFParser.h"
+#include "Core/RRURDFParser.h"
+#include "Robots/RRBaseRobot.h"
+
+URRRobotBlueprintCommandlet::URRRobotBlueprintCommandlet()
+{
+    IsClient = false;
+    IsEditor = true;
+    IsServer = false;
+    LogToConsole = true;
+
+    HelpDescription = TEXT("Bake a robot assembled from its URDF/SDF model into a blueprint asset");
+    HelpUsage = TEXT("-run=RRRobotBlueprint -Robot=<robot class path> [-Model=<URDF/SDF path>] [-Name=<BP name>]");
+    HelpParamNames = {TEXT("Robot"), TEXT("Model"), TEXT("Name")};
+    HelpParamDescriptions = {TEXT("ARRBaseRobot class or blueprint class path, ARRBaseRobot if empty"),
+                             TEXT("URDF/SDF file giving the robot model name"),
+                             TEXT("Output blueprint name, BP_<model name> if empty")};
+}
+
+int32 URRRobotBlueprintCommandlet::Main(const FString& InParams)
+{
+#if WITH_EDITOR
+    TArray<FString> tokens, switches;
+    TMap<FString, FString> params;
+    ParseCommandLine(*InParams, tokens, switches, params);
+
+    // Robot class
+    const FString robotClassPath = params.FindRef(TEXT("Robot"));
+    UClass* robotClass = ARRBaseRobot::StaticClass();
+    if (!robotClassPath.IsEmpty())
+    {
+        robotClass = LoadClass<ARRBaseRobot>(nullptr, *robotClassPath);
+        if (nullptr == robotClass)
+        {
+            robotClass = URRAssetUtils::FindBlueprintClass(robotClassPath);
+        }
+        if ((nullptr == robotClass) || !robotClass->IsChildOf(ARRBaseRobot::StaticClass()))
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("%s is not a robot class"), *robotClassPath);
+            return 1;
+        }
+    }
+
+    // Model name, from the parsed model
+    FString modelName;
+    const FString modelPath = params.FindRef(TEXT("Model"));
+    if (!modelPath.IsEmpty())
+    {
+        const FRRRobotModelInfo modelInfo = modelPath.EndsWith(TEXT(".sdf"), ESearchCase::IgnoreCase)
+                                                ? FRRSDFParser().LoadModelInfoFromFile(modelPath)
+                                                : FRRURDFParser().LoadModelInfoFromFile(modelPath);
+        modelName = modelInfo.Data.GetModelName();
+        if (modelName.IsEmpty())
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Failed parsing robot model %s"), *modelPath);
+            return 1;
+        }
+    }
+
+    FString bpName = params.FindRef(TEXT("Name"));
+    if (bpName.IsEmpty())
+    {
+        bpName = FString::Printf(TEXT("BP_%s"), modelName.IsEmpty() ? *robotClass->GetName() : *modelName);
+    }
+
+    // Transient world, with actors initialized for the robot to assemble itself in PreInitializeComponents()
+    UWorld* world = UWorld::CreateWorld(EWorldType::Game, false, TEXT("RRRobotBlueprintWorld"));
+    FWorldContext& worldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+    worldContext.SetCurrentWorld(world);
+    world->InitializeActorsForPlay(FURL());
+
+    ARRBaseRobot* robot = world->SpawnActorDeferred<ARRBaseRobot>(
+        robotClass, FTransform::Identity, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AlwaysSpawn);
+    int32 res = 1;
+    if (robot)
+    {
+        robot->RobotModelName = modelName;
+        robot->FinishSpawning(FTransform::Identity);
+
+        // Meshes created at runtime, eg imported from the model, are saved along with their cooked bodies, all in one batch
+        int32 savedMeshesNum = 0;
+        URRAssetUtils::BeginPackageSaveBatch();
+        TInlineComponentArray<UStaticMeshComponent*> meshComponents(robot);
+        for (UStaticMeshComponent* meshComp : meshComponents)
+        {
+            UStaticMesh* mesh = meshComp->GetStaticMesh();
+            if (mesh && (mesh->GetPackage() == GetTransientPackage()))
+            {
+                const FString meshAssetPath = FString::Printf(TEXT("%s/%s_%s"),
+                                                              *URRGameSingleton::Get()->ASSETS_RUNTIME_BP_SAVE_BASE_PATH,
+                                                              *bpName,
+                                                              *meshComp->GetName());
+                mesh->CreateBodySetup();
+                if (URRAssetUtils::SaveObjectToAsset(mesh, meshAssetPath, false, false, false, true))
+                {
+                    ++savedMeshesNum;
+                }
+            }
+        }
+        URRAssetUtils::EndPackageSaveBatch(FRROnPackagesSaved::CreateLambda(
+            [](int32 InSavedNum, const TArray<FString>& InFailedPackageNames)
+            {
+                UE_LOG_WITH_INFO(
+                    LogRapyutaCore, Display, TEXT("%d baked meshes saved, %d failed"), InSavedNum, InFailedPackageNames.Num());
+            }));
+        // The commandlet exits right after, thus not waiting for the completion callback
+        UPackage::WaitForAsyncFileWrites();
+
+        if (URRAssetUtils::CreateBlueprintFromActor(robot, bpName, true))
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore,
+                             Display,
+                             TEXT("Saved %s from %s with %d baked meshes"),
+                             *bpName,
+                             *robotClass->GetName(),
+                             savedMeshesNum);
+            res = 0;
+        }
+        robot->Destroy();
+    }
+    else
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Failed spawning %s"), *robotClass->GetName());
+    }
+
+    GEngine->DestroyWorldContext(world);
+    world->DestroyWorld(false);
+    return res;
+#else
+    UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Baking robot blueprints requires WITH_EDITOR"));
+    return 1;
+#endif
+}
@@ -0,0 +1,283 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRSimulationShardComponent.h"
+
+// UE
+#include "Components/PrimitiveComponent.h"
+#include "Misc/CommandLine.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRConversionUtils.h"
+#include "Core/RRTrace.h"
+#include "Robots/RRBaseRobot.h"
+#include "Tools/ROS2Spawnable.h"
+#include "Tools/RRWorldSnapshot.h"
+#include "Tools/SimulationState.h"
+
+int32 FRRShardLayout::GetShardId(const FVector& InLocation) const
+{
+    const int32 x = FMath::Clamp(FMath::FloorToInt32((InLocation.X - Origin.X) / RegionSize.X), 0, GridSize.X - 1);
+    const int32 y = FMath::Clamp(FMath::FloorToInt32((InLocation.Y - Origin.Y) / RegionSize.Y), 0, GridSize.Y - 1);
+    return y * GridSize.X + x;
+}
+
+void FRRShardLayout::GetBorderShardIds(const FVector& InLocation, const int32 InShardId, TArray<int32>& OutShardIds) const
+{
+    OutShardIds.Reset();
+    const int32 shardX = InShardId % GridSize.X;
+    const int32 shardY = InShardId / GridSize.X;
+    const FVector2D location(InLocation.X, InLocation.Y);
+    for (int32 y = FMath::Max(shardY - 1, 0); y <= FMath::Min(shardY + 1, GridSize.Y - 1); ++y)
+    {
+        for (int32 x = FMath::Max(shardX - 1, 0); x <= FMath::Min(shardX + 1, GridSize.X - 1); ++x)
+        {
+            if ((x == shardX) && (y == shardY))
+            {
+                continue;
+            }
+            const FVector2D regionMin = Origin + FVector2D(x, y) * RegionSize;
+            const FBox2D region(regionMin, regionMin + RegionSize);
+            if (region.ComputeSquaredDistanceToPoint(location) <= FMath::Square(BorderMargin))
+            {
+                OutShardIds.Add(y * GridSize.X + x);
+            }
+        }
+    }
+}
+
+URRSimulationShardComponent::URRSimulationShardComponent()
+{
+    PrimaryComponentTick.bCanEverTick = true;
+    // Regions are large compared to the distance entities travel per frame
+    PrimaryComponentTick.TickInterval = 0.1f;
+}
+
+void URRSimulationShardComponent::BeginPlay()
+{
+    Super::BeginPlay();
+    SimState = Cast<ASimulationState>(GetOwner());
+    if (nullptr == SimState)
+    {
+        UE_LOG_WITH_INFO_NAMED(LogRapyutaCore, Error, TEXT("Owner is not a ASimulationState, sharding disabled"));
+        SetComponentTickEnabled(false);
+        return;
+    }
+
+    FParse::Value(FCommandLine::Get(), TEXT("RRShardId="), ShardId);
+    if (IsEnabled())
+    {
+        UE_LOG_WITH_INFO_NAMED(LogRapyutaCore, Log, TEXT("Simulating shard %d of %d"), ShardId, Layout.Num());
+    }
+}
+
+bool URRSimulationShardComponent::CaptureHandoffData(AActor* InEntity,
+                                                     const FString& InEntityName,
+                                                     TArray<uint8>& OutHandoffData) const
+{
+    UROS2Spawnable* spawnable = InEntity->FindComponentByClass<UROS2Spawnable>();
+    if (nullptr == spawnable)
+    {
+        return false;
+    }
+
+    FRRWorldSnapshot snapshot;
+    FRRWorldSnapshot::CaptureEntity(InEntity, InEntityName, snapshot.Entities.AddDefaulted_GetRef());
+    TArray<uint8> snapshotData;
+    snapshot.Save(snapshotData);
+
+    OutHandoffData.Reset();
+    FMemoryWriter writer(OutHandoffData, true);
+    uint32 version = HANDOFF_VERSION;
+    writer << version << spawnable->ActorModelName << spawnable->ActorNamespace << spawnable->ActorTags
+           << spawnable->ActorJsonConfigs << snapshotData;
+    return true;
+}
+
+void URRSimulationShardComponent::TickComponent(float InDeltaTime,
+                                                ELevelTick InTickType,
+                                                FActorComponentTickFunction* ThisTickFunction)
+{
+    Super::TickComponent(InDeltaTime, InTickType, ThisTickFunction);
+    if (!IsEnabled() || (nullptr == SimState) || !SimState->HasAuthority())
+    {
+        return;
+    }
+
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRShardUpdate", RRSimStateChannel);
+    // Signalled after iterating, since listeners may release entities from #ASimulationState::Entities
+    TArray<TPair<FString, int32>> migratingEntities;
+    TArray<int32> borderShardIds;
+    for (const auto& entityIt : SimState->Entities)
+    {
+        AActor* entity = entityIt.Value;
+        const FString& entityName = entityIt.Key;
+        if (!IsValid(entity) || IsProxy(entity) || MigratingEntityNames.Contains(entityName) ||
+            ((ShardedEntityTag != NAME_None) && !entity->ActorHasTag(ShardedEntityTag)))
+        {
+            continue;
+        }
+        UROS2Spawnable* spawnable = entity->FindComponentByClass<UROS2Spawnable>();
+        if (nullptr == spawnable)
+        {
+            continue;
+        }
+
+        const FTransform& transform = entity->GetActorTransform();
+        const int32 targetShardId = Layout.GetShardId(transform.GetLocation());
+        if (targetShardId != ShardId)
+        {
+            migratingEntities.Emplace(entityName, targetShardId);
+            continue;
+        }
+
+        Layout.GetBorderShardIds(transform.GetLocation(), ShardId, borderShardIds);
+        if (borderShardIds.Num() > 0)
+        {
+            BorderEntityNames.Add(entityName);
+            OnProxyUpdate.Broadcast(entityName, spawnable->ActorModelName, borderShardIds, transform);
+        }
+        else if (BorderEntityNames.Remove(entityName) > 0)
+        {
+            OnProxyUpdate.Broadcast(entityName, spawnable->ActorModelName, borderShardIds, transform);
+        }
+    }
+
+    TArray<uint8> handoffData;
+    for (const auto& migratingEntity : migratingEntities)
+    {
+        AActor* entity = SimState->FindEntity(migratingEntity.Key);
+        if (entity && CaptureHandoffData(entity, migratingEntity.Key, handoffData))
+        {
+            UE_LOG_WITH_INFO_NAMED(LogRapyutaCore,
+                                   Log,
+                                   TEXT("[%s] migrating from shard %d to %d"),
+                                   *migratingEntity.Key,
+                                   ShardId,
+                                   migratingEntity.Value);
+            MigratingEntityNames.Add(migratingEntity.Key);
+            BorderEntityNames.Remove(migratingEntity.Key);
+            OnEntityMigrating.Broadcast(migratingEntity.Key, migratingEntity.Value, handoffData);
+        }
+    }
+}
+
+AActor* URRSimulationShardComponent::ImportMigratedEntity(const TArray<uint8>& InHandoffData)
+{
+    if (nullptr == SimState)
+    {
+        return nullptr;
+    }
+
+    FMemoryReader reader(InHandoffData, true);
+    uint32 version = 0;
+    reader << version;
+    if (HANDOFF_VERSION != version)
+    {
+        UE_LOG_WITH_INFO_NAMED(LogRapyutaCore, Error, TEXT("Unsupported handoff data version %u"), version);
+        return nullptr;
+    }
+
+    FROSSpawnEntityReq request;
+    TArray<uint8> snapshotData;
+    reader << request.Xml << request.RobotNamespace << request.Tags << request.JsonParameters << snapshotData;
+    FRRWorldSnapshot snapshot;
+    if (reader.IsError() || !snapshot.Load(snapshotData) || (snapshot.Entities.Num() != 1))
+    {
+        UE_LOG_WITH_INFO_NAMED(LogRapyutaCore, Error, TEXT("Invalid handoff data"));
+        return nullptr;
+    }
+    const FRRWorldSnapshot::FEntityState& state = snapshot.Entities[0];
+
+    // The proxy is replaced by the entity itself
+    if (AActor* existingEntity = SimState->FindEntity(state.Name))
+    {
+        if (false == IsProxy(existingEntity))
+        {
+            UE_LOG_WITH_INFO_NAMED(LogRapyutaCore, Error, TEXT("[%s] is already simulated by this shard"), *state.Name);
+            return nullptr;
+        }
+        SimState->ServerRemoveEntity(existingEntity);
+    }
+
+    // Spawned at its latest pose, in world frame
+    const FTransform rosTransform = URRConversionUtils::TransformUEToROS(state.Transform);
+    request.State.Name = state.Name;
+    request.State.Pose.Position = rosTransform.GetLocation();
+    request.State.Pose.Orientation = rosTransform.GetRotation();
+    AActor* entity = SimState->ServerSpawnCheckedEntity(request, 0);
+    if (entity)
+    {
+        FRRWorldSnapshot::RestoreEntity(entity, state);
+        UE_LOG_WITH_INFO_NAMED(LogRapyutaCore, Log, TEXT("[%s] migrated into shard %d"), *state.Name, ShardId);
+    }
+    return entity;
+}
+
+void URRSimulationShardComponent::ReleaseMigratedEntity(const FString& InEntityName)
+{
+    MigratingEntityNames.Remove(InEntityName);
+    if (SimState)
+    {
+        SimState->ServerRemoveEntity(SimState->FindEntity(InEntityName));
+    }
+}
+
+void URRSimulationShardComponent::UpdateProxy(const FString& InEntityName,
+                                              const FString& InEntityModelName,
+                                              const FTransform& InTransform)
+{
+    if (nullptr == SimState)
+    {
+        return;
+    }
+
+    AActor* proxy = SimState->FindEntity(InEntityName);
+    if (proxy)
+    {
+        // Not overriding an entity owned by this shard, eg upon a late update after its migration
+        if (IsProxy(proxy))
+        {
+            proxy->SetActorTransform(InTransform, false, nullptr, ETeleportType::TeleportPhysics);
+        }
+        return;
+    }
+
+    FROSSpawnEntityReq request;
+    const FTransform rosTransform = URRConversionUtils::TransformUEToROS(InTransform);
+    request.Xml = InEntityModelName;
+    request.State.Name = InEntityName;
+    request.State.Pose.Position = rosTransform.GetLocation();
+    request.State.Pose.Orientation = rosTransform.GetRotation();
+    request.Tags.Add(PROXY_TAG);
+    proxy = SimState->ServerSpawnCheckedEntity(request, 0);
+    if (nullptr == proxy)
+    {
+        return;
+    }
+
+    // Kinematic & silent: driven by the owner shard, whose entity publishes on ROS 2
+    if (ARRBaseRobot* robot = Cast<ARRBaseRobot>(proxy))
+    {
+        robot->DeInitROS2Interface();
+    }
+    proxy->SetActorTickEnabled(false);
+    proxy->SetActorEnableCollision(false);
+    for (UActorComponent* component : proxy->GetComponents())
+    {
+        if (UPrimitiveComponent* primitiveComp = Cast<UPrimitiveComponent>(component))
+        {
+            primitiveComp->SetSimulatePhysics(false);
+        }
+    }
+}
+
+void URRSimulationShardComponent::RemoveProxy(const FString& InEntityName)
+{
+    AActor* proxy = SimState ? SimState->FindEntity(InEntityName) : nullptr;
+    if (IsProxy(proxy))
+    {
+        SimState->ServerRemoveEntity(proxy);
+    }
+}
@@ -0,0 +1,128 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRStartupProfiler.h"
+
+// UE
+#include "HAL/IConsoleManager.h"
+
+// RapyutaSimulationPlugins
+#include "RapyutaSimulationPlugins.h"
+
+static void StartupProfileCommand(const TArray<FString>& InArgs)
+{
+    FRRStartupProfiler& profiler = FRRStartupProfiler::Get();
+    if ((InArgs.Num() > 0) && InArgs[0].Equals(TEXT("reset"), ESearchCase::IgnoreCase))
+    {
+        profiler.Reset();
+    }
+    else
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Display, TEXT("%s"), *profiler.ToString());
+    }
+}
+
+static FAutoConsoleCommandWithArgs GStartupProfileCommand(
+    TEXT("rr.StartupProfile"),
+    TEXT("Log the time spent per startup & spawn phase, or reset it with 'rr.StartupProfile reset'."),
+    FConsoleCommandWithArgsDelegate::CreateStatic(&StartupProfileCommand));
+
+FRRStartupProfiler& FRRStartupProfiler::Get()
+{
+    static FRRStartupProfiler sProfiler;
+    return sProfiler;
+}
+
+FRRStartupProfiler::FRRStartupProfiler()
+{
+    Reset();
+}
+
+const TCHAR* FRRStartupProfiler::GetPhaseName(const ERRStartupPhase InPhase)
+{
+    switch (InPhase)
+    {
+        case ERRStartupPhase::RESOURCES_LOADING:
+            return TEXT("resources_loading");
+        case ERRStartupPhase::ROBOT_DESCRIPTION_PARSING:
+            return TEXT("robot_description_parsing");
+        case ERRStartupPhase::MESH_IMPORT:
+            return TEXT("mesh_import");
+        case ERRStartupPhase::COLLISION_COOKING:
+            return TEXT("collision_cooking");
+        case ERRStartupPhase::ACTOR_SPAWN:
+            return TEXT("actor_spawn");
+        case ERRStartupPhase::ROS2_INTERFACE_INIT:
+            return TEXT("ros2_interface_init");
+        default:
+            return TEXT("unknown");
+    }
+}
+
+void FRRStartupProfiler::AddTime(const ERRStartupPhase InPhase, const double InSeconds)
+{
+    const uint8 phase = static_cast<uint8>(InPhase);
+    const int64 nanosec = static_cast<int64>(FMath::Max(InSeconds, 0.) * 1e9);
+    ++Counts[phase];
+    TotalNanosec[phase] += nanosec;
+    int64 maxNanosec = MaxNanosec[phase];
+    while ((nanosec > maxNanosec) && !MaxNanosec[phase].compare_exchange_weak(maxNanosec, nanosec))
+    {
+    }
+}
+
+void FRRStartupProfiler::BeginPhase(const ERRStartupPhase InPhase)
+{
+    check(IsInGameThread());
+    PhaseStartTimes[static_cast<uint8>(InPhase)] = FPlatformTime::Seconds();
+}
+
+void FRRStartupProfiler::EndPhase(const ERRStartupPhase InPhase)
+{
+    check(IsInGameThread());
+    double& startTime = PhaseStartTimes[static_cast<uint8>(InPhase)];
+    if (startTime > 0.)
+    {
+        AddTime(InPhase, FPlatformTime::Seconds() - startTime);
+        startTime = 0.;
+    }
+}
+
+TArray<FRRStartupPhaseStats> FRRStartupProfiler::GetStats() const
+{
+    TArray<FRRStartupPhaseStats> stats;
+    stats.Reserve(static_cast<uint8>(ERRStartupPhase::NUM));
+    for (uint8 i = 0; i < static_cast<uint8>(ERRStartupPhase::NUM); ++i)
+    {
+        FRRStartupPhaseStats& phaseStats = stats.AddDefaulted_GetRef();
+        phaseStats.Name = GetPhaseName(static_cast<ERRStartupPhase>(i));
+        phaseStats.Count = Counts[i];
+        phaseStats.TotalMs = 1e-6 * TotalNanosec[i];
+        phaseStats.MaxMs = 1e-6 * MaxNanosec[i];
+    }
+    return stats;
+}
+
+FString FRRStartupProfiler::ToString() const
+{
+    FString result = TEXT("Startup profile [ms] (count / total / mean / max):");
+    for (const FRRStartupPhaseStats& stats : GetStats())
+    {
+        result += FString::Printf(TEXT("\n  %-28s %6lld / %10.3f / %8.3f / %8.3f"),
+                                  *stats.Name,
+                                  stats.Count,
+                                  stats.TotalMs,
+                                  (stats.Count > 0) ? (stats.TotalMs / stats.Count) : 0.,
+                                  stats.MaxMs);
+    }
+    return result;
+}
+
+void FRRStartupProfiler::Reset()
+{
+    for (uint8 i = 0; i < static_cast<uint8>(ERRStartupPhase::NUM); ++i)
+    {
+        Counts[i] = 0;
+        TotalNanosec[i] = 0;
+        MaxNanosec[i] = 0;
+    }
+}
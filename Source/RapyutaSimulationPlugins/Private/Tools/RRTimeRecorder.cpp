@@ -0,0 +1,182 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRTimeRecorder.h"
+
+// Native
+#include <cstdio>
+
+// UE
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/RunnableThread.h"
+
+// RapyutaSimulationPlugins
+#include "RapyutaSimulationPlugins.h"
+
+FRRTimeRecorder::~FRRTimeRecorder()
+{
+    Finish();
+}
+
+bool FRRTimeRecorder::Start(const FString& InFilePath, const bool bInCsv, const uint32 InCapacity)
+{
+    check(IsInGameThread());
+    Finish();
+
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(InFilePath), true);
+    FileHandle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenWrite(*InFilePath));
+    if (!FileHandle.IsValid())
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Failed to open time log [%s]"), *InFilePath);
+        return false;
+    }
+
+    bCsv = bInCsv;
+    if (bCsv)
+    {
+        static const ANSICHAR CSV_HEADER[] = "sim_ns,wall_ns,frame_cost_us,rolling_rtf\n";
+        FileHandle->Write(reinterpret_cast<const uint8*>(CSV_HEADER), sizeof(CSV_HEADER) - 1);
+    }
+    else
+    {
+        const uint32 version = VERSION;
+        const uint32 recordSize = sizeof(FRRTimeRecord);
+        const int64 startUnixTime = FDateTime::UtcNow().ToUnixTimestamp();
+        FileHandle->Write(reinterpret_cast<const uint8*>("RRTL"), 4);
+        FileHandle->Write(reinterpret_cast<const uint8*>(&version), sizeof(version));
+        FileHandle->Write(reinterpret_cast<const uint8*>(&recordSize), sizeof(recordSize));
+        FileHandle->Write(reinterpret_cast<const uint8*>(&startUnixTime), sizeof(startUnixTime));
+    }
+
+    // One slot of TCircularQueue is always kept empty
+    const uint32 capacity = FMath::RoundUpToPowerOfTwo(FMath::Max(InCapacity, 1u) + 1);
+    Records = MakeUnique<TCircularQueue<FRRTimeRecord>>(capacity);
+    WriteBuffer.Reset(capacity * (bCsv ? 64 : sizeof(FRRTimeRecord)));
+    RecordsNum = 0;
+    DroppedRecordsNum = 0;
+    RTF = 0.;
+    RollingRTF = 0.;
+
+    bStopping = false;
+    WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+    Thread = FRunnableThread::Create(this, TEXT("RRTimeRecorder"), 0, TPri_BelowNormal);
+    UE_LOG_WITH_INFO(LogRapyutaCore, Display, TEXT("Recording times to [%s]"), *InFilePath);
+    return true;
+}
+
+void FRRTimeRecorder::Finish()
+{
+    if (nullptr == Thread)
+    {
+        return;
+    }
+    Stop();
+    Thread->WaitForCompletion();
+    delete Thread;
+    Thread = nullptr;
+    FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+    WakeEvent = nullptr;
+
+    FileHandle->Flush();
+    FileHandle.Reset();
+    Records.Reset();
+    UE_LOG_WITH_INFO(LogRapyutaCore,
+                     Display,
+                     TEXT("Recorded %lld frames (%lld dropped), RTF %.3f"),
+                     RecordsNum,
+                     DroppedRecordsNum.load(),
+                     RTF);
+}
+
+void FRRTimeRecorder::Record(const double InSimTime, const double InFrameCostSec)
+{
+    if (!Records.IsValid())
+    {
+        return;
+    }
+
+    const uint64 wallCycles = FPlatformTime::Cycles64();
+    if (0 == RecordsNum)
+    {
+        StartSimTime = InSimTime;
+        StartWallCycles = wallCycles;
+    }
+    FRRTimeRecord record;
+    record.SimTimeNs = static_cast<int64>((InSimTime - StartSimTime) * 1e9);
+    record.WallTimeNs = static_cast<int64>(FPlatformTime::ToSeconds64(wallCycles - StartWallCycles) * 1e9);
+    record.FrameCostUs = static_cast<uint32>(FMath::Max(InFrameCostSec, 0.) * 1e6);
+
+    if (record.WallTimeNs > 0)
+    {
+        RTF = static_cast<double>(record.SimTimeNs) / record.WallTimeNs;
+    }
+    // Slot of the record RTF_WINDOW_SIZE frames earlier, or of the first one if not as many yet
+    FRRTimeRecord& windowSlot = RTFWindow[RecordsNum % RTF_WINDOW_SIZE];
+    const FRRTimeRecord& windowStart = (RecordsNum >= RTF_WINDOW_SIZE) ? windowSlot : RTFWindow[0];
+    const int64 windowWallTimeNs = record.WallTimeNs - windowStart.WallTimeNs;
+    if ((RecordsNum > 0) && (windowWallTimeNs > 0))
+    {
+        RollingRTF = static_cast<double>(record.SimTimeNs - windowStart.SimTimeNs) / windowWallTimeNs;
+    }
+    record.RTFMicro = static_cast<uint32>(FMath::Clamp(RollingRTF * 1e6, 0., static_cast<double>(MAX_uint32)));
+    windowSlot = record;
+    ++RecordsNum;
+
+    if (!Records->Enqueue(record))
+    {
+        ++DroppedRecordsNum;
+    }
+}
+
+void FRRTimeRecorder::Stop()
+{
+    bStopping = true;
+    if (WakeEvent)
+    {
+        WakeEvent->Trigger();
+    }
+}
+
+uint32 FRRTimeRecorder::Run()
+{
+    // Woken up periodically only, the records being written in batches
+    static constexpr uint32 WAIT_MS = 100;
+    while (!bStopping)
+    {
+        WakeEvent->Wait(WAIT_MS);
+        WritePendingRecords();
+    }
+    WritePendingRecords();
+    return 0;
+}
+
+void FRRTimeRecorder::WritePendingRecords()
+{
+    WriteBuffer.Reset();
+    FRRTimeRecord record;
+    while (Records->Dequeue(record))
+    {
+        if (bCsv)
+        {
+            ANSICHAR line[96];
+            const int32 lineLength = FMath::Clamp(snprintf(line,
+                                                           sizeof(line),
+                                                           "%lld,%lld,%u,%.6f\n",
+                                                           static_cast<long long>(record.SimTimeNs),
+                                                           static_cast<long long>(record.WallTimeNs),
+                                                           record.FrameCostUs,
+                                                           record.RTFMicro * 1e-6),
+                                                  0,
+                                                  static_cast<int32>(sizeof(line)) - 1);
+            WriteBuffer.Append(reinterpret_cast<const uint8*>(line), lineLength);
+        }
+        else
+        {
+            WriteBuffer.Append(reinterpret_cast<const uint8*>(&record), sizeof(record));
+        }
+    }
+    if (WriteBuffer.Num() > 0)
+    {
+        FileHandle->Write(WriteBuffer.GetData(), WriteBuffer.Num());
+    }
+}
@@ -0,0 +1,236 @@
+// Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+
+#include "Tools/RRWorldSnapshot.h"
+
+// UE
+#include "Components/PrimitiveComponent.h"
+#include "GameFramework/Actor.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/ObjectAndNameAsStringProxyArchive.h"
+#include "UObject/UnrealType.h"
+
+// RapyutaSimulationPlugins
+#include "Drives/RRJointComponent.h"
+
+//! Whether a loaded element count fits in the remaining data, guarding against corrupted blobs
+static bool IsValidCount(FArchive& InAr, const int32 InCount)
+{
+    if (InAr.IsLoading() && ((InCount < 0) || (InCount > InAr.TotalSize() - InAr.Tell())))
+    {
+        InAr.SetError();
+    }
+    return !InAr.IsError();
+}
+
+static void SerializeEntityState(FArchive& InAr, FRRWorldSnapshot::FEntityState& InOutState)
+{
+    InAr << InOutState.Name << InOutState.Transform << InOutState.AttachParentName << InOutState.bWelded;
+
+    int32 bodiesNum = InOutState.Bodies.Num();
+    InAr << bodiesNum;
+    if (!IsValidCount(InAr, bodiesNum))
+    {
+        return;
+    }
+    InOutState.Bodies.SetNum(bodiesNum);
+    for (auto& body : InOutState.Bodies)
+    {
+        InAr << body.ComponentName << body.Transform << body.LinearVelocity << body.AngularVelocity;
+    }
+
+    int32 jointsNum = InOutState.Joints.Num();
+    InAr << jointsNum;
+    if (!IsValidCount(InAr, jointsNum))
+    {
+        return;
+    }
+    InOutState.Joints.SetNum(jointsNum);
+    for (auto& joint : InOutState.Joints)
+    {
+        InAr << joint.ComponentName << joint.Position << joint.Orientation << joint.PositionTarget << joint.OrientationTarget
+             << joint.LinearVelocityTarget << joint.AngularVelocityTarget;
+    }
+
+    InAr << InOutState.ActorSaveGameData << InOutState.ComponentSaveGameData;
+}
+
+bool FRRWorldSnapshot::HasSaveGameProperties(const UClass* InClass)
+{
+    // Per class, since most of them have none
+    static TMap<const UClass*, bool> sHasSaveGameProperties;
+    if (const bool* bHas = sHasSaveGameProperties.Find(InClass))
+    {
+        return *bHas;
+    }
+    bool bHas = false;
+    for (TFieldIterator<FProperty> propIt(InClass); propIt; ++propIt)
+    {
+        if (propIt->HasAnyPropertyFlags(CPF_SaveGame))
+        {
+            bHas = true;
+            break;
+        }
+    }
+    sHasSaveGameProperties.Add(InClass, bHas);
+    return bHas;
+}
+
+void FRRWorldSnapshot::SaveGameProperties(UObject* InObject, TArray<uint8>& OutData)
+{
+    FMemoryWriter writer(OutData, true);
+    FObjectAndNameAsStringProxyArchive ar(writer, false);
+    ar.ArIsSaveGame = true;
+    InObject->Serialize(ar);
+}
+
+void FRRWorldSnapshot::LoadGameProperties(UObject* InObject, const TArray<uint8>& InData)
+{
+    FMemoryReader reader(InData, true);
+    FObjectAndNameAsStringProxyArchive ar(reader, true);
+    ar.ArIsSaveGame = true;
+    InObject->Serialize(ar);
+}
+
+void FRRWorldSnapshot::CaptureEntity(AActor* InEntity, const FString& InName, FEntityState& OutState)
+{
+    OutState.Name = InName;
+    OutState.Transform = InEntity->GetActorTransform();
+    OutState.Bodies.Reset();
+    OutState.Joints.Reset();
+    OutState.ActorSaveGameData.Reset();
+    OutState.ComponentSaveGameData.Reset();
+
+    for (UActorComponent* component : InEntity->GetComponents())
+    {
+        if (UPrimitiveComponent* primitiveComp = Cast<UPrimitiveComponent>(component))
+        {
+            if (primitiveComp->IsSimulatingPhysics())
+            {
+                FBodyState& body = OutState.Bodies.AddDefaulted_GetRef();
+                body.ComponentName = primitiveComp->GetFName();
+                body.Transform = primitiveComp->GetComponentTransform();
+                body.LinearVelocity = primitiveComp->GetPhysicsLinearVelocity();
+                body.AngularVelocity = primitiveComp->GetPhysicsAngularVelocityInDegrees();
+            }
+        }
+        else if (URRJointComponent* jointComp = Cast<URRJointComponent>(component))
+        {
+            FJointState& joint = OutState.Joints.AddDefaulted_GetRef();
+            joint.ComponentName = jointComp->GetFName();
+            joint.Position = jointComp->Position;
+            joint.Orientation = jointComp->Orientation;
+            joint.PositionTarget = jointComp->PositionTarget;
+            joint.OrientationTarget = jointComp->OrientationTarget;
+            joint.LinearVelocityTarget = jointComp->LinearVelocityTarget;
+            joint.AngularVelocityTarget = jointComp->AngularVelocityTarget;
+        }
+
+        if (component && HasSaveGameProperties(component->GetClass()))
+        {
+            SaveGameProperties(component, OutState.ComponentSaveGameData.Add(component->GetFName()));
+        }
+    }
+
+    if (HasSaveGameProperties(InEntity->GetClass()))
+    {
+        SaveGameProperties(InEntity, OutState.ActorSaveGameData);
+    }
+}
+
+void FRRWorldSnapshot::RestoreEntity(AActor* InEntity, const FEntityState& InState)
+{
+    InEntity->SetActorTransform(InState.Transform, false, nullptr, ETeleportType::TeleportPhysics);
+
+    TMap<FName, UActorComponent*> components;
+    for (UActorComponent* component : InEntity->GetComponents())
+    {
+        if (component)
+        {
+            components.Add(component->GetFName(), component);
+        }
+    }
+
+    for (const auto& body : InState.Bodies)
+    {
+        UActorComponent* const* component = components.Find(body.ComponentName);
+        if (UPrimitiveComponent* primitiveComp = component ? Cast<UPrimitiveComponent>(*component) : nullptr)
+        {
+            primitiveComp->SetWorldTransform(body.Transform, false, nullptr, ETeleportType::TeleportPhysics);
+            primitiveComp->SetPhysicsLinearVelocity(body.LinearVelocity);
+            primitiveComp->SetPhysicsAngularVelocityInDegrees(body.AngularVelocity);
+        }
+    }
+
+    for (const auto& joint : InState.Joints)
+    {
+        UActorComponent* const* component = components.Find(joint.ComponentName);
+        if (URRJointComponent* jointComp = component ? Cast<URRJointComponent>(*component) : nullptr)
+        {
+            jointComp->SetPose(joint.Position, joint.Orientation);
+            // Targets last, since setting them also sets the velocities of some joint types
+            if (ERRJointControlType::POSITION == jointComp->ControlType)
+            {
+                jointComp->SetPoseTarget(joint.PositionTarget, joint.OrientationTarget);
+            }
+            else
+            {
+                jointComp->SetVelocityTarget(joint.LinearVelocityTarget, joint.AngularVelocityTarget);
+            }
+        }
+    }
+
+    for (const auto& componentData : InState.ComponentSaveGameData)
+    {
+        if (UActorComponent* const* component = components.Find(componentData.Key))
+        {
+            LoadGameProperties(*component, componentData.Value);
+        }
+    }
+    if (InState.ActorSaveGameData.Num() > 0)
+    {
+        LoadGameProperties(InEntity, InState.ActorSaveGameData);
+    }
+}
+
+void FRRWorldSnapshot::Save(TArray<uint8>& OutData) const
+{
+    OutData.Reset();
+    FMemoryWriter writer(OutData, true);
+    uint32 version = VERSION;
+    int32 entitiesNum = Entities.Num();
+    writer << version << entitiesNum;
+    for (const auto& entity : Entities)
+    {
+        SerializeEntityState(writer, const_cast<FEntityState&>(entity));
+    }
+}
+
+bool FRRWorldSnapshot::Load(const TArray<uint8>& InData)
+{
+    Entities.Reset();
+    FMemoryReader reader(InData, true);
+    uint32 version = 0;
+    int32 entitiesNum = 0;
+    reader << version << entitiesNum;
+    if ((VERSION != version) || !IsValidCount(reader, entitiesNum))
+    {
+        return false;
+    }
+
+    Entities.SetNum(entitiesNum);
+    for (auto& entity : Entities)
+    {
+        SerializeEntityState(reader, entity);
+        if (reader.IsError())
+        {
+            break;
+        }
+    }
+    if (reader.IsError())
+    {
+        Entities.Reset();
+        return false;
+    }
+    return true;
+}
@@ -3,10 +3,13 @@
 #include "Tools/SimulationState.h"
 
 // UE
+#include "Algo/BinarySearch.h"
+#include "Algo/Count.h"
+#include "Engine/Level.h"
 #include "Engine/World.h"
 #include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
 #include "Kismet/GameplayStatics.h"
-#include "TimerManager.h"
 
 // rclUE
 #include "Srvs/ROS2Attach.h"
@@ -20,22 +23,115 @@
 #include "Core/RRActorCommon.h"
 #include "Core/RRAssetUtils.h"
 #include "Core/RRConversionUtils.h"
+#include "Core/RRTrace.h"
 #include "Core/RRUObjectUtils.h"
 #include "Net/UnrealNetwork.h"
 #include "Robots/RRBaseRobot.h"
 #include "Tools/ROS2Spawnable.h"
+#include "Tools/RRStartupProfiler.h"
+#include "Tools/RRWorldSnapshot.h"
+
+static TAutoConsoleVariable<int32> CVarMaxSpawnsPerFrame(
+    TEXT("rr.SimulationState.MaxSpawnsPerFrame"),
+    4,
+    TEXT("Max number of queued spawn requests spawned by ASimulationState per frame, all of them being spawned if <= 0."),
+    ECVF_Default);
+
+void FRREntityRegistryItem::PostReplicatedAdd(const FRREntityRegistry& InArraySerializer)
+{
+    if (InArraySerializer.Owner)
+    {
+        InArraySerializer.Owner->OnEntityRegistered(*this);
+    }
+}
+
+void FRREntityRegistryItem::PostReplicatedChange(const FRREntityRegistry& InArraySerializer)
+{
+    // Mostly upon [Actor] being resolved, after it has been replicated
+    if (InArraySerializer.Owner)
+    {
+        InArraySerializer.Owner->OnEntityRegistered(*this);
+    }
+}
+
+void FRREntityRegistryItem::PreReplicatedRemove(const FRREntityRegistry& InArraySerializer)
+{
+    if (InArraySerializer.Owner)
+    {
+        InArraySerializer.Owner->OnEntityUnregistered(*this);
+    }
+}
+
+uint32 FRREntityRegistry::AddEntity(AActor* InEntity, const FString& InName)
+{
+    FRREntityRegistryItem& item = Items.AddDefaulted_GetRef();
+    item.Actor = InEntity;
+    item.Name = InName;
+    item.EntityId = NextEntityId++;
+    MarkItemDirty(item);
+    return item.EntityId;
+}
+
+bool FRREntityRegistry::RemoveEntity(const AActor* InEntity)
+{
+    const int32 itemIdx = Items.IndexOfByPredicate([InEntity](const FRREntityRegistryItem& InItem)
+                                                   { return InItem.Actor == InEntity; });
+    if (INDEX_NONE == itemIdx)
+    {
+        return false;
+    }
+    // Items order is not replicated
+    Items.RemoveAtSwap(itemIdx);
+    MarkArrayDirty();
+    return true;
+}
+
+uint32 FRREntityRegistry::GetEntityId(const AActor* InEntity) const
+{
+    const FRREntityRegistryItem* item =
+        Items.FindByPredicate([InEntity](const FRREntityRegistryItem& InItem) { return InItem.Actor == InEntity; });
+    return item ? item->EntityId : 0;
+}
+
+static TAutoConsoleVariable<float> CVarSpatialHashCellSize(
+    TEXT("rr.SimulationState.SpatialHashCellSize"),
+    1000.f,
+    TEXT("[cm] Cell size of the spatial hash of ASimulationState's entities, used by its radius, box & nearest queries."),
+    ECVF_Default);
+
+static TAutoConsoleVariable<bool> CVarDeferSetEntityState(
+    TEXT("rr.SimulationState.DeferSetEntityState"),
+    true,
+    TEXT("Whether entity states set by ASimulationState are buffered & applied all together before the physics step."),
+    ECVF_Default);
 
 ASimulationState::ASimulationState()
 {
     bReplicates = true;
     PrimaryActorTick.bCanEverTick = true;
+    // Buffered entity states are applied before the physics step
+    PrimaryActorTick.TickGroup = TG_PrePhysics;
     bAlwaysRelevant = true;
+    EntityRegistry.Owner = this;
+}
+
+void ASimulationState::Tick(float InDeltaTime)
+{
+    Super::Tick(InDeltaTime);
+    if (PendingEntityStates.Num() > 0)
+    {
+        ServerApplyPendingEntityStates();
+    }
+    if ((PendingSpawnRequests.Num() > 0) && HasAuthority())
+    {
+        ServerSpawnPendingEntities(CVarMaxSpawnsPerFrame.GetValueOnGameThread());
+    }
 }
 
 void ASimulationState::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-    DOREPLIFETIME(ASimulationState, EntityList);
+    DOREPLIFETIME(ASimulationState, EntityRegistry);
     DOREPLIFETIME(ASimulationState, SpawnableEntityInfoList);
 }
 
@@ -75,9 +171,82 @@ void ASimulationState::InitEntities()
         ServerAddEntity(actor);
     }
 
+    if (bTrackStreamedLevels && HasAuthority() && !LevelAddedToWorldHandle.IsValid())
+    {
+        LevelAddedToWorldHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &ASimulationState::OnLevelAddedToWorld);
+        LevelRemovedFromWorldHandle =
+            FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &ASimulationState::OnLevelRemovedFromWorld);
+    }
+
     // NOTE: [SpawnableEntityInfoList] is a TArray<> thus replicatable, which is not supported for [SpawnableEntities] as a TMap
-    GetWorld()->GetTimerManager().SetTimer(
-        FetchEntityListTimerHandle, this, &ASimulationState::GetSpawnableEntityInfoList, 1.0f, true);
+    // It is kept in sync by [AddSpawnableEntityTypes()], only types set beforehand in [SpawnableEntityTypes] are synced here
+    GetSpawnableEntityInfoList();
+}
+
+void ASimulationState::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedToWorldHandle);
+    FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedFromWorldHandle);
+    LevelAddedToWorldHandle.Reset();
+    LevelRemovedFromWorldHandle.Reset();
+    Super::EndPlay(EndPlayReason);
+}
+
+void ASimulationState::OnLevelAddedToWorld(ULevel* InLevel, UWorld* InWorld)
+{
+    if ((InWorld != GetWorld()) || (nullptr == InLevel))
+    {
+        return;
+    }
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRSimStateLevelAdded", RRSimStateChannel);
+    TArray<AActor*> newEntities;
+    newEntities.Reserve(InLevel->Actors.Num());
+    for (AActor* actor : InLevel->Actors)
+    {
+        if (IsValid(actor) && (Entities.FindRef(actor->GetName()) != actor))
+        {
+            newEntities.Add(actor);
+        }
+    }
+    if (newEntities.Num() > 0)
+    {
+        ServerAddEntities(newEntities);
+        UE_LOG_WITH_INFO(LogRapyutaCore,
+                         Verbose,
+                         TEXT("Level [%s] streamed in: %d entities registered"),
+                         *InLevel->GetOuter()->GetName(),
+                         newEntities.Num());
+    }
+}
+
+void ASimulationState::OnLevelRemovedFromWorld(ULevel* InLevel, UWorld* InWorld)
+{
+    // A null level means all levels being removed, upon the world teardown
+    if ((InWorld != GetWorld()) || (nullptr == InLevel))
+    {
+        return;
+    }
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRSimStateLevelRemoved", RRSimStateChannel);
+    int32 removedNum = 0;
+    for (AActor* actor : InLevel->Actors)
+    {
+        if (actor && (Entities.FindRef(actor->GetName()) == actor))
+        {
+            const FBox prevBounds = actor->GetComponentsBoundingBox();
+            ServerUnregisterEntity(actor);
+            OnEntityBoundsChanged.Broadcast(actor, prevBounds);
+            ++removedNum;
+        }
+    }
+    if (removedNum > 0)
+    {
+        ForceNetUpdate();
+        UE_LOG_WITH_INFO(LogRapyutaCore,
+                         Verbose,
+                         TEXT("Level [%s] streamed out: %d entities unregistered"),
+                         *InLevel->GetOuter()->GetName(),
+                         removedNum);
+    }
 }
 
 void ASimulationState::ServerAddEntity(AActor* InEntity)
@@ -87,9 +256,31 @@ void ASimulationState::ServerAddEntity(AActor* InEntity)
         return;
     }
 
-    GetSpawnableEntityInfoList();
-    Entities.Emplace(InEntity->GetName(), InEntity);
-    EntityList.Emplace(InEntity);
+    ServerRegisterEntity(InEntity);
+    ++TaggedEntitiesVersion;
+}
+
+void ASimulationState::ServerAddEntities(const TArray<AActor*>& InEntities)
+{
+    Entities.Reserve(Entities.Num() + InEntities.Num());
+    EntityRegistry.Items.Reserve(EntityRegistry.Items.Num() + InEntities.Num());
+    for (AActor* entity : InEntities)
+    {
+        if (IsValid(entity))
+        {
+            ServerRegisterEntity(entity);
+        }
+    }
+    ++TaggedEntitiesVersion;
+    ForceNetUpdate();
+}
+
+void ASimulationState::ServerRegisterEntity(AActor* InEntity)
+{
+    const FString entityName = InEntity->GetName();
+    Entities.Emplace(entityName, InEntity);
+    AddEntityToIndex(InEntity, entityName, EntityRegistry.AddEntity(InEntity, entityName));
+    TRACE_COUNTER_SET(RREntitiesNum, Entities.Num());
     for (auto& tag : InEntity->Tags)
     {
         if (EntitiesWithTag.Contains(tag))
@@ -103,46 +294,67 @@ void ASimulationState::ServerAddEntity(AActor* InEntity)
             EntitiesWithTag.Emplace(tag, MoveTemp(actors));
         }
     }
+    OnEntityBoundsChanged.Broadcast(InEntity, FBox(ForceInit));
+}
+
+void ASimulationState::ServerUnregisterEntity(AActor* InEntity)
+{
+    const FString entityName = InEntity->GetName();
+    Entities.Remove(entityName);
+    RemoveEntityFromIndex(entityName, EntityRegistry.GetEntityId(InEntity));
+    EntityRegistry.RemoveEntity(InEntity);
+    TRACE_COUNTER_SET(RREntitiesNum, Entities.Num());
+    RemoveTaggedEntity(InEntity, InEntity->Tags);
+    EntitySpatialHash.Remove(InEntity);
+    WeldedEntities.Remove(InEntity);
 }
 
 // Work around to replicating Entities and EntitiesWithTag since TMaps cannot be replicated
-void ASimulationState::OnRep_EntityList()
+void ASimulationState::OnEntityRegistered(FRREntityRegistryItem& InItem)
 {
-    for (AActor* entity : EntityList)
+    AActor* entity = InItem.Actor;
+    if ((false == IsValid(entity)) || (InItem.RegisteredActor == entity))
     {
-        if (false == IsValid(entity))
-        {
-            continue;
-        }
+        return;
+    }
+    InItem.RegisteredActor = entity;
 
-        if (!Entities.Contains(entity->GetName()))
-        {
-            UROS2Spawnable* rosSpawnParameters = entity->FindComponentByClass<UROS2Spawnable>();
-            if (rosSpawnParameters)
-            {
-                Entities.Emplace(rosSpawnParameters->GetName(), entity);
-            }
-            else
-            {
-                Entities.Emplace(entity->GetName(), entity);
-            }
-        }
+    Entities.Emplace(InItem.Name, entity);
+    AddEntityToIndex(entity, InItem.Name, InItem.EntityId);
+    for (const auto& tag : entity->Tags)
+    {
+        AddTaggedEntity(entity, tag);
+    }
 
-        for (const auto& tag : entity->Tags)
+    // Looked up by their registry name, thus replicated actors are not renamed after their spawn parameters
+    UROS2Spawnable* entitySpawnParam = entity->FindComponentByClass<UROS2Spawnable>();
+    if (entitySpawnParam)
+    {
+        for (const auto& tag : entitySpawnParam->ActorTags)
         {
-            AddTaggedEntity(entity, tag);
+            AddTaggedEntity(entity, FName(tag));
         }
+    }
+}
 
-        UROS2Spawnable* EntitySpawnParam = entity->FindComponentByClass<UROS2Spawnable>();
-        if (EntitySpawnParam)
-        {
-            entity->Rename(*EntitySpawnParam->GetName());
-            for (const auto& tag : EntitySpawnParam->ActorTags)
-            {
-                AddTaggedEntity(entity, FName(tag));
-            }
-        }
+void ASimulationState::OnEntityUnregistered(FRREntityRegistryItem& InItem)
+{
+    if (Entities.FindRef(InItem.Name) == InItem.RegisteredActor)
+    {
+        Entities.Remove(InItem.Name);
+        RemoveEntityFromIndex(InItem.Name, InItem.EntityId);
+    }
+    if (IsValid(InItem.RegisteredActor))
+    {
+        RemoveTaggedEntity(InItem.RegisteredActor, InItem.RegisteredActor->Tags);
     }
+    else
+    {
+        TArray<FName> tags;
+        EntitiesWithTag.GetKeys(tags);
+        RemoveTaggedEntity(InItem.RegisteredActor, tags);
+    }
+    InItem.RegisteredActor = nullptr;
 }
 
 void ASimulationState::OnRep_SpawnableEntityInfoList()
@@ -155,6 +367,7 @@ void ASimulationState::OnRep_SpawnableEntityInfoList()
 
 void ASimulationState::AddTaggedEntity(AActor* Entity, const FName& InTag)
 {
+    ++TaggedEntitiesVersion;
     if (EntitiesWithTag.Contains(InTag))
     {
         // Check if Actor in EntitiesWithTag
@@ -180,24 +393,237 @@ void ASimulationState::AddTaggedEntity(AActor* Entity, const FName& InTag)
     }
 }
 
+void ASimulationState::AddEntityToIndex(AActor* InEntity, const FString& InName, const uint32 InEntityId)
+{
+    EntityIndex.Emplace(FName(*InName), InEntity);
+    if (InEntityId > 0)
+    {
+        EntityIdIndex.Emplace(InEntityId, InEntity);
+    }
+}
+
+void ASimulationState::RemoveEntityFromIndex(const FString& InName, const uint32 InEntityId)
+{
+    EntityIndex.Remove(FName(*InName, FNAME_Find));
+    EntityIdIndex.Remove(InEntityId);
+}
+
+AActor* ASimulationState::FindEntity(const FString& InName) const
+{
+    // FNAME_Find does not add unknown names, eg from erroneous ROS requests, to the name table
+    const FName name(*InName, FNAME_Find);
+    if (name.IsNone())
+    {
+        return nullptr;
+    }
+    if (const TWeakObjectPtr<AActor>* entity = EntityIndex.Find(name))
+    {
+        return entity->Get();
+    }
+
+    // Entities added to [Entities] directly, eg from BP
+    AActor* entity = Entities.FindRef(InName);
+    return IsValid(entity) ? entity : nullptr;
+}
+
+AActor* ASimulationState::FindEntityById(const uint32 InEntityId) const
+{
+    const TWeakObjectPtr<AActor>* entity = EntityIdIndex.Find(InEntityId);
+    return entity ? entity->Get() : nullptr;
+}
+
+void ASimulationState::RemoveTaggedEntity(const AActor* InEntity, const TArray<FName>& InTags)
+{
+    ++TaggedEntitiesVersion;
+    for (const auto& tag : InTags)
+    {
+        if (FRREntities* entities = EntitiesWithTag.Find(tag))
+        {
+            entities->Actors.RemoveAll([InEntity](const AActor* InActor)
+                                       { return (InActor == InEntity) || (false == IsValid(InActor)); });
+        }
+    }
+}
+
+AActor* ASimulationState::FindNearestTaggedEntityAlongZ(const FName& InTag, const float InZ, float& OutMinZ, float& OutMaxZ)
+{
+    // 1- (Re)build the tag's index, sorted by Z
+    FTaggedEntitiesZIndex& index = TaggedEntitiesZIndices.FindOrAdd(InTag);
+    if (index.Version != TaggedEntitiesVersion)
+    {
+        TArray<TPair<float, AActor*>> sortedActors;
+        if (const FRREntities* entities = EntitiesWithTag.Find(InTag))
+        {
+            sortedActors.Reserve(entities->Actors.Num());
+            for (AActor* actor : entities->Actors)
+            {
+                if (IsValid(actor))
+                {
+                    sortedActors.Emplace(actor->GetActorLocation().Z, actor);
+                }
+            }
+        }
+        sortedActors.Sort([](const TPair<float, AActor*>& InA, const TPair<float, AActor*>& InB) { return InA.Key < InB.Key; });
+
+        index.Actors.Reset(sortedActors.Num());
+        index.Zs.Reset(sortedActors.Num());
+        for (const auto& sortedActor : sortedActors)
+        {
+            index.Zs.Add(sortedActor.Key);
+            index.Actors.Add(sortedActor.Value);
+        }
+        index.Version = TaggedEntitiesVersion;
+    }
+
+    const int32 actorsNum = index.Zs.Num();
+    if (actorsNum == 0)
+    {
+        return nullptr;
+    }
+
+    // 2- Nearest of the two entities around InZ
+    int32 nearest = FMath::Clamp(Algo::LowerBound(index.Zs, InZ), 0, actorsNum - 1);
+    if ((nearest > 0) && (FMath::Abs(InZ - index.Zs[nearest - 1]) <= FMath::Abs(InZ - index.Zs[nearest])))
+    {
+        --nearest;
+    }
+
+    // 3- Boundaries halfway to the neighbours
+    OutMinZ = (nearest > 0) ? 0.5f * (index.Zs[nearest - 1] + index.Zs[nearest]) : -TNumericLimits<float>::Max();
+    OutMaxZ = (nearest < actorsNum - 1) ? 0.5f * (index.Zs[nearest] + index.Zs[nearest + 1]) : TNumericLimits<float>::Max();
+    return index.Actors[nearest].Get();
+}
+
+void ASimulationState::SyncEntitySpatialHash()
+{
+    if (EntitySpatialHashSyncFrame != GFrameCounter)
+    {
+        TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRSyncEntitySpatialHash", RRSimStateChannel);
+        EntitySpatialHashSyncFrame = GFrameCounter;
+        EntitySpatialHash.SetCellSize(CVarSpatialHashCellSize.GetValueOnGameThread());
+        EntitySpatialHash.Sync(Entities);
+    }
+}
+
+bool ASimulationState::GetTaggedEntitiesSet(const FName& InTag, TSet<const AActor*>& OutTaggedEntities) const
+{
+    if (InTag.IsNone())
+    {
+        return true;
+    }
+    const FRREntities* entities = EntitiesWithTag.Find(InTag);
+    if ((nullptr == entities) || (entities->Actors.Num() == 0))
+    {
+        return false;
+    }
+    OutTaggedEntities.Reserve(entities->Actors.Num());
+    for (const AActor* actor : entities->Actors)
+    {
+        OutTaggedEntities.Add(actor);
+    }
+    return true;
+}
+
+void ASimulationState::FindEntitiesInRadius(const FVector& InCenter,
+                                            const float InRadius,
+                                            TArray<AActor*>& OutEntities,
+                                            const FName& InTag)
+{
+    OutEntities.Reset();
+    TSet<const AActor*> taggedEntities;
+    if (GetTaggedEntitiesSet(InTag, taggedEntities))
+    {
+        SyncEntitySpatialHash();
+        EntitySpatialHash.QueryRadius(InCenter,
+                                      InRadius,
+                                      OutEntities,
+                                      [&InTag, &taggedEntities](const AActor* InEntity)
+                                      { return InTag.IsNone() || taggedEntities.Contains(InEntity); });
+    }
+}
+
+void ASimulationState::FindEntitiesInBox(const FBox& InBox, TArray<AActor*>& OutEntities, const FName& InTag)
+{
+    OutEntities.Reset();
+    TSet<const AActor*> taggedEntities;
+    if (GetTaggedEntitiesSet(InTag, taggedEntities))
+    {
+        SyncEntitySpatialHash();
+        EntitySpatialHash.QueryBox(InBox,
+                                   OutEntities,
+                                   [&InTag, &taggedEntities](const AActor* InEntity)
+                                   { return InTag.IsNone() || taggedEntities.Contains(InEntity); });
+    }
+}
+
+AActor* ASimulationState::FindNearestEntity(const FVector& InLocation,
+                                            const float InMaxDistance,
+                                            const FName& InTag,
+                                            const AActor* InIgnoredEntity)
+{
+    TSet<const AActor*> taggedEntities;
+    if (!GetTaggedEntitiesSet(InTag, taggedEntities))
+    {
+        return nullptr;
+    }
+    SyncEntitySpatialHash();
+    return EntitySpatialHash.FindNearest(InLocation,
+                                         InMaxDistance,
+                                         [&InTag, &taggedEntities, InIgnoredEntity](const AActor* InEntity)
+                                         {
+                                             return (InEntity != InIgnoredEntity) &&
+                                                    (InTag.IsNone() || taggedEntities.Contains(InEntity));
+                                         });
+}
+
 void ASimulationState::AddSpawnableEntityTypes(TMap<FString, TSubclassOf<AActor>> InSpawnableEntityTypes)
 {
+    bool bChanged = false;
     for (auto& elem : InSpawnableEntityTypes)
     {
-        SpawnableEntityInfoList.Emplace(FRREntityInfo(elem));
+        TSubclassOf<AActor>* entityClass = SpawnableEntityTypes.Find(elem.Key);
+        if (entityClass && (*entityClass == elem.Value))
+        {
+            continue;
+        }
+
+        FRREntityInfo* entityInfo = SpawnableEntityInfoList.FindByPredicate(
+            [&elem](const FRREntityInfo& InEntityInfo) { return InEntityInfo.EntityTypeName == elem.Key; });
+        if (entityInfo)
+        {
+            entityInfo->EntityClass = elem.Value;
+        }
+        else
+        {
+            SpawnableEntityInfoList.Emplace(FRREntityInfo(elem));
+        }
         SpawnableEntityTypes.Emplace(MoveTemp(elem.Key), MoveTemp(elem.Value));
+        bChanged = true;
+    }
+
+    if (bChanged && HasAuthority())
+    {
+        ForceNetUpdate();
     }
 }
 
 void ASimulationState::GetSpawnableEntityInfoList()
 {
-    for (auto& elem : SpawnableEntityTypes)
+    bool bInSync = (SpawnableEntityInfoList.Num() == SpawnableEntityTypes.Num());
+    for (int32 i = 0; bInSync && (i < SpawnableEntityInfoList.Num()); ++i)
     {
-        SpawnableEntityInfoList.Emplace(FRREntityInfo(elem));
+        const FRREntityInfo& entityInfo = SpawnableEntityInfoList[i];
+        bInSync = (SpawnableEntityTypes.FindRef(entityInfo.EntityTypeName) == entityInfo.EntityClass);
     }
-    if (SpawnableEntityInfoList.Num() > 0)
+    if (bInSync)
+    {
+        return;
+    }
+
+    SpawnableEntityInfoList.Reset(SpawnableEntityTypes.Num());
+    for (auto& elem : SpawnableEntityTypes)
     {
-        GetWorld()->GetTimerManager().ClearTimer(FetchEntityListTimerHandle);
+        SpawnableEntityInfoList.Emplace(FRREntityInfo(elem));
     }
 }
 
@@ -218,6 +644,7 @@ bool ASimulationState::ServerCheckSetEntityStateRequest(const FROSSetEntityState
 
 void ASimulationState::ServerSetEntityState(const FROSSetEntityStateReq& InRequest)
 {
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRSetEntityState", RRSimStateChannel);
     if (false == VerifyIsServerCall(TEXT("ServerSetEntityState")))
     {
         return;
@@ -225,20 +652,80 @@ void ASimulationState::ServerSetEntityState(const FROSSetEntityStateReq& InReque
 
     if (ServerCheckSetEntityStateRequest(InRequest))
     {
-        FTransform relativeTransf(InRequest.State.Pose.Orientation, InRequest.State.Pose.Position);
-        relativeTransf = URRConversionUtils::TransformROSToUE(relativeTransf);
-        FTransform worldTransf;
-        URRGeneralUtils::GetWorldTransform(
-            InRequest.State.ReferenceFrame,
-            Entities.Contains(InRequest.State.ReferenceFrame) ? Entities[InRequest.State.ReferenceFrame] : nullptr,
-            relativeTransf,
-            worldTransf);
-        Entities[InRequest.State.Name]->SetActorTransform(worldTransf);
+        AActor* entity = FindEntity(InRequest.State.Name);
+        if (nullptr == entity)
+        {
+            UE_LOG_WITH_INFO(
+                LogRapyutaCore, Warning, TEXT("Entity [%s] is not under SimulationState control"), *InRequest.State.Name);
+        }
+        else
+        {
+            FTransform relativeTransf(InRequest.State.Pose.Orientation, InRequest.State.Pose.Position);
+            relativeTransf = URRConversionUtils::TransformROSToUE(relativeTransf);
+            if (CVarDeferSetEntityState.GetValueOnGameThread())
+            {
+                // Reference frames are resolved upon being applied, since they may be moved in the meantime
+                const int32* pendingIdx = PendingEntityStateIndices.Find(entity);
+                FPendingEntityState& pendingState = pendingIdx ? PendingEntityStates[*pendingIdx]
+                                                               : PendingEntityStates.AddDefaulted_GetRef();
+                if (nullptr == pendingIdx)
+                {
+                    PendingEntityStateIndices.Emplace(entity, PendingEntityStates.Num() - 1);
+                }
+                pendingState.Entity = entity;
+                pendingState.ReferenceFrame = InRequest.State.ReferenceFrame;
+                pendingState.RelativeTransform = relativeTransf;
+            }
+            else
+            {
+                FTransform worldTransf;
+                URRGeneralUtils::GetWorldTransform(
+                    InRequest.State.ReferenceFrame, FindEntity(InRequest.State.ReferenceFrame), relativeTransf, worldTransf);
+                const FBox prevBounds = entity->GetComponentsBoundingBox();
+                entity->SetActorTransform(worldTransf, false, nullptr, ETeleportType::TeleportPhysics);
+                OnEntityBoundsChanged.Broadcast(entity, prevBounds);
+                EntitySpatialHash.Update(entity);
+            }
+        }
     }
 
     PrevSetEntityStateRequest = InRequest;
 }
 
+void ASimulationState::ServerApplyPendingEntityStates()
+{
+    // Render transforms of moved entities are sent all together at end of frame
+    for (const auto& pendingState : PendingEntityStates)
+    {
+        AActor* entity = pendingState.Entity.Get();
+        if (nullptr == entity)
+        {
+            continue;
+        }
+        FTransform worldTransf;
+        const AActor* referenceEntity = FindEntity(pendingState.ReferenceFrame);
+        if (URRGeneralUtils::GetWorldTransform(
+                pendingState.ReferenceFrame, referenceEntity, pendingState.RelativeTransform, worldTransf))
+        {
+            const FBox prevBounds = entity->GetComponentsBoundingBox();
+            entity->SetActorTransform(worldTransf, false, nullptr, ETeleportType::TeleportPhysics);
+            OnEntityBoundsChanged.Broadcast(entity, prevBounds);
+            EntitySpatialHash.Update(entity);
+        }
+    }
+    PendingEntityStates.Reset();
+    PendingEntityStateIndices.Reset();
+}
+
+void ASimulationState::ServerSetEntityStates(const TArray<FROSSetEntityStateReq>& InRequests)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRSetEntityStates", RRSimStateChannel);
+    for (const auto& request : InRequests)
+    {
+        ServerSetEntityState(request);
+    }
+}
+
 bool ASimulationState::ServerCheckAttachRequest(const FROSAttachReq& InRequest)
 {
     if (false == VerifyIsServerCall(TEXT("ServerCheckAttachRequest")))
@@ -258,58 +745,254 @@ void ASimulationState::ServerAttach(const FROSAttachReq& InRequest)
     // TODO: Add proper server check
     //if (ServerCheckAttachRequest(InRequest))
 
-    AActor* entity1 = Entities[InRequest.Name1];
-    AActor* entity2 = Entities[InRequest.Name2];
+    AActor* entity1 = Entities.FindRef(InRequest.Name1);
+    AActor* entity2 = Entities.FindRef(InRequest.Name2);
+    if (IsValid(entity1) && IsValid(entity2))
+    {
+        ServerToggleAttachment(entity1, entity2, AttachMode);
+    }
+    else
+    {
+        UE_LOG_WITH_INFO(
+            LogRapyutaCore,
+            Warning,
+            TEXT("Entity %s and/or %s not exit or not under SimulationState Actor control. Please call AddEntity to make Actors "
+                 "under SimulationState control."),
+            *InRequest.Name1,
+            *InRequest.Name2);
+    }
+
+    PrevAttachEntityRequest = InRequest;
+}
 
-    if (entity2->IsRootComponentMovable())
+void ASimulationState::ServerAttachBatch(const TArray<FROSAttachReq>& InRequests)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRAttachBatch", RRSimStateChannel);
+    for (const auto& request : InRequests)
     {
-        if (!entity2->IsAttachedTo(entity1))
+        ServerAttach(request);
+    }
+}
+
+int32 ASimulationState::ServerCaptureWorldSnapshot(const FString& InSnapshotName)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRCaptureWorldSnapshot", RRSimStateChannel);
+    if (false == VerifyIsServerCall(TEXT("ServerCaptureWorldSnapshot")))
+    {
+        return 0;
+    }
+
+    TMap<const AActor*, const FString*> entityNames;
+    entityNames.Reserve(Entities.Num());
+    for (const auto& entity : Entities)
+    {
+        if (IsValid(entity.Value))
+        {
+            entityNames.Add(entity.Value, &entity.Key);
+        }
+    }
+
+    FRRWorldSnapshot snapshot;
+    snapshot.Entities.Reserve(entityNames.Num());
+    for (const auto& entity : entityNames)
+    {
+        AActor* actor = const_cast<AActor*>(entity.Key);
+        FRRWorldSnapshot::FEntityState& state = snapshot.Entities.AddDefaulted_GetRef();
+        FRRWorldSnapshot::CaptureEntity(actor, *entity.Value, state);
+        if (const FString* const* parentName = entityNames.Find(actor->GetAttachParentActor()))
         {
-            entity2->AttachToActor(entity1, FAttachmentTransformRules::KeepWorldTransform);
+            state.AttachParentName = **parentName;
+            state.bWelded = WeldedEntities.Contains(actor);
+        }
+    }
 
-            // disable collision check with attached actor (Entity2) when entity1 moves
-            for (auto component : entity1->GetComponents())
+    TArray<uint8>& data = WorldSnapshots.FindOrAdd(InSnapshotName);
+    snapshot.Save(data);
+    UE_LOG_WITH_INFO(LogRapyutaCore,
+                     Log,
+                     TEXT("Captured world snapshot [%s] of %d entities, %d bytes"),
+                     *InSnapshotName,
+                     snapshot.Entities.Num(),
+                     data.Num());
+    return snapshot.Entities.Num();
+}
+
+int32 ASimulationState::ServerRestoreWorldSnapshot(const FString& InSnapshotName)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRRestoreWorldSnapshot", RRSimStateChannel);
+    if (false == VerifyIsServerCall(TEXT("ServerRestoreWorldSnapshot")))
+    {
+        return INDEX_NONE;
+    }
+
+    const TArray<uint8>* data = WorldSnapshots.Find(InSnapshotName);
+    FRRWorldSnapshot snapshot;
+    if ((nullptr == data) || !snapshot.Load(*data))
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Warning, TEXT("No valid world snapshot [%s]"), *InSnapshotName);
+        return INDEX_NONE;
+    }
+
+    // Pending poses would otherwise be applied over the restored ones at end of frame
+    PendingEntityStates.Reset();
+    PendingEntityStateIndices.Reset();
+
+    // 1- Attachments, differing ones being toggled
+    TArray<AActor*> actors;
+    TArray<int32> depths;
+    actors.SetNumZeroed(snapshot.Entities.Num());
+    depths.SetNumZeroed(snapshot.Entities.Num());
+    for (int32 i = 0; i < snapshot.Entities.Num(); ++i)
+    {
+        const FRRWorldSnapshot::FEntityState& state = snapshot.Entities[i];
+        AActor* actor = FindEntity(state.Name);
+        if (nullptr == actor)
+        {
+            continue;
+        }
+        actors[i] = actor;
+        AActor* parent = state.AttachParentName.IsEmpty() ? nullptr : FindEntity(state.AttachParentName);
+        AActor* currentParent = actor->GetAttachParentActor();
+        if (currentParent != parent)
+        {
+            if (currentParent)
             {
-                auto primitiveComp = Cast<UPrimitiveComponent>(component);
-                if (primitiveComp)
-                {
-                    primitiveComp->IgnoreActorWhenMoving(entity2, true);
-                }
+                ServerToggleAttachment(currentParent, actor, AttachMode);
+            }
+            if (parent)
+            {
+                ServerToggleAttachment(parent, actor, state.bWelded ? ERRAttachMode::WELD : ERRAttachMode::KINEMATIC);
             }
         }
-        else
-        {
-            entity2->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+    }
 
-            // enable collisions between the 2 actors when entity1 moves
-            for (auto component : entity1->GetComponents())
+    // 2- States, parents first so that moving them does not offset their restored children
+    TArray<int32> order;
+    order.Reserve(actors.Num());
+    for (int32 i = 0; i < actors.Num(); ++i)
+    {
+        if (actors[i])
+        {
+            for (const AActor* parent = actors[i]->GetAttachParentActor(); parent; parent = parent->GetAttachParentActor())
             {
-                auto primitiveComp = Cast<UPrimitiveComponent>(component);
-                if (primitiveComp)
-                {
-                    primitiveComp->IgnoreActorWhenMoving(entity2, false);
-                }
+                ++depths[i];
             }
+            order.Add(i);
         }
     }
-    else
+    order.StableSort([&depths](const int32 InA, const int32 InB) { return depths[InA] < depths[InB]; });
+    for (const int32 i : order)
+    {
+        const FBox prevBounds = actors[i]->GetComponentsBoundingBox();
+        FRRWorldSnapshot::RestoreEntity(actors[i], snapshot.Entities[i]);
+        OnEntityBoundsChanged.Broadcast(actors[i], prevBounds);
+        EntitySpatialHash.Update(actors[i]);
+    }
+
+    UE_LOG_WITH_INFO(LogRapyutaCore,
+                     Log,
+                     TEXT("Restored world snapshot [%s]: %d/%d entities"),
+                     *InSnapshotName,
+                     order.Num(),
+                     snapshot.Entities.Num());
+    return order.Num();
+}
+
+bool ASimulationState::GetWorldSnapshotData(const FString& InSnapshotName, TArray<uint8>& OutData) const
+{
+    if (const TArray<uint8>* data = WorldSnapshots.Find(InSnapshotName))
+    {
+        OutData = *data;
+        return true;
+    }
+    return false;
+}
+
+void ASimulationState::ServerToggleAttachment(AActor* InParent, AActor* InChild, const ERRAttachMode InMode)
+{
+    if (false == InChild->IsRootComponentMovable())
     {
         UE_LOG_WITH_INFO(LogRapyutaCore,
                          Warning,
                          TEXT("entity2 to attach or detach %s has its Mobility not set as Movable. Please set Mobility of "
                               "entity2 as Movable for Attach service to work properly."),
-                         *InRequest.Name2);
+                         *InChild->GetName());
+        return;
     }
 
-    UE_LOG_WITH_INFO(
-        LogRapyutaCore,
-        Warning,
-        TEXT("Entity %s and/or %s not exit or not under SimulationState Actor control. Please call AddEntity to make Actors "
-             "under SimulationState control."),
-        *InRequest.Name1,
-        *InRequest.Name2);
+    // Only the moved component sweeps, its attached children following without, thus only the parent's root needs to ignore
+    // the child in WELD mode
+    auto setIgnoreChildWhenMoving = [InParent, InChild](const bool bInRootOnly, const bool bInIgnore)
+    {
+        if (bInRootOnly)
+        {
+            if (auto* rootComp = Cast<UPrimitiveComponent>(InParent->GetRootComponent()))
+            {
+                rootComp->IgnoreActorWhenMoving(InChild, bInIgnore);
+            }
+            return;
+        }
+        for (auto component : InParent->GetComponents())
+        {
+            auto primitiveComp = Cast<UPrimitiveComponent>(component);
+            if (primitiveComp)
+            {
+                primitiveComp->IgnoreActorWhenMoving(InChild, bInIgnore);
+            }
+        }
+    };
 
-    PrevAttachEntityRequest = InRequest;
+    if (!InChild->IsAttachedTo(InParent))
+    {
+        if (ERRAttachMode::WELD == InMode)
+        {
+            InChild->AttachToActor(InParent, FAttachmentTransformRules(EAttachmentRule::KeepWorld, true));
+            setIgnoreChildWhenMoving(true, true);
+
+            // Overlaps of the child would otherwise be updated per component upon every move of the parent
+            TArray<TWeakObjectPtr<UPrimitiveComponent>>& overlapComps = WeldedEntities.FindOrAdd(InChild);
+            overlapComps.Reset();
+            for (auto component : InChild->GetComponents())
+            {
+                auto primitiveComp = Cast<UPrimitiveComponent>(component);
+                if (primitiveComp && primitiveComp->GetGenerateOverlapEvents())
+                {
+                    primitiveComp->SetGenerateOverlapEvents(false);
+                    overlapComps.Add(primitiveComp);
+                }
+            }
+        }
+        else
+        {
+            InChild->AttachToActor(InParent, FAttachmentTransformRules::KeepWorldTransform);
+
+            // disable collision check with attached actor (Entity2) when entity1 moves
+            setIgnoreChildWhenMoving(false, true);
+        }
+    }
+    else
+    {
+        // Also unwelds the child's bodies
+        InChild->DetachFromActor(FDetachmentTransformRules::KeepWorldTransform);
+
+        // enable collisions between the 2 actors when entity1 moves
+        TArray<TWeakObjectPtr<UPrimitiveComponent>> overlapComps;
+        if (WeldedEntities.RemoveAndCopyValue(InChild, overlapComps))
+        {
+            setIgnoreChildWhenMoving(true, false);
+            for (const auto& comp : overlapComps)
+            {
+                if (comp.IsValid())
+                {
+                    comp->SetGenerateOverlapEvents(true);
+                }
+            }
+        }
+        else
+        {
+            setIgnoreChildWhenMoving(false, false);
+        }
+    }
 }
 
 bool ASimulationState::ServerCheckSpawnRequest(const FROSSpawnEntityReq& InRequest)
@@ -343,6 +1026,27 @@ AActor* ASimulationState::ServerSpawnEntity(const FROSSpawnEntityReq& InROSSpawn
         return nullptr;
     }
 
+    AActor* newEntity = ServerBeginSpawnEntity(InROSSpawnRequest, InEntityClass, InEntityTransform, InNetworkPlayerId);
+    if (newEntity == nullptr)
+    {
+        return nullptr;
+    }
+
+    // Finish spawning Entity
+    // Destroy seems not make newEntity=nullptr evevn if it failed.
+    newEntity = UGameplayStatics::FinishSpawningActor(newEntity, InEntityTransform);
+
+    // Add to [Entities]
+    ServerAddEntity(newEntity);
+
+    return newEntity;
+}
+
+AActor* ASimulationState::ServerBeginSpawnEntity(const FROSSpawnEntityReq& InROSSpawnRequest,
+                                                 const TSubclassOf<AActor>& InEntityClass,
+                                                 const FTransform& InEntityTransform,
+                                                 const int32 InNetworkPlayerId)
+{
     // SpawnActorDeferred to set parameters beforehand
     // Using AdjustIfPossibleButAlwaysSpawn, the actual entity's transform could be different from one specified in SpawnEntity,
     // thus we may need to inform ros side to get synchronized with it
@@ -397,13 +1101,6 @@ AActor* ASimulationState::ServerSpawnEntity(const FROSSpawnEntityReq& InROSSpawn
     // Add Json configs
     spawnableComponent->ActorJsonConfigs = InROSSpawnRequest.JsonParameters;
 
-    // Finish spawning Entity
-    // Destroy seems not make newEntity=nullptr evevn if it failed.
-    newEntity = UGameplayStatics::FinishSpawningActor(newEntity, InEntityTransform);
-
-    // Add to [Entities]
-    ServerAddEntity(newEntity);
-
     return newEntity;
 }
 
@@ -414,56 +1111,179 @@ AActor* ASimulationState::ServerSpawnEntity(const FROSSpawnEntityReq& InRequest,
         return nullptr;
     }
 
-    AActor* newEntity = nullptr;
+    AActor* newEntity = ServerCheckSpawnRequest(InRequest) ? ServerSpawnCheckedEntity(InRequest, InNetworkPlayerId) : nullptr;
+    PrevSpawnEntityRequest = InRequest;
+    return newEntity;
+}
+
+bool ASimulationState::ServerQueueSpawnEntity(const FROSSpawnEntityReq& InRequest, const int32 InNetworkPlayerId)
+{
+    if (false == VerifyIsServerCall(TEXT("ServerQueueSpawnEntity")))
+    {
+        return false;
+    }
+
+    bool bQueued = false;
     if (ServerCheckSpawnRequest(InRequest))
     {
-        const FString& entityModelName = InRequest.Xml;
-        const FString& entityName = InRequest.State.Name;
-        verify(false == entityName.IsEmpty());
-        if (nullptr == URRUObjectUtils::FindActorByName<AActor>(GetWorld(), entityName))
-        {
-            // Calculate to-be-spawned entity's [world transf]
-            FTransform relativeTransf =
-                URRConversionUtils::TransformROSToUE(FTransform(InRequest.State.Pose.Orientation, InRequest.State.Pose.Position));
-            const FString& referenceFrame = InRequest.State.ReferenceFrame;
-            FTransform worldTransf;
-            URRGeneralUtils::GetWorldTransform(referenceFrame, Entities.FindRef(referenceFrame), relativeTransf, worldTransf);
-
-            // Spawn entity
-            newEntity = ServerSpawnEntity(InRequest, SpawnableEntityTypes[entityModelName], worldTransf, InNetworkPlayerId);
-            if (newEntity)
-            {
-                UE_LOG_WITH_INFO(LogRapyutaCore,
-                                 Warning,
-                                 TEXT("Spawned Entity of model [%s] as [%s] to world pose: %s - ReferenceFrame: %s"),
-                                 *entityModelName,
-                                 *entityName,
-                                 *worldTransf.ToString(),
-                                 *referenceFrame);
-            }
-            else
-            {
-                // todo: need pass response to SimulationStateClient
-                // response.bSuccess = false;
-                // response.StatusMessage =
-                //     FString::Printf(TEXT("[%s] Failed to spawn entity named %s, probably out collision!"), *GetName(),
-                //     *entityName);
-                UE_LOG_WITH_INFO(LogRapyutaCore,
-                                 Error,
-                                 TEXT("[ASimulationState] Failed to spawn entity named %s, probably out collision!"),
-                                 *entityName);
-            }
+        bool bAlreadyPending = false;
+        PendingSpawnNames.Add(InRequest.State.Name, &bAlreadyPending);
+        if (bAlreadyPending)
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore,
+                             Error,
+                             TEXT("Entity spawning failed - [%s] given name actor is already being spawned!"),
+                             *InRequest.State.Name);
         }
         else
         {
-            UE_LOG_WITH_INFO(
-                LogRapyutaCore, Error, TEXT("Entity spawning failed - [%s] given name actor already exists!"), *entityName);
+            PendingSpawnRequests.Add({InRequest, InNetworkPlayerId});
+            bQueued = true;
         }
     }
     PrevSpawnEntityRequest = InRequest;
+
+    if (CVarMaxSpawnsPerFrame.GetValueOnGameThread() <= 0)
+    {
+        ServerSpawnPendingEntities(0);
+    }
+    return bQueued;
+}
+
+TArray<AActor*> ASimulationState::ServerSpawnEntities(const TArray<FROSSpawnEntityReq>& InRequests,
+                                                     const int32 InNetworkPlayerId)
+{
+    TArray<AActor*> newEntities;
+    if (false == VerifyIsServerCall(TEXT("ServerSpawnEntities")))
+    {
+        return newEntities;
+    }
+
+    // 1- Spawn all entities deferred
+    newEntities.SetNumZeroed(InRequests.Num());
+    TArray<FTransform> worldTransforms;
+    worldTransforms.SetNum(InRequests.Num());
+    TMap<FString, AActor*> batchEntities;
+    batchEntities.Reserve(InRequests.Num());
+    for (int32 i = 0; i < InRequests.Num(); ++i)
+    {
+        const FROSSpawnEntityReq& request = InRequests[i];
+        if (batchEntities.Contains(request.State.Name) || PendingSpawnNames.Contains(request.State.Name))
+        {
+            UE_LOG_WITH_INFO(LogRapyutaCore,
+                             Error,
+                             TEXT("Entity spawning failed - [%s] given name actor is already being spawned!"),
+                             *request.State.Name);
+            continue;
+        }
+
+        TSubclassOf<AActor> entityClass;
+        if (ServerPrepareSpawnEntity(request, batchEntities, entityClass, worldTransforms[i]))
+        {
+            newEntities[i] = ServerBeginSpawnEntity(request, entityClass, worldTransforms[i], InNetworkPlayerId);
+            if (newEntities[i])
+            {
+                batchEntities.Emplace(request.State.Name, newEntities[i]);
+            }
+        }
+    }
+
+    // 2- Finish them together
+    URRUObjectUtils::FinishSpawningActors(GetWorld(), newEntities, worldTransforms);
+    const int32 spawnedNum = newEntities.Num() - Algo::Count(newEntities, nullptr);
+
+    // 3- Register them in a single pass
+    ServerAddEntities(newEntities);
+    UE_LOG_WITH_INFO(LogRapyutaCore, Log, TEXT("Spawned %d/%d entities in batch"), spawnedNum, InRequests.Num());
+    return newEntities;
+}
+
+void ASimulationState::ServerSpawnPendingEntities(const int32 InMaxNum)
+{
+    const int32 spawnsNum = (InMaxNum > 0) ? FMath::Min(InMaxNum, PendingSpawnRequests.Num()) : PendingSpawnRequests.Num();
+    for (int32 i = 0; i < spawnsNum; ++i)
+    {
+        const FPendingSpawnRequest& pendingRequest = PendingSpawnRequests[i];
+        PendingSpawnNames.Remove(pendingRequest.Request.State.Name);
+        ServerSpawnCheckedEntity(pendingRequest.Request, pendingRequest.NetworkPlayerId);
+    }
+    PendingSpawnRequests.RemoveAt(0, spawnsNum);
+}
+
+AActor* ASimulationState::ServerSpawnCheckedEntity(const FROSSpawnEntityReq& InRequest, const int32 InNetworkPlayerId)
+{
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR("RRSpawnCheckedEntity", RRSimStateChannel);
+    FRRStartupPhaseScope startupPhaseScope(ERRStartupPhase::ACTOR_SPAWN);
+    TSubclassOf<AActor> entityClass;
+    FTransform worldTransf;
+    if (false == ServerPrepareSpawnEntity(InRequest, {}, entityClass, worldTransf))
+    {
+        return nullptr;
+    }
+
+    // Spawn entity
+    AActor* newEntity = ServerSpawnEntity(InRequest, entityClass, worldTransf, InNetworkPlayerId);
+    if (newEntity)
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore,
+                         Warning,
+                         TEXT("Spawned Entity of model [%s] as [%s] to world pose: %s - ReferenceFrame: %s"),
+                         *InRequest.Xml,
+                         *InRequest.State.Name,
+                         *worldTransf.ToString(),
+                         *InRequest.State.ReferenceFrame);
+    }
+    else
+    {
+        // todo: need pass response to SimulationStateClient
+        // response.bSuccess = false;
+        // response.StatusMessage =
+        //     FString::Printf(TEXT("[%s] Failed to spawn entity named %s, probably out collision!"), *GetName(),
+        //     *entityName);
+        UE_LOG_WITH_INFO(LogRapyutaCore,
+                         Error,
+                         TEXT("[ASimulationState] Failed to spawn entity named %s, probably out collision!"),
+                         *InRequest.State.Name);
+    }
     return newEntity;
 }
 
+bool ASimulationState::ServerPrepareSpawnEntity(const FROSSpawnEntityReq& InRequest,
+                                                const TMap<FString, AActor*>& InBatchEntities,
+                                                TSubclassOf<AActor>& OutEntityClass,
+                                                FTransform& OutWorldTransform)
+{
+    const FString& entityModelName = InRequest.Xml;
+    const FString& entityName = InRequest.State.Name;
+    verify(false == entityName.IsEmpty());
+    if (URRUObjectUtils::FindActorByName<AActor>(GetWorld(), entityName))
+    {
+        UE_LOG_WITH_INFO(
+            LogRapyutaCore, Error, TEXT("Entity spawning failed - [%s] given name actor already exists!"), *entityName);
+        return false;
+    }
+
+    const TSubclassOf<AActor>* entityClass = SpawnableEntityTypes.Find(entityModelName);
+    if (nullptr == entityClass)
+    {
+        UE_LOG_WITH_INFO(LogRapyutaCore, Error, TEXT("Entity spawning failed - [%s] is not spawnable!"), *entityModelName);
+        return false;
+    }
+    OutEntityClass = *entityClass;
+
+    // Calculate to-be-spawned entity's [world transf]
+    FTransform relativeTransf =
+        URRConversionUtils::TransformROSToUE(FTransform(InRequest.State.Pose.Orientation, InRequest.State.Pose.Position));
+    const FString& referenceFrame = InRequest.State.ReferenceFrame;
+    AActor* referenceActor = Entities.FindRef(referenceFrame);
+    if (nullptr == referenceActor)
+    {
+        referenceActor = InBatchEntities.FindRef(referenceFrame);
+    }
+    URRGeneralUtils::GetWorldTransform(referenceFrame, referenceActor, relativeTransf, OutWorldTransform);
+    return true;
+}
+
 bool ASimulationState::ServerCheckDeleteRequest(const FROSDeleteEntityReq& InRequest)
 {
     if (false == VerifyIsServerCall(TEXT("ServerCheckDeleteRequest")))
@@ -482,8 +1302,20 @@ void ASimulationState::ServerDeleteEntity(const FROSDeleteEntityReq& InRequest)
 
     if (ServerCheckDeleteRequest(InRequest))
     {
-        AActor* Removed = Entities.FindAndRemoveChecked(InRequest.Name);
-        Removed->Destroy();
+        ServerRemoveEntity(Entities.FindChecked(InRequest.Name));
     }
     PrevDeleteEntityRequest = InRequest;
 }
+
+void ASimulationState::ServerRemoveEntity(AActor* InEntity)
+{
+    if (false == VerifyIsServerCall(TEXT("ServerRemoveEntity")) || (nullptr == InEntity))
+    {
+        return;
+    }
+
+    ServerUnregisterEntity(InEntity);
+    const FBox prevBounds = InEntity->GetComponentsBoundingBox();
+    InEntity->Destroy();
+    OnEntityBoundsChanged.Broadcast(InEntity, prevBounds);
+}
@@ -2,6 +2,9 @@
 
 #include "Tools/TimeLogger.h"
 
+// UE
+#include "RenderCore.h"
+
 // Sets default values
 ATimeLogger::ATimeLogger()
 {
@@ -13,10 +16,12 @@ ATimeLogger::ATimeLogger()
 void ATimeLogger::BeginPlay()
 {
     Super::BeginPlay();
+}
 
-    // 1 minute worth of data at 200 FPS
-    RealTimeHistory.Reserve(1000);
-    SimTimeHistory.Reserve(1000);
+void ATimeLogger::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    DumpData();
+    Super::EndPlay(EndPlayReason);
 }
 
 // Called every frame
@@ -24,15 +29,16 @@ void ATimeLogger::Tick(float DeltaTime)
 {
     Super::Tick(DeltaTime);
 
-    FDateTime CurrentRealTime = FDateTime::Now();
+    if (!Recorder.IsRecording())
+    {
+        return;
+    }
+
     UWorld* world = GetWorld();
-    float CurrentRealTime_s =
-        CurrentRealTime.GetMinute() * 60.f + CurrentRealTime.GetSecond() + CurrentRealTime.GetMillisecond() * .001f;
-    float CurrentSimTime = UGameplayStatics::GetRealTimeSeconds(world);    // clock
-    RealTimeHistory.Add(FString::SanitizeFloat(CurrentRealTime_s));
-    SimTimeHistory.Add(FString::SanitizeFloat(CurrentSimTime));
+    const double CurrentSimTime = world->GetTimeSeconds();
+    Recorder.Record(CurrentSimTime, FPlatformTime::ToSeconds(GGameThreadTime));
 
-    if (CurrentSimTime - StartSimTime >= MaxTime)
+    if ((MaxTime > 0.f) && (CurrentSimTime - StartSimTime >= MaxTime))
     {
         DumpData();
         UKismetSystemLibrary::QuitGame(world, nullptr, EQuitPreference::Quit, true);
@@ -41,16 +47,15 @@ void ATimeLogger::Tick(float DeltaTime)
 
 void ATimeLogger::StartTimer()
 {
-    StartSimTime = UGameplayStatics::GetRealTimeSeconds(GetWorld());
+    StartSimTime = GetWorld()->GetTimeSeconds();
     StartRealTime = FDateTime::Now();
+    const FString filePath =
+        FilePath.IsEmpty() ? FPaths::Combine(FPaths::ProjectSavedDir(), bCsv ? TEXT("TimeLog.csv") : TEXT("TimeLog.bin"))
+                           : FilePath;
+    Recorder.Start(filePath, bCsv, static_cast<uint32>(FMath::Max(RecordsBufferSize, 1)));
 }
 
 void ATimeLogger::DumpData()
 {
-    FString Directory = FPaths::ProjectContentDir();
-    FString TargetFile_RealTime = Directory + "/RealTime_UE4";
-    FString TargetFile_SimTime = Directory + "/SimTime_UE4";
-
-    FFileHelper::SaveStringArrayToFile(RealTimeHistory, *TargetFile_RealTime);
-    FFileHelper::SaveStringArrayToFile(SimTimeHistory, *TargetFile_SimTime);
+    Recorder.Finish();
 }
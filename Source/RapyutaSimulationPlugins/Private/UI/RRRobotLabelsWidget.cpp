@@ -0,0 +1,161 @@
+// Copyright 2020-2023 Rapyuta Robotics Co., Ltd.
+#include "UI/RRRobotLabelsWidget.h"
+
+// UE
+#include "Blueprint/WidgetLayoutLibrary.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "Rendering/DrawElements.h"
+#include "Styling/CoreStyle.h"
+
+TMap<const UWorld*, TWeakObjectPtr<URRRobotLabelsWidget>> URRRobotLabelsWidget::SWidgets;
+
+URRRobotLabelsWidget* URRRobotLabelsWidget::Get(UWorld* InWorld)
+{
+    check(IsInGameThread());
+    TWeakObjectPtr<URRRobotLabelsWidget>& widget = SWidgets.FindOrAdd(InWorld);
+    if (widget.IsValid())
+    {
+        return widget.Get();
+    }
+
+    APlayerController* playerController = InWorld ? InWorld->GetFirstPlayerController() : nullptr;
+    if ((nullptr == playerController) || !playerController->IsLocalController())
+    {
+        SWidgets.Remove(InWorld);
+        return nullptr;
+    }
+    widget =
+        CreateWidget<URRRobotLabelsWidget>(playerController, URRRobotLabelsWidget::StaticClass(), TEXT("RRRobotLabelsWidget"));
+    widget->AddToViewport();
+    return widget.Get();
+}
+
+void URRRobotLabelsWidget::NativeConstruct()
+{
+    Super::NativeConstruct();
+    // Overlay only, never taking the inputs of the view
+    SetVisibility(ESlateVisibility::HitTestInvisible);
+    if (!Font.HasValidFont())
+    {
+        Font = FCoreStyle::GetDefaultFontStyle("Regular", 12);
+    }
+}
+
+void URRRobotLabelsWidget::AddLabel(AActor* InActor, const FString& InText, const FVector& InOffset)
+{
+    FLabel& label = Labels.FindOrAdd(InActor);
+    label.Text = InText;
+    label.Offset = InOffset;
+    bLabelsDirty = true;
+}
+
+void URRRobotLabelsWidget::RemoveLabel(AActor* InActor)
+{
+    if (Labels.Remove(InActor) > 0)
+    {
+        bLabelsDirty = true;
+    }
+}
+
+void URRRobotLabelsWidget::SetLabelText(AActor* InActor, const FString& InText)
+{
+    if (FLabel* label = Labels.Find(InActor))
+    {
+        label->Text = InText;
+    }
+}
+
+void URRRobotLabelsWidget::SetLabelVisible(AActor* InActor, const bool bInVisible)
+{
+    FLabel* label = Labels.Find(InActor);
+    if (label && (label->bVisible != bInVisible))
+    {
+        label->bVisible = bInVisible;
+        bLabelsDirty = true;
+    }
+}
+
+void URRRobotLabelsWidget::UpdateDrawnLabels(const FGeometry& InGeometry) const
+{
+    DrawnLabels.Reset();
+    APlayerController* playerController = GetOwningPlayer();
+    if (nullptr == playerController)
+    {
+        return;
+    }
+
+    FVector viewLocation;
+    FRotator viewRotation;
+    playerController->GetPlayerViewPoint(viewLocation, viewRotation);
+    const double maxDistanceSquared =
+        (MaxLabelDistance > 0.f) ? FMath::Square(static_cast<double>(MaxLabelDistance)) : TNumericLimits<double>::Max();
+    const FVector2D widgetSize = InGeometry.GetLocalSize();
+    for (const auto& label : Labels)
+    {
+        const AActor* actor = label.Key.Get();
+        if ((nullptr == actor) || !label.Value.bVisible || actor->IsHidden())
+        {
+            continue;
+        }
+        const FVector labelLocation = actor->GetActorLocation() + label.Value.Offset;
+        const double distanceSquared = FVector::DistSquared(labelLocation, viewLocation);
+        if (distanceSquared > maxDistanceSquared)
+        {
+            continue;
+        }
+
+        // Fails behind the view
+        FVector2D position;
+        if (!UWidgetLayoutLibrary::ProjectWorldLocationToWidgetPosition(playerController, labelLocation, position, true) ||
+            (position.X < 0.f) || (position.Y < 0.f) || (position.X > widgetSize.X) || (position.Y > widgetSize.Y))
+        {
+            continue;
+        }
+        FDrawnLabel& drawnLabel = DrawnLabels.AddDefaulted_GetRef();
+        drawnLabel.Text = &label.Value.Text;
+        drawnLabel.Position = position;
+        drawnLabel.DistanceSquared = distanceSquared;
+    }
+
+    if ((MaxLabelsNum > 0) && (DrawnLabels.Num() > MaxLabelsNum))
+    {
+        DrawnLabels.Sort([](const FDrawnLabel& InA, const FDrawnLabel& InB)
+                         { return InA.DistanceSquared < InB.DistanceSquared; });
+        DrawnLabels.SetNum(MaxLabelsNum, false);
+    }
+}
+
+int32 URRRobotLabelsWidget::NativePaint(const FPaintArgs& Args,
+                                        const FGeometry& AllottedGeometry,
+                                        const FSlateRect& MyCullingRect,
+                                        FSlateWindowElementList& OutDrawElements,
+                                        int32 LayerId,
+                                        const FWidgetStyle& InWidgetStyle,
+                                        bool bParentEnabled) const
+{
+    LayerId = Super::NativePaint(Args, AllottedGeometry, MyCullingRect, OutDrawElements, LayerId, InWidgetStyle, bParentEnabled);
+
+    const UWorld* world = GetWorld();
+    const double now = world ? world->GetRealTimeSeconds() : 0.;
+    if (bLabelsDirty || (LastUpdateTime < 0.) || (now - LastUpdateTime >= UpdateInterval))
+    {
+        UpdateDrawnLabels(AllottedGeometry);
+        LastUpdateTime = now;
+        bLabelsDirty = false;
+    }
+
+    ++LayerId;
+    for (const FDrawnLabel& drawnLabel : DrawnLabels)
+    {
+        const FSlateLayoutTransform labelTransform(drawnLabel.Position);
+        FSlateDrawElement::MakeText(OutDrawElements,
+                                    LayerId,
+                                    AllottedGeometry.ToPaintGeometry(FVector2D::UnitVector, labelTransform),
+                                    *drawnLabel.Text,
+                                    Font,
+                                    ESlateDrawEffect::None,
+                                    Color);
+    }
+    return LayerId;
+}
@@ -469,6 +469,35 @@ struct RAPYUTASIMULATIONPLUGINS_API FRRColorArray
     }
 };
 
+/**
+ * @brief Automatic LOD generation of meshes loaded at runtime, by #FRRMeshSimplifier at import time.
+ * Configurable per robot model, also by URDF <ue> tags ue_mesh_lod_screen_sizes & ue_mesh_lod_triangles_ratio.
+ */
+USTRUCT(BlueprintType)
+struct RAPYUTASIMULATIONPLUGINS_API FRRMeshLODSettings
+{
+    GENERATED_BODY()
+
+    //! Screen sizes from which LOD1, LOD2, etc. are used, in decreasing order. Empty for a single LOD.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<float> ScreenSizes;
+
+    //! Triangles num ratio of each LOD to its previous one
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.01", ClampMax = "1.0"))
+    float TrianglesRatio = 0.5f;
+
+    bool IsEnabled() const
+    {
+        return ScreenSizes.Num() > 0;
+    }
+
+    //! Including LOD0, bounded by MAX_STATIC_MESH_LODS
+    int32 GetLODsNum() const
+    {
+        return FMath::Min(1 + ScreenSizes.Num(), 8);
+    }
+};
+
 USTRUCT()
 struct RAPYUTASIMULATIONPLUGINS_API FRRActorSpawnInfo
 {
@@ -531,6 +560,10 @@ struct RAPYUTASIMULATIONPLUGINS_API FRRActorSpawnInfo
     UPROPERTY()
     TArray<FString> MaterialNameList;
 
+    //! LODs generated for the static meshes created from #MeshUniqueNameList
+    UPROPERTY()
+    FRRMeshLODSettings MeshLODSettings;
+
     UPROPERTY()
     uint8 bIsTickEnabled : 1;
 
@@ -563,6 +596,56 @@ struct RAPYUTASIMULATIONPLUGINS_API FRRActorSpawnInfo
     }
 };
 
+/**
+ * @brief Allocator of unique segmentation mask ids within a scene instance, O(1) per allocation & release:
+ * released ids are reused from a free list before any new one is taken from the counter.
+ * Ids are in [1, MaxId], 0 being #URRActorCommon::DEFAULT_CUSTOM_DEPTH_STENCIL_VALUE_VOID.
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRSegMaskIdAllocator
+{
+    //! Max id in instance id mode, ids being stored in float custom primitive data, exact up to 2^24
+    static constexpr int32 MAX_INSTANCE_ID = (1 << 24) - 1;
+
+    /**
+     * @brief Set the id range, reserved ids being skipped by the counter, then #Reset()
+     * @param InMaxId Ids beyond it are still allocated, yet with an error as duplicating ones in the rendered masks
+     * @param InReservedIds Eg #URRActorCommon::StaticCustomDepthStencilList, must outlive this allocator
+     */
+    void Initialize(const int32 InMaxId, const TArray<int32>* InReservedIds);
+
+    bool IsInitialized() const
+    {
+        return (MaxId > 0);
+    }
+
+    int32 Allocate();
+
+    //! Ids not currently allocated by this allocator, eg set explicitly, are ignored
+    void Release(const int32 InId);
+
+    //! Make all ids available again, eg upon scene reset
+    void Reset();
+
+    int32 GetMaxId() const
+    {
+        return MaxId;
+    }
+
+    int32 GetAllocatedNum() const
+    {
+        return AllocatedNum;
+    }
+
+private:
+    int32 MaxId = 0;
+    int32 LatestId = 0;
+    int32 AllocatedNum = 0;
+    const TArray<int32>* ReservedIds = nullptr;
+    TArray<int32> FreeIds;
+    //! Indexed by id, up to #LatestId
+    TBitArray<> AllocatedFlags;
+};
+
 DECLARE_DELEGATE_TwoParams(FOnMeshActorFullyCreated, bool /* bCreationResult */, ARRMeshActor*);
 
 /**
@@ -629,6 +712,16 @@ public:
     UPROPERTY()
     FVector SceneInstanceLocation = FVector::ZeroVector;
 
+    //! ROS namespace prefixed to the robots' of the scene instance, eg those of a forked episode, empty for none
+    UPROPERTY()
+    FString SceneROSNamespace;
+
+    //! InNamespace under #SceneROSNamespace
+    FString GetSceneROSNamespace(const FString& InNamespace) const
+    {
+        return SceneROSNamespace.IsEmpty() ? InNamespace : FString::Printf(TEXT("%s/%s"), *SceneROSNamespace, *InNamespace);
+    }
+
     //! Generate a new scene id
     //! Each scene is assigned with a unique id, regardless of which scene instance it belongs
     static uint64 SLatestSceneId;
@@ -691,7 +784,9 @@ public:
     // + Since deactivated actors do not appear in scene so their custom depth stencil values should be reused
     // for activated ones in any scene instance.
     // + Also, actors of different scene instances, due to always appearing in different scenes, could share the same value,
-    // thus each scene instance must have its own [LatestCustomDepthStencilValue]
+    // thus each scene instance must have its own [SegMaskIdAllocator]
+    // + To go beyond the stencil range, rr.SegMask.InstanceIds switches to 24-bit instance ids in custom primitive data,
+    // eg with 255 labelled objects or more, segmenting them all in a single pass, see URRUObjectUtils::SetSegMaskId()
 
     // Temp as No of non-zero elements in [DATA_SYNTH_CUSTOM_DEPTH_STENCILS], due to UE5 segmask mismatch issue
     static constexpr int16 MAX_CUSTOM_DEPTH_STENCIL_VALUES_NUM = 76;
@@ -701,29 +796,19 @@ public:
     //! Example: Bucket's (DropPlatform is also a static object but its custom depth render is disabled due to not being segmasked)
     static TArray<int32> StaticCustomDepthStencilList;
 
-    UPROPERTY()
-    int32 LatestCustomDepthStencilValue = 0;
+    //! Whether seg mask ids are 24-bit instance ids in custom primitive data, rather than custom depth stencil values
+    static bool IsSegMaskInstanceIdEnabled();
 
-    //! Generate a new unique custom depth stencil value for a mesh actor's Segmentation mask
-    int32 GenerateUniqueDepthStencilValue()
-    {
-        if (LatestCustomDepthStencilValue > MAX_CUSTOM_DEPTH_STENCIL_VALUES_NUM)
-        {
-            UE_LOG_WITH_INFO(LogTemp,
-                             Error,
-                             TEXT("SceneInstance[%d] [%d] More than %d CustomDepthStencil values having been assigned!"
-                                  "Segmentation Mask will be duplicated!"),
-                             SceneInstanceId,
-                             LatestCustomDepthStencilValue,
-                             MAX_CUSTOM_DEPTH_STENCIL_VALUES_NUM);
-        }
+    //! Seg mask ids of this scene instance's entities, either custom depth stencil values or instance ids
+    FRRSegMaskIdAllocator SegMaskIdAllocator;
 
-        // Fetch the next non-static [CustomDepthStencilValue]
-        do
-        {
-            ++LatestCustomDepthStencilValue;
-        } while (StaticCustomDepthStencilList.Contains(LatestCustomDepthStencilValue));
-        return LatestCustomDepthStencilValue;
+    //! Generate a new unique seg mask id for a mesh actor's Segmentation mask, reusing released ones first
+    int32 GenerateUniqueDepthStencilValue();
+
+    //! Make a seg mask id from #GenerateUniqueDepthStencilValue() available again, eg as its actor is deactivated
+    void ReleaseDepthStencilValue(const int32 InValue)
+    {
+        SegMaskIdAllocator.Release(InValue);
     }
 };
 
@@ -0,0 +1,76 @@
+/**
+ * @file RRAssetRegistryCache.h
+ * @brief On-disk cache of asset lists collated from the asset registry, to skip synchronous directory scanning on later runs.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+/**
+ * @brief Name & soft object path of a collated asset
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRCachedAssetInfo
+{
+    FString AssetName;
+    FString AssetPath;
+
+    friend FArchive& operator<<(FArchive& Ar, FRRCachedAssetInfo& InOutAssetInfo)
+    {
+        return Ar << InOutAssetInfo.AssetName << InOutAssetInfo.AssetPath;
+    }
+};
+
+/**
+ * @brief Cache of asset lists collated by #URRAssetUtils::LoadAssetInfoList(), under [ProjectSavedDir]/RRAssetRegistryCache.
+ * Entries are keyed by the asset class & UE path, and validated by a signature of the package files under that path
+ * (relative names, sizes & timestamps), which is cheap to compute versus an asset registry scan. On mismatch, the list
+ * is collated from the asset registry again & re-cached.
+ * Only used outside the editor, which has its own in-memory assets. Disabled by rr.AssetRegistryCache.Enabled 0.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRAssetRegistryCache
+{
+public:
+    static constexpr uint32 MAGIC = 0x52434152;    // "RACR"
+    static constexpr uint32 VERSION = 1;
+
+    static bool IsEnabled();
+
+    /**
+     * @brief Get the signature of package files under a UE path
+     * @param InAssetsPath
+     * @return FString Empty if InAssetsPath could not be mapped to a directory
+     */
+    static FString GetPackagesSignature(const FString& InAssetsPath);
+
+    /**
+     * @brief Load a cached asset list
+     * @param InClassName
+     * @param InAssetsPath
+     * @param InSignature From #GetPackagesSignature()
+     * @param OutAssetInfoList
+     * @return true if the cache file exists, is of the current #VERSION & InSignature
+     */
+    static bool Load(const FString& InClassName,
+                     const FString& InAssetsPath,
+                     const FString& InSignature,
+                     TArray<FRRCachedAssetInfo>& OutAssetInfoList);
+
+    /**
+     * @brief Save an asset list, written to a temporary file first so that concurrent sim runs never read a partial file
+     * @param InClassName
+     * @param InAssetsPath
+     * @param InSignature From #GetPackagesSignature()
+     * @param InAssetInfoList
+     * @return true if saved
+     */
+    static bool Save(const FString& InClassName,
+                     const FString& InAssetsPath,
+                     const FString& InSignature,
+                     const TArray<FRRCachedAssetInfo>& InAssetInfoList);
+
+private:
+    static FString GetCacheFilePath(const FString& InClassName, const FString& InAssetsPath);
+};
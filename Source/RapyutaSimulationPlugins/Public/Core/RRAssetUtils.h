@@ -22,11 +22,14 @@
 #endif
 
 // RapyutaSim
+#include "Core/RRAssetRegistryCache.h"
 #include "Core/RRObjectCommon.h"
 #include "RapyutaSimulationPlugins.h"
 
 #include "RRAssetUtils.generated.h"
 
+DECLARE_DELEGATE_TwoParams(FRROnPackagesSaved, int32 /*InSavedNum*/, const TArray<FString>& /*InFailedPackageNames*/);
+
 /**
  * @brief Asset utils.
  * - Save asset with [UPackage](https://docs.unrealengine.com/4.27/en-US/API/Runtime/CoreUObject/UObject/UPackage/)
@@ -240,6 +243,38 @@ public:
         verify(IsAssetDataListValid(OutAssetDataList, bIsFullLoad, true));
     }
 
+    /**
+     * @brief Get names & soft object paths of assets of type T under a UE path, from #FRRAssetRegistryCache if it is still
+     * valid for the package files there, else by #LoadAssetDataList(), then re-cached.
+     * @tparam T
+     * @param InAssetsPath
+     * @param OutAssetInfoList
+     */
+    template<typename T>
+    static void LoadAssetInfoList(const FString& InAssetsPath, TArray<FRRCachedAssetInfo>& OutAssetInfoList)
+    {
+        OutAssetInfoList.Reset();
+        const bool bUseCache = (false == GIsEditor) && FRRAssetRegistryCache::IsEnabled();
+        const FString className = T::StaticClass()->GetPathName();
+        const FString signature = bUseCache ? FRRAssetRegistryCache::GetPackagesSignature(InAssetsPath) : FString();
+        if (!signature.IsEmpty() && FRRAssetRegistryCache::Load(className, InAssetsPath, signature, OutAssetInfoList))
+        {
+            return;
+        }
+
+        TArray<FAssetData> assetDataList;
+        LoadAssetDataList<T>(InAssetsPath, assetDataList);
+        for (const auto& asset : assetDataList)
+        {
+            OutAssetInfoList.Add({asset.AssetName.ToString(), asset.ToSoftObjectPath().ToString()});
+        }
+
+        if (!signature.IsEmpty())
+        {
+            FRRAssetRegistryCache::Save(className, InAssetsPath, signature, OutAssetInfoList);
+        }
+    }
+
     /**
      * @brief
      * This must not be invoked at Sim initialization since it would flush Async loaders away!
@@ -363,6 +398,41 @@ public:
                                    bool bInAsyncSave = true,
                                    bool bInAlwaysOverwrite = false);
 
+    // BATCHED PACKAGE SAVING --
+    /**
+     * @brief Start batching package saves: until the matching #EndPackageSaveBatch(), #SavePackageToAsset() only queues the
+     * packages by #EnqueuePackageToSave(), eg those of all meshes, materials & blueprints generated by a dataset export
+     * or robots pre-baking, then saved together. Batches could be nested, the outermost one saving.
+     */
+    static void BeginPackageSaveBatch();
+
+    /**
+     * @brief End a batch started by #BeginPackageSaveBatch(), saving the queued packages by #FlushPackageSaveQueue() if it is
+     * the outermost one
+     * @param InOnSaved Called on game thread once saved, right away if an outer batch is still open
+     */
+    static void EndPackageSaveBatch(const FRROnPackagesSaved& InOnSaved = FRROnPackagesSaved());
+
+    static bool IsBatchingPackageSaves();
+
+    /**
+     * @brief Queue a package to be saved by #FlushPackageSaveQueue(), a package already queued being only queued once
+     * @param InPackage
+     * @param InObject
+     * @param bInAlwaysOverwrite
+     */
+    static void EnqueuePackageToSave(UPackage* InPackage, UObject* InObject, bool bInAlwaysOverwrite = false);
+
+    static int32 GetQueuedPackagesToSaveNum();
+
+    /**
+     * @brief Save all queued packages at once through UPackage::SaveConcurrent(), serializing them in parallel, while their
+     * files are written asynchronously, then waited for on a worker thread instead of the game thread
+     * @param InOnSaved Called on game thread once all files are written
+     * @return int32 Num of packages whose saving started
+     */
+    static int32 FlushPackageSaveQueue(const FRROnPackagesSaved& InOnSaved = FRROnPackagesSaved());
+
     /**
      * @brief Find generated UClass from blueprint class name
      * @param InBlueprintClassName
@@ -7,6 +7,7 @@
 #pragma once
 
 // std
+#include <atomic>
 #include <mutex>
 
 // UE
@@ -34,13 +35,14 @@ class RAPYUTASIMULATIONPLUGINS_API ARRBaseActor : public APawn
     GENERATED_BODY()
 public:
     /**
-     * @brief
-     * [std::once_flag] also applies even in case of consecutive PIE runs,
+     * @brief Whether #PrintSimConfig() & #DoGlobalConfig() have run for this class, only set on its CDO by #Initialize(),
+     * thus once per class for class having multiple-branch child classes (multiple-branch inheritance tree).
+     * Read without lock, so that actors of a configured class, eg batch spawned from worker threads, initialize cheaply.
+     * Like [std::once_flag], this also applies even in case of consecutive PIE runs,
      * thus if running in PIE and the called function is required to run again each time (though still once per PIE) then,
-     * another (context-specific) method (without using [static res]) should be considered!
-     * Used for class having multiple-branch child classes (multiple-branch inheritance tree)
+     * another (context-specific) method should be considered!
      */
-    static TMap<UClass*, TUniquePtr<std::once_flag>> OnceFlagList;
+    std::atomic<bool> bGloballyConfigured = false;
 
     //! Used for class having single-branch child classes (linear inheritance tree)
     static std::once_flag OnceFlag;
@@ -0,0 +1,59 @@
+/**
+ * @file RRBoneTransformsCache.h
+ * @brief Per-frame cache of skeletal mesh bone-space transforms, shared by all their consumers.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+class USkeletalMeshComponent;
+
+/**
+ * @brief Bone-space (ie parent-relative) transforms of a skeletal mesh, read once per frame.
+ * Bone names & parent indices are read once, upon the first fetching.
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRBoneTransforms
+{
+    TArray<FName> BoneNames;
+
+    //! INDEX_NONE for the root bone
+    TArray<int32> ParentIndices;
+
+    TArray<FTransform> BoneSpaceTransforms;
+
+    //! GFrameCounter of #BoneSpaceTransforms
+    uint64 Frame = 0;
+};
+
+/**
+ * @brief Game-thread cache of #FRRBoneTransforms by skeletal mesh component, so that TF, joint states & visualization
+ * consumers of the same mesh in a frame share a single GetBoneSpaceTransforms() read.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRBoneTransformsCache
+{
+public:
+    /**
+     * @brief Get the bone transforms of InSkeletalMesh in the current frame, reading them if not yet read this frame
+     *
+     * @param InSkeletalMesh
+     * @return const FRRBoneTransforms&
+     */
+    static const FRRBoneTransforms& Get(USkeletalMeshComponent* InSkeletalMesh);
+
+    /**
+     * @brief Get the GFrameCounter of the latest #Get() of InSkeletalMesh, eg for its bones to be kept evaluated
+     *
+     * @param InSkeletalMesh
+     * @return uint64 0 if never read
+     */
+    static uint64 GetReadFrame(const USkeletalMeshComponent* InSkeletalMesh);
+
+private:
+    static TMap<TWeakObjectPtr<USkeletalMeshComponent>, FRRBoneTransforms> SBoneTransforms;
+
+    //! GFrameCounter upon the latest removal of the destroyed components' entries
+    static uint64 SLastCleanupFrame;
+};
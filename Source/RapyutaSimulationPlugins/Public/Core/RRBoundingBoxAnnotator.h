@@ -0,0 +1,104 @@
+/**
+ * @file RRBoundingBoxAnnotator.h
+ * @brief Batched 3D & 2D bounding box annotation of scene entities, for dataset generation.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+#include "UObject/ObjectKey.h"
+
+/**
+ * @brief Pinhole view of a capturing camera, UE camera frame being X forward, Y right & Z up
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRAnnotationView
+{
+    FTransform Transform = FTransform::Identity;
+
+    //! Horizontal field of view, in degrees
+    float FOVAngle = 90.f;
+
+    FIntPoint ImageSize = FIntPoint(640, 480);
+
+    //! Vertices nearer along the view direction are not projected, in cm
+    float NearClipPlane = 1.f;
+};
+
+/**
+ * @brief Annotation of one entity: its oriented bounding box, in the same layout as
+ * #URRUObjectUtils::GetActorCenterAndBoundingBoxVertices(), and its projection onto the image
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRBoundingBoxAnnotation
+{
+    TWeakObjectPtr<AActor> Actor;
+
+    //! [0]: center, [1-8]: vertices, in the base actor frame or world frame
+    FVector CenterAndVertices3D[9];
+
+    //! Image-space box of the in front vertices, clamped to the image, in pixels
+    FBox2D ImageBox = FBox2D(ForceInit);
+
+    //! Whether the box is in front of the camera & overlaps the image
+    bool bVisible = false;
+};
+
+/**
+ * @brief Annotates all entities of a scene instance at once per captured frame: local-space bounds are cached per actor,
+ * while boxes & their projections are computed in a ParallelFor over flat arrays of transforms gathered on the game thread.
+ * Cached bounds are invalidated by #InvalidateLocalBounds(), which mesh components call upon mesh creation & resize.
+ * Game thread only.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRBoundingBoxAnnotator
+{
+public:
+    //! Boxes per parallel task
+    static constexpr int32 BATCH_SIZE = 64;
+
+    /**
+     * @brief Mark the cached local bounds of an actor as stale, in all annotators
+     * @param InActor
+     */
+    static void InvalidateLocalBounds(const AActor* InActor);
+
+    /**
+     * @brief Compute the boxes of InActors & their projections in InView
+     * @param InActors Invalid & hidden ones are skipped
+     * @param InBaseActor Frame of the 3D boxes, world frame if null
+     * @param InView
+     * @param OutAnnotations One per annotated actor, visible or not
+     * @param bInIncludeNonColliding
+     */
+    void Annotate(const TArray<AActor*>& InActors,
+                  const AActor* InBaseActor,
+                  const FRRAnnotationView& InView,
+                  TArray<FRRBoundingBoxAnnotation>& OutAnnotations,
+                  bool bInIncludeNonColliding = true);
+
+    /**
+     * @brief Format annotations as text, one line per visible actor: its name, the 9 points of its 3D box & its image box
+     * (min x, min y, max x, max y)
+     * @param InAnnotations
+     * @return FString
+     */
+    static FString ToText(const TArray<FRRBoundingBoxAnnotation>& InAnnotations);
+
+    void Reset()
+    {
+        LocalBoundsCache.Reset();
+    }
+
+private:
+    struct FCachedLocalBounds
+    {
+        FVector Center = FVector::ZeroVector;
+        FVector Extent = FVector::ZeroVector;
+        uint32 Generation = 0;
+        bool bIncludeNonColliding = true;
+    };
+    TMap<FObjectKey, FCachedLocalBounds> LocalBoundsCache;
+
+    //! Bumped per actor by #InvalidateLocalBounds()
+    static TMap<FObjectKey, uint32> LocalBoundsGenerations;
+};
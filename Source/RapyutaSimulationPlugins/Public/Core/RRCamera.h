@@ -100,6 +100,20 @@ public:
     void RandomizeFoV();
     void RandomizePose(const FVector& InBaseLocation, bool bIsRandomLocationOnly);
 
+    /**
+     * @brief Randomize many cameras' FoVs & poses around a base location, like #RandomizeFoV() & #RandomizePose().
+     * Each camera is sampled in parallel from its own #URRMathUtils::GetRandomSubstream() of InSeed & its index in InCameras,
+     * thus reproducibly, all samples then being applied in the game thread.
+     * @param InCameras
+     * @param InBaseLocation
+     * @param bIsRandomLocationOnly
+     * @param InSeed
+     */
+    static void RandomizeCameras(const TArray<ARRCamera*>& InCameras,
+                                 const FVector& InBaseLocation,
+                                 bool bIsRandomLocationOnly,
+                                 const int32 InSeed);
+
     float GetDistanceToFloor() const;
     template<typename T>
     float GetDistanceToActorsGroup(const TArray<T*>& InActors) const
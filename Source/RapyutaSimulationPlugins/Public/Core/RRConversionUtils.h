@@ -21,6 +21,9 @@
 
 #include "RRConversionUtils.generated.h"
 
+class UWorld;
+struct FRRRefFrame;
+
 UCLASS()
 class URRConversionUtils : public UBlueprintFunctionLibrary
 {
@@ -228,19 +231,65 @@ public:
                           URRConversionUtils::VectorROSToUE(InROSPose.Position));
     }
 
+    // Batch UE to ROS conversions, in one pass over contiguous arrays. Outputs must have the inputs' size & may alias them
+
+    //! #VectorUEToROS of each vector
+    static void VectorsUEToROS(TArrayView<const FVector> InVectors, TArrayView<FVector> OutVectors);
+
+    //! #TransformUEToROS of each transform
+    static void TransformsUEToROS(TArrayView<const FTransform> InTransforms, TArrayView<FTransform> OutTransforms);
+
+    /**
+     * @brief Fused #URRGeneralUtils::GetRelativeTransform(InRefTransf, each) & #TransformUEToROS, the reference's inverse
+     * rotation & scale being computed once for all
+     * @param InRefTransf Reference frame, in UE world frame
+     * @param InWorldTransforms In UE world frame
+     * @param OutTransforms In ROS reference frame
+     */
+    static void RelativeTransformsUEToROS(const FTransform& InRefTransf,
+                                          TArrayView<const FTransform> InWorldTransforms,
+                                          TArrayView<FTransform> OutTransforms);
+
+    //! #RelativeTransformsUEToROS to an already computed frame, eg #URRGeneralUtils::GetCachedRefFrame
+    static void RelativeTransformsUEToROS(const FRRRefFrame& InRefFrame,
+                                          TArrayView<const FTransform> InWorldTransforms,
+                                          TArrayView<FTransform> OutTransforms);
+
     // time to ROS stamp
     UFUNCTION(BlueprintCallable, Category = "Conversion")
-    static FROSTime FloatToROSStamp(const float InTimeSec)
+    static FROSTime FloatToROSStamp(const double InTimeSec)
+    {
+        return NanosecToROSStamp(FMath::RoundToInt64(InTimeSec * 1e+09));
+    }
+
+    //! Exact conversion of a time in integer nanoseconds
+    UFUNCTION(BlueprintCallable, Category = "Conversion")
+    static FROSTime NanosecToROSStamp(const int64 InTimeNanosec)
     {
         FROSTime stamp;
-        stamp.Sec = static_cast<int32>(InTimeSec);
-        stamp.Nanosec = uint32((InTimeSec - stamp.Sec) * 1e+09f);
+        stamp.Sec = static_cast<int32>(InTimeNanosec / 1000000000LL);
+        stamp.Nanosec = static_cast<uint32>(InTimeNanosec % 1000000000LL);
         return stamp;
     }
 
+    /**
+     * @brief Get the sim time in nanoseconds, synced with the server's in clients, see #ARRNetworkGameState
+     * @param InContextObject
+     * @return int64
+     */
+    static int64 GetSimTimeNanosec(const UObject* InContextObject);
+
+    /**
+     * @brief Get a world's local time in nanoseconds, accumulated from the fixed steps of
+     * #URRLimitRTFFixedSizeCustomTimeStep if in use, else rounded from its floating-point time.
+     * @param InWorld
+     * @return int64
+     */
+    static int64 GetWorldTimeNanosec(const UWorld* InWorld);
+
     static FROSTime GetCurrentROS2Time(const UObject* InContextObject)
     {
-        return FloatToROSStamp(UGameplayStatics::GetTimeSeconds(InContextObject->GetWorld()));
+        return NanosecToROSStamp(GetSimTimeNanosec(InContextObject));
     }
 
     static float ROSStampToFloat(const FROSTime& InTimeStamp)
@@ -0,0 +1,53 @@
+/**
+ * @file RRConvexDecomposition.h
+ * @brief Runtime approximate convex decomposition of meshes loaded at runtime, for their simple collision outside the editor.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+/**
+ * @brief Settings of #FRRConvexDecomposition, also keying its cached hulls by #ToString()
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRConvexDecompositionSettings
+{
+    //! Max number of convex hulls
+    int32 MaxHullsNum = 16;
+
+    //! Voxels num along the longest bounding box axis
+    int32 Resolution = 32;
+
+    //! Max ratio of a part's concave volume to its hull volume, for it not to be split
+    float MaxConcavity = 0.05f;
+
+    FString ToString() const
+    {
+        return FString::Printf(TEXT("%d_%d_%g"), MaxHullsNum, Resolution, MaxConcavity);
+    }
+};
+
+/**
+ * @brief Voxel-based approximate convex decomposition, after V-HACD: the mesh is voxelized & solid-filled, then parts are
+ * recursively split by the axis-aligned plane minimizing their concave volume, ie hull volume minus voxels volume, until
+ * each part is convex enough or MaxHullsNum is reached. Split candidates are evaluated on worker threads.
+ * Hulls are conservative by up to a voxel, wrapping their voxels' corners.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRConvexDecomposition
+{
+public:
+    /**
+     * @brief Decompose a triangle mesh into convex hulls, each as its vertices
+     * @param InVertices
+     * @param InIndices
+     * @param InSettings
+     * @param OutHulls
+     * @return true if at least a hull has been generated
+     */
+    static bool Decompose(const TArray<FVector3f>& InVertices,
+                          const TArray<uint32>& InIndices,
+                          const FRRConvexDecompositionSettings& InSettings,
+                          TArray<TArray<FVector3f>>& OutHulls);
+};
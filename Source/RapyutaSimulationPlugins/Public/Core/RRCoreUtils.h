@@ -332,6 +332,22 @@ public:
 
     static bool IsSimProfiling();
 
+    /**
+     * @brief Whether the sim runs in headless sensor-only mode, from -RRHeadless or rr.HeadlessSensorMode, where the main view
+     * is not rendered & lidar rays, on-screen messages and robot UI widgets are disabled.
+     * Sensor scene captures are still rendered since they are captured explicitly by CaptureScene(), not by the main view.
+     */
+    static bool IsHeadlessSensorMode();
+
+    /**
+     * @brief Disable the main view rendering & on-screen messages of InContextObject's game if #IsHeadlessSensorMode(),
+     * logging all features disabled by the mode.
+     *
+     * @param InContextObject
+     * @return TArray<FString> Names of the disabled features, empty if not headless
+     */
+    static TArray<FString> ApplyHeadlessSensorMode(const UObject* InContextObject);
+
     // GameState & PlayerController should be able to be recognized polymorphically!
 
     /**
@@ -602,19 +618,60 @@ public:
         return loadedTexture;
     }
 
+    /**
+     * @brief Decode an LDR image file, thread-safe given #LoadImageWrapperModule() having been called.
+     * Each call uses its own image wrapper, as wrappers hold their decoding state.
+     * @param InImagePath
+     * @param bInCompressed Whether to BC1-compress it, opaque, if its size is a multiple of 4
+     * @param OutImage
+     * @return false if not loaded, not decodable or of HDR formats, which are left to #LoadImageToTexture()
+     */
+    static bool DecodeImageFile(const FString& InImagePath, const bool bInCompressed, FRRDecodedImage& OutImage);
+
+    //! Create a transient texture of a decoded image, its mip being uploaded without blocking the game thread
+    static UTexture2D* CreateImageTexture(const FRRDecodedImage& InImage, const FString& InTextureName);
+
+    /**
+     * @brief Upload a decoded image into an existing texture of the same size & pixel format, recycling its GPU resource
+     * @param InTexture
+     * @param InImage Its data is moved out to be released once uploaded by the render thread
+     * @return false if InTexture mismatches InImage
+     */
+    static bool UpdateImageTexture(UTexture2D* InTexture, FRRDecodedImage&& InImage);
+
+    /**
+     * @brief Load images under a folder into textures, LDR ones being decoded in parallel on worker threads
+     * @param InImageFolderPath
+     * @param InImageFileTypes
+     * @param OutImageTextureList
+     * @param bIsLogged
+     * @param bInCompressed Whether LDR images, of sizes being multiples of 4, are BC1-compressed, opaque
+     * @return true if all images have been loaded
+     */
     static bool LoadImagesFromFolder(const FString& InImageFolderPath,
                                      const TArray<ERRFileType>& InImageFileTypes,
                                      TArray<UTexture*>& OutImageTextureList,
-                                     bool bIsLogged = false);
+                                     bool bIsLogged = false,
+                                     bool bInCompressed = false);
+
+    /**
+     * @brief Parse an IES file into light profile texels, reusing #FRRLightProfileCache. Thread-safe.
+     * @param InFullFilePath
+     * @param OutData
+     * @return true if parsed
+     */
+    static bool ParseIESProfile(const FString& InFullFilePath, FRRLightProfileData& OutData);
+
+    //! Create a light profile texture of parsed data, which is moved out to be uploaded by the render thread
+    static UTextureLightProfile* CreateIESProfile(FRRLightProfileData&& InData, const FString& InLightProfileName);
 
-    static FRRLightProfileData SLightProfileData;
     static UTextureLightProfile* LoadIESProfile(const FString& InFullFilePath, const FString& InLightProfileName);
+
+    //! Load all IES files under a folder into light profiles, parsing them on worker threads
     static bool LoadIESProfilesFromFolder(const FString& InFolderPath,
                                           TArray<UTextureLightProfile*>& OutLightProfileList,
                                           bool bIsLogged = false);
 
-    static TFunction<void(uint8*, const FUpdateTextureRegion2D*)> CleanupLightProfileData;
-
     static bool IsValidBitDepth(int32 InBitDepth)
     {
         return (URRActorCommon::IMAGE_BIT_DEPTH_INT8 == InBitDepth) || (URRActorCommon::IMAGE_BIT_DEPTH_FLOAT16 == InBitDepth) ||
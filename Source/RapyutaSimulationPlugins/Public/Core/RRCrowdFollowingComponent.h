@@ -37,7 +37,35 @@ public:
         return IsIdle();
     }
 
+    //! Switch to the far LOD by #FRRCrowdLODManager when farther than #LODDistance from any robot, sensor or player view
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bLODEnabled = false;
+
+    //! [cm]
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float LODDistance = 3000.f;
+
+    //! [s] Tick interval of this component & the movement component at the far LOD
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float LODFarTickInterval = 0.2f;
+
+    /**
+     * @brief Switch between full fidelity & the far LOD, which ticks every #LODFarTickInterval, steers crowd agents by
+     * low quality avoidance without separation nor topology optimization, and moves without sweeping if the movement
+     * component is a #URRFloatingMovementComponent.
+     * @param bInFarLOD
+     */
+    void SetFarLOD(const bool bInFarLOD);
+
+    bool IsFarLOD() const
+    {
+        return bFarLOD;
+    }
+
 protected:
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
     virtual void FollowPathSegment(float InDeltaTime) override;
 
     virtual void ApplyCrowdAgentVelocity(const FVector& InNewVelocity,
@@ -45,4 +73,12 @@ protected:
                                          bool bInTraversingLink,
                                          bool bInNearEndOfPath) override;
     virtual void OnPathFinished(const FPathFollowingResult& InResult) override;
+
+private:
+    bool bFarLOD = false;
+
+    //! Full fidelity crowd settings, restored when leaving the far LOD
+    TEnumAsByte<ECrowdAvoidanceQuality::Type> NearAvoidanceQuality = ECrowdAvoidanceQuality::Good;
+    bool bNearSeparation = false;
+    bool bNearOptimizeTopology = false;
 };
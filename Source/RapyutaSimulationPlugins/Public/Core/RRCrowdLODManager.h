@@ -0,0 +1,117 @@
+/**
+ * @file RRCrowdLODManager.h
+ * @brief Per-world crowd level of detail, updating crowd agents far from any robot, sensor or player view at lower fidelity.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// Native
+#include <mutex>
+
+// UE
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+
+#include "RRCrowdLODManager.generated.h"
+
+class FRRCrowdLODManager;
+class URRCrowdFollowingComponent;
+class USceneComponent;
+class UWorld;
+
+/**
+ * @brief Tick function of a world's #FRRCrowdLODManager, run every rr.CrowdLOD.UpdateInterval seconds
+ */
+USTRUCT()
+struct RAPYUTASIMULATIONPLUGINS_API FRRCrowdLODTickFunction : public FTickFunction
+{
+    GENERATED_BODY()
+
+    FRRCrowdLODManager* Manager = nullptr;
+
+    virtual void ExecuteTick(float DeltaTime,
+                             ELevelTick TickType,
+                             ENamedThreads::Type CurrentThread,
+                             const FGraphEventRef& MyCompletionGraphEvent) override;
+
+    virtual FString DiagnosticMessage() override
+    {
+        return TEXT("FRRCrowdLODTickFunction");
+    }
+};
+
+template<>
+struct TStructOpsTypeTraits<FRRCrowdLODTickFunction> : public TStructOpsTypeTraitsBase2<FRRCrowdLODTickFunction>
+{
+    enum
+    {
+        WithCopy = false
+    };
+};
+
+/**
+ * @brief Per-world crowd LOD manager of #URRCrowdFollowingComponent with bLODEnabled on.
+ * Viewers are all robots (thus their sensors), player view points & the scene components added by #AddViewer, eg
+ * standalone cameras. Each update, the distance of every agent to its nearest viewer is computed in a ParallelFor, then
+ * agents farther than their #URRCrowdFollowingComponent::LODDistance are switched to the far LOD, and back to full fidelity
+ * once nearer than 90% of it, by #URRCrowdFollowingComponent::SetFarLOD on game thread.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRCrowdLODManager
+{
+public:
+    ~FRRCrowdLODManager();
+
+    /**
+     * @brief Get the manager of a world, creating it upon the first fetching
+     *
+     * @param InWorld
+     * @return FRRCrowdLODManager&
+     */
+    static FRRCrowdLODManager& Get(UWorld* InWorld);
+
+    //! Start switching an agent's LOD, starting at full fidelity
+    void AddAgent(URRCrowdFollowingComponent* InAgent);
+
+    //! Stop switching an agent's LOD, restoring its full fidelity
+    void RemoveAgent(URRCrowdFollowingComponent* InAgent);
+
+    //! Add a scene component near which agents are at full fidelity, besides robots & player view points
+    void AddViewer(USceneComponent* InViewer);
+
+    void RemoveViewer(USceneComponent* InViewer);
+
+    //! Update all agents' LOD from their distance to the viewers
+    void Update();
+
+    int32 GetAgentsNum() const
+    {
+        return Agents.Num();
+    }
+
+    //! Agents at the far LOD upon the last #Update
+    int32 GetFarAgentsNum() const
+    {
+        return LastFarAgentsNum;
+    }
+
+private:
+    static TMap<UWorld*, TUniquePtr<FRRCrowdLODManager>> SManagers;
+    static std::once_flag OnceFlag;
+
+    static void OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/);
+
+    void GatherViewerLocations(UWorld* InWorld);
+
+    TWeakObjectPtr<UWorld> World;
+    FRRCrowdLODTickFunction TickFunction;
+    TArray<TWeakObjectPtr<URRCrowdFollowingComponent>> Agents;
+    TArray<TWeakObjectPtr<USceneComponent>> Viewers;
+
+    // Reused across updates
+    TArray<FVector> ViewerLocations;
+    TArray<FVector> AgentLocations;
+    TArray<double> AgentDistancesSquared;
+
+    int32 LastFarAgentsNum = 0;
+};
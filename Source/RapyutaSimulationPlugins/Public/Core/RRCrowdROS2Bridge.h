@@ -0,0 +1,103 @@
+/**
+ * @file RRCrowdROS2Bridge.h
+ * @brief Single ROS 2 interface of all crowd agents, publishing their states & taking their goals as batched msgs.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// Native
+#include <atomic>
+
+// UE
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+#include "RRCrowdROS2Bridge.generated.h"
+
+class AAIController;
+class UROS2GenericMsg;
+class UROS2NodeComponent;
+class URRROS2EntityStatesPublisher;
+
+/**
+ * @brief Single ROS 2 interface of all crowd agents, replacing one ROS 2 node & its topics per agent, eg of
+ * #ARRCrowdROSController without bBatchedROS2, by one publisher & one subscriber in a shared node:
+ * - #StatesTopicName: poses & twists of all agents' pawns in one gazebo_msgs/ModelStates, by #URRROS2EntityStatesPublisher
+ * - #GoalsTopicName: gazebo_msgs/ModelStates of which each name & pose position is a goal of the agent of that name, in
+ *   the world frame. Goals received from a ROS working thread are kept per agent, the latest overriding older ones, then
+ *   dispatched on game thread by a single task at a time to their AI controller's MoveToLocation(), thus path following
+ *   component, eg #URRCrowdFollowingComponent.
+ * Agents may be added before #InitROS2.
+ * @sa [gazebo_msgs/ModelStates](http://docs.ros.org/en/noetic/api/gazebo_msgs/html/msg/ModelStates.html)
+ */
+UCLASS()
+class RAPYUTASIMULATIONPLUGINS_API URRCrowdROS2Bridge : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * @brief Create the states publisher & goals subscriber in the given node
+     * @param InROS2Node
+     */
+    virtual void InitROS2(UROS2NodeComponent* InROS2Node);
+
+    bool IsROS2Inited() const
+    {
+        return bROS2Inited;
+    }
+
+    /**
+     * @brief Register an agent, of which pawn is published & which is commanded as InName or its pawn name if empty
+     * @param InController Possessing its pawn
+     * @param InName
+     */
+    UFUNCTION(BlueprintCallable)
+    void AddAgent(AAIController* InController, const FString& InName = TEXT(""));
+
+    UFUNCTION(BlueprintCallable)
+    void RemoveAgent(AAIController* InController);
+
+    int32 GetAgentsNum() const
+    {
+        return Agents.Num();
+    }
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FString StatesTopicName = TEXT("crowd_states");
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FString GoalsTopicName = TEXT("crowd_goals");
+
+    //! [Hz]
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 StatesPublicationFrequencyHz = 10;
+
+    //! [cm] Acceptance radius of the goals' MoveToLocation()
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float GoalAcceptanceRadius = 50.f;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    URRROS2EntityStatesPublisher* StatesPublisher = nullptr;
+
+protected:
+    UFUNCTION()
+    void GoalsCallback(const UROS2GenericMsg* InMsg);
+
+    //! Dispatch #PendingGoals, on game thread
+    void ApplyPendingGoals();
+
+    //! Agents by name
+    TMap<FString, TWeakObjectPtr<AAIController>> Agents;
+
+    //! [cm] Latest undispatched goal of each agent, guarded by #GoalsMutex
+    TMap<FString, FVector> PendingGoals;
+
+    //! Goals being dispatched, reused across dispatches
+    TArray<TPair<FString, FVector>> DispatchedGoals;
+
+    FCriticalSection GoalsMutex;
+    std::atomic<bool> bGoalsTaskQueued = false;
+    bool bROS2Inited = false;
+};
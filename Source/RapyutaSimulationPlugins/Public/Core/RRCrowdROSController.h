@@ -20,6 +20,12 @@ class RAPYUTASIMULATIONPLUGINS_API ARRCrowdROSController : public ARRCrowdAICont
 {
     GENERATED_BODY()
 
+public:
+    //! Register the pawn to the single crowd ROS 2 interface of #ARRROS2GameMode::GetCrowdROS2Bridge, instead of
+    //! initializing its own ROS 2 interface, thus node & topics, which does not scale to large crowds
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bBatchedROS2 = false;
+
 protected:
     /**
      * @brief Initialize robot pawn by calling #ARRBaseRobot::InitROS2Interface.
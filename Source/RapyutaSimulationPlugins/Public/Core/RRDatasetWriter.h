@@ -0,0 +1,115 @@
+/**
+ * @file RRDatasetWriter.h
+ * @brief Pipelined writer of captured dataset samples, encoding & saving them on worker threads.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "Async/Future.h"
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeCounter.h"
+
+/**
+ * @brief Kind of a dataset sample, deciding its encoding
+ */
+enum class ERRDatasetSampleType : uint8
+{
+    COLOR,    //!< RGB or segmentation capture, saved as PNG
+    DEPTH,    //!< Float depth capture, saved as EXR
+    TEXT      //!< Labels, eg from #URRUObjectUtils::GetSegMaskDepthStencilsAsText(), saved as is
+};
+
+/**
+ * @brief A captured sample to be written by #FRRDatasetWriter, owning its raw data
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRDatasetSample
+{
+    ERRDatasetSampleType Type = ERRDatasetSampleType::COLOR;
+
+    //! Relative to the writer's output folder, without extension
+    FString FilePath;
+
+    int32 Width = 0;
+    int32 Height = 0;
+    TArray<FColor> ColorData;
+    TArray<float> DepthData;
+    FString Text;
+
+    //! Raw data size, also used as estimate of the encoded one for disk space checks
+    uint64 GetDataSize() const
+    {
+        return ColorData.Num() * sizeof(FColor) + DepthData.Num() * sizeof(float) + Text.Len() * sizeof(TCHAR);
+    }
+};
+
+/**
+ * @brief Bounded queue of dataset samples, each encoded & saved to disk by a thread pool task, so that capturing never waits
+ * for I/O as long as the queue has capacity. Data collection should only advance when #HasCapacity().
+ * Samples are rejected once the output disk has less than the configured free space, checked every
+ * #DISK_SPACE_CHECK_INTERVAL samples with #URRCoreUtils::HasEnoughDiskSpace().
+ * Enqueueing is game thread only.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRDatasetWriter
+{
+public:
+    static constexpr int32 DISK_SPACE_CHECK_INTERVAL = 32;
+
+    ~FRRDatasetWriter();
+
+    /**
+     * @brief Set the output folder, creating it if needed, and the queue size
+     * @param InOutputFolderPath
+     * @param InMaxPendingSamplesNum Max number of samples being encoded/written at once
+     * @param InMinFreeDiskSpaceInBytes Free space to be kept on the output disk
+     * @return true if the output folder exists
+     */
+    bool Init(const FString& InOutputFolderPath, const int32 InMaxPendingSamplesNum, const uint64 InMinFreeDiskSpaceInBytes);
+
+    //! Whether a sample could be enqueued right now without going over the queue size
+    bool HasCapacity() const
+    {
+        return PendingSamplesNum.GetValue() < MaxPendingSamplesNum;
+    }
+
+    /**
+     * @brief Move a sample into the queue, to be encoded & written by a worker thread
+     * @param InSample
+     * @return false if the queue is full or the output disk is short of space
+     */
+    bool Enqueue(FRRDatasetSample&& InSample);
+
+    //! Block till all enqueued samples have been written
+    void Flush();
+
+    int32 GetPendingSamplesNum() const
+    {
+        return PendingSamplesNum.GetValue();
+    }
+
+    int32 GetFailedSamplesNum() const
+    {
+        return FailedSamplesNum.GetValue();
+    }
+
+    const FString& GetOutputFolderPath() const
+    {
+        return OutputFolderPath;
+    }
+
+private:
+    //! Encode & save a sample, thread-safe
+    static bool WriteSample(const FString& InOutputFolderPath, const FRRDatasetSample& InSample);
+
+    FString OutputFolderPath;
+    int32 MaxPendingSamplesNum = 16;
+    uint64 MinFreeDiskSpaceInBytes = 0;
+
+    int32 SamplesSinceDiskSpaceCheck = 0;
+    bool bEnoughDiskSpace = true;
+
+    FThreadSafeCounter PendingSamplesNum;
+    FThreadSafeCounter FailedSamplesNum;
+    TArray<TFuture<void>> WriteTasks;
+};
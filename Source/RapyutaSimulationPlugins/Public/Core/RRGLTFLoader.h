@@ -0,0 +1,76 @@
+/**
+ * @file RRGLTFLoader.h
+ * @brief Native glTF 2.0 mesh loader, including meshopt-compressed buffers, bypassing Assimp import & post-processing.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+struct FRRMeshData;
+
+/**
+ * @brief Decoders of the meshoptimizer codecs used by EXT_meshopt_compression & KHR_meshopt_compression buffer views.
+ * Vertex codec version 0 & index codecs versions 0 & 1 are supported.
+ * @sa [EXT_meshopt_compression](https://github.com/KhronosGroup/glTF/tree/main/extensions/2.0/Vendor/EXT_meshopt_compression)
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRMeshoptDecoder
+{
+public:
+    //! ATTRIBUTES mode, InSize being the byte stride, a multiple of 4 up to 256
+    static bool DecodeVertexBuffer(uint8* OutData,
+                                   const int32 InCount,
+                                   const int32 InSize,
+                                   const uint8* InBuffer,
+                                   const int32 InBufferSize);
+
+    //! TRIANGLES mode, InIndexSize being 2 or 4
+    static bool DecodeIndexBuffer(uint8* OutData,
+                                  const int32 InCount,
+                                  const int32 InIndexSize,
+                                  const uint8* InBuffer,
+                                  const int32 InBufferSize);
+
+    //! INDICES mode, InIndexSize being 2 or 4
+    static bool DecodeIndexSequence(uint8* OutData,
+                                    const int32 InCount,
+                                    const int32 InIndexSize,
+                                    const uint8* InBuffer,
+                                    const int32 InBufferSize);
+
+    /**
+     * @brief Apply a filter in place to InCount decoded elements of InStride bytes
+     * @param InFilter NONE, OCTAHEDRAL, QUATERNION or EXPONENTIAL
+     * @param InOutData
+     * @param InCount
+     * @param InStride
+     * @return false if the filter is unknown or does not support InStride
+     */
+    static bool DecodeFilter(const FString& InFilter, uint8* InOutData, const int32 InCount, const int32 InStride);
+};
+
+/**
+ * @brief Loads the triangle meshes of .gltf & .glb files straight into #FRRMeshData's compact vertex layout, in the same
+ * space as #URRMeshUtils::LoadMeshFromFile()'s Assimp import (vertices pre-transformed by their node hierarchy, scaled
+ * m -> cm & mirrored along Y), yet without post-processing: normals are only generated if missing, tangents kept from
+ * the file or left as default & vertices not rejoined.
+ * Buffers may be embedded (GLB or data URIs) or external files, meshopt-compressed & quantized (KHR_mesh_quantization).
+ * Only the material factors are read, as Assimp's import does.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRGLTFLoader
+{
+public:
+    //! Whether InFilePath is a .gltf or .glb file
+    static bool IsGLTFFile(const FString& InFilePath);
+
+    /**
+     * @brief Load the meshes & materials params of the default scene, leaving #FRRMeshData::MaterialInstances to the caller
+     * @param InFilePath
+     * @param InMeshScale
+     * @param OutMeshData
+     * @return false if the file is invalid or requires unsupported extensions (eg Draco), to be imported by Assimp instead
+     */
+    static bool Load(const FString& InFilePath, const float InMeshScale, FRRMeshData& OutMeshData);
+};
@@ -11,6 +11,7 @@
 
 // RapyutaSimulationPlugins
 #include "Core/RRROS2GameMode.h"
+#include "Core/RRReadinessBarrier.h"
 #include "Core/RRTypeUtils.h"
 
 #include "RRGameMode.generated.h"
@@ -43,6 +44,9 @@ public:
     static constexpr int32 SIM_START_TIMEOUT_MINS = 2;
     static constexpr int32 SIM_START_TIMEOUT_SECS = 60 * SIM_START_TIMEOUT_MINS;
 
+    //! #SimStartBarrier dependency signalled by #URRGameSingleton::OnPriorityResourcesLoaded
+    static const FName SIM_START_DEPENDENCY_PRIORITY_RESOURCES;
+
     UPROPERTY()
     uint8 SimType = static_cast<uint8>(ERRSimType::ROBOT_SIM);
 
@@ -109,7 +113,7 @@ public:
      * 1. LOAD [ImageWrapperModule].  This must be loaded this early for possible external image-based texture loading at Sim
      * initialization!
      * 2. LOAD SIM STATIC GLOBAL RESOURCES
-     * 3. START SIM ONCE RESOURCES ARE LOADED
+     * 3. START SIM ONCE #SimStartBarrier's DEPENDENCIES ARE RESOLVED, the barrier being armed next tick
      *  The reason for this scheduled delegate is some essential operation, which facilitates sim startup activities like
      *  asynchronous resource loading, could only run after this [ARRGameState::BeginPlay()] ends!
      */
@@ -120,12 +124,19 @@ public:
 
     void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
+    /**
+     * @brief Dependencies to resolve before #TryStartingSim() runs, right upon the last one being signalled.
+     * Child classes may add their own in #StartSim() after calling the parent's, then signal them upon completion.
+     */
+    FRRReadinessBarrier SimStartBarrier = FRRReadinessBarrier(TEXT("SimStart"));
+
 private:
+    //! Timer logging the pending #SimStartBarrier dependencies after #SIM_START_TIMEOUT_SECS
     FTimerHandle OwnTimerHandle;
 
     /**
-     * @brief This method was scheduled to be run by BeginPlay()
-     * 1. WAIT FOR RESOURCE LOADING, in prep for Sim mode initialization
+     * @brief This method is run by #SimStartBarrier once all its dependencies have resolved
+     * 1. STOP THE SIM START TIMEOUT
      * 2. START PARENT'S PLAY, WHICH TRIGGER OTHERS PLAY FROM GAME STATE, PLAYER CONTROLLER, ETC.
      */
     UFUNCTION()
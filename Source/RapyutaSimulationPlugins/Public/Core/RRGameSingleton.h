@@ -52,10 +52,29 @@ using URRAssetObject = typename TChooseClass<
                             typename TChooseClass<(ERRResourceDataType::UE_BODY_SETUP == InDataType), UBodySetup, UObject>::
                                 Result>::Result>::Result>::Result>::Result>::Result>::Result>::Result;
 
+/**
+ * @brief Names of resources required by a map, in RapyutaSimSettings.ini, eg:
+ * +RESOURCE_MANIFESTS=(MapName="MyMap",ResourceNames=("SM_Box","M_RapyutaAssetMaster"))
+ * A manifest with an empty MapName applies to all maps.
+ */
+USTRUCT()
+struct RAPYUTASIMULATIONPLUGINS_API FRRResourceManifest
+{
+    GENERATED_BODY()
+
+    UPROPERTY(config)
+    FString MapName;
+
+    //! Resource unique names, ie asset names
+    UPROPERTY(config)
+    TArray<FString> ResourceNames;
+};
+
 /**
  * @brief GameSingleton class which handles asset loading.
  * GameSingleton class can exist during editor usage.
- * - #InitializeResources will async load data into #ResourceMap for each #ERRResourceDataType
+ * - #InitializeResources will async load data into #ResourceMap for each #ERRResourceDataType, ones in the map's
+ * #RESOURCE_MANIFESTS first, the rest streaming in the background afterwards
  * - Get Asset meta data with URRAssetUtils.
  * - Load data with [UAssetManager](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/Engine/UAssetManager/)
  * @sa [GameSingleton](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/Engine/UEngine/GameSingleton/)
@@ -82,13 +101,18 @@ public:
     // SIM RESOURCES ==
     //
 
+    //! Resources required by maps, loaded with high priority, see #HavePriorityResourcesBeenLoaded
+    UPROPERTY(config)
+    TArray<FRRResourceManifest> RESOURCE_MANIFESTS;
+
     /**
      * @brief Read all sim dynamic resouces(Uassets) info from designated folders
      *
+     * @param InMapName Name of the map, of which #RESOURCE_MANIFESTS are to be loaded first
      * @return true
      * @return false
      */
-    bool InitializeResources();
+    bool InitializeResources(const FString& InMapName = EMPTY_STR);
 
     /**
      * @brief Finalize #ResourceMap by calling #FRRResourceInfo::Finalize
@@ -230,7 +254,7 @@ public:
      */
     FORCEINLINE static TArray<FString> GetDynamicAssetsPathList(const ERRResourceDataType InDataType)
     {
-        static TArray<FString> runtimeAssetsPathList;
+        TArray<FString> runtimeAssetsPathList;
         for (const auto& moduleName : SASSET_OWNING_MODULE_NAMES[InDataType])
         {
             runtimeAssetsPathList.Emplace(GetDynamicAssetsBasePath(moduleName));
@@ -239,7 +263,7 @@ public:
     }
 
     /**
-     * @brief Finalize #ResourceMap by calling #FRRResourceInfo::Finalize
+     * @brief Collate assets info into #ResourceMap, by #URRAssetUtils::LoadAssetInfoList(), which caches it across runs
      * @tparam TResource
      * @param InDataType
      * @param InAssetRelativeFolderPath
@@ -250,28 +274,22 @@ public:
     {
         FRRResourceInfo& outResourceInfo = GetSimResourceInfo(InDataType);
 
-        TArray<FAssetData> totalAssetDataList;
+        TArray<FRRCachedAssetInfo> totalAssetInfoList;
         for (const auto& assetsPath : GetDynamicAssetsPathList(InDataType))
         {
-            TArray<FAssetData> assetDataList;
-            URRAssetUtils::LoadAssetDataList<T>(assetsPath / InAssetRelativeFolderPath, assetDataList);
-            totalAssetDataList.Append(assetDataList);
+            TArray<FRRCachedAssetInfo> assetInfoList;
+            URRAssetUtils::LoadAssetInfoList<T>(assetsPath / InAssetRelativeFolderPath, assetInfoList);
+            totalAssetInfoList.Append(assetInfoList);
         }
 
-        for (const auto& asset : totalAssetDataList)
+        for (const auto& asset : totalAssetInfoList)
         {
 #if RAPYUTA_SIM_DEBUG
-            UE_LOG_WITH_INFO(LogTemp,
-                             Warning,
-                             TEXT("[%s] ASSET [%s] [%s]"),
-                             *asset.AssetName.ToString(),
-                             *asset.PackagePath.ToString(),
-                             *asset.GetFullName(),
-                             *asset.ToSoftObjectPath().ToString());
+            UE_LOG_WITH_INFO(LogTemp, Warning, TEXT("ASSET [%s] [%s]"), *asset.AssetName, *asset.AssetPath);
 #endif
-            outResourceInfo.AddResource(asset.AssetName.ToString(), asset.ToSoftObjectPath().ToString(), nullptr);
+            outResourceInfo.AddResource(asset.AssetName, asset.AssetPath, nullptr);
         }
-        return totalAssetDataList.Num();
+        return totalAssetInfoList.Num();
     }
 
     //  RESOURCE STORE --
@@ -285,6 +303,28 @@ public:
      */
     bool HaveAllResourcesBeenLoaded(bool bIsLogged = false) const;
 
+    /**
+     * @brief Check resources in the map's #RESOURCE_MANIFESTS, or all if there is none, have been loaded or not.
+     * The sim could start then, while consumers of other resources await them by #WaitForSimResource.
+     *
+     * @param bIsLogged
+     * @return true
+     * @return false
+     */
+    bool HavePriorityResourcesBeenLoaded(bool bIsLogged = false) const;
+
+    //! Broadcast once per #InitializeResources, as soon as #HavePriorityResourcesBeenLoaded turns true
+    FSimpleMulticastDelegate OnPriorityResourcesLoaded;
+
+    //! Broadcast #OnPriorityResourcesLoaded if the priority resources have just finished loading
+    void NotifyIfPriorityResourcesLoaded();
+
+    //! Whether InResourceUniqueName is in the map's #RESOURCE_MANIFESTS, all resources being so if there is none
+    bool IsPriorityResource(const FString& InResourceUniqueName) const
+    {
+        return (PriorityResourceNames.Num() == 0) || PriorityResourceNames.Contains(InResourceUniqueName);
+    }
+
     /**
      * @brief Collate asset resources info & Async load them by UAssetManager
      * @tparam InDataType
@@ -313,6 +353,7 @@ public:
 
         // 2- REQUEST FOR LOADING THE RESOURCES ASYNCHRONOUSLY
         resourceInfo.ToBeAsyncLoadedResourceNum = resourceInfo.Data.Num();
+        resourceInfo.ToBeAsyncLoadedPriorityResourceNum = 0;
         resourceInfo.bHasBeenAllLoaded = false;
 #if RAPYUTA_SIM_VERBOSE
         UE_LOG_WITH_INFO(LogRapyutaCore,
@@ -327,6 +368,10 @@ public:
         {
             for (const auto& resourceMetaData : resourceInfo.Data)
             {
+                // Manifest resources are loaded first, the rest streaming in the background
+                const bool bIsPriority = IsPriorityResource(resourceMetaData.Value.UniqueName);
+                resourceInfo.ToBeAsyncLoadedPriorityResourceNum += bIsPriority ? 1 : 0;
+
                 // https://docs.unrealengine.com/en-US/Resources/SampleGames/ARPG/BalancingBlueprintAndCPP/index.html
                 // "Avoid Referencing Assets by String"
                 FSoftObjectPath resourceSoftObjPath(resourceMetaData.Value.GetAssetPath());
@@ -336,7 +381,8 @@ public:
                                                        &URRGameSingleton::OnResourceLoaded,
                                                        InDataType,
                                                        resourceSoftObjPath,
-                                                       resourceMetaData.Value.UniqueName));
+                                                       resourceMetaData.Value.UniqueName),
+                    bIsPriority ? FStreamableManager::AsyncLoadHighPriority : FStreamableManager::DefaultAsyncLoadPriority);
             }
             return true;
         }
@@ -419,6 +465,10 @@ public:
             FRRResourceInfo& resourceInfo = GetSimResourceInfo(InDataType);
             resourceInfo.AddResource(InResourceUniqueName, InResourcePath, resource);
             resourceInfo.ToBeAsyncLoadedResourceNum--;
+            if (IsPriorityResource(InResourceUniqueName))
+            {
+                resourceInfo.ToBeAsyncLoadedPriorityResourceNum--;
+            }
 #if RAPYUTA_SIM_DEBUG
             UE_LOG_WITH_INFO(LogTemp,
                              Warning,
@@ -438,6 +488,9 @@ public:
             // Still need to store resource handle in a direct UPROPERTY() child TArray of this GameSingleton to bypass
             // early GC
             ResourceStore.AddUnique(Cast<UObject>(resource));
+            PublishResourceSnapshot(InDataType, InResourceUniqueName, resource);
+            SignalDynamicResourceWaiters(InDataType, InResourceUniqueName, resource);
+            NotifyIfPriorityResourcesLoaded();
             return true;
         }
         return false;
@@ -482,9 +535,50 @@ public:
         if (IsValid(InResourceObject))
         {
             ResourceStore.AddUnique(Cast<UObject>(InResourceObject));
+            PublishResourceSnapshot(InDataType, InResourceUniqueName, InResourceObject);
+            SignalDynamicResourceWaiters(InDataType, InResourceUniqueName, InResourceObject);
         }
     }
 
+    using FRRResourceReadyCallback = TUniqueFunction<void(UObject* /*InResourceObject*/)>;
+
+    /**
+     * @brief Call InCallback once the dynamic resource, of which a null place-holder has been added by #AddDynamicResource
+     * while being created, is added, or right away if it is already available.
+     * All waiters of a resource are called once, in the game thread, instead of each polling it.
+     *
+     * @param InDataType
+     * @param InResourceUniqueName
+     * @param InCallback Given nullptr if the resource creation failed, see #SignalDynamicResourceWaiters
+     */
+    void WaitForDynamicResource(const ERRResourceDataType InDataType,
+                                const FString& InResourceUniqueName,
+                                FRRResourceReadyCallback&& InCallback);
+
+    /**
+     * @brief Call InCallback once the asset resource, possibly still streaming in the background, has been loaded, or right
+     * away if it already is. Its loading is also bumped to high priority.
+     *
+     * @param InDataType
+     * @param InResourceUniqueName
+     * @param InCallback
+     */
+    void WaitForSimResource(const ERRResourceDataType InDataType,
+                            const FString& InResourceUniqueName,
+                            FRRResourceReadyCallback&& InCallback);
+
+    /**
+     * @brief Call then clear the waiters of a dynamic resource, registered by #WaitForDynamicResource.
+     * Called by #AddDynamicResource, or with nullptr upon the resource creation failing.
+     *
+     * @param InDataType
+     * @param InResourceUniqueName
+     * @param InResourceObject
+     */
+    void SignalDynamicResourceWaiters(const ERRResourceDataType InDataType,
+                                      const FString& InResourceUniqueName,
+                                      UObject* InResourceObject);
+
     /**
      * @brief Get the Sim Resource object
      *
@@ -499,7 +593,10 @@ public:
                               const FString& InResourceUniqueName,
                               bool bIsStaticResource = true) const
     {
-        TResource* resourceAsset = Cast<TResource>(GetSimResourceInfo(InDataType).Data.FindRef(InResourceUniqueName).AssetData);
+        // Off the game thread, which alone writes #ResourceMap, resources are resolved from their published snapshot
+        TResource* resourceAsset =
+            IsInGameThread() ? Cast<TResource>(GetSimResourceInfo(InDataType).Data.FindRef(InResourceUniqueName).AssetData)
+                             : FindSimResourceAnyThread<TResource>(InDataType, FName(*InResourceUniqueName));
 
         if (bIsStaticResource && (!resourceAsset))
         {
@@ -526,6 +623,23 @@ public:
         return resourceAsset;
     }
 
+    /**
+     * @brief Find a loaded resource from any thread, in the snapshot of its data type last published by the game thread.
+     * Objects are kept alive by #ResourceStore until #FinalizeResources.
+     *
+     * @tparam TResource
+     * @param InDataType
+     * @param InResourceUniqueName
+     * @return TResource* nullptr if not yet loaded or added
+     */
+    template<typename TResource>
+    TResource* FindSimResourceAnyThread(const ERRResourceDataType InDataType, const FName& InResourceUniqueName) const
+    {
+        const FRRResourceSnapshotPtr snapshot = GetResourceSnapshot(InDataType);
+        UObject* const* resource = snapshot.IsValid() ? snapshot->Find(InResourceUniqueName) : nullptr;
+        return resource ? Cast<TResource>(*resource) : nullptr;
+    }
+
     /**
      * @brief Check resource exist with #GetSimResourceInfo
      *
@@ -635,6 +749,17 @@ public:
         return GetSimResource<UStaticMesh>(ERRResourceDataType::UE_STATIC_MESH, InStaticMeshName, bIsStaticResource);
     }
 
+    /**
+     * @brief Get the unique name of the dynamic resources created from a mesh file, keyed by its content hash so that the same
+     * mesh referenced from different paths is imported & built once, while different meshes of the same base name do not
+     * collide. Falls back to the file's base name if it could not be hashed.
+     *
+     * @param InPrefix eg #GetAssetNamePrefix()
+     * @param InMeshFilePath
+     * @return FString
+     */
+    static FString GetMeshUniqueName(const TCHAR* InPrefix, const FString& InMeshFilePath);
+
     // SKELETAL ASSETS --
     UPROPERTY(config)
     FString FOLDER_PATH_ASSET_SKELETAL_MESHES = TEXT("SkeletalMeshes");
@@ -759,12 +884,51 @@ public:
         return GetSimResource<UBodySetup>(ERRResourceDataType::UE_BODY_SETUP, InBodySetupName, false);
     }
 
+    /**
+     * @brief Num of objects kept alive by #ResourceStore & their estimated total resource size, CPU & GPU
+     * @param OutObjectsNum
+     * @return int64 [bytes]
+     */
+    int64 GetResourceStoreSize(int32& OutObjectsNum) const;
+
 private:
-    //! Async loaded, thus must be thread safe. A map just helps referencing an item faster, though costs some overheads.
+    //! Async loaded, written & read in the game thread only, other threads reading #ResourceSnapshots instead.
+    //! A map just helps referencing an item faster, though costs some overheads.
     //! Besides, UE does not support UPROPERTY() on a map yet.
     TMap<ERRResourceDataType, FRRResourceInfo> ResourceMap;
 
     //! We need this to escape UObject-based resource Garbage Collection
     UPROPERTY()
     TArray<UObject*> ResourceStore;
+
+    //! Loaded resources of a data type, immutable once published, so readers of any thread need no lock to look up
+    using FRRResourceSnapshot = TMap<FName, UObject*>;
+    using FRRResourceSnapshotPtr = TSharedPtr<const FRRResourceSnapshot, ESPMode::ThreadSafe>;
+
+    //! Per data type, replaced as a whole upon publishing, under #ResourceSnapshotsLock held only to swap/copy the pointer
+    FRRResourceSnapshotPtr ResourceSnapshots[static_cast<uint8>(ERRResourceDataType::TOTAL)];
+    mutable FRWLock ResourceSnapshotsLock;
+
+    FRRResourceSnapshotPtr GetResourceSnapshot(const ERRResourceDataType InDataType) const
+    {
+        FReadScopeLock lock(ResourceSnapshotsLock);
+        return ResourceSnapshots[static_cast<uint8>(InDataType)];
+    }
+
+    /**
+     * @brief Publish a new snapshot of InDataType's resources, with InResourceObject added, copied from the current one.
+     * Only called in the game thread, thus publishers are serialized.
+     */
+    void PublishResourceSnapshot(const ERRResourceDataType InDataType,
+                                 const FString& InResourceUniqueName,
+                                 UObject* InResourceObject);
+
+    //! Resource names of the map's #RESOURCE_MANIFESTS, see #IsPriorityResource
+    TSet<FString> PriorityResourceNames;
+
+    //! Callbacks waiting for dynamic resources being created, see #WaitForDynamicResource
+    TMap<TPair<ERRResourceDataType, FString>, TArray<FRRResourceReadyCallback>> DynamicResourceWaiters;
+
+    //! Whether #OnPriorityResourcesLoaded has been broadcast since #InitializeResources, or is suppressed during it
+    bool bPriorityResourcesLoadedNotified = false;
 };
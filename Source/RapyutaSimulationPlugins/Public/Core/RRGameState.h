@@ -17,9 +17,43 @@
 
 #include "RRGameState.generated.h"
 
+class ARRBaseActor;
 class ARRGameMode;
 class URRGameInstance;
 class ARRMeshActor;
+class ULevelStreamingDynamic;
+
+/**
+ * @brief Actor pool prewarming config, in RapyutaSimSettings.ini, eg:
+ * +ACTOR_POOL_PREWARM_LIST=(ActorClass="/Script/MyModule.MyActor",EntityModelName="box",Num=20)
+ */
+USTRUCT()
+struct RAPYUTASIMULATIONPLUGINS_API FRRActorPoolPrewarmInfo
+{
+    GENERATED_BODY()
+
+    UPROPERTY(config)
+    TSoftClassPtr<ARRBaseActor> ActorClass;
+
+    UPROPERTY(config)
+    FString EntityModelName;
+
+    //! Num of actors prewarmed per scene instance
+    UPROPERTY(config)
+    int32 Num = 0;
+};
+
+/**
+ * @brief Parked actors of the same class & entity model, ready to be reused
+ */
+USTRUCT()
+struct RAPYUTASIMULATIONPLUGINS_API FRRActorPool
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<ARRBaseActor*> Actors;
+};
 
 /**
  * @brief Game state which handles multiple #URRSceneInstance which spit game in scenes for data gen, large world and etc.
@@ -41,6 +75,22 @@ public:
      */
     virtual void StartSim();
 
+    /**
+     * @brief Fork the scenario of an initialized scene instance into new scene instances, one per given random seed, each run
+     * by its own scene director of the source's class, set up from the source one by #ARRSceneDirector::ForkFrom().
+     * Forks run in this process alongside the source, thus sharing all its loaded assets, built meshes & body setups, parsed
+     * robot models & caches, only paying their own actors' spawning. Each fork has its own random substreams seeded by
+     * #URRMathUtils::SetSceneRandomSeed() & its robots under the ROS namespace #SCENE_INSTANCE_FORK_ROS_NAMESPACE_PREFIX<id>.
+     * @param InSourceSceneInstanceId
+     * @param InRandomSeeds 0 for a seed derived from the master seed & the fork's id
+     * @return TArray<int8> Ids of the forked scene instances, fewer than seeds if the max num of scene instances is reached
+     */
+    TArray<int8> ForkSceneInstances(int8 InSourceSceneInstanceId, const TArray<int32>& InRandomSeeds);
+
+    //! ROS namespace prefix of forked scene instances' robots, see #ForkSceneInstances()
+    UPROPERTY(config)
+    FString SCENE_INSTANCE_FORK_ROS_NAMESPACE_PREFIX = TEXT("scene_");
+
     UPROPERTY(config)
     int8 SCENE_INSTANCES_NUM = 1;
 
@@ -52,6 +102,16 @@ public:
 
     UPROPERTY(config)
     float SCENE_INSTANCES_DISTANCE_INTERVAL = 5000.f;
+
+    //! If set, eg /Game/Maps/Warehouse, each scene instance streams its own instance of this environment level at its location,
+    //! instead of sharing #MainEnvironment, so that instances run independently of each other
+    UPROPERTY(config)
+    FString SCENE_INSTANCE_ENVIRONMENT_LEVEL;
+
+    bool HasOwnSceneInstanceEnvironments() const
+    {
+        return !SCENE_INSTANCE_ENVIRONMENT_LEVEL.IsEmpty();
+    }
     UPROPERTY()
     int8 LastSceneInstanceId = URRActorCommon::DEFAULT_SCENE_INSTANCE_ID;
 
@@ -178,9 +238,65 @@ public:
         }
     }
 
-    //! Move all env static actors to a scene instance
+    // ACTOR POOL
+    //! Actors prewarmed into the pool per scene instance at sim start, before scene directors are spawned
+    UPROPERTY(config)
+    TArray<FRRActorPoolPrewarmInfo> ACTOR_POOL_PREWARM_LIST;
+
+    /**
+     * @brief Reuse a parked actor of InActorClass & InEntityModelName in the scene instance if any, else spawn a new one by
+     * #URRUObjectUtils::SpawnSimActor()
+     * @param InSceneInstanceId
+     * @param InActorClass
+     * @param InEntityModelName
+     * @param InActorTransform
+     * @param InActorName Only used for a newly spawned actor
+     * @return ARRBaseActor*
+     */
+    ARRBaseActor* AcquirePooledActor(int8 InSceneInstanceId,
+                                     UClass* InActorClass,
+                                     const FString& InEntityModelName,
+                                     const FTransform& InActorTransform,
+                                     const FString& InActorName = EMPTY_STR);
+
+    template<typename T>
+    T* AcquirePooledActor(int8 InSceneInstanceId, const FString& InEntityModelName, const FTransform& InActorTransform)
+    {
+        return Cast<T>(AcquirePooledActor(InSceneInstanceId, T::StaticClass(), InEntityModelName, InActorTransform));
+    }
+
+    /**
+     * @brief Park InActor into the pool in place of destroying it: hidden, collision & tick disabled, moved out of sight.
+     * Its components (meshes, bodies) are kept as they are for reuse by the same entity model.
+     * @param InActor
+     */
+    void ReleasePooledActor(ARRBaseActor* InActor);
+
+    /**
+     * @brief Spawn & park actors into the pool up to InNum of InActorClass & InEntityModelName in the scene instance
+     * @param InSceneInstanceId
+     * @param InActorClass
+     * @param InEntityModelName
+     * @param InNum
+     */
+    void PrewarmActorPool(int8 InSceneInstanceId, UClass* InActorClass, const FString& InEntityModelName, int32 InNum);
+
+    //! Num of parked actors of InActorClass & InEntityModelName
+    int32 GetPooledActorsNum(UClass* InActorClass, const FString& InEntityModelName) const
+    {
+        const FRRActorPool* pool = ActorPools.Find(GetActorPoolKey(InActorClass, InEntityModelName));
+        return pool ? pool->Actors.Num() : 0;
+    }
+
+    //! Move all env static actors to a scene instance, no-op if each has its own, see #SCENE_INSTANCE_ENVIRONMENT_LEVEL
     virtual void MoveEnvironmentToSceneInstance(int8 InSceneInstanceId);
 
+    //! Streamed environment level instance of a scene instance, nullptr if not #HasOwnSceneInstanceEnvironments()
+    ULevelStreamingDynamic* GetSceneInstanceEnvironment(int8 InSceneInstanceId) const
+    {
+        return SceneInstanceEnvironments.IsValidIndex(InSceneInstanceId) ? SceneInstanceEnvironments[InSceneInstanceId] : nullptr;
+    }
+
 protected:
     /**
     * @brief Create a Scene Instance object.
@@ -216,6 +332,9 @@ protected:
      */
     virtual void CreateServiceObjects(int8 InSceneInstanceId);
 
+    //! Stream #SCENE_INSTANCE_ENVIRONMENT_LEVEL at the scene instance's location, once #CreateServiceObjects() has located it
+    virtual void CreateSceneInstanceEnvironment(int8 InSceneInstanceId);
+
     //! Stream level & Fetch static-env actors
     virtual void SetupEnvironment();
 
@@ -249,10 +368,26 @@ protected:
     UPROPERTY()
     TSubclassOf<URRSceneInstance> SceneInstanceClass;
 
+    //! Per scene instance environment level instances, see #SCENE_INSTANCE_ENVIRONMENT_LEVEL
+    UPROPERTY()
+    TArray<ULevelStreamingDynamic*> SceneInstanceEnvironments;
+
     //! Pool of all entities having been spawned
     UPROPERTY()
     TArray<ARRMeshActor*> AllDynamicMeshEntities;
 
+    //! Parked actors, keyed by #GetActorPoolKey()
+    UPROPERTY()
+    TMap<FString, FRRActorPool> ActorPools;
+
+    static FString GetActorPoolKey(UClass* InActorClass, const FString& InEntityModelName)
+    {
+        return FString::Printf(TEXT("%s|%s"), *GetPathNameSafe(InActorClass), *InEntityModelName);
+    }
+
+    //! Prewarm #ACTOR_POOL_PREWARM_LIST into the scene instance
+    virtual void PrewarmActorPools(int8 InSceneInstanceId);
+
 private:
     //! To avoid early GC, this exists only to keep ones temporarily taken away from [AllDynamicMeshEntities] & recycled later
     UPROPERTY()
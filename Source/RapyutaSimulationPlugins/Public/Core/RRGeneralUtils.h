@@ -14,6 +14,30 @@
 
 #include "RRGeneralUtils.generated.h"
 
+/**
+ * @brief A reference frame with its inverse terms precomputed, for many transforms relative to it
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRRefFrame
+{
+    FRRRefFrame() = default;
+
+    explicit FRRRefFrame(const FTransform& InRefTransf);
+
+    //! Normalized reference transform, in world frame
+    FTransform Transform = FTransform::Identity;
+    FQuat InvRotation = FQuat::Identity;
+    FVector InvScale = FVector::OneVector;
+    bool bNegativeScale = false;
+
+    /**
+     * @brief Same as #URRGeneralUtils::GetRelativeTransform(#Transform, InWorldTransf)
+     *
+     * @param InWorldTransf Transform in world frame
+     * @return FTransform Transform in reference frame
+     */
+    FTransform GetRelativeTransform(const FTransform& InWorldTransf) const;
+};
+
 /**
  * @brief General utils
  *
@@ -82,9 +106,19 @@ public:
         {
             return WorldTransf;
         }
-        return GetRelativeTransform(RefActor->GetTransform(), WorldTransf);
+        return GetCachedRefFrame(RefActor).GetRelativeTransform(WorldTransf);
     }
 
+    /**
+     * @brief Get the frame of RefActor, its inverse being computed once per frame on game thread & shared by all callers,
+     * eg the many publishers referencing the same map origin. Recomputed if the actor has moved since.
+     * Computed without caching off game thread.
+     *
+     * @param RefActor Not nullptr
+     * @return FRRRefFrame
+     */
+    static FRRRefFrame GetCachedRefFrame(const AActor* RefActor);
+
     /**
      * @brief Get the transform in reference frame. If RefActor==nullptr, return WorldTransf
      *
@@ -113,13 +147,17 @@ public:
                                      const FTransform& InTransf,
                                      FTransform& OutTransf)
     {
-        FTransform refTransf;
-        bool result = GetRefTransform(RefActorName, RefActor, refTransf);
-        if (result)
+        if (RefActorName.IsEmpty())    // refrence is world origin
         {
-            OutTransf = URRGeneralUtils::GetRelativeTransform(refTransf, InTransf);
+            OutTransf = URRGeneralUtils::GetRelativeTransform(FTransform::Identity, InTransf);
+            return true;
         }
-        return result;
+        if (RefActor == nullptr)
+        {
+            return false;
+        }
+        OutTransf = GetCachedRefFrame(RefActor).GetRelativeTransform(InTransf);
+        return true;
     }
 
     /**
@@ -323,4 +361,28 @@ public:
         OutValue = InDefaultValue;
         return false;
     }
+
+    /**
+     * @brief Get a JSON document parsed only once per process, eg the same #UROS2Spawnable::ActorJsonConfigs of many
+     * spawned robots. Documents are keyed by their text, or by path & timestamp for files, thus re-parsed upon changes.
+     * Disabled by rr.JsonCache.Enabled 0.
+     * @param InJson JSON text, or path of a .json file
+     * @return TSharedPtr<FJsonObject> Shared by all callers thus not to be modified, nullptr if invalid
+     */
+    static TSharedPtr<FJsonObject> GetCachedJsonObject(const FString& InJson);
+
+    /**
+     * @brief Get a JSON document converted to a struct only once per process & struct type, see #GetCachedJsonObject
+     * @param InJson JSON text, or path of a .json file
+     * @param InStruct
+     * @param OutStructData Instance of InStruct, set with a plain struct copy
+     * @return bool if converted
+     */
+    static bool GetCachedJsonStruct(const FString& InJson, const UScriptStruct* InStruct, void* OutStructData);
+
+    template<typename TStruct>
+    FORCEINLINE static bool GetCachedJsonStruct(const FString& InJson, TStruct& OutStruct)
+    {
+        return GetCachedJsonStruct(InJson, TStruct::StaticStruct(), &OutStruct);
+    }
 };
@@ -0,0 +1,65 @@
+/**
+ * @file RRInstancedMeshGroupComponent.h
+ * @brief Instanced rendering of a homogeneous mesh entity group.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "CoreMinimal.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRActorCommon.h"
+
+#include "RRInstancedMeshGroupComponent.generated.h"
+
+/**
+ * @brief Render all entities of a #FRRHomoMeshEntityGroup, sharing the same static mesh, as instances of a single HISM,
+ * their own mesh components being hidden while keeping their collision & physics.
+ * Per-instance custom data hold the entity's segmentation mask id & albedo color, to be read by the materials through
+ * PerInstanceCustomData. Since custom depth stencil is per component, it is only set if uniform across the group.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class RAPYUTASIMULATIONPLUGINS_API URRInstancedMeshGroupComponent : public UHierarchicalInstancedStaticMeshComponent
+{
+    GENERATED_BODY()
+
+public:
+    static constexpr int32 CUSTOM_DATA_INDEX_SEGMASK_ID = 0;
+    //! R, G, B at this index onwards
+    static constexpr int32 CUSTOM_DATA_INDEX_COLOR_ALBEDO = 1;
+    static constexpr int32 CUSTOM_DATA_NUM = 4;
+
+    URRInstancedMeshGroupComponent();
+
+    /**
+     * @brief Render InGroup's entities as instances, hiding their own mesh components.
+     * Entities of another static mesh than the first one's are left rendering by themselves.
+     * @param InGroup
+     * @return true if at least an entity is rendered as an instance
+     */
+    bool SetGroup(const FRRHomoMeshEntityGroup& InGroup);
+
+    //! Give the entities back their own rendering & clear all instances
+    void ResetGroup();
+
+    //! Sync instance transforms with their entities', in one batch
+    void UpdateInstanceTransforms();
+
+    void SetInstanceSegMaskId(const int32 InInstanceIndex, const int32 InSegMaskId);
+    //! @param bMarkRenderStateDirty False to batch many instances' updates, marking the render state dirty once after
+    void SetInstanceColorAlbedo(const int32 InInstanceIndex, const FLinearColor& InColor, bool bMarkRenderStateDirty = true);
+
+    //! Entities rendered by this component, an entity's instance index being its index here
+    UPROPERTY(VisibleAnywhere)
+    TArray<ARRMeshActor*> Entities;
+
+protected:
+    virtual void OnComponentDestroyed(bool bDestroyingHierarchy) override;
+
+private:
+    static UStaticMeshComponent* GetEntityMeshComponent(const ARRMeshActor* InEntity);
+    void UpdateGroupCustomDepthStencil();
+};
@@ -0,0 +1,54 @@
+/**
+ * @file RRLightProfileCache.h
+ * @brief On-disk cache of light profile texels parsed from IES files, to skip parsing them on later runs.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+struct FRRLightProfileData;
+
+/**
+ * @brief Cache of #FRRLightProfileData parsed by #URRCoreUtils::ParseIESProfile(), under [ProjectSavedDir]/RRLightProfileCache.
+ * Entries are keyed by the IES file full path, and validated by its size & timestamp.
+ * Thread-safe, as each entry is its own file. Disabled by rr.LightProfileCache.Enabled 0.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRLightProfileCache
+{
+public:
+    static constexpr uint32 MAGIC = 0x53454952;    // "RIES"
+    static constexpr uint32 VERSION = 1;
+
+    static bool IsEnabled();
+
+    /**
+     * @brief Get the signature of an IES file
+     * @param InFilePath
+     * @return FString Empty if the file does not exist
+     */
+    static FString GetFileSignature(const FString& InFilePath);
+
+    /**
+     * @brief Load cached light profile data
+     * @param InFilePath
+     * @param InSignature From #GetFileSignature()
+     * @param OutData
+     * @return true if the cache file exists, is of the current #VERSION & InSignature
+     */
+    static bool Load(const FString& InFilePath, const FString& InSignature, FRRLightProfileData& OutData);
+
+    /**
+     * @brief Save light profile data, written to a temporary file first so that concurrent sim runs never read a partial file
+     * @param InFilePath
+     * @param InSignature From #GetFileSignature()
+     * @param InData
+     * @return true if saved
+     */
+    static bool Save(const FString& InFilePath, const FString& InSignature, const FRRLightProfileData& InData);
+
+private:
+    static FString GetCacheFilePath(const FString& InFilePath);
+};
@@ -0,0 +1,92 @@
+/**
+ * @file RRMaterialInstanceCache.h
+ * @brief Per-world cache of dynamic material instances, reused across repeated appearance changes.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// Native
+#include <mutex>
+
+// UE
+#include "CoreMinimal.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "UObject/GCObject.h"
+#include "UObject/ObjectKey.h"
+
+class UMeshComponent;
+class UWorld;
+
+/**
+ * @brief #FRRMaterialProperty parameter names as material parameter infos, hashed once instead of upon every
+ * UMaterialInstanceDynamic::Set*ParameterValue() by name
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRMaterialParameterInfos
+{
+    static const FMaterialParameterInfo ALBEDO;
+    static const FMaterialParameterInfo ORM;
+    static const FMaterialParameterInfo NORMAL;
+    static const FMaterialParameterInfo MASK;
+    static const FMaterialParameterInfo COLOR_ALBEDO;
+    static const FMaterialParameterInfo EMISSIVE_STRENGTH;
+};
+
+/**
+ * @brief Per-world cache of MIDs, keyed by (mesh component, material index, parent material).
+ * A slot's MID is created once per parent material, then reused whenever the slot gets that parent again, thus repeated
+ * randomization neither allocates new UObjects nor leaves discarded MIDs to the GC. Cached MIDs are kept alive by
+ * this cache, till their components are destroyed or the world is cleaned up.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRMaterialInstanceCache : public FGCObject
+{
+public:
+    /**
+     * @brief Get the cache of a world, creating it upon the first fetching
+     *
+     * @param InWorld
+     * @return FRRMaterialInstanceCache&
+     */
+    static FRRMaterialInstanceCache& Get(UWorld* InWorld);
+
+    /**
+     * @brief Get the MID of a mesh component's material slot having a given parent, setting it to the slot.
+     * The slot's current material is returned as is if already such a MID, else a cached one or a new one is set.
+     *
+     * @param InMeshComp
+     * @param InMaterialIndex
+     * @param InParentMaterial
+     * @param InName Base name of a new MID, made unique under InMeshComp
+     * @return UMaterialInstanceDynamic*
+     */
+    UMaterialInstanceDynamic* GetOrCreate(UMeshComponent* InMeshComp,
+                                          const int32 InMaterialIndex,
+                                          UMaterialInterface* InParentMaterial,
+                                          const FName& InName = NAME_None);
+
+    int32 Num() const
+    {
+        return MaterialInstances.Num();
+    }
+
+    virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+
+    virtual FString GetReferencerName() const override
+    {
+        return TEXT("FRRMaterialInstanceCache");
+    }
+
+private:
+    using FRRMaterialInstanceKey = TTuple<TObjectKey<UMeshComponent>, int32, TObjectKey<UMaterialInterface>>;
+
+    static TMap<UWorld*, TUniquePtr<FRRMaterialInstanceCache>> SCaches;
+    static std::once_flag OnceFlag;
+
+    static void OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/);
+
+    //! Drop MIDs of destroyed components, once the cache has doubled since the last pruning
+    void PruneIfNeeded();
+
+    TMap<FRRMaterialInstanceKey, UMaterialInstanceDynamic*> MaterialInstances;
+    int32 PruneThresholdNum = 256;
+};
@@ -97,6 +97,50 @@ public:
         return false;
     }
 
+    /**
+     * @brief Rotate a SoA (X[], Y[], Z[]) list of vectors by a single quaternion, 4 vectors per SIMD register.
+     * Uses v' = v + w * t + q x t, with t = 2 * (q x v), thus no trigonometry.
+     * @param InQuat
+     * @param InX, InY, InZ Input components
+     * @param OutX, OutY, OutZ Output components
+     * @param InNum Num of vectors, which must be a multiple of 4 (pad the arrays with zeros otherwise)
+     */
+    static void RotateVectorsSoA(const FQuat4f& InQuat,
+                                 const float* InX,
+                                 const float* InY,
+                                 const float* InZ,
+                                 float* OutX,
+                                 float* OutY,
+                                 float* OutZ,
+                                 const int32 InNum)
+    {
+        check(InNum % 4 == 0);
+        const VectorRegister4Float qx = VectorSetFloat1(InQuat.X);
+        const VectorRegister4Float qy = VectorSetFloat1(InQuat.Y);
+        const VectorRegister4Float qz = VectorSetFloat1(InQuat.Z);
+        const VectorRegister4Float qw = VectorSetFloat1(InQuat.W);
+        const VectorRegister4Float two = VectorSetFloat1(2.f);
+        for (int32 i = 0; i < InNum; i += 4)
+        {
+            const VectorRegister4Float vx = VectorLoad(InX + i);
+            const VectorRegister4Float vy = VectorLoad(InY + i);
+            const VectorRegister4Float vz = VectorLoad(InZ + i);
+
+            // t = 2 * (q x v)
+            const VectorRegister4Float tx = VectorMultiply(two, VectorSubtract(VectorMultiply(qy, vz), VectorMultiply(qz, vy)));
+            const VectorRegister4Float ty = VectorMultiply(two, VectorSubtract(VectorMultiply(qz, vx), VectorMultiply(qx, vz)));
+            const VectorRegister4Float tz = VectorMultiply(two, VectorSubtract(VectorMultiply(qx, vy), VectorMultiply(qy, vx)));
+
+            // v' = v + w * t + (q x t)
+            VectorStore(VectorAdd(VectorMultiplyAdd(qw, tx, vx), VectorSubtract(VectorMultiply(qy, tz), VectorMultiply(qz, ty))),
+                        OutX + i);
+            VectorStore(VectorAdd(VectorMultiplyAdd(qw, ty, vy), VectorSubtract(VectorMultiply(qz, tx), VectorMultiply(qx, tz))),
+                        OutY + i);
+            VectorStore(VectorAdd(VectorMultiplyAdd(qw, tz, vz), VectorSubtract(VectorMultiply(qx, ty), VectorMultiply(qy, tx))),
+                        OutZ + i);
+        }
+    }
+
     /**
      * @brief Clamp a given rotator to its max axis angles
      *
@@ -127,13 +171,93 @@ public:
         return FMath::Clamp(InAngle, -InMaxAngle, InMaxAngle);
     }
 
+    /**
+     * @brief Get a value of the base-2 Van der Corput sequence (0, 1/2, 1/4, 3/4, ..), evenly spread in [0, 1) for any
+     * num of values without moving the previous ones, eg for the timer phases of sensors added over time
+     * @param InIndex
+     * @return float
+     */
+    FORCEINLINE static float GetSpreadPhase(const uint32 InIndex)
+    {
+        return static_cast<float>(ReverseBits(InIndex) * (1.0 / 4294967296.0));
+    }
+
     // RANDOM GENERATOR --
     /**
-     * @brief Initialize #URRMathUtils::RandomStream by FRandomStream
+     * @brief Initialize #URRMathUtils::RandomStream by FRandomStream, with -RRRandomSeed=<seed> if given, else a new seed
      * @sa [FRandomStream](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Core/Math/FRandomStream/)
      */
     static void InitializeRandomStream();
 
+    //! Reseed #URRMathUtils::RandomStream, the master seed of all substreams, on game thread
+    static void SetRandomSeed(const int32 InSeed);
+
+    //! Initial seed of #URRMathUtils::RandomStream, from which scenes & actors derive their substreams
+    static int32 GetMasterRandomSeed()
+    {
+        return RandomStream.GetInitialSeed();
+    }
+
+    /**
+     * @brief Get the stream the GetRandom*() functions draw from on the calling thread:
+     * - the innermost #FRRRandomStreamScope of the thread if any, eg a substream per item in a ParallelFor
+     * - #URRMathUtils::RandomStream on game thread
+     * - else a stream of the thread, seeded from the master seed & the thread id, thus thread-safe but not reproducible
+     * @return const FRandomStream&
+     */
+    static const FRandomStream& GetCurrentRandomStream();
+
+    /**
+     * @brief Get a random stream seeded from a base seed & an item index, eg an actor's in a batch, so that each item is
+     * randomized reproducibly whatever the order or thread it is processed in
+     * @param InSeed
+     * @param InIndex
+     * @return FRandomStream
+     */
+    FORCEINLINE static FRandomStream GetRandomSubstream(const int32 InSeed, const int32 InIndex)
+    {
+        return FRandomStream(static_cast<int32>(HashCombine(GetTypeHash(InSeed), GetTypeHash(InIndex))));
+    }
+
+    /**
+     * @brief Get a random stream of a scene instance & an item in it, eg an actor's unique id, derived from the master seed
+     * @param InSceneId
+     * @param InIndex
+     * @return FRandomStream
+     */
+    FORCEINLINE static FRandomStream GetSceneRandomSubstream(const int32 InSceneId, const int32 InIndex)
+    {
+        return GetRandomSubstream(GetSceneRandomSeed(InSceneId), InIndex);
+    }
+
+    //! Seed of a scene instance's substreams, as set by #SetSceneRandomSeed() if so, else derived from the master seed
+    static int32 GetSceneRandomSeed(const int32 InSceneId);
+
+    /**
+     * @brief Seed a scene instance's substreams independently of the master seed, eg each forked episode of a scenario.
+     * To be set on game thread before the scene instance draws from them.
+     * @param InSceneId
+     * @param InSeed 0 to derive it from the master seed again
+     */
+    static void SetSceneRandomSeed(const int32 InSceneId, const int32 InSeed);
+
+    // Batched sampling, filling arrays from a given stream, eg one substream per ParallelFor item
+
+    //! Fill OutValues with floats in [InMin, InMax]
+    static void FillRandomFloatsInRange(const FRandomStream& InStream, TArrayView<float> OutValues, float InMin, float InMax);
+
+    //! Fill OutValues with integers in [InMin, InMax]
+    static void FillRandomIntegersInRange(const FRandomStream& InStream, TArrayView<int32> OutValues, int32 InMin, int32 InMax);
+
+    //! Fill OutLocations with locations in the box between InLocationA & InLocationB
+    static void FillRandomLocations(const FRandomStream& InStream,
+                                    TArrayView<FVector> OutLocations,
+                                    const FVector& InLocationA,
+                                    const FVector& InLocationB);
+
+    //! Fill OutOrientations with uniformly distributed orientations, see #GetRandomOrientation()
+    static void FillRandomOrientations(const FRandomStream& InStream, TArrayView<FQuat> OutOrientations);
+
     /**
      * @brief Get the Random Element of given array
      *
@@ -149,13 +273,14 @@ public:
 
     //! Return an almost uniformly distributed float random number in [0, 1]
     /**
-     * @brief Return an almost uniformly distributed float random number in [0, 1]. Calls GetFraction from #URRMathUtils::RandomStream.
+     * @brief Return an almost uniformly distributed float random number in [0, 1].
+     * Calls GetFraction from #GetCurrentRandomStream().
      * @sa [GetFraction](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Core/Math/FRandomStream/GetFraction/)
      * @return float
      */
     FORCEINLINE static float GetRandomBias()
     {
-        return RandomStream.GetFraction();
+        return GetCurrentRandomStream().GetFraction();
     }
 
     /**
@@ -201,7 +326,7 @@ public:
      */
     FORCEINLINE static float GetRandomFloatInRange(float InValueA, float InValueB)
     {
-        return RandomStream.FRandRange(InValueA, InValueB);
+        return GetCurrentRandomStream().FRandRange(InValueA, InValueB);
     }
 
     /**
@@ -212,7 +337,7 @@ public:
      */
     FORCEINLINE static float GetRandomFloatInRange(const FVector2f& InValueRange)
     {
-        return RandomStream.FRandRange(InValueRange.X, InValueRange.Y);
+        return GetCurrentRandomStream().FRandRange(InValueRange.X, InValueRange.Y);
     }
 
     /**
@@ -224,7 +349,7 @@ public:
      */
     FORCEINLINE static int32 GetRandomIntegerInRange(int32 InValueA, int32 InValueB)
     {
-        return RandomStream.RandRange(InValueA, InValueB);
+        return GetCurrentRandomStream().RandRange(InValueA, InValueB);
     }
 
     /**
@@ -235,7 +360,7 @@ public:
      */
     FORCEINLINE static int32 GetRandomIntegerInRange(int32 InValueMax)
     {
-        return RandomStream.RandRange(0, InValueMax);
+        return GetCurrentRandomStream().RandRange(0, InValueMax);
     }
 
     /**
@@ -246,7 +371,7 @@ public:
     */
     FORCEINLINE static int32 GetRandomIntegerInRange(const FIntPoint& InValueRange)
     {
-        return RandomStream.RandRange(InValueRange.X, InValueRange.Y);
+        return GetCurrentRandomStream().RandRange(InValueRange.X, InValueRange.Y);
     }
 
     /**
@@ -272,12 +397,18 @@ public:
      * @return FQuat
      */
     FORCEINLINE static FQuat GetRandomOrientation()
+    {
+        return GetRandomOrientation(GetCurrentRandomStream());
+    }
+
+    //! #GetRandomOrientation(), drawn from a given stream
+    FORCEINLINE static FQuat GetRandomOrientation(const FRandomStream& InStream)
     {
         static constexpr float C2PI = 2.f * PI;
 
-        const float u1 = GetRandomBias();
-        const float u2 = GetRandomFloatInRange(0.f, C2PI);
-        const float u3 = GetRandomFloatInRange(0.f, C2PI);
+        const float u1 = InStream.GetFraction();
+        const float u2 = InStream.FRandRange(0.f, C2PI);
+        const float u3 = InStream.FRandRange(0.f, C2PI);
         const float sqrt_u1 = FMath::Sqrt(u1);
         const float sqrt_1_u1 = FMath::Sqrt(1 - u1);
 
@@ -320,6 +451,23 @@ public:
      * @return FVector
      */
     static FVector GetRandomSphericalPosition(const FVector& InCenter,
+                                              const FVector2f& InDistanceRange,
+                                              const FVector2f& InHeightRange)
+    {
+        return GetRandomSphericalPosition(GetCurrentRandomStream(), InCenter, InDistanceRange, InHeightRange);
+    }
+
+    /**
+     * @brief Get the Random Spherical Position object, drawn from a given stream, eg from #GetRandomSubstream()
+     *
+     * @param InStream
+     * @param InCenter
+     * @param InDistanceRange
+     * @param InHeightRange
+     * @return FVector
+     */
+    static FVector GetRandomSphericalPosition(const FRandomStream& InStream,
+                                              const FVector& InCenter,
                                               const FVector2f& InDistanceRange,
                                               const FVector2f& InHeightRange);
 
@@ -359,7 +507,18 @@ public:
      */
     FORCEINLINE static FLinearColor GetRandomColor()
     {
-        return FLinearColor(GetRandomBias(), GetRandomBias(), GetRandomBias(), GetRandomBias());
+        return GetRandomColor(GetCurrentRandomStream());
+    }
+
+    /**
+     * @brief Get the Random Color, drawn from a given stream
+     *
+     * @param InStream
+     * @return FLinearColor
+     */
+    FORCEINLINE static FLinearColor GetRandomColor(const FRandomStream& InStream)
+    {
+        return FLinearColor(InStream.GetFraction(), InStream.GetFraction(), InStream.GetFraction(), InStream.GetFraction());
     }
 
     /**
@@ -428,4 +587,24 @@ public:
 
 private:
     static FRandomStream RandomStream;
+
+    //! Set by #SetSceneRandomSeed()
+    static TMap<int32, int32> SceneRandomSeeds;
+};
+
+/**
+ * @brief Makes the URRMathUtils::GetRandom*() functions of the calling thread draw from a given stream during its lifetime,
+ * eg in a ParallelFor body with a #URRMathUtils::GetRandomSubstream() per item, for reproducible parallel randomization.
+ * Scopes nest, the stream must outlive the scope.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRRandomStreamScope
+{
+public:
+    explicit FRRRandomStreamScope(const FRandomStream& InStream);
+    ~FRRRandomStreamScope();
+
+    static const FRandomStream* GetCurrent();
+
+private:
+    const FRandomStream* PrevStream = nullptr;
 };
@@ -19,6 +19,8 @@
 
 DECLARE_DELEGATE_OneParam(FOnMeshActorDeactivated, ARRMeshActor*);
 
+class URRInstancedMeshGroupComponent;
+
 /**
  * @brief Mesh actor.#ARRBaseActor with list of #UMeshComponent
  * @sa #RRProceduralMeshComponent
@@ -93,6 +95,14 @@ public:
     UPROPERTY(VisibleAnywhere)
     UMeshComponent* BaseMeshComp = nullptr;
 
+    //! Instanced group comp rendering this actor in place of #BaseMeshComp, if any
+    UPROPERTY()
+    TWeakObjectPtr<URRInstancedMeshGroupComponent> InstancedGroupComp;
+
+    //! Instance index in #InstancedGroupComp
+    UPROPERTY()
+    int32 InstanceIndex = INDEX_NONE;
+
     /**
      * @brief Get #BaseMeshComp's material
      * @param InMaterialIndex
@@ -172,6 +182,11 @@ public:
 
             if (meshComp)
             {
+                if constexpr (TIsDerivedFrom<TMeshComp, URRStaticMeshComponent>::Value)
+                {
+                    meshComp->LODSettings = ActorInfo->MeshLODSettings;
+                }
+
                 // (Note) This must be the full path to the mesh file on disk
                 if (meshComp->InitializeMesh(meshUniqueName))
                 {
@@ -248,7 +263,7 @@ public:
     bool IsCustomDepthEnabled() const;
 
     /**
-     * @brief Get mesh comps' custom depth stencil values
+     * @brief Get mesh comps' seg mask ids, custom depth stencil values or instance ids, see URRUObjectUtils::GetSegMaskId()
       * @return TArray<int32> 
       */
     TArray<int32> GetCustomDepthStencilValueList() const;
@@ -301,4 +316,7 @@ protected:
     //! Whether all body meshes are fully created
     UPROPERTY(VisibleAnywhere)
     uint8 bFullyCreated : 1;
+
+    //! Whether mesh comps' seg mask ids are from ActorCommon's allocator, thus to be released on deactivation
+    bool bSegMaskIdsAllocated = false;
 };
@@ -0,0 +1,107 @@
+/**
+ * @file RRMeshCache.h
+ * @brief On-disk cache of the mesh data imported from mesh files, to skip Assimp import & post-processing on later runs.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRActorCommon.h"
+
+struct FRRMeshData;
+struct FRRConvexDecompositionSettings;
+
+/**
+ * @brief Compact binary cache of post-processed #FRRMeshData, under [ProjectSavedDir]/RRMeshCache.
+ * Entries are keyed by the MD5 of the mesh file content (#GetContentHash), the mesh scale, LOD settings & #VERSION, which is
+ * to be bumped upon any change of #URRMeshUtils::LoadMeshFromFile() import flags or of the cache layout.
+ * Cache files are memory-mapped upon loading.
+ * Geometry & material colors are cached, while material instances are recreated from them. Convex hulls decomposed at
+ * runtime for simple collision are cached alongside, as .rrhull files.
+ * Disabled by rr.MeshCache.Enabled 0.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRMeshCache
+{
+public:
+    static constexpr uint32 MAGIC = 0x48534D52;    // "RMSH"
+    static constexpr uint32 VERSION = 4;
+
+    static bool IsEnabled();
+
+    /**
+     * @brief Get the MD5 of a mesh file content, memoized per file path as long as its size & timestamp are unchanged.
+     * Also used as the mesh identity of dynamic resources by #URRGameSingleton::GetMeshUniqueName(). Thread-safe.
+     * @param InMeshFilePath
+     * @return FString Empty if the mesh file could not be read
+     */
+    static FString GetContentHash(const FString& InMeshFilePath);
+
+    /**
+     * @brief Get the cache file path of a mesh file, hashing its content
+     * @param InMeshFilePath
+     * @param InMeshScale
+     * @param InLODSettings LODs generated upon importing
+     * @return FString Empty if the mesh file could not be hashed
+     */
+    static FString GetCacheFilePath(const FString& InMeshFilePath,
+                                    const float InMeshScale,
+                                    const FRRMeshLODSettings& InLODSettings = FRRMeshLODSettings());
+
+    /**
+     * @brief Load geometry & materials data from a cache file, leaving #FRRMeshData::MaterialInstances to the caller
+     * @param InCacheFilePath
+     * @param OutMeshData
+     * @return true if the cache file exists & is of the current #VERSION
+     */
+    static bool Load(const FString& InCacheFilePath, FRRMeshData& OutMeshData);
+
+    /**
+     * @brief Save InMeshData to a cache file, written to a temporary file first so that concurrent loaders never read a
+     * partial file
+     * @param InCacheFilePath
+     * @param InMeshData
+     * @return true if saved
+     */
+    static bool Save(const FString& InCacheFilePath, const FRRMeshData& InMeshData);
+
+    /**
+     * @brief Get the cache file path of the convex hulls decomposed from a collision mesh, hashing its geometry
+     * @param InVertices
+     * @param InIndices
+     * @param InSettings
+     * @return FString
+     */
+    static FString GetHullsCacheFilePath(const TArray<FVector3f>& InVertices,
+                                         const TArray<uint32>& InIndices,
+                                         const FRRConvexDecompositionSettings& InSettings);
+
+    /**
+     * @brief Load convex hulls, each as its vertices, from a cache file
+     * @param InCacheFilePath
+     * @param OutHulls
+     * @return true if the cache file exists & is of the current #VERSION
+     */
+    static bool LoadHulls(const FString& InCacheFilePath, TArray<TArray<FVector3f>>& OutHulls);
+
+    /**
+     * @brief Save convex hulls to a cache file, atomically as #Save()
+     * @param InCacheFilePath
+     * @param InHulls
+     * @return true if saved
+     */
+    static bool SaveHulls(const FString& InCacheFilePath, const TArray<TArray<FVector3f>>& InHulls);
+
+private:
+    static void Serialize(FArchive& Ar, FRRMeshData& InOutMeshData);
+    static void SerializeHulls(FArchive& Ar, TArray<TArray<FVector3f>>& InOutHulls);
+
+    //! Read a whole memory-mapped cache file through InSerializeFunc, once its header has been checked
+    static bool LoadFile(const FString& InCacheFilePath, TFunctionRef<void(FArchive&)> InSerializeFunc);
+
+    //! Write a cache file with its header, through InSerializeFunc
+    static bool SaveFile(const FString& InCacheFilePath, TFunctionRef<void(FArchive&)> InSerializeFunc);
+};
@@ -14,6 +14,7 @@
 // UE
 #include "Engine/Texture.h"
 #include "Materials/MaterialInstanceDynamic.h"
+#include "PackedNormal.h"
 #include "ProceduralMeshComponent.h"
 
 // Assimp
@@ -98,33 +99,57 @@ struct RAPYUTASIMULATIONPLUGINS_API FRRBoneVertInfo
 };
 
 /**
- * @brief todo
- *
+ * @brief Compact interleaved vertex of #FRRMeshNodeData: float32 position & UV, quantized normal & tangent.
+ * The tangent's W is -1 if its bitangent is flipped, as FProcMeshTangent::bFlipTangentY.
+ */
+struct FRRMeshVertex
+{
+    FVector3f Position = FVector3f::ZeroVector;
+    FVector2f UV = FVector2f::ZeroVector;
+    FPackedNormal Normal = FPackedNormal(FVector3f::ZeroVector);
+    FPackedNormal Tangent = FPackedNormal(FVector4f(1.f, 0.f, 0.f, 1.f));
+};
+
+/**
+ * @brief Triangle indices of a LOD of #FRRMeshNodeData, indexing the same vertices as LOD0
  */
 USTRUCT()
-struct RAPYUTASIMULATIONPLUGINS_API FRRMeshNodeData
+struct RAPYUTASIMULATIONPLUGINS_API FRRMeshLODData
 {
     GENERATED_BODY()
 
-    UPROPERTY()
-    TArray<FVector> Vertices;
-    UPROPERTY()
-    TArray<FColor> VertexColors;
-
     UPROPERTY()
     TArray<int32> TriangleIndices;
+};
 
-    UPROPERTY()
-    TArray<FVector> Normals;
+/**
+ * @brief Mesh data of a node, resident in #FRRMeshData::MeshDataStore thus kept compact: vertices are #FRRMeshVertex, while
+ * vertex colors are only allocated if the mesh has them.
+ * Components expand it to the procedural mesh layout by #ToProcMeshSection.
+ */
+USTRUCT()
+struct RAPYUTASIMULATIONPLUGINS_API FRRMeshNodeData
+{
+    GENERATED_BODY()
+
+    //! Not a UPROPERTY, #FRRMeshVertex not being reflected, but referencing no UObject
+    TArray<FRRMeshVertex> Vertices;
 
+    //! Empty if the mesh has no vertex colors, in which case they are black
     UPROPERTY()
-    TArray<FVector2f> UV2fs;
+    TArray<FColor> VertexColors;
 
     UPROPERTY()
-    TArray<FVector2D> UVs;
+    TArray<int32> TriangleIndices;
 
+    //! LOD1, LOD2, etc. generated by #FRRMeshSimplifier, empty if LODs are not enabled
     UPROPERTY()
-    TArray<FProcMeshTangent> ProcTangents;
+    TArray<FRRMeshLODData> LODs;
+
+    const TArray<int32>& GetTriangleIndices(const int32 InLODIndex) const
+    {
+        return LODs.IsValidIndex(InLODIndex - 1) ? LODs[InLODIndex - 1].TriangleIndices : TriangleIndices;
+    }
 
     UPROPERTY()
     TArray<FRRBoneInfluence> BoneInfluences;
@@ -134,16 +159,60 @@ struct RAPYUTASIMULATIONPLUGINS_API FRRMeshNodeData
 
     void Reset(uint64 InNum = 0)
     {
-        Vertices.SetNumZeroed(InNum);
-        VertexColors.SetNumZeroed(InNum);
-        Normals.SetNumZeroed(InNum);
-        UVs.SetNumZeroed(InNum);
-        UV2fs.SetNumZeroed(InNum);
-        ProcTangents.SetNumZeroed(InNum);
+        Vertices.SetNum(InNum);
+        VertexColors.Reset();
         TriangleIndices.SetNumZeroed(3 * InNum);
+        LODs.Reset();
         BoneInfluences.Reset();
     }
 
+    bool HasVertexColors() const
+    {
+        return VertexColors.Num() > 0;
+    }
+
+    FVector GetPosition(const int32 InIndex) const
+    {
+        return FVector(Vertices[InIndex].Position);
+    }
+
+    FVector GetNormal(const int32 InIndex) const
+    {
+        return FVector(Vertices[InIndex].Normal.ToFVector3f());
+    }
+
+    FVector2D GetUV(const int32 InIndex) const
+    {
+        return FVector2D(Vertices[InIndex].UV);
+    }
+
+    FColor GetVertexColor(const int32 InIndex) const
+    {
+        return HasVertexColors() ? VertexColors[InIndex] : FColor::Black;
+    }
+
+    void GetPositions(TArray<FVector>& OutPositions) const;
+
+    /**
+     * @brief Expand to the layout taken by UProceduralMeshComponent::CreateMeshSection()
+     */
+    void ToProcMeshSection(TArray<FVector>& OutVertices,
+                           TArray<FVector>& OutNormals,
+                           TArray<FVector2D>& OutUVs,
+                           TArray<FColor>& OutVertexColors,
+                           TArray<FProcMeshTangent>& OutTangents) const;
+
+    /**
+     * @brief Set vertices from the procedural mesh layout, InNormals, InUVs, InVertexColors, InTangents being optional
+     */
+    void FromProcMeshSection(const TArray<FVector>& InVertices,
+                             const TArray<FVector>& InNormals,
+                             const TArray<FVector2D>& InUVs,
+                             const TArray<FColor>& InVertexColors,
+                             const TArray<FProcMeshTangent>& InTangents);
+
+    void TransformBy(const FTransform& InTransform);
+
     void PrintSelf() const;
 };
 
@@ -166,6 +235,53 @@ struct RAPYUTASIMULATIONPLUGINS_API FRRMeshNode
     TArray<FRRMeshNodeData> Meshes;
 };
 
+/**
+ * @brief Material params parsed from a mesh file, from which #FRRMeshData::MaterialInstances are created, their vector params
+ * also being what #FRRMeshCache stores of materials.
+ * Collected on the mesh loader thread, then applied all at once in the game thread by #URRMeshUtils::ApplyMaterialParams().
+ */
+USTRUCT()
+struct RAPYUTASIMULATIONPLUGINS_API FRRMeshMaterialData
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TMap<FName, FLinearColor> VectorParams;
+
+    //! Texture maps loaded from files next to the mesh file, not cached
+    UPROPERTY()
+    TMap<FName, UTexture*> TextureParams;
+};
+
+/**
+ * @brief Stats of #FRRMeshData::MeshDataStore, logged by rr.MeshDataStore.Stats
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRMeshDataStoreStats
+{
+    uint64 HitsNum = 0;
+    uint64 MissesNum = 0;
+    uint64 EvictionsNum = 0;
+    int64 ResidentBytes = 0;
+    int32 EntriesNum = 0;
+
+    float GetHitRate() const
+    {
+        const uint64 lookupsNum = HitsNum + MissesNum;
+        return (lookupsNum > 0) ? (static_cast<float>(HitsNum) / lookupsNum) : 0.f;
+    }
+
+    FString ToString() const
+    {
+        return FString::Printf(TEXT("%d entries - %.2f MB resident - hit rate %.1f%% (%llu/%llu) - %llu evicted"),
+                               EntriesNum,
+                               ResidentBytes / (1024.f * 1024.f),
+                               100.f * GetHitRate(),
+                               HitsNum,
+                               HitsNum + MissesNum,
+                               EvictionsNum);
+    }
+};
+
 /**
  * @brief todo
  *
@@ -175,21 +291,49 @@ struct RAPYUTASIMULATIONPLUGINS_API FRRMeshData
 {
     GENERATED_BODY()
 private:
-    static TMap<FString /* MeshUniqueName */, TSharedPtr<FRRMeshData>> MeshDataStore;
+    struct FStoreEntry
+    {
+        TSharedPtr<FRRMeshData> MeshData;
+        int64 Bytes = 0;
+        uint64 LastAccess = 0;
+        //! Whether the UStaticMesh has been built from it, thus its CPU-side data only needed by later procedural meshes
+        bool bResourceBuilt = false;
+    };
+
+    /**
+     * Bounded by rr.MeshDataStore.BudgetMB, evicting least recently used entries referenced by no one else, those whose
+     * resource has been built first. Game thread only.
+     */
+    static TMap<FString /* MeshUniqueName */, FStoreEntry> MeshDataStore;
+    static FRRMeshDataStoreStats MeshDataStoreStats;
+    static uint64 MeshDataStoreAccessCounter;
+
+    //! Evict entries until the store fits in its budget
+    static void TrimMeshDataStore();
 
 public:
-    static void AddMeshData(const FString& InMeshUniqueName, const TSharedPtr<FRRMeshData>& InMeshData)
-    {
-        MeshDataStore.Add(InMeshUniqueName, InMeshData);
-    }
-    static TSharedPtr<FRRMeshData> GetMeshData(const FString& InMeshUniqueName)
-    {
-        return MeshDataStore.FindRef(InMeshUniqueName);
-    }
+    /**
+     * @brief Add InMeshData to #MeshDataStore, releasing its #MeshImporter whose scene has already been converted
+     * @param InMeshUniqueName
+     * @param InMeshData
+     * @param bInResourceBuilt Whether the UStaticMesh has already been built from InMeshData
+     */
+    static void AddMeshData(const FString& InMeshUniqueName,
+                            const TSharedPtr<FRRMeshData>& InMeshData,
+                            bool bInResourceBuilt = false);
+
+    static TSharedPtr<FRRMeshData> GetMeshData(const FString& InMeshUniqueName);
     static bool IsMeshDataAvailable(const FString& InMeshUniqueName)
     {
         return MeshDataStore.Contains(InMeshUniqueName);
     }
+    static const FRRMeshDataStoreStats& GetMeshDataStoreStats()
+    {
+        return MeshDataStoreStats;
+    }
+
+    //! Allocated bytes of the CPU-side data
+    int64 GetAllocatedSize() const;
 
     UPROPERTY()
     FString MeshUniqueName;
@@ -207,12 +351,17 @@ public:
     UPROPERTY()
     TArray<FRRMeshNode> Nodes;
 
+    UPROPERTY()
+    TArray<FRRMeshMaterialData> Materials;
+
+    //! Created from #Materials
     UPROPERTY()
     TArray<UMaterialInstanceDynamic*> MaterialInstances;
 
     void Reset()
     {
         Nodes.Reset();
+        Materials.Reset();
         MaterialInstances.Reset();
     }
 
@@ -224,22 +373,23 @@ public:
         {
             for (auto& mesh : meshNode.Meshes)
             {
-                for (auto& vertex : mesh.Vertices)
-                {
-                    vertex = InTransform.TransformPosition(vertex);
-                }
-
-                for (auto& normal : mesh.Normals)
-                {
-                    normal = InTransform.TransformVectorNoScale(normal);
-                }
+                mesh.TransformBy(InTransform);
+            }
+        }
+    }
 
-                for (auto& procTangent : mesh.ProcTangents)
-                {
-                    procTangent.TangentX = InTransform.TransformVectorNoScale(procTangent.TangentX);
-                }
+    //! Including LOD0
+    int32 GetLODsNum() const
+    {
+        int32 lodsNum = 1;
+        for (const auto& meshNode : Nodes)
+        {
+            for (const auto& mesh : meshNode.Meshes)
+            {
+                lodsNum = FMath::Max(lodsNum, 1 + mesh.LODs.Num());
             }
         }
+        return lodsNum;
     }
 
     int32 GetVerticesNum() const
@@ -261,7 +411,7 @@ public:
         {
             for (const auto& mesh : meshNode.Meshes)
             {
-                if (mesh.VertexColors.Num() > 0)
+                if (mesh.HasVertexColors())
                 {
                     return true;
                 }
@@ -289,7 +439,7 @@ public:
         {
             for (const auto& mesh : meshNode.Meshes)
             {
-                return mesh.UVs.Num();
+                return mesh.Vertices.Num();
             }
         }
         return 0;
@@ -0,0 +1,43 @@
+/**
+ * @file RRMeshSimplifier.h
+ * @brief Quadric error metric mesh simplification, generating the LODs of meshes loaded at runtime.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRMeshData.h"
+
+/**
+ * @brief Edge collapse simplifier, after Garland & Heckbert, "Surface Simplification Using Quadric Error Metrics".
+ * Edges are collapsed onto one of their end vertices, so simplified triangles keep indexing the source vertices, a LOD
+ * thus only holding its own triangle indices, as #FRRMeshLODData.
+ * Vertices sharing a position are welded for collapsing, keeping the surface closed along UV/normal seams, while open
+ * boundaries are preserved by penalty planes. Collapses flipping triangles are rejected.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRMeshSimplifier
+{
+public:
+    /**
+     * @brief Simplify a triangle list down to about InTargetTrianglesNum triangles
+     * @param InVertices
+     * @param InTriangleIndices
+     * @param InTargetTrianglesNum
+     * @param OutTriangleIndices Indexing InVertices, as InTriangleIndices if it could not be simplified
+     */
+    static void Simplify(const TArray<FRRMeshVertex>& InVertices,
+                         const TArray<int32>& InTriangleIndices,
+                         const int32 InTargetTrianglesNum,
+                         TArray<int32>& OutTriangleIndices);
+
+    /**
+     * @brief Generate InOutMeshData meshes' LODs as per InLODSettings, in parallel
+     * @param InLODSettings
+     * @param InOutMeshData
+     */
+    static void GenerateLODs(const FRRMeshLODSettings& InLODSettings, FRRMeshData& InOutMeshData);
+};
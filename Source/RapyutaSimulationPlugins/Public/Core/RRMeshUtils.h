@@ -39,7 +39,8 @@ public:
     static FRRMeshNodeData ProcessMesh(aiMesh* InMesh);
     
     /**
-     * @brief 
+     * @brief Flatten the node tree into OutMeshData's Nodes with #FlattenMeshNode, then convert all their meshes with
+     * #ProcessMesh in parallel.
      * @note Use [int] instead of [int32 ,int64] due to the compatibility with Assimp's api
      * 
      * @param InNode 
@@ -58,8 +59,66 @@ public:
                                const aiTextureType InTextureType,
                                const TCHAR* InTextureTypeName,
                                const FString& InTextureBasePath,
-                               UMaterialInstanceDynamic* OutUEMaterial);
+                               FRRMeshMaterialData& OutMaterialData);
     static void ProcessMaterial(aiMaterial* InMaterial, const FString& InMeshFilePath, FRRMeshData& OutMeshData);
 
-    static FRRMeshData LoadMeshFromFile(const FString& InMeshFilePath, Assimp::Importer& InMeshImporter, float InMeshScale = 1.f);
+    /**
+     * @brief Create a material instance of the prop master material, whose params are set later by #ApplyMaterialParams().
+     * @return UMaterialInstanceDynamic*
+     */
+    static UMaterialInstanceDynamic* CreateMaterialInstance();
+
+    /**
+     * @brief Set all #FRRMeshData::Materials params to their #FRRMeshData::MaterialInstances in a single game-thread task
+     * @param InMeshData
+     */
+    static void ApplyMaterialParams(const FRRMeshData& InMeshData);
+
+    /**
+     * @brief Load mesh data from #FRRMeshCache if cached for the same file content, scale & LODs, otherwise load it natively
+     * by #FRRGLTFLoader if a glTF file it supports, or import it with Assimp, generating its LODs, then cache it.
+     * @param InMeshFilePath
+     * @param InMeshImporter
+     * @param InMeshScale
+     * @param InLODSettings
+     * @return FRRMeshData
+     */
+    static FRRMeshData LoadMeshFromFile(const FString& InMeshFilePath,
+                                        Assimp::Importer& InMeshImporter,
+                                        float InMeshScale = 1.f,
+                                        const FRRMeshLODSettings& InLODSettings = FRRMeshLODSettings());
+
+    /**
+     * @brief Same as above, an Assimp importer being only created, as #FRRMeshData::MeshImporter, if the mesh is neither
+     * cached nor loaded natively
+     */
+    static FRRMeshData LoadMeshFromFile(const FString& InMeshFilePath,
+                                        float InMeshScale = 1.f,
+                                        const FRRMeshLODSettings& InLODSettings = FRRMeshLODSettings());
+
+private:
+    //! InMeshImporter being null if to be created on demand
+    static FRRMeshData LoadMeshFromFileImpl(const FString& InMeshFilePath,
+                                            Assimp::Importer* InMeshImporter,
+                                            float InMeshScale,
+                                            const FRRMeshLODSettings& InLODSettings);
+
+    //! A mesh to be converted into its slot of #FRRMeshData::Nodes
+    struct FRRMeshJob
+    {
+        int32 NodeIndex = 0;
+        int32 MeshIndex = 0;
+        aiMesh* Mesh = nullptr;
+    };
+
+    /**
+     * @brief Add the nodes having meshes to OutMeshData's Nodes, with their mesh slots allocated, collecting their meshes
+     * into OutMeshJobs
+     */
+    static void FlattenMeshNode(aiNode* InNode,
+                                const aiScene* InScene,
+                                int InParentNodeIndex,
+                                int* InCurrentIndex,
+                                FRRMeshData& OutMeshData,
+                                TArray<FRRMeshJob>& OutMeshJobs);
 };
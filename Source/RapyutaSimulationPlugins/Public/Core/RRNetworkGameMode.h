@@ -17,9 +17,12 @@
 #include "RRNetworkGameMode.generated.h"
 
 class ARRNetworkPlayerController;
+class ARRSpectatorPlayerController;
 
 /**
  * @brief GameMode for client-server. This class handles #ANetworkPlayerController initialization from #PostLogin.
+ * Clients joining with the ARRSpectatorPlayerController::SPECTATOR_OPTION URL option are given a
+ * #SpectatorPlayerControllerClass instead, without any ROS 2 interface.
  * @sa [AGameMode](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/GameFramework/AGameMode/)
  */
 UCLASS()
@@ -33,7 +36,13 @@ public:
     UPROPERTY()
     TArray<ARRNetworkPlayerController*> NetworkClientControllerList;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TSubclassOf<ARRSpectatorPlayerController> SpectatorPlayerControllerClass;
+
 protected:
+    //! Spawn a #SpectatorPlayerControllerClass for spectator connections
+    virtual APlayerController* SpawnPlayerController(ENetRole InRemoteRole, const FString& Options) override;
+
     /**
      * @brief Called after a successful login
      * Create #ANetworkPlayerController::ROS2SimStateClient for each client.
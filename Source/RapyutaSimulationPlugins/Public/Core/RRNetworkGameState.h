@@ -29,4 +29,11 @@ public:
      * @return float
      */
     virtual float GetServerWorldTimeSeconds() const override;
+
+    /**
+     * @brief Get the Server World Time in integer nanoseconds, free of float precision loss over long runs
+     *
+     * @return int64
+     */
+    virtual int64 GetServerWorldTimeNanosec() const;
 };
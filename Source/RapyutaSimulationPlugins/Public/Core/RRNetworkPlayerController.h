@@ -6,6 +6,7 @@
 #pragma once
 
 // UE
+#include "Engine/NetSerialization.h"
 #include "GameFramework/Pawn.h"
 #include "GameFramework/PlayerController.h"
 #include "UnrealClient.h"
@@ -22,6 +23,67 @@
 
 #include "RRNetworkPlayerController.generated.h"
 
+/**
+ * @brief Latest movement command of a client robot, batched with others' by #ARRNetworkPlayerController into
+ * #ARRNetworkPlayerController::ServerSetRobotsMovement. Net serialized with quantized vectors & a compressed rotator.
+ */
+USTRUCT()
+struct RAPYUTASIMULATIONPLUGINS_API FRRRobotMovementCommand
+{
+    GENERATED_BODY()
+
+    static constexpr uint8 FLAG_LINEAR = 1 << 0;
+    static constexpr uint8 FLAG_ANGULAR = 1 << 1;
+
+    UPROPERTY()
+    ARRBaseRobot* ServerRobot = nullptr;
+
+    //! Per robot, incremented upon each new command, so that the server drops outdated or duplicated ones
+    UPROPERTY()
+    uint16 SequenceNum = 0;
+
+    //! #FLAG_LINEAR and/or #FLAG_ANGULAR, telling which parts have been commanded & are thus serialized
+    UPROPERTY()
+    uint8 Flags = 0;
+
+    // LINEAR PART, as of #ARRNetworkPlayerController::ServerSetLinearVel
+    UPROPERTY()
+    float LinearTimeStamp = 0.f;
+
+    UPROPERTY()
+    FVector_NetQuantize10 ClientLocation = FVector::ZeroVector;
+
+    UPROPERTY()
+    FRotator ClientLinearRotation = FRotator::ZeroRotator;
+
+    UPROPERTY()
+    FVector_NetQuantize10 LinearVel = FVector::ZeroVector;
+
+    // ANGULAR PART, as of #ARRNetworkPlayerController::ServerSetAngularVel
+    UPROPERTY()
+    float AngularTimeStamp = 0.f;
+
+    UPROPERTY()
+    FRotator ClientAngularRotation = FRotator::ZeroRotator;
+
+    UPROPERTY()
+    FVector_NetQuantize100 AngularVel = FVector::ZeroVector;
+
+    //! Client only, number of batches this command is still to be sent in, as batches are unreliable
+    int32 SendsLeftNum = 0;
+
+    bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FRRRobotMovementCommand> : public TStructOpsTypeTraitsBase2<FRRRobotMovementCommand>
+{
+    enum
+    {
+        WithNetSerializer = true
+    };
+};
+
 /**
  * @brief Network Player controller provides functionality for client-server. Major functionalites are
  * - [UROS2NodeComponent](https://rclue.readthedocs.io/en/devel/doxygen_generated/html/d1/d79/_r_o_s2_node_component_8h.html),  #URRROS2ClockPublisher,  #URRROS2SimulationStateClient are created for each client to provide ROS 2 services which are provided by #ARRROS2GameMode in standalone game.
@@ -98,7 +160,7 @@ public:
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
     FTimerHandle ClockRequestTimerHandle;
 
-    //! Local clock time
+    //! Local clock time, as float seconds of #LocalTimeNanosec
     UPROPERTY()
     float LocalTime = 0.0f;
     virtual float GetLocalTime()
@@ -106,6 +168,28 @@ public:
         return LocalTime;
     }
 
+    //! Local clock time in nanoseconds, synced with the server's sim time
+    int64 GetLocalTimeNanosec() const
+    {
+        return LocalTimeNanosec;
+    }
+
+    //! [s] Interval between clock sync requests, each giving one sample
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float ClockSyncIntervalSec = 1.f;
+
+    //! Number of latest clock sync samples, out of which the one of minimal round trip is used, as in NTP
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 ClockSyncSamplesNum = 8;
+
+    //! Max ratio of the elapsed time by which the local clock is slewed towards the server's
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float MaxClockSlewRate = 0.05f;
+
+    //! [s] Clock offset beyond which the local clock is stepped instead of being slewed, eg upon the first sync
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float ClockStepThresholdSec = 0.5f;
+
     /**
      * @brief [Time Sync Step1] Request server time update from client via #ServerRequestLocalClockUpdate
      */
@@ -113,26 +197,26 @@ public:
 
     /**
      * @brief [Time Sync Step2] Called from the client and execute in the server via RPC.
-     * Get current server time and call #ClientSendLocalClockUpdate with current server time and given InClientRequestTime
+     * Get current server sim time and call #ClientSendLocalClockUpdate with it and given InClientRequestTimeNanosec
      *
-     * @param InClientRequestTime Client Time when client call this method.
+     * @param InClientRequestTimeNanosec Client Time when client call this method.
      */
     UFUNCTION(Server, Reliable)
-    void ServerRequestLocalClockUpdate(float InClientRequestTime);
+    void ServerRequestLocalClockUpdate(int64 InClientRequestTimeNanosec);
 
     /**
      * @brief [Time Sync Step3] Called from the server and execute in the client via RPC.
-     * Sync client time with InServerCurrentTime + delay compendation.
-     * Delay is estimated as 0.5 * (current client time - InClientRequestTime)
+     * Add a sample of the offset to the server clock, as InServerCurrentTimeNanosec + half the round trip - client time,
+     * then slew the local clock towards the offset of the sample having the minimal round trip among the latest ones.
      *
-     * @param InClientRequestTime Client time when client calls #ServerRequestLocalClockUpdate
-     * @param InServerCurrentTime Server time when server call this method
+     * @param InClientRequestTimeNanosec Client time when client calls #ServerRequestLocalClockUpdate
+     * @param InServerCurrentTimeNanosec Server time when server call this method
      */
     UFUNCTION(Client, Reliable)
-    void ClientSendLocalClockUpdate(float InClientRequestTime, float InServerCurrentTime);
+    void ClientSendLocalClockUpdate(int64 InClientRequestTimeNanosec, int64 InServerCurrentTimeNanosec);
 
     /**
-     * @brief Increase local clock's time by delta seconds
+     * @brief Increase local clock's time by delta seconds, plus part of the pending clock correction
      * @param InDeltaSeconds
      */
     void UpdateLocalClock(float InDeltaSeconds);
@@ -165,6 +249,36 @@ public:
                                      const FRotator& InClientRobotRotation,
                                      const FVector& InAngularVel);
 
+    /**
+     * @brief Queue a linear movement command of a locally controlled robot, to be sent in this frame's batch by
+     * #ServerSetRobotsMovement instead of its own #ServerSetLinearVel RPC, if rr.NetworkPlayerController.BatchRobotMovement
+     * @param InServerRobot
+     * @param InClientTimeStamp
+     * @param InClientRobotTransform
+     * @param InLinearVel
+     */
+    void QueueRobotLinearMovement(ARRBaseRobot* InServerRobot,
+                                  float InClientTimeStamp,
+                                  const FTransform& InClientRobotTransform,
+                                  const FVector& InLinearVel);
+
+    //! Angular counterpart of #QueueRobotLinearMovement, replacing #ServerSetAngularVel
+    void QueueRobotAngularMovement(ARRBaseRobot* InServerRobot,
+                                   float InClientTimeStamp,
+                                   const FRotator& InClientRobotRotation,
+                                   const FVector& InAngularVel);
+
+    //! Whether robot movement commands are batched, per rr.NetworkPlayerController.BatchRobotMovement
+    static bool IsRobotMovementBatched();
+
+    /**
+     * @brief Apply a frame's batch of robots' latest movement commands, dropping the ones older than already applied.
+     * Unreliable, each command being resent in a few following batches for loss tolerance.
+     * @param InCommands
+     */
+    UFUNCTION(Server, Unreliable)
+    void ServerSetRobotsMovement(const TArray<FRRRobotMovementCommand>& InCommands);
+
 protected:
     /**
      * @brief
@@ -173,4 +287,42 @@ protected:
      */
     virtual void BeginPlay() override;
     virtual void ReceivedPlayer() override;
+
+    //! Sync a server robot with a client's linear movement
+    void ApplyRobotLinearMovement(ARRBaseRobot* InServerRobot,
+                                  float InClientTimeStamp,
+                                  const FTransform& InClientRobotTransform,
+                                  const FVector& InLinearVel);
+
+    //! Sync a server robot with a client's angular movement
+    void ApplyRobotAngularMovement(ARRBaseRobot* InServerRobot,
+                                   float InClientTimeStamp,
+                                   const FRotator& InClientRobotRotation,
+                                   const FVector& InAngularVel);
+
+    //! Get the queued command of a robot, bumping its sequence num as a new command
+    FRRRobotMovementCommand& QueueRobotMovementCommand(ARRBaseRobot* InServerRobot);
+
+    //! Send queued commands still having sends left in one #ServerSetRobotsMovement batch
+    void FlushRobotMovementCommands();
+
+    struct FRRClockSyncSample
+    {
+        int64 RoundTripNanosec = 0;
+        int64 OffsetNanosec = 0;
+    };
+
+    //! Shift the local clock, keeping the samples' offsets relative to it
+    void ShiftLocalClock(const int64 InShiftNanosec);
+
+    int64 LocalTimeNanosec = 0;
+    int64 PendingClockCorrectionNanosec = 0;
+    bool bClockSynced = false;
+    TArray<FRRClockSyncSample> ClockSyncSamples;
+
+    //! Client only, latest movement command per locally controlled robot
+    TArray<FRRRobotMovementCommand> RobotMovementCommands;
+
+    //! Server only, sequence num of the latest applied command per robot
+    TMap<TWeakObjectPtr<ARRBaseRobot>, uint16> AppliedRobotMovementSequenceNums;
 };
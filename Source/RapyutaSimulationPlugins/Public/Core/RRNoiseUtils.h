@@ -0,0 +1,180 @@
+/**
+ * @file RRNoiseUtils.h
+ * @brief Counter-based random noise utils, for noise generated in parallel.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRMathUtils.h"
+
+/**
+ * @brief Stateless counter-based gaussian noise generator.
+ * Each value is a pure function of a (key, counter) pair, Philox-style, thus:
+ * - it can be generated from any thread without locking, in any order & chunking,
+ * - the same key always gives the same sequence, for reproducible noise.
+ * Keys are usually made from a seed & stream ids with #MakeKey().
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRNoiseUtils
+{
+    //! Values generated per #FillGaussian() iteration, chunks fed to it must start at a multiple of this
+    static constexpr int32 GAUSSIAN_BATCH_SIZE = 8;
+
+    /**
+     * @brief SplitMix64 finalizer, a bijective 64-bit mixing function
+     * @param InX
+     * @return uint64
+     */
+    FORCEINLINE static uint64 Mix(uint64 InX)
+    {
+        InX = (InX ^ (InX >> 30)) * 0xbf58476d1ce4e5b9ull;
+        InX = (InX ^ (InX >> 27)) * 0x94d049bb133111ebull;
+        return InX ^ (InX >> 31);
+    }
+
+    /**
+     * @brief Make a generator key from a seed & two stream ids, eg a scan index & a noise type
+     * @param InSeed
+     * @param InStreamA
+     * @param InStreamB
+     * @return uint64
+     */
+    FORCEINLINE static uint64 MakeKey(const uint32 InSeed, const uint32 InStreamA, const uint32 InStreamB = 0)
+    {
+        return Mix(((static_cast<uint64>(InSeed) << 32) | InStreamA) ^ Mix(static_cast<uint64>(InStreamB) + 1));
+    }
+
+    /**
+     * @brief Get the noise seed of a sensor, derived from #URRMathUtils::GetMasterRandomSeed() & its name unless given,
+     * thus reproducible across runs with -RRRandomSeed=
+     * @param InSeed Used as is if not 0
+     * @param InSensorName Eg the sensor's path name, unique in the world
+     * @return uint32
+     */
+    static uint32 GetSensorSeed(const int32 InSeed, const FString& InSensorName)
+    {
+        return (InSeed != 0) ? static_cast<uint32>(InSeed)
+                             : HashCombine(GetTypeHash(URRMathUtils::GetMasterRandomSeed()), GetTypeHash(InSensorName));
+    }
+
+    /**
+     * @brief Get 64 random bits of a counter in a key's sequence
+     * @param InKey
+     * @param InCounter
+     * @return uint64
+     */
+    FORCEINLINE static uint64 GetBits(const uint64 InKey, const uint64 InCounter)
+    {
+        return Mix(InKey ^ Mix(InCounter));
+    }
+
+    /**
+     * @brief Convert 32 random bits to an uniformly distributed float in (0, 1], from their 24 high bits
+     * @param InBits
+     * @return float
+     */
+    FORCEINLINE static float ToUnitFloat(const uint32 InBits)
+    {
+        return static_cast<float>((InBits >> 8) + 1) * (1.f / 16777216.f);
+    }
+
+    /**
+     * @brief Fill values [InCounterStart, InCounterStart + InNum) of a key's gaussian sequence,
+     * with 4-wide Box-Muller transforms, each giving #GAUSSIAN_BATCH_SIZE values.
+     * @param InKey
+     * @param InCounterStart Must be a multiple of #GAUSSIAN_BATCH_SIZE
+     * @param InMean
+     * @param InStdDev
+     * @param OutValues
+     * @param InNum
+     */
+    static void FillGaussian(const uint64 InKey,
+                             const uint64 InCounterStart,
+                             const float InMean,
+                             const float InStdDev,
+                             float* OutValues,
+                             const int32 InNum)
+    {
+        check(InCounterStart % GAUSSIAN_BATCH_SIZE == 0);
+        alignas(16) float u1[4];
+        alignas(16) float u2[4];
+        alignas(16) float z0[4];
+        alignas(16) float z1[4];
+        const VectorRegister4Float minusTwo = VectorSetFloat1(-2.f);
+        const VectorRegister4Float twoPi = VectorSetFloat1(2.f * PI);
+        const VectorRegister4Float mean = VectorSetFloat1(InMean);
+        const VectorRegister4Float stdDev = VectorSetFloat1(InStdDev);
+        for (int32 i = 0; i < InNum; i += GAUSSIAN_BATCH_SIZE)
+        {
+            // One 64-bit draw per Box-Muller pair
+            const uint64 pairCounter = (InCounterStart + i) / 2;
+            for (int32 k = 0; k < 4; ++k)
+            {
+                const uint64 bits = GetBits(InKey, pairCounter + k);
+                u1[k] = ToUnitFloat(static_cast<uint32>(bits));
+                u2[k] = ToUnitFloat(static_cast<uint32>(bits >> 32));
+            }
+
+            // r = sqrt(-2 ln(u1)), theta = 2 pi u2, z0 = r cos(theta), z1 = r sin(theta)
+            const VectorRegister4Float r = VectorSqrt(VectorMultiply(minusTwo, VectorLog(VectorLoadAligned(u1))));
+            const VectorRegister4Float theta = VectorMultiply(twoPi, VectorLoadAligned(u2));
+            VectorRegister4Float sinTheta, cosTheta;
+            VectorSinCos(&sinTheta, &cosTheta, &theta);
+            VectorStoreAligned(VectorMultiplyAdd(stdDev, VectorMultiply(r, cosTheta), mean), z0);
+            VectorStoreAligned(VectorMultiplyAdd(stdDev, VectorMultiply(r, sinTheta), mean), z1);
+
+            const int32 num = FMath::Min(GAUSSIAN_BATCH_SIZE, InNum - i);
+            for (int32 k = 0; k < num; ++k)
+            {
+                OutValues[i + k] = (k % 2 == 0) ? z0[k / 2] : z1[k / 2];
+            }
+        }
+    }
+};
+
+/**
+ * @brief Sequential gaussian noise of one key, generated by batches of #FRRNoiseUtils::GAUSSIAN_BATCH_SIZE.
+ * Replaces per-sensor std::mt19937 & std::normal_distribution, while being owned by one sensor & used by one thread at a
+ * time, eg in a ParallelFor across robots, its sequence only depending on its key.
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRNoiseStream
+{
+    FRRNoiseStream() = default;
+    explicit FRRNoiseStream(const uint64 InKey) : Key(InKey)
+    {
+    }
+
+    void Reset(const uint64 InKey)
+    {
+        Key = InKey;
+        Counter = 0;
+        BatchIndex = FRRNoiseUtils::GAUSSIAN_BATCH_SIZE;
+    }
+
+    //! Next value of the standard normal distribution
+    FORCEINLINE float NextGaussian()
+    {
+        if (BatchIndex >= FRRNoiseUtils::GAUSSIAN_BATCH_SIZE)
+        {
+            FRRNoiseUtils::FillGaussian(Key, Counter, 0.f, 1.f, Batch, FRRNoiseUtils::GAUSSIAN_BATCH_SIZE);
+            Counter += FRRNoiseUtils::GAUSSIAN_BATCH_SIZE;
+            BatchIndex = 0;
+        }
+        return Batch[BatchIndex++];
+    }
+
+    FORCEINLINE float NextGaussian(const float InMean, const float InStdDev)
+    {
+        return InMean + InStdDev * NextGaussian();
+    }
+
+private:
+    uint64 Key = 0;
+    uint64 Counter = 0;
+    int32 BatchIndex = FRRNoiseUtils::GAUSSIAN_BATCH_SIZE;
+    float Batch[FRRNoiseUtils::GAUSSIAN_BATCH_SIZE] = {};
+};
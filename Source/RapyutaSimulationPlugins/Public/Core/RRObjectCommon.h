@@ -125,6 +125,10 @@ struct RAPYUTASIMULATIONPLUGINS_API FRRResourceInfo
     UPROPERTY()
     int32 ToBeAsyncLoadedResourceNum = 0;
 
+    //! Num of resources, among #ToBeAsyncLoadedResourceNum, in the current resource manifest
+    UPROPERTY()
+    int32 ToBeAsyncLoadedPriorityResourceNum = 0;
+
     UPROPERTY()
     bool bHasBeenAllLoaded = false;
 
@@ -147,6 +151,7 @@ struct RAPYUTASIMULATIONPLUGINS_API FRRResourceInfo
     {
         DataType = ERRResourceDataType::NONE;
         ToBeAsyncLoadedResourceNum = 0;
+        ToBeAsyncLoadedPriorityResourceNum = 0;
         bHasBeenAllLoaded = false;
 
         // BodySetup's collision mesh data are manually created from the underlying Physics engine,
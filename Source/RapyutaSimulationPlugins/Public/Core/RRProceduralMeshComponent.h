@@ -76,12 +76,24 @@ public:
     bool bIsStationary = false;
 
     /**
-     * @brief Create primitive-shape mesh based on #ShapeType.
+     * @brief Create primitive-shape mesh based on #ShapeType, or only rescale it if #bResizeByScale
      *
      * @param InSize
      */
     void SetMeshSize(const FVector& InSize);
 
+    /**
+     * @brief Whether #SetMeshSize() applies sizes as component scale, of a unit-size primitive shape mesh created once, whose
+     * body setup is cooked once & shared by all components of the same shape, collision being scaled at query time.
+     * Thus no geometry or collision cooking work happens per resize, as needed by scene randomization.
+     * Mesh shapes are also resized by scale. Also enabled for all components by rr.ProcMesh.ResizeByScale.
+     */
+    UPROPERTY()
+    bool bResizeByScale = false;
+
+    //! Size of the unit-size primitive shape meshes created if #bResizeByScale, in cm
+    static constexpr float UNIT_SHAPE_SIZE = 100.f;
+
     FVector GetSize() const
     {
         // TBD
@@ -120,8 +132,6 @@ protected:
 private:
     UPROPERTY()
     FTimerHandle CollisionCookingTimerHandle;
-    UPROPERTY()
-    FTimerHandle BodySetupTimerHandle;
 
     /**
      * @brief Create Mesh Body Setup from #FRRMeshData
@@ -132,7 +142,33 @@ private:
      */
     bool CreateMeshBody(const FRRMeshData& InMeshData);
 
-    void CreateMeshSection(const TArray<FRRMeshNodeData>& InMeshSectionData);
+    /**
+     * @brief Create a mesh section per mesh of InMeshSectionData
+     * @param InMeshSectionData
+     * @param bInCreateCollision Whether sections provide their triangles to complex collision cooking
+     */
+    void CreateMeshSection(const TArray<FRRMeshNodeData>& InMeshSectionData, bool bInCreateCollision = true);
 
     void FinalizeMeshBodyCreation(UBodySetup* InBodySetup, const FString& InBodySetupModelName);
+
+    //! Create the primitive-shape mesh & its collision of InSize, based on #ShapeType
+    void CreatePrimitiveShapeMesh(const FVector& InSize);
+
+    /**
+     * @brief Create the collision of the primitive shape as analytic box, sphere & capsule elements of the body setup, or a
+     * convex hull for cylinders, Chaos having no analytic cylinder, instead of cooking the shape mesh.
+     * Disabled by rr.ProcMesh.AnalyticCollision 0.
+     * @param InSize
+     * @param InCenter Shape center in component frame
+     */
+    void CreatePrimitiveShapeCollision(const FVector& InSize, const FVector& InCenter);
+
+    //! Sides of the convex hull of cylinder collisions
+    static constexpr int32 CYLINDER_COLLISION_SIDES_NUM = 16;
+
+    //! Size of the mesh at unit scale, zero if not available yet
+    FVector GetUnitShapeSize() const;
+
+    //! #SetMeshSize() if #bResizeByScale
+    void SetMeshSizeByScale(const FVector& InSize);
 };
@@ -12,13 +12,21 @@
 #include "Tools/RRLimitRTFFixedSizeCustomTimeStep.h"
 
 // RapyutaSimulationPlugins
+#include "Tools/RRInputReplay.h"
 #include "Tools/RRROS2SimulationStateClient.h"
 #include "Tools/SimulationState.h"
 
 #include "RRROS2GameMode.generated.h"
 
 class AROS2Node;
+class URRCrowdROS2Bridge;
+class URRROS2InterfacePool;
+class URRROS2NodePool;
 class URRROS2ClockPublisher;
+class URRROS2MemoryStatsPublisher;
+class URRROS2SensorDiagnosticsPublisher;
+class URRROS2StartupProfilePublisher;
+class URRROS2TFAggregatePublisher;
 
 DECLARE_MULTICAST_DELEGATE(FRROnROS2Initialized);
 
@@ -47,6 +55,82 @@ public:
     UPROPERTY(BlueprintReadOnly)
     URRROS2ClockPublisher* ClockPublisher = nullptr;
 
+    //! Publish the stats of all sensors on /diagnostics, see rr.SensorStats console command for the same in logs
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bPublishSensorDiagnostics = false;
+
+    UPROPERTY(BlueprintReadOnly)
+    URRROS2SensorDiagnosticsPublisher* SensorDiagnosticsPublisher = nullptr;
+
+    //! Publish the time spent per startup & spawn phase on /startup_profile, see rr.StartupProfile console command
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bPublishStartupProfile = false;
+
+    UPROPERTY(BlueprintReadOnly)
+    URRROS2StartupProfilePublisher* StartupProfilePublisher = nullptr;
+
+    //! Publish the memory held per plugin subsystem on /memory_stats, see rr.MemStats console command
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bPublishMemoryStats = false;
+
+    UPROPERTY(BlueprintReadOnly)
+    URRROS2MemoryStatsPublisher* MemoryStatsPublisher = nullptr;
+
+    //! Record the ROS inputs into #InputReplayFilePath, or replay them from it, overridden by -RRInputRecord=<path> or
+    //! -RRInputReplay=<path>
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    ERRInputReplayMode InputReplayMode = ERRInputReplayMode::NONE;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FString InputReplayFilePath;
+
+    UPROPERTY(BlueprintReadOnly)
+    URRInputReplay* InputReplay = nullptr;
+
+    //! Record the published msgs into this MCAP file if not empty, with #FRRMcapRecorder, overridden by -RRRecord=<path>
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FString McapRecordFilePath;
+
+    //! Batch the transforms of all TF publishers with #URRROS2TFPublisher::bAggregate into one /tf msg per frame
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bAggregateTF = false;
+
+    UPROPERTY(BlueprintReadOnly)
+    URRROS2TFAggregatePublisher* TFAggregatePublisher = nullptr;
+
+    UPROPERTY(BlueprintReadOnly)
+    URRROS2TFAggregatePublisher* StaticTFAggregatePublisher = nullptr;
+
+    /**
+     * @brief Get the single ROS 2 interface of crowd agents, creating it upon the first fetching, initialized with
+     * #MainROS2Node as soon as it is
+     * @return URRCrowdROS2Bridge*
+     */
+    UFUNCTION(BlueprintCallable)
+    URRCrowdROS2Bridge* GetCrowdROS2Bridge();
+
+    //! Num of ROS 2 nodes shared by all robots' ROS 2 interfaces, 0 for one node per robot
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 RobotROS2NodePoolSize = 0;
+
+    /**
+     * @brief Get the pool of ROS 2 nodes shared by robots, creating it upon the first fetching
+     * @return URRROS2NodePool* nullptr if #RobotROS2NodePoolSize <= 0
+     */
+    UFUNCTION(BlueprintCallable)
+    URRROS2NodePool* GetRobotROS2NodePool();
+
+    //! Max num of ROS 2 interfaces of deleted robots kept for robots respawned in the same namespace, 0 for none
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 RobotROS2InterfacePoolSize = 0;
+
+    /**
+     * @brief Get the pool of ROS 2 interfaces recycled across robots' despawn & respawn, creating it upon the first fetching
+     * @return URRROS2InterfacePool* nullptr if #RobotROS2InterfacePoolSize <= 0
+     */
+    UFUNCTION(BlueprintCallable)
+    URRROS2InterfacePool* GetRobotROS2InterfacePool();
+
     //! Provide ROS 2 implementation of sim-wide operations like get/set actor state, spawn/delete actor, attach/detach actor.
     UPROPERTY(BlueprintReadOnly)
     ASimulationState* MainSimState = nullptr;
@@ -118,10 +202,28 @@ protected:
      */
     virtual void StartPlay() override;
 
+    //! Stop #InputReplay & the MCAP recording
+    virtual void EndPlay(const EEndPlayReason::Type InEndPlayReason) override;
+
+    //! Start #InputReplay from #InputReplayMode, once the time step is set
+    void InitInputReplay();
+
+    //! Start recording into #McapRecordFilePath
+    void InitMcapRecord();
+
     //! Blueprint class names to be registered as spawnable entity types
     UPROPERTY()
     TArray<FString> BPSpawnableClassNames;
 
+    UPROPERTY()
+    URRCrowdROS2Bridge* CrowdROS2Bridge = nullptr;
+
+    UPROPERTY()
+    URRROS2NodePool* RobotROS2NodePool = nullptr;
+
+    UPROPERTY()
+    URRROS2InterfacePool* RobotROS2InterfacePool = nullptr;
+
 private:
     /**
      * @brief Create and initialize #MainROS2Node, #ClockPublisher and #MainSimState.
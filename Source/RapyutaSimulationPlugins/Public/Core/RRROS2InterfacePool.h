@@ -0,0 +1,75 @@
+/**
+ * @file RRROS2InterfacePool.h
+ * @brief Pool of ROS 2 interfaces of deleted robots, rebound by robots respawned in the same namespace.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+#include "RRROS2InterfacePool.generated.h"
+
+class ARRBaseRobot;
+class URRRobotROS2Interface;
+
+/**
+ * @brief Pool of the ROS 2 interfaces of robots being destroyed, eg deleted by #ASimulationState between RL episodes, kept with
+ * their ROS 2 node, publishers, subscribers, services & actions, instead of all being torn down & recreated again by the
+ * respawned robot, having DDS discovery to settle again each time.
+ * A robot's interface is parked by #Park upon the robot being destroyed, then acquired by #Acquire instead of being created by
+ * a new robot of the same namespace, interface class & sensor topic names as of their creation, see #MakeKey.
+ * #URRRobotROS2Interface::Initialize then only rebinds the parked endpoints to the new robot: subscription & service callbacks
+ * being bound to the interface itself are kept as is, while the sensors' publishers, parked in
+ * #URRRobotROS2Interface::ParkedSensorPublishers, are handed to the new sensors of the same topic & publisher class.
+ * Created by #ARRROS2GameMode with #ARRROS2GameMode::RobotROS2InterfacePoolSize > 0.
+ * @note Interfaces on a node of #URRROS2NodePool are not parked, their endpoints being added to nodes shared by all robots.
+ * Endpoints created by sensors besides their #URRROS2BaseSensorComponent::SensorPublisher are created again.
+ */
+UCLASS()
+class RAPYUTASIMULATIONPLUGINS_API URRROS2InterfacePool : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    //! Max num of parked interfaces, robots destroyed once it is reached having their interface destroyed along
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 InterfacesNum = 16;
+
+    /**
+     * @brief Park the ROS 2 interface of a robot being destroyed, deinitializing it & detaching it from the robot
+     * @param InRobot
+     * @return true if parked
+     */
+    bool Park(ARRBaseRobot* InRobot);
+
+    /**
+     * @brief Acquire the interface parked by a robot of the same key, moved into InRobot
+     * @param InKey Key of InRobot by #MakeKey, to be kept in #URRRobotROS2Interface::PoolKey of its interface
+     * @param InRobot
+     * @return URRRobotROS2Interface* nullptr if none is parked
+     */
+    URRRobotROS2Interface* Acquire(const FString& InKey, ARRBaseRobot* InRobot);
+
+    int32 GetParkedInterfacesNum() const
+    {
+        return ParkedInterfaces.Num();
+    }
+
+    //! Whether an interface is parked in a pool, ie not bound to any robot
+    static bool IsParked(const URRRobotROS2Interface* InInterface);
+
+    /**
+     * @brief Key of the interfaces interchangeable between robots, being their namespace, interface class & topic set,
+     * ie their sensors' topic names, before their ROS 2 interface adds any, eg its odometry
+     * @param InRobot
+     * @return FString
+     */
+    static FString MakeKey(const ARRBaseRobot* InRobot);
+
+protected:
+    //! Parked interfaces by #MakeKey
+    UPROPERTY()
+    TMap<FString, URRRobotROS2Interface*> ParkedInterfaces;
+};
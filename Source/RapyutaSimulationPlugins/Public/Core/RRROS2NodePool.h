@@ -0,0 +1,78 @@
+/**
+ * @file RRROS2NodePool.h
+ * @brief Small pool of ROS 2 nodes shared by many robots, keeping their topics namespaced.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+#include "RRROS2NodePool.generated.h"
+
+class UROS2NodeComponent;
+
+/**
+ * @brief Pool of #NodesNum ROS 2 nodes onto which robots' publishers & subscribers are multiplexed, instead of one node per
+ * robot by #URRRobotROS2Interface::InitRobotROS2Node, to bound DDS discovery traffic & memory with hundreds of robots.
+ * Each pooled node being spun by rclUE by itself, #NodesNum also bounds the executors servicing the robots.
+ * Pooled nodes have no namespace, thus the robots' namespaces are kept by resolving their relative topic names & frame ids
+ * with #GetTopicName & #GetNamespace, eg [cmd_vel] of robot [robot1] as [/robot1/cmd_vel].
+ * Created by #ARRROS2GameMode with #ARRROS2GameMode::RobotROS2NodePoolSize > 0.
+ * @note Services & actions of pooled robots are not namespaced, thus have to be given unique names.
+ */
+UCLASS()
+class RAPYUTASIMULATIONPLUGINS_API URRROS2NodePool : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    //! Max num of pooled nodes, created upon being first acquired
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 NodesNum = 4;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FString NodeNamePrefix = TEXT("UERobotsNode");
+
+    /**
+     * @brief Acquire the pooled node with the fewest users, creating it if not yet
+     * @return UROS2NodeComponent*
+     */
+    UROS2NodeComponent* Acquire();
+
+    //! Release a node acquired by #Acquire
+    void Release(UROS2NodeComponent* InNode);
+
+    int32 GetCreatedNodesNum() const
+    {
+        return Nodes.Num();
+    }
+
+    //! Whether a node belongs to a pool
+    static bool IsPooled(const UROS2NodeComponent* InNode);
+
+    /**
+     * @brief Get the namespace of a node's user, ie the one of the robot it belongs to if the node is pooled
+     * @param InNode
+     * @param InUser Robot or any object owned by it, eg its ROS 2 interface, sensors or their publishers
+     * @return FString
+     */
+    static FString GetNamespace(const UROS2NodeComponent* InNode, const UObject* InUser);
+
+    /**
+     * @brief Get a topic name resolved as in a node of its user's namespace
+     * @param InNode
+     * @param InUser
+     * @param InTopicName
+     * @return FString Absolute topic name if the node is pooled & InTopicName relative, else InTopicName
+     */
+    static FString GetTopicName(const UROS2NodeComponent* InNode, const UObject* InUser, const FString& InTopicName);
+
+protected:
+    UPROPERTY()
+    TArray<UROS2NodeComponent*> Nodes;
+
+    //! Num of users of each of #Nodes
+    TArray<int32> UsersNums;
+};
@@ -0,0 +1,68 @@
+/**
+ * @file RRReadinessBarrier.h
+ * @brief Barrier running an action as soon as all its named dependencies have signalled, logging when each resolved.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+/**
+ * @brief Collects named dependencies, eg resources loading, each signalled once by its owner upon completion, then runs the
+ * action set by #Arm() in the same call as the last #Signal(), instead of it being polled on a timer.
+ * Dependencies may be added & signalled before #Arm(), which runs the action right away if none is pending. Game thread only.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRReadinessBarrier
+{
+public:
+    explicit FRRReadinessBarrier(const FString& InName = TEXT("ReadinessBarrier")) : Name(InName)
+    {
+    }
+
+    //! Forget all dependencies & the action, restarting the timings
+    void Reset();
+
+    //! Add a dependency to await, no-op if already added
+    void AddDependency(const FName& InDependency);
+
+    //! Resolve InDependency, running the action if it was the last pending one & #Arm() was called
+    void Signal(const FName& InDependency);
+
+    //! Set the action to run once all dependencies have resolved, immediately if they have already
+    void Arm(TUniqueFunction<void()>&& InOnReady);
+
+    bool IsReady() const
+    {
+        return bArmed && (PendingNum == 0);
+    }
+
+    bool HasFired() const
+    {
+        return bFired;
+    }
+
+    //! Names of the dependencies yet to be signalled
+    TArray<FName> GetPendingDependencies() const;
+
+    //! [s] Since the first dependency was added or #Reset()
+    double GetElapsedSeconds() const;
+
+    //! Resolve time of each dependency, pending ones included
+    FString ToString() const;
+
+protected:
+    void TryFire();
+
+    FString Name;
+
+    //! [s] Resolve time since #StartTime per dependency, negative if pending
+    TMap<FName, double> Dependencies;
+    int32 PendingNum = 0;
+    double StartTime = 0.;
+
+    TUniqueFunction<void()> OnReady;
+    bool bArmed = false;
+    bool bFired = false;
+};
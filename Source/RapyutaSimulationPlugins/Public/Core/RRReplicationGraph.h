@@ -0,0 +1,99 @@
+/**
+ * @file RRReplicationGraph.h
+ * @brief Replication graph spatializing robots, each client only receiving nearby or own robots at high rate.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "BasicReplicationGraph.h"
+#include "CoreMinimal.h"
+
+#include "RRReplicationGraph.generated.h"
+
+class ARRBaseRobot;
+class URRReplicationGraph;
+
+/**
+ * @brief Per-connection node gathering the robots spawned by the connection's player, thus always relevant to it, & setting
+ * the connection's replication period of the other robots by their distance to its viewers.
+ * Both are refreshed every #URRReplicationGraph::RobotsUpdateIntervalFrames.
+ */
+UCLASS()
+class RAPYUTASIMULATIONPLUGINS_API URRReplicationGraphNode_ConnectionRobots : public UReplicationGraphNode
+{
+    GENERATED_BODY()
+
+public:
+    virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& InActorInfo) override
+    {
+    }
+
+    virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& InActorInfo, bool bInWarnIfNotFound = true) override
+    {
+        return false;
+    }
+
+    virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+    UPROPERTY()
+    URRReplicationGraph* Graph = nullptr;
+
+protected:
+    //! Robots of the connection's player
+    FActorRepListRefView OwnedRobots;
+
+    //! Frame #OwnedRobots & the robots' periods were last refreshed, 0 if never
+    uint32 LastUpdateFrame = 0;
+};
+
+/**
+ * @brief Replication graph for large fleets, replacing the bAlwaysRelevant replication of #ARRBaseRobot:
+ * - robots are added to the grid spatialization node, thus only replicated to clients within their NetCullDistanceSquared,
+ * - robots spawned by a client's player are always relevant to it, by #URRReplicationGraphNode_ConnectionRobots,
+ * - other robots are replicated every frame up to #RobotsNearDistance from the client's viewers, then less often up to
+ *   #RobotsFarReplicationPeriodFrame at #RobotsFarDistance,
+ * - no robots are replicated to #ARRSpectatorPlayerController connections, which get entity snapshots instead.
+ * Other actors are routed as by UBasicReplicationGraph, eg #ASimulationState being always relevant.
+ *
+ * Enabled in DefaultEngine.ini with:
+ * [/Script/OnlineSubsystemUtils.IpNetDriver]
+ * ReplicationDriverClassName="/Script/RapyutaSimulationPlugins.RRReplicationGraph"
+ * @sa [Replication Graph](https://docs.unrealengine.com/5.1/en-US/replication-graph-in-unreal-engine/)
+ */
+UCLASS(Transient, Config = Engine)
+class RAPYUTASIMULATIONPLUGINS_API URRReplicationGraph : public UBasicReplicationGraph
+{
+    GENERATED_BODY()
+
+public:
+    //! [cm] Robots closer to a client's viewer are replicated to it every frame
+    UPROPERTY(Config)
+    float RobotsNearDistance = 5000.f;
+
+    //! [cm] Robots farther from a client's viewer are replicated to it every #RobotsFarReplicationPeriodFrame
+    UPROPERTY(Config)
+    float RobotsFarDistance = 20000.f;
+
+    UPROPERTY(Config)
+    int32 RobotsFarReplicationPeriodFrame = 10;
+
+    //! Frames between refreshes of the robots' ownership & per-connection replication periods
+    UPROPERTY(Config)
+    int32 RobotsUpdateIntervalFrames = 30;
+
+    const TArray<TWeakObjectPtr<ARRBaseRobot>>& GetRobots() const
+    {
+        return Robots;
+    }
+
+    virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* InConnectionManager) override;
+    virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& InActorInfo,
+                                             FGlobalActorReplicationInfo& InGlobalInfo) override;
+    virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& InActorInfo) override;
+
+protected:
+    //! All replicated robots, spatialized in GridNode
+    TArray<TWeakObjectPtr<ARRBaseRobot>> Robots;
+};
@@ -0,0 +1,68 @@
+/**
+ * @file RRRobotModelCache.h
+ * @brief Parse-once cache of robot models read from URDF/SDF description files.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+#include "Misc/ScopeRWLock.h"
+
+// RapyutaSimulationPlugins
+#include "Robots/RRRobotStructs.h"
+
+/**
+ * @brief Thread-safe cache of #FRRRobotModelInfo parsed by #FRRURDFParser & #FRRSDFParser, keyed by a hash of the
+ * description file's content & folder, the latter resolving its mesh paths. Identical robots spawned in fleets are
+ * thus parsed only once per process. Entries are also saved under [ProjectSavedDir]/RRRobotModelCache, in a binary
+ * serialization of #FRRRobotModelData, so that later process starts skip XML parsing entirely.
+ * Files included by an SDF are not part of its hash. Disabled by rr.RobotModelCache.Enabled 0.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRRobotModelCache
+{
+public:
+    static constexpr uint32 MAGIC = 0x4D445252;    // "RRDM"
+    static constexpr uint32 VERSION = 1;
+
+    static bool IsEnabled();
+
+    /**
+     * @brief Get the cache key of a description
+     * @param InDescriptionFilePath
+     * @param InDescription Description file content
+     * @return FString
+     */
+    static FString GetContentHash(const FString& InDescriptionFilePath, const FString& InDescription);
+
+    /**
+     * @brief Find a model info, from memory then from disk
+     * @param InContentHash From #GetContentHash()
+     * @param OutModelInfo
+     * @return true if found
+     */
+    static bool Find(const FString& InContentHash, FRRRobotModelInfo& OutModelInfo);
+
+    //! Cache a successfully parsed model info, in memory & on disk
+    static void Add(const FString& InContentHash, const FRRRobotModelInfo& InModelInfo);
+
+    //! Clear the in-memory entries
+    static void Reset();
+
+    /**
+     * @brief Serialize robot model data, its UPROPERTY() members as tagged properties & its child models recursively
+     * @param Ar
+     * @param InOutModelData
+     * @return true if no error
+     */
+    static bool SerializeModelData(FArchive& Ar, FRRRobotModelData& InOutModelData);
+
+private:
+    static FString GetCacheFilePath(const FString& InContentHash);
+    static bool LoadFromDisk(const FString& InContentHash, FRRRobotModelData& OutModelData);
+    static bool SaveToDisk(const FString& InContentHash, const FRRRobotModelData& InModelData);
+
+    static FRWLock SLock;
+    static TMap<FString, TSharedRef<FRRRobotModelInfo, ESPMode::ThreadSafe>> SModelInfos;
+};
@@ -82,6 +82,10 @@ private:
     static constexpr const char* SDF_ELEMENT_SENSOR_LIDAR_NOISE_TYPE = "type";
     static constexpr const char* SDF_ELEMENT_SENSOR_LIDAR_NOISE_MEAN = "mean";
     static constexpr const char* SDF_ELEMENT_SENSOR_LIDAR_NOISE_STDDEV = "stddev";
+    static constexpr const char* SDF_ELEMENT_SENSOR_CAMERA = "camera";
+    static constexpr const char* SDF_ELEMENT_SENSOR_CAMERA_IMAGE = "image";
+    static constexpr const char* SDF_ELEMENT_SENSOR_CAMERA_IMAGE_WIDTH = "width";
+    static constexpr const char* SDF_ELEMENT_SENSOR_CAMERA_IMAGE_HEIGHT = "height";
 
     static constexpr const char* SDF_ELEMENT_LINK_MATERIAL = "material";
     static constexpr const char* SDF_ELEMENT_LINK_MATERIAL_SCRIPT = "script";
@@ -17,8 +17,12 @@
 // RapyutaSimulationPlugins
 #include "Core/RRActorCommon.h"
 #include "Core/RRBaseActor.h"
+#include "Core/RRBoundingBoxAnnotator.h"
 #include "Core/RRCamera.h"
+#include "Core/RRDatasetWriter.h"
+#include "Core/RRSceneSnapshot.h"
 #include "Core/RRGameSingleton.h"
+#include "Core/RRStaticMeshMerger.h"
 #include "Core/RRPlayerController.h"
 #include "Core/RRTypeUtils.h"
 #include "RapyutaSimulationPlugins.h"
@@ -69,14 +73,56 @@ public:
 
     FOnSpawnedActorsSettled OnSpawnedActorsSettled;
 
+    /**
+     * @brief Set up this director, of a scene instance forked by #ARRGameState::ForkSceneInstances(), to run the same scenario
+     * as InSourceDirector's. Called right after being spawned, before its operation is initialized.
+     * Overridden by scenarios to copy their own configuration, assets being already shared by all scene instances.
+     * @param InSourceDirector
+     */
+    virtual void ForkFrom(const ARRSceneDirector* InSourceDirector);
+
+    //! Id of the scene instance this one's scenario was forked from, -1 if not forked
+    UPROPERTY()
+    int32 ForkSourceSceneInstanceId = -1;
+
     virtual bool HasOperationCompleted(bool bIsLogged = false);
 
     UPROPERTY()
     double DataCollectionTimeStamp = 0.f;
 
+    //! @deprecated Seg mask ids are reused through ActorCommon's SegMaskIdAllocator
     UPROPERTY()
     TArray<int32> SceneEntityMaskValueList;
 
+    /**
+     * @brief Move a captured sample into #DatasetWriter's queue, to be encoded & written on worker threads
+     * @param InSample
+     * @return false if the queue is full or the output disk is short of space
+     */
+    bool EnqueueDatasetSample(FRRDatasetSample&& InSample);
+
+    /**
+     * @brief Enqueue the seg mask depth stencils of actors, one line per actor, as a text sample
+     * @param InFilePath Relative to #DatasetWriter's output folder, without extension
+     * @param InActors
+     * @return bool
+     */
+    bool EnqueueSegMaskLabels(const FString& InFilePath, const TArray<AActor*>& InActors);
+
+    /**
+     * @brief Enqueue the 3D & image bounding boxes of actors visible from InView, one line per actor, as a text sample.
+     * Boxes are computed in one batch by #BoundingBoxAnnotator, which caches the actors' local bounds across frames.
+     * @param InFilePath Relative to #DatasetWriter's output folder, without extension
+     * @param InActors
+     * @param InView
+     * @param InBaseActor Frame of the 3D boxes, world frame if null
+     * @return bool
+     */
+    bool EnqueueBoundingBoxAnnotations(const FString& InFilePath,
+                                       const TArray<AActor*>& InActors,
+                                       const FRRAnnotationView& InView,
+                                       const AActor* InBaseActor = nullptr);
+
 protected:
     /**
     * @brief Call #TryInitializeOperation() repeatedly.
@@ -108,6 +154,18 @@ protected:
     }
 
     virtual void OnDataCollectionPhaseDone(bool bIsFinalDataCollectingPhase);
+
+    //! Writer of captured samples, set up in #InitializeOperation() under the sim outputs folder
+    FRRDatasetWriter DatasetWriter;
+
+    FRRBoundingBoxAnnotator BoundingBoxAnnotator;
+
+    /**
+     * @brief Run InContinuation, eg the next data collection phase, as soon as #DatasetWriter has queue capacity,
+     * checking every tick without blocking the game thread
+     * @param InContinuation
+     */
+    void ContinueOnDatasetWriterCapacity(TFunction<void()> InContinuation);
     virtual void EndSceneInstance();
 
     UPROPERTY()
@@ -130,12 +188,40 @@ protected:
 
     UPROPERTY()
     int32 OperationBatchLoopLeft = 0;
+
+    //! Spawn the scene's actors, eg in batch by #URRUObjectUtils::SpawnSimActors()
     virtual void SpawnActors()
     {
     }
 
+    /**
+     * @brief Reset the scene between operations, restoring #SceneSnapshot if captured
+     */
     virtual void ResetScene();
 
+    /**
+     * @brief Record the initial states of scene actors, eg pooled ones once spawned, to be restored by #ResetScene()
+     * without respawning them
+     * @param InActors
+     */
+    void CaptureSceneSnapshot(const TArray<AActor*>& InActors);
+
+    FRRSceneSnapshot SceneSnapshot;
+
+    /**
+     * @brief Merge the static mesh components of scene actors once spawned, as per #StaticMeshMergeSettings, into
+     * #MergedMeshActor, then rendering & colliding in place of them.
+     * To be called once, eg after #SpawnActors(), before #CaptureSceneSnapshot() since the merged actors no longer move.
+     * @param InActors
+     * @return int32 Num of merged meshes
+     */
+    int32 MergeStaticMeshes(const TArray<AActor*>& InActors);
+
+    FRRStaticMeshMergeSettings StaticMeshMergeSettings;
+
+    UPROPERTY()
+    AActor* MergedMeshActor = nullptr;
+
 private:
     /**
      * @brief Initialize Scene by #InitializeOperation() or exit with timeout.
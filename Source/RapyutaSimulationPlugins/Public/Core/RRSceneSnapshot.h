@@ -0,0 +1,71 @@
+/**
+ * @file RRSceneSnapshot.h
+ * @brief Snapshot of scene actors' transforms, visibility & materials, to reset a scene without respawning.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+#include "Materials/MaterialInstanceDynamic.h"
+#include "UObject/GCObject.h"
+
+class UMeshComponent;
+
+/**
+ * @brief States of actors recorded in flat arrays, restored all together by #Restore(), eg between data collection episodes.
+ * Per actor: world transform & hidden-in-game flag. Per mesh component material: the material itself, plus the parameter
+ * values of MIDs, which are reset to them on restore, only those having changed being set.
+ * Actors are teleported with ETeleportType::ResetPhysics, thus also zeroing physics velocities. Game thread only.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRSceneSnapshot : public FGCObject
+{
+public:
+    /**
+     * @brief Record the current states of actors, replacing any previous snapshot
+     * @param InActors Invalid ones are skipped
+     */
+    void Capture(const TArray<AActor*>& InActors);
+
+    /**
+     * @brief Restore all recorded states, skipping actors or components destroyed since
+     * @return int32 Num of restored actors
+     */
+    int32 Restore() const;
+
+    void Reset();
+
+    int32 Num() const
+    {
+        return Actors.Num();
+    }
+
+    virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+
+    virtual FString GetReferencerName() const override
+    {
+        return TEXT("FRRSceneSnapshot");
+    }
+
+private:
+    struct FMaterialState
+    {
+        TWeakObjectPtr<UMeshComponent> MeshComp;
+        int32 MaterialIndex = 0;
+        //! Only set for MIDs
+        TArray<FScalarParameterValue> ScalarParameterValues;
+        TArray<FVectorParameterValue> VectorParameterValues;
+        TArray<FTextureParameterValue> TextureParameterValues;
+    };
+
+    static void RestoreMaterialParameters(UMaterialInstanceDynamic* InMID, const FMaterialState& InState);
+
+    TArray<TWeakObjectPtr<AActor>> Actors;
+    TArray<FTransform> Transforms;
+    TBitArray<> HiddenFlags;
+
+    TArray<FMaterialState> MaterialStates;
+    //! Per #MaterialStates, kept alive in case they get replaced before being restored
+    TArray<UMaterialInterface*> Materials;
+};
@@ -0,0 +1,147 @@
+/**
+ * @file RRSkeletalAnimLODManager.h
+ * @brief Per-world skeletal animation throttling, evaluating robot skeletal meshes unseen by any sensor or view less often.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// Native
+#include <mutex>
+
+// UE
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+
+#include "RRSkeletalAnimLODManager.generated.h"
+
+class FRRSkeletalAnimLODManager;
+class USkeletalMeshComponent;
+class UWorld;
+
+/**
+ * @brief Tick function of a world's #FRRSkeletalAnimLODManager, run every rr.SkeletalAnimLOD.UpdateInterval seconds
+ */
+USTRUCT()
+struct RAPYUTASIMULATIONPLUGINS_API FRRSkeletalAnimLODTickFunction : public FTickFunction
+{
+    GENERATED_BODY()
+
+    FRRSkeletalAnimLODManager* Manager = nullptr;
+
+    virtual void ExecuteTick(float DeltaTime,
+                             ELevelTick TickType,
+                             ENamedThreads::Type CurrentThread,
+                             const FGraphEventRef& MyCompletionGraphEvent) override;
+
+    virtual FString DiagnosticMessage() override
+    {
+        return TEXT("FRRSkeletalAnimLODTickFunction");
+    }
+};
+
+template<>
+struct TStructOpsTypeTraits<FRRSkeletalAnimLODTickFunction> : public TStructOpsTypeTraitsBase2<FRRSkeletalAnimLODTickFunction>
+{
+    enum
+    {
+        WithCopy = false
+    };
+};
+
+//! Animation evaluation rate of a skeletal mesh managed by #FRRSkeletalAnimLODManager
+enum class ERRSkeletalAnimLOD : uint8
+{
+    //! Seen by a sensor or view, or its bones read by a publisher: evaluated every frame
+    FULL,
+    //! Unseen: evaluated every rr.SkeletalAnimLOD.ReducedTickInterval
+    REDUCED,
+    //! Unseen & farther than rr.SkeletalAnimLOD.PausedDistance from any viewer: every rr.SkeletalAnimLOD.PausedTickInterval
+    PAUSED
+};
+
+/**
+ * @brief Per-world animation LOD manager of the skeletal meshes of robots with #ARRBaseRobot::bSkeletalAnimLODEnabled.
+ * Viewers are the camera & lidar sensors of all robots & standalone camera actors, plus player view points. Cameras & views
+ * are cones of their diagonal FOV, lidars spheres of their max range. Each update, every mesh bounding sphere is tested
+ * against all viewers in a ParallelFor, then its #ERRSkeletalAnimLOD is applied as its component tick interval.
+ * Since ticks with an interval are passed the accumulated delta time, animations still advance by the exact sim time, only
+ * sampled less often; actor transforms are driven by the movement components thus unaffected. Meshes whose bones have been
+ * read through #FRRBoneTransformsCache since the last update (eg by /tf or joint state publishers) are kept at #FULL.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRSkeletalAnimLODManager
+{
+public:
+    ~FRRSkeletalAnimLODManager();
+
+    /**
+     * @brief Get the manager of a world, creating it upon the first fetching
+     *
+     * @param InWorld
+     * @return FRRSkeletalAnimLODManager&
+     */
+    static FRRSkeletalAnimLODManager& Get(UWorld* InWorld);
+
+    //! Start throttling a mesh, starting at #ERRSkeletalAnimLOD::FULL
+    void AddSkeletalMesh(USkeletalMeshComponent* InSkeletalMesh);
+
+    //! Stop throttling a mesh, restoring its own tick interval
+    void RemoveSkeletalMesh(USkeletalMeshComponent* InSkeletalMesh);
+
+    //! Update all meshes' LOD from the viewers
+    void Update();
+
+    int32 GetSkeletalMeshesNum() const
+    {
+        return SkeletalMeshes.Num();
+    }
+
+    //! Meshes at InLOD upon the last #Update
+    int32 GetSkeletalMeshesNum(const ERRSkeletalAnimLOD InLOD) const
+    {
+        return LastLODNums[static_cast<uint8>(InLOD)];
+    }
+
+private:
+    static TMap<UWorld*, TUniquePtr<FRRSkeletalAnimLODManager>> SManagers;
+    static std::once_flag OnceFlag;
+
+    static void OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/);
+
+    //! Cone of view, a sphere if HalfAngle >= PI
+    struct FViewer
+    {
+        FVector Origin = FVector::ZeroVector;
+        FVector Forward = FVector::ForwardVector;
+        //! [rad]
+        float HalfAngle = PI;
+        //! [cm]
+        float Range = TNumericLimits<float>::Max();
+    };
+
+    struct FSkeletalMesh
+    {
+        TWeakObjectPtr<USkeletalMeshComponent> Component;
+        //! Tick interval of the component before being managed, restored upon removal
+        float OriginalTickInterval = 0.f;
+        ERRSkeletalAnimLOD LOD = ERRSkeletalAnimLOD::FULL;
+    };
+
+    void GatherViewers(UWorld* InWorld);
+
+    static void SetLOD(FSkeletalMesh& InSkeletalMesh, const ERRSkeletalAnimLOD InLOD);
+
+    TWeakObjectPtr<UWorld> World;
+    FRRSkeletalAnimLODTickFunction TickFunction;
+    TArray<FSkeletalMesh> SkeletalMeshes;
+
+    // Reused across updates
+    TArray<FViewer> Viewers;
+    TArray<FSphere> Bounds;
+    TArray<ERRSkeletalAnimLOD> LODs;
+
+    //! GFrameCounter of the last #Update
+    uint64 LastUpdateFrame = 0;
+
+    int32 LastLODNums[3] = {0, 0, 0};
+};
@@ -0,0 +1,133 @@
+/**
+ * @file RRSpectatorPlayerController.h
+ * @brief Lightweight player controller of network viewers, only receiving low-rate snapshots of nearby entities' transforms.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "GameFramework/PlayerController.h"
+
+#include "RRSpectatorPlayerController.generated.h"
+
+class ASimulationState;
+
+/**
+ * @brief Transform of an entity in a #ARRSpectatorPlayerController snapshot, net serialized with a packed entity id,
+ * a location quantized to 1cm & a compressed rotator
+ */
+USTRUCT(BlueprintType)
+struct RAPYUTASIMULATIONPLUGINS_API FRREntitySnapshotEntry
+{
+    GENERATED_BODY()
+
+    //! #FRREntityRegistryItem::EntityId of the entity
+    UPROPERTY(BlueprintReadOnly)
+    int64 EntityId = 0;
+
+    UPROPERTY(BlueprintReadOnly)
+    FVector_NetQuantize Location = FVector::ZeroVector;
+
+    UPROPERTY(BlueprintReadOnly)
+    FRotator Rotation = FRotator::ZeroRotator;
+
+    bool NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess);
+};
+
+template<>
+struct TStructOpsTypeTraits<FRREntitySnapshotEntry> : public TStructOpsTypeTraitsBase2<FRREntitySnapshotEntry>
+{
+    enum
+    {
+        WithNetSerializer = true
+    };
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FRROnEntitySnapshotReceived, const TArray<FRREntitySnapshotEntry>&, InEntries);
+
+/**
+ * @brief Player controller of spectator connections, eg operators & dashboards watching a large simulation, spawned by
+ * #ARRNetworkGameMode instead of #ARRNetworkPlayerController for clients joining with the #SPECTATOR_OPTION URL option.
+ * Unlike #ARRNetworkPlayerController, it has no ROS 2 node, sim state client nor clock sync, & sends no robot commands.
+ * Instead of receiving the robots' replication, culled for its connection by #URRReplicationGraph, it receives every
+ * #SnapshotIntervalSec a snapshot of the transforms of the #MaxSnapshotEntitiesNum entities of #ASimulationState nearest to
+ * its view, within #InterestRadius, in one unreliable RPC.
+ * The spectator only spectates, having no pawn. Snapshots are exposed by #GetLatestSnapshot & #OnEntitySnapshotReceived,
+ * their entities being named by the client's replicated #ASimulationState::EntityRegistry, see #FindEntityName.
+ */
+UCLASS()
+class RAPYUTASIMULATIONPLUGINS_API ARRSpectatorPlayerController : public APlayerController
+{
+    GENERATED_BODY()
+
+public:
+    ARRSpectatorPlayerController();
+
+    //! Client URL option of spectator connections, eg open 127.0.0.1?RRSpectator
+    static constexpr const TCHAR* SPECTATOR_OPTION = TEXT("RRSpectator");
+
+    virtual void Tick(float DeltaSeconds) override;
+
+    void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+
+    //! Set by #ARRNetworkGameMode upon login
+    UPROPERTY(Transient, Replicated)
+    ASimulationState* ServerSimState = nullptr;
+
+    //! [s] Interval between snapshots
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float SnapshotIntervalSec = 0.2f;
+
+    //! [cm] Max distance of snapshot entities to the spectator's view, <= 0 for all entities
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float InterestRadius = 20000.f;
+
+    //! Max num of entities in a snapshot, the nearest to the spectator's view
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 MaxSnapshotEntitiesNum = 256;
+
+    /**
+     * @brief Receive a snapshot of entities' transforms, replacing the latest one
+     * @param InEntries
+     */
+    UFUNCTION(Client, Unreliable)
+    void ClientReceiveEntitySnapshot(const TArray<FRREntitySnapshotEntry>& InEntries);
+
+    UPROPERTY(BlueprintAssignable)
+    FRROnEntitySnapshotReceived OnEntitySnapshotReceived;
+
+    UFUNCTION(BlueprintCallable)
+    const TArray<FRREntitySnapshotEntry>& GetLatestSnapshot() const
+    {
+        return LatestSnapshot;
+    }
+
+    /**
+     * @brief Find the registered name of a snapshot entity on client
+     * @param InEntityId
+     * @return FString Empty if not registered (yet)
+     */
+    UFUNCTION(BlueprintCallable)
+    FString FindEntityName(const int64 InEntityId);
+
+protected:
+    //! Spectate only, not to be given a pawn by the game mode
+    virtual void InitPlayerState() override;
+
+    //! Server only, snapshot the entities of interest & send them to the client
+    void SendEntitySnapshot();
+
+    //! [s] Server only, time since the latest snapshot
+    float SnapshotElapsedSec = 0.f;
+
+    //! Server only, reused across snapshots
+    TArray<AActor*> InterestEntities;
+
+    //! Client only
+    TArray<FRREntitySnapshotEntry> LatestSnapshot;
+
+    //! Client only, names by entity id, refreshed from #ASimulationState::EntityRegistry upon missing an id
+    TMap<uint32, FString> EntityNames;
+};
@@ -71,9 +71,10 @@ public:
      * @brief Create a Mesh Body object
      * @note This function could be invoked from an async task running in GameThread
      * @param InMeshData
+     * @param InMeshDescs Visual mesh descriptions prebuilt on the mesh loader thread by #BuildMeshDescriptions(), if any
      * @return UStaticMesh*
      */
-    UStaticMesh* CreateMeshBody(const FRRMeshData& InMeshData);
+    UStaticMesh* CreateMeshBody(const FRRMeshData& InMeshData, const TArray<FMeshDescription>* InMeshDescs = nullptr);
 
     /**
      * @brief Set Static mesh from UstaticMesh
@@ -83,10 +84,7 @@ public:
      */
     void SetMesh(UStaticMesh* InStaticMesh);
 
-    void SetMeshSize(const FVector& InSize)
-    {
-        SetWorldScale3D(InSize / GetStaticMesh()->GetBoundingBox().GetSize());
-    }
+    void SetMeshSize(const FVector& InSize);
 
     UPROPERTY()
     ERRShapeType ShapeType = ERRShapeType::NONE;
@@ -106,16 +104,36 @@ public:
     UPROPERTY()
     bool bUseComplexCollision = false;
 
+    //! LODs generated upon importing the mesh file & built into the visual static mesh, to be set before #InitializeMesh()
+    UPROPERTY()
+    FRRMeshLODSettings LODSettings;
+
     /**
      * @brief Create a static mesh
      * @param InMeshData
      * @param bInAsVisualMesh Whether it is created as a visual or collision mesh
+     * @param InMeshDescs Prebuilt mesh descriptions of at least the LODs to be built, otherwise built here
      * @return UStaticMesh
      */
-    UStaticMesh* CreateMesh(const FRRMeshData& InMeshData, bool bInAsVisualMesh);
+    UStaticMesh* CreateMesh(const FRRMeshData& InMeshData,
+                            bool bInAsVisualMesh,
+                            const TArray<FMeshDescription>* InMeshDescs = nullptr);
+
+    //! Num of LODs built into the visual static mesh of InMeshData
+    static int32 GetVisualLODsNum(const FRRMeshData& InMeshData, const FRRMeshLODSettings& InLODSettings);
 
     /**
-     * @brief Generate custom simple collision, only if not #bUseDefaultSimpleCollision
+     * @brief Build the mesh descriptions of InMeshData's first InLODsNum LODs, in parallel.
+     * Not touching any UObject, it is run on mesh loader threads, leaving only the static mesh build to the game thread.
+     * @param InMeshData
+     * @param InLODsNum
+     * @param OutMeshDescs
+     */
+    static void BuildMeshDescriptions(const FRRMeshData& InMeshData, int32 InLODsNum, TArray<FMeshDescription>& OutMeshDescs);
+
+    /**
+     * @brief Generate custom simple collision, only if not #bUseDefaultSimpleCollision.
+     * Convex hulls are decomposed by V-HACD in the editor, otherwise by #FRRConvexDecomposition, cached by #FRRMeshCache.
      */
     void GenerateCustomSimpleCollision(const FRRMeshData& InMeshData, UBodySetup* OutBodySetup);
 
@@ -170,8 +188,7 @@ protected:
     virtual void BeginPlay() override;
 
 private:
-    UPROPERTY()
-    FTimerHandle StaticMeshTimerHandle;
-
-    void CreateMeshSection(const TArray<FRRMeshNodeData>& InMeshSectionData, FMeshDescriptionBuilder& OutMeshDescBuilder);
+    static void CreateMeshSection(const TArray<FRRMeshNodeData>& InMeshSectionData,
+                                  FMeshDescriptionBuilder& OutMeshDescBuilder,
+                                  int32 InLODIndex = 0);
 };
@@ -0,0 +1,86 @@
+/**
+ * @file RRStaticMeshMerger.h
+ * @brief Runtime merging of non-movable mesh components sharing a material into combined static meshes.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRMeshData.h"
+
+class URRStaticMeshComponent;
+
+/**
+ * @brief Settings of #FRRStaticMeshMerger
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRStaticMeshMergeSettings
+{
+    //! [cm] Size of the XY grid cells clustering mesh components, keeping merged meshes spatially coherent for culling
+    float ClusterSize = 5000.f;
+
+    //! Min num of mesh components of a cluster to be merged, smaller clusters being left as is
+    int32 MinClusterMeshCompsNum = 2;
+
+    //! Max num of vertices of a merged mesh, a cluster above it being split into several merged meshes
+    int32 MaxMergedVerticesNum = 1 << 20;
+};
+
+/**
+ * @brief Merge the static #URRStaticMeshComponent of a scene that share the same materials & custom depth stencil, within a
+ * grid cell, into one #URRStaticMeshComponent per cluster, whose static mesh is built from the components' #FRRMeshData
+ * transformed into the cluster frame & appended into a single mesh section, with a single complex-as-simple collision body.
+ * Thousands of static props thus cost a few draw calls & physics bodies instead of one each.
+ * The source components are hidden & their collision disabled, their actors being kept for entity queries.
+ * @note Only mesh components whose #FRRMeshData is still in #FRRMeshData::MeshDataStore are merged, primitive shapes not.
+ * Merged meshes have no LODs, nor per-entity segmentation masks other than the shared custom depth stencil.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRStaticMeshMerger
+{
+public:
+    /**
+     * @brief Merge mesh components as per InSettings, into mesh components created on InOwner
+     * @param InOwner Owner of the merged mesh components, whose root component is attached to
+     * @param InMeshComps Static ones are merged, the others being skipped
+     * @param InSettings
+     * @return TArray<URRStaticMeshComponent*> Merged mesh components
+     */
+    static TArray<URRStaticMeshComponent*> Merge(AActor* InOwner,
+                                                 const TArray<URRStaticMeshComponent*>& InMeshComps,
+                                                 const FRRStaticMeshMergeSettings& InSettings = FRRStaticMeshMergeSettings());
+
+    /**
+     * @brief Merge the static mesh components of all mesh actors of InWorld, into a merged mesh actor spawned in it
+     * @param InWorld
+     * @param InSettings
+     * @return AActor* Merged mesh actor, nullptr if nothing was merged
+     */
+    static AActor* MergeWorldStaticMeshes(UWorld* InWorld,
+                                          const FRRStaticMeshMergeSettings& InSettings = FRRStaticMeshMergeSettings());
+
+    /**
+     * @brief Merge the static mesh components of InActors, into a merged mesh actor spawned in InWorld
+     * @param InWorld
+     * @param InActors
+     * @param InSettings
+     * @return AActor* Merged mesh actor, nullptr if nothing was merged
+     */
+    static AActor* MergeActorsStaticMeshes(UWorld* InWorld,
+                                           const TArray<AActor*>& InActors,
+                                           const FRRStaticMeshMergeSettings& InSettings = FRRStaticMeshMergeSettings());
+
+    /**
+     * @brief Append InMeshData, transformed by InTransform, into the single merged mesh InOutMergedMesh
+     * @param InMeshData
+     * @param InTransform
+     * @param bInWithVertexColors Whether InOutMergedMesh has vertex colors, black for meshes without
+     * @param InOutMergedMesh
+     */
+    static void AppendMeshData(const FRRMeshData& InMeshData,
+                               const FTransform& InTransform,
+                               bool bInWithVertexColors,
+                               FRRMeshNodeData& InOutMergedMesh);
+};
@@ -0,0 +1,108 @@
+/**
+ * @file RRStreamingTexturePool.h
+ * @brief Working set of randomization textures streamed from a large image library.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "Async/Future.h"
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRActorCommon.h"
+#include "Core/RRTextureData.h"
+
+class UTexture;
+class UTexture2D;
+
+/**
+ * @brief Keep only a working set of textures resident, out of an image library of any size, for #FRRTextureData.
+ * Once the working set has been drawn from as many times as its size, a batch of images prefetched on worker threads
+ * replaces its oldest textures, which are recycled in place if of the same size & pixel format, and the next batch
+ * starts being prefetched. GPU memory is thus bounded by the working set size, whatever the library size.
+ * Resident textures are kept alive by this pool, which must only be used in the game thread.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRStreamingTexturePool : public FGCObject
+{
+public:
+    virtual ~FRRStreamingTexturePool();
+
+    /**
+     * @brief Collect the image library & load the first working set, blocking till it has been decoded
+     * @param InImageFolderPath
+     * @param InImageFileTypes
+     * @param InResidentTexturesNum Working set size
+     * @param InPrefetchBatchNum Textures replaced per batch, clamped to InResidentTexturesNum
+     * @param bInCompressed Whether textures are BC1-compressed, opaque, if their sizes are multiples of 4
+     * @return true if at least a texture is resident
+     */
+    bool Init(const FString& InImageFolderPath,
+              const TArray<ERRFileType>& InImageFileTypes,
+              const int32 InResidentTexturesNum,
+              const int32 InPrefetchBatchNum,
+              const bool bInCompressed = false);
+
+    //! Wait for the on-going prefetch & release all textures
+    void Reset();
+
+    //! Draw a random resident texture, swapping in the prefetched batch if the working set has been drawn through
+    UTexture* GetRandomTexture();
+
+    /**
+     * @brief Get the current working set, to be drawn from InDrawsNum times by the caller, eg on worker threads,
+     * swapping in the prefetched batch beforehand if the working set has been drawn through
+     * @param OutTextures
+     * @param InDrawsNum
+     */
+    void GetResidentTextures(TArray<UTexture*>& OutTextures, const int32 InDrawsNum);
+
+    int32 GetResidentTexturesNum() const
+    {
+        return ResidentTextures.Num();
+    }
+
+    int32 GetLibraryNum() const
+    {
+        return ImageFilePaths.Num();
+    }
+
+    virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+
+    virtual FString GetReferencerName() const override
+    {
+        return TEXT("FRRStreamingTexturePool");
+    }
+
+private:
+    using FRRDecodedBatch = TArray<TPair<int32, FRRDecodedImage>>;
+
+    //! Count draws from the working set, rotating it once drawn through as long as the prefetch does not block
+    void AddDraws(const int32 InDrawsNum);
+
+    //! Start decoding a batch of random library images not yet resident
+    void PrefetchNextBatch();
+
+    //! Replace the oldest resident textures by the prefetched batch's, which must have been decoded
+    void SwapInPrefetchedBatch();
+
+    UTexture2D* CreateTexture(const int32 InFileIndex, const FRRDecodedImage& InImage) const;
+
+    FString ImageFolderPath;
+    TArray<FString> ImageFilePaths;
+    int32 PrefetchBatchNum = 0;
+    bool bCompressed = false;
+
+    TArray<UTexture2D*> ResidentTextures;
+    //! Library index of each resident texture
+    TArray<int32> ResidentFileIndices;
+    //! Index in #ResidentTextures of the next one to be replaced
+    int32 NextReplacedIndex = 0;
+    int32 DrawsNum = 0;
+
+    //! Filled by the prefetch task, being shared with it
+    TSharedPtr<FRRDecodedBatch, ESPMode::ThreadSafe> PrefetchBatch;
+    TFuture<void> PrefetchFuture;
+};
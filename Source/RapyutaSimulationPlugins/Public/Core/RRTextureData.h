@@ -6,6 +6,8 @@
 
 #include "RRTextureData.generated.h"
 
+class UTextureLightProfile;
+
 USTRUCT()
 struct RAPYUTASIMULATIONPLUGINS_API FRRTextureData
 {
@@ -18,12 +20,40 @@ public:
     UPROPERTY()
     TArray<FString> TextureNames;
 
+    //! If set, textures are randomly picked from its resident working set instead
+    TSharedPtr<class FRRStreamingTexturePool> StreamingPool;
+
     UTexture* GetRandomTexture() const;
+
+    /**
+     * @brief Get all textures that could be drawn right now, for InDrawsNum draws to be sampled by the caller
+     * @sa #FRRStreamingTexturePool::GetResidentTextures()
+     */
+    void GetTextures(TArray<UTexture*>& OutTextures, const int32 InDrawsNum) const;
+};
+
+/**
+ * @brief An LDR image decoded into BGRA8 or BC1, possibly on a worker thread
+ * @sa #URRCoreUtils::DecodeImageFile()
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRDecodedImage
+{
+public:
+    TArray64<uint8> Data;
+    int32 Width = 0;
+    int32 Height = 0;
+    EPixelFormat PixelFormat = EPixelFormat::PF_Unknown;
+
+    bool IsValid() const
+    {
+        return (EPixelFormat::PF_Unknown != PixelFormat);
+    }
 };
 
 /**
- * @brief 
+ * @brief Light profile texels parsed from an IES file, owning its own buffer so that files could be parsed concurrently
  * @sa [DatasmithRuntime::FTextureData](https://docs.unrealengine.com/4.27/en-US/API/Plugins/DatasmithRuntime/)
+ * @sa #URRCoreUtils::ParseIESProfile()
  */
 struct RAPYUTASIMULATIONPLUGINS_API FRRLightProfileData
 {
@@ -33,9 +63,52 @@ public:
     int32 Height = 0;
     uint32 Pitch = 0;
     int16 BytesPerPixel = 0;
-    FUpdateTextureRegion2D Region = {0, 0, 0, 0, 0, 0};
-    uint8* ImageData = nullptr;
+    TArray<uint8> ImageData;
     // For IES profile
     float Brightness = -FLT_MAX;
     float TextureMultiplier = -FLT_MAX;
+
+    bool IsValid() const
+    {
+        return (Width > 0) && (Height > 0) && (ImageData.Num() > 0);
+    }
+
+    friend FArchive& operator<<(FArchive& Ar, FRRLightProfileData& InOutData)
+    {
+        return Ar << InOutData.Width << InOutData.Height << InOutData.Brightness << InOutData.TextureMultiplier
+                  << InOutData.ImageData;
+    }
+};
+
+/**
+ * @brief IES light profiles of a folder, parsed upfront in parallel while their textures are only created upon first use
+ */
+USTRUCT()
+struct RAPYUTASIMULATIONPLUGINS_API FRRLightProfileLibrary
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * @brief Parse all IES files under a folder on worker threads, reusing #FRRLightProfileCache
+     * @param InFolderPath
+     * @param bIsLogged
+     * @return true if all have been parsed
+     */
+    bool LoadFromFolder(const FString& InFolderPath, bool bIsLogged = false);
+
+    //! Get a light profile by its name, relative to the loaded folder, creating its texture upon the first fetching
+    UTextureLightProfile* GetLightProfile(const FString& InProfileName);
+
+    UTextureLightProfile* GetRandomLightProfile();
+
+    UPROPERTY()
+    TArray<FString> ProfileNames;
+
+protected:
+    UPROPERTY()
+    TMap<FString, UTextureLightProfile*> LightProfiles;
+
+    //! Released once their textures have been created
+    TMap<FString, FRRLightProfileData> ProfilesData;
 };
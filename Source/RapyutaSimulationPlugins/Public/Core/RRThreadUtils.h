@@ -6,9 +6,14 @@
 
 #pragma once
 
+// Native
+#include <atomic>
+
 // UE
 #include "Async/Async.h"
 #include "Async/AsyncWork.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Containers/Ticker.h"
 #include "HAL/PlatformProcess.h"
 #include "Kismet/BlueprintFunctionLibrary.h"
 #include "RenderCommandFence.h"
@@ -20,6 +25,58 @@
 
 #include "RRThreadUtils.generated.h"
 
+/**
+ * @brief Handle of a task graph task launched by #URRThreadUtils::LaunchTask, #URRThreadUtils::Then or
+ * #URRThreadUtils::ThenAfter, to be waited for, continued or cancelled.
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRTaskHandle
+{
+    //! Completed once the task has run or been skipped for being cancelled
+    FGraphEventRef Event;
+
+    //! Shared by the task & its continuations
+    TSharedPtr<std::atomic<bool>, ESPMode::ThreadSafe> CancelledFlag;
+
+    bool IsValid() const
+    {
+        return Event.IsValid();
+    }
+
+    bool IsCompleted() const
+    {
+        return !Event.IsValid() || Event->IsComplete();
+    }
+
+    //! Block till completion, processing the tasks of the calling named thread meanwhile
+    void Wait() const;
+
+    //! Skip the task if not started yet & all its continuations, which still complete for their dependents
+    void Cancel() const
+    {
+        if (CancelledFlag.IsValid())
+        {
+            *CancelledFlag = true;
+        }
+    }
+
+    bool IsCancelled() const
+    {
+        return CancelledFlag.IsValid() && *CancelledFlag;
+    }
+};
+
+/**
+ * @brief Priority of a job queued by #URRThreadUtils::EnqueueGameThreadJob
+ */
+UENUM()
+enum class ERRGameThreadJobPriority : uint8
+{
+    HIGH,      // Run in the next frame regardless of the budget
+    NORMAL,    // Run within the per-frame budget, before LOW ones
+    LOW,       // Run within the per-frame budget once no NORMAL one is left
+    TOTAL
+};
+
 /**
  * @brief ThreadUtils with Async
  * @sa [Async](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Core/Async/)
@@ -72,15 +129,79 @@ public:
     template<typename TFunc, typename... TArgs>
     static void DoTaskInGameThreadLater(TFunc&& InTaskInGameThread, float InWaitingTime, TArgs&&... Args)
     {
-        DoAsyncTaskInThread<void>(
-            [InWaitingTime]()
-            {
-                // Wait for the physics to complete the computation given earlier vel cmds
-                FPlatformProcess::Sleep(InWaitingTime);
-            },
-            [InTaskInGameThread = Forward<TFunc>(InTaskInGameThread)]() { DoTaskInGameThread(InTaskInGameThread); });
+        // Fired by the core ticker on game thread, eg once the physics has completed the computation given earlier vel cmds,
+        // instead of a pool thread sleeping meanwhile
+        FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda(
+                                                 [InTaskInGameThread = Forward<TFunc>(InTaskInGameThread)](float)
+                                                 {
+                                                     InTaskInGameThread();
+                                                     return false;
+                                                 }),
+                                             InWaitingTime);
     }
 
+    // ----------------------------------------------------------------------------------------------------------
+    // [GAME THREAD JOB QUEUE] --
+    //
+    /**
+     * @brief Queue a non-urgent job, eg material setup or mesh body creation, run on game thread in a later frame.
+     * Unlike [AsyncTask(ENamedThreads::GameThread)], queued jobs are drained by the core ticker within a per-frame budget,
+     * [rr.GameThreadJobs.BudgetMs], thus a burst of them, eg of spawned entities, is amortized over frames instead of
+     * hitching one, keeping sensors publishing steadily meanwhile. At least one job is run per frame.
+     * @note Thread-safe. Jobs of the same priority run in their queuing order.
+     *
+     * @param InJob
+     * @param InPriority
+     */
+    static void EnqueueGameThreadJob(TUniqueFunction<void()> InJob,
+                                     const ERRGameThreadJobPriority InPriority = ERRGameThreadJobPriority::NORMAL);
+
+    //! Num of queued jobs not run yet
+    static int32 GetGameThreadJobsNum();
+
+    // ----------------------------------------------------------------------------------------------------------
+    // [TASK GRAPH SERVICES] --
+    //
+    /**
+     * @brief Launch a task on the task graph once all its prerequisites are completed, without blocking any thread meanwhile
+     *
+     * @param InTask Skipped if cancelled or any prerequisite was
+     * @param InPrerequisites
+     * @param InThread Eg ENamedThreads::GameThread
+     * @param InCancelledFlag Shared with another task, a new one if null
+     * @return FRRTaskHandle
+     */
+    static FRRTaskHandle LaunchTask(TUniqueFunction<void()> InTask,
+                                    const TArray<FRRTaskHandle>& InPrerequisites = TArray<FRRTaskHandle>(),
+                                    const ENamedThreads::Type InThread = ENamedThreads::AnyBackgroundThreadNormalTask,
+                                    TSharedPtr<std::atomic<bool>, ESPMode::ThreadSafe> InCancelledFlag = nullptr);
+
+    /**
+     * @brief Continue a task, the continuation being cancelled along with it
+     *
+     * @param InTask
+     * @param InContinuation
+     * @param InThread
+     * @return FRRTaskHandle
+     */
+    static FRRTaskHandle Then(const FRRTaskHandle& InTask,
+                              TUniqueFunction<void()> InContinuation,
+                              const ENamedThreads::Type InThread = ENamedThreads::AnyBackgroundThreadNormalTask);
+
+    /**
+     * @brief Continue a task after a delay since its completion, timed by the core ticker instead of a sleeping worker
+     *
+     * @param InTask Invalid to only wait for the delay
+     * @param InDelaySeconds [s]
+     * @param InContinuation
+     * @param InThread
+     * @return FRRTaskHandle
+     */
+    static FRRTaskHandle ThenAfter(const FRRTaskHandle& InTask,
+                                   const float InDelaySeconds,
+                                   TUniqueFunction<void()> InContinuation,
+                                   const ENamedThreads::Type InThread = ENamedThreads::GameThread);
+
     template<typename TResult>
     static auto DoAsyncTaskInThread(TFunction<TResult()> InTask,
                                     TFunction<void()> InCompletionCallback,
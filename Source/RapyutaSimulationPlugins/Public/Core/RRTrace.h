@@ -0,0 +1,36 @@
+/**
+ * @file RRTrace.h
+ * @brief Unreal Insights trace channels & counters of the plugin's hot paths.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
+
+// RapyutaSimulationPlugins
+#include "Sensors/RRSensorStats.h"
+
+// Channels, besides #RRSensorChannel of lidar & camera scopes, recorded with eg -trace=cpu,gpu,counters,rrros2,rrsimstate &
+// toggled at runtime with the `rr.Trace <channel|all> <0|1>` console command
+
+//! ROS 2 publishing & subscription callbacks
+UE_TRACE_CHANNEL_EXTERN(RRROS2Channel, RAPYUTASIMULATIONPLUGINS_API);
+//! #ASimulationState services
+UE_TRACE_CHANNEL_EXTERN(RRSimStateChannel, RAPYUTASIMULATIONPLUGINS_API);
+//! Mesh & asset loading
+UE_TRACE_CHANNEL_EXTERN(RRAssetChannel, RAPYUTASIMULATIONPLUGINS_API);
+//! Drive & joint components updates
+UE_TRACE_CHANNEL_EXTERN(RRDriveChannel, RAPYUTASIMULATIONPLUGINS_API);
+
+// Counters, recorded with the counters channel
+TRACE_DECLARE_INT_COUNTER_EXTERN(RRLidarActiveRays);
+TRACE_DECLARE_INT_COUNTER_EXTERN(RRCameraQueuedRenderRequests);
+TRACE_DECLARE_INT_COUNTER_EXTERN(RRPendingAsyncMeshLoads);
+TRACE_DECLARE_INT_COUNTER_EXTERN(RREntitiesNum);
+TRACE_DECLARE_INT_COUNTER_EXTERN(RRPendingGameThreadJobs);
+TRACE_DECLARE_INT_COUNTER_EXTERN(RRPendingPublisherThreadMsgs);
@@ -551,6 +551,89 @@ public:
         return newSimActor;
     }
 
+    /**
+     * @brief Spawn a batch of actors as #SpawnSimActor<T>() does each, but all deferred first then finished together by
+     * #FinishSpawningActors(), before initializing each with its spawn info, eg for ARRSceneDirector::SpawnActors()
+     * @tparam T
+     * @tparam TActorSpawnInfo
+     * @param InWorld
+     * @param InSceneInstanceId
+     * @param InActorSpawnInfos
+     * @param CollisionHandlingType
+     * @return TArray<T*> Indexed as InActorSpawnInfos, nullptr for each one failing to spawn
+     */
+    template<typename T, typename TActorSpawnInfo>
+    static TArray<T*> SpawnSimActors(
+        UWorld* InWorld,
+        int8 InSceneInstanceId,
+        const TArray<TActorSpawnInfo>& InActorSpawnInfos,
+        const ESpawnActorCollisionHandlingMethod CollisionHandlingType = ESpawnActorCollisionHandlingMethod::AlwaysSpawn)
+    {
+        const int32 actorsNum = InActorSpawnInfos.Num();
+        TArray<AActor*> newActors;
+        newActors.Init(nullptr, actorsNum);
+        TArray<FTransform> actorTransforms;
+        actorTransforms.Reserve(actorsNum);
+
+        // 1- Spawn all deferred, in the scene instance as taken by their ctor
+        T::SSceneInstanceId = InSceneInstanceId;
+        for (int32 i = 0; i < actorsNum; ++i)
+        {
+            const TActorSpawnInfo& actorSpawnInfo = InActorSpawnInfos[i];
+            actorTransforms.Add(actorSpawnInfo.ActorTransform);
+            if (false == actorSpawnInfo.IsValid(true))
+            {
+                continue;
+            }
+            if ((actorSpawnInfo.TypeClass == nullptr) && (false == T::StaticClass()->IsChildOf(AActor::StaticClass())))
+            {
+                UE_LOG_WITH_INFO(LogTemp, Fatal, TEXT("NULL SPAWN TYPE-CLASS && A NON-AACTOR CLASS!"));
+                continue;
+            }
+
+            FActorSpawnParameters spawnInfo;
+            spawnInfo.Name = FName(*actorSpawnInfo.UniqueName);
+            spawnInfo.SpawnCollisionHandlingOverride = CollisionHandlingType;
+            spawnInfo.bDeferConstruction = true;
+            newActors[i] = InWorld->SpawnActor<T>(actorSpawnInfo.TypeClass ? static_cast<UClass*>(actorSpawnInfo.TypeClass)
+                                                                           : static_cast<UClass*>(T::StaticClass()),
+                                                  actorSpawnInfo.ActorTransform,
+                                                  spawnInfo);
+        }
+
+        // 2- Finish them together
+        FinishSpawningActors(InWorld, newActors, actorTransforms);
+
+        // 3- Initialize each with its spawn info, requiring its components to have been initialized
+        TArray<T*> newSimActors;
+        newSimActors.Init(nullptr, actorsNum);
+        for (int32 i = 0; i < actorsNum; ++i)
+        {
+            T* newSimActor = Cast<T>(newActors[i]);
+            if (nullptr == newSimActor)
+            {
+                UE_LOG_WITH_INFO(
+                    LogTemp, Warning, TEXT("[%s] FAILED SPAWNING OBJECT ACTOR!!!"), *InActorSpawnInfos[i].UniqueName);
+                continue;
+            }
+            newSimActor->template InitializeWithSpawnInfo<TActorSpawnInfo>(InActorSpawnInfos[i]);
+#if WITH_EDITOR
+            newSimActor->SetActorLabel(InActorSpawnInfos[i].UniqueName);
+#endif
+            newSimActors[i] = newSimActor;
+        }
+        return newSimActors;
+    }
+
+    /**
+     * @brief Finish spawning actors spawned deferred, eg by SpawnActorDeferred(), under a single navigation lock so that the
+     * navigation octree is updated once for all of them instead of upon each one's components being registered
+     * @param InWorld
+     * @param InOutActors Deferred actors, nullptr ones being skipped & those destroyed upon finishing being set to nullptr
+     * @param InTransforms Final transform of each of InOutActors
+     */
+    static void FinishSpawningActors(UWorld* InWorld, TArray<AActor*>& InOutActors, const TArray<FTransform>& InTransforms);
+
     /**
      * @brief Spawn a generic actor that is either mesh-based or mesh-free
      *
@@ -774,6 +857,25 @@ public:
             actor->AddActorWorldOffset(center - actor->GetActorLocation(), true);
         }
     }
+
+    //! Custom primitive data index of seg mask instance ids, as URRInstancedMeshGroupComponent::CUSTOM_DATA_INDEX_SEGMASK_ID
+    static constexpr int32 SEGMASK_ID_CUSTOM_PRIMITIVE_DATA_INDEX = 0;
+
+    //! Custom depth stencil value of primitives labelled by an instance id, marking them as segmasked
+    static constexpr int32 SEGMASK_INSTANCE_ID_STENCIL_VALUE = 1;
+
+    /**
+     * @brief Set the seg mask id of a primitive: its custom depth stencil value or, if
+     * #URRActorCommon::IsSegMaskInstanceIdEnabled(), its 24-bit instance id in custom primitive data,
+     * to be output by its material
+     * @param InComp
+     * @param InSegMaskId #URRActorCommon::DEFAULT_CUSTOM_DEPTH_STENCIL_VALUE_VOID to unlabel it
+     */
+    static void SetSegMaskId(UPrimitiveComponent* InComp, const int32 InSegMaskId);
+
+    //! Seg mask id set by #SetSegMaskId()
+    static int32 GetSegMaskId(const UPrimitiveComponent* InComp);
+
     static FString GetSegMaskDepthStencilsAsText(AActor* InActor);
     static bool GetPhysicsActorHandles(FBodyInstance* InBody1,
                                        FBodyInstance* InBody2,
@@ -794,4 +896,17 @@ public:
                                    bool bApplyManufacturingAlbedo = true);
     static bool SetMeshActorColor(AActor* InMeshActor, const FLinearColor& InColor, bool InEmitColor = false);
     static void RandomizeActorAppearance(AActor* InActor, const FRRTextureData& InTextureData);
+
+    /**
+     * @brief Randomize the appearance of many actors at once, like #RandomizeActorAppearance() does for each.
+     * All parameters are first sampled in parallel, each actor from its own #URRMathUtils::GetRandomSubstream() of InSeed &
+     * its index in InActors, thus reproducibly. They are then applied in a single game thread pass, only parameters having
+     * changed being set, instanced entities' groups marking their render states dirty once.
+     * @param InActors
+     * @param InTextureData
+     * @param InSeed
+     */
+    static void RandomizeActorsAppearance(const TArray<AActor*>& InActors,
+                                          const FRRTextureData& InTextureData,
+                                          const int32 InSeed);
 };
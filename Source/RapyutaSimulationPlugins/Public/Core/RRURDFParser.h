@@ -49,9 +49,52 @@ private:
     TArray<FString> EndEffectorNames;
     TArray<FRRRobotWheelProperty> WheelPropList;
     FRRMaterialProperty WholeBodyMaterialInfo;
+    FRRMeshLODSettings MeshLODSettings;
+
+    //! Interned tokens of the elements the parser branches on, compared instead of their names
+    enum class ERRURDFElement : uint8
+    {
+        OTHER,
+        ROBOT,
+        JOINT,
+        LINK,
+        TRANSMISSION,
+        UE,
+        MATERIAL,
+        VISUAL,
+        INERTIAL,
+        COLLISION,
+        SENSOR,
+        COMPONENT,
+        BASE_LINK,
+        ARTICULATED_LINK,
+        WHEEL,
+        END_EFFECTOR,
+        ALBEDO,
+        ORM,
+        NORMAL,
+        RAY,
+        LIDAR,
+        HORIZONTAL,
+        VERTICAL,
+        RANGE,
+        NOISE
+    };
+    static ERRURDFElement GetElementToken(const TCHAR* InElementName);
 
     //! Element stack
     TArray<FString> ElemStack;
+    //! Tokens of #ElemStack's elements
+    TArray<ERRURDFElement> ElemTokenStack;
+    //! #ElemStack joined by "_", maintained upon push/pop instead of being joined per attribute
+    FString ElemPath;
+    TArray<int32> ElemPathLengths;
+    //! Per #ElemStack level, bitmask of the UE elements contained in #ElemPath
+    TArray<uint32> UEElementMasks;
+    int32 FindLastElement(const ERRURDFElement InToken) const
+    {
+        return ElemTokenStack.FindLast(InToken);
+    }
 
     //! Elements' Name & Value attributes
     TMap<FString, FString> AttMap;
@@ -68,8 +111,13 @@ private:
         WheelPropList.Reset();
         EndEffectorNames.Reset();
         WholeBodyMaterialInfo = FRRMaterialProperty();
+        MeshLODSettings = FRRMeshLODSettings();
 
         ElemStack.Reset();
+        ElemTokenStack.Reset();
+        ElemPath.Reset();
+        ElemPathLengths.Reset();
+        UEElementMasks.Reset();
         AttMap.Reset();
     }
 
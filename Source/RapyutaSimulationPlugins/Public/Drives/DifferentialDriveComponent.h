@@ -16,6 +16,21 @@
 
 DECLARE_LOG_CATEGORY_EXTERN(LogDifferentialDriveComponent, Log, All);
 
+class FJointConstraintPhysicsProxy;
+
+/**
+ * @brief Wheel constraint's physics proxy, cached along with the Chaos joint it was resolved from, & its last drive target
+ */
+struct FRRWheelDriveCache
+{
+    const void* Constraint = nullptr;
+    FJointConstraintPhysicsProxy* Proxy = nullptr;
+
+    //! [rev/s]
+    FVector LastTarget = FVector::ZeroVector;
+    bool bSubmitted = false;
+};
+
 /**
  * @brief Differential Drive component class.
  * Simulate differential drive by using 2 UPhysicsConstraintComponent.
@@ -104,11 +119,46 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     float MaxForce = 1000.f;
 
+    //! Write wheel drive targets directly on their Chaos joints on physics thread by #FRRPhysicsSubstepManager, only upon a
+    //! change, instead of calling the constraint API each tick. Falls back to the latter if the wheels have no physics yet.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bPhysicsThreadDrive = false;
+
 protected:
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    /**
+     * @brief Submit wheels' drive targets to #FRRPhysicsSubstepManager, (re)resolving their proxies if needed
+     * @param InLeftTarget [rev/s]
+     * @param InRightTarget [rev/s]
+     * @return false if any wheel has no physics proxy
+     */
+    bool SubmitPhysicsThreadDrive(const FVector& InLeftTarget, const FVector& InRightTarget);
+
+    FRRWheelDriveCache WheelLeftDrive;
+    FRRWheelDriveCache WheelRightDrive;
+
+    //! MaxForce last set to the wheels' drive params by #SubmitPhysicsThreadDrive, < 0 if not yet
+    float DriveMaxForce = -1.f;
+
+    //! #UpdateOdom, from #PendingOdomDeltaTime, being thread-safe across robots
+    virtual FRRDriveParallelUpdate GetDriveParallelUpdate() const override
+    {
+        return &UDifferentialDriveComponent::UpdatePendingOdom;
+    }
+
+    static void UpdatePendingOdom(UActorComponent* InComponent);
+
+    //! [s] Time to integrate odom by, left to #FRRDriveTickManager upon #bAggregatedTick
+    float PendingOdomDeltaTime = 0.f;
+
     //! [cm]
     UPROPERTY()
     float WheelPerimeter = 6.28f;
 
+    //! [1/cm] Precomputed by #SetPerimeter
+    float InvWheelPerimeter = 1.f / 6.28f;
+
     //! [cm]
     UPROPERTY()
     float PoseEncoderX = 0.f;
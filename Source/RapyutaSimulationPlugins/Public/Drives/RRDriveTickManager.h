@@ -0,0 +1,132 @@
+/**
+ * @file RRDriveTickManager.h
+ * @brief Per-world manager ticking all drive, odom & joint components of a class in a single tick function.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// Native
+#include <mutex>
+
+// UE
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+
+#include "RRDriveTickManager.generated.h"
+
+class AActor;
+class UActorComponent;
+class UWorld;
+struct FRRDriveTickGroup;
+
+/**
+ * @brief Update run on each component of a #FRRDriveTickGroup after all of them have ticked, in a ParallelFor, thus which
+ * must only touch the component's own data & read its robot's
+ */
+using FRRDriveParallelUpdate = void (*)(UActorComponent* InComponent);
+
+/**
+ * @brief Tick function of a #FRRDriveTickGroup
+ */
+USTRUCT()
+struct RAPYUTASIMULATIONPLUGINS_API FRRDriveTickFunction : public FTickFunction
+{
+    GENERATED_BODY()
+
+    FRRDriveTickGroup* Group = nullptr;
+
+    virtual void ExecuteTick(float DeltaTime,
+                             ELevelTick TickType,
+                             ENamedThreads::Type CurrentThread,
+                             const FGraphEventRef& MyCompletionGraphEvent) override;
+
+    virtual FString DiagnosticMessage() override
+    {
+        return TEXT("FRRDriveTickFunction");
+    }
+};
+
+template<>
+struct TStructOpsTypeTraits<FRRDriveTickFunction> : public TStructOpsTypeTraitsBase2<FRRDriveTickFunction>
+{
+    enum
+    {
+        WithCopy = false
+    };
+};
+
+/**
+ * @brief All components of one class ticked by #FRRDriveTickManager
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRDriveTickGroup
+{
+    ~FRRDriveTickGroup();
+
+    /**
+     * @brief Tick all components on game thread, by their owners' time dilation, then run #ParallelUpdate on them
+     * @param InDeltaTime [s]
+     * @param InTickType
+     */
+    void Tick(const float InDeltaTime, const ELevelTick InTickType);
+
+    FRRDriveTickFunction TickFunction;
+    TArray<TWeakObjectPtr<UActorComponent>> Components;
+    FRRDriveParallelUpdate ParallelUpdate = nullptr;
+
+private:
+    //! Ticked components by their root attach actor, reused across ticks
+    TArray<TPair<const AActor*, UActorComponent*>> TickedComponents;
+
+    //! Offsets into #TickedComponents of each root attach actor's components
+    TArray<int32> IslandOffsets;
+};
+
+/**
+ * @brief Per-world drive tick manager, replacing the per-component tick functions of components with bAggregatedTick on,
+ * eg #URobotVehicleMovementComponent, #URRBaseOdomComponent, #URRJointComponent & their child classes.
+ * Components are grouped by class, each #FRRDriveTickGroup having a single tick function in the tick group of its first
+ * component, which ticks them all in one loop. Thus ticking N robots costs one tick dispatch per component class instead
+ * of one per component, but group ticks have no prerequisites on their components' owner actors.
+ *
+ * A group's #FRRDriveTickGroup::ParallelUpdate, if any, is then run in a ParallelFor across robots unless the
+ * rr.DriveTick.Parallel console variable is 0. Robots attached together, thus possibly sharing physics bodies, are updated
+ * in the same task, serially. Component ticks themselves always run on game thread, moving scene components.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRDriveTickManager
+{
+public:
+    /**
+     * @brief Get the manager of a world, creating it upon the first fetching
+     *
+     * @param InWorld
+     * @return FRRDriveTickManager&
+     */
+    static FRRDriveTickManager& Get(UWorld* InWorld);
+
+    /**
+     * @brief Tick a component by its class group, disabling its own tick
+     * @param InComponent
+     * @param InParallelUpdate Only taken from the first component of its class
+     */
+    void AddComponent(UActorComponent* InComponent, FRRDriveParallelUpdate InParallelUpdate = nullptr);
+
+    //! Stop ticking a component, its own tick being left disabled
+    void RemoveComponent(UActorComponent* InComponent);
+
+    int32 GetGroupsNum() const
+    {
+        return Groups.Num();
+    }
+
+    int32 GetComponentsNum() const;
+
+private:
+    static TMap<UWorld*, TUniquePtr<FRRDriveTickManager>> SManagers;
+    static std::once_flag OnceFlag;
+
+    static void OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/);
+
+    TWeakObjectPtr<UWorld> World;
+    TMap<UClass*, TUniquePtr<FRRDriveTickGroup>> Groups;
+};
@@ -59,6 +59,12 @@ public:
         bUseAccelerationForPaths = bEnabled;
     }
 
+    //! Whether moves sweep #UpdatedComponent, sliding along blocking surfaces, else teleport it through them
+    void SetSweepEnabled(bool bEnabled)
+    {
+        bSweepEnabled = bEnabled;
+    }
+
     void SetPenetrationPullbackDistance(float PullbackDistance)
     {
         PenetrationPullbackDistance = PullbackDistance;
@@ -66,6 +72,23 @@ public:
 
     virtual void StopMovementImmediately() override;
 
+    //! Move along with all other fleet robots of the world by #FRRKinematicFleet, only sweeping near static geometry
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bFleetMovement = false;
+
+    //! [cm] Radius of the robot in #FRRKinematicFleet, <= 0 to take its bounds' XY extent
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float FleetRadius = 0.f;
+
+    /**
+     * @brief Move #UpdatedComponent, sliding along surfaces if sweeping, then update #Velocity from the actual movement
+     * @param InDelta [cm] World translation
+     * @param InNewRotation
+     * @param bInSweep Only applied if bSweepEnabled
+     * @param InDeltaTime
+     */
+    void ApplyMovement(const FVector& InDelta, const FQuat& InNewRotation, const bool bInSweep, const float InDeltaTime);
+
 protected:
     virtual void TickComponent(float InDeltaTime, enum ELevelTick InTickType, FActorComponentTickFunction* InTickFunction) override;
     virtual bool IsExceedingMaxSpeed(float InMaxSpeed) const override;
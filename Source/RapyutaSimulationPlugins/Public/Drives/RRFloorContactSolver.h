@@ -0,0 +1,149 @@
+/**
+ * @file RRFloorContactSolver.h
+ * @brief Per-world solver which traces the floor contacts of all robot vehicles of a frame in one batch.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// Native
+#include <mutex>
+
+// UE
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+
+class UWorld;
+class URobotVehicleMovementComponent;
+
+/**
+ * @brief Height field of static floors, as the surfaces found in each XY cell of #CellSize.
+ * Cells are either filled lazily from traced hits, or all at once within bounds by #Build(), which makes them authoritative,
+ * ie a missing surface means there is no static floor there.
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRFloorHeightMap
+{
+    //! A static floor surface, locally planar around its point
+    struct FSample
+    {
+        FVector Point = FVector::ZeroVector;
+        FVector Normal = FVector::UpVector;
+    };
+
+    //! [cm]
+    float CellSize = 50.f;
+
+    TMap<FIntPoint, TArray<FSample, TInlineAllocator<2>>> Cells;
+
+    //! XY bounds built by #Build()
+    TArray<FBox2D> AuthoritativeBounds;
+
+    FIntPoint GetCell(const FVector& InLocation) const
+    {
+        return FIntPoint(FMath::FloorToInt32(InLocation.X / CellSize), FMath::FloorToInt32(InLocation.Y / CellSize));
+    }
+
+    /**
+     * @brief Find the floor hit of a vertical ray from its cell's surfaces, evaluating their plane at the ray location
+     * @param InStart Ray start
+     * @param InEnd Ray end, straight below
+     * @param OutHit Blocking if a surface is within the ray
+     * @return false if unknown, ie the cell is not authoritative & has no surface within the ray, thus to be traced
+     */
+    bool FindFloor(const FVector& InStart, const FVector& InEnd, FHitResult& OutHit) const;
+
+    //! Add a traced hit's surface to its cell, unless already in
+    void AddSample(const FHitResult& InHit);
+
+    /**
+     * @brief Trace all static surfaces of the cells within XY bounds, through their Z range
+     * @param InWorld
+     * @param InBounds
+     */
+    void Build(UWorld* InWorld, const FBox& InBounds);
+
+    bool IsAuthoritative(const FVector& InLocation) const;
+
+    void Reset()
+    {
+        Cells.Reset();
+        AuthoritativeBounds.Reset();
+    }
+};
+
+/**
+ * @brief Per-world floor contact solver.
+ * #URobotVehicleMovementComponent with #URobotVehicleMovementComponent::bBatchFloorContacts on only queue themselves upon
+ * moving. All floor contact rays queued in a frame are then traced against simple collision in one ParallelFor, upon
+ * [FWorldDelegates::OnWorldPostActorTick], and each robot adapts its pose to its own hits on game thread.
+ * Rays of robots with #URobotVehicleMovementComponent::bCacheStaticFloorHeights are first looked up in #FloorHeights, which
+ * is filled from the traced hits on static floors, then only traced upon a miss. Within a static floor map built from
+ * #URobotVehicleMovementComponent::StaticFloorMapBounds, they are never traced. Robots on a moving platform always trace.
+ *
+ * @sa [OnWorldPostActorTick](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/Engine/FWorldDelegates/OnWorldPostActorTick/)
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRFloorContactSolver
+{
+public:
+    /**
+     * @brief Get the solver of a world, creating it upon the first fetching
+     *
+     * @param InWorld
+     * @return FRRFloorContactSolver&
+     */
+    static FRRFloorContactSolver& Get(UWorld* InWorld);
+
+    /**
+     * @brief Queue a robot to adapt to its floor in the next #Flush(), only once per frame
+     * @param InMovementComp
+     * @param InDeltaTime [s] Of its movement update, for falling
+     */
+    void AddRobot(URobotVehicleMovementComponent* InMovementComp, const float InDeltaTime);
+
+    //! Trace all pending robots' floor contacts in a single batch, then let each robot adapt to its own
+    void Flush();
+
+    /**
+     * @brief Build the static floor map within bounds, once, for rays within it to never be traced
+     * @param InBounds
+     * @param InCellSize [cm] Only applied if the map is still empty
+     */
+    void BuildStaticFloorMap(const FBox& InBounds, const float InCellSize);
+
+    //! Forget all cached & mapped floors, eg after the static level geometry has been changed
+    void ResetFloorHeights()
+    {
+        FloorHeights.Reset();
+    }
+
+    int32 GetPendingRobotsNum() const
+    {
+        return PendingRobots.Num();
+    }
+
+    //! Num of rays of the latest #Flush() found in #FloorHeights, thus not traced
+    int32 GetLastCachedRaysNum() const
+    {
+        return LastCachedRaysNum;
+    }
+
+    FRRFloorHeightMap FloorHeights;
+
+private:
+    static TMap<UWorld*, TUniquePtr<FRRFloorContactSolver>> SSolvers;
+    static std::once_flag OnceFlag;
+
+    static void OnWorldPostActorTick(UWorld* InWorld, ELevelTick /*InTickType*/, float /*InDeltaSeconds*/);
+    static void OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/);
+
+    TWeakObjectPtr<UWorld> World;
+    TArray<TPair<TWeakObjectPtr<URobotVehicleMovementComponent>, float>> PendingRobots;
+
+    //! Reused across flushes: rays, their hits & per robot offsets into them
+    TArray<FVector> RayStarts;
+    TArray<FVector> RayEnds;
+    TArray<FHitResult> RayHits;
+    TArray<int32> RayOffsets;
+    TArray<int32> TracedRayIndices;
+    int32 LastCachedRaysNum = 0;
+};
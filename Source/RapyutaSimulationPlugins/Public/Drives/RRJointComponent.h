@@ -12,6 +12,8 @@
 
 #include "RRJointComponent.generated.h"
 
+struct FRRLinkBodyStates;
+
 #define RAPYUTA_JOINT_DEBUG (0)
 
 UENUM(BlueprintType)
@@ -38,7 +40,9 @@ public:
     URRJointComponent();
 
 protected:
+    //! Call #Initialize, then add to #FRRDriveTickManager if #bAggregatedTick
     virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void PoseFromArray(const TArray<float>& InPose, FVector& OutPosition, FRotator& OutOrientation);
     virtual void VelocityFromArray(const TArray<float>& InVelocity, FVector& OutLinearVelocity, FVector& OutAngularVelocity);
 
@@ -51,6 +55,36 @@ public:
      */
     virtual void Initialize();
 
+    /**
+     * @brief Call #UpdateJoint, unless #bUpdatedByOwner
+     *
+     * @param DeltaTime
+     * @param TickType
+     * @param ThisTickFunction
+     */
+    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+    /**
+     * @brief Update joint state & control, which should be implemented in child class.
+     * Called by #TickComponent or, for robot joints, by the robot's #FRRJointStateBlock in a single loop.
+     * @param InDeltaTime
+     * @param InTime World time, fetched once for all joints updated together
+     */
+    virtual void UpdateJoint(const float InDeltaTime, const float InTime)
+    {
+    }
+
+    //! Whether #UpdateJoint is called by the owner robot's #FRRJointStateBlock instead of this component's tick
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    bool bUpdatedByOwner = false;
+
+    //! Ticked by the world's #FRRDriveTickManager along with all other joints of its class, instead of by its own tick
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bAggregatedTick = false;
+
+    //! Link body states shared by all joints of the owner's #FRRJointStateBlock in its update, nullptr if not #bUpdatedByOwner
+    FRRLinkBodyStates* LinkBodyStates = nullptr;
+
     /**
      * @brief Directly set velocity.
      * Control to move joint with this velocity should be implemented in child class.
@@ -0,0 +1,162 @@
+/**
+ * @file RRJointStateBlock.h
+ * @brief Per-robot contiguous joint states, updated in a single tick for all robot joints.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+
+#include "RRJointStateBlock.generated.h"
+
+class UPrimitiveComponent;
+class URRJointComponent;
+
+/**
+ * @brief World center of mass & velocities of link bodies, as read from the physics solver, each once per joint block update
+ * however many joints it is linked by.
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRLinkBodyStates
+{
+    struct FState
+    {
+        FVector CenterOfMass = FVector::ZeroVector;
+
+        //! [cm/s]
+        FVector LinearVelocity = FVector::ZeroVector;
+
+        //! [rad/s]
+        FVector AngularVelocity = FVector::ZeroVector;
+
+        //! [cm/s] Velocity of the body's point at InLocation
+        FVector GetVelocityAtPoint(const FVector& InLocation) const
+        {
+            return LinearVelocity + (AngularVelocity ^ (InLocation - CenterOfMass));
+        }
+
+        //! Zero velocities at the link's location if it has no physics body
+        static FState Read(const UPrimitiveComponent& InLink);
+    };
+
+    //! Read upon the first query since #Reset()
+    const FState& FindOrRead(const UPrimitiveComponent& InLink);
+
+    void Reset()
+    {
+        States.Reset();
+    }
+
+    TMap<const UPrimitiveComponent*, FState> States;
+};
+
+/**
+ * @brief Structure of arrays of the joint states of a robot.
+ * Joint i owns the DOF entries [#Offsets[i], #Offsets[i] + #DOFsNum[i]) of the per-DOF arrays, linear DOFs first then
+ * rotational ones, in UE units ([cm], [deg], [cm/s], [deg/s]), the same order as
+ * #URRJointComponent::SetPoseTargetWithArray(). Joint state publishing thus copies #Positions, #Velocities as a whole.
+ *
+ * Upon #Reset(), the joints' own ticks are disabled, #Update() updating all of them in one loop, sharing #LinkBodyStates.
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRJointStateBlock
+{
+    //! Bits 0-2: linear X, Y, Z, bits 3-5: rotational X, Y, Z
+    enum EDOFMask : uint8
+    {
+        LINEAR_X = 0x01,
+        LINEAR_Y = 0x02,
+        LINEAR_Z = 0x04,
+        ROTATIONAL_X = 0x08,
+        ROTATIONAL_Y = 0x10,
+        ROTATIONAL_Z = 0x20
+    };
+
+    /**
+     * @brief (Re)build the block from InJoints, disabling their component ticks
+     * @param InJoints
+     */
+    void Reset(const TMap<FString, URRJointComponent*>& InJoints);
+
+    /**
+     * @brief Whether the block has been built from the same joints as InJoints
+     * @param InJoints
+     */
+    bool Matches(const TMap<FString, URRJointComponent*>& InJoints) const;
+
+    /**
+     * @brief Update all joints, fetching the world time once, then gather their states
+     * @param InDeltaTime
+     */
+    void Update(const float InDeltaTime);
+
+    int32 Num() const
+    {
+        return Joints.Num();
+    }
+
+    TArrayView<const float> GetJointPositions(const int32 InJointIndex) const
+    {
+        return TArrayView<const float>(Positions.GetData() + Offsets[InJointIndex], DOFsNum[InJointIndex]);
+    }
+
+    TArrayView<const float> GetJointVelocities(const int32 InJointIndex) const
+    {
+        return TArrayView<const float>(Velocities.GetData() + Offsets[InJointIndex], DOFsNum[InJointIndex]);
+    }
+
+    TArray<FString> Names;
+    TArray<TWeakObjectPtr<URRJointComponent>> Joints;
+    TArray<int32> Offsets;
+    TArray<uint8> DOFsNum;
+    TArray<uint8> DOFMasks;
+
+    // Per DOF
+    TArray<float> Positions;
+    TArray<float> Velocities;
+    TArray<float> PositionTargets;
+    TArray<float> VelocityTargets;
+
+    //! Reset upon each #Update()
+    FRRLinkBodyStates LinkBodyStates;
+
+private:
+    //! Joints as given to #Reset(), for #Matches()
+    TArray<URRJointComponent*> SourceJoints;
+
+    void Gather(const int32 InJointIndex, const URRJointComponent& InJoint);
+};
+
+/**
+ * @brief Tick function of a robot updating its #FRRJointStateBlock, independently of the robot actor's own tick
+ */
+USTRUCT()
+struct RAPYUTASIMULATIONPLUGINS_API FRRJointsTickFunction : public FTickFunction
+{
+    GENERATED_BODY()
+
+    FRRJointStateBlock* Block = nullptr;
+
+    //! Joints to (re)build #Block from, upon their changing
+    const TMap<FString, URRJointComponent*>* Joints = nullptr;
+
+    virtual void ExecuteTick(float DeltaTime,
+                             ELevelTick TickType,
+                             ENamedThreads::Type CurrentThread,
+                             const FGraphEventRef& MyCompletionGraphEvent) override;
+
+    virtual FString DiagnosticMessage() override
+    {
+        return TEXT("FRRJointsTickFunction");
+    }
+};
+
+template<>
+struct TStructOpsTypeTraits<FRRJointsTickFunction> : public TStructOpsTypeTraitsBase2<FRRJointsTickFunction>
+{
+    enum
+    {
+        WithCopy = false
+    };
+};
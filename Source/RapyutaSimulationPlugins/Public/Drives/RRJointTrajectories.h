@@ -0,0 +1,80 @@
+/**
+ * @file RRJointTrajectories.h
+ * @brief Allocation-free constant acceleration trajectories of many joint axes, evaluated all at once.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+/**
+ * @brief Two-point constant acceleration trajectories of joint axes, as two_points_interpolation_cpp's
+ * TwoPointInterpolation & TwoAngleInterpolation with a zero end velocity, stored as structure of arrays.
+ * Each axis is planned as up to #SEGMENTS_NUM constant acceleration segments: a stop if moving away from or unable to stop
+ * before its target, then acceleration, cruise at the max velocity & deceleration.
+ * #Evaluate() then computes all axes' positions & velocities into caller arrays, segment by segment in branchless loops
+ * over the axes, which are auto-vectorized. Up to #INLINE_AXES_NUM axes are stored inline, thus copying never allocates.
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRJointTrajectories
+{
+    static constexpr int32 SEGMENTS_NUM = 4;
+
+    //! A 6 DOF joint's 3 linear, then 3 rotational axes
+    static constexpr int32 INLINE_AXES_NUM = 6;
+
+    //! (Re)size to InAxesNum axes, all uninitialized
+    void SetNum(const int32 InAxesNum);
+
+    int32 Num() const
+    {
+        return StartTimes.Num();
+    }
+
+    bool IsInitialized(const int32 InAxis) const
+    {
+        return InitializedFlags[InAxis];
+    }
+
+    /**
+     * @brief Plan an axis from its current state to rest at a target
+     * @param InAxis
+     * @param InStartPosition
+     * @param InEndPosition
+     * @param InAccMax > 0
+     * @param InVelMax > 0
+     * @param InStartTime [s]
+     * @param InStartVelocity
+     * @param bInAngle [rad] Toward InEndPosition by the shortest way around
+     */
+    void Plan(const int32 InAxis,
+              const double InStartPosition,
+              const double InEndPosition,
+              const double InAccMax,
+              const double InVelMax,
+              const double InStartTime,
+              const double InStartVelocity,
+              const bool bInAngle = false);
+
+    /**
+     * @brief Evaluate all axes, uninitialized ones keeping zero positions & velocities
+     * @param InTime [s] Before an axis' start time, its start state is returned, after its end, its target at rest
+     * @param OutPositions At least #Num()
+     * @param OutVelocities At least #Num()
+     */
+    void Evaluate(const double InTime, TArrayView<double> OutPositions, TArrayView<double> OutVelocities) const;
+
+private:
+    using FAxesArray = TArray<double, TInlineAllocator<INLINE_AXES_NUM>>;
+
+    FAxesArray StartTimes;
+    FAxesArray StartPositions;
+    FAxesArray StartVelocities;
+    TArray<bool, TInlineAllocator<INLINE_AXES_NUM>> InitializedFlags;
+
+    //! Per segment, per axis: absolute start time, duration & acceleration
+    TStaticArray<FAxesArray, SEGMENTS_NUM> SegmentStarts;
+    TStaticArray<FAxesArray, SEGMENTS_NUM> SegmentDurations;
+    TStaticArray<FAxesArray, SEGMENTS_NUM> SegmentAccs;
+};
@@ -0,0 +1,155 @@
+/**
+ * @file RRKinematicFleet.h
+ * @brief Per-world system which moves all kinematic fleet robots in one data-oriented pass per frame.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// Native
+#include <mutex>
+
+// UE
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "UObject/ObjectKey.h"
+
+#include "RRKinematicFleet.generated.h"
+
+class FRRKinematicFleet;
+class UMovementComponent;
+class UWorld;
+
+/**
+ * @brief Tick function of a world's #FRRKinematicFleet, in TG_PostPhysics, thus after all robots have submitted their moves
+ */
+USTRUCT()
+struct RAPYUTASIMULATIONPLUGINS_API FRRKinematicFleetTickFunction : public FTickFunction
+{
+    GENERATED_BODY()
+
+    FRRKinematicFleet* Fleet = nullptr;
+
+    virtual void ExecuteTick(float DeltaTime,
+                             ELevelTick TickType,
+                             ENamedThreads::Type CurrentThread,
+                             const FGraphEventRef& MyCompletionGraphEvent) override;
+
+    virtual FString DiagnosticMessage() override
+    {
+        return TEXT("FRRKinematicFleetTickFunction");
+    }
+};
+
+template<>
+struct TStructOpsTypeTraits<FRRKinematicFleetTickFunction> : public TStructOpsTypeTraitsBase2<FRRKinematicFleetTickFunction>
+{
+    enum
+    {
+        WithCopy = false
+    };
+};
+
+/**
+ * @brief Per-world kinematic fleet movement system, for large fleets of #URobotVehicleMovementComponent &
+ * #URRFloatingMovementComponent with bFleetMovement on, which only submit their desired move upon ticking instead of
+ * sweeping it. All moves of a frame are then processed at once, as structure of arrays:
+ * 1- Robot-robot collisions: broad phase through a uniform XY grid of cells as large as the largest robot, then each robot
+ *    overlapping another, as vertical cylinders of their bounds, is pushed back by half the penetration.
+ * 2- Static geometry: robots whose bounds, inflated by #StaticClearance & raised by #FloorClearance not to count the floor,
+ *    overlap no WorldStatic geometry are known to be free till they move by half #StaticClearance from where that was
+ *    checked, and are then moved without sweeping. Only the others fall back to the engine sweep & slide.
+ * Checks run in ParallelFor, moves on game thread. Robots not in the fleet & other movable actors are only collided with by
+ * sweeping robots.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRKinematicFleet
+{
+public:
+    ~FRRKinematicFleet();
+
+    /**
+     * @brief Get the fleet of a world, creating it upon the first fetching
+     *
+     * @param InWorld
+     * @return FRRKinematicFleet&
+     */
+    static FRRKinematicFleet& Get(UWorld* InWorld);
+
+    /**
+     * @brief Submit a robot's move for this frame, to be finished by its own ApplyMovement()
+     * @param InMovementComp #URobotVehicleMovementComponent or #URRFloatingMovementComponent
+     * @param InDelta [cm] World translation
+     * @param InNewRotation
+     * @param InRadius [cm] Of the robot as a vertical cylinder, <= 0 to take its bounds' XY extent
+     * @param InDeltaTime [s]
+     */
+    void SubmitMove(UMovementComponent* InMovementComp,
+                    const FVector& InDelta,
+                    const FQuat& InNewRotation,
+                    const float InRadius,
+                    const float InDeltaTime);
+
+    //! Process all moves submitted in this frame
+    void Flush();
+
+    int32 GetLastRobotsNum() const
+    {
+        return LastRobotsNum;
+    }
+
+    //! Num of robots which swept in the latest #Flush(), being near static geometry
+    int32 GetLastSweptRobotsNum() const
+    {
+        return LastSweptRobotsNum;
+    }
+
+    //! [cm] Clearance to static geometry within which robots sweep
+    float StaticClearance = 50.f;
+
+    //! [cm] Height above robots' bounds bottom below which static geometry is ignored, being their floor
+    float FloorClearance = 5.f;
+
+private:
+    static TMap<UWorld*, TUniquePtr<FRRKinematicFleet>> SFleets;
+    static std::once_flag OnceFlag;
+
+    static void OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/);
+
+    FRRKinematicFleetTickFunction TickFunction;
+    TWeakObjectPtr<UWorld> World;
+
+    //! Moves of the frame, as structure of arrays
+    struct FRRFleetMoves
+    {
+        TArray<TWeakObjectPtr<UMovementComponent>> MovementComps;
+        TArray<FVector> Locations;
+        TArray<FVector> Deltas;
+        TArray<FQuat> Rotations;
+        TArray<float> Radii;
+        TArray<float> HalfHeights;
+        TArray<float> DeltaTimes;
+
+        void Reset();
+        int32 Num() const
+        {
+            return MovementComps.Num();
+        }
+    };
+    FRRFleetMoves Moves;
+
+    //! Reused across flushes
+    TMap<FIntPoint, TArray<int32, TInlineAllocator<4>>> Grid;
+    TArray<FVector> Corrections;
+    TArray<bool> NearStaticFlags;
+
+    //! Where each robot was last found free of static geometry or not
+    struct FRRStaticCheck
+    {
+        FVector Location = FVector::ZeroVector;
+        bool bNearStatic = true;
+    };
+    TMap<TObjectKey<UMovementComponent>, FRRStaticCheck> StaticChecks;
+
+    int32 LastRobotsNum = 0;
+    int32 LastSweptRobotsNum = 0;
+};
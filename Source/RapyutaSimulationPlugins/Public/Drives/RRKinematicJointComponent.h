@@ -22,6 +22,8 @@
  * #Controltype:
  * - Joints moves with Max, Min velocity to target with #ERRJointControlType::POSITION
  * - Joints moves with given velocity with #ERRJointControlType::VELOCITY
+ *
+ * Joints of a robot updated by its #FRRJointStateBlock are moved all at once by #UpdatePoses(), sweeping only if #bSweep.
  * @sa[K2_SetWorldTransform](https://docs.unrealengine.com/4.26/en-US/API/Runtime/Engine/Components/USceneComponent/K2_SetWorldTransform/)
  */
 UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
@@ -43,11 +45,10 @@ public:
     /**
      * @brief Call #UpdatePose after update #PositionTarget and #OrientationTarget with #LinearVelocity and AngularVelocity
      *
-     * @param DeltaTime
-     * @param TickType
-     * @param ThisTickFunction
+     * @param InDeltaTime
+     * @param InTime
      */
-    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+    virtual void UpdateJoint(const float InDeltaTime, const float InTime) override;
 
     /**
      * @brief Set velocity target
@@ -75,4 +76,21 @@ public:
      * @sa[K2_SetWorldTransform](https://docs.unrealengine.com/4.26/en-US/API/Runtime/Engine/Components/USceneComponent/K2_SetWorldTransform/)
      */
     virtual void UpdatePose();
+
+    /**
+     * @brief Apply the poses of all joints marked by a deferred #UpdatePose() in one forward kinematics pass: their relative
+     * transforms are written first, then component-to-world & overlaps are updated once per moved subtree, from its top joint.
+     * Joints with #bSweep are then swept from their previous world transform, inside their own FScopedMovementUpdate.
+     * @param InJoints
+     */
+    static void UpdatePoses(const TArrayView<URRKinematicJointComponent* const> InJoints);
+
+    //! Whether the child link is swept to its new pose, stopping at blocking collisions, eg on end effectors
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bSweep = true;
+
+    //! Whether #UpdatePose() only marks #bPoseDirty, for #UpdatePoses() to apply it
+    bool bDeferPoseUpdate = false;
+
+    bool bPoseDirty = false;
 };
@@ -17,6 +17,8 @@ DECLARE_LOG_CATEGORY_EXTERN(LogRRKinematicTricycleDriveComponent, Log, All);
 /**
  * @brief Kinematic Tricycle Drive component class.
  * Simulate kinematic tricycle drive by using 2 URRJointComponent SteeringJoint + DriveJoint.
+ * Its move is composed into the one of #URobotVehicleMovementComponent::UpdateMovement, thus swept once, or batched with
+ * other robots by #FRRKinematicFleet with bFleetMovement.
  */
 UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
 class RAPYUTASIMULATIONPLUGINS_API URRKinematicTricycleDriveComponent : public URobotVehicleMovementComponent
@@ -26,8 +28,6 @@ class RAPYUTASIMULATIONPLUGINS_API URRKinematicTricycleDriveComponent : public U
 public:
     void BeginPlay();
 
-    void TickComponent(float InDeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction);
-
     UFUNCTION(BlueprintCallable)
     void SetDriveJoints(URRJointComponent* InSteeringJoint, URRJointComponent* InDriveJoint);
 
@@ -45,6 +45,9 @@ public:
     float WheelBase = 110.f;
 
 protected:
+    //! Move by the drive joint's rotation since the last move, steered by the steering joint's
+    virtual FTransform ComputeDriveLocalMove(float InDeltaTime) override;
+
     //! [rad]
     UPROPERTY()
     float PrevWheeAngleRad = 0.f;
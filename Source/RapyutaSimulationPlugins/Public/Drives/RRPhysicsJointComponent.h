@@ -14,12 +14,12 @@
 //RapyutaSimulationPlugins
 #include "Core/RRGeneralUtils.h"
 #include "Drives/RRJointComponent.h"
-
-//Thirdparty
-#include "two_points_interpolation_constant_acc.hpp"
+#include "Drives/RRJointTrajectories.h"
 
 #include "RRPhysicsJointComponent.generated.h"
 
+struct FRRRobotJointDynamicProperties;
+
 /**
  * @brief Physics Joint component. 
  * PhysicsConstraintsComponent needs to be defined outside of this class and passed to #Constraint in construction.
@@ -44,14 +44,15 @@ public:
      */
     virtual void Initialize() override;
 
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
     /**
-     * @brief 
+     * @brief Call #UpdateState then #UpdateControl
      *
-     * @param DeltaTime
-     * @param TickType
-     * @param ThisTickFunction
+     * @param InDeltaTime
+     * @param InTime
      */
-    virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+    virtual void UpdateJoint(const float InDeltaTime, const float InTime) override;
 
 
     /**
@@ -90,16 +91,40 @@ public:
     UFUNCTION(BlueprintCallable)
     virtual void SetJoint();
 
+    /**
+     * @brief Set drive spring, damper, force limit & max velocity from URDF/SDF joint dynamics in SI units,
+     * to the linear drive if #LinearDOF > 0, else the angular one. Call #SetJoint afterwards to apply them to #Constraint.
+     * @param InDynamicProperties [N/m, N.s/m, N, m/s] or [N.m/rad, N.m.s/rad, N.m, rad/s]
+     */
+    void SetDynamicProperties(const FRRRobotJointDynamicProperties& InDynamicProperties);
+
     //! Physics Constraints
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     UPhysicsConstraintComponent* Constraint = nullptr;
 
     //! Smoothing TargetPose to #Constraint.
     //! If this is false, step pose target are used by #SetPoseTarget
-    //! If this is true, pose target changes linearly with max vel in #TickComponent
+    //! If this is true, pose target changes linearly with max vel in #UpdateJoint
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     bool bSmoothing = false;
 
+    //! Run the smoothing of #UpdateControl on the physics thread, once per Chaos (sub)step, via #FRRPhysicsSubstepManager,
+    //! instead of once per game tick, so that control quality does not depend on the game step size.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bSubstepControl = false;
+
+    //! Read #LinearVelocity, #AngularVelocity from the relative velocities of #ParentLink & #ChildLink bodies in the physics
+    //! solver, in the joint frame, instead of finite differences of the pose. #AngularVelocity is then the angular velocity
+    //! vector, which equals the Euler angle rates for single axis joints.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bPhysicsVelocity = false;
+
+    //! Solve #Constraint as a link of an articulated chain, closer to a reduced-coordinate articulation: #ParentLink
+    //! dominates, thus #ChildLink can not drag it back, and residual joint errors are projected out after solving,
+    //! so that long chains of links hold together at large steps. Applied by #SetJoint.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bArticulated = false;
+
     //! Acceleration[cm/ss] used by velocity smoothing if #bVelocitySmoothing = true.
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     float LinearVelocitySmoothingAcc = 10.f;
@@ -175,6 +200,18 @@ protected:
 
     virtual void UpdateControl(const float DeltaTime);
 
-    TStaticArray<TwoPointInterpolation, 3> PositionTPI;
-    TStaticArray<TwoAngleInterpolation, 3> OrientationTPI;
+    //! World time of the ongoing #UpdateJoint, used by smoothing in #UpdateControl
+    float UpdateTime = 0.f;
+
+    /**
+     * @brief Submit the smoothing control to #FRRPhysicsSubstepManager upon a new target
+     * @return true if the control is run on the physics thread, thus to be skipped on game thread
+     */
+    bool UpdateSubstepControl();
+
+    bool bSubstepControlDirty = false;
+    bool bSubstepControlled = false;
+
+    //! Smoothing trajectories of position [cm] XYZ, then orientation [rad] Euler XYZ
+    FRRJointTrajectories Trajectories;
 };
@@ -0,0 +1,209 @@
+/**
+ * @file RRPhysicsSubstepManager.h
+ * @brief Runs physics joints' control laws & samples IMUs on the physics thread, once per Chaos (sub)step.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// Native
+#include <mutex>
+
+// UE
+#include "Chaos/SimCallbackInput.h"
+#include "Chaos/SimCallbackObject.h"
+#include "CoreMinimal.h"
+
+// RapyutaSimulationPlugins
+#include "Drives/RRJointComponent.h"
+#include "Drives/RRJointTrajectories.h"
+#include "Sensors/RRImuSampleRing.h"
+
+class FJointConstraintPhysicsProxy;
+class FSingleParticlePhysicsProxy;
+class UPhysicsConstraintComponent;
+class UPrimitiveComponent;
+
+/**
+ * @brief Snapshot of a physics joint's smoothing control, taken on game thread upon a new target, then advanced on physics
+ * thread by each substep's delta time. Mirrors URRPhysicsJointComponent::UpdateControl() with bSmoothing.
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRJointSubstepControl
+{
+    FJointConstraintPhysicsProxy* Proxy = nullptr;
+    ERRJointControlType ControlType = ERRJointControlType::VELOCITY;
+
+    //! [cm/s], [deg/s]
+    FVector LinearVelocityTarget = FVector::ZeroVector;
+    FVector AngularVelocityTarget = FVector::ZeroVector;
+    FVector MidLinearVelocityTarget = FVector::ZeroVector;
+    FVector MidAngularVelocityTarget = FVector::ZeroVector;
+    float LinearVelocitySmoothingAcc = 0.f;
+    float AngularVelocitySmoothingAcc = 0.f;
+    float LinearVelocityTolerance = 0.f;
+    float AngularVelocityTolerance = 0.f;
+
+    FVector MidPositionTarget = FVector::ZeroVector;
+    FRotator MidOrientationTarget = FRotator::ZeroRotator;
+    FRRJointTrajectories Trajectories;
+
+    //! [s] World time of the snapshot, from which the trajectories are evaluated
+    double Time = 0.;
+
+    //! Advance by a substep & write the drive targets to the joint's physics thread handle
+    void Step_Internal(const float InDeltaTime);
+};
+
+/**
+ * @brief New drive velocity target of a physics constraint, eg a wheel, written once to its physics thread handle
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRConstraintDriveTarget
+{
+    FJointConstraintPhysicsProxy* Proxy = nullptr;
+
+    //! [rad/s]
+    FVector AngularVelocityTarget = FVector::ZeroVector;
+
+    void Apply_Internal() const;
+};
+
+/**
+ * @brief IMU mounted on a rigid body, sampled on physics thread: linear acceleration is differentiated from the mount point's
+ * velocity between consecutive (sub)steps, then pushed along with the body's angular velocity to #Ring
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRImuSubstepSampler
+{
+    FSingleParticlePhysicsProxy* Proxy = nullptr;
+    TSharedPtr<FRRImuSampleRing, ESPMode::ThreadSafe> Ring;
+
+    //! Sensor pose relative to the body
+    FTransform MountTransform = FTransform::Identity;
+
+    //! [cm/s^2]
+    FVector Gravity = FVector::ZeroVector;
+
+    //! [s] World time of the body state, advanced by each substep's delta time
+    double Time = 0.;
+
+    void Sample_Internal(const float InDeltaTime);
+
+private:
+    FVector PrevVelocity = FVector::ZeroVector;
+    float PrevDeltaTime = 0.f;
+    bool bHasPrevVelocity = false;
+};
+
+struct FRRPhysicsSubstepInput : public Chaos::FSimCallbackInput
+{
+    //! Game thread frame of the input, not to apply it again in following substeps
+    uint64 FrameId = 0;
+    TArray<TPair<uint32, FRRJointSubstepControl>> JointControls;
+    TArray<uint32> RemovedJointIds;
+    TArray<TPair<uint32, FRRConstraintDriveTarget>> DriveTargets;
+    TArray<TPair<uint32, FRRImuSubstepSampler>> ImuSamplers;
+    TArray<uint32> RemovedImuIds;
+
+    void Reset()
+    {
+        FrameId = 0;
+        JointControls.Reset();
+        RemovedJointIds.Reset();
+        DriveTargets.Reset();
+        ImuSamplers.Reset();
+        RemovedImuIds.Reset();
+    }
+};
+
+/**
+ * @brief Chaos sim callback, invoked on physics thread before each (sub)step
+ */
+class FRRPhysicsSubstepCallback : public Chaos::TSimCallbackObject<FRRPhysicsSubstepInput>
+{
+private:
+    virtual void OnPreSimulate_Internal() override;
+
+    //! Only accessed on physics thread
+    TMap<uint32, FRRJointSubstepControl> JointControls;
+    TMap<uint32, FRRImuSubstepSampler> ImuSamplers;
+    uint64 LastFrameId = 0;
+};
+
+/**
+ * @brief Per-world owner of a #FRRPhysicsSubstepCallback registered to the world's Chaos solver, so that joint control laws
+ * run at the physics substep rate, independent of the game tick, thus allowing a larger game step size.
+ * Joints submit a #FRRJointSubstepControl upon each new target, handed off with the next physics step's input.
+ * Drives, eg #UDifferentialDriveComponent's wheels, submit #FRRConstraintDriveTarget the same way, applied once.
+ * IMUs, eg #URRROS2ImuComponent, submit a #FRRImuSubstepSampler once, sampling every substep till removed.
+ * Game thread only.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRPhysicsSubstepManager
+{
+public:
+    ~FRRPhysicsSubstepManager();
+
+    /**
+     * @brief Get the manager of a world, creating it upon the first fetching
+     * @param InWorld
+     * @return FRRPhysicsSubstepManager* nullptr if the world has no Chaos solver
+     */
+    static FRRPhysicsSubstepManager* Get(UWorld* InWorld);
+
+    /**
+     * @brief Submit a joint's control from now on, replacing its previous one
+     * @param InJointId Unique among the world's joints
+     * @param InConstraint Its proxy is resolved here
+     * @param InControl
+     * @return false if the constraint has no physics proxy yet
+     */
+    bool SubmitJointControl(const uint32 InJointId,
+                            UPhysicsConstraintComponent* InConstraint,
+                            FRRJointSubstepControl&& InControl);
+
+    //! Stop controlling a joint, eg before its constraint is destroyed
+    void RemoveJoint(const uint32 InJointId);
+
+    /**
+     * @brief Physics proxy of a constraint, for callers to cache it along with ConstraintInstance.ConstraintHandle.Constraint
+     * @param InConstraint
+     * @return FJointConstraintPhysicsProxy* nullptr if the constraint has no Chaos joint yet
+     */
+    static FJointConstraintPhysicsProxy* GetJointProxy(UPhysicsConstraintComponent* InConstraint);
+
+    /**
+     * @brief Write a constraint's angular drive velocity target on physics thread before the next step, bypassing the game
+     * thread constraint API. It is overwritten by the game thread one upon any later change to the constraint's settings.
+     * @param InConstraintId Unique among the world's constraints
+     * @param InProxy From #GetJointProxy()
+     * @param InAngularVelocityTarget [rad/s]
+     */
+    void SubmitDriveTarget(const uint32 InConstraintId,
+                           FJointConstraintPhysicsProxy* InProxy,
+                           const FVector& InAngularVelocityTarget);
+
+    //! Drop a constraint's pending drive targets, eg before it is destroyed
+    void RemoveDriveTargets(const uint32 InConstraintId);
+
+    /**
+     * @brief Start sampling an IMU mounted on a body every substep, replacing its previous sampler
+     * @param InImuId Unique among the world's IMUs
+     * @param InBody Its physics proxy is resolved here
+     * @param InSampler
+     * @return false if the body has no physics proxy yet
+     */
+    bool SubmitImuSampler(const uint32 InImuId, UPrimitiveComponent* InBody, FRRImuSubstepSampler&& InSampler);
+
+    //! Stop sampling an IMU, eg before its body is destroyed
+    void RemoveImu(const uint32 InImuId);
+
+private:
+    static void OnPostWorldCleanup(UWorld* InWorld, bool bInSessionEnded, bool bInCleanupResources);
+
+    FRRPhysicsSubstepInput* GetInput();
+
+    static TMap<UWorld*, TUniquePtr<FRRPhysicsSubstepManager>> SManagers;
+    static std::once_flag OnceFlag;
+
+    TWeakObjectPtr<UWorld> World;
+    FRRPhysicsSubstepCallback* Callback = nullptr;
+    uint64 FrameId = 0;
+};
@@ -10,10 +10,12 @@
 #include <random>
 
 // UE
+#include "CollisionQueryParams.h"
 #include "CoreMinimal.h"
 #include "GameFramework/PawnMovementComponent.h"
 
 // RapyutaSimulationPlugins
+#include "Drives/RRDriveTickManager.h"
 #include "Sensors/RRBaseOdomComponent.h"
 
 #include "RobotVehicleMovementComponent.generated.h"
@@ -28,6 +30,7 @@ class URRFloatingMovementComponent;
  *
  * If #bAdaptToSurfaceBelow is true, robot will follow the pawn movement under the robot which has been defined as the
  #MovingPlatform (e.g. elevators), it will also adapt its pose to the floor surface configuration (e.g. slopes)
+ * With #bAttachToMovingPlatform, the robot is rather attached to #MovingPlatform, thus moving relative to it.
 
  *
  * Publish odometry from world origin or initial pose.
@@ -54,6 +57,10 @@ private:
     UPROPERTY(VisibleAnywhere)
     FQuat LastPlatformRotation = FQuat::Identity;
 
+    //! Whether the robot got attached to #MovingPlatform by #SetMovingPlatform, with #bAttachToMovingPlatform
+    UPROPERTY(VisibleAnywhere)
+    bool bAttachedToPlatform = false;
+
     //! List all scene components on the pawn. that have the tag "ContactPoint". This is used to adapt the robot pose based on the
     //! floor surface configuration.
 
@@ -108,6 +115,60 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     bool bAdaptToSurfaceBelow = true;
 
+    //! Trace floor contacts against simple collision, in one batch with all robots of the world, by #FRRFloorContactSolver
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bBatchFloorContacts = false;
+
+    //! With #bBatchFloorContacts, look floor contacts up in the solver's cached height field of static floors before tracing
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bCacheStaticFloorHeights = false;
+
+    //! With #bCacheStaticFloorHeights, bounds of the static floor map built upon #InitData(), where floors are never traced
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FBox StaticFloorMapBounds = FBox(ForceInit);
+
+    //! [cm] XY resolution of the cached static floor heights
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float StaticFloorCellSize = 50.f;
+
+    /**
+     * @brief Append the floor contact rays: a single one beneath the robot if less than 3 #ContactPoints, else one per point
+     * @param OutStarts
+     * @param OutEnds
+     */
+    void GetFloorContactRays(TArray<FVector>& OutStarts, TArray<FVector>& OutEnds) const;
+
+    /**
+     * @brief Orient the robot as its floor & move it up or down onto it, or let it fall if no floor beneath
+     * @param InHits One per ray of #GetFloorContactRays(), blocking if the floor is hit
+     * @param InDeltaTime
+     */
+    void AdaptToFloor(TArrayView<FHitResult> InHits, const float InDeltaTime);
+
+    //! Query params of batched floor contacts against simple collision, built in #InitData()
+    FCollisionQueryParams BatchFloorTraceParams;
+
+    //! Move along with all other fleet robots of the world by #FRRKinematicFleet, only sweeping near static geometry
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bFleetMovement = false;
+
+    //! [cm] Radius of the robot in #FRRKinematicFleet, <= 0 to take its bounds' XY extent
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float FleetRadius = 0.f;
+
+    //! Ticked by the world's #FRRDriveTickManager along with all other components of its class, instead of by its own tick
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bAggregatedTick = false;
+
+    /**
+     * @brief Move #UpdatedComponent, sliding along surfaces if sweeping, then adapt to the surface below
+     * @param InDelta [cm] World translation
+     * @param InNewRotation
+     * @param bInSweep
+     * @param InDeltaTime
+     */
+    void ApplyMovement(const FVector& InDelta, const FQuat& InNewRotation, const bool bInSweep, const float InDeltaTime);
+
     /**
      * @brief Initialize noise and odometry.
      *
@@ -127,12 +188,22 @@ public:
     UFUNCTION(BlueprintCallable)
     virtual void InitData();
 
+    //! Attach the robot to #MovingPlatform, being carried by its transform instead of following its translation by each move
+    //! of #UpdateMovement, the robot's own movement then being relative to the platform. Also follows the platform's rotation.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bAttachToMovingPlatform = false;
+
+    /**
+     * @brief Set the platform below the robot, eg elevator, attaching the robot to it with #bAttachToMovingPlatform
+     * @param platform
+     */
     UFUNCTION(BlueprintCallable)
     void SetMovingPlatform(AActor* platform);
 
     UFUNCTION(BlueprintCallable)
     bool IsOnMovingPlatform();
 
+    //! Unset #MovingPlatform, detaching the robot from it if attached by #SetMovingPlatform
     UFUNCTION(BlueprintCallable)
     void RemoveMovingPlatform();
 
@@ -156,6 +227,16 @@ protected:
         return true;
     }
 
+    //! Add to #FRRDriveTickManager if #bAggregatedTick
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    //! Update run by #FRRDriveTickManager across robots after all components of this class have ticked, if #bAggregatedTick
+    virtual FRRDriveParallelUpdate GetDriveParallelUpdate() const
+    {
+        return nullptr;
+    }
+
     /**
      * @brief Call #UpdateMovement, and UpdateComponentVelocity
      *
@@ -186,6 +267,17 @@ protected:
      */
     virtual void UpdateMovement(float InDeltaTime);
 
+    /**
+     * @brief Kinematic move of the drive itself, eg from its joints' states, composed by #UpdateMovement after the one by
+     * Velocity & #AngularVelocity, thus moved, swept & possibly batched by #FRRKinematicFleet along with it
+     * @param InDeltaTime
+     * @return FTransform Local to #UpdatedComponent
+     */
+    virtual FTransform ComputeDriveLocalMove(float InDeltaTime)
+    {
+        return FTransform::Identity;
+    }
+
     //! internal property used to log throttle.
     UPROPERTY()
     float LogLastHit = 0.f;
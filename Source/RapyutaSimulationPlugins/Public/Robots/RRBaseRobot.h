@@ -18,7 +18,9 @@
 #include "Core/RRBaseActor.h"
 #include "Core/RRObjectCommon.h"
 #include "Drives/RRJointComponent.h"
+#include "Drives/RRJointStateBlock.h"
 #include "Drives/RobotVehicleMovementComponent.h"
+#include "Robots/RRRobotMovementReconciler.h"
 #include "Sensors/RRROS2BaseSensorComponent.h"
 #include "Tools/ROS2Spawnable.h"
 
@@ -51,6 +53,7 @@ class ARRNetworkGameState;
 class URRRobotROS2Interface;
 class ARRNetworkPlayerController;
 class URRUserWidget;
+class UWorldPartitionStreamingSourceComponent;
 
 /**
  * @brief Which server or client has robot movement authority.
@@ -97,6 +100,17 @@ public:
      */
     virtual void BeginPlay() override;
 
+    /**
+     * @brief Unregister #JointsTickFunction
+     */
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    /**
+     * @brief Park #ROS2Interface in the game mode's #URRROS2InterfacePool if any, before being deinitialized by the
+     * controller's unpossessing, to be recycled by a robot respawned in the same namespace
+     */
+    virtual void Destroyed() override;
+
     /**
      * @brief Wake rigid body in addition to Super::Tick()
      *
@@ -104,6 +118,11 @@ public:
      */
     virtual void Tick(float DeltaSeconds) override;
 
+    /**
+     * @brief Hand replicated poses over to #MovementReconciler for interpolation on remote proxies, instead of snapping
+     */
+    virtual void PostNetReceiveLocationAndRotation() override;
+
     /**
      * @brief Initialize default components being configurable in child BP classes.
      * Could only be called in constructor.
@@ -324,6 +343,18 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     TMap<FString, URRJointComponent*> Joints;
 
+    //! Update all #Joints in one robot-level tick into #JointStates, instead of each joint component ticking by itself
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bUpdateJointsInRobot = true;
+
+    /**
+     * @brief Contiguous states of #Joints, updated by #JointsTickFunction if #bUpdateJointsInRobot
+     */
+    const FRRJointStateBlock& GetJointStates() const
+    {
+        return JointStates;
+    }
+
     /**
      * @brief Initialize sensors components which are child class of #URRROS2BaseSensorComponent.
      *
@@ -380,6 +411,29 @@ public:
     UFUNCTION(BlueprintCallable)
     virtual void StopMovement();
 
+    //! Wake simulating bodies up every tick, the former workaround keeping Chaos awake, instead of only while commanded
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bAlwaysWakePhysics = false;
+
+    //! [s] Time simulating bodies are kept awake after the last velocity or joint command
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float PhysicsWakeDuration = 1.f;
+
+    //! [cm/s] Once uncommanded, bodies are kept awake until all are slower than this, then left to Chaos sleeping
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float PhysicsSleepLinearVelocity = 1.f;
+
+    //! [deg/s] Once uncommanded, bodies are kept awake until all are slower than this, then left to Chaos sleeping
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float PhysicsSleepAngularVelocity = 1.f;
+
+    /**
+     * @brief Keep simulating bodies awake for #PhysicsWakeDuration, then until they settle.
+     * Called upon velocity & joint commands, since Chaos may put bodies only driven by constraint motors to sleep.
+     */
+    UFUNCTION(BlueprintCallable)
+    void WakePhysics();
+
     //! Main robot movement component (kinematics/diff-drive or wheels-drive comp)
     //! #MovementComponent and #RobotVehicleMoveComponent should point to same pointer.
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
@@ -399,6 +453,44 @@ public:
     UFUNCTION(BlueprintCallable)
     virtual void SetMoveComponent(UMovementComponent* InMoveComponent);
 
+    //! Whether #MovementReconciler is created upon BeginPlay in networked games
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bMovementReconciliationEnabled = true;
+
+    //! Whether the skeletal meshes of this robot are added to #FRRSkeletalAnimLODManager upon BeginPlay, throttling their
+    //! animation while unseen by any sensor or view
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bSkeletalAnimLODEnabled = true;
+
+    //! Reconciling client moves in the server & smoothing replicated poses on remote proxies, networked games only
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    URRRobotMovementReconciler* MovementReconciler = nullptr;
+
+    //! Whether this robot is a World Partition streaming source in partitioned worlds, keeping the cells around its body &
+    //! within its lidars' & cameras' range loaded, thus their collision.
+    //! @note Servers only stream cells with wp.Runtime.EnableServerStreaming=1, loading all of them otherwise.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bWorldPartitionStreamingSource = true;
+
+    //! [cm] Loading radius around the robot body, <= 0 for the target grid's own loading range
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float StreamingSourceRadius = 0.f;
+
+    //! [cm] Loading range of the cameras without any max view distance
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float StreamingCameraRange = 3000.f;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    UWorldPartitionStreamingSourceComponent* StreamingSourceComp = nullptr;
+
+    /**
+     * @brief Create #StreamingSourceComp if #bWorldPartitionStreamingSource in a partitioned world & (re)build its shapes:
+     * the body one, a sphere of MaxRange per lidar & a sector of the FOV per camera.
+     * Called upon BeginPlay & #InitSensors, thus to be called again if sensors are added afterwards.
+     */
+    UFUNCTION(BlueprintCallable)
+    void UpdateStreamingSourceShapes();
+
     /**
      * @brief Set velocity to #RobotVehicleMoveComponent.
      * Calls #SetLocalLinearVel for setting velocity to #RobotVehicleMoveComponent and
@@ -483,7 +575,9 @@ public:
     /**
      * @brief Parse Json parameters in #ROSSpawnParameters
      * This function is called in #PreInitializeComponents
-     * Please overwrite this function to parse your custom parameters
+     * Please overwrite this function to parse your custom parameters, preferably with
+     * #URRGeneralUtils::GetCachedJsonObject or #URRGeneralUtils::GetCachedJsonStruct, parsing the configs shared by
+     * many robots only once
     */
     UFUNCTION(BlueprintCallable)
     virtual void InitPropertiesFromJSON();
@@ -502,6 +596,10 @@ public:
     UPROPERTY()
     FTransform UIWidgetOffset = FTransform(FVector(0.f, 0.f, 100.f));
 
+    //! Draw the label into the world's single #URRRobotLabelsWidget overlay instead of creating #UIWidgetComp, for big fleets
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bPooledUIWidget = false;
+
     /**
      * @brief Check whether #UIUserWidget is valid
      */
@@ -554,7 +652,18 @@ protected:
     virtual void ConfigureMovementComponent();
 
     /**
-     * @brief Create & init #UIWidgetComp
+     * @brief Create & init #UIWidgetComp, or add the robot label to #URRRobotLabelsWidget if #bPooledUIWidget
      */
     virtual void InitUIWidget();
+
+    //! [s] World time until which simulating bodies are kept awake
+    double PhysicsWakeEndTime = -1.;
+
+    //! Whether bodies are being kept awake until they settle
+    bool bPhysicsSettling = false;
+
+    FRRJointStateBlock JointStates;
+
+    //! Independent of the actor tick, which is disabled by default, see #ARRBaseActor::SetTickEnabled()
+    FRRJointsTickFunction JointsTickFunction;
 };
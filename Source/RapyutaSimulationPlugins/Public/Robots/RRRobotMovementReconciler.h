@@ -0,0 +1,116 @@
+/**
+ * @file RRRobotMovementReconciler.h
+ * @brief Client-server reconciliation of a robot's movement, in sim time.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "Components/ActorComponent.h"
+#include "CoreMinimal.h"
+
+#include "RRRobotMovementReconciler.generated.h"
+
+/**
+ * @brief A client robot's move, timestamped in sim time, ie as of AGameStateBase::GetServerWorldTimeSeconds()
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRRobotMove
+{
+    float TimeStamp = 0.f;
+
+    bool bHasLocation = false;
+    FVector Location = FVector::ZeroVector;
+    //! [cm/s] In world frame
+    FVector LinearVel = FVector::ZeroVector;
+
+    bool bHasRotation = false;
+    FRotator Rotation = FRotator::ZeroRotator;
+    //! [deg/s] [X:Roll - Y:Pitch - Z: Yaw], as #ARRBaseRobot::TargetAngularVel
+    FVector AngularVel = FVector::ZeroVector;
+};
+
+/**
+ * @brief Reconcile a networked robot's movement, instead of snapping it to every received pose.
+ * - Server: client moves are buffered in sim time, then extrapolated to the current sim time. The error to the robot's
+ * current pose, as integrated by its movement component, is corrected smoothly over #CorrectionDuration if within
+ * #MaxCorrectionDistance & #MaxCorrectionAngle, else by teleporting.
+ * - Remote proxies: replicated poses are buffered & rendered #RemoteInterpolationDelay in the past, interpolating
+ * between the two surrounding them, see #ARRBaseRobot::PostNetReceiveLocationAndRotation().
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class RAPYUTASIMULATIONPLUGINS_API URRRobotMovementReconciler : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    URRRobotMovementReconciler();
+
+    virtual void TickComponent(float InDeltaTime,
+                               enum ELevelTick InTickType,
+                               FActorComponentTickFunction* InThisTickFunction) override;
+
+    /**
+     * @brief [Server] Buffer a client move, dropped if older than the latest one, to be reconciled in the next tick
+     * @param InMove
+     */
+    void AddClientMove(const FRRRobotMove& InMove);
+
+    /**
+     * @brief [Remote proxy] Buffer a replicated pose, stamped with the current sim time
+     * @param InLocation
+     * @param InRotation
+     */
+    void AddRemotePose(const FVector& InLocation, const FRotator& InRotation);
+
+    //! [cm] Max location error being corrected smoothly, a larger one being teleported away
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float MaxCorrectionDistance = 100.f;
+
+    //! [deg] Max rotation error being corrected smoothly, a larger one being teleported away
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float MaxCorrectionAngle = 30.f;
+
+    //! [s] Time constant of the smooth error correction
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float CorrectionDuration = 0.2f;
+
+    //! [s] Max time a client move is extrapolated over, bounding the effect of clock skews & stale moves
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float MaxExtrapolationTime = 0.5f;
+
+    //! [s] Remote proxies render this much in the past, so that there are generally 2 replicated poses to interpolate
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float RemoteInterpolationDelay = 0.1f;
+
+    static constexpr int32 MAX_BUFFERED_POSES_NUM = 32;
+
+protected:
+    float GetSimTime() const;
+
+    //! Merge the buffered client moves & set the pending corrections to reach the latest ones' extrapolated poses
+    void ReconcileClientMoves();
+
+    //! Apply part of the pending corrections, per #CorrectionDuration
+    void ApplyCorrections(const float InDeltaTime);
+
+    //! Set the owner's pose to the buffered remote poses' interpolated one at the render time
+    void InterpolateRemotePoses();
+
+    //! Pending client moves, in arrival order
+    TArray<FRRRobotMove> ClientMoves;
+    float LatestLocationTimeStamp = TNumericLimits<float>::Lowest();
+    float LatestRotationTimeStamp = TNumericLimits<float>::Lowest();
+
+    FVector PendingLocationCorrection = FVector::ZeroVector;
+    FQuat PendingRotationCorrection = FQuat::Identity;
+
+    struct FRRRobotRemotePose
+    {
+        float TimeStamp = 0.f;
+        FVector Location = FVector::ZeroVector;
+        FQuat Rotation = FQuat::Identity;
+    };
+    //! Buffered remote poses, in receipt order
+    TArray<FRRRobotRemotePose> RemotePoses;
+};
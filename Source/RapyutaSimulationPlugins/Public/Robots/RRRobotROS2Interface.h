@@ -6,10 +6,16 @@
 
 #pragma once
 
+// Native
+#include <atomic>
+#include <mutex>
+
 // UE
 #include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
 
 // rclUE
+#include "Msgs/ROS2JointState.h"
 #include "ROS2NodeComponent.h"
 #include "ROS2ServiceClient.h"
 #include "Tools/ROS2Spawnable.h"
@@ -17,11 +23,38 @@
 
 // RapyutaSimulationPlugins
 #include "Core/RRUObjectUtils.h"
+#include "Drives/RRJointComponent.h"
 #include "Sensors/RRBaseOdomComponent.h"
 
 #include "RRRobotROS2Interface.generated.h"
 
 class ARRBaseRobot;
+
+/**
+ * @brief Joints resolved from the name array of a joint command msg, reused as long as the incoming names are unchanged.
+ * Names which are missing or not single DOF joints are kept with a null joint, so that values are indexed as in the msg.
+ */
+struct FRRJointCmdLayout
+{
+    TArray<FString> Names;
+    TArray<TWeakObjectPtr<URRJointComponent>> Joints;
+
+    //! ROS to UE unit scale of each joint: 100 for linear [m->cm], 180/pi for rotational [rad->deg]
+    TArray<float> Scales;
+
+    //! Num of #ARRBaseRobot::Joints upon resolving, to re-resolve upon robot joints being added
+    int32 RobotJointsNum = 0;
+};
+
+/**
+ * @brief A joint command of #FRRJointCmdLayout, in UE units
+ */
+struct FRRJointCmd
+{
+    TSharedPtr<const FRRJointCmdLayout, ESPMode::ThreadSafe> Layout;
+    TArray<float> Values;
+    ERRJointControlType ControlType = ERRJointControlType::POSITION;
+};
 /**
  * @brief  Base Robot ROS 2 interface class.
  * This class owns ROS2Node and controls ROS 2 interfaces of the #Robot, by
@@ -39,7 +72,7 @@ class RAPYUTASIMULATIONPLUGINS_API URRRobotROS2Interface : public UObject
     GENERATED_BODY()
 
 #define RR_ROBOT_ROS2_SUBSCRIBE_TO_TOPIC(InTopicName, InMsgClass, InCallback) \
-    ROS2_CREATE_SUBSCRIBER(RobotROS2Node, this, InTopicName, InMsgClass, InCallback)
+    ROS2_CREATE_SUBSCRIBER(RobotROS2Node, this, GetTopicName(InTopicName), InMsgClass, InCallback)
 
 public:
     //! Target robot
@@ -59,10 +92,21 @@ public:
      */
     void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
-    //! ROS 2 node of this interface created by #InitRobotROS2Node
+    //! ROS 2 node of this interface created by #InitRobotROS2Node, or shared with other robots from #URRROS2NodePool
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated)
     UROS2NodeComponent* RobotROS2Node = nullptr;
 
+    //! Robot's namespace, being #RobotROS2Node's unless shared, then prefixing relative topic names by #GetTopicName
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    FString RobotNamespace;
+
+    /**
+     * @brief Get a topic name resolved in #RobotNamespace, see #URRROS2NodePool::GetTopicName
+     * @param InTopicName
+     * @return FString
+     */
+    FString GetTopicName(const FString& InTopicName) const;
+
     //! ROS2SpawnParameters which is created when robot is spawn from /SpawnEntity srv provided by #ASimulationState.
     UPROPERTY(VisibleAnywhere, Replicated)
     UROS2Spawnable* ROSSpawnParameters = nullptr;
@@ -90,7 +134,7 @@ public:
     virtual void DeInitialize();
 
     /**
-     * @brief Spawn ROS2Node and initialize it.
+     * @brief Spawn ROS2Node and initialize it, or acquire one from the game mode's #URRROS2NodePool if any.
      *
      * @param InPawn
      */
@@ -105,6 +149,14 @@ public:
     UFUNCTION()
     virtual void JointStateCallback(const UROS2GenericMsg* Msg);
 
+    /**
+     * @brief Apply a joint command already converted to UE units, on game thread, eg replayed by #URRInputReplay
+     * @param InNames
+     * @param InControlType
+     * @param InValues
+     */
+    void ApplyJointCmd(const TArray<FString>& InNames, const ERRJointControlType InControlType, const TArray<float>& InValues);
+
     //! Odometry source
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated)
     URRBaseOdomComponent* OdomComponent = nullptr;
@@ -118,6 +170,10 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated)
     float OdomPublicationFrequencyHz = 30;
 
+    //! Set #URRROS2BaseSensorComponent::bOnDemand on all robot sensors, only updated while their topics are subscribed
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bSensorsOnDemand = false;
+
     //! Movement command topic. If empty is given, subscriber will not be initiated.
     UPROPERTY(BlueprintReadWrite, Replicated)
     FString CmdVelTopicName = TEXT("cmd_vel");
@@ -199,6 +255,35 @@ public:
     UFUNCTION()
     virtual void StopPublishers();
 
+    //! Restart the publication timers of #Publishers stopped by #StopPublishers, already added to #RobotROS2Node
+    virtual void RestartPublishers();
+
+    //! Key of this interface in #URRROS2InterfacePool, set upon being created by a robot while a pool is in use
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    FString PoolKey;
+
+    //! Whether acquired from #URRROS2InterfacePool, thus only rebinding its endpoints upon the next #Initialize
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    bool bRecycled = false;
+
+    //! Sensor publishers taken over from the robot's sensors while parked in #URRROS2InterfacePool
+    UPROPERTY()
+    TArray<URRROS2BaseSensorPublisher*> ParkedSensorPublishers;
+
+    /**
+     * @brief Take over the sensor publishers created on #RobotROS2Node from InRobot's sensors, stopped, into
+     * #ParkedSensorPublishers, to be handed to the sensors of the next robot by #RebindSensorPublishers
+     * @param InRobot
+     */
+    void ParkSensorPublishers(ARRBaseRobot* InRobot);
+
+    /**
+     * @brief Hand #ParkedSensorPublishers to InRobot's sensors without publisher, of the same topic & publisher class,
+     * leaving the remaining ones to be destroyed
+     * @param InRobot
+     */
+    void RebindSensorPublishers(ARRBaseRobot* InRobot);
+
     /**
      * @brief Initialize subscriptions for cmd_vel & joint_states topics
      * Overidden in child robot ROS 2 interface classes for specialized topic subscriptions.
@@ -290,6 +375,62 @@ protected:
         }
     }
 
+    /**
+     * @brief Get the layout of InNames, re-resolving the joints only if the names differ from the previous msg's.
+     * Called on the ROS thread receiving joint commands.
+     * @param InNames
+     * @return TSharedPtr<const FRRJointCmdLayout, ESPMode::ThreadSafe>
+     */
+    TSharedPtr<const FRRJointCmdLayout, ESPMode::ThreadSafe> GetJointCmdLayout(const TArray<FString>& InNames);
+
+    /**
+     * @brief Apply the latest joint command to #Robot's joints, on the game thread.
+     * Commands received since the previous apply are dropped, only the latest one being relevant.
+     */
+    void ApplyPendingJointCmd();
+
+    /**
+     * @brief Queue this interface's pending commands to be applied upon its world's next tick, along with the ones of all
+     * other robots of the world. Called on the ROS thread receiving commands, queuing once until applied.
+     */
+    void QueuePendingCmds();
+
+    //! Apply the latest movement & joint commands, on game thread
+    virtual void ApplyPendingCmds();
+
+    /**
+     * @brief Apply the pending commands of all interfaces of a world, once per tick upon [OnWorldPreActorTick]
+     * @sa [OnWorldPreActorTick](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/Engine/FWorldDelegates/OnWorldPreActorTick/)
+     */
+    static void ApplyAllPendingCmds(UWorld* InWorld, ELevelTick /*InTickType*/, float /*InDeltaSeconds*/);
+
+    //! Interfaces with queued commands, of all worlds, guarded by #SPendingCmdsMutex
+    static TArray<TWeakObjectPtr<URRRobotROS2Interface>> SInterfacesWithPendingCmds;
+    static FCriticalSection SPendingCmdsMutex;
+    static std::once_flag SPendingCmdsOnceFlag;
+
+    //! [cm/s], [deg/s] Latest cmd_vel, written by #MovementCallback
+    FVector PendingLinearVel = FVector::ZeroVector;
+    FVector PendingAngularVel = FVector::ZeroVector;
+    bool bMovementCmdPending = false;
+    FCriticalSection MovementCmdMutex;
+
+    //! Reused by #JointStateCallback, which is invoked sequentially by the subscription
+    FROSJointState JointStateMsgData;
+
+    TSharedPtr<const FRRJointCmdLayout, ESPMode::ThreadSafe> JointCmdLayout;
+
+    //! Double buffer: written by #JointStateCallback, swapped with #AppliedJointCmd by #ApplyPendingJointCmd
+    FRRJointCmd PendingJointCmd;
+    FRRJointCmd AppliedJointCmd;
+    FCriticalSection JointCmdMutex;
+
+    //! Whether this is in #SInterfacesWithPendingCmds
+    std::atomic<bool> bCmdsQueued{false};
+
+    //! Single element staging of #ApplyPendingJointCmd, for the joints' array setters
+    TArray<float> JointCmdInput;
+
     UPROPERTY()
     TMap<FName /*ServiceName*/, UROS2ServiceClient*> ServiceClientList;
 
@@ -611,6 +611,28 @@ struct RAPYUTASIMULATIONPLUGINS_API FRRSensorLidarInfo
     double NoiseStdDev = 0;
 };
 
+/**
+ * @brief Sensor camera info
+ * @sa [URDF-Sensor](http://wiki.ros.org/urdf/XML/sensor)
+ * @sa [SDF-Sensor](http://sdformat.org/spec?elem=sensor)
+ */
+USTRUCT(BlueprintType)
+struct RAPYUTASIMULATIONPLUGINS_API FRRSensorCameraInfo
+{
+    GENERATED_BODY()
+    //! Name of a #URRROS2CameraComponent capture profile, eg "perception-fast" or "photoreal"
+    UPROPERTY(EditAnywhere)
+    FString CaptureProfileName;
+
+    //! [px], 0 to keep the camera's one
+    UPROPERTY(EditAnywhere)
+    int32 Width = 0;
+
+    //! [px], 0 to keep the camera's one
+    UPROPERTY(EditAnywhere)
+    int32 Height = 0;
+};
+
 USTRUCT(BlueprintType)
 struct RAPYUTASIMULATIONPLUGINS_API FRRSensorProperty
 {
@@ -623,6 +645,8 @@ struct RAPYUTASIMULATIONPLUGINS_API FRRSensorProperty
     ERRSensorType SensorType = ERRSensorType::NONE;
     UPROPERTY(EditAnywhere)
     FRRSensorLidarInfo LidarInfo;
+    UPROPERTY(EditAnywhere)
+    FRRSensorCameraInfo CameraInfo;
 };
 
 USTRUCT(BlueprintType)
@@ -729,6 +753,14 @@ public:
                              *sensor.SensorName);
             UE_LOG_WITH_INFO(LogTemp, Display, TEXT("- Link: %s"), *sensor.LinkName);
 
+            if (ERRSensorType::CAMERA == sensor.SensorType)
+            {
+                const auto& cameraInfo = sensor.CameraInfo;
+                UE_LOG_WITH_INFO(LogTemp, Display, TEXT("- Camera capture profile: %s"), *cameraInfo.CaptureProfileName);
+                UE_LOG_WITH_INFO(LogTemp, Display, TEXT("+ Width: %d - Height: %d"), cameraInfo.Width, cameraInfo.Height);
+                continue;
+            }
+
             const auto& lidarInfo = sensor.LidarInfo;
             UE_LOG_WITH_INFO(LogTemp,
                              Display,
@@ -1256,6 +1288,10 @@ public:
     // Material
     UPROPERTY(EditAnywhere)
     FRRMaterialProperty WholeBodyMaterialInfo;
+
+    // Mesh LODs, generated for the robot's runtime-loaded meshes
+    UPROPERTY(EditAnywhere)
+    FRRMeshLODSettings MeshLODSettings;
     FRRMaterialProperty GetBodyMaterialInfo() const
     {
         return WholeBodyMaterialInfo;
@@ -27,16 +27,16 @@
 
 /**
  * @brief ROS 2 2D lidar components.
- * This class has 2 types of implementation, async and sync which can be switched by define TRACE_ASYNC.
- * sync uses LineTraceSingleByChannel and async uses AsyncLineTraceByChannel.
+ * Scans are traced by #URRBaseLidarComponent::SensorUpdate(), either on game thread or, with define TRACE_ASYNC, in a
+ * worker task resolved in a later tick.
  *
  * @sa [LineTraceSingleByChannel](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/Engine/UWorld/LineTraceSingleByChannel/)
- * @sa [AsyncLineTraceByChannel](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/Engine/UWorld/AsyncLineTraceSingleByChannel/)
  */
 UCLASS(ClassGroup = (Custom), Blueprintable, meta = (BlueprintSpawnableComponent))
 class RAPYUTASIMULATIONPLUGINS_API URR2DLidarComponent : public URRBaseLidarComponent
 {
     GENERATED_BODY()
+    friend class FRRMicroBenchmarks;
 
 public:
     /**
@@ -46,59 +46,101 @@ public:
     URR2DLidarComponent();
 
     /**
-     * @brief
-     * async: Update #RecordedHits from #TraceHandles which is update in #SensorUpdate.
-     *
-     * @param DeltaTime
-     * @param TickType
-     * @param ThisTickFunction
+     * @brief Size #LaserScanMsg ranges & intensities for #NSamplesPerScan rays, then start the sensor timer
      */
-    virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+    virtual void Run() override;
 
     /**
-     * @brief
-     * sync:  Initialize #FHitResult
-     * async: Initialize #FTraceHandle
+     * @brief Get a sensor-local ray's rotation from #StartAngle & #DHAngle
+     * @param InIndex
+     * @return FRotator
      */
-    void Run() override;
+    FRotator GetLocalRayRotation(const int32 InIndex) const override;
 
     /**
-     * @brief Get Lidar data, add noise, draw lidar rays.
-     * sync  : Uses LineTraceSingleByChannel to get lidar data.
-     * async : Uses AsyncLineTraceByChannel to get lidar data.
-     *
-     * @sa [LineTraceSingleByChannel](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/Engine/UWorld/LineTraceSingleByChannel/)
-     * @sa [AsyncLineTraceByChannel](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/Engine/UWorld/AsyncLineTraceSingleByChannel/)
+     * @brief Get the index of the ray of a sensor-local rotation, from its yaw if within the scan plane
      */
-    void SensorUpdate() override;
+    int32 FindRayIndex(const FRotator& InLocalRotation) const override;
 
     /**
-     * @brief Return true if laser hits the target actor.
-     * @param TargetActor
-     * @return true
-     * @return false
+     * @brief Derive the scans of lidars of the group, add noise, update #TimeOfLastScan & draw lidar rays of the latest
+     * traced scan
      */
-    bool Visible(AActor* TargetActor) override;
+    void OnScanTraced() override;
 
     UFUNCTION(BlueprintCallable)
     /**
-     * @brief Create ROS 2 Msg structure from #RecordedHits
+     * @brief Create ROS 2 Msg structure from #ScanHits
      * This should probably be removed so that the sensor can be decoupled from the message types
      *
-     * @return FROSLaserScan
+     * @return FROSLaserScan Copy of #LaserScanMsg
      */
     FROSLaserScan GetROS2Data();
 
     /**
-     * @brief Set result of #GetROS2Data to
+     * @brief Write #ScanHits into #LaserScanMsg ranges & intensities by index, in a single pass, in parallel for wide scans.
+     * Arrays are only reallocated if the scan size has changed.
+     */
+    void UpdateLaserScanMsg();
+
+    /**
+     * @brief Set #LaserScanMsg, updated by #UpdateLaserScanMsg, to InMessage without intermediate copy.
      *
      * @param InMessage
      */
     virtual void SetROS2Msg(UROS2GenericMsg* InMessage) override;
 
+    /**
+     * @brief Snapshot #ScanHits & the intensity noise into a builder writing the msg rays on the publisher thread
+     *
+     * @param OutBuilder
+     * @return true
+     */
+    virtual bool GetROS2MsgBuilder(FRRROS2MsgBuilder& OutBuilder) override;
+
     UFUNCTION(BlueprintCallable)
     float GetMinAngleRadians() const;
 
     UFUNCTION(BlueprintCallable)
     float GetMaxAngleRadians() const;
+
+protected:
+    //! Rays written per #UpdateLaserScanMsg() task, narrower scans are written on the calling thread
+    static constexpr int32 RAYS_PER_TASK = 1024;
+
+    //! Lidar params read by #WriteLaserScanRays(), copied to be used off game thread
+    struct FLaserScanRaysParams
+    {
+        float MinRange = 0.f;
+        FRRLidarIntensityTable IntensityTable;
+    };
+
+    FLaserScanRaysParams GetLaserScanRaysParams() const;
+
+    //! NaN, as for misses
+    virtual float GetNoSurfaceIntensity() const override
+    {
+        return std::numeric_limits<float>::quiet_NaN();
+    }
+
+    /**
+     * @brief Fill the msg header & scalar fields, ie all but ranges & intensities
+     * @param OutMsg
+     */
+    void FillLaserScanMsgHeader(FROSLaserScan& OutMsg) const;
+
+    /**
+     * @brief Write hits into msg ranges & intensities, thread-safe as only reading its inputs
+     * @param InHits
+     * @param InIntensityNoise nullptr if without noise
+     * @param InParams
+     * @param OutMsg
+     */
+    static void WriteLaserScanRays(const TArray<FRRLidarHit>& InHits,
+                                   const TArray<float>* InIntensityNoise,
+                                   const FLaserScanRaysParams& InParams,
+                                   FROSLaserScan& OutMsg);
+
+    //! Persistent msg reused across scans
+    FROSLaserScan LaserScanMsg;
 };
@@ -7,6 +7,7 @@
 #pragma once
 
 // UE
+#include "Components/SceneCaptureComponent2D.h"
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 
@@ -15,21 +16,33 @@
 
 // RapyutaSimulationPlugins
 #include "Sensors/RRBaseLidarComponent.h"
+#include "Sensors/RRLidarDepthCapture.h"
+#include "Tools/RRROS2MsgWriter.h"
 
 #include "RR3DLidarComponent.generated.h"
 
+/**
+ * @brief How #URR3DLidarComponent scans are acquired
+ */
+UENUM(BlueprintType)
+enum class ERR3DLidarBackend : uint8
+{
+    LINE_TRACE UMETA(DisplayName = "Line trace", ToolTip = "CPU line traces against complex collision."),
+    DEPTH_CAPTURE UMETA(DisplayName = "Depth capture", ToolTip = "GPU depth captures resampled to the lidar grid.")
+};
+
 /**
  * @brief ROS 2 3D lidar components.
- * This class has 2 types of implementation, async and sync which can be switched by define TRACE_ASYNC.
- * sync uses LineTraceSingleByChannel and async uses AsyncLineTraceByChannel.
+ * Scans are traced by #URRBaseLidarComponent::SensorUpdate(), either on game thread or, with define TRACE_ASYNC, in a
+ * worker task resolved in a later tick. Dense lidars can instead be scanned with GPU depth captures, see #Backend.
  *
  * @sa [LineTraceSingleByChannel](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/Engine/UWorld/LineTraceSingleByChannel/)
- * @sa [AsyncLineTraceByChannel](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/Engine/UWorld/AsyncLineTraceSingleByChannel/)
  */
 UCLASS(ClassGroup = (Custom), Blueprintable, meta = (BlueprintSpawnableComponent))
 class RAPYUTASIMULATIONPLUGINS_API URR3DLidarComponent : public URRBaseLidarComponent
 {
     GENERATED_BODY()
+    friend class FRRMicroBenchmarks;
 
 public:
     /**
@@ -39,54 +52,105 @@ public:
     URR3DLidarComponent();
 
     /**
-     * @brief
-     * async: Update #RecordedHits from #TraceHandles which is update in #SensorUpdate.
-     *
-     * @param DeltaTime
-     * @param TickType
-     * @param ThisTickFunction
+     * @brief Build #PointCloudMsg fields layout, with an extra t field if #bSweepScan, then start the sensor timer
      */
-    virtual void TickComponent(float DeltaTime, enum ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+    virtual void Run() override;
 
     /**
-     * @brief
-     * sync:  Initialize #FHitResult
-     * async: Initialize #FTraceHandle
+     * @brief Get a sensor-local ray's rotation from #StartAngle, #DHAngle, #StartVerticalAngle & #DVAngle
+     * @param InIndex
+     * @return FRotator
      */
-    void Run() override;
+    FRotator GetLocalRayRotation(const int32 InIndex) const override;
 
     /**
-     * @brief Get Lidar data, add noise, draw lidar rays.
-     * sync  : Uses LineTraceSingleByChannel to get lidar data.
-     * async : Uses AsyncLineTraceByChannel to get lidar data.
-     *
-     * @sa [LineTraceSingleByChannel](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/Engine/UWorld/LineTraceSingleByChannel/)
-     * @sa [AsyncLineTraceByChannel](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/Engine/UWorld/AsyncLineTraceSingleByChannel/)
+     * @brief Get the index of the ray of a sensor-local rotation, from its channel & column, eg of the channel matching
+     * a 2D lidar of the same #LidarGroup, making it a built-in point cloud to laser scan conversion
+     */
+    int32 FindRayIndex(const FRotator& InLocalRotation) const override;
+
+    int32 GetRaysNum() const override
+    {
+        return static_cast<int32>(GetTotalScan());
+    }
+
+    uint32 GetScanPatternHash() const override;
+
+    /**
+     * @brief #EchoesNum if #bMultiEcho with the line trace backend, otherwise 1
+     */
+    int32 GetEchoesNum() const override
+    {
+        return (bMultiEcho && (Backend == ERR3DLidarBackend::LINE_TRACE)) ? FMath::Max(1, EchoesNum) : 1;
+    }
+
+    /**
+     * @brief Also update #DVAngle
+     */
+    void BuildRayDirectionTable() override;
+
+    /**
+     * @brief Scan with line traces in #URRBaseLidarComponent::SensorUpdate(), or render depth captures if #Backend is
+     * #ERR3DLidarBackend::DEPTH_CAPTURE. Captures are read back without blocking, then resolved in #TickComponent().
      */
     void SensorUpdate() override;
 
     /**
-     * @brief Return true if laser hits the target actor.
-     * @param TargetActor
-     * @return true
-     * @return false
+     * @brief Also resolve the depth captures read back, if completed
+     */
+    virtual void TickComponent(float DeltaTime,
+                               enum ELevelTick TickType,
+                               FActorComponentTickFunction* ThisTickFunction) override;
+
+    /**
+     * @brief Trace the scan at #AdaptiveStride coarse resolution first if #bAdaptiveResolution, then fully trace only the
+     * blocks in between at range edges or near objects, others being interpolated from their corners.
+     * Interpolated rays have no recorded hit result.
+     */
+    void TraceScan(TArray<FRRLidarHit>& OutHits, TArray<FHitResult>* OutRecordedHits, TArray<FRRLidarHit>& OutEchoHits) override;
+
+    /**
+     * @brief Derive the scans of lidars of the group, add noise, update #TimeOfLastScan & draw lidar rays of the latest
+     * traced scan
      */
-    bool Visible(AActor* TargetActor) override;
+    void OnScanTraced() override;
 
     /**
-     * @brief Create ROS 2 Msg structure from #RecordedHits
+     * @brief Create ROS 2 Msg structure from #ScanHits
      * This should probably be removed so that the sensor can be decoupled from the message types
-     * @return FROSPointCloud2
+     * @return FROSPointCloud2 Copy of #PointCloudMsg
      */
     FROSPointCloud2 GetROS2Data();
 
     /**
-     * @brief Set result of #GetROS2Data to InMessage.
+     * @brief Pack #ScanHits into #PointCloudMsg in place, in parallel over rows.
+     * Fields layout is only built once in #Run(), data buffer is only reallocated if the scan size has changed.
+     */
+    void UpdatePointCloudMsg();
+
+    /**
+     * @brief Set #PointCloudMsg, updated by #UpdatePointCloudMsg, to InMessage without intermediate copy, written in place
+     * by #FRRROS2MsgWriter into the msg's data buffer kept from the previous publish.
      *
      * @param InMessage
      */
     virtual void SetROS2Msg(UROS2GenericMsg* InMessage) override;
 
+    /**
+     * @brief If #IsPointCloudProcessed(), provide a builder post-processing a copy of #PointCloudMsg on the publisher thread
+     * with #ProcessPointCloud(), otherwise publish #PointCloudMsg as is.
+     * The copy is taken from #MsgPool, thus into a buffer already sized by a previous scan.
+     * @param OutBuilder
+     * @return true if a builder is provided
+     */
+    virtual bool GetROS2MsgBuilder(FRRROS2MsgBuilder& OutBuilder) override;
+
+    //! Whether any of #bRemoveNoReturns, #VoxelSize or #bCompactPointFields applies to the published clouds
+    bool IsPointCloudProcessed() const
+    {
+        return bRemoveNoReturns || (VoxelSize > 0.f) || bCompactPointFields;
+    }
+
     // vertical samples
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     int32 NChannelsPerScan = 32;
@@ -112,4 +176,169 @@ public:
     //! [degrees]
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
     float DVAngle = 0.f;
+
+    //! x, y, z, distance, intensity, followed by t in sweep mode & return_index in multi-echo mode
+    static constexpr int32 POINT_FIELDS_NUM = 5;
+
+    //! Keep up to #EchoesNum returns per beam, from a single multi-hit trace, published as extra point cloud rows with
+    //! their return_index. Only objects overlapping (not blocking) ECC_Visibility, eg rain or glass, give returns
+    //! before the blocking one. Line trace backend only.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trace")
+    bool bMultiEcho = false;
+
+    UPROPERTY(EditAnywhere,
+              BlueprintReadWrite,
+              Category = "Trace",
+              meta = (ClampMin = "2", ClampMax = "8", EditCondition = "bMultiEcho"))
+    int32 EchoesNum = 2;
+
+    //! [degrees] Full beam divergence in multi-echo mode, 0 to disable. Beams at a range discontinuity with a neighbour
+    //! beam are also probed by a stencil of #BEAM_STENCIL_SIZE sub-rays at the beam edges, whose distinct returns fill
+    //! the free echo slots. Others beams cost a single trace.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trace", meta = (ClampMin = "0", EditCondition = "bMultiEcho"))
+    float BeamDivergence = 0.f;
+
+    //! [cm] Min range difference of neighbour beams at a discontinuity, & of distinct returns of a beam
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trace", meta = (ClampMin = "0", EditCondition = "bMultiEcho"))
+    float EchoSeparation = 50.f;
+
+    static constexpr int32 BEAM_STENCIL_SIZE = 4;
+
+    //! Trace every #AdaptiveStride-th column & channel first, then fully trace only the blocks in between whose corners
+    //! straddle a range edge or are near, see #TraceScan(). Single-echo sync & async scans only, sweeps & batched scans
+    //! staying at full resolution.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trace")
+    bool bAdaptiveResolution = false;
+
+    UPROPERTY(EditAnywhere,
+              BlueprintReadWrite,
+              Category = "Trace",
+              meta = (ClampMin = "2", EditCondition = "bAdaptiveResolution"))
+    int32 AdaptiveStride = 4;
+
+    //! [cm] Min range spread of a block's corners for the block to be fully traced
+    UPROPERTY(EditAnywhere,
+              BlueprintReadWrite,
+              Category = "Trace",
+              meta = (ClampMin = "0", EditCondition = "bAdaptiveResolution"))
+    float AdaptiveEdgeThreshold = 20.f;
+
+    //! [cm] Blocks with a corner hit nearer than this are fully traced
+    UPROPERTY(EditAnywhere,
+              BlueprintReadWrite,
+              Category = "Trace",
+              meta = (ClampMin = "0", EditCondition = "bAdaptiveResolution"))
+    float AdaptiveNearRange = 200.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trace")
+    ERR3DLidarBackend Backend = ERR3DLidarBackend::LINE_TRACE;
+
+    //! Drop the points of rays without return, otherwise packed at the sensor origin, publishing an unorganized cloud
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PointCloud")
+    bool bRemoveNoReturns = false;
+
+    //! [cm] Edge of the voxel grid the published points are downsampled to, one centroid per occupied voxel, 0 to disable.
+    //! Points without return are removed as well.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PointCloud", meta = (ClampMin = "0"))
+    float VoxelSize = 0.f;
+
+    //! Publish compact points: x, y, z (& t) as FLOAT32, intensity (& return_index) as UINT16, dropping the distance
+    //! field, which is recomputed from x, y, z by consumers if needed
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "PointCloud")
+    bool bCompactPointFields = false;
+
+    //! Horizontal resolution of each depth capture face, whose height follows the vertical FOV
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trace")
+    int32 DepthCaptureWidth = 1024;
+
+    //! Optional post-process material writing the EPhysicalSurface index of the rendered surfaces into R, eg from their
+    //! CustomStencil. If set, it is rendered by extra surface class captures, otherwise all depth hits are non-reflective.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trace")
+    UMaterialInterface* DepthCaptureSurfaceClassMaterial = nullptr;
+
+protected:
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    UPROPERTY(Transient)
+    TArray<USceneCaptureComponent2D*> DepthCaptures;
+
+    UPROPERTY(Transient)
+    TArray<USceneCaptureComponent2D*> SurfaceClassCaptures;
+
+    FRRLidarDepthCaptureLayout DepthCaptureLayout;
+
+    //! #GetScanPatternHash() the depth captures were last built with
+    uint32 DepthCaptureLayoutHash = 0;
+
+    FRRLidarDepthReadback DepthReadback;
+
+    /**
+     * @brief (Re)build #DepthCaptureLayout & the capture components with their render targets
+     */
+    void InitDepthCaptures();
+
+    /**
+     * @brief Render all capture faces at the pose cached by #PrepareScan(), then enqueue their read-back
+     */
+    void CaptureDepth();
+
+    /**
+     * @brief Resample the read-back faces into #ScanHits, then post-process the scan
+     */
+    void ResolveDepthCapture();
+
+    /**
+     * @brief Check whether a ray's range differs from one of its 4-neighbours' by more than #EchoSeparation
+     * @param InIndex
+     * @return true
+     * @return false
+     */
+    bool IsAtRangeDiscontinuity(const int32 InIndex) const;
+
+    /**
+     * @brief Probe beams at range discontinuities with the #BeamDivergence stencil, in parallel, filling their free
+     * #ScanEchoHits slots with distinct returns
+     */
+    void TraceBeamDivergence();
+
+    //! Lidar params read by #ProcessPointCloud(), copied to be used off game thread
+    struct FPointCloudProcessParams
+    {
+        bool bRemoveNoReturns = false;
+        //! [m]
+        float VoxelSize = 0.f;
+        bool bCompactPointFields = false;
+        int32 TimeFieldIndex = INDEX_NONE;
+        int32 ReturnIndexFieldIndex = INDEX_NONE;
+    };
+
+    FPointCloudProcessParams GetPointCloudProcessParams() const;
+
+    /**
+     * @brief Remove the no-return points, voxel-downsample & compact the fields of a dense cloud packed by
+     * #UpdatePointCloudMsg(), in place. Thread-safe as only reading its params.
+     * @param InParams
+     * @param InOutMsg Unorganized (height 1) if points are removed
+     */
+    static void ProcessPointCloud(const FPointCloudProcessParams& InParams, FROSPointCloud2& InOutMsg);
+
+    //! Index of t & return_index fields in #PointCloudMsg, INDEX_NONE if absent
+    int32 TimeFieldIndex = INDEX_NONE;
+    int32 ReturnIndexFieldIndex = INDEX_NONE;
+
+    //! Persistent msg reused across scans
+    FROSPointCloud2 PointCloudMsg;
+
+    //! Copy of #PointCloudMsg processed on game thread, reused across scans
+    FROSPointCloud2 ProcessedPointCloudMsg;
+
+    //! Copies of #PointCloudMsg handed off to the publisher thread, recycled once written, created upon the first builder
+    TSharedPtr<TRRROS2MsgPool<FROSPointCloud2>> MsgPool;
+
+    /**
+     * @brief Copy a cloud, reusing the destination's data allocation
+     * @param InSrc
+     * @param OutDst
+     */
+    static void CopyPointCloudMsg(const FROSPointCloud2& InSrc, FROSPointCloud2& OutDst);
 };
@@ -9,20 +9,135 @@
 #pragma once
 
 // std
+#include <atomic>
 #include <random>
 
 // UE
+#include "Async/Future.h"
 #include "Components/StaticMeshComponent.h"
 #include "CoreMinimal.h"
 
 // RapyutaSimulationPlugins
 #include "RRROS2BaseSensorComponent.h"
+#include "Sensors/RRLidarIntensityTable.h"
 
 #include "RRBaseLidarComponent.generated.h"
 
 #define TRACE_ASYNC 1
 
 class URRROS2LidarPublisher;
+class URRLidarVisualizationComponent;
+class FRRSensorRayScene;
+
+/**
+ * @brief Compact POD per-ray lidar return, written directly by the trace in place of a ~200-byte FHitResult.
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRLidarHit
+{
+    //! #SurfaceType value for hits without physical material
+    static constexpr uint8 SURFACE_TYPE_NONE = 0xFF;
+
+    //! [cm] World hit point, or trace end if no hit
+    FVector3f Point = FVector3f::ZeroVector;
+
+    //! [cm] Distance from trace start to the hit point, 0 if no hit
+    float Distance = 0.f;
+
+    //! Dot product of hit surface normal & the reversed ray direction, used for reflective surfaces' intensity
+    float NormalAlignment = 0.f;
+
+    //! Hit actor's UObject unique id, 0 if no hit
+    uint32 ActorId = 0;
+
+    //! EPhysicalSurface of the hit physical material, or #SURFACE_TYPE_NONE
+    uint8 SurfaceType = SURFACE_TYPE_NONE;
+
+    bool bHit = false;
+
+    //! [s] Trace time relative to the scan start, only non-zero in sweep mode
+    float TimeOffset = 0.f;
+
+    void SetFromHitResult(const FHitResult& InHit);
+
+    void SetMiss(const FVector& InTraceEnd)
+    {
+        *this = FRRLidarHit();
+        Point = FVector3f(InTraceEnd);
+    }
+};
+
+/**
+ * @brief Sensor-local angular region of a lidar scan, see #URRBaseLidarComponent::ExcludedRegions
+ */
+USTRUCT(BlueprintType)
+struct RAPYUTASIMULATIONPLUGINS_API FRRLidarRegion
+{
+    GENERATED_BODY()
+
+    //! [degrees] Azimuth range in [-180, 180], wrapping around if MinAzimuth > MaxAzimuth
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float MinAzimuth = -180.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float MaxAzimuth = 180.f;
+
+    //! [degrees] Elevation range, 2D lidars' rays being at 0
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float MinElevation = -90.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float MaxElevation = 90.f;
+
+    //! Whether a sensor-local ray rotation is within this region
+    bool Contains(const FRotator& InRayRotation) const
+    {
+        const float azimuth = FRotator::NormalizeAxis(InRayRotation.Yaw);
+        const bool bInAzimuth = (MinAzimuth <= MaxAzimuth) ? ((azimuth >= MinAzimuth) && (azimuth <= MaxAzimuth))
+                                                           : ((azimuth >= MinAzimuth) || (azimuth <= MaxAzimuth));
+        return bInAzimuth && (InRayRotation.Pitch >= MinElevation) && (InRayRotation.Pitch <= MaxElevation);
+    }
+};
+
+/**
+ * @brief Read-only table of the sensor-local ray directions & excluded rays of a scan pattern, built once then shared by all
+ * the lidars of the same class, #URRBaseLidarComponent::GetScanPatternHash() & rays num, eg those of a fleet of identical
+ * robots, unless `rr.Lidar.ShareRayTables` is 0.
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRLidarRayTable
+{
+    //! Sensor-local unit ray directions (SoA), padded with zeros to a multiple of 4 for #URRMathUtils::RotateVectorsSoA()
+    TArray<float> LocalRayDirX;
+    TArray<float> LocalRayDirY;
+    TArray<float> LocalRayDirZ;
+
+    //! Rays within #URRBaseLidarComponent::ExcludedRegions
+    TBitArray<> ExcludedRays;
+    int32 ExcludedRaysNum = 0;
+
+    FORCEINLINE bool IsRayExcluded(const int32 InIndex) const
+    {
+        return (ExcludedRaysNum > 0) && ExcludedRays[InIndex];
+    }
+};
+
+/**
+ * @brief Branches of #URRBaseLidarComponent::TraceRay() which are invariant over a scan, each combination being a separate
+ * instantiation of the ray kernel, selected by #URRBaseLidarComponent::GetTraceRayKernel()
+ */
+enum class ERRLidarTraceConfig : uint8
+{
+    NONE = 0x00,
+    //! Any ray within #URRBaseLidarComponent::ExcludedRegions
+    EXCLUSIONS = 0x01,
+    //! Cast against #URRBaseLidarComponent::ScanRayScene, only without ECHOES nor RECORDED
+    RAY_SCENE = 0x02,
+    //! Multi-hit traces for further returns
+    ECHOES = 0x04,
+    //! Full hit results recorded
+    RECORDED = 0x08,
+    NUM = 0x10
+};
+ENUM_CLASS_FLAGS(ERRLidarTraceConfig);
 
 /**
  * @brief Base ROS 2 LIDAR Component class. Other lidar class should inherit from this class.
@@ -39,22 +154,263 @@ public:
 protected:
     virtual void BeginPlay() override;
 
+    /**
+     * @brief Wait for the scan in flight, if any, since it accesses this component's buffers
+     */
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:
     /**
-     * @brief Return true if laser hits the target actor. This method should be overwritten by child class.
+     * @brief Build #TraceParams, shared by all rays of every scan, allocate scan buffers, then start the sensor timer
+     */
+    virtual void Run() override;
+
+    /**
+     * @brief
+     * sweep: Trace the columns due since the last tick with #UpdateSweep()
+     * async: Resolve the scan traced by the worker task, if completed, by swapping it into #ScanHits
+     * sync: Do nothing
+     */
+    virtual void TickComponent(float DeltaTime,
+                               enum ELevelTick TickType,
+                               FActorComponentTickFunction* ThisTickFunction) override;
+
+    /**
+     * @brief Stop the sensor timer & drop any scan pending in #FRRLidarBatchScheduler
+     */
+    virtual void Stop() override;
+
+    /**
+     * @brief Prepare & trace a scan, then post-process it with #OnScanTraced once traced.
+     * sweep : Completes the sweep in progress, then starts a new one, traced over ticks by #UpdateSweep() if #bSweepScan.
+     * batch : Queues the scan to #FRRLidarBatchScheduler if #bBatchTrace.
+     * sync  : Traces the scan in ParallelFor on game thread.
+     * async : Traces the scan into #PendingScanHits in a worker task, then swaps it into #ScanHits in #TickComponent() once
+     *         completed, so that publication never waits for nor sees a partial scan. Timer due times while a scan is in
+     *         flight are skipped.
+     *
+     * @sa [LineTraceSingleByChannel](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/Engine/UWorld/LineTraceSingleByChannel/)
+     */
+    virtual void SensorUpdate() override;
+
+    /**
+     * @brief Start a new scan, then cache its lidar pose & world ray directions with #UpdateScanPose().
+     * Called at the beginning of SensorUpdate(), thus batch-traced scans use the pose at their timer due time.
+     * The sensor-local direction table & scan buffers are rebuilt here-in only if the scan pattern has changed.
+     */
+    virtual void PrepareScan();
+
+    /**
+     * @brief Cache the current lidar pose & world ray directions used by #GetTraceRay
+     */
+    void UpdateScanPose();
+
+    /**
+     * @brief Get the world-space start & end of a ray in the upcoming scan, from the directions cached by #PrepareScan().
+     * @param InIndex Ray index in #ScanHits
+     * @param OutStartPos
+     * @param OutEndPos
+     */
+    FORCEINLINE void GetTraceRay(const int32 InIndex, FVector& OutStartPos, FVector& OutEndPos) const
+    {
+        const FVector rayDir(ScanRayDirX[InIndex], ScanRayDirY[InIndex], ScanRayDirZ[InIndex]);
+        OutStartPos = ScanLidarPos + MinRange * rayDir;
+        OutEndPos = ScanLidarPos + MaxRange * rayDir;
+    }
+
+    /**
+     * @brief Get total num of rays per scan. 3D lidars override this.
+     */
+    virtual int32 GetRaysNum() const
+    {
+        return NSamplesPerScan;
+    }
+
+    /**
+     * @brief Get a sensor-local ray's (pitch, yaw) angles in [degrees]. This method should be overwritten by child class.
+     * @param InIndex
+     * @return FRotator
+     */
+    virtual FRotator GetLocalRayRotation(const int32 InIndex) const
+    {
+        checkNoEntry();
+        return FRotator::ZeroRotator;
+    }
+
+    /**
+     * @brief Hash of the scan pattern params the direction table is built from. Child classes combine their extra params.
+     */
+    virtual uint32 GetScanPatternHash() const;
+
+    /**
+     * @brief (Re)build the #RayTable of sensor-local unit ray directions from #GetLocalRayRotation(), or get the one shared
+     * by the lidars of the same pattern, also updating #DHAngle. Called in #Run() and whenever #GetScanPatternHash() changes.
+     */
+    virtual void BuildRayDirectionTable();
+
+    //! Rays within any of these sensor-local regions are never traced but published as misses, eg those blocked by the
+    //! robot's own body or out of the region of interest
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trace")
+    TArray<FRRLidarRegion> ExcludedRegions;
+
+    //! Whether single-echo scans are cast against the world's #FRRSensorRayCaster instead of physics scene queries, faster
+    //! in large static worlds. Only movable primitives of #ASimulationState entities are seen among the non-static ones.
+    //! Ignored with #bRecordHitResults.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trace")
+    bool bUseSensorRayCaster = false;
+
+    //! Whether a ray is within #ExcludedRegions
+    FORCEINLINE bool IsRayExcluded(const int32 InIndex) const
+    {
+        return RayTable->IsRayExcluded(InIndex);
+    }
+
+    //! Num of rays actually traced by the latest #TraceScan(), excluded & interpolated ones aside
+    int32 GetLastScanTracedRaysNum() const
+    {
+        return LastScanTracedRaysNum;
+    }
+
+    /**
+     * @brief Trace all rays of the upcoming scan into given buffers in ParallelFor. Called on game thread for sync scans or
+     * from the worker task for async ones, thus only writing the given buffers & #LastScanTracedRaysNum.
+     * Sweeps & batched scans trace their rays with #TraceRay() directly.
+     * @param OutHits
+     * @param OutRecordedHits Optional, if #bRecordHitResults
+     * @param OutEchoHits
+     */
+    virtual void TraceScan(TArray<FRRLidarHit>& OutHits, TArray<FHitResult>* OutRecordedHits, TArray<FRRLidarHit>& OutEchoHits);
+
+    //! Lidars of the same owner in the same non-None group share the scan of the group member whose rays are a superset of
+    //! theirs, eg a 2D safety scanner derived from the matching channel of a co-located 3D lidar, see #ResolveLidarGroup().
+    //! Derived lidars are updated on the source's schedule, thus should share its PublicationFrequencyHz.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trace")
+    FName LidarGroup = NAME_None;
+
+    //! Whether scans are derived from #GetSourceLidar() instead of traced
+    bool IsScanDerived() const
+    {
+        return SourceLidar.IsValid();
+    }
+
+    URRBaseLidarComponent* GetSourceLidar() const
+    {
+        return SourceLidar.Get();
+    }
+
+    /**
+     * @brief Get the index of the ray of a sensor-local rotation, used to map the rays of lidars deriving their scans
+     * from this one
+     * @param InLocalRotation
+     * @return int32 INDEX_NONE if no ray matches within #RAY_ANGLE_TOLERANCE
+     */
+    virtual int32 FindRayIndex(const FRotator& InLocalRotation) const
+    {
+        return INDEX_NONE;
+    }
+
+    //! [degrees] Max angle between matched rays of a lidar group
+    static constexpr float RAY_ANGLE_TOLERANCE = 0.01f;
+
+    //! [cm] Max distance between the origins of a lidar group members
+    static constexpr float GROUP_POSITION_TOLERANCE = 1.f;
+
+    /**
+     * @brief Synchronously trace a single ray into #ScanHits[InIndex] (and #RecordedHits[InIndex] if #bRecordHitResults).
+     * Thread-safe, called from worker threads.
+     * @param InIndex
+     */
+    void TraceRay(const int32 InIndex)
+    {
+        (this->*ScanTraceRayKernel)(InIndex,
+                                    ScanHits[InIndex],
+                                    bRecordHitResults ? &RecordedHits[InIndex] : nullptr,
+                                    GetEchoHits(ScanEchoHits, InIndex));
+    }
+
+    /**
+     * @brief Synchronously trace a single ray into given buffers, or set it a miss if #IsRayExcluded(). Thread-safe.
+     * With OutEchoHits, a single multi-hit trace gives the nearest return to OutHit & the next ones to OutEchoHits.
+     * Selects the kernel per call, thus loops over rays should rather call the one of #GetTraceRayKernel().
+     * @param InIndex
+     * @param OutHit
+     * @param OutRecordedHit Optional full hit result of the first return
+     * @param OutEchoHits Optional (#ActiveEchoesNum - 1) further returns, in distance order
+     */
+    void TraceRay(const int32 InIndex, FRRLidarHit& OutHit, FHitResult* OutRecordedHit, FRRLidarHit* OutEchoHits = nullptr) const
+    {
+        (this->*GetTraceRayKernel(nullptr != OutRecordedHit, nullptr != OutEchoHits))(
+            InIndex, OutHit, OutRecordedHit, OutEchoHits);
+    }
+
+    //! #TraceRay() specialized for a #ERRLidarTraceConfig, ignoring the optional outputs it excludes
+    using FTraceRayKernel = void (URRBaseLidarComponent::*)(int32, FRRLidarHit&, FHitResult*, FRRLidarHit*) const;
+
+    /**
+     * @brief Get the ray kernel of the upcoming scan, its exclusions & #ScanRayScene being as set by #PrepareScan()
+     * @param bInRecorded Whether full hit results are to be recorded
+     * @param bInEchoes Whether further returns are to be traced
+     * @return FTraceRayKernel
+     */
+    FTraceRayKernel GetTraceRayKernel(const bool bInRecorded, const bool bInEchoes) const;
+
+    //! #TraceRay() without the branches TConfig excludes, the optional outputs being non-null as per TConfig
+    template<ERRLidarTraceConfig TConfig>
+    void TraceRayKernel(const int32 InIndex, FRRLidarHit& OutHit, FHitResult* OutRecordedHit, FRRLidarHit* OutEchoHits) const;
+
+    /**
+     * @brief Get num of returns kept per ray, 1 for single return. Child classes supporting multi-echo override this.
+     */
+    virtual int32 GetEchoesNum() const
+    {
+        return 1;
+    }
+
+    /**
+     * @brief Get the echoes of a ray in #ScanEchoHits or #PendingScanEchoHits
+     * @param InEchoHits
+     * @param InIndex
+     * @return FRRLidarHit* nullptr if single return
+     */
+    FORCEINLINE FRRLidarHit* GetEchoHits(TArray<FRRLidarHit>& InEchoHits, const int32 InIndex) const
+    {
+        return (ActiveEchoesNum > 1) ? &InEchoHits[InIndex * (ActiveEchoesNum - 1)] : nullptr;
+    }
+
+    /**
+     * @brief Post-process the latest traced scan: add noise, update #TimeOfLastScan & draw lidar rays.
+     * This method should be overwritten by child class.
+     */
+    virtual void OnScanTraced()
+    {
+        checkNoEntry();
+    }
+
+    /**
+     * @brief Return true if any laser of a scan from the current pose hits the target actor.
+     * The scan is shared by all queries in the same frame & pose, see #GetVisibleActorIds().
      * @param TargetActor 
      * @return true 
      * @return false 
      */
     UFUNCTION(BlueprintCallable)
-    virtual bool Visible(AActor* TargetActor)
-    {
-        checkNoEntry();
-        return false;
-    }
+    virtual bool Visible(AActor* TargetActor);
 
     /**
-     * @brief Get #RecordedHits and #TimeOfLastScan.
+     * @brief Batched #Visible(), answering all target actors from a single scan.
+     * @param InTargetActors
+     * @param OutVisible Same size as InTargetActors, true if the actor at the same index is hit
+     */
+    UFUNCTION(BlueprintCallable)
+    void GetVisibleActors(const TArray<AActor*>& InTargetActors, TArray<bool>& OutVisible);
+
+    //! Answer visibility queries from the latest published scan's hits instead of tracing a scan from the current pose.
+    //! Cheaper, but up to a scan period late. Only line trace hits record their actor.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bVisibilityFromLatestScan = false;
+
+    /**
+     * @brief Get #RecordedHits and #TimeOfLastScan. #RecordedHits is only filled if #bRecordHitResults.
      * adding the rest of the necessary information might be tedious
      * eventually split into multiple getters
      *
@@ -64,6 +420,9 @@ public:
     UFUNCTION(BlueprintCallable)
     void GetData(TArray<FHitResult>& OutHits, float& OutTime) const;
 
+    //! [bytes] Held by the scan buffers & their back buffers, #RecordedHits included
+    int64 GetScanBuffersAllocatedSize() const;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     int32 NSamplesPerScan = 360;
 
@@ -98,6 +457,10 @@ public:
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
     float TimeOfLastScan = 0.f;
 
+    //! #TimeOfLastScan in integer nanoseconds, from which the scan msgs are stamped
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    int64 TimeOfLastScanNanosec = 0;
+
     // [degrees]
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
     float DHAngle = 0.f;
@@ -117,19 +480,89 @@ public:
     UPROPERTY(EditAnywhere, Category = "Noise")
     uint8 BWithNoise : 1;
 
+    //! Seed of the per-scan noise streams, for reproducible noisy scans. 0: derived from the master random seed & this
+    //! component's path upon BeginPlay(), see #FRRNoiseUtils::GetSensorSeed
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Noise")
+    int32 NoiseSeed = 0;
+
+    //! Full hit results of the latest scan, only recorded if #bRecordHitResults, for debugging
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
     TArray<FHitResult> RecordedHits;
 
+    //! Also record full FHitResult of every ray into #RecordedHits.
+    //! Debug only, since it costs ~20x the memory traffic of #ScanHits.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Debug")
+    bool bRecordHitResults = false;
+
+    //! Compact returns of the latest scan, from which ROS msgs & visualization are generated
+    TArray<FRRLidarHit> ScanHits;
+
+    //! #GetEchoesNum() the scan buffers are allocated for
+    int32 ActiveEchoesNum = 1;
+
+    //! Returns after the first one of each ray in #ScanHits, (#ActiveEchoesNum - 1) per ray, empty if single return
+    TArray<FRRLidarHit> ScanEchoHits;
+
+    /**
+     * @brief Allocate #ScanHits, #RecordedHits (if #bRecordHitResults), #ScanEchoHits & their async counterparts for
+     * #GetRaysNum() rays
+     */
+    void InitScanBuffers();
+
+    //! Back buffer of #ScanHits, being traced by #ScanTraceFuture or swept by #UpdateSweep()
+    TArray<FRRLidarHit> PendingScanHits;
+
+    //! Back buffer of #RecordedHits
+    TArray<FHitResult> PendingRecordedHits;
+
+    //! Back buffer of #ScanEchoHits
+    TArray<FRRLidarHit> PendingScanEchoHits;
+
+    //! Spread the scan columns over the scan period, like a rotating lidar, instead of tracing the whole scan at once.
+    //! Each tick only traces the columns due since the last one, from the lidar pose at that tick, thus producing motion
+    //! distortion & per-column #FRRLidarHit::TimeOffset. Neither batched nor async.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trace")
+    bool bSweepScan = false;
+
+    //! Num of columns of the sweep in progress which have been traced, -1 if none is in progress
+    int32 SweepColumnsDone = -1;
+
+    /**
+     * @brief Trace the columns of the sweep in progress due by now, then post-process the sweep once completed.
+     * Columns are swept from the last to the first, which is the increasing-angle order of published msgs.
+     * @param bInComplete Trace all remaining columns
+     */
+    void UpdateSweep(const bool bInComplete);
+
 #if TRACE_ASYNC
-    TArray<FTraceHandle> TraceHandles;
+    //! Worker task tracing the scan in flight
+    TFuture<void> ScanTraceFuture;
+
+    //! Num of timer due times skipped since a scan was still in flight, eg with traces slower than the scan period
+    uint32 SkippedScansNum = 0;
+
+    /**
+     * @brief Block until the scan in flight, if any, has been traced, without resolving it
+     */
+    void WaitForScanTrace();
 #endif
 
+    //! Queue scans to #FRRLidarBatchScheduler, which traces all lidars due in the same frame in one batch, instead of
+    //! tracing them on this component's own sensor timer.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Trace")
+    bool bBatchTrace = false;
+
+    //! Ignored in headless sensor-only mode, see URRCoreUtils::IsHeadlessSensorMode()
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     bool bShowLidarRays = true;
 
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     bool ShowLidarRayMisses = false;
 
+    //! Only visualize every n-th ray, independently of the published data
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "1"))
+    int32 VisualizationDecimation = 1;
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Intensity")
     float IntensityNonReflective = 1000.f;
 
@@ -142,22 +575,195 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Intensity")
     float IntensityMax = 10000.f;
 
+    //! Reflectivity of further surface types, or overriding the legacy SurfaceType_Default (non-reflective), SurfaceType1
+    //! (retroreflective) & SurfaceType2 (reflective) ones, see #FRRLidarIntensityTable::Build()
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Intensity")
+    TMap<TEnumAsByte<EPhysicalSurface>, FRRLidarSurfaceIntensity> SurfaceIntensities;
+
     FLinearColor InterpColorFromIntensity(const float InIntensity);
 
 protected:
     UPROPERTY()
     float Dt = 0.f;
 
+    //! Collision query params shared by all rays, built once in #Run()
+    FCollisionQueryParams TraceParams;
+
+    //! [s] Game time of the upcoming scan, cached by #PrepareScan(), stamped to #TimeOfLastScan once traced
+    float ScanStartTime = 0.f;
+    int64 ScanStartTimeNanosec = 0;
+
+    //! Lidar world location, cached by #PrepareScan()
+    FVector ScanLidarPos = FVector::ZeroVector;
+
+    //! Lidar world rotation, cached by #PrepareScan()
+    FRotator ScanLidarRot = FRotator::ZeroRotator;
+
+    /**
+     * @brief Get unique ids of the actors hit by a scan from the current pose, or by the latest scan if
+     * #bVisibilityFromLatestScan. The traced scan is cached until the frame or the lidar pose changes.
+     * @return const TSet<uint32>&
+     */
+    const TSet<uint32>& GetVisibleActorIds();
+
+    //! Cache of #GetVisibleActorIds()
+    TSet<uint32> VisibleActorIds;
+
+    //! Frame & lidar pose of #VisibleActorIds, or the #TimeOfLastScan if #bVisibilityFromLatestScan
+    uint64 VisibleActorIdsFrame = MAX_uint64;
+    FTransform VisibleActorIdsPose = FTransform::Identity;
+    float VisibleActorIdsScanTime = -1.f;
+
+    //! Sensor-local ray directions & excluded rays, set by #BuildRayDirectionTable()
+    TSharedPtr<const FRRLidarRayTable> RayTable;
+
+    //! World ray directions of the upcoming scan, rotated from the local ones once per scan in #PrepareScan()
+    TArray<float> ScanRayDirX;
+    TArray<float> ScanRayDirY;
+    TArray<float> ScanRayDirZ;
+
+    //! #GetScanPatternHash() the direction table was last built with
+    uint32 RayDirectionTableHash = 0;
+
+    std::atomic<int32> LastScanTracedRaysNum = 0;
+
+    //! Sensor ray casting scene of the upcoming scan if #bUseSensorRayCaster applies, set by #PrepareScan()
+    TSharedPtr<const FRRSensorRayScene> ScanRayScene;
+    uint32 ScanIgnoredActorId = 0;
+
+    //! Kernel of the upcoming scan's own buffers, ie with #bRecordHitResults & #ActiveEchoesNum, set by #PrepareScan()
+    FTraceRayKernel ScanTraceRayKernel = nullptr;
+
+    /**
+     * @brief Find the #LidarGroup member to derive scans from, the first one on the same owner which neither derives its own
+     * scans nor is on demand & whose rays, pose & ranges cover this lidar's by #BuildSourceRayIndices(). Called in #Run().
+     */
+    void ResolveLidarGroup();
+
+    /**
+     * @brief Map every ray to its source ray by #FindRayIndex(), if InSource is co-located with the same rotation & covers
+     * the range span, while this lidar is single-echo & only records hit results if InSource does.
+     * @param InSource
+     * @return true if all rays are mapped into #SourceRayIndices
+     */
+    bool BuildSourceRayIndices(const URRBaseLidarComponent& InSource);
+
+    /**
+     * @brief Copy the mapped hits of InSource's latest scan into #ScanHits, re-measured from this lidar's MinRange &
+     * MaxRange, excluded rays being misses, then post-process it with #OnScanTraced(). Re-maps the rays upon either scan
+     * pattern change.
+     * @param InSource
+     * @return false if no longer derivable, this lidar then tracing its own scans
+     */
+    bool DeriveScan(const URRBaseLidarComponent& InSource);
+
+    //! Derive the scans of #DerivedLidars from the latest one, called by child classes' #OnScanTraced() before noise
+    void UpdateDerivedLidars();
+
+    //! Get the column of a yaw in the #StartAngle, #FOVHorizontal, #NSamplesPerScan pattern, INDEX_NONE if none
+    int32 FindColumn(const float InYaw) const;
+
+    TWeakObjectPtr<URRBaseLidarComponent> SourceLidar;
+    TArray<TWeakObjectPtr<URRBaseLidarComponent>> DerivedLidars;
+
+    //! Source ray index of every ray, built by #BuildSourceRayIndices()
+    TArray<int32> SourceRayIndices;
+
+    //! Scan pattern hashes of this lidar & the source upon #BuildSourceRayIndices()
+    uint32 SourceRayIndicesHash = 0;
+    uint32 SourceScanPatternHash = 0;
+
     //! C++11 RNG for noise
     std::random_device Rng;
 
-    //! C++11 RNG for noise
+    //! C++11 RNG for visualization noise, only used on game thread
     std::mt19937 Gen = std::mt19937{Rng()};
 
-    std::normal_distribution<> GaussianRNGPosition;
-
     std::normal_distribution<> GaussianRNGIntensity;
 
+    //! Noise streams of a scan, each one keyed by (#ActiveNoiseSeed, #ScanIndex, stream)
+    enum class ENoiseStream : uint8
+    {
+        POSITION,
+        INTENSITY,
+        ECHO_POSITION
+    };
+
+    //! #NoiseSeed, or a seed derived from the master random seed if it is 0
+    uint32 ActiveNoiseSeed = 0;
+
+    //! Index of the latest prepared scan, incremented in #PrepareScan()
+    uint32 ScanIndex = 0;
+
+    //! Positional noise of the latest scan, 3 values per ray
+    TArray<float> PositionNoise;
+
+    //! Intensity noise of the latest scan, 1 value per ray
+    TArray<float> IntensityNoise;
+
+    /**
+     * @brief Generate a noise stream of the latest scan in parallel chunks, with #FRRNoiseUtils.
+     * The result only depends on #ActiveNoiseSeed, #ScanIndex & InStream, not on threads scheduling.
+     * @param InStream
+     * @param InMean
+     * @param InStdDev
+     * @param InNum
+     * @param OutNoise
+     */
+    void FillScanNoise(const ENoiseStream InStream,
+                       const float InMean,
+                       const float InStdDev,
+                       const int32 InNum,
+                       TArray<float>& OutNoise) const;
+
+    /**
+     * @brief Add #PositionNoise to #ScanHits points.
+     * Noise on the linetrace input would mean that the further the hit, the larger the error, while here the error is
+     * independent from distance.
+     */
+    void AddPositionNoise();
+
+    /**
+     * @brief Fill #IntensityNoise for the latest scan
+     */
+    void UpdateIntensityNoise()
+    {
+        FillScanNoise(ENoiseStream::INTENSITY, IntensityNoiseMean, IntensityNoiseVariance, ScanHits.Num(), IntensityNoise);
+    }
+
     FLinearColor InterpolateColor(float InX);
     static float GetIntensityFromDist(float InBaseIntensity, float InDistance);
+
+    //! Published intensity of hits without physical material & misses
+    virtual float GetNoSurfaceIntensity() const
+    {
+        return 0.f;
+    }
+
+    /**
+     * @brief Rebuild #IntensityTable from the intensity properties, only requesting physical materials from traces if
+     * intensities depend on them. Called by #PrepareScan().
+     */
+    void UpdateIntensityTable();
+
+    //! Intensity parameters of the upcoming scan
+    FRRLidarIntensityTable IntensityTable;
+
+    //! Created upon the first visualized scan
+    UPROPERTY(Transient)
+    URRLidarVisualizationComponent* VisualizationComponent = nullptr;
+
+    /**
+     * @brief Get the visualized intensity of a hit, from #IntensityTable & its distance
+     * @param InHit
+     * @param OutIntensity
+     * @return false if the surface type is not visualized
+     */
+    bool GetVisualizationIntensity(const FRRLidarHit& InHit, float& OutIntensity) const;
+
+    /**
+     * @brief Send the latest scan, decimated by #VisualizationDecimation, to #VisualizationComponent, or hide it
+     * @param bInShow
+     */
+    void UpdateVisualization(const bool bInShow);
 };
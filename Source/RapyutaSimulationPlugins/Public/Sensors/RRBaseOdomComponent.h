@@ -11,6 +11,7 @@
 
 // RapyutaSimulationPlugins
 #include "Core/RRActorCommon.h"
+#include "Core/RRNoiseUtils.h"
 #include "Sensors/RRROS2EntityStateSensorComponent.h"
 #include "Tools/SimulationState.h"
 
@@ -44,10 +45,15 @@ public:
     URRBaseOdomComponent();
 
     /**
-     * @brief Calculate relative pose with #URRGeneralUtils and update #Data
+     * @brief Calculate relative pose with #URRGeneralUtils and update #Data.
+     * If #bAggregatedTick, the update is deferred to the next #FRRDriveTickManager tick, updating all odoms in parallel.
      */
     virtual void SensorUpdate() override;
 
+    //! Add to #FRRDriveTickManager if #bAggregatedTick
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
     virtual void PreInitializePublisher(UROS2NodeComponent* InROS2Node, const FString& InTopicName) override;
 
     UPROPERTY(BlueprintReadWrite)
@@ -59,6 +65,11 @@ public:
     UPROPERTY(VisibleAnywhere, BlueprintReadWrite)
     bool bManualUpdate = false;
 
+    //! Ticked by the world's #FRRDriveTickManager along with all other odoms of its class, instead of by its own tick,
+    //! the odoms being updated in one ParallelFor across robots
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bAggregatedTick = false;
+
     UPROPERTY(VisibleAnywhere, BlueprintReadWrite)
     FROSOdom OdomData;
 
@@ -105,14 +116,10 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     FTransform RootOffset = FTransform::Identity;
 
-    //! C++11 RNG for odometry noise
-    std::random_device Rng;
-
-    //! C++11 RNG for odometry noise
-    std::mt19937 Gen = std::mt19937{Rng()};
-
-    std::normal_distribution<> GaussianRNGPosition;
-    std::normal_distribution<> GaussianRNGRotation;
+    //! Seed of #NoiseStream, derived from the master random seed & this component's path if 0, see
+    //! #FRRNoiseUtils::GetSensorSeed
+    UPROPERTY(EditAnywhere, Category = "Noise")
+    int32 NoiseSeed = 0;
 
     UPROPERTY(EditAnywhere, Category = "Noise")
     float NoiseMeanPos = 0.f;
@@ -133,6 +140,18 @@ public:
 protected:
     float LastUpdatedTime = 0.f;
 
+    //! Odometry noise, set up by #InitOdom
+    FRRNoiseStream NoiseStream;
+
+    //! Inverse of #InitialTransform's rotation, cached by #InitOdom
+    FQuat InitialRotationInverse = FQuat::Identity;
+
+    //! [s] Accumulated by #SensorUpdate if #bAggregatedTick, till #UpdatePendingOdom
+    float PendingOdomDeltaTime = 0.f;
+
+    //! #UpdateOdom, from #PendingOdomDeltaTime, being thread-safe across robots
+    static void UpdatePendingOdom(UActorComponent* InComponent);
+
     UPROPERTY()
     FTransform PreviousTransform = FTransform::Identity;
 
@@ -0,0 +1,94 @@
+/**
+ * @file RRCameraCaptureScheduler.h
+ * @brief Per-world scheduler which staggers & budgets the scene captures of all scheduled cameras.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// Native
+#include <mutex>
+
+// UE
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+
+class UWorld;
+class URRROS2CameraComponent;
+
+/**
+ * @brief Per-world camera capture scheduler.
+ * Cameras with #URRROS2CameraComponent::bScheduledCapture on:
+ * - are given evenly spread timer phases upon #URRROS2CameraComponent::Run(), so that cameras of the same rate are not
+ *   all due in the same frame,
+ * - only request their capture on their sensor timer. The requests of a frame are then served upon
+ *   [FWorldDelegates::OnWorldPostActorTick], by #URRROS2CameraComponent::CapturePriority then by waiting time, until
+ *   the summed #URRROS2CameraComponent::CaptureCostMs reach the rr.CameraCapture.GPUBudgetMs console variable. The
+ *   others are deferred to the next frame, at least one capture being served per frame.
+ * The readback copies & polls of all cameras captured in a frame are enqueued in a single render command.
+ *
+ * @sa [OnWorldPostActorTick](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/Engine/FWorldDelegates/OnWorldPostActorTick/)
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRCameraCaptureScheduler
+{
+public:
+    /**
+     * @brief Get the scheduler of a world, creating it upon the first fetching
+     *
+     * @param InWorld
+     * @return FRRCameraCaptureScheduler&
+     */
+    static FRRCameraCaptureScheduler& Get(UWorld* InWorld);
+
+    /**
+     * @brief Register a camera, to spread its timer phase against the others
+     *
+     * @param InCamera
+     * @return float Timer phase in [0, 1) of the camera's period
+     */
+    float AddCamera(URRROS2CameraComponent* InCamera);
+
+    /**
+     * @brief Unregister a camera & drop its pending request, eg upon its being stopped
+     *
+     * @param InCamera
+     */
+    void RemoveCamera(URRROS2CameraComponent* InCamera);
+
+    /**
+     * @brief Request a capture, to be served in the next #Flush() within the budget.
+     * A camera requesting again while its previous request is still deferred keeps a single request.
+     *
+     * @param InCamera
+     */
+    void RequestCapture(URRROS2CameraComponent* InCamera);
+
+    /**
+     * @brief Serve the pending requests within the budget, then batch their readbacks
+     */
+    void Flush();
+
+    int32 GetPendingCapturesNum() const
+    {
+        return PendingRequests.Num();
+    }
+
+private:
+    static TMap<UWorld*, TUniquePtr<FRRCameraCaptureScheduler>> SSchedulers;
+    static std::once_flag OnceFlag;
+
+    static void OnWorldPostActorTick(UWorld* InWorld, ELevelTick /*InTickType*/, float /*InDeltaSeconds*/);
+    static void OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/);
+
+    struct FCaptureRequest
+    {
+        TWeakObjectPtr<URRROS2CameraComponent> Camera;
+
+        //! GFrameCounter upon the request, to serve the longest waiting ones first among the same priority
+        uint64 RequestFrame = 0;
+    };
+
+    TArray<FCaptureRequest> PendingRequests;
+
+    TArray<TWeakObjectPtr<URRROS2CameraComponent>> Cameras;
+};
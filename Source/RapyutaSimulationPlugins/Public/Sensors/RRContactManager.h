@@ -0,0 +1,80 @@
+/**
+ * @file RRContactManager.h
+ * @brief Per-world dispatcher of Chaos collision events to the contact sensors of the colliding bodies.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// Native
+#include <mutex>
+
+// UE
+#include "CoreMinimal.h"
+
+class UPrimitiveComponent;
+class UWorld;
+class URRROS2ContactSensorComponent;
+
+namespace Chaos
+{
+struct FCollisionEventData;
+}
+
+/**
+ * @brief One contact of a sensor's body with another body, from a physics step's collision data, in UE units
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRContact
+{
+    TWeakObjectPtr<UPrimitiveComponent> Body;
+    TWeakObjectPtr<UPrimitiveComponent> OtherBody;
+    FVector Location = FVector::ZeroVector;
+    //! Pointing from the other body to #Body
+    FVector Normal = FVector::ZeroVector;
+    //! [kg.cm/s] Applied to #Body over the step
+    FVector Impulse = FVector::ZeroVector;
+    //! [cm]
+    float PenetrationDepth = 0.f;
+};
+
+/**
+ * @brief Registers a single Chaos collision event handler per world, instead of per-robot overlap queries or hit callbacks,
+ * and buckets each contact into the #URRROS2ContactSensorComponent owning either colliding body, eg a robot's bumper.
+ * Chaos dispatches the events on game thread after each physics step, thus buckets are plain arrays consumed by the
+ * sensors' own updates. Game thread only.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRContactManager
+{
+public:
+    ~FRRContactManager();
+
+    /**
+     * @brief Get the manager of a world, creating it upon the first fetching
+     * @param InWorld
+     * @return FRRContactManager* nullptr if the world has no Chaos solver
+     */
+    static FRRContactManager* Get(UWorld* InWorld);
+
+    /**
+     * @brief Bucket the contacts of a body into a sensor, enabling its rigid body collision notifications
+     * @param InBody
+     * @param InSensor
+     */
+    void AddBody(UPrimitiveComponent* InBody, URRROS2ContactSensorComponent* InSensor);
+
+    //! Stop bucketing all bodies of a sensor
+    void RemoveSensor(const URRROS2ContactSensorComponent* InSensor);
+
+private:
+    static void OnPostWorldCleanup(UWorld* InWorld, bool bInSessionEnded, bool bInCleanupResources);
+
+    void HandleCollisionEvents(const Chaos::FCollisionEventData& InEvent);
+
+    static TMap<UWorld*, TUniquePtr<FRRContactManager>> SManagers;
+    static std::once_flag OnceFlag;
+
+    TWeakObjectPtr<UWorld> World;
+
+    //! Sensor of each registered body
+    TMap<TWeakObjectPtr<UPrimitiveComponent>, TWeakObjectPtr<URRROS2ContactSensorComponent>> BodySensors;
+};
@@ -0,0 +1,85 @@
+/**
+ * @file RRImuSampleRing.h
+ * @brief IMU samples & the lock-free ring handing them off from the physics thread to the game thread.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// Native
+#include <atomic>
+
+// UE
+#include "CoreMinimal.h"
+
+/**
+ * @brief One IMU sample, taken at the end of a physics (sub)step, in UE units & the sensor frame
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRImuSample
+{
+    //! [s] World time
+    double Time = 0.;
+
+    //! [cm/s^2] Specific force, ie acceleration minus gravity, thus +Z of gravity magnitude at rest
+    FVector LinearAcceleration = FVector::ZeroVector;
+
+    //! [rad/s]
+    FVector AngularVelocity = FVector::ZeroVector;
+
+    //! Sensor orientation in world frame
+    FQuat Orientation = FQuat::Identity;
+};
+
+/**
+ * @brief Single-producer single-consumer ring of #FRRImuSample, written on physics thread & read on game thread without
+ * locking. Samples pushed while full are dropped & counted, the oldest unread ones being kept.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRImuSampleRing
+{
+public:
+    //! @param InCapacity Rounded up to a power of 2
+    explicit FRRImuSampleRing(const uint32 InCapacity = 1024)
+    {
+        Samples.SetNum(FMath::RoundUpToPowerOfTwo(FMath::Max(InCapacity, 2u)));
+        Mask = Samples.Num() - 1;
+    }
+
+    //! Producer only
+    bool Push(const FRRImuSample& InSample)
+    {
+        const uint32 head = Head.load(std::memory_order_relaxed);
+        if (head - Tail.load(std::memory_order_acquire) > Mask)
+        {
+            DroppedSamplesNum.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        Samples[head & Mask] = InSample;
+        Head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    //! Consumer only: append all unread samples to OutSamples
+    int32 PopAll(TArray<FRRImuSample>& OutSamples)
+    {
+        const uint32 tail = Tail.load(std::memory_order_relaxed);
+        const uint32 head = Head.load(std::memory_order_acquire);
+        for (uint32 i = tail; i != head; ++i)
+        {
+            OutSamples.Add(Samples[i & Mask]);
+        }
+        Tail.store(head, std::memory_order_release);
+        return static_cast<int32>(head - tail);
+    }
+
+    uint32 GetDroppedSamplesNum() const
+    {
+        return DroppedSamplesNum.load(std::memory_order_relaxed);
+    }
+
+private:
+    TArray<FRRImuSample> Samples;
+    uint32 Mask = 0;
+    std::atomic<uint32> Head = {0};
+    std::atomic<uint32> Tail = {0};
+    std::atomic<uint32> DroppedSamplesNum = {0};
+};
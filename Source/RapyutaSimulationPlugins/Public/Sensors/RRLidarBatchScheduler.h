@@ -0,0 +1,75 @@
+/**
+ * @file RRLidarBatchScheduler.h
+ * @brief Per-world scheduler which coalesces the scans of all batch-traced lidars due in the same frame.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// Native
+#include <mutex>
+
+// UE
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+
+class UWorld;
+class URRBaseLidarComponent;
+
+/**
+ * @brief Per-world lidar batch scheduler.
+ * Lidars with #URRBaseLidarComponent::bBatchTrace on only queue their scan on their sensor timer. All scans queued in a frame
+ * are then traced together in one ParallelFor over the total rays count, upon [FWorldDelegates::OnWorldPostActorTick],
+ * which is broadcast after the world's timers have been ticked.
+ * Each lidar's collision query params are built once in #URRBaseLidarComponent::Run() & shared by all its rays.
+ *
+ * @sa [OnWorldPostActorTick](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/Engine/FWorldDelegates/OnWorldPostActorTick/)
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRLidarBatchScheduler
+{
+public:
+    /**
+     * @brief Get the scheduler of a world, creating it upon the first fetching
+     *
+     * @param InWorld
+     * @return FRRLidarBatchScheduler&
+     */
+    static FRRLidarBatchScheduler& Get(UWorld* InWorld);
+
+    /**
+     * @brief Queue a lidar's scan to be traced in the next #Flush()
+     * A lidar being queued several times in a frame is only traced once.
+     *
+     * @param InLidar
+     */
+    void AddScan(URRBaseLidarComponent* InLidar);
+
+    /**
+     * @brief Remove a lidar's pending scan, eg upon its being stopped
+     *
+     * @param InLidar
+     */
+    void RemoveScan(URRBaseLidarComponent* InLidar);
+
+    /**
+     * @brief Trace all pending scans in a single batch, then let each lidar post-process its own scan
+     */
+    void Flush();
+
+    int32 GetPendingScansNum() const
+    {
+        return PendingLidars.Num();
+    }
+
+private:
+    static TMap<UWorld*, TUniquePtr<FRRLidarBatchScheduler>> SSchedulers;
+    static std::once_flag OnceFlag;
+
+    static void OnWorldPostActorTick(UWorld* InWorld, ELevelTick /*InTickType*/, float /*InDeltaSeconds*/);
+    static void OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/);
+
+    TArray<TWeakObjectPtr<URRBaseLidarComponent>> PendingLidars;
+
+    //! Rays num prefix sums of #PendingLidars, reused across flushes
+    TArray<int32> RayOffsets;
+};
@@ -0,0 +1,110 @@
+/**
+ * @file RRLidarDepthCapture.h
+ * @brief Depth capture faces layout & resampling of a lidar scanned with scene depth captures, instead of line traces.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+#include "RenderCommandFence.h"
+
+struct FRRLidarHit;
+
+/**
+ * @brief Layout of the perspective depth capture faces covering a lidar's FOV, together with the pixel sampled by each ray.
+ * The horizontal FOV is split into faces of at most 90 degrees, each one tall enough to cover the vertical FOV at its
+ * horizontal edges. The per-ray lookup table is built once per scan pattern, then each scan is resampled by #Resample().
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRLidarDepthCaptureLayout
+{
+    static constexpr float MAX_FACE_FOV = 90.f;
+
+    //! Sampled pixel of a ray, Face is INDEX_NONE if the ray is not covered by any face (eg near vertical)
+    struct FRaySample
+    {
+        int32 Face = INDEX_NONE;
+        int32 PixelX = 0;
+        int32 PixelY = 0;
+        //! 1 / ray forward component in face space, converting view depth to ray range
+        float InvForward = 0.f;
+    };
+
+    int32 FacesNum = 0;
+
+    //! [degrees] Horizontal FOV of each face
+    float FaceFOV = 0.f;
+
+    //! [degrees] Yaw of each face center, relative to the lidar
+    TArray<float> FaceYaws;
+
+    int32 Width = 0;
+    int32 Height = 0;
+    float TanHalfFOVH = 0.f;
+    float TanHalfFOVV = 0.f;
+
+    TArray<FRaySample> RaySamples;
+
+    /**
+     * @brief Build faces layout & the per-ray lookup table
+     * @param InStartAngle [degrees]
+     * @param InFOVHorizontal [degrees]
+     * @param InStartVerticalAngle [degrees]
+     * @param InFOVVertical [degrees]
+     * @param InWidth Horizontal resolution of each face
+     * @param InDirX, InDirY, InDirZ Sensor-local unit ray directions (SoA)
+     * @param InRaysNum
+     */
+    void Build(const float InStartAngle,
+               const float InFOVHorizontal,
+               const float InStartVerticalAngle,
+               const float InFOVVertical,
+               const int32 InWidth,
+               const float* InDirX,
+               const float* InDirY,
+               const float* InDirZ,
+               const int32 InRaysNum);
+
+    /**
+     * @brief Resample read-back depth (& optional surface class) faces into lidar hits, in parallel over rays.
+     * Normal alignment is estimated from the depth gradient around the sampled pixel.
+     * @param InDepth Per face scene depth [cm] in R
+     * @param InSurfaceClass Per face EPhysicalSurface index in R, or empty to classify all hits as SurfaceType_Default
+     * @param InMinRange [cm]
+     * @param InMaxRange [cm]
+     * @param InLidarPos World lidar location upon capture
+     * @param InDirX, InDirY, InDirZ World unit ray directions upon capture (SoA)
+     * @param OutHits
+     */
+    void Resample(const TArray<TArray<FLinearColor>>& InDepth,
+                  const TArray<TArray<FLinearColor>>& InSurfaceClass,
+                  const float InMinRange,
+                  const float InMaxRange,
+                  const FVector& InLidarPos,
+                  const float* InDirX,
+                  const float* InDirY,
+                  const float* InDirZ,
+                  TArray<FRRLidarHit>& OutHits) const;
+
+    /**
+     * @brief Get the face-space point seen by a pixel at a view depth
+     */
+    FORCEINLINE FVector3f GetFacePoint(const int32 InX, const int32 InY, const float InDepth) const
+    {
+        return InDepth * FVector3f(1.f,
+                                   (2.f * (InX + .5f) / Width - 1.f) * TanHalfFOVH,
+                                   (1.f - 2.f * (InY + .5f) / Height) * TanHalfFOVV);
+    }
+};
+
+/**
+ * @brief Pending GPU read-back of all faces of a lidar depth capture, completed once #RenderFence is.
+ */
+struct FRRLidarDepthReadback
+{
+    TArray<TArray<FLinearColor>> Depth;
+    TArray<TArray<FLinearColor>> SurfaceClass;
+    FRenderCommandFence RenderFence;
+    bool bInFlight = false;
+};
@@ -0,0 +1,100 @@
+/**
+ * @file RRLidarIntensityTable.h
+ * @brief Lookup table of lidar return intensity parameters per hit surface type.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "Chaos/ChaosEngineInterface.h"
+#include "CoreMinimal.h"
+
+#include "RRLidarIntensityTable.generated.h"
+
+struct FRRLidarHit;
+
+/**
+ * @brief Reflectivity of a physical surface type, see #URRBaseLidarComponent::SurfaceIntensities.
+ * A hit's intensity is Diffuse + Specular * its normal alignment, sharpened to the power of 32 for visualization.
+ */
+USTRUCT(BlueprintType)
+struct RAPYUTASIMULATIONPLUGINS_API FRRLidarSurfaceIntensity
+{
+    GENERATED_BODY()
+
+    //! Intensity independent from the incidence angle
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float Diffuse = 1000.f;
+
+    //! Extra intensity at normal incidence
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float Specular = 0.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bVisualized = true;
+};
+
+/**
+ * @brief Intensity parameters of all 256 #FRRLidarHit::SurfaceType values, so that intensities are computed with one
+ * lookup per hit instead of branching on surface types. Plain data, thus copied along hits to be used off game thread.
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRLidarIntensityTable
+{
+    static constexpr int32 SIZE = 256;
+
+    //! Hits evaluated per chunk by #Evaluate()
+    static constexpr int32 CHUNK_SIZE = 64;
+
+    /**
+     * @brief Build the table of the lidars' legacy surface classes, then override given surface types.
+     * SurfaceType_Default is non-reflective, SurfaceType1 retroreflective & SurfaceType2 reflective, other surface types
+     * have a zero intensity & are not visualized.
+     * @param InNonReflective
+     * @param InReflective
+     * @param InNoSurfaceIntensity Published intensity of hits without physical material & misses, visualized as non-reflective
+     * @param InSurfaces
+     */
+    void Build(const float InNonReflective,
+               const float InReflective,
+               const float InNoSurfaceIntensity,
+               const TMap<TEnumAsByte<EPhysicalSurface>, FRRLidarSurfaceIntensity>& InSurfaces);
+
+    //! Published intensity of a hit, without noise
+    FORCEINLINE float Get(const uint8 InSurfaceType, const float InNormalAlignment) const
+    {
+        return Diffuse[InSurfaceType] + Specular[InSurfaceType] * FMath::Clamp(InNormalAlignment, 0.f, 1.f);
+    }
+
+    /**
+     * @brief Evaluate the published intensities of hits in chunks, gathering their table entries first then scaling them by
+     * (1 + noise) in branchless loops.
+     * @param InHits
+     * @param InHitsStride Distance between consecutive hits, eg the echoes num for a given return of multi-echo hits
+     * @param InNoise Optional 1 relative noise per hit
+     * @param InNum
+     * @param OutIntensities InNum intensities
+     */
+    void Evaluate(const FRRLidarHit* InHits,
+                  const int32 InHitsStride,
+                  const float* InNoise,
+                  const int32 InNum,
+                  float* OutIntensities) const;
+
+    /**
+     * @brief Get the visualized base intensity of a hit, before distance attenuation
+     * @param InSurfaceType
+     * @param InNormalAlignment
+     * @param OutIntensity
+     * @return false if the surface type is not visualized
+     */
+    bool GetVisualized(const uint8 InSurfaceType, const float InNormalAlignment, float& OutIntensity) const;
+
+    //! Whether intensities depend on hits' surface types, ie whether traces need to return physical materials
+    bool bSurfaceDependent = true;
+
+    float Diffuse[SIZE] = {};
+    float Specular[SIZE] = {};
+    //! NaN for surface types not visualized
+    float VisualizedDiffuse[SIZE] = {};
+};
@@ -0,0 +1,82 @@
+/**
+ * @file RRLidarVisualizationComponent.h
+ * @brief Lidar scan visualization, drawn as a single point set updated in place each scan.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "Components/PrimitiveComponent.h"
+#include "CoreMinimal.h"
+
+#include "RRLidarVisualizationComponent.generated.h"
+
+/**
+ * @brief Visualized lidar point, colored on render thread
+ */
+struct FRRLidarVizPoint
+{
+    //! #Value of ray misses
+    static constexpr float MISS = -1.f;
+
+    //! [cm] World position
+    FVector3f Position = FVector3f::ZeroVector;
+
+    //! Intensity normalized in [0, 1] (possibly with visualization noise), or #MISS
+    float Value = MISS;
+};
+
+/**
+ * @brief Colors & sizes of visualized lidar points
+ */
+struct FRRLidarVizStyle
+{
+    FLinearColor ColorMin = FLinearColor::Red;
+    FLinearColor ColorMid = FLinearColor::Red;
+    FLinearColor ColorMax = FLinearColor::White;
+    FLinearColor ColorMiss = FLinearColor(1.f, .5f, 0.f);
+    float HitPointSize = 5.f;
+    float MissPointSize = 2.5f;
+
+    /**
+     * @brief Same mapping as #URRBaseLidarComponent::InterpolateColor(), without noise
+     * @param InValue Normalized intensity
+     * @return FLinearColor
+     */
+    FLinearColor GetColor(const float InValue) const
+    {
+        return (InValue > .5f) ? FLinearColor::LerpUsingHSV(ColorMid, ColorMax, 2 * InValue - 1)
+                               : FLinearColor::LerpUsingHSV(ColorMin, ColorMid, 2 * InValue);
+    }
+};
+
+/**
+ * @brief Draws the latest lidar scan as one point set owned by its scene proxy.
+ * Unlike drawing into the world PersistentLineBatcher, which accumulates one batched element per point until their
+ * lifetime expires & rebuilds its whole proxy upon every change, each scan here replaces the previous one in place,
+ * through a single render command in which the points' colors are also computed.
+ * Points are in world space, thus this component uses absolute transform.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class RAPYUTASIMULATIONPLUGINS_API URRLidarVisualizationComponent : public UPrimitiveComponent
+{
+    GENERATED_BODY()
+
+public:
+    URRLidarVisualizationComponent();
+
+    /**
+     * @brief Replace the visualized points
+     * @param InPoints
+     * @param InStyle
+     */
+    void SetPoints(TArray<FRRLidarVizPoint>&& InPoints, const FRRLidarVizStyle& InStyle);
+
+    virtual FPrimitiveSceneProxy* CreateSceneProxy() override;
+    virtual FBoxSphereBounds CalcBounds(const FTransform& LocalToWorld) const override;
+
+protected:
+    //! World bounds of the latest points
+    FBox PointsBounds = FBox(ForceInit);
+};
@@ -80,7 +80,9 @@ public:
     virtual void SensorUpdate() override;
 
     /**
-     * @brief Update reference actor to the nearest one along Z axis with tag
+     * @brief Update reference actor to the nearest one along Z axis with tag, with
+     * ASimulationState::FindNearestTaggedEntityAlongZ(). Skipped while the sensor stays within the current reference's
+     * floor boundaries & the sim state's tagged entities have not changed.
      */
     UFUNCTION(BlueprintCallable)
     virtual void UpdateReferenceActorWithTag();
@@ -102,6 +104,14 @@ public:
     URRROS2EntityStateSensorComponent* MapOriginPoseSensor = nullptr;
 
 protected:
+    //! Z range within which #ReferenceActor stays the nearest tagged actor
+    float ReferenceMinZ = 0.f;
+    float ReferenceMaxZ = 0.f;
+
+    //! ASimulationState::GetTaggedEntitiesVersion() & #ReferenceTag upon the latest search, 0 if none
+    uint32 ReferenceSearchVersion = 0;
+    FString ReferenceSearchTag;
+
     /**
      * @brief Callback on component creation to setup SetIsReplicated()
      */
@@ -14,6 +14,7 @@
 #include "ROS2Publisher.h"
 
 // RapyutaSimulationPlugins
+#include "Sensors/RRSensorStats.h"
 #include "Tools/RRROS2BaseSensorPublisher.h"
 
 #include "RRROS2BaseSensorComponent.generated.h"
@@ -22,6 +23,30 @@ DECLARE_LOG_CATEGORY_EXTERN(LogROS2Sensor, Log, All);
 
 #define TRACE_ASYNC 1
 
+/**
+ * @brief Priority class of sensors scheduled by #FRRSensorScheduler
+ */
+UENUM(BlueprintType)
+enum class ERRSensorPriority : uint8
+{
+    HIGH UMETA(DisplayName = "High", ToolTip = "Always updated when due, regardless of the CPU budget."),
+    NORMAL UMETA(DisplayName = "Normal"),
+    LOW UMETA(DisplayName = "Low", ToolTip = "Updated last, thus deferred first when over the CPU budget.")
+};
+
+/**
+ * @brief Importance of a sensor's rate, lower tiers being slowed down first by #FRRSensorScheduler when the sim falls behind
+ * its target RTF
+ */
+UENUM(BlueprintType)
+enum class ERRSensorOverloadTier : uint8
+{
+    SAFETY UMETA(DisplayName = "Safety", ToolTip = "Never slowed down, eg safety scanners."),
+    NAVIGATION UMETA(DisplayName = "Navigation"),
+    PERCEPTION UMETA(DisplayName = "Perception"),
+    VISUALIZATION UMETA(DisplayName = "Visualization", ToolTip = "Slowed down first.")
+};
+
 /**
  * @brief Base ROS 2 Sensor Component class. Other sensors class should inherit from this class.
  * Provide features to initialize with [UROS2NodeComponent](https://rclue.readthedocs.io/en/devel/doxygen_generated/html/d1/d79/_r_o_s2_node_component_8h.html)
@@ -86,7 +111,9 @@ public:
     virtual void InitializePublisher(UROS2NodeComponent* InROS2Node, const UROS2QoS InQoS = UROS2QoS::SensorData);
 
     /**
-     * @brief Start timer to update and publish sensor data by using SetTimer
+     * @brief Start timer to update and publish sensor data by using SetTimer,
+     * or add this sensor to #FRRSensorScheduler if #bFrameScheduled.
+     * Also starts the publisher's async publishing if #bAsyncPublish.
      * @sa [SetTimer](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/FTimerManager/SetTimer/4/)
      *
      */
@@ -110,6 +137,15 @@ public:
         checkNoEntry();
     }
 
+    /**
+     * @brief Call #SensorUpdate() in a RRSensor trace scope & record its duration into #Stats.
+     * Called by the sensor timer & #FRRSensorScheduler.
+     */
+    void TimedSensorUpdate();
+
+    //! Num of periods skipped by #FRRSensorScheduler & of msgs dropped by the async handoff
+    int32 GetDroppedFramesNum() const;
+
     /**
      * @brief Set sensor data to ROS 2 msg. This method should be overwritten by child class.
      */
@@ -119,6 +155,39 @@ public:
         checkNoEntry();
     }
 
+    /**
+     * @brief Provide a builder snapshotting the latest sensor data, used by #URRROS2BaseSensorPublisher::HandOff().
+     * Sensors not overriding this are published on game thread with #SetROS2Msg.
+     *
+     * @param OutBuilder
+     * @return true if a builder is provided
+     */
+    virtual bool GetROS2MsgBuilder(FRRROS2MsgBuilder& OutBuilder)
+    {
+        return false;
+    }
+
+    /**
+     * @brief Write the latest sensor data in place into a msg loaned from the RMW, used by
+     * #URRROS2BaseSensorPublisher::bLoanMessages. Sensors not overriding this are published regularly with #SetROS2Msg.
+     *
+     * @param InLoanedMsg RMW-owned msg of the publisher's msg type, eg a sensor_msgs__msg__Image
+     * @return true if written
+     */
+    virtual bool WriteLoanedROS2Msg(void* InLoanedMsg)
+    {
+        return false;
+    }
+
+    /**
+     * @brief Whether the data has changed enough to be published, checked by #URRROS2BaseSensorPublisher::HandOff(), thus
+     * only for sensors publishing by #URRROS2BaseSensorPublisher::StartTimerPublishing() or async.
+     */
+    virtual bool HasDataToPublish() const
+    {
+        return true;
+    }
+
     UPROPERTY()
     TSubclassOf<UROS2Publisher> SensorPublisherClass = URRROS2BaseSensorPublisher::StaticClass();
 
@@ -141,7 +210,58 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadOnly)
     bool bIsValid = true;
 
+    //! Build & publish the msgs on #FRRROS2PublisherThread, see #URRROS2BaseSensorPublisher::StartAsyncPublishing()
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bAsyncPublish = false;
+
+    //! Only update & publish while #SensorPublisher has matched subscribers, checked every #OnDemandCheckInterval
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scheduling")
+    bool bOnDemand = false;
+
+    //! [s]
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scheduling", meta = (ClampMin = "0.01"))
+    float OnDemandCheckInterval = 1.f;
+
+    //! Stopped by #bOnDemand for having no subscriber
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Scheduling")
+    bool bPausedOnDemand = false;
+
+    //! Update by #FRRSensorScheduler at exact multiples of the period in simulation time, instead of by own timer
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scheduling")
+    bool bFrameScheduled = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scheduling")
+    ERRSensorPriority SchedulePriority = ERRSensorPriority::NORMAL;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Scheduling")
+    ERRSensorOverloadTier OverloadTier = ERRSensorOverloadTier::PERCEPTION;
+
+    //! Ratio of #PublicationFrequencyHz currently scheduled by #FRRSensorScheduler, below 1 while its tier is slowed down
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Scheduling")
+    float OverloadRateScale = 1.f;
+
+    float GetEffectiveFrequencyHz() const
+    {
+        return OverloadRateScale * static_cast<float>(PublicationFrequencyHz);
+    }
+
+    //! Num of frames a due update was deferred by #FRRSensorScheduler, for being over budget
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Scheduling")
+    int32 DeferredUpdatesNum = 0;
+
+    //! Num of periods elapsed without any update by #FRRSensorScheduler, eg upon long frames
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Scheduling")
+    int32 SkippedUpdatesNum = 0;
+
+    //! Shared with #FRRROS2PublisherThread, which records the async publishes, see rr.SensorStats console command
+    TSharedPtr<FRRSensorStats> Stats;
+
 protected:
     UPROPERTY()
     FTimerHandle TimerHandle;
+
+    //! Resume or pause this sensor by #Run or #Stop upon #SensorPublisher's subscribers appearing or being gone
+    void CheckSubscribers();
+
+    FTimerHandle OnDemandTimerHandle;
 };
@@ -1,16 +1,19 @@
 /**
  * @file RRROS2CameraComponent.h
  * @brief ROS 2 Camera component
- * @todo Support non RGB data support.
  * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
  */
 
 #pragma once
 
+// std
+#include <atomic>
+
 #include "Camera/CameraComponent.h"
 #include "Components/SceneCaptureComponent2D.h"
 #include "CoreMinimal.h"
 #include "Engine/TextureRenderTarget2D.h"
+#include "RHIGPUReadback.h"
 
 // rclUE
 #include <Msgs/ROS2Img.h>
@@ -21,30 +24,109 @@
 
 #include "RRROS2CameraComponent.generated.h"
 
+struct FRRSensorCameraInfo;
+
 /**
- * @brief
- * used in　#CaptureNonBlocking of #URRROS2CameraComponent
+ * @brief Scene capture quality settings of #URRROS2CameraComponent, applied consistently to all its captures.
+ * Built-in profiles: "perception-fast", disabling the features most perception workloads do not need, & "photoreal".
  */
-USTRUCT()
-struct FRenderRequest
+USTRUCT(BlueprintType)
+struct RAPYUTASIMULATIONPLUGINS_API FRRCameraCaptureProfile
 {
     GENERATED_BODY()
-    TArray<FColor> Image;
-    FRenderCommandFence RenderFence;
+
+    //! Names of the show flags to disable, as in FEngineShowFlags, eg MotionBlur, Bloom, Translucency
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<FString> DisabledShowFlags;
+
+    //! Override the capture's post process settings with #PostProcessSettings
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bOverridePostProcess = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (EditCondition = "bOverridePostProcess"))
+    FPostProcessSettings PostProcessSettings;
+
+    //! Scales the distances at which LODs are selected, > 1 selecting coarser LODs
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "0.01"))
+    float LODDistanceFactor = 1.f;
+
+    //! Captures are normally triggered by the camera's sensor timer only
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bCaptureEveryFrame = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bCaptureOnMovement = false;
+
+    /**
+     * @brief Get a built-in profile
+     * @param InName "perception-fast" or "photoreal"
+     * @param OutProfile
+     * @return false if InName is not a built-in profile
+     */
+    static bool GetBuiltinProfile(const FString& InName, FRRCameraCaptureProfile& OutProfile);
+
+    /**
+     * @brief Apply to a scene capture
+     * @param InCapture
+     * @param bInPostProcess Whether to apply #PostProcessSettings, eg not to captures rendering through their own material
+     */
+    void Apply(USceneCaptureComponent2D* InCapture, const bool bInPostProcess) const;
+};
+
+/**
+ * @brief What #URRROS2CameraComponent does with a new capture once all its readback slots are pending
+ */
+UENUM(BlueprintType)
+enum class ERRCameraQueuePolicy : uint8
+{
+    DROP_OLDEST UMETA(DisplayName = "Drop oldest", ToolTip = "Drop the oldest pending capture, for the lowest latency."),
+    DROP_NEWEST UMETA(DisplayName = "Drop newest", ToolTip = "Skip the new capture, keeping the pending ones."),
+    BLOCK UMETA(DisplayName = "Block", ToolTip = "Wait for the oldest readback to complete. No frame is dropped.")
+};
+
+/**
+ * @brief Recycled slot of the #URRROS2CameraComponent readback ring, used in　#CaptureNonBlocking.
+ * #Readback and the RT-suffixed members are only accessed on render thread.
+ */
+struct FRenderRequest
+{
+    //! Read back pixels in the target encoding, written on render thread once #Readback is ready.
+    //! Swapped with the msg data upon consumption, thus both buffers are reused across captures.
+    TArray<uint8> Image;
+
+    //! Staging buffer the render target is copied into, without stalling the render thread
+    TUniquePtr<FRHIGPUTextureReadback> Readback;
+
+    //! Staging buffer of the auxiliary outputs render target, null if none is enabled
+    TUniquePtr<FRHIGPUTextureReadback> AuxReadback;
+
+    //! Auxiliary output images (depth, segmentation, normals) in their msg encoding, swapped like #Image
+    TArray<uint8> AuxImages[3];
+
+    //! Game thread: id of the capture this slot was last requested for
+    uint32 CaptureId = 0;
+
+    //! Id of the capture #Image holds, published by render thread after #Image is written
+    std::atomic<uint32> ReadyCaptureId = {0};
+
+    uint32 CaptureIdRT = 0;
+    bool bPendingRT = false;
 };
 
 /**
  * @brief ROS 2 Camera component. Uses USceneCaptureComponent2D.
+ * Depth, segmentation & normals outputs are all rendered by a single auxiliary capture, see #AuxOutputsMaterial, and
+ * read back together with the color image, each one published by its own #URRROS2ImagePublisher.
  *
  * @sa [USceneCaptureComponent2D](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/Components/USceneCaptureComponent2D/)
  * @sa [UE4 ShaderInPlugin](https://docs.unrealengine.com/5.1/en-US/ProgrammingAndScripting/Rendering/ShaderInPlugin/Overview/)
  * @sa implementation reference: https://github.com/TimmHess/UnrealImageCapture
- * @todo Support non RGB data support.
  */
 UCLASS(ClassGroup = (Custom), Blueprintable, meta = (BlueprintSpawnableComponent))
 class RAPYUTASIMULATIONPLUGINS_API URRROS2CameraComponent : public URRROS2BaseSensorComponent
 {
     GENERATED_BODY()
+    friend class FRRMicroBenchmarks;
 
 public:
     /**
@@ -53,8 +135,15 @@ public:
      */
     URRROS2CameraComponent();
 
+    /**
+     * @brief Also create a publisher per enabled auxiliary output
+     * @param InPublisherName
+     */
+    virtual void CreatePublisher(const FString& InPublisherName = TEXT("")) override;
+
     /**
      * @brief Initialize #Data and #RenderTarget, set #SceneCaptureComponent parameters.
+     * Also create #AuxCaptureComponent if any auxiliary output is enabled.
      *
      * @param InROS2Node ROS2Node which this publisher belongs to
      * @param InTopicName
@@ -62,26 +151,260 @@ public:
     virtual void PreInitializePublisher(UROS2NodeComponent* InROS2Node, const FString& InTopicName) override;
 
     /**
-     * @brief Update sensor data by CaptureScene and #CaptureNonBlocking
+     * @brief Also initialize #AuxPublishers
+     * @param InROS2Node
+     * @param InQoS
+     */
+    virtual void InitializePublisher(UROS2NodeComponent* InROS2Node, const UROS2QoS InQoS) override;
+
+    /**
+     * @brief Start the sensor timer, phase-shifted by #FRRCameraCaptureScheduler if #bScheduledCapture
+     */
+    virtual void Run() override;
+
+    /**
+     * @brief Stop the sensor timer & drop any capture request pending in #FRRCameraCaptureScheduler
+     */
+    virtual void Stop() override;
+
+    /**
+     * @brief Update sensor data by CaptureScene and #CaptureNonBlocking,
+     * or only request the capture to #FRRCameraCaptureScheduler if #bScheduledCapture.
      * @sa [CaptureScene](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/Components/USceneCaptureComponent2D/CaptureScene/)
      * @todo Should #CaptureNonBlocking called in TickComponents?
      */
     virtual void SensorUpdate() override;
 
+    //! [bytes] Held by the CPU-side images of #RenderRequests, read back staging buffers excluded.
+    //! Approximate while captures are in flight, their images being resized on render thread.
+    int64 GetRenderRequestsAllocatedSize() const;
+
+    //! [bytes] Held by the image msgs data, ie #Data & #AuxData
+    int64 GetMsgDataAllocatedSize() const;
+
+    //! Num of pending captures in the readback ring
+    int32 GetQueuedRenderRequestsNum() const
+    {
+        return QueueCount;
+    }
+
+    /**
+     * @brief Readback copy of a capture into its #FRenderRequest, see #EnqueueReadbackCopy()
+     */
+    struct FReadbackCopy
+    {
+        FTextureRenderTargetResource* RenderTargetResource = nullptr;
+        FTextureRenderTargetResource* AuxRenderTargetResource = nullptr;
+        FRenderRequest* RenderRequest = nullptr;
+        uint32 CaptureId = 0;
+
+        //! Region of the render target to copy, eg the camera's tile of its atlas, empty for the whole target
+        FIntRect SourceRect;
+    };
+
+    //! Pixel encodings converted from the B8G8R8A8 render target
+    enum class EImageEncoding : uint8
+    {
+        RGB8,
+        BGR8,
+        MONO8
+    };
+
+    /**
+     * @brief Snapshot of the readback ring & conversion params, polled on render thread by #PollReadbacks_RenderThread()
+     */
+    struct FReadbackPoll
+    {
+        TArray<FRenderRequest*, TInlineAllocator<4>> RenderRequests;
+        int32 Width = 0;
+        int32 Height = 0;
+        EImageEncoding Encoding = EImageEncoding::RGB8;
+        bool bDepth16 = false;
+        TStaticArray<int32, 3> AuxBytesPerPixel = TStaticArray<int32, 3>(InPlace, 0);
+    };
+
+    /**
+     * @brief Capture the color & auxiliary scenes, without reading them back
+     */
+    virtual void CaptureScenes();
+
+    /**
+     * @brief Reserve the next slot of #RenderRequests for a new capture, applying #QueuePolicy if all are pending
+     * @param OutCopy
+     * @return false if the capture is dropped
+     */
+    bool BeginReadback(FReadbackCopy& OutCopy);
+
+    virtual FReadbackPoll MakeReadbackPoll() const;
+
+    static void EnqueueReadbackCopy_RenderThread(FRHICommandListImmediate& RHICmdList, const FReadbackCopy& InCopy);
+
+    /**
+     * @brief Render all cameras of the atlas led by this one as views of a single scene render, then begin the readbacks
+     * of their tiles. Atlas leaders only.
+     * @param OutCopies Readback copies of the cameras whose capture is not dropped
+     * @param OutPolls Readback polls of all cameras
+     */
+    void CaptureAtlas(TArray<FReadbackCopy>& OutCopies, TArray<FReadbackPoll>& OutPolls);
+
+    //! Whether this camera is captured by the leader of its #AtlasGroup
+    bool IsAtlasMember() const
+    {
+        return AtlasLeader.IsValid() && (AtlasLeader.Get() != this);
+    }
+
+    //! Whether this camera renders the atlas of its #AtlasGroup, itself being its first tile
+    bool IsAtlasLeader() const
+    {
+        return AtlasMembers.Num() > 0;
+    }
+
+    /**
+     * @brief Copy the ready readbacks to their #FRenderRequest::Image, converted to the target encoding
+     * @param InPoll
+     */
+    static void PollReadbacks_RenderThread(const FReadbackPoll& InPoll);
+
 protected:
     /**
-     * @brief Capture data by notifing task in #RenderRequestQueue
+     * @brief Join the atlas of the first running camera of the owner with the same #AtlasGroup, or lead a new one.
+     * Called by #Run().
+     */
+    void ResolveAtlasGroup();
+
+    /**
+     * @brief Leave the atlas, restoring this camera's own render target. A leaving leader hands its other members over to
+     * a new leader amongst them.
+     */
+    void LeaveAtlas();
+
+    /**
+     * @brief Add a compatible camera to the atlas led by this one & update the layout
+     * @param InMember
+     * @return false if InMember's image size differs or it has auxiliary outputs
+     */
+    bool AddAtlasMember(URRROS2CameraComponent* InMember);
+
+    /**
+     * @brief Lay #AtlasMembers out as a grid of tiles in a new #AtlasRenderTarget, set as their capture target
+     */
+    void UpdateAtlasLayout();
+
+    /**
+     * @brief Render one view per atlas member into its tile of #AtlasRenderTarget, with a single scene render
+     */
+    void RenderAtlas();
+
+    //! View of #RenderSceneViews(), rendered with the settings of Capture from Location
+    struct FSceneViewTile
+    {
+        const USceneCaptureComponent2D* Capture = nullptr;
+        FVector Location = FVector::ZeroVector;
+        FIntRect Rect;
+    };
+
+    /**
+     * @brief Render perspective views into their tiles of a render target, as one scene view family, ie with a single
+     * scene update & render setup. The family show flags & capture source are #SceneCaptureComponent's.
+     * @param InRenderTarget
+     * @param InTiles
+     */
+    void RenderSceneViews(UTextureRenderTarget2D* InRenderTarget, TArrayView<const FSceneViewTile> InTiles);
+
+    //! Leader of this camera's atlas, itself if leading it
+    TWeakObjectPtr<URRROS2CameraComponent> AtlasLeader;
+
+    //! Cameras of the atlas led by this one, itself first. Empty if not leading any.
+    TArray<TWeakObjectPtr<URRROS2CameraComponent>> AtlasMembers;
+
+    //! This camera's tile in its atlas, empty if not in any
+    FIntRect AtlasRect;
+
+    /**
+     * @brief Flush the render commands referencing #RenderRequests & return the render targets
+     */
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    /**
+     * @brief Return #RenderTarget & #AuxRenderTarget to #FRRRenderTargetPool
+     */
+    void ReturnRenderTargets();
+
+    /**
+     * @brief Capture data by enqueuing a GPU readback into the next slot of #RenderRequests, dropping the oldest
+     * pending capture if the ring is full.
      * @sa reference https://github.com/TimmHess/UnrealImageCapture
      */
     UFUNCTION()
     void CaptureNonBlocking();
 
-    //!
-    TQueue<FRenderRequest*> RenderRequestQueue;
+    /**
+     * @brief Convert a row of B8G8R8A8 pixels to an encoding
+     * @param InSrc
+     * @param OutDst InNum * #GetChannelsNum(InEncoding) bytes
+     * @param InNum Num of pixels
+     * @param InEncoding
+     */
+    static void ConvertPixels(const FColor* InSrc, uint8* OutDst, const int32 InNum, const EImageEncoding InEncoding);
+
+    static int32 GetChannelsNum(const EImageEncoding InEncoding)
+    {
+        return (InEncoding == EImageEncoding::MONO8) ? 1 : 3;
+    }
+
+    //! Parsed from #Encoding in #PreInitializePublisher()
+    EImageEncoding ImageEncoding = EImageEncoding::RGB8;
+
+    FORCEINLINE static int32 GetAuxOutputIndex(const ERRCameraOutput InOutput)
+    {
+        return static_cast<int32>(InOutput) - static_cast<int32>(ERRCameraOutput::DEPTH);
+    }
+
+    /**
+     * @brief Convert a row of auxiliary outputs pixels, R: scene depth [cm], G: stencil, B & A: octahedral world normal
+     * @param InSrc
+     * @param InNum Num of pixels
+     * @param InRow
+     * @param bInDepth16 16UC1 [mm] depth instead of 32FC1 [m]
+     * @param OutAuxImages Enabled ones are sized for the whole image
+     */
+    static void ConvertAuxPixels(const FLinearColor* InSrc,
+                                 const int32 InNum,
+                                 const int32 InRow,
+                                 const bool bInDepth16,
+                                 TArray<uint8> (&OutAuxImages)[3]);
+
+    //! Auxiliary outputs msgs, indexed by #GetAuxOutputIndex()
+    FROSImg AuxData[3];
+
+    /**
+     * @brief Swap the oldest pending capture into #Data & recycle its slot, if its readback is done
+     * @return true if consumed
+     */
+    bool ConsumeRenderRequest();
+
+    /**
+     * @brief Enqueue a render command polling the pending readbacks, without blocking.
+     * The ready ones are copied to their #FRenderRequest::Image, to be consumed by a later #GetROS2Data().
+     */
+    void PollReadbacks();
+
+    //! Ring of #QueueSize readback slots, allocated once in #PreInitializePublisher()
+    TArray<TUniquePtr<FRenderRequest>> RenderRequests;
+
+    //! Index of the oldest pending capture in #RenderRequests
+    int32 RenderRequestHead = 0;
+
+    //! Id of the latest capture
+    uint32 LastCaptureId = 0;
 
     //!
     FROSImg Data;
 
+    //! Id of the capture held in #Data
+    uint32 DataCaptureId = 0;
+
+    //! Num of pending captures in #RenderRequests
     int32 QueueCount = 0;
 
 public:
@@ -92,9 +415,116 @@ public:
     UPROPERTY(VisibleAnywhere, BlueprintReadWrite)
     USceneCaptureComponent2D* SceneCaptureComponent = nullptr;
 
+    //! Leased from #FRRRenderTargetPool
     UPROPERTY(VisibleAnywhere, BlueprintReadWrite)
     UTextureRenderTarget2D* RenderTarget = nullptr;
 
+    //! Renders all auxiliary outputs in a single pass, only created if any is enabled
+    UPROPERTY(VisibleAnywhere, BlueprintReadWrite)
+    USceneCaptureComponent2D* AuxCaptureComponent = nullptr;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadWrite)
+    UTextureRenderTarget2D* AuxRenderTarget = nullptr;
+
+    //! Render target of the atlas led by this camera, leased from #FRRRenderTargetPool
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    UTextureRenderTarget2D* AtlasRenderTarget = nullptr;
+
+    //! Publishers of the enabled auxiliary outputs
+    UPROPERTY(Transient)
+    TArray<URRROS2ImagePublisher*> AuxPublishers;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Outputs")
+    bool bPublishDepth = false;
+
+    //! 32FC1 [m] or 16UC1 [mm]
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Outputs")
+    FString DepthEncoding = TEXT("32FC1");
+
+    //! Custom depth stencil values, eg set by ARRMeshActor::SetCustomDepthStencilValue(). Requires #AuxOutputsMaterial.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Outputs")
+    bool bPublishSegmentation = false;
+
+    //! Requires #AuxOutputsMaterial
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Outputs")
+    bool bPublishNormals = false;
+
+    //! Post-process material, blended replacing the tonemapper, packing SceneDepth [cm] into R, CustomStencil into G & the
+    //! octahedral-encoded world normal into B & A. Without it, #AuxCaptureComponent only captures SCS_SceneDepth.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Outputs")
+    UMaterialInterface* AuxOutputsMaterial = nullptr;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Outputs")
+    FString DepthTopicName = TEXT("depth");
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Outputs")
+    FString SegmentationTopicName = TEXT("segmentation");
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Outputs")
+    FString NormalsTopicName = TEXT("normals");
+
+    //! Also publish the color image as sensor_msgs/CompressedImage, by a #URRROS2CompressedImagePublisher
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Outputs")
+    bool bPublishCompressed = false;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Outputs")
+    FString CompressedTopicName = TEXT("compressed_image");
+
+    /**
+     * @brief Whether an output is published, segmentation & normals requiring #AuxOutputsMaterial
+     * @param InOutput
+     * @return true
+     * @return false
+     */
+    bool IsOutputEnabled(const ERRCameraOutput InOutput) const;
+
+    bool IsDepth16() const
+    {
+        return DepthEncoding.Equals(TEXT("16UC1"));
+    }
+
+    /**
+     * @brief Get bytes per pixel of an auxiliary output msg, 0 if disabled
+     * @param InOutput
+     * @return int32
+     */
+    int32 GetAuxBytesPerPixel(const ERRCameraOutput InOutput) const;
+
+    bool HasAuxOutputs() const
+    {
+        return IsOutputEnabled(ERRCameraOutput::DEPTH) || IsOutputEnabled(ERRCameraOutput::SEGMENTATION) ||
+               IsOutputEnabled(ERRCameraOutput::NORMALS);
+    }
+
+    /**
+     * @brief Set an auxiliary output msg, updated with the color one, to InMessage
+     * @param InOutput
+     * @param InMessage
+     */
+    void SetOutputROS2Msg(const ERRCameraOutput InOutput, UROS2GenericMsg* InMessage);
+
+    //! Name of a #CustomCaptureProfiles or built-in #FRRCameraCaptureProfile, applied in #PreInitializePublisher().
+    //! Empty to keep the scene capture settings as they are.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
+    FString CaptureProfileName;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
+    TMap<FString, FRRCameraCaptureProfile> CustomCaptureProfiles;
+
+    /**
+     * @brief Find a capture profile by name, in #CustomCaptureProfiles then the built-in ones
+     * @param InName
+     * @param OutProfile
+     * @return true if found
+     */
+    bool FindCaptureProfile(const FString& InName, FRRCameraCaptureProfile& OutProfile) const;
+
+    /**
+     * @brief Set capture profile & image size from URDF/SDF sensor properties, before #PreInitializePublisher()
+     * @param InCameraInfo
+     */
+    void SetCameraInfo(const FRRSensorCameraInfo& InCameraInfo);
+
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     int32 Width = 640;
 
@@ -104,6 +534,41 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     int32 QueueSize = 2;
 
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    ERRCameraQueuePolicy QueuePolicy = ERRCameraQueuePolicy::DROP_OLDEST;
+
+    //! Num of captures dropped since all readback slots were pending, by #ERRCameraQueuePolicy::DROP_OLDEST or DROP_NEWEST
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    int32 DroppedFramesNum = 0;
+
+    //! Num of captures which waited for a readback slot, by #ERRCameraQueuePolicy::BLOCK
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    int32 BlockedFramesNum = 0;
+
+    //! Request captures to #FRRCameraCaptureScheduler, which staggers & budgets the captures of all scheduled cameras &
+    //! batches their readbacks, instead of capturing on this component's own sensor timer.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
+    bool bScheduledCapture = false;
+
+    //! Higher priority requests are served first by #FRRCameraCaptureScheduler when over budget
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
+    int32 CapturePriority = 0;
+
+    //! [ms] Estimated GPU cost of a capture, counted against the rr.CameraCapture.GPUBudgetMs budget
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture", meta = (ClampMin = "0"))
+    float CaptureCostMs = 1.f;
+
+    //! Cameras of the same owner in the same non-None group, with the same image size & without auxiliary outputs, are
+    //! rendered as tiles of a single atlas render target, as views of one scene render sharing its per-frame setup, by
+    //! the first running one. Their tiles are then read back separately into their own msgs. Suited to many small
+    //! cameras, whose per-capture overhead dominates. Perspective cameras only.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Capture")
+    FName AtlasGroup = NAME_None;
+
+    //! Num of frames a scheduled capture was deferred by #FRRCameraCaptureScheduler, for being over budget
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Capture")
+    int32 DeferredFramesNum = 0;
+
     // ROS
     /**
      * @brief Update ROS 2 Msg structure from #RenderRequestQueue
@@ -114,12 +579,32 @@ public:
     virtual FROSImg GetROS2Data();
 
     /**
-     * @brief Set result of #GetROS2Data to InMessage.
+     * @brief Set #Data, updated as in #GetROS2Data, to InMessage without intermediate copy, written in place by
+     * #FRRROS2MsgWriter into the msg's data buffer kept from the previous publish.
      *
      * @param InMessage
      */
     virtual void SetROS2Msg(UROS2GenericMsg* InMessage) override;
 
+    /**
+     * @brief Consume the oldest completed capture into #Data & poll the pending readbacks
+     * @return true if a new capture was consumed
+     */
+    virtual bool UpdateImageMsg();
+
+    //! Latest consumed color image
+    const FROSImg& GetImageMsg() const
+    {
+        return Data;
+    }
+
+    //! Id of the capture held by #GetImageMsg(), 0 if none
+    uint32 GetImageMsgCaptureId() const
+    {
+        return DataCaptureId;
+    }
+
+    //! rgb8, bgr8 or mono8
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     FString Encoding = TEXT("rgb8");
 };
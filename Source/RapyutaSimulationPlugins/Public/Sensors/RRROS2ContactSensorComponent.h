@@ -0,0 +1,59 @@
+/**
+ * @file RRROS2ContactSensorComponent.h
+ * @brief Contact/bumper sensor component, fed by the world's #FRRContactManager & published as gazebo_msgs/ContactsState.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+// rclUE
+#include "Msgs/ROS2ContactsState.h"
+
+// RapyutaSimulationPlugins
+#include "Sensors/RRContactManager.h"
+#include "Sensors/RRROS2BaseSensorComponent.h"
+
+#include "RRROS2ContactSensorComponent.generated.h"
+
+/**
+ * @brief Contact sensor of the owner's bodies, eg a robot's bumper, without any overlap query.
+ * Contacts are bucketed into #PendingContacts by #FRRContactManager after each physics step, then each update groups them
+ * per pair of colliding bodies into one ContactState, with positions, normals & depths in this sensor's frame and the
+ * wrench as the mean force over the update period. States are published at #PublicationFrequencyHz, empty if no contact.
+ * @sa [gazebo_msgs/ContactsState](https://github.com/ros-simulation/gazebo_ros_pkgs/blob/ros2/gazebo_msgs/msg/ContactsState.msg)
+ */
+UCLASS(ClassGroup = (Custom), Blueprintable, meta = (BlueprintSpawnableComponent))
+class RAPYUTASIMULATIONPLUGINS_API URRROS2ContactSensorComponent : public URRROS2BaseSensorComponent
+{
+    GENERATED_BODY()
+
+public:
+    URRROS2ContactSensorComponent();
+
+    virtual void Run() override;
+    virtual void Stop() override;
+
+    virtual void SensorUpdate() override;
+
+    virtual void SetROS2Msg(UROS2GenericMsg* InMessage) override;
+
+    //! Bodies whose contacts are sensed, all colliding primitives of the owner if empty
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    TArray<UPrimitiveComponent*> Bodies;
+
+    //! Whether any contact was sensed over the latest update period
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    bool bInContact = false;
+
+    //! Filled by #FRRContactManager, consumed by #SensorUpdate()
+    TArray<FRRContact> PendingContacts;
+
+    UPROPERTY(BlueprintReadWrite)
+    FROSContactsState Data;
+
+protected:
+    double LastUpdateTime = -1.;
+};
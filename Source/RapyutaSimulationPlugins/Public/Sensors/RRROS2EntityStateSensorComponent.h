@@ -25,7 +25,9 @@ DECLARE_MULTICAST_DELEGATE_OneParam(FOnNewReferenceActorDetected, AActor* /* New
 
 /**
  * @brief EntityState sensor components which publish entitystate relative to a specific actor.
- * @todo Currently twist = ZeroVectors. Should be filled for physics actors.
+ * Twist is estimated from the previous relative pose, in the reference frame.
+ * With #bPublishOnlyOnChange, states are only published when having moved beyond the thresholds, or every
+ * #MaxUnchangedPublishInterval.
  */
 UCLASS(ClassGroup = (Custom), Blueprintable, meta = (BlueprintSpawnableComponent))
 class RAPYUTASIMULATIONPLUGINS_API URRROS2EntityStateSensorComponent : public URRROS2BaseSensorComponent
@@ -42,11 +44,36 @@ public:
     void BeginPlay() override;
 
     /**
-     * @brief Calculate relative pose with #URRGeneralUtils and update #Data
-     * @todo Currently twist = ZeroVectors. Should be filled for physics actors.
+     * @brief Calculate relative pose with #URRGeneralUtils and update #Data, with twist differentiated from the previous pose
      */
     virtual void SensorUpdate() override;
 
+    //! Publish by own timer, skipping states not changed beyond #PositionChangeThreshold & #OrientationChangeThreshold
+    virtual void Run() override;
+    virtual void Stop() override;
+
+    virtual bool HasDataToPublish() const override;
+
+    //! Fill twist by differentiating the relative pose between updates, else left zero
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bEstimateTwist = true;
+
+    //! Only publish states changed beyond the thresholds since the last published one, or every #MaxUnchangedPublishInterval
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bPublishOnlyOnChange = false;
+
+    //! [m]
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float PositionChangeThreshold = 0.001f;
+
+    //! [rad]
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float OrientationChangeThreshold = 0.001f;
+
+    //! [s] Unchanged states are still published at this interval for late subscribers, never if <= 0
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float MaxUnchangedPublishInterval = 1.f;
+
     //! NOTE: Only #URRPoseSensorManager uses #ReferenceActor
     UPROPERTY(EditAnywhere, BlueprintReadOnly)
     FString ReferenceActorName = TEXT("");
@@ -86,4 +113,13 @@ public:
 private:
     UPROPERTY()
     FTransform RootOffset = FTransform::Identity;
+
+    //! Pose & time of the previous update, to estimate twist
+    FROSPose PrevPose;
+    double PrevUpdateTime = -1.;
+
+    //! Last published pose & time, for #bPublishOnlyOnChange
+    FROSPose PublishedPose;
+    double PublishedTime = -1.;
+    bool bChangedSincePublished = true;
 };
@@ -0,0 +1,99 @@
+/**
+ * @file RRROS2ImuComponent.h
+ * @brief IMU sensor component, sampled at the physics substep rate & published as sensor_msgs/Imu.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+// rclUE
+#include "Msgs/ROS2Imu.h"
+
+// RapyutaSimulationPlugins
+#include "Core/RRNoiseUtils.h"
+#include "Sensors/RRImuSampleRing.h"
+#include "Sensors/RRROS2BaseSensorComponent.h"
+
+#include "RRROS2ImuComponent.generated.h"
+
+class UPrimitiveComponent;
+
+//! Signalled by each #URRROS2ImuComponent::SensorUpdate() with the noisy substep samples since the previous one
+DECLARE_MULTICAST_DELEGATE_OneParam(FRROnImuSamples, TArrayView<const FRRImuSample> /* InSamples */);
+
+/**
+ * @brief IMU mounted on the nearest physics body up its attach parents, eg a robot's base link.
+ * Samples are taken on physics thread once per Chaos (sub)step by #FRRPhysicsSubstepManager into a lock-free
+ * #FRRImuSampleRing, thus at the physics rate, eg 200-400Hz with substepping, independent of the game tick.
+ * Each update drains the ring, adds gaussian noise to each sample with #FRRNoiseStream, signals them by #OnImuSamples for
+ * in-process consumers, then publishes their mean as one decimated sensor_msgs/Imu at #PublicationFrequencyHz, stamped
+ * with the latest sample's time.
+ * @sa [sensor_msgs/Imu](https://docs.ros2.org/latest/api/sensor_msgs/msg/Imu.html)
+ */
+UCLASS(ClassGroup = (Custom), Blueprintable, meta = (BlueprintSpawnableComponent))
+class RAPYUTASIMULATIONPLUGINS_API URRROS2ImuComponent : public URRROS2BaseSensorComponent
+{
+    GENERATED_BODY()
+
+public:
+    URRROS2ImuComponent();
+
+    virtual void Run() override;
+    virtual void Stop() override;
+
+    virtual void SensorUpdate() override;
+
+    virtual void SetROS2Msg(UROS2GenericMsg* InMessage) override;
+
+    //! Body the IMU is mounted on, the nearest attach parent having a physics body if null
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    UPrimitiveComponent* Body = nullptr;
+
+    //! Samples buffered between updates, beyond which they are dropped
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "2"))
+    int32 RingCapacity = 1024;
+
+    //! Add noise or not
+    UPROPERTY(EditAnywhere, Category = "Noise")
+    bool bWithNoise = true;
+
+    //! Seed of #NoiseStream, derived from the master random seed & this component's path if 0, see
+    //! #FRRNoiseUtils::GetSensorSeed
+    UPROPERTY(EditAnywhere, Category = "Noise")
+    int32 NoiseSeed = 0;
+
+    //! [m/s^2] Per sample & axis
+    UPROPERTY(EditAnywhere, Category = "Noise")
+    float LinearAccelerationNoiseStdDev = 0.02f;
+
+    //! [rad/s] Per sample & axis
+    UPROPERTY(EditAnywhere, Category = "Noise")
+    float AngularVelocityNoiseStdDev = 0.002f;
+
+    FRROnImuSamples OnImuSamples;
+
+    UPROPERTY(BlueprintReadWrite)
+    FROSImu Data;
+
+    uint32 GetDroppedSamplesNum() const
+    {
+        return Ring.IsValid() ? Ring->GetDroppedSamplesNum() : 0;
+    }
+
+protected:
+    //! Submit the sampler once #Body has a physics proxy
+    bool StartSampling();
+
+    void StopSampling();
+
+    TSharedPtr<FRRImuSampleRing, ESPMode::ThreadSafe> Ring;
+    bool bSampling = false;
+
+    //! Drained from #Ring, reused across updates
+    TArray<FRRImuSample> Samples;
+
+    FRRNoiseStream NoiseStream;
+};
@@ -0,0 +1,112 @@
+/**
+ * @file RRROS2StereoCameraComponent.h
+ * @brief ROS 2 stereo camera component, capturing both eyes in one scene render & one readback
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+// rclUE
+#include <Msgs/ROS2CameraInfo.h>
+
+// RapyutaSimulationPlugins
+#include "Sensors/RRROS2CameraComponent.h"
+#include "Tools/RRROS2StereoCameraPublisher.h"
+
+#include "RRROS2StereoCameraComponent.generated.h"
+
+/**
+ * @brief ROS 2 stereo camera component. Both eyes are rendered side by side into one #RenderTarget of 2 #Width x #Height,
+ * as two views of a single scene render from #SceneCaptureComponent, the right one offset by #Baseline along its Y axis.
+ * The pair is read back with a single readback per capture, then split into the left & right images, thus always
+ * captured in the same frame & published with the same stamp, along their camera infos.
+ * The left image is published by the sensor publisher on #TopicName, the other outputs by #StereoPublishers.
+ * Auxiliary outputs & atlas groups are not supported.
+ */
+UCLASS(ClassGroup = (Custom), Blueprintable, meta = (BlueprintSpawnableComponent))
+class RAPYUTASIMULATIONPLUGINS_API URRROS2StereoCameraComponent : public URRROS2CameraComponent
+{
+    GENERATED_BODY()
+
+public:
+    URRROS2StereoCameraComponent();
+
+    /**
+     * @brief Also create the right image & camera infos publishers
+     * @param InPublisherName
+     */
+    virtual void CreatePublisher(const FString& InPublisherName = TEXT("")) override;
+
+    /**
+     * @brief Lease the side by side #RenderTarget & initialize the right image & camera infos msgs
+     * @param InROS2Node
+     * @param InTopicName
+     */
+    virtual void PreInitializePublisher(UROS2NodeComponent* InROS2Node, const FString& InTopicName) override;
+
+    /**
+     * @brief Render both eyes into their halves of #RenderTarget, with one scene render
+     */
+    virtual void CaptureScenes() override;
+
+    virtual FReadbackPoll MakeReadbackPoll() const override;
+
+    /**
+     * @brief Also split a newly consumed pair into the left image, ie #GetImageMsg(), & #RightData
+     * @return true if a new capture was consumed
+     */
+    virtual bool UpdateImageMsg() override;
+
+    /**
+     * @brief Set a stereo output, consumed with the left image, to InMessage
+     * @param InOutput
+     * @param InMessage
+     */
+    void SetStereoROS2Msg(const ERRStereoCameraOutput InOutput, UROS2GenericMsg* InMessage);
+
+    const FROSImg& GetRightImageMsg() const
+    {
+        return RightData;
+    }
+
+    //! [cm] Distance between the left & right eyes
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stereo", meta = (ClampMin = "0"))
+    float Baseline = 12.f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stereo")
+    FString RightTopicName = TEXT("right/image_raw");
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stereo")
+    FString LeftCameraInfoTopicName = TEXT("left/camera_info");
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stereo")
+    FString RightCameraInfoTopicName = TEXT("right/camera_info");
+
+    //! Frame of the right eye, empty for #FrameId
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Stereo")
+    FString RightFrameId;
+
+    //! Publishers of the right image & camera infos
+    UPROPERTY(Transient)
+    TArray<URRROS2StereoCameraPublisher*> StereoPublishers;
+
+protected:
+    /**
+     * @brief Set the pinhole camera info of an eye, without distortion, the right projection embedding the baseline
+     * @param bInRight
+     * @param OutCameraInfo
+     */
+    void InitCameraInfo(const bool bInRight, FROSCameraInfo& OutCameraInfo) const;
+
+    //! Consumed pair of images, side by side, swapped with #Data's buffer upon each split to be recycled
+    TArray<uint8> StereoImage;
+
+    FROSImg RightData;
+
+    FROSCameraInfo LeftCameraInfo;
+
+    FROSCameraInfo RightCameraInfo;
+};
@@ -0,0 +1,81 @@
+/**
+ * @file RRRenderTargetPool.h
+ * @brief Per-world pool of render targets leased by sensor components, reused across their respawns.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// Native
+#include <mutex>
+
+// UE
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+
+class UWorld;
+class UTextureRenderTarget2D;
+
+/**
+ * @brief Per-world render target pool, keyed by (width, height, pixel format).
+ * Sensors lease their render targets upon initialization & return them upon EndPlay, thus respawning robots reuses the
+ * already allocated GPU textures instead of creating new ones. Free render targets are kept alive by this pool until
+ * the world is cleaned up.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRRenderTargetPool : public FGCObject
+{
+public:
+    /**
+     * @brief Get the pool of a world, creating it upon the first fetching
+     *
+     * @param InWorld
+     * @return FRRRenderTargetPool&
+     */
+    static FRRRenderTargetPool& Get(UWorld* InWorld);
+
+    /**
+     * @brief Lease a free linear gamma render target of a size & format, creating one if none is free
+     *
+     * @param InWidth
+     * @param InHeight
+     * @param InFormat
+     * @return UTextureRenderTarget2D*
+     */
+    UTextureRenderTarget2D* Lease(const int32 InWidth, const int32 InHeight, const EPixelFormat InFormat);
+
+    /**
+     * @brief Return a leased render target to the pool. Render commands referencing it must have been flushed.
+     *
+     * @param InRenderTarget
+     */
+    void Return(UTextureRenderTarget2D* InRenderTarget);
+
+    int32 GetFreeTargetsNum() const;
+
+    int32 GetLeasedTargetsNum() const
+    {
+        return LeasedTargets.Num();
+    }
+
+    virtual void AddReferencedObjects(FReferenceCollector& Collector) override;
+
+    virtual FString GetReferencerName() const override
+    {
+        return TEXT("FRRRenderTargetPool");
+    }
+
+private:
+    static TMap<UWorld*, TUniquePtr<FRRRenderTargetPool>> SPools;
+    static std::once_flag OnceFlag;
+
+    static void OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/);
+
+    static uint64 MakeKey(const int32 InWidth, const int32 InHeight, const EPixelFormat InFormat)
+    {
+        return (static_cast<uint64>(InWidth) << 40) | (static_cast<uint64>(InHeight) << 16) | static_cast<uint64>(InFormat);
+    }
+
+    TMap<uint64, TArray<UTextureRenderTarget2D*>> FreeTargets;
+
+    TArray<UTextureRenderTarget2D*> LeasedTargets;
+};
@@ -0,0 +1,249 @@
+/**
+ * @file RRSensorRayCaster.h
+ * @brief Sensor-only ray casting against a static world triangle BVH & a small tree of dynamic entities, bypassing the
+ * general physics scene queries.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// Native
+#include <mutex>
+
+// UE
+#include "CoreMinimal.h"
+
+struct FRRLidarHit;
+class ASimulationState;
+class UPrimitiveComponent;
+class UWorld;
+
+/**
+ * @brief Bounding volume hierarchy over primitive bounds, built top-down with a binned SAH.
+ * Nodes are 32 bytes & children of an inner node adjacent, primitives being reordered by #Build() so that each leaf's ones
+ * are contiguous.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRBVH
+{
+public:
+    struct FNode
+    {
+        FVector3f Min = FVector3f::ZeroVector;
+        //! Inner node: index of the left child, the right one following. Leaf: index of its first primitive.
+        int32 Index = 0;
+        FVector3f Max = FVector3f::ZeroVector;
+        //! Num of primitives of a leaf, 0 for an inner node
+        int32 Count = 0;
+    };
+
+    //! Leaves are only split beyond this num of primitives, or if the SAH finds it cheaper
+    static constexpr int32 MAX_LEAF_SIZE = 8;
+    static constexpr int32 SAH_BINS_NUM = 12;
+
+    /**
+     * @brief Build the nodes over InPrimBounds
+     * @param InPrimBounds
+     * @param OutOrder Primitive indices in leaves order, by which the caller reorders its primitives
+     */
+    void Build(const TArray<FBox3f>& InPrimBounds, TArray<int32>& OutOrder);
+
+    void Reset()
+    {
+        Nodes.Reset();
+    }
+
+    bool IsEmpty() const
+    {
+        return Nodes.Num() == 0;
+    }
+
+    /**
+     * @brief Visit the leaves whose bounds a ray enters within [InMinDistance, InOutMaxDistance], nearest first.
+     * InVisitLeaf(InFirst, InCount, InOutMaxDistance) shortens InOutMaxDistance upon any nearer hit.
+     */
+    template<typename TFunc>
+    void Traverse(const FVector3f& InOrigin,
+                  const FVector3f& InInvDir,
+                  const float InMinDistance,
+                  float& InOutMaxDistance,
+                  TFunc&& InVisitLeaf) const;
+
+    /**
+     * @brief Visit the leaves whose bounds any of a packet of up to 64 rays sharing InOrigin enters, the packet being
+     * narrowed down to the rays entering each node. InVisitLeaf(InFirst, InCount, InRaysMask) shortens the InMaxDistances
+     * of its rays upon nearer hits, a negative one disabling its ray.
+     */
+    template<typename TFunc>
+    void TraversePacket(const FVector3f& InOrigin,
+                        const FVector3f* InInvDirs,
+                        const int32 InRaysNum,
+                        const float InMinDistance,
+                        const float* InMaxDistances,
+                        TFunc&& InVisitLeaf) const;
+
+    TArray<FNode> Nodes;
+};
+
+/**
+ * @brief Immutable ray casting scene of a world: the shared static triangle BVH & a snapshot of the dynamic
+ * primitives' bounds tree. Scenes are snapshot once per frame by #FRRSensorRayCaster::GetScene() & thread-safe, thus kept
+ * by the scans in flight.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRSensorRayScene
+{
+public:
+    //! Static triangle, with its precomputed edges for the Moller-Trumbore test
+    struct FTriangle
+    {
+        FVector3f V0 = FVector3f::ZeroVector;
+        FVector3f E1 = FVector3f::ZeroVector;
+        FVector3f E2 = FVector3f::ZeroVector;
+        //! Index into #FStaticGeometry::SourceActorIds
+        int32 SourceIndex = 0;
+        //! EPhysicalSurface, or FRRLidarHit::SURFACE_TYPE_NONE
+        uint8 SurfaceType = 0;
+    };
+
+    //! Static geometry, built once per world by #FRRSensorRayCaster
+    struct FStaticGeometry
+    {
+        FRRBVH BVH;
+        TArray<FTriangle> Triangles;
+        //! Actor UniqueID of each static source primitive
+        TArray<uint32> SourceActorIds;
+    };
+
+    //! Dynamic primitive, traced with its own collision
+    struct FDynamicPrimitive
+    {
+        TWeakObjectPtr<UPrimitiveComponent> Component;
+        uint32 ActorId = 0;
+    };
+
+    static constexpr int32 PACKET_SIZE = 64;
+
+    /**
+     * @brief Cast a ray, writing its nearest hit
+     * @param InStart
+     * @param InDir Normalized
+     * @param InLength
+     * @param InIgnoredActorId UniqueID of an actor whose primitives are ignored, eg the sensor owner, 0 for none
+     * @param OutHit A miss at InStart + InLength * InDir without hit
+     */
+    void Raycast(const FVector& InStart,
+                 const FVector3f& InDir,
+                 const float InLength,
+                 const uint32 InIgnoredActorId,
+                 FRRLidarHit& OutHit) const;
+
+    /**
+     * @brief Cast rays sharing InOrigin, eg a lidar scan, by packets of #PACKET_SIZE traversing the static BVH together,
+     * in ParallelFor. Hits distances are measured from InMinDistance along each ray, as #Raycast()'s.
+     * @param InOrigin
+     * @param InDirX Normalized directions, SoA
+     * @param InDirY
+     * @param InDirZ
+     * @param InRaysNum
+     * @param InMinDistance
+     * @param InMaxDistance
+     * @param InIgnoredActorId
+     * @param InSkippedRays Optional rays set as misses without being cast
+     * @param OutHits InRaysNum hits
+     */
+    void RaycastPacket(const FVector& InOrigin,
+                       const float* InDirX,
+                       const float* InDirY,
+                       const float* InDirZ,
+                       const int32 InRaysNum,
+                       const float InMinDistance,
+                       const float InMaxDistance,
+                       const uint32 InIgnoredActorId,
+                       const TBitArray<>* InSkippedRays,
+                       FRRLidarHit* OutHits) const;
+
+    TSharedPtr<const FStaticGeometry> Static;
+
+    FRRBVH DynamicBVH;
+    TArray<FDynamicPrimitive> DynamicPrimitives;
+
+private:
+    //! Test a static leaf's triangles, shortening InOutDistance & setting OutTriangle upon nearer hits
+    void IntersectTriangles(const int32 InFirst,
+                            const int32 InCount,
+                            const FVector3f& InOrigin,
+                            const FVector3f& InDir,
+                            const float InMinDistance,
+                            const uint32 InIgnoredActorId,
+                            float& InOutDistance,
+                            int32& OutTriangle) const;
+
+    //! Trace the dynamic primitives nearer than InOutHit, from InStart, overwriting it upon a nearer hit
+    void RaycastDynamic(const FVector& InStart,
+                        const FVector3f& InDir,
+                        const float InLength,
+                        const uint32 InIgnoredActorId,
+                        FRRLidarHit& InOutHit) const;
+
+    //! Write a static triangle hit, or a miss if InTriangle is INDEX_NONE
+    void SetStaticHit(const FVector& InOrigin,
+                      const FVector3f& InDir,
+                      const float InMinDistance,
+                      const float InMaxDistance,
+                      const float InDistance,
+                      const int32 InTriangle,
+                      FRRLidarHit& OutHit) const;
+};
+
+/**
+ * @brief Per-world sensor ray caster, used by lidars with #URRBaseLidarComponent::bUseSensorRayCaster.
+ * Static geometry is the complex collision triangles of static, visibility-blocking static mesh components, extracted &
+ * built into a BVH upon the first #Get() then cached to Saved/RRSensorRayCaster keyed by a hash of those components.
+ * Dynamic primitives are the movable visibility-blocking primitives of #ASimulationState entities, plus static ones
+ * without collision triangles (eg landscapes), whose bounds tree is rebuilt once per frame, each intersected primitive then
+ * being traced with its own collision only.
+ * Unlike scene queries, movable primitives of actors not registered as entities are not seen.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRSensorRayCaster
+{
+public:
+    /**
+     * @brief Get the ray caster of a world, creating & building its static geometry upon the first fetching
+     *
+     * @param InWorld
+     * @return FRRSensorRayCaster&
+     */
+    static FRRSensorRayCaster& Get(UWorld* InWorld);
+
+    /**
+     * @brief Get the scene of the current frame, snapshotting the dynamic primitives upon the first call in a frame.
+     * Game thread only.
+     */
+    TSharedRef<const FRRSensorRayScene> GetScene();
+
+    int32 GetStaticTrianglesNum() const
+    {
+        return Static.IsValid() ? Static->Triangles.Num() : 0;
+    }
+
+private:
+    static TMap<UWorld*, TUniquePtr<FRRSensorRayCaster>> SCasters;
+    static std::once_flag OnceFlag;
+
+    static void OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/);
+
+    //! Extract the static triangles, or load them & their BVH from the disk cache
+    void BuildStaticGeometry(UWorld* InWorld);
+
+    static FString GetCacheFilePath(const UWorld* InWorld, const uint32 InHash);
+
+    TWeakObjectPtr<UWorld> World;
+    TSharedPtr<const FRRSensorRayScene::FStaticGeometry> Static;
+
+    //! Static primitives without collision triangles, added to every scene's dynamic ones
+    TArray<TWeakObjectPtr<UPrimitiveComponent>> StaticFallbackPrimitives;
+
+    TWeakObjectPtr<ASimulationState> SimState;
+
+    TSharedPtr<const FRRSensorRayScene> Scene;
+    uint64 SceneFrame = 0;
+};
@@ -0,0 +1,147 @@
+/**
+ * @file RRSensorScheduler.h
+ * @brief Per-world scheduler firing sensor updates in simulation time, with spread phases & a per-frame CPU budget.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// Native
+#include <mutex>
+
+// UE
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+
+class UWorld;
+class URRROS2BaseSensorComponent;
+enum class ERRSensorOverloadTier : uint8;
+
+/**
+ * @brief Per-world sensor scheduler, replacing the per-sensor timer of sensors with
+ * #URRROS2BaseSensorComponent::bFrameScheduled on.
+ * Upon [FWorldDelegates::OnWorldPreActorTick], thus before the batch schedulers flushing upon OnWorldPostActorTick:
+ * - Each sensor is due at exact multiples of its period in world time, which is independent of the frame rate with a
+ *   fixed time step, eg #URRLimitRTFFixedSizeCustomTimeStep. Its next due time is advanced by its period, not reset from
+ *   the firing time, thus never drifts. Periods elapsed entirely between two firings are counted as skipped.
+ * - Sensors are given evenly spread phases upon being added, not to have the ones of the same rate all due in the same
+ *   frame.
+ * - Due sensors are updated by #URRROS2BaseSensorComponent::SchedulePriority, then the most overdue first, until their total
+ *   update time reaches the rr.SensorScheduler.CPUBudgetMs console variable. The others are deferred to the next frame,
+ *   except the ERRSensorPriority::HIGH ones which are always updated.
+ * - With the rr.SensorScheduler.OverloadPolicy console variable on, the RTF achieved over each second is compared with the
+ *   target one of #URRLimitRTFFixedSizeCustomTimeStep, 1 without it. While below rr.SensorScheduler.OverloadRTFRatio of it,
+ *   the rate of the lowest #ERRSensorOverloadTier still above rr.SensorScheduler.OverloadMinRateScale is halved every second,
+ *   ERRSensorOverloadTier::SAFETY never being slowed down. Once the target is held again, rates are doubled back, the most
+ *   important tier first. See #URRROS2BaseSensorComponent::OverloadRateScale.
+ *
+ * @sa [OnWorldPreActorTick](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/Engine/FWorldDelegates/OnWorldPreActorTick/)
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRSensorScheduler
+{
+public:
+    /**
+     * @brief Get the scheduler of a world, creating it upon the first fetching
+     *
+     * @param InWorld
+     * @return FRRSensorScheduler&
+     */
+    static FRRSensorScheduler& Get(UWorld* InWorld);
+
+    //! Get the scheduler of a world if any
+    static FRRSensorScheduler* Find(UWorld* InWorld)
+    {
+        TUniquePtr<FRRSensorScheduler>* scheduler = SSchedulers.Find(InWorld);
+        return scheduler ? scheduler->Get() : nullptr;
+    }
+
+    /**
+     * @brief Start scheduling a sensor at its #URRROS2BaseSensorComponent::PublicationFrequencyHz
+     *
+     * @param InSensor
+     */
+    void AddSensor(URRROS2BaseSensorComponent* InSensor);
+
+    /**
+     * @brief Stop scheduling a sensor
+     *
+     * @param InSensor
+     */
+    void RemoveSensor(URRROS2BaseSensorComponent* InSensor);
+
+    /**
+     * @brief Update the due sensors within the budget
+     *
+     * @param InTimeSeconds Current world time
+     */
+    void Update(const double InTimeSeconds);
+
+    int32 GetSensorsNum() const
+    {
+        return Entries.Num();
+    }
+
+    static constexpr int32 OVERLOAD_TIERS_NUM = 4;
+
+    //! Ratio of the sensors' #URRROS2BaseSensorComponent::PublicationFrequencyHz scheduled for a tier
+    float GetTierRateScale(const ERRSensorOverloadTier InTier) const
+    {
+        return TierRateScales[static_cast<uint8>(InTier)];
+    }
+
+    //! RTF achieved over the latest overload policy interval, 0 until measured
+    double GetMeasuredRTF() const
+    {
+        return MeasuredRTF;
+    }
+
+    double GetTargetRTF() const
+    {
+        return TargetRTF;
+    }
+
+private:
+    static TMap<UWorld*, TUniquePtr<FRRSensorScheduler>> SSchedulers;
+    static std::once_flag OnceFlag;
+
+    static void OnWorldPreActorTick(UWorld* InWorld, ELevelTick /*InTickType*/, float /*InDeltaSeconds*/);
+    static void OnPostWorldCleanup(UWorld* InWorld, bool /*bInSessionEnded*/, bool /*bInCleanupResources*/);
+
+    struct FEntry
+    {
+        TWeakObjectPtr<URRROS2BaseSensorComponent> Sensor;
+
+        //! [s] Of #URRROS2BaseSensorComponent::PublicationFrequencyHz
+        double BasePeriod = 0.;
+
+        //! [s] Scheduled, ie #BasePeriod slowed down by the overload policy
+        double Period = 0.;
+
+        //! [s] World time the sensor is next due
+        double DueTime = 0.;
+    };
+
+    TArray<FEntry> Entries;
+
+    //! Index of the next added sensor in the phases sequence
+    uint32 PhaseIndex = 0;
+
+    //! Indices of the due entries, reused across updates
+    TArray<int32> DueEntries;
+
+    //! Per #ERRSensorOverloadTier
+    float TierRateScales[OVERLOAD_TIERS_NUM] = {1.f, 1.f, 1.f, 1.f};
+
+    //! [s] Start of the current overload policy interval, in real & world time
+    double PolicyRealTime = 0.;
+    double PolicyWorldTime = 0.;
+
+    double MeasuredRTF = 0.;
+    double TargetRTF = 1.;
+
+    //! Measure the RTF once per interval & slow down or restore one tier
+    void UpdateOverloadPolicy(const double InTimeSeconds);
+
+    //! Apply #TierRateScales to all entries' periods & sensors
+    void ApplyTierRateScales();
+};
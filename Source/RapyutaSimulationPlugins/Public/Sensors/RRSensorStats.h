@@ -0,0 +1,125 @@
+/**
+ * @file RRSensorStats.h
+ * @brief Rolling timing stats of sensors & their Unreal Insights trace channel.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.h"
+
+//! Sensor update & publish scopes, enabled with -trace=cpu,rrsensor
+UE_TRACE_CHANNEL_EXTERN(RRSensorChannel, RAPYUTASIMULATIONPLUGINS_API);
+
+/**
+ * @brief Fixed-size ring of the latest samples, for rolling means & percentiles
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRRollingSamples
+{
+public:
+    explicit FRRRollingSamples(const int32 InCapacity = 128) : Capacity(FMath::Max(InCapacity, 1))
+    {
+        Samples.Reserve(Capacity);
+    }
+
+    void Add(const double InValue);
+
+    void Reset()
+    {
+        Samples.Reset();
+        NextIndex = 0;
+    }
+
+    int32 Num() const
+    {
+        return Samples.Num();
+    }
+
+    double GetMean() const;
+
+    double GetMax() const;
+
+    /**
+     * @brief Nearest-rank percentile of the samples
+     * @param InPercent [0, 100]
+     * @return double 0 if no sample
+     */
+    double GetPercentile(const float InPercent) const;
+
+    double GetOldest() const
+    {
+        return (Samples.Num() < Capacity) ? Samples[0] : Samples[NextIndex];
+    }
+
+    double GetLatest() const
+    {
+        return Samples[(NextIndex + Capacity - 1) % Capacity];
+    }
+
+private:
+    TArray<double> Samples;
+    int32 Capacity = 1;
+    int32 NextIndex = 0;
+};
+
+/**
+ * @brief Rolling stats of a sensor, recorded from game thread & #FRRROS2PublisherThread:
+ * - Update time: duration of #URRROS2BaseSensorComponent::SensorUpdate()
+ * - Msg time: duration of filling the ROS 2 msg, ie #URRROS2BaseSensorComponent::SetROS2Msg() or a msg builder
+ * - Publish latency: wall time from the end of the latest update to the msg being filled, ie the staleness of the
+ *   published data, whose stamp is the simulation time of its update
+ * - Publish rate: achieved over the latest publishes
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRSensorStats
+{
+public:
+    struct FSummary
+    {
+        int64 UpdatesNum = 0;
+        int64 PublishedMsgsNum = 0;
+        double UpdateMeanMs = 0.;
+        double UpdateP95Ms = 0.;
+        double UpdateMaxMs = 0.;
+        double MsgMeanMs = 0.;
+        double MsgP95Ms = 0.;
+        double LatencyMeanMs = 0.;
+        double LatencyP95Ms = 0.;
+        double LatencyMaxMs = 0.;
+        double PublishRateHz = 0.;
+
+        FString ToString() const;
+    };
+
+    /**
+     * @brief Record an update
+     * @param InStartSeconds [FPlatformTime::Seconds()]
+     * @param InEndSeconds [FPlatformTime::Seconds()]
+     */
+    void RecordUpdate(const double InStartSeconds, const double InEndSeconds);
+
+    /**
+     * @brief Record a msg being filled right before publishing
+     * @param InStartSeconds [FPlatformTime::Seconds()]
+     * @param InEndSeconds [FPlatformTime::Seconds()]
+     */
+    void RecordPublish(const double InStartSeconds, const double InEndSeconds);
+
+    void Reset();
+
+    FSummary GetSummary() const;
+
+private:
+    mutable FCriticalSection Mutex;
+
+    FRRRollingSamples UpdateTimesMs;
+    FRRRollingSamples MsgTimesMs;
+    FRRRollingSamples PublishLatenciesMs;
+    FRRRollingSamples PublishTimes;
+
+    int64 UpdatesNum = 0;
+    int64 PublishedMsgsNum = 0;
+    double LastUpdateEndSeconds = 0.;
+};
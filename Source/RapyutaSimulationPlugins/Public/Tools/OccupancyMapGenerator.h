@@ -9,13 +9,32 @@
 #include "CoreMinimal.h"
 #include "Engine/StaticMeshActor.h"
 #include "GameFramework/Actor.h"
+#include "RenderCommandFence.h"
 
 #include "OccupancyMapGenerator.generated.h"
 
+class ASimulationState;
+class URRROS2OccupancyGridPublisher;
+class USceneCaptureComponent2D;
+
 /**
  * @brief Actor to Generate 2D occupancy map for navigation/localization with LineTraceSingleByChannel.
  * Generate 2D occupancy map with given parameter and save to file with beginplay.
  * How to use: Place this actor to the level, set parameters(select #Map and max vertical height), and play simulation, then map file will be saved.
+ * Cells are traced by tiles of #TileSize x #TileSize cells, tiles in parallel. With #bGenerateOverFrames, tiles are traced
+ * upon ticks within #FrameBudgetMs each, instead of all at once in BeginPlay, not to block startup.
+ * Besides #OccupancyGrid, optionally generated & saved with it:
+ * - #HeightSlices: one occupancy grid per height interval, eg per floor of a multi-level warehouse, in #SliceGrids
+ * - #bGenerateHeightMap: 2.5D map of the highest surface height of each cell, in #HeightMap, saved as a 16-bit PGM
+ * - #QuadtreeLevelsNum: implicit quadtree of #OccupancyGrid, as coarser grids of which each cell covers 2x2 cells of the
+ *   finer level & is free, occupied or mixed, uniform cells being leaves, queried by #IsAreaFree
+ * With #bUseGPU, #OccupancyGrid & #HeightMap are instead rasterized from top-down orthographic depth captures of
+ * #GPUTileSize x #GPUTileSize cells, one tile per frame, each read back & thresholded in parallel, cells being occupied
+ * where the highest rendered surface is within the traced height range. Rendered geometry is used instead of collision.
+ * With #bIncrementalUpdate, entities spawned, moved or deleted by #ASimulationState afterwards only get the tiles overlapped
+ * by their bounds before & after retraced, then files are saved again.
+ * With #bPublishROS2, #OccupancyGrid is also published live by #GridPublisher in the game mode's main ROS 2 node, in full
+ * once generated then as partial updates of the retraced area, eg for nav2 to get map changes without restarting.
  * @sa [LineTraceSingleByChannel](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/Engine/UWorld/LineTraceSingleByChannel/)
  */
 UCLASS()
@@ -37,6 +56,14 @@ protected:
 	 */
     virtual void BeginPlay() override;
 
+    /**
+     * @brief Trace the next tiles within #FrameBudgetMs, then save files once all are traced
+     * @param DeltaSeconds
+     */
+    virtual void Tick(float DeltaSeconds) override;
+
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 public:
     //! Generate map to cover bounding box of this actor. Please select actor such as ground plane.
     UPROPERTY(EditAnywhere)
@@ -53,9 +80,89 @@ public:
     UPROPERTY(EditAnywhere)
     FString Filename = "ue4_map";
 
+    //! [cells] Tile edge, each tile being traced by one task
+    UPROPERTY(EditAnywhere)
+    int32 TileSize = 64;
+
+    //! Trace tiles over multiple frames instead of all at once in BeginPlay
+    UPROPERTY(EditAnywhere)
+    bool bGenerateOverFrames = true;
+
+    //! [ms] Tracing time per frame if #bGenerateOverFrames, at least one batch of tiles being traced per frame
+    UPROPERTY(EditAnywhere)
+    float FrameBudgetMs = 10.f;
+
+    //! Rasterize the initial grids from depth captures, unless #HeightSlices are set, which require traces
+    UPROPERTY(EditAnywhere)
+    bool bUseGPU = false;
+
+    //! [cells] Edge of each depth capture if #bUseGPU
+    UPROPERTY(EditAnywhere)
+    int32 GPUTileSize = 1024;
+
+    //! [m] Height intervals above #Map top of #SliceGrids, X: min, Y: max
+    UPROPERTY(EditAnywhere)
+    TArray<FVector2D> HeightSlices;
+
+    //! Generate #HeightMap
+    UPROPERTY(EditAnywhere)
+    bool bGenerateHeightMap = false;
+
+    //! Num of coarser levels of the quadtree of #OccupancyGrid, each saved as Filename_L<level>, mixed cells as occupied
+    UPROPERTY(EditAnywhere)
+    int32 QuadtreeLevelsNum = 0;
+
+    //! Retrace the tiles of entities spawned, moved or deleted by #SimulationState once generated
+    UPROPERTY(EditAnywhere)
+    bool bIncrementalUpdate = false;
+
+    //! Found in the world if null
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    ASimulationState* SimulationState = nullptr;
+
+    //! Publish #OccupancyGrid as nav_msgs/OccupancyGrid on #MapTopicName & its updates on [<MapTopicName>_updates]
+    UPROPERTY(EditAnywhere)
+    bool bPublishROS2 = false;
+
+    UPROPERTY(EditAnywhere)
+    FString MapTopicName = TEXT("map");
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    URRROS2OccupancyGridPublisher* GridPublisher = nullptr;
+
+    //! Whether all cells have been traced & files saved
+    bool IsGenerated() const
+    {
+        return (TilesNum > 0) && (NextTileIndex >= TilesNum);
+    }
+
+    //! Traced fraction of the cells, [0, 1]
+    float GetProgress() const
+    {
+        if (bGPUGeneration)
+        {
+            return (GPUTilesNum > 0) ? (float(NextGPUTileIndex) / GPUTilesNum) : 0.f;
+        }
+        return (TilesNum > 0) ? (float(NextTileIndex) / TilesNum) : 0.f;
+    }
+
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
     TArray<uint8> OccupancyGrid;
 
+    //! Occupancy grids of #HeightSlices, as #OccupancyGrid
+    TArray<TArray<uint8>> SliceGrids;
+
+    //! [cm] Highest surface height of each cell above #Map top, 0 if none
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    TArray<float> HeightMap;
+
+    /**
+     * @brief Whether an area is free in #OccupancyGrid, descending the quadtree only into mixed cells
+     * @param InArea [cm] World XY area
+     * @return true if fully free & inside the map
+     */
+    bool IsAreaFree(const FBox2D& InArea) const;
+
     UFUNCTION()
     /**
 	 * @brief Save .pgm and .yaml files.
@@ -68,4 +175,102 @@ public:
 	 * @return false
 	 */
     bool WriteToFile(int width, int height, float originx, float originy);
+
+    //! Retrace the tiles overlapped by a box
+    void MarkDirty(const FBox& InBounds);
+
+protected:
+    //! Trace tiles in parallel into #OccupancyGrid, #SliceGrids & #HeightMap, then update the quadtree over them
+    void TraceTiles(const TArray<int32>& InTileIndices);
+
+    //! Capture the depth of the next GPU tile & enqueue its read-back
+    void CaptureGPUTile();
+
+    //! Threshold the read-back depth of the captured GPU tile into #OccupancyGrid & #HeightMap
+    void ResolveGPUTile();
+
+    //! Save all files of the traced grids & publish the cells traced since the last time
+    void FinishGeneration();
+
+    //! Create #GridPublisher in the game mode's main ROS 2 node once initialized, publishing the grid if generated
+    bool InitGridPublisher();
+
+    /**
+     * @brief Save a grid as .pgm and .yaml files
+     * @param InFilename Without extension
+     * @param InWidth
+     * @param InHeight
+     * @param InResolution [m/pixel]
+     * @param InOriginX [m]
+     * @param InOriginY [m]
+     * @param InData InWidth x InHeight pixels, 2 bytes big-endian each if InMaxValue > 255
+     * @param InMaxValue
+     * @param InYamlExtra Appended to the .yaml
+     */
+    bool WriteGridToFile(const FString& InFilename,
+                         const int32 InWidth,
+                         const int32 InHeight,
+                         const float InResolution,
+                         const float InOriginX,
+                         const float InOriginY,
+                         TArrayView<const uint8> InData,
+                         const int32 InMaxValue = 255,
+                         const FString& InYamlExtra = TEXT(""));
+
+    //! Update the coarser quadtree levels over [InMinCell, InMaxCell] cells of #OccupancyGrid
+    void UpdateQuadtree(const FIntPoint& InMinCell, const FIntPoint& InMaxCell);
+
+    //! Level 0 being #OccupancyGrid
+    uint8 GetQuadtreeCell(const int32 InLevel, const int32 InX, const int32 InY) const;
+
+    //! Whether [InMinCell, InMaxCell] cells of #OccupancyGrid within a quadtree cell are free
+    bool IsQuadtreeAreaFree(const int32 InLevel,
+                            const int32 InX,
+                            const int32 InY,
+                            const FIntPoint& InMinCell,
+                            const FIntPoint& InMaxCell) const;
+
+    void OnEntityBoundsChanged(const AActor* InEntity, const FBox& InPrevBounds);
+
+    //! Coarser quadtree levels, from 1, with their sizes
+    TArray<TArray<uint8>> QuadtreeLevels;
+    TArray<FIntPoint> QuadtreeLevelSizes;
+
+    //! Tiles to retrace if #bIncrementalUpdate, and ones of the current batch
+    TSet<int32> DirtyTiles;
+    TArray<int32> BatchTiles;
+
+    //! Cells traced since the last #FinishGeneration, invalid if none
+    FIntRect TracedCells = FIntRect(FIntPoint(MAX_int32), FIntPoint(MIN_int32));
+    FDelegateHandle EntityBoundsChangedHandle;
+
+    //! [cm] Min corner & size of #Map bounds
+    FVector Origin = FVector::ZeroVector;
+    FVector MapSize = FVector::ZeroVector;
+
+    //! [cm] #Map top, ray start & end heights
+    float MapTopZ = 0.f;
+    float RayStartZ = 0.f;
+    float RayEndZ = 0.f;
+
+    //! Top-down orthographic depth capture of the GPU tiles
+    UPROPERTY()
+    USceneCaptureComponent2D* DepthCapture = nullptr;
+
+    //! [cm] Read-back depth of the captured GPU tile, complete once #DepthFence is
+    TArray<FLinearColor> DepthData;
+    FRenderCommandFence DepthFence;
+    bool bDepthInFlight = false;
+
+    //! Rasterizing the initial grids on GPU
+    bool bGPUGeneration = false;
+    int32 NGPUTilesX = 0;
+    int32 GPUTilesNum = 0;
+    int32 NextGPUTileIndex = 0;
+
+    int32 NCellsX = 0;
+    int32 NCellsY = 0;
+    int32 NTilesX = 0;
+    int32 TilesNum = 0;
+    int32 NextTileIndex = 0;
 };
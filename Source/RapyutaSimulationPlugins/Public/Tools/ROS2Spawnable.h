@@ -36,6 +36,7 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Replicated)
     TArray<FString> ActorTags;
 
+    //! JSON text, or path of a .json file, parsed with #URRGeneralUtils::GetCachedJsonObject
     UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Replicated)
     FString ActorJsonConfigs;
 
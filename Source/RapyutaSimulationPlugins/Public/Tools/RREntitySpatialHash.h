@@ -0,0 +1,110 @@
+/**
+ * @file RREntitySpatialHash.h
+ * @brief Uniform grid of entity locations, for radius, box & nearest queries without scanning all entities.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+
+/**
+ * @brief Hashes entities by their location into cubic cells of #GetCellSize().
+ * Incrementally synced with an entities map by #Sync(), which only moves the entities having changed cell, adds the new ones
+ * & drops the removed or destroyed ones. #Update() re-buckets a single entity, eg right after it has been teleported.
+ * Queries test the actor locations, not their bounds. Game thread only.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRREntitySpatialHash
+{
+public:
+    //! Whether to keep an entity in the query results
+    using FFilter = TFunctionRef<bool(const AActor*)>;
+
+    float GetCellSize() const
+    {
+        return CellSize;
+    }
+
+    //! Set the cell size [cm], rebucketing all entities if changed
+    void SetCellSize(const float InCellSize);
+
+    int32 Num() const
+    {
+        return SlotIndices.Num();
+    }
+
+    /**
+     * @brief Sync with InEntities, reading the location of each
+     * @param InEntities
+     */
+    void Sync(const TMap<FString, AActor*>& InEntities);
+
+    //! Add or re-bucket InEntity from its current location
+    void Update(AActor* InEntity);
+
+    void Remove(const AActor* InEntity);
+
+    void Reset();
+
+    /**
+     * @brief Get the entities located in InBox
+     * @param InBox
+     * @param OutEntities Appended
+     * @param InFilter
+     */
+    void QueryBox(const FBox& InBox, TArray<AActor*>& OutEntities, FFilter InFilter) const;
+
+    /**
+     * @brief Get the entities located within InRadius of InCenter
+     * @param InCenter
+     * @param InRadius
+     * @param OutEntities Appended
+     * @param InFilter
+     */
+    void QueryRadius(const FVector& InCenter, const float InRadius, TArray<AActor*>& OutEntities, FFilter InFilter) const;
+
+    /**
+     * @brief Find the entity nearest to InLocation, searching cell shells outwards
+     * @param InLocation
+     * @param InMaxDistance Unbounded if <= 0
+     * @param InFilter
+     * @return AActor* nullptr if none within InMaxDistance
+     */
+    AActor* FindNearest(const FVector& InLocation, const float InMaxDistance, FFilter InFilter) const;
+
+protected:
+    struct FSlot
+    {
+        TWeakObjectPtr<AActor> Actor;
+        FVector Location = FVector::ZeroVector;
+        FIntVector Cell = FIntVector::ZeroValue;
+        //! #SyncStamp of the latest #Sync() having seen this entity
+        uint32 SyncStamp = 0;
+    };
+
+    FIntVector GetCell(const FVector& InLocation) const
+    {
+        return FIntVector(FMath::FloorToInt32(InLocation.X / CellSize),
+                          FMath::FloorToInt32(InLocation.Y / CellSize),
+                          FMath::FloorToInt32(InLocation.Z / CellSize));
+    }
+
+    void AddToCell(const int32 InSlotIdx);
+    void RemoveFromCell(const int32 InSlotIdx);
+
+    //! Visit the entities of a cell, passing the filter & validity checks
+    template<typename TFunc>
+    void ForEachInCell(const FIntVector& InCell, FFilter InFilter, TFunc&& InFunc) const;
+
+    //! Visit the entities of the cells overlapping InBox
+    template<typename TFunc>
+    void ForEachInBoxCells(const FBox& InBox, FFilter InFilter, TFunc&& InFunc) const;
+
+    float CellSize = 1000.f;
+    TSparseArray<FSlot> Slots;
+    TMap<const AActor*, int32> SlotIndices;
+    TMap<FIntVector, TArray<int32>> Cells;
+    uint32 SyncStamp = 0;
+};
@@ -0,0 +1,182 @@
+/**
+ * @file RRFrameTelemetry.h
+ * @brief Per fixed step breakdown of the frame time into its main costs, aggregated into rolling percentiles.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// Native
+#include <atomic>
+
+// UE
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "HAL/CriticalSection.h"
+
+// RapyutaSimulationPlugins
+#include "Sensors/RRSensorStats.h"
+
+class FPhysScene_Chaos;
+class UWorld;
+
+//! Cost categories of a fixed step
+enum class ERRFrameTimeCategory : uint8
+{
+    //! Game thread frame, from one step to the next, including #RTF_WAIT
+    FRAME,
+    //! World ticks, excluding the other game thread categories run inside them
+    GAME_TICK,
+    //! Game thread span of the physics scene's frame, ie waiting for the simulation & during-physics ticks
+    PHYSICS,
+    //! #URRROS2BaseSensorComponent updates, also broken down per sensor class
+    SENSORS,
+    //! Filling & publishing ROS 2 msgs, including on #FRRROS2PublisherThread, thus overlapping the frame
+    ROS_PUBLISH,
+    //! ROS 2 subscription callbacks
+    ROS_SUBSCRIBE,
+    //! Game thread after world ticks: viewport drawing, scene captures' submission & render thread sync
+    RENDER,
+    //! Render thread time of the latest frame, overlapping the game thread
+    RENDER_THREAD,
+    //! Wait of the custom time step, not to go over the target RTF
+    RTF_WAIT,
+    NUM
+};
+
+/**
+ * @brief Rolling percentiles of a cost per step
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRFrameTimeStats
+{
+    FString Name;
+    int32 StepsNum = 0;
+    double MeanMs = 0.;
+    double P50Ms = 0.;
+    double P95Ms = 0.;
+    double P99Ms = 0.;
+    double MaxMs = 0.;
+};
+
+/**
+ * @brief Records the time spent per fixed step of #URRLimitRTFFixedSizeCustomTimeStep on each #ERRFrameTimeCategory & per
+ * sensor class, over the latest #STEPS_NUM steps, to find out which features the frame budget goes to in large scenes.
+ * Steps are ended by the custom time step, thus nothing is recorded without it; costs of zero-length lockstep hold frames
+ * are added to the next step. World ticks & physics frames are hooked automatically, other costs are recorded with
+ * #FRRFrameTimeScope or #AddTime(), which are thread-safe.
+ * Summaries are logged with `rr.FrameTelemetry`, written to CSV with `rr.FrameTelemetry csv <path>` or the command line
+ * `-RRFrameTelemetryCsv=<path>`, and published by #URRROS2FrameTelemetryPublisher.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRFrameTelemetry
+{
+public:
+    //! Rolling window size, in steps
+    static constexpr int32 STEPS_NUM = 1024;
+
+    struct FSummary
+    {
+        uint64 StepsNum = 0;
+        //! One per #ERRFrameTimeCategory
+        TArray<FRRFrameTimeStats> Categories;
+        TArray<FRRFrameTimeStats> SensorClasses;
+
+        FString ToString() const;
+    };
+
+    //! Get the singleton, hooking world ticks upon the first call, which must be on game thread
+    static FRRFrameTelemetry& Get();
+
+    static const TCHAR* GetCategoryName(const ERRFrameTimeCategory InCategory);
+
+    /**
+     * @brief Add a cost to the current step, thread-safe
+     * @param InCategory
+     * @param InSeconds
+     */
+    void AddTime(const ERRFrameTimeCategory InCategory, const double InSeconds);
+
+    /**
+     * @brief Add a sensor update to the current step, as #ERRFrameTimeCategory::SENSORS & its class, thread-safe
+     * @param InSensorClassName
+     * @param InSeconds
+     */
+    void AddSensorTime(const FName& InSensorClassName, const double InSeconds);
+
+    /**
+     * @brief End the current step, moving its costs to the rolling window & writing to CSV if due. Game thread only.
+     * @param InFrameTime [s] Real time of the whole step
+     * @param InWaitTime [s] Part of it waited by the custom time step
+     */
+    void EndStep(const double InFrameTime, const double InWaitTime);
+
+    //! Game thread only
+    FSummary GetSummary() const;
+
+    //! Game thread only
+    void Reset();
+
+    /**
+     * @brief Start appending summaries to a CSV file, one row per category & sensor class. Game thread only.
+     * @param InFilePath Truncated first
+     * @param InIntervalSec [s] Real time between summaries
+     * @return false if the file could not be written
+     */
+    bool StartCsv(const FString& InFilePath, const float InIntervalSec = 1.f);
+
+    void StopCsv();
+
+private:
+    FRRFrameTelemetry();
+
+    void OnWorldTickStart(UWorld* InWorld, ELevelTick InTickType, float InDeltaSeconds);
+    void OnWorldPostActorTick(UWorld* InWorld, ELevelTick InTickType, float InDeltaSeconds);
+    void OnPhysScenePreTick(FPhysScene_Chaos* InPhysScene, float InDeltaSeconds);
+    void OnPhysScenePostTick(FPhysScene_Chaos* InPhysScene);
+    void OnPostWorldCleanup(UWorld* InWorld, bool bInSessionEnded, bool bInCleanupResources);
+
+    void WriteCsv();
+
+    //! [ns] Costs of the current step
+    std::atomic<int64> StepTimesNanosec[static_cast<uint8>(ERRFrameTimeCategory::NUM)];
+    FCriticalSection SensorTimesMutex;
+    TMap<FName, double> StepSensorTimes;
+
+    //! Game thread only
+    TArray<FRRRollingSamples> CategoryTimesMs;
+    TMap<FName, FRRRollingSamples> SensorClassTimesMs;
+    uint64 StepsNum = 0;
+
+    //! [s] Game thread time of categories nested in world ticks & physics frames, to exclude it from those
+    double GameThreadNestedTime = 0.;
+    double WorldTickStartTime = 0.;
+    double WorldTickStartNestedTime = 0.;
+    double LastWorldTickEndTime = 0.;
+    double LastWorldTickEndNestedTime = 0.;
+    double PhysicsStartTime = 0.;
+    double PhysicsStartNestedTime = 0.;
+    TMap<UWorld*, FPhysScene_Chaos*> HookedPhysScenes;
+
+    FString CsvFilePath;
+    float CsvIntervalSec = 1.f;
+    double LastCsvTime = 0.;
+};
+
+/**
+ * @brief Add the duration of a scope to the current step's cost of a category
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRFrameTimeScope
+{
+    explicit FRRFrameTimeScope(const ERRFrameTimeCategory InCategory)
+        : Category(InCategory), StartTime(FPlatformTime::Seconds())
+    {
+    }
+
+    ~FRRFrameTimeScope()
+    {
+        FRRFrameTelemetry::Get().AddTime(Category, FPlatformTime::Seconds() - StartTime);
+    }
+
+private:
+    ERRFrameTimeCategory Category;
+    double StartTime = 0.;
+};
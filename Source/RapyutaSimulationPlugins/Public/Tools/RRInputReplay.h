@@ -0,0 +1,195 @@
+/**
+ * @file RRInputReplay.h
+ * @brief Records the ROS inputs applied to the sim keyed by sim step, then replays them for identical workloads.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// Native
+#include <atomic>
+
+// UE
+#include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "UObject/Object.h"
+
+// RapyutaSimulationPlugins
+#include "Drives/RRJointComponent.h"
+
+#include "RRInputReplay.generated.h"
+
+class ASimulationState;
+struct FROSAttachReq;
+struct FROSDeleteEntityReq;
+struct FROSSetEntityStateReq;
+struct FROSSpawnEntityReq;
+
+UENUM()
+enum class ERRInputReplayMode : uint8
+{
+    NONE,
+    //! Record the applied inputs & state checksums
+    RECORD,
+    //! Drive the sim with the recorded inputs, ignoring the live ones & verifying the recorded checksums
+    REPLAY
+};
+
+//! Recorded inputs, values being serialized into the file
+enum class ERRReplayInputType : uint8
+{
+    MOVEMENT_CMD,
+    JOINT_CMD,
+    SPAWN_ENTITY,
+    SPAWN_ENTITIES,
+    SET_ENTITY_STATE,
+    SET_ENTITY_STATES,
+    ATTACH,
+    DELETE_ENTITY,
+    STATE_CHECKSUM
+};
+
+/**
+ * @brief Records in #RECORD mode the ROS inputs of a world, as applied on game thread, into a binary file keyed by sim step:
+ * - cmd_vel & joint commands, by #URRRobotROS2Interface::ApplyPendingCmds()
+ * - spawn, set state, attach & delete requests of #URRROS2SimulationStateClient, upon reaching #ASimulationState
+ * In #REPLAY mode, live inputs are ignored & the recorded ones are applied at the start of the step they were recorded in (or
+ * of the next one if recorded after its state checksum), thus the workload is identical as long as the steps are, ie with
+ * #URRLimitRTFFixedSizeCustomTimeStep. Else steps are only counted from the start, which is not deterministic.
+ * If #bStateChecksums, a checksum of the entities' transforms is recorded every #ChecksumIntervalSteps, then compared upon
+ * replay, logging the first diverging step.
+ * Created by #ARRROS2GameMode from #ARRROS2GameMode::InputReplayMode, or -RRInputRecord=<path> / -RRInputReplay=<path>.
+ *
+ * File: "RRIR", version, step size [ns], then records of (step, type, payload size, payload).
+ */
+UCLASS()
+class RAPYUTASIMULATIONPLUGINS_API URRInputReplay : public UObject
+{
+    GENERATED_BODY()
+
+public:
+    static constexpr uint32 FILE_VERSION = 1;
+
+    //! The recording or replaying instance of InWorld, nullptr if none
+    static URRInputReplay* Get(const UWorld* InWorld);
+
+    //! Whether any world is replaying, thus live ROS commands are to be ignored, thread-safe
+    static bool IsAnyReplaying()
+    {
+        return SReplayingNum.load(std::memory_order_relaxed) > 0;
+    }
+
+    /**
+     * @brief Open InFilePath for recording or replaying & register this as the instance of InSimState's world
+     * @param InSimState Which requests are replayed to & entities are checksummed
+     * @param InMode
+     * @param InFilePath
+     * @return true if started
+     */
+    bool Start(ASimulationState* InSimState, const ERRInputReplayMode InMode, const FString& InFilePath);
+
+    //! Close the file, logging the replay results
+    void Stop();
+
+    ERRInputReplayMode GetMode() const
+    {
+        return Mode;
+    }
+
+    bool IsRecording() const
+    {
+        return ERRInputReplayMode::RECORD == Mode;
+    }
+
+    bool IsReplaying() const
+    {
+        return ERRInputReplayMode::REPLAY == Mode;
+    }
+
+    //! Current sim step of the world, the fixed step index if #URRLimitRTFFixedSizeCustomTimeStep is used
+    int64 GetStep() const;
+
+    //! Whether all records have been replayed
+    bool IsReplayFinished() const
+    {
+        return IsReplaying() && (ReplayOffset >= ReplayData.Num());
+    }
+
+    int32 GetChecksumMismatchesNum() const
+    {
+        return ChecksumMismatchesNum;
+    }
+
+    // Recording, no-op unless #IsRecording()
+    void RecordMovementCmd(const FString& InRobotName, const FVector& InLinearVel, const FVector& InAngularVel);
+    void RecordJointCmd(const FString& InRobotName,
+                        const TArray<FString>& InNames,
+                        const ERRJointControlType InControlType,
+                        const TArray<float>& InValues);
+    void RecordSpawnEntity(const FROSSpawnEntityReq& InRequest, const int32 InNetworkPlayerId);
+    void RecordSpawnEntities(const TArray<FROSSpawnEntityReq>& InRequests, const int32 InNetworkPlayerId);
+    void RecordSetEntityState(const FROSSetEntityStateReq& InRequest);
+    void RecordSetEntityStates(const TArray<FROSSetEntityStateReq>& InRequests);
+    void RecordAttach(const FROSAttachReq& InRequest);
+    void RecordDeleteEntity(const FROSDeleteEntityReq& InRequest);
+
+    //! Record/verify a checksum of the entities' transforms every #ChecksumIntervalSteps
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bStateChecksums = true;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 ChecksumIntervalSteps = 10;
+
+    //! [cm] Quantization of the checksummed locations, absorbing float noise below it
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float ChecksumLocationTolerance = 0.01f;
+
+protected:
+    virtual void BeginDestroy() override;
+
+    /**
+     * @brief Apply the records up to InStep, stopping at the checksum of InStep unless bInPostTick
+     * @param InStep
+     * @param bInPostTick Whether the world has ticked InStep, thus its checksum is verified
+     */
+    void Replay(const int64 InStep, const bool bInPostTick);
+
+    void ApplyRecord(const ERRReplayInputType InType, FArchive& InPayload, const int64 InStep);
+
+    //! Checksum of the transforms of #SimState's entities, in name order
+    uint32 ComputeStateChecksum() const;
+
+    //! Append a record, whose payload is written by InWritePayload into an FArchive
+    void WriteRecord(const ERRReplayInputType InType, const TFunctionRef<void(FArchive&)>& InWritePayload);
+
+    void OnWorldPreActorTick(UWorld* InWorld, ELevelTick InTickType, float InDeltaSeconds);
+    void OnWorldPostActorTick(UWorld* InWorld, ELevelTick InTickType, float InDeltaSeconds);
+
+    static TMap<const UWorld*, TWeakObjectPtr<URRInputReplay>> SReplays;
+    static std::atomic<int32> SReplayingNum;
+
+    UPROPERTY()
+    ASimulationState* SimState = nullptr;
+
+    ERRInputReplayMode Mode = ERRInputReplayMode::NONE;
+    FString FilePath;
+
+    //! Recording
+    TUniquePtr<FArchive> Writer;
+    TArray<uint8> PayloadBuffer;
+
+    //! Replaying, the whole file being loaded at start
+    TArray<uint8> ReplayData;
+    int64 ReplayOffset = 0;
+    int64 ReplayedRecordsNum = 0;
+    int32 ChecksumMismatchesNum = 0;
+    int64 FirstMismatchStep = -1;
+    bool bReplayFinishLogged = false;
+
+    //! Steps counted since #Start() if the engine time step is not fixed
+    int64 CountedSteps = 0;
+    int64 LastChecksumStep = -1;
+
+    FDelegateHandle PreActorTickHandle;
+    FDelegateHandle PostActorTickHandle;
+};
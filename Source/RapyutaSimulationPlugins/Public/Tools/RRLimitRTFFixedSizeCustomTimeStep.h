@@ -5,11 +5,36 @@
  */
 
 #pragma once
+
+// Native
+#include <atomic>
+
 #include "Engine/EngineCustomTimeStep.h"
 
 #include "RRLimitRTFFixedSizeCustomTimeStep.generated.h"
 
 class UEngine;
+class UWorld;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FRROnSimStepped, int64 /* SimTimeNanosec */);
+
+/**
+ * @brief Real-time statistics of #URRLimitRTFFixedSizeCustomTimeStep, over its latest completed stats interval
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRTimeStepStats
+{
+    uint64 StepsNum = 0;
+    //! Sim time over real time
+    double AchievedRTF = 0.0;
+    //! [s] Mean time waited per step to not go over the target RTF
+    double MeanWaitTime = 0.0;
+    //! Ratio of real time spent waiting, thus idle
+    double WaitRatio = 0.0;
+    //! [s] Max time by which a wait went past its deadline
+    double MaxLateness = 0.0;
+    //! [s] Time by which sleeps are currently shortened to compensate oversleeping
+    double OversleepEstimate = 0.0;
+};
 
 /**
  * @brief Control the Engine TimeStep via a fixed time step and limit RTF(Real Time Factor).
@@ -88,6 +113,19 @@ public:
      */
     virtual void SetTargetRTF(const float InTargetRTF);
 
+    /**
+     * @brief Get the RTF currently limited to, being adapted by the governor from #TargetRTF if #bAdaptiveRTF
+     *
+     * @return float
+     */
+    float GetEffectiveRTF() const;
+
+    /**
+     * @brief Report a ROS consumer lagging behind, eg a subscriber ack overdue, lowering the RTF if #bAdaptiveRTF.
+     * Thread-safe.
+     */
+    void ReportConsumerLag();
+
     /**
      * @brief Main logic to update simulation time.
      * Simulation time += #StepSize and wait not to over #TargetRTF.
@@ -97,6 +135,46 @@ public:
      */
     virtual bool WaitForSync();
 
+    //! Real-time statistics over the latest completed #StatsIntervalSec
+    const FRRTimeStepStats& GetStats() const
+    {
+        return Stats;
+    }
+
+    //! Get the custom time step in use by the engine, if of this class
+    static URRLimitRTFFixedSizeCustomTimeStep* Get();
+
+    //! #StepSize in integer nanoseconds, the unit by which sim time is accumulated
+    int64 GetStepSizeNanosec() const
+    {
+        return StepSizeNanosec;
+    }
+
+    //! Sim time accumulated over all steps taken since the engine started, in integer nanoseconds
+    int64 GetSimTimeNanosec() const
+    {
+        return SimTimeNanosec;
+    }
+
+    /**
+     * @brief Convert a world's time, being the sum of its fixed steps, to integer nanoseconds, by snapping it to the step grid.
+     * Thus bit-identical across runs & free of the precision loss of accumulated floating-point steps, as long as the step
+     * size is kept constant & time is not dilated, else the time is simply rounded.
+     * @param InWorld
+     * @return int64
+     */
+    int64 GetWorldTimeNanosec(const UWorld* InWorld) const;
+
+    /**
+     * @brief Sim time of the physics state seen on game thread, being #GetSimTimeNanosec() lagged by the steps the async
+     * physics results are interpolated behind if #bAsyncPhysics, eg to stamp poses read from bodies.
+     * @return int64
+     */
+    int64 GetPhysicsTimeNanosec() const;
+
+    //! Broadcast once per fixed step taken, ahead of the engine tick it starts, eg to publish /clock at the sim step rate
+    FRROnSimStepped OnSimStepped;
+
 public:
     /** Desired step size */
     UPROPERTY(EditAnywhere, Category = "Timing")
@@ -110,4 +188,105 @@ public:
 
     UPROPERTY()
     double LastPlatformTime = 0;
+
+    //! [s] Real time interval over which #GetStats() are computed
+    UPROPERTY(EditAnywhere, Category = "Timing")
+    float StatsIntervalSec = 5.f;
+
+    //! Log #GetStats() once every #StatsIntervalSec, and adaptive RTF changes
+    UPROPERTY(EditAnywhere, Category = "Timing")
+    bool bLogStats = false;
+
+    /**
+     * Adapt the RTF, starting from #TargetRTF, to the max sustainable one within [#MinAdaptiveRTF, #MaxAdaptiveRTF]:
+     * every #AdaptiveRTFIntervalSec, it is lowered by #AdaptiveRTFDecreaseFactor if ROS consumers lag behind, ie sensor msgs
+     * were dropped or more than #MaxPendingMsgsNum are pending in #FRRROS2PublisherThread, or #ReportConsumerLag() was
+     * called, else raised by #AdaptiveRTFIncreaseRatio up to what the measured frame cost could sustain.
+     */
+    UPROPERTY(EditAnywhere, Category = "Timing|Adaptive RTF")
+    bool bAdaptiveRTF = false;
+
+    UPROPERTY(EditAnywhere, Category = "Timing|Adaptive RTF")
+    float MinAdaptiveRTF = 0.1f;
+
+    UPROPERTY(EditAnywhere, Category = "Timing|Adaptive RTF")
+    float MaxAdaptiveRTF = 10.f;
+
+    //! [s] Real time interval between RTF adaptations
+    UPROPERTY(EditAnywhere, Category = "Timing|Adaptive RTF")
+    float AdaptiveRTFIntervalSec = 1.f;
+
+    UPROPERTY(EditAnywhere, Category = "Timing|Adaptive RTF")
+    float AdaptiveRTFIncreaseRatio = 0.05f;
+
+    UPROPERTY(EditAnywhere, Category = "Timing|Adaptive RTF")
+    float AdaptiveRTFDecreaseFactor = 0.7f;
+
+    UPROPERTY(EditAnywhere, Category = "Timing|Adaptive RTF")
+    int32 MaxPendingMsgsNum = 8;
+
+    /**
+     * Run Chaos on its own thread (UPhysicsSettings::bTickPhysicsAsync), overlapping the game tick, rendering & sensors,
+     * with one physics step of #StepSize per game step, thus physics time, sim time & /clock advancing together.
+     * The game thread then sees the results of the previous step, see #GetPhysicsTimeNanosec(). Physics joints' control
+     * laws, drive targets & IMUs keep running on the physics thread through #FRRPhysicsSubstepManager.
+     * Set from [/Script/Engine.Engine] bAsyncPhysics, applied upon #Initialize() & #SetStepSize().
+     */
+    UPROPERTY(EditAnywhere, Category = "Timing|Async Physics")
+    bool bAsyncPhysics = false;
+
+protected:
+    /**
+     * @brief Take one fixed step: set the engine's delta & current time, accumulate #SimTimeNanosec & broadcast #OnSimStepped
+     * @param InIdleTime [s] Time waited for this step
+     */
+    void AdvanceStep(const double InIdleTime);
+
+    /**
+     * @brief Sleep till the given platform time with a high-resolution timer (absolute clock_nanosleep() on Linux), waking up
+     * early by the measured #OversleepEstimate, then only yield for the remainder, instead of spinning a core.
+     * @param InWaitEndTime [s] Platform time
+     */
+    void WaitUntil(const double InWaitEndTime);
+
+    void UpdateStats(const double InRealStepTime, const double InWaitTime);
+
+    //! Set the physics settings of #bAsyncPhysics, read by Chaos upon each frame
+    void ApplyAsyncPhysicsSettings();
+
+    //! Num of steps the game thread physics results lag behind, upon async physics
+    int64 AsyncPhysicsLagStepsNum = 0;
+
+    //! Smoothing factor of #OversleepEstimate, as exponential moving average
+    static constexpr double OVERSLEEP_SMOOTHING = 0.1;
+    //! [s] Bound of #OversleepEstimate, against outliers eg upon process suspension
+    static constexpr double MAX_OVERSLEEP_ESTIMATE = 0.002;
+    double OversleepEstimate = 0.0;
+
+    struct FRRTimeStepStatsWindow
+    {
+        uint64 StepsNum = 0;
+        double SimTime = 0.0;
+        double RealTime = 0.0;
+        double WaitTime = 0.0;
+        double MaxLateness = 0.0;
+    };
+    FRRTimeStepStatsWindow StatsWindow;
+    FRRTimeStepStats Stats;
+
+    void UpdateAdaptiveRTF(const double InRealStepTime, const double InWaitTime);
+
+    struct FRRGovernorWindow
+    {
+        uint64 StepsNum = 0;
+        double RealTime = 0.0;
+        double BusyTime = 0.0;
+    };
+    FRRGovernorWindow GovernorWindow;
+    float EffectiveRTF = 1.f;
+    int64 LastDroppedMsgsNum = 0;
+    std::atomic<int32> ConsumerLagReportsNum = {0};
+
+    int64 StepSizeNanosec = 10000000;
+    int64 SimTimeNanosec = 0;
 };
@@ -0,0 +1,109 @@
+/**
+ * @file RRLockstepCustomTimeStep.h
+ * @brief CustomTimeStep class which advances fixed time steps only upon external requests, in lockstep with ROS controllers
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+#include "HAL/CriticalSection.h"
+
+// RapyutaSimulationPlugins
+#include "Tools/RRLimitRTFFixedSizeCustomTimeStep.h"
+
+#include "RRLockstepCustomTimeStep.generated.h"
+
+class UROS2GenericMsg;
+class UROS2GenericSrv;
+class UROS2NodeComponent;
+
+/**
+ * @brief Control the Engine TimeStep via fixed time steps, each of which is only taken once granted, with no real-time wait,
+ * thus running as fast as the slowest component instead of at a conservative fixed RTF, eg for RL or CI.
+ * Steps are granted:
+ * - #StepsPerRequestNum per call to #StepSimulationSrvName service (example_interfaces/SetBool with data = true),
+ * - #StepsPerAcksNum once every controller of #AckControllerNames has acknowledged the previous batch of steps,
+ * by publishing its name to #AckTopicName (std_msgs/String). Granted steps wait for those acks too.
+ * While no step is granted, zero-length frames are run every #HoldSleepSec, without advancing sim time, so that ROS
+ * callbacks keep being processed. Lockstep is only in effect once #InitROS2() is called, eg by #ARRROS2GameMode, and
+ * while #bLockstepEnabled, else it behaves as its parent, limiting RTF.
+ * Requests & acks are thread-safe, since ROS callbacks could be invoked from a ROS working thread.
+ */
+UCLASS(Blueprintable, editinlinenew, meta = (DisplayName = "Lockstep Fixed Rate"))
+class RAPYUTASIMULATIONPLUGINS_API URRLockstepCustomTimeStep : public URRLimitRTFFixedSizeCustomTimeStep
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * @brief Create the step service & ack subscriber in the given node, resetting the lockstep state
+     * @param InROS2Node
+     */
+    virtual void InitROS2(UROS2NodeComponent* InROS2Node);
+
+    /**
+     * @brief Take the next fixed step if granted & acknowledged, else run a zero-length frame
+     * @return true
+     */
+    virtual bool WaitForSync() override;
+
+    /**
+     * @brief Grant more steps, thread-safe
+     * @param InStepsNum
+     */
+    void RequestSteps(const int32 InStepsNum);
+
+    /**
+     * @brief Acknowledge the latest batch of steps on behalf of a controller, thread-safe
+     * @param InControllerName One of #AckControllerNames
+     */
+    void Acknowledge(const FString& InControllerName);
+
+    //! Num of granted steps left to be taken
+    int32 GetStepsLeftNum() const;
+
+    //! Callback of #StepSimulationSrvName, granting #StepsPerRequestNum steps if data is true
+    UFUNCTION()
+    void StepSimulationSrv(UROS2GenericSrv* InService);
+
+    //! Callback of #AckTopicName, acknowledging on behalf of the controller name in msg
+    UFUNCTION()
+    void AckCallback(const UROS2GenericMsg* InMsg);
+
+public:
+    UPROPERTY(EditAnywhere, Category = "Lockstep")
+    bool bLockstepEnabled = true;
+
+    UPROPERTY(EditAnywhere, Category = "Lockstep")
+    FString StepSimulationSrvName = TEXT("StepSimulation");
+
+    UPROPERTY(EditAnywhere, Category = "Lockstep")
+    FString AckTopicName = TEXT("lockstep_ack");
+
+    //! Steps granted per #StepSimulationSrvName request
+    UPROPERTY(EditAnywhere, Category = "Lockstep", meta = (ClampMin = "1"))
+    int32 StepsPerRequestNum = 1;
+
+    //! Steps granted automatically once all #AckControllerNames have acknowledged the previous batch, 0 to only step on requests
+    UPROPERTY(EditAnywhere, Category = "Lockstep", meta = (ClampMin = "0"))
+    int32 StepsPerAcksNum = 0;
+
+    //! Controllers whose acks are awaited after each batch of steps, none to never wait
+    UPROPERTY(EditAnywhere, Category = "Lockstep")
+    TArray<FString> AckControllerNames;
+
+    //! [s] Sleep of each zero-length frame while holding
+    UPROPERTY(EditAnywhere, Category = "Lockstep")
+    float HoldSleepSec = 0.001f;
+
+protected:
+    //! Take one granted step if all acks of the previous batch are in, opening the next batch once its steps are over
+    bool ConsumeStep();
+
+    mutable FCriticalSection LockstepMutex;
+    int32 StepsLeftNum = 0;
+    TSet<FString> PendingAckNames;
+    bool bROS2Inited = false;
+};
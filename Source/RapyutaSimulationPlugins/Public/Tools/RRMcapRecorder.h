@@ -0,0 +1,182 @@
+/**
+ * @file RRMcapRecorder.h
+ * @brief In-process recorder of the published ROS 2 msgs into an MCAP file, without DDS transport.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// Native
+#include <atomic>
+
+// UE
+#include "Containers/Queue.h"
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+
+struct rcl_publisher_t;
+struct rosidl_message_type_support_t;
+class FRunnableThread;
+class IFileHandle;
+class UROS2Publisher;
+
+/**
+ * @brief A serialized msg handed off to the writer thread
+ */
+struct FRRMcapMessage
+{
+    uint16 ChannelId = 0;
+    uint32 Sequence = 0;
+    //! [ns] Sim time
+    uint64 LogTime = 0;
+    //! CDR
+    TArray<uint8> Data;
+};
+
+/**
+ * @brief Records the msgs of the sim's own publishers, ie #URRROS2BaseSensorPublisher subclasses, #URRROS2TFPublisher,
+ * #URRROS2TFAggregatePublisher & #URRROS2ClockPublisher, into an MCAP file, as they are published, instead of an external
+ * `ros2 bag record` paying for the DDS transport & deserialization of every msg.
+ * Each msg is CDR-serialized from its already filled ROS msg with rmw_serialize on the publishing thread, then handed off
+ * through a lock-free queue to a writer thread, which buffers it into its topic's chunk, compressed with LZ4 once reaching
+ * `rr.Record.ChunkSizeKB`. Schemas are generated as ros2msg definitions from the msg introspection type support.
+ * Msgs are dropped once `rr.Record.MaxPendingMB` of them are pending, eg on a slow disk.
+ * Started with #ARRROS2GameMode::McapRecordFilePath, `-RRRecord=<file path>` or `rr.Record <file path>`, stopped with
+ * `rr.Record stop` or upon the game mode end play, the summary being written upon stop.
+ * @sa [MCAP format](https://mcap.dev/spec)
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRMcapRecorder : public FRunnable
+{
+public:
+    static FRRMcapRecorder& Get();
+
+    //! Checked by publishers before serializing anything
+    FORCEINLINE static bool IsRecording()
+    {
+        return SRecording.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Open the file & start the writer thread, game thread only
+     * @param InFilePath .mcap appended if missing
+     * @return true if recording
+     */
+    bool StartRecording(const FString& InFilePath);
+
+    //! Write the pending msgs & summary and close the file, game thread only
+    void StopRecording();
+
+    /**
+     * @brief Serialize & hand off a published msg, thread-safe, no-op if not recording
+     * @param InPublisher Publisher of the msg, giving its resolved topic name
+     * @param InTypeSupport
+     * @param InROSMsg rcl msg
+     * @param InLogTimeNanosec Sim time of the msg
+     */
+    void Record(const rcl_publisher_t& InPublisher,
+                const rosidl_message_type_support_t* InTypeSupport,
+                const void* InROSMsg,
+                const int64 InLogTimeNanosec);
+
+    /**
+     * @brief Record the msg just published by a publisher, ie its #TopicMessage, no-op if not recording
+     * @param InPublisher
+     * @param InLogTimeNanosec
+     */
+    static void RecordPublished(UROS2Publisher& InPublisher, const int64 InLogTimeNanosec);
+
+    int64 GetRecordedMsgsNum() const
+    {
+        return RecordedMsgsNum;
+    }
+
+    int64 GetDroppedMsgsNum() const
+    {
+        return DroppedMsgsNum;
+    }
+
+    // FRunnable
+    virtual uint32 Run() override;
+    virtual void Stop() override;
+
+private:
+    struct FSchema
+    {
+        //! Eg sensor_msgs/msg/LaserScan
+        FString Name;
+        //! ros2msg, empty if the type has no introspection type support
+        FString Definition;
+    };
+
+    struct FChannel
+    {
+        FString Topic;
+        uint16 SchemaId = 0;
+        uint32 NextSequence = 0;
+    };
+
+    //! Chunk being filled by the writer thread
+    struct FChunk
+    {
+        TArray<uint8> Records;
+        uint64 MessageStartTime = 0;
+        uint64 MessageEndTime = 0;
+    };
+
+    struct FChunkIndex
+    {
+        uint64 MessageStartTime = 0;
+        uint64 MessageEndTime = 0;
+        uint64 ChunkStartOffset = 0;
+        uint64 ChunkLength = 0;
+        uint64 CompressedSize = 0;
+        uint64 UncompressedSize = 0;
+        bool bLZ4 = false;
+    };
+
+    static std::atomic<bool> SRecording;
+
+    //! Get or add the channel of a topic, with #ChannelsMutex held
+    uint16 FindOrAddChannel(const FString& InTopic, const rosidl_message_type_support_t* InTypeSupport);
+
+    //! Writer thread
+    void WriteMessage(FRRMcapMessage& InMessage);
+    void FlushChunk(const uint16 InChannelId, FChunk& InChunk);
+    void WriteSchemaAndChannel(const uint16 InChannelId);
+    void WriteSummary();
+    void WriteRecord(const uint8 InOpCode, const TArray<uint8>& InContent);
+    void WriteBytes(const uint8* InData, const int64 InSize);
+
+    //! Guards #Schemas, #SchemaIds, #Channels & #ChannelIds
+    FCriticalSection ChannelsMutex;
+    //! Indexed by id - 1
+    TArray<FSchema> Schemas;
+    TMap<FString, uint16> SchemaIds;
+    //! Indexed by id - 1
+    TArray<FChannel> Channels;
+    TMap<FString, uint16> ChannelIds;
+
+    TQueue<FRRMcapMessage, EQueueMode::Mpsc> Queue;
+    std::atomic<int64> PendingBytes = {0};
+    std::atomic<int64> RecordedMsgsNum = {0};
+    std::atomic<int64> DroppedMsgsNum = {0};
+
+    FRunnableThread* Thread = nullptr;
+    FEvent* WakeEvent = nullptr;
+    std::atomic<bool> bStopping = {false};
+    //! Compressing chunks with LZ4, else uncompressed, from `rr.Record.Compression` upon start
+    bool bLZ4 = true;
+    int64 ChunkSize = 0;
+
+    // Writer thread state
+    IFileHandle* FileHandle = nullptr;
+    uint64 FileOffset = 0;
+    TMap<uint16, FChunk> Chunks;
+    TArray<FChunkIndex> ChunkIndexes;
+    TSet<uint16> WrittenSchemaIds;
+    TSet<uint16> WrittenChannelIds;
+    TMap<uint16, uint64> ChannelMessageCounts;
+    uint64 MessageStartTime = TNumericLimits<uint64>::Max();
+    uint64 MessageEndTime = 0;
+    FString FilePath;
+};
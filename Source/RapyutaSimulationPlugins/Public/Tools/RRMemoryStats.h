@@ -0,0 +1,65 @@
+/**
+ * @file RRMemoryStats.h
+ * @brief Memory held per plugin subsystem, as Low-Level Memory tracker tags & on-demand accounting.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+
+//! LLM tags of the plugin's allocations, reported with -llm & `stat LLMFULL`
+LLM_DECLARE_TAG_API(RRMeshData, RAPYUTASIMULATIONPLUGINS_API);
+LLM_DECLARE_TAG_API(RRResources, RAPYUTASIMULATIONPLUGINS_API);
+LLM_DECLARE_TAG_API(RRLidar, RAPYUTASIMULATIONPLUGINS_API);
+LLM_DECLARE_TAG_API(RRCamera, RAPYUTASIMULATIONPLUGINS_API);
+LLM_DECLARE_TAG_API(RRROS2Msgs, RAPYUTASIMULATIONPLUGINS_API);
+
+//! Accounted subsystems
+enum class ERRMemorySubsystem : uint8
+{
+    //! #FRRMeshData::MeshDataStore
+    MESH_DATA_STORE,
+    //! Objects kept alive by #URRGameSingleton's resource store, estimated CPU & GPU resource sizes
+    RESOURCE_STORE,
+    //! #URRBaseLidarComponent scan buffers, RecordedHits included
+    LIDAR_SCAN_BUFFERS,
+    //! #URRROS2CameraComponent readback ring images
+    CAMERA_RENDER_REQUESTS,
+    //! Sensor-held ROS 2 msg data, ie camera images, plus the msgs pending in #FRRROS2PublisherThread as items
+    ROS2_MSGS,
+    NUM
+};
+
+/**
+ * @brief Memory of a subsystem
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRMemorySubsystemStats
+{
+    FString Name;
+    int64 Bytes = 0;
+    //! Entries, objects or components accounted
+    int32 ItemsNum = 0;
+};
+
+/**
+ * @brief Accounts on demand the memory of each #ERRMemorySubsystem, complementing the LLM tags which only track
+ * allocations made in their scopes & require -llm.
+ * Logged with `rr.MemStats` & published by #URRROS2MemoryStatsPublisher.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRMemoryStats
+{
+public:
+    static const TCHAR* GetSubsystemName(const ERRMemorySubsystem InSubsystem);
+
+    /**
+     * @brief Gather the stats, game thread only
+     * @param InWorld Whose sensors are accounted, all worlds' if nullptr
+     * @return One per #ERRMemorySubsystem
+     */
+    static TArray<FRRMemorySubsystemStats> Gather(const UWorld* InWorld = nullptr);
+
+    static FString ToString(const TArray<FRRMemorySubsystemStats>& InStats);
+};
@@ -0,0 +1,73 @@
+/**
+ * @file RRMicroBenchmarks.h
+ * @brief Micro-benchmarks of hot utility & sensor packing code, compared to stored baselines for regression reports.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+/**
+ * @brief Timing of one micro-benchmark
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRBenchmarkResult
+{
+    FString Name;
+    //! Items, eg transforms or rays, processed per iteration
+    int32 ItemsNum = 0;
+    int32 Iterations = 0;
+    //! [us] Per iteration, best & mean of the rounds
+    double BestUs = 0.;
+    double MeanUs = 0.;
+    //! [us] Stored best time, 0 if none
+    double BaselineUs = 0.;
+    bool bRegressed = false;
+};
+
+/**
+ * @brief Runs micro-benchmarks of the hot code of utilities & sensors on synthetic inputs, from any running build:
+ * - #URRConversionUtils transform conversions, single & batched, & #URRGeneralUtils::GetRelativeTransform,
+ * - #FRRNoiseUtils::FillGaussian,
+ * - 2D/3D lidar msg packing, ie #URR2DLidarComponent::WriteLaserScanRays & #URR3DLidarComponent::ProcessPointCloud,
+ * - camera pixel conversion, ie #URRROS2CameraComponent::ConvertPixels,
+ * - #URRMeshUtils::ProcessMesh on the meshes of `rr.Benchmark.MeshFiles` & URDF/SDF parsing of `rr.Benchmark.ModelFiles`.
+ * Each benchmark is calibrated to `rr.Benchmark.RoundMs` per round & timed over `rr.Benchmark.Rounds` rounds, its best
+ * round being compared to the baseline stored by #SaveBaselines(), as a regression beyond `rr.Benchmark.RegressionThreshold`.
+ * Run with `rr.Benchmark [filter]`, store baselines with `rr.Benchmark save [filter]`, on game thread.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRMicroBenchmarks
+{
+public:
+    /**
+     * @brief Run the benchmarks whose name contains a filter
+     * @param InFilter All if empty
+     * @return TArray<FRRBenchmarkResult> Without baselines
+     */
+    static TArray<FRRBenchmarkResult> Run(const FString& InFilter = FString());
+
+    //! Saved/RRBenchmarks/Baselines.json, or the `-RRBenchmarkBaselines=` path
+    static FString GetBaselinesFilePath();
+
+    /**
+     * @brief Store results' best times as baselines, merged into the existing ones
+     * @param InResults
+     * @return true if the baselines file is written
+     */
+    static bool SaveBaselines(const TArray<FRRBenchmarkResult>& InResults);
+
+    /**
+     * @brief Fill results' baselines from the stored ones & flag the regressed ones
+     * @param InOutResults
+     * @return int32 Regressed num
+     */
+    static int32 CompareToBaselines(TArray<FRRBenchmarkResult>& InOutResults);
+
+    static FString ToReport(const TArray<FRRBenchmarkResult>& InResults);
+
+private:
+    static void RunConversionBenchmarks(const FString& InFilter, TArray<FRRBenchmarkResult>& OutResults);
+    static void RunSensorBenchmarks(const FString& InFilter, TArray<FRRBenchmarkResult>& OutResults);
+    static void RunFileBenchmarks(const FString& InFilter, TArray<FRRBenchmarkResult>& OutResults);
+};
@@ -73,5 +73,11 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadOnly)
     FString TriggerServiceName = TEXT("actor_tf_publisher_trigger");
 
-    void UpdateMessage(UROS2GenericMsg* InMessage) override;
+    /**
+     * @brief Update #TF from the actors, then fill stamped transform in UE frame
+     *
+     * @param OutTFData
+     * @return false if the target or reference actor is invalid
+     */
+    bool GetUETFData(FROSTFStamped& OutTFData) override;
 };
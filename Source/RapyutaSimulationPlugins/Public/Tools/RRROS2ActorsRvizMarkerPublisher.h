@@ -20,6 +20,8 @@ class AROS2Node;
 /**
  * @brief Rviz marker array publisher class. This class publishes markers for given actors.
  * Expected to create child class in BP/C++ to set marker params and actor class.
+ * Markers are kept in a persistent msg, only the poses of moved actors being rewritten. Actors removed from #Actors are
+ * published once as DELETE markers.
  */
 UCLASS(ClassGroup = (Custom), Blueprintable, meta = (BlueprintSpawnableComponent))
 class RAPYUTASIMULATIONPLUGINS_API URRROS2ActorsRvizMarkerPublisher : public UROS2Publisher
@@ -46,15 +48,52 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadOnly)
     AActor* ReferenceActor = nullptr;
 
-    //! Update Actors with GetAllActorsOfClass or not in UpdateMessages
-    //! Enable this may cause delay since GetAllActorsOfClass is slow operation.
+    //! Track #ActorClass actors in #Actors. They are fetched once with GetAllActorsOfClass, then kept updated
+    //! incrementally by the world's actor spawned & destroyed handlers.
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     bool bUpdateActorsList = false;
 
+    //! Only publish the markers of new, moved & removed actors, rviz keeping the others
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bPublishChangesOnly = false;
+
     //! Common parameters among Markers
     //! Parameters are used from this one except for name and pose.
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     FROSMarker BaseMarker;
 
     void UpdateMessage(UROS2GenericMsg* InMessage) override;
+
+    virtual void BeginDestroy() override;
+
+protected:
+    /**
+     * @brief Fetch #ActorClass actors once & bind the world's actor handlers to keep #Actors updated
+     */
+    void InitActorsRegistry();
+
+    void OnActorSpawned(AActor* InActor);
+
+    void OnActorDestroyed(AActor* InActor);
+
+    /**
+     * @brief Rebuild #Msg markers if #Actors has changed, keeping the existing markers & queueing DELETE markers for the
+     * removed actors
+     */
+    void SyncMarkers();
+
+    //! Persistent markers, sharing their indices with #MarkerActors & #MarkerTransforms
+    FROSMarkerArray Msg;
+
+    TArray<TWeakObjectPtr<AActor>> MarkerActors;
+
+    //! Actor world transforms upon their marker last update
+    TArray<FTransform> MarkerTransforms;
+
+    //! Markers of removed actors, to be published once
+    TArray<FROSMarker> DeletedMarkers;
+
+    bool bActorsRegistryInited = false;
+    FDelegateHandle ActorSpawnedHandle;
+    FDelegateHandle ActorDestroyedHandle;
 };
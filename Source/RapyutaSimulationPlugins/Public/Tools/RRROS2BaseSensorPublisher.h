@@ -17,6 +17,13 @@
 #include "RRROS2BaseSensorPublisher.generated.h"
 
 class URRROS2BaseSensorComponent;
+struct FRRROS2PublisherChannel;
+
+/**
+ * @brief Writes a sensor data snapshot it holds into a msg, on the publisher thread
+ * @sa #URRROS2BaseSensorComponent::GetROS2MsgBuilder()
+ */
+using FRRROS2MsgBuilder = TUniqueFunction<void(UROS2GenericMsg*)>;
 
 /**
  * @brief Base Sensor Publisher class. Other sensor publisher class should inherit from this class.
@@ -34,4 +41,70 @@ public:
     URRROS2BaseSensorComponent* DataSourceComponent = nullptr;
 
     virtual void UpdateMessage(UROS2GenericMsg* InMessage);
+
+    /**
+     * @brief Publish from #FRRROS2PublisherThread instead of game thread, replacing the publication timer started by Init()
+     * with a handoff timer of the same frequency. To be called after Init().
+     * @param InFrequencyHz
+     */
+    void StartAsyncPublishing(const int32 InFrequencyHz);
+
+    void StopAsyncPublishing();
+
+    /**
+     * @brief Publish on game thread by own timer instead of the publication timer started by Init(), eg to be paused &
+     * resumed by #URRROS2BaseSensorComponent::bOnDemand, which the latter cannot.
+     * @param InFrequencyHz
+     */
+    void StartTimerPublishing(const int32 InFrequencyHz);
+
+    void StopTimerPublishing();
+
+    //! Num of subscriptions currently matched with this publisher, 0 if not initialized
+    int32 GetSubscribersNum() const;
+
+    //! Whether the rcl publisher has been created on InROS2Node, eg recycled by #URRROS2InterfacePool, thus not to be re-added
+    bool IsInitializedWith(const UROS2NodeComponent* InROS2Node) const;
+
+    /**
+     * @brief Hand off the data source's msg builder to #FRRROS2PublisherThread,
+     * or publish on game thread if the data source does not provide builders.
+     */
+    void HandOff();
+
+    virtual void BeginDestroy() override;
+
+    //! Num of msgs dropped since the publisher thread had not consumed the previous ones
+    int32 GetDroppedMsgsNum() const;
+
+    /**
+     * @brief Publish messages loaned from the RMW, written in place by
+     * #URRROS2BaseSensorComponent::WriteLoanedROS2Msg, eg into shared memory with zero copy RMWs, publishing by own timer.
+     * Falls back to regular publishing if the RMW cannot loan this msg type, as for msgs of unbounded size with most RMWs,
+     * or the data source does not write loaned msgs.
+     */
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bLoanMessages = false;
+
+    //! Num of msgs published as loaned
+    int32 GetLoanedMsgsNum() const
+    {
+        return LoanedMsgsNum;
+    }
+
+    //! Num of builders the handoff ring holds
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "1"))
+    int32 HandOffCapacity = 4;
+
+protected:
+    /**
+     * @brief Borrow a msg from the RMW, have the data source write it & publish it
+     * @return false if not published, thus to be published regularly
+     */
+    bool PublishLoaned();
+
+    TSharedPtr<FRRROS2PublisherChannel> Channel;
+    int32 LoanedMsgsNum = 0;
+
+    FTimerHandle HandOffTimerHandle;
 };
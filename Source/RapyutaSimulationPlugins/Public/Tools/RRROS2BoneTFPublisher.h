@@ -0,0 +1,57 @@
+/**
+ * @file RRROS2BoneTFPublisher.h
+ * @brief Publishes the bone transforms of a skeletal mesh as a single TF msg.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+// rclUE
+#include "Msgs/ROS2TFMsg.h"
+#include "ROS2Publisher.h"
+
+#include "RRROS2BoneTFPublisher.generated.h"
+
+class USkeletalMeshComponent;
+
+/**
+ * @brief Publishes the parent-relative transforms of all bones of #SkeletalMeshComp in one tf2_msgs/TFMessage, each one
+ * from its parent bone frame, or #RootFrameId for the root bone. Bone transforms are read through
+ * #FRRBoneTransformsCache, thus shared with the other consumers of the same mesh in a frame.
+ * @sa [UROS2Publisher](https://rclue.readthedocs.io/en/devel/doxygen_generated/html/d6/dd4/class_u_r_o_s2_publisher.html)
+ */
+UCLASS(ClassGroup = (Custom), Blueprintable, meta = (BlueprintSpawnableComponent))
+class RAPYUTASIMULATIONPLUGINS_API URRROS2BoneTFPublisher : public UROS2Publisher
+{
+    GENERATED_BODY()
+
+public:
+    URRROS2BoneTFPublisher();
+
+    /**
+     * @brief Set topic & QoS of /tf
+     *
+     * @param InROS2Node
+     */
+    bool InitializeWithROS2(UROS2NodeComponent* InROS2Node) override;
+
+    void UpdateMessage(UROS2GenericMsg* InMessage) override;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    USkeletalMeshComponent* SkeletalMeshComp = nullptr;
+
+    //! Parent frame of the root bone
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FString RootFrameId = TEXT("base_link");
+
+    //! Prefix of bone frame ids, eg the robot namespace
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FString FramePrefix;
+
+protected:
+    //! Persistent msg, whose frame ids are only rebuilt upon the bones changing
+    FROSTFMsg Msg;
+};
@@ -11,12 +11,15 @@
 #include "CoreMinimal.h"
 
 // rclUE
+#include "Msgs/ROS2Clock.h"
 #include "ROS2Publisher.h"
 
 #include "RRROS2ClockPublisher.generated.h"
 
 /**
  * @brief Clock publisher class. Get elapsed time by UGameplayStatics.
+ * If #bSyncWithSimSteps and the engine uses #URRLimitRTFFixedSizeCustomTimeStep, the clock is published once per
+ * #SimStepsPerPublishNum fixed steps, driven by the custom time step itself, else once per core ticker tick.
  * @sa [UGameplayStatics::GetTimeSeconds](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/Kismet/UGameplayStatics/GetTimeSeconds/)
  */
 UCLASS(ClassGroup = (Custom), Blueprintable, meta = (BlueprintSpawnableComponent))
@@ -33,6 +36,16 @@ public:
      */
     virtual bool Init() override;
 
+    virtual void BeginDestroy() override;
+
+    //! Publish once per fixed sim step (or per #SimStepsPerPublishNum), instead of every core ticker tick
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bSyncWithSimSteps = true;
+
+    //! Decimation of the fixed sim steps, if #bSyncWithSimSteps
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "1"))
+    int32 SimStepsPerPublishNum = 1;
+
 protected:
     //! Delegate for callbacks to Tick 
     FTickerDelegate TickDelegate;
@@ -47,4 +60,21 @@ protected:
      * @param DeltaSeconds
      */
     bool Tick(float DeltaSeconds);
+
+    /**
+     * @brief Called by #URRLimitRTFFixedSizeCustomTimeStep with every fixed step if #bSyncWithSimSteps.
+     * Publishing clock msg of the world time once every #SimStepsPerPublishNum steps.
+     *
+     * @param InSimTimeNanosec
+     */
+    void OnSimStepped(int64 InSimTimeNanosec);
+
+    //! Update #ClockMsg with the current world time & publish it, unless unchanged since last one, eg while paused
+    void PublishClock(const bool bInSkipUnchanged);
+
+    //! Preallocated msg, updated in place
+    FROSClock ClockMsg;
+
+    FDelegateHandle SimSteppedHandle;
+    int32 SimStepsSincePublishNum = 0;
 };
@@ -0,0 +1,87 @@
+/**
+ * @file RRROS2CompressedImagePublisher.h
+ * @brief Compressed image publisher class, encoding camera images on worker threads
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "Async/Future.h"
+#include "CoreMinimal.h"
+
+// rclUE
+#include "Msgs/ROS2CompressedImage.h"
+
+// RapyutaSimulationPlugins
+#include "Tools/RRROS2ImagePublisher.h"
+
+#include "RRROS2CompressedImagePublisher.generated.h"
+
+class IImageWrapper;
+
+/**
+ * @brief Publishes the color image of a #URRROS2CameraComponent as sensor_msgs/CompressedImage.
+ * Each new capture is encoded to JPEG or PNG on the thread pool, while the previous encoded one is published, thus
+ * neither capture nor publishing waits on encoding. Captures arriving while an encoding is in flight are skipped.
+ * #Format follows the image_transport convention, eg "rgb8; jpeg compressed bgr8".
+ */
+UCLASS(ClassGroup = (Custom), Blueprintable, meta = (BlueprintSpawnableComponent))
+class RAPYUTASIMULATIONPLUGINS_API URRROS2CompressedImagePublisher : public URRROS2ImagePublisher
+{
+    GENERATED_BODY()
+
+public:
+    URRROS2CompressedImagePublisher();
+
+    /**
+     * @brief Set the latest encoded image to InMessage & start encoding the camera's new capture, if any.
+     * The camera image is consumed here only if this is its #URRROS2BaseSensorComponent::SensorPublisher, otherwise it is
+     * consumed by the raw image publisher.
+     * @param InMessage
+     */
+    virtual void UpdateMessage(UROS2GenericMsg* InMessage) override;
+
+    /**
+     * @brief Wait for the encoding in flight, which references this publisher's buffers
+     */
+    virtual void BeginDestroy() override;
+
+    //! jpeg or png
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FString CompressionFormat = TEXT("jpeg");
+
+    //! [1, 100], PNG compression being always lossless
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, meta = (ClampMin = "1", ClampMax = "100"))
+    int32 JpegQuality = 90;
+
+    //! Num of new captures skipped since the previous one was still being encoded
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    int32 SkippedFramesNum = 0;
+
+protected:
+    /**
+     * @brief Encode #RawImage into #EncodedData, on a worker thread
+     * @param InQuality
+     */
+    void Encode(const int32 InQuality);
+
+    TFuture<void> EncodeFuture;
+
+    //! Only used by the encoding in flight
+    TSharedPtr<IImageWrapper> ImageWrapper;
+
+    //! Copy of the camera image being encoded
+    FROSImg RawImage;
+
+    //! Staging buffer expanding 3-channel images to the 4-channel layout accepted by the image wrappers
+    TArray<uint8> BGRAImage;
+
+    TArray64<uint8> EncodedData;
+
+    //! Latest encoded msg
+    FROSCompressedImage Data;
+
+    //! Id of the camera capture last encoded, see #URRROS2CameraComponent::GetImageMsgCaptureId()
+    uint32 EncodedCaptureId = 0;
+};
@@ -0,0 +1,27 @@
+/**
+ * @file RRROS2ContactsStatePublisher.h
+ * @brief Contacts state publisher class
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+// RapyutaSimulationPlugins
+#include "Tools/RRROS2BaseSensorPublisher.h"
+
+#include "RRROS2ContactsStatePublisher.generated.h"
+
+/**
+ * @brief gazebo_msgs/ContactsState publisher of #URRROS2ContactSensorComponent
+ */
+UCLASS(ClassGroup = (Custom), Blueprintable, meta = (BlueprintSpawnableComponent))
+class RAPYUTASIMULATIONPLUGINS_API URRROS2ContactsStatePublisher : public URRROS2BaseSensorPublisher
+{
+    GENERATED_BODY()
+
+public:
+    URRROS2ContactsStatePublisher();
+};
@@ -0,0 +1,94 @@
+/**
+ * @file RRROS2EntityStatesPublisher.h
+ * @brief Publishes the states of all registered entities in a single batched msg.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+// rclUE
+#include "Msgs/ROS2ModelStates.h"
+#include "ROS2Publisher.h"
+
+#include "RRROS2EntityStatesPublisher.generated.h"
+
+/**
+ * @brief Publishes the poses & twists of all registered entities, relative to #ReferenceActor, as a single
+ * gazebo_msgs/ModelStates, instead of one EntityState msg per entity as #URRROS2StatePublisher & #URRPoseSensorManager.
+ * Entities are kept in contiguous arrays with their transform cache, which is filled in a single pass per publish.
+ * With #bDeltaCompression, only the entities having moved beyond #DeltaPositionThreshold or #DeltaAngleThreshold since
+ * their last publish are published, all of them being published every #KeyFramePeriod publishes for late subscribers.
+ * @sa [UROS2Publisher](https://rclue.readthedocs.io/en/devel/doxygen_generated/html/d6/dd4/class_u_r_o_s2_publisher.html)
+ * @sa [gazebo_msgs/ModelStates](http://docs.ros.org/en/noetic/api/gazebo_msgs/html/msg/ModelStates.html)
+ */
+UCLASS(ClassGroup = (Custom), Blueprintable, meta = (BlueprintSpawnableComponent))
+class RAPYUTASIMULATIONPLUGINS_API URRROS2EntityStatesPublisher : public UROS2Publisher
+{
+    GENERATED_BODY()
+
+public:
+    URRROS2EntityStatesPublisher();
+
+    void UpdateMessage(UROS2GenericMsg* InMessage) override;
+
+    /**
+     * @brief Register an entity, published as InName or its actor name if empty
+     *
+     * @param InEntity
+     * @param InName
+     */
+    UFUNCTION(BlueprintCallable)
+    void AddEntity(AActor* InEntity, const FString& InName = TEXT(""));
+
+    UFUNCTION(BlueprintCallable)
+    void RemoveEntity(AActor* InEntity);
+
+    UFUNCTION(BlueprintCallable)
+    void RemoveAllEntities();
+
+    int32 GetEntitiesNum() const
+    {
+        return Entities.Num();
+    }
+
+    //! Poses are relative to this actor, or to world origin if null
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    AActor* ReferenceActor = nullptr;
+
+    //! Only publish entities having moved since their last publish
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bDeltaCompression = false;
+
+    //! [cm]
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float DeltaPositionThreshold = 1.f;
+
+    //! [deg]
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float DeltaAngleThreshold = 1.f;
+
+    //! Num of publishes between two publishes of all entities with #bDeltaCompression, 0 for never
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 KeyFramePeriod = 100;
+
+protected:
+    //! Contiguous per-entity arrays, sharing their indices
+    TArray<TWeakObjectPtr<AActor>> Entities;
+    TArray<FString> EntityNames;
+    TArray<FTransform> TransformCache;
+    TArray<FTransform> PublishedTransforms;
+
+    //! Entities selected by the current update & their transforms, converted in place, reused across publishes
+    TArray<int32> PublishIndices;
+    TArray<FTransform> PublishTransforms;
+
+    void RemoveEntityAt(const int32 InIndex);
+
+    //! Persistent msg whose arrays are reused across publishes
+    FROSModelStates Msg;
+
+    int32 PublishesNum = 0;
+};
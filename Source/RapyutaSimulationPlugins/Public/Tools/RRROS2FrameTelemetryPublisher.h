@@ -0,0 +1,37 @@
+/**
+ * @file RRROS2FrameTelemetryPublisher.h
+ * @brief Publishes the frame time breakdown of #FRRFrameTelemetry as diagnostic_msgs/DiagnosticArray.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+// rclUE
+#include "ROS2Publisher.h"
+
+#include "RRROS2FrameTelemetryPublisher.generated.h"
+
+/**
+ * @brief Publishes one DiagnosticStatus per #ERRFrameTimeCategory & sensor class, with its per step percentiles as key
+ * values, plus the RTF achieved by #URRLimitRTFFixedSizeCustomTimeStep. The frame is WARN if its p95 goes over the real time
+ * budget of a step, ie step size / effective RTF, by more than #OverBudgetRatio.
+ * @sa [UROS2Publisher](https://rclue.readthedocs.io/en/devel/doxygen_generated/html/d6/dd4/class_u_r_o_s2_publisher.html)
+ * @sa [diagnostic_msgs](https://docs.ros2.org/latest/api/diagnostic_msgs/msg/DiagnosticArray.html)
+ */
+UCLASS(ClassGroup = (Custom), Blueprintable, meta = (BlueprintSpawnableComponent))
+class RAPYUTASIMULATIONPLUGINS_API URRROS2FrameTelemetryPublisher : public UROS2Publisher
+{
+    GENERATED_BODY()
+
+public:
+    URRROS2FrameTelemetryPublisher();
+
+    void UpdateMessage(UROS2GenericMsg* InMessage) override;
+
+    //! Ratio of the step real time budget by which the frame p95 may go over it before being WARN
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float OverBudgetRatio = 0.1f;
+};
@@ -16,6 +16,18 @@
 
 class URRROS2CameraComponent;
 
+/**
+ * @brief Image outputs of #URRROS2CameraComponent
+ */
+UENUM(BlueprintType)
+enum class ERRCameraOutput : uint8
+{
+    COLOR UMETA(DisplayName = "Color"),
+    DEPTH UMETA(DisplayName = "Depth", ToolTip = "Scene depth, 32FC1 [m] or 16UC1 [mm]."),
+    SEGMENTATION UMETA(DisplayName = "Segmentation", ToolTip = "Custom depth stencil value, mono8."),
+    NORMALS UMETA(DisplayName = "Normals", ToolTip = "World normals in ROS coordinates, 32FC3.")
+};
+
 /**
  * @brief Image publisher class
  * 
@@ -27,4 +39,14 @@ class RAPYUTASIMULATIONPLUGINS_API URRROS2ImagePublisher : public URRROS2BaseSen
 
 public:
     URRROS2ImagePublisher();
+
+    //! Published output of the #URRROS2CameraComponent data source
+    UPROPERTY()
+    ERRCameraOutput CameraOutput = ERRCameraOutput::COLOR;
+
+    /**
+     * @brief Set #CameraOutput of the data source camera to InMessage
+     * @param InMessage
+     */
+    virtual void UpdateMessage(UROS2GenericMsg* InMessage) override;
 };
@@ -0,0 +1,27 @@
+/**
+ * @file RRROS2ImuPublisher.h
+ * @brief IMU publisher class
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+// RapyutaSimulationPlugins
+#include "Tools/RRROS2BaseSensorPublisher.h"
+
+#include "RRROS2ImuPublisher.generated.h"
+
+/**
+ * @brief sensor_msgs/Imu publisher of #URRROS2ImuComponent
+ */
+UCLASS(ClassGroup = (Custom), Blueprintable, meta = (BlueprintSpawnableComponent))
+class RAPYUTASIMULATIONPLUGINS_API URRROS2ImuPublisher : public URRROS2BaseSensorPublisher
+{
+    GENERATED_BODY()
+
+public:
+    URRROS2ImuPublisher();
+};
@@ -0,0 +1,36 @@
+/**
+ * @file RRROS2MemoryStatsPublisher.h
+ * @brief Publishes the memory held per plugin subsystem of #FRRMemoryStats as diagnostic_msgs/DiagnosticArray.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+// rclUE
+#include "ROS2Publisher.h"
+
+#include "RRROS2MemoryStatsPublisher.generated.h"
+
+/**
+ * @brief Publishes one DiagnosticStatus per #ERRMemorySubsystem of the world, with its bytes & items num as key values.
+ * A subsystem is WARN if it holds more than #WarnMB.
+ * @sa [UROS2Publisher](https://rclue.readthedocs.io/en/devel/doxygen_generated/html/d6/dd4/class_u_r_o_s2_publisher.html)
+ * @sa [diagnostic_msgs](https://docs.ros2.org/latest/api/diagnostic_msgs/msg/DiagnosticArray.html)
+ */
+UCLASS(ClassGroup = (Custom), Blueprintable, meta = (BlueprintSpawnableComponent))
+class RAPYUTASIMULATIONPLUGINS_API URRROS2MemoryStatsPublisher : public UROS2Publisher
+{
+    GENERATED_BODY()
+
+public:
+    URRROS2MemoryStatsPublisher();
+
+    void UpdateMessage(UROS2GenericMsg* InMessage) override;
+
+    //! [MB] Memory of a subsystem above which it is WARN, 0 for never
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float WarnMB = 0.f;
+};
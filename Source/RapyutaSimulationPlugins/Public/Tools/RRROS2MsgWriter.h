@@ -0,0 +1,123 @@
+/**
+ * @file RRROS2MsgWriter.h
+ * @brief In-place writing of sensor, odom & TF msgs into their rcl msgs & pools of pre-sized msgs handed off between threads.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// Native
+#include <atomic>
+
+// UE
+#include "Containers/Queue.h"
+#include "CoreMinimal.h"
+#include "Templates/UniquePtr.h"
+
+// rclUE
+#include "Msgs/ROS2Img.h"
+#include "Msgs/ROS2Odom.h"
+#include "Msgs/ROS2PointCloud2.h"
+#include "Msgs/ROS2TFMsg.h"
+
+class UROS2GenericMsg;
+
+/**
+ * @brief Frame ids last written into a rcl msg by #FRRROS2MsgWriter, which only reassigns them upon a change, rosidl
+ * reallocating a string upon each assignment. One per written msg.
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRROS2MsgFrameIds
+{
+    FString FrameId;
+    FString ChildFrameId;
+};
+
+/**
+ * @brief Writes image & point cloud msgs into the rcl msg of a #UROS2GenericMsg in place, keeping its data buffer as long as
+ * it is large enough, instead of UROS2ImgMsg::SetMsg() & UROS2PointCloud2Msg::SetMsg() freeing & reallocating it upon each
+ * publish. The rcl msg buffers are allocated by rosidl, thus cannot take over the TArray ones, only be reused.
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRROS2MsgWriter
+{
+    /**
+     * @brief Write an image into a UROS2ImgMsg
+     * @param InImg
+     * @param InMessage
+     */
+    static void WriteImg(const FROSImg& InImg, UROS2GenericMsg* InMessage);
+
+    /**
+     * @brief Write a point cloud into a UROS2PointCloud2Msg
+     * @param InPointCloud
+     * @param InMessage
+     */
+    static void WritePointCloud2(const FROSPointCloud2& InPointCloud, UROS2GenericMsg* InMessage);
+
+    /**
+     * @brief Write an odometry in UE frame into a UROS2OdomMsg, converting it to ROS as URRConversionUtils::OdomUEToROS()
+     * without copying it
+     * @param InUEOdom
+     * @param InChildFrameId Written instead of InUEOdom.ChildFrameId, eg namespaced
+     * @param InMessage
+     * @param InOutFrameIds
+     */
+    static void WriteOdom(const FROSOdom& InUEOdom,
+                          const FString& InChildFrameId,
+                          UROS2GenericMsg* InMessage,
+                          FRRROS2MsgFrameIds& InOutFrameIds);
+
+    /**
+     * @brief Write a single stamped transform, already in ROS frame, into a UROS2TFMsgMsg, its transforms sequence being
+     * only reallocated upon not holding a single one
+     * @param InTF
+     * @param InMessage
+     * @param InOutFrameIds
+     */
+    static void WriteTF(const FROSTFStamped& InTF, UROS2GenericMsg* InMessage, FRRROS2MsgFrameIds& InOutFrameIds);
+
+    //! Headroom of a grown rcl data buffer, against reallocating it each time the data size grows slightly
+    static constexpr int64 DATA_SLACK_DIVISOR = 8;
+};
+
+/**
+ * @brief Pool of msgs recycled between a single consumer thread acquiring them, eg game thread snapshotting a sensor's data
+ * into a #FRRROS2MsgBuilder, and a single producer thread releasing them, eg #FRRROS2PublisherThread once the builder has
+ * written it, so that the msgs' arrays keep their allocation from one publish to the next.
+ * @tparam TMsg Msg struct, eg FROSPointCloud2
+ */
+template<typename TMsg>
+class TRRROS2MsgPool
+{
+public:
+    //! @param InCapacity Max num of pooled msgs, eg the handoff ring capacity + 1
+    explicit TRRROS2MsgPool(const int32 InCapacity) : Capacity(FMath::Max(InCapacity, 1))
+    {
+    }
+
+    //! @return A pooled msg, else a new one
+    TUniquePtr<TMsg> Acquire()
+    {
+        TUniquePtr<TMsg> msg;
+        if (Queue.Dequeue(msg))
+        {
+            PooledNum.fetch_sub(1, std::memory_order_relaxed);
+            return msg;
+        }
+        return MakeUnique<TMsg>();
+    }
+
+    //! Give back a msg, deleted if the pool is full
+    void Release(TUniquePtr<TMsg>&& InMsg)
+    {
+        if (InMsg.IsValid() && (PooledNum.load(std::memory_order_relaxed) < Capacity))
+        {
+            PooledNum.fetch_add(1, std::memory_order_relaxed);
+            Queue.Enqueue(MoveTemp(InMsg));
+        }
+    }
+
+private:
+    TQueue<TUniquePtr<TMsg>, EQueueMode::Spsc> Queue;
+    std::atomic<int32> PooledNum = {0};
+    const int32 Capacity;
+};
@@ -0,0 +1,95 @@
+/**
+ * @file RRROS2OccupancyGridPublisher.h
+ * @brief Publisher of a live nav_msgs/OccupancyGrid & its map_msgs/OccupancyGridUpdate partial updates.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+// rclUE
+#include "Msgs/ROS2OccupancyGrid.h"
+#include "Msgs/ROS2OccupancyGridUpdate.h"
+#include "ROS2Publisher.h"
+
+#include "RRROS2OccupancyGridPublisher.generated.h"
+
+/**
+ * @brief Publishes an occupancy grid of 0 (occupied) / 255 (free) cells as #AOccupancyMapGenerator's, in its .pgm row order,
+ * ie row 0 at min UE Y thus max ROS y, as nav_msgs/OccupancyGrid of 100 (occupied) / 0 (free) cells, rows from min ROS y.
+ * - The full grid is published on #TopicName, latched by its QoS, upon #SetGrid
+ * - Changed areas are published on #UpdatesTopicName by #UpdateGridArea, as nav2 costmap static layer or map_server
+ *   clients subscribing to [<map>_updates] expect, without republishing the full grid
+ * Both are published manually, thus without timer.
+ * @sa [nav_msgs/OccupancyGrid](https://docs.ros2.org/foxy/api/nav_msgs/msg/OccupancyGrid.html)
+ * @sa [map_msgs/OccupancyGridUpdate](https://docs.ros2.org/foxy/api/map_msgs/msg/OccupancyGridUpdate.html)
+ */
+UCLASS(ClassGroup = (Custom), Blueprintable, meta = (BlueprintSpawnableComponent))
+class RAPYUTASIMULATIONPLUGINS_API URRROS2OccupancyGridPublisher : public UROS2Publisher
+{
+    GENERATED_BODY()
+
+public:
+    URRROS2OccupancyGridPublisher();
+
+    /**
+     * @brief Also create #UpdatesPublisher in the same node
+     *
+     * @param InROS2Node
+     */
+    bool InitializeWithROS2(UROS2NodeComponent* InROS2Node) override;
+
+    //! Topic of partial updates, [<TopicName>_updates] if empty
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FString UpdatesTopicName;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FString FrameId = TEXT("map");
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
+    UROS2Publisher* UpdatesPublisher = nullptr;
+
+    /**
+     * @brief Set & publish the full grid
+     *
+     * @param InWidth
+     * @param InHeight
+     * @param InResolution [m/cell]
+     * @param InOriginX [m] ROS x of the grid's min corner
+     * @param InOriginY [m] ROS y of the grid's min corner
+     * @param InGrid InWidth x InHeight cells, 0: occupied, 255: free, else unknown
+     */
+    void SetGrid(const int32 InWidth,
+                 const int32 InHeight,
+                 const float InResolution,
+                 const float InOriginX,
+                 const float InOriginY,
+                 TArrayView<const uint8> InGrid);
+
+    /**
+     * @brief Update the cells of an area from the grid & publish them as a partial update
+     *
+     * @param InGrid Whole grid as given to #SetGrid
+     * @param InMinCell Min cell in InGrid
+     * @param InMaxCell Max cell in InGrid, included
+     */
+    void UpdateGridArea(TArrayView<const uint8> InGrid, const FIntPoint& InMinCell, const FIntPoint& InMaxCell);
+
+    bool IsGridSet() const
+    {
+        return Msg.Info.Width > 0;
+    }
+
+protected:
+    //! ROS cell value of a grid cell
+    static int8 ToROSCell(const uint8 InCell)
+    {
+        return (0 == InCell) ? 100 : ((255 == InCell) ? 0 : -1);
+    }
+
+    //! Latest full grid, kept up to date by #UpdateGridArea
+    FROSOccupancyGrid Msg;
+    FROSOccupancyGridUpdate UpdateMsg;
+};
@@ -15,6 +15,7 @@
 
 // RapyutaSimulationPlugins
 #include "Tools/RRROS2BaseSensorPublisher.h"
+#include "Tools/RRROS2MsgWriter.h"
 #include "Tools/RRROS2TFPublisher.h"
 
 #include "RRROS2OdomPublisher.generated.h"
@@ -45,6 +46,12 @@ public:
 
     void InitializeTFWithROS2(UROS2NodeComponent* InROS2Node);
 
+    /**
+     * @brief Write the odom source's data in place by #FRRROS2MsgWriter::WriteOdom, without copying nor allocating, & update
+     * the TF data.
+     *
+     * @param InMessage
+     */
     void UpdateMessage(UROS2GenericMsg* InMessage) override;
 
     /**
@@ -63,4 +70,20 @@ public:
     //! add robot name to the frame_id and ChildFrameId or not.
     UPROPERTY(BlueprintReadWrite)
     bool bAppendNodeNamespace = true;
+
+protected:
+    /**
+     * @brief Get the published child frame id, namespaced if #bAppendNodeNamespace, composed only upon the odom's one changing
+     * @param InOdomChildFrameId
+     * @return const FString&
+     */
+    const FString& GetChildFrameId(const FString& InOdomChildFrameId) const;
+
+    //! Odom child frame id #CachedChildFrameId was composed from
+    mutable FString CachedOdomChildFrameId;
+    mutable FString CachedChildFrameId;
+    mutable bool bChildFrameIdCached = false;
+
+    //! Frame ids written into #TopicMessage
+    FRRROS2MsgFrameIds WrittenFrameIds;
 };
@@ -0,0 +1,110 @@
+/**
+ * @file RRROS2PublisherThread.h
+ * @brief Dedicated thread building & publishing the msgs handed off by sensors through lock-free rings.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// Native
+#include <atomic>
+
+// UE
+#include "Containers/CircularQueue.h"
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+
+// RapyutaSimulationPlugins
+#include "Sensors/RRSensorStats.h"
+#include "Tools/RRROS2BaseSensorPublisher.h"
+
+class FRunnableThread;
+
+/**
+ * @brief Handoff ring of a publisher, see #FRRROS2PublisherThread
+ */
+struct FRRROS2PublisherChannel
+{
+    explicit FRRROS2PublisherChannel(URRROS2BaseSensorPublisher* InPublisher, const uint32 InCapacity)
+        : Publisher(InPublisher), Queue(InCapacity)
+    {
+    }
+
+    //! Only accessed by the publisher thread once added
+    URRROS2BaseSensorPublisher* Publisher = nullptr;
+
+    TCircularQueue<FRRROS2MsgBuilder> Queue;
+
+    //! Num of builders dropped since the ring was full
+    std::atomic<int32> DroppedMsgsNum = {0};
+
+    //! Stats of the data source, recording the publishes on the publisher thread
+    TSharedPtr<FRRSensorStats> Stats;
+};
+
+/**
+ * @brief Process-wide publisher thread, started upon the first channel being added & stopped upon the last being removed.
+ * Each #URRROS2BaseSensorPublisher with async publishing owns a channel, a single-producer (game thread) single-consumer
+ * (this thread) lock-free ring of msg builders. Each builder holds a compact snapshot of its sensor's data, which it
+ * writes into the publisher's msg on this thread, right before the msg is published.
+ * Only adding & removing channels takes a lock, thus never the handoff.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRROS2PublisherThread : public FRunnable
+{
+public:
+    static FRRROS2PublisherThread& Get();
+
+    /**
+     * @brief Add a channel, starting the thread if it is the first one
+     * @param InPublisher
+     * @param InCapacity Num of builders the ring holds, rounded up to a power of two
+     * @return TSharedPtr<FRRROS2PublisherChannel>
+     */
+    TSharedPtr<FRRROS2PublisherChannel> AddChannel(URRROS2BaseSensorPublisher* InPublisher, const uint32 InCapacity);
+
+    /**
+     * @brief Remove a channel & drop its pending builders, once the thread is not publishing from it.
+     * Stops the thread if this is the last channel.
+     * @param InChannel
+     */
+    void RemoveChannel(const TSharedPtr<FRRROS2PublisherChannel>& InChannel);
+
+    /**
+     * @brief Hand off a builder from game thread, without locking
+     * @param InChannel
+     * @param InBuilder
+     * @return false if the ring is full, the builder being dropped
+     */
+    bool Push(FRRROS2PublisherChannel& InChannel, FRRROS2MsgBuilder&& InBuilder);
+
+    //! Num of builders handed off but not published yet, over all channels, ie the consumer lag
+    int32 GetPendingMsgsNum() const
+    {
+        return PendingMsgsNum;
+    }
+
+    //! Num of builders dropped since start due to full rings, over all channels
+    int64 GetDroppedMsgsNum() const
+    {
+        return DroppedMsgsNum;
+    }
+
+    // FRunnable
+    virtual uint32 Run() override;
+    virtual void Stop() override;
+
+private:
+    void StartThread();
+    void StopThread();
+
+    //! Guards #Channels, held by the thread during each pass
+    FCriticalSection ChannelsMutex;
+    TArray<TSharedPtr<FRRROS2PublisherChannel>> Channels;
+
+    FRunnableThread* Thread = nullptr;
+    FEvent* WakeEvent = nullptr;
+    std::atomic<bool> bStopping = {false};
+
+    std::atomic<int32> PendingMsgsNum = {0};
+    std::atomic<int64> DroppedMsgsNum = {0};
+};
@@ -0,0 +1,37 @@
+/**
+ * @file RRROS2SensorDiagnosticsPublisher.h
+ * @brief Publishes the rolling stats of all ROS 2 sensors of the world as diagnostic_msgs/DiagnosticArray.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+// rclUE
+#include "ROS2Publisher.h"
+
+#include "RRROS2SensorDiagnosticsPublisher.generated.h"
+
+/**
+ * @brief Publishes one DiagnosticStatus per #URRROS2BaseSensorComponent of the world, with its #FRRSensorStats summary as
+ * key values. A sensor is WARN if its achieved publish rate is below #MinRateRatio of its effective frequency, or if slowed
+ * down by the overload policy of #FRRSensorScheduler, whose tier rate scales & measured RTF are in a "sensor_scheduler" status.
+ * @sa [UROS2Publisher](https://rclue.readthedocs.io/en/devel/doxygen_generated/html/d6/dd4/class_u_r_o_s2_publisher.html)
+ * @sa [diagnostic_msgs](https://docs.ros2.org/latest/api/diagnostic_msgs/msg/DiagnosticArray.html)
+ */
+UCLASS(ClassGroup = (Custom), Blueprintable, meta = (BlueprintSpawnableComponent))
+class RAPYUTASIMULATIONPLUGINS_API URRROS2SensorDiagnosticsPublisher : public UROS2Publisher
+{
+    GENERATED_BODY()
+
+public:
+    URRROS2SensorDiagnosticsPublisher();
+
+    void UpdateMessage(UROS2GenericMsg* InMessage) override;
+
+    //! Achieved publish rate ratio of the sensor frequency, below which a sensor is WARN
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float MinRateRatio = 0.8f;
+};
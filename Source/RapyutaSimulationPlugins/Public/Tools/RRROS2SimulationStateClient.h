@@ -28,11 +28,29 @@
 
 class UROS2GenericSrv;
 class ASimulationState;
+class URRROS2EntityStatesPublisher;
+
+/**
+ * @brief Entity states pushed to a client at a rate, see #URRROS2SimulationStateClient::SubscribeEntityStates()
+ */
+USTRUCT()
+struct RAPYUTASIMULATIONPLUGINS_API FRREntityStatesSubscription
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    URRROS2EntityStatesPublisher* Publisher = nullptr;
+
+    //! Subscribed names not found in #ASimulationState yet, looked up again upon each publish
+    TArray<FString> UnresolvedEntityNames;
+
+    FTimerHandle TimerHandle;
+};
 
 /**
  * @brief Provide ROS 2 interfaces to interact with UE4. This provide only ROS 2 interfaces and implementation is in #ASimulationState
  * Supported interactions: GetEntityState, SetEntityState, Attach, SpawnEntity, DeleteEntity
- *
+ * Entity states can also be pushed to clients at a rate, see #SubscribeEntityStates(), instead of polled by GetEntityState.
  */
 UCLASS()
 class RAPYUTASIMULATIONPLUGINS_API URRROS2SimulationStateClient : public UActorComponent
@@ -96,6 +114,13 @@ public:
     UFUNCTION(BlueprintCallable, Server, Reliable)
     void ServerSetEntityState(const FROSSetEntityStateReq& InRequest);
 
+    /**
+     * @brief RPC call to Server's batch SetEntityStates, sent once per frame with all SetEntityState requests received in it
+     * @param InRequests
+     */
+    UFUNCTION(Server, Reliable)
+    void ServerSetEntityStates(const TArray<FROSSetEntityStateReq>& InRequests);
+
     /**
      * @brief Callback function of Attach ROS 2 service.
      * Attach actors if those are not attached and detach actors if those are attached.
@@ -135,6 +160,13 @@ public:
     UFUNCTION(BlueprintCallable, Server, Reliable)
     void ServerSpawnEntity(const FROSSpawnEntityReq& InRequest);
 
+    /**
+     * @brief RPC call to Server's batch SpawnEntities, spawning & registering all entities together
+     * @param InRequests
+     */
+    UFUNCTION(BlueprintCallable, Server, Reliable)
+    void ServerSpawnEntities(const TArray<FROSSpawnEntityReq>& InRequests);
+
     /**
      * @brief Callback function of DeleteEntity ROS 2 service.
      * @param Service
@@ -157,6 +189,67 @@ public:
     UFUNCTION(BlueprintCallable, Server, Reliable)
     void ServerAddEntity(AActor* InEntity);
 
+    /**
+     * @brief Callback function of CaptureWorldSnapshot ROS 2 service, capturing the default world snapshot if data is true,
+     * removing it otherwise
+     * @param InService std_srvs/SetBool
+     */
+    UFUNCTION(BlueprintCallable)
+    void CaptureWorldSnapshotSrv(UROS2GenericSrv* InService);
+
+    /**
+     * @brief Callback function of RestoreWorldSnapshot ROS 2 service, restoring the default world snapshot
+     * @param InService std_srvs/SetBool, data being ignored
+     */
+    UFUNCTION(BlueprintCallable)
+    void RestoreWorldSnapshotSrv(UROS2GenericSrv* InService);
+
+    /**
+     * @brief RPC call to Server's CaptureWorldSnapshot or RemoveWorldSnapshot
+     * @param InSnapshotName
+     * @param bInCapture
+     */
+    UFUNCTION(BlueprintCallable, Server, Reliable)
+    void ServerCaptureWorldSnapshot(const FString& InSnapshotName, const bool bInCapture);
+
+    /**
+     * @brief RPC call to Server's RestoreWorldSnapshot
+     * @param InSnapshotName
+     */
+    UFUNCTION(BlueprintCallable, Server, Reliable)
+    void ServerRestoreWorldSnapshot(const FString& InSnapshotName);
+
+    /**
+     * @brief Publish the states of a set of entities as one gazebo_msgs/ModelStates on `entity_states/<InSubscriptionId>`
+     * at a rate, by a #URRROS2EntityStatesPublisher on #ROS2Node holding the entities found once, instead of clients calling
+     * GetEntityState per entity in loops. Entities not found yet are added once registered to #ServerSimState.
+     * Subscribing again with the same id replaces the previous subscription.
+     * @param InSubscriptionId Topic suffix
+     * @param InEntityNames
+     * @param InFrequencyHz 0 to unsubscribe
+     * @param InReferenceFrame Entity the poses are relative to, world if empty
+     * @return false if not subscribed
+     */
+    UFUNCTION(BlueprintCallable)
+    bool SubscribeEntityStates(const FString& InSubscriptionId,
+                               const TArray<FString>& InEntityNames,
+                               const int32 InFrequencyHz,
+                               const FString& InReferenceFrame = TEXT(""));
+
+    UFUNCTION(BlueprintCallable)
+    void UnsubscribeEntityStates(const FString& InSubscriptionId);
+
+    /**
+     * @brief Callback of the #EntityStateSubscriptionsTopicName subscriber, of which std_msgs/String data is
+     * `<subscription id> <frequency Hz> [@<reference entity>] <entity name>...`, a frequency of 0 unsubscribing.
+     * @param InMsg
+     */
+    UFUNCTION()
+    void EntityStateSubscriptionCallback(const UROS2GenericMsg* InMsg);
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FString EntityStateSubscriptionsTopicName = TEXT("entity_state_subscriptions");
+
     /**
      * @brief Set Player Id
      * @param InNetworkPlayerId
@@ -179,6 +272,21 @@ public:
 
 protected:
     virtual void OnComponentCreated() override;
+    virtual void OnComponentDestroyed(bool bDestroyingHierarchy) override;
+
+    //! SetEntityState requests received this frame, see #ServerSetEntityStates()
+    TArray<FROSSetEntityStateReq> PendingSetEntityStateRequests;
+    FDelegateHandle PostActorTickHandle;
+
+    //! Send #PendingSetEntityStateRequests, after all actors, ie ROS 2 nodes, have ticked
+    void FlushSetEntityStateRequests(UWorld* InWorld, ELevelTick InTickType, float InDeltaSeconds);
+
+    //! By subscription id, kept idle once unsubscribed
+    UPROPERTY(Transient)
+    TMap<FString, FRREntityStatesSubscription> EntityStatesSubscriptions;
+
+    //! Add the newly found entities of a subscription & publish it
+    void PublishEntityStates(const FString InSubscriptionId);
 
     //! NetworkPlayerId which is used to differenciate client in server.
     UPROPERTY(BlueprintReadOnly, Replicated)
@@ -187,6 +295,10 @@ protected:
     template<typename T>
     bool CheckEntity(TMap<FString, T>& InEntities, const FString& InEntityName, const bool bAllowEmpty = false);
     bool CheckEntity(const FString& InEntityName, const bool bAllowEmpty = false);
+    //! Check an entity by a single lookup through #ASimulationState::FindEntity(), also outputting it
+    bool CheckEntity(const FString& InEntityName, const bool bAllowEmpty, AActor*& OutEntity);
     bool CheckSpawnableEntity(const FString& InEntityName, const bool bAllowEmpty = false);
     virtual FROSSpawnEntityRes SpawnEntityImpl(FROSSpawnEntityReq& InRequest);
+    //! Validate a spawn request on this client, before RPC to Server
+    virtual FROSSpawnEntityRes CheckSpawnEntityRequest(const FROSSpawnEntityReq& InRequest);
 };
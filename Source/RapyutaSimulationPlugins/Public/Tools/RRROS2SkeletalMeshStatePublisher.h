@@ -16,7 +16,7 @@
 
 /**
  * @brief Publish pose of owner #ARobotVehicle which has skeletalmesh
- * 
+ * Its bone transforms are published by #URRROS2BoneTFPublisher.
  */
 UCLASS()
 class RAPYUTASIMULATIONPLUGINS_API URRROS2SkeletalMeshStatePublisher : public URRROS2StatePublisher
@@ -0,0 +1,32 @@
+/**
+ * @file RRROS2StartupProfilePublisher.h
+ * @brief Publishes the startup & spawn phase times of #FRRStartupProfiler as diagnostic_msgs/DiagnosticArray.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+// rclUE
+#include "ROS2Publisher.h"
+
+#include "RRROS2StartupProfilePublisher.generated.h"
+
+/**
+ * @brief Publishes one DiagnosticStatus per #ERRStartupPhase, with its cumulative count, total, mean & max times as key
+ * values, for spawn benchmarks to diff them around their spawn bursts.
+ * @sa [UROS2Publisher](https://rclue.readthedocs.io/en/devel/doxygen_generated/html/d6/dd4/class_u_r_o_s2_publisher.html)
+ * @sa [diagnostic_msgs](https://docs.ros2.org/latest/api/diagnostic_msgs/msg/DiagnosticArray.html)
+ */
+UCLASS(ClassGroup = (Custom), Blueprintable, meta = (BlueprintSpawnableComponent))
+class RAPYUTASIMULATIONPLUGINS_API URRROS2StartupProfilePublisher : public UROS2Publisher
+{
+    GENERATED_BODY()
+
+public:
+    URRROS2StartupProfilePublisher();
+
+    void UpdateMessage(UROS2GenericMsg* InMessage) override;
+};
@@ -0,0 +1,55 @@
+/**
+ * @file RRROS2StereoCameraPublisher.h
+ * @brief Publisher of the right image & camera infos of #URRROS2StereoCameraComponent
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+// RapyutaSimulationPlugins
+#include "Tools/RRROS2ImagePublisher.h"
+
+#include "RRROS2StereoCameraPublisher.generated.h"
+
+/**
+ * @brief Outputs of #URRROS2StereoCameraComponent besides the left image, published by its sensor publisher
+ */
+UENUM(BlueprintType)
+enum class ERRStereoCameraOutput : uint8
+{
+    RIGHT_IMAGE UMETA(DisplayName = "Right image"),
+    LEFT_CAMERA_INFO UMETA(DisplayName = "Left camera info"),
+    RIGHT_CAMERA_INFO UMETA(DisplayName = "Right camera info")
+};
+
+/**
+ * @brief Publishes a #ERRStereoCameraOutput of the data source #URRROS2StereoCameraComponent, as consumed along the left
+ * image, thus with the same stamp.
+ */
+UCLASS(ClassGroup = (Custom), Blueprintable, meta = (BlueprintSpawnableComponent))
+class RAPYUTASIMULATIONPLUGINS_API URRROS2StereoCameraPublisher : public URRROS2ImagePublisher
+{
+    GENERATED_BODY()
+
+public:
+    //! Also sets MsgClass, sensor_msgs/Image or sensor_msgs/CameraInfo
+    void SetStereoOutput(const ERRStereoCameraOutput InOutput);
+
+    ERRStereoCameraOutput GetStereoOutput() const
+    {
+        return StereoOutput;
+    }
+
+    /**
+     * @brief Set #StereoOutput of the data source stereo camera to InMessage
+     * @param InMessage
+     */
+    virtual void UpdateMessage(UROS2GenericMsg* InMessage) override;
+
+protected:
+    UPROPERTY()
+    ERRStereoCameraOutput StereoOutput = ERRStereoCameraOutput::RIGHT_IMAGE;
+};
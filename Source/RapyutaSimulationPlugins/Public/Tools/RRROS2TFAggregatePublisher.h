@@ -0,0 +1,107 @@
+/**
+ * @file RRROS2TFAggregatePublisher.h
+ * @brief Per-world publisher batching the transforms of all aggregated TF publishers into a single msg per frame.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+
+// rclUE
+#include "Msgs/ROS2TFMsg.h"
+#include "ROS2Publisher.h"
+
+#include "RRROS2TFAggregatePublisher.generated.h"
+
+/**
+ * @brief Publishes the transforms submitted by #URRROS2TFPublisher with #URRROS2TFPublisher::bAggregate on, instead of one
+ * msg per transform.
+ * - Dynamic: the transforms submitted during a frame are published as a single tf2_msgs/TFMessage upon
+ *   [FWorldDelegates::OnWorldPostActorTick].
+ * - Static (#IsStatic): transforms are kept by child frame id and the whole set is republished on /tf_static, latched by
+ *   its QoS, only when a transform is added or changed.
+ * Created by #ARRROS2GameMode with #ARRROS2GameMode::bAggregateTF. TF publishers of worlds without it publish by themselves.
+ *
+ * @sa [OnWorldPostActorTick](https://docs.unrealengine.com/5.1/en-US/API/Runtime/Engine/Engine/FWorldDelegates/OnWorldPostActorTick/)
+ */
+UCLASS(ClassGroup = (Custom), Blueprintable, meta = (BlueprintSpawnableComponent))
+class RAPYUTASIMULATIONPLUGINS_API URRROS2TFAggregatePublisher : public UROS2Publisher
+{
+    GENERATED_BODY()
+
+public:
+    URRROS2TFAggregatePublisher();
+
+    /**
+     * @brief Get the aggregate publisher of a world
+     *
+     * @param InWorld
+     * @param bInStatic
+     * @return URRROS2TFAggregatePublisher* nullptr if none
+     */
+    static URRROS2TFAggregatePublisher* Get(UWorld* InWorld, const bool bInStatic);
+
+    //! Publish /tf_static instead of /tf
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool IsStatic = false;
+
+    /**
+     * @brief Set topic & QoS from #IsStatic
+     *
+     * @param InROS2Node
+     */
+    bool InitializeWithROS2(UROS2NodeComponent* InROS2Node) override;
+
+    /**
+     * @brief Register this as the world's aggregate publisher & bind the per-frame publishing
+     */
+    bool Init() override;
+
+    virtual void BeginDestroy() override;
+
+    /**
+     * @brief Add a transform to the current batch
+     *
+     * @param InTF
+     */
+    void AddTransform(FROSTFStamped&& InTF);
+
+    /**
+     * @brief Add a dynamic transform in UE frame to the current batch, the batch being converted to ROS at once upon publishing
+     *
+     * @param InTF
+     */
+    void AddUETransform(FROSTFStamped&& InTF);
+
+    int32 GetPendingTransformsNum() const
+    {
+        return IsStatic ? StaticTransforms.Num() : (Transforms.Num() + UETransforms.Num());
+    }
+
+protected:
+    static TMap<UWorld*, TWeakObjectPtr<URRROS2TFAggregatePublisher>> SPublishers;
+    static TMap<UWorld*, TWeakObjectPtr<URRROS2TFAggregatePublisher>> SStaticPublishers;
+
+    void OnWorldPostActorTick(UWorld* InWorld, ELevelTick /*InTickType*/, float /*InDeltaSeconds*/);
+
+    //! Dynamic transforms submitted in the current frame
+    TArray<FROSTFStamped> Transforms;
+
+    //! Dynamic transforms submitted in UE frame in the current frame, the transforms kept contiguous for batch conversion
+    TArray<FROSTFStamped> UETransforms;
+    TArray<FTransform> UETransformsBatch;
+
+    //! Static transforms by child frame id
+    TMap<FString, FROSTFStamped> StaticTransforms;
+
+    //! #StaticTransforms changed since being last published
+    bool bStaticTransformsDirty = false;
+
+    //! Published msg, its transforms array swapped with #Transforms so that both keep their allocation across frames
+    FROSTFMsg Msg;
+
+    FDelegateHandle PostActorTickHandle;
+};
@@ -16,10 +16,15 @@
 #include "Msgs/ROS2TFMsg.h"
 #include "ROS2Publisher.h"
 
+// RapyutaSimulationPlugins
+#include "Tools/RRROS2MsgWriter.h"
+
 #include "RRROS2TFPublisher.generated.h"
 
 /**
  * @brief TF Publisher class. Please check #URRROS2OdomPublisher as example.
+ * With #bAggregate, its transform is submitted to the world's #URRROS2TFAggregatePublisher, if any, at its publication
+ * frequency instead of being published in its own msg.
  * @sa [UROS2Publisher](https://rclue.readthedocs.io/en/devel/doxygen_generated/html/d6/dd4/class_u_r_o_s2_publisher.html)
  */
 UCLASS(ClassGroup = (Custom), Blueprintable, meta = (BlueprintSpawnableComponent))
@@ -48,6 +53,10 @@ public:
     UPROPERTY(EditAnywhere, BlueprintReadWrite)
     FTransform TF = FTransform::Identity;
 
+    //! Submit to the world's #URRROS2TFAggregatePublisher if any, falling back to publishing by itself otherwise
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bAggregate = true;
+
     /**
      * @brief Initialize publisher with QoS
      *
@@ -55,6 +64,20 @@ public:
      */
     bool InitializeWithROS2(UROS2NodeComponent* InROS2Node) override;
 
+    /**
+     * @brief Replace the publication timer with #AggregateTimerHandle if #bAggregate
+     */
+    bool Init() override;
+
+    /**
+     * @brief Start publishing or submitting to the aggregate publisher
+     */
+    UFUNCTION(BlueprintCallable)
+    void StartTFPublishing();
+
+    UFUNCTION(BlueprintCallable)
+    void StopTFPublishing();
+
     /**
      * @brief Set value to #TF.
      *
@@ -65,9 +88,39 @@ public:
     void SetTransform(const FVector& Translation, const FQuat& Rotation);
 
     /**
-     * @brief Update message frorm #TF.
+     * @brief Update message frorm #TF, written in place by #FRRROS2MsgWriter::WriteTF without allocating.
      *
      * @param InMessage
      */
     void UpdateMessage(UROS2GenericMsg* InMessage) override;
+
+    /**
+     * @brief Fill stamped transform from #TF, converted to ROS by #GetUETFData.
+     *
+     * @param OutTFData
+     * @return false if there is no valid transform to publish
+     */
+    virtual bool GetTFData(FROSTFStamped& OutTFData);
+
+    /**
+     * @brief Fill stamped transform from #TF in UE frame, converted later, eg in batch by #URRROS2TFAggregatePublisher.
+     *
+     * @param OutTFData
+     * @return false if there is no valid transform to publish
+     */
+    virtual bool GetUETFData(FROSTFStamped& OutTFData);
+
+protected:
+    /**
+     * @brief Submit the transform to the world's #URRROS2TFAggregatePublisher, or publish it if there is none
+     */
+    void SubmitTF();
+
+    FTimerHandle AggregateTimerHandle;
+
+    //! Reused by #UpdateMessage across publishes, keeping its frame ids' allocations
+    FROSTFStamped TFData;
+
+    //! Frame ids written into #TopicMessage
+    FRRROS2MsgFrameIds WrittenFrameIds;
 };
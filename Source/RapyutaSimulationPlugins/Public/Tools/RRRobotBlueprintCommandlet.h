@@ -0,0 +1,32 @@
+/**
+ * @file RRRobotBlueprintCommandlet.h
+ * @brief Commandlet baking a robot assembled from its URDF/SDF model into a blueprint asset.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "Commandlets/Commandlet.h"
+#include "CoreMinimal.h"
+
+#include "RRRobotBlueprintCommandlet.generated.h"
+
+/**
+ * @brief Bake a robot offline into a blueprint, to be spawned at runtime without parsing its model, importing its meshes
+ * nor cooking its bodies. The robot class is spawned in a transient world with the model name parsed from the URDF/SDF
+ * file, its runtime-created static meshes are saved as assets with their cooked bodies, then the assembled actor is saved
+ * by #URRAssetUtils::CreateBlueprintFromActor under #URRGameSingleton::ASSETS_RUNTIME_BP_SAVE_BASE_PATH.
+ * Usage: UnrealEditor-Cmd <project> -run=RRRobotBlueprint -Robot=<robot class path> [-Model=<URDF/SDF path>] [-Name=<BP name>]
+ */
+UCLASS()
+class RAPYUTASIMULATIONPLUGINS_API URRRobotBlueprintCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    URRRobotBlueprintCommandlet();
+
+    //! @return 0 upon the blueprint being saved
+    virtual int32 Main(const FString& InParams) override;
+};
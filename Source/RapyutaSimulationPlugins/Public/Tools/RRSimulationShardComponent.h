@@ -0,0 +1,162 @@
+/**
+ * @file RRSimulationShardComponent.h
+ * @brief Spatial sharding of a site among server processes, each simulating one region of it.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "Components/ActorComponent.h"
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+
+#include "RRSimulationShardComponent.generated.h"
+
+class ASimulationState;
+
+/**
+ * @brief Partition of the site's XY plane into a grid of regions, region (x, y) being simulated by shard (y * GridSize.X + x).
+ * Locations outside of the grid belong to the nearest border region.
+ */
+USTRUCT(BlueprintType)
+struct RAPYUTASIMULATIONPLUGINS_API FRRShardLayout
+{
+    GENERATED_BODY()
+
+    //! Min XY corner of region (0, 0) [cm]
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FVector2D Origin = FVector2D::ZeroVector;
+
+    //! [cm]
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FVector2D RegionSize = FVector2D(5000.f, 5000.f);
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FIntPoint GridSize = FIntPoint(2, 1);
+
+    //! Entities within this distance of a neighbor region are mirrored there as proxies [cm]
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float BorderMargin = 500.f;
+
+    int32 Num() const
+    {
+        return GridSize.X * GridSize.Y;
+    }
+
+    int32 GetShardId(const FVector& InLocation) const;
+
+    /**
+     * @brief Get the shards, other than InShardId, whose regions are within #BorderMargin of InLocation
+     * @param InLocation
+     * @param InShardId
+     * @param OutShardIds
+     */
+    void GetBorderShardIds(const FVector& InLocation, const int32 InShardId, TArray<int32>& OutShardIds) const;
+};
+
+//! Signalled once as an owned entity has left this shard's region, with its handoff data to be imported by the target shard
+DECLARE_MULTICAST_DELEGATE_ThreeParams(FRROnShardEntityMigrating,
+                                       const FString& /* InEntityName */,
+                                       const int32 /* InTargetShardId */,
+                                       const TArray<uint8>& /* InHandoffData */);
+
+//! Signalled per update for each owned entity near the border of other shards, to update its proxies there.
+//! Empty InShardIds once the entity has moved away from borders, its proxies to be removed.
+DECLARE_MULTICAST_DELEGATE_FourParams(FRROnShardProxyUpdate,
+                                      const FString& /* InEntityName */,
+                                      const FString& /* InEntityModelName */,
+                                      const TArray<int32>& /* InShardIds */,
+                                      const FTransform& /* InTransform */);
+
+/**
+ * @brief Runs this process as one shard of a site partitioned by #Layout, to be added to the #ASimulationState actor.
+ * - Owned entities leaving the shard's region get their handoff data, their spawn request & #FRRWorldSnapshot state,
+ * signalled by #OnEntityMigrating. Once imported by the target shard with #ImportMigratedEntity(), the source shard removes
+ * its copy with #ReleaseMigratedEntity().
+ * - Owned entities near the border are signalled by #OnProxyUpdate, the neighbor shards mirroring them as kinematic,
+ * collision-free proxies with #UpdateProxy(), registered to their #ASimulationState under the same name, thus presenting a
+ * unified entity namespace around borders.
+ * Only spawnable entities (having a UROS2Spawnable component) migrate. Data transport between the shard processes, eg by
+ * ROS 2 topics or the orchestrator, is left to the delegates' listeners. Server only.
+ */
+UCLASS(ClassGroup = (Custom), meta = (BlueprintSpawnableComponent))
+class RAPYUTASIMULATIONPLUGINS_API URRSimulationShardComponent : public UActorComponent
+{
+    GENERATED_BODY()
+
+public:
+    URRSimulationShardComponent();
+
+    static constexpr const TCHAR* PROXY_TAG = TEXT("ShardProxy");
+    static constexpr uint32 HANDOFF_VERSION = 1;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FRRShardLayout Layout;
+
+    //! Region of this process, overridden by -RRShardId=<id> on command line. Sharding is disabled if INDEX_NONE.
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 ShardId = INDEX_NONE;
+
+    //! If not None, only entities with this tag migrate & get proxies, eg robots
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FName ShardedEntityTag = NAME_None;
+
+    FRROnShardEntityMigrating OnEntityMigrating;
+    FRROnShardProxyUpdate OnProxyUpdate;
+
+    bool IsEnabled() const
+    {
+        return (ShardId >= 0) && (ShardId < Layout.Num());
+    }
+
+    /**
+     * @brief Spawn an entity migrated from another shard & restore its state, replacing its proxy if any
+     * @param InHandoffData From #OnEntityMigrating
+     * @return AActor* nullptr if invalid or failed to spawn
+     */
+    AActor* ImportMigratedEntity(const TArray<uint8>& InHandoffData);
+
+    //! Remove an entity of this shard, once imported by its target shard
+    void ReleaseMigratedEntity(const FString& InEntityName);
+
+    /**
+     * @brief Spawn or move the local proxy of an entity owned by another shard
+     * @param InEntityName
+     * @param InEntityModelName Spawnable entity type name, see ASimulationState::AddSpawnableEntityTypes()
+     * @param InTransform
+     */
+    void UpdateProxy(const FString& InEntityName, const FString& InEntityModelName, const FTransform& InTransform);
+
+    void RemoveProxy(const FString& InEntityName);
+
+    static bool IsProxy(const AActor* InEntity)
+    {
+        return InEntity && InEntity->ActorHasTag(PROXY_TAG);
+    }
+
+    virtual void BeginPlay() override;
+
+    virtual void TickComponent(float InDeltaTime,
+                               ELevelTick InTickType,
+                               FActorComponentTickFunction* ThisTickFunction) override;
+
+protected:
+    UPROPERTY()
+    ASimulationState* SimState = nullptr;
+
+    //! Entities whose handoff has been signalled, awaiting #ReleaseMigratedEntity()
+    TSet<FString> MigratingEntityNames;
+
+    //! Owned entities having proxies in other shards
+    TSet<FString> BorderEntityNames;
+
+    /**
+     * @brief Serialize an owned entity's spawn parameters & state, to be spawned by #ImportMigratedEntity()
+     * @param InEntity
+     * @param InEntityName
+     * @param OutHandoffData
+     * @return false if InEntity is not spawnable
+     */
+    bool CaptureHandoffData(AActor* InEntity, const FString& InEntityName, TArray<uint8>& OutHandoffData) const;
+};
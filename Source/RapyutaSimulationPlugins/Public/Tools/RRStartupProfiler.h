@@ -0,0 +1,101 @@
+/**
+ * @file RRStartupProfiler.h
+ * @brief Cumulative time spent in each phase of the sim startup & entity spawning, for time-to-ready breakdowns.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// Native
+#include <atomic>
+
+// UE
+#include "CoreMinimal.h"
+
+//! Startup & spawn phases
+enum class ERRStartupPhase : uint8
+{
+    //! #URRGameSingleton::InitializeResources till the priority resources are loaded, spanning frames
+    RESOURCES_LOADING,
+    //! URDF/SDF model files parsing, cached models included
+    ROBOT_DESCRIPTION_PARSING,
+    //! #URRMeshUtils::LoadMeshFromFile, on loading threads
+    MESH_IMPORT,
+    //! Sync collision cooking of created mesh bodies
+    COLLISION_COOKING,
+    //! #ASimulationState spawning a checked request, including the game thread parts of the phases above run in it
+    ACTOR_SPAWN,
+    //! #URRRobotROS2Interface::Initialize
+    ROS2_INTERFACE_INIT,
+    NUM
+};
+
+/**
+ * @brief Cumulative time of a phase
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRStartupPhaseStats
+{
+    FString Name;
+    int64 Count = 0;
+    double TotalMs = 0.;
+    double MaxMs = 0.;
+};
+
+/**
+ * @brief Accumulates the time spent in each #ERRStartupPhase since the process start or the latest #Reset, recorded with
+ * #FRRStartupPhaseScope, #AddTime() or #BeginPhase()/#EndPhase() for phases spanning frames.
+ * Totals being cumulative, the breakdown of a spawn burst is the difference of the stats around it.
+ * Logged with `rr.StartupProfile` & published by #URRROS2StartupProfilePublisher.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRStartupProfiler
+{
+public:
+    static FRRStartupProfiler& Get();
+
+    static const TCHAR* GetPhaseName(const ERRStartupPhase InPhase);
+
+    //! Add one occurrence of a phase, thread-safe
+    void AddTime(const ERRStartupPhase InPhase, const double InSeconds);
+
+    //! Start a phase spanning frames, game thread only
+    void BeginPhase(const ERRStartupPhase InPhase);
+
+    //! End a phase started by #BeginPhase, game thread only
+    void EndPhase(const ERRStartupPhase InPhase);
+
+    //! One per #ERRStartupPhase
+    TArray<FRRStartupPhaseStats> GetStats() const;
+
+    FString ToString() const;
+
+    void Reset();
+
+private:
+    FRRStartupProfiler();
+
+    std::atomic<int64> Counts[static_cast<uint8>(ERRStartupPhase::NUM)];
+    std::atomic<int64> TotalNanosec[static_cast<uint8>(ERRStartupPhase::NUM)];
+    std::atomic<int64> MaxNanosec[static_cast<uint8>(ERRStartupPhase::NUM)];
+
+    //! [s] Start of the phases begun by #BeginPhase, 0 if not begun
+    double PhaseStartTimes[static_cast<uint8>(ERRStartupPhase::NUM)] = {};
+};
+
+/**
+ * @brief Records its lifetime as one occurrence of a phase
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRStartupPhaseScope
+{
+    explicit FRRStartupPhaseScope(const ERRStartupPhase InPhase) : Phase(InPhase), StartTime(FPlatformTime::Seconds())
+    {
+    }
+
+    ~FRRStartupPhaseScope()
+    {
+        FRRStartupProfiler::Get().AddTime(Phase, FPlatformTime::Seconds() - StartTime);
+    }
+
+private:
+    ERRStartupPhase Phase;
+    double StartTime;
+};
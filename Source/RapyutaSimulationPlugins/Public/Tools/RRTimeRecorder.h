@@ -0,0 +1,118 @@
+/**
+ * @file RRTimeRecorder.h
+ * @brief Low-overhead recorder of per-frame sim & wall times, streamed to disk by a background thread.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// Native
+#include <atomic>
+
+// UE
+#include "Containers/CircularQueue.h"
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+
+class FRunnableThread;
+class IFileHandle;
+
+/**
+ * @brief One frame record of #FRRTimeRecorder, written as is to binary files
+ */
+struct FRRTimeRecord
+{
+    //! World time since the recording start [ns]
+    int64 SimTimeNs = 0;
+    //! Monotonic wall time since the recording start [ns]
+    int64 WallTimeNs = 0;
+    //! Game thread time of the previous frame [us]
+    uint32 FrameCostUs = 0;
+    //! Rolling RTF over the latest #FRRTimeRecorder::RTF_WINDOW_SIZE frames, [x1e-6]
+    uint32 RTFMicro = 0;
+};
+
+/**
+ * @brief Records one #FRRTimeRecord per frame into a fixed-size single-producer (game thread) single-consumer (writer thread)
+ * lock-free ring, without any per-frame allocation, for multi-hour runs to be logged.
+ * The writer thread streams the records to a file, either binary, ie a [RRTL] header of version, record size & start Unix
+ * time [s], followed by raw records, or CSV. The RTF is computed online, cumulatively & over a rolling window.
+ * Records are dropped, & counted, if the writer thread lags behind by a full ring.
+ */
+class RAPYUTASIMULATIONPLUGINS_API FRRTimeRecorder : public FRunnable
+{
+public:
+    static constexpr uint32 VERSION = 1;
+    static constexpr int32 RTF_WINDOW_SIZE = 128;
+
+    ~FRRTimeRecorder();
+
+    /**
+     * @brief Open the file & start the writer thread
+     * @param InFilePath
+     * @param bInCsv CSV instead of binary
+     * @param InCapacity Num of records the ring holds, rounded up to a power of two
+     * @return false if the file could not be opened
+     */
+    bool Start(const FString& InFilePath, const bool bInCsv = false, const uint32 InCapacity = 4096);
+
+    //! Write the pending records, then stop the writer thread & close the file
+    void Finish();
+
+    //! Record a frame, from game thread
+    void Record(const double InSimTime, const double InFrameCostSec);
+
+    bool IsRecording() const
+    {
+        return nullptr != Thread;
+    }
+
+    double GetRTF() const
+    {
+        return RTF;
+    }
+
+    double GetRollingRTF() const
+    {
+        return RollingRTF;
+    }
+
+    int64 GetRecordsNum() const
+    {
+        return RecordsNum;
+    }
+
+    int64 GetDroppedRecordsNum() const
+    {
+        return DroppedRecordsNum;
+    }
+
+    // FRunnable
+    virtual uint32 Run() override;
+    virtual void Stop() override;
+
+private:
+    //! Write the pending records to #FileHandle, from the writer thread
+    void WritePendingRecords();
+
+    TUniquePtr<TCircularQueue<FRRTimeRecord>> Records;
+    TUniquePtr<IFileHandle> FileHandle;
+    bool bCsv = false;
+    //! Reused by the writer thread
+    TArray<uint8> WriteBuffer;
+
+    FRunnableThread* Thread = nullptr;
+    FEvent* WakeEvent = nullptr;
+    std::atomic<bool> bStopping = {false};
+
+    // Game thread only
+    double StartSimTime = 0.;
+    uint64 StartWallCycles = 0;
+    //! Latest records, for #RollingRTF
+    FRRTimeRecord RTFWindow[RTF_WINDOW_SIZE];
+    double RTF = 0.;
+    double RollingRTF = 0.;
+    int64 RecordsNum = 0;
+
+    std::atomic<int64> DroppedRecordsNum = {0};
+};
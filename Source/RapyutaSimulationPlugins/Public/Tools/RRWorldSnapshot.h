@@ -0,0 +1,85 @@
+/**
+ * @file RRWorldSnapshot.h
+ * @brief Compact binary snapshot of entities' states, to checkpoint & restore a world in memory, eg between RL episodes.
+ * @copyright Copyright 2020-2022 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "CoreMinimal.h"
+
+class AActor;
+
+/**
+ * @brief States of entities, saved to & loaded from a versioned binary blob by #Save() & #Load().
+ * Per entity: world transform, attach parent entity, simulated bodies' transforms & velocities, URRJointComponent states and
+ * the SaveGame properties of the actor & its components, eg sensors' internal states.
+ * Entities are identified by their #ASimulationState name, see ASimulationState::ServerRestoreWorldSnapshot().
+ */
+struct RAPYUTASIMULATIONPLUGINS_API FRRWorldSnapshot
+{
+    static constexpr uint32 VERSION = 1;
+
+    struct FBodyState
+    {
+        FName ComponentName;
+        FTransform Transform;
+        FVector LinearVelocity = FVector::ZeroVector;
+        //! [deg/s]
+        FVector AngularVelocity = FVector::ZeroVector;
+    };
+
+    struct FJointState
+    {
+        FName ComponentName;
+        FVector Position = FVector::ZeroVector;
+        FRotator Orientation = FRotator::ZeroRotator;
+        FVector PositionTarget = FVector::ZeroVector;
+        FRotator OrientationTarget = FRotator::ZeroRotator;
+        FVector LinearVelocityTarget = FVector::ZeroVector;
+        FVector AngularVelocityTarget = FVector::ZeroVector;
+    };
+
+    struct FEntityState
+    {
+        FString Name;
+        FTransform Transform;
+        //! Empty if not attached to an entity
+        FString AttachParentName;
+        bool bWelded = false;
+        TArray<FBodyState> Bodies;
+        TArray<FJointState> Joints;
+        //! SaveGame properties, only of the actor & components whose classes have some
+        TArray<uint8> ActorSaveGameData;
+        TMap<FName, TArray<uint8>> ComponentSaveGameData;
+    };
+
+    TArray<FEntityState> Entities;
+
+    /**
+     * @brief Record the states of an entity, except its attachment, known by its owner only
+     * @param InEntity
+     * @param InName
+     * @param OutState
+     */
+    static void CaptureEntity(AActor* InEntity, const FString& InName, FEntityState& OutState);
+
+    /**
+     * @brief Restore the states of an entity recorded by #CaptureEntity(), its attachment being handled by the caller first.
+     * Components missing since are skipped.
+     * @param InEntity
+     * @param InState
+     */
+    static void RestoreEntity(AActor* InEntity, const FEntityState& InState);
+
+    void Save(TArray<uint8>& OutData) const;
+
+    //! @return false if InData is not a snapshot of #VERSION
+    bool Load(const TArray<uint8>& InData);
+
+private:
+    static bool HasSaveGameProperties(const UClass* InClass);
+    static void SaveGameProperties(UObject* InObject, TArray<uint8>& OutData);
+    static void LoadGameProperties(UObject* InObject, const TArray<uint8>& InData);
+};
@@ -10,6 +10,7 @@
 // UE
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "Net/Serialization/FastArraySerializer.h"
 
 // rclUE
 #include "Srvs/ROS2Attach.h"
@@ -22,9 +23,16 @@
 // RapyutaSimulationPlugins
 #include "Core/RRConversionUtils.h"
 #include "Core/RRGeneralUtils.h"
+#include "Tools/RREntitySpatialHash.h"
 
 #include "SimulationState.generated.h"
 
+/**
+ * @brief Signalled on server upon an entity being spawned, moved or deleted by #ASimulationState, with its bounds before,
+ * invalid if spawned. Its current bounds are empty upon deletion.
+ */
+DECLARE_MULTICAST_DELEGATE_TwoParams(FRROnEntityBoundsChanged, const AActor* /* InEntity */, const FBox& /* InPrevBounds */);
+
 /**
  * @brief FRREntityInfo
  * This struct is used to create #SpawnableEntityInfoList
@@ -63,12 +71,106 @@ struct RAPYUTASIMULATIONPLUGINS_API FRREntities
     TArray<AActor*> Actors;
 };
 
+class ASimulationState;
+
+//! How #ASimulationState::ServerAttach() attaches an entity to another
+UENUM(BlueprintType)
+enum class ERRAttachMode : uint8
+{
+    //! Plain attachment, all components of the parent ignoring the child when sweeping
+    KINEMATIC,
+    //! Simulated bodies of the child welded into the parent's body, only the parent's root (the swept component) ignoring
+    //! the child & the child's components not updating overlaps while attached
+    WELD
+};
+
+/**
+ * @brief Item of #FRREntityRegistry, whose replication callbacks only process the added/removed entity
+ */
+USTRUCT()
+struct RAPYUTASIMULATIONPLUGINS_API FRREntityRegistryItem : public FFastArraySerializerItem
+{
+    GENERATED_BODY()
+
+    //! May be unresolved on clients upon being added, till the actor itself has been replicated
+    UPROPERTY()
+    AActor* Actor = nullptr;
+
+    //! Name under which the entity is registered in #ASimulationState::Entities
+    UPROPERTY()
+    FString Name;
+
+    //! Unique id, stable for the entity's lifetime in the registry
+    UPROPERTY()
+    uint32 EntityId = 0;
+
+    //! Processed entity, kept to be unregistered once #Actor has been destroyed
+    UPROPERTY(NotReplicated)
+    AActor* RegisteredActor = nullptr;
+
+    void PostReplicatedAdd(const struct FRREntityRegistry& InArraySerializer);
+    void PostReplicatedChange(const struct FRREntityRegistry& InArraySerializer);
+    void PreReplicatedRemove(const struct FRREntityRegistry& InArraySerializer);
+};
+
+/**
+ * @brief Replicated registry of #ASimulationState's entities, as a fast array so that clients only receive & process
+ * added/removed entities instead of the whole list.
+ */
+USTRUCT()
+struct RAPYUTASIMULATIONPLUGINS_API FRREntityRegistry : public FFastArraySerializer
+{
+    GENERATED_BODY()
+
+    UPROPERTY()
+    TArray<FRREntityRegistryItem> Items;
+
+    UPROPERTY(NotReplicated)
+    ASimulationState* Owner = nullptr;
+
+    /**
+     * @brief Add an entity on Server
+     * @param InEntity
+     * @param InName
+     * @return uint32 Entity id
+     */
+    uint32 AddEntity(AActor* InEntity, const FString& InName);
+
+    /**
+     * @brief Remove an entity on Server
+     * @param InEntity
+     * @return true if InEntity was registered
+     */
+    bool RemoveEntity(const AActor* InEntity);
+
+    //! Get InEntity's id, 0 if it is not registered
+    uint32 GetEntityId(const AActor* InEntity) const;
+
+    bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+    {
+        return FFastArraySerializer::FastArrayDeltaSerialize<FRREntityRegistryItem, FRREntityRegistry>(Items, DeltaParms, *this);
+    }
+
+private:
+    uint32 NextEntityId = 1;
+};
+
+template<>
+struct TStructOpsTypeTraits<FRREntityRegistry> : public TStructOpsTypeTraitsBase2<FRREntityRegistry>
+{
+    enum
+    {
+        WithNetDeltaSerializer = true,
+    };
+};
+
 // (NOTE) To be renamed ARRROS2SimulationState, due to its inherent attachment to ROS 2 Node
 // & thus house [Entities] spawned by ROS services, and  with ROS relevance.
 // However, check for its usage in BP and refactor if there is accordingly!
 /**
  * @brief Provide ROS 2 interface implementations to interact with UE4.
- * Supported interactions: Service [GetEntityState, SetEntityState, Attach, SpawnEntity, DeleteEntity]
+ * Supported interactions: Service [GetEntityState, SetEntityState, Attach, SpawnEntity, DeleteEntity,
+ * CaptureWorldSnapshot, RestoreWorldSnapshot]
  *
  * SimulationState can manipulate only actors in #Entities and #EntitiesWithTag. All actors in the world are added to #Entities and
  * #EntitiesWithTag with #InitEntities method and actors can be added to those list by #AddEntity method individually as well.
@@ -88,6 +190,11 @@ public:
      */
     ASimulationState();
 
+    virtual void Tick(float InDeltaTime) override;
+
+    //! Signalled upon entities being spawned, moved or deleted, eg to update maps of them incrementally
+    FRROnEntityBoundsChanged OnEntityBoundsChanged;
+
 public:
     /**
      * @brief Register entity types from Blueprint class names, that are configured in #ARRROS2GameMode
@@ -97,10 +204,16 @@ public:
 
     /**
      * @brief Fetch all entities in the current map under control of this Actor.
+     * Only the loaded actors are fetched, those of levels streamed in or out afterwards, eg World Partition cells, being
+     * added or removed incrementally if #bTrackStreamedLevels.
      */
     UFUNCTION(BlueprintCallable)
     virtual void InitEntities();
 
+    //! Register & unregister the actors of the levels streamed in & out after #InitEntities
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool bTrackStreamedLevels = true;
+
     //! Cached the previous [GetEntityState] request for duplicated incoming request filtering
     //! @todo is this necessary?
     UPROPERTY(BlueprintReadOnly)
@@ -114,12 +227,19 @@ public:
     bool ServerCheckSetEntityStateRequest(const FROSSetEntityStateReq& InRequest);
 
     /**
-     * @brief Set Entity state on server
+     * @brief Set Entity state on server. Unless rr.SimulationState.DeferSetEntityState is 0, the state is buffered to be applied
+     * in this actor's pre-physics tick along with all others set this frame, the latest one per entity winning.
      * @param InRequest
      */
     UFUNCTION(BlueprintCallable)
     void ServerSetEntityState(const FROSSetEntityStateReq& InRequest);
 
+    /**
+     * @brief Set a batch of entity states on server, eg coalesced from a high-rate SetEntityState stream
+     * @param InRequests
+     */
+    void ServerSetEntityStates(const TArray<FROSSetEntityStateReq>& InRequests);
+
     //! Cached the previous [SetEntityState] request for duplicated incoming request filtering
     //! @todo is this necessary?
     UPROPERTY(BlueprintReadOnly)
@@ -140,11 +260,58 @@ public:
     UFUNCTION(BlueprintCallable)
     void ServerAttach(const FROSAttachReq& InRequest);
 
+    /**
+     * @brief Attach/detach a batch of entity pairs on Server, eg a robot picking up a stack of totes
+     * @param InRequests
+     */
+    UFUNCTION(BlueprintCallable)
+    void ServerAttachBatch(const TArray<FROSAttachReq>& InRequests);
+
+    //! Mode of the attachments made by #ServerAttach(), detachments following the mode each entity was attached with
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    ERRAttachMode AttachMode = ERRAttachMode::KINEMATIC;
+
     //! Cached the previous [Attach] request for duplicated incoming request filtering
     //! @todo is this necessary?
     UPROPERTY(BlueprintReadOnly)
     FROSAttachReq PrevAttachEntityRequest;
 
+    //! Snapshot name used by the ROS 2 CaptureWorldSnapshot & RestoreWorldSnapshot services
+    static constexpr const TCHAR* DEFAULT_WORLD_SNAPSHOT_NAME = TEXT("default");
+
+    /**
+     * @brief Record the states of all #Entities into an in-memory #FRRWorldSnapshot blob, replacing any of the same name
+     * @param InSnapshotName
+     * @return int32 Num of captured entities
+     */
+    UFUNCTION(BlueprintCallable)
+    int32 ServerCaptureWorldSnapshot(const FString& InSnapshotName);
+
+    /**
+     * @brief Restore a snapshot in one pass within the current frame: attachments first, then entities' states, parents
+     * before their attached children. Entities deleted since are skipped, those spawned since left as they are.
+     * Pending SetEntityState requests of this frame are dropped.
+     * @param InSnapshotName
+     * @return int32 Num of restored entities, INDEX_NONE if there is no valid snapshot of InSnapshotName
+     */
+    UFUNCTION(BlueprintCallable)
+    int32 ServerRestoreWorldSnapshot(const FString& InSnapshotName);
+
+    UFUNCTION(BlueprintCallable)
+    void ServerRemoveWorldSnapshot(const FString& InSnapshotName)
+    {
+        WorldSnapshots.Remove(InSnapshotName);
+    }
+
+    //! Get a snapshot blob, eg to be checkpointed to disk by the training framework
+    bool GetWorldSnapshotData(const FString& InSnapshotName, TArray<uint8>& OutData) const;
+
+    //! Set a snapshot blob, eg loaded from a checkpoint, to be restored by #ServerRestoreWorldSnapshot()
+    void SetWorldSnapshotData(const FString& InSnapshotName, TArray<uint8>&& InData)
+    {
+        WorldSnapshots.Emplace(InSnapshotName, MoveTemp(InData));
+    }
+
     /**
      * @brief Check entity-spawn-request for duplication on Server
      * @todo is this necessary?
@@ -160,6 +327,30 @@ public:
     UFUNCTION(BlueprintCallable)
     AActor* ServerSpawnEntity(const FROSSpawnEntityReq& InRequest, const int32 NetworkPlayerId);
 
+    /**
+     * @brief Queue a spawn request on Server, to be spawned in a later frame among at most rr.SimulationState.MaxSpawnsPerFrame
+     * ones, so that bursts of spawn requests do not freeze the sim. Requests are only validated upon being queued.
+     * @param InRequest
+     * @param InNetworkPlayerId
+     * @return true if queued
+     */
+    bool ServerQueueSpawnEntity(const FROSSpawnEntityReq& InRequest, const int32 InNetworkPlayerId);
+
+    /**
+     * @brief Spawn a batch of entities on Server: all actors are spawned deferred, then finished together & registered in a
+     * single pass by #ServerAddEntities(). Requests are all validated first, the batch bypassing the spawn queue.
+     * Reference frames may be entities earlier in the same batch.
+     * @param InRequests
+     * @param InNetworkPlayerId
+     * @return TArray<AActor*> Spawned entity per request, nullptr if it failed
+     */
+    TArray<AActor*> ServerSpawnEntities(const TArray<FROSSpawnEntityReq>& InRequests, const int32 InNetworkPlayerId);
+
+    int32 GetPendingSpawnRequestsNum() const
+    {
+        return PendingSpawnRequests.Num();
+    }
+
     //! Cached the previous [SpawnEntity] request for duplicated incoming request filtering
     //! @todo is this necessary?
     UPROPERTY(BlueprintReadOnly)
@@ -181,6 +372,12 @@ public:
     UFUNCTION(BlueprintCallable)
     void ServerDeleteEntity(const FROSDeleteEntityReq& InRequest);
 
+    //! Unregister & destroy an entity, bypassing #PrevDeleteEntityRequest filtering, eg for shards' entity migration
+    void ServerRemoveEntity(AActor* InEntity);
+
+    //! Spawn a request having passed #ServerCheckSpawnRequest(), or bypassing #PrevSpawnEntityRequest filtering
+    AActor* ServerSpawnCheckedEntity(const FROSSpawnEntityReq& InRequest, const int32 InNetworkPlayerId);
+
     //! Cached the previous [DeleteEntity] request for duplicated incoming request filtering
     //! @todo is this necessary?
     UPROPERTY(BlueprintReadOnly)
@@ -194,6 +391,12 @@ public:
     UFUNCTION(BlueprintCallable)
     void ServerAddEntity(AActor* InEntity);
 
+    /**
+     * @brief Add entities to #Entities and #EntitiesWithTag in a single pass, #EntityRegistry being sent once
+     * @param InEntities Invalid ones are skipped
+     */
+    void ServerAddEntities(const TArray<AActor*>& InEntities);
+
     /**
      * @brief Add an entity with tag
      */
@@ -202,6 +405,7 @@ public:
 
     /**
      * @brief Add Entity Types to #SpawnableEntities which can be spawn by SpawnEntity ROS 2 service.
+     * Only new or changed types are updated in #SpawnableEntityInfoList, which is thus only re-replicated upon changes.
      * BP callable thus the param could not be const&
      * @param InSpawnableEntityTypes
      */
@@ -218,15 +422,21 @@ public:
     UPROPERTY(EditAnywhere)
     TMap<FName, FRREntities> EntitiesWithTag;
 
-    //! Replicatable copy of #Entities
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, ReplicatedUsing = OnRep_EntityList)
-    TArray<AActor*> EntityList;
+    //! Replicated registry of #Entities, clients adding/removing them by delta
+    UPROPERTY(VisibleAnywhere, Replicated)
+    FRREntityRegistry EntityRegistry;
 
     /**
-     * @brief Callback when #EntityList is replicated
+     * @brief Add a replicated entity from #EntityRegistry to #Entities and #EntitiesWithTag on client
+     * @param InItem
      */
-    UFUNCTION(BlueprintCallable)
-    void OnRep_EntityList();
+    void OnEntityRegistered(FRREntityRegistryItem& InItem);
+
+    /**
+     * @brief Remove a replicated entity from #Entities and #EntitiesWithTag on client
+     * @param InItem
+     */
+    void OnEntityUnregistered(FRREntityRegistryItem& InItem);
 
     //! Spawnable entity types for SpawnEntity ROS 2 service.
     //! @todo Converting to TArrays to be able to be replicated
@@ -238,7 +448,8 @@ public:
     TArray<FRREntityInfo> SpawnableEntityInfoList;
 
     /**
-     * @brief Fetch #SpawnableEntityInfoList
+     * @brief Rebuild #SpawnableEntityInfoList from #SpawnableEntityTypes if they are out of sync, eg after the latter has been
+     * edited directly. #AddSpawnableEntityTypes() keeps both in sync by delta.
      */
     UFUNCTION(BlueprintCallable)
     void GetSpawnableEntityInfoList();
@@ -249,16 +460,148 @@ public:
     UFUNCTION(BlueprintCallable)
     void OnRep_SpawnableEntityInfoList();
 
-    //! Timer handle to fetch #SpawnableEntityInfoList
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly)
-    FTimerHandle FetchEntityListTimerHandle;
-
     /**
      * @brief Matches UE strings to original char buffers, for ros messages
      * This can be needed for unicode encoded strings in ros message when ROS->UE->ROS conversion does not work well
      */
     TMap<FString, std::string> EncodedStrings;
 
+    /**
+     * @brief Find the entity with InTag whose Z is the nearest to InZ, through a per-tag index sorted by Z, which is only
+     * rebuilt upon #EntitiesWithTag changing. Tagged entities are thus expected to be static, eg map origins.
+     * Also output the Z range within which the found entity stays the nearest, ie the floor boundaries, so that callers
+     * only need to search again when leaving it or upon #GetTaggedEntitiesVersion() changing.
+     *
+     * @param InTag
+     * @param InZ
+     * @param OutMinZ
+     * @param OutMaxZ
+     * @return AActor* nullptr if there is no entity with InTag
+     */
+    AActor* FindNearestTaggedEntityAlongZ(const FName& InTag, const float InZ, float& OutMinZ, float& OutMaxZ);
+
+    /**
+     * @brief Find a valid entity in #Entities by a single FName-keyed lookup in #EntityIndex.
+     * Names which have never been made FName, thus of no entity, are rejected without any map lookup.
+     * @param InName
+     * @return AActor* nullptr if there is no valid entity named InName
+     */
+    AActor* FindEntity(const FString& InName) const;
+
+    /**
+     * @brief Find a valid entity by its #FRREntityRegistryItem::EntityId
+     * @param InEntityId
+     * @return AActor*
+     */
+    AActor* FindEntityById(const uint32 InEntityId) const;
+
+    /**
+     * @brief Get the entities located within InRadius of InCenter, through #EntitySpatialHash
+     * @param InCenter
+     * @param InRadius
+     * @param OutEntities
+     * @param InTag If not None, only entities in #EntitiesWithTag of it
+     */
+    UFUNCTION(BlueprintCallable)
+    void FindEntitiesInRadius(const FVector& InCenter,
+                              const float InRadius,
+                              TArray<AActor*>& OutEntities,
+                              const FName& InTag = NAME_None);
+
+    /**
+     * @brief Get the entities located in InBox, through #EntitySpatialHash
+     * @param InBox
+     * @param OutEntities
+     * @param InTag If not None, only entities in #EntitiesWithTag of it
+     */
+    UFUNCTION(BlueprintCallable)
+    void FindEntitiesInBox(const FBox& InBox, TArray<AActor*>& OutEntities, const FName& InTag = NAME_None);
+
+    /**
+     * @brief Find the entity nearest to InLocation, through #EntitySpatialHash
+     * @param InLocation
+     * @param InMaxDistance Unbounded if <= 0
+     * @param InTag If not None, only entities in #EntitiesWithTag of it
+     * @param InIgnoredEntity Excluded, eg the querying entity itself
+     * @return AActor* nullptr if none
+     */
+    UFUNCTION(BlueprintCallable)
+    AActor* FindNearestEntity(const FVector& InLocation,
+                              const float InMaxDistance = -1.f,
+                              const FName& InTag = NAME_None,
+                              const AActor* InIgnoredEntity = nullptr);
+
+    //! Incremented upon every change to #EntitiesWithTag, invalidating the per-tag Z indices
+    uint32 GetTaggedEntitiesVersion() const
+    {
+        return TaggedEntitiesVersion;
+    }
+
+protected:
+    //! Entities with a tag sorted by Z, see #FindNearestTaggedEntityAlongZ()
+    struct FTaggedEntitiesZIndex
+    {
+        TArray<TWeakObjectPtr<AActor>> Actors;
+        TArray<float> Zs;
+        uint32 Version = 0;
+    };
+
+    TMap<FName, FTaggedEntitiesZIndex> TaggedEntitiesZIndices;
+
+    //! #Entities keyed by FName & by entity id, see #FindEntity()
+    TMap<FName, TWeakObjectPtr<AActor>> EntityIndex;
+    TMap<uint32, TWeakObjectPtr<AActor>> EntityIdIndex;
+
+    void AddEntityToIndex(AActor* InEntity, const FString& InName, const uint32 InEntityId);
+    void RemoveEntityFromIndex(const FString& InName, const uint32 InEntityId);
+
+    uint32 TaggedEntitiesVersion = 1;
+
+    /**
+     * @brief Locations of #Entities, synced lazily upon the first spatial query of each frame, thus only re-bucketing the
+     * entities having moved to another cell. Teleports by #ServerSetEntityState() are applied immediately.
+     */
+    FRREntitySpatialHash EntitySpatialHash;
+    uint64 EntitySpatialHashSyncFrame = 0;
+
+    /**
+     * @brief Attach InChild to InParent with InMode, or detach it if already attached
+     * @param InParent
+     * @param InChild
+     * @param InMode
+     */
+    void ServerToggleAttachment(AActor* InParent, AActor* InChild, const ERRAttachMode InMode);
+
+    //! Components of the entities attached by #ERRAttachMode::WELD whose overlap updates were disabled, to be restored upon
+    //! detachment
+    TMap<TWeakObjectPtr<AActor>, TArray<TWeakObjectPtr<UPrimitiveComponent>>> WeldedEntities;
+
+    //! #FRRWorldSnapshot blobs by name, see #ServerCaptureWorldSnapshot()
+    TMap<FString, TArray<uint8>> WorldSnapshots;
+
+    //! Unbind the level streaming delegates
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    //! Register the actors of a level streamed in, see #bTrackStreamedLevels
+    void OnLevelAddedToWorld(ULevel* InLevel, UWorld* InWorld);
+
+    //! Unregister the actors of a level streamed out, see #bTrackStreamedLevels
+    void OnLevelRemovedFromWorld(ULevel* InLevel, UWorld* InWorld);
+
+    FDelegateHandle LevelAddedToWorldHandle;
+    FDelegateHandle LevelRemovedFromWorldHandle;
+
+    //! Sync #EntitySpatialHash with #Entities once per frame
+    void SyncEntitySpatialHash();
+
+    /**
+     * @brief Entities of InTag, for query filters
+     * @param InTag
+     * @param OutTaggedEntities
+     * @return false if InTag is not None & has no entity
+     */
+    bool GetTaggedEntitiesSet(const FName& InTag, TSet<const AActor*>& OutTaggedEntities) const;
+
 private:
     /**
      * @brief Verify a function is called from server
@@ -277,4 +620,64 @@ private:
                               const TSubclassOf<AActor>& InEntityClass,
                               const FTransform& InEntityTransform,
                               const int32& InNetworkPlayerId);
+
+    /**
+     * @brief Spawn deferred & configure an entity, which is to be finished by #UGameplayStatics::FinishSpawningActor()
+     * @param InROSSpawnRequest
+     * @param InEntityClass
+     * @param InEntityTransform
+     * @param InNetworkPlayerId
+     * @return AActor*
+     */
+    AActor* ServerBeginSpawnEntity(const FROSSpawnEntityReq& InROSSpawnRequest,
+                                   const TSubclassOf<AActor>& InEntityClass,
+                                   const FTransform& InEntityTransform,
+                                   const int32 InNetworkPlayerId);
+
+    /**
+     * @brief Check a request's entity name & model, and get its world transform
+     * @param InRequest
+     * @param InBatchEntities Entities being spawned in the same batch, which may be reference frames
+     * @param OutEntityClass
+     * @param OutWorldTransform
+     * @return true if the entity can be spawned
+     */
+    bool ServerPrepareSpawnEntity(const FROSSpawnEntityReq& InRequest,
+                                  const TMap<FString, AActor*>& InBatchEntities,
+                                  TSubclassOf<AActor>& OutEntityClass,
+                                  FTransform& OutWorldTransform);
+
+    //! Add an entity to #Entities, #EntityRegistry and #EntitiesWithTag, without bumping #TaggedEntitiesVersion
+    void ServerRegisterEntity(AActor* InEntity);
+
+    //! Remove a registered InEntity from #Entities, #EntitiesWithTag & their indices, without destroying it
+    void ServerUnregisterEntity(AActor* InEntity);
+
+    //! Remove an entity from all of InEntity's tag lists in #EntitiesWithTag, also dropping destroyed ones
+    void RemoveTaggedEntity(const AActor* InEntity, const TArray<FName>& InTags);
+
+    //! Spawn at most InMaxNum queued requests, all if <= 0
+    void ServerSpawnPendingEntities(const int32 InMaxNum);
+
+    //! Teleport all entities buffered by #ServerSetEntityState() in a single pass
+    void ServerApplyPendingEntityStates();
+
+    struct FPendingEntityState
+    {
+        TWeakObjectPtr<AActor> Entity;
+        FString ReferenceFrame;
+        FTransform RelativeTransform;
+    };
+    TArray<FPendingEntityState> PendingEntityStates;
+    //! Index in #PendingEntityStates of each entity's
+    TMap<AActor*, int32> PendingEntityStateIndices;
+
+    struct FPendingSpawnRequest
+    {
+        FROSSpawnEntityReq Request;
+        int32 NetworkPlayerId = 0;
+    };
+    TArray<FPendingSpawnRequest> PendingSpawnRequests;
+    //! Names of #PendingSpawnRequests' entities, rejecting duplicates before they are spawned
+    TSet<FString> PendingSpawnNames;
 };
@@ -9,10 +9,15 @@
 #include "CoreMinimal.h"
 #include "Misc/DateTime.h"
 #include "GameFramework/Actor.h"
+
+// RapyutaSimulationPlugins
+#include "Tools/RRTimeRecorder.h"
+
 #include "TimeLogger.generated.h"
 
 /**
- * @brief Log Simulation and Real timestamps to files.
+ * @brief Log Simulation and Real timestamps to files, through #FRRTimeRecorder,
+ * ie without per-frame allocation & streamed to #FilePath by a background thread.
  * 
  */
 UCLASS()
@@ -34,39 +39,67 @@ protected:
 	 */
 	virtual void BeginPlay() override;
 
+	/**
+	 * @brief Write the pending records
+	 * 
+	 */
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	FRRTimeRecorder Recorder;
+
 public:	
 	// Called every frame
 	/**
-	 * @brief  Called every frame. Save simulation time and real time to #SimTimeHistory and #RealTimeHistory .
-	 * if time elapsed more than #MaxTime, call #DumpData to save data to files.
+	 * @brief  Called every frame. Record simulation time, real time and frame cost once #StartTimer is called.
+	 * if simulation time elapsed more than #MaxTime, call #DumpData to save data to files and quit, unless #MaxTime <= 0.
 	 * @param DeltaTime 
 	 */
 	virtual void Tick(float DeltaTime) override;
 
 	/**
-	 * @brief Start saving time stamp.
+	 * @brief Start saving time stamp to #FilePath.
 	 * 
 	 */
 	UFUNCTION(BlueprintCallable)
 	void StartTimer();
 
 	/**
-	 * @brief Dump data to files.
+	 * @brief Write the pending records & close the file.
 	 * 
 	 */
 	UFUNCTION(BlueprintCallable)
 	void DumpData();
 
-	UPROPERTY()
-	TArray<FString> RealTimeHistory;
-	
-	UPROPERTY()
-	TArray<FString> SimTimeHistory;
-	
+	//! Cumulative real time factor since #StartTimer
+	UFUNCTION(BlueprintCallable)
+	float GetRTF() const
+	{
+		return Recorder.GetRTF();
+	}
+
+	//! Real time factor over the latest frames
+	UFUNCTION(BlueprintCallable)
+	float GetRollingRTF() const
+	{
+		return Recorder.GetRollingRTF();
+	}
+
+	//! Log file, [<ProjectSavedDir>/TimeLog.bin|csv] if empty
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	FString FilePath;
+
+	//! Write CSV instead of binary records
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool bCsv = false;
+
+	//! Num of records buffered for the writer thread, records being dropped if it lags behind further
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 RecordsBufferSize = 4096;
+
 	UPROPERTY()
 	FTimerHandle timerHandle;
 
-	//! Max time to log. 
+	//! Max simulation time to log, unlimited if <= 0.
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	float MaxTime=10.f;
 
@@ -0,0 +1,114 @@
+/**
+ * @file RRRobotLabelsWidget.h
+ * @brief Single viewport overlay drawing the labels of all robots, instead of one widget component per robot.
+ * @copyright Copyright 2020-2023 Rapyuta Robotics Co., Ltd.
+ */
+
+#pragma once
+
+// UE
+#include "Blueprint/UserWidget.h"
+#include "CoreMinimal.h"
+#include "Fonts/SlateFontInfo.h"
+
+#include "RRRobotLabelsWidget.generated.h"
+
+/**
+ * @brief Overlay of the first local player's viewport, painting all actor labels as text elements in one pass.
+ * Labels are projected to screen every #UpdateInterval only, then culled by their distance to the view & the viewport bounds,
+ * the nearest #MaxLabelsNum ones being drawn. Used by #ARRBaseRobot with bPooledUIWidget, see #ARRBaseRobot::InitUIWidget.
+ */
+UCLASS()
+class RAPYUTASIMULATIONPLUGINS_API URRRobotLabelsWidget : public UUserWidget
+{
+    GENERATED_BODY()
+
+public:
+    /**
+     * @brief Get the overlay of InWorld, creating & adding it to the viewport upon the first fetching
+     * @param InWorld
+     * @return URRRobotLabelsWidget* nullptr if InWorld has no local player, eg on a dedicated server
+     */
+    static URRRobotLabelsWidget* Get(UWorld* InWorld);
+
+    /**
+     * @brief Add or replace the label of InActor
+     * @param InActor
+     * @param InText
+     * @param InOffset World offset from the actor location
+     */
+    void AddLabel(AActor* InActor, const FString& InText, const FVector& InOffset);
+
+    void RemoveLabel(AActor* InActor);
+
+    void SetLabelText(AActor* InActor, const FString& InText);
+
+    void SetLabelVisible(AActor* InActor, const bool bInVisible);
+
+    int32 GetLabelsNum() const
+    {
+        return Labels.Num();
+    }
+
+    //! Labels drawn upon the last update
+    int32 GetDrawnLabelsNum() const
+    {
+        return DrawnLabels.Num();
+    }
+
+    //! [s] Interval between the labels projections, the labels being drawn at their last projected positions in between
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float UpdateInterval = 0.1f;
+
+    //! [cm] Labels farther than this from the view are culled, <= 0 for unbounded
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float MaxLabelDistance = 5000.f;
+
+    //! Max num of labels drawn, the nearest to the view, <= 0 for unbounded
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 MaxLabelsNum = 100;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FSlateFontInfo Font;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    FLinearColor Color = FLinearColor::White;
+
+protected:
+    virtual void NativeConstruct() override;
+
+    //! Update the labels projections if #UpdateInterval has passed, then draw them
+    virtual int32 NativePaint(const FPaintArgs& Args,
+                              const FGeometry& AllottedGeometry,
+                              const FSlateRect& MyCullingRect,
+                              FSlateWindowElementList& OutDrawElements,
+                              int32 LayerId,
+                              const FWidgetStyle& InWidgetStyle,
+                              bool bParentEnabled) const override;
+
+    //! Project the visible labels to widget space, culled & sorted by distance
+    void UpdateDrawnLabels(const FGeometry& InGeometry) const;
+
+    struct FLabel
+    {
+        FString Text;
+        FVector Offset = FVector::ZeroVector;
+        bool bVisible = true;
+    };
+
+    struct FDrawnLabel
+    {
+        const FString* Text = nullptr;
+        FVector2D Position = FVector2D::ZeroVector;
+        double DistanceSquared = 0.;
+    };
+
+    static TMap<const UWorld*, TWeakObjectPtr<URRRobotLabelsWidget>> SWidgets;
+
+    TMap<TWeakObjectPtr<AActor>, FLabel> Labels;
+
+    // Updated while painting, every #UpdateInterval
+    mutable TArray<FDrawnLabel> DrawnLabels;
+    mutable double LastUpdateTime = -1.;
+    mutable bool bLabelsDirty = true;
+};
@@ -45,9 +45,9 @@ public class RapyutaSimulationPlugins : ModuleRules
 
         // Runtime modules
         PublicDependencyModuleNames.AddRange(new string[] { "Core", "CoreUObject", "Engine", "InputCore", "ImageWrapper", "RenderCore", "Renderer", "RHI", "PhysicsCore", "XmlParser", "IESFile",
-                                                            "AIModule", "NavigationSystem", "TimeManagement", "Json", "UMG",
-                                                            "ChaosVehicles",
-                                                            "ProceduralMeshComponent", "MeshDescription", "StaticMeshDescription", "MeshConversion",
+                                                            "AIModule", "NavigationSystem", "NetCore", "ReplicationGraph", "TimeManagement", "Json", "JsonUtilities", "UMG",
+                                                            "Chaos", "ChaosVehicles",
+                                                            "ProceduralMeshComponent", "MeshDescription", "StaticMeshDescription", "MeshConversion", "GeometryCore",
                                                             "rclUE"});
 
         PrivateDependencyModuleNames.AddRange(new string[] { });